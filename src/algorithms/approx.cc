@@ -0,0 +1,362 @@
+/**
+ * @file approx.cc
+ * @brief Approximate reachability on BDDs, its sets as invariants.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <base.hh>
+
+#include <dd/cudd_mgr.hh>
+
+/* max size of the BDDs of the images and of the sets of the blocks,
+   a block growing past it is given up on (i.e. left unconstrained) */
+static const int approx_node_limit { 1 << 16 };
+
+/* sets larger than this are not worth their clauses, in every frame */
+static const int approx_invariant_node_limit { 1 << 10 };
+
+/* rounds of images, a fixpoint not reached by then is thrown away */
+static const unsigned approx_max_rounds { 1024 };
+
+namespace algorithms {
+
+    /* Machine by machine over-approximation: the state bits are split
+     * in blocks (the bits of a var are never split), with a set R_i
+     * over the bits of each block. R_i starts from the initial states,
+     * projected on the block. At each round, the image of each block
+     * is taken from the states in the conjunction of all sets, by the
+     * TRANS partitions depending on the block's next state, all other
+     * vars quantified: R_i grows by it, until no set does. Every
+     * reachable state is then in each R_i, projected on its block.
+     *
+     * Dropping constraints only makes the sets larger: units which are
+     * not plain DDs are left out, so are the environment constraints,
+     * and vars other than the state ones (e.g. inputs) are quantified
+     * from the units depending on them. */
+    void Algorithm::approximate_reachable()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+
+        /* all BDDs are gone once approximate_blocks returns */
+        dd::CuddMgr& cm { dd::CuddMgr::INSTANCE() };
+        Cudd& dd { cm.dd() };
+
+        dd::DDVector sets;
+        bool done { approximate_blocks(dd, om.bdd_approx(), sets) };
+
+        cm.release(dd);
+
+        if (!done || sets.empty()) {
+            return;
+        }
+
+        compiler::Units approximated;
+        for (const auto& set : sets) {
+            dd::DDVector dds { set };
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+            compiler::AigDescriptors aig_descriptors;
+
+            approximated.push_back(compiler::Unit(em().make_true(), dds,
+                                                  inlined_operator_descriptors,
+                                                  binary_selection_descriptors_map,
+                                                  array_mux_descriptors, aig_descriptors));
+        }
+
+        /* environment constraints stay the last units */
+        f_invar.insert(f_invar.end() - f_n_env_invars, approximated.begin(),
+                       approximated.end());
+
+        /* templates were built on the original units */
+        f_invar_templates.clear();
+        f_trans_templates.clear();
+        f_templates_ready = false;
+    }
+
+    bool Algorithm::approximate_blocks(Cudd& dd, unsigned block_bits, dd::DDVector& res)
+    {
+        std::vector<int> state;
+        std::vector<int> next;
+        fsm_state_bits(state, next);
+
+        /* the units proper, each on its own */
+        dd::DDTransfer transfer { dd };
+        auto plain_units = [this, &transfer](const compiler::Units& units, unsigned n_env) {
+            dd::DDVector res;
+            for (unsigned i = 0; i + n_env < units.size(); ++i) {
+                compiler::Units unit { units[i] };
+                plain_dds(transfer, unit, res);
+            }
+
+            return res;
+        };
+
+        dd::DDVector init_dds { plain_units(f_init, f_n_env_inits) };
+        dd::DDVector invar_dds { plain_units(f_invar, f_n_env_invars) };
+        dd::DDVector trans_dds { plain_units(f_trans, f_n_env_transes) };
+
+        /* current and next state vars, on this manager */
+        for (unsigned i = 0; i < state.size(); ++i) {
+            dd.bddVar(state[i]);
+            if (-1 != next[i]) {
+                dd.bddVar(next[i]);
+            }
+        }
+
+        int size { dd.ReadSize() };
+
+        /* blocks of the current (and next) state vars, frozen bits
+           belong to no block, they are never quantified */
+        std::vector<int> block_of(size, -1);
+        std::vector<int> kind(size, 0);
+        std::vector<int> swap(size);
+        for (int index = 0; index < size; ++index) {
+            swap[index] = index;
+        }
+
+        std::vector<BDD> current_cubes;
+        expr::Expr_ptr last_var { NULL };
+        unsigned n_bits { 0 };
+        BDD state_cube { dd.bddOne() };
+        for (unsigned i = 0; i < state.size(); ++i) {
+            if (-1 == next[i]) {
+                kind[state[i]] = 3;
+                continue;
+            }
+
+            /* a new block starts with a var, once the current one is
+               full */
+            expr::Expr_ptr var { f_bm.find_ucbi(state[i]).expr() };
+            if (current_cubes.empty() || (var != last_var && block_bits <= n_bits)) {
+                current_cubes.push_back(dd.bddOne());
+                n_bits = 0;
+            }
+            last_var = var;
+            ++n_bits;
+
+            block_of[state[i]] = current_cubes.size() - 1;
+            block_of[next[i]] = current_cubes.size() - 1;
+            kind[state[i]] = 1;
+            kind[next[i]] = 2;
+            swap[state[i]] = next[i];
+            swap[next[i]] = state[i];
+
+            current_cubes.back() &= dd.bddVar(state[i]);
+            state_cube &= dd.bddVar(state[i]);
+        }
+
+        unsigned n_blocks { (unsigned) current_cubes.size() };
+        if (0 == n_blocks) {
+            return false;
+        }
+
+        /* vars other than the state ones (e.g. inputs, or state vars
+           of later frames) are quantified, next state ones unless
+           allowed */
+        auto projected = [&](const BDD& bdd, bool allow_next) {
+            BDD cube { dd.bddOne() };
+            for (auto index : bdd.SupportIndices()) {
+                int k { (int) index < size ? kind[index] : 0 };
+                if (0 == k || (2 == k && !allow_next)) {
+                    cube &= dd.bddVar(index);
+                }
+            }
+
+            return bdd.ExistAbstract(cube);
+        };
+
+        BDD invar { dd.bddOne() };
+        for (const auto& add : invar_dds) {
+            invar &= add.BddPattern();
+        }
+        invar = projected(invar, false);
+
+        BDD init { invar };
+        for (const auto& add : init_dds) {
+            init &= add.BddPattern();
+        }
+        init = projected(init, false);
+
+        if (approx_node_limit < init.nodeCount()) {
+            INFO
+                << "Approximate reachability: initial states exceed node limit"
+                << std::endl;
+
+            return false;
+        }
+
+        std::vector<BDD> partitions;
+        for (const auto& add : trans_dds) {
+            partitions.push_back(projected(add.BddPattern(), true));
+        }
+        partitions.push_back(invar.Permute(&swap[0]));
+
+        /* for each block, the partitions constraining its next state */
+        std::vector<std::vector<unsigned>> constraining(n_blocks);
+        for (unsigned i = 0; i < partitions.size(); ++i) {
+            std::vector<bool> seen(n_blocks, false);
+            for (auto index : partitions[i].SupportIndices()) {
+                int block { (int) index < size ? block_of[index] : -1 };
+                if (-1 != block && 2 == kind[index] && !seen[block]) {
+                    seen[block] = true;
+                    constraining[block].push_back(i);
+                }
+            }
+        }
+
+        /* R_i, the initial states on block i */
+        std::vector<BDD> sets;
+        std::vector<bool> given_up(n_blocks, false);
+        for (unsigned i = 0; i < n_blocks; ++i) {
+            sets.push_back(init.ExistAbstract(state_cube.ExistAbstract(current_cubes[i])));
+        }
+
+        auto image = [&](unsigned i, BDD& res) {
+            const std::vector<unsigned>& parts { constraining[i] };
+
+            /* the states the image is from */
+            BDD from { dd.bddOne() };
+            std::vector<bool> used(n_blocks, false);
+            used[i] = true;
+            for (auto j : parts) {
+                for (auto index : partitions[j].SupportIndices()) {
+                    int block { (int) index < size ? block_of[index] : -1 };
+                    if (-1 != block && 1 == kind[index]) {
+                        used[block] = true;
+                    }
+                }
+            }
+            for (unsigned j = 0; j < n_blocks; ++j) {
+                if (used[j] && !given_up[j]) {
+                    from &= sets[j];
+                }
+            }
+
+            /* every var but the next state of the block is quantified
+               with the last partition depending on it */
+            std::vector<int> last(size, -1);
+            for (unsigned j = 0; j < parts.size(); ++j) {
+                for (auto index : partitions[parts[j]].SupportIndices()) {
+                    last[index] = j;
+                }
+            }
+
+            BDD early_cube { dd.bddOne() };
+            std::vector<BDD> cubes(parts.size(), dd.bddOne());
+            for (int index = 0; index < size; ++index) {
+                if (-1 == block_of[index] || (2 == kind[index] && block_of[index] == (int) i)) {
+                    continue;
+                }
+
+                BDD& cube { -1 == last[index] ? early_cube : cubes[last[index]] };
+                cube &= dd.bddVar(index);
+            }
+
+            res = from.ExistAbstract(early_cube);
+            for (unsigned j = 0; j < parts.size(); ++j) {
+                res = res.AndAbstract(partitions[parts[j]], cubes[j]);
+
+                if (approx_node_limit < res.nodeCount()) {
+                    return false;
+                }
+            }
+
+            res = res.Permute(&swap[0]);
+            return true;
+        };
+
+        unsigned round;
+        for (round = 0; round < approx_max_rounds; ++round) {
+            if (limits_exceeded()) {
+                return false;
+            }
+
+            bool changed { false };
+            for (unsigned i = 0; i < n_blocks; ++i) {
+                if (given_up[i]) {
+                    continue;
+                }
+
+                BDD frontier;
+                if (!image(i, frontier) ||
+                    approx_node_limit < (sets[i] | frontier).nodeCount()) {
+                    given_up[i] = true;
+                    changed = true;
+                    continue;
+                }
+
+                BDD grown { sets[i] | frontier };
+                if (grown != sets[i]) {
+                    sets[i] = grown;
+                    changed = true;
+                }
+            }
+
+            if (!changed) {
+                break;
+            }
+        }
+
+        if (approx_max_rounds == round) {
+            INFO
+                << "Approximate reachability: no fixpoint after "
+                << round
+                << " rounds"
+                << std::endl;
+
+            return false;
+        }
+
+        /* back on the FSM manager */
+        boost::recursive_mutex::scoped_lock lock { f_bm.mutex() };
+        dd::DDTransfer back { f_bm.dd() };
+
+        unsigned n_given_up { 0 };
+        for (unsigned i = 0; i < n_blocks; ++i) {
+            if (given_up[i]) {
+                ++n_given_up;
+                continue;
+            }
+
+            if (sets[i].IsOne() || approx_invariant_node_limit < sets[i].nodeCount()) {
+                continue;
+            }
+
+            res.push_back(back(sets[i].Add()));
+        }
+
+        unsigned n_sets { (unsigned) res.size() };
+        INFO
+            << "Approximate reachability: fixpoint after "
+            << round
+            << " rounds, "
+            << n_sets
+            << " invariants out of "
+            << n_blocks
+            << " blocks ("
+            << n_given_up
+            << " given up)"
+            << std::endl;
+
+        return true;
+    }
+
+} // namespace algorithms
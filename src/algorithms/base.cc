@@ -21,19 +21,134 @@
  *
  **/
 
+#include <algorithm>
+#include <initializer_list>
+#include <map>
+#include <sstream>
 #include <vector>
 
 #include <base.hh>
+#include <compiled_fsm.hh>
+#include <scheduler.hh>
+#include <symb/classes.hh>
 #include <symb/proxy.hh>
+#include <symb/exceptions.hh>
+#include <symb/symb_iter.hh>
 
 #include <model/model.hh>
+#include <model/symmetry.hh>
 
 #include <env/environment.hh>
 
+#include <opts/opts_mgr.hh>
+
 #include <utils/misc.hh>
 
 namespace algorithms {
 
+    /* gates for the sorting network simple-path encoding, full
+       Tseitin equivalences */
+    static void add_clause(sat::Engine& engine, std::initializer_list<Lit> lits)
+    {
+        vec<Lit> ps;
+        for (Lit lit : lits) {
+            ps.push(lit);
+        }
+
+        engine.add_clause(ps);
+    }
+
+    static Lit and_gate(sat::Engine& engine, const std::vector<Lit>& lits)
+    {
+        Lit res { mkLit(engine.new_sat_var()) };
+
+        vec<Lit> ps;
+        ps.push(res);
+        for (Lit lit : lits) {
+            add_clause(engine, { ~res, lit });
+            ps.push(~lit);
+        }
+        engine.add_clause(ps);
+
+        return res;
+    }
+
+    static Lit xnor_gate(sat::Engine& engine, Lit x, Lit y)
+    {
+        Lit res { mkLit(engine.new_sat_var()) };
+
+        add_clause(engine, { ~res, ~x, y });
+        add_clause(engine, { ~res, x, ~y });
+        add_clause(engine, { res, x, y });
+        add_clause(engine, { res, ~x, ~y });
+
+        return res;
+    }
+
+    /* sel ? t : e */
+    static Lit mux_gate(sat::Engine& engine, Lit sel, Lit t, Lit e)
+    {
+        Lit res { mkLit(engine.new_sat_var()) };
+
+        add_clause(engine, { ~sel, ~t, res });
+        add_clause(engine, { ~sel, t, ~res });
+        add_clause(engine, { sel, ~e, res });
+        add_clause(engine, { sel, e, ~res });
+
+        return res;
+    }
+
+    /* sorts (x, y) lexicographically: x, y are swapped iff x > y */
+    static void compare_exchange(sat::Engine& engine, std::vector<Lit>& x, std::vector<Lit>& y)
+    {
+        assert(x.size() == y.size());
+        unsigned width = x.size();
+
+        /* lit_Undef stands for FALSE (swap) and TRUE (equal prefix) */
+        Lit swap { Minisat::lit_Undef };
+        Lit equal { Minisat::lit_Undef };
+
+        for (unsigned b = 0; b < width; ++b) {
+            /* x > y is decided at bit b */
+            std::vector<Lit> lits;
+            if (Minisat::lit_Undef != equal) {
+                lits.push_back(equal);
+            }
+            lits.push_back(x[b]);
+            lits.push_back(~y[b]);
+
+            Lit greater { and_gate(engine, lits) };
+            swap = (Minisat::lit_Undef == swap)
+                ? greater
+                : ~and_gate(engine, { ~swap, ~greater });
+
+            if (b + 1 < width) {
+                Lit same { xnor_gate(engine, x[b], y[b]) };
+                equal = (Minisat::lit_Undef == equal)
+                    ? same
+                    : and_gate(engine, { equal, same });
+            }
+        }
+
+        if (Minisat::lit_Undef == swap) {
+            return;
+        }
+
+        for (unsigned b = 0; b < width; ++b) {
+            Lit lo { mux_gate(engine, swap, y[b], x[b]) };
+            Lit hi { mux_gate(engine, swap, x[b], y[b]) };
+
+            x[b] = lo;
+            y[b] = hi;
+        }
+    }
+
+    static pconst_char section_name(unsigned kind)
+    {
+        static const pconst_char names[] = { "INIT", "INVAR", "TRANS" };
+        return names[kind];
+    }
+
     Algorithm::Algorithm(cmd::Command& command, model::Model& model)
         : f_ok(true)
         , f_command(command)
@@ -42,13 +157,87 @@ namespace algorithms {
         , f_bm(enc::EncodingMgr::INSTANCE())
         , f_em(expr::ExprMgr::INSTANCE())
         , f_tm(type::TypeMgr::INSTANCE())
+        , f_n_env_inits(0)
+        , f_n_env_invars(0)
+        , f_n_env_transes(0)
+        , f_templates_ready(false)
+        , f_fsm_dds_released(false)
+        , f_lazy_simple_path(opts::OptsMgr::INSTANCE().lazy_simple_path())
         , f_witness(NULL)
+        , f_cancelled(false)
+        , f_track_memory(false)
+        , f_watchdog(NULL)
     {
         /* Force mgr to exist */
         sat::EngineMgr& mgr { sat::EngineMgr::INSTANCE() };
         (void) mgr; /* suppress warning */
 
-        env::Environment& env { env::Environment::INSTANCE() };
+        /* the FSM is compiled once per model and environment */
+        CompiledFSMMgr& fsm_mgr { CompiledFSMMgr::INSTANCE() };
+        if (fsm_mgr.fetch(model, f_init, f_not_init, f_invar, f_trans)) {
+            for (auto* units : { &f_init, &f_invar, &f_trans }) {
+                for (const auto& unit : *units) {
+                    prefetch_microcode(unit);
+                }
+            }
+
+            TRACE
+                << "Reusing compiled FSM"
+                << std::endl;
+        } else {
+            compile_fsm();
+
+            if (!ok()) {
+                throw FailedSetup();
+            }
+
+            fsm_mgr.store(model, f_init, f_not_init, f_invar, f_trans);
+        }
+
+        compile_env_constraints();
+        if (!ok()) {
+            throw FailedSetup();
+        }
+
+        /* time and memory limits are enforced by a watchdog, for the
+           whole lifetime of this algorithm */
+        const sat::ResourceLimits& limits { command.limits() };
+        if (limits.watched()) {
+            f_watchdog = new sat::Watchdog(this, limits);
+        }
+
+        /* engines in this scope are interrupted if the command is
+           cancelled */
+        command.attach(this);
+
+        /* optional preprocessing */
+        if (opts::OptsMgr::INSTANCE().sweep() ||
+            opts::OptsMgr::INSTANCE().ternary_sim()) {
+            sweep();
+        }
+
+        TRACE
+            << "Base setup completed"
+            << std::endl;
+    }
+
+    void Algorithm::compile_fsm()
+    {
+        model::Model& model { f_model };
+
+        FsmSections sections;
+
+        /* the first section of the first instance of each module, by
+           the constants its parameters are bound to (none for modules
+           without parameters). The sections of the other instances
+           are the same bodies, in the same order */
+        typedef std::pair<model::Module_ptr, expr::ExprVector> Specialization;
+        boost::unordered_map<Specialization, unsigned> instances;
+
+        /* bodies of instances whose parameters are all bound to
+           constants are specialized on them */
+        compiler::Simplifier specializer;
+        unsigned n_specialized { 0 };
 
         std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
         model::Module& main_module { model.main_module() };
@@ -61,18 +250,66 @@ namespace algorithms {
 
             expr::Expr_ptr ctx { top.first };
             model::Module& module { *top.second };
+            unsigned first { (unsigned) sections.size() };
+
+            Specialization key { &module, expr::ExprVector() };
+            bool shared { true };
+
+            const symb::Parameters& params { module.parameters() };
+            for (symb::Parameters::const_iterator pi = params.begin();
+                 shared && params.end() != pi; ++pi) {
+                expr::Expr_ptr formal { em().make_dot(ctx, (*pi->second).name()) };
+                expr::Expr_ptr actual { compiler::Simplifier::constant_actual(formal) };
+
+                /* bound to other exprs in each instance */
+                if (NULL == actual) {
+                    shared = false;
+                }
+
+                key.second.push_back(actual);
+            }
+
+            expr::ExprVector init { module.init() };
+            expr::ExprVector invar { module.invar() };
+            expr::ExprVector trans { module.trans() };
+            if (shared && !params.empty()) {
+                DEBUG
+                    << "Specializing `"
+                    << ctx
+                    << "` on the constants of its parameters"
+                    << std::endl;
+
+                for (auto exprs : { &init, &invar, &trans }) {
+                    for (auto& body : *exprs) {
+                        body = specializer.specialize(ctx, body);
+                    }
+                }
+
+                ++n_specialized;
+            }
 
             /* module INITs */
-            const expr::ExprVector& init { module.init() };
-            process_init(ctx, init);
+            add_sections(sections, SECTION_INIT, ctx, init);
 
             /* module INVARs */
-            const expr::ExprVector& invar { module.invar() };
-            process_invar(ctx, invar);
+            add_sections(sections, SECTION_INVAR, ctx, invar);
 
             /* module TRANSes */
-            const expr::ExprVector& trans { module.trans() };
-            process_trans(ctx, trans);
+            add_sections(sections, SECTION_TRANS, ctx, trans);
+
+            if (shared) {
+                boost::unordered_map<Specialization, unsigned>::const_iterator i {
+                    instances.find(key)
+                };
+
+                if (instances.end() == i) {
+                    instances.insert(std::make_pair(key, first));
+                } else {
+                    for (unsigned j = first; j < sections.size(); ++j) {
+                        sections[j].instance_of = i->second + (j - first);
+                    }
+                }
+            }
 
             symb::Variables attrs { module.vars() };
             symb::Variables::const_iterator vi;
@@ -90,230 +327,1490 @@ namespace algorithms {
             }
         } /* while() */
 
-        /* processing environment extra constraints */
-        const expr::ExprVector& extra_init { env.extra_init() };
-        process_init(NULL, extra_init);
+        if (n_specialized) {
+            TRACE
+                << "Specialized "
+                << n_specialized
+                << " module instances on constant parameters"
+                << std::endl;
+        }
 
-        /* environment INVARs */
-        const expr::ExprVector& extra_invar { env.extra_invar() };
-        process_invar(NULL, extra_invar);
+        build_sections(sections);
 
-        /* environment TRANSes */
-        const expr::ExprVector& extra_trans { env.extra_trans() };
-        process_trans(NULL, extra_trans);
+        /* units are collected in the original order */
+        for (const auto& section : sections) {
+            if (section.error.empty()) {
+                collect_section(section);
+            }
+        }
+    }
 
-        if (!ok()) {
-            throw FailedSetup();
+    void Algorithm::compile_env_constraints()
+    {
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        FsmSections sections;
+        add_sections(sections, SECTION_INIT, NULL, env.extra_init());
+        add_sections(sections, SECTION_INVAR, NULL, env.extra_invar());
+        add_sections(sections, SECTION_TRANS, NULL, env.extra_trans());
+
+        if (sections.empty()) {
+            return;
         }
 
-        TRACE
-            << "Base setup completed"
-            << std::endl;
-    }
+        build_sections(sections);
 
-    Algorithm::~Algorithm()
-    {}
+        for (const auto& section : sections) {
+            if (!section.error.empty()) {
+                continue;
+            }
+
+            collect_section(section);
+
+            EnvConstraint constraint { section.kind, section.body, section.units[0] };
+            f_env_constraints.push_back(constraint);
+
+            /* vars the model does not depend on may be bound here */
+            collect_support(constraint.cu, f_env_support);
+
+            switch (section.kind) {
+                case SECTION_INIT:
+                    ++f_n_env_inits;
+                    break;
+
+                case SECTION_INVAR:
+                    ++f_n_env_invars;
+                    break;
+
+                case SECTION_TRANS:
+                    ++f_n_env_transes;
+                    break;
+            }
+        }
+    }
 
-    void Algorithm::process_init(expr::Expr_ptr ctx, const expr::ExprVector& exprs)
+    void Algorithm::build_sections(FsmSections& sections)
     {
-        for (auto body : exprs) {
-            DEBUG
-                << "processing INIT "
-                << ctx << "::" << body
+        /* sections of unchanged module instances survive reading the
+           model again, environment constraints survive as long as
+           they are there */
+        CompiledFSMMgr& fsm_mgr { CompiledFSMMgr::INSTANCE() };
+        unsigned n_reused { 0 };
+        for (auto& section : sections) {
+            if (fsm_mgr.fetch_section(section.kind, section.ctx, section.body, section.units)) {
+                ++n_reused;
+            }
+        }
+
+        if (n_reused) {
+            unsigned n_sections { (unsigned) sections.size() };
+            TRACE
+                << "Reusing "
+                << n_reused
+                << " compiled sections out of "
+                << n_sections
                 << std::endl;
+        }
 
-            try {
-                f_init.push_back(compiler().process(ctx, body));
-            } catch (Exception& ae) {
-                f_ok = false;
+        /* sections are compiled in parallel, each task with a
+           compiler of its own */
+        unsigned n_tasks {
+            std::min((unsigned) sections.size(), Scheduler::INSTANCE().slots())
+        };
+
+        if (n_tasks <= 1) {
+            compile_sections(sections, 0, 1);
+        } else {
+            Tasks tasks;
+            for (unsigned i = 0; i < n_tasks; ++i) {
+                tasks.push_back(Task("compile_fsm",
+                                     boost::bind(&Algorithm::compile_sections, this,
+                                                 boost::ref(sections), i, n_tasks)));
+            }
 
-                pconst_char what { ae.what() };
-                ERR
-                    << what
-                    << std::endl
-                    << "  in INIT "
-                    << ctx << "::" << body
-                    << std::endl;
+            Scheduler::INSTANCE().run(tasks, []() { return true; });
+        }
+
+        /* the other instances of a module are renamed from the first
+           one, or compiled on their own if that fails */
+        unsigned n_instantiated { 0 };
+        bool fallback { false };
+        for (auto& section : sections) {
+            if (-1 == section.instance_of || !section.units.empty()) {
+                continue;
+            }
+
+            const FsmSection& first { sections[section.instance_of] };
+            if (first.error.empty() &&
+                instantiate_units(first.units, first.ctx, section.ctx, section.units)) {
+                ++n_instantiated;
+            } else {
+                section.units.clear();
+                section.instance_of = -1;
+                fallback = true;
             }
         }
-    } /* process_init() */
 
-    void Algorithm::process_invar(expr::Expr_ptr ctx, const expr::ExprVector& exprs)
-    {
-        for (auto body : exprs) {
-            DEBUG
-                << "processing INVAR "
-                << ctx << "::" << body
+        if (fallback) {
+            compile_sections(sections, 0, 1);
+        }
+
+        if (n_instantiated) {
+            TRACE
+                << "Renamed "
+                << n_instantiated
+                << " sections from the first instance of their modules"
                 << std::endl;
-            try {
-                f_invar.push_back(compiler().process(ctx, body));
-            } catch (Exception& ae) {
+        }
+
+        for (const auto& section : sections) {
+            if (!section.error.empty()) {
                 f_ok = false;
 
-                pconst_char what { ae.what() };
+                pconst_char kind { section_name(section.kind) };
                 ERR
-                    << what
+                    << section.error
                     << std::endl
-                    << "  in INVAR "
-                    << ctx << "::" << body
+                    << "  in "
+                    << kind
+                    << " "
+                    << section.ctx << "::" << section.body
                     << std::endl;
+
+                continue;
             }
+
+            fsm_mgr.store_section(section.kind, section.ctx, section.body, section.units);
+
+            prefetch_microcode(section.units[0]);
         }
-    } /* process_invar() */
+    }
 
-    void Algorithm::process_trans(expr::Expr_ptr ctx, const expr::ExprVector& exprs)
+    void Algorithm::collect_section(const FsmSection& section)
     {
-        for (auto body : exprs) {
-            DEBUG
-                << "processing TRANS "
-                << ctx << "::" << body
-                << std::endl;
+        switch (section.kind) {
+            case SECTION_INIT:
+                f_init.push_back(section.units[0]);
+                f_not_init.push_back(section.units[1]);
+                break;
+
+            case SECTION_INVAR:
+                f_invar.push_back(section.units[0]);
+                break;
+
+            case SECTION_TRANS:
+                f_trans.push_back(section.units[0]);
+                break;
+        }
+    }
 
-            try {
-                f_trans.push_back(compiler().process(ctx, body));
-            } catch (Exception& ae) {
-                f_ok = false;
+    Algorithm::~Algorithm()
+    {
+        f_command.detach(this);
+        delete f_watchdog;
+
+        /* join and destroy all prefetching threads (if any) */
+        std::for_each(
+            begin(f_prefetch_tasks), end(f_prefetch_tasks),
+            [](thread_ptr task) {
+                task->join();
+                delete task;
+            });
+    }
 
-                pconst_char what { ae.what() };
-                ERR
-                    << what
-                    << std::endl
-                    << "  in TRANS "
-                    << ctx << "::" << body
-                    << std::endl;
+    void Algorithm::prefetch_microcode(const compiler::Unit& unit)
+    {
+        const compiler::InlinedOperatorDescriptors& descriptors {
+            unit.inlined_operator_descriptors()
+        };
+
+        /* one loading thread for each signature not seen before, so
+         * that microcode I/O overlaps with the rest of the setup */
+        for (const auto& iod : descriptors) {
+            const compiler::InlinedOperatorSignature& ios { iod.ios() };
+
+            if (f_prefetched.insert(ios).second) {
+                f_prefetch_tasks.push_back(
+                    new boost::thread(&Algorithm::load_microcode, ios));
             }
         }
-    } /* process_trans() */
+    }
 
-    void Algorithm::assert_fsm_init(sat::Engine& engine, step_t time, sat::group_t group)
+    void Algorithm::load_microcode(compiler::InlinedOperatorSignature ios)
     {
-        for (const auto& i : f_init) {
-            engine.push(i, time, group);
+        sat::InlinedOperatorMgr& mgr { sat::InlinedOperatorMgr::INSTANCE() };
+
+        try {
+            (void) mgr.require(ios).clauses();
+        } catch (Exception& e) {
+            /* not fatal here, errors are reported on first use */
+            pconst_char what { e.what() };
+            DEBUG
+                << "Microcode prefetch failed: "
+                << what
+                << std::endl;
         }
     }
 
-    void Algorithm::assert_fsm_invar(sat::Engine& engine, step_t time, sat::group_t group)
+    void Algorithm::add_sections(FsmSections& sections, fsm_section_t kind,
+                                 expr::Expr_ptr ctx, const expr::ExprVector& exprs)
     {
-        for (const auto& i : f_invar) {
-            engine.push(i, time, group);
+        for (auto body : exprs) {
+            FsmSection section;
+
+            section.kind = kind;
+            section.ctx = ctx;
+            section.body = body;
+            section.instance_of = -1;
+
+            sections.push_back(section);
         }
     }
 
-    void Algorithm::assert_fsm_trans(sat::Engine& engine, step_t time, sat::group_t group)
+    void Algorithm::compile_sections(FsmSections& sections, unsigned first, unsigned stride)
     {
-        for (const auto& f_tran : f_trans) {
-            engine.push(f_tran, time, group);
+        compiler::Compiler compiler;
+
+        for (unsigned i = first; i < sections.size(); i += stride) {
+            FsmSection& section { sections[i] };
+            expr::Expr_ptr ctx { section.ctx };
+            expr::Expr_ptr body { section.body };
+
+            /* reused, renamed, or failed already */
+            if (!section.units.empty() || -1 != section.instance_of ||
+                !section.error.empty()) {
+                continue;
+            }
+
+            pconst_char kind { section_name(section.kind) };
+            DEBUG
+                << "processing "
+                << kind
+                << " "
+                << ctx << "::" << body
+                << std::endl;
+
+            try {
+                section.units.push_back(compiler.process(ctx, body));
+
+                /* negated INIT, i.e. a non-initial state */
+                if (SECTION_INIT == section.kind) {
+                    section.units.push_back(compiler.process(ctx, em().make_not(body)));
+                }
+            } catch (Exception& ae) {
+                section.error = ae.what();
+            }
         }
     }
 
-    void Algorithm::assert_fsm_uniqueness(sat::Engine& engine, step_t j, step_t k, sat::group_t group)
+    /* ctx, under to rather than from. NULL if not under from */
+    static expr::Expr_ptr relocate_ctx(expr::Expr_ptr ctx, expr::Expr_ptr from,
+                                       expr::Expr_ptr to)
     {
-        symb::SymbIter symbols { model() };
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
 
-        /* this will hold the activation vars for the uniqueness clauses
-           defined below */
-        sat::VarVector uniqueness_vars;
+        if (ctx == from) {
+            return to;
+        }
 
-        while (symbols.has_next()) {
-            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+        if (!em.is_dot(ctx)) {
+            return NULL;
+        }
 
-            expr::Expr_ptr ctx { pair.first };
-            symb::Symbol_ptr symbol { pair.second };
+        expr::Expr_ptr lhs { relocate_ctx(ctx->lhs(), from, to) };
+        return lhs ? em.make_dot(lhs, ctx->rhs()) : NULL;
+    }
 
-            if (symbol->is_variable()) {
-                symb::Variable& var { symbol->as_variable() };
-                if (var.is_input() || var.is_frozen() || var.is_temp()) {
+    bool Algorithm::instantiate_units(const compiler::Units& units, expr::Expr_ptr from,
+                                      expr::Expr_ptr to, compiler::Units& res)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_bm.mutex() };
+        Cudd& dd { f_bm.dd() };
+
+        /* all DDs of the units, descriptors included */
+        dd::DDVector all;
+        for (const auto& unit : units) {
+            if (!unit.aig_descriptors().empty()) {
+                return false;
+            }
+
+            all.insert(all.end(), unit.dds().begin(), unit.dds().end());
+            for (const auto& iod : unit.inlined_operator_descriptors()) {
+                all.insert(all.end(), iod.z().begin(), iod.z().end());
+                all.insert(all.end(), iod.x().begin(), iod.x().end());
+                all.insert(all.end(), iod.y().begin(), iod.y().end());
+            }
+            for (const auto& pair : unit.binary_selection_descriptors_map()) {
+                for (const auto& bsd : pair.second) {
+                    all.insert(all.end(), bsd.z().begin(), bsd.z().end());
+                    all.push_back(bsd.cnd());
+                    all.push_back(bsd.aux());
+                    all.insert(all.end(), bsd.x().begin(), bsd.x().end());
+                    all.insert(all.end(), bsd.y().begin(), bsd.y().end());
+                }
+            }
+            for (const auto& md : unit.array_mux_descriptors()) {
+                all.insert(all.end(), md.z().begin(), md.z().end());
+                all.insert(all.end(), md.cnds().begin(), md.cnds().end());
+                all.insert(all.end(), md.acts().begin(), md.acts().end());
+                all.insert(all.end(), md.x().begin(), md.x().end());
+                all.insert(all.end(), md.index().begin(), md.index().end());
+            }
+        }
+
+        /* the DD var of each bit, in the instance. Aux vars are
+           registered in the context they were made in, they are made
+           anew in the instance's */
+        std::vector<std::pair<int, int>> renaming;
+        boost::unordered_set<int> seen;
+        for (const auto& add : all) {
+            for (auto index : add.SupportIndices()) {
+                if (!seen.insert(index).second) {
                     continue;
                 }
 
-                expr::Expr_ptr expr { var.name() };
-                expr::TimedExpr key { em().make_dot(ctx, expr), 0 };
-                enc::Encoding_ptr enc { f_bm.find_encoding(key) };
+                const enc::UCBI& ucbi { f_bm.find_ucbi(index) };
+                expr::Expr_ptr full { ucbi.expr() };
+                if (!em().is_dot(full)) {
+                    return false;
+                }
+
+                expr::Expr_ptr ctx { relocate_ctx(full->lhs(), from, to) };
+                if (!ctx) {
+                    return false;
+                }
+
+                expr::Expr_ptr relocated { em().make_dot(ctx, full->rhs()) };
+                expr::TimedExpr key { relocated, ucbi.time() };
 
+                enc::Encoding_ptr orig { f_bm.find_encoding(expr::TimedExpr(full, ucbi.time())) };
+                enc::Encoding_ptr enc { f_bm.find_encoding(key) };
                 if (!enc) {
-                    continue;
+                    const symb::Variables& vars { f_mm.scope(ctx)->vars() };
+                    symb::Variables::const_iterator vi { vars.find(full->rhs()) };
+
+                    enc = vars.end() != vi
+                              ? f_bm.make_var_encoding(relocated, vi->second->type())
+                              : f_bm.make_encoding(tm().find_boolean());
+                    f_bm.register_encoding(key, enc);
                 }
 
-                dd::DDVector::const_iterator di;
-                unsigned ndx;
-                for (ndx = 0, di = enc->bits().begin(); enc->bits().end() != di; ++ndx, ++di) {
-                    unsigned bit { di->getNode()->index };
-                    const enc::UCBI& ucbi { f_bm.find_ucbi(bit) };
-                    const enc::TCBI jtcbi { enc::TCBI(ucbi, j) };
-                    const enc::TCBI ktcbi { enc::TCBI(ucbi, k) };
+                /* e.g. ranges narrowed differently */
+                if (!orig || orig->bits().size() != enc->bits().size()) {
+                    return false;
+                }
 
-                    Var jkne { engine.new_sat_var() };
-                    uniqueness_vars.push_back(jkne);
+                renaming.push_back(std::make_pair(
+                    index, enc->bits()[ucbi.bitno()].getNode()->index));
+            }
+        }
 
-                    Var jvar { engine.tcbi_to_var(jtcbi) };
-                    Var kvar { engine.tcbi_to_var(ktcbi) };
+        std::vector<int> permut(dd.ReadSize());
+        for (unsigned i = 0; i < permut.size(); ++i) {
+            permut[i] = i;
+        }
+        for (const auto& pair : renaming) {
+            permut[pair.first] = pair.second;
+        }
 
-                    /* for each pair (j, k) we assert two clauses, both
-                       activated by jkne. The first clause is satisfied if
-                       at least one of the two variables (j, k) is false;
-                       the second clause is satisfied if at least one of
-                       the two variables is true. As it is impossible for
-                       the same variable to be false and true at the same
-                       time, this is equivalent to state:
+        auto rename = [&permut](const dd::DDVector& dds) {
+            dd::DDVector res;
+            for (const auto& add : dds) {
+                res.push_back(add.Permute(&permut[0]));
+            }
 
-                       jkne -> j xor k */
+            return res;
+        };
 
-                    {
-                        vec<Lit> ps;
-                        ps.push(mkLit(jkne, true));
-                        ps.push(mkLit(jvar, true));
-                        ps.push(mkLit(kvar, true));
+        for (const auto& unit : units) {
+            expr::Expr_ptr expr { relocate_ctx(unit.expr(), from, to) };
+            if (!expr) {
+                expr = unit.expr();
+            }
 
-                        engine.add_clause(ps);
-                    }
+            dd::DDVector dds { rename(unit.dds()) };
 
-                    {
-                        vec<Lit> ps;
-                        ps.push(mkLit(jkne, true));
-                        ps.push(mkLit(jvar, false));
-                        ps.push(mkLit(kvar, false));
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+            for (const auto& iod : unit.inlined_operator_descriptors()) {
+                dd::DDVector z { rename(iod.z()) };
+                dd::DDVector x { rename(iod.x()) };
+                dd::DDVector y { rename(iod.y()) };
 
-                        engine.add_clause(ps);
-                    }
+                if (y.empty()) {
+                    inlined_operator_descriptors.push_back(
+                        compiler::InlinedOperatorDescriptor(iod.ios(), z, x));
+                } else {
+                    inlined_operator_descriptors.push_back(
+                        compiler::InlinedOperatorDescriptor(iod.ios(), z, x, y));
                 }
             }
-        }
 
-        /* ...  finally, we assert that at least one of the activation
-           variables is true */
-        {
-            vec<Lit> ps;
-            ps.push(mkLit(group, true));
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+            for (const auto& pair : unit.binary_selection_descriptors_map()) {
+                for (const auto& bsd : pair.second) {
+                    dd::DDVector z { rename(bsd.z()) };
+                    dd::DDVector x { rename(bsd.x()) };
+                    dd::DDVector y { rename(bsd.y()) };
+
+                    binary_selection_descriptors_map[expr].push_back(
+                        compiler::BinarySelectionDescriptor(bsd.width(), z,
+                                                            bsd.cnd().Permute(&permut[0]),
+                                                            bsd.aux().Permute(&permut[0]),
+                                                            x, y));
+                }
+            }
 
-            for (int uniqueness_var : uniqueness_vars) {
-                ps.push(mkLit(uniqueness_var, false));
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+            for (const auto& md : unit.array_mux_descriptors()) {
+                dd::DDVector z { rename(md.z()) };
+                dd::DDVector cnds { rename(md.cnds()) };
+                dd::DDVector acts { rename(md.acts()) };
+                dd::DDVector x { rename(md.x()) };
+                dd::DDVector index { rename(md.index()) };
+
+                array_mux_descriptors.push_back(
+                    compiler::MultiwaySelectionDescriptor(md.elem_width(), md.elem_count(),
+                                                          z, cnds, acts, x, index));
             }
 
-            engine.add_clause(ps);
+            compiler::AigDescriptors aig_descriptors;
+            res.push_back(compiler::Unit(expr, dds, inlined_operator_descriptors,
+                                         binary_selection_descriptors_map,
+                                         array_mux_descriptors, aig_descriptors));
         }
+
+        return true;
     }
 
-    void Algorithm::assert_time_frame(sat::Engine& engine,
-                                      step_t time,
-                                      witness::TimeFrame& tf,
-                                      sat::group_t group)
+    void Algorithm::assert_fsm_init(sat::Engine& engine, step_t time, sat::group_t group,
+                                    bool env)
     {
-        symb::ResolverProxy resolver;
+        /* environment constraints come last */
+        unsigned n { (unsigned) f_init.size() - (env ? 0 : f_n_env_inits) };
+        for (unsigned i = 0; i < n; ++i) {
+            engine.push(f_init[i], time, group);
+        }
 
-        expr::ExprVector assignments { tf.assignments() };
-        unsigned count { 0 };
+        if (!f_symmetry_bits.empty()) {
+            assert_fsm_symmetry_breaking(engine, time, group);
+        }
+    }
 
-        expr::ExprVector::const_iterator i { assignments.begin() };
-        while (i != assignments.end()) {
-            expr::Expr_ptr assignment { *i++ };
-            expr::Expr_ptr full { assignment->lhs() };
-            symb::Symbol_ptr symbol { resolver.symbol(full) };
+    void Algorithm::assert_fsm_not_init(sat::Engine& engine, step_t time, sat::group_t group)
+    {
+        assert(!f_fsm_dds_released);
 
-            if (symbol->is_variable()) {
-                expr::Expr_ptr scope { full->lhs() };
-                expr::Expr_ptr expr { em().make_eq(full->rhs(), assignment->rhs()) };
+        /* !(i_1 & ... & i_n) is !i_1 | ... | !i_n, each disjunct is
+           enabled by a selector */
+        vec<Lit> ps;
+        if (sat::MAINGROUP != group) {
+            ps.push(mkLit(group, true));
+        }
 
-                DEBUG
+        for (const auto& i : f_not_init) {
+            Var selector { engine.new_sat_var() };
+            engine.push(i, time, selector);
+            ps.push(mkLit(selector));
+        }
+
+        engine.add_clause(ps);
+    }
+
+    void Algorithm::sample_memory(const sat::SolveStats& stats)
+    {
+        utils::MemorySample sample { utils::MemoryMgr::INSTANCE().sample() };
+
+        boost::mutex::scoped_lock lock { f_memory_mutex };
+        f_memory_by_step[stats.step].merge(sample);
+    }
+
+    MemoryByStep Algorithm::memory_by_step()
+    {
+        boost::mutex::scoped_lock lock { f_memory_mutex };
+        return f_memory_by_step;
+    }
+
+    void Algorithm::setup_engine(sat::Engine& engine)
+    {
+        engine.set_scope(this);
+
+        /* the scope is set before checking, a cancellation racing
+           with this engine's setup reaches it either way */
+        if (cancelled()) {
+            engine.interrupt();
+        }
+
+        /* budgets are relative to the current counters, i.e. zero
+           for a fresh engine: the conflict budget covers all of its
+           solve() calls */
+        const sat::ResourceLimits& limits { f_command.limits() };
+        if (0 < limits.conflicts) {
+            engine.configure(limits.conflicts, -1);
+        }
+
+        /* the clause database budget is given, or half the memory
+           limit shared among the strategies running at once */
+        uint64_t megs { opts::OptsMgr::INSTANCE().clause_db_memory() };
+        if (0 == megs && 0 < limits.max_memory) {
+            megs = std::max(1u, limits.max_memory / (2 * Scheduler::INSTANCE().slots()));
+        }
+        if (0 < megs) {
+            engine.set_memory_budget(megs << 20);
+        }
+
+        /* long SAT calls give way to waiting strategies */
+        unsigned quantum { opts::OptsMgr::INSTANCE().solve_quantum() };
+        engine.set_time_slicing(quantum, []() {
+            Scheduler::INSTANCE().yield();
+        });
+
+        for (const auto& fixed : f_fixed_bits) {
+            engine.fix_bit(fixed.first, fixed.second);
+        }
+
+        /* solves tell the scheduler how far the strategy got. Engines
+           kept across commands drop the observer of the algorithm
+           they were set up by before */
+        if (f_track_memory) {
+            engine.set_solve_observer([this](const sat::SolveStats& stats) {
+                Scheduler::INSTANCE().progress(stats.step);
+                sample_memory(stats);
+            });
+        } else {
+            engine.set_solve_observer([](const sat::SolveStats& stats) {
+                Scheduler::INSTANCE().progress(stats.step);
+            });
+        }
+
+        /* engines kept across commands are traced once */
+        if (!f_cnf_trace_path.empty() && !engine.traced()) {
+            boost::filesystem::path prefix { f_cnf_trace_path };
+            prefix /= engine.name();
+
+            engine.trace_cnf(prefix.string());
+        }
+    }
+
+    const sat::ResourceLimits& Algorithm::limits() const
+    {
+        return f_command.limits();
+    }
+
+    void Algorithm::cancel()
+    {
+        {
+            boost::mutex::scoped_lock lock { f_cancel_mutex };
+            f_cancelled = true;
+        }
+
+        sat::EngineMgr::INSTANCE().interrupt(this);
+    }
+
+    bool Algorithm::cancelled()
+    {
+        {
+            boost::mutex::scoped_lock lock { f_cancel_mutex };
+            if (f_cancelled) {
+                return true;
+            }
+        }
+
+        return f_command.cancelled();
+    }
+
+    void Algorithm::share_learnts(sat::Engine& engine, const char* channel,
+                                  sat::exchange_role_t role)
+    {
+        if (0 == opts::OptsMgr::INSTANCE().share_learnts()) {
+            return;
+        }
+
+        /* channels are private to this algorithm instance */
+        std::ostringstream oss;
+        oss
+            << channel
+            << "@"
+            << this;
+
+        engine.join_exchange(oss.str(), role);
+    }
+
+    void Algorithm::build_templates()
+    {
+        boost::mutex::scoped_lock lock { f_templates_mutex };
+
+        if (f_templates_ready) {
+            return;
+        }
+
+        /* INVARs and TRANSes are asserted at each step, with the same
+           clause structure: CNF-ize them only once. */
+        for (const auto& i : f_invar) {
+            f_invar_templates.push_back(sat::CNFTemplate(i));
+        }
+
+        for (const auto& f_tran : f_trans) {
+            f_trans_templates.push_back(sat::CNFTemplate(f_tran));
+        }
+
+        f_templates_ready = true;
+    }
+
+    void Algorithm::release_fsm_dds()
+    {
+        if (!opts::OptsMgr::INSTANCE().release_dds() || f_fsm_dds_released) {
+            return;
+        }
+
+        build_templates();
+
+        /* the units are still counted, and their exprs reported */
+        unsigned n_dds { 0 };
+        for (auto* units : { &f_invar, &f_trans }) {
+            for (auto& unit : *units) {
+                dd::DDVector dds;
+                compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+                compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+                compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+                compiler::AigDescriptors aig_descriptors;
+
+                n_dds += unit.dds().size();
+                unit = compiler::Unit(unit.expr(), dds, inlined_operator_descriptors,
+                                      binary_selection_descriptors_map,
+                                      array_mux_descriptors, aig_descriptors);
+            }
+        }
+
+        /* the cached copies would keep the same DDs alive */
+        CompiledFSMMgr::INSTANCE().clear();
+        f_fsm_dds_released = true;
+
+        DEBUG
+            << "Released "
+            << n_dds
+            << " DDs of the compiled FSM"
+            << std::endl;
+    }
+
+    void Algorithm::assert_fsm_invar(sat::Engine& engine, step_t time, sat::group_t group,
+                                     bool env)
+    {
+        build_templates();
+
+        unsigned n { (unsigned) f_invar_templates.size() - (env ? 0 : f_n_env_invars) };
+        for (unsigned i = 0; i < n; ++i) {
+            engine.push(f_invar_templates[i], time, group);
+        }
+
+        /* backward times are out of range */
+        if (time < f_phase_seed.size()) {
+            seed_phases(engine, time, f_phase_seed[time]);
+        }
+    }
+
+    void Algorithm::assert_fsm_not_invar(sat::Engine& engine, step_t time, sat::group_t group)
+    {
+        /* !(i_1 & ... & i_n) is !i_1 | ... | !i_n, each disjunct is
+           enabled by a selector */
+        vec<Lit> ps;
+        if (sat::MAINGROUP != group) {
+            ps.push(mkLit(group, true));
+        }
+
+        for (auto& i : f_invar) {
+            Var selector { engine.new_sat_var() };
+            assert_not_formula(engine, time, i, selector);
+            ps.push(mkLit(selector));
+        }
+
+        engine.add_clause(ps);
+    }
+
+    void Algorithm::assert_fsm_trans(sat::Engine& engine, step_t time, sat::group_t group,
+                                     bool env)
+    {
+        build_templates();
+
+        unsigned n { (unsigned) f_trans_templates.size() - (env ? 0 : f_n_env_transes) };
+        for (unsigned i = 0; i < n; ++i) {
+            engine.push(f_trans_templates[i], time, group);
+        }
+    }
+
+    void Algorithm::assert_fsm_trans_unit(sat::Engine& engine, unsigned i, step_t time,
+                                          sat::group_t group)
+    {
+        build_templates();
+
+        assert(i < f_trans_templates.size());
+        engine.push(f_trans_templates[i], time, group);
+    }
+
+    void Algorithm::assert_fsm_init_unit(sat::Engine& engine, unsigned i, step_t time,
+                                         sat::group_t group)
+    {
+        assert(i < f_init.size());
+        engine.push(f_init[i], time, group);
+    }
+
+    void Algorithm::assert_fsm_invar_unit(sat::Engine& engine, unsigned i, step_t time,
+                                          sat::group_t group)
+    {
+        build_templates();
+
+        assert(i < f_invar_templates.size());
+        engine.push(f_invar_templates[i], time, group);
+    }
+
+    void Algorithm::localize_trans(const compiler::Units& units, std::vector<bool>& res)
+    {
+        Support support;
+        for (const auto& unit : units) {
+            collect_support(unit, support);
+        }
+
+        /* no TRANS shares any var once its DDs are released, the
+           abstraction is refined from none of them */
+        res.assign(f_trans.size(), false);
+        for (unsigned i = 0; i < f_trans.size(); ++i) {
+            Support trans;
+            collect_support(f_trans[i], trans);
+
+            for (auto var : trans) {
+                if (0 < support.count(var)) {
+                    res[i] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    void Algorithm::collect_state_bits(std::vector<enc::UCBI>& res, bool inputs)
+    {
+        StateBits_ptr bits { CompiledFSMMgr::INSTANCE().state_bits(model()) };
+
+        for (const auto& bit : *bits) {
+            if ((bit.input && !inputs) || bit.frozen || bit.temp) {
+                continue;
+            }
+
+            if (!f_coi.empty() && 0 == f_coi.count(bit.var)) {
+                continue;
+            }
+
+            /* dead vars behave like inputs */
+            if (bit.dead && 0 == f_env_support.count(bit.var)) {
+                continue;
+            }
+
+            res.push_back(bit.ucbi);
+        }
+    }
+
+    void Algorithm::collect_support(const compiler::Unit& unit, Support& res)
+    {
+        std::vector<int> indices;
+        collect_support_indices(unit, indices);
+
+        for (auto index : indices) {
+            res.insert(f_bm.find_ucbi(index).expr());
+        }
+    }
+
+    void Algorithm::collect_support_indices(const compiler::Unit& unit, std::vector<int>& res)
+    {
+        dd::DDVector dds { unit.dds() };
+        auto append = [&dds](const dd::DDVector& v) {
+            dds.insert(dds.end(), v.begin(), v.end());
+        };
+
+        for (const auto& iod : unit.inlined_operator_descriptors()) {
+            append(iod.z());
+            append(iod.x());
+            append(iod.y());
+        }
+
+        for (const auto& pair : unit.binary_selection_descriptors_map()) {
+            for (const auto& bsd : pair.second) {
+                append(bsd.z());
+                append(bsd.x());
+                append(bsd.y());
+                dds.push_back(bsd.cnd());
+                dds.push_back(bsd.aux());
+            }
+        }
+
+        for (const auto& md : unit.array_mux_descriptors()) {
+            append(md.z());
+            append(md.cnds());
+            append(md.acts());
+            append(md.x());
+            append(md.index());
+        }
+
+        /* AIG nodes are defined over their inputs */
+        for (const auto& ad : unit.aig_descriptors()) {
+            compiler::AigMgr::INSTANCE().support(ad.root(), res);
+        }
+
+        for (auto& dd : dds) {
+            for (auto index : dd.SupportIndices()) {
+                res.push_back(index);
+            }
+        }
+    }
+
+    void Algorithm::eliminate_inputs(sat::Engine& engine, const compiler::Units& units)
+    {
+        if (!opts::OptsMgr::INSTANCE().input_elimination()) {
+            return;
+        }
+
+        /* vars read by TRANS at the current time, and vars read
+           anywhere else (or at the next time) */
+        Support read;
+        Support pinned;
+
+        std::vector<int> indices;
+        for (const auto& unit : f_trans) {
+            indices.clear();
+            collect_support_indices(unit, indices);
+
+            for (auto index : indices) {
+                const enc::UCBI& ucbi { f_bm.find_ucbi(index) };
+                if (0 == ucbi.time()) {
+                    read.insert(ucbi.expr());
+                } else {
+                    pinned.insert(ucbi.expr());
+                }
+            }
+        }
+
+        for (const auto& unit : f_init) {
+            collect_support(unit, pinned);
+        }
+        for (const auto& unit : f_invar) {
+            collect_support(unit, pinned);
+        }
+        for (const auto& unit : units) {
+            collect_support(unit, pinned);
+        }
+
+        unsigned n_bits { 0 };
+        StateBits_ptr bits { CompiledFSMMgr::INSTANCE().state_bits(model()) };
+        for (const auto& bit : *bits) {
+            if (!bit.input || 0 == read.count(bit.var) || 0 < pinned.count(bit.var)) {
+                continue;
+            }
+
+            engine.set_transient_input(bit.ucbi);
+            ++n_bits;
+        }
+
+        DEBUG
+            << n_bits
+            << " transient input bits in "
+            << engine.name()
+            << std::endl;
+    }
+
+    void Algorithm::break_symmetries(const expr::ExprVector& exprs)
+    {
+        /* the environment must not tell the members apart either */
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        expr::ExprVector all { exprs };
+        for (const auto* extras : { &env.extra_init(), &env.extra_invar(), &env.extra_trans() }) {
+            all.insert(all.end(), extras->begin(), extras->end());
+        }
+        for (auto id : env.identifiers()) {
+            all.push_back(f_em.make_eq(id, env.get(id)));
+        }
+
+        model::SymmetryDetector detector { f_model };
+        StateBits_ptr bits { CompiledFSMMgr::INSTANCE().state_bits(model()) };
+
+        f_symmetry_bits.clear();
+        for (const auto& sc : detector.classes()) {
+            bool invariant { true };
+            for (auto expr : all) {
+                if (!detector.invariant(sc, expr)) {
+                    invariant = false;
+                    break;
+                }
+            }
+            if (!invariant) {
+                continue;
+            }
+
+            SymmetryBits members(sc.size());
+            if (NULL != sc.array) {
+                /* elements are encoded one after the other */
+                expr::Expr_ptr full { f_em.make_dot(sc.ctx, sc.array) };
+
+                std::vector<enc::UCBI> elements;
+                for (const auto& bit : *bits) {
+                    if (bit.var == full && !bit.input && !bit.temp) {
+                        elements.push_back(bit.ucbi);
+                    }
+                }
+
+                unsigned width { (unsigned) elements.size() / sc.nelems };
+                for (unsigned k = 0; k < width * sc.nelems; ++k) {
+                    members[k / width].push_back(elements[k]);
+                }
+            } else {
+                /* instances of the same module have their bits in the
+                   same order */
+                for (unsigned k = 0; k < sc.size(); ++k) {
+                    expr::Expr_ptr member { f_em.make_dot(sc.ctx, sc.instances[k]) };
+
+                    for (const auto& bit : *bits) {
+                        if (bit.input || bit.temp) {
+                            continue;
+                        }
+
+                        expr::Expr_ptr scope { bit.var };
+                        while (f_em.is_dot(scope) && scope != member) {
+                            scope = scope->lhs();
+                        }
+                        if (scope == member) {
+                            members[k].push_back(bit.ucbi);
+                        }
+                    }
+                }
+            }
+
+            bool uniform { !members[0].empty() };
+            for (const auto& member : members) {
+                uniform = uniform && member.size() == members[0].size();
+            }
+            if (!uniform) {
+                continue;
+            }
+
+            f_symmetry_bits.push_back(members);
+        }
+
+        unsigned n_classes { (unsigned) f_symmetry_bits.size() };
+        INFO
+            << n_classes
+            << " symmetry classes broken"
+            << std::endl;
+    }
+
+    void Algorithm::assert_fsm_symmetry_breaking(sat::Engine& engine, step_t time,
+                                                 sat::group_t group)
+    {
+        for (const auto& members : f_symmetry_bits) {
+            for (unsigned m = 1; m < members.size(); ++m) {
+                const std::vector<enc::UCBI>& a { members[m - 1] };
+                const std::vector<enc::UCBI>& b { members[m] };
+
+                /* a <= b: eq is true iff a and b are equal on all bits
+                   before the k-th, then a_k -> b_k */
+                Var eq { group };
+                for (unsigned k = 0; k < a.size(); ++k) {
+                    Var x { engine.tcbi_to_var(enc::TCBI(a[k], time)) };
+                    Var y { engine.tcbi_to_var(enc::TCBI(b[k], time)) };
+
+                    {
+                        vec<Lit> ps;
+                        ps.push(mkLit(eq, true));
+                        ps.push(mkLit(x, true));
+                        ps.push(mkLit(y, false));
+
+                        engine.add_clause(ps);
+                    }
+
+                    if (k + 1 == a.size()) {
+                        break;
+                    }
+
+                    Var next { engine.new_sat_var() };
+                    {
+                        vec<Lit> ps;
+                        ps.push(mkLit(eq, true));
+                        ps.push(mkLit(x, false));
+                        ps.push(mkLit(y, false));
+                        ps.push(mkLit(next, false));
+
+                        engine.add_clause(ps);
+                    }
+                    {
+                        vec<Lit> ps;
+                        ps.push(mkLit(eq, true));
+                        ps.push(mkLit(x, true));
+                        ps.push(mkLit(y, true));
+                        ps.push(mkLit(next, false));
+
+                        engine.add_clause(ps);
+                    }
+
+                    eq = next;
+                }
+            }
+        }
+    }
+
+    void Algorithm::restrict_to_coi(const compiler::Units& units)
+    {
+        assert(!f_templates_ready);
+
+        Support coi;
+        for (const auto& unit : units) {
+            collect_support(unit, coi);
+        }
+
+        /* supports of the FSM units, INITs first, then INVARs and
+           TRANSes */
+        std::vector<const compiler::Unit*> fsm;
+        for (const auto& unit : f_init) {
+            fsm.push_back(&unit);
+        }
+        for (const auto& unit : f_invar) {
+            fsm.push_back(&unit);
+        }
+        for (const auto& unit : f_trans) {
+            fsm.push_back(&unit);
+        }
+
+        std::vector<Support> supports(fsm.size());
+        for (unsigned i = 0; i < fsm.size(); ++i) {
+            collect_support(*fsm[i], supports[i]);
+        }
+
+        /* constant units (i.e. with no vars) are always relevant,
+           and so are environment constraints, which are kept last */
+        std::vector<bool> relevant(fsm.size(), false);
+        for (unsigned i = 0; i < fsm.size(); ++i) {
+            relevant[i] = supports[i].empty();
+        }
+        unsigned n_init { (unsigned) f_init.size() };
+        unsigned n_invar { (unsigned) f_invar.size() };
+        for (unsigned i = n_init - f_n_env_inits; i < n_init; ++i) {
+            relevant[i] = true;
+        }
+        for (unsigned i = n_invar - f_n_env_invars; i < n_invar; ++i) {
+            relevant[n_init + i] = true;
+        }
+        for (unsigned i = fsm.size() - f_n_env_transes; i < fsm.size(); ++i) {
+            relevant[i] = true;
+        }
+
+        /* fixpoint: units sharing vars with the cone bring all of
+           their vars in */
+        bool grown;
+        do {
+            grown = false;
+            for (unsigned i = 0; i < fsm.size(); ++i) {
+                if (relevant[i]) {
+                    continue;
+                }
+
+                const Support& support { supports[i] };
+                if (std::none_of(support.begin(), support.end(),
+                                 [&coi](expr::Expr_ptr var) {
+                                     return 0 < coi.count(var);
+                                 })) {
+                    continue;
+                }
+
+                relevant[i] = true;
+                coi.insert(support.begin(), support.end());
+                grown = true;
+            }
+        } while (grown);
+
+        unsigned dropped { (unsigned) std::count(relevant.begin(), relevant.end(), false) };
+        if (0 == dropped) {
+            INFO
+                << "Cone of influence covers the whole model, no reduction"
+                << std::endl;
+            return;
+        }
+
+        unsigned total { (unsigned) fsm.size() };
+        INFO
+            << "Cone of influence reduction: "
+            << dropped
+            << " out of "
+            << total
+            << " FSM formulas dropped"
+            << std::endl;
+
+        /* INITs and negated INITs are kept in parallel */
+        compiler::Units init;
+        compiler::Units not_init;
+        compiler::Units invar;
+        compiler::Units trans;
+
+        unsigned i { 0 };
+        for (unsigned j = 0; j < f_init.size(); ++j, ++i) {
+            if (relevant[i]) {
+                init.push_back(f_init[j]);
+                not_init.push_back(f_not_init[j]);
+            }
+        }
+        for (const auto& unit : f_invar) {
+            if (relevant[i++]) {
+                invar.push_back(unit);
+            }
+        }
+        for (const auto& unit : f_trans) {
+            if (relevant[i++]) {
+                trans.push_back(unit);
+            }
+        }
+
+        f_init = init;
+        f_not_init = not_init;
+        f_invar = invar;
+        f_trans = trans;
+
+        f_coi = coi;
+    }
+
+    void Algorithm::replace_init(witness::TimeFrame& tf)
+    {
+        symb::ResolverProxy resolver;
+
+        compiler::Units init;
+        compiler::Units not_init;
+
+        for (auto assignment : tf.assignments()) {
+            expr::Expr_ptr full { assignment->lhs() };
+            symb::Symbol_ptr symbol { resolver.symbol(full) };
+
+            if (!symbol->is_variable() || symbol->as_variable().is_input()) {
+                continue;
+            }
+
+            expr::Expr_ptr scope { full->lhs() };
+            expr::Expr_ptr expr { em().make_eq(full->rhs(), assignment->rhs()) };
+
+            init.push_back(compiler().process(scope, expr));
+            not_init.push_back(compiler().process(scope, em().make_not(expr)));
+        }
+
+        INFO
+            << "Initial states replaced by a single state ("
+            << init.size()
+            << " vars)"
+            << std::endl;
+
+        f_init = init;
+        f_not_init = not_init;
+        f_n_env_inits = 0;
+        f_symmetry_bits.clear();
+    }
+
+    void Algorithm::assert_fsm_uniqueness(sat::Engine& engine, step_t j, step_t k, sat::group_t group)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits);
+
+        /* this will hold the activation vars for the uniqueness clauses
+           defined below */
+        sat::VarVector uniqueness_vars;
+
+        for (const auto& ucbi : bits) {
+            const enc::TCBI jtcbi { enc::TCBI(ucbi, j) };
+            const enc::TCBI ktcbi { enc::TCBI(ucbi, k) };
+
+            Var jkne { engine.new_sat_var() };
+            uniqueness_vars.push_back(jkne);
+
+            Var jvar { engine.tcbi_to_var(jtcbi) };
+            Var kvar { engine.tcbi_to_var(ktcbi) };
+
+            /* for each pair (j, k) we assert two clauses, both
+               activated by jkne. The first clause is satisfied if
+               at least one of the two variables (j, k) is false;
+               the second clause is satisfied if at least one of
+               the two variables is true. As it is impossible for
+               the same variable to be false and true at the same
+               time, this is equivalent to state:
+
+               jkne -> j xor k */
+
+            {
+                vec<Lit> ps;
+                ps.push(mkLit(jkne, true));
+                ps.push(mkLit(jvar, true));
+                ps.push(mkLit(kvar, true));
+
+                engine.add_clause(ps);
+            }
+
+            {
+                vec<Lit> ps;
+                ps.push(mkLit(jkne, true));
+                ps.push(mkLit(jvar, false));
+                ps.push(mkLit(kvar, false));
+
+                engine.add_clause(ps);
+            }
+        }
+
+        /* ...  finally, we assert that at least one of the activation
+           variables is true */
+        {
+            vec<Lit> ps;
+            ps.push(mkLit(group, true));
+
+            for (int uniqueness_var : uniqueness_vars) {
+                ps.push(mkLit(uniqueness_var, false));
+            }
+
+            engine.add_clause(ps);
+        }
+    }
+
+    void Algorithm::assert_fsm_join(sat::Engine& engine, step_t j, step_t k, sat::group_t group)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits, true);
+
+        for (const auto& ucbi : bits) {
+            Var jvar { engine.tcbi_to_var(enc::TCBI(ucbi, j)) };
+            Var kvar { engine.tcbi_to_var(enc::TCBI(ucbi, k)) };
+
+            /* group -> (j <-> k) */
+            {
+                vec<Lit> ps;
+                ps.push(mkLit(group, true));
+                ps.push(mkLit(jvar, true));
+                ps.push(mkLit(kvar, false));
+
+                engine.add_clause(ps);
+            }
+
+            {
+                vec<Lit> ps;
+                ps.push(mkLit(group, true));
+                ps.push(mkLit(jvar, false));
+                ps.push(mkLit(kvar, true));
+
+                engine.add_clause(ps);
+            }
+        }
+    }
+
+    void Algorithm::assert_fsm_simple_path(sat::Engine& engine, step_t k, bool backward)
+    {
+        step_t time { backward ? UINT_MAX - k : k };
+
+        if (f_lazy_simple_path) {
+            /* state vars must exist before solving, for their values
+               to be fetched from the model (the first state's too) */
+            std::vector<enc::UCBI> bits;
+            collect_state_bits(bits);
+
+            for (const auto& ucbi : bits) {
+                engine.tcbi_to_var(enc::TCBI(ucbi, time));
+                if (1 == k) {
+                    engine.tcbi_to_var(enc::TCBI(ucbi, backward ? UINT_MAX : 0));
+                }
+            }
+
+            return;
+        }
+
+        if (opts::OptsMgr::INSTANCE().simple_path_encoding() == "sorting") {
+            assert_fsm_sorted_states(engine, k, backward);
+            return;
+        }
+
+        sat::group_t guard { simple_path_guard(engine) };
+        for (step_t j = 0; j < k; ++j) {
+            assert_fsm_uniqueness(engine, backward ? UINT_MAX - j : j, time, guard);
+        }
+    }
+
+    void Algorithm::guard_simple_path(sat::Engine& engine)
+    {
+        Var guard { engine.new_sat_var(true) };
+
+        boost::mutex::scoped_lock lock { f_simple_path_mutex };
+        f_simple_path_guards[&engine] = guard;
+    }
+
+    sat::group_t Algorithm::simple_path_guard(const sat::Engine& engine)
+    {
+        boost::mutex::scoped_lock lock { f_simple_path_mutex };
+
+        auto i { f_simple_path_guards.find(&engine) };
+        return f_simple_path_guards.end() != i ? i->second : sat::MAINGROUP;
+    }
+
+    void Algorithm::assert_fsm_sorted_states(sat::Engine& engine, step_t k, bool backward)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits);
+
+        std::vector<std::vector<Lit>> states;
+        for (step_t j = 0; j <= k; ++j) {
+            step_t time { backward ? UINT_MAX - j : j };
+
+            std::vector<Lit> state;
+            for (const auto& ucbi : bits) {
+                state.push_back(mkLit(engine.tcbi_to_var(enc::TCBI(ucbi, time))));
+            }
+            states.push_back(state);
+        }
+
+        /* Batcher's odd-even merge sort, for arbitrary n */
+        unsigned n = states.size();
+        for (unsigned p = 1; p < n; p <<= 1) {
+            for (unsigned d = p; 0 < d; d >>= 1) {
+                for (unsigned j = d % p; j + d < n; j += 2 * d) {
+                    for (unsigned i = 0; i < d && i + j + d < n; ++i) {
+                        if ((i + j) / (2 * p) == (i + j + d) / (2 * p)) {
+                            compare_exchange(engine, states[i + j], states[i + j + d]);
+                        }
+                    }
+                }
+            }
+        }
+
+        /* sorted states are pairwise distinct iff adjacent ones are,
+           constraints are activated by a fresh var, as an assumption
+           to solve_simple_path() */
+        Var active { engine.new_sat_var(true) };
+        for (unsigned i = 0; i + 1 < n; ++i) {
+            const std::vector<Lit>& x { states[i] };
+            const std::vector<Lit>& y { states[i + 1] };
+
+            vec<Lit> ps;
+            ps.push(mkLit(active, true));
+
+            for (unsigned b = 0; b < x.size(); ++b) {
+                /* ne -> x xor y */
+                Lit ne { mkLit(engine.new_sat_var()) };
+                add_clause(engine, { ~ne, x[b], y[b] });
+                add_clause(engine, { ~ne, ~x[b], ~y[b] });
+
+                ps.push(ne);
+            }
+
+            engine.add_clause(ps);
+        }
+
+        /* the network for k - 1 states is implied by this one, and
+           is retired. Unrollings start over at k = 1. */
+        boost::mutex::scoped_lock lock { f_simple_path_mutex };
+
+        auto i { f_simple_path_vars.find(&engine) };
+        if (f_simple_path_vars.end() != i && 1 < k) {
+            add_clause(engine, { mkLit(i->second, true) });
+        }
+        f_simple_path_vars[&engine] = active;
+    }
+
+    sat::status_t Algorithm::solve_simple_path(sat::Engine& engine, step_t k, bool backward)
+    {
+        /* guarded constraints are only enabled here */
+        sat::group_t guard { simple_path_guard(engine) };
+
+        vec<Lit> assumptions;
+        if (sat::MAINGROUP != guard) {
+            assumptions.push(mkLit(guard));
+        }
+
+        if (!f_lazy_simple_path) {
+            if (opts::OptsMgr::INSTANCE().simple_path_encoding() != "sorting") {
+                return engine.solve(assumptions);
+            }
+
+            {
+                boost::mutex::scoped_lock lock { f_simple_path_mutex };
+
+                auto i { f_simple_path_vars.find(&engine) };
+                if (f_simple_path_vars.end() != i) {
+                    assumptions.push(mkLit(i->second));
+                }
+            }
+
+            return engine.solve(assumptions);
+        }
+
+        sat::status_t status { engine.solve(assumptions) };
+
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits);
+
+        unsigned rounds { 0 };
+        unsigned pairs { 0 };
+
+        while (sat::status_t::STATUS_SAT == status) {
+            /* states in the model, each is compared to the last
+               previous state it is equal to (if any) */
+            std::map<std::vector<bool>, step_t> states;
+            unsigned found { 0 };
+
+            for (step_t j = 0; j <= k; ++j) {
+                step_t time { backward ? UINT_MAX - j : j };
+
+                std::vector<bool> state;
+                state.reserve(bits.size());
+                for (const auto& ucbi : bits) {
+                    Var var { engine.tcbi_to_var(enc::TCBI(ucbi, time)) };
+                    state.push_back(1 == engine.value(var));
+                }
+
+                auto i { states.find(state) };
+                if (states.end() == i) {
+                    states.insert(std::make_pair(state, time));
+                    continue;
+                }
+
+                assert_fsm_uniqueness(engine, i->second, time, guard);
+                i->second = time;
+                ++found;
+            }
+
+            /* a simple path */
+            if (0 == found) {
+                break;
+            }
+
+            pairs += found;
+            ++rounds;
+
+            status = engine.solve(assumptions);
+        }
+
+        TRACE
+            << "Lazy simple-path (k = " << k << "): "
+            << pairs << " uniqueness constraints, "
+            << rounds << " refinements"
+            << std::endl;
+
+        return status;
+    }
+
+    void Algorithm::assert_time_frame(sat::Engine& engine,
+                                      step_t time,
+                                      witness::TimeFrame& tf,
+                                      sat::group_t group)
+    {
+        symb::ResolverProxy resolver;
+
+        expr::ExprVector assignments { tf.assignments() };
+        unsigned count { 0 };
+
+        expr::ExprVector::const_iterator i { assignments.begin() };
+        while (i != assignments.end()) {
+            expr::Expr_ptr assignment { *i++ };
+            expr::Expr_ptr full { assignment->lhs() };
+            symb::Symbol_ptr symbol { resolver.symbol(full) };
+
+            if (symbol->is_variable()) {
+                expr::Expr_ptr scope { full->lhs() };
+                expr::Expr_ptr expr { em().make_eq(full->rhs(), assignment->rhs()) };
+
+                DEBUG
                     << expr
                     << std::endl;
 
@@ -337,6 +1834,81 @@ namespace algorithms {
             << std::endl;
     }
 
+    void Algorithm::frame_phases(witness::TimeFrame& tf, FramePhases& res)
+    {
+        symb::ResolverProxy resolver;
+
+        /* entries are reset once read, for the next var */
+        std::vector<int> assignment(f_bm.nbits(), -1);
+
+        expr::ExprVector assignments { tf.assignments() };
+        for (auto assignment_expr : assignments) {
+            expr::Expr_ptr full { assignment_expr->lhs() };
+
+            /* e.g. witnesses of another model */
+            symb::Symbol_ptr symbol;
+            try {
+                symbol = resolver.symbol(full);
+            } catch (symb::UnresolvedSymbol& us) {
+                continue;
+            }
+
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            const symb::Variable& var { symbol->as_variable() };
+            enc::Encoding_ptr enc {
+                f_bm.find_encoding(expr::TimedExpr(full, var.is_frozen() ? FROZEN : 0))
+            };
+            if (!enc) {
+                continue;
+            }
+
+            bool ok { enc->assignment(assignment_expr->rhs(), &assignment[0]) };
+            for (const auto& bit : enc->bits()) {
+                int index { (int) bit.getNode()->index };
+
+                if (ok && 0 <= assignment[index]) {
+                    res.push_back(std::make_pair(f_bm.find_ucbi(index),
+                                                 0 != assignment[index]));
+                }
+                assignment[index] = -1;
+            }
+        }
+    }
+
+    void Algorithm::seed_phases(sat::Engine& engine, step_t time, const FramePhases& phases)
+    {
+        for (const auto& phase : phases) {
+            engine.set_phase(enc::TCBI(phase.first, time), phase.second);
+        }
+    }
+
+    void Algorithm::set_phase_seed(witness::Witness& w)
+    {
+        f_phase_seed.clear();
+
+        unsigned n_bits { 0 };
+        for (step_t time = w.first_time(); time <= w.last_time(); ++time) {
+            FramePhases phases;
+            frame_phases(w[time], phases);
+
+            n_bits += phases.size();
+            f_phase_seed.push_back(phases);
+        }
+
+        INFO
+            << "Seeding decision phases from witness `"
+            << w.id()
+            << "` ("
+            << f_phase_seed.size()
+            << " frames, "
+            << n_bits
+            << " bits)"
+            << std::endl;
+    }
+
     void Algorithm::assert_formula(sat::Engine& engine,
                                    step_t time,
                                    compiler::Unit& term,
@@ -352,4 +1924,184 @@ namespace algorithms {
         engine.push(term, time, group);
     }
 
+    bool Algorithm::fsm_initial_states(BDD& res, const compiler::Units& constraints, int limit)
+    {
+        if (f_fsm_dds_released) {
+            return false;
+        }
+
+        std::vector<const compiler::Unit*> units;
+        for (const auto& unit : f_init) {
+            units.push_back(&unit);
+        }
+        for (const auto& unit : f_invar) {
+            units.push_back(&unit);
+        }
+        for (const auto& unit : constraints) {
+            units.push_back(&unit);
+        }
+
+        res = f_bm.dd().bddOne();
+        for (const auto* unit : units) {
+            /* auxiliary vars are only defined by the CNF */
+            if (!unit->inlined_operator_descriptors().empty() ||
+                !unit->binary_selection_descriptors_map().empty() ||
+                !unit->array_mux_descriptors().empty() ||
+                !unit->aig_descriptors().empty()) {
+                return false;
+            }
+
+            for (const auto& dd : unit->dds()) {
+                res &= dd.BddPattern();
+
+                if (limit < res.nodeCount()) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void Algorithm::fsm_state_bits(std::vector<int>& state, std::vector<int>& next)
+    {
+        symb::SymbIter symbols { model() };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symbol { pair.second };
+
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+            if (var.is_input() || var.is_temp()) {
+                continue;
+            }
+
+            expr::Expr_ptr full { em().make_dot(ctx, var.name()) };
+
+            if (var.is_frozen()) {
+                enc::Encoding_ptr enc { f_bm.find_encoding(expr::TimedExpr(full, FROZEN)) };
+                if (!enc) {
+                    continue;
+                }
+
+                for (const auto& bit : enc->bits()) {
+                    state.push_back(bit.getNode()->index);
+                    next.push_back(-1);
+                }
+
+                continue;
+            }
+
+            enc::Encoding_ptr enc { f_bm.find_encoding(expr::TimedExpr(full, 0)) };
+            if (!enc) {
+                continue;
+            }
+
+            const expr::TimedExpr next_key { full, 1 };
+            enc::Encoding_ptr next_enc { f_bm.find_encoding(next_key) };
+            if (!next_enc) {
+                next_enc = f_bm.make_var_encoding(full, var.type());
+                f_bm.register_encoding(next_key, next_enc);
+            }
+
+            for (unsigned i = 0; i < enc->bits().size(); ++i) {
+                state.push_back(enc->bits()[i].getNode()->index);
+                next.push_back(next_enc->bits()[i].getNode()->index);
+            }
+        }
+    }
+
+    bool Algorithm::plain_dds(dd::DDTransfer& transfer, const compiler::Units& units,
+                              dd::DDVector& res)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_bm.mutex() };
+
+        for (const auto& unit : units) {
+            /* auxiliary vars are only defined by the CNF */
+            if (!unit.inlined_operator_descriptors().empty() ||
+                !unit.binary_selection_descriptors_map().empty() ||
+                !unit.array_mux_descriptors().empty() ||
+                !unit.aig_descriptors().empty()) {
+                return false;
+            }
+
+            for (const auto& dd : unit.dds()) {
+                res.push_back(transfer(dd));
+            }
+        }
+
+        return true;
+    }
+
+    bool Algorithm::fsm_dds(dd::DDTransfer& transfer, dd::DDVector& init,
+                            dd::DDVector& invar, dd::DDVector& trans)
+    {
+        if (f_fsm_dds_released) {
+            return false;
+        }
+
+        return plain_dds(transfer, f_init, init) &&
+               plain_dds(transfer, f_invar, invar) &&
+               plain_dds(transfer, f_trans, trans);
+    }
+
+    void Algorithm::assert_not_formula(sat::Engine& engine,
+                                       step_t time,
+                                       compiler::Unit& term,
+                                       sat::group_t group)
+    {
+        expr::Expr_ptr expr { term.expr() };
+
+        /* auxiliary vars definitions, these hold for any value of
+           the model vars */
+        {
+            dd::DDVector dds;
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors {
+                term.inlined_operator_descriptors()
+            };
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map {
+                term.binary_selection_descriptors_map()
+            };
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors {
+                term.array_mux_descriptors()
+            };
+            compiler::AigDescriptors aig_descriptors {
+                term.aig_descriptors()
+            };
+
+            engine.push(compiler::Unit(expr, dds, inlined_operator_descriptors,
+                                       binary_selection_descriptors_map, array_mux_descriptors,
+                                       aig_descriptors),
+                        time, group);
+        }
+
+        /* !(d_1 & ... & d_n), each disjunct is enabled by a selector */
+        vec<Lit> ps;
+        if (sat::MAINGROUP != group) {
+            ps.push(mkLit(group, true));
+        }
+
+        for (const auto& dd : term.dds()) {
+            dd::DDVector dds { dd.Cmpl() };
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+            compiler::AigDescriptors aig_descriptors;
+
+            Var selector { engine.new_sat_var() };
+            engine.push(compiler::Unit(expr, dds, inlined_operator_descriptors,
+                                       binary_selection_descriptors_map, array_mux_descriptors,
+                                       aig_descriptors),
+                        time, selector);
+            ps.push(mkLit(selector));
+        }
+
+        engine.add_clause(ps);
+    }
+
 } // namespace algorithms
@@ -28,12 +28,17 @@
 #ifndef BASE_ALGORITHM_H
 #define BASE_ALGORITHM_H
 
+#include <map>
+
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <cmd/command.hh>
 
 #include <compiler/compiler.hh>
 
+#include <dd/transfer.hh>
+
 #include <sat/sat.hh>
 
 #include <model/model.hh>
@@ -46,6 +51,9 @@
 #include <witness/witness.hh>
 
 #include <algorithms/exceptions.hh>
+#include <algorithms/lanes.hh>
+#include <utils/memory.hh>
+#include <utils/pool.hh>
 #include <utils/variant.hh>
 
 #include <boost/thread.hpp>
@@ -55,6 +63,25 @@ namespace algorithms {
     using thread_ptr = boost::thread*;
     using thread_ptrs = std::vector<thread_ptr>;
 
+    /* encoded vars (UCBI exprs) a compiled unit depends upon */
+    using Support = boost::unordered_set<expr::Expr_ptr, utils::PtrHash, utils::PtrEq>;
+
+    /* state bits and their constant values */
+    using FixedBits = std::vector<std::pair<enc::UCBI, bool>>;
+
+    /* candidate invariants, and their kinds (see mining.cc) */
+    using InvariantCandidates = std::vector<std::pair<compiler::Unit, unsigned>>;
+
+    /* bits and their values in a frame, decision phases to start from */
+    using FramePhases = std::vector<std::pair<enc::UCBI, bool>>;
+
+    /* the state bits of each member of a symmetry class, members
+       sorted as by the class */
+    using SymmetryBits = std::vector<std::vector<enc::UCBI>>;
+
+    /* peak memory figures, by unrolling step */
+    using MemoryByStep = std::map<step_t, utils::MemorySample>;
+
     /* Engine-less algorithm base class. Engine instances are provided
      * by strategies. */
     class Algorithm {
@@ -80,6 +107,10 @@ namespace algorithms {
         {
             return f_model;
         }
+        inline cmd::Command& command()
+        {
+            return f_command;
+        }
         inline compiler::Compiler& compiler()
         {
             return f_compiler;
@@ -98,6 +129,7 @@ namespace algorithms {
         inline void set_witness(witness::Witness& witness)
         {
             f_witness = &witness;
+            f_command.add_witness(witness.id());
         }
         inline witness::Witness& witness() const
         {
@@ -105,33 +137,405 @@ namespace algorithms {
             return *f_witness;
         }
 
-        /* FSM */
+        /* Phase seeding: decisions on the vars of the frames asserted
+         * from now on (see assert_fsm_invar) try the values they have
+         * in the frames of w first, frame i of w is taken for time i */
+        void set_phase_seed(witness::Witness& w);
+
+        /* CNF tracing, engines are traced into `<path>/<engine name>` */
+        inline void set_cnf_trace_path(const std::string& path)
+        {
+            f_cnf_trace_path = path;
+        }
+
+        /* engines are scoped to this algorithm, conflict budgets from
+         * the command's resource limits are applied here */
+        void setup_engine(sat::Engine& engine);
+
+        /* memory is sampled after each solve() of the engines set up
+           from now on, peaks are kept by unrolling step */
+        inline void track_memory()
+        {
+            f_track_memory = true;
+        }
+
+        MemoryByStep memory_by_step();
+
+        /* cancellation group: interrupts all engines of this
+         * algorithm (i.e. sibling strategies), and those set up
+         * afterwards. Engines of other algorithms are not affected.
+         * Cancelling the command (e.g. `kill`) cancels this too */
+        void cancel();
+        bool cancelled();
+
+        /* the command's resource limits */
+        const sat::ResourceLimits& limits() const;
+
+        /* true iff the command's time or memory limits were exceeded */
+        inline bool limits_exceeded() const
+        {
+            return NULL != f_watchdog && f_watchdog->expired();
+        }
+
+        /* learnt clauses sharing among strategies of this algorithm
+         * (if enabled by program options), see sat/exchange.hh */
+        void share_learnts(sat::Engine& engine, const char* channel,
+                           sat::exchange_role_t role);
+
+        typedef enum {
+            SECTION_INIT,
+            SECTION_INVAR,
+            SECTION_TRANS,
+        } fsm_section_t;
+
+        /* environment extra constraints, compiled */
+        struct EnvConstraint {
+            fsm_section_t kind;
+            expr::Expr_ptr body;
+            compiler::Unit cu;
+        };
+        typedef std::vector<EnvConstraint> EnvConstraints;
+
+        inline const EnvConstraints& env_constraints() const
+        {
+            return f_env_constraints;
+        }
+
+        /* FSM. Unless env, the environment constraints are left out,
+           see env_constraints() */
         void assert_fsm_init(sat::Engine& engine, step_t time,
-                             sat::group_t group = sat::MAINGROUP);
+                             sat::group_t group = sat::MAINGROUP,
+                             bool env = true);
+
+        /* negated INIT, i.e. a non-initial state */
+        void assert_fsm_not_init(sat::Engine& engine, step_t time,
+                                 sat::group_t group = sat::MAINGROUP);
 
         void assert_fsm_invar(sat::Engine& engine, step_t time,
-                              sat::group_t group = sat::MAINGROUP);
+                              sat::group_t group = sat::MAINGROUP,
+                              bool env = true);
+
+        /* negated INVAR, i.e. a state violating some INVAR */
+        void assert_fsm_not_invar(sat::Engine& engine, step_t time,
+                                  sat::group_t group = sat::MAINGROUP);
 
         void assert_fsm_trans(sat::Engine& engine, step_t time,
-                              sat::group_t group = sat::MAINGROUP);
+                              sat::group_t group = sat::MAINGROUP,
+                              bool env = true);
+
+        /* Localization abstraction: TRANS units on their own, by
+           index (see localize_trans()) */
+        inline unsigned n_trans_units() const
+        {
+            return (unsigned) f_trans.size();
+        }
+
+        void assert_fsm_trans_unit(sat::Engine& engine, unsigned i, step_t time,
+                                   sat::group_t group = sat::MAINGROUP);
+
+        /* Unsat cores: INIT and INVAR units on their own as well, by
+           index. INIT units are asserted with no symmetry breaking */
+        inline unsigned n_init_units() const
+        {
+            return (unsigned) f_init.size();
+        }
+
+        inline unsigned n_invar_units() const
+        {
+            return (unsigned) f_invar.size();
+        }
+
+        void assert_fsm_init_unit(sat::Engine& engine, unsigned i, step_t time,
+                                  sat::group_t group = sat::MAINGROUP);
+
+        void assert_fsm_invar_unit(sat::Engine& engine, unsigned i, step_t time,
+                                   sat::group_t group = sat::MAINGROUP);
+
+        /* the units by index, their exprs are fully qualified */
+        inline const compiler::Unit& init_unit(unsigned i) const
+        {
+            return f_init[i];
+        }
+
+        inline const compiler::Unit& invar_unit(unsigned i) const
+        {
+            return f_invar[i];
+        }
+
+        inline const compiler::Unit& trans_unit(unsigned i) const
+        {
+            return f_trans[i];
+        }
+
+        /* res[i] is true iff the i-th TRANS unit shares some var with
+           any of the given units */
+        void localize_trans(const compiler::Units& units, std::vector<bool>& res);
+
+        /* collects the vars in unit's DDs, microcode operands included */
+        void collect_support(const compiler::Unit& unit, Support& res);
 
         /* Generate uniqueness constraints between j-th and k-th state */
         void assert_fsm_uniqueness(sat::Engine& engine, step_t j, step_t k,
                                    sat::group_t group = sat::MAINGROUP);
 
+        /* Generate equality constraints between j-th and k-th time
+           frame, inputs included */
+        void assert_fsm_join(sat::Engine& engine, step_t j, step_t k,
+                             sat::group_t group = sat::MAINGROUP);
+
+        /* Simple-path constraints for the k-th state of a path
+         * unrolled forward (times 0, 1, ..., k) or backward (times
+         * UINT_MAX, UINT_MAX - 1, ...). Eagerly, uniqueness is asserted
+         * between the k-th state and each of the previous ones, or by a
+         * sorting network (--simple-path-encoding=sorting). In lazy
+         * mode (--lazy-simple-path), state vars are just allocated and
+         * uniqueness is left to solve_simple_path(). */
+        void assert_fsm_simple_path(sat::Engine& engine, step_t k,
+                                    bool backward = false);
+
+        /* Solves a path of k + 1 states under simple-path constraints.
+         * In lazy mode, whenever some states are equal in the model,
+         * uniqueness is asserted for those pairs only and the engine
+         * is solved again, until UNSAT or a simple path is found. */
+        sat::status_t solve_simple_path(sat::Engine& engine, step_t k,
+                                        bool backward = false);
+
+        /* Simple-path constraints asserted in engine from now on are
+         * only enabled by solve_simple_path(), so that other queries
+         * on the same unrolling (e.g. witness searches) are not
+         * constrained by them */
+        void guard_simple_path(sat::Engine& engine);
+
+        /* lazy simple-path constraints for this algorithm, regardless
+           of --lazy-simple-path */
+        inline void use_lazy_simple_path()
+        {
+            f_lazy_simple_path = true;
+        }
+
+        /* Cone of influence reduction: INIT, INVAR and TRANS units
+         * sharing no vars, directly or through other such units, with
+         * the given ones are dropped, and state vars outside the cone
+         * are left out of simple-path constraints. Only sound if the
+         * dropped units do not restrict the vars in the cone. Must be
+         * invoked before any FSM assertion. */
+        void restrict_to_coi(const compiler::Units& units);
+
+        /* Origin: the initial states are replaced by the state of tf
+         * (inputs excluded), e.g. to resume a search from a frame of
+         * a trace. Environment INITs and symmetry breaking no longer
+         * apply. Must be invoked before any FSM assertion. */
+        void replace_init(witness::TimeFrame& tf);
+
+        /* Input elimination (--input-elimination): the bits of inputs
+         * read by TRANS only, at the current time, and by none of the
+         * given units are made transient in engine (see
+         * sat::Engine::set_transient_input()). Only sound for
+         * strategies asserting each TRANS once, as a whole, and never
+         * referring to the frame's inputs again. To be invoked before
+         * any FSM assertion. */
+        void eliminate_inputs(sat::Engine& engine, const compiler::Units& units);
+
+        /* Symmetry breaking (see model::SymmetryDetector): for each
+         * symmetry class of the model leaving exprs (in the main
+         * module, e.g. the target and constraints) and the
+         * environment invariant, the initial states asserted from now
+         * on are required to have their members sorted
+         * lexicographically by their state bits, inputs excluded. */
+        void break_symmetries(const expr::ExprVector& exprs);
+
+        /* Invariant mining (--mine-invariants): candidate invariants
+         * (constant bits, equivalences and implications between state
+         * bits, bounds of algebraic vars) are taken from bit-parallel
+         * random simulation, those holding in all initial states and
+         * preserved by all transitions are appended to the INVARs.
+         * They hold regardless of the environment constraints. Must
+         * be invoked before any FSM assertion. */
+        void mine_invariants();
+
+        /* Approximate reachability (--bdd-approx): an over-approximation
+         * of the reachable states is computed on BDDs, machine by
+         * machine, i.e. a set for each block of state bits, each image
+         * taken from the conjunction of the sets. Those sets small
+         * enough are appended to the INVARs. They hold regardless of
+         * the environment constraints. Must be invoked before any FSM
+         * assertion. */
+        void approximate_reachable();
+
         /* Generic formulas */
         void assert_formula(sat::Engine& engine, step_t time, compiler::Unit& term,
                             sat::group_t group = sat::MAINGROUP);
 
+        /* BDD of the states satisfying INIT, INVAR and constraints,
+         * if they are all plain DDs (i.e. no microcode, nor
+         * selections) and the conjunction stays within limit
+         * nodes. False otherwise */
+        bool fsm_initial_states(BDD& res, const compiler::Units& constraints, int limit);
+
+        /* DD var indices of the state bits at time 0 (state[i]) and
+         * 1 (next[i], -1 for frozen bits). Next encodings are built
+         * if no TRANS refers to them */
+        void fsm_state_bits(std::vector<int>& state, std::vector<int>& next);
+
+        /* DDs of units, rebuilt by transfer (e.g. on a DD manager of
+         * the caller's own). False if any of them is not a plain DD,
+         * i.e. microcode or selections are involved */
+        bool plain_dds(dd::DDTransfer& transfer, const compiler::Units& units,
+                       dd::DDVector& res);
+
+        /* DDs of INIT, INVAR and TRANS, as above */
+        bool fsm_dds(dd::DDTransfer& transfer, dd::DDVector& init,
+                     dd::DDVector& invar, dd::DDVector& trans);
+
+        /* With --release-dds, builds the templates and drops the DDs
+         * of the INVAR and TRANS units (the units stay, with their
+         * exprs and none of their DDs), and those of the compiled FSM
+         * kept for later commands. To be called before any strategy
+         * is started. Past it, the DDs of the FSM are no longer
+         * available (see fsm_dds(), fsm_initial_states()). */
+        void release_fsm_dds();
+
+        /* Bit-parallel random simulator on the BDDs of the FSM (see
+         * fsm_initial_states), constraints are restricted to all
+         * states. NULL if the FSM can not be simulated this way,
+         * the caller owns the simulator otherwise */
+        LaneSimulator_ptr make_lane_simulator(const compiler::Units& constraints,
+                                              int limit, unsigned long seed);
+
+        /* Negated generic formulas: the DDs are complemented,
+           microcode and selections are asserted as they are */
+        void assert_not_formula(sat::Engine& engine, step_t time, compiler::Unit& term,
+                                sat::group_t group = sat::MAINGROUP);
+
         /* TimeFrame from a witness */
         void assert_time_frame(sat::Engine& engine, step_t time, witness::TimeFrame& tf,
                                sat::group_t group = sat::MAINGROUP);
 
+        /* the bits of the encoded vars of tf, as valued there */
+        void frame_phases(witness::TimeFrame& tf, FramePhases& res);
+
+        /* seeds the phases of the vars at time, see set_phase_seed */
+        void seed_phases(sat::Engine& engine, step_t time, const FramePhases& phases);
+
     private:
         /* internals */
-        void process_init(expr::Expr_ptr ctx, const expr::ExprVector& init);
-        void process_invar(expr::Expr_ptr ctx, const expr::ExprVector& invar);
-        void process_trans(expr::Expr_ptr ctx, const expr::ExprVector& trans);
+
+        /* compiles INITs, INVARs and TRANSes of all modules */
+        void compile_fsm();
+
+        /* FSM sections, in model order: one per INIT, INVAR and
+           TRANS, each compiled on its own */
+        struct FsmSection {
+            fsm_section_t kind;
+            expr::Expr_ptr ctx;
+            expr::Expr_ptr body;
+
+            /* the compiled unit (and its negation, for INITs), unless
+               compilation failed with error */
+            compiler::Units units;
+            std::string error;
+
+            /* the same section of the first instance of the module,
+               if any, its units are renamed rather than compiled */
+            int instance_of;
+        };
+        typedef std::vector<FsmSection> FsmSections;
+
+        void add_sections(FsmSections& sections, fsm_section_t kind,
+                          expr::Expr_ptr ctx, const expr::ExprVector& exprs);
+
+        /* sections are fetched from the cache, or compiled and stored
+           into it. Errors are reported, and fail the setup */
+        void build_sections(FsmSections& sections);
+
+        /* appends the units of a compiled section to the FSM */
+        void collect_section(const FsmSection& section);
+
+        /* units compiled in context from, with their DD vars renamed
+           to those of context to (aux vars are made anew). False if
+           any of them depends on vars outside of from, or can not be
+           renamed (e.g. AIG nodes, narrowed encodings) */
+        bool instantiate_units(const compiler::Units& units, expr::Expr_ptr from,
+                               expr::Expr_ptr to, compiler::Units& res);
+
+        /* Environment extra constraints (see env::Environment) are
+         * compiled on their own after the FSM, which is thus cached
+         * regardless of them, and their units are appended to it.
+         * Engines kept across commands assert them in groups of their
+         * own instead, so that they can be changed without rebuilding
+         * the engine */
+        void compile_env_constraints();
+
+        /* compiles sections first, first + stride, ... with a
+           compiler of its own, sections are independent */
+        void compile_sections(FsmSections& sections, unsigned first, unsigned stride);
+
+        /* CNF templates for INVARs and TRANSes, built on first use */
+        void build_templates();
+
+        /* asynchronous microcode loading, for all inlined operators
+         * required by a compiled unit */
+        void prefetch_microcode(const compiler::Unit& unit);
+        static void load_microcode(compiler::InlinedOperatorSignature ios);
+
+        /* lex-leader predicates, adjacent members of each symmetry
+           class are sorted at time */
+        void assert_fsm_symmetry_breaking(sat::Engine& engine, step_t time,
+                                          sat::group_t group);
+
+        /* encoding bits of the state vars (frozen and temp vars
+           excluded, inputs too unless required). Dead vars are
+           excluded as well, unless bound by environment constraints */
+        void collect_state_bits(std::vector<enc::UCBI>& res, bool inputs = false);
+
+        /* Constant sweeping (--sweep, --ternary-sim): state bits
+         * which are constant in all reachable states are cofactored
+         * out of the FSM DDs, and fixed in every engine set up
+         * afterwards */
+        void sweep();
+
+        /* the constant bits of candidates (see sweep()), under the
+           known ones. False iff interrupted, or there are no initial
+           states */
+        bool sweep_candidates(const std::vector<enc::UCBI>& bits, const FixedBits& known,
+                              FixedBits& res);
+
+        /* the bits stuck at a value in all reachable states, by
+           ternary simulation on the FSM BDDs (see ternary.cc) */
+        void ternary_simulation(const std::vector<enc::UCBI>& bits, FixedBits& res);
+
+        /* drops the candidates violated at time by some model, under
+         * the candidates at time - 1 if 0 < time, until UNSAT. False
+         * iff interrupted */
+        bool prune_candidates(sat::Engine& engine, FixedBits& candidates, step_t time);
+
+        /* as prune_candidates(), for candidate invariants */
+        bool prune_invariants(sat::Engine& engine, InvariantCandidates& candidates,
+                              step_t time);
+
+        /* the sets of approximate_reachable(), for blocks of about
+           block_bits state bits, built on dd and transferred back to
+           the FSM manager. False iff no fixpoint was reached */
+        bool approximate_blocks(Cudd& dd, unsigned block_bits, dd::DDVector& res);
+
+        /* drops the candidates violated in some state reached by
+           bit-parallel random simulation, if the FSM fits in a BDD */
+        void simulate_candidates(FixedBits& candidates);
+
+        /* unit, with fixed bits replaced by their values */
+        compiler::Unit substitute(const compiler::Unit& unit, const sat::FixedBitsMap& fixed);
+
+        /* ... as DD indices, with duplicates */
+        void collect_support_indices(const compiler::Unit& unit, std::vector<int>& res);
+
+        /* Sorting network simple-path encoding: states 0, .., k are
+         * sorted, adjacent sorted states are required to differ. Uses
+         * O(k log^2 k) comparators instead of O(k^2) state pairs. */
+        void assert_fsm_sorted_states(sat::Engine& engine, step_t k, bool backward);
+
+        /* the guard of engine's simple-path constraints, MAINGROUP if
+           none */
+        sat::group_t simple_path_guard(const sat::Engine& engine);
 
         /* all good? */
         bool f_ok;
@@ -153,11 +557,70 @@ namespace algorithms {
 
         /* Formulas */
         compiler::Units f_init;
+        compiler::Units f_not_init;
         compiler::Units f_invar;
         compiler::Units f_trans;
 
+        /* environment constraints, the last units of the above */
+        EnvConstraints f_env_constraints;
+        unsigned f_n_env_inits;
+        unsigned f_n_env_invars;
+        unsigned f_n_env_transes;
+
+        /* constant state bits, from sweeping */
+        FixedBits f_fixed_bits;
+
+        /* symmetry classes to be broken, see break_symmetries() */
+        std::vector<SymmetryBits> f_symmetry_bits;
+
+        /* vars in the cone of influence, empty if not restricted */
+        Support f_coi;
+
+        /* vars the environment constraints depend on */
+        Support f_env_support;
+
+        /* decision phases by time, see set_phase_seed */
+        std::vector<FramePhases> f_phase_seed;
+
+        /* CNF templates */
+        boost::mutex f_templates_mutex;
+        bool f_templates_ready;
+        sat::CNFTemplates f_invar_templates;
+        sat::CNFTemplates f_trans_templates;
+
+        /* INVAR and TRANS units have no DDs, see release_fsm_dds() */
+        bool f_fsm_dds_released;
+
+        /* activation vars of the current sorting networks, per engine */
+        boost::mutex f_simple_path_mutex;
+        boost::unordered_map<const sat::Engine*, Var> f_simple_path_vars;
+        boost::unordered_map<const sat::Engine*, Var> f_simple_path_guards;
+
+        /* from program options, unless overridden */
+        bool f_lazy_simple_path;
+
         /* Witness */
         witness::Witness_ptr f_witness;
+
+        /* CNF tracing (if not empty) */
+        std::string f_cnf_trace_path;
+
+        /* Cancellation group */
+        boost::mutex f_cancel_mutex;
+        bool f_cancelled;
+
+        /* Memory tracking, by unrolling step */
+        boost::mutex f_memory_mutex;
+        bool f_track_memory;
+        MemoryByStep f_memory_by_step;
+        void sample_memory(const sat::SolveStats& stats);
+
+        /* Resource limits watchdog (if any) */
+        sat::Watchdog_ptr f_watchdog;
+
+        /* Microcode prefetching */
+        compiler::InlinedOperatorSignatureSet f_prefetched;
+        thread_ptrs f_prefetch_tasks;
     };
 
 } // namespace algorithms
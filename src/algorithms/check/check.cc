@@ -21,15 +21,56 @@
  *
  **/
 
+#include <initializer_list>
+#include <sstream>
+
 #include <boost/thread.hpp>
 
 #include <algorithms/check/check.hh>
+#include <algorithms/scheduler.hh>
+
+#include <expr/nnfizer/nnfizer.hh>
+#include <expr/time/analyzer/analyzer.hh>
+#include <expr/walker/exceptions.hh>
+
 #include <witness_mgr.hh>
 
+static const char* check_trace_prfx { "ltl_" };
+
 namespace check {
 
+    static void add_clause(sat::Engine& engine, std::initializer_list<Lit> lits)
+    {
+        vec<Lit> ps;
+        for (Lit lit : lits) {
+            ps.push(lit);
+        }
+
+        engine.add_clause(ps);
+    }
+
+    /* true iff expr has LTL operators outside of its predicates */
+    static bool has_ltl(expr::ExprMgr& em, expr::Expr_ptr expr)
+    {
+        if (em.is_LTL(expr)) {
+            return true;
+        }
+
+        if (em.is_not(expr)) {
+            return has_ltl(em, expr->lhs());
+        }
+
+        if (em.is_and(expr) || em.is_or(expr) || em.is_implies(expr)) {
+            return has_ltl(em, expr->lhs()) || has_ltl(em, expr->rhs());
+        }
+
+        return false;
+    }
+
     Check::Check(cmd::Command& command, model::Model& model)
         : Algorithm(command, model)
+        , f_status(CHECK_UNKNOWN)
+        , f_pending(0)
     {
         const void* instance { this };
         TRACE
@@ -47,12 +88,569 @@ namespace check {
             << std::endl;
     }
 
-    void Check::process(const expr::Expr_ptr phi)
+    void Check::process(const expr::ExprVector& properties, expr::ExprVector constraints,
+                        step_t max_depth)
     {
+        expr::time::Analyzer eta { em() };
+        expr::Expr_ptr ctx { em().make_empty() };
+
         set_status(CHECK_UNKNOWN);
-        assert(false); // XXX: TODO
+
+        f_results.clear();
+        for (auto phi : properties) {
+            PropertyResult result { phi, CHECK_UNKNOWN, 0, NULL };
+            f_results.push_back(result);
+        }
+        f_pending = f_results.size();
+
+        /* counterexamples satisfy !phi and all LTL constraints,
+           untimed constraints hold at all times */
+        expr::ExprVector ltl_constraints;
+        for (auto constraint : constraints) {
+            eta.process(constraint);
+            if (eta.has_forward_time() || eta.has_backward_time()) {
+                ERR
+                    << "Timed constraints not supported by LTL checking: `"
+                    << constraint
+                    << "`"
+                    << std::endl;
+
+                set_status(CHECK_ERROR);
+                return;
+            }
+
+            if (has_ltl(em(), constraint)) {
+                ltl_constraints.push_back(constraint);
+            } else {
+                TRACE
+                    << "Compiling constraint `"
+                    << constraint
+                    << "` ..."
+                    << std::endl;
+
+                f_constraint_cus.push_back(compiler().process(ctx, constraint));
+            }
+        }
+
+        std::vector<unsigned> roots;
+        for (unsigned i = 0; i < properties.size(); ++i) {
+            expr::Expr_ptr phi { properties[i] };
+
+            expr::Expr_ptr formula { em().make_not(phi) };
+            for (auto constraint : ltl_constraints) {
+                formula = em().make_and(formula, constraint);
+            }
+
+            /* never checked, an unsupported property is resolved
+               right away */
+            roots.push_back(0);
+            try {
+                expr::Nnfizer nnfizer;
+                formula = nnfizer.process(formula);
+
+                TRACE
+                    << "Looking for paths satisfying `"
+                    << formula
+                    << "` ..."
+                    << std::endl;
+
+                roots.back() = collect(formula);
+            } catch (expr::InternalError& ie) {
+                ERR
+                    << "Unsupported LTL property `"
+                    << phi
+                    << "`"
+                    << std::endl;
+
+                sync_resolve(i, CHECK_ERROR, 0);
+            }
+        }
+
+        unsigned nsubformulas { (unsigned) f_subformulas.size() };
+        unsigned npredicates { (unsigned) f_atom_cus.size() };
+        INFO
+            << nsubformulas
+            << " subformulas, "
+            << npredicates
+            << " predicates found."
+            << std::endl;
+
+        /* strategy threads will access these values in the main
+           thread's stack, no reallocation once they started */
+        compiler::Units bad_cus;
+        bad_cus.reserve(properties.size());
+
+        algorithms::Tasks tasks;
+        tasks.push_back(algorithms::Task(
+            "bmc",
+            boost::bind(&Check::bmc_strategy, this, roots, max_depth)));
+
+        /* complete answers for G p, F p and G F p properties by a
+           reduction to safety, see liveness_strategy() */
+        for (unsigned i = 0; i < properties.size(); ++i) {
+            expr::Expr_ptr p;
+            liveness_t kind { f_constraint_cus.size() == constraints.size() &&
+                                      sync_is_pending(i)
+                                  ? classify(properties[i], p)
+                                  : LIVENESS_NONE };
+
+            if (LIVENESS_NONE == kind) {
+                continue;
+            }
+
+            TRACE
+                << "Compiling predicate `"
+                << p
+                << "` for liveness ..."
+                << std::endl;
+
+            std::ostringstream oss;
+            oss
+                << "liveness";
+            if (1 < properties.size()) {
+                oss
+                    << "_"
+                    << i;
+            }
+
+            bad_cus.push_back(compiler().process(ctx, em().make_not(p)));
+            tasks.push_back(algorithms::Task(
+                oss.str(),
+                boost::bind(&Check::liveness_strategy, this, boost::ref(bad_cus.back()),
+                            kind, i)));
+        }
+
+        release_fsm_dds();
+
+        if (0 < sync_pending()) {
+            algorithms::Scheduler::INSTANCE().run(tasks, [this]() {
+                return 0 < this->sync_pending();
+            });
+        }
+
+        /* FALSE wins over errors, errors over undecided properties */
+        ltl_status_t status { CHECK_TRUE };
+        for (const auto& result : f_results) {
+            if (CHECK_FALSE == result.status ||
+                (CHECK_ERROR == result.status && CHECK_FALSE != status) ||
+                (CHECK_UNKNOWN == result.status && CHECK_TRUE == status)) {
+                status = result.status;
+            }
+        }
+        set_status(status);
 
         TRACE << "Done." << std::endl;
     }
 
+    /* counterexamples, i.e. paths of increasing length satisfying the
+       root subformula */
+    void Check::bmc_strategy(std::vector<unsigned> roots, step_t max_depth)
+    {
+        sat::Engine engine { "ltl" };
+        setup_engine(engine);
+
+        for (auto& subformula : f_subformulas) {
+            subformula.loop = engine.new_sat_var(true);
+        }
+
+        step_t k { 0 };
+        unroll(engine, k);
+
+        engine.set_step(k);
+        sat::status_t status { engine.solve() };
+
+        if (sat::status_t::STATUS_UNKNOWN == status) {
+            goto cleanup;
+        }
+
+        else if (sat::status_t::STATUS_UNSAT == status) {
+            INFO
+                << "Empty initial states. Property is trivially TRUE."
+                << std::endl;
+
+            for (unsigned i = 0; i < roots.size(); ++i) {
+                sync_resolve(i, CHECK_TRUE, 0);
+            }
+            goto cleanup;
+        }
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            INFO
+                << "Now looking for LTL counterexample (k = " << k << ")..."
+                << std::endl;
+
+            sat::group_t group { engine.new_group() };
+            assert_closing(engine, k, group);
+
+            for (unsigned i = 0; i < roots.size(); ++i) {
+                if (!sync_is_pending(i)) {
+                    continue;
+                }
+
+                /* paths of property i */
+                vec<Lit> assumptions;
+                assumptions.push(mkLit(value(engine, roots[i], 0)));
+
+                engine.set_step(k);
+                status = engine.solve(assumptions);
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                if (sat::status_t::STATUS_UNSAT == status) {
+                    continue;
+                }
+
+                expr::Expr_ptr phi { f_results[i].property };
+                step_t loop { loopback(engine, k) };
+
+                witness::Witness_ptr cex {
+                    new CheckCounterExample(phi, model(), engine, k, loop)
+                };
+
+                if (!sync_resolve(i, CHECK_FALSE, k, cex)) {
+                    delete cex;
+                    continue;
+                }
+
+                INFO
+                    << "LTL counterexample exists (k = " << k << "), property `"
+                    << phi
+                    << "` is FALSE."
+                    << std::endl;
+
+                witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+                witness::Witness& w { *cex };
+
+                /* witness identifier */
+                std::ostringstream oss_id;
+                oss_id
+                    << check_trace_prfx
+                    << wm.autoincrement();
+                w.set_id(oss_id.str());
+
+                /* witness description */
+                std::ostringstream oss_desc;
+                oss_desc
+                    << "LTL counterexample for property `"
+                    << phi
+                    << "` in module `"
+                    << model().main_module().name()
+                    << "`";
+                if (0 < loop) {
+                    oss_desc
+                        << ", looping back to step "
+                        << loop;
+                }
+                w.set_desc(oss_desc.str());
+
+                wm.record(w);
+                wm.set_current(w);
+                set_witness(w);
+            }
+
+            engine.retire_last_group();
+            if (0 == sync_pending()) {
+                goto cleanup;
+            }
+
+            if (0 < max_depth && max_depth <= k) {
+                INFO
+                    << "No LTL counterexample found (k <= " << k << ")."
+                    << std::endl;
+
+                goto cleanup;
+            }
+
+            unroll(engine, ++k);
+        } while (0 < sync_pending());
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << engine
+            << std::endl;
+    }
+
+    Check::liveness_t Check::classify(expr::Expr_ptr phi, expr::Expr_ptr& p)
+    {
+        if (em().is_G(phi) && em().is_F(phi->lhs()) &&
+            !has_ltl(em(), phi->lhs()->lhs())) {
+            p = phi->lhs()->lhs();
+            return LIVENESS_RECURRENCE;
+        }
+
+        if ((em().is_G(phi) || em().is_F(phi)) && !has_ltl(em(), phi->lhs())) {
+            p = phi->lhs();
+            return em().is_G(phi) ? LIVENESS_SAFETY : LIVENESS_INITIAL;
+        }
+
+        return LIVENESS_NONE;
+    }
+
+    unsigned Check::collect(expr::Expr_ptr phi)
+    {
+        const auto i { f_indexes.find(phi) };
+        if (f_indexes.end() != i) {
+            return i->second;
+        }
+
+        Subformula subformula;
+        subformula.expr = phi;
+        subformula.lhs = 0;
+        subformula.rhs = 0;
+        subformula.atom = 0;
+        subformula.loop = 0;
+
+        if (em().is_and(phi) || em().is_or(phi) ||
+            em().is_U(phi) || em().is_R(phi)) {
+            subformula.kind = em().is_and(phi) ? LTL_AND
+                              : em().is_or(phi) ? LTL_OR
+                              : em().is_U(phi)  ? LTL_U
+                                                : LTL_R;
+            subformula.lhs = collect(phi->lhs());
+            subformula.rhs = collect(phi->rhs());
+        }
+
+        else if (em().is_X(phi) || em().is_F(phi) || em().is_G(phi)) {
+            subformula.kind = em().is_X(phi) ? LTL_X
+                              : em().is_F(phi) ? LTL_F
+                                               : LTL_G;
+            subformula.lhs = collect(phi->lhs());
+        }
+
+        else {
+            TRACE
+                << "Compiling predicate `"
+                << phi
+                << "` ..."
+                << std::endl;
+
+            subformula.kind = LTL_ATOM;
+            subformula.atom = f_atom_cus.size();
+            f_atom_cus.push_back(compiler().process(em().make_empty(), phi));
+        }
+
+        unsigned res = f_subformulas.size();
+        f_subformulas.push_back(subformula);
+        f_indexes.insert(std::make_pair(phi, res));
+
+        return res;
+    }
+
+    Var Check::value(sat::Engine& engine, unsigned index, step_t time)
+    {
+        sat::VarVector& values { f_subformulas[index].values };
+        while (values.size() <= time) {
+            values.push_back(engine.new_sat_var(true));
+        }
+
+        return values[time];
+    }
+
+    Var Check::eventuality(sat::Engine& engine, unsigned index, step_t time)
+    {
+        sat::VarVector& eventualities { f_subformulas[index].eventualities };
+        while (eventualities.size() <= time) {
+            eventualities.push_back(engine.new_sat_var(true));
+        }
+
+        return eventualities[time];
+    }
+
+    void Check::unroll(sat::Engine& engine, step_t k)
+    {
+        /* FSM and untimed constraints */
+        if (0 == k) {
+            assert_fsm_init(engine, k);
+        } else {
+            assert_fsm_trans(engine, k - 1);
+        }
+        assert_fsm_invar(engine, k);
+
+        for (auto& cu : f_constraint_cus) {
+            assert_formula(engine, k, cu);
+        }
+
+        /* loop selectors, l_k -> s_(k - 1) = s_E. in_loop_k holds iff
+           some l_j holds for j <= k, and at most one does */
+        Var in_loop { engine.new_sat_var(true) };
+        Var selector { engine.new_sat_var(true) };
+
+        if (0 == k) {
+            add_clause(engine, { mkLit(in_loop, true) });
+            add_clause(engine, { mkLit(selector, true) });
+        } else {
+            Var prev { f_in_loop[k - 1] };
+            assert_fsm_join(engine, k - 1, UINT_MAX, selector);
+
+            add_clause(engine, { mkLit(in_loop, true), mkLit(prev), mkLit(selector) });
+            add_clause(engine, { mkLit(in_loop), mkLit(prev, true) });
+            add_clause(engine, { mkLit(in_loop), mkLit(selector, true) });
+            add_clause(engine, { mkLit(prev, true), mkLit(selector, true) });
+        }
+
+        f_loop_selectors.push_back(selector);
+        f_in_loop.push_back(in_loop);
+
+        /* subformulas at time k, only referring to times k and k + 1 */
+        for (unsigned n = 0; n < f_subformulas.size(); ++n) {
+            Subformula& subformula { f_subformulas[n] };
+            Lit x { mkLit(value(engine, n, k), true) };
+
+            switch (subformula.kind) {
+                case LTL_ATOM:
+                    assert_formula(engine, k, f_atom_cus[subformula.atom],
+                                   value(engine, n, k));
+                    break;
+
+                case LTL_AND:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k)) });
+                    add_clause(engine, { x, mkLit(value(engine, subformula.rhs, k)) });
+                    break;
+
+                case LTL_OR:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k)),
+                                         mkLit(value(engine, subformula.rhs, k)) });
+                    break;
+
+                case LTL_X:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k + 1)) });
+                    break;
+
+                case LTL_F:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k)),
+                                         mkLit(value(engine, n, k + 1)) });
+                    break;
+
+                case LTL_G:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k)) });
+                    add_clause(engine, { x, mkLit(value(engine, n, k + 1)) });
+                    break;
+
+                case LTL_U:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.rhs, k)),
+                                         mkLit(value(engine, subformula.lhs, k)) });
+                    add_clause(engine, { x, mkLit(value(engine, subformula.rhs, k)),
+                                         mkLit(value(engine, n, k + 1)) });
+                    break;
+
+                case LTL_R:
+                    add_clause(engine, { x, mkLit(value(engine, subformula.rhs, k)) });
+                    add_clause(engine, { x, mkLit(value(engine, subformula.lhs, k)),
+                                         mkLit(value(engine, n, k + 1)) });
+                    break;
+
+                default:
+                    assert(false); /* unreachable */
+            }
+
+            /* the loop state is the k-th one, if selected */
+            add_clause(engine, { mkLit(selector, true), mkLit(subformula.loop, true),
+                                 mkLit(value(engine, n, k)) });
+
+            /* eventualities, the rhs holds within the loop at some
+               time up to k */
+            if (LTL_F == subformula.kind || LTL_U == subformula.kind) {
+                unsigned rhs { LTL_F == subformula.kind ? subformula.lhs : subformula.rhs };
+                Lit e { mkLit(eventuality(engine, n, k), true) };
+
+                if (0 == k) {
+                    add_clause(engine, { e, mkLit(in_loop) });
+                    add_clause(engine, { e, mkLit(value(engine, rhs, k)) });
+                } else {
+                    Lit prev { mkLit(eventuality(engine, n, k - 1)) };
+                    add_clause(engine, { e, prev, mkLit(in_loop) });
+                    add_clause(engine, { e, prev, mkLit(value(engine, rhs, k)) });
+                }
+            }
+        }
+    }
+
+    void Check::assert_closing(sat::Engine& engine, step_t k, sat::group_t group)
+    {
+        Lit g { mkLit(group, true) };
+        Lit in_loop { mkLit(f_in_loop[k]) };
+
+        assert_fsm_join(engine, k, UINT_MAX, group);
+
+        /* time k + 1 is the state the path loops back to (if any),
+           eventualities must be fulfilled within the loop */
+        for (unsigned n = 0; n < f_subformulas.size(); ++n) {
+            Subformula& subformula { f_subformulas[n] };
+            Lit next { mkLit(value(engine, n, k + 1), true) };
+
+            add_clause(engine, { g, next, mkLit(subformula.loop) });
+            add_clause(engine, { g, mkLit(subformula.loop, true), in_loop });
+
+            if (LTL_F == subformula.kind || LTL_U == subformula.kind) {
+                add_clause(engine, { g, next, mkLit(eventuality(engine, n, k)) });
+            }
+        }
+    }
+
+    step_t Check::loopback(sat::Engine& engine, step_t k)
+    {
+        for (step_t j = 1; j <= k; ++j) {
+            if (engine.value(f_loop_selectors[j])) {
+                return j;
+            }
+        }
+
+        return 0;
+    }
+
+    /* synchronized */
+    PropertyResults Check::results()
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return f_results;
+    }
+
+    /* synchronized */
+    unsigned Check::sync_pending()
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return f_pending;
+    }
+
+    /* synchronized */
+    bool Check::sync_is_pending(unsigned index)
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return CHECK_UNKNOWN == f_results[index].status;
+    }
+
+    /* synchronized, true iff the property was not resolved yet */
+    bool Check::sync_resolve(unsigned index, ltl_status_t status, step_t depth,
+                             witness::Witness_ptr witness)
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+
+        PropertyResult& result { f_results[index] };
+        if (CHECK_UNKNOWN != result.status) {
+            return false;
+        }
+
+        result.status = status;
+        result.depth = depth;
+        result.witness = witness;
+        --f_pending;
+
+        return true;
+    }
+
+    CheckCounterExample::CheckCounterExample(expr::Expr_ptr property, model::Model& model,
+                                             sat::Engine& engine, unsigned k,
+                                             unsigned loopback)
+        : reach::ReachabilityCounterExample(property, model, engine, k)
+        , f_loopback(loopback)
+    {}
+
 } // namespace check
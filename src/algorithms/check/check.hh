@@ -32,8 +32,12 @@
 #include <expr/expr.hh>
 
 #include <algorithms/base.hh>
+#include <algorithms/reach/witness.hh>
+
 #include <witness/witness.hh>
 
+#include <utils/pool.hh>
+
 namespace check {
 
     typedef enum {
@@ -43,33 +47,171 @@ namespace check {
         CHECK_ERROR,
     } ltl_status_t;
 
+    /* outcome for a single property: depth is the length of its
+       counterexample, if any */
+    struct PropertyResult {
+        expr::Expr_ptr property;
+        ltl_status_t status;
+        step_t depth;
+        witness::Witness_ptr witness;
+    };
+
+    typedef std::vector<PropertyResult> PropertyResults;
+
+    /* Incremental linear encoding of bounded LTL model checking
+     * (Biere, Heljanko, Junttila, Latvala, Schuppan). Counterexamples
+     * are paths of k + 1 states satisfying the NNF of !phi, possibly
+     * looping back: loop selector l_j (0 < j <= k) states the k-th
+     * state is the same as the (j - 1)-th, so that the successor of
+     * the k-th state is the j-th one. The encoding of each subformula
+     * at time i only refers to times i and i + 1, frames are shared
+     * across k and each step only adds O(|phi|) clauses. The only
+     * k-dependent clauses (closing the path at time k) are asserted
+     * in a group of their own, retired when k is increased.
+     *
+     * BMC alone only finds counterexamples. Properties G p, F p and
+     * G F p, for a predicate p, are also proved by a liveness to
+     * safety reduction running alongside (see liveness.cc).
+     *
+     * Several properties share a single unrolling: their subformulas
+     * are collected in the same table (common subformulas are encoded
+     * once), and each property is checked at each k under the
+     * assumption of its root at time 0. A property found FALSE is no
+     * longer assumed, the others keep the frames and the learnts. */
     class Check: public algorithms::Algorithm {
 
     public:
         Check(cmd::Command& command, model::Model& model);
         ~Check();
 
-        void process(const expr::Expr_ptr phi);
+        /* looks for counterexamples of length up to max_depth, with
+           no limit if max_depth is zero */
+        void process(const expr::ExprVector& properties, expr::ExprVector constraints,
+                     step_t max_depth = 0);
 
+        /* overall: FALSE if some property is, TRUE if all are */
         inline ltl_status_t status() const
         {
             return f_status;
         }
 
+        /* synchronized, a copy */
+        PropertyResults results();
+
         inline void set_status(ltl_status_t status)
         {
             f_status = status;
         }
 
     private:
+        /* properties with complete answers, see liveness_strategy() */
+        typedef enum {
+            LIVENESS_NONE,
+            LIVENESS_SAFETY,     /* G p */
+            LIVENESS_INITIAL,    /* F p */
+            LIVENESS_RECURRENCE, /* G F p */
+        } liveness_t;
+
+        typedef enum {
+            LTL_ATOM,
+            LTL_AND,
+            LTL_OR,
+            LTL_X,
+            LTL_F,
+            LTL_G,
+            LTL_U,
+            LTL_R,
+        } subformula_t;
+
+        /* subformulas are numbered bottom-up, operands have smaller
+           indexes than the operators they belong to */
+        struct Subformula {
+            subformula_t kind;
+            expr::Expr_ptr expr;
+            unsigned lhs;
+            unsigned rhs;
+
+            /* compiled predicate (atoms only) */
+            unsigned atom;
+
+            /* value on the state the path loops back to */
+            Var loop;
+
+            /* values at time 0, 1, ...; the eventualities (U and F
+               only) are true at time i only if the rhs holds at some
+               time 0 < j <= i within the loop */
+            sat::VarVector values;
+            sat::VarVector eventualities;
+        };
+
+        typedef std::vector<Subformula> Subformulas;
+
         ltl_status_t f_status;
+
+        boost::mutex f_results_mutex;
+        PropertyResults f_results;
+        unsigned f_pending;
+
+        Subformulas f_subformulas;
+        boost::unordered_map<expr::Expr_ptr, unsigned,
+                             utils::PtrHash, utils::PtrEq> f_indexes;
+        compiler::Units f_atom_cus;
+
+        /* untimed constraints, asserted at all times */
+        compiler::Units f_constraint_cus;
+
+        /* loop selectors and in-loop vars, indexed by time */
+        sat::VarVector f_loop_selectors;
+        sat::VarVector f_in_loop;
+
+        /* checking strategies */
+        void bmc_strategy(std::vector<unsigned> roots, step_t max_depth);
+        void liveness_strategy(compiler::Unit& bad_cu, liveness_t kind, unsigned index);
+
+        /* the kind of phi, p is set to its predicate (if any) */
+        liveness_t classify(expr::Expr_ptr phi, expr::Expr_ptr& p);
+
+        /* synchronized */
+        unsigned sync_pending();
+        bool sync_is_pending(unsigned index);
+        bool sync_resolve(unsigned index, ltl_status_t status, step_t depth,
+                          witness::Witness_ptr witness = NULL);
+
+        /* collects the subformulas of the NNF formula phi, returns
+           the index of phi */
+        unsigned collect(expr::Expr_ptr phi);
+
+        /* the value of the i-th subformula at time, created if needed */
+        Var value(sat::Engine& engine, unsigned index, step_t time);
+        Var eventuality(sat::Engine& engine, unsigned index, step_t time);
+
+        /* FSM, loop selectors and subformulas encoding at time k */
+        void unroll(sat::Engine& engine, step_t k);
+
+        /* closes the path at time k, in group. The state at time k is
+           copied to a frame of its own (at time UINT_MAX), so that
+           loop selectors need not refer to k */
+        void assert_closing(sat::Engine& engine, step_t k, sat::group_t group);
+
+        /* the time the path found in engine loops back to, zero if
+           none */
+        step_t loopback(sat::Engine& engine, step_t k);
     };
 
-    /* Specialized for LTL CEX */
-    class CheckCounterExample: public witness::Witness {
+    /* Specialized for LTL CEX, loopback is the time the successor of
+       the last state loops back to, zero for finite paths */
+    class CheckCounterExample: public reach::ReachabilityCounterExample {
     public:
         CheckCounterExample(expr::Expr_ptr property, model::Model& model,
-                            sat::Engine& engine, unsigned k);
+                            sat::Engine& engine, unsigned k, unsigned loopback);
+
+        inline unsigned loopback() const
+        {
+            return f_loopback;
+        }
+
+    private:
+        unsigned f_loopback;
     };
 
 } // namespace check
@@ -0,0 +1,180 @@
+/**
+ * @file check/liveness.cc
+ * @brief SAT-based liveness to safety reduction for LTL properties checking
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithms/check/check.hh>
+#include <algorithms/scheduler.hh>
+
+namespace check {
+
+    /* Counterexamples of G F p (resp. F p) are lassos of !p states,
+     * starting from a reachable (resp. initial) state. As the model is
+     * finite, no such lasso exists iff for some K no run of K + 1 !p
+     * states starts from one of those states: this is a safety
+     * property, for growing values of K (G p is just the K = 0 case).
+     *
+     * Reachable states are first bounded by the recurrence diameter:
+     * if no simple path of n + 1 states exists, all reachable states
+     * are found at times 0, .., n - 1. Then, a selector c_i for each
+     * such time i states a run of !p starts at i, and K is increased
+     * by asserting c_i -> !p at time i + K, until UNSAT. The
+     * unrolling is shared across all values of K. Counterexamples are
+     * left to the BMC strategy. One such strategy runs for each
+     * property of the kind, index is that of the property. */
+    void Check::liveness_strategy(compiler::Unit& bad_cu, liveness_t kind, unsigned index)
+    {
+        sat::Engine engine { "liveness" };
+        setup_engine(engine);
+
+        /* simple-path constraints only bound the reachable states */
+        guard_simple_path(engine);
+
+        step_t top { 0 };
+        step_t depth { 1 };
+        step_t K { 0 };
+
+        sat::VarVector starts;
+        vec<Lit> ps;
+
+        sat::status_t status;
+
+        assert_fsm_init(engine, top);
+        assert_fsm_invar(engine, top);
+        for (auto& cu : f_constraint_cus) {
+            assert_formula(engine, top, cu);
+        }
+
+        if (LIVENESS_INITIAL != kind) {
+            do {
+                /* give way to waiting strategies, if any */
+                algorithms::Scheduler::INSTANCE().yield();
+
+                /* found FALSE meanwhile */
+                if (!sync_is_pending(index)) {
+                    goto done;
+                }
+
+                assert_fsm_trans(engine, top);
+                ++top;
+                assert_fsm_invar(engine, top);
+                for (auto& cu : f_constraint_cus) {
+                    assert_formula(engine, top, cu);
+                }
+                assert_fsm_simple_path(engine, top);
+
+                INFO
+                    << "Now looking for reachable states diameter (k = " << top << ")..."
+                    << std::endl;
+
+                engine.set_step(top);
+                status = solve_simple_path(engine, top);
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+            } while (sat::status_t::STATUS_SAT == status);
+
+            depth = top;
+
+            step_t diameter { depth - 1 };
+            INFO
+                << "All reachable states are found within "
+                << diameter
+                << " steps."
+                << std::endl;
+        }
+
+        for (step_t i = 0; i < depth; ++i) {
+            Var start { engine.new_sat_var(true) };
+
+            starts.push_back(start);
+            ps.push(mkLit(start));
+        }
+        engine.add_clause(ps);
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            for (step_t i = 0; i < depth; ++i) {
+                while (top < i + K) {
+                    assert_fsm_trans(engine, top);
+                    ++top;
+                    assert_fsm_invar(engine, top);
+                    for (auto& cu : f_constraint_cus) {
+                        assert_formula(engine, top, cu);
+                    }
+                }
+
+                assert_formula(engine, i + K, bad_cu, starts[i]);
+            }
+
+            step_t length { K + 1 };
+            INFO
+                << "Now looking for runs of "
+                << length
+                << " violating states..."
+                << std::endl;
+
+            engine.set_step(depth - 1 + K);
+            status = engine.solve();
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No runs of "
+                    << length
+                    << " violating states exist, property is TRUE."
+                    << std::endl;
+
+                sync_resolve(index, CHECK_TRUE, K);
+
+                /* other properties are still being checked */
+                if (0 < sync_pending()) {
+                    goto done;
+                }
+                goto cleanup;
+            }
+
+            /* a reachable violating state, the counterexample is left
+               to BMC */
+            else if (LIVENESS_SAFETY == kind) {
+                goto done;
+            }
+
+            ++K;
+        } while (sync_is_pending(index));
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+    done:
+        INFO
+            << engine
+            << std::endl;
+    } /* Check::liveness_strategy() */
+
+} // namespace check
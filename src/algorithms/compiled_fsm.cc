@@ -0,0 +1,310 @@
+/**
+ * @file compiled_fsm.cc
+ * @brief Compiled FSM, shared among commands
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include <compiled_fsm.hh>
+
+#include <env/environment.hh>
+
+#include <expr/collector.hh>
+
+#include <model/model_mgr.hh>
+
+#include <symb/classes.hh>
+#include <symb/symb_iter.hh>
+
+#include <utils/logging.hh>
+
+namespace algorithms {
+
+    CompiledFSMMgr::CompiledFSMMgr()
+        : f_model(NULL)
+        , f_state_bits_model(NULL)
+        , f_state_bits_nbits(0)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized CompiledFSMMgr @"
+            << instance
+            << std::endl;
+
+        expr::ExprCollector& collector { expr::ExprCollector::INSTANCE() };
+        collector.add_roots(
+            "compiled FSM", [this](expr::ExprMarker& marker) {
+                boost::mutex::scoped_lock lock { f_mutex };
+
+                for (const compiler::Units* units : { &f_init, &f_not_init, &f_invar, &f_trans }) {
+                    for (const auto& unit : *units) {
+                        unit.mark(marker);
+                    }
+                }
+
+                if (f_state_bits) {
+                    for (const auto& bit : *f_state_bits) {
+                        marker.mark(bit.ucbi.expr());
+                        marker.mark(bit.var);
+                    }
+                }
+            });
+
+        /* sections whose bodies are gone can not be fetched again */
+        collector.add_cache(
+            "compiled sections", [this](expr::ExprMarker& marker) {
+                boost::mutex::scoped_lock lock { f_mutex };
+
+                SectionMap::iterator i { f_sections.begin() };
+                while (i != f_sections.end()) {
+                    const SectionKey& key { i->first };
+
+                    if (marker.is_marked(key.second.first) &&
+                        marker.is_marked(key.second.second)) {
+                        for (const auto& unit : i->second) {
+                            unit.mark(marker);
+                        }
+                        ++i;
+                    } else {
+                        i = f_sections.erase(i);
+                    }
+                }
+            });
+    }
+
+    CompiledFSMMgr::~CompiledFSMMgr()
+    {
+        TRACE
+            << "Destroyed CompiledFSMMgr"
+            << std::endl;
+    }
+
+    std::string CompiledFSMMgr::env_signature()
+    {
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        /* identifiers are not ordered */
+        std::vector<std::string> inputs;
+        for (auto id : env.identifiers()) {
+            std::ostringstream oss;
+            oss
+                << id
+                << " = "
+                << env.get(id);
+
+            inputs.push_back(oss.str());
+        }
+        std::sort(inputs.begin(), inputs.end());
+
+        std::ostringstream oss;
+        for (const auto& input : inputs) {
+            oss
+                << "input "
+                << input
+                << std::endl;
+        }
+        /* extra constraints are not part of the compiled FSM, see
+           Algorithm::compile_env_constraints() */
+        return oss.str();
+    }
+
+    bool CompiledFSMMgr::fetch(const model::Model& model, compiler::Units& init,
+                               compiler::Units& not_init, compiler::Units& invar,
+                               compiler::Units& trans)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (&model != f_model || env_signature() != f_env_signature) {
+            return false;
+        }
+
+        init = f_init;
+        not_init = f_not_init;
+        invar = f_invar;
+        trans = f_trans;
+
+        return true;
+    }
+
+    void CompiledFSMMgr::store(const model::Model& model, const compiler::Units& init,
+                               const compiler::Units& not_init, const compiler::Units& invar,
+                               const compiler::Units& trans)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_model = &model;
+        f_env_signature = env_signature();
+
+        f_init = init;
+        f_not_init = not_init;
+        f_invar = invar;
+        f_trans = trans;
+    }
+
+    bool CompiledFSMMgr::fetch_section(int kind, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                                       compiler::Units& units)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (env_signature() != f_sections_env_signature) {
+            f_sections.clear();
+            return false;
+        }
+
+        SectionMap::const_iterator i {
+            f_sections.find(std::make_pair(kind, std::make_pair(ctx, body)))
+        };
+        if (f_sections.end() == i) {
+            return false;
+        }
+
+        units = i->second;
+        return true;
+    }
+
+    void CompiledFSMMgr::store_section(int kind, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                                       const compiler::Units& units)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        std::string signature { env_signature() };
+        if (signature != f_sections_env_signature) {
+            f_sections.clear();
+            f_sections_env_signature = signature;
+        }
+
+        f_sections[std::make_pair(kind, std::make_pair(ctx, body))] = units;
+    }
+
+    StateBits_ptr CompiledFSMMgr::state_bits(model::Model& model)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        unsigned nbits { bm.nbits() };
+        if (f_state_bits && &model == f_state_bits_model && nbits == f_state_bits_nbits) {
+            return f_state_bits;
+        }
+
+        StateBits* res { new StateBits() };
+
+        symb::SymbIter symbols { model };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symbol { pair.second };
+
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+            expr::Expr_ptr full { em.make_dot(ctx, var.name()) };
+
+            enc::Encoding_ptr enc { bm.find_encoding(expr::TimedExpr(full, 0)) };
+            if (!enc) {
+                continue;
+            }
+
+            bool dead { !mm.is_live(full) };
+            for (const auto& bit : enc->bits()) {
+                StateBit state_bit {
+                    bm.find_ucbi(bit.getNode()->index), full,
+                    var.is_input(), var.is_frozen(), var.is_temp(), dead
+                };
+                res->push_back(state_bit);
+            }
+        }
+
+        unsigned n_state_bits { (unsigned) res->size() };
+        DEBUG
+            << "Built state bits table ("
+            << n_state_bits
+            << " bits)"
+            << std::endl;
+
+        f_state_bits_model = &model;
+        f_state_bits_nbits = nbits;
+        f_state_bits.reset(res);
+
+        return f_state_bits;
+    }
+
+    void CompiledFSMMgr::invalidate()
+    {
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_model = NULL;
+        f_env_signature.clear();
+
+        f_init.clear();
+        f_not_init.clear();
+        f_invar.clear();
+        f_trans.clear();
+
+        f_state_bits_model = NULL;
+        f_state_bits.reset();
+
+        unsigned n_sections { (unsigned) f_sections.size() };
+        for (SectionMap::iterator i = f_sections.begin(); i != f_sections.end(); ) {
+            if (mm.changed(i->first.second.first)) {
+                i = f_sections.erase(i);
+            } else {
+                ++i;
+            }
+        }
+
+        unsigned n_kept { (unsigned) f_sections.size() };
+        DEBUG
+            << "Kept "
+            << n_kept
+            << " compiled sections out of "
+            << n_sections
+            << std::endl;
+    }
+
+    void CompiledFSMMgr::clear()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_model = NULL;
+        f_env_signature.clear();
+
+        f_init.clear();
+        f_not_init.clear();
+        f_invar.clear();
+        f_trans.clear();
+
+        f_sections_env_signature.clear();
+        f_sections.clear();
+
+        f_state_bits_model = NULL;
+        f_state_bits.reset();
+    }
+
+} // namespace algorithms
@@ -0,0 +1,144 @@
+/**
+ * @file compiled_fsm.hh
+ * @brief Compiled FSM, shared among commands
+ *
+ * This header file contains the declarations required to reuse the
+ * compiled INIT, INVAR and TRANS units of a model across commands.
+ * Units are compiled by the first algorithm set up on the model, and
+ * taken from here by the following ones, as long as the environment
+ * (INPUT values and extra constraints) is unchanged. Entries are
+ * dropped when a new model is read.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILED_FSM_H
+#define COMPILED_FSM_H
+
+#include <string>
+#include <utility>
+
+#include <compiler/compiler.hh>
+
+#include <enc/ucbi.hh>
+
+#include <model/model.hh>
+
+#include <utils/context.hh>
+
+#include <boost/functional/hash.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace algorithms {
+
+    /* a bit of the encoding of a var at time 0, flags of the var
+       included */
+    struct StateBit {
+        enc::UCBI ucbi;
+
+        /* fully qualified name */
+        expr::Expr_ptr var;
+
+        bool input;
+        bool frozen;
+        bool temp;
+
+        /* INIT, INVAR and TRANS do not depend on the var, see
+           model::ModelMgr::is_live */
+        bool dead;
+    };
+
+    /* all of them, in model order */
+    typedef std::vector<StateBit> StateBits;
+    typedef boost::shared_ptr<const StateBits> StateBits_ptr;
+
+    typedef class CompiledFSMMgr* CompiledFSMMgr_ptr;
+
+    class CompiledFSMMgr {
+    public:
+        /* true iff the units compiled for model under the current
+           environment are available, they are copied into the given
+           containers */
+        bool fetch(const model::Model& model, compiler::Units& init,
+                   compiler::Units& not_init, compiler::Units& invar,
+                   compiler::Units& trans);
+
+        void store(const model::Model& model, const compiler::Units& init,
+                   const compiler::Units& not_init, const compiler::Units& invar,
+                   const compiler::Units& trans);
+
+        /* units of a single section body (and of its negation, for
+           INITs), compiled under the current environment */
+        bool fetch_section(int kind, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                           compiler::Units& units);
+
+        void store_section(int kind, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                           const compiler::Units& units);
+
+        /* the state bits of model, built once per model and set of
+           encodings (i.e. until new DD vars are made) */
+        StateBits_ptr state_bits(model::Model& model);
+
+        /* after reading a model again, the FSM is dropped along with
+           the sections of the module instances that changed */
+        void invalidate();
+
+        void clear();
+
+        static CompiledFSMMgr& INSTANCE()
+        {
+            return utils::Context::current().instance<CompiledFSMMgr>(
+                utils::CONTEXT_COMPILED_FSM, []() { return new CompiledFSMMgr(); });
+        }
+
+    protected:
+        CompiledFSMMgr();
+        ~CompiledFSMMgr();
+
+    private:
+        /* INPUT values, printed */
+        std::string env_signature();
+
+        boost::mutex f_mutex;
+
+        const model::Model* f_model;
+        std::string f_env_signature;
+
+        compiler::Units f_init;
+        compiler::Units f_not_init;
+        compiler::Units f_invar;
+        compiler::Units f_trans;
+
+        /* (kind, (ctx, body)) */
+        typedef std::pair<int, std::pair<expr::Expr_ptr, expr::Expr_ptr>> SectionKey;
+        typedef boost::unordered_map<SectionKey, compiler::Units> SectionMap;
+
+        std::string f_sections_env_signature;
+        SectionMap f_sections;
+
+        const model::Model* f_state_bits_model;
+        unsigned f_state_bits_nbits;
+        StateBits_ptr f_state_bits;
+    };
+
+} // namespace algorithms
+
+#endif /* COMPILED_FSM_H */
@@ -0,0 +1,449 @@
+/**
+ * @file aiger.cc
+ * @brief FSM export as an And-Inverter Graph (AIGER) implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <algorithms/fsm/fsm.hh>
+
+#include <symb/proxy.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace fsm {
+
+    namespace {
+
+        /* a bit of a var, as referred to by the CNF. Frozen bits
+           have a single value. AIGER literals are those of the
+           current value, of the next one, and (for inputs whose next
+           value is referred to) of the previous one */
+        struct Bit {
+            expr::Expr_ptr var;
+            unsigned bitno;
+
+            bool input;
+            bool frozen;
+            bool boolean;
+            bool next;
+
+            unsigned now;
+            unsigned succ;
+            unsigned prev;
+        };
+
+        /* the CNF recorded by an engine, as zero terminated DIMACS
+           clauses and the assumptions of its groups. Aux vars are
+           mapped to AIGER literals by DIMACS var */
+        struct Cnf {
+            std::vector<int> clauses;
+            std::vector<int> units;
+            std::vector<unsigned> aux;
+        };
+
+        struct Latch {
+            unsigned lit;
+            unsigned next;
+            unsigned reset;
+            std::string name;
+        };
+
+        /* AND gates on the literals allocated so far, structurally
+           hashed. Gates come in order, each after its operands */
+        class AigBuilder {
+        public:
+            AigBuilder(unsigned n_vars)
+                : f_n_vars(n_vars)
+            {}
+
+            unsigned make_and(unsigned lhs, unsigned rhs)
+            {
+                if (lhs < rhs) {
+                    std::swap(lhs, rhs);
+                }
+
+                if (0 == rhs || lhs == (rhs ^ 1)) {
+                    return 0;
+                }
+                if (1 == rhs || lhs == rhs) {
+                    return lhs;
+                }
+
+                const std::pair<unsigned, unsigned> key { lhs, rhs };
+                auto eye { f_gates_map.find(key) };
+                if (f_gates_map.end() != eye) {
+                    return eye->second;
+                }
+
+                unsigned res { 2 * ++f_n_vars };
+                f_gates.push_back(std::make_pair(res, key));
+                f_gates_map.insert(std::make_pair(key, res));
+
+                return res;
+            }
+
+            inline unsigned make_or(unsigned lhs, unsigned rhs)
+            {
+                return make_and(lhs ^ 1, rhs ^ 1) ^ 1;
+            }
+
+            inline unsigned make_iff(unsigned lhs, unsigned rhs)
+            {
+                return make_or(make_and(lhs, rhs), make_and(lhs ^ 1, rhs ^ 1));
+            }
+
+            inline unsigned n_vars() const
+            {
+                return f_n_vars;
+            }
+
+            /* (lhs, (rhs0, rhs1)), rhs0 >= rhs1 */
+            inline const std::vector<std::pair<unsigned, std::pair<unsigned, unsigned>>>& gates() const
+            {
+                return f_gates;
+            }
+
+        private:
+            unsigned f_n_vars;
+
+            std::vector<std::pair<unsigned, std::pair<unsigned, unsigned>>> f_gates;
+            boost::unordered_map<std::pair<unsigned, unsigned>, unsigned> f_gates_map;
+        };
+
+        /* binary AND gates, 7 bits at a time */
+        void write_delta(std::ostream& os, unsigned delta)
+        {
+            while (0x7f < delta) {
+                os.put((char) (0x80 | (delta & 0x7f)));
+                delta >>= 7;
+            }
+            os.put((char) delta);
+        }
+
+    } // namespace
+
+    AigerExport::AigerExport(cmd::Command& command, model::Model& model)
+        : algorithms::Algorithm { command, model }
+    {
+        const void* instance { this };
+        TRACE
+            << "Created AigerExport @"
+            << instance
+            << std::endl;
+    }
+
+    AigerExport::~AigerExport()
+    {
+        const void* instance { this };
+        TRACE
+            << "Destroyed AigerExport @"
+            << instance
+            << std::endl;
+    }
+
+    /* The AIG runs one step of the FSM per clock cycle: latches hold
+     * the current state, its successor is an input, which the TRANS
+     * clauses constrain. Hence the next value of an input is an input
+     * too, and is latched to be checked against the actual value on
+     * the next cycle. INIT is only required before the first cycle,
+     * when a latch of its own is still 0. Everything but bad states
+     * is a single invariant constraint: as constraints hold on every
+     * cycle, including the last one, bad states are only reached with
+     * a successor (i.e. the FSM is assumed not to deadlock). */
+    bool AigerExport::process(expr::Expr_ptr target, std::ostream& os, bool binary)
+    {
+        symb::ResolverProxy resolver;
+
+        sat::Engine init_engine { "aiger_init" };
+        sat::Engine trans_engine { "aiger_trans" };
+        sat::Engine bad_engine { "aiger_bad" };
+
+        sat::Engine* engines[] { &init_engine, &trans_engine, &bad_engine };
+        for (auto engine : engines) {
+            setup_engine(*engine);
+            engine->record_cnf();
+        }
+
+        assert_fsm_init(init_engine, 0);
+        assert_fsm_invar(trans_engine, 0);
+        assert_fsm_trans(trans_engine, 0);
+
+        if (NULL != target) {
+            compiler::Unit unit { compiler().process(em().make_empty(), target) };
+            assert_formula(bad_engine, 0, unit);
+        }
+
+        /* the bits referred to, and the aux vars of each CNF */
+        std::vector<Bit> bits;
+        boost::unordered_map<std::pair<expr::Expr_ptr, unsigned>, unsigned> bit_index;
+
+        Cnf cnfs[3];
+        for (unsigned i = 0; i < 3; ++i) {
+            sat::Engine& engine { *engines[i] };
+            Cnf& cnf { cnfs[i] };
+
+            engine.recorded_clauses(0, cnf.clauses);
+            engine.query_assumptions(cnf.units);
+
+            for (const auto* lits : { &cnf.clauses, &cnf.units }) {
+                for (int lit : *lits) {
+                    if (0 == lit) {
+                        continue;
+                    }
+
+                    Var var { abs(lit) - 1 };
+                    if (!engine.is_model_var(var)) {
+                        if ((int) cnf.aux.size() <= abs(lit)) {
+                            cnf.aux.resize(1 + abs(lit), 0);
+                        }
+                        cnf.aux[abs(lit)] = 1;
+                        continue;
+                    }
+
+                    const enc::TCBI& tcbi { engine.var_to_tcbi(var) };
+                    bool frozen { FROZEN == tcbi.time() };
+                    if (!frozen && 1 < tcbi.absolute_time()) {
+                        WARN
+                            << "The FSM depends on absolute times, which AIGs can not express"
+                            << std::endl;
+
+                        return false;
+                    }
+
+                    std::pair<expr::Expr_ptr, unsigned> key { tcbi.expr(), tcbi.bitno() };
+                    auto eye { bit_index.find(key) };
+                    if (bit_index.end() == eye) {
+                        symb::Variable& variable { resolver.symbol(tcbi.expr())->as_variable() };
+
+                        Bit bit { tcbi.expr(), tcbi.bitno(), variable.is_input(), frozen,
+                                  variable.type()->is_boolean(), false, 0, 0, 0 };
+                        eye = bit_index.insert(std::make_pair(key, bits.size())).first;
+                        bits.push_back(bit);
+                    }
+
+                    Bit& bit { bits[eye->second] };
+                    bit.frozen = bit.frozen || frozen;
+                    bit.next = bit.next || (!frozen && 1 == tcbi.absolute_time());
+                }
+            }
+        }
+
+        /* inputs first (current inputs, successors, aux vars), then
+           latches (state, previous inputs, the first cycle flag) */
+        unsigned n_vars { 0 };
+        std::vector<std::pair<unsigned, std::string>> inputs;
+
+        auto name_of = [](const Bit& bit) {
+            std::ostringstream oss;
+            oss << bit.var;
+            if (!bit.boolean) {
+                oss << "[" << bit.bitno << "]";
+            }
+            return oss.str();
+        };
+
+        for (auto& bit : bits) {
+            if (bit.input && !bit.frozen) {
+                bit.now = 2 * ++n_vars;
+                inputs.push_back(std::make_pair(bit.now, name_of(bit)));
+            }
+        }
+        for (auto& bit : bits) {
+            if (!bit.frozen && (bit.next || !bit.input)) {
+                bit.succ = 2 * ++n_vars;
+                inputs.push_back(std::make_pair(bit.succ, "next(" + name_of(bit) + ")"));
+            }
+        }
+        for (auto& cnf : cnfs) {
+            for (int var = 1; var < (int) cnf.aux.size(); ++var) {
+                if (!cnf.aux[var]) {
+                    continue;
+                }
+
+                cnf.aux[var] = 2 * ++n_vars;
+                inputs.push_back(std::make_pair(cnf.aux[var], std::string()));
+            }
+        }
+
+        std::vector<Latch> latches;
+        for (auto& bit : bits) {
+            if (!bit.input || bit.frozen) {
+                bit.now = 2 * ++n_vars;
+
+                /* uninitialized, INIT decides */
+                Latch latch { bit.now, bit.frozen ? bit.now : bit.succ, bit.now, name_of(bit) };
+                latches.push_back(latch);
+            }
+        }
+        for (auto& bit : bits) {
+            if (bit.input && !bit.frozen && bit.next) {
+                bit.prev = 2 * ++n_vars;
+
+                Latch latch { bit.prev, bit.succ, 0, "prev(" + name_of(bit) + ")" };
+                latches.push_back(latch);
+            }
+        }
+
+        unsigned started { 2 * ++n_vars };
+        Latch latch { started, 1, 0, "__started" };
+        latches.push_back(latch);
+
+        AigBuilder aig { n_vars };
+
+        auto literal = [&](unsigned i, int lit) {
+            sat::Engine& engine { *engines[i] };
+            Var var { abs(lit) - 1 };
+
+            unsigned res;
+            if (engine.is_model_var(var)) {
+                const enc::TCBI& tcbi { engine.var_to_tcbi(var) };
+                const Bit& bit { bits[bit_index[std::make_pair(tcbi.expr(), tcbi.bitno())]] };
+
+                res = (bit.frozen || 0 == tcbi.absolute_time()) ? bit.now : bit.succ;
+            } else {
+                res = cnfs[i].aux[abs(lit)];
+            }
+
+            return lit < 0 ? res ^ 1 : res;
+        };
+
+        auto conjunction = [&](unsigned i) {
+            const Cnf& cnf { cnfs[i] };
+
+            unsigned res { 1 };
+            unsigned clause { 0 };
+            for (int lit : cnf.clauses) {
+                if (0 == lit) {
+                    res = aig.make_and(res, clause);
+                    clause = 0;
+                } else {
+                    clause = aig.make_or(clause, literal(i, lit));
+                }
+            }
+            for (int lit : cnf.units) {
+                res = aig.make_and(res, literal(i, lit));
+            }
+
+            return res;
+        };
+
+        unsigned init { conjunction(0) };
+        unsigned trans { conjunction(1) };
+        unsigned bad { NULL != target ? conjunction(2) : 0 };
+
+        unsigned history { 1 };
+        for (const auto& bit : bits) {
+            if (bit.prev) {
+                history = aig.make_and(history,
+                                       aig.make_or(started ^ 1, aig.make_iff(bit.now, bit.prev)));
+            }
+        }
+
+        unsigned constraint {
+            aig.make_and(aig.make_and(aig.make_or(started, init), trans), history)
+        };
+
+        unsigned n_bads { NULL != target ? 1U : 0U };
+        unsigned n_constraints { 1 != constraint ? 1U : 0U };
+
+        /* M I L O A B C */
+        os
+            << (binary ? "aig " : "aag ")
+            << aig.n_vars() << " "
+            << inputs.size() << " "
+            << latches.size() << " 0 "
+            << aig.gates().size() << " "
+            << n_bads << " "
+            << n_constraints
+            << "\n";
+
+        if (!binary) {
+            for (const auto& input : inputs) {
+                os << input.first << "\n";
+            }
+        }
+        for (const auto& latch : latches) {
+            if (!binary) {
+                os << latch.lit << " ";
+            }
+            os << latch.next;
+            if (0 != latch.reset) {
+                os << " " << latch.reset;
+            }
+            os << "\n";
+        }
+        if (n_bads) {
+            os << bad << "\n";
+        }
+        if (n_constraints) {
+            os << constraint << "\n";
+        }
+
+        for (const auto& gate : aig.gates()) {
+            if (binary) {
+                write_delta(os, gate.first - gate.second.first);
+                write_delta(os, gate.second.first - gate.second.second);
+            } else {
+                os
+                    << gate.first << " "
+                    << gate.second.first << " "
+                    << gate.second.second
+                    << "\n";
+            }
+        }
+
+        /* symbols, aux vars are left unnamed */
+        for (unsigned i = 0; i < inputs.size(); ++i) {
+            if (!inputs[i].second.empty()) {
+                os << "i" << i << " " << inputs[i].second << "\n";
+            }
+        }
+        for (unsigned i = 0; i < latches.size(); ++i) {
+            os << "l" << i << " " << latches[i].name << "\n";
+        }
+        if (n_bads) {
+            os << "b0 " << target << "\n";
+        }
+        if (n_constraints) {
+            os << "c0 fsm\n";
+        }
+        os
+            << "c\n"
+            << "written by yasmv\n";
+
+        INFO
+            << "Wrote AIG with "
+            << inputs.size()
+            << " inputs, "
+            << latches.size()
+            << " latches and "
+            << aig.gates().size()
+            << " gates"
+            << std::endl;
+
+        return true;
+    }
+
+}; // namespace fsm
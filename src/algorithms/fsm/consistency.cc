@@ -0,0 +1,241 @@
+/**
+ * @file consistency.cc
+ * @brief SAT-based FSM consistency checks, unsat cores implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <numeric>
+
+#include <algorithms/fsm/fsm.hh>
+#include <algorithms/scheduler.hh>
+
+namespace fsm {
+
+    ConsistencyCheck::ConsistencyCheck(cmd::Command& command, model::Model& model,
+                                       pconst_char engine_name)
+        : algorithms::Algorithm(command, model)
+        , f_engine_name(engine_name)
+        , f_status(FSM_CONSISTENCY_UNDECIDED)
+    {}
+
+    ConsistencyCheck::~ConsistencyCheck()
+    {}
+
+    void ConsistencyCheck::add_constraint(pconst_char kind, const compiler::Unit& unit,
+                                          ConstraintAsserter asserter)
+    {
+        Candidate candidate { { kind, unit.expr() }, unit, asserter };
+        f_candidates.push_back(candidate);
+    }
+
+    void ConsistencyCheck::compile_constraints(const expr::ExprVector& constraints)
+    {
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        for (auto constraint : constraints) {
+            INFO
+                << "Compiling constraint `"
+                << constraint
+                << "` ..."
+                << std::endl;
+
+            f_constraint_cus.push_back(compiler().process(ctx, constraint));
+        }
+
+        unsigned nconstraints { (unsigned) f_constraint_cus.size() };
+        INFO
+            << nconstraints
+            << " additional constraints found."
+            << std::endl;
+    }
+
+    void ConsistencyCheck::check()
+    {
+        unsigned n { (unsigned) f_candidates.size() };
+
+        /* candidates sharing some var are in the same partition */
+        std::vector<unsigned> parent(n);
+        std::iota(parent.begin(), parent.end(), 0);
+
+        auto find = [&parent](unsigned i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+
+        boost::unordered_map<expr::Expr_ptr, unsigned,
+                             utils::PtrHash, utils::PtrEq>
+            owners;
+        for (unsigned i = 0; i < n; ++i) {
+            algorithms::Support support;
+            collect_support(f_candidates[i].unit, support);
+
+            for (auto var : support) {
+                auto j { owners.find(var) };
+                if (owners.end() == j) {
+                    owners.insert(std::make_pair(var, i));
+                } else {
+                    parent[find(i)] = find(j->second);
+                }
+            }
+        }
+
+        /* partitions are in the order of their first candidate */
+        boost::unordered_map<unsigned, unsigned> partition_of;
+        for (unsigned i = 0; i < n; ++i) {
+            unsigned root { find(i) };
+
+            auto j { partition_of.find(root) };
+            if (partition_of.end() == j) {
+                partition_of.insert(std::make_pair(root, (unsigned) f_partitions.size()));
+                f_partitions.push_back(std::vector<unsigned>(1, i));
+            } else {
+                f_partitions[j->second].push_back(i);
+            }
+        }
+        f_partition_cores.assign(f_partitions.size(), ConsistencyCore());
+
+        unsigned n_partitions { (unsigned) f_partitions.size() };
+        INFO
+            << "Checking "
+            << n
+            << " constraints, in "
+            << n_partitions
+            << " independent partitions ..."
+            << std::endl;
+
+        f_status = FSM_CONSISTENCY_OK;
+
+        unsigned n_tasks {
+            std::min(n_partitions, algorithms::Scheduler::INSTANCE().slots())
+        };
+
+        if (n_tasks <= 1) {
+            check_partitions(0, 1);
+        } else {
+            algorithms::Tasks tasks;
+            for (unsigned i = 0; i < n_tasks; ++i) {
+                tasks.push_back(algorithms::Task(
+                    "consistency",
+                    boost::bind(&ConsistencyCheck::check_partitions, this, i, n_tasks)));
+            }
+
+            algorithms::Scheduler::INSTANCE().run(tasks, []() { return true; });
+        }
+
+        for (const auto& core : f_partition_cores) {
+            if (!core.empty()) {
+                f_cores.push_back(core);
+            }
+        }
+    }
+
+    void ConsistencyCheck::check_partitions(unsigned first, unsigned stride)
+    {
+        for (unsigned i = first; i < f_partitions.size(); i += stride) {
+            check_partition(i);
+        }
+    }
+
+    void ConsistencyCheck::check_partition(unsigned i)
+    {
+        const std::vector<unsigned>& partition { f_partitions[i] };
+
+        sat::Engine engine { f_engine_name };
+        setup_engine(engine);
+
+        /* an activation var for each candidate */
+        std::vector<Var> activations;
+        vec<Lit> assumptions;
+        for (auto candidate : partition) {
+            Var act { engine.new_sat_var() };
+            f_candidates[candidate].asserter(engine, act);
+
+            activations.push_back(act);
+            assumptions.push(mkLit(act));
+        }
+
+        sat::status_t status { engine.solve(assumptions) };
+
+        if (sat::status_t::STATUS_SAT == status) {
+            return;
+        }
+
+        if (sat::status_t::STATUS_UNKNOWN == status) {
+            boost::mutex::scoped_lock lock { f_status_mutex };
+            if (FSM_CONSISTENCY_KO != f_status) {
+                f_status = FSM_CONSISTENCY_UNDECIDED;
+            }
+
+            return;
+        }
+
+        /* the core, by position in the partition */
+        std::vector<unsigned> core;
+        for (unsigned j = 0; j < activations.size(); ++j) {
+            if (engine.failed(mkLit(activations[j]))) {
+                core.push_back(j);
+            }
+        }
+
+        /* a member is dropped if the others are inconsistent anyway,
+           the core shrinks to the failed ones among them. Members
+           kept so far are needed by any subset, hence kept */
+        for (unsigned j = 0; j < core.size();) {
+            vec<Lit> others;
+            for (unsigned k = 0; k < core.size(); ++k) {
+                if (k != j) {
+                    others.push(mkLit(activations[core[k]]));
+                }
+            }
+
+            status = engine.solve(others);
+
+            /* interrupted, the core is not minimal */
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                break;
+            }
+
+            if (sat::status_t::STATUS_SAT == status) {
+                ++j;
+                continue;
+            }
+
+            std::vector<unsigned> refined;
+            for (unsigned k = 0; k < core.size(); ++k) {
+                if (k != j && engine.failed(mkLit(activations[core[k]]))) {
+                    refined.push_back(core[k]);
+                }
+            }
+            core.swap(refined);
+        }
+
+        ConsistencyCore& res { f_partition_cores[i] };
+        for (auto j : core) {
+            res.push_back(f_candidates[partition[j]].constraint);
+        }
+
+        boost::mutex::scoped_lock lock { f_status_mutex };
+        f_status = FSM_CONSISTENCY_KO;
+    }
+
+} // namespace fsm
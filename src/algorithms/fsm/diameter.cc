@@ -21,9 +21,12 @@
  *
  **/
 
+#include <algorithm>
+
 #include <boost/thread.hpp>
 
 #include <algorithms/fsm/fsm.hh>
+#include <algorithms/scheduler.hh>
 #include <witness_mgr.hh>
 
 namespace fsm {
@@ -31,7 +34,11 @@ namespace fsm {
     ComputeDiameter::ComputeDiameter(cmd::Command& command, model::Model& model)
         : algorithms::Algorithm { command, model }
         , f_diameter { UINT_MAX }
+        , f_feasible { 0 }
     {
+        use_lazy_simple_path();
+
+
         const void* instance { this };
         TRACE
             << "Created ComputeDiameter @"
@@ -50,26 +57,40 @@ namespace fsm {
 
     void ComputeDiameter::process()
     {
-        sat::Engine engine { "ComputeDiameter" };
+        DiameterMgr& dm { DiameterMgr::INSTANCE() };
+
+        step_t cached { dm.diameter(model()) };
+        if (UINT_MAX != cached) {
+            INFO
+                << "Diameter is known (" << cached << ")."
+                << std::endl;
+
+            sync_set_diameter(cached);
+            return;
+        }
 
         /* fire up strategies */
-        algorithms::thread_ptrs tasks;
-        tasks.push_back(new boost::thread(&ComputeDiameter::forward_strategy, this));
-        tasks.push_back(new boost::thread(&ComputeDiameter::backward_strategy, this));
+        algorithms::Tasks tasks;
+        tasks.push_back(algorithms::Task(
+            "forward", boost::bind(&ComputeDiameter::forward_strategy, this)));
+        tasks.push_back(algorithms::Task(
+            "backward", boost::bind(&ComputeDiameter::backward_strategy, this)));
 
-        /* join and destroy all active threads */
         assert(0 < tasks.size());
-        std::for_each(
-            begin(tasks), end(tasks),
-            [](algorithms::thread_ptr task) {
-                task->join();
-                delete task;
-            });
+        algorithms::Scheduler::INSTANCE().run(tasks, [this]() {
+            return UINT_MAX == this->sync_diameter();
+        });
+
+        step_t diameter { sync_diameter() };
+        if (UINT_MAX != diameter) {
+            dm.set_diameter(model(), diameter);
+        }
     }
 
     void ComputeDiameter::forward_strategy()
     {
         sat::Engine engine { "forward" };
+        setup_engine(engine);
         step_t k { 0 };
 
         /* initial constraints */
@@ -93,21 +114,31 @@ namespace fsm {
         }
 
         do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
             /* unrolling next */
             assert_fsm_trans(engine, k++);
             assert_fsm_invar(engine, k);
 
             /* build state uniqueness constraint for each pair of states
                (j, k), where j < k */
-            for (step_t j = 0; j < k; ++j) {
-                assert_fsm_uniqueness(engine, j, k);
-            }
+            assert_fsm_simple_path(engine, k);
 
             INFO
                 << "Now looking for infeasibility proof (k = " << k << ") ..."
                 << std::endl;
 
-            sat::status_t status { engine.solve() };
+            /* known to be feasible, k - 1 is not the diameter */
+            if (k <= sync_feasible()) {
+                TRACE
+                    << "A simple path is known to exist (k = " << k << ")"
+                    << std::endl;
+
+                continue;
+            }
+
+            sat::status_t status { solve_simple_path(engine, k) };
             if (sat::status_t::STATUS_UNKNOWN == status) {
                 goto cleanup;
             } else if (sat::status_t::STATUS_UNSAT == status) {
@@ -121,6 +152,8 @@ namespace fsm {
                 INFO
                     << "No infeasibility proof found (k = " << k << ")"
                     << std::endl;
+
+                sync_set_feasible(k);
             } else {
                 assert(false); /* unreachable */
             }
@@ -131,8 +164,8 @@ namespace fsm {
         } while (sync_diameter() == UINT_MAX);
 
     cleanup:
-        /* signal other threads it's time to go home */
-        sat::EngineMgr::INSTANCE().interrupt();
+        /* signal sibling strategies it's time to go home */
+        cancel();
 
         INFO
             << engine
@@ -142,6 +175,7 @@ namespace fsm {
     void ComputeDiameter::backward_strategy()
     {
         sat::Engine engine { "backward" };
+        setup_engine(engine);
         step_t k { 0 };
 
         assert_fsm_invar(engine, UINT_MAX - k);
@@ -164,6 +198,9 @@ namespace fsm {
         }
 
         do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
             /* unrolling next */
             ++k;
             assert_fsm_trans(engine, UINT_MAX - k);
@@ -171,15 +208,22 @@ namespace fsm {
 
             /* build state uniqueness constraint for each pair of states
                (j, k), where j < k */
-            for (step_t j = 0; j < k; ++j) {
-                assert_fsm_uniqueness(engine, UINT_MAX - j, UINT_MAX - k);
-            }
+            assert_fsm_simple_path(engine, k, true);
 
             INFO
                 << "Now looking for infeasibility proof (k = " << k << ")..."
                 << std::endl;
 
-            sat::status_t status { engine.solve() };
+            /* known to be feasible, k - 1 is not the diameter */
+            if (k <= sync_feasible()) {
+                TRACE
+                    << "A simple path is known to exist (k = " << k << ")"
+                    << std::endl;
+
+                continue;
+            }
+
+            sat::status_t status { solve_simple_path(engine, k, true) };
 
             if (sat::status_t::STATUS_UNKNOWN == status) {
                 goto cleanup;
@@ -187,6 +231,8 @@ namespace fsm {
                 INFO
                     << "No infeasibility proof found (k = " << k << ")"
                     << std::endl;
+
+                sync_set_feasible(k);
             } else if (sat::status_t::STATUS_UNSAT == status) {
                 INFO
                     << "Found infeasibility proof (k = " << k << ")"
@@ -205,8 +251,8 @@ namespace fsm {
         } while (sync_diameter() == UINT_MAX);
 
     cleanup:
-        /* signal other threads it's time to go home */
-        sat::EngineMgr::INSTANCE().interrupt();
+        /* signal sibling strategies it's time to go home */
+        cancel();
 
         INFO
             << engine
@@ -228,10 +274,60 @@ namespace fsm {
         /* consistency check */
         assert(f_diameter == diameter || f_diameter == UINT_MAX);
 
-        bool res { f_diameter != UINT_MAX };
+        bool res { f_diameter == UINT_MAX };
         f_diameter = diameter;
 
         return res;
     }
 
+    /* synchronized */
+    step_t ComputeDiameter::sync_feasible()
+    {
+        boost::mutex::scoped_lock lock { f_diameter_mutex };
+        return f_feasible;
+    }
+
+    /* synchronized */
+    void ComputeDiameter::sync_set_feasible(step_t k)
+    {
+        boost::mutex::scoped_lock lock { f_diameter_mutex };
+        f_feasible = std::max(f_feasible, k);
+    }
+
+    DiameterMgr::DiameterMgr()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized DiameterMgr @"
+            << instance
+            << std::endl;
+    }
+
+    DiameterMgr::~DiameterMgr()
+    {
+        TRACE
+            << "Destroyed DiameterMgr"
+            << std::endl;
+    }
+
+    step_t DiameterMgr::diameter(const model::Model& model)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        const auto i { f_diameters.find(&model) };
+        return f_diameters.end() != i ? i->second : UINT_MAX;
+    }
+
+    void DiameterMgr::set_diameter(const model::Model& model, step_t diameter)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_diameters[&model] = diameter;
+    }
+
+    void DiameterMgr::clear()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_diameters.clear();
+    }
+
 } // namespace fsm
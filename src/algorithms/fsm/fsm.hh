@@ -34,6 +34,9 @@
 #include <algorithms/base.hh>
 #include <witness/witness.hh>
 
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
 namespace fsm {
 
     typedef enum {
@@ -42,13 +45,28 @@ namespace fsm {
         FSM_CONSISTENCY_UNDECIDED
     } fsm_consistency_t;
 
-    class CheckInitConsistency: public algorithms::Algorithm {
+    /* a constraint of a consistency check, as reported in cores */
+    struct ConsistencyConstraint {
+        /* INIT, INVAR, TRANS or constraint (i.e. given by -c) */
+        pconst_char kind;
 
-    public:
-        CheckInitConsistency(cmd::Command& command, model::Model& model);
-        ~CheckInitConsistency();
+        /* fully qualified, i.e. ctx::body */
+        expr::Expr_ptr expr;
+    };
+    typedef std::vector<ConsistencyConstraint> ConsistencyCore;
+    typedef std::vector<ConsistencyCore> ConsistencyCores;
 
-        void process(expr::ExprVector constraints);
+    /* Each constraint is asserted under an activation var of its own,
+     * cores are taken from the failed activations and minimized by
+     * dropping one constraint at a time. Constraints sharing no vars
+     * (e.g. those of unrelated modules) are partitioned, and each
+     * partition is checked on its own engine, concurrently. */
+    class ConsistencyCheck: public algorithms::Algorithm {
+
+    public:
+        ConsistencyCheck(cmd::Command& command, model::Model& model,
+                         pconst_char engine_name);
+        ~ConsistencyCheck();
 
         inline fsm_consistency_t status() const
         {
@@ -60,40 +78,79 @@ namespace fsm {
             f_status = status;
         }
 
-    private:
-        expr::ExprVector f_constraints;
+        /* when inconsistent, a minimal core for each partition which
+           is inconsistent on its own */
+        inline const ConsistencyCores& cores() const
+        {
+            return f_cores;
+        }
+
+    protected:
+        /* asserts a constraint, under group */
+        typedef boost::function<void(sat::Engine&, sat::group_t)> ConstraintAsserter;
+
+        void add_constraint(pconst_char kind, const compiler::Unit& unit,
+                            ConstraintAsserter asserter);
+
+        /* the additional constraints, compiled */
+        void compile_constraints(const expr::ExprVector& constraints);
+
+        /* checks all constraints added so far */
+        void check();
+
         compiler::Units f_constraint_cus;
 
+    private:
+        struct Candidate {
+            ConsistencyConstraint constraint;
+            compiler::Unit unit;
+            ConstraintAsserter asserter;
+        };
+
+        /* checks partitions first, first + stride, ... */
+        void check_partitions(unsigned first, unsigned stride);
+
+        /* checks the i-th partition, its core is recorded if it is
+           inconsistent */
+        void check_partition(unsigned i);
+
+        pconst_char f_engine_name;
+        std::vector<Candidate> f_candidates;
+
+        /* indices of candidates, and the core of each partition (if
+           any) */
+        std::vector<std::vector<unsigned> > f_partitions;
+        ConsistencyCores f_partition_cores;
+
         boost::mutex f_status_mutex;
         fsm_consistency_t f_status;
+        ConsistencyCores f_cores;
     };
 
-    class CheckTransConsistency: public algorithms::Algorithm {
+    class CheckInitConsistency: public ConsistencyCheck {
 
     public:
-        CheckTransConsistency(cmd::Command& command, model::Model& model);
-        ~CheckTransConsistency();
+        CheckInitConsistency(cmd::Command& command, model::Model& model);
+        ~CheckInitConsistency();
 
         void process(expr::ExprVector constraints);
+    };
 
-        inline fsm_consistency_t status() const
-        {
-            return f_status;
-        }
-
-        inline void set_status(fsm_consistency_t status)
-        {
-            f_status = status;
-        }
+    class CheckTransConsistency: public ConsistencyCheck {
 
-    private:
-        expr::ExprVector f_constraints;
-        compiler::Units f_constraint_cus;
+    public:
+        CheckTransConsistency(cmd::Command& command, model::Model& model);
+        ~CheckTransConsistency();
 
-        boost::mutex f_status_mutex;
-        fsm_consistency_t f_status;
+        void process(expr::ExprVector constraints);
     };
 
+    /* Forward and backward strategies look for the longest simple
+     * path, with lazy simple-path constraints. Both compute the same
+     * value: the length of the longest simple path known to exist is
+     * shared, so that either strategy need not solve for lengths
+     * already proved feasible by the other one, and both stop as soon
+     * as either finds the bound. Diameters are cached by DiameterMgr. */
     class ComputeDiameter: public algorithms::Algorithm {
 
     public:
@@ -114,11 +171,63 @@ namespace fsm {
         boost::mutex f_diameter_mutex;
         step_t f_diameter;
 
+        /* a simple path of this length is known to exist */
+        step_t f_feasible;
+
+        /* synchronized */
+        step_t sync_feasible();
+        void sync_set_feasible(step_t k);
+
         /* strategies */
         void forward_strategy();
         void backward_strategy();
     };
 
+    /* The bit-blasted FSM as an And-Inverter Graph (AIGER 1.9), see
+     * aiger.cc. INIT, INVAR and TRANS (and the target) are asserted
+     * on engines of their own, and their CNF is written as an AIG:
+     * each clause is an OR gate, the aux vars of the CNF are inputs. */
+    class AigerExport: public algorithms::Algorithm {
+
+    public:
+        AigerExport(cmd::Command& command, model::Model& model);
+        ~AigerExport();
+
+        /* writes the FSM, with the states satisfying target (unless
+           NULL) as bad states, in the ASCII format unless binary.
+           False if the FSM can not be written (e.g. it depends on
+           absolute times) */
+        bool process(expr::Expr_ptr target, std::ostream& os, bool binary);
+    };
+
+    typedef class DiameterMgr* DiameterMgr_ptr;
+
+    /* Diameters computed so far, e.g. as completeness thresholds for
+       reachability. Entries are dropped when a new model is read */
+    class DiameterMgr {
+    public:
+        /* UINT_MAX if unknown */
+        step_t diameter(const model::Model& model);
+        void set_diameter(const model::Model& model, step_t diameter);
+
+        void clear();
+
+        static DiameterMgr& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static DiameterMgr_ptr instance { new DiameterMgr() };
+            return *instance;
+        }
+
+    protected:
+        DiameterMgr();
+        ~DiameterMgr();
+
+    private:
+        boost::mutex f_mutex;
+        boost::unordered_map<const model::Model*, step_t> f_diameters;
+    };
+
 } // namespace fsm
 
 #endif /* FSM_ALGORITHM_H */
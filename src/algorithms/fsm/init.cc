@@ -29,15 +29,13 @@
 namespace fsm {
 
     CheckInitConsistency::CheckInitConsistency(cmd::Command& command, model::Model& model)
-        : algorithms::Algorithm(command, model)
+        : ConsistencyCheck(command, model, "Initial")
     {
         const void* instance { this };
         TRACE
             << "Created CheckInitConsistency @"
             << instance
             << std::endl;
-
-        f_status = FSM_CONSISTENCY_UNDECIDED;
     }
 
     CheckInitConsistency::~CheckInitConsistency()
@@ -51,50 +49,31 @@ namespace fsm {
 
     void CheckInitConsistency::process(expr::ExprVector constraints)
     {
-        sat::Engine engine { "Initial" };
-        expr::Expr_ptr ctx { em().make_empty() };
-
-        unsigned nconstraints { 0 };
-        std::for_each(
-            begin(constraints), end(constraints),
-            [this, ctx, &nconstraints](expr::Expr_ptr expr) {
-                INFO
-                    << "Compiling constraint `"
-                    << expr
-                    << "` ..."
-                    << std::endl;
-
-                compiler::Unit unit { compiler().process(ctx, expr) };
-
-                f_constraint_cus.push_back(unit);
-                ++nconstraints;
-            });
-
-        INFO
-            << nconstraints
-            << " additional constraints found."
-            << std::endl;
+        compile_constraints(constraints);
 
         /* FSM constraints */
-        assert_fsm_init(engine, 0);
-        assert_fsm_invar(engine, 0);
+        for (unsigned i = 0; i < n_init_units(); ++i) {
+            add_constraint("INIT", init_unit(i),
+                           [this, i](sat::Engine& engine, sat::group_t group) {
+                               assert_fsm_init_unit(engine, i, 0, group);
+                           });
+        }
+        for (unsigned i = 0; i < n_invar_units(); ++i) {
+            add_constraint("INVAR", invar_unit(i),
+                           [this, i](sat::Engine& engine, sat::group_t group) {
+                               assert_fsm_invar_unit(engine, i, 0, group);
+                           });
+        }
 
         /* Additional constraints */
-        std::for_each(
-            begin(f_constraint_cus), end(f_constraint_cus),
-            [this, &engine](compiler::Unit& cu) {
-                this->assert_formula(engine, 0, cu);
-            });
-
-        sat::status_t status { engine.solve() };
-
-        if (sat::status_t::STATUS_UNKNOWN == status) {
-            f_status = FSM_CONSISTENCY_UNDECIDED;
-        } else if (sat::status_t::STATUS_UNSAT == status) {
-            f_status = FSM_CONSISTENCY_KO;
-        } else if (sat::status_t::STATUS_SAT == status) {
-            f_status = FSM_CONSISTENCY_OK;
+        for (auto& cu : f_constraint_cus) {
+            add_constraint("constraint", cu,
+                           [this, &cu](sat::Engine& engine, sat::group_t group) {
+                               assert_formula(engine, 0, cu, group);
+                           });
         }
+
+        check();
     }
 
 } // namespace fsm
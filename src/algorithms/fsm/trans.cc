@@ -31,15 +31,13 @@
 namespace fsm {
 
     CheckTransConsistency::CheckTransConsistency(cmd::Command& command, model::Model& model)
-        : algorithms::Algorithm(command, model)
+        : ConsistencyCheck(command, model, "Transitional")
     {
         const void* instance { this };
         TRACE
             << "Created CheckTransConsistency @"
             << instance
             << std::endl;
-
-        f_status = FSM_CONSISTENCY_UNDECIDED;
     }
 
     CheckTransConsistency::~CheckTransConsistency()
@@ -53,52 +51,33 @@ namespace fsm {
 
     void CheckTransConsistency::process(expr::ExprVector constraints)
     {
-        sat::Engine engine { "Transitional" };
-        expr::Expr_ptr ctx { em().make_empty() };
-
-        unsigned no_constraints { 0 };
-        std::for_each(
-            begin(constraints), end(constraints),
-            [this, ctx, &no_constraints](expr::Expr_ptr expr) {
-                INFO
-                    << "Compiling constraint `"
-                    << expr
-                    << "` ..."
-                    << std::endl;
-
-                compiler::Unit unit { compiler().process(ctx, expr) };
-
-                f_constraint_cus.push_back(unit);
-                ++no_constraints;
-            });
-
-        INFO
-            << no_constraints
-            << " additional constraints found."
-            << std::endl;
+        compile_constraints(constraints);
 
         /* FSM constraints */
-        assert_fsm_trans(engine, 0);
-        assert_fsm_invar(engine, 0);
+        for (unsigned i = 0; i < n_trans_units(); ++i) {
+            add_constraint("TRANS", trans_unit(i),
+                           [this, i](sat::Engine& engine, sat::group_t group) {
+                               assert_fsm_trans_unit(engine, i, 0, group);
+                           });
+        }
+        for (unsigned i = 0; i < n_invar_units(); ++i) {
+            add_constraint("INVAR", invar_unit(i),
+                           [this, i](sat::Engine& engine, sat::group_t group) {
+                               assert_fsm_invar_unit(engine, i, 0, group);
+                           });
+        }
 
         /* Additional constraints, times 0 and 1 */
-        for (step_t time = 0; time < 2; ++time) {
-            std::for_each(
-                begin(f_constraint_cus), end(f_constraint_cus),
-                [this, &engine, time](compiler::Unit& cu) {
-                    this->assert_formula(engine, time, cu);
-                });
+        for (auto& cu : f_constraint_cus) {
+            add_constraint("constraint", cu,
+                           [this, &cu](sat::Engine& engine, sat::group_t group) {
+                               for (step_t time = 0; time < 2; ++time) {
+                                   assert_formula(engine, time, cu, group);
+                               }
+                           });
         }
 
-        sat::status_t status { engine.solve() };
-
-        if (sat::status_t::STATUS_UNKNOWN == status) {
-            f_status = FSM_CONSISTENCY_UNDECIDED;
-        } else if (sat::status_t::STATUS_UNSAT == status) {
-            f_status = FSM_CONSISTENCY_KO;
-        } else if (sat::status_t::STATUS_SAT == status) {
-            f_status = FSM_CONSISTENCY_OK;
-        }
+        check();
     }
 
 } // namespace fsm
@@ -0,0 +1,279 @@
+/**
+ * @file lanes.cc
+ * @brief Bit-parallel simulation of the compiled FSM, implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+
+#include <base.hh>
+#include <lanes.hh>
+
+#include <dd/cudd-2.5.0/cudd/cuddInt.h>
+
+namespace algorithms {
+
+    LaneProgram::LaneProgram(const BDD& bdd)
+    {
+        boost::unordered_map<DdNode*, unsigned> ids;
+
+        /* the constant one */
+        Node one { 0, 0, 0 };
+        f_nodes.push_back(one);
+
+        /* post-order, children come first */
+        std::vector<std::pair<DdNode*, bool>> stack;
+        stack.push_back(std::make_pair(Cudd_Regular(bdd.getNode()), false));
+
+        while (!stack.empty()) {
+            DdNode* node { stack.back().first };
+            bool expanded { stack.back().second };
+            stack.pop_back();
+
+            if (Cudd_IsConstant(node) || ids.end() != ids.find(node)) {
+                continue;
+            }
+
+            DdNode* t { Cudd_T(node) };
+            DdNode* e { Cudd_E(node) };
+
+            if (!expanded) {
+                stack.push_back(std::make_pair(node, true));
+                stack.push_back(std::make_pair(Cudd_Regular(t), false));
+                stack.push_back(std::make_pair(Cudd_Regular(e), false));
+                continue;
+            }
+
+            auto ref = [&ids](DdNode* child) {
+                DdNode* regular { Cudd_Regular(child) };
+                unsigned id { Cudd_IsConstant(regular) ? 0 : ids.at(regular) };
+                return (id << 1) | (Cudd_IsComplement(child) ? 1 : 0);
+            };
+
+            Node n { node->index, ref(t), ref(e) };
+            ids[node] = f_nodes.size();
+            f_nodes.push_back(n);
+        }
+
+        DdNode* root { bdd.getNode() };
+        DdNode* regular { Cudd_Regular(root) };
+        f_root = ((Cudd_IsConstant(regular) ? 0 : ids.at(regular)) << 1) |
+                 (Cudd_IsComplement(root) ? 1 : 0);
+
+        f_scratch.resize(f_nodes.size());
+    }
+
+    lanes_t LaneProgram::eval(const std::vector<lanes_t>& values)
+    {
+        std::vector<lanes_t>& s { f_scratch };
+        auto ref = [&s](unsigned r) {
+            return s[r >> 1] ^ ((r & 1) ? ~(lanes_t) 0 : 0);
+        };
+
+        s[0] = ~(lanes_t) 0;
+        for (unsigned i = 1; i < f_nodes.size(); ++i) {
+            const Node& n { f_nodes[i] };
+            lanes_t x { values[n.index] };
+
+            s[i] = (x & ref(n.then_ref)) | (~x & ref(n.else_ref));
+        }
+
+        return ref(f_root);
+    }
+
+    LaneSimulator::LaneSimulator(const BDD& init, const BDD& trans,
+                                 const std::vector<int>& state,
+                                 const std::vector<int>& next,
+                                 unsigned long seed)
+        : f_state(state)
+        , f_next(next)
+        , f_alive(0)
+        , f_rng(seed)
+    {
+        int size { 0 };
+        for (auto index : state) {
+            size = std::max(size, 1 + index);
+        }
+        for (auto index : next) {
+            size = std::max(size, 1 + index);
+        }
+
+        /* all state bits are drawn initially, next bits at each
+           step. Other vars in the support are drawn each time */
+        f_init_bits = state;
+        for (auto index : init.SupportIndices()) {
+            if (f_init_bits.end() == std::find(f_init_bits.begin(), f_init_bits.end(), (int) index)) {
+                f_init_bits.push_back(index);
+            }
+            size = std::max(size, 1 + (int) index);
+        }
+
+        for (auto index : next) {
+            if (-1 != index) {
+                f_trans_bits.push_back(index);
+            }
+        }
+        for (auto index : trans.SupportIndices()) {
+            if (state.end() == std::find(state.begin(), state.end(), (int) index) &&
+                f_trans_bits.end() == std::find(f_trans_bits.begin(), f_trans_bits.end(), (int) index)) {
+                f_trans_bits.push_back(index);
+            }
+            size = std::max(size, 1 + (int) index);
+        }
+
+        f_values.resize(size, 0);
+
+        build_chain(init, f_init_bits, f_init_chain);
+        build_chain(trans, f_trans_bits, f_trans_chain);
+    }
+
+    void LaneSimulator::build_chain(BDD bdd, const std::vector<int>& bits, LaneChain& chain)
+    {
+        Cudd& dd { enc::EncodingMgr::INSTANCE().dd() };
+
+        std::vector<BDD> quantified(bits.size() + 1);
+        quantified[bits.size()] = bdd;
+
+        for (unsigned i = bits.size(); 0 < i; --i) {
+            quantified[i - 1] = quantified[i].ExistAbstract(dd.bddVar(bits[i - 1]));
+        }
+
+        for (const auto& q : quantified) {
+            chain.push_back(LaneProgram(q));
+        }
+    }
+
+    lanes_t LaneSimulator::draw(LaneChain& chain, const std::vector<int>& bits, lanes_t mask)
+    {
+        lanes_t ok { chain[0].eval(f_values) & mask };
+
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            lanes_t& value { f_values[bits[i]] };
+            lanes_t keep { value & ~ok };
+            lanes_t r { f_rng() };
+
+            /* the other value, where this one has no completion */
+            value = keep | (r & ok);
+            lanes_t sat { chain[i + 1].eval(f_values) };
+            value = keep | (~(r ^ sat) & ok);
+        }
+
+        return ok;
+    }
+
+    lanes_t LaneSimulator::initialize()
+    {
+        f_alive = draw(f_init_chain, f_init_bits, ~(lanes_t) 0);
+        return f_alive;
+    }
+
+    lanes_t LaneSimulator::step()
+    {
+        lanes_t ok { draw(f_trans_chain, f_trans_bits, f_alive) };
+
+        /* next states become the current ones, on live lanes */
+        for (unsigned i = 0; i < f_state.size(); ++i) {
+            if (-1 == f_next[i]) {
+                continue;
+            }
+
+            lanes_t& value { f_values[f_state[i]] };
+            value = (value & ~ok) | (f_values[f_next[i]] & ok);
+        }
+
+        f_alive = ok;
+        return f_alive;
+    }
+
+    LaneSimulator_ptr Algorithm::make_lane_simulator(const compiler::Units& constraints,
+                                                     int limit, unsigned long seed)
+    {
+        BDD init;
+        if (!fsm_initial_states(init, constraints, limit)) {
+            return NULL;
+        }
+
+        /* state bits at time 0 and 1 */
+        std::vector<int> state;
+        std::vector<int> next;
+
+        fsm_state_bits(state, next);
+
+        /* INVARs and constraints are shifted to time 1 */
+        std::vector<int> permut(f_bm.nbits());
+        for (unsigned i = 0; i < permut.size(); ++i) {
+            permut[i] = i;
+        }
+        for (unsigned i = 0; i < state.size(); ++i) {
+            if (-1 != next[i]) {
+                permut[state[i]] = next[i];
+            }
+        }
+
+        std::vector<const compiler::Unit*> units;
+        for (const auto& unit : f_invar) {
+            units.push_back(&unit);
+        }
+        for (const auto& unit : constraints) {
+            units.push_back(&unit);
+        }
+
+        BDD trans { f_bm.dd().bddOne() };
+        for (const auto* unit : units) {
+            for (const auto& dd : unit->dds()) {
+                BDD bdd { dd.BddPattern() };
+                trans &= bdd & bdd.Permute(&permut[0]);
+
+                if (limit < trans.nodeCount()) {
+                    return NULL;
+                }
+            }
+        }
+
+        for (const auto& unit : f_trans) {
+            /* auxiliary vars are only defined by the CNF */
+            if (!unit.inlined_operator_descriptors().empty() ||
+                !unit.binary_selection_descriptors_map().empty() ||
+                !unit.array_mux_descriptors().empty() ||
+                !unit.aig_descriptors().empty()) {
+                return NULL;
+            }
+
+            for (const auto& dd : unit.dds()) {
+                trans &= dd.BddPattern();
+
+                if (limit < trans.nodeCount()) {
+                    return NULL;
+                }
+            }
+        }
+
+        /* only transitions from time 0 to time 1 */
+        for (auto index : trans.SupportIndices()) {
+            step_t time { f_bm.find_ucbi(index).time() };
+            if (1 < time && FROZEN != time) {
+                return NULL;
+            }
+        }
+
+        return new LaneSimulator(init, trans, state, next, seed);
+    }
+
+} // namespace algorithms
@@ -0,0 +1,144 @@
+/**
+ * @file lanes.hh
+ * @brief Bit-parallel simulation of the compiled FSM.
+ *
+ * This module contains the declarations of a concrete simulator
+ * running 64 independent random simulations at once, one per bit of
+ * a machine word (i.e. a lane). The FSM is taken in its bit-blasted
+ * form, the conjunction of the DDs of INIT and INVAR (initial states)
+ * and of TRANS and INVAR at both ends (transitions). Each state bit
+ * is drawn at random within the values allowed by the assignments to
+ * the bits drawn before it, which are decided on the existentially
+ * quantified DDs. Thus simulations never deadlock on choices, only on
+ * states without successors.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef ALGORITHMS_LANES_H
+#define ALGORITHMS_LANES_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <dd/dd.hh>
+
+namespace algorithms {
+
+    /* one bit per lane */
+    typedef uint64_t lanes_t;
+    const unsigned N_LANES { 64 };
+
+    /* a BDD, flattened in topological order for evaluation over all
+       lanes at once */
+    class LaneProgram {
+    public:
+        LaneProgram(const BDD& bdd);
+
+        /* the lanes satisfying the BDD, values are indexed by DD var
+           index */
+        lanes_t eval(const std::vector<lanes_t>& values);
+
+    private:
+        /* refs are (node << 1 | complemented), node 0 is the
+           constant one */
+        struct Node {
+            unsigned index;
+            unsigned then_ref;
+            unsigned else_ref;
+        };
+
+        std::vector<Node> f_nodes;
+        unsigned f_root;
+
+        std::vector<lanes_t> f_scratch;
+    };
+
+    typedef class LaneSimulator* LaneSimulator_ptr;
+
+    class LaneSimulator {
+    public:
+        /* state[i] and next[i] are the DD var indices of the i-th
+         * state bit at time 0 and 1, next[i] is -1 for frozen bits.
+         * Other vars in the support of the DDs (e.g. inputs) are
+         * drawn along with the state bits, at each step. */
+        LaneSimulator(const BDD& init, const BDD& trans,
+                      const std::vector<int>& state, const std::vector<int>& next,
+                      unsigned long seed);
+
+        /* random initial states, yields the lanes that have one (i.e.
+           all of them or none) */
+        lanes_t initialize();
+
+        /* a random step on each live lane, yields the lanes still
+           alive (i.e. whose state had a successor) */
+        lanes_t step();
+
+        inline lanes_t alive() const
+        {
+            return f_alive;
+        }
+
+        /* value of DD var index, on each lane */
+        inline lanes_t value(int index) const
+        {
+            return f_values[index];
+        }
+
+        inline bool value(int index, unsigned lane) const
+        {
+            return 0 != ((f_values[index] >> lane) & 1);
+        }
+
+        /* all values, e.g. for LaneProgram::eval */
+        inline const std::vector<lanes_t>& values() const
+        {
+            return f_values;
+        }
+
+    private:
+        /* chain[i] is the DD with bits[i], .., bits[n - 1]
+           existentially quantified */
+        typedef std::vector<LaneProgram> LaneChain;
+
+        void build_chain(BDD bdd, const std::vector<int>& bits, LaneChain& chain);
+
+        /* draws bits, on the lanes satisfying chain[0]. Yields those
+           lanes */
+        lanes_t draw(LaneChain& chain, const std::vector<int>& bits, lanes_t mask);
+
+        std::vector<int> f_state;
+        std::vector<int> f_next;
+
+        std::vector<int> f_init_bits;
+        LaneChain f_init_chain;
+
+        std::vector<int> f_trans_bits;
+        LaneChain f_trans_chain;
+
+        std::vector<lanes_t> f_values;
+        lanes_t f_alive;
+
+        std::mt19937_64 f_rng;
+    };
+
+} // namespace algorithms
+
+#endif /* ALGORITHMS_LANES_H */
@@ -0,0 +1,430 @@
+/**
+ * @file mining.cc
+ * @brief Invariant mining on the compiled FSM.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <ctime>
+#include <map>
+
+#include <base.hh>
+#include <lanes.hh>
+
+/* bit-parallel simulation the candidates are taken from */
+static const int mining_lanes_node_limit { 1 << 16 };
+static const unsigned mining_lanes_steps { 64 };
+
+/* implications are only looked for among this many classes of
+   equivalent bits */
+static const unsigned mining_implication_bits { 128 };
+
+/* no implication is taken past this many candidates */
+static const unsigned mining_max_candidates { 2048 };
+
+namespace algorithms {
+
+    typedef enum {
+        INVARIANT_CONSTANT,
+        INVARIANT_EQUIVALENCE,
+        INVARIANT_RANGE,
+        INVARIANT_IMPLICATION,
+        N_INVARIANT_KINDS,
+    } invariant_kind_t;
+
+    /* an algebraic var, the values it took in simulation */
+    struct SimulatedRange {
+        expr::Expr_ptr var;
+        enc::AlgebraicEncoding_ptr enc;
+        std::vector<int> indexes;
+        bool seen;
+        value_t lo;
+        value_t hi;
+    };
+
+    /* Candidates are what holds in every state reached by simulation
+     * (64 lanes, up to 64 steps): constant bits, bits equal to (or
+     * the complement of) the first bit of their class, 2-literal
+     * clauses between those first bits, and the least and largest
+     * values of algebraic vars. They are then pruned as by sweeping
+     * (Houdini), on INIT first and on a transition from a state
+     * satisfying all of them next. Environment constraints are left
+     * out: they only drop states, so what holds without them holds
+     * with them as well. */
+    void Algorithm::mine_invariants()
+    {
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits);
+
+        if (bits.empty()) {
+            return;
+        }
+
+        LaneSimulator_ptr lanes {
+            make_lane_simulator(compiler::Units(), mining_lanes_node_limit, time(NULL))
+        };
+
+        if (!lanes) {
+            INFO
+                << "Invariant mining: FSM too large for simulation, skipped"
+                << std::endl;
+
+            return;
+        }
+
+        std::vector<int> indexes;
+        dd::DDVector literals;
+        std::vector<SimulatedRange> ranges;
+        for (const auto& ucbi : bits) {
+            enc::Encoding_ptr enc {
+                f_bm.find_encoding(expr::TimedExpr(ucbi.expr(), ucbi.time()))
+            };
+            assert(NULL != enc);
+
+            ADD bit { enc->bits()[ucbi.bitno()] };
+            indexes.push_back(bit.getNode()->index);
+            literals.push_back(bit);
+
+            /* once per var, all of its bits */
+            enc::AlgebraicEncoding_ptr algebraic {
+                dynamic_cast<enc::AlgebraicEncoding_ptr>(enc)
+            };
+            if (NULL != algebraic && 0 == ucbi.bitno() && algebraic->width() < 63) {
+                SimulatedRange range { ucbi.expr(), algebraic, {}, false, 0, 0 };
+                for (const auto& dd : algebraic->bits()) {
+                    range.indexes.push_back(dd.getNode()->index);
+                }
+                ranges.push_back(range);
+            }
+        }
+
+        /* the values of each bit at each step, on live lanes */
+        std::vector<std::vector<lanes_t>> values(bits.size());
+        std::vector<lanes_t> alives;
+        std::vector<int> assignment(f_bm.nbits(), 0);
+
+        lanes_t alive { lanes->initialize() };
+        for (unsigned k = 0; alive && k < mining_lanes_steps; ++k) {
+            alives.push_back(alive);
+            for (unsigned i = 0; i < bits.size(); ++i) {
+                values[i].push_back(lanes->value(indexes[i]) & alive);
+            }
+
+            for (auto& range : ranges) {
+                for (unsigned lane = 0; lane < N_LANES; ++lane) {
+                    if (0 == ((alive >> lane) & 1)) {
+                        continue;
+                    }
+
+                    for (auto index : range.indexes) {
+                        assignment[index] = lanes->value(index, lane) ? 1 : 0;
+                    }
+
+                    expr::Expr_ptr expr { range.enc->expr(&assignment[0]) };
+                    value_t value {
+                        em().is_neg(expr) ? -expr->lhs()->value() : expr->value()
+                    };
+
+                    range.lo = range.seen ? std::min(range.lo, value) : value;
+                    range.hi = range.seen ? std::max(range.hi, value) : value;
+                    range.seen = true;
+                }
+            }
+
+            alive = lanes->step();
+        }
+
+        delete lanes;
+
+        /* no initial state */
+        if (alives.empty()) {
+            return;
+        }
+
+        InvariantCandidates candidates;
+        auto add = [&candidates, this](ADD dd, invariant_kind_t kind) {
+            dd::DDVector dds { dd };
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+            compiler::AigDescriptors aig_descriptors;
+
+            candidates.push_back(std::make_pair(
+                compiler::Unit(em().make_true(), dds, inlined_operator_descriptors,
+                               binary_selection_descriptors_map, array_mux_descriptors,
+                               aig_descriptors),
+                (unsigned) kind));
+        };
+
+        /* constants, and classes of equivalent bits by their values
+           (complemented if the bit is set on the first live lane) */
+        lanes_t first { alives[0] & (~alives[0] + 1) };
+        std::map<std::vector<lanes_t>, unsigned> classes;
+        std::vector<unsigned> representatives;
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            bool ones { true };
+            bool zeros { true };
+            for (unsigned k = 0; k < alives.size(); ++k) {
+                ones = ones && values[i][k] == alives[k];
+                zeros = zeros && 0 == values[i][k];
+            }
+
+            if (ones || zeros) {
+                add(ones ? literals[i] : literals[i].Cmpl(), INVARIANT_CONSTANT);
+                continue;
+            }
+
+            bool flip { 0 != (values[i][0] & first) };
+            std::vector<lanes_t> signature;
+            for (unsigned k = 0; k < alives.size(); ++k) {
+                signature.push_back(flip ? ~values[i][k] & alives[k] : values[i][k]);
+            }
+
+            std::pair<std::map<std::vector<lanes_t>, unsigned>::iterator, bool> res {
+                classes.insert(std::make_pair(signature, i))
+            };
+            if (res.second) {
+                representatives.push_back(i);
+                continue;
+            }
+
+            unsigned j { res.first->second };
+            bool same { flip == (0 != (values[j][0] & first)) };
+            add(literals[j].Xnor(same ? literals[i] : literals[i].Cmpl()),
+                INVARIANT_EQUIVALENCE);
+        }
+
+        /* bounds tighter than the type's */
+        for (const auto& range : ranges) {
+            if (!range.seen || range.lo == range.hi) {
+                continue;
+            }
+
+            unsigned width { range.enc->width() };
+            value_t min { range.enc->is_signed() ? -((value_t) 1 << (width - 1)) : 0 };
+            value_t max {
+                range.enc->is_signed() ? ((value_t) 1 << (width - 1)) - 1
+                                       : ((value_t) 1 << width) - 1
+            };
+
+            auto constant = [this](value_t value) {
+                return value < 0 ? em().make_neg(em().make_const(-value))
+                                 : em().make_const(value);
+            };
+
+            expr::Expr_ptr scope { range.var->lhs() };
+            expr::Expr_ptr name { range.var->rhs() };
+
+            expr::ExprVector bounds;
+            if (min < range.lo) {
+                bounds.push_back(em().make_ge(name, constant(range.lo)));
+            }
+            if (range.hi < max) {
+                bounds.push_back(em().make_le(name, constant(range.hi)));
+            }
+
+            for (auto bound : bounds) {
+                try {
+                    candidates.push_back(
+                        std::make_pair(compiler().process(scope, bound),
+                                       (unsigned) INVARIANT_RANGE));
+                } catch (Exception& e) {
+                    pconst_char what { e.what() };
+                    DEBUG
+                        << "Invariant mining: bound dropped, "
+                        << what
+                        << std::endl;
+                }
+            }
+        }
+
+        /* a | b, for literals a and b of distinct classes */
+        unsigned n_reps {
+            std::min((unsigned) representatives.size(), mining_implication_bits)
+        };
+        for (unsigned a = 0; a < n_reps && candidates.size() < mining_max_candidates; ++a) {
+            for (unsigned b = a + 1; b < n_reps; ++b) {
+                unsigned i { representatives[a] };
+                unsigned j { representatives[b] };
+
+                for (unsigned polarity = 0; polarity < 4; ++polarity) {
+                    bool pi { 0 != (polarity & 1) };
+                    bool pj { 0 != (polarity & 2) };
+
+                    bool holds { true };
+                    for (unsigned k = 0; holds && k < alives.size(); ++k) {
+                        lanes_t li { pi ? values[i][k] : ~values[i][k] };
+                        lanes_t lj { pj ? values[j][k] : ~values[j][k] };
+                        holds = 0 == (~li & ~lj & alives[k]);
+                    }
+
+                    if (holds) {
+                        add((pi ? literals[i] : literals[i].Cmpl())
+                                .Or(pj ? literals[j] : literals[j].Cmpl()),
+                            INVARIANT_IMPLICATION);
+                    }
+                }
+            }
+        }
+
+        unsigned n_candidates { (unsigned) candidates.size() };
+
+        {
+            sat::Engine engine { "mine_init" };
+            setup_engine(engine);
+
+            assert_fsm_init(engine, 0, sat::MAINGROUP, false);
+            assert_fsm_invar(engine, 0, sat::MAINGROUP, false);
+
+            if (!prune_invariants(engine, candidates, 0)) {
+                return;
+            }
+        }
+
+        {
+            sat::Engine engine { "mine_step" };
+            setup_engine(engine);
+
+            assert_fsm_invar(engine, 0, sat::MAINGROUP, false);
+            assert_fsm_trans(engine, 0, sat::MAINGROUP, false);
+            assert_fsm_invar(engine, 1, sat::MAINGROUP, false);
+
+            if (!prune_invariants(engine, candidates, 1)) {
+                return;
+            }
+        }
+
+        unsigned counts[N_INVARIANT_KINDS] = { 0 };
+        compiler::Units mined;
+        for (const auto& candidate : candidates) {
+            ++counts[candidate.second];
+            mined.push_back(candidate.first);
+        }
+
+        unsigned n_mined { (unsigned) mined.size() };
+        INFO
+            << "Invariant mining: "
+            << n_mined
+            << " out of "
+            << n_candidates
+            << " candidates proved ("
+            << counts[INVARIANT_CONSTANT]
+            << " constants, "
+            << counts[INVARIANT_EQUIVALENCE]
+            << " equivalences, "
+            << counts[INVARIANT_IMPLICATION]
+            << " implications, "
+            << counts[INVARIANT_RANGE]
+            << " bounds)"
+            << std::endl;
+
+        if (mined.empty()) {
+            return;
+        }
+
+        /* environment constraints stay the last units */
+        f_invar.insert(f_invar.end() - f_n_env_invars, mined.begin(), mined.end());
+
+        /* templates were built on the original units */
+        f_invar_templates.clear();
+        f_trans_templates.clear();
+        f_templates_ready = false;
+    }
+
+    bool Algorithm::prune_invariants(sat::Engine& engine, InvariantCandidates& candidates,
+                                     step_t time)
+    {
+        /* violated[i] iff the i-th candidate does not hold at time,
+           holds[i] enables it at time - 1 */
+        std::vector<Var> violated;
+        std::vector<Var> holds;
+        for (auto& candidate : candidates) {
+            Var bad { engine.new_sat_var() };
+            Var good { engine.new_sat_var() };
+            assert_not_formula(engine, time, candidate.first, bad);
+            assert_formula(engine, time, candidate.first, good);
+
+            vec<Lit> ps;
+            ps.push(mkLit(bad));
+            ps.push(mkLit(good));
+            engine.add_clause(ps);
+
+            violated.push_back(bad);
+
+            if (0 < time) {
+                Var hold { engine.new_sat_var() };
+                assert_formula(engine, time - 1, candidate.first, hold);
+                holds.push_back(hold);
+            }
+        }
+
+        std::vector<unsigned> live;
+        for (unsigned i = 0; i < candidates.size(); ++i) {
+            live.push_back(i);
+        }
+
+        while (!live.empty()) {
+            sat::group_t group { engine.new_group() };
+
+            /* some candidate is violated at time, while all of them
+               hold at time - 1 */
+            vec<Lit> ps;
+            ps.push(mkLit(group, true));
+
+            vec<Lit> assumptions;
+            for (auto i : live) {
+                ps.push(mkLit(violated[i]));
+                if (0 < time) {
+                    assumptions.push(mkLit(holds[i]));
+                }
+            }
+            engine.add_clause(ps);
+
+            sat::status_t status { engine.solve(assumptions) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return false;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                engine.retire_last_group();
+                break;
+            }
+
+            std::vector<unsigned> kept;
+            for (auto i : live) {
+                if (1 != engine.value(violated[i])) {
+                    kept.push_back(i);
+                }
+            }
+
+            engine.retire_last_group();
+            live.swap(kept);
+        }
+
+        InvariantCandidates res;
+        for (auto i : live) {
+            res.push_back(candidates[i]);
+        }
+        candidates.swap(res);
+
+        return true;
+    }
+
+} // namespace algorithms
@@ -0,0 +1,724 @@
+/**
+ * @file pdr.cc
+ * @brief SAT-based IC3/PDR reachability analysis algorithm implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+#include <queue>
+#include <sstream>
+
+#include <algorithms/pdr/pdr.hh>
+#include <algorithms/reach/witness.hh>
+
+#include <expr/time/analyzer/analyzer.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/symb_iter.hh>
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace pdr {
+
+    /* drop-literal generalization attempts for each lemma, on top of
+       the unsat core */
+    static const unsigned MAX_DROP_ATTEMPTS { 32 };
+
+    /* a proof obligation: cube must be blocked in F_level, `depth`
+       is its distance from the target */
+    struct Obligation {
+        unsigned level;
+        unsigned depth;
+        Cube cube;
+
+        /* lowest level first */
+        bool operator<(const Obligation& other) const
+        {
+            return level > other.level;
+        }
+    };
+
+    PDR::PDR(cmd::Command& command, model::Model& model)
+        : Algorithm(command, model)
+        , f_target(NULL)
+        , f_status(reach::REACHABILITY_UNKNOWN)
+        , f_engine("pdr")
+        , f_init_act(0)
+        , f_bad_act(0)
+        , f_cex_depth(0)
+        , f_fixpoint(0)
+    {
+        const void* instance { this };
+        TRACE
+            << "Created PDR @"
+            << instance
+            << std::endl;
+    }
+
+    PDR::~PDR()
+    {
+        const void* instance { this };
+        TRACE
+            << "Destroyed PDR @"
+            << instance
+            << std::endl;
+    }
+
+    void PDR::process(expr::Expr_ptr target, expr::ExprVector constraints)
+    {
+        expr::time::Analyzer eta { em() };
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        f_target = target;
+        assert(f_target);
+
+        /* only global constraints are supported: they hold in every
+         * state, just like INVARs */
+        for (auto i = constraints.begin(); i != constraints.end(); ++i) {
+            expr::Expr_ptr constraint { *i };
+
+            eta.process(constraint);
+            if (eta.has_forward_time() || eta.has_backward_time()) {
+                ERR
+                    << "Timed constraints are not supported by PDR."
+                    << std::endl;
+
+                f_status = reach::REACHABILITY_ERROR;
+                return;
+            }
+
+            f_constraints.push_back(constraint);
+        }
+
+        TRACE
+            << "Compiling target `"
+            << f_target
+            << "` ..."
+            << std::endl;
+
+        compiler::Unit target_cu { compiler().process(ctx, f_target) };
+
+        /* auxiliary invariants, frames start from them */
+        if (opts::OptsMgr::INSTANCE().mine_invariants()) {
+            mine_invariants();
+        }
+        if (0 < opts::OptsMgr::INSTANCE().bdd_approx()) {
+            approximate_reachable();
+        }
+
+        setup_engine(f_engine);
+        collect_state_bits();
+
+        /* a single transition, INIT and the target are activated by
+           assumptions */
+        f_init_act = f_engine.new_sat_var(true);
+        f_bad_act = f_engine.new_sat_var(true);
+
+        assert_fsm_init(f_engine, 0, f_init_act);
+        assert_fsm_invar(f_engine, 0);
+        assert_fsm_trans(f_engine, 0);
+        assert_fsm_invar(f_engine, 1);
+        assert_formula(f_engine, 0, target_cu, f_bad_act);
+
+        for (auto i = f_constraints.begin(); i != f_constraints.end(); ++i) {
+            compiler::Unit cu { compiler().process(ctx, *i) };
+
+            assert_formula(f_engine, 0, cu);
+            assert_formula(f_engine, 1, cu);
+        }
+
+        /* F_0 is INIT */
+        f_frame_acts.push_back(f_init_act);
+        f_frames.push_back(std::vector<Cube>());
+
+        {
+            vec<Lit> assumptions;
+            assumptions.push(mkLit(f_init_act));
+            assumptions.push(mkLit(f_bad_act));
+
+            sat::status_t status { solve(assumptions) };
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            if (sat::status_t::STATUS_SAT == status) {
+                f_cex_depth = 0;
+                build_witness();
+                goto cleanup;
+            }
+        }
+
+        new_frame();
+        for (unsigned k = 1; reach::REACHABILITY_UNKNOWN == f_status; ++k) {
+            INFO
+                << "PDR: blocking target in frame "
+                << k
+                << "..."
+                << std::endl;
+
+            /* block all target states in F_k */
+            while (true) {
+                Cube cube;
+                sat::status_t status { bad_state(k, cube) };
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                if (sat::status_t::STATUS_UNSAT == status) {
+                    break;
+                }
+
+                status = block(cube, k);
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    INFO
+                        << "PDR: counterexample found (k = "
+                        << f_cex_depth
+                        << ")"
+                        << std::endl;
+
+                    build_witness();
+                    goto cleanup;
+                }
+            }
+
+            new_frame();
+
+            sat::status_t status { propagate(k) };
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "PDR: fixpoint reached (frame "
+                    << f_fixpoint
+                    << "), target is UNREACHABLE."
+                    << std::endl;
+
+                build_invariant();
+                f_status = reach::REACHABILITY_UNREACHABLE;
+                goto cleanup;
+            }
+
+            TRACE
+                << "PDR: done with frame "
+                << k
+                << ", "
+                << f_stats.lemmas
+                << " lemmas so far"
+                << std::endl;
+        }
+
+    cleanup:
+        INFO
+            << f_engine
+            << std::endl;
+    }
+
+    void PDR::collect_state_bits()
+    {
+        enc::EncodingMgr& bm { f_engine.enc() };
+        symb::SymbIter symbols { model() };
+
+        /* state bits are the encoding bits of all non-input vars */
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symbol { pair.second };
+
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+            if (var.is_input() || var.is_temp()) {
+                continue;
+            }
+
+            expr::Expr_ptr name { em().make_dot(ctx, var.name()) };
+            expr::TimedExpr key { name, 0 };
+            enc::Encoding_ptr enc { bm.find_encoding(key) };
+
+            if (!enc) {
+                continue;
+            }
+
+            unsigned width { static_cast<unsigned>(enc->bits().size()) };
+
+            dd::DDVector::const_iterator di;
+            unsigned ndx;
+            for (ndx = 0, di = enc->bits().begin(); enc->bits().end() != di; ++ndx, ++di) {
+                unsigned bit { di->getNode()->index };
+                const enc::UCBI& ucbi { bm.find_ucbi(bit) };
+
+                /* encoding bits are MSB first */
+                StateBit sb;
+                sb.name = name;
+                sb.bit = width - ndx - 1;
+                sb.width = width;
+                sb.curr = f_engine.tcbi_to_var(enc::TCBI(ucbi, 0));
+                sb.next = f_engine.tcbi_to_var(enc::TCBI(ucbi, 1));
+
+                f_state_bits.push_back(sb);
+            }
+        }
+
+        size_t count { f_state_bits.size() };
+        TRACE
+            << "PDR: "
+            << count
+            << " state bits"
+            << std::endl;
+    }
+
+    void PDR::new_frame()
+    {
+        f_frame_acts.push_back(f_engine.new_sat_var(true));
+        f_frames.push_back(std::vector<Cube>());
+    }
+
+    void PDR::assume_frame(vec<Lit>& assumptions, unsigned level)
+    {
+        /* lemmas hold in INIT too, they can be assumed in F_0 */
+        if (!level) {
+            assumptions.push(mkLit(f_init_act));
+            level = 1;
+        }
+
+        for (unsigned j = level; j < f_frame_acts.size(); ++j) {
+            assumptions.push(mkLit(f_frame_acts[j]));
+        }
+    }
+
+    void PDR::assume_cube(vec<Lit>& assumptions, const Cube& cube, bool next)
+    {
+        for (unsigned lit : cube) {
+            const StateBit& sb { f_state_bits[lit >> 1] };
+            assumptions.push(mkLit(next ? sb.next : sb.curr, lit & 1));
+        }
+    }
+
+    void PDR::extract(Cube& res)
+    {
+        res.clear();
+        for (unsigned i = 0; i < f_state_bits.size(); ++i) {
+            res.push_back(2 * i + (f_engine.value(f_state_bits[i].curr) ? 0 : 1));
+        }
+    }
+
+    sat::status_t PDR::solve(vec<Lit>& assumptions)
+    {
+        ++f_stats.queries;
+        return f_engine.solve(assumptions);
+    }
+
+    sat::status_t PDR::bad_state(unsigned level, Cube& res)
+    {
+        vec<Lit> assumptions;
+        assume_frame(assumptions, level);
+        assumptions.push(mkLit(f_bad_act));
+
+        sat::status_t status { solve(assumptions) };
+        if (sat::status_t::STATUS_SAT == status) {
+            extract(res);
+        }
+
+        return status;
+    }
+
+    sat::status_t PDR::intersects_init(const Cube& cube)
+    {
+        vec<Lit> assumptions;
+        assumptions.push(mkLit(f_init_act));
+        assume_cube(assumptions, cube, false);
+
+        return solve(assumptions);
+    }
+
+    sat::status_t PDR::relative_induction(unsigned level, const Cube& cube,
+                                          Cube& res, bool strengthen)
+    {
+        vec<Lit> assumptions;
+        assume_frame(assumptions, level);
+
+        /* !cube is only needed for this query, its clause is retired
+           right after */
+        Var act { 0 };
+        if (strengthen) {
+            act = f_engine.new_sat_var(true);
+
+            vec<Lit> ps;
+            ps.push(mkLit(act, true));
+            for (unsigned lit : cube) {
+                const StateBit& sb { f_state_bits[lit >> 1] };
+                ps.push(mkLit(sb.curr, !(lit & 1)));
+            }
+            f_engine.add_clause(ps);
+
+            assumptions.push(mkLit(act));
+        }
+
+        int first { assumptions.size() };
+        assume_cube(assumptions, cube, true);
+
+        sat::status_t status { solve(assumptions) };
+        if (sat::status_t::STATUS_SAT == status) {
+            extract(res);
+        } else if (sat::status_t::STATUS_UNSAT == status) {
+            res.clear();
+            for (unsigned i = 0; i < cube.size(); ++i) {
+                if (f_engine.failed(assumptions[first + i])) {
+                    res.push_back(cube[i]);
+                }
+            }
+        }
+
+        if (strengthen) {
+            vec<Lit> ps;
+            ps.push(mkLit(act, true));
+            f_engine.add_clause(ps);
+        }
+
+        return status;
+    }
+
+    sat::status_t PDR::block(const Cube& cube, unsigned level)
+    {
+        std::priority_queue<Obligation> obligations;
+        obligations.push(Obligation { level, 0, cube });
+
+        while (!obligations.empty()) {
+            Obligation ob { obligations.top() };
+            ++f_stats.obligations;
+
+            if (!ob.level) {
+                f_cex_depth = ob.depth;
+                return sat::status_t::STATUS_SAT;
+            }
+
+            Cube res;
+            sat::status_t status { relative_induction(ob.level - 1, ob.cube, res) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return status;
+            }
+
+            if (sat::status_t::STATUS_SAT == status) {
+                /* a predecessor, either initial or to be blocked in
+                   the previous frame */
+                status = intersects_init(res);
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    return status;
+                }
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    f_cex_depth = 1 + ob.depth;
+                    return status;
+                }
+
+                obligations.push(Obligation { ob.level - 1, 1 + ob.depth, res });
+                continue;
+            }
+
+            obligations.pop();
+
+            Cube lemma;
+            status = generalize(ob.level - 1, ob.cube, res, lemma);
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return status;
+            }
+
+            /* push the lemma as far as possible */
+            unsigned lemma_level { ob.level };
+            while (lemma_level < level) {
+                Cube core;
+                status = relative_induction(lemma_level, lemma, core);
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    return status;
+                }
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    break;
+                }
+
+                ++lemma_level;
+            }
+
+            add_lemma(lemma_level, lemma);
+
+            /* the same states must be blocked in later frames too */
+            if (lemma_level < level) {
+                obligations.push(Obligation { 1 + lemma_level, ob.depth, ob.cube });
+            }
+        }
+
+        return sat::status_t::STATUS_UNSAT;
+    }
+
+    sat::status_t PDR::generalize(unsigned level, const Cube& cube,
+                                  const Cube& core, Cube& res)
+    {
+        /* Start from the unsat core of the consecution query. The
+           lemma must exclude INIT, if the core does not the whole
+           cube is used instead (it does, by construction). */
+        sat::status_t status { intersects_init(core) };
+        if (sat::status_t::STATUS_UNKNOWN == status) {
+            return status;
+        }
+
+        res = sat::status_t::STATUS_SAT == status ? cube : core;
+
+        /* drop literals, one at a time */
+        unsigned attempts { 0 };
+        for (unsigned i = 0; i < res.size() && attempts < MAX_DROP_ATTEMPTS; ++attempts) {
+            Cube candidate { res };
+            candidate.erase(candidate.begin() + i);
+
+            status = candidate.empty()
+                         ? sat::status_t::STATUS_SAT
+                         : intersects_init(candidate);
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return status;
+            }
+
+            if (sat::status_t::STATUS_UNSAT == status) {
+                Cube unused;
+                status = relative_induction(level, candidate, unused);
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    return status;
+                }
+            }
+
+            if (sat::status_t::STATUS_UNSAT == status) {
+                res = candidate;
+            } else {
+                ++i;
+            }
+        }
+
+        return sat::status_t::STATUS_UNSAT;
+    }
+
+    void PDR::add_lemma(unsigned level, const Cube& cube)
+    {
+        assert(0 < level && level < f_frames.size());
+        f_frames[level].push_back(cube);
+        ++f_stats.lemmas;
+
+        /* act_level -> !cube */
+        vec<Lit> ps;
+        ps.push(mkLit(f_frame_acts[level], true));
+        for (unsigned lit : cube) {
+            const StateBit& sb { f_state_bits[lit >> 1] };
+            ps.push(mkLit(sb.curr, !(lit & 1)));
+        }
+        f_engine.add_clause(ps);
+
+        std::string clause { to_string(cube) };
+        DEBUG
+            << "PDR: new lemma in frame "
+            << level
+            << ": "
+            << clause
+            << std::endl;
+    }
+
+    sat::status_t PDR::propagate(unsigned k)
+    {
+        for (unsigned level = 1; level <= k; ++level) {
+            std::vector<Cube> lemmas;
+            lemmas.swap(f_frames[level]);
+
+            for (const Cube& lemma : lemmas) {
+                Cube res;
+
+                /* the lemma already holds in F_level, no need to
+                   strengthen the query with it */
+                sat::status_t status { relative_induction(level, lemma, res, false) };
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    return status;
+                }
+
+                if (sat::status_t::STATUS_UNSAT == status) {
+                    add_lemma(1 + level, lemma);
+                    --f_stats.lemmas; /* moved, not new */
+                    ++f_stats.propagated;
+                } else {
+                    f_frames[level].push_back(lemma);
+                }
+            }
+
+            /* F_level == F_level+1, an inductive invariant */
+            if (f_frames[level].empty()) {
+                f_fixpoint = level;
+                return sat::status_t::STATUS_SAT;
+            }
+        }
+
+        return sat::status_t::STATUS_UNSAT;
+    }
+
+    void PDR::build_witness()
+    {
+        sat::Engine engine { "pdr-witness" };
+        setup_engine(engine);
+
+        /* the counterexample is replayed with BMC, it is known to be
+           exactly f_cex_depth steps long */
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+        for (step_t k = 0; k < f_cex_depth; ++k) {
+            assert_fsm_trans(engine, k);
+            assert_fsm_invar(engine, 1 + k);
+        }
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        for (auto i = f_constraints.begin(); i != f_constraints.end(); ++i) {
+            compiler::Unit cu { compiler().process(ctx, *i) };
+
+            for (step_t k = 0; k <= f_cex_depth; ++k) {
+                assert_formula(engine, k, cu);
+            }
+        }
+
+        compiler::Unit target_cu { compiler().process(ctx, f_target) };
+        assert_formula(engine, f_cex_depth, target_cu);
+
+        engine.set_step(f_cex_depth);
+        sat::status_t status { engine.solve() };
+
+        if (sat::status_t::STATUS_SAT != status) {
+            WARN
+                << "PDR: could not replay counterexample (k = "
+                << f_cex_depth
+                << ")"
+                << std::endl;
+
+            return;
+        }
+
+        f_status = reach::REACHABILITY_REACHABLE;
+
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        witness::Witness& w {
+            *new reach::ReachabilityCounterExample(f_target, model(), engine, f_cex_depth)
+        };
+
+        /* witness identifier */
+        std::ostringstream oss_id;
+        oss_id
+            << reach_trace_prfx
+            << wm.autoincrement();
+        w.set_id(oss_id.str());
+
+        /* witness description */
+        std::ostringstream oss_desc;
+        oss_desc
+            << "Reachability witness for target `"
+            << f_target
+            << "` in module `"
+            << model().main_module().name()
+            << "`";
+        w.set_desc(oss_desc.str());
+
+        wm.record(w);
+        wm.set_current(w);
+        set_witness(w);
+    }
+
+    void PDR::build_invariant()
+    {
+        /* all lemmas beyond the fixpoint frame */
+        f_invariant.clear();
+        for (unsigned level = 1 + f_fixpoint; level < f_frames.size(); ++level) {
+            for (const Cube& lemma : f_frames[level]) {
+                f_invariant.push_back(to_string(lemma));
+            }
+        }
+    }
+
+    std::string PDR::to_string(const Cube& cube) const
+    {
+        std::ostringstream oss;
+
+        /* bits of multi-bit encodings are written `<var>#<bit>` */
+        for (unsigned i = 0; i < cube.size(); ++i) {
+            const StateBit& sb { f_state_bits[cube[i] >> 1] };
+
+            if (i) {
+                oss << " | ";
+            }
+
+            if (!(cube[i] & 1)) {
+                oss << "!";
+            }
+
+            oss << sb.name;
+            if (1 < sb.width) {
+                oss << "#" << sb.bit;
+            }
+        }
+
+        if (cube.empty()) {
+            oss << "FALSE";
+        }
+
+        return oss.str();
+    }
+
+    void PDR::print_frames(std::ostream& os) const
+    {
+        os
+            << f_frames.size() - 1
+            << " frames, lemmas: ";
+
+        for (unsigned level = 1; level < f_frames.size(); ++level) {
+            if (1 < level) {
+                os << " ";
+            }
+
+            os
+                << "F"
+                << level
+                << "="
+                << f_frames[level].size();
+        }
+
+        os
+            << " (total "
+            << f_stats.lemmas
+            << ", propagated "
+            << f_stats.propagated
+            << "), obligations: "
+            << f_stats.obligations
+            << ", queries: "
+            << f_stats.queries;
+    }
+
+} // namespace pdr
@@ -0,0 +1,166 @@
+/**
+ * @file pdr.hh
+ * @brief SAT-based IC3/PDR reachability analysis algorithm
+ *
+ * This header file contains the declarations required to implement
+ * the IC3/PDR (Property Directed Reachability) algorithm. Unlike the
+ * BMC strategies, PDR never unrolls the transition relation: it
+ * maintains a sequence of frames, over-approximations of the states
+ * reachable in at most k steps, and strengthens them with clauses
+ * blocking the states leading to the target. The target is proved
+ * unreachable when two consecutive frames become equal, at which
+ * point the frame is an inductive invariant.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef PDR_ALGORITHM_H
+#define PDR_ALGORITHM_H
+
+#include <algorithms/base.hh>
+#include <algorithms/reach/typedefs.hh>
+
+#include <cmd/command.hh>
+
+#include <compiler/typedefs.hh>
+
+namespace pdr {
+
+    /* A state bit: one bit of the encoding of a state variable, and
+     * its SAT vars in the current (0) and next (1) state. */
+    struct StateBit {
+        expr::Expr_ptr name;
+        unsigned bit; /* LSB first */
+        unsigned width;
+
+        Var curr;
+        Var next;
+    };
+
+    /* Cubes are sorted sets of state bit literals, encoded as 2 *
+     * <state bit index> + <1 iff the bit is false>. */
+    typedef std::vector<unsigned> Cube;
+
+    struct PDRStats {
+        PDRStats()
+            : queries(0)
+            , obligations(0)
+            , lemmas(0)
+            , propagated(0)
+        {}
+
+        unsigned queries;
+        unsigned obligations;
+        unsigned lemmas;
+        unsigned propagated;
+    };
+
+    class PDR: public algorithms::Algorithm {
+
+    public:
+        PDR(cmd::Command& command, model::Model& model);
+        ~PDR();
+
+        void process(expr::Expr_ptr target, expr::ExprVector constraints);
+
+        inline reach::reachability_status_t status() const
+        {
+            return f_status;
+        }
+
+        /* inductive invariant, one clause for each element (only
+         * meaningful if the target is UNREACHABLE) */
+        inline const std::vector<std::string>& invariant() const
+        {
+            return f_invariant;
+        }
+
+        /* frames and lemmas statistics */
+        void print_frames(std::ostream& os) const;
+
+    private:
+        /* state bits and activation vars */
+        void collect_state_bits();
+        void new_frame();
+
+        /* F_level (INIT for level 0) assumptions */
+        void assume_frame(vec<Lit>& assumptions, unsigned level);
+        void assume_cube(vec<Lit>& assumptions, const Cube& cube, bool next);
+
+        /* state cube from the last model */
+        void extract(Cube& res);
+
+        /* SAT queries, a non-UNKNOWN status is always returned
+         * unless interrupted */
+        sat::status_t solve(vec<Lit>& assumptions);
+        sat::status_t bad_state(unsigned level, Cube& res);
+        sat::status_t intersects_init(const Cube& cube);
+
+        /* F_level & !cube & T & cube'. If UNSAT, res is the subset
+         * of cube needed to prove it, otherwise res is a predecessor
+         * state in F_level. */
+        sat::status_t relative_induction(unsigned level, const Cube& cube,
+                                         Cube& res, bool strengthen = true);
+
+        /* SAT iff cube can reach the target (a counterexample has
+         * been found, see f_cex_depth), UNSAT iff cube has been
+         * blocked in F_level */
+        sat::status_t block(const Cube& cube, unsigned level);
+        sat::status_t generalize(unsigned level, const Cube& cube,
+                                 const Cube& core, Cube& res);
+        void add_lemma(unsigned level, const Cube& cube);
+
+        /* SAT iff a fixpoint has been reached (f_fixpoint) */
+        sat::status_t propagate(unsigned k);
+
+        /* counterexample, as a BMC witness of length f_cex_depth */
+        void build_witness();
+        void build_invariant();
+
+        /* lemma clause (i.e. negated cube) as a string */
+        std::string to_string(const Cube& cube) const;
+
+        expr::Expr_ptr f_target;
+        expr::ExprVector f_constraints;
+
+        reach::reachability_status_t f_status;
+
+        sat::Engine f_engine;
+
+        std::vector<StateBit> f_state_bits;
+
+        /* activation vars for INIT, the target, and each frame */
+        Var f_init_act;
+        Var f_bad_act;
+        std::vector<Var> f_frame_acts;
+
+        /* lemmas at each level (delta encoding, each lemma holds in
+         * all frames up to its level) */
+        std::vector<std::vector<Cube>> f_frames;
+
+        unsigned f_cex_depth;
+        unsigned f_fixpoint;
+
+        std::vector<std::string> f_invariant;
+        PDRStats f_stats;
+    };
+
+} // namespace pdr
+
+#endif /* PDR_ALGORITHM_H */
@@ -22,10 +22,9 @@
  **/
 
 #include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
 #include <algorithms/reach/witness.hh>
 
-#include <expr/time/analyzer/analyzer.hh>
-
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -37,25 +36,20 @@ namespace reach {
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
 
         sat::Engine engine { "backward" };
+        setup_engine(engine);
+        /* imports learnts from fast_backward, whose clauses are a
+           subset of ours (uniqueness constraints are only asserted here) */
+        share_learnts(engine, "backward", sat::EXCHANGE_IMPORT);
         step_t k { 0 };
 
         /* goal state constraints */
         assert_formula(engine, UINT_MAX - k, target_cu);
         assert_fsm_invar(engine, UINT_MAX - k);
 
-        /* Timed constraints can be asserted immediately, global
-           constraints must be asserted at time zero, therefore we
-           don't need any filtering here. */
-        std::for_each(
-            begin(f_constraints), end(f_constraints),
-            [this, &engine, k](expr::Expr_ptr constraint) {
-                auto i { f_constraint_cus.find(constraint) };
-                assert(f_constraint_cus.end() != i);
-
-                compiler::Unit cu { i->second };
-                this->assert_formula(engine, UINT_MAX - k, cu);
-            });
+        /* constraints on the goal frame */
+        assert_constraints(engine, k, true);
 
+        engine.set_step(k);
         sat::status_t status { engine.solve() };
 
         if (sat::status_t::STATUS_UNKNOWN == status) {
@@ -82,13 +76,25 @@ namespace reach {
         }
 
         do {
-            /* looking for witness : I(k-1) ^ Reachability(k-1) ^ ... ^! P(0) */
-            assert_fsm_init(engine, UINT_MAX - k, engine.new_group());
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* looking for witness : I(k-1) ^ Reachability(k-1) ^ ... ^! P(0),
+               the constraints timed from INIT too */
+            sat::group_t group { engine.new_group() };
+            assert_fsm_init(engine, UINT_MAX - k, group);
+            assert_far_constraints(engine, k, true, group);
             INFO
                 << "Now looking for reachability witness (k = " << k << ")..."
                 << std::endl;
 
-            sat::status_t status { engine.solve() };
+            /* step k is the witness query of k steps, then the proof
+               query of k + 1. Neither succeeded at steps completed
+               before */
+            engine.set_step(k);
+            sat::status_t status {
+                resumed(engine, k) ? sat::status_t::STATUS_UNSAT : engine.solve()
+            };
 
             if (sat::status_t::STATUS_UNKNOWN == status) {
                 goto cleanup;
@@ -122,9 +128,9 @@ namespace reach {
                     wm.record(w);
                     wm.set_current(w);
                     set_witness(w);
-
-                    goto cleanup;
                 }
+
+                goto cleanup;
             }
 
             else if (sat::status_t::STATUS_UNSAT == status) {
@@ -132,37 +138,19 @@ namespace reach {
                     << "No reachability witness found (k = " << k << ")..."
                     << std::endl;
 
-                engine.invert_last_group();
+                engine.retire_last_group();
 
                 /* unrolling next */
                 ++k;
                 assert_fsm_trans(engine, UINT_MAX - k);
                 assert_fsm_invar(engine, UINT_MAX - k);
 
-                /* Only global (i.e. untimed) constraints need be asserted here */
-                std::for_each(
-                    begin(f_constraints), end(f_constraints),
-                    [this, &engine, k](expr::Expr_ptr constraint) {
-                        expr::time::Analyzer eta { em() };
-                        eta.process(constraint);
-
-                        /* if forward time made it up to this point, something went wrong */
-                        assert(!eta.has_forward_time());
-
-                        if (!eta.has_backward_time()) {
-                            auto i { f_constraint_cus.find(constraint) };
-                            assert(f_constraint_cus.end() != i);
-
-                            compiler::Unit cu { i->second };
-                            this->assert_formula(engine, UINT_MAX - k, cu);
-                        }
-                    });
+                /* constraints on the new frame */
+                assert_constraints(engine, k, true);
 
                 /* build state uniqueness constraint for each pair of states
                    (j, k), where j < k */
-                for (step_t j = 0; j < k; ++j) {
-                    assert_fsm_uniqueness(engine, UINT_MAX - j, UINT_MAX - k);
-                }
+                assert_fsm_simple_path(engine, k, true);
 
                 /* is this still relevant? */
                 if (sync_status() != REACHABILITY_UNKNOWN) {
@@ -173,7 +161,11 @@ namespace reach {
                     << "Now looking for unreachability proof (k = " << k << ")..."
                     << std::endl;
 
-                sat::status_t status { engine.solve() };
+                engine.set_step(k);
+                sat::status_t status {
+                    resumed(engine, k - 1) ? sat::status_t::STATUS_SAT
+                                           : solve_simple_path(engine, k, true)
+                };
 
                 if (sat::status_t::STATUS_UNKNOWN == status) {
                     goto cleanup;
@@ -183,6 +175,8 @@ namespace reach {
                     INFO
                         << "No unreachability proof found (k = " << k << ")"
                         << std::endl;
+
+                    checkpoint(engine, k - 1);
                 }
 
                 else if (sat::status_t::STATUS_UNSAT == status) {
@@ -206,8 +200,8 @@ namespace reach {
         } while (sync_status() == REACHABILITY_UNKNOWN);
 
     cleanup:
-        /* signal other threads it's time to go home */
-        sat::EngineMgr::INSTANCE().interrupt();
+        /* signal sibling strategies it's time to go home */
+        cancel();
 
         INFO
             << engine
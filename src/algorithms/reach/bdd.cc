@@ -0,0 +1,410 @@
+/**
+ * @file reach/bdd.cc
+ * @brief BDD-based reachability analysis algorithm implementation.
+ *
+ * Exact forward fixpoint, for models made of plain DDs only. TRANS is
+ * kept partitioned, in clusters of bounded size, current state vars
+ * are quantified out as soon as no cluster left depends on them. The
+ * strategy runs on a DD manager of its own, and gives way to the
+ * SAT-based ones as soon as its BDDs grow beyond a node limit.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+#include <algorithms/reach/witness.hh>
+
+#include <dd/cudd_mgr.hh>
+#include <dd/transfer.hh>
+
+static const char* reach_trace_prfx { "reach_" };
+
+/* max size of the BDDs of the reached states and of the images */
+static const int bdd_reach_node_limit { 1 << 20 };
+
+/* TRANS partitions are clustered up to this size */
+static const int bdd_reach_cluster_limit { 1 << 12 };
+
+namespace reach {
+
+    void Reachability::bdd_reach_strategy(compiler::Unit& target_cu)
+    {
+        std::vector<int> state;
+        std::vector<int> next;
+        fsm_state_bits(state, next);
+
+        /* all BDDs are gone once bdd_reach returns */
+        dd::CuddMgr& cm { dd::CuddMgr::INSTANCE() };
+        Cudd& dd { cm.dd() };
+
+        std::vector<std::vector<bool>> path;
+        step_t k { 0 };
+        reachability_status_t status {
+            bdd_reach(dd, target_cu, state, next, path, k)
+        };
+
+        cm.release(dd);
+
+        if (REACHABILITY_UNREACHABLE == status) {
+            INFO
+                << "BDD fixpoint reached (k = " << k << "), target `"
+                << f_target
+                << "` is UNREACHABLE."
+                << std::endl;
+
+            sync_set_status(REACHABILITY_UNREACHABLE);
+            cancel();
+        }
+
+        else if (REACHABILITY_REACHABLE == status) {
+            path_witness("bdd_reach", target_cu, state, path);
+        }
+    }
+
+    reachability_status_t Reachability::bdd_reach(Cudd& dd, compiler::Unit& target_cu,
+                                                  const std::vector<int>& state,
+                                                  const std::vector<int>& next,
+                                                  std::vector<std::vector<bool>>& path,
+                                                  step_t& k)
+    {
+        dd::DDTransfer transfer { dd };
+
+        dd::DDVector init_dds;
+        dd::DDVector invar_dds;
+        dd::DDVector trans_dds;
+        dd::DDVector target_dds;
+        dd::DDVector constraint_dds;
+
+        compiler::Units target_cus { target_cu };
+        if (!fsm_dds(transfer, init_dds, invar_dds, trans_dds) ||
+            !plain_dds(transfer, target_cus, target_dds) ||
+            !plain_dds(transfer, f_global_cus, constraint_dds)) {
+            INFO
+                << "FSM is not made of plain DDs, BDD reachability is not available"
+                << std::endl;
+
+            return REACHABILITY_UNKNOWN;
+        }
+
+        /* current and next state vars, on this manager */
+        for (unsigned i = 0; i < state.size(); ++i) {
+            dd.bddVar(state[i]);
+            if (-1 != next[i]) {
+                dd.bddVar(next[i]);
+            }
+        }
+
+        int size { dd.ReadSize() };
+        std::vector<int> kind(size, 0);
+
+        /* current and next state vars are swapped by images */
+        std::vector<int> swap(size);
+        for (int index = 0; index < size; ++index) {
+            swap[index] = index;
+        }
+
+        std::vector<BDD> vars;
+        BDD next_cube { dd.bddOne() };
+        for (unsigned i = 0; i < state.size(); ++i) {
+            kind[state[i]] = 1;
+            vars.push_back(dd.bddVar(state[i]));
+
+            if (-1 != next[i]) {
+                kind[next[i]] = 2;
+                swap[state[i]] = next[i];
+                swap[next[i]] = state[i];
+                next_cube &= dd.bddVar(next[i]);
+            }
+        }
+
+        auto conjunction = [&dd](const dd::DDVector& dds) {
+            BDD res { dd.bddOne() };
+            for (const auto& add : dds) {
+                res &= add.BddPattern();
+            }
+
+            return res;
+        };
+
+        /* vars other than the state ones are only defined by the CNF
+           (e.g. frames beyond the next one) */
+        auto supported = [size, &kind](const BDD& bdd, int max_kind) {
+            for (auto index : bdd.SupportIndices()) {
+                if (size <= (int) index || 0 == kind[index] || max_kind < kind[index]) {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        BDD constraints { conjunction(invar_dds) & conjunction(constraint_dds) };
+        BDD init { conjunction(init_dds) & constraints };
+        BDD target { conjunction(target_dds) };
+
+        /* TRANS partitions, and constraints on next states */
+        std::vector<BDD> partitions;
+        for (const auto& add : trans_dds) {
+            partitions.push_back(add.BddPattern());
+        }
+        partitions.push_back(constraints.Permute(&swap[0]));
+
+        bool ok { supported(constraints, 1) && supported(init, 1) && supported(target, 1) };
+        for (const auto& partition : partitions) {
+            ok = ok && supported(partition, 2);
+        }
+        if (!ok) {
+            INFO
+                << "FSM depends on more than two time frames, BDD reachability is not available"
+                << std::endl;
+
+            return REACHABILITY_UNKNOWN;
+        }
+
+        /* adjacent partitions are merged, up to the cluster limit */
+        std::vector<BDD> clusters;
+        BDD cluster { dd.bddOne() };
+        for (const auto& partition : partitions) {
+            BDD merged { cluster & partition };
+
+            if (bdd_reach_cluster_limit < merged.nodeCount() && !cluster.IsOne()) {
+                clusters.push_back(cluster);
+                cluster = partition;
+            } else {
+                cluster = merged;
+            }
+        }
+        clusters.push_back(cluster);
+
+        /* early quantification, each current state var goes with the
+           last cluster depending on it (or before the first one, if
+           none does). Frozen vars are never quantified */
+        std::vector<int> last(size, -1);
+        for (unsigned i = 0; i < clusters.size(); ++i) {
+            for (auto index : clusters[i].SupportIndices()) {
+                last[index] = i;
+            }
+        }
+
+        BDD early_cube { dd.bddOne() };
+        std::vector<BDD> cubes(clusters.size(), dd.bddOne());
+        for (unsigned i = 0; i < state.size(); ++i) {
+            if (-1 == next[i]) {
+                continue;
+            }
+
+            int index { state[i] };
+            BDD& cube { -1 == last[index] ? early_cube : cubes[last[index]] };
+            cube &= dd.bddVar(index);
+        }
+
+        auto image = [&](const BDD& from, BDD& res) {
+            res = from.ExistAbstract(early_cube);
+
+            for (unsigned i = 0; i < clusters.size(); ++i) {
+                res = res.AndAbstract(clusters[i], cubes[i]);
+
+                if (bdd_reach_node_limit < res.nodeCount()) {
+                    return false;
+                }
+            }
+
+            res = res.Permute(&swap[0]);
+            return true;
+        };
+
+        /* breadth-first, rings[j] are the states first reached in j
+           steps */
+        std::vector<BDD> rings { init };
+        BDD reached { init };
+
+        for (k = 0;; ++k) {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            if (REACHABILITY_UNKNOWN != sync_status() || limits_exceeded()) {
+                return REACHABILITY_UNKNOWN;
+            }
+
+            if (!(rings[k] & target).IsZero()) {
+                break;
+            }
+
+            BDD frontier;
+            if (!image(rings[k], frontier)) {
+                INFO
+                    << "BDD image exceeds node limit (k = " << k << "), "
+                    << "leaving target to SAT-based strategies..."
+                    << std::endl;
+
+                return REACHABILITY_UNKNOWN;
+            }
+
+            frontier &= !reached;
+            if (frontier.IsZero()) {
+                return REACHABILITY_UNREACHABLE;
+            }
+
+            reached |= frontier;
+
+            int nodes { reached.nodeCount() };
+            if (bdd_reach_node_limit < nodes) {
+                INFO
+                    << "BDD of reached states exceeds node limit (k = " << k << "), "
+                    << "leaving target to SAT-based strategies..."
+                    << std::endl;
+
+                return REACHABILITY_UNKNOWN;
+            }
+
+            rings.push_back(frontier);
+
+            TRACE
+                << "BDD image computed (k = " << k << "), "
+                << nodes << " nodes reached so far"
+                << std::endl;
+        }
+
+        INFO
+            << "Target is reachable in " << k << " steps (BDD), extracting witness..."
+            << std::endl;
+
+        /* a shortest path backwards, through the rings. Each state
+           of a ring has a predecessor in the previous one */
+        std::vector<BDD> states(k + 1);
+        states[k] = (rings[k] & target).PickOneMinterm(vars);
+
+        for (step_t j = k; 0 < j; --j) {
+            BDD pre { states[j].Permute(&swap[0]) };
+            for (const auto& cluster : clusters) {
+                pre &= cluster;
+            }
+
+            pre = pre.ExistAbstract(next_cube);
+            states[j - 1] = (rings[j - 1] & pre).PickOneMinterm(vars);
+        }
+
+        for (const auto& minterm : states) {
+            std::vector<bool> values;
+            for (const auto& var : vars) {
+                values.push_back(minterm.Leq(var));
+            }
+
+            path.push_back(values);
+        }
+
+        return REACHABILITY_REACHABLE;
+    }
+
+    void Reachability::path_witness(const char* name, compiler::Unit& target_cu,
+                                    const std::vector<int>& state,
+                                    const std::vector<std::vector<bool>>& path)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        sat::Engine engine { name };
+        setup_engine(engine);
+
+        step_t k { (step_t) path.size() - 1 };
+
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+        assert_constraints(engine, 0, false);
+
+        for (step_t j = 0; j < k; ++j) {
+            assert_fsm_trans(engine, j);
+            assert_fsm_invar(engine, j + 1);
+            assert_constraints(engine, j + 1, false);
+        }
+
+        assert_formula(engine, k, target_cu);
+
+        /* the states of the path, the model is then found by
+           propagation alone */
+        for (step_t j = 0; j <= k; ++j) {
+            for (unsigned i = 0; i < state.size(); ++i) {
+                vec<Lit> ps;
+                ps.push(mkLit(engine.find_dd_var(state[i], j), !path[j][i]));
+                engine.add_clause(ps);
+            }
+        }
+
+        engine.set_step(k);
+        sat::status_t status { engine.solve() };
+
+        if (sat::status_t::STATUS_UNKNOWN == status) {
+            goto cleanup;
+        }
+
+        else if (sat::status_t::STATUS_UNSAT == status) {
+            WARN
+                << "Witness of `" << name << "` could not be replayed (k = " << k << "), "
+                << "leaving target to SAT-based strategies..."
+                << std::endl;
+
+            goto cleanup;
+        }
+
+        INFO
+            << "Reachability witness exists (k = " << k << "), target `"
+            << f_target
+            << "` is REACHABLE."
+            << std::endl;
+
+        if (sync_set_status(REACHABILITY_REACHABLE)) {
+            /* Extract reachability witness */
+            witness::Witness& w {
+                *new ReachabilityCounterExample(f_target, model(), engine, k)
+            };
+
+            /* witness identifier */
+            std::ostringstream oss_id;
+            oss_id
+                << reach_trace_prfx
+                << wm.autoincrement();
+            w.set_id(oss_id.str());
+
+            /* witness description */
+            std::ostringstream oss_desc;
+            oss_desc
+                << "Reachability witness for target `"
+                << f_target
+                << "` in module `"
+                << model().main_module().name()
+                << "`";
+            w.set_desc(oss_desc.str());
+
+            wm.record(w);
+            wm.set_current(w);
+            set_witness(w);
+        }
+
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+    cleanup:
+        INFO
+            << engine
+            << std::endl;
+    } /* Reachability::path_witness() */
+
+} // namespace reach
@@ -0,0 +1,194 @@
+/**
+ * @file bmc/bidirectional.cc
+ * @brief SAT-based bidirectional BMC reachability analysis algorithm implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+#include <ctime>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/reach/witness.hh>
+#include <algorithms/scheduler.hh>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace reach {
+
+    static double thread_cpu_time()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+        return now.tv_sec + now.tv_nsec / 1e9;
+    }
+
+    /* Meet-in-the-middle BMC: a single engine holds k1 steps unrolled
+     * forward from INIT (times 0, .., k1) and k2 steps unrolled
+     * backward from the target (times UINT_MAX - k2, .., UINT_MAX).
+     * The two frontiers are joined by a group asserting the frames at
+     * k1 and UINT_MAX - k2 to be the same. When the join is UNSAT,
+     * either side is extended by one step, so that the overall length
+     * grows by one and witnesses are shortest. The side whose last
+     * extension was solved faster is extended next. Only supports
+     * global constraints. */
+    void Reachability::bidirectional_strategy(compiler::Unit& target_cu)
+    {
+        sat::Engine engine { "bidirectional" };
+        setup_engine(engine);
+
+        step_t k1 { 0 };
+        step_t k2 { 0 };
+
+        /* CPU time of the last solve after extending either side */
+        double forward_time { 0.0 };
+        double backward_time { 0.0 };
+        bool forward { true };
+
+        /* initial and goal constraints */
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+        assert_global_constraints(engine, 0);
+
+        assert_formula(engine, UINT_MAX, target_cu);
+        assert_fsm_invar(engine, UINT_MAX);
+        assert_global_constraints(engine, UINT_MAX);
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            step_t k { k1 + k2 };
+            assert_fsm_join(engine, k1, UINT_MAX - k2, engine.new_group());
+
+            INFO
+                << "Now looking for bidirectional reachability witness (k = " << k
+                << ", " << k1 << " forward, " << k2 << " backward)..."
+                << std::endl;
+
+            double t0 { thread_cpu_time() };
+
+            engine.set_step(k);
+            sat::status_t status { engine.solve() };
+
+            double elapsed { thread_cpu_time() - t0 };
+            (forward ? forward_time : backward_time) = elapsed;
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "Reachability witness exists (k = " << k << "), target `"
+                    << f_target
+                    << "` is REACHABLE."
+                    << std::endl;
+
+                if (sync_set_status(REACHABILITY_REACHABLE)) {
+
+                    /* Extract reachability witness, the join frame
+                       is only taken once */
+                    std::vector<step_t> times;
+                    for (step_t j = 0; j <= k1; ++j) {
+                        times.push_back(j);
+                    }
+                    for (step_t j = k2; 0 < j; --j) {
+                        times.push_back(UINT_MAX - j + 1);
+                    }
+
+                    witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+                    witness::Witness& w {
+                        *new ReachabilityCounterExample(f_target, model(), engine, times)
+                    };
+
+                    /* witness identifier */
+                    std::ostringstream oss_id;
+                    oss_id
+                        << reach_trace_prfx
+                        << wm.autoincrement();
+                    w.set_id(oss_id.str());
+
+                    /* witness description */
+                    std::ostringstream oss_desc;
+                    oss_desc
+                        << "Reachability witness for target `"
+                        << f_target
+                        << "` in module `"
+                        << model().main_module().name()
+                        << "`";
+                    w.set_desc(oss_desc.str());
+
+                    wm.record(w);
+                    wm.set_current(w);
+                    set_witness(w);
+                }
+
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No bidirectional reachability witness found (k = " << k << ")..."
+                    << std::endl;
+
+                engine.retire_last_group();
+
+                /* extend the cheaper side, the first time both are
+                   extended in turn */
+                forward = (0 == k2) ? (0 == k1) : forward_time <= backward_time;
+                if (forward) {
+                    assert_fsm_trans(engine, k1);
+                    ++k1;
+                    assert_fsm_invar(engine, k1);
+                    assert_global_constraints(engine, k1);
+                }
+
+                else {
+                    ++k2;
+                    assert_fsm_trans(engine, UINT_MAX - k2);
+                    assert_fsm_invar(engine, UINT_MAX - k2);
+                    assert_global_constraints(engine, UINT_MAX - k2);
+                }
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            TRACE
+                << "Done with k = " << k << "..."
+                << std::endl;
+
+        } while (sync_status() == REACHABILITY_UNKNOWN);
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << engine
+            << std::endl;
+    } /* Reachability::bidirectional_strategy() */
+
+} // namespace reach
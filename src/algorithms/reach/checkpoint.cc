@@ -0,0 +1,418 @@
+/**
+ * @file reach/checkpoint.cc
+ * @brief Checkpoints of reachability runs.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithms/reach/checkpoint.hh>
+
+#include <model/module.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/symb_iter.hh>
+
+#include <type/printers.hh>
+
+#include <utils/logging.hh>
+
+/* bump whenever the file format changes */
+static const char* checkpoint_magic { "yasmv-checkpoint 1" };
+
+namespace reach {
+
+    /* The problem a checkpoint is for: the model (its FSM and vars,
+     * printed), the word width, the target and the constraints. FSM
+     * statements and vars are not ordered, the constraints are. */
+    static std::size_t problem_digest(model::Model& model, expr::Expr_ptr target,
+                                      const expr::ExprVector& constraints)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        boost::hash<std::string> hash;
+        std::size_t res { 0 };
+
+        const model::Modules& modules { model.modules() };
+        for (model::Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+            model::Module& module { *mi->second };
+
+            const std::pair<const char*, const expr::ExprVector*> sections[] = {
+                { "INIT", &module.init() },
+                { "INVAR", &module.invar() },
+                { "TRANS", &module.trans() },
+            };
+            for (const auto& section : sections) {
+                for (auto body : *section.second) {
+                    std::ostringstream oss;
+                    oss
+                        << module.name()
+                        << " "
+                        << section.first
+                        << " "
+                        << body;
+                    res += hash(oss.str());
+                }
+            }
+        }
+
+        symb::SymbIter si { model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            symb::Symbol_ptr symbol { pair.second };
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+
+            std::ostringstream oss;
+            oss
+                << em.make_dot(pair.first, symbol->name())
+                << " : "
+                << var.type()
+                << " "
+                << var.is_input()
+                << var.is_frozen()
+                << var.is_inertial();
+            res += hash(oss.str());
+        }
+
+        boost::hash_combine(res, opts::OptsMgr::INSTANCE().word_width());
+
+        std::ostringstream oss;
+        oss
+            << target;
+        boost::hash_combine(res, hash(oss.str()));
+
+        for (auto constraint : constraints) {
+            std::ostringstream oss;
+            oss
+                << constraint;
+            boost::hash_combine(res, hash(oss.str()));
+        }
+
+        return res;
+    }
+
+    Checkpoint::Checkpoint(const std::string& path, model::Model& model,
+                           expr::Expr_ptr target, const expr::ExprVector& constraints)
+        : f_model(model)
+        , f_path(path)
+        , f_problem(problem_digest(model, target, constraints))
+        , f_last_save(time(NULL))
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Created Checkpoint @"
+            << instance
+            << std::endl;
+    }
+
+    Checkpoint::~Checkpoint()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Checkpoint @"
+            << instance
+            << std::endl;
+    }
+
+    bool Checkpoint::load(const std::string& path)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        std::ifstream is { path.c_str() };
+        if (!is) {
+            WARN
+                << "Could not open checkpoint `"
+                << path
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+
+        /* vars by their printed names */
+        boost::unordered_map<std::string, expr::Expr_ptr> vars;
+        symb::SymbIter si { f_model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            if (pair.second->is_variable()) {
+                expr::Expr_ptr full { em.make_dot(pair.first, pair.second->name()) };
+
+                std::ostringstream oss;
+                oss
+                    << full;
+                vars.insert(std::make_pair(oss.str(), full));
+            }
+        }
+
+        Entries entries;
+        try {
+            std::string magic;
+            std::getline(is, magic);
+            if (magic != checkpoint_magic) {
+                throw std::runtime_error("not a checkpoint");
+            }
+
+            std::string keyword;
+            std::size_t problem;
+            if (!(is >> keyword >> problem) || keyword != "problem") {
+                throw std::runtime_error("malformed header");
+            }
+            if (problem != f_problem) {
+                throw std::runtime_error("written for another model, target or constraints");
+            }
+
+            std::string strategy;
+            step_t k;
+            size_t n_learnts;
+            while (is >> keyword >> strategy >> k >> n_learnts) {
+                if (keyword != "strategy") {
+                    throw std::runtime_error("malformed strategy");
+                }
+
+                Entry& entry { entries[strategy] };
+                entry.k = k;
+                entry.restored = false;
+
+                for (size_t i = 0; i < n_learnts; ++i) {
+                    size_t size;
+                    if (!(is >> size)) {
+                        throw std::runtime_error("malformed learnt");
+                    }
+
+                    sat::SharedClause clause;
+                    for (size_t j = 0; j < size; ++j) {
+                        std::string name;
+                        step_t abs_time;
+                        unsigned bitno;
+                        bool negated;
+                        if (!(is >> name >> abs_time >> bitno >> negated)) {
+                            throw std::runtime_error("malformed literal");
+                        }
+
+                        boost::unordered_map<std::string, expr::Expr_ptr>::const_iterator vi {
+                            vars.find(name)
+                        };
+                        if (vars.end() == vi) {
+                            throw std::runtime_error("unknown var " + name);
+                        }
+
+                        /* absolute times, on no time base */
+                        enc::TCBI tcbi { enc::UCBI(vi->second, abs_time, bitno), 0 };
+                        clause.push_back(sat::SharedLit(tcbi, negated));
+                    }
+                    entry.learnts.push_back(clause);
+                }
+            }
+
+            if (!is.eof()) {
+                throw std::runtime_error("malformed strategy");
+            }
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not resume from checkpoint `"
+                << path
+                << "`: "
+                << what
+                << std::endl;
+
+            return false;
+        }
+
+        f_entries = entries;
+
+        for (const auto& entry : f_entries) {
+            step_t k { entry.second.k };
+            size_t n { entry.second.learnts.size() };
+            INFO
+                << "Resuming `"
+                << entry.first
+                << "` past k = "
+                << k
+                << ", "
+                << n
+                << " learnts"
+                << std::endl;
+        }
+
+        return true;
+    }
+
+    bool Checkpoint::completed(const std::string& strategy, step_t k)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Entries::const_iterator i { f_entries.find(strategy) };
+        return f_entries.end() != i && k <= i->second.k;
+    }
+
+    void Checkpoint::restore(sat::Engine& engine)
+    {
+        sat::SharedClauses learnts;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+
+            Entries::iterator i { f_entries.find(engine.name()) };
+            if (f_entries.end() == i || i->second.restored) {
+                return;
+            }
+
+            i->second.restored = true;
+            learnts = i->second.learnts;
+        }
+
+        engine.add_model_clauses(learnts);
+
+        size_t n { learnts.size() };
+        DEBUG
+            << "Restored "
+            << n
+            << " learnts"
+            << std::endl;
+    }
+
+    void Checkpoint::complete(sat::Engine& engine, step_t k)
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+
+        /* collected in the engine's thread */
+        time_t now { time(NULL) };
+        bool due;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            due = f_last_save + (time_t) om.checkpoint_interval() <= now;
+        }
+
+        sat::SharedClauses learnts;
+        if (due && 0 < om.checkpoint_learnts()) {
+            engine.model_learnts(om.checkpoint_learnts(), learnts);
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Entry& entry { f_entries[engine.name()] };
+        entry.k = k;
+        entry.restored = true;
+        if (due) {
+            entry.learnts = learnts;
+            save_aux();
+        }
+    }
+
+    bool Checkpoint::save()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return save_aux();
+    }
+
+    bool Checkpoint::save_aux()
+    {
+        f_last_save = time(NULL);
+
+        std::ostringstream tmpname;
+        tmpname
+            << f_path
+            << "."
+            << getpid();
+        boost::filesystem::path tmppath { tmpname.str() };
+
+        try {
+            {
+                std::ofstream os { tmppath.c_str() };
+
+                os
+                    << checkpoint_magic
+                    << std::endl
+                    << "problem "
+                    << f_problem
+                    << std::endl;
+
+                for (const auto& entry : f_entries) {
+                    const sat::SharedClauses& learnts { entry.second.learnts };
+
+                    os
+                        << "strategy "
+                        << entry.first
+                        << " "
+                        << entry.second.k
+                        << " "
+                        << learnts.size()
+                        << std::endl;
+
+                    for (const auto& clause : learnts) {
+                        os
+                            << clause.size();
+                        for (const auto& lit : clause) {
+                            os
+                                << " "
+                                << lit.first.expr()
+                                << " "
+                                << lit.first.absolute_time()
+                                << " "
+                                << lit.first.bitno()
+                                << " "
+                                << lit.second;
+                        }
+                        os
+                            << std::endl;
+                    }
+                }
+
+                if (!os) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+
+            rename(tmppath, boost::filesystem::path { f_path });
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not write checkpoint: "
+                << what
+                << std::endl;
+
+            boost::system::error_code ec;
+            remove(tmppath, ec);
+
+            return false;
+        }
+
+        DEBUG
+            << "Wrote checkpoint `"
+            << f_path
+            << "`"
+            << std::endl;
+
+        return true;
+    }
+
+} // namespace reach
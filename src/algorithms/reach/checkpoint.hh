@@ -0,0 +1,106 @@
+/**
+ * @file reach/checkpoint.hh
+ * @brief Checkpoints of reachability runs.
+ *
+ * This module contains the declarations of the checkpoints of
+ * reachability runs. A checkpoint keeps on disk, for each strategy,
+ * the last step it completed (i.e. no witness, nor proof, was found
+ * up to it) and, optionally, the short learnts of its SAT engine over
+ * model vars. A run resumed from a checkpoint unrolls the model as
+ * before, but skips the queries of the steps already completed, and
+ * adds the learnts back once its unrolling is past them. The
+ * unrolling itself is not stored, it is made again from the compiled
+ * units, which costs a fraction of solving it.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef REACHABILITY_CHECKPOINT_H
+#define REACHABILITY_CHECKPOINT_H
+
+#include <ctime>
+#include <string>
+
+#include <expr/expr.hh>
+
+#include <model/model.hh>
+
+#include <sat/sat.hh>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace reach {
+
+    class Checkpoint;
+    typedef Checkpoint* Checkpoint_ptr;
+
+    class Checkpoint {
+    public:
+        /* checkpoints of the run for target and constraints on
+           model, written to path */
+        Checkpoint(const std::string& path, model::Model& model,
+                   expr::Expr_ptr target, const expr::ExprVector& constraints);
+        ~Checkpoint();
+
+        /* reads the checkpoint at path, false (with a warning) if it
+           can not be read, or was written for another model, target
+           or constraints */
+        bool load(const std::string& path);
+
+        /* true iff strategy had completed step k */
+        bool completed(const std::string& strategy, step_t k);
+
+        /* adds the learnts saved for the strategy of engine, once */
+        void restore(sat::Engine& engine);
+
+        /* the strategy of engine completed step k, the checkpoint is
+           written if due (see --checkpoint-interval) */
+        void complete(sat::Engine& engine, step_t k);
+
+        /* written aside, then renamed: a run killed while writing
+           leaves the previous checkpoint */
+        bool save();
+
+    private:
+        struct Entry {
+            step_t k;
+            sat::SharedClauses learnts;
+            bool restored;
+        };
+
+        using Entries = boost::unordered_map<std::string, Entry>;
+
+        bool save_aux();
+
+        model::Model& f_model;
+        std::string f_path;
+
+        /* identifies the model, target and constraints */
+        std::size_t f_problem;
+
+        boost::mutex f_mutex;
+        Entries f_entries;
+
+        time_t f_last_save;
+    };
+
+} // namespace reach
+
+#endif /* REACHABILITY_CHECKPOINT_H */
@@ -0,0 +1,588 @@
+/**
+ * @file reach/cubes.cc
+ * @brief SAT-based BMC reachability analysis algorithm, cube-and-conquer.
+ *
+ * A forward witness query taking more conflicts than the threshold is
+ * split into cubes, i.e. assignments to a few splitting bits of its
+ * last frame. The splitting bits are picked by a lookahead phase,
+ * probing both values of each candidate bit with a short conflicts
+ * budget: failed values are implied by all cubes, the others are
+ * ranked by the product of the propagations of their two probes.
+ *
+ * Cubes are solved in parallel by engines of their own (unrolled
+ * from scratch, as SAT instances can not be copied), one for each
+ * worker. Each worker owns a deque of cubes, idle workers steal from
+ * the back of the others'. The first satisfiable cube interrupts all
+ * workers, the query is unsatisfiable if all cubes are.
+ *
+ * Remote workers (yasmv servers, see sat/remote.hh) take cubes from
+ * deques of their own too. They are sent the clauses of the forward
+ * unrolling as recorded, lazy array MUXes expanded, and the cubes as
+ * assumptions. A model found remotely is replayed on the forward
+ * unrolling, under the values of its model vars, so that the witness
+ * is extracted as if found locally.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <sstream>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+
+#include <symb/symb_iter.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <sat/dimacs.hh>
+#include <sat/remote.hh>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace reach {
+
+    /* conflicts budget of each lookahead probe */
+    static const int64_t LOOKAHEAD_CONFLICTS { 64 };
+
+    /* max number of candidate bits probed by the lookahead */
+    static const unsigned LOOKAHEAD_CANDIDATES { 64 };
+
+    /* a literal on a model bit at the last frame: 1 + bit index,
+       negative for false */
+    typedef int BitLit;
+    typedef std::vector<BitLit> Cube;
+
+    struct CubeDeque {
+        boost::mutex mutex;
+        std::deque<unsigned> cubes;
+    };
+
+    typedef boost::shared_ptr<CubeDeque> CubeDeque_ptr;
+
+    struct CubeSearch {
+        std::vector<Cube> cubes;
+        std::vector<CubeDeque_ptr> deques;
+
+        boost::mutex mutex;
+        bool found;
+        unsigned unsat;
+        std::vector<sat::Engine*> engines;
+        std::vector<sat::RemoteSolver*> remotes;
+
+        /* the CNF of the query and the cubes, for remote workers, and
+           the model found by any of them */
+        std::vector<int> clauses;
+        std::vector<int> assumptions;
+        std::vector<std::vector<int>> remote_cubes;
+        std::vector<int> remote_model;
+
+        /* true for the first satisfiable cube only, all workers are
+           interrupted */
+        bool win()
+        {
+            boost::mutex::scoped_lock lock { mutex };
+            bool res { !found };
+            found = true;
+
+            for (sat::Engine* engine : engines) {
+                engine->interrupt();
+            }
+            for (sat::RemoteSolver* remote : remotes) {
+                remote->interrupt();
+            }
+
+            return res;
+        }
+
+        /* a cube given back by a worker, for the others to steal */
+        void give_back(unsigned id, unsigned cube)
+        {
+            boost::mutex::scoped_lock lock { deques[id]->mutex };
+            deques[id]->cubes.push_back(cube);
+        }
+
+        /* pops a cube from worker's deque, or steals one from the back
+           of another's. False when no cube is left */
+        bool next(unsigned id, unsigned& cube)
+        {
+            unsigned n { (unsigned) deques.size() };
+            for (unsigned i = 0; i < n; ++i) {
+                CubeDeque& deque { *deques[(id + i) % n] };
+                boost::mutex::scoped_lock lock { deque.mutex };
+
+                if (deque.cubes.empty()) {
+                    continue;
+                }
+
+                if (0 == i) {
+                    cube = deque.cubes.front();
+                    deque.cubes.pop_front();
+                } else {
+                    cube = deque.cubes.back();
+                    deque.cubes.pop_back();
+                }
+
+                return true;
+            }
+
+            return false;
+        }
+    };
+
+    static inline Lit bit_lit(sat::Engine& engine, BitLit lit, step_t k)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        const enc::UCBI& ucbi { bm.find_ucbi(abs(lit) - 1) };
+
+        return mkLit(engine.tcbi_to_var(enc::TCBI(ucbi, k)), lit < 0);
+    }
+
+    /* the state and input bits, frozen vars excluded */
+    static std::vector<unsigned> candidate_bits(model::Model& model)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        std::vector<unsigned> res;
+
+        symb::SymbIter si { model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+
+            if (!symb->is_variable() || symb->as_variable().is_frozen()) {
+                continue;
+            }
+
+            expr::Expr_ptr key { em.make_dot(ctx, symb->name()) };
+            enc::Encoding_ptr enc { bm.find_encoding(expr::TimedExpr(key, 0)) };
+            if (!enc) {
+                continue;
+            }
+
+            dd::DDVector::const_iterator di;
+            for (di = enc->bits().begin(); enc->bits().end() != di; ++di) {
+                res.push_back((*di).getNode()->index);
+            }
+        }
+
+        std::sort(res.begin(), res.end());
+        res.erase(std::unique(res.begin(), res.end()), res.end());
+
+        /* evenly sampled, so that all vars are represented */
+        if (LOOKAHEAD_CANDIDATES < res.size()) {
+            std::vector<unsigned> sample;
+            for (unsigned i = 0; i < LOOKAHEAD_CANDIDATES; ++i) {
+                sample.push_back(res[i * res.size() / LOOKAHEAD_CANDIDATES]);
+            }
+            res.swap(sample);
+        }
+
+        return res;
+    }
+
+    sat::status_t Reachability::solve_forward_witness(sat::Engine& engine, step_t k,
+                                                      compiler::Unit& target_cu)
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+
+        /* the conflicts limit of the command would be overridden by
+           the threshold */
+        unsigned threshold { om.cube_and_conquer() };
+        if (0 < threshold && 0 == limits().conflicts) {
+            engine.configure(threshold, -1);
+        } else {
+            threshold = 0;
+        }
+
+        sat::status_t status { engine.solve() };
+
+        if (0 < threshold) {
+            engine.configure(-1, -1);
+
+            if (sat::status_t::STATUS_UNKNOWN == status && !cancelled() &&
+                REACHABILITY_UNKNOWN == sync_status()) {
+                INFO
+                    << "Witness query exceeded "
+                    << threshold
+                    << " conflicts (k = " << k << "), splitting into cubes..."
+                    << std::endl;
+
+                return cube_and_conquer(engine, k, target_cu);
+            }
+        }
+
+        if (sat::status_t::STATUS_SAT == status) {
+            record_forward_witness(engine, k);
+        }
+
+        return status;
+    }
+
+    sat::status_t Reachability::cube_and_conquer(sat::Engine& engine, step_t k,
+                                                 compiler::Unit& target_cu)
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+
+        /* lookahead: the values of the candidate bits are probed on
+           the query, under the values implied so far */
+        Cube implied;
+        std::vector<std::pair<uint64_t, BitLit>> ranking;
+
+        for (unsigned bit : candidate_bits(model())) {
+            uint64_t propagations[2];
+            bool failed[2];
+
+            for (unsigned polarity = 0; polarity < 2; ++polarity) {
+                BitLit lit { (BitLit) (1 + bit) * (polarity ? -1 : 1) };
+
+                vec<Lit> assumptions;
+                for (BitLit implied_lit : implied) {
+                    assumptions.push(bit_lit(engine, implied_lit, k));
+                }
+                Lit probe { bit_lit(engine, lit, k) };
+                assumptions.push(probe);
+
+                sat::SolverCounters before;
+                engine.counters(before);
+
+                engine.configure(LOOKAHEAD_CONFLICTS, -1);
+                sat::status_t status { engine.solve(assumptions) };
+
+                sat::SolverCounters after;
+                engine.counters(after);
+
+                propagations[polarity] = after.propagations - before.propagations;
+                failed[polarity] = false;
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    engine.configure(-1, -1);
+                    record_forward_witness(engine, k);
+                    return status;
+                }
+
+                else if (sat::status_t::STATUS_UNSAT == status) {
+                    /* the query itself (or under the implied values)
+                       is unsatisfiable */
+                    if (!engine.failed(probe)) {
+                        engine.configure(-1, -1);
+                        return status;
+                    }
+
+                    failed[polarity] = true;
+                }
+
+                else if (cancelled() || REACHABILITY_UNKNOWN != sync_status()) {
+                    engine.configure(-1, -1);
+                    return status;
+                }
+            }
+
+            if (failed[0] && failed[1]) {
+                engine.configure(-1, -1);
+                return sat::status_t::STATUS_UNSAT;
+            }
+
+            else if (failed[0] || failed[1]) {
+                implied.push_back((BitLit) (1 + bit) * (failed[0] ? -1 : 1));
+            }
+
+            else {
+                ranking.push_back(std::make_pair((1 + propagations[0]) * (1 + propagations[1]),
+                                                 (BitLit) (1 + bit)));
+            }
+        }
+        engine.configure(-1, -1);
+
+        /* the best ranked bits are used for splitting */
+        std::sort(ranking.rbegin(), ranking.rend());
+        unsigned n_vars { std::min(om.cube_vars(), (unsigned) ranking.size()) };
+
+        CubeSearch search;
+        search.found = false;
+        search.unsat = 0;
+
+        for (unsigned i = 0; i < (1U << n_vars); ++i) {
+            Cube cube { implied };
+            for (unsigned j = 0; j < n_vars; ++j) {
+                BitLit lit { ranking[j].second };
+                cube.push_back(((i >> j) & 1) ? lit : -lit);
+            }
+            search.cubes.push_back(cube);
+        }
+
+        const std::vector<std::string> endpoints { om.remote_workers() };
+        if (!endpoints.empty()) {
+            for (const auto& cube : search.cubes) {
+                std::vector<int> lits;
+                for (BitLit lit : cube) {
+                    lits.push_back(sat::dimacs_lit(bit_lit(engine, lit, k)));
+                }
+                search.remote_cubes.push_back(lits);
+            }
+
+            /* remote models are not refined */
+            engine.flush_lazy_muxes();
+            engine.recorded_clauses(0, search.clauses);
+            engine.query_assumptions(search.assumptions);
+        }
+
+        unsigned n_local { std::min(algorithms::Scheduler::INSTANCE().slots(),
+                                    (unsigned) search.cubes.size()) };
+        unsigned n_workers { n_local + (unsigned) endpoints.size() };
+        for (unsigned id = 0; id < n_workers; ++id) {
+            search.deques.push_back(CubeDeque_ptr(new CubeDeque()));
+        }
+        for (unsigned i = 0; i < search.cubes.size(); ++i) {
+            search.deques[i % n_workers]->cubes.push_back(i);
+        }
+
+        INFO
+            << search.cubes.size()
+            << " cubes over "
+            << n_vars
+            << " splitting bits ("
+            << implied.size()
+            << " implied), "
+            << n_local
+            << " local and "
+            << endpoints.size()
+            << " remote workers (k = " << k << ")"
+            << std::endl;
+
+        algorithms::Tasks tasks;
+        for (unsigned id = 0; id < n_workers; ++id) {
+            std::ostringstream oss;
+            oss
+                << (id < n_local ? "cube_" : "remote_") << id;
+
+            if (id < n_local) {
+                tasks.push_back(algorithms::Task(
+                    oss.str(),
+                    boost::bind(&Reachability::cube_worker, this,
+                                boost::ref(search), id, k, boost::ref(target_cu)),
+                    algorithms::PRIORITY_HIGH));
+            } else {
+                tasks.push_back(algorithms::Task(
+                    oss.str(),
+                    boost::bind(&Reachability::remote_cube_worker, this,
+                                boost::ref(search), id, endpoints[id - n_local]),
+                    algorithms::PRIORITY_HIGH));
+            }
+        }
+
+        algorithms::Scheduler::INSTANCE().run(tasks, [this, &search]() {
+            boost::mutex::scoped_lock lock { search.mutex };
+            return !search.found && !cancelled();
+        });
+
+        /* the remote model, replayed on the forward unrolling */
+        if (search.found && !search.remote_model.empty()) {
+            vec<Lit> assumptions;
+            for (int lit : search.remote_model) {
+                Var var { abs(lit) - 1 };
+                if (engine.is_model_var(var)) {
+                    assumptions.push(mkLit(var, lit < 0));
+                }
+            }
+
+            engine.set_step(k);
+            sat::status_t status { engine.solve(assumptions) };
+            if (sat::status_t::STATUS_SAT != status) {
+                WARN
+                    << "Could not replay the model of a remote worker (k = " << k << ")"
+                    << std::endl;
+
+                return sat::status_t::STATUS_UNKNOWN;
+            }
+
+            record_forward_witness(engine, k);
+        }
+
+        if (search.found) {
+            return sat::status_t::STATUS_SAT;
+        }
+
+        return search.cubes.size() == search.unsat
+                   ? sat::status_t::STATUS_UNSAT
+                   : sat::status_t::STATUS_UNKNOWN;
+    }
+
+    void Reachability::cube_worker(CubeSearch& search, unsigned id, step_t k,
+                                   compiler::Unit& target_cu)
+    {
+        std::ostringstream oss;
+        oss
+            << "cube_" << id;
+        const std::string name { oss.str() };
+
+        sat::Engine engine { name.c_str() };
+        setup_engine(engine);
+
+        {
+            boost::mutex::scoped_lock lock { search.mutex };
+            if (search.found) {
+                return;
+            }
+            search.engines.push_back(&engine);
+        }
+
+        /* the witness query of k steps, from scratch */
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+        assert_constraints(engine, 0, false);
+
+        for (step_t j = 0; j < k; ++j) {
+            assert_fsm_trans(engine, j);
+            assert_fsm_invar(engine, 1 + j);
+            assert_constraints(engine, 1 + j, false);
+        }
+
+        assert_formula(engine, k, target_cu);
+        assert_far_constraints(engine, k, false, sat::MAINGROUP);
+
+        unsigned index;
+        while (search.next(id, index)) {
+            vec<Lit> assumptions;
+            for (BitLit lit : search.cubes[index]) {
+                assumptions.push(bit_lit(engine, lit, k));
+            }
+
+            engine.set_step(k);
+            sat::status_t status { engine.solve(assumptions) };
+
+            if (sat::status_t::STATUS_SAT == status) {
+                /* not to be interrupted while extracting the witness */
+                {
+                    boost::mutex::scoped_lock lock { search.mutex };
+                    search.engines.erase(std::find(search.engines.begin(),
+                                                   search.engines.end(), &engine));
+                }
+
+                if (search.win()) {
+                    DEBUG
+                        << "Cube " << index << " is satisfiable"
+                        << std::endl;
+
+                    record_forward_witness(engine, k);
+                }
+                return;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                boost::mutex::scoped_lock lock { search.mutex };
+                ++search.unsat;
+            }
+
+            else {
+                break;
+            }
+        }
+
+        /* not to be interrupted once gone */
+        boost::mutex::scoped_lock lock { search.mutex };
+        search.engines.erase(std::find(search.engines.begin(), search.engines.end(), &engine));
+    }
+
+    void Reachability::remote_cube_worker(CubeSearch& search, unsigned id,
+                                          const std::string& endpoint)
+    {
+        sat::RemoteSolver remote { endpoint };
+        if (!remote.connect()) {
+            WARN
+                << "Could not reach worker `"
+                << endpoint
+                << "`, its cubes are left to the others"
+                << std::endl;
+
+            return;
+        }
+
+        {
+            boost::mutex::scoped_lock lock { search.mutex };
+            if (search.found) {
+                return;
+            }
+            search.remotes.push_back(&remote);
+        }
+
+        /* the clauses are sent with the first cube only */
+        const std::vector<int> none;
+        bool first { true };
+
+        unsigned index;
+        while (search.next(id, index)) {
+            std::vector<int> assumptions { search.assumptions };
+            assumptions.insert(assumptions.end(), search.remote_cubes[index].begin(),
+                               search.remote_cubes[index].end());
+
+            std::vector<int> model;
+            sat::status_t status {
+                remote.solve(first ? search.clauses : none, assumptions, model)
+            };
+            first = false;
+
+            if (sat::status_t::STATUS_SAT == status) {
+                {
+                    boost::mutex::scoped_lock lock { search.mutex };
+                    search.remotes.erase(std::find(search.remotes.begin(),
+                                                   search.remotes.end(), &remote));
+                }
+
+                if (search.win()) {
+                    DEBUG
+                        << "Cube " << index << " is satisfiable, on `"
+                        << endpoint
+                        << "`"
+                        << std::endl;
+
+                    search.remote_model.swap(model);
+                }
+                return;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                boost::mutex::scoped_lock lock { search.mutex };
+                ++search.unsat;
+            }
+
+            else {
+                if (remote.lost()) {
+                    WARN
+                        << "Lost worker `"
+                        << endpoint
+                        << "`, its cubes are left to the others"
+                        << std::endl;
+
+                    search.give_back(id, index);
+                }
+                break;
+            }
+        }
+
+        boost::mutex::scoped_lock lock { search.mutex };
+        search.remotes.erase(std::find(search.remotes.begin(), search.remotes.end(), &remote));
+    }
+
+} // namespace reach
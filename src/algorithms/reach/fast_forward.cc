@@ -24,10 +24,9 @@
 #include <algorithm>
 
 #include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
 #include <algorithms/reach/witness.hh>
 
-#include <expr/time/analyzer/analyzer.hh>
-
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -41,25 +40,32 @@ namespace reach {
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
 
         sat::Engine engine { "fast_forward" };
+        setup_engine(engine);
+        share_learnts(engine, "forward", sat::EXCHANGE_EXPORT);
+
+        /* inputs of each frame are only read by its TRANS */
+        compiler::Units read { target_cu };
+        collect_constraint_units(read);
+        eliminate_inputs(engine, read);
         step_t k { 0 };
 
+        /* Step-jumping: with a stride, several frames are unrolled at
+           once and the target is asserted in any of the new frames
+           first, .., k, activated by selectors */
+        step_t stride { f_stride };
+        step_t first { 0 };
+        step_t released { 0 };
+        sat::VarVector selectors;
+        sat::VarVector continues;
+
         /* initial constraints */
         assert_fsm_init(engine, k);
         assert_fsm_invar(engine, k);
 
-        /* Timed constraints can be asserted immediately, global
-         * constraints must be asserted at time zero, therefore we
-         * don't need any filtering here. */
-        std::for_each(
-            begin(f_constraints), end(f_constraints),
-            [this, &engine, k](expr::Expr_ptr constraint) {
-                auto i { f_constraint_cus.find(constraint) };
-                assert(f_constraint_cus.end() != i);
-
-                compiler::Unit cu { i->second };
-                this->assert_formula(engine, k, cu);
-            });
+        /* constraints on the initial frame */
+        assert_constraints(engine, k, false);
 
+        engine.set_step(k);
         sat::status_t status { engine.solve() };
 
         if (sat::status_t::STATUS_UNKNOWN == status) {
@@ -86,20 +92,85 @@ namespace reach {
         }
 
         do {
-            /* looking for witness : Reachability(k-1) ^ ! P(k) */
-            assert_formula(engine, k, target_cu, engine.new_group());
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* looking for witness : Reachability(k-1) ^ ! P(j), with
+               first <= j <= k */
+            sat::group_t group { engine.new_group() };
+            if (selectors.empty()) {
+                assert_formula(engine, k, target_cu, group);
+                assert_far_constraints(engine, k, false, group);
+            } else {
+                vec<Lit> ps;
+                ps.push(mkLit(group, true));
+                for (Var selector : selectors) {
+                    ps.push(mkLit(selector));
+                }
+                engine.add_clause(ps);
+            }
 
             INFO
                 << "Now looking for reachability witness (k = " << k << ")..."
                 << std::endl;
 
-            sat::status_t status { engine.solve() };
+            /* no witness was found at steps completed before */
+            engine.set_step(k);
+            sat::status_t status {
+                resumed(engine, k) ? sat::status_t::STATUS_UNSAT : engine.solve()
+            };
 
             if (sat::status_t::STATUS_UNKNOWN == status) {
                 goto cleanup;
             }
 
             else if (sat::status_t::STATUS_SAT == status) {
+                /* shortest witness, by bisection on the frames the
+                   target may hold in */
+                if (!selectors.empty()) {
+                    auto earliest = [&engine, &selectors, first]() {
+                        step_t res { first };
+                        while (1 != engine.value(selectors[res - first])) {
+                            ++res;
+                        }
+                        return res;
+                    };
+
+                    step_t lo { first };
+                    step_t hi { earliest() };
+
+                    while (lo < hi) {
+                        step_t mid { lo + (hi - lo) / 2 };
+
+                        vec<Lit> assumptions;
+                        assumptions.push(mkLit(continues[mid - first], true));
+
+                        status = engine.solve(assumptions);
+                        if (sat::status_t::STATUS_UNKNOWN == status) {
+                            goto cleanup;
+                        }
+
+                        if (sat::status_t::STATUS_SAT == status) {
+                            hi = earliest();
+                        } else {
+                            lo = mid + 1;
+                        }
+                    }
+
+                    /* the model the witness is extracted from */
+                    vec<Lit> assumptions;
+                    if (hi < k) {
+                        assumptions.push(mkLit(continues[hi - first], true));
+                    }
+
+                    status = engine.solve(assumptions);
+                    if (sat::status_t::STATUS_SAT != status) {
+                        goto cleanup;
+                    }
+
+                    k = hi;
+                }
+
                 INFO
                     << "Reachability witness exists (k = " << k << "), target `"
                     << f_target
@@ -132,9 +203,9 @@ namespace reach {
                     wm.record(w);
                     wm.set_current(w);
                     set_witness(w);
-
-                    goto cleanup;
                 }
+
+                goto cleanup;
             }
 
             else if (sat::status_t::STATUS_UNSAT == status) {
@@ -142,31 +213,65 @@ namespace reach {
                     << "No reachability witness found (k = " << k << ")..."
                     << std::endl;
 
-                engine.invert_last_group();
-
-                /* unrolling next */
-                assert_fsm_trans(engine, k);
-                ++k;
-                assert_fsm_invar(engine, k);
+                engine.retire_last_group();
+                checkpoint(engine, k);
 
-                /* Only global (i.e. untimed) constraints need be asserted here */
-                std::for_each(
-                    begin(f_constraints), end(f_constraints),
-                    [this, &engine, k](expr::Expr_ptr constraint) {
-                        expr::time::Analyzer eta { em() };
-                        eta.process(constraint);
-
-                        /* if backward time made it up to this point, something went wrong */
-                        assert(!eta.has_backward_time());
+                /* the target holds in none of the frames */
+                for (Var selector : selectors) {
+                    vec<Lit> ps;
+                    ps.push(mkLit(selector, true));
+                    engine.add_clause(ps);
+                }
+                selectors.clear();
+                continues.clear();
+
+                /* Unrolling next, stride steps at once. With a stride,
+                 * the target is asserted in each new frame j under a
+                 * selector, and the steps after j are only required
+                 * (by a guard) if the target holds in none of the
+                 * frames up to j. */
+                first = k + 1;
+                for (step_t t = k; t < k + stride; ++t) {
+                    sat::group_t guard { first <= t ? continues[t - first] : sat::MAINGROUP };
+
+                    assert_fsm_trans(engine, t, guard);
+                    assert_fsm_invar(engine, t + 1, guard);
+
+                    /* constraints on the new frame */
+                    assert_constraints(engine, t + 1, false, guard);
+
+                    if (1 < stride) {
+                        Var selector { engine.new_sat_var(true) };
+                        assert_formula(engine, t + 1, target_cu, selector);
+                        assert_far_constraints(engine, t + 1, false, selector);
+                        selectors.push_back(selector);
+
+                        /* continue <- no target so far */
+                        if (t + 1 < k + stride) {
+                            Var cont { engine.new_sat_var(true) };
+
+                            vec<Lit> ps;
+                            ps.push(mkLit(cont));
+                            for (Var selector : selectors) {
+                                ps.push(mkLit(selector));
+                            }
+                            engine.add_clause(ps);
+
+                            continues.push_back(cont);
+                        }
+                    }
+                }
+                k += stride;
 
-                        if (!eta.has_forward_time()) {
-                            auto i { f_constraint_cus.find(constraint) };
-                            assert(f_constraint_cus.end() != i);
+                /* frames older than k - 1 are never referred to again,
+                   unless by constraints timed from the target */
+                for (; released + 2 <= k && f_backward_cus.empty(); ++released) {
+                    engine.release_frame(released);
+                }
 
-                            compiler::Unit cu { i->second };
-                            this->assert_formula(engine, k, cu);
-                        }
-                    });
+                if (f_geometric) {
+                    stride *= 2;
+                }
             }
 
             TRACE
@@ -175,8 +280,8 @@ namespace reach {
         } while (sync_status() == REACHABILITY_UNKNOWN);
 
     cleanup:
-        /* signal other threads it's time to go home */
-        sat::EngineMgr::INSTANCE().interrupt();
+        /* signal sibling strategies it's time to go home */
+        cancel();
 
         INFO
             << engine
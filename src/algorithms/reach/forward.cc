@@ -23,9 +23,10 @@
 #include <algorithm>
 
 #include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
 #include <algorithms/reach/witness.hh>
 
-#include <expr/time/analyzer/analyzer.hh>
+#include <opts/opts_mgr.hh>
 
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -36,25 +37,34 @@ namespace reach {
     void Reachability::forward_strategy(compiler::Unit& target_cu)
     {
         sat::Engine engine { "forward" };
+
+        /* remote workers of cube-and-conquer are sent its clauses */
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        if (om.cube_and_conquer() && !om.remote_workers().empty()) {
+            engine.record_cnf();
+        }
+        setup_engine(engine);
+
+        /* Shared unrolling: witness queries are not constrained by
+         * uniqueness constraints, these are only enabled for proofs.
+         * Otherwise, imports learnts from fast_forward, whose clauses
+         * are a subset of ours (uniqueness constraints are only
+         * asserted here) */
+        if (f_shared_forward) {
+            guard_simple_path(engine);
+        } else {
+            share_learnts(engine, "forward", sat::EXCHANGE_IMPORT);
+        }
         step_t k { 0 };
 
         /* initial constraints */
         assert_fsm_init(engine, k);
         assert_fsm_invar(engine, k);
 
-        /* Timed constraints can be asserted immediately, global
-         * constraints must be assert at time zero, therefore we don't
-         * need any filtering here. */
-        std::for_each(
-            begin(f_constraints), end(f_constraints),
-            [this, &engine, k](expr::Expr_ptr constraint) {
-                auto i { f_constraint_cus.find(constraint) };
-                assert(f_constraint_cus.end() != i);
-
-                compiler::Unit cu { i->second };
-                this->assert_formula(engine, k, cu);
-            });
+        /* constraints on the initial frame */
+        assert_constraints(engine, k, false);
 
+        engine.set_step(k);
         sat::status_t status { engine.solve() };
 
         if (sat::status_t::STATUS_UNKNOWN == status) {
@@ -81,14 +91,27 @@ namespace reach {
         }
 
         do {
-            /* looking for witness : Reachability(k-1) ^ ! P(k) */
-            assert_formula(engine, k, target_cu, engine.new_group());
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* looking for witness : Reachability(k-1) ^ ! P(k), the
+               constraints timed from the end of the path too */
+            sat::group_t group { engine.new_group() };
+            assert_formula(engine, k, target_cu, group);
+            assert_far_constraints(engine, k, false, group);
 
             INFO
                 << "Now looking for reachability witness (k = " << k << ")..."
                 << std::endl;
 
-            sat::status_t status { engine.solve() };
+            /* step k is the witness query of k steps, then the proof
+               query of k + 1. Neither succeeded at steps completed
+               before */
+            engine.set_step(k);
+            sat::status_t status {
+                resumed(engine, k) ? sat::status_t::STATUS_UNSAT
+                                   : solve_forward_witness(engine, k, target_cu)
+            };
 
             if (sat::status_t::STATUS_UNKNOWN == status) {
                 goto cleanup;
@@ -101,38 +124,8 @@ namespace reach {
                     << "` is REACHABLE."
                     << std::endl;
 
-                if (sync_set_status(REACHABILITY_REACHABLE)) {
-
-                    /* Extract reachability witness */
-                    witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
-
-                    witness::Witness& w {
-                        *new ReachabilityCounterExample(f_target, model(), engine, k)
-                    };
-
-                    /* witness identifier */
-                    std::ostringstream oss_id;
-                    oss_id
-                        << reach_trace_prfx
-                        << wm.autoincrement();
-                    w.set_id(oss_id.str());
-
-                    /* witness description */
-                    std::ostringstream oss_desc;
-                    oss_desc
-                        << "Reachability witness for target `"
-                        << f_target
-                        << "` in module `"
-                        << model().main_module().name()
-                        << "`";
-                    w.set_desc(oss_desc.str());
-
-                    wm.record(w);
-                    wm.set_current(w);
-                    set_witness(w);
-
-                    goto cleanup;
-                }
+                /* recorded by the engine that found it */
+                goto cleanup;
             }
 
             else if (sat::status_t::STATUS_UNSAT == status) {
@@ -140,37 +133,31 @@ namespace reach {
                     << "No reachability witness found (k = " << k << ")..."
                     << std::endl;
 
-                engine.invert_last_group();
+                engine.retire_last_group();
+
+                /* all simple paths have been searched */
+                if (f_threshold <= k) {
+                    INFO
+                        << "Diameter reached (k = " << k << "), target `"
+                        << f_target
+                        << "` is UNREACHABLE."
+                        << std::endl;
+
+                    sync_set_status(REACHABILITY_UNREACHABLE);
+                    goto cleanup;
+                }
 
                 /* unrolling next */
                 assert_fsm_trans(engine, k);
                 ++k;
                 assert_fsm_invar(engine, k);
 
-                /* Only global (i.e. untimed) constraints need be asserted here */
-                std::for_each(
-                    begin(f_constraints), end(f_constraints),
-                    [this, &engine, k](expr::Expr_ptr constraint) {
-                        expr::time::Analyzer eta { em() };
-                        eta.process(constraint);
-
-                        /* if backward time made it up to this point, something went wrong */
-                        assert(!eta.has_backward_time());
-
-                        if (!eta.has_forward_time()) {
-                            auto i { f_constraint_cus.find(constraint) };
-                            assert(f_constraint_cus.end() != i);
-
-                            compiler::Unit cu { i->second };
-                            this->assert_formula(engine, k, cu);
-                        }
-                    });
+                /* constraints on the new frame */
+                assert_constraints(engine, k, false);
 
                 /* build state uniqueness constraint for each pair of states
                (j, k), where j < k */
-                for (step_t j = 0; j < k; ++j) {
-                    assert_fsm_uniqueness(engine, j, k);
-                }
+                assert_fsm_simple_path(engine, k);
 
                 /* is this still relevant? */
                 if (sync_status() != REACHABILITY_UNKNOWN) {
@@ -181,7 +168,11 @@ namespace reach {
                     << "Now looking for unreachability proof (k = " << k << ")..."
                     << std::endl;
 
-                sat::status_t status { engine.solve() };
+                engine.set_step(k);
+                sat::status_t status {
+                    resumed(engine, k - 1) ? sat::status_t::STATUS_SAT
+                                           : solve_simple_path(engine, k)
+                };
 
                 if (sat::status_t::STATUS_UNKNOWN == status) {
                     goto cleanup;
@@ -196,11 +187,14 @@ namespace reach {
                     goto cleanup;
                 }
 
-                else if (sat::status_t::STATUS_SAT == status)
+                else if (sat::status_t::STATUS_SAT == status) {
                     INFO
                         << "No unreachability proof found (k = " << k << ")"
                         << std::endl;
 
+                    checkpoint(engine, k - 1);
+                }
+
                 else {
                     assert(false); /* unreachable */
                 }
@@ -213,12 +207,83 @@ namespace reach {
         } while (sync_status() == REACHABILITY_UNKNOWN);
 
     cleanup:
-        /* signal other threads it's time to go home */
-        sat::EngineMgr::INSTANCE().interrupt();
+        /* signal sibling strategies it's time to go home */
+        cancel();
 
         INFO
             << engine
             << std::endl;
     } /* Reachability::forward_strategy() */
 
+    void Reachability::record_forward_witness(sat::Engine& engine, step_t k)
+    {
+        if (!sync_set_status(REACHABILITY_REACHABLE)) {
+            return;
+        }
+
+        /* Extract reachability witness */
+        witness::Witness& w {
+            *new ReachabilityCounterExample(f_target, model(), engine, k)
+        };
+
+        record_witness(w);
+    }
+
+    witness::Witness& Reachability::splice_witness(witness::Witness& prefix, step_t time,
+                                                   witness::Witness& w)
+    {
+        witness::Witness& res {
+            *prefix.duplicate(prefix.id(), prefix.desc())
+        };
+        while (time < res.last_time()) {
+            res.drop_last();
+        }
+
+        /* the first frame of w is the state at time */
+        if (1 < w.size()) {
+            w.drop_first();
+            res.extend(w);
+        }
+
+        return res;
+    }
+
+    void Reachability::record_witness(witness::Witness& found)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        /* post-processing applies to the path from the origin */
+        witness::Witness_ptr pw { &found };
+        if (f_shorten) {
+            pw = &shorten_witness(*pw);
+        }
+        if (f_minimize) {
+            pw = &minimize_witness(*pw);
+        }
+
+        witness::Witness& w {
+            NULL != f_origin ? splice_witness(*f_origin, f_origin_time, *pw) : *pw
+        };
+
+        /* witness identifier */
+        std::ostringstream oss_id;
+        oss_id
+            << reach_trace_prfx
+            << wm.autoincrement();
+        w.set_id(oss_id.str());
+
+        /* witness description */
+        std::ostringstream oss_desc;
+        oss_desc
+            << "Reachability witness for target `"
+            << f_target
+            << "` in module `"
+            << model().main_module().name()
+            << "`";
+        w.set_desc(oss_desc.str());
+
+        wm.record(w);
+        wm.set_current(w);
+        set_witness(w);
+    }
+
 } // namespace reach
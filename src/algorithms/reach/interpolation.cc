@@ -0,0 +1,279 @@
+/**
+ * @file bmc/interpolation.cc
+ * @brief SAT-based interpolation reachability analysis algorithm implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+
+#include <sat/proof.hh>
+
+#include <symb/symb_iter.hh>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace reach {
+
+    /* encoding bits of all the model vars, interpolants are built
+       over these (LSB first is not relevant here) */
+    static void collect_bits(algorithms::Algorithm& algorithm,
+                             std::vector<enc::UCBI>& res)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        symb::SymbIter symbols { algorithm.model() };
+
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symbol { pair.second };
+
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+            if (var.is_temp()) {
+                continue;
+            }
+
+            expr::Expr_ptr name { algorithm.em().make_dot(ctx, var.name()) };
+            expr::TimedExpr key { name, 0 };
+            enc::Encoding_ptr enc { bm.find_encoding(key) };
+
+            if (!enc) {
+                continue;
+            }
+
+            for (const auto& bit : enc->bits()) {
+                res.push_back(bm.find_ucbi(bit.getNode()->index));
+            }
+        }
+    }
+
+    /* McMillan's interpolation-based model checking, for a bound k:
+     * A is R(0) & T(0, 1), B is T(1, .., k) & (BAD(1) | ... |
+     * BAD(k)), where R is an over-approximation of the reachable
+     * states, initially INIT. If A & B is UNSAT, the interpolant is
+     * an over-approximation of the image of R that can not reach the
+     * target within k - 1 steps: it is added to R, until a fixpoint is
+     * reached and R is proved to be an inductive invariant. If A & B
+     * is SAT from INIT the target is reachable, and witnesses are left
+     * to the BMC strategies. Otherwise, R has grown too coarse and the
+     * bound is increased. */
+    void Reachability::interpolation_strategy(compiler::Unit& target_cu)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_bits(*this, bits);
+
+        /* Interpolants are over-approximations: timed constraints
+         * are ignored, which is sound for unreachability proofs. Only
+         * global constraints are asserted. */
+        sat::Engine* fixpoint { NULL };
+        step_t k { 0 };
+
+        /* interpolants only cover successor states, the target is
+           checked in the initial states once and for all */
+        {
+            sat::Engine engine { "interpolation-init" };
+            setup_engine(engine);
+
+            assert_fsm_init(engine, 0);
+            assert_fsm_invar(engine, 0);
+            assert_global_constraints(engine, 0);
+            assert_formula(engine, 0, target_cu);
+
+            sat::status_t status { engine.solve() };
+            if (sat::status_t::STATUS_UNSAT != status) {
+                goto cleanup;
+            }
+        }
+
+        for (k = 1; REACHABILITY_UNKNOWN == sync_status(); ++k) {
+            /* R = INIT | images[0] | ... | images[n - 1], over time 0 */
+            std::vector<sat::Interpolant> images;
+
+            /* does the last image add any state to R? Images found to
+               add states are asserted to be false here */
+            delete fixpoint;
+            fixpoint = new sat::Engine("interpolation-fixpoint");
+            setup_engine(*fixpoint);
+
+            assert_fsm_not_init(*fixpoint, 0);
+            assert_fsm_invar(*fixpoint, 0);
+            assert_global_constraints(*fixpoint, 0);
+
+            std::vector<Var> fixpoint_leaves;
+            for (const auto& bit : bits) {
+                fixpoint_leaves.push_back(fixpoint->tcbi_to_var(enc::TCBI(bit, 0)));
+            }
+
+            INFO
+                << "Now looking for interpolation fixpoint (k = " << k << ")..."
+                << std::endl;
+
+            while (REACHABILITY_UNKNOWN == sync_status()) {
+                /* give way to waiting strategies, if any */
+                algorithms::Scheduler::INSTANCE().yield();
+
+                sat::ProofBackend* proof { new sat::ProofBackend() };
+                sat::Engine engine { "interpolation", proof };
+                setup_engine(engine);
+
+                std::vector<Var> leaves;
+                for (const auto& bit : bits) {
+                    leaves.push_back(engine.tcbi_to_var(enc::TCBI(bit, 0)));
+                }
+
+                /* A: R(0) & T(0, 1) */
+                proof->set_partition(sat::PARTITION_A);
+
+                Var init { engine.new_sat_var() };
+                assert_fsm_init(engine, 0, init);
+
+                vec<Lit> ps;
+                ps.push(mkLit(init));
+                for (const auto& image : images) {
+                    ps.push(image.encode(engine, leaves));
+                }
+                engine.add_clause(ps);
+
+                assert_fsm_invar(engine, 0);
+                assert_global_constraints(engine, 0);
+                assert_fsm_trans(engine, 0);
+
+                /* B: T(1, .., k) & (BAD(1) | ... | BAD(k)) */
+                proof->set_partition(sat::PARTITION_B);
+
+                vec<Lit> bad;
+                for (step_t j = 1; j <= k; ++j) {
+                    assert_fsm_invar(engine, j);
+                    assert_global_constraints(engine, j);
+
+                    Var target { engine.new_sat_var() };
+                    assert_formula(engine, j, target_cu, target);
+                    bad.push(mkLit(target));
+
+                    if (j < k) {
+                        assert_fsm_trans(engine, j);
+                    }
+                }
+                engine.add_clause(bad);
+
+                engine.set_step(k);
+                sat::status_t status { engine.solve() };
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                else if (sat::status_t::STATUS_SAT == status) {
+                    if (images.empty()) {
+                        INFO
+                            << "Target is reachable within " << k << " steps "
+                            << "(interpolation), leaving witness to BMC..."
+                            << std::endl;
+
+                        goto cleanup;
+                    }
+
+                    INFO
+                        << "Interpolation bound is too small (k = " << k << "), "
+                        << "increasing..."
+                        << std::endl;
+
+                    break;
+                }
+
+                /* UNSAT: model vars at time 1 are translated back to
+                   bits, frozen vars are time invariant */
+                std::vector<int> shared;
+                for (unsigned i = 0; i < bits.size(); ++i) {
+                    Var var { engine.tcbi_to_var(enc::TCBI(bits[i], 1)) };
+                    if (shared.size() <= static_cast<size_t>(var)) {
+                        shared.resize(1 + var, -1);
+                    }
+                    shared[var] = i;
+                }
+
+                sat::Interpolant image;
+                if (!proof->interpolant(shared, image)) {
+                    WARN
+                        << "Unexpected shared vars in interpolant, giving up on interpolation"
+                        << std::endl;
+
+                    goto cleanup;
+                }
+
+                unsigned size { image.size() };
+                TRACE
+                    << "Interpolant has " << size << " gates"
+                    << std::endl;
+
+                /* fixpoint check: image => R */
+                vec<Lit> assumptions;
+                assumptions.push(image.encode(*fixpoint, fixpoint_leaves));
+
+                fixpoint->set_step(k);
+                status = fixpoint->solve(assumptions);
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                else if (sat::status_t::STATUS_UNSAT == status) {
+                    size_t n { 1 + images.size() };
+                    INFO
+                        << "Interpolation fixpoint reached (k = " << k << ", "
+                        << n << " images), target `"
+                        << f_target
+                        << "` is UNREACHABLE."
+                        << std::endl;
+
+                    if (sync_set_status(REACHABILITY_UNREACHABLE)) {
+                        /* signal sibling strategies it's time to go home */
+                        cancel();
+                    }
+
+                    goto cleanup;
+                }
+
+                ps.clear();
+                ps.push(~assumptions[0]);
+                fixpoint->add_clause(ps);
+
+                images.push_back(image);
+            }
+        }
+
+    cleanup:
+        if (NULL != fixpoint) {
+            INFO
+                << *fixpoint
+                << std::endl;
+        }
+
+        delete fixpoint;
+    } /* Reachability::interpolation_strategy() */
+
+} // namespace reach
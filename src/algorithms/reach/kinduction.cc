@@ -0,0 +1,228 @@
+/**
+ * @file bmc/kinduction.cc
+ * @brief SAT-based k-induction reachability analysis algorithm implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+#include <algorithms/reach/witness.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace reach {
+
+    /* Two incremental engines: the base engine looks for a witness of
+     * length k from the initial states (plain BMC), the step engine
+     * looks for a path of k states where the target does not hold,
+     * followed by one where it does, from *any* state. If the base
+     * case fails up to k and the step case is UNSAT for k, the target
+     * is unreachable. With simple-path strengthening, states along the
+     * step path are required to be pairwise distinct, which makes the
+     * procedure complete. */
+    void Reachability::kinduction_strategy(compiler::Unit& target_cu,
+                                           compiler::Unit& invariant_cu)
+    {
+        sat::Engine base { "kinduction-base" };
+        setup_engine(base);
+        /* imports learnts from fast_forward, whose clauses are a
+           subset of ours (the negated target is only asserted here) */
+        share_learnts(base, "forward", sat::EXCHANGE_IMPORT);
+
+        sat::Engine step { "kinduction-step" };
+        setup_engine(step);
+
+        bool simple_path { opts::OptsMgr::INSTANCE().kinduction_simple_path() };
+        step_t k { 0 };
+
+        /* initial constraints */
+        assert_fsm_init(base, k);
+        assert_fsm_invar(base, k);
+        assert_fsm_invar(step, k);
+
+        /* Constraints are asserted in the base case. The step case
+         * is not anchored to the initial states, only global
+         * constraints apply there: ignoring the others
+         * over-approximates the set of paths, which is sound. */
+        assert_constraints(base, k, false);
+        assert_global_constraints(step, k);
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* base case: is the target reachable in k steps? */
+            sat::group_t group { base.new_group() };
+            assert_formula(base, k, target_cu, group);
+            assert_far_constraints(base, k, false, group);
+
+            INFO
+                << "Now looking for k-induction base case witness (k = " << k << ")..."
+                << std::endl;
+
+            base.set_step(k);
+            sat::status_t status { base.solve() };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "Reachability witness exists (k = " << k << "), target `"
+                    << f_target
+                    << "` is REACHABLE."
+                    << std::endl;
+
+                if (sync_set_status(REACHABILITY_REACHABLE)) {
+
+                    /* Extract reachability witness */
+                    witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+                    witness::Witness& w {
+                        *new ReachabilityCounterExample(f_target, model(), base, k)
+                    };
+
+                    /* witness identifier */
+                    std::ostringstream oss_id;
+                    oss_id
+                        << reach_trace_prfx
+                        << wm.autoincrement();
+                    w.set_id(oss_id.str());
+
+                    /* witness description */
+                    std::ostringstream oss_desc;
+                    oss_desc
+                        << "Reachability witness for target `"
+                        << f_target
+                        << "` in module `"
+                        << model().main_module().name()
+                        << "`";
+                    w.set_desc(oss_desc.str());
+
+                    wm.record(w);
+                    wm.set_current(w);
+                    set_witness(w);
+                }
+
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No k-induction base case witness found (k = " << k << ")..."
+                    << std::endl;
+
+                /* the target does not hold in k steps, from now on
+                   this is a fact */
+                base.retire_last_group();
+                assert_formula(base, k, invariant_cu);
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            /* is this still relevant? */
+            if (sync_status() != REACHABILITY_UNKNOWN) {
+                goto cleanup;
+            }
+
+            /* inductive step: the target does not hold along the
+               first k states of the path, does it hold in the last
+               one? */
+            assert_formula(step, k, target_cu, step.new_group());
+
+            INFO
+                << "Now looking for k-induction step proof (k = " << k << ")..."
+                << std::endl;
+
+            step.set_step(k);
+            status = simple_path ? solve_simple_path(step, k) : step.solve();
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "Found k-induction unreachability proof (k = " << k << ")"
+                    << std::endl;
+
+                sync_set_status(REACHABILITY_UNREACHABLE);
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "No k-induction step proof found (k = " << k << ")"
+                    << std::endl;
+
+                step.retire_last_group();
+                assert_formula(step, k, invariant_cu);
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            /* unrolling next */
+            assert_fsm_trans(base, k);
+            assert_fsm_trans(step, k);
+            ++k;
+            assert_fsm_invar(base, k);
+            assert_fsm_invar(step, k);
+
+            /* constraints on the new frame */
+            assert_constraints(base, k, false);
+            assert_global_constraints(step, k);
+
+            /* simple-path strengthening, state uniqueness constraint
+               for each pair of states (j, k), where j < k */
+            if (simple_path) {
+                assert_fsm_simple_path(step, k);
+            }
+
+            TRACE
+                << "Done with k = " << k << "..."
+                << std::endl;
+
+        } while (sync_status() == REACHABILITY_UNKNOWN);
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << base
+            << std::endl;
+
+        INFO
+            << step
+            << std::endl;
+    } /* Reachability::kinduction_strategy() */
+
+} // namespace reach
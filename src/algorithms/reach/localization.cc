@@ -0,0 +1,294 @@
+/**
+ * @file reach/localization.cc
+ * @brief SAT-based localization abstraction reachability strategy implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+
+#include <opts/opts_mgr.hh>
+
+namespace reach {
+
+    /* Localization abstraction: the abstract FSM has the INITs, the
+     * INVARs and only some of the TRANSes of the concrete one, the
+     * vars the others would constrain are free. It is thus an
+     * over-approximation, initially the TRANSes sharing vars with the
+     * target or constraints.
+     *
+     * Three incremental engines: the abstract engine looks for a
+     * witness of length k on the abstraction (BMC), the concrete
+     * engine checks abstract witnesses of length k against the whole
+     * FSM, and the step engine looks for a k-induction step on the
+     * abstraction. Concrete TRANSes are enabled by assumptions of
+     * their own, so that spurious witnesses are refuted by an UNSAT
+     * core: the TRANSes in the core are added to the abstraction, in
+     * all the frames unrolled so far. An abstract k-induction proof is
+     * a proof for the concrete FSM, whose paths are all abstract
+     * paths. */
+    void Reachability::localization_strategy(compiler::Unit& target_cu,
+                                             compiler::Unit& invariant_cu)
+    {
+        const unsigned n_trans { n_trans_units() };
+
+        std::vector<bool> abstraction;
+        {
+            compiler::Units units { target_cu };
+            collect_constraint_units(units);
+
+            localize_trans(units, abstraction);
+        }
+
+        unsigned n_abstract {
+            (unsigned) std::count(abstraction.begin(), abstraction.end(), true)
+        };
+        if (n_abstract == n_trans) {
+            TRACE
+                << "All TRANSes are relevant to the target, no localization"
+                << std::endl;
+
+            return;
+        }
+
+        INFO
+            << "Localization abstraction has "
+            << n_abstract << " TRANSes out of " << n_trans
+            << std::endl;
+
+        sat::Engine abstract { "localization-abstract" };
+        setup_engine(abstract);
+
+        sat::Engine concrete { "localization-concrete" };
+        setup_engine(concrete);
+
+        sat::Engine step { "localization-step" };
+        setup_engine(step);
+
+        bool simple_path { opts::OptsMgr::INSTANCE().kinduction_simple_path() };
+        step_t k { 0 };
+
+        /* a single activation var for each TRANS, over all frames */
+        std::vector<Var> activations;
+        vec<Lit> assumptions;
+        for (unsigned i = 0; i < n_trans; ++i) {
+            Var act { concrete.new_sat_var() };
+
+            activations.push_back(act);
+            assumptions.push(mkLit(act));
+        }
+
+        /* initial constraints */
+        for (auto* engine : { &abstract, &concrete }) {
+            assert_fsm_init(*engine, k);
+            assert_fsm_invar(*engine, k);
+            assert_constraints(*engine, k, false);
+        }
+        assert_fsm_invar(step, k);
+        assert_global_constraints(step, k);
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* abstract base case: is the target reachable in k steps? */
+            sat::group_t group { abstract.new_group() };
+            assert_formula(abstract, k, target_cu, group);
+            assert_far_constraints(abstract, k, false, group);
+
+            INFO
+                << "Now looking for abstract witness (k = " << k << ", "
+                << n_abstract << " TRANSes)..."
+                << std::endl;
+
+            abstract.set_step(k);
+            sat::status_t status { abstract.solve() };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                /* is the abstract witness spurious? */
+                sat::group_t concrete_group { concrete.new_group() };
+                assert_formula(concrete, k, target_cu, concrete_group);
+                assert_far_constraints(concrete, k, false, concrete_group);
+
+                concrete.set_step(k);
+                status = concrete.solve(assumptions);
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    goto cleanup;
+                }
+
+                else if (sat::status_t::STATUS_SAT == status) {
+                    INFO
+                        << "Reachability witness exists (k = " << k << "), target `"
+                        << f_target
+                        << "` is REACHABLE."
+                        << std::endl;
+
+                    record_forward_witness(concrete, k);
+                    goto cleanup;
+                }
+
+                /* UNSAT: refinement, by the TRANSes in the core */
+                concrete.retire_last_group();
+                abstract.retire_last_group();
+
+                unsigned n_refined { 0 };
+                for (unsigned i = 0; i < n_trans; ++i) {
+                    if (abstraction[i] || !concrete.failed(mkLit(activations[i]))) {
+                        continue;
+                    }
+
+                    abstraction[i] = true;
+                    ++n_refined;
+
+                    for (step_t j = 0; j < k; ++j) {
+                        assert_fsm_trans_unit(abstract, i, j);
+                        assert_fsm_trans_unit(step, i, j);
+                    }
+                }
+
+                /* the core is within the abstraction only if the abstract
+                   witness relied on something else, e.g. timed constraints */
+                if (0 == n_refined) {
+                    WARN
+                        << "Localization refinement failed (k = " << k << "), giving up"
+                        << std::endl;
+
+                    goto cleanup;
+                }
+
+                n_abstract += n_refined;
+                INFO
+                    << "Spurious abstract witness (k = " << k << "), "
+                    << n_refined << " TRANSes added to the abstraction"
+                    << std::endl;
+
+                /* same k, on the refined abstraction */
+                continue;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No abstract witness found (k = " << k << ")..."
+                    << std::endl;
+
+                /* the target does not hold in k steps, from now on
+                   this is a fact */
+                abstract.retire_last_group();
+                assert_formula(abstract, k, invariant_cu);
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            /* is this still relevant? */
+            if (sync_status() != REACHABILITY_UNKNOWN) {
+                goto cleanup;
+            }
+
+            /* abstract inductive step */
+            assert_formula(step, k, target_cu, step.new_group());
+
+            INFO
+                << "Now looking for abstract k-induction step proof (k = " << k << ")..."
+                << std::endl;
+
+            step.set_step(k);
+            status = simple_path ? solve_simple_path(step, k) : step.solve();
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "Found abstract k-induction unreachability proof (k = " << k << ", "
+                    << n_abstract << " TRANSes), target `"
+                    << f_target
+                    << "` is UNREACHABLE."
+                    << std::endl;
+
+                sync_set_status(REACHABILITY_UNREACHABLE);
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                step.retire_last_group();
+                assert_formula(step, k, invariant_cu);
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            /* unrolling next */
+            for (unsigned i = 0; i < n_trans; ++i) {
+                assert_fsm_trans_unit(concrete, i, k, activations[i]);
+
+                if (abstraction[i]) {
+                    assert_fsm_trans_unit(abstract, i, k);
+                    assert_fsm_trans_unit(step, i, k);
+                }
+            }
+            ++k;
+
+            for (auto* engine : { &abstract, &concrete }) {
+                assert_fsm_invar(*engine, k);
+                assert_constraints(*engine, k, false);
+            }
+            assert_fsm_invar(step, k);
+            assert_global_constraints(step, k);
+
+            if (simple_path) {
+                assert_fsm_simple_path(step, k);
+            }
+
+            TRACE
+                << "Done with k = " << k << "..."
+                << std::endl;
+
+        } while (sync_status() == REACHABILITY_UNKNOWN);
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        if (REACHABILITY_UNKNOWN != sync_status()) {
+            cancel();
+        }
+
+        INFO
+            << abstract
+            << std::endl;
+
+        INFO
+            << concrete
+            << std::endl;
+
+        INFO
+            << step
+            << std::endl;
+    } /* Reachability::localization_strategy() */
+
+} // namespace reach
@@ -0,0 +1,283 @@
+/**
+ * @file reach/minimize.cc
+ * @brief Reachability witnesses post-processing (shortening and
+ * minimization).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/reach/witness.hh>
+
+#include <symb/proxy.hh>
+
+#include <witness/witness.hh>
+
+namespace reach {
+
+    /* the bits of frame tf, as assumption literals at time, inputs
+       excluded unless requested */
+    static void frame_literals(sat::Engine& engine, step_t time,
+                               const algorithms::FramePhases& phases,
+                               bool inputs, vec<Lit>& res)
+    {
+        symb::ResolverProxy resolver;
+
+        for (const auto& phase : phases) {
+            if (!inputs &&
+                resolver.symbol(phase.first.expr())->as_variable().is_input()) {
+                continue;
+            }
+
+            Var var { engine.tcbi_to_var(enc::TCBI(phase.first, time)) };
+            res.push(mkLit(var, !phase.second));
+        }
+    }
+
+    /* Shortening: a witness of k steps is shorter if the target is
+     * reachable in d steps from its state at time i, with i + d < k
+     * (inputs excluded). A single unrolling starts from any of these
+     * states, each state enabled by a selector of its own, and the
+     * target at each depth by another one. Candidates are checked by
+     * increasing length i + d. */
+    witness::Witness& Reachability::shorten_witness(witness::Witness& w)
+    {
+        step_t k { w.size() - 1 };
+        if (k < 2) {
+            return w;
+        }
+
+        sat::Engine engine { "shorten" };
+        setup_engine(engine);
+
+        std::vector<Var> origins;
+        for (step_t i = 0; i < k - 1; ++i) {
+            algorithms::FramePhases phases;
+            frame_phases(w[w.first_time() + i], phases);
+
+            vec<Lit> lits;
+            frame_literals(engine, 0, phases, false, lits);
+
+            Var selector { engine.new_sat_var() };
+            for (int j = 0; j < lits.size(); ++j) {
+                vec<Lit> ps;
+                ps.push(mkLit(selector, true));
+                ps.push(lits[j]);
+                engine.add_clause(ps);
+            }
+            origins.push_back(selector);
+        }
+
+        assert_fsm_invar(engine, 0);
+        assert_global_constraints(engine, 0);
+
+        /* by depth, none at depth 0 */
+        std::vector<Var> targets { var_Undef };
+        for (step_t length = 1; length < k; ++length) {
+            for (step_t d = 1; d <= length; ++d) {
+                /* unrolling next */
+                if (targets.size() == d) {
+                    assert_fsm_trans(engine, d - 1);
+                    assert_fsm_invar(engine, d);
+                    assert_global_constraints(engine, d);
+
+                    Var selector { engine.new_sat_var() };
+                    assert_formula(engine, d, f_target_cus[0], selector);
+                    targets.push_back(selector);
+                }
+
+                step_t i { length - d };
+
+                vec<Lit> assumptions;
+                assumptions.push(mkLit(origins[i]));
+                assumptions.push(mkLit(targets[d]));
+
+                engine.set_step(d);
+                sat::status_t status { engine.solve(assumptions) };
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    return w;
+                }
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    INFO
+                        << "Witness shortened from "
+                        << k
+                        << " to "
+                        << i + d
+                        << " steps"
+                        << std::endl;
+
+                    witness::Witness& shortcut {
+                        *new ReachabilityCounterExample(f_target, model(), engine, d)
+                    };
+                    return splice_witness(w, w.first_time() + i, shortcut);
+                }
+            }
+        }
+
+        return w;
+    }
+
+    /* Minimization: the values the target does not depend on are
+     * dropped, by lifting one step at a time, backward from the last
+     * frame. The values kept at time t + 1 are a cube c; those kept at
+     * time t are the failed assumptions of the values of the frame
+     * (inputs included) for INVAR & TRANS & !c', i.e. every completion
+     * of them leads to c. The cube of the last frame must imply the
+     * target, the one of the first frame INIT as well. A single
+     * engine (i.e. one TRANS) is used for all frames, goals are
+     * enabled by selectors and retired once checked. A var is kept if
+     * any of its bits is. */
+    witness::Witness& Reachability::minimize_witness(witness::Witness& w)
+    {
+        symb::ResolverProxy resolver;
+        step_t k { w.size() - 1 };
+
+        sat::Engine engine { "minimize" };
+        setup_engine(engine);
+
+        assert_fsm_invar(engine, 0);
+        assert_fsm_invar(engine, 1);
+        assert_fsm_trans(engine, 0);
+        assert_global_constraints(engine, 0);
+        assert_global_constraints(engine, 1);
+
+        /* vars kept, by frame */
+        using Kept = boost::unordered_set<expr::Expr_ptr, utils::PtrHash, utils::PtrEq>;
+        std::vector<Kept> kept(1 + k);
+
+        unsigned n_values { 0 };
+        unsigned n_kept { 0 };
+
+        vec<Lit> cube;
+        for (step_t t = k; t != (step_t) -1; --t) {
+            algorithms::FramePhases phases;
+            frame_phases(w[w.first_time() + t], phases);
+
+            vec<Lit> assumptions;
+            frame_literals(engine, 0, phases, true, assumptions);
+            assert(assumptions.size() == (int) phases.size());
+
+            /* the goal: !target, !c' or (on the first frame) !INIT */
+            Var selector { engine.new_sat_var() };
+            vec<Lit> ps;
+            ps.push(mkLit(selector, true));
+
+            if (t == k) {
+                Var goal { engine.new_sat_var() };
+                assert_formula(engine, 0, f_target_cus[1], goal);
+                ps.push(mkLit(goal));
+            } else {
+                for (int j = 0; j < cube.size(); ++j) {
+                    ps.push(~cube[j]);
+                }
+            }
+            if (0 == t) {
+                Var goal { engine.new_sat_var() };
+                assert_fsm_not_init(engine, 0, goal);
+                ps.push(mkLit(goal));
+            }
+            engine.add_clause(ps);
+
+            vec<Lit> selectors;
+            selectors.push(mkLit(selector));
+            for (int j = 0; j < assumptions.size(); ++j) {
+                selectors.push(assumptions[j]);
+            }
+
+            engine.set_step(t);
+            sat::status_t status { engine.solve(selectors) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return w;
+            }
+
+            /* e.g. the target depends on a var left out of the
+               witness, nothing is dropped */
+            bool all { sat::status_t::STATUS_SAT == status };
+
+            cube.clear();
+            for (unsigned j = 0; j < phases.size(); ++j) {
+                if (all || engine.failed(assumptions[j])) {
+                    kept[t].insert(phases[j].first.expr());
+                }
+            }
+
+            /* the cube of the next step, at time 1 */
+            algorithms::FramePhases kept_phases;
+            for (const auto& phase : phases) {
+                if (kept[t].count(phase.first.expr())) {
+                    kept_phases.push_back(phase);
+                }
+            }
+            frame_literals(engine, 1, kept_phases, true, cube);
+
+            /* retired */
+            vec<Lit> retire;
+            retire.push(mkLit(selector, true));
+            engine.add_clause(retire);
+        }
+
+        witness::Witness& res {
+            *new witness::Witness(NULL, w.id(), w.desc(), w.first_time())
+        };
+        res.set_lang(w.lang());
+
+        for (step_t t = 0; t <= k; ++t) {
+            witness::TimeFrame& src { w[w.first_time() + t] };
+            witness::TimeFrame& tf { res.extend() };
+
+            for (auto assignment : src.assignments()) {
+                expr::Expr_ptr full { assignment->lhs() };
+                symb::Symbol_ptr symbol { resolver.symbol(full) };
+                if (!symbol->is_variable()) {
+                    continue;
+                }
+
+                ++n_values;
+
+                /* frozen vars share their bits across frames */
+                bool keep { 0 < kept[t].count(full) };
+                if (symbol->as_variable().is_frozen()) {
+                    for (const auto& frame : kept) {
+                        keep = keep || 0 < frame.count(full);
+                    }
+                }
+
+                if (keep) {
+                    ++n_kept;
+                    tf.set_value(full, assignment->rhs(),
+                                 w.format(w.symbol_index(full)));
+                }
+            }
+        }
+
+        INFO
+            << "Witness minimized, "
+            << n_kept
+            << " out of "
+            << n_values
+            << " values kept"
+            << std::endl;
+
+        return res;
+    }
+
+} // namespace reach
@@ -0,0 +1,389 @@
+/**
+ * @file reach/multi.cc
+ * @brief SAT-based multi-target BMC reachability analysis algorithm implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+
+#include <algorithms/reach/multi.hh>
+#include <algorithms/reach/witness.hh>
+#include <algorithms/scheduler.hh>
+
+#include <expr/time/analyzer/analyzer.hh>
+
+#include <compiler/compiler.hh>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace reach {
+
+    MultiReachability::MultiReachability(cmd::Command& command, model::Model& model)
+        : Algorithm(command, model)
+        , f_pending(0)
+    {
+        const void* instance { this };
+        TRACE
+            << "Created MultiReachability @"
+            << instance
+            << std::endl;
+    }
+
+    MultiReachability::~MultiReachability()
+    {
+        const void* instance { this };
+        TRACE
+            << "Destroyed MultiReachability @"
+            << instance
+            << std::endl;
+    }
+
+    void MultiReachability::process(const expr::ExprVector& targets,
+                                    expr::ExprVector constraints)
+    {
+        expr::time::Analyzer eta { em() };
+
+        for (auto target : targets) {
+            TargetResult result { target, REACHABILITY_UNKNOWN, 0, NULL };
+            f_results.push_back(result);
+        }
+        f_pending = f_results.size();
+
+        /* only forward and global constraints, a single unrolling is
+           shared by all targets */
+        f_constraints = constraints;
+        for (auto constraint : f_constraints) {
+            eta.process(constraint);
+            if (eta.has_backward_time()) {
+                ERR
+                    << "Backward constraints not supported with multiple targets!"
+                    << std::endl;
+
+                for (auto& result : f_results) {
+                    result.status = REACHABILITY_ERROR;
+                }
+                return;
+            }
+        }
+
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        /* strategy threads will access these values in the main thread's stack */
+        compiler::Units target_cus;
+        for (auto target : targets) {
+            TRACE
+                << "Compiling target `"
+                << target
+                << "` ..."
+                << std::endl;
+
+            target_cus.push_back(compiler().process(ctx, target));
+        }
+
+        for (auto constraint : f_constraints) {
+            TRACE
+                << "Compiling constraint `"
+                << constraint
+                << "` ..."
+                << std::endl;
+
+            f_constraint_cus.push_back(
+                compiler().process(ctx, constraint));
+        }
+
+        release_fsm_dds();
+
+        algorithms::Tasks tasks;
+        tasks.push_back(algorithms::Task(
+            "fast_forward",
+            boost::bind(&MultiReachability::fast_forward_strategy, this, target_cus),
+            algorithms::PRIORITY_HIGH));
+        tasks.push_back(algorithms::Task(
+            "forward",
+            boost::bind(&MultiReachability::forward_strategy, this, target_cus)));
+
+        algorithms::Scheduler::INSTANCE().run(tasks, [this]() {
+            return 0 < this->sync_pending();
+        });
+    }
+
+    bool MultiReachability::check_targets(sat::Engine& engine, step_t k,
+                                          compiler::Units& target_cus)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        for (unsigned i = 0; i < target_cus.size(); ++i) {
+            if (!sync_is_pending(i)) {
+                continue;
+            }
+
+            /* looking for witness : Reachability(k-1) ^ ! P_i(k) */
+            Var assumption { engine.new_sat_var(true) };
+            assert_formula(engine, k, target_cus[i], assumption);
+
+            vec<Lit> assumptions;
+            assumptions.push(mkLit(assumption));
+
+            engine.set_step(k);
+            sat::status_t status { engine.solve(assumptions) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return false;
+            }
+
+            /* target i leaves the unrolling at k */
+            vec<Lit> ps;
+            ps.push(mkLit(assumption, true));
+
+            if (sat::status_t::STATUS_SAT == status) {
+                expr::Expr_ptr target { f_results[i].target };
+
+                witness::Witness_ptr w {
+                    new ReachabilityCounterExample(target, model(), engine, k)
+                };
+
+                if (!sync_resolve(i, REACHABILITY_REACHABLE, k, w)) {
+                    delete w;
+                    engine.add_clause(ps);
+                    continue;
+                }
+
+                INFO
+                    << "Reachability witness exists (k = " << k << "), target `"
+                    << target
+                    << "` is REACHABLE."
+                    << std::endl;
+
+                /* witness identifier */
+                std::ostringstream oss_id;
+                oss_id
+                    << reach_trace_prfx
+                    << wm.autoincrement();
+                w->set_id(oss_id.str());
+
+                /* witness description */
+                std::ostringstream oss_desc;
+                oss_desc
+                    << "Reachability witness for target `"
+                    << target
+                    << "` in module `"
+                    << model().main_module().name()
+                    << "`";
+                w->set_desc(oss_desc.str());
+
+                wm.record(*w);
+                wm.set_current(*w);
+            }
+
+            engine.add_clause(ps);
+        }
+
+        return true;
+    }
+
+    void MultiReachability::unroll(sat::Engine& engine, step_t k)
+    {
+        assert_fsm_trans(engine, k);
+        assert_fsm_invar(engine, k + 1);
+
+        /* Only global (i.e. untimed) constraints need be asserted here */
+        for (unsigned i = 0; i < f_constraints.size(); ++i) {
+            expr::time::Analyzer eta { em() };
+            eta.process(f_constraints[i]);
+
+            if (!eta.has_forward_time()) {
+                assert_formula(engine, k + 1, f_constraint_cus[i]);
+            }
+        }
+    }
+
+    /* witnesses only */
+    void MultiReachability::fast_forward_strategy(compiler::Units& target_cus)
+    {
+        sat::Engine engine { "multi_fast_forward" };
+        setup_engine(engine);
+        step_t k { 0 };
+
+        /* initial constraints, timed constraints are asserted
+           immediately */
+        assert_fsm_init(engine, k);
+        assert_fsm_invar(engine, k);
+        for (auto& cu : f_constraint_cus) {
+            assert_formula(engine, k, cu);
+        }
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            unsigned pending { sync_pending() };
+            INFO
+                << "Now looking for reachability witnesses ("
+                << pending
+                << " targets, k = " << k << ")..."
+                << std::endl;
+
+            if (!check_targets(engine, k, target_cus)) {
+                goto cleanup;
+            }
+
+            unroll(engine, k);
+            ++k;
+
+            /* frames older than k - 1 are never referred to again */
+            if (2 <= k) {
+                engine.release_frame(k - 2);
+            }
+        } while (0 < sync_pending());
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << engine
+            << std::endl;
+    }
+
+    /* witnesses and unreachability proofs: a target that has been
+       checked at all depths up to k - 1 is unreachable if no simple
+       path of length k exists */
+    void MultiReachability::forward_strategy(compiler::Units& target_cus)
+    {
+        sat::Engine engine { "multi_forward" };
+        setup_engine(engine);
+        step_t k { 0 };
+
+        assert_fsm_init(engine, k);
+        assert_fsm_invar(engine, k);
+        for (auto& cu : f_constraint_cus) {
+            assert_formula(engine, k, cu);
+        }
+
+        engine.set_step(k);
+        sat::status_t status { engine.solve() };
+
+        if (sat::status_t::STATUS_UNKNOWN == status) {
+            goto cleanup;
+        }
+
+        else if (sat::status_t::STATUS_UNSAT == status) {
+            INFO
+                << "Empty initial states. All targets are trivially UNREACHABLE."
+                << std::endl;
+
+            for (unsigned i = 0; i < target_cus.size(); ++i) {
+                sync_resolve(i, REACHABILITY_UNREACHABLE, 0);
+            }
+            goto cleanup;
+        }
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            if (!check_targets(engine, k, target_cus)) {
+                goto cleanup;
+            }
+
+            unroll(engine, k);
+            ++k;
+            assert_fsm_simple_path(engine, k);
+
+            /* is this still relevant? */
+            if (0 == sync_pending()) {
+                goto cleanup;
+            }
+
+            INFO
+                << "Now looking for unreachability proof (k = " << k << ")..."
+                << std::endl;
+
+            engine.set_step(k);
+            status = solve_simple_path(engine, k);
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "Found unreachability proof (k = " << k << ")"
+                    << std::endl;
+
+                for (unsigned i = 0; i < target_cus.size(); ++i) {
+                    sync_resolve(i, REACHABILITY_UNREACHABLE, k);
+                }
+                goto cleanup;
+            }
+        } while (0 < sync_pending());
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << engine
+            << std::endl;
+    }
+
+    /* synchronized */
+    TargetResults MultiReachability::results()
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return f_results;
+    }
+
+    /* synchronized */
+    unsigned MultiReachability::sync_pending()
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return f_pending;
+    }
+
+    /* synchronized */
+    bool MultiReachability::sync_is_pending(unsigned index)
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+        return REACHABILITY_UNKNOWN == f_results[index].status;
+    }
+
+    /* synchronized, true iff the target was not resolved yet */
+    bool MultiReachability::sync_resolve(unsigned index, reachability_status_t status,
+                                         step_t depth, witness::Witness_ptr witness)
+    {
+        boost::mutex::scoped_lock lock { f_results_mutex };
+
+        TargetResult& result { f_results[index] };
+        if (REACHABILITY_UNKNOWN != result.status) {
+            return false;
+        }
+
+        result.status = status;
+        result.depth = depth;
+        result.witness = witness;
+        --f_pending;
+
+        return true;
+    }
+
+} // namespace reach
@@ -0,0 +1,92 @@
+/**
+ * @file reach/multi.hh
+ * @brief SAT-based multi-target BMC reachability analysis algorithm.
+ *
+ * This module contains the declaration of a reachability algorithm
+ * checking several targets against the same model at once. The FSM
+ * is compiled once, and each strategy shares a single unrolling among
+ * all targets: at each step, every unresolved target is checked under
+ * an assumption of its own, and resolved targets leave the unrolling.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MULTI_REACHABILITY_ALGORITHM_H
+#define MULTI_REACHABILITY_ALGORITHM_H
+
+#include <algorithms/base.hh>
+#include <algorithms/reach/typedefs.hh>
+
+#include <cmd/command.hh>
+
+#include <compiler/typedefs.hh>
+
+namespace reach {
+
+    /* outcome for a single target: depth is the length of the
+       witness, or that of the unreachability proof */
+    struct TargetResult {
+        expr::Expr_ptr target;
+        reachability_status_t status;
+        step_t depth;
+        witness::Witness_ptr witness;
+    };
+
+    typedef std::vector<TargetResult> TargetResults;
+
+    class MultiReachability: public algorithms::Algorithm {
+
+    public:
+        MultiReachability(cmd::Command& command, model::Model& model);
+        ~MultiReachability();
+
+        void process(const expr::ExprVector& targets, expr::ExprVector constraints);
+
+        /* synchronized, a copy */
+        TargetResults results();
+
+    private:
+        expr::ExprVector f_constraints;
+        compiler::Units f_constraint_cus;
+
+        boost::mutex f_results_mutex;
+        TargetResults f_results;
+        unsigned f_pending;
+
+        /* checking strategies */
+        void fast_forward_strategy(compiler::Units& target_cus);
+        void forward_strategy(compiler::Units& target_cus);
+
+        /* checks all unresolved targets at k, each under a fresh
+           assumption that is then retired. False iff interrupted */
+        bool check_targets(sat::Engine& engine, step_t k, compiler::Units& target_cus);
+
+        /* unrolling next, frame k + 1 */
+        void unroll(sat::Engine& engine, step_t k);
+
+        /* synchronized */
+        unsigned sync_pending();
+        bool sync_is_pending(unsigned index);
+        bool sync_resolve(unsigned index, reachability_status_t status, step_t depth,
+                          witness::Witness_ptr witness = NULL);
+    };
+
+} // namespace reach
+
+#endif /* MULTI_REACHABILITY_ALGORITHM_H */
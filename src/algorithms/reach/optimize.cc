@@ -0,0 +1,318 @@
+/**
+ * @file reach/optimize.cc
+ * @brief SAT-based search of witnesses of least cost, implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+#include <sstream>
+
+#include <algorithms/reach/optimize.hh>
+#include <algorithms/reach/witness.hh>
+
+#include <expr/time/analyzer/analyzer.hh>
+
+#include <compiler/compiler.hh>
+
+#include <witness/witness_mgr.hh>
+
+static const char* optimize_trace_prfx { "optimize_" };
+
+namespace reach {
+
+    Optimization::Optimization(cmd::Command& command, model::Model& model)
+        : Algorithm(command, model)
+        , f_target(NULL)
+        , f_cost(NULL)
+        , f_status(REACHABILITY_UNKNOWN)
+        , f_best(0)
+        , f_optimal(false)
+    {
+        const void* instance { this };
+        TRACE
+            << "Created Optimization @"
+            << instance
+            << std::endl;
+    }
+
+    Optimization::~Optimization()
+    {
+        const void* instance { this };
+        TRACE
+            << "Destroyed Optimization @"
+            << instance
+            << std::endl;
+    }
+
+    expr::Expr_ptr Optimization::make_bound(value_t bound)
+    {
+        expr::Expr_ptr konst {
+            bound < 0 ? em().make_neg(em().make_const(-bound))
+                      : em().make_const(bound)
+        };
+
+        return em().make_le(f_cost, konst);
+    }
+
+    witness::Witness_ptr Optimization::make_witness(sat::Engine& engine, step_t k,
+                                                    value_t& cost)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        witness::Witness_ptr res {
+            new ReachabilityCounterExample(f_target, model(), engine, k)
+        };
+
+        expr::Expr_ptr value { wm.eval(*res, em().make_empty(), f_cost, k) };
+        cost = em().is_neg(value) ? -value->lhs()->value() : value->value();
+
+        return res;
+    }
+
+    void Optimization::unroll(sat::Engine& engine, step_t k)
+    {
+        assert_fsm_trans(engine, k);
+        assert_fsm_invar(engine, k + 1);
+
+        /* Only global (i.e. untimed) constraints need be asserted here */
+        for (unsigned i = 0; i < f_constraints.size(); ++i) {
+            expr::time::Analyzer eta { em() };
+            eta.process(f_constraints[i]);
+
+            if (!eta.has_forward_time()) {
+                assert_formula(engine, k + 1, f_constraint_cus[i]);
+            }
+        }
+    }
+
+    /* Minimal depth first, as the forward strategy of reach: a witness
+     * of k steps is looked for under a group, which is retired if
+     * there is none, and a simple path of k + 1 steps proves the target
+     * unreachable. Once a witness is found, the unrolling stays as it
+     * is: each bound on the cost at k is asserted under a group of its
+     * own, over the target group. A bound with no witness is retired,
+     * and the least cost not ruled out is past it. A bound with one is
+     * kept, its witness is the best so far. The search is over once
+     * the two meet, or is interrupted (the best witness is not known
+     * to be optimal then). */
+    void Optimization::process(expr::Expr_ptr target, expr::Expr_ptr cost,
+                               expr::ExprVector constraints, bool binary)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em().make_empty() };
+        expr::time::Analyzer eta { em() };
+
+        f_target = target;
+        f_cost = cost;
+
+        type::Type_ptr type { mm().type(cost, ctx) };
+        if (!type->is_algebraic()) {
+            ERR
+                << "Cost `"
+                << cost
+                << "` is not algebraic!"
+                << std::endl;
+
+            f_status = REACHABILITY_ERROR;
+            return;
+        }
+
+        /* only forward and global constraints, the depth is not known
+           in advance */
+        f_constraints = constraints;
+        for (auto constraint : f_constraints) {
+            eta.process(constraint);
+            if (eta.has_backward_time()) {
+                ERR
+                    << "Backward constraints not supported by optimization!"
+                    << std::endl;
+
+                f_status = REACHABILITY_ERROR;
+                return;
+            }
+        }
+
+        /* the least value of the type, no cost is below it */
+        value_t lo { 0 };
+        if (!type->is_constant() && type->is_signed_algebraic()) {
+            unsigned width { std::min(type->width(), 63u) };
+            lo = -((value_t) 1 << (width - 1));
+        }
+
+        TRACE
+            << "Compiling target `"
+            << target
+            << "` ..."
+            << std::endl;
+
+        compiler::Unit target_cu { compiler().process(ctx, target) };
+
+        for (auto constraint : f_constraints) {
+            TRACE
+                << "Compiling constraint `"
+                << constraint
+                << "` ..."
+                << std::endl;
+
+            f_constraint_cus.push_back(compiler().process(ctx, constraint));
+        }
+
+        release_fsm_dds();
+
+        sat::Engine engine { "optimize" };
+        setup_engine(engine);
+
+        /* uniqueness constraints only for proofs */
+        guard_simple_path(engine);
+
+        step_t k { 0 };
+        assert_fsm_init(engine, k);
+        assert_fsm_invar(engine, k);
+        for (auto& cu : f_constraint_cus) {
+            assert_formula(engine, k, cu);
+        }
+
+        sat::status_t status;
+        while (true) {
+            sat::group_t group { engine.new_group() };
+            assert_formula(engine, k, target_cu, group);
+
+            INFO
+                << "Now looking for reachability witness (k = " << k << ")..."
+                << std::endl;
+
+            engine.set_step(k);
+            status = engine.solve();
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return;
+            }
+
+            if (sat::status_t::STATUS_SAT == status) {
+                break;
+            }
+
+            engine.retire_last_group();
+
+            unroll(engine, k);
+            ++k;
+            assert_fsm_simple_path(engine, k);
+
+            INFO
+                << "Now looking for unreachability proof (k = " << k << ")..."
+                << std::endl;
+
+            engine.set_step(k);
+            status = solve_simple_path(engine, k);
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return;
+            }
+
+            if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "Found unreachability proof (k = " << k << ")"
+                    << std::endl;
+
+                f_status = REACHABILITY_UNREACHABLE;
+                return;
+            }
+        }
+
+        f_status = REACHABILITY_REACHABLE;
+
+        witness::Witness_ptr best { make_witness(engine, k, f_best) };
+        INFO
+            << "Reachability witness exists (k = " << k << "), cost is "
+            << f_best
+            << std::endl;
+
+        while (lo < f_best) {
+            value_t bound { binary ? lo + (f_best - 1 - lo) / 2 : f_best - 1 };
+
+            sat::group_t group { engine.new_group() };
+            compiler::Unit bound_cu { compiler().process(ctx, make_bound(bound)) };
+            assert_formula(engine, k, bound_cu, group);
+
+            INFO
+                << "Now looking for a witness of cost at most "
+                << bound
+                << " (k = " << k << ")..."
+                << std::endl;
+
+            status = engine.solve();
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                break;
+            }
+
+            if (sat::status_t::STATUS_UNSAT == status) {
+                engine.retire_last_group();
+                lo = bound + 1;
+                continue;
+            }
+
+            value_t value;
+            witness::Witness_ptr w { make_witness(engine, k, value) };
+            assert(value <= bound);
+
+            INFO
+                << "Found a witness of cost "
+                << value
+                << std::endl;
+
+            delete best;
+            best = w;
+            f_best = value;
+        }
+
+        f_optimal = f_best <= lo;
+
+        /* witness identifier */
+        std::ostringstream oss_id;
+        oss_id
+            << optimize_trace_prfx
+            << wm.autoincrement();
+        best->set_id(oss_id.str());
+
+        /* witness description */
+        std::ostringstream oss_desc;
+        oss_desc
+            << (f_optimal ? "Least cost" : "Best known")
+            << " witness for target `"
+            << target
+            << "`, cost `"
+            << cost
+            << "` = "
+            << f_best
+            << ", in module `"
+            << model().main_module().name()
+            << "`";
+        best->set_desc(oss_desc.str());
+
+        wm.record(*best);
+        wm.set_current(*best);
+        set_witness(*best);
+
+        INFO
+            << engine
+            << std::endl;
+    }
+
+} // namespace reach
@@ -0,0 +1,94 @@
+/**
+ * @file reach/optimize.hh
+ * @brief SAT-based search of witnesses of least cost.
+ *
+ * This module contains the declaration of an algorithm looking for a
+ * witness of minimal depth for a target, then for one of least cost
+ * among those, a cost being an algebraic expression on the last state.
+ * The bound on the cost is tightened on the same unrolling, each bound
+ * asserted in a group of its own: a bound too tight is retired, the
+ * others are kept, since later bounds only tighten them further.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef OPTIMIZATION_ALGORITHM_H
+#define OPTIMIZATION_ALGORITHM_H
+
+#include <algorithms/base.hh>
+#include <algorithms/reach/typedefs.hh>
+
+#include <cmd/command.hh>
+
+#include <compiler/typedefs.hh>
+
+namespace reach {
+
+    class Optimization: public algorithms::Algorithm {
+
+    public:
+        Optimization(cmd::Command& command, model::Model& model);
+        ~Optimization();
+
+        /* bounds are tried halfway between the least cost not ruled
+           out and the best one found if binary, one less than the
+           best one otherwise */
+        void process(expr::Expr_ptr target, expr::Expr_ptr cost,
+                     expr::ExprVector constraints, bool binary);
+
+        inline reachability_status_t status() const
+        {
+            return f_status;
+        }
+
+        /* the cost of the witness, if any, and whether no witness of
+           the same depth costs less */
+        inline value_t cost() const
+        {
+            return f_best;
+        }
+        inline bool optimal() const
+        {
+            return f_optimal;
+        }
+
+    private:
+        expr::Expr_ptr f_target;
+        expr::Expr_ptr f_cost;
+
+        expr::ExprVector f_constraints;
+        compiler::Units f_constraint_cus;
+
+        reachability_status_t f_status;
+        value_t f_best;
+        bool f_optimal;
+
+        /* unrolling next, frame k + 1 */
+        void unroll(sat::Engine& engine, step_t k);
+
+        /* the model of engine as a witness of k steps, its cost at k */
+        witness::Witness_ptr make_witness(sat::Engine& engine, step_t k, value_t& cost);
+
+        /* cost <= bound */
+        expr::Expr_ptr make_bound(value_t bound);
+    };
+
+} // namespace reach
+
+#endif /* OPTIMIZATION_ALGORITHM_H */
@@ -24,12 +24,21 @@
 
 #include <algorithms/reach/reach.hh>
 #include <algorithms/reach/witness.hh>
+#include <algorithms/fsm/fsm.hh>
 
 #include <expr/time/analyzer/analyzer.hh>
-#include <expr/time/expander/expander.hh>
+
+#include <algorithms/scheduler.hh>
+#include <algorithms/telemetry.hh>
 
 #include <compiler/compiler.hh>
 
+#include <witness/exceptions.hh>
+
+#include <model/model_mgr.hh>
+
+#include <opts/opts_mgr.hh>
+
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -37,6 +46,17 @@ namespace reach {
 
     Reachability::Reachability(cmd::Command& command, model::Model& model)
         : Algorithm(command, model)
+        , f_stride(1)
+        , f_geometric(false)
+        , f_session(NULL)
+        , f_checkpoint(NULL)
+        , f_origin(NULL)
+        , f_origin_time(0)
+        , f_shorten(false)
+        , f_minimize(false)
+        , f_sweeping(false)
+        , f_shared_forward(false)
+        , f_threshold(UINT_MAX)
     {
         const void* instance { this };
         TRACE
@@ -54,6 +74,43 @@ namespace reach {
             << std::endl;
     }
 
+    void Reachability::set_origin(witness::Witness& w, step_t k)
+    {
+        if (k < w.first_time() || w.last_time() < k) {
+            throw witness::IllegalTime(k);
+        }
+
+        f_origin = &w;
+        f_origin_time = k;
+    }
+
+    bool Reachability::resumed(sat::Engine& engine, step_t k)
+    {
+        if (NULL == f_checkpoint) {
+            return false;
+        }
+
+        if (f_checkpoint->completed(engine.name(), k)) {
+            INFO
+                << "Step k = "
+                << k
+                << " completed before, skipped"
+                << std::endl;
+
+            return true;
+        }
+
+        f_checkpoint->restore(engine);
+        return false;
+    }
+
+    void Reachability::checkpoint(sat::Engine& engine, step_t k)
+    {
+        if (NULL != f_checkpoint) {
+            f_checkpoint->complete(engine, k);
+        }
+    }
+
     void Reachability::process(expr::Expr_ptr target, expr::ExprVector constraints)
     {
         expr::time::Analyzer eta { em() };
@@ -64,12 +121,15 @@ namespace reach {
 
         /* store and inspect constraints: currently mixed-time
          * (i.e. backward + forward) constraints are *not*
-         * supported */
+         * supported. Constraints timed on either end of the path are
+         * scheduled on the frames they apply to. */
         f_constraints = constraints;
         unsigned no_forward_constraints { 0 };
         unsigned no_backward_constraints { 0 };
         unsigned no_global_constraints { 0 };
 
+        expr::Expr_ptr ctx { em().make_empty() };
+
         for (auto i = f_constraints.begin(); i != f_constraints.end(); ++i) {
             auto constraint { *i };
 
@@ -83,12 +143,63 @@ namespace reach {
                 return;
             }
 
-            if (eta.has_forward_time()) {
+            TRACE
+                << "Compiling constraint `"
+                << constraint
+                << "` ..."
+                << std::endl;
+
+            bool forward { eta.has_forward_time() };
+            bool backward { eta.has_backward_time() };
+
+            if (!forward && !backward) {
+                f_global_cus.push_back(
+                    compiler().process(ctx, constraint));
+
+                ++no_global_constraints;
+                continue;
+            }
+
+            if (forward) {
                 ++no_forward_constraints;
-            } else if (eta.has_backward_time()) {
-                ++no_backward_constraints;
             } else {
-                ++no_global_constraints;
+                ++no_backward_constraints;
+            }
+
+            /* `@a..b{ e }`, `$a..b{ e }` with e untimed */
+            bool scheduled { false };
+            if (em().is_at(constraint)) {
+                expr::time::Analyzer body_eta { em() };
+                body_eta.process(constraint->rhs());
+
+                scheduled = !body_eta.has_forward_time() &&
+                            !body_eta.has_backward_time();
+            }
+
+            if (scheduled) {
+                expr::Expr_ptr lhs { constraint->lhs() };
+                expr::Expr_ptr a { em().is_interval(lhs) ? lhs->lhs() : lhs };
+                expr::Expr_ptr b { em().is_interval(lhs) ? lhs->rhs() : lhs };
+
+                /* backward instants are stored as UINT_MAX - j */
+                step_t va { (step_t) a->value() };
+                step_t vb { (step_t) b->value() };
+                if (backward) {
+                    va = UINT_MAX - va;
+                    vb = UINT_MAX - vb;
+                }
+
+                TimedUnit tu {
+                    compiler().process(ctx, constraint->rhs()),
+                    std::min(va, vb),
+                    std::max(va, vb)
+                };
+                (forward ? f_forward_cus : f_backward_cus).push_back(tu);
+            }
+
+            else {
+                (forward ? f_timed_forward_cus : f_timed_backward_cus).push_back(
+                    compiler().process(ctx, constraint));
             }
         }
 
@@ -108,21 +219,48 @@ namespace reach {
             << " global."
             << std::endl;
 
-        bool use_forward { !no_backward_constraints };
-        bool use_backward { !no_forward_constraints };
+        /* absolute times only apply to unrollings from the same end */
+        bool use_forward { f_timed_backward_cus.empty() };
+        bool use_backward { f_timed_forward_cus.empty() };
 
-        /* TODO: consider introducing support for this: a bit trickier, but doable */
         if (!use_forward && !use_backward) {
             ERR
                 << "Mixing forward and backward guided reachability "
-                << "constraints currently not supported."
+                << "constraints currently not supported, "
+                << "unless given as `@a..b{ expr }` or `$a..b{ expr }`."
                 << std::endl;
 
             f_status = REACHABILITY_ERROR;
             return;
         }
 
-        expr::Expr_ptr ctx { em().make_empty() };
+        /* sessions unroll from the initial states of the model */
+        if (NULL != f_session && NULL != f_origin) {
+            WARN
+                << "Sessions do not support an origin state, not using session."
+                << std::endl;
+
+            f_session = NULL;
+        }
+
+        if (NULL != f_session && 0 < no_backward_constraints) {
+            WARN
+                << "Sessions only support forward and global constraints, not using session."
+                << std::endl;
+
+            f_session = NULL;
+        }
+
+        /* sessions keep whole constraints in groups of their own */
+        if (NULL != f_session) {
+            for (auto constraint : f_constraints) {
+                compiler::Unit cu {
+                    compiler().process(ctx, constraint)
+                };
+                f_constraint_cus.insert(
+                    std::pair<expr::Expr_ptr, compiler::Unit>(constraint, cu));
+            }
+        }
 
         TRACE
             << "Compiling target `"
@@ -132,37 +270,136 @@ namespace reach {
 
         /* strategy threads will access this value in the main thread's stack */
         compiler::Unit target_cu { compiler().process(ctx, f_target) };
-        expr::time::Expander expander { em() };
 
-        for (auto i = f_constraints.begin(); i != f_constraints.end(); ++i) {
-            auto constraint { *i };
+        /* k-induction also needs the negated target */
+        compiler::Unit invariant_cu { compiler().process(ctx, em().make_not(f_target)) };
 
-            TRACE
-                << "Compiling constraint `"
-                << constraint
-                << "` ..."
+        if ((f_shorten || f_minimize) && has_timed_constraints()) {
+            WARN
+                << "Witness post-processing not supported with timed constraints."
                 << std::endl;
 
-            compiler::Unit cu {
-                compiler().process(ctx, expander.process(constraint))
-            };
-            f_constraint_cus.insert(
-                std::pair<expr::Expr_ptr, compiler::Unit>(constraint, cu));
+            f_shorten = false;
+            f_minimize = false;
+        }
+        f_target_cus = { target_cu, invariant_cu };
+
+        /* the diameter bounds the shortest witness, unless
+           constraints depend on time. It is measured from the initial
+           states, not from an origin */
+        if (!has_timed_constraints() && NULL == f_origin) {
+            f_threshold = fsm::DiameterMgr::INSTANCE().diameter(model());
         }
 
+        /* sessions share their unrolling with other targets */
+        if (opts::OptsMgr::INSTANCE().coi()) {
+            if (NULL != f_session) {
+                WARN
+                    << "Cone of influence reduction not supported with sessions."
+                    << std::endl;
+            } else {
+                compiler::Units cone { target_cu };
+                collect_constraint_units(cone);
+
+                restrict_to_coi(cone);
+            }
+        }
+
+        /* symmetric initial states are explored once */
+        const std::string symmetry { opts::OptsMgr::INSTANCE().symmetry_breaking() };
+        if (("reach" == symmetry || "all" == symmetry) && NULL == f_origin) {
+            if (NULL != f_session) {
+                WARN
+                    << "Symmetry breaking not supported with sessions."
+                    << std::endl;
+            } else {
+                expr::ExprVector exprs { f_constraints };
+                exprs.push_back(f_target);
+
+                break_symmetries(exprs);
+            }
+        }
+
+        /* the prefix of the origin trace is not searched again */
+        if (NULL != f_origin) {
+            INFO
+                << "Searching from time "
+                << f_origin_time
+                << " of witness `"
+                << f_origin->id()
+                << "`"
+                << std::endl;
+
+            replace_init((*f_origin)[f_origin_time]);
+        }
+
+        /* auxiliary invariants, e.g. for k-induction */
+        if (f_sweeping || opts::OptsMgr::INSTANCE().mine_invariants()) {
+            mine_invariants();
+        }
+        if (0 < opts::OptsMgr::INSTANCE().bdd_approx()) {
+            approximate_reachable();
+        }
+
+        /* past preprocessing, only the CNF of the FSM is needed */
+        release_fsm_dds();
+
         /* fire up strategies */
         f_status = REACHABILITY_UNKNOWN;
 
-        algorithms::thread_ptrs tasks;
+        /* deterministic mode: the shortest witness is always found by
+           the same strategy, i.e. the first one below */
+        algorithms::Tasks tasks;
         if (use_forward) {
             TRACE
                 << "Forward strategies enabled"
                 << std::endl;
 
-            tasks.push_back(new boost::thread(
-                &Reachability::fast_forward_strategy, this, target_cu));
-            tasks.push_back(new boost::thread(
-                &Reachability::forward_strategy, this, target_cu));
+            /* a single unrolling for witnesses and proofs, unless
+               witnesses are searched by step-jumping or on a session */
+            f_shared_forward =
+                !opts::OptsMgr::INSTANCE().split_forward() &&
+                1 == f_stride && !f_geometric && NULL == f_session;
+
+            /* witnesses first, then proofs */
+            if (f_shared_forward) {
+                TRACE
+                    << "Forward witnesses and proofs share an unrolling"
+                    << std::endl;
+            } else if (NULL != f_session) {
+                tasks.push_back(algorithms::Task(
+                    "session",
+                    boost::bind(&Reachability::session_strategy, this, target_cu),
+                    algorithms::PRIORITY_HIGH));
+            } else {
+                tasks.push_back(algorithms::Task(
+                    "fast_forward",
+                    boost::bind(&Reachability::fast_forward_strategy, this, target_cu),
+                    algorithms::PRIORITY_HIGH));
+            }
+            tasks.push_back(algorithms::Task(
+                "forward",
+                boost::bind(&Reachability::forward_strategy, this, target_cu),
+                f_shared_forward ? algorithms::PRIORITY_HIGH : algorithms::PRIORITY_NORMAL));
+            tasks.push_back(algorithms::Task(
+                "kinduction",
+                boost::bind(&Reachability::kinduction_strategy, this, target_cu, invariant_cu)));
+            tasks.push_back(algorithms::Task(
+                "interpolation",
+                boost::bind(&Reachability::interpolation_strategy, this, target_cu),
+                algorithms::PRIORITY_LOW));
+            tasks.push_back(algorithms::Task(
+                "localization",
+                boost::bind(&Reachability::localization_strategy, this, target_cu, invariant_cu),
+                algorithms::PRIORITY_LOW));
+        }
+
+        /* word-level BMC, global constraints only */
+        if (use_forward && !has_timed_constraints() && NULL == f_origin &&
+            !opts::OptsMgr::INSTANCE().smt_solver().empty()) {
+            tasks.push_back(algorithms::Task(
+                "smt_bmc",
+                boost::bind(&Reachability::smt_strategy, this)));
         }
 
         if (use_backward) {
@@ -170,20 +407,135 @@ namespace reach {
                 << "Backward strategies enabled"
                 << std::endl;
 
-            tasks.push_back(new boost::thread(
-                &Reachability::fast_backward_strategy, this, target_cu));
-            tasks.push_back(new boost::thread(
-                &Reachability::backward_strategy, this, target_cu));
+            tasks.push_back(algorithms::Task(
+                "fast_backward",
+                boost::bind(&Reachability::fast_backward_strategy, this, target_cu),
+                algorithms::PRIORITY_HIGH));
+            tasks.push_back(algorithms::Task(
+                "backward",
+                boost::bind(&Reachability::backward_strategy, this, target_cu)));
+        }
+
+        /* BDD fixpoint, no timed constraints */
+        if (use_forward && !has_timed_constraints()) {
+            tasks.push_back(algorithms::Task(
+                "bdd_reach",
+                boost::bind(&Reachability::bdd_reach_strategy, this, target_cu)));
+        }
+
+        /* random simulation for shallow targets, on the BDDs of the
+           FSM, which must still be around */
+        if (use_forward && !has_timed_constraints() && NULL == f_origin &&
+            !opts::OptsMgr::INSTANCE().release_dds()) {
+            tasks.push_back(algorithms::Task(
+                "simulation",
+                boost::bind(&Reachability::simulation_strategy, this, target_cu)));
         }
 
-        /* join and destroy all active threads */
+        /* both frontiers, no timed constraints */
+        if (use_forward && use_backward && !has_timed_constraints()) {
+            tasks.push_back(algorithms::Task(
+                "bidirectional",
+                boost::bind(&Reachability::bidirectional_strategy, this, target_cu)));
+        }
+
+        if (opts::OptsMgr::INSTANCE().deterministic()) {
+            f_witness_strategy = tasks[0].name;
+
+            DEBUG
+                << "Deterministic mode, witnesses from `"
+                << f_witness_strategy
+                << "` only"
+                << std::endl;
+        }
+
+        /* strategies which did not pay off on this model before come
+           last */
+        algorithms::Telemetry& telemetry { algorithms::Telemetry::INSTANCE() };
+        std::size_t fingerprint { model::ModelMgr::INSTANCE().fingerprint() };
+        if (1 < tasks.size()) {
+            for (auto& task : tasks) {
+                if (telemetry.unpromising(fingerprint, task.name)) {
+                    INFO
+                        << "Strategy `"
+                        << task.name
+                        << "` fell behind on previous runs, lowest priority"
+                        << std::endl;
+
+                    task.priority = algorithms::PRIORITY_LOW;
+                }
+            }
+        }
+
+        /* run all strategies, the ones not started yet are skipped
+           once the status is known */
         assert(0 < tasks.size());
-        std::for_each(
-            begin(tasks), end(tasks),
-            [](algorithms::thread_ptr task) {
-                task->join();
-                delete task;
-            });
+        algorithms::TaskStatsVector stats;
+        f_winner.clear();
+        algorithms::Scheduler::INSTANCE().run(tasks, [this]() {
+            return REACHABILITY_UNKNOWN == this->sync_status();
+        }, &stats);
+
+        telemetry.record(fingerprint, stats, f_winner);
+    }
+
+    void Reachability::assert_constraints(sat::Engine& engine, step_t j, bool backward,
+                                          sat::group_t group)
+    {
+        step_t time { backward ? UINT_MAX - j : j };
+        assert_global_constraints(engine, time, group);
+
+        for (auto& tu : backward ? f_backward_cus : f_forward_cus) {
+            if (tu.begin <= j && j <= tu.end) {
+                assert_formula(engine, time, tu.cu, group);
+            }
+        }
+
+        /* absolute times */
+        if (0 == j) {
+            for (auto& cu : backward ? f_timed_backward_cus : f_timed_forward_cus) {
+                assert_formula(engine, time, cu, group);
+            }
+        }
+    }
+
+    void Reachability::assert_global_constraints(sat::Engine& engine, step_t time,
+                                                 sat::group_t group)
+    {
+        for (auto& cu : f_global_cus) {
+            assert_formula(engine, time, cu, group);
+        }
+    }
+
+    void Reachability::assert_far_constraints(sat::Engine& engine, step_t k, bool backward,
+                                              sat::group_t group)
+    {
+        for (auto& tu : backward ? f_forward_cus : f_backward_cus) {
+            for (step_t j = tu.begin; j <= std::min(tu.end, k); ++j) {
+                /* frame j from the other end is frame k - j from this one */
+                step_t time { backward ? UINT_MAX - (k - j) : k - j };
+                assert_formula(engine, time, tu.cu, group);
+            }
+        }
+    }
+
+    void Reachability::collect_constraint_units(compiler::Units& res) const
+    {
+        res.insert(res.end(), f_global_cus.begin(), f_global_cus.end());
+        res.insert(res.end(), f_timed_forward_cus.begin(), f_timed_forward_cus.end());
+        res.insert(res.end(), f_timed_backward_cus.begin(), f_timed_backward_cus.end());
+        for (const auto& tu : f_forward_cus) {
+            res.push_back(tu.cu);
+        }
+        for (const auto& tu : f_backward_cus) {
+            res.push_back(tu.cu);
+        }
+    }
+
+    bool Reachability::has_timed_constraints() const
+    {
+        return !f_forward_cus.empty() || !f_backward_cus.empty() ||
+               !f_timed_forward_cus.empty() || !f_timed_backward_cus.empty();
     }
 
     /* synchronized */
@@ -202,7 +554,23 @@ namespace reach {
         assert(f_status == status ||
                (status != REACHABILITY_UNKNOWN && f_status == REACHABILITY_UNKNOWN));
 
+        /* the other strategies keep looking for proofs, a witness
+           they find is dropped */
+        if (REACHABILITY_REACHABLE == status && !f_witness_strategy.empty() &&
+            f_witness_strategy != algorithms::Scheduler::INSTANCE().current_task()) {
+            DEBUG
+                << "Deterministic mode, witness left to `"
+                << f_witness_strategy
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+
         bool res { f_status != status };
+        if (res) {
+            f_winner = algorithms::Scheduler::INSTANCE().current_task();
+        }
 
         /* set status, extract witness if reachable */
         f_status = status;
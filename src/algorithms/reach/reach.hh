@@ -26,6 +26,8 @@
 
 #include <algorithms/base.hh>
 #include <algorithms/reach/typedefs.hh>
+#include <algorithms/reach/session.hh>
+#include <algorithms/reach/checkpoint.hh>
 
 #include <cmd/command.hh>
 
@@ -33,6 +35,9 @@
 
 namespace reach {
 
+    /* shared state of a cube-and-conquer search, see cubes.cc */
+    struct CubeSearch;
+
     class Reachability: public algorithms::Algorithm {
 
     public:
@@ -49,25 +54,229 @@ namespace reach {
         reachability_status_t sync_status();
         bool sync_set_status(reachability_status_t status);
 
+        /* step-jumping BMC: the fast forward strategy unrolls stride
+           steps at once, doubling it each time if geometric */
+        inline void set_stride(step_t stride, bool geometric)
+        {
+            f_stride = stride;
+            f_geometric = geometric;
+        }
+
+        /* persistent session (if any), taken over by the session
+           strategy instead of the fast forward one */
+        inline void set_session(Session_ptr session)
+        {
+            f_session = session;
+        }
+
+        /* the search starts from the state at time k of w, instead of
+           the initial states. Witnesses found extend the frames of w
+           up to time k */
+        void set_origin(witness::Witness& w, step_t k);
+
+        /* witnesses found are shortened, by searching shortcuts from
+           their intermediate states, and minimized, by dropping the
+           values the target does not depend on (see minimize.cc) */
+        inline void set_postprocessing(bool shorten, bool minimize)
+        {
+            f_shorten = shorten;
+            f_minimize = minimize;
+        }
+
+        /* steps completed are checkpointed, and steps completed by
+           the run checkpoint was loaded from (if any) are skipped */
+        inline void set_checkpoint(Checkpoint_ptr checkpoint)
+        {
+            f_checkpoint = checkpoint;
+        }
+
+        /* auxiliary invariants are mined (see mining.cc) even if
+           --mine-invariants was not given, e.g. the equivalences of
+           the two sides of a miter */
+        inline void set_sweeping(bool sweeping)
+        {
+            f_sweeping = sweeping;
+        }
+
     private:
         expr::Expr_ptr f_target;
 
         expr::ExprVector f_constraints;
 
+        step_t f_stride;
+        bool f_geometric;
+
+        Session_ptr f_session;
+
+        /* deterministic mode (--deterministic): the only strategy
+           allowed to record a witness, empty if any is */
+        std::string f_witness_strategy;
+
+        /* the strategy which decided the status, empty if none did */
+        std::string f_winner;
+
+        /* NULL, unless set_checkpoint() was called */
+        Checkpoint_ptr f_checkpoint;
+
+        /* true iff the queries of step k were completed by the run
+           resumed. Learnts saved for the strategy of engine are added
+           on the first step that was not */
+        bool resumed(sat::Engine& engine, step_t k);
+
+        /* the strategy of engine completed step k */
+        void checkpoint(sat::Engine& engine, step_t k);
+
+        /* NULL, unless set_origin() was called */
+        witness::Witness_ptr f_origin;
+        step_t f_origin_time;
+
+        /* the frames of prefix up to time, followed by the ones of w
+           past its first (i.e. the state of prefix at time) */
+        witness::Witness& splice_witness(witness::Witness& prefix, step_t time,
+                                         witness::Witness& w);
+
+        bool f_shorten;
+        bool f_minimize;
+
+        bool f_sweeping;
+
+        /* the target and its negation, for post-processing */
+        compiler::Units f_target_cus;
+
+        /* post-processing, w is not changed. Neither supports timed
+           constraints */
+        witness::Witness& shorten_witness(witness::Witness& w);
+        witness::Witness& minimize_witness(witness::Witness& w);
+
+        /* if true, the forward strategy also searches witnesses
+           (without simple-path constraints), instead of a separate
+           fast forward unrolling */
+        bool f_shared_forward;
+
+        /* if the model's diameter is known, no witness longer than
+           it need be looked for (UINT_MAX otherwise) */
+        step_t f_threshold;
+
+        /* whole constraints, compiled for the session strategy only */
         using ConstraintCompilationMap =
             boost::unordered_map<expr::Expr_ptr, compiler::Unit,
                                  utils::PtrHash, utils::PtrEq>;
         ConstraintCompilationMap f_constraint_cus;
 
+        /* Constraints schedule, built once by process(). `@a..b{ e }`
+         * and `$a..b{ e }` constraints (with e untimed) are compiled
+         * as e, asserted on frames a, .., b counted from either end
+         * of the path. Other timed constraints are compiled with
+         * absolute times, and only apply to the strategies unrolling
+         * from the same end. */
+        struct TimedUnit {
+            compiler::Unit cu;
+            step_t begin;
+            step_t end;
+        };
+        using TimedUnits = std::vector<TimedUnit>;
+
+        compiler::Units f_global_cus;
+        TimedUnits f_forward_cus;
+        TimedUnits f_backward_cus;
+        compiler::Units f_timed_forward_cus;
+        compiler::Units f_timed_backward_cus;
+
+        /* constraints on the j-th frame of an unrolling (time j, or
+           UINT_MAX - j if backward), asserted as the frame is
+           unrolled */
+        void assert_constraints(sat::Engine& engine, step_t j, bool backward,
+                                sat::group_t group = sat::MAINGROUP);
+
+        /* global constraints only on the given time frame */
+        void assert_global_constraints(sat::Engine& engine, step_t time,
+                                       sat::group_t group = sat::MAINGROUP);
+
+        /* constraints timed from the other end of the path, for paths
+           of k steps. Frames out of the path are not constrained */
+        void assert_far_constraints(sat::Engine& engine, step_t k, bool backward,
+                                    sat::group_t group);
+
+        bool has_timed_constraints() const;
+
+        /* units of all constraints, appended to res */
+        void collect_constraint_units(compiler::Units& res) const;
+
         boost::mutex f_status_mutex;
         reachability_status_t f_status;
 
         /* checking strategies */
         void forward_strategy(compiler::Unit& target_cu);
+
+        /* records the forward witness of k steps found by engine */
+        void record_forward_witness(sat::Engine& engine, step_t k);
+
+        /* names, records and publishes a reachability witness */
+        void record_witness(witness::Witness& w);
+
+        /* the forward witness query of k steps, already asserted on
+           engine. With cube-and-conquer, a query exceeding the
+           conflicts threshold is split into cubes solved in parallel
+           by engines of their own, then the witness (if any) is
+           recorded by the engine that found it */
+        sat::status_t solve_forward_witness(sat::Engine& engine, step_t k,
+                                            compiler::Unit& target_cu);
+        sat::status_t cube_and_conquer(sat::Engine& engine, step_t k,
+                                       compiler::Unit& target_cu);
+        void cube_worker(CubeSearch& search, unsigned id, step_t k,
+                         compiler::Unit& target_cu);
+        void remote_cube_worker(CubeSearch& search, unsigned id,
+                                const std::string& endpoint);
         void backward_strategy(compiler::Unit& target_cu);
 
         void fast_forward_strategy(compiler::Unit& target_cu);
         void fast_backward_strategy(compiler::Unit& target_cu);
+
+        /* fast forward, resuming the unrolling of a session */
+        void session_strategy(compiler::Unit& target_cu);
+
+        /* forward from INIT and backward from the target, joined */
+        void bidirectional_strategy(compiler::Unit& target_cu);
+
+        /* `invariant_cu` is the negated target */
+        void kinduction_strategy(compiler::Unit& target_cu,
+                                 compiler::Unit& invariant_cu);
+
+        void interpolation_strategy(compiler::Unit& target_cu);
+
+        /* BMC and k-induction on a localization abstraction, refined
+           by the UNSAT cores of a concrete BMC */
+        void localization_strategy(compiler::Unit& target_cu,
+                                   compiler::Unit& invariant_cu);
+
+        /* exact forward fixpoint on BDDs, for FSMs made of plain DDs
+           and global constraints only */
+        void bdd_reach_strategy(compiler::Unit& target_cu);
+
+        /* BMC on the external SMT solver of --smt-solver, word-level
+           and with global constraints only */
+        void smt_strategy();
+
+        /* the fixpoint, on DD manager dd. If the target is reachable,
+           path[j][i] is the value of state[i] in the j-th state of a
+           shortest witness (k steps) */
+        reachability_status_t bdd_reach(Cudd& dd, compiler::Unit& target_cu,
+                                        const std::vector<int>& state,
+                                        const std::vector<int>& next,
+                                        std::vector<std::vector<bool>>& path,
+                                        step_t& k);
+
+        /* witness for a path found by bdd_reach or by simulation
+           (path[j][i] as above), replayed on SAT by an engine of the
+           given name */
+        void path_witness(const char* name, compiler::Unit& target_cu,
+                          const std::vector<int>& state,
+                          const std::vector<std::vector<bool>>& path);
+
+        /* bit-parallel random simulation from the initial states, for
+           shallow targets, global constraints only. Witnesses are
+           replayed as those of bdd_reach */
+        void simulation_strategy(compiler::Unit& target_cu);
     };
 
 } // namespace reach
@@ -0,0 +1,512 @@
+/**
+ * @file reach/result_cache.cc
+ * @brief Persistent cache of reachability results, implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <algorithms/reach/result_cache.hh>
+
+#include <env/environment.hh>
+
+#include <expr/printer/printer.hh>
+
+#include <model/module.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/proxy.hh>
+#include <symb/symb_iter.hh>
+
+#include <type/printers.hh>
+
+#include <witness/binary.hh>
+#include <witness/witness_mgr.hh>
+
+#include <utils/logging.hh>
+
+/* bump whenever the file format changes */
+static const char* result_cache_magic { "yasmv-reach-result 1" };
+static const char* result_cache_ext { ".reach" };
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace reach {
+
+    /* FNV-1a, stable across runs (unlike std::hash) */
+    static uint64_t stable_hash(const std::string& s)
+    {
+        uint64_t res { 14695981039346656037ULL };
+        for (unsigned char c : s) {
+            res ^= c;
+            res *= 1099511628211ULL;
+        }
+
+        return res;
+    }
+
+    /* The query, printed: options affecting the encoding, the model
+     * (symbols and FSM statements are sorted, so that it does not
+     * depend on the order of the symbol tables), the environment, the
+     * target and the constraints, which are ordered. */
+    static std::string query_signature(model::Model& model, expr::Expr_ptr target,
+                                       const expr::ExprVector& constraints,
+                                       const std::string& algorithm)
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        std::vector<std::string> lines;
+        for (const auto& pair : model.modules()) {
+            model::Module& module { *pair.second };
+
+            auto add = [&](const char* kind, const std::string& what) {
+                std::ostringstream oss;
+                oss
+                    << "module "
+                    << module.name()
+                    << " "
+                    << kind
+                    << " "
+                    << what;
+                lines.push_back(oss.str());
+            };
+
+            for (const auto& param : module.parameters()) {
+                std::ostringstream oss;
+                oss
+                    << param.first
+                    << " : "
+                    << param.second->type();
+                add("param", oss.str());
+            }
+
+            for (const auto& var : module.vars()) {
+                const symb::Variable& v { *var.second };
+
+                std::ostringstream oss;
+                oss
+                    << var.first
+                    << " : "
+                    << v.type()
+                    << (v.is_input() ? " input" : "")
+                    << (v.is_frozen() ? " frozen" : "")
+                    << (v.is_temp() ? " temp" : "")
+                    << (v.is_inertial() ? " inertial" : "");
+                add("var", oss.str());
+            }
+
+            for (const auto& def : module.defs()) {
+                std::ostringstream oss;
+                oss
+                    << def.first
+                    << " := "
+                    << def.second->body();
+                add("define", oss.str());
+            }
+
+            const std::pair<const char*, const expr::ExprVector*> sections[] = {
+                { "init", &module.init() },
+                { "invar", &module.invar() },
+                { "trans", &module.trans() },
+            };
+            for (const auto& section : sections) {
+                for (auto body : *section.second) {
+                    std::ostringstream oss;
+                    oss
+                        << body;
+                    add(section.first, oss.str());
+                }
+            }
+        }
+
+        for (auto id : env.identifiers()) {
+            std::ostringstream oss;
+            oss
+                << "input "
+                << id
+                << " = "
+                << env.get(id);
+            lines.push_back(oss.str());
+        }
+
+        const std::pair<const char*, const expr::ExprVector*> extras[] = {
+            { "extra-init", &env.extra_init() },
+            { "extra-invar", &env.extra_invar() },
+            { "extra-trans", &env.extra_trans() },
+        };
+        for (const auto& extra : extras) {
+            for (auto constraint : *extra.second) {
+                std::ostringstream oss;
+                oss
+                    << extra.first
+                    << " "
+                    << constraint;
+                lines.push_back(oss.str());
+            }
+        }
+
+        std::sort(lines.begin(), lines.end());
+
+        std::ostringstream oss;
+        oss
+            << result_cache_magic
+            << std::endl
+            << "word-width "
+            << om.word_width()
+            << std::endl
+            << "enum-encoding "
+            << om.enum_encoding()
+            << std::endl
+            << "narrow-ranges "
+            << om.narrow_ranges()
+            << std::endl
+            << "algorithm "
+            << algorithm
+            << std::endl;
+
+        for (const auto& line : lines) {
+            oss
+                << line
+                << std::endl;
+        }
+
+        oss
+            << "target "
+            << target
+            << std::endl;
+
+        for (auto constraint : constraints) {
+            oss
+                << "constraint "
+                << constraint
+                << std::endl;
+        }
+
+        return oss.str();
+    }
+
+    ResultCache::ResultCache(const std::string& path, model::Model& model,
+                             expr::Expr_ptr target, const expr::ExprVector& constraints,
+                             const std::string& algorithm)
+        : f_model(model)
+    {
+        std::ostringstream name;
+        name
+            << std::hex
+            << std::setw(16)
+            << std::setfill('0')
+            << stable_hash(query_signature(model, target, constraints, algorithm))
+            << result_cache_ext;
+
+        f_cachefile = boost::filesystem::path { path } / name.str();
+
+        const void* instance { this };
+        DRIVEL
+            << "Created ResultCache @"
+            << instance
+            << std::endl;
+    }
+
+    ResultCache::~ResultCache()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed ResultCache @"
+            << instance
+            << std::endl;
+    }
+
+    void ResultCache::collect_vars(StateVars& res)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        symb::SymbIter si { f_model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            symb::Symbol_ptr symbol { pair.second };
+            if (!symbol->is_variable()) {
+                continue;
+            }
+
+            symb::Variable& var { symbol->as_variable() };
+            if (var.is_input() || var.type()->is_instance()) {
+                continue;
+            }
+
+            expr::Expr_ptr full { em.make_dot(pair.first, symbol->name()) };
+
+            std::ostringstream oss;
+            expr::Printer printer { oss };
+            printer << full;
+
+            res.push_back(std::make_pair(oss.str(), full));
+        }
+    }
+
+    bool ResultCache::lookup(reachability_status_t& status, witness::Witness_ptr& witness)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        symb::ResolverProxy resolver;
+
+        std::ifstream is { f_cachefile.c_str(), std::ios::binary };
+        if (!is) {
+            return false;
+        }
+
+        StateVars vars;
+        collect_vars(vars);
+
+        boost::unordered_map<std::string, expr::Expr_ptr> by_name;
+        for (const auto& var : vars) {
+            by_name.insert(var);
+        }
+
+        witness::Witness_ptr w { NULL };
+        try {
+            std::string magic;
+            unsigned long long tag, depth;
+            if (!witness::read_string(is, magic) || magic != result_cache_magic ||
+                !witness::read_varint(is, tag) || !witness::read_varint(is, depth)) {
+                throw std::runtime_error("malformed header");
+            }
+
+            if (REACHABILITY_UNREACHABLE == tag) {
+                status = REACHABILITY_UNREACHABLE;
+                witness = NULL;
+
+                INFO
+                    << "Cached result found, target is unreachable"
+                    << std::endl;
+
+                return true;
+            }
+
+            if (REACHABILITY_REACHABLE != tag) {
+                throw std::runtime_error("malformed status");
+            }
+
+            /* a single trace, in the binary trace format */
+            unsigned long long version, n_traces, n_inputs, n_steps, n_vars, n_defines;
+            std::string desc, unused;
+            if (!witness::read_string(is, magic) || magic != witness::BIN_MAGIC ||
+                !witness::read_varint(is, version) || witness::BIN_VERSION != version ||
+                !witness::read_varint(is, n_traces) || 1 != n_traces ||
+                !witness::read_string(is, unused) || !witness::read_string(is, desc) ||
+                !witness::read_varint(is, n_inputs)) {
+                throw std::runtime_error("malformed trace header");
+            }
+
+            /* INPUT values are part of the query */
+            for (unsigned long long i = 0; i < n_inputs; ++i) {
+                expr::Expr_ptr value;
+                if (!witness::read_string(is, unused) ||
+                    !witness::read_binary_value(is, value)) {
+                    throw std::runtime_error("malformed input");
+                }
+            }
+
+            if (!witness::read_varint(is, n_steps) || depth + 1 != n_steps ||
+                !witness::read_varint(is, n_vars)) {
+                throw std::runtime_error("malformed trace header");
+            }
+
+            std::vector<expr::Expr_ptr> columns;
+            for (unsigned long long i = 0; i < n_vars; ++i) {
+                std::string name;
+                if (!witness::read_string(is, name)) {
+                    throw std::runtime_error("malformed var name");
+                }
+
+                boost::unordered_map<std::string, expr::Expr_ptr>::const_iterator vi {
+                    by_name.find(name)
+                };
+                if (by_name.end() == vi) {
+                    throw std::runtime_error("unknown var " + name);
+                }
+                columns.push_back(vi->second);
+            }
+
+            if (!witness::read_varint(is, n_defines) || 0 != n_defines) {
+                throw std::runtime_error("unexpected defines");
+            }
+
+            std::ostringstream oss_id;
+            oss_id
+                << reach_trace_prfx
+                << wm.autoincrement();
+
+            w = new witness::Witness(NULL, oss_id.str(), desc);
+
+            std::vector<expr::Expr_ptr> previous(n_vars, NULL);
+            for (unsigned long long time = 0; time < n_steps; ++time) {
+                witness::TimeFrame& tf { w->extend() };
+
+                for (unsigned i = 0; i < n_vars; ++i) {
+                    if (witness::BIN_SAME == is.peek()) {
+                        is.get();
+                    } else if (!witness::read_binary_value(is, previous[i])) {
+                        throw std::runtime_error("malformed value");
+                    }
+
+                    if (NULL != previous[i]) {
+                        symb::Symbol_ptr symb { resolver.symbol(columns[i]) };
+                        tf.set_value(columns[i], previous[i], symb->format());
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Ignoring cached result `"
+                << f_cachefile.string()
+                << "`: "
+                << what
+                << std::endl;
+
+            delete w;
+            return false;
+        }
+
+        wm.record(*w);
+        wm.set_current(*w);
+
+        status = REACHABILITY_REACHABLE;
+        witness = w;
+
+        step_t k { w->size() - 1 };
+        INFO
+            << "Cached result found, target is reachable (k = "
+            << k
+            << ")"
+            << std::endl;
+
+        return true;
+    }
+
+    void ResultCache::store(reachability_status_t status, witness::Witness_ptr witness)
+    {
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        if (REACHABILITY_UNREACHABLE != status &&
+            (REACHABILITY_REACHABLE != status || NULL == witness)) {
+            return;
+        }
+
+        /* a cached witness starts from the initial states */
+        if (NULL != witness && 0 != witness->first_time()) {
+            return;
+        }
+
+        std::ostringstream tmpname;
+        tmpname
+            << f_cachefile.string()
+            << "."
+            << getpid();
+        boost::filesystem::path tmppath { tmpname.str() };
+
+        try {
+            boost::filesystem::create_directories(f_cachefile.parent_path());
+
+            {
+                std::ofstream os { tmppath.c_str(), std::ios::binary };
+
+                step_t depth { NULL != witness ? witness->size() - 1 : 0 };
+                witness::write_string(os, result_cache_magic);
+                witness::write_varint(os, status);
+                witness::write_varint(os, depth);
+
+                if (NULL != witness) {
+                    StateVars vars;
+                    collect_vars(vars);
+
+                    witness::write_string(os, witness::BIN_MAGIC);
+                    witness::write_varint(os, witness::BIN_VERSION);
+                    witness::write_varint(os, 1);
+                    witness::write_string(os, witness->id());
+                    witness::write_string(os, witness->desc());
+
+                    witness::write_varint(os, env.identifiers().size());
+                    for (auto id : env.identifiers()) {
+                        witness::write_name(os, id);
+                        witness::write_binary_value(os, env.get(id));
+                    }
+
+                    witness::write_varint(os, witness->size());
+                    witness::write_varint(os, vars.size());
+                    for (const auto& var : vars) {
+                        witness::write_string(os, var.first);
+                    }
+                    witness::write_varint(os, 0);
+
+                    /* as write_binary_values does, vars without a
+                       value are BIN_UNDEF */
+                    expr::ExprVector previous(vars.size(), NULL);
+                    for (step_t time = witness->first_time(); time <= witness->last_time(); ++time) {
+                        witness::TimeFrame& tf { (*witness)[time] };
+
+                        for (unsigned i = 0; i < vars.size(); ++i) {
+                            expr::Expr_ptr full { vars[i].second };
+                            expr::Expr_ptr value { tf.has_value(full) ? tf.value(full) : NULL };
+
+                            if (0 < time && value == previous[i]) {
+                                os.put(witness::BIN_SAME);
+                            } else {
+                                witness::write_binary_value(os, value);
+                                previous[i] = value;
+                            }
+                        }
+                    }
+                }
+
+                if (!os) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+
+            rename(tmppath, f_cachefile);
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not store result in cache: "
+                << what
+                << std::endl;
+
+            boost::system::error_code ec;
+            remove(tmppath, ec);
+
+            return;
+        }
+
+        DEBUG
+            << "Stored result in cache `"
+            << f_cachefile.string()
+            << "`"
+            << std::endl;
+    }
+
+} // namespace reach
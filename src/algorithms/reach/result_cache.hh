@@ -0,0 +1,82 @@
+/**
+ * @file reach/result_cache.hh
+ * @brief Persistent cache of reachability results.
+ *
+ * This module contains the declarations of the cache of reachability
+ * results (--reach-cache). Results are stored in a directory, one
+ * file per query, named after a stable hash of the model, the word
+ * width, the environment (INPUT values and extra constraints), the
+ * target, the constraints and the algorithm. Only decided results
+ * are stored: the status, the depth and, for reachable targets, the
+ * witness in the binary trace format (see witness/binary.hh).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef REACHABILITY_RESULT_CACHE_H
+#define REACHABILITY_RESULT_CACHE_H
+
+#include <string>
+
+#include <expr/expr.hh>
+
+#include <model/model.hh>
+
+#include <algorithms/reach/typedefs.hh>
+
+#include <witness/witness.hh>
+
+#include <boost/filesystem.hpp>
+
+namespace reach {
+
+    class ResultCache;
+    typedef ResultCache* ResultCache_ptr;
+
+    class ResultCache {
+    public:
+        /* results of target and constraints on model, by algorithm
+           (e.g. `bmc`, `pdr`, along with the post-processing of
+           witnesses), in the directory at path */
+        ResultCache(const std::string& path, model::Model& model,
+                    expr::Expr_ptr target, const expr::ExprVector& constraints,
+                    const std::string& algorithm);
+        ~ResultCache();
+
+        /* true iff a result was found. The witness of a reachable
+           target is registered, and made current. Corrupted entries
+           are misses */
+        bool lookup(reachability_status_t& status, witness::Witness_ptr& witness);
+
+        /* stores a decided result, the witness is needed iff the
+           target is reachable. Failures are not fatal */
+        void store(reachability_status_t status, witness::Witness_ptr witness);
+
+    private:
+        model::Model& f_model;
+        boost::filesystem::path f_cachefile;
+
+        /* (printed name, var) pairs of state vars, in symbol order */
+        using StateVars = std::vector<std::pair<std::string, expr::Expr_ptr>>;
+        void collect_vars(StateVars& res);
+    };
+
+} // namespace reach
+
+#endif /* REACHABILITY_RESULT_CACHE_H */
@@ -0,0 +1,426 @@
+/**
+ * @file reach/session.cc
+ * @brief Persistent reachability sessions implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/reach/session.hh>
+#include <algorithms/reach/witness.hh>
+#include <algorithms/scheduler.hh>
+
+#include <expr/collector.hh>
+#include <expr/time/analyzer/analyzer.hh>
+
+#include <utils/logging.hh>
+
+static const char* reach_trace_prfx { "reach_" };
+
+namespace reach {
+
+    Session::Session(model::Model& model)
+        : f_model(model)
+        , f_engine("session")
+        , f_initialized(false)
+        , f_depth(0)
+        , f_target(NULL)
+        , f_checked(0)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Created Session @"
+            << instance
+            << std::endl;
+    }
+
+    Session::~Session()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Session @"
+            << instance
+            << std::endl;
+    }
+
+    step_t Session::checked(expr::Expr_ptr target) const
+    {
+        return target == f_target ? f_checked : 0;
+    }
+
+    void Session::set_checked(expr::Expr_ptr target, step_t depth)
+    {
+        f_target = target;
+        f_checked = depth;
+    }
+
+    void Session::reset_checked()
+    {
+        f_target = NULL;
+        f_checked = 0;
+    }
+
+    void Session::mark(expr::ExprMarker& marker) const
+    {
+        for (const SessionConstraints* constraints :
+             { &f_constraints, &f_env_inits, &f_env_invars, &f_env_transes }) {
+            for (const auto& pair : *constraints) {
+                marker.mark(pair.first);
+                pair.second.cu.mark(marker);
+            }
+        }
+
+        marker.mark(f_target);
+    }
+
+    SessionMgr::SessionMgr()
+        : f_session(NULL)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized SessionMgr @ "
+            << instance
+            << std::endl;
+
+        /* the session outlives commands, its engine is kept */
+        expr::ExprCollector::INSTANCE().add_roots(
+            "reach session", [this](expr::ExprMarker& marker) {
+                boost::mutex::scoped_lock lock { f_mutex };
+
+                if (f_session) {
+                    f_session->mark(marker);
+                }
+            });
+    }
+
+    SessionMgr::~SessionMgr()
+    {
+        clear();
+
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed SessionMgr @ "
+            << instance
+            << std::endl;
+    }
+
+    Session& SessionMgr::session(model::Model& model)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (NULL != f_session && &f_session->model() != &model) {
+            delete f_session;
+            f_session = NULL;
+        }
+
+        if (NULL == f_session) {
+            f_session = new Session(model);
+        }
+
+        return *f_session;
+    }
+
+    void SessionMgr::clear()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        delete f_session;
+        f_session = NULL;
+    }
+
+    /* Like the fast forward strategy, on the engine of a session:
+     * the unrolling is resumed from the session's depth, and the
+     * target is checked under an assumption of its own, so that the
+     * engine stays usable for any target. Frames are never released,
+     * as constraints given by later commands need be asserted in all
+     * of them. The extra constraints of the environment are asserted
+     * in groups of their own too, so that changing them costs neither
+     * a new unrolling nor the clauses learnt so far. */
+    void Reachability::session_strategy(compiler::Unit& target_cu)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        Session& session { *f_session };
+        boost::mutex::scoped_lock lock { session.mutex() };
+
+        sat::Engine& engine { session.engine() };
+        SessionConstraints& constraints { session.constraints() };
+        sat::Groups& groups { engine.groups() };
+
+        /* the last command using this engine may have been
+           interrupted, or have had a conflict budget */
+        engine.clear_interrupt();
+        engine.configure(-1, -1);
+        setup_engine(engine);
+
+        auto assert_frame = [this, &engine, &constraints, &groups, &session](step_t time) {
+            for (auto& entry : constraints) {
+                SessionConstraint& sc { entry.second };
+                if (sc.global) {
+                    this->assert_formula(engine, time, sc.cu, abs(groups[sc.index]));
+                }
+            }
+
+            /* time - 1 to time transition, and state at time */
+            for (auto& entry : session.env_transes()) {
+                SessionConstraint& sc { entry.second };
+                engine.push(sc.cu, time - 1, abs(groups[sc.index]));
+            }
+            for (auto& entry : session.env_invars()) {
+                SessionConstraint& sc { entry.second };
+                engine.push(sc.cu, time, abs(groups[sc.index]));
+            }
+        };
+
+        if (!session.initialized()) {
+            assert_fsm_init(engine, 0, sat::MAINGROUP, false);
+            assert_fsm_invar(engine, 0, sat::MAINGROUP, false);
+            session.set_initialized();
+        }
+
+        /* environment constraints no longer there are disabled, new
+           ones are added as new groups over all the frames unrolled
+           so far */
+        bool relaxed { false };
+        auto sync_env = [this, &engine, &groups, &session, &relaxed](
+            fsm_section_t kind, SessionConstraints& scs) {
+            for (auto& entry : scs) {
+                const EnvConstraints& ecs { this->env_constraints() };
+                bool enabled {
+                    std::any_of(begin(ecs), end(ecs),
+                                [kind, &entry](const EnvConstraint& ec) {
+                                    return kind == ec.kind && entry.first == ec.body;
+                                })
+                };
+
+                sat::group_t& group { groups[entry.second.index] };
+                if (enabled != (0 < group)) {
+                    relaxed |= !enabled;
+                    group = -group;
+                }
+            }
+
+            for (const auto& ec : this->env_constraints()) {
+                if (kind != ec.kind || scs.end() != scs.find(ec.body)) {
+                    continue;
+                }
+
+                SessionConstraint sc { ec.cu, SECTION_INIT != kind, 0 };
+                sat::group_t group { engine.new_group() };
+                sc.index = groups.size() - 1;
+
+                if (SECTION_INIT == kind) {
+                    engine.push(sc.cu, 0, group);
+                } else if (SECTION_INVAR == kind) {
+                    for (step_t time = 0; time <= session.depth(); ++time) {
+                        engine.push(sc.cu, time, group);
+                    }
+                } else {
+                    for (step_t time = 0; time < session.depth(); ++time) {
+                        engine.push(sc.cu, time, group);
+                    }
+                }
+
+                scs.insert(std::make_pair(ec.body, sc));
+            }
+        };
+
+        sync_env(SECTION_INIT, session.env_inits());
+        sync_env(SECTION_INVAR, session.env_invars());
+        sync_env(SECTION_TRANS, session.env_transes());
+
+        /* constraints not given to this command are disabled, which
+           invalidates all unreachability results so far */
+        for (auto& entry : constraints) {
+            bool enabled {
+                f_constraints.end() !=
+                std::find(begin(f_constraints), end(f_constraints), entry.first)
+            };
+
+            sat::group_t& group { groups[entry.second.index] };
+            if (enabled != (0 < group)) {
+                relaxed |= !enabled;
+                group = -group;
+            }
+        }
+
+        /* new constraints are added as new groups, over all the
+           frames unrolled so far */
+        for (expr::Expr_ptr constraint : f_constraints) {
+            if (constraints.end() != constraints.find(constraint)) {
+                continue;
+            }
+
+            expr::time::Analyzer eta { em() };
+            eta.process(constraint);
+
+            /* if backward time made it up to this point, something went wrong */
+            assert(!eta.has_backward_time());
+
+            auto i { f_constraint_cus.find(constraint) };
+            assert(f_constraint_cus.end() != i);
+
+            SessionConstraint sc { i->second, !eta.has_forward_time(), 0 };
+            sat::group_t group { engine.new_group() };
+            sc.index = groups.size() - 1;
+
+            if (sc.global) {
+                for (step_t time = 0; time <= session.depth(); ++time) {
+                    assert_formula(engine, time, sc.cu, group);
+                }
+            } else {
+                assert_formula(engine, 0, sc.cu, group);
+            }
+
+            constraints.insert(std::make_pair(constraint, sc));
+        }
+
+        if (relaxed) {
+            session.reset_checked();
+        }
+
+        step_t k { session.checked(f_target) };
+
+        if (0 == k) {
+            engine.set_step(k);
+            sat::status_t status { engine.solve() };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "Empty initial states. Target is trivially UNREACHABLE."
+                    << std::endl;
+
+                sync_set_status(REACHABILITY_UNREACHABLE);
+                goto cleanup;
+            }
+        }
+
+        else {
+            step_t depth { session.depth() };
+            INFO
+                << "Resuming session (k = " << k << ", "
+                << depth << " steps unrolled)..."
+                << std::endl;
+        }
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            /* unrolling next, up to k */
+            while (session.depth() < k) {
+                step_t t { session.depth() };
+
+                assert_fsm_trans(engine, t, sat::MAINGROUP, false);
+                assert_fsm_invar(engine, t + 1, sat::MAINGROUP, false);
+                assert_frame(t + 1);
+
+                session.set_depth(t + 1);
+            }
+
+            /* looking for witness : Reachability(k-1) ^ ! P(k) */
+            Var assumption { engine.new_sat_var(true) };
+            assert_formula(engine, k, target_cu, assumption);
+
+            vec<Lit> assumptions;
+            assumptions.push(mkLit(assumption));
+
+            INFO
+                << "Now looking for reachability witness (k = " << k << ")..."
+                << std::endl;
+
+            engine.set_step(k);
+            sat::status_t status { engine.solve(assumptions) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "Reachability witness exists (k = " << k << "), target `"
+                    << f_target
+                    << "` is REACHABLE."
+                    << std::endl;
+
+                if (sync_set_status(REACHABILITY_REACHABLE)) {
+                    /* Extract reachability witness */
+                    witness::Witness& w {
+                        *new ReachabilityCounterExample(f_target, model(), engine, k)
+                    };
+
+                    /* witness identifier */
+                    std::ostringstream oss_id;
+                    oss_id
+                        << reach_trace_prfx
+                        << wm.autoincrement();
+                    w.set_id(oss_id.str());
+
+                    /* witness description */
+                    std::ostringstream oss_desc;
+                    oss_desc
+                        << "Reachability witness for target `"
+                        << f_target
+                        << "` in module `"
+                        << model().main_module().name()
+                        << "`";
+                    w.set_desc(oss_desc.str());
+
+                    wm.record(w);
+                    wm.set_current(w);
+                    set_witness(w);
+                }
+
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No reachability witness found (k = " << k << ")..."
+                    << std::endl;
+
+                /* the assumption is retired for good */
+                vec<Lit> ps;
+                ps.push(mkLit(assumption, true));
+                engine.add_clause(ps);
+
+                session.set_checked(f_target, ++k);
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+        } while (sync_status() == REACHABILITY_UNKNOWN);
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        cancel();
+
+        INFO
+            << engine
+            << std::endl;
+    } /* Reachability::session_strategy() */
+
+} // namespace reach
@@ -0,0 +1,194 @@
+/**
+ * @file reach/session.hh
+ * @brief Persistent reachability sessions.
+ *
+ * This module contains the declarations of persistent reachability
+ * sessions. A session keeps a SAT engine and its forward unrolling
+ * alive across `reach` commands on the same model, so that a later
+ * command resumes from the depth reached by the previous one instead
+ * of starting over. Constraints are kept in groups of their own:
+ * constraints given by a later command are added as new groups,
+ * those it does not mention are disabled (and may be enabled again
+ * by a later command).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef REACHABILITY_SESSION_H
+#define REACHABILITY_SESSION_H
+
+#include <expr/expr.hh>
+
+#include <compiler/compiler.hh>
+
+#include <model/model.hh>
+
+#include <sat/sat.hh>
+
+#include <utils/context.hh>
+#include <utils/pool.hh>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace reach {
+
+    /* a constraint asserted in the session's engine: timed
+       constraints are asserted once, global ones at every frame */
+    struct SessionConstraint {
+        compiler::Unit cu;
+        bool global;
+
+        /* index of the constraint's group in the engine's groups */
+        int index;
+    };
+
+    using SessionConstraints =
+        boost::unordered_map<expr::Expr_ptr, SessionConstraint,
+                             utils::PtrHash, utils::PtrEq>;
+
+    class Session;
+    typedef Session* Session_ptr;
+
+    class Session {
+    public:
+        Session(model::Model& model);
+        ~Session();
+
+        inline model::Model& model() const
+        {
+            return f_model;
+        }
+
+        inline sat::Engine& engine()
+        {
+            return f_engine;
+        }
+
+        /* held by the strategy using the session, for the whole run */
+        inline boost::mutex& mutex()
+        {
+            return f_mutex;
+        }
+
+        /* true iff INIT has been asserted at time 0 */
+        inline bool initialized() const
+        {
+            return f_initialized;
+        }
+
+        inline void set_initialized()
+        {
+            f_initialized = true;
+        }
+
+        /* frames 0, .., depth() are unrolled */
+        inline step_t depth() const
+        {
+            return f_depth;
+        }
+
+        inline void set_depth(step_t depth)
+        {
+            f_depth = depth;
+        }
+
+        inline SessionConstraints& constraints()
+        {
+            return f_constraints;
+        }
+
+        /* extra constraints of the environment, by kind. The model's
+           FSM is asserted without them */
+        inline SessionConstraints& env_inits()
+        {
+            return f_env_inits;
+        }
+
+        inline SessionConstraints& env_invars()
+        {
+            return f_env_invars;
+        }
+
+        inline SessionConstraints& env_transes()
+        {
+            return f_env_transes;
+        }
+
+        /* smallest depth target has not been checked at (i.e. it is
+           unreachable in less steps), zero for any other target */
+        step_t checked(expr::Expr_ptr target) const;
+        void set_checked(expr::Expr_ptr target, step_t depth);
+
+        /* forget about checked depths, e.g. when constraints have
+           been relaxed */
+        void reset_checked();
+
+        /* the constraints asserted so far, and the target, are live */
+        void mark(expr::ExprMarker& marker) const;
+
+    private:
+        model::Model& f_model;
+
+        sat::Engine f_engine;
+        boost::mutex f_mutex;
+
+        bool f_initialized;
+        step_t f_depth;
+
+        SessionConstraints f_constraints;
+
+        SessionConstraints f_env_inits;
+        SessionConstraints f_env_invars;
+        SessionConstraints f_env_transes;
+
+        expr::Expr_ptr f_target;
+        step_t f_checked;
+    };
+
+    typedef class SessionMgr* SessionMgr_ptr;
+
+    class SessionMgr {
+    public:
+        /* the session for model, created if needed. Sessions for
+           other models are dropped */
+        Session& session(model::Model& model);
+
+        /* drops the current session (if any), e.g. when a new model
+           is read */
+        void clear();
+
+        static SessionMgr& INSTANCE()
+        {
+            return utils::Context::current().instance<SessionMgr>(
+                utils::CONTEXT_REACH_SESSIONS, []() { return new SessionMgr(); });
+        }
+
+    protected:
+        SessionMgr();
+        ~SessionMgr();
+
+    private:
+        boost::mutex f_mutex;
+        Session_ptr f_session;
+    };
+
+} // namespace reach
+
+#endif /* REACHABILITY_SESSION_H */
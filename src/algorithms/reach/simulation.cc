@@ -0,0 +1,182 @@
+/**
+ * @file reach/simulation.cc
+ * @brief Simulation-based reachability strategy, for shallow targets.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <ctime>
+
+#include <algorithms/lanes.hh>
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+
+#include <opts/opts_mgr.hh>
+
+/* max size of the FSM BDDs for simulation */
+static const int simulation_node_limit { 1 << 20 };
+
+/* steps of a round, all lanes restart from random initial states
+   past it */
+static const step_t simulation_max_depth { 256 };
+
+/* rounds, a target not hit by then is left to the other strategies */
+static const unsigned simulation_max_rounds { 1024 };
+
+namespace reach {
+
+    /* Rounds of 64 random simulations at once, on the BDDs of the FSM
+     * (see lanes.hh), global constraints restricted to all states. The
+     * target is evaluated on each state reached: on a hit, the path of
+     * the lane is replayed on SAT, which only needs propagation, and
+     * the other strategies are cancelled. Simulation never proves the
+     * target unreachable. */
+    void Reachability::simulation_strategy(compiler::Unit& target_cu)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+
+        if (!target_cu.inlined_operator_descriptors().empty() ||
+            !target_cu.binary_selection_descriptors_map().empty() ||
+            !target_cu.array_mux_descriptors().empty() ||
+            !target_cu.aig_descriptors().empty()) {
+            INFO
+                << "Target is not a plain DD, simulation is not available"
+                << std::endl;
+
+            return;
+        }
+
+        std::vector<int> state;
+        std::vector<int> next;
+        fsm_state_bits(state, next);
+
+        algorithms::LaneSimulator_ptr lanes { NULL };
+        algorithms::LaneProgram* target { NULL };
+        {
+            /* other strategies share the FSM manager */
+            boost::recursive_mutex::scoped_lock lock { bm.mutex() };
+
+            unsigned long seed {
+                opts::OptsMgr::INSTANCE().deterministic() ? 0UL : (unsigned long) time(NULL)
+            };
+            lanes = make_lane_simulator(f_global_cus, simulation_node_limit, seed);
+
+            BDD bdd { bm.dd().bddOne() };
+            for (const auto& dd : target_cu.dds()) {
+                bdd &= dd.BddPattern();
+            }
+
+            /* the target is evaluated on the current state only */
+            bool current { true };
+            for (auto index : bdd.SupportIndices()) {
+                current = current && state.end() != std::find(state.begin(), state.end(), (int) index);
+            }
+
+            if (NULL != lanes && current) {
+                target = new algorithms::LaneProgram(bdd);
+            }
+        }
+
+        if (NULL == target) {
+            INFO
+                << "FSM or target can not be simulated, simulation is not available"
+                << std::endl;
+
+            delete lanes;
+            return;
+        }
+
+        /* the state bits on each lane, by step */
+        std::vector<std::vector<algorithms::lanes_t>> history;
+        algorithms::lanes_t hit { 0 };
+        unsigned round;
+        for (round = 0; round < simulation_max_rounds && !hit; ++round) {
+            if (REACHABILITY_UNKNOWN != sync_status() || cancelled() || limits_exceeded()) {
+                break;
+            }
+
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            history.clear();
+            algorithms::lanes_t alive { lanes->initialize() };
+            for (step_t k = 0; alive; ++k) {
+                std::vector<algorithms::lanes_t> values;
+                for (auto index : state) {
+                    values.push_back(lanes->value(index));
+                }
+                history.push_back(values);
+
+                hit = target->eval(lanes->values()) & alive;
+                if (hit || simulation_max_depth == k) {
+                    break;
+                }
+
+                alive = lanes->step();
+            }
+        }
+
+        delete target;
+        delete lanes;
+
+        if (!hit) {
+            INFO
+                << "Simulation did not hit target `"
+                << f_target
+                << "` in "
+                << round
+                << " rounds"
+                << std::endl;
+
+            return;
+        }
+
+        unsigned lane { 0 };
+        while (!((hit >> lane) & 1)) {
+            ++lane;
+        }
+
+        std::vector<std::vector<bool>> path;
+        for (const auto& values : history) {
+            std::vector<bool> bits;
+            for (auto value : values) {
+                bits.push_back(0 != ((value >> lane) & 1));
+            }
+
+            path.push_back(bits);
+        }
+
+        step_t k { (step_t) path.size() - 1 };
+        INFO
+            << "Simulation hit target `"
+            << f_target
+            << "` (k = "
+            << k
+            << ", round "
+            << round
+            << ", lane "
+            << lane
+            << ")"
+            << std::endl;
+
+        path_witness("simulation", target_cu, state, path);
+    }
+
+} // namespace reach
@@ -0,0 +1,165 @@
+/**
+ * @file reach/smt.cc
+ * @brief Word-level SMT reachability strategy implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithms/reach/reach.hh>
+#include <algorithms/scheduler.hh>
+#include <algorithms/smt.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <witness/witness.hh>
+
+namespace reach {
+
+    /* BMC on an external SMT solver: the FSM is unrolled at the word
+     * level, one frame at a time as in the forward strategy. The
+     * target of each k is asserted in a scope of its own, popped when
+     * there is no witness. Global constraints hold in every frame. */
+    void Reachability::smt_strategy()
+    {
+        algorithms::SmtUnrolling unrolling {
+            model(), opts::OptsMgr::INSTANCE().smt_solver()
+        };
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        step_t k { 0 };
+
+        if (!unrolling.start([this]() {
+                return cancelled() || REACHABILITY_UNKNOWN != sync_status();
+            })) {
+            return;
+        }
+
+        /* initial constraints */
+        if (!unrolling.assert_init(k) || !unrolling.assert_invar(k)) {
+            goto cleanup;
+        }
+        for (auto constraint : f_constraints) {
+            if (!unrolling.assert_formula(ctx, constraint, k)) {
+                goto cleanup;
+            }
+        }
+
+        do {
+            /* give way to waiting strategies, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            if (!unrolling.push() || !unrolling.assert_formula(ctx, f_target, k)) {
+                goto cleanup;
+            }
+
+            INFO
+                << "Now looking for SMT reachability witness (k = " << k << ")..."
+                << std::endl;
+
+            sat::status_t status { unrolling.check() };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_SAT == status) {
+                INFO
+                    << "SMT reachability witness exists (k = " << k << "), target `"
+                    << f_target
+                    << "` is REACHABLE."
+                    << std::endl;
+
+                std::vector<step_t> times;
+                for (step_t j = 0; j <= k; ++j) {
+                    times.push_back(j);
+                }
+
+                witness::Witness& w { *new witness::Witness() };
+                if (!unrolling.extract(w, times)) {
+                    WARN
+                        << "Could not extract SMT witness (k = " << k << ")"
+                        << std::endl;
+
+                    delete &w;
+                    goto cleanup;
+                }
+
+                if (sync_set_status(REACHABILITY_REACHABLE)) {
+                    record_witness(w);
+                } else {
+                    delete &w;
+                }
+
+                goto cleanup;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                INFO
+                    << "No SMT reachability witness found (k = " << k << ")..."
+                    << std::endl;
+
+                if (!unrolling.pop()) {
+                    goto cleanup;
+                }
+
+                /* all simple paths have been searched */
+                if (f_threshold <= k) {
+                    INFO
+                        << "Diameter reached (k = " << k << "), target `"
+                        << f_target
+                        << "` is UNREACHABLE."
+                        << std::endl;
+
+                    sync_set_status(REACHABILITY_UNREACHABLE);
+                    goto cleanup;
+                }
+            }
+
+            else {
+                assert(false); /* unreachable */
+            }
+
+            /* unrolling next */
+            if (!unrolling.assert_trans(k)) {
+                goto cleanup;
+            }
+            ++k;
+            if (!unrolling.assert_invar(k)) {
+                goto cleanup;
+            }
+            for (auto constraint : f_constraints) {
+                if (!unrolling.assert_formula(ctx, constraint, k)) {
+                    goto cleanup;
+                }
+            }
+
+            TRACE
+                << "Done with k = " << k << "..."
+                << std::endl;
+
+        } while (sync_status() == REACHABILITY_UNKNOWN);
+
+    cleanup:
+        /* signal sibling strategies it's time to go home */
+        if (REACHABILITY_UNKNOWN != sync_status()) {
+            cancel();
+        }
+    } /* Reachability::smt_strategy() */
+
+} // namespace reach
@@ -29,110 +29,54 @@
 #include <algorithms/reach/reach.hh>
 #include <algorithms/reach/witness.hh>
 
-#include <symb/symb_iter.hh>
-
+#include <witness/decoder.hh>
 #include <witness/witness.hh>
 #include <witness/witness_mgr.hh>
 
+#include <utils/profile.hh>
+#include <utils/trace.hh>
+
 namespace reach {
 
+    /* times of a path of length k, either forward (0, .., k) or
+       backward (UINT_MAX - k, .., UINT_MAX) */
+    static std::vector<step_t> path_times(unsigned k, bool reversed)
+    {
+        std::vector<step_t> res;
+        for (step_t j = 0; j <= k; ++j) {
+            res.push_back(reversed ? UINT_MAX - (k - j) : j);
+        }
+
+        return res;
+    }
+
     ReachabilityCounterExample::ReachabilityCounterExample(
         expr::Expr_ptr property, model::Model& model,
         sat::Engine& engine, unsigned k, bool reversed)
+        : ReachabilityCounterExample(property, model, engine, path_times(k, reversed))
+    {}
+
+    ReachabilityCounterExample::ReachabilityCounterExample(
+        expr::Expr_ptr property, model::Model& model,
+        sat::Engine& engine, const std::vector<step_t>& times)
         : Witness()
     {
-        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
-        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
-        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
-
-        /* Collecting symbols for the witness' language */
-        symb::SymbIter si { model };
-        while (si.has_next()) {
-            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
-            expr::Expr_ptr ctx { pair.first };
-            symb::Symbol_ptr symb { pair.second };
-            expr::Expr_ptr full_name { em.make_dot(ctx, symb->name()) };
+        utils::ProfileScope scope { "witness" };
+        utils::TraceScope trace { "extract", "witness" };
 
-            f_lang.push_back(full_name);
-        }
+        /* only the bits of the model are captured here, symbols are
+           decoded on first access */
+        boost::shared_ptr<witness::ModelDecoder> decoder {
+            new witness::ModelDecoder(*this, model, true)
+        };
 
-        step_t step { reversed ? k : 0 };
-        do {
+        for (step_t time : times) {
             witness::TimeFrame& tf { extend() };
-            symb::SymbIter symbols { model };
-
-            while (symbols.has_next()) {
-                std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
-                expr::Expr_ptr ctx { pair.first };
-                symb::Symbol_ptr symb { pair.second };
-                expr::Expr_ptr symb_name { symb->name() };
-                expr::Expr_ptr key { em.make_dot(ctx, symb_name) };
-
-                if (symb->is_variable()) {
-                    symb::Variable& var { symb->as_variable() };
 
-                    /* time it, and fetch encoding for enc mgr */
-                    enc::Encoding_ptr enc {
-                        bm.find_encoding(
-                            expr::TimedExpr(key, var.is_frozen()
-                                                     ? FROZEN
-                                                     : 0))
-                    };
-
-                    if (!enc) {
-                        continue;
-                    }
-
-                    int inputs[bm.nbits()];
-                    memset(inputs, 0, sizeof(inputs));
-
-                    /* 1. for each bit int the encoding, fetch UCBI,
-                     * time it into TCBI, fetch its value in MiniSAT
-                     * model and set the corresponding entry in
-                     * input. */
-                    dd::DDVector::const_iterator di;
-                    unsigned ndx;
-                    for (ndx = 0, di = enc->bits().begin();
-                         enc->bits().end() != di; ++ndx, ++di) {
-
-                        unsigned bit((*di).getNode()->index);
-                        const enc::UCBI& ucbi { bm.find_ucbi(bit) };
-                        const enc::TCBI tcbi {
-                            enc::TCBI(ucbi, reversed ? UINT_MAX - step : step)
-                        };
-
-                        Var var { engine.tcbi_to_var(tcbi) };
-                        int value { engine.value(var) }; /* XXX: don't cares assigned to 0 */
-
-                        inputs[bit] = value;
-                    }
-
-                    /* 2. eval the encoding DDs with inputs and put
-                     * resulting value into time frame container. */
-                    expr::Expr_ptr value { enc->expr(inputs) };
-
-                    /* NULL values here indicate UNDEFs */
-                    if (value) {
-                        tf.set_value(key, value, symb->format());
-                    }
-                }
-
-                else if (symb->is_define()) {
-                    const symb::Define& define { symb->as_define() };
-                    expr::Expr_ptr value { wm.eval(*this, ctx, define.body(), 0) };
-
-                    /* NULL values here indicate UNDEFs */
-                    if (value) {
-                        tf.set_value(key, value, symb->format());
-                    }
-                }
-            }
-
-            step += reversed ? -1 : 1;
-            if ((reversed && step == UINT_MAX) || (!reversed && step > k)) {
-                break;
-            }
-        } while (1);
+            std::vector<bool> bits;
+            decoder->capture(engine, time, bits);
+            tf.set_lazy(decoder, bits);
+        }
     } /* ReachabilityCounterExample::ReachabilityCounterExample() */
 
 } // namespace reach
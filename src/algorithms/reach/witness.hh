@@ -39,6 +39,10 @@ namespace reach {
     public:
         ReachabilityCounterExample(expr::Expr_ptr property, model::Model& model, sat::Engine& engine,
                                    unsigned k, bool reversed = false);
+
+        /* time frames are taken from `times`, in order */
+        ReachabilityCounterExample(expr::Expr_ptr property, model::Model& model, sat::Engine& engine,
+                                   const std::vector<step_t>& times);
     };
 
 } // namespace reach
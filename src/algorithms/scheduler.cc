@@ -0,0 +1,598 @@
+/**
+ * @file algorithms/scheduler.cc
+ * @brief Strategy scheduler class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithms/scheduler.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/context.hh>
+#include <utils/logging.hh>
+
+namespace algorithms {
+
+    struct Scheduler::Batch {
+        Relevance relevant;
+        unsigned pending;
+
+        std::vector<Job>* jobs;
+
+        /* the context of the caller, strategies run in it */
+        utils::Context* context;
+    };
+
+    /* Jobs which have not started yet are granted slots first, by
+     * priority. Running jobs give way at yield points, and get their
+     * slot back in round robin order: higher priority ones give way
+     * less often (every 2^priority yield points).
+     *
+     * Strategies report the steps they are at. The time a step takes
+     * (holding a slot) is projected from the last two: a job whose
+     * next step is projected to take --lag-factor times longer than
+     * the fastest one of its batch is lagging. Lagging jobs give way
+     * at every yield point, and get a slot only when no other job is
+     * waiting for it, i.e. they are suspended as long as the others
+     * keep the slots busy. As theirs is the time holding a slot, the
+     * projections of suspended jobs stay put while the others grow,
+     * and they are resumed eventually. */
+    struct Scheduler::Job {
+        Task task;
+        Batch* batch;
+
+        bool started;
+        unsigned long ticket;
+        unsigned credits;
+
+        bool done;
+
+        /* time holding a slot, up to slot_since if holding one */
+        bool holding;
+        double slot_since;
+        double run_secs;
+
+        /* steps completed, the run time when the current one began,
+           and the time taken by the last two */
+        bool progressed;
+        step_t step;
+        unsigned steps_done;
+        double step_since;
+        double last_step_secs;
+        double prev_step_secs;
+
+        bool lagging;
+        bool lagged;
+    };
+
+    /* steps this fast are never lagging, whatever the others */
+    static const double min_lag_secs { 1.0 };
+
+    static double now_secs()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return now.tv_sec + now.tv_nsec / 1e9;
+    }
+
+    /* the cores in a cpulist, e.g. `0-3,8-11` */
+    static std::vector<int> parse_cpulist(const std::string& cpulist)
+    {
+        std::vector<int> res;
+
+        std::istringstream iss { cpulist };
+        std::string range;
+        while (std::getline(iss, range, ',')) {
+            int first;
+            int last;
+            char dash;
+
+            std::istringstream ris { range };
+            if (!(ris >> first)) {
+                continue;
+            }
+            last = (ris >> dash >> last && '-' == dash) ? last : first;
+
+            for (int cpu = first; cpu <= last; ++cpu) {
+                res.push_back(cpu);
+            }
+        }
+
+        return res;
+    }
+
+    /* the cores the process may run on, by NUMA node (see
+       sysfs(5)), a single node if the topology is not known */
+    static std::vector<std::vector<int>> numa_cores()
+    {
+        std::vector<std::vector<int>> res;
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (0 != sched_getaffinity(0, sizeof(allowed), &allowed)) {
+            return res;
+        }
+
+        std::vector<int> all;
+        for (int node = 0; ; ++node) {
+            std::ostringstream path;
+            path
+                << "/sys/devices/system/node/node"
+                << node
+                << "/cpulist";
+
+            std::ifstream is { path.str().c_str() };
+            std::string cpulist;
+            if (!is || !std::getline(is, cpulist)) {
+                break;
+            }
+
+            std::vector<int> cores;
+            for (int cpu : parse_cpulist(cpulist)) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                    cores.push_back(cpu);
+                    all.push_back(cpu);
+                }
+            }
+
+            if (!cores.empty()) {
+                res.push_back(cores);
+            }
+        }
+
+        if (res.empty()) {
+            std::vector<int> cores;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cores.push_back(cpu);
+                }
+            }
+
+            if (!cores.empty()) {
+                res.push_back(cores);
+            }
+        }
+
+        return res;
+    }
+
+    boost::thread_specific_ptr<Scheduler::Job> Scheduler::f_current { [](Job*) {} };
+
+    Scheduler::Scheduler()
+        : f_slots(opts::OptsMgr::INSTANCE().threads())
+        , f_running(0)
+        , f_tickets(0)
+        , f_idle(0)
+    {
+        if (0 == f_slots) {
+            f_slots = std::max(1U, boost::thread::hardware_concurrency());
+        }
+
+        /* strategies take turns, at yield points and between the
+           slices of their SAT calls */
+        if (opts::OptsMgr::INSTANCE().cooperative()) {
+            f_slots = 1;
+        }
+
+        /* compact fills one node after the other, scatter takes
+           one core of each node in turn */
+        const std::string affinity { opts::OptsMgr::INSTANCE().thread_affinity() };
+        if ("compact" == affinity || "scatter" == affinity) {
+            std::vector<std::vector<int>> nodes { numa_cores() };
+
+            if ("compact" == affinity) {
+                for (const auto& cores : nodes) {
+                    f_placement.insert(f_placement.end(), cores.begin(), cores.end());
+                }
+            } else {
+                for (unsigned i = 0; ; ++i) {
+                    bool more { false };
+                    for (const auto& cores : nodes) {
+                        if (i < cores.size()) {
+                            f_placement.push_back(cores[i]);
+                            more = true;
+                        }
+                    }
+
+                    if (!more) {
+                        break;
+                    }
+                }
+            }
+
+            unsigned n_nodes { (unsigned) nodes.size() };
+            unsigned n_cores { (unsigned) f_placement.size() };
+            DEBUG
+                << "Strategy threads pinned to "
+                << n_cores
+                << " cores on "
+                << n_nodes
+                << " NUMA nodes ("
+                << affinity
+                << ")"
+                << std::endl;
+        } else if ("none" != affinity) {
+            WARN
+                << "Unknown thread affinity `"
+                << affinity
+                << "`, threads are not pinned"
+                << std::endl;
+        }
+
+        const void* instance { this };
+        unsigned slots { f_slots };
+        DRIVEL
+            << "Initialized Scheduler @ " << instance
+            << " (" << slots << " slots)"
+            << std::endl;
+    }
+
+    Scheduler::~Scheduler()
+    {
+        const void* instance { this };
+
+        DRIVEL
+            << "Destroyed Scheduler @ "
+            << instance
+            << std::endl;
+    }
+
+    void Scheduler::run(const Tasks& tasks, Relevance relevant,
+                        TaskStatsVector* stats)
+    {
+        std::vector<Job> jobs;
+
+        Batch batch;
+        batch.relevant = relevant;
+        batch.pending = tasks.size();
+        batch.jobs = &jobs;
+        batch.context = &utils::Context::current();
+
+        jobs.reserve(tasks.size());
+        for (const auto& task : tasks) {
+            Job job { task, &batch, false, 0, 0 };
+            jobs.push_back(job);
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        for (auto& job : jobs) {
+            f_jobs.push_back(&job);
+        }
+
+        /* every job needs a stack of its own, as it may be preempted */
+        while (f_idle < f_jobs.size()) {
+            f_workers.push_back(new boost::thread(&Scheduler::worker, this,
+                                                  (unsigned) f_workers.size()));
+            ++f_idle;
+        }
+        f_job_ready.notify_all();
+
+        /* a strategy running a batch of its own (e.g. parallel cubes)
+           gives up its slot while waiting, so that the batch can not
+           starve for slots */
+        Job* current { f_current.get() };
+        if (current) {
+            release(*current, lock);
+        }
+
+        while (0 < batch.pending) {
+            f_batch_done.wait(lock);
+        }
+
+        if (current) {
+            acquire(*current, lock);
+        }
+
+        if (stats) {
+            for (const auto& job : jobs) {
+                TaskStats entry { job.task.name, job.step, job.run_secs, job.lagged };
+                stats->push_back(entry);
+            }
+        }
+    }
+
+    void Scheduler::worker(unsigned index)
+    {
+        /* engines are allocated by the strategies running on this
+           thread, first touch keeps them on its NUMA node */
+        if (!f_placement.empty()) {
+            int core { f_placement[index % f_placement.size()] };
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            if (0 != pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+                WARN
+                    << "Could not pin worker "
+                    << index
+                    << " to core "
+                    << core
+                    << std::endl;
+            }
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        while (true) {
+            while (f_jobs.empty()) {
+                f_job_ready.wait(lock);
+            }
+
+            Job& job { *f_jobs.front() };
+            f_jobs.pop_front();
+            --f_idle;
+
+            lock.unlock();
+            bool relevant { job.batch->relevant() };
+            lock.lock();
+
+            if (relevant) {
+                acquire(job, lock);
+                job.started = true;
+                job.credits = 1U << job.task.priority;
+                f_current.reset(&job);
+
+                DEBUG
+                    << "Starting strategy `"
+                    << job.task.name
+                    << "`"
+                    << std::endl;
+
+                lock.unlock();
+
+                /* log lines are tagged with the strategy */
+                utils::Logger& logger { utils::Logger::INSTANCE() };
+                std::string tag { logger.tag() };
+                logger.set_tag(job.task.name);
+
+                {
+                    utils::ContextScope scope { *job.batch->context };
+                    job.task.strategy();
+                }
+
+                logger.set_tag(tag);
+                lock.lock();
+
+                f_current.reset();
+                job.done = true;
+                release(job, lock);
+            }
+
+            else {
+                DEBUG
+                    << "Skipping strategy `"
+                    << job.task.name
+                    << "`"
+                    << std::endl;
+            }
+
+            if (0 == --job.batch->pending) {
+                f_batch_done.notify_all();
+            }
+
+            ++f_idle;
+        }
+    }
+
+    void Scheduler::yield()
+    {
+        Job* job { f_current.get() };
+        if (!job) {
+            return;
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (0 < --job->credits) {
+            return;
+        }
+
+        /* no progress is news, too */
+        evaluate(*job->batch);
+        job->credits = job->lagging ? 1U : 1U << job->task.priority;
+
+        if (f_waiting.empty()) {
+            return;
+        }
+
+        release(*job, lock);
+        acquire(*job, lock);
+    }
+
+    void Scheduler::progress(step_t step)
+    {
+        Job* job { f_current.get() };
+        if (!job) {
+            return;
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        double run_secs { job->run_secs };
+        if (job->holding) {
+            run_secs += now_secs() - job->slot_since;
+        }
+
+        if (!job->progressed) {
+            job->progressed = true;
+            job->step = step;
+            job->step_since = run_secs;
+            return;
+        }
+
+        if (step <= job->step) {
+            return;
+        }
+
+        job->prev_step_secs = job->last_step_secs;
+        job->last_step_secs = run_secs - job->step_since;
+        ++job->steps_done;
+
+        job->step = step;
+        job->step_since = run_secs;
+
+        evaluate(*job->batch);
+    }
+
+    void Scheduler::evaluate(Batch& batch)
+    {
+        unsigned factor { opts::OptsMgr::INSTANCE().lag_factor() };
+        if (0 == factor) {
+            return;
+        }
+
+        double now { now_secs() };
+
+        /* projected time to the next step, for the jobs with at least
+           two steps done. A step taking longer than projected so far
+           counts as it is */
+        std::vector<std::pair<Job*, double>> projections;
+        for (auto& job : *batch.jobs) {
+            if (!job.started || job.done || job.steps_done < 2) {
+                continue;
+            }
+
+            double run_secs { job.run_secs };
+            if (job.holding) {
+                run_secs += now - job.slot_since;
+            }
+
+            double growth { 0 < job.prev_step_secs
+                                ? std::max(1.0, job.last_step_secs / job.prev_step_secs)
+                                : 1.0 };
+
+            double projection { std::max(job.last_step_secs * growth,
+                                         run_secs - job.step_since) };
+            projections.push_back(std::make_pair(&job, projection));
+        }
+
+        if (projections.size() < 2) {
+            return;
+        }
+
+        double fastest { projections[0].second };
+        for (const auto& projection : projections) {
+            fastest = std::min(fastest, projection.second);
+        }
+
+        bool changed { false };
+        for (const auto& projection : projections) {
+            Job& job { *projection.first };
+
+            bool lagging { min_lag_secs < projection.second &&
+                           factor * fastest < projection.second };
+            if (lagging == job.lagging) {
+                continue;
+            }
+
+            DEBUG
+                << "Strategy `"
+                << job.task.name
+                << (lagging ? "` is falling behind" : "` is catching up")
+                << " (next step in about "
+                << projection.second
+                << "s)"
+                << std::endl;
+
+            job.lagging = lagging;
+            job.lagged = job.lagged || lagging;
+            changed = true;
+        }
+
+        /* waiting jobs may go first now */
+        if (changed) {
+            f_slot_ready.notify_all();
+        }
+    }
+
+    std::string Scheduler::current_task() const
+    {
+        const Job* job { f_current.get() };
+        return job ? job->task.name : std::string();
+    }
+
+    bool Scheduler::is_next(const Job& job) const
+    {
+        for (const Job* other : f_waiting) {
+            if (other == &job) {
+                continue;
+            }
+
+            bool precedes;
+            if (other->lagging != job.lagging) {
+                precedes = job.lagging;
+            } else if (other->started != job.started) {
+                precedes = !other->started;
+            } else if (!job.started && other->task.priority != job.task.priority) {
+                precedes = other->task.priority > job.task.priority;
+            } else {
+                precedes = other->ticket < job.ticket;
+            }
+
+            if (precedes) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Scheduler::acquire(Job& job, boost::mutex::scoped_lock& lock)
+    {
+        job.ticket = f_tickets++;
+        f_waiting.push_back(&job);
+
+        while (f_slots <= f_running || !is_next(job)) {
+            f_slot_ready.wait(lock);
+        }
+
+        f_waiting.erase(std::find(f_waiting.begin(), f_waiting.end(), &job));
+        ++f_running;
+
+        job.holding = true;
+        job.slot_since = now_secs();
+
+        /* the next waiting job may fit in a free slot */
+        f_slot_ready.notify_all();
+    }
+
+    void Scheduler::release(Job& job, boost::mutex::scoped_lock& lock)
+    {
+        assert(0 < f_running);
+        --f_running;
+
+        job.holding = false;
+        job.run_secs += now_secs() - job.slot_since;
+
+        f_slot_ready.notify_all();
+    }
+
+}; // namespace algorithms
@@ -0,0 +1,175 @@
+/**
+ * @file algorithms/scheduler.hh
+ * @brief Strategy scheduler class declaration.
+ *
+ * This module contains the declaration of the scheduler the
+ * strategies of all algorithms run on. Strategies are run by a pool
+ * of worker threads, which is reused across commands. At most
+ * `--threads` strategies are running at any time: when more are
+ * ready, the others wait for a slot, highest priority first. Running
+ * strategies give way to waiting ones of no lower priority at yield
+ * points (between SAT calls), so that strategies outnumbering the
+ * slots are time-sliced rather than starved.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef ALGORITHMS_SCHEDULER_H
+#define ALGORITHMS_SCHEDULER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <common/time.hh>
+
+namespace algorithms {
+
+    typedef enum {
+        PRIORITY_LOW,
+        PRIORITY_NORMAL,
+        PRIORITY_HIGH,
+    } priority_t;
+
+    typedef boost::function<void()> Strategy;
+
+    /* false when the outcome of a batch is known, strategies not yet
+       started are skipped */
+    typedef boost::function<bool()> Relevance;
+
+    struct Task {
+        Task(const std::string& name, Strategy strategy,
+             priority_t priority = PRIORITY_NORMAL)
+            : name(name)
+            , strategy(strategy)
+            , priority(priority)
+        {}
+
+        std::string name;
+        Strategy strategy;
+        priority_t priority;
+    };
+
+    typedef std::vector<Task> Tasks;
+
+    /* how a task of a batch fared */
+    struct TaskStats {
+        std::string name;
+
+        /* the last step reported, and the time spent holding a slot */
+        step_t step;
+        double run_secs;
+
+        /* true iff it fell behind the others at some point */
+        bool lagged;
+    };
+
+    typedef std::vector<TaskStats> TaskStatsVector;
+
+    class Scheduler;
+    typedef Scheduler* Scheduler_ptr;
+
+    class Scheduler {
+    public:
+        /* runs all tasks, returns when all of them are done. May be
+           invoked by a running strategy, whose slot is released
+           meanwhile. When stats is given, the statistics of each task
+           are appended to it, in order */
+        void run(const Tasks& tasks, Relevance relevant,
+                 TaskStatsVector* stats = NULL);
+
+        /* time-slicing point for the calling strategy, a no-op if not
+           invoked by a strategy */
+        void yield();
+
+        /* the calling strategy is at step (e.g. it is solving at that
+           depth), a no-op if not invoked by a strategy. Strategies
+           falling behind the others of their batch are downweighted */
+        void progress(step_t step);
+
+        /* the name of the strategy run by the calling thread, empty if
+           none */
+        std::string current_task() const;
+
+        /* max number of running strategies, from program options */
+        inline unsigned slots() const
+        {
+            return f_slots;
+        }
+
+        static Scheduler& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static Scheduler_ptr instance { new Scheduler() };
+            return *instance;
+        }
+
+    protected:
+        Scheduler();
+        ~Scheduler();
+
+    private:
+        struct Batch;
+        struct Job;
+
+        /* the index-th worker, pinned to a core by --thread-affinity */
+        void worker(unsigned index);
+
+        /* slots are granted by priority, then in request order */
+        void acquire(Job& job, boost::mutex::scoped_lock& lock);
+        void release(Job& job, boost::mutex::scoped_lock& lock);
+        bool is_next(const Job& job) const;
+
+        /* tells the jobs of batch falling behind from the others */
+        void evaluate(Batch& batch);
+
+        /* the job run by the current thread (if any), not owned */
+        static boost::thread_specific_ptr<Job> f_current;
+
+        unsigned f_slots;
+        unsigned f_running;
+        unsigned long f_tickets;
+
+        /* jobs waiting for a worker, and for a slot */
+        std::deque<Job*> f_jobs;
+        std::vector<Job*> f_waiting;
+
+        /* workers are never destroyed, idle ones pick up new jobs */
+        std::vector<boost::thread*> f_workers;
+        unsigned f_idle;
+
+        /* the cores workers are pinned to, in turn (none if empty) */
+        std::vector<int> f_placement;
+
+        boost::mutex f_mutex;
+        boost::condition_variable f_job_ready;
+        boost::condition_variable f_slot_ready;
+        boost::condition_variable f_batch_done;
+    };
+
+}; // namespace algorithms
+
+#endif /* ALGORITHMS_SCHEDULER_H */
@@ -0,0 +1,874 @@
+/**
+ * @file concrete.cc
+ * @brief Explicit-state random and input-driven simulation, by
+ * concrete evaluation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <stack>
+
+#include <env/environment.hh>
+
+#include <sim/session.hh>
+#include <sim/simulation.hh>
+
+#include <symb/classes.hh>
+#include <symb/proxy.hh>
+#include <symb/symb_iter.hh>
+
+static const char* random_trace_prfx = "rsim-";
+
+namespace sim {
+
+    /* true iff expr can be evaluated by the witness evaluator, i.e. no
+       non-determinism and no parametric defines, defines included */
+    static bool is_concrete(expr::Expr_ptr ctx, expr::Expr_ptr expr)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        switch (expr->symb()) {
+            case expr::SET:
+            case expr::SET_COMMA:
+            case expr::PARAMS:
+            case expr::PARAMS_COMMA:
+            case expr::INTERVAL:
+            case expr::F:
+            case expr::G:
+            case expr::X:
+            case expr::U:
+            case expr::R:
+                return false;
+
+            case expr::IDENT: {
+                symb::ResolverProxy resolver;
+                symb::Symbol_ptr symb { resolver.symbol(em.make_dot(ctx, expr)) };
+
+                return !symb->is_define() ||
+                       is_concrete(ctx, symb->as_define().body());
+            }
+
+            case expr::QSTRING:
+            case expr::ICONST:
+            case expr::HCONST:
+            case expr::OCONST:
+            case expr::BCONST:
+            case expr::INSTANT:
+            case expr::UNDEF:
+                return true;
+
+            default:
+                return (NULL == expr->lhs() || is_concrete(ctx, expr->lhs())) &&
+                       (NULL == expr->rhs() || is_concrete(ctx, expr->rhs()));
+        }
+    }
+
+    /* `x := e`, `g ?: x := e`, `next(x) = e` or `g -> next(x) = e`
+       (e.g. synthesized inertial TRANSes), with x an identifier */
+    bool Simulation::classify_trans(expr::Expr_ptr ctx, expr::Expr_ptr body,
+                                    ConcreteTrans& res)
+    {
+        res.ctx = ctx;
+        res.guard = NULL;
+        res.lhs = NULL;
+        res.rhs = body;
+
+        expr::Expr_ptr action { body };
+        if (em().is_guard(body) || em().is_implies(body)) {
+            res.guard = body->lhs();
+            action = body->rhs();
+        }
+
+        expr::Expr_ptr lhs { NULL };
+        if (em().is_assignment(action)) {
+            lhs = action->lhs();
+        } else if (em().is_eq(action) && em().is_next(action->lhs())) {
+            lhs = action->lhs()->lhs();
+        }
+
+        if (NULL != lhs && em().is_identifier(lhs)) {
+            res.lhs = em().make_dot(ctx, lhs);
+            res.rhs = action->rhs();
+
+            /* a non-deterministic choice among the set elements */
+            if (em().is_set(res.rhs)) {
+                expr::Expr_ptr eye { res.rhs->lhs() };
+                while (em().is_set_comma(eye)) {
+                    res.choices.push_back(eye->lhs());
+                    eye = eye->rhs();
+                }
+                res.choices.push_back(eye);
+            }
+        } else {
+            /* just a constraint */
+            res.guard = NULL;
+        }
+
+        if (NULL != res.guard && !is_concrete(ctx, res.guard)) {
+            return false;
+        }
+
+        if (res.choices.empty()) {
+            return is_concrete(ctx, res.rhs);
+        }
+
+        for (auto choice : res.choices) {
+            if (!is_concrete(ctx, choice)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Simulation::collect_concrete_fsm(ConcreteTransVector& trans,
+                                          ConcreteExprs& invars,
+                                          ConcreteVars& vars)
+    {
+        bool res { true };
+
+        std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
+        stack.push(std::pair<expr::Expr_ptr, model::Module_ptr>(em().make_empty(),
+                                                               &model().main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, model::Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            model::Module& module { *top.second };
+
+            for (auto body : module.invar()) {
+                invars.push_back(std::make_pair(ctx, body));
+                res &= is_concrete(ctx, body);
+            }
+
+            for (auto body : module.trans()) {
+                ConcreteTrans ct;
+                res &= classify_trans(ctx, body, ct);
+                trans.push_back(ct);
+            }
+
+            symb::Variables attrs { module.vars() };
+            for (auto vi = attrs.begin(); attrs.end() != vi; ++vi) {
+                expr::Expr_ptr local_ctx { em().make_dot(ctx, vi->first) };
+                symb::Variable& var { *vi->second };
+                type::Type_ptr vtype { var.type() };
+
+                if (vtype->is_instance()) {
+                    type::InstanceType_ptr instance { vtype->as_instance() };
+                    model::Module& module { model().module(instance->name()) };
+                    stack.push(std::pair<expr::Expr_ptr, model::Module_ptr>(local_ctx, &module));
+                }
+
+                else if (!var.is_input()) {
+                    vars.push_back(std::make_pair(local_ctx, &var));
+                }
+            }
+        }
+
+        /* environment constraints are left to SAT */
+        env::Environment& env { env::Environment::INSTANCE() };
+        if (0 < env.extra_invar().size() || 0 < env.extra_trans().size()) {
+            res = false;
+        }
+
+        return res;
+    }
+
+    bool Simulation::random_value(type::Type_ptr type, expr::Expr_ptr& res)
+    {
+        if (type->is_boolean()) {
+            res = (f_rng() & 1) ? em().make_true() : em().make_false();
+            return true;
+        }
+
+        if (type->is_enum()) {
+            const expr::ExprSet& literals { type->as_enum()->literals() };
+            expr::ExprSet::const_iterator i { literals.begin() };
+
+            for (unsigned n = f_rng() % literals.size(); 0 < n; --n) {
+                ++i;
+            }
+
+            res = *i;
+            return true;
+        }
+
+        if (type->is_algebraic() && type->width() < 8 * sizeof(value_t) - 1) {
+            unsigned width { type->width() };
+            value_t value { (value_t) (f_rng() & ((1ULL << width) - 1)) };
+
+            if (type->is_signed_algebraic()) {
+                value -= (value_t) 1 << (width - 1);
+            }
+
+            res = em().make_const(value);
+            return true;
+        }
+
+        return false;
+    }
+
+    /* next(lhs) is assigned, if the guard holds. Each TRANS is
+       applied once per step */
+    Simulation::concrete_status_t
+    Simulation::apply_trans(witness::Witness& scratch, ConcreteTrans& ct,
+                            bool deterministic)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        witness::TimeFrame& next { scratch[1] };
+
+        if (NULL != ct.guard) {
+            expr::Expr_ptr guard { wm.eval(scratch, ct.ctx, ct.guard, 0) };
+            if (NULL == guard) {
+                return CONCRETE_POSTPONED;
+            }
+
+            if (em().is_false(guard)) {
+                return CONCRETE_DONE;
+            }
+        }
+
+        /* plain constraints are just checked */
+        if (NULL == ct.lhs) {
+            expr::Expr_ptr value { wm.eval(scratch, ct.ctx, ct.rhs, 0) };
+            if (NULL == value) {
+                return CONCRETE_POSTPONED;
+            }
+
+            return em().is_true(value) ? CONCRETE_DONE : CONCRETE_FAILED;
+        }
+
+        if (deterministic && !ct.choices.empty()) {
+            return CONCRETE_FAILED;
+        }
+
+        expr::Expr_ptr rhs {
+            ct.choices.empty() ? ct.rhs : ct.choices[f_rng() % ct.choices.size()]
+        };
+
+        expr::Expr_ptr value { wm.eval(scratch, ct.ctx, rhs, 0) };
+        if (NULL == value) {
+            return CONCRETE_POSTPONED;
+        }
+
+        if (next.has_value(ct.lhs)) {
+            return next.value(ct.lhs) == value ? CONCRETE_DONE : CONCRETE_FAILED;
+        }
+
+        next.set_value(ct.lhs, value);
+        return CONCRETE_DONE;
+    }
+
+    /* Pending TRANSes are applied until no more progress can be made
+     * (i.e. they depend on next values not yet known). State vars left
+     * unassigned, and not pending assignment, are then given random
+     * values, and so on. False iff the step could not be taken by
+     * concrete evaluation, i.e. the random choices violate the FSM or
+     * the constraints. */
+    bool Simulation::concrete_step(witness::Witness& scratch, ConcreteTransVector& trans,
+                                   ConcreteExprs& invars, ConcreteExprs& constraints,
+                                   ConcreteVars& vars, bool deterministic)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        witness::TimeFrame& next { scratch.extend() };
+
+        std::vector<ConcreteTrans*> pending;
+        for (auto& ct : trans) {
+            pending.push_back(&ct);
+        }
+
+        while (true) {
+            bool progress { true };
+            while (progress) {
+                progress = false;
+
+                std::vector<ConcreteTrans*> postponed;
+                for (auto ct : pending) {
+                    concrete_status_t status { apply_trans(scratch, *ct, deterministic) };
+
+                    if (CONCRETE_FAILED == status) {
+                        return false;
+                    }
+
+                    else if (CONCRETE_POSTPONED == status) {
+                        postponed.push_back(ct);
+                    }
+
+                    else {
+                        progress = true;
+                    }
+                }
+
+                pending.swap(postponed);
+            }
+
+            /* free vars, pending assignments are left alone unless
+               there is nothing else (i.e. circular dependencies) */
+            ConcreteVars unassigned, free;
+            for (auto& var : vars) {
+                if (!next.has_value(var.first)) {
+                    unassigned.push_back(var);
+
+                    bool assigned { false };
+                    for (auto ct : pending) {
+                        if (ct->lhs == var.first) {
+                            assigned = true;
+                            break;
+                        }
+                    }
+
+                    if (!assigned) {
+                        free.push_back(var);
+                    }
+                }
+            }
+
+            if (unassigned.empty()) {
+                break;
+            }
+
+            for (auto& var : free.empty() ? unassigned : free) {
+                expr::Expr_ptr value;
+
+                /* frozen vars keep their value */
+                if (var.second->is_frozen() && scratch[0].has_value(var.first)) {
+                    value = scratch[0].value(var.first);
+                }
+
+                else if (deterministic || !random_value(var.second->type(), value)) {
+                    return false;
+                }
+
+                next.set_value(var.first, value, var.second->format());
+            }
+        }
+
+        /* e.g. depending on inputs without a value */
+        if (!pending.empty()) {
+            return false;
+        }
+
+        for (auto& invar : invars) {
+            expr::Expr_ptr value { wm.eval(scratch, invar.first, invar.second, 1) };
+            if (NULL == value || !em().is_true(value)) {
+                return false;
+            }
+        }
+
+        for (auto& constraint : constraints) {
+            expr::Expr_ptr value { wm.eval(scratch, constraint.first, constraint.second, 1) };
+            if (NULL == value || !em().is_true(value)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* a new frame in w, with the current values of vars in scratch,
+       and those of inputs and defines */
+    void Simulation::record_frame(witness::Witness& w, witness::Witness& scratch,
+                                  ConcreteVars& vars)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        witness::TimeFrame& tf { w.extend() };
+        witness::TimeFrame& curr { scratch[0] };
+
+        for (auto& var : vars) {
+            if (curr.has_value(var.first)) {
+                tf.set_value(var.first, curr.value(var.first), var.second->format());
+            }
+        }
+
+        symb::SymbIter symbols { model() };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+            expr::Expr_ptr key { em().make_dot(ctx, symb->name()) };
+
+            if (symb->is_variable() && symb->as_variable().is_input()) {
+                expr::Expr_ptr value { env::Environment::INSTANCE().get(symb->name()) };
+                if (value) {
+                    tf.set_value(key, value, symb->format());
+                }
+            }
+
+            else if (symb->is_define()) {
+                expr::Expr_ptr value { wm.eval(scratch, ctx, symb->as_define().body(), 0) };
+                if (value) {
+                    tf.set_value(key, value);
+                }
+            }
+        }
+    }
+
+    simulation_status_t Simulation::random_simulate(expr::ExprVector constraints,
+                                                    pconst_char trace_name,
+                                                    step_t n, step_t period)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        clock_t t0 { clock() }, t1;
+        double secs;
+
+        expr::Atom trace_uid {
+            trace_name ? expr::Atom(trace_name) : wm.current().id()
+        };
+        witness::Witness& trace { wm.witness(trace_uid) };
+
+        if (0 == period) {
+            period = 1;
+        }
+
+        ConcreteTransVector trans;
+        ConcreteExprs invars;
+        ConcreteVars vars;
+
+        bool concrete { collect_concrete_fsm(trans, invars, vars) };
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        ConcreteExprs constraint_exprs;
+        for (auto constraint : constraints) {
+            constraint_exprs.push_back(std::make_pair(ctx, constraint));
+            concrete &= is_concrete(ctx, constraint);
+        }
+
+        if (!concrete) {
+            WARN
+                << "Model can not be evaluated concretely, all steps are taken by SAT"
+                << std::endl;
+        }
+
+        /* SAT steps out of the current state, i.e. frame 0 */
+        sat::Engine engine { "random_simulation" };
+        setup_engine(engine);
+
+        assert_fsm_invar(engine, 0);
+        assert_fsm_trans(engine, 0);
+        assert_fsm_invar(engine, 1);
+
+        for (auto constraint : constraints) {
+            compiler::Unit cu { compiler().process(ctx, constraint) };
+            assert_formula(engine, 1, cu);
+        }
+
+        /* frame 0 is the current state, frame 1 the next one */
+        witness::Witness scratch;
+        scratch.set_lang(trace.lang());
+        {
+            witness::TimeFrame& tf { scratch.extend() };
+            witness::TimeFrame& last { trace.last() };
+
+            for (auto& var : vars) {
+                if (last.has_value(var.first)) {
+                    tf.set_value(var.first, last.value(var.first), var.second->format());
+                }
+            }
+        }
+
+        witness::Witness& w { *new witness::Witness() };
+        w.set_lang(trace.lang());
+        record_frame(w, scratch, vars);
+
+        simulation_status_t res { SIMULATION_DONE };
+        step_t sat_steps { 0 };
+        step_t last_recorded { 0 };
+        step_t reached { 0 };
+
+        for (step_t k = 1; k <= n; ++k) {
+            if (limits_exceeded()) {
+                res = SIMULATION_INTERRUPTED;
+                break;
+            }
+
+            if (!concrete || !concrete_step(scratch, trans, invars, constraint_exprs, vars)) {
+                /* start over from the current state */
+                if (2 == scratch.size()) {
+                    scratch.drop_last();
+                }
+
+                witness::TimeFrame& next { scratch.extend() };
+
+                sat::group_t group { engine.new_group() };
+                assert_time_frame(engine, 0, scratch[0], group);
+
+                sat::status_t status { engine.solve() };
+
+                if (sat::status_t::STATUS_SAT == status) {
+                    SimulationWitness sw { model(), engine, 1 };
+                    witness::TimeFrame& tf { sw.first() };
+
+                    for (auto& var : vars) {
+                        if (tf.has_value(var.first)) {
+                            next.set_value(var.first, tf.value(var.first),
+                                           var.second->format());
+                        }
+                    }
+                }
+
+                engine.retire_last_group();
+                ++sat_steps;
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    res = SIMULATION_INTERRUPTED;
+                    break;
+                }
+
+                else if (sat::status_t::STATUS_UNSAT == status) {
+                    INFO
+                        << "Inconsistency detected in transition relation at step "
+                        << k
+                        << std::endl;
+
+                    res = SIMULATION_DEADLOCKED;
+                    break;
+                }
+            }
+
+            /* the next state becomes the current one */
+            scratch.drop_first();
+            reached = k;
+
+            if (0 == k % period) {
+                record_frame(w, scratch, vars);
+                last_recorded = k;
+            }
+        }
+
+        /* the last state reached is always recorded */
+        if (last_recorded != reached) {
+            record_frame(w, scratch, vars);
+        }
+
+        for (auto tf : scratch.frames()) {
+            delete tf;
+        }
+        scratch.frames().clear();
+
+        t1 = clock();
+        secs = (double) (t1 - t0) / (double) CLOCKS_PER_SEC;
+
+        INFO
+            << "Random simulation took "
+            << secs
+            << " seconds, "
+            << reached
+            << " steps ("
+            << sat_steps
+            << " by SAT)"
+            << std::endl;
+
+        std::ostringstream oss_id;
+        oss_id
+            << random_trace_prfx
+            << wm.autoincrement();
+        w.set_id(oss_id.str());
+
+        std::ostringstream oss_desc;
+        oss_desc
+            << "Random simulation from `"
+            << trace_uid
+            << "`, one frame every "
+            << period
+            << " steps";
+        w.set_desc(oss_desc.str());
+
+        wm.record(w);
+        wm.set_current(w);
+        set_witness(w);
+
+        return res;
+    }
+
+
+    /* TRUE/FALSE (or 0/1) for booleans, a literal of the type for
+       enums, an integer for algebraics. NULL if the token is none of
+       these */
+    static expr::Expr_ptr input_value(type::Type_ptr type, const std::string& token)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (type->is_boolean()) {
+            if ("TRUE" == token || "1" == token) {
+                return em.make_true();
+            }
+            if ("FALSE" == token || "0" == token) {
+                return em.make_false();
+            }
+
+            return NULL;
+        }
+
+        if (type->is_enum()) {
+            expr::Expr_ptr literal { em.make_identifier(token.c_str()) };
+            const expr::ExprSet& literals { type->as_enum()->literals() };
+
+            return literals.end() != literals.find(literal) ? literal : NULL;
+        }
+
+        if (type->is_algebraic()) {
+            char* end;
+            const char* begin { token.c_str() };
+            value_t value { (value_t) strtoll(begin, &end, 0) };
+
+            return (end != begin && '\0' == *end) ? em.make_const(value) : NULL;
+        }
+
+        return NULL;
+    }
+
+    sat::status_t Simulation::sat_step(witness::Witness& scratch,
+                                       const expr::ExprVector& constraints,
+                                       ConcreteVars& vars)
+    {
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        sat::Engine engine { "stream_simulation" };
+        setup_engine(engine);
+
+        /* the current state is pinned as a whole, its INVARs were
+           checked on the inputs of the step leading to it */
+        assert_time_frame(engine, 0, scratch[0]);
+        assert_fsm_trans(engine, 0);
+        assert_fsm_invar(engine, 1);
+
+        for (auto constraint : constraints) {
+            compiler::Unit cu { compiler().process(ctx, constraint) };
+            assert_formula(engine, 1, cu);
+        }
+
+        sat::status_t res { engine.solve() };
+        if (sat::status_t::STATUS_SAT == res) {
+            SimulationWitness sw { model(), engine, 1 };
+            witness::TimeFrame& tf { sw.first() };
+            witness::TimeFrame& next { scratch.extend() };
+
+            for (auto& var : vars) {
+                if (tf.has_value(var.first)) {
+                    next.set_value(var.first, tf.value(var.first), var.second->format());
+                }
+            }
+        }
+
+        return res;
+    }
+
+    /* Each line of the stream holds the inputs of one step, as `name =
+     * value` assignments (separated by blanks, commas or semicolons,
+     * `--` and `#` start a comment). Inputs not assigned keep their
+     * value. The step is taken by concrete evaluation if the FSM is
+     * deterministic given the inputs, i.e. every state var is
+     * assigned, or frozen. When it is not, the step is solved by SAT
+     * out of the current state. As INPUT vars are compiled as their
+     * values, each SAT step runs on the FSM compiled for the inputs
+     * of the step (the compiled FSM is reused while they do not
+     * change). Inputs keep the values of the last step. */
+    simulation_status_t Simulation::stream_simulate(expr::ExprVector constraints,
+                                                    pconst_char trace_name,
+                                                    std::istream& is)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        clock_t t0 { clock() }, t1;
+        double secs;
+
+        expr::Atom trace_uid {
+            trace_name ? expr::Atom(trace_name) : wm.current().id()
+        };
+        witness::Witness& trace { wm.witness(trace_uid) };
+
+        set_witness(trace);
+
+        /* the trace is extended here, and the FSM compiled for other
+           inputs */
+        SessionMgr::INSTANCE().clear();
+
+        /* INPUT vars are keyed by their name in the environment */
+        using InputTypes = boost::unordered_map<expr::Expr_ptr, type::Type_ptr,
+                                                utils::PtrHash, utils::PtrEq>;
+        InputTypes inputs;
+        symb::SymbIter symbols { model() };
+        while (symbols.has_next()) {
+            symb::Symbol_ptr symb { symbols.next().second };
+            if (symb->is_variable() && symb->as_variable().is_input()) {
+                inputs.insert(std::make_pair(symb->name(), symb->as_variable().type()));
+            }
+        }
+
+        ConcreteTransVector trans;
+        ConcreteExprs invars;
+        ConcreteVars vars;
+
+        bool concrete { collect_concrete_fsm(trans, invars, vars) };
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        ConcreteExprs constraint_exprs;
+        for (auto constraint : constraints) {
+            constraint_exprs.push_back(std::make_pair(ctx, constraint));
+            concrete &= is_concrete(ctx, constraint);
+        }
+
+        if (!concrete) {
+            WARN
+                << "Model can not be evaluated concretely, all steps are taken by SAT"
+                << std::endl;
+        }
+
+        /* frame 0 is the current state, frame 1 the next one */
+        witness::Witness scratch;
+        scratch.set_lang(trace.lang());
+        {
+            witness::TimeFrame& tf { scratch.extend() };
+            witness::TimeFrame& last { trace.last() };
+
+            for (auto& var : vars) {
+                if (last.has_value(var.first)) {
+                    tf.set_value(var.first, last.value(var.first), var.second->format());
+                }
+            }
+        }
+
+        simulation_status_t res { SIMULATION_DONE };
+        step_t sat_steps { 0 };
+        step_t reached { 0 };
+        unsigned lineno { 0 };
+
+        std::string line;
+        while (std::getline(is, line)) {
+            ++lineno;
+
+            std::string::size_type comment { std::min(line.find("--"), line.find('#')) };
+            if (std::string::npos != comment) {
+                line.erase(comment);
+            }
+
+            for (auto& c : line) {
+                if (',' == c || ';' == c || '=' == c || ':' == c) {
+                    c = ' ';
+                }
+            }
+
+            std::istringstream iss { line };
+            std::string name, token;
+            bool assigned { false };
+            bool ok { true };
+            while (ok && iss >> name) {
+                expr::Expr_ptr id { em().make_identifier(name.c_str()) };
+                InputTypes::const_iterator i { inputs.find(id) };
+
+                expr::Expr_ptr value { NULL };
+                if (inputs.end() == i || !(iss >> token) ||
+                    NULL == (value = input_value(i->second, token))) {
+                    ok = false;
+                    break;
+                }
+
+                env.set(id, value);
+                assigned = true;
+            }
+
+            if (!ok) {
+                WARN
+                    << "Malformed input vector at line "
+                    << lineno
+                    << ": `"
+                    << name
+                    << "` is not an INPUT var, or has no valid value"
+                    << std::endl;
+
+                res = SIMULATION_UNKNOWN;
+                break;
+            }
+
+            /* blank lines and comments */
+            if (!assigned) {
+                continue;
+            }
+
+            if (limits_exceeded()) {
+                res = SIMULATION_INTERRUPTED;
+                break;
+            }
+
+            if (!concrete ||
+                !concrete_step(scratch, trans, invars, constraint_exprs, vars, true)) {
+                if (2 == scratch.size()) {
+                    scratch.drop_last();
+                }
+
+                /* compiled on the current inputs */
+                Simulation stepper { command(), model() };
+                sat::status_t status { stepper.sat_step(scratch, constraints, vars) };
+                ++sat_steps;
+
+                if (sat::status_t::STATUS_UNKNOWN == status) {
+                    res = SIMULATION_INTERRUPTED;
+                    break;
+                }
+
+                else if (sat::status_t::STATUS_UNSAT == status) {
+                    INFO
+                        << "Inconsistency detected in transition relation at step "
+                        << reached + 1
+                        << " (line "
+                        << lineno
+                        << ")"
+                        << std::endl;
+
+                    res = SIMULATION_DEADLOCKED;
+                    break;
+                }
+            }
+
+            /* the next state becomes the current one */
+            scratch.drop_first();
+            record_frame(trace, scratch, vars);
+            ++reached;
+        }
+
+        for (auto tf : scratch.frames()) {
+            delete tf;
+        }
+        scratch.frames().clear();
+
+        t1 = clock();
+        secs = (double) (t1 - t0) / (double) CLOCKS_PER_SEC;
+
+        INFO
+            << "Input-driven simulation took "
+            << secs
+            << " seconds, "
+            << reached
+            << " steps ("
+            << sat_steps
+            << " by SAT)"
+            << std::endl;
+
+        return res;
+    }
+
+} // namespace sim
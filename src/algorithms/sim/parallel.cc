@@ -0,0 +1,263 @@
+/**
+ * @file parallel.cc
+ * @brief Simulation algorithm, bit-parallel random simulation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <ctime>
+#include <sstream>
+
+#include <env/environment.hh>
+
+#include <sim/simulation.hh>
+
+#include <symb/classes.hh>
+#include <symb/symb_iter.hh>
+
+static const char* lanes_trace_prfx = "lsim-";
+
+/* max size of the FSM BDDs for bit-parallel simulation */
+static const int dd_lanes_node_limit { 1 << 20 };
+
+namespace sim {
+
+    /* a new frame in w, with the values of the state vars on lane,
+       and those of inputs and defines */
+    void Simulation::record_lane_frame(witness::Witness& w,
+                                       algorithms::LaneSimulator& lanes, unsigned lane)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        std::vector<int> inputs(bm.nbits(), 0);
+        witness::TimeFrame& tf { w.extend() };
+
+        symb::SymbIter symbols { model() };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+            expr::Expr_ptr key { em().make_dot(ctx, symb->name()) };
+
+            if (symb->is_variable()) {
+                const symb::Variable& var { symb->as_variable() };
+
+                if (var.is_input()) {
+                    expr::Expr_ptr value { env::Environment::INSTANCE().get(symb->name()) };
+                    if (value) {
+                        tf.set_value(key, value, symb->format());
+                    }
+
+                    continue;
+                }
+
+                enc::Encoding_ptr enc {
+                    bm.find_encoding(expr::TimedExpr(key, var.is_frozen() ? FROZEN : 0))
+                };
+                if (!enc) {
+                    continue;
+                }
+
+                for (const auto& bit : enc->bits()) {
+                    int index { (int) bit.getNode()->index };
+                    inputs[index] = lanes.value(index, lane) ? 1 : 0;
+                }
+
+                expr::Expr_ptr value { enc->expr(&inputs[0]) };
+                if (value) {
+                    tf.set_value(key, value, symb->format());
+                }
+            }
+        }
+
+        /* defines, once all vars are known */
+        symb::SymbIter defines { model() };
+        while (defines.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { defines.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+
+            if (symb->is_define()) {
+                expr::Expr_ptr value {
+                    wm.eval(w, ctx, symb->as_define().body(), w.last_time())
+                };
+                if (value) {
+                    tf.set_value(em().make_dot(ctx, symb->name()), value);
+                }
+            }
+        }
+    }
+
+    simulation_status_t Simulation::lanes_simulate(expr::ExprVector constraints,
+                                                   step_t n, step_t period)
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        clock_t t0 { clock() }, t1;
+        double secs;
+
+        if (0 == period) {
+            period = 1;
+        }
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        compiler::Units constraint_cus;
+        for (auto constraint : constraints) {
+            constraint_cus.push_back(compiler().process(ctx, constraint));
+        }
+
+        algorithms::LaneSimulator_ptr lanes {
+            make_lane_simulator(constraint_cus, dd_lanes_node_limit, f_rng())
+        };
+
+        if (!lanes) {
+            WARN
+                << "Model can not be simulated in parallel, BDDs of the FSM are not available"
+                << std::endl;
+
+            return SIMULATION_UNKNOWN;
+        }
+
+        algorithms::lanes_t alive { lanes->initialize() };
+        if (!alive) {
+            INFO
+                << "No initial states"
+                << std::endl;
+
+            delete lanes;
+            return SIMULATION_DEADLOCKED;
+        }
+
+        expr::ExprVector lang;
+        symb::SymbIter symbols { model() };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+            lang.push_back(em().make_dot(pair.first, pair.second->name()));
+        }
+
+        std::vector<witness::Witness_ptr> witnesses;
+        std::vector<step_t> last_recorded;
+        for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+            witness::Witness_ptr w { new witness::Witness() };
+            w->set_lang(lang);
+            record_lane_frame(*w, *lanes, lane);
+
+            witnesses.push_back(w);
+            last_recorded.push_back(0);
+        }
+
+        simulation_status_t res { SIMULATION_DONE };
+        step_t reached { 0 };
+
+        for (step_t k = 1; k <= n; ++k) {
+            if (limits_exceeded()) {
+                res = SIMULATION_INTERRUPTED;
+                break;
+            }
+
+            algorithms::lanes_t prev { alive };
+            alive = lanes->step();
+
+            /* dead lanes keep their last state, recorded as it is */
+            for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+                if (((prev & ~alive) >> lane) & 1 && last_recorded[lane] != k - 1) {
+                    record_lane_frame(*witnesses[lane], *lanes, lane);
+                    last_recorded[lane] = k - 1;
+                }
+            }
+
+            if (!alive) {
+                INFO
+                    << "Inconsistency detected in transition relation at step "
+                    << k
+                    << " on all lanes"
+                    << std::endl;
+
+                res = SIMULATION_DEADLOCKED;
+                break;
+            }
+
+            reached = k;
+
+            if (0 == k % period) {
+                for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+                    if ((alive >> lane) & 1) {
+                        record_lane_frame(*witnesses[lane], *lanes, lane);
+                        last_recorded[lane] = k;
+                    }
+                }
+            }
+        }
+
+        /* the last state reached is always recorded */
+        for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+            if ((alive >> lane) & 1 && last_recorded[lane] != reached) {
+                record_lane_frame(*witnesses[lane], *lanes, lane);
+            }
+        }
+
+        unsigned n_alive { 0 };
+        for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+            n_alive += (alive >> lane) & 1;
+        }
+
+        t1 = clock();
+        secs = (double) (t1 - t0) / (double) CLOCKS_PER_SEC;
+
+        INFO
+            << "Bit-parallel simulation took "
+            << secs
+            << " seconds, "
+            << reached
+            << " steps ("
+            << n_alive
+            << " lanes alive)"
+            << std::endl;
+
+        for (unsigned lane = 0; lane < algorithms::N_LANES; ++lane) {
+            witness::Witness& w { *witnesses[lane] };
+
+            std::ostringstream oss_id;
+            oss_id
+                << lanes_trace_prfx
+                << wm.autoincrement();
+            w.set_id(oss_id.str());
+
+            std::ostringstream oss_desc;
+            oss_desc
+                << "Bit-parallel simulation, lane "
+                << lane
+                << ", one frame every "
+                << period
+                << " steps";
+            w.set_desc(oss_desc.str());
+
+            wm.record(w);
+        }
+
+        /* the first lane is the current witness */
+        wm.set_current(*witnesses[0]);
+        set_witness(*witnesses[0]);
+
+        delete lanes;
+        return res;
+    }
+
+} // namespace sim
@@ -0,0 +1,336 @@
+/**
+ * @file sim/sampling.cc
+ * @brief Simulation algorithm, near-uniform sampling of the initial
+ * states by random XOR hashing.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <sim/simulation.hh>
+
+/* cells of at most this many states are enumerated, hashing splits
+   larger sets of states into cells of about this size */
+static const unsigned sampling_pivot { 40 };
+
+/* an approximate count is the median of this many estimates */
+static const unsigned counting_rounds { 5 };
+
+/* attempts at finding a cell of the right size, for each sample */
+static const unsigned sampling_attempts { 10 };
+
+namespace sim {
+
+    /* The feasible states S are split in 2^m cells by m random XOR
+     * constraints over their bits (each bit is in each XOR with
+     * probability 1/2, the parity is random as well). Each state is in
+     * a given cell with probability 2^-m, independently of the others
+     * (the family of hashes is 3-wise independent): cells have
+     * |S| / 2^m states on average, and they are seldom far from it.
+     *
+     * Counting (ApproxMC): m is increased until the states in a cell
+     * are at most pivot, its size times 2^m is an estimate of |S|.
+     * The median of a few such estimates is the count.
+     *
+     * Sampling (UniGen): m is chosen from the count for cells of about
+     * pivot states, a cell of roughly that size is enumerated, and one
+     * of its states is picked uniformly. Each state is thus picked
+     * with probability close to 1 / |S|. If |S| is at most pivot, all
+     * states are enumerated once, and sampled from directly.
+     *
+     * A single engine is used throughout: the XORs (and the cubes
+     * blocking the states of a cell found so far) are enabled by a
+     * selector, which is retired once the cell is done with. */
+
+    Var Simulation::add_xors(sat::Engine& engine, const std::vector<enc::UCBI>& bits,
+                             unsigned m)
+    {
+        Var selector { engine.new_sat_var() };
+
+        for (unsigned i = 0; i < m; ++i) {
+            bool parity { 0 != (f_rng() & 1) };
+
+            /* x_1 ^ .. ^ x_n = parity, by a chain t_j = t_{j-1} ^ x_j */
+            bool empty { true };
+            Lit acc;
+            for (const auto& ucbi : bits) {
+                if (0 == (f_rng() & 1)) {
+                    continue;
+                }
+
+                Lit x { mkLit(engine.tcbi_to_var(enc::TCBI(ucbi, 0))) };
+                if (empty) {
+                    acc = x;
+                    empty = false;
+                    continue;
+                }
+
+                Lit t { mkLit(engine.new_sat_var()) };
+                Lit clauses[4][3] = {
+                    { ~t, acc, x },
+                    { ~t, ~acc, ~x },
+                    { t, ~acc, x },
+                    { t, acc, ~x },
+                };
+                for (auto& clause : clauses) {
+                    vec<Lit> ps;
+                    ps.push(mkLit(selector, true));
+                    for (auto lit : clause) {
+                        ps.push(lit);
+                    }
+                    engine.add_clause(ps);
+                }
+                acc = t;
+            }
+
+            /* an empty XOR is 0, the cell is either everything or
+               nothing */
+            vec<Lit> ps;
+            ps.push(mkLit(selector, true));
+            if (!empty) {
+                ps.push(parity ? acc : ~acc);
+            } else if (!parity) {
+                continue;
+            }
+            engine.add_clause(ps);
+        }
+
+        return selector;
+    }
+
+    bool Simulation::enumerate_cell(sat::Engine& engine, const std::vector<enc::UCBI>& bits,
+                                    Var selector, unsigned limit, Cubes& res)
+    {
+        vec<Lit> assumptions;
+        assumptions.push(mkLit(selector));
+
+        res.clear();
+        while (res.size() <= limit) {
+            sat::status_t status { engine.solve(assumptions) };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return false;
+            }
+
+            if (sat::status_t::STATUS_UNSAT == status) {
+                break;
+            }
+
+            /* the state is blocked within the cell */
+            std::vector<bool> cube;
+            vec<Lit> ps;
+            ps.push(mkLit(selector, true));
+            for (const auto& ucbi : bits) {
+                Var var { engine.tcbi_to_var(enc::TCBI(ucbi, 0)) };
+                bool value { 1 == engine.value(var) };
+
+                cube.push_back(value);
+                ps.push(mkLit(var, value));
+            }
+            engine.add_clause(ps);
+
+            res.push_back(cube);
+        }
+
+        /* retired */
+        vec<Lit> ps;
+        ps.push(mkLit(selector, true));
+        engine.add_clause(ps);
+
+        return true;
+    }
+
+    void Simulation::setup_sampling(sat::Engine& engine, const expr::ExprVector& constraints)
+    {
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        setup_engine(engine);
+
+        /* INITs and INVARs at time 0, additional constraints */
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+        for (auto constraint : constraints) {
+            compiler::Unit unit { compiler().process(ctx, constraint) };
+            assert_formula(engine, 0, unit);
+        }
+    }
+
+    bool Simulation::hashed_count(sat::Engine& engine, const std::vector<enc::UCBI>& bits,
+                                  value_t& res)
+    {
+        Cubes cell;
+        if (!enumerate_cell(engine, bits, add_xors(engine, bits, 0), sampling_pivot, cell)) {
+            return false;
+        }
+
+        /* exact */
+        if (cell.size() <= sampling_pivot) {
+            res = cell.size();
+            return true;
+        }
+
+        /* each round starts from about the m of the previous one */
+        std::vector<double> estimates;
+        unsigned m { 1 };
+        for (unsigned round = 0; round < counting_rounds; ++round) {
+            m = std::max(1u, m - 1);
+
+            while (m < bits.size()) {
+                if (!enumerate_cell(engine, bits, add_xors(engine, bits, m),
+                                    sampling_pivot, cell)) {
+                    return false;
+                }
+
+                if (cell.size() <= sampling_pivot) {
+                    break;
+                }
+                ++m;
+            }
+
+            estimates.push_back(std::ldexp((double) cell.size(), m));
+
+            DEBUG
+                << "Round "
+                << round
+                << ": "
+                << cell.size()
+                << " states in one of 2^"
+                << m
+                << " cells"
+                << std::endl;
+        }
+
+        std::sort(estimates.begin(), estimates.end());
+        double median { estimates[estimates.size() / 2] };
+
+        res = median < (double) std::numeric_limits<value_t>::max()
+                  ? (value_t) median
+                  : std::numeric_limits<value_t>::max();
+
+        return true;
+    }
+
+    value_t Simulation::approx_count_states(expr::ExprVector constraints,
+                                            expr::ExprVector projection)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_bits(projection, bits);
+
+        sat::Engine engine { "pick_state_count" };
+        setup_sampling(engine, constraints);
+
+        value_t res { 0 };
+        if (!hashed_count(engine, bits, res)) {
+            WARN
+                << "Approximate counting interrupted"
+                << std::endl;
+        }
+
+        return res;
+    }
+
+    value_t Simulation::sample_states(expr::ExprVector constraints,
+                                      expr::ExprVector projection, value_t n)
+    {
+        std::vector<enc::UCBI> bits;
+        collect_bits(projection, bits);
+
+        sat::Engine engine { "pick_state_sample" };
+        setup_sampling(engine, constraints);
+
+        value_t count { 0 };
+        if (!hashed_count(engine, bits, count) || 0 == count) {
+            return 0;
+        }
+
+        /* cells of about pivot states, i.e. m = log2(count / pivot) */
+        Cubes all;
+        int m { 0 };
+        if (sampling_pivot < count) {
+            m = (int) std::lround(std::log2((double) count / sampling_pivot));
+        } else if (!enumerate_cell(engine, bits, add_xors(engine, bits, 0),
+                                   sampling_pivot, all)) {
+            return 0;
+        }
+
+        INFO
+            << "Sampling from about "
+            << count
+            << " states, split in 2^"
+            << m
+            << " cells"
+            << std::endl;
+
+        std::vector<std::vector<bool>> samples;
+        while ((value_t) samples.size() < n) {
+            if (!all.empty()) {
+                samples.push_back(all[f_rng() % all.size()]);
+                continue;
+            }
+
+            /* cells too small (or too large) are discarded */
+            bool found { false };
+            for (unsigned attempt = 0; !found && attempt < sampling_attempts; ++attempt) {
+                unsigned cell_m { (unsigned) std::max(1, m - 1 + (int) (attempt % 3)) };
+
+                Cubes cell;
+                if (!enumerate_cell(engine, bits, add_xors(engine, bits, cell_m),
+                                    2 * sampling_pivot, cell)) {
+                    break;
+                }
+
+                if (sampling_pivot / 2 <= cell.size() && cell.size() <= 2 * sampling_pivot) {
+                    samples.push_back(cell[f_rng() % cell.size()]);
+                    found = true;
+                }
+            }
+
+            if (!found) {
+                WARN
+                    << "No cell of the expected size found, "
+                    << samples.size()
+                    << " states sampled"
+                    << std::endl;
+                break;
+            }
+        }
+
+        /* a whole state for each sample, its bits as assumptions */
+        for (unsigned i = 0; i < samples.size(); ++i) {
+            vec<Lit> assumptions;
+            for (unsigned j = 0; j < bits.size(); ++j) {
+                Var var { engine.tcbi_to_var(enc::TCBI(bits[j], 0)) };
+                assumptions.push(mkLit(var, !samples[i][j]));
+            }
+
+            if (sat::status_t::STATUS_SAT != engine.solve(assumptions)) {
+                return i;
+            }
+
+            register_witness(*new SimulationWitness(model(), engine, 0),
+                             i + 1 == samples.size());
+        }
+
+        return samples.size();
+    }
+
+} // namespace sim
@@ -0,0 +1,107 @@
+/**
+ * @file sim/session.cc
+ * @brief Persistent simulation sessions implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sim/session.hh>
+
+#include <utils/logging.hh>
+
+namespace sim {
+
+    Session::Session(model::Model& model, witness::Witness& trace)
+        : f_model(model)
+        , f_engine("simulation")
+        , f_trace(&trace)
+        , f_trace_id(trace.id())
+        , f_initialized(false)
+        , f_depth(0)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Created Session @"
+            << instance
+            << std::endl;
+    }
+
+    Session::~Session()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Session @"
+            << instance
+            << std::endl;
+    }
+
+    bool Session::resumes(const model::Model& model, witness::Witness& trace) const
+    {
+        return &f_model == &model &&
+               f_trace == &trace &&
+               f_trace_id == trace.id() &&
+               (!f_initialized || f_depth == trace.last_time());
+    }
+
+    SessionMgr::SessionMgr()
+        : f_session(NULL)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized SessionMgr @ "
+            << instance
+            << std::endl;
+    }
+
+    SessionMgr::~SessionMgr()
+    {
+        clear();
+
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed SessionMgr @ "
+            << instance
+            << std::endl;
+    }
+
+    Session& SessionMgr::session(model::Model& model, witness::Witness& trace)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (NULL != f_session && !f_session->resumes(model, trace)) {
+            delete f_session;
+            f_session = NULL;
+        }
+
+        if (NULL == f_session) {
+            f_session = new Session(model, trace);
+        }
+
+        return *f_session;
+    }
+
+    void SessionMgr::clear()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        delete f_session;
+        f_session = NULL;
+    }
+
+} // namespace sim
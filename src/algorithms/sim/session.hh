@@ -0,0 +1,126 @@
+/**
+ * @file sim/session.hh
+ * @brief Persistent simulation sessions.
+ *
+ * This module contains the declarations of persistent simulation
+ * sessions. A session keeps the SAT engine of a simulation alive
+ * across `simulate` commands extending the same trace: each step
+ * only adds the transition relation out of the last frame, which is
+ * pinned to the state chosen by the previous step, instead of
+ * rebuilding the whole instance from the trace.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SIMULATION_SESSION_H
+#define SIMULATION_SESSION_H
+
+#include <expr/expr.hh>
+
+#include <model/model.hh>
+
+#include <sat/sat.hh>
+
+#include <witness/witness.hh>
+
+#include <utils/context.hh>
+
+#include <boost/thread/mutex.hpp>
+
+namespace sim {
+
+    class Session;
+    typedef Session* Session_ptr;
+
+    class Session {
+    public:
+        Session(model::Model& model, witness::Witness& trace);
+        ~Session();
+
+        inline model::Model& model() const
+        {
+            return f_model;
+        }
+
+        inline sat::Engine& engine()
+        {
+            return f_engine;
+        }
+
+        /* true iff the last frame of the trace is pinned in the
+           engine */
+        inline bool initialized() const
+        {
+            return f_initialized;
+        }
+
+        /* frames up to time are unrolled, the last one is pinned */
+        inline void set_depth(step_t time)
+        {
+            f_initialized = true;
+            f_depth = time;
+        }
+
+        /* true iff this session can extend trace, i.e. trace has not
+           been extended by anyone else since the last step */
+        bool resumes(const model::Model& model, witness::Witness& trace) const;
+
+    private:
+        model::Model& f_model;
+
+        sat::Engine f_engine;
+
+        /* the trace being extended, not owned */
+        const witness::Witness* f_trace;
+        expr::Atom f_trace_id;
+
+        bool f_initialized;
+        step_t f_depth;
+    };
+
+    typedef class SessionMgr* SessionMgr_ptr;
+
+    class SessionMgr {
+    public:
+        /* the session extending trace, created if needed. Any other
+           session is dropped */
+        Session& session(model::Model& model, witness::Witness& trace);
+
+        /* drops the current session (if any), e.g. when a new model
+           is read, or when a step could not be completed */
+        void clear();
+
+        static SessionMgr& INSTANCE()
+        {
+            return utils::Context::current().instance<SessionMgr>(
+                utils::CONTEXT_SIM_SESSIONS, []() { return new SessionMgr(); });
+        }
+
+    protected:
+        SessionMgr();
+        ~SessionMgr();
+
+    private:
+        boost::mutex f_mutex;
+        Session_ptr f_session;
+    };
+
+} // namespace sim
+
+#endif /* SIMULATION_SESSION_H */
@@ -21,22 +21,35 @@
  *
  **/
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include <compiler/typedefs.hh>
 
+#include <sim/session.hh>
 #include <sim/simulation.hh>
 
+#include <algorithms/compiled_fsm.hh>
+#include <algorithms/scheduler.hh>
+#include <algorithms/smt.hh>
+
 #include <symb/classes.hh>
 #include <symb/symb_iter.hh>
 #include <symb/typedefs.hh>
 
 static unsigned progressive = 0;
+
+/* max size of the initial states BDD counted by pick-state -n, SAT
+   enumeration is used beyond that */
+static const int dd_count_node_limit { 1 << 20 };
 static const char* simulation_trace_prfx = "sim-";
 
 namespace sim {
     Simulation::Simulation(cmd::Command& command, model::Model& model)
         : Algorithm(command, model)
+        , f_rng(time(NULL))
+        , f_enumerated(0)
     {
         const void* instance { this };
         TRACE
@@ -55,9 +68,13 @@ namespace sim {
     }
 
     void Simulation::extract_witness(sat::Engine& engine, bool select_current_witness)
+    {
+        register_witness(*new SimulationWitness(model(), engine, 0), select_current_witness);
+    }
+
+    void Simulation::register_witness(witness::Witness& w, bool select_current_witness)
     {
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
-        witness::Witness& w { *new SimulationWitness(model(), engine, 0) };
 
         {
             std::ostringstream oss;
@@ -86,73 +103,236 @@ namespace sim {
         }
     }
 
-    void Simulation::exclude_state(sat::Engine& engine)
+    bool Simulation::smt_pick_state(const expr::ExprVector& constraints, value_t& feasible)
+    {
+        algorithms::SmtUnrolling unrolling {
+            model(), opts::OptsMgr::INSTANCE().smt_solver()
+        };
+
+        if (!unrolling.start([this]() { return cancelled(); })) {
+            return false;
+        }
+
+        /* INITs and INVARs at time 0, additional constraints */
+        expr::Expr_ptr ctx { em().make_empty() };
+        if (!unrolling.assert_init(0) || !unrolling.assert_invar(0)) {
+            return false;
+        }
+        for (auto constraint : constraints) {
+            if (!unrolling.assert_formula(ctx, constraint, 0)) {
+                return false;
+            }
+        }
+
+        sat::status_t status { unrolling.check() };
+        if (sat::status_t::STATUS_UNSAT == status) {
+            feasible = 0;
+            return true;
+        }
+
+        if (sat::status_t::STATUS_SAT != status) {
+            return false;
+        }
+
+        witness::Witness& w { *new witness::Witness() };
+        if (!unrolling.extract(w, std::vector<step_t>(1, 0))) {
+            delete &w;
+            return false;
+        }
+
+        register_witness(w, true);
+        feasible = 1;
+        return true;
+    }
+
+    void Simulation::collect_bits(const expr::ExprVector& projection,
+                                  std::vector<enc::UCBI>& bits)
     {
-        /* In ALLSAT mode, for each bit int the encoding, fetch UCBI,
-           time it into TCBI at time 0, fetch its value in MiniSAT
-           model and negate it in the exclusion clause. */
         enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
 
-        vec<Lit> exclusion;
-        symb::SymbIter symbols { model() };
+        /* projection vars, as fully qualified names */
+        algorithms::Support projected;
+        for (auto var : projection) {
+            projected.insert(em().make_dot(em().make_empty(), var));
+        }
 
+        unsigned found { 0 };
+        symb::SymbIter symbols { model() };
         while (symbols.has_next()) {
             std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
 
             expr::Expr_ptr ctx { pair.first };
             symb::Symbol_ptr symb { pair.second };
-            expr::Expr_ptr symb_name { symb->name() };
-            expr::Expr_ptr key { em().make_dot(ctx, symb_name) };
 
-            if (symb->is_variable()) {
-                symb::Variable& var { symb->as_variable() };
+            /* INPUT vars are not really vars ... */
+            if (!symb->is_variable() || symb->as_variable().is_input()) {
+                continue;
+            }
 
-                /* INPUT vars are not really vars ... */
-                if (var.is_input()) {
+            expr::Expr_ptr key { em().make_dot(ctx, symb->name()) };
+            if (!projected.empty()) {
+                if (0 == projected.count(key)) {
                     continue;
                 }
+                ++found;
+            }
 
-                /* time it, and fetch encoding for enc mgr */
-                enc::Encoding_ptr enc {
-                    bm.find_encoding(expr::TimedExpr(key, 0))
-                };
+            /* time it, and fetch encoding for enc mgr */
+            enc::Encoding_ptr enc {
+                bm.find_encoding(expr::TimedExpr(key, 0))
+            };
 
-                if (!enc) {
-                    continue;
-                }
+            if (!enc) {
+                continue;
+            }
 
-                /* for each bit in this encoding, fetch UCBI, time it
-                   into TCBI at time 0, fetch its value in MiniSAT
-                   model and append its negation to exclusion
-                   clause. */
-                dd::DDVector::const_iterator di;
-                unsigned ndx;
-                for (ndx = 0, di = enc->bits().begin();
-                     enc->bits().end() != di; ++ndx, ++di) {
-
-                    unsigned bit { (*di).getNode()->index };
-                    const enc::UCBI& ucbi { bm.find_ucbi(bit) };
-                    const enc::TCBI tcbi { enc::TCBI(ucbi, 0) };
-
-                    Var var { engine.tcbi_to_var(tcbi) };
-                    exclusion.push(mkLit(var, engine.value(var)));
-                }
+            for (const auto& bit : enc->bits()) {
+                bits.push_back(bm.find_ucbi(bit.getNode()->index));
             }
+        }
+
+        if (found < projected.size()) {
+            WARN
+                << "Some projection vars are not state vars, ignored."
+                << std::endl;
+        }
+    }
+
+    bool Simulation::count_states(const compiler::Units& constraint_cus,
+                                  const std::vector<enc::UCBI>& bits, value_t& res)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+
+        BDD states;
+        if (!fsm_initial_states(states, constraint_cus, dd_count_node_limit)) {
+            return false;
+        }
+
+        /* DD indices of the counted bits */
+        boost::unordered_set<unsigned> indices;
+        for (const auto& ucbi : bits) {
+            enc::Encoding_ptr enc {
+                bm.find_encoding(expr::TimedExpr(ucbi.expr(), ucbi.time()))
+            };
+            indices.insert(enc->bits()[ucbi.bitno()].getNode()->index);
+        }
 
-            /* add exclusion clause to SAT instance */
-            engine.add_clause(exclusion);
+        /* any other var is abstracted away */
+        BDD cube { bm.dd().bddOne() };
+        for (auto index : states.SupportIndices()) {
+            if (0 == indices.count(index)) {
+                cube &= bm.dd().bddVar(index);
+            }
+        }
+
+        double minterms { states.ExistAbstract(cube).CountMinterm(bits.size()) };
+        res = (minterms < (double) std::numeric_limits<value_t>::max())
+                  ? (value_t) minterms
+                  : std::numeric_limits<value_t>::max();
+
+        INFO
+            << "Counted "
+            << res
+            << " feasible states on the DD of the initial states"
+            << std::endl;
+
+        return true;
+    }
+
+    unsigned Simulation::exclude_cube(sat::Engine& engine, sat::Engine& dual,
+                                      sat::VarVector& disjuncts,
+                                      const std::vector<enc::UCBI>& bits, unsigned n_kept)
+    {
+        /* the cube of the current model, over the projection bits, as
+           assumptions in the dual engine */
+        std::vector<bool> values;
+        vec<Lit> assumptions;
+        for (const auto& ucbi : bits) {
+            const enc::TCBI tcbi { ucbi, 0 };
+            bool value { 1 == engine.value(engine.tcbi_to_var(tcbi)) };
+
+            values.push_back(value);
+            assumptions.push(mkLit(dual.tcbi_to_var(tcbi), !value));
+        }
+
+        /* the dual engine holds the states which are either not
+           feasible, or in a cube excluded so far. If none is in the
+           current cube, the literals of the final conflict make a cube
+           of feasible states only, disjoint from the previous ones. */
+        sat::group_t group { dual.new_group() };
+        {
+            vec<Lit> ps;
+            ps.push(mkLit(group, true));
+            for (Var disjunct : disjuncts) {
+                ps.push(mkLit(disjunct));
+            }
+            dual.add_clause(ps);
+        }
+
+        sat::status_t status { dual.solve(assumptions) };
+        std::vector<bool> kept(bits.size(), true);
+        if (sat::status_t::STATUS_UNSAT == status) {
+            for (unsigned i = 0; i < bits.size(); ++i) {
+                kept[i] = i < n_kept || dual.failed(assumptions[i]);
+            }
+        }
+        dual.retire_last_group();
+
+        /* the enlarged cube is excluded from both engines */
+        Var selector { dual.new_sat_var() };
+        disjuncts.push_back(selector);
+
+        vec<Lit> exclusion;
+        unsigned dropped { 0 };
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            if (!kept[i]) {
+                ++dropped;
+                continue;
+            }
+
+            const enc::TCBI tcbi { bits[i], 0 };
+            exclusion.push(mkLit(engine.tcbi_to_var(tcbi), values[i]));
+
+            vec<Lit> ps;
+            ps.push(mkLit(selector, true));
+            ps.push(assumptions[i]);
+            dual.add_clause(ps);
+        }
+
+        engine.add_clause(exclusion);
+
+        return dropped;
+    }
+
+    void Simulation::pin_state(sat::Engine& engine, step_t time)
+    {
+        /* for each state bit (inputs excluded), time its UCBI into
+           a TCBI, and assert its value in MiniSAT model by a unit
+           clause. */
+        algorithms::StateBits_ptr bits {
+            algorithms::CompiledFSMMgr::INSTANCE().state_bits(model())
+        };
+
+        for (const auto& bit : *bits) {
+            if (bit.input) {
+                continue;
+            }
+
+            Var var { engine.tcbi_to_var(enc::TCBI(bit.ucbi, time)) };
+
+            vec<Lit> ps;
+            ps.push(mkLit(var, !engine.value(var)));
+            engine.add_clause(ps);
         }
     }
 
     value_t Simulation::pick_state(expr::ExprVector constraints,
-                                   bool all_sat, bool count, value_t limit)
+                                   expr::ExprVector projection,
+                                   bool all_sat, bool count, value_t limit,
+                                   unsigned jobs)
     {
         value_t feasible { 0 };
 
-        clock_t t0 { clock() }, t1;
-        double secs;
-
-        sat::Engine engine { "pick_state" };
         expr::Expr_ptr ctx { em().make_empty() };
 
         compiler::Units constraint_cus;
@@ -177,18 +357,163 @@ namespace sim {
             << " constraints found."
             << std::endl;
 
-        /* INITs and INVARs at time 0 */
+        if (!all_sat && !count) {
+            /* word-level, unless the model can not be lowered */
+            if (!opts::OptsMgr::INSTANCE().smt_solver().empty() &&
+                smt_pick_state(constraints, feasible)) {
+                return feasible;
+            }
+
+            /* any state of the orbit will do, enumerations and counts
+               need them all */
+            const std::string symmetry { opts::OptsMgr::INSTANCE().symmetry_breaking() };
+            if ("pick-state" == symmetry || "all" == symmetry) {
+                break_symmetries(constraints);
+            }
+
+            sat::Engine engine { "pick_state" };
+            setup_engine(engine);
+
+            /* INITs and INVARs at time 0, additional constraints */
+            assert_fsm_init(engine, 0);
+            assert_fsm_invar(engine, 0);
+            for (auto& cu : constraint_cus) {
+                assert_formula(engine, 0, cu);
+            }
+
+            if (sat::status_t::STATUS_SAT == engine.solve()) {
+                extract_witness(engine, true);
+                ++feasible;
+            }
+
+            return feasible;
+        }
+
+        std::vector<enc::UCBI> bits;
+        collect_bits(projection, bits);
+
+        /* counting: the initial states DD is counted directly, unless
+           it is too large */
+        if (count) {
+            if (count_states(constraint_cus, bits, feasible)) {
+                if (0 <= limit && limit < feasible) {
+                    feasible = limit;
+                }
+
+                return feasible;
+            }
+
+            INFO
+                << "Falling back to ALLSAT counting"
+                << std::endl;
+        }
+
+        /* the state space is split in 2^p cubes over the first p
+           projection bits, one enumeration each */
+        unsigned p { 0 };
+        while ((1u << p) < jobs && p < bits.size()) {
+            ++p;
+        }
+
+        f_enumerated = 0;
+        Partitions partitions(1u << p);
+
+        if (1 == partitions.size()) {
+            enumerate_partition(constraint_cus, bits, 0, 0, count, limit, partitions[0]);
+        } else {
+            unsigned n_partitions { (unsigned) partitions.size() };
+            INFO
+                << "Enumerating "
+                << n_partitions
+                << " partitions in parallel"
+                << std::endl;
+
+            algorithms::Tasks tasks;
+            for (unsigned i = 0; i < partitions.size(); ++i) {
+                tasks.push_back(algorithms::Task(
+                    "pick_state",
+                    boost::bind(&Simulation::enumerate_partition, this,
+                                boost::ref(constraint_cus), boost::ref(bits),
+                                p, i, count, limit, boost::ref(partitions[i]))));
+            }
+
+            algorithms::Scheduler::INSTANCE().run(tasks, [this, limit]() {
+                return limit < 0 || this->sync_enumerated(0) < limit;
+            });
+        }
+
+        /* witnesses are registered in partition order */
+        for (auto& partition : partitions) {
+            for (auto w : partition.witnesses) {
+                register_witness(*w, false);
+            }
+        }
+
+        feasible = sync_enumerated(0);
+
+        TRACE
+            << "Found "
+            << feasible
+            << " feasible states"
+            << std::endl;
+
+        return feasible;
+    }
+
+    void Simulation::enumerate_partition(compiler::Units& constraint_cus,
+                                         std::vector<enc::UCBI>& bits,
+                                         unsigned p, unsigned index,
+                                         bool count, value_t limit,
+                                         Partition& partition)
+    {
+        clock_t t0 { clock() }, t1;
+        double secs;
+
+        sat::Engine engine { "pick_state" };
+        setup_engine(engine);
+
+        /* INITs and INVARs at time 0, additional constraints */
         assert_fsm_init(engine, 0);
         assert_fsm_invar(engine, 0);
+        for (auto& cu : constraint_cus) {
+            assert_formula(engine, 0, cu);
+        }
 
-        /* Additional constraints */
-        std::for_each(
-            begin(constraint_cus), end(constraint_cus),
-            [this, &engine](compiler::Unit& cu) {
-                this->assert_formula(engine, 0, cu);
-            });
+        /* this partition's cube, over the first p bits */
+        for (unsigned j = 0; j < p; ++j) {
+            Var var { engine.tcbi_to_var(enc::TCBI(bits[j], 0)) };
+
+            vec<Lit> ps;
+            ps.push(mkLit(var, 0 == ((index >> j) & 1)));
+            engine.add_clause(ps);
+        }
+
+        /* states are excluded by cubes over the projection bits,
+           enlarged against the dual engine (i.e. non-feasible states,
+           each disjunct enabled by a selector) */
+        sat::Engine dual { "pick_state_dual" };
+        setup_engine(dual);
+
+        sat::VarVector disjuncts;
+
+        Var not_init { dual.new_sat_var() };
+        assert_fsm_not_init(dual, 0, not_init);
+        disjuncts.push_back(not_init);
+
+        Var not_invar { dual.new_sat_var() };
+        assert_fsm_not_invar(dual, 0, not_invar);
+        disjuncts.push_back(not_invar);
+
+        for (auto& cu : constraint_cus) {
+            Var not_constraint { dual.new_sat_var() };
+            assert_not_formula(dual, 0, cu, not_constraint);
+            disjuncts.push_back(not_constraint);
+        }
 
         while (true) {
+            /* give way to waiting enumerations, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
             if (sat::status_t::STATUS_SAT != engine.solve()) {
                 break;
             }
@@ -201,7 +526,24 @@ namespace sim {
                 << secs << " seconds"
                 << std::endl;
 
-            if (++feasible >= limit) {
+            /* witnesses read the define values from the witness
+               manager */
+            if (!count) {
+                boost::mutex::scoped_lock lock { f_witnesses_mutex };
+                partition.witnesses.push_back(new SimulationWitness(model(), engine, 0));
+            }
+
+            /* each cube counts for all the states it covers, the
+               partition bits are never dropped */
+            unsigned dropped { exclude_cube(engine, dual, disjuncts, bits, p) };
+            value_t states {
+                dropped < 8 * sizeof(value_t) - 1
+                    ? (value_t) 1 << dropped
+                    : std::numeric_limits<value_t>::max()
+            };
+
+            value_t total { sync_enumerated(states) };
+            if (0 <= limit && total >= limit) {
                 TRACE
                     << "Reached limit: "
                     << limit
@@ -209,30 +551,136 @@ namespace sim {
                     << std::endl;
                 break;
             }
+        } /* while (true) */
+    }
 
-            if (!count) {
-                extract_witness(engine, !all_sat);
+    /* Learnts over INITs and INVARs hold for all sets: a set's group
+     * is retired once it is solved (its clauses, and the learnts
+     * depending on them, are satisfied from then on), the others are
+     * kept for the next sets. Forks start from the clauses of the
+     * engine, learnts included. */
+    value_t Simulation::pick_states(const std::vector<expr::ExprVector>& sets, unsigned jobs,
+                                    std::vector<witness::Witness_ptr>& witnesses)
+    {
+        expr::Expr_ptr ctx { em().make_empty() };
+
+        std::vector<compiler::Units> set_cus;
+        for (const auto& constraints : sets) {
+            compiler::Units cus;
+            for (auto constraint : constraints) {
+                TRACE
+                    << "Compiling constraint `"
+                    << constraint
+                    << "` ..."
+                    << std::endl;
+
+                cus.push_back(compiler().process(ctx, constraint));
+            }
+            set_cus.push_back(cus);
+        }
+
+        unsigned n_engines { std::max(1u, std::min(jobs, (unsigned) sets.size())) };
+
+        sat::Engine engine { "pick_state" };
+        if (1 < n_engines) {
+            engine.record_cnf();
+        }
+        setup_engine(engine);
+
+        /* INITs and INVARs at time 0, once */
+        assert_fsm_init(engine, 0);
+        assert_fsm_invar(engine, 0);
+
+        witnesses.assign(sets.size(), NULL);
+        if (1 == n_engines) {
+            pick_sets(engine, set_cus, 0, 1, witnesses);
+        } else {
+            INFO
+                << "Picking states for "
+                << sets.size()
+                << " constraint sets on "
+                << n_engines
+                << " engines"
+                << std::endl;
+
+            std::vector<sat::Engine_ptr> forks;
+            algorithms::Tasks tasks;
+            for (unsigned i = 0; i < n_engines; ++i) {
+                sat::Engine_ptr fork { new sat::Engine("pick_state", engine) };
+                setup_engine(*fork);
+                forks.push_back(fork);
+
+                tasks.push_back(algorithms::Task(
+                    "pick_state",
+                    boost::bind(&Simulation::pick_sets, this, boost::ref(*fork),
+                                boost::cref(set_cus), i, n_engines, boost::ref(witnesses))));
+            }
+
+            algorithms::Scheduler::INSTANCE().run(tasks, [this]() {
+                return !this->cancelled();
+            });
+
+            for (auto fork : forks) {
+                delete fork;
+            }
+        }
+
+        /* the first feasible set's becomes the current witness */
+        value_t res { 0 };
+        for (auto w : witnesses) {
+            if (NULL != w) {
+                register_witness(*w, 0 == res);
+                ++res;
             }
+        }
+
+        return res;
+    }
+
+    void Simulation::pick_sets(sat::Engine& engine, const std::vector<compiler::Units>& set_cus,
+                               unsigned first, unsigned stride,
+                               std::vector<witness::Witness_ptr>& witnesses)
+    {
+        for (unsigned i = first; i < set_cus.size(); i += stride) {
+            /* give way to waiting engines, if any */
+            algorithms::Scheduler::INSTANCE().yield();
+
+            sat::group_t group { engine.new_group() };
+            compiler::Units cus { set_cus[i] };
+            for (auto& cu : cus) {
+                assert_formula(engine, 0, cu, group);
+            }
+
+            sat::status_t status { engine.solve() };
+            if (sat::status_t::STATUS_SAT == status) {
+                /* witnesses read the define values from the witness
+                   manager */
+                boost::mutex::scoped_lock lock { f_witnesses_mutex };
+                witnesses[i] = new SimulationWitness(model(), engine, 0);
+            }
+
+            engine.retire_last_group();
 
-            if (!all_sat && !count) {
-                /* no further work needed here ... */
+            if (sat::status_t::STATUS_UNKNOWN == status) {
                 break;
-            } else {
-                exclude_state(engine);
             }
-        } /* while (true) */
+        }
+    }
 
-        TRACE
-            << "Found "
-            << feasible
-            << " feasible states"
-            << std::endl;
+    /* synchronized, adds delta and yields the total */
+    value_t Simulation::sync_enumerated(value_t delta)
+    {
+        boost::mutex::scoped_lock lock { f_enumerated_mutex };
 
-        return feasible;
+        f_enumerated = (std::numeric_limits<value_t>::max() - f_enumerated < delta)
+                           ? std::numeric_limits<value_t>::max()
+                           : f_enumerated + delta;
+
+        return f_enumerated;
     }
 
     simulation_status_t Simulation::simulate(expr::ExprVector constraints,
-                                             pconst_char trace_name)
+                                             pconst_char trace_name, step_t n)
     {
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
         sat::status_t last_sat;
@@ -240,8 +688,6 @@ namespace sim {
         clock_t t0 { clock() }, t1;
         double secs;
 
-        sat::Engine engine { "simulation" };
-
         expr::Atom trace_uid {
             trace_name ? expr::Atom(trace_name) : wm.current().id()
         };
@@ -249,27 +695,72 @@ namespace sim {
 
         set_witness(trace);
 
+        /* the engine of the previous step is resumed, unless the
+           trace has changed since */
+        Session& session { SessionMgr::INSTANCE().session(model(), trace) };
+        sat::Engine& engine { session.engine() };
+
+        /* the last command using this engine may have been
+           interrupted, or have had a conflict budget */
+        engine.clear_interrupt();
+        engine.configure(-1, -1);
+        setup_engine(engine);
+
+        step_t k { trace.last_time() };
+
+        expr::Expr_ptr ctx { em().make_empty() };
+        compiler::Units constraint_cus;
+        for (auto constraint : constraints) {
+            TRACE
+                << "Compiling constraint `"
+                << constraint
+                << "` ..."
+                << std::endl;
+
+            constraint_cus.push_back(compiler().process(ctx, constraint));
+        }
+
         /* here we need to push all the values for variables in the
          * last state of resuming witness. A complete assignment to
          * *all* state variables guarantees full deterministic
-         * behavior. */
-        step_t init_time { trace.last_time() }, k { init_time };
-        witness::TimeFrame& last { trace.last() };
+         * behavior. Trace may not be compatible with current state's
+         * INVARs. On a resumed session, the last frame is already
+         * pinned by the previous step. */
+        if (!session.initialized()) {
+            witness::TimeFrame& last { trace.last() };
+
+            assert_time_frame(engine, k, last);
+            assert_fsm_invar(engine, k);
+        }
 
-        assert_time_frame(engine, k, last);
+        /* inject full transition relation, n steps at once, with
+           the additional constraints on each new frame */
+        step_t first { k };
+        for (step_t i = 0; i < n; ++i) {
+            assert_fsm_trans(engine, first + i);
+            assert_fsm_invar(engine, first + i + 1);
 
-        /* inject full transition relation, trace may not be
-           compatible with current state's INVARs */
-        assert_fsm_invar(engine, k);
-        assert_fsm_trans(engine, k);
-        assert_fsm_invar(engine, 1 + k);
+            for (auto& cu : constraint_cus) {
+                assert_formula(engine, first + i + 1, cu);
+            }
+        }
+
+        /* states seldom change much from one step to the next, the
+           last one (e.g. by pick-state) is the first guess for the
+           new frames */
+        algorithms::FramePhases phases;
+        frame_phases(trace.last(), phases);
+        for (step_t i = 0; i < n; ++i) {
+            seed_phases(engine, first + i + 1, phases);
+        }
 
         DEBUG
             << "Running simulation..."
             << std::endl;
 
+        engine.set_step(first + n);
         if (sat::status_t::STATUS_SAT == (last_sat = engine.solve())) {
-            ++k;
+            k = first + n;
 
             t1 = clock();
             secs = (double) (t1 - t0) / (double) CLOCKS_PER_SEC;
@@ -279,10 +770,26 @@ namespace sim {
                 << ", took " << secs << " seconds"
                 << std::endl;
 
-            t0 = t1; // resetting clock
+            /* the whole extension comes from a single model */
+            for (step_t time = first + 1; time <= k; ++time) {
+                witness::Witness& w { *new SimulationWitness(model(), engine, time) };
+                witness().extend(w);
+            }
+
+            /* the next step starts from here, older frames are
+               never referred to again */
+            pin_state(engine, k);
+            session.set_depth(k);
+
+            for (step_t time = first; time < k; ++time) {
+                engine.release_frame(time);
+            }
+        }
 
-            witness::Witness& w { *new SimulationWitness(model(), engine, k) };
-            witness().extend(w);
+        else {
+            /* the transition out of the last frame was asserted for
+               good, the engine can not be resumed */
+            SessionMgr::INSTANCE().clear();
         }
 
         if (sat::status_t::STATUS_SAT == last_sat) {
@@ -303,7 +810,8 @@ namespace sim {
 
         if (sat::status_t::STATUS_UNSAT == last_sat) {
             INFO
-                << "Inconsistency detected in transition relation at step " << k
+                << "Inconsistency detected in transition relation within "
+                << n << " steps from step " << k
                 << std::endl;
 
             return SIMULATION_DEADLOCKED;
@@ -27,6 +27,9 @@
 #ifndef SIMULATION_ALGORITHM_H
 #define SIMULATION_ALGORITHM_H
 
+#include <istream>
+#include <random>
+
 #include <algorithms/base.hh>
 
 #include <witness/witness.hh>
@@ -49,17 +52,186 @@ namespace sim {
         Simulation(cmd::Command& command, model::Model& model);
         ~Simulation();
 
-        // returns the number of enumerated states
-        value_t pick_state(expr::ExprVector constraints, bool all_sat, bool count, value_t limit);
-
-        // returns the status of the simulation
-        simulation_status_t simulate(expr::ExprVector constraints, pconst_char trace_uid);
+        // returns the number of enumerated states, with ALLSAT states
+        // are distinct on the projection vars (all state vars if empty).
+        // ALLSAT runs up to jobs enumerations in parallel
+        value_t pick_state(expr::ExprVector constraints, expr::ExprVector projection,
+                           bool all_sat, bool count, value_t limit, unsigned jobs = 1);
+
+        // returns the number of feasible constraint sets. INITs and
+        // INVARs are asserted once, each set is solved under a group
+        // of its own on the same engine (or on up to jobs forks of it).
+        // One witness is registered per feasible set, in order (NULL
+        // in witnesses for the others)
+        value_t pick_states(const std::vector<expr::ExprVector>& sets, unsigned jobs,
+                            std::vector<witness::Witness_ptr>& witnesses);
+
+        // returns the number of states sampled (up to n), distinct on
+        // the projection vars (all state vars if empty), near-uniformly
+        // by random XOR hashing (see sampling.cc). One witness is
+        // registered per sample
+        value_t sample_states(expr::ExprVector constraints, expr::ExprVector projection,
+                              value_t n);
+
+        // returns an approximate count of the feasible initial states,
+        // distinct on the projection vars, by random XOR hashing
+        value_t approx_count_states(expr::ExprVector constraints,
+                                    expr::ExprVector projection);
+
+        // returns the status of the simulation, the trace is extended
+        // by n steps solved at once. Constraints apply to each new step
+        simulation_status_t simulate(expr::ExprVector constraints, pconst_char trace_uid,
+                                     step_t n = 1);
+
+        // returns the status of the random simulation. n steps are
+        // taken out of the last state of the trace by concrete
+        // evaluation, with random non-deterministic choices, or by SAT
+        // when that fails. One state every period steps is recorded,
+        // in a new witness
+        simulation_status_t random_simulate(expr::ExprVector constraints,
+                                            pconst_char trace_uid,
+                                            step_t n, step_t period);
+
+        // returns the status of the bit-parallel random simulation.
+        // 64 simulations of n steps are run at once out of random
+        // initial states, on the BDDs of the FSM. One witness is
+        // recorded per simulation, with one state every period steps
+        // (UNKNOWN if the BDDs can not be built)
+        simulation_status_t lanes_simulate(expr::ExprVector constraints,
+                                           step_t n, step_t period);
+
+        // returns the status of the input-driven simulation. The trace
+        // is extended by one step per input vector read from is, by
+        // concrete evaluation where the FSM is deterministic given the
+        // inputs, or by SAT where it is not (see concrete.cc)
+        simulation_status_t stream_simulate(expr::ExprVector constraints,
+                                            pconst_char trace_uid, std::istream& is);
 
     private:
         expr::ExprVector f_constraints;
 
+        /* random simulation */
+        std::mt19937_64 f_rng;
+
+        /* a TRANS, as seen by concrete evaluation: next(lhs) is
+           assigned the value of rhs (or one of choices, if any)
+           whenever guard holds. TRANSes of any other form are just
+           checked (i.e. lhs is NULL) */
+        struct ConcreteTrans {
+            expr::Expr_ptr ctx;
+            expr::Expr_ptr guard;
+            expr::Expr_ptr lhs;
+            expr::Expr_ptr rhs;
+            expr::ExprVector choices;
+        };
+        typedef std::vector<ConcreteTrans> ConcreteTransVector;
+
+        /* (ctx, expr) pairs */
+        typedef std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> ConcreteExprs;
+
+        /* (full name, var) pairs for state vars */
+        typedef std::vector<std::pair<expr::Expr_ptr, symb::Variable_ptr>> ConcreteVars;
+
+        typedef enum {
+            CONCRETE_DONE,
+            CONCRETE_POSTPONED,
+            CONCRETE_FAILED,
+        } concrete_status_t;
+
+        /* false iff some part of the FSM can not be evaluated */
+        bool collect_concrete_fsm(ConcreteTransVector& trans, ConcreteExprs& invars,
+                                  ConcreteVars& vars);
+        bool classify_trans(expr::Expr_ptr ctx, expr::Expr_ptr body, ConcreteTrans& res);
+
+        bool random_value(type::Type_ptr type, expr::Expr_ptr& res);
+        /* if deterministic, non-deterministic choices and state vars
+           left unassigned fail the step, instead of being made at
+           random */
+        concrete_status_t apply_trans(witness::Witness& scratch, ConcreteTrans& ct,
+                                      bool deterministic);
+        bool concrete_step(witness::Witness& scratch, ConcreteTransVector& trans,
+                           ConcreteExprs& invars, ConcreteExprs& constraints,
+                           ConcreteVars& vars, bool deterministic = false);
+        void record_frame(witness::Witness& w, witness::Witness& scratch, ConcreteVars& vars);
+
+        /* the step out of frame 0 of scratch by SAT, frame 1 is added
+           to scratch with the values of vars, if any */
+        sat::status_t sat_step(witness::Witness& scratch, const expr::ExprVector& constraints,
+                               ConcreteVars& vars);
+
+        /* bit-parallel simulation */
+        void record_lane_frame(witness::Witness& w, algorithms::LaneSimulator& lanes,
+                               unsigned lane);
+
+        /* ALLSAT partition, witnesses are registered at the end */
+        struct Partition {
+            std::vector<witness::Witness_ptr> witnesses;
+        };
+        typedef std::vector<Partition> Partitions;
+
+        boost::mutex f_enumerated_mutex;
+        value_t f_enumerated;
+
+        boost::mutex f_witnesses_mutex;
+
+        /* enumerates the states in the index-th cube over the first p
+           bits */
+        void enumerate_partition(compiler::Units& constraint_cus, std::vector<enc::UCBI>& bits,
+                                 unsigned p, unsigned index, bool count, value_t limit,
+                                 Partition& partition);
+
+        /* synchronized, adds delta and yields the total */
+        value_t sync_enumerated(value_t delta);
+
+        /* the sets first, first + stride, .. in turn on engine */
+        void pick_sets(sat::Engine& engine, const std::vector<compiler::Units>& set_cus,
+                       unsigned first, unsigned stride,
+                       std::vector<witness::Witness_ptr>& witnesses);
+
         void extract_witness(sat::Engine& engine, bool select_current_witness);
-        void exclude_state(sat::Engine& engine);
+        void register_witness(witness::Witness& w, bool select_current_witness);
+
+        /* a single initial state, on the SMT solver of --smt-solver. False
+           iff the solver could not decide, feasible is set otherwise */
+        bool smt_pick_state(const expr::ExprVector& constraints, value_t& feasible);
+
+        /* encoding bits of the projection vars */
+        void collect_bits(const expr::ExprVector& projection, std::vector<enc::UCBI>& bits);
+
+        /* counts the feasible states over bits on the initial states
+           DD. False iff the DD could not be built */
+        bool count_states(const compiler::Units& constraint_cus,
+                          const std::vector<enc::UCBI>& bits, value_t& res);
+
+        /* excludes the cube of engine's model over bits, enlarged by
+           failed assumption analysis on the dual engine (the first
+           n_kept bits are never dropped). Returns the number of bits
+           dropped from the cube */
+        unsigned exclude_cube(sat::Engine& engine, sat::Engine& dual,
+                              sat::VarVector& disjuncts, const std::vector<enc::UCBI>& bits,
+                              unsigned n_kept = 0);
+
+        /* random XOR hashing, the states of a cell by their values
+           on the projection bits */
+        typedef std::vector<std::vector<bool>> Cubes;
+
+        /* INITs, INVARs and constraints at time 0 */
+        void setup_sampling(sat::Engine& engine, const expr::ExprVector& constraints);
+
+        /* m random XORs over bits, enabled by the returned selector */
+        Var add_xors(sat::Engine& engine, const std::vector<enc::UCBI>& bits, unsigned m);
+
+        /* the states of the cell of selector, up to limit + 1 of them.
+           The selector is retired. False iff interrupted */
+        bool enumerate_cell(sat::Engine& engine, const std::vector<enc::UCBI>& bits,
+                            Var selector, unsigned limit, Cubes& res);
+
+        /* exact, for small sets of states. False iff interrupted */
+        bool hashed_count(sat::Engine& engine, const std::vector<enc::UCBI>& bits,
+                          value_t& res);
+
+        /* asserts the state at time in engine's model, for good */
+        void pin_state(sat::Engine& engine, step_t time);
     };
 
     class SimulationWitness: public witness::Witness {
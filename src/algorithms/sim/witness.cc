@@ -25,6 +25,7 @@
 
 #include <env/environment.hh>
 
+#include <witness/decoder.hh>
 #include <witness/witness.hh>
 #include <witness/witness_mgr.hh>
 
@@ -34,27 +35,21 @@
 #include <symb/symb_iter.hh>
 #include <symb/typedefs.hh>
 
+#include <utils/profile.hh>
+#include <utils/trace.hh>
+
 namespace sim {
 
     SimulationWitness::SimulationWitness(model::Model& model, sat::Engine& engine, step_t k)
         : Witness(&engine)
     {
-        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
-        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
-
-        int inputs[bm.nbits()];
-
-        /* Collecting symbols for the witness' language */
-        symb::SymbIter si { model };
-        while (si.has_next()) {
-            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+        utils::ProfileScope scope { "witness" };
+        utils::TraceScope trace { "extract", "witness" };
 
-            expr::Expr_ptr ctx { pair.first };
-            symb::Symbol_ptr symb { pair.second };
-
-            expr::Expr_ptr full_name { em.make_dot(ctx, symb->name()) };
-            f_lang.push_back(full_name);
-        }
+        /* INPUT vars are in fact bodyless, typed DEFINEs */
+        boost::shared_ptr<witness::ModelDecoder> decoder {
+            new witness::ModelDecoder(*this, model, false)
+        };
 
         /* just step `k` */
         witness::TimeFrame& tf { extend() };
@@ -62,81 +57,23 @@ namespace sim {
 
         while (symbols.has_next()) {
             std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
-            expr::Expr_ptr ctx { pair.first };
             symb::Symbol_ptr symb { pair.second };
-            expr::Expr_ptr symb_name { symb->name() };
-            expr::Expr_ptr key { em.make_dot(ctx, symb_name) };
 
-            if (symb->is_variable()) {
-                const symb::Variable& var { symb->as_variable() };
+            if (symb->is_variable() && symb->as_variable().is_input()) {
+                expr::Expr_ptr symb_name { symb->name() };
+                expr::Expr_ptr value { env::Environment::INSTANCE().get(symb_name) };
 
-                /* INPUT vars are in fact bodyless, typed DEFINEs */
-                if (var.is_input()) {
-                    expr::Expr_ptr value { env::Environment::INSTANCE().get(symb_name) };
-
-                    if (value) {
-                        tf.set_value(key, value, symb->format());
-                    }
-                }
-
-                else {
-                    /* time it, and fetch encoding for enc mgr */
-                    enc::Encoding_ptr enc { bm.find_encoding(expr::TimedExpr(key, 0)) };
-
-                    /* not in COI, skipping... */
-                    if (!enc) {
-                        continue;
-                    }
-
-                    /* 1. for each bit int the encoding, fetch UCBI,
-                     * time it into TCBI, fetch its value in solver
-                     * model and set the corresponding entry in inputs
-                     * array. */
-                    dd::DDVector::const_iterator di;
-                    unsigned ndx;
-                    for (ndx = 0, di = enc->bits().begin();
-                         enc->bits().end() != di; ++ndx, ++di) {
-
-                        unsigned bit { (*di).getNode()->index };
-                        const enc::UCBI& ucbi { bm.find_ucbi(bit) };
-                        const enc::TCBI tcbi { enc::TCBI(ucbi, k) };
-                        Var var { engine.tcbi_to_var(tcbi) };
-
-                        /* Don't care is assigned to 0 */
-                        int value { engine.value(var) };
-                        inputs[bit] = value;
-                    }
-
-                    /* 2. eval the encoding DDs with inputs and put
-                     * resulting value into time frame container. */
-                    expr::Expr_ptr value { enc->expr(inputs) };
-                    if (value) {
-                        tf.set_value(key, value, symb->format());
-                    }
-                }
-            }
-
-            else if (symb->is_define()) {
-                witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
-                const symb::Define& define { symb->as_define() };
-                expr::Expr_ptr body { define.body() };
-
-                try {
-                    expr::Expr_ptr value { wm.eval(*this, ctx, body, 0) };
-                    if (value) {
-                        tf.set_value(key, value);
-                    }
-                }
-
-                catch (witness::NoValue& nv) {
-                    WARN
-                        << "Cannot evaluate define `"
-                        << key
-                        << " `"
-                        << std::endl;
+                if (value) {
+                    tf.set_value(expr::ExprMgr::INSTANCE().make_dot(pair.first, symb_name),
+                                 value, symb->format());
                 }
             }
         }
+
+        /* other symbols are decoded on first access */
+        std::vector<bool> bits;
+        decoder->capture(engine, k, bits);
+        tf.set_lazy(decoder, bits);
     }
 
 } // namespace sim
@@ -0,0 +1,308 @@
+/**
+ * @file smt.cc
+ * @brief Word-level SMT unrolling of the FSM, implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <stack>
+
+#include <algorithms/smt.hh>
+
+#include <env/environment.hh>
+
+#include <symb/classes.hh>
+#include <symb/symb_iter.hh>
+
+#include <type/classes.hh>
+
+#include <witness/exceptions.hh>
+#include <witness/witness_mgr.hh>
+
+#include <utils/logging.hh>
+
+namespace algorithms {
+
+    SmtUnrolling::SmtUnrolling(model::Model& model, const std::string& command)
+        : f_model(model)
+        , f_solver(command)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        /* walk of the module instances, as for the compiled FSM */
+        std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
+        stack.push(std::pair<expr::Expr_ptr, model::Module_ptr>(em.make_empty(),
+                                                                &model.main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, model::Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            model::Module& module { *top.second };
+
+            for (auto body : module.init()) {
+                f_init.push_back(std::make_pair(ctx, body));
+            }
+            for (auto body : module.invar()) {
+                f_invar.push_back(std::make_pair(ctx, body));
+            }
+            for (auto body : module.trans()) {
+                f_trans.push_back(std::make_pair(ctx, body));
+            }
+
+            symb::Variables attrs { module.vars() };
+            for (auto vi = attrs.begin(); attrs.end() != vi; ++vi) {
+                type::Type_ptr vtype { vi->second->type() };
+                if (vtype->is_instance()) {
+                    model::Module& instance { model.module(vtype->as_instance()->name()) };
+                    stack.push(std::pair<expr::Expr_ptr, model::Module_ptr>(
+                        em.make_dot(ctx, vi->first), &instance));
+                }
+            }
+        }
+
+        /* environment constraints */
+        env::Environment& env { env::Environment::INSTANCE() };
+        expr::Expr_ptr empty { em.make_empty() };
+        for (auto body : env.extra_init()) {
+            f_init.push_back(std::make_pair(empty, body));
+        }
+        for (auto body : env.extra_invar()) {
+            f_invar.push_back(std::make_pair(empty, body));
+        }
+        for (auto body : env.extra_trans()) {
+            f_trans.push_back(std::make_pair(empty, body));
+        }
+    }
+
+    SmtUnrolling::~SmtUnrolling()
+    {}
+
+    bool SmtUnrolling::start(sat::SmtStopPredicate stop)
+    {
+        f_solver.set_stop(stop);
+        if (f_solver.start()) {
+            return true;
+        }
+
+        WARN
+            << "Could not start SMT solver `"
+            << f_solver.name()
+            << "`"
+            << std::endl;
+
+        return false;
+    }
+
+    bool SmtUnrolling::assert_init(step_t time)
+    {
+        return assert_sections(f_init, time);
+    }
+
+    bool SmtUnrolling::assert_invar(step_t time)
+    {
+        return assert_sections(f_invar, time);
+    }
+
+    bool SmtUnrolling::assert_trans(step_t time)
+    {
+        return assert_sections(f_trans, time);
+    }
+
+    bool SmtUnrolling::assert_sections(const SmtSections& sections, step_t time)
+    {
+        for (const auto& section : sections) {
+            if (!assert_formula(section.first, section.second, time)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool SmtUnrolling::assert_formula(expr::Expr_ptr ctx, expr::Expr_ptr body, step_t time)
+    {
+        std::string preamble;
+        std::string term;
+
+        try {
+            term = f_lowering.process(ctx, body, time, preamble);
+        } catch (compiler::UnsupportedLowering& ul) {
+            WARN
+                << ul.what()
+                << std::endl
+                << "  in "
+                << ctx << "::" << body
+                << ", no SMT lowering"
+                << std::endl;
+
+            return false;
+        }
+
+        return f_solver.command(preamble + "(assert " + term + ")");
+    }
+
+    bool SmtUnrolling::push()
+    {
+        return f_solver.command("(push 1)");
+    }
+
+    bool SmtUnrolling::pop()
+    {
+        return f_solver.command("(pop 1)");
+    }
+
+    sat::status_t SmtUnrolling::check()
+    {
+        return f_solver.check();
+    }
+
+    bool SmtUnrolling::extract(witness::Witness& w, const std::vector<step_t>& times)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        struct Entry {
+            expr::Expr_ptr ctx;
+            expr::Expr_ptr key;
+            value_format_t format;
+
+            /* NULL for vars */
+            expr::Expr_ptr body;
+
+            /* NULL for defines and INPUT vars */
+            type::Type_ptr type;
+            bool frozen;
+        };
+
+        std::vector<Entry> entries;
+        symb::SymbIter si { f_model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+            expr::Expr_ptr key { em.make_dot(ctx, symb->name()) };
+
+            Entry entry { ctx, key, symb->format(), NULL, NULL, false };
+            if (symb->is_define()) {
+                entry.body = symb->as_define().body();
+            } else if (symb->is_variable()) {
+                const symb::Variable& var { symb->as_variable() };
+                if (var.is_input() || var.type()->is_instance()) {
+                    continue;
+                }
+
+                entry.type = var.type();
+                entry.frozen = var.is_frozen();
+            } else {
+                continue;
+            }
+
+            w.add_symbol(key);
+            entries.push_back(entry);
+        }
+
+        for (step_t time : times) {
+            /* the consts of all vars, in a single query */
+            std::string preamble;
+            std::vector<std::string> terms;
+            for (const auto& entry : entries) {
+                if (NULL != entry.type) {
+                    f_lowering.var_consts(entry.key, entry.type, entry.frozen, time, terms,
+                                          preamble);
+                }
+            }
+
+            /* consts never asserted upon are declared now */
+            std::vector<std::string> values;
+            if ((!preamble.empty() && !f_solver.command(preamble)) ||
+                !f_solver.values(terms, values)) {
+                return false;
+            }
+
+            witness::TimeFrame& tf { w.extend() };
+
+            unsigned j { 0 };
+            for (const auto& entry : entries) {
+                if (NULL == entry.type) {
+                    continue;
+                }
+
+                if (entry.type->is_array()) {
+                    type::ArrayType_ptr at { entry.type->as_array() };
+
+                    expr::Expr_ptr acc { NULL };
+                    std::vector<expr::Expr_ptr> elements;
+                    for (unsigned k = 0; k < at->nelems(); ++k) {
+                        elements.push_back(f_lowering.decode(at->of(), values[j++]));
+                    }
+                    for (auto e = elements.rbegin(); elements.rend() != e; ++e) {
+                        if (NULL == *e) {
+                            acc = NULL;
+                            break;
+                        }
+                        acc = NULL == acc ? *e : em.make_array_comma(*e, acc);
+                    }
+
+                    if (NULL != acc) {
+                        tf.set_value(entry.key, em.make_array(acc), entry.format);
+                    }
+                } else {
+                    expr::Expr_ptr value { f_lowering.decode(entry.type, values[j++]) };
+                    if (NULL != value) {
+                        tf.set_value(entry.key, value, entry.format);
+                    }
+                }
+            }
+        }
+
+        /* DEFINEs, once all frames are there */
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        step_t first { (step_t) (1 + w.last_time() - times.size()) };
+        for (step_t i = first; i <= w.last_time(); ++i) {
+            witness::TimeFrame& tf { w[i] };
+
+            for (const auto& entry : entries) {
+                if (NULL == entry.body) {
+                    continue;
+                }
+
+                try {
+                    expr::Expr_ptr value {
+                        wm.eval(w, entry.ctx, entry.body, w.time_of(tf))
+                    };
+
+                    /* NULL values here indicate UNDEFs */
+                    if (value) {
+                        tf.set_value(entry.key, value, entry.format);
+                    }
+                } catch (witness::NoValue& nv) {
+                    WARN
+                        << "Cannot evaluate define `"
+                        << entry.key
+                        << "`"
+                        << std::endl;
+                }
+            }
+        }
+
+        return true;
+    }
+
+} // namespace algorithms
@@ -0,0 +1,98 @@
+/**
+ * @file smt.hh
+ * @brief Word-level SMT unrolling of the FSM
+ *
+ * This header file contains the declarations of the FSM unrolling on
+ * an SMT solver (sat/smt.hh), the word-level alternative to the SAT
+ * engines used by algorithms. INITs, INVARs and TRANSes (environment
+ * constraints included) are lowered by compiler::SmtLowering when
+ * asserted, i.e. with no bit-blasting, and witnesses are extracted
+ * from the values the solver assigns to the consts of the vars.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef ALGORITHMS_SMT_H
+#define ALGORITHMS_SMT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <compiler/smtlib.hh>
+
+#include <model/model.hh>
+#include <model/module.hh>
+
+#include <sat/smt.hh>
+
+#include <witness/witness.hh>
+
+namespace algorithms {
+
+    class SmtUnrolling {
+    public:
+        SmtUnrolling(model::Model& model, const std::string& command);
+        ~SmtUnrolling();
+
+        /* false iff the solver could not be started */
+        bool start(sat::SmtStopPredicate stop);
+
+        /* the assertions below are false iff the exprs can not be
+           lowered, or the solver is lost. Nothing is asserted then,
+           and the unrolling is no longer usable */
+        bool assert_init(step_t time);
+        bool assert_invar(step_t time);
+        bool assert_trans(step_t time);
+        bool assert_formula(expr::Expr_ptr ctx, expr::Expr_ptr body, step_t time);
+
+        /* assertion scopes */
+        bool push();
+        bool pop();
+
+        sat::status_t check();
+
+        /* appends a frame to w for each time, after a SAT check. Vars
+           are taken from the solver, DEFINEs are evaluated then */
+        bool extract(witness::Witness& w, const std::vector<step_t>& times);
+
+        inline const std::string& name() const
+        {
+            return f_solver.name();
+        }
+
+    private:
+        /* (ctx, body) */
+        typedef std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> SmtSections;
+
+        bool assert_sections(const SmtSections& sections, step_t time);
+
+        model::Model& f_model;
+
+        sat::SmtSolver f_solver;
+        compiler::SmtLowering f_lowering;
+
+        SmtSections f_init;
+        SmtSections f_invar;
+        SmtSections f_trans;
+    };
+
+} // namespace algorithms
+
+#endif /* ALGORITHMS_SMT_H */
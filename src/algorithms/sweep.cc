@@ -0,0 +1,296 @@
+/**
+ * @file sweep.cc
+ * @brief Constant sweeping of the compiled FSM.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <ctime>
+
+#include <base.hh>
+#include <lanes.hh>
+
+#include <opts/opts_mgr.hh>
+
+/* bit-parallel pre-filtering of candidates, before SAT pruning */
+static const int sweep_lanes_node_limit { 1 << 16 };
+static const unsigned sweep_lanes_steps { 64 };
+
+namespace algorithms {
+
+    /* Bits stuck by ternary simulation (--ternary-sim) are constant
+     * already. With --sweep, the other constants are found on SAT
+     * under them, see sweep_candidates(). */
+    void Algorithm::sweep()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+
+        std::vector<enc::UCBI> bits;
+        collect_state_bits(bits);
+
+        if (bits.empty()) {
+            return;
+        }
+
+        FixedBits stuck;
+        if (om.ternary_sim()) {
+            ternary_simulation(bits, stuck);
+        }
+
+        FixedBits candidates;
+        if (om.sweep() && !sweep_candidates(bits, stuck, candidates)) {
+            candidates.clear();
+        }
+        candidates.insert(candidates.end(), stuck.begin(), stuck.end());
+
+        unsigned n_fixed { (unsigned) candidates.size() };
+        unsigned n_bits { (unsigned) bits.size() };
+        INFO
+            << "Sweeping: "
+            << n_fixed
+            << " out of "
+            << n_bits
+            << " state bits are constant"
+            << std::endl;
+
+        if (candidates.empty()) {
+            return;
+        }
+
+        sat::FixedBitsMap fixed;
+        for (const auto& candidate : candidates) {
+            const enc::UCBI& ucbi { candidate.first };
+            const enc::TCBI key { enc::UCBI(ucbi.expr(), FROZEN, ucbi.bitno()), 0 };
+            fixed[key] = candidate.second;
+        }
+
+        for (auto* units : { &f_init, &f_not_init, &f_invar, &f_trans }) {
+            for (auto& unit : *units) {
+                unit = substitute(unit, fixed);
+            }
+        }
+
+        /* templates were built on the original units */
+        f_invar_templates.clear();
+        f_trans_templates.clear();
+        f_templates_ready = false;
+
+        f_fixed_bits = candidates;
+    }
+
+    /* Candidate constants are taken from an initial state, then
+     * pruned by any initial state violating them, and by any
+     * transition from a state satisfying all of them to one violating
+     * some (Houdini). What is left holds in all initial states and is
+     * inductive, i.e. it holds in all reachable states. The known
+     * constants are not candidates, they are fixed in both engines:
+     * holding in all reachable states, they strengthen induction. */
+    bool Algorithm::sweep_candidates(const std::vector<enc::UCBI>& bits,
+                                     const FixedBits& known, FixedBits& res)
+    {
+        boost::unordered_set<enc::UCBI, enc::UCBIHash, enc::UCBIEq> fixed;
+        for (const auto& bit : known) {
+            fixed.insert(bit.first);
+        }
+
+        FixedBits candidates;
+
+        {
+            sat::Engine engine { "sweep_init" };
+            setup_engine(engine);
+
+            for (const auto& bit : known) {
+                engine.fix_bit(bit.first, bit.second);
+            }
+
+            assert_fsm_init(engine, 0);
+            assert_fsm_invar(engine, 0);
+
+            if (sat::status_t::STATUS_SAT != engine.solve()) {
+                return false;
+            }
+
+            for (const auto& ucbi : bits) {
+                if (0 == fixed.count(ucbi)) {
+                    Var var { engine.tcbi_to_var(enc::TCBI(ucbi, 0)) };
+                    candidates.push_back(std::make_pair(ucbi, 1 == engine.value(var)));
+                }
+            }
+
+            simulate_candidates(candidates);
+
+            if (!prune_candidates(engine, candidates, 0)) {
+                return false;
+            }
+        }
+
+        {
+            sat::Engine engine { "sweep_step" };
+            setup_engine(engine);
+
+            for (const auto& bit : known) {
+                engine.fix_bit(bit.first, bit.second);
+            }
+
+            assert_fsm_invar(engine, 0);
+            assert_fsm_trans(engine, 0);
+            assert_fsm_invar(engine, 1);
+
+            if (!prune_candidates(engine, candidates, 1)) {
+                return false;
+            }
+        }
+
+        res = candidates;
+        return true;
+    }
+
+    void Algorithm::simulate_candidates(FixedBits& candidates)
+    {
+        LaneSimulator_ptr lanes {
+            make_lane_simulator(compiler::Units(), sweep_lanes_node_limit, time(NULL))
+        };
+
+        if (!lanes) {
+            return;
+        }
+
+        std::vector<int> indexes;
+        for (const auto& candidate : candidates) {
+            const enc::UCBI& ucbi { candidate.first };
+            enc::Encoding_ptr enc {
+                f_bm.find_encoding(expr::TimedExpr(ucbi.expr(), ucbi.time()))
+            };
+            assert(NULL != enc);
+
+            indexes.push_back(enc->bits()[ucbi.bitno()].getNode()->index);
+        }
+
+        lanes_t alive { lanes->initialize() };
+        for (unsigned k = 0; alive && k < sweep_lanes_steps && !candidates.empty(); ++k) {
+            FixedBits kept;
+            std::vector<int> kept_indexes;
+
+            for (unsigned i = 0; i < candidates.size(); ++i) {
+                lanes_t value { lanes->value(indexes[i]) & alive };
+
+                if (value == (candidates[i].second ? alive : 0)) {
+                    kept.push_back(candidates[i]);
+                    kept_indexes.push_back(indexes[i]);
+                }
+            }
+
+            candidates.swap(kept);
+            indexes.swap(kept_indexes);
+
+            alive = lanes->step();
+        }
+
+        delete lanes;
+    }
+
+    bool Algorithm::prune_candidates(sat::Engine& engine, FixedBits& candidates, step_t time)
+    {
+        while (!candidates.empty()) {
+            sat::group_t group { engine.new_group() };
+
+            /* some candidate is violated at time... */
+            vec<Lit> ps;
+            ps.push(mkLit(group, true));
+
+            for (const auto& candidate : candidates) {
+                Var var { engine.tcbi_to_var(enc::TCBI(candidate.first, time)) };
+                ps.push(mkLit(var, candidate.second));
+
+                /* ... while all of them hold at time - 1 */
+                if (0 < time) {
+                    Var prev { engine.tcbi_to_var(enc::TCBI(candidate.first, time - 1)) };
+
+                    vec<Lit> unit;
+                    unit.push(mkLit(group, true));
+                    unit.push(mkLit(prev, !candidate.second));
+                    engine.add_clause(unit);
+                }
+            }
+            engine.add_clause(ps);
+
+            sat::status_t status { engine.solve() };
+
+            if (sat::status_t::STATUS_UNKNOWN == status) {
+                return false;
+            }
+
+            else if (sat::status_t::STATUS_UNSAT == status) {
+                engine.retire_last_group();
+                break;
+            }
+
+            FixedBits kept;
+            for (const auto& candidate : candidates) {
+                Var var { engine.tcbi_to_var(enc::TCBI(candidate.first, time)) };
+                if ((1 == engine.value(var)) == candidate.second) {
+                    kept.push_back(candidate);
+                }
+            }
+
+            engine.retire_last_group();
+            candidates = kept;
+        }
+
+        return true;
+    }
+
+    compiler::Unit Algorithm::substitute(const compiler::Unit& unit,
+                                         const sat::FixedBitsMap& fixed)
+    {
+        dd::DDVector dds;
+        for (auto dd : unit.dds()) {
+            for (auto index : dd.SupportIndices()) {
+                const enc::UCBI& ucbi { f_bm.find_ucbi(index) };
+                const enc::TCBI key { enc::UCBI(ucbi.expr(), FROZEN, ucbi.bitno()), 0 };
+
+                const sat::FixedBitsMap::const_iterator eye { fixed.find(key) };
+                if (fixed.end() != eye) {
+                    dd = dd.Compose(eye->second ? f_bm.one() : f_bm.zero(), index);
+                }
+            }
+
+            dds.push_back(dd);
+        }
+
+        /* microcode operands are fixed by the engines */
+        compiler::InlinedOperatorDescriptors inlined_operator_descriptors {
+            unit.inlined_operator_descriptors()
+        };
+        compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map {
+            unit.binary_selection_descriptors_map()
+        };
+        compiler::MultiwaySelectionDescriptors array_mux_descriptors {
+            unit.array_mux_descriptors()
+        };
+        compiler::AigDescriptors aig_descriptors {
+            unit.aig_descriptors()
+        };
+
+        return compiler::Unit(unit.expr(), dds, inlined_operator_descriptors,
+                              binary_selection_descriptors_map, array_mux_descriptors,
+                              aig_descriptors);
+    }
+
+} // namespace algorithms
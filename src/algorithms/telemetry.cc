@@ -0,0 +1,98 @@
+/**
+ * @file algorithms/telemetry.cc
+ * @brief Strategy telemetry class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithms/telemetry.hh>
+
+#include <utils/logging.hh>
+
+namespace algorithms {
+
+    Telemetry::Telemetry()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized Telemetry @ "
+            << instance
+            << std::endl;
+    }
+
+    Telemetry::~Telemetry()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Telemetry @ "
+            << instance
+            << std::endl;
+    }
+
+    void Telemetry::record(std::size_t model, const TaskStatsVector& stats,
+                           const std::string& winner)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        for (const auto& entry : stats) {
+            StrategyRecord& record { f_records[std::make_pair(model, entry.name)] };
+
+            ++record.runs;
+            if (entry.name == winner) {
+                ++record.decided;
+            }
+            if (entry.lagged) {
+                ++record.lagged;
+            }
+            record.steps += entry.step;
+            record.run_secs += entry.run_secs;
+
+            DEBUG
+                << "Strategy `"
+                << entry.name
+                << "`: step "
+                << entry.step
+                << ", "
+                << entry.run_secs
+                << "s running"
+                << (entry.lagged ? ", fell behind" : "")
+                << (entry.name == winner ? ", decided" : "")
+                << " ("
+                << record.decided
+                << " decided out of "
+                << record.runs
+                << " runs)"
+                << std::endl;
+        }
+    }
+
+    bool Telemetry::unpromising(std::size_t model, const std::string& strategy)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        const auto ri { f_records.find(std::make_pair(model, strategy)) };
+        if (f_records.end() == ri) {
+            return false;
+        }
+
+        const StrategyRecord& record { ri->second };
+        return 2 <= record.runs && 0 == record.decided && record.lagged == record.runs;
+    }
+
+}; // namespace algorithms
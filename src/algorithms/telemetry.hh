@@ -0,0 +1,90 @@
+/**
+ * @file algorithms/telemetry.hh
+ * @brief Strategy telemetry class declaration.
+ *
+ * This module contains the declaration of the record of how the
+ * strategies fared on the runs of each model: steps reached, time
+ * spent running, whether they fell behind the others (see the
+ * scheduler), and whether they decided the outcome. Algorithms look
+ * strategies up before starting them, those which never paid off on
+ * a model are given the lowest priority.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef ALGORITHMS_TELEMETRY_H
+#define ALGORITHMS_TELEMETRY_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <algorithms/scheduler.hh>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace algorithms {
+
+    /* a strategy on a model, over all runs */
+    struct StrategyRecord {
+        unsigned runs;
+        unsigned decided;
+        unsigned lagged;
+
+        step_t steps;
+        double run_secs;
+    };
+
+    class Telemetry;
+    typedef Telemetry* Telemetry_ptr;
+
+    class Telemetry {
+    public:
+        /* a run on the model of the given fingerprint, stats as
+           collected by the scheduler. Winner is the strategy which
+           decided the outcome, empty if none did */
+        void record(std::size_t model, const TaskStatsVector& stats,
+                    const std::string& winner);
+
+        /* true iff the strategy fell behind on every run on the model
+           so far (at least two), and never decided one */
+        bool unpromising(std::size_t model, const std::string& strategy);
+
+        static Telemetry& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static Telemetry_ptr instance { new Telemetry() };
+            return *instance;
+        }
+
+    protected:
+        Telemetry();
+        ~Telemetry();
+
+    private:
+        typedef std::pair<std::size_t, std::string> Key;
+        boost::unordered_map<Key, StrategyRecord> f_records;
+
+        boost::mutex f_mutex;
+    };
+
+}; // namespace algorithms
+
+#endif /* ALGORITHMS_TELEMETRY_H */
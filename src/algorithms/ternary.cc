@@ -0,0 +1,247 @@
+/**
+ * @file ternary.cc
+ * @brief Ternary simulation of the compiled FSM, stuck state bits.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+
+#include <base.hh>
+
+#include <dd/cudd_mgr.hh>
+
+namespace algorithms {
+
+    /* the values a state bit may take */
+    static const unsigned char ternary_zero { 1 };
+    static const unsigned char ternary_one { 2 };
+    static const unsigned char ternary_x { ternary_zero | ternary_one };
+
+    /* Each state bit is 0, 1 or X (either), bits start as valued in
+     * all initial states. At each round, a bit takes the values its
+     * next state is allowed by each TRANS (and next INVAR) partition
+     * on its own, from the states of the current values, X bits and
+     * inputs left free. The values are joined with those of the
+     * previous rounds, so that each round turns some bit to X or is
+     * the last one. Bits still 0 or 1 by then are so in all reachable
+     * states.
+     *
+     * Each partition is only cofactored by the cube of the current
+     * values, no BDD grows past the partitions. As with
+     * approximate_reachable(), units which are not plain DDs are left
+     * out, so are the environment constraints. */
+    void Algorithm::ternary_simulation(const std::vector<enc::UCBI>& bits, FixedBits& res)
+    {
+        std::vector<int> state;
+        std::vector<int> next;
+        fsm_state_bits(state, next);
+
+        /* the values by state bit, once done */
+        std::vector<unsigned char> values(state.size(), ternary_x);
+        unsigned n_rounds { 0 };
+        bool done { false };
+
+        /* all BDDs are gone before the manager is released */
+        dd::CuddMgr& cm { dd::CuddMgr::INSTANCE() };
+        Cudd& dd { cm.dd() };
+        {
+            dd::DDTransfer transfer { dd };
+            auto plain_units = [this, &transfer](const compiler::Units& units, unsigned n_env) {
+                dd::DDVector res;
+                for (unsigned i = 0; i + n_env < units.size(); ++i) {
+                    compiler::Units unit { units[i] };
+                    plain_dds(transfer, unit, res);
+                }
+
+                return res;
+            };
+
+            dd::DDVector init_dds { plain_units(f_init, f_n_env_inits) };
+            dd::DDVector invar_dds { plain_units(f_invar, f_n_env_invars) };
+            dd::DDVector trans_dds { plain_units(f_trans, f_n_env_transes) };
+
+            for (unsigned i = 0; i < state.size(); ++i) {
+                dd.bddVar(state[i]);
+                if (-1 != next[i]) {
+                    dd.bddVar(next[i]);
+                }
+            }
+
+            int size { dd.ReadSize() };
+
+            /* the bit of each current (and next) state var, and the
+               swap of the two */
+            std::vector<int> current_bit(size, -1);
+            std::vector<int> next_bit(size, -1);
+            std::vector<int> swap(size);
+            for (int index = 0; index < size; ++index) {
+                swap[index] = index;
+            }
+            for (unsigned i = 0; i < state.size(); ++i) {
+                current_bit[state[i]] = i;
+                if (-1 != next[i]) {
+                    next_bit[next[i]] = i;
+                    swap[state[i]] = next[i];
+                    swap[next[i]] = state[i];
+                }
+            }
+
+            std::vector<BDD> initial;
+            for (const auto& add : init_dds) {
+                initial.push_back(add.BddPattern());
+            }
+
+            std::vector<BDD> partitions;
+            for (const auto& add : trans_dds) {
+                partitions.push_back(add.BddPattern());
+            }
+            for (const auto& add : invar_dds) {
+                BDD bdd { add.BddPattern() };
+
+                initial.push_back(bdd);
+                partitions.push_back(bdd.Permute(&swap[0]));
+            }
+
+            /* the values of the bits of which (indices by bit) allowed
+               by all parts, from the states of cube. False iff some
+               part has no such states, i.e. no value is allowed */
+            auto allowed = [&](const std::vector<BDD>& parts, const BDD& cube,
+                               const std::vector<int>& which,
+                               std::vector<unsigned char>& res) {
+                res.assign(state.size(), ternary_x);
+                for (const auto& part : parts) {
+                    BDD bdd { part.Cofactor(cube) };
+                    if (bdd.IsZero()) {
+                        return false;
+                    }
+
+                    for (auto index : bdd.SupportIndices()) {
+                        int i { (int) index < size ? which[index] : -1 };
+                        if (-1 == i) {
+                            continue;
+                        }
+
+                        BDD var { dd.bddVar(index) };
+                        unsigned char value { 0 };
+                        if (!bdd.Cofactor(!var).IsZero()) {
+                            value |= ternary_zero;
+                        }
+                        if (!bdd.Cofactor(var).IsZero()) {
+                            value |= ternary_one;
+                        }
+
+                        res[i] &= value;
+                    }
+                }
+
+                return true;
+            };
+
+            /* no initial states, nothing to simulate */
+            done = allowed(initial, dd.bddOne(), current_bit, values) &&
+                   values.end() == std::find(values.begin(), values.end(), 0);
+
+            if (done) {
+                std::vector<unsigned char> image;
+
+                /* each round but the last one turns some bit to X */
+                for (unsigned round = 0; round <= state.size(); ++round) {
+                    if (limits_exceeded()) {
+                        done = false;
+                        break;
+                    }
+
+                    ++n_rounds;
+
+                    BDD cube { dd.bddOne() };
+                    for (unsigned i = 0; i < state.size(); ++i) {
+                        if (ternary_x != values[i]) {
+                            BDD var { dd.bddVar(state[i]) };
+                            cube &= (ternary_one == values[i]) ? var : !var;
+                        }
+                    }
+
+                    /* no successors, or none allowed by all parts */
+                    if (!allowed(partitions, cube, next_bit, image)) {
+                        break;
+                    }
+
+                    bool changed { false };
+                    for (unsigned i = 0; i < state.size(); ++i) {
+                        /* frozen bits keep their values */
+                        if (-1 == next[i] || !image[i]) {
+                            continue;
+                        }
+
+                        unsigned char joined { (unsigned char) (values[i] | image[i]) };
+                        if (joined != values[i]) {
+                            values[i] = joined;
+                            changed = true;
+                        }
+                    }
+
+                    if (!changed) {
+                        break;
+                    }
+                }
+            }
+        }
+        cm.release(dd);
+
+        if (!done) {
+            return;
+        }
+
+        /* the state bits at hand, by DD index */
+        std::vector<int> bit_of;
+        for (unsigned i = 0; i < state.size(); ++i) {
+            if ((int) bit_of.size() <= state[i]) {
+                bit_of.resize(state[i] + 1, -1);
+            }
+            bit_of[state[i]] = i;
+        }
+
+        for (const auto& ucbi : bits) {
+            enc::Encoding_ptr enc {
+                f_bm.find_encoding(expr::TimedExpr(ucbi.expr(), ucbi.time()))
+            };
+            assert(NULL != enc);
+
+            int index { (int) enc->bits()[ucbi.bitno()].getNode()->index };
+            int i { index < (int) bit_of.size() ? bit_of[index] : -1 };
+            if (-1 != i && ternary_x != values[i]) {
+                res.push_back(std::make_pair(ucbi, ternary_one == values[i]));
+            }
+        }
+
+        unsigned n_stuck { (unsigned) res.size() };
+        unsigned n_bits { (unsigned) bits.size() };
+        INFO
+            << "Ternary simulation: "
+            << n_stuck
+            << " out of "
+            << n_bits
+            << " state bits are stuck ("
+            << n_rounds
+            << " rounds)"
+            << std::endl;
+    }
+
+} // namespace algorithms
@@ -0,0 +1,188 @@
+/**
+ * @file bench.cc
+ * @brief Micro-benchmarks harness, implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <bench/bench.hh>
+#include <bench/perf.hh>
+
+#include <expr/expr_mgr.hh>
+
+#include <model/model_mgr.hh>
+
+#include <parse.hh>
+
+#include <jsoncpp/json/json.h>
+
+namespace bench {
+
+    const unsigned bench_widths[] = { 8, 16, 32, 64 };
+    const unsigned n_bench_widths { sizeof(bench_widths) / sizeof(bench_widths[0]) };
+
+    static inline double elapsed(const struct timespec& t0, const struct timespec& t1)
+    {
+        return (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+    }
+
+    void BenchRegistry::add(const std::string& name, BenchBatch batch)
+    {
+        f_benchmarks.push_back(std::make_pair(name, batch));
+    }
+
+    void BenchRegistry::run(std::ostream& os, const std::string& filter,
+                            double min_secs, bool json)
+    {
+        Json::Value root;
+        PerfCounters counters;
+
+        for (const auto& benchmark : f_benchmarks) {
+            const std::string& name { benchmark.first };
+            if (std::string::npos == name.find(filter)) {
+                continue;
+            }
+
+            /* one batch to warm up caches (and microcode) */
+            benchmark.second();
+
+            unsigned long ops { 0 };
+            unsigned long batches { 0 };
+            double secs { 0.0 };
+
+            struct timespec t0, t1;
+            counters.start();
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            do {
+                ops += benchmark.second();
+                ++batches;
+
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                secs = elapsed(t0, t1);
+            } while (secs < min_secs);
+            counters.stop();
+
+            double ns_per_op { 1e9 * secs / (ops ? ops : 1) };
+
+            /* instructions per cycle, 0 if either is not read */
+            double ipc { 0.0 };
+            if (counters.available(PERF_CYCLES) && counters.available(PERF_INSTRUCTIONS) &&
+                0 < counters.value(PERF_CYCLES)) {
+                ipc = (double) counters.value(PERF_INSTRUCTIONS) / counters.value(PERF_CYCLES);
+            }
+
+            if (json) {
+                Json::Value obj;
+                obj["ops"] = Json::UInt64(ops);
+                obj["batches"] = Json::UInt64(batches);
+                obj["secs"] = secs;
+                obj["ns_per_op"] = ns_per_op;
+
+                /* counts, and counts per op, of the counters read */
+                for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+                    if (!counters.available(i)) {
+                        continue;
+                    }
+
+                    std::string counter { perf_counter_names[i] };
+                    obj[counter] = Json::UInt64(counters.value(i));
+                    obj[counter + "_per_op"] = (double) counters.value(i) / (ops ? ops : 1);
+                }
+                if (0.0 < ipc) {
+                    obj["ipc"] = ipc;
+                }
+
+                root[name] = obj;
+                continue;
+            }
+
+            os
+                << std::left << std::setw(48) << name
+                << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                << ns_per_op << " ns/op"
+                << std::setw(12) << ops << " ops";
+
+            if (0.0 < ipc) {
+                os
+                    << std::setw(8) << std::setprecision(2)
+                    << ipc << " IPC";
+            }
+
+            os
+                << std::endl;
+        }
+
+        if (json) {
+            os
+                << root.toStyledString()
+                << std::endl;
+        }
+    }
+
+    expr::Expr_ptr bench_var(char name, unsigned width)
+    {
+        std::ostringstream oss;
+        oss
+            << name << width;
+
+        return expr::ExprMgr::INSTANCE().make_identifier(oss.str().c_str());
+    }
+
+    bool setup_model()
+    {
+        /* state vars of each width, their TRANS adds the other two */
+        std::ostringstream oss;
+        oss
+            << "MODULE bench" << std::endl;
+
+        for (unsigned i = 0; i < n_bench_widths; ++i) {
+            unsigned w { bench_widths[i] };
+            oss
+                << "VAR x" << w << ", y" << w << ", z" << w
+                << " : uint" << w << ";" << std::endl
+                << "INIT x" << w << " = y" << w << ";" << std::endl
+                << "TRANS x" << w << " := x" << w << " + y" << w << " * z" << w << ";" << std::endl;
+        }
+
+        char path[] = "/tmp/yasmv-bench-XXXXXX";
+        int fd { mkstemp(path) };
+        if (-1 == fd) {
+            return false;
+        }
+
+        const std::string text { oss.str() };
+        bool ok { (ssize_t) text.size() == write(fd, text.c_str(), text.size()) };
+        close(fd);
+
+        ok = ok && parse::parseFile(path) &&
+             model::ModelMgr::INSTANCE().analyze();
+
+        unlink(path);
+        return ok;
+    }
+
+}; // namespace bench
@@ -0,0 +1,81 @@
+/**
+ * @file bench.hh
+ * @brief Micro-benchmarks harness
+ *
+ * This header file contains the declarations of a minimal harness for
+ * the micro-benchmarks of the core hot paths. A benchmark is a batch
+ * function returning the number of operations it performed: batches
+ * are run until the minimum time is reached, and the time per
+ * operation is reported. Any setup takes place on registration, so
+ * that it is not measured.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <expr/expr.hh>
+
+#include <boost/function.hpp>
+
+namespace bench {
+
+    /* runs a batch, returns the number of operations performed */
+    typedef boost::function<unsigned long()> BenchBatch;
+
+    class BenchRegistry {
+    public:
+        void add(const std::string& name, BenchBatch batch);
+
+        /* runs the benchmarks whose name contains filter, each for at
+           least min_secs. Results are written as text, or as a JSON
+           object by name */
+        void run(std::ostream& os, const std::string& filter,
+                 double min_secs, bool json);
+
+    private:
+        std::vector<std::pair<std::string, BenchBatch>> f_benchmarks;
+    };
+
+    /* widths of the synthetic algebraic exprs */
+    extern const unsigned bench_widths[];
+    extern const unsigned n_bench_widths;
+
+    /* identifier of a var of the synthetic model, e.g. `x8` */
+    expr::Expr_ptr bench_var(char name, unsigned width);
+
+    /* reads the synthetic model all benchmarks are defined upon, false
+       on errors */
+    bool setup_model();
+
+    void register_expr_benchmarks(BenchRegistry& registry);
+    void register_compiler_benchmarks(BenchRegistry& registry);
+    void register_sat_benchmarks(BenchRegistry& registry);
+    void register_algorithms_benchmarks(BenchRegistry& registry);
+    void register_witness_benchmarks(BenchRegistry& registry);
+
+}; // namespace bench
+
+#endif /* BENCH_H */
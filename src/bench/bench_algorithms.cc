@@ -0,0 +1,78 @@
+/**
+ * @file bench_algorithms.cc
+ * @brief Algorithms subsystem micro-benchmarks.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sstream>
+
+#include <bench/bench.hh>
+
+#include <algorithms/base.hh>
+
+#include <cmd/command.hh>
+#include <cmd/interpreter.hh>
+#include <cmd/commands/commands.hh>
+
+#include <model/model_mgr.hh>
+
+namespace bench {
+
+    /* algorithms are bound to a command */
+    class BenchCommand: public cmd::Command {
+    public:
+        BenchCommand()
+            : cmd::Command(cmd::Interpreter::INSTANCE())
+        {}
+
+        utils::Variant operator()()
+        {
+            return utils::Variant(cmd::okMessage);
+        }
+    };
+
+    static const step_t uniqueness_ks[] = { 8, 16, 32, 64 };
+
+    void register_algorithms_benchmarks(BenchRegistry& registry)
+    {
+        /* the FSM is compiled once, both live as long as the program */
+        BenchCommand* command { new BenchCommand() };
+        algorithms::Algorithm* algorithm {
+            new algorithms::Algorithm(*command, model::ModelMgr::INSTANCE().model())
+        };
+
+        for (step_t k : uniqueness_ks) {
+            std::ostringstream oss;
+            oss
+                << "algorithms/fsm uniqueness (k = " << k << ")";
+
+            /* the k-th state against each of the previous ones */
+            registry.add(oss.str(), [algorithm, k]() {
+                sat::Engine engine { "bench" };
+                for (step_t j = 0; j < k; ++j) {
+                    algorithm->assert_fsm_uniqueness(engine, j, k);
+                }
+
+                return (unsigned long) k;
+            });
+        }
+    }
+
+}; // namespace bench
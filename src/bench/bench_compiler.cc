@@ -0,0 +1,71 @@
+/**
+ * @file bench_compiler.cc
+ * @brief Compiler subsystem micro-benchmarks.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sstream>
+
+#include <bench/bench.hh>
+
+#include <compiler/compiler.hh>
+
+#include <expr/expr_mgr.hh>
+
+namespace bench {
+
+    /* compilations performed by each batch */
+    static const unsigned long n_compilations { 10 };
+
+    void register_compiler_benchmarks(BenchRegistry& registry)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        for (unsigned i = 0; i < n_bench_widths; ++i) {
+            unsigned w { bench_widths[i] };
+
+            expr::Expr_ptr x { bench_var('x', w) };
+            expr::Expr_ptr y { bench_var('y', w) };
+            expr::Expr_ptr z { bench_var('z', w) };
+
+            /* x + y * z = x - z */
+            expr::Expr_ptr body {
+                em.make_eq(em.make_add(x, em.make_mul(y, z)), em.make_sub(x, z))
+            };
+
+            std::ostringstream oss;
+            oss
+                << "compiler/process arithmetical (uint" << w << ")";
+
+            /* compilers memoize results, each compilation takes a
+               fresh one */
+            registry.add(oss.str(), [ctx, body]() {
+                for (unsigned long j = 0; j < n_compilations; ++j) {
+                    compiler::Compiler compiler;
+                    compiler.process(ctx, body);
+                }
+
+                return n_compilations;
+            });
+        }
+    }
+
+}; // namespace bench
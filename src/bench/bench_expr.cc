@@ -0,0 +1,58 @@
+/**
+ * @file bench_expr.cc
+ * @brief Expr subsystem micro-benchmarks.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <bench/bench.hh>
+
+#include <expr/expr_mgr.hh>
+
+namespace bench {
+
+    /* exprs made by each batch */
+    static const unsigned long n_exprs { 100000 };
+
+    void register_expr_benchmarks(BenchRegistry& registry)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        expr::Expr_ptr x { bench_var('x', 8) };
+
+        /* the same exprs over and over, all found in the pool */
+        registry.add("expr/hash-consing (hit)", [&em, x]() {
+            for (unsigned long i = 0; i < n_exprs; ++i) {
+                em.make_add(x, em.make_const(i % 1024));
+            }
+
+            return 2 * n_exprs;
+        });
+
+        /* fresh constants, both exprs are new to the pool */
+        registry.add("expr/hash-consing (miss)", [&em, x]() {
+            static value_t next { 1 << 20 };
+            for (unsigned long i = 0; i < n_exprs; ++i) {
+                em.make_add(x, em.make_const(next++));
+            }
+
+            return 2 * n_exprs;
+        });
+    }
+
+}; // namespace bench
@@ -0,0 +1,168 @@
+/**
+ * @file bench_sat.cc
+ * @brief SAT subsystem micro-benchmarks.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sstream>
+
+#include <bench/bench.hh>
+
+#include <compiler/compiler.hh>
+#include <compiler/streamers.hh>
+
+#include <enc/enc_mgr.hh>
+
+#include <expr/expr_mgr.hh>
+
+#include <sat/sat.hh>
+
+namespace bench {
+
+    /* each batch pushes a unit at this many times, on a fresh engine */
+    static const step_t n_times { 16 };
+
+    /* at least half of the bits are set, (n / 2) * (n / 2 + 1) nodes
+       whatever the variable order */
+    static ADD at_least_half(const dd::DDVector& bits, unsigned n)
+    {
+        Cudd& dd { enc::EncodingMgr::INSTANCE().dd() };
+        unsigned k { n / 2 };
+
+        /* row[c] holds "at least c of the bits from j on" */
+        std::vector<BDD> row(k + 1, dd.bddZero());
+        row[0] = dd.bddOne();
+
+        for (unsigned j = n; 0 < j; --j) {
+            BDD bit { bits[j - 1].BddPattern() };
+            for (unsigned c = k; 0 < c; --c) {
+                row[c] = bit.Ite(row[c - 1], row[c]);
+            }
+        }
+
+        return row[k].Add();
+    }
+
+    static BenchBatch push_batch(const compiler::Unit& unit)
+    {
+        return [unit]() {
+            sat::Engine engine { "bench" };
+            for (step_t time = 0; time < n_times; ++time) {
+                engine.push(unit, time);
+            }
+
+            return (unsigned long) n_times;
+        };
+    }
+
+    static void register_cnf_benchmarks(BenchRegistry& registry)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        /* the encoding of x64, made by compiling any expr on it */
+        expr::Expr_ptr x { bench_var('x', 64) };
+        compiler::Compiler compiler;
+        compiler.process(ctx, em.make_eq(x, bench_var('y', 64)));
+
+        enc::Encoding_ptr enc {
+            bm.find_encoding(expr::TimedExpr(em.make_dot(ctx, x), 0))
+        };
+        assert(NULL != enc);
+
+        for (unsigned i = 0; i < n_bench_widths; ++i) {
+            unsigned n { bench_widths[i] };
+
+            dd::DDVector dds;
+            dds.push_back(at_least_half(enc->bits(), n));
+
+            compiler::InlinedOperatorDescriptors inlined_operator_descriptors;
+            compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+            compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+            compiler::AigDescriptors aig_descriptors;
+
+            compiler::Unit unit { x, dds, inlined_operator_descriptors,
+                                  binary_selection_descriptors_map,
+                                  array_mux_descriptors, aig_descriptors };
+
+            std::ostringstream oss;
+            oss
+                << "sat/cnf single-cut ("
+                << dds[0].nodeCount()
+                << " nodes)";
+
+            registry.add(oss.str(), push_batch(unit));
+        }
+    }
+
+    static void register_inliner_benchmarks(BenchRegistry& registry)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        for (unsigned i = 0; i < n_bench_widths; ++i) {
+            unsigned w { bench_widths[i] };
+
+            expr::Expr_ptr x { bench_var('x', w) };
+            expr::Expr_ptr y { bench_var('y', w) };
+            expr::Expr_ptr z { bench_var('z', w) };
+
+            const std::pair<expr::ExprType, expr::Expr_ptr> ops[] = {
+                { expr::ExprType::PLUS, em.make_eq(em.make_add(x, y), z) },
+                { expr::ExprType::MUL, em.make_eq(em.make_mul(x, y), z) },
+                { expr::ExprType::LT, em.make_lt(x, y) },
+            };
+
+            for (const auto& op : ops) {
+                compiler::Compiler compiler;
+                compiler::Unit compiled { compiler.process(ctx, op.second) };
+
+                /* just the descriptor of the operator, the DDs (and
+                   the equality, if any) are left out */
+                for (const auto& iod : compiled.inlined_operator_descriptors()) {
+                    if (op.first != compiler::ios_optype(iod.ios())) {
+                        continue;
+                    }
+
+                    dd::DDVector dds;
+                    compiler::InlinedOperatorDescriptors inlined_operator_descriptors { iod };
+                    compiler::Expr2BinarySelectionDescriptorsMap binary_selection_descriptors_map;
+                    compiler::MultiwaySelectionDescriptors array_mux_descriptors;
+                    compiler::AigDescriptors aig_descriptors;
+
+                    compiler::Unit unit { op.second, dds, inlined_operator_descriptors,
+                                          binary_selection_descriptors_map,
+                                          array_mux_descriptors, aig_descriptors };
+
+                    registry.add("sat/inject " + ios2string(iod.ios()), push_batch(unit));
+                    break;
+                }
+            }
+        }
+    }
+
+    void register_sat_benchmarks(BenchRegistry& registry)
+    {
+        register_cnf_benchmarks(registry);
+        register_inliner_benchmarks(registry);
+    }
+
+}; // namespace bench
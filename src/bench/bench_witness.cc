@@ -0,0 +1,87 @@
+/**
+ * @file bench_witness.cc
+ * @brief Witness subsystem micro-benchmarks.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <bench/bench.hh>
+
+#include <expr/expr_mgr.hh>
+
+#include <witness/evaluator.hh>
+#include <witness/witness.hh>
+#include <witness/witness_mgr.hh>
+
+namespace bench {
+
+    /* frames of the witness, each batch evaluates on all of them */
+    static const step_t n_frames { 64 };
+
+    void register_witness_benchmarks(BenchRegistry& registry)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        expr::Expr_ptr x { bench_var('x', 32) };
+        expr::Expr_ptr y { bench_var('y', 32) };
+        expr::Expr_ptr z { bench_var('z', 32) };
+
+        /* x + y * z < x - z */
+        expr::Expr_ptr body {
+            em.make_lt(em.make_add(x, em.make_mul(y, z)), em.make_sub(x, z))
+        };
+
+        /* arbitrary values, lives as long as the program */
+        witness::Witness* witness { new witness::Witness() };
+
+        expr::ExprVector lang;
+        for (expr::Expr_ptr var : { x, y, z }) {
+            lang.push_back(em.make_dot(ctx, var));
+        }
+        witness->set_lang(lang);
+
+        for (step_t time = 0; time < n_frames; ++time) {
+            witness::TimeFrame& tf { witness->extend() };
+
+            value_t value { (value_t) time };
+            for (expr::Expr_ptr symb : lang) {
+                tf.set_value(symb, em.make_const(value));
+                value = 3 * value + 1;
+            }
+        }
+
+        registry.add("witness/evaluator (per frame)", [witness, ctx, body]() {
+            witness::Evaluator evaluator { witness::WitnessMgr::INSTANCE() };
+            for (step_t time = 0; time < n_frames; ++time) {
+                evaluator.process(witness, ctx, body, time);
+            }
+
+            return (unsigned long) n_frames;
+        });
+
+        registry.add("witness/program (all frames)", [witness, ctx, body]() {
+            expr::ExprVector values;
+            witness::WitnessMgr::INSTANCE().eval_frames(*witness, ctx, body, values);
+
+            return (unsigned long) n_frames;
+        });
+    }
+
+}; // namespace bench
@@ -0,0 +1,109 @@
+/**
+ * @file bench/main.cc
+ * @brief Micro-benchmarks of the core hot paths, main program.
+ *
+ * usage: yasmv_bench [--min-secs SECS] [--json] [FILTER]
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <bench/bench.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/logging.hh>
+
+static void usage(const char* program)
+{
+    std::cerr
+        << "usage: "
+        << program
+        << " [--min-secs SECS] [--json] [FILTER]"
+        << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    double min_secs { 0.5 };
+    bool json { false };
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--min-secs") && i + 1 < argc) {
+            min_secs = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--json")) {
+            json = true;
+        } else if ('-' != argv[i][0] && filter.empty()) {
+            filter = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* program options defaults */
+    opts::OptsMgr::INSTANCE().parse_command_line(1, argv);
+
+    if (!bench::setup_model()) {
+        std::cerr
+            << "Could not set up the benchmarks model"
+            << std::endl;
+
+        return 1;
+    }
+
+    bench::BenchRegistry registry;
+    bench::register_expr_benchmarks(registry);
+    bench::register_compiler_benchmarks(registry);
+    bench::register_sat_benchmarks(registry);
+    bench::register_algorithms_benchmarks(registry);
+    bench::register_witness_benchmarks(registry);
+
+    registry.run(std::cout, filter, min_secs, json);
+
+    return 0;
+}
+
+// logging subsystem settings
+namespace axter {
+    std::string get_log_prefix_format(const char* FileName,
+                                      int LineNo, const char* FunctionName,
+                                      ext_data levels_format_usage_data)
+    {
+
+        return ezlogger_format_policy::
+            get_log_prefix_format(FileName, LineNo, FunctionName,
+                                  levels_format_usage_data);
+    }
+
+    std::ostream& get_log_stream()
+    {
+        return ezlogger_output_policy::get_log_stream();
+    }
+
+    /* benchmarks only log warnings and errors */
+    verbosity get_verbosity_level_tolerance()
+    {
+        return log_always;
+    }
+}; // namespace axter
@@ -0,0 +1,139 @@
+/**
+ * @file perf.cc
+ * @brief Micro-benchmarks harness, hardware performance counters
+ * implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <bench/perf.hh>
+
+namespace bench {
+
+    const char* perf_counter_names[] = {
+        "cycles",
+        "instructions",
+        "cache_misses",
+        "branch_misses",
+    };
+
+    static const uint64_t perf_counter_configs[] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    /* no glibc wrapper */
+    static int perf_event_open(struct perf_event_attr* attr)
+    {
+        return (int) syscall(__NR_perf_event_open, attr, 0, -1, -1, 0);
+    }
+
+    /* Counters are not grouped: groups can not be read with inherited
+     * counters, and a counter the hardware lacks would take the others
+     * down with it. User space only, as allowed to unprivileged users
+     * with the default perf_event_paranoid. */
+    PerfCounters::PerfCounters()
+    {
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = perf_counter_configs[i];
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            f_fds[i] = perf_event_open(&attr);
+            f_values[i] = 0;
+        }
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            if (available(i)) {
+                close(f_fds[i]);
+            }
+        }
+    }
+
+    bool PerfCounters::any() const
+    {
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            if (available(i)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void PerfCounters::start()
+    {
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            if (available(i)) {
+                ioctl(f_fds[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(f_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void PerfCounters::stop()
+    {
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            if (available(i)) {
+                ioctl(f_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        /* value, time enabled, time running */
+        for (unsigned i = 0; i < N_PERF_COUNTERS; ++i) {
+            uint64_t buf[3];
+            if (!available(i) ||
+                (ssize_t) sizeof(buf) != read(f_fds[i], buf, sizeof(buf))) {
+                f_values[i] = 0;
+                continue;
+            }
+
+            f_values[i] = (0 < buf[2] && buf[2] < buf[1])
+                              ? (uint64_t) ((double) buf[0] * buf[1] / buf[2])
+                              : buf[0];
+        }
+    }
+
+    uint64_t PerfCounters::value(unsigned i) const
+    {
+        return f_values[i];
+    }
+
+}; // namespace bench
@@ -0,0 +1,82 @@
+/**
+ * @file perf.hh
+ * @brief Micro-benchmarks harness, hardware performance counters
+ *
+ * This header file contains the declarations of the hardware counters
+ * read around each benchmark (cycles, instructions, cache and branch
+ * misses), by perf_event_open(2). Counters the kernel or the hardware
+ * do not provide (e.g. in VMs, or with a restrictive
+ * perf_event_paranoid) are not read, and not reported.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef BENCH_PERF_H
+#define BENCH_PERF_H
+
+#include <stdint.h>
+
+namespace bench {
+
+    enum perf_counter_t {
+        PERF_CYCLES,
+        PERF_INSTRUCTIONS,
+        PERF_CACHE_MISSES,
+        PERF_BRANCH_MISSES,
+        N_PERF_COUNTERS,
+    };
+
+    /* names of the counters, as reported */
+    extern const char* perf_counter_names[];
+
+    class PerfCounters {
+    public:
+        /* opens the counters of this process, threads spawned after
+           this included (their counts are added as they exit) */
+        PerfCounters();
+        ~PerfCounters();
+
+        /* true iff the i-th counter is read */
+        inline bool available(unsigned i) const
+        {
+            return -1 != f_fds[i];
+        }
+
+        /* true iff any counter is */
+        bool any() const;
+
+        /* counts are from start() to stop() */
+        void start();
+        void stop();
+
+        /* the i-th count, scaled if the counter was multiplexed */
+        uint64_t value(unsigned i) const;
+
+    private:
+        /* not copyable, the descriptors are owned */
+        PerfCounters(const PerfCounters&);
+        PerfCounters& operator=(const PerfCounters&);
+
+        int f_fds[N_PERF_COUNTERS];
+        uint64_t f_values[N_PERF_COUNTERS];
+    };
+
+}; // namespace bench
+
+#endif /* BENCH_PERF_H */
@@ -26,13 +26,11 @@
 #include <boost/filesystem.hpp>
 
 namespace cmd {
-    CommandMgr_ptr CommandMgr::f_instance { NULL };
     CommandMgr& CommandMgr::INSTANCE()
     {
-        if (!f_instance)
-            f_instance = new CommandMgr();
-
-        return (*f_instance);
+        /* made on first use, concurrent first uses wait for it */
+        static CommandMgr_ptr instance { new CommandMgr() };
+        return *instance;
     }
 
     CommandMgr::CommandMgr()
@@ -27,11 +27,17 @@
 /* -- commands */
 #include <cmd/commands/diameter.hh>
 #include <cmd/commands/do.hh>
+#include <cmd/commands/parallel.hh>
 #include <cmd/commands/echo.hh>
 #include <cmd/commands/help.hh>
 #include <cmd/commands/last.hh>
 #include <cmd/commands/on.hh>
 #include <cmd/commands/quit.hh>
+#include <cmd/commands/stats.hh>
+#include <cmd/commands/compile_stats.hh>
+#include <cmd/commands/dd_stats.hh>
+#include <cmd/commands/mem_stats.hh>
+#include <cmd/commands/gc.hh>
 #include <cmd/commands/time.hh>
 
 #include <cmd/commands/dump_model.hh>
@@ -41,12 +47,17 @@
 #include <cmd/commands/check_init.hh>
 #include <cmd/commands/check_trans.hh>
 #include <cmd/commands/reach.hh>
+#include <cmd/commands/optimize.hh>
+#include <cmd/commands/equiv.hh>
 
 #include <cmd/commands/pick_state.hh>
 #include <cmd/commands/simulate.hh>
 
+#include <cmd/commands/diff_traces.hh>
 #include <cmd/commands/dump_traces.hh>
 #include <cmd/commands/dup_trace.hh>
+#include <cmd/commands/find_in_trace.hh>
+#include <cmd/commands/validate_trace.hh>
 #include <cmd/commands/list_traces.hh>
 #include <cmd/commands/read_trace.hh>
 #include <cmd/commands/select_trace.hh>
@@ -55,6 +66,11 @@
 #include <cmd/commands/get.hh>
 #include <cmd/commands/set.hh>
 
+#include <cmd/commands/background.hh>
+#include <cmd/commands/jobs.hh>
+#include <cmd/commands/kill.hh>
+#include <cmd/commands/wait.hh>
+
 namespace cmd {
 
     using CommandTopics = std::set<std::string>;
@@ -82,6 +98,11 @@ namespace cmd {
             return new Do(f_interpreter);
         }
 
+        inline Command_ptr make_parallel()
+        {
+            return new Parallel(f_interpreter);
+        }
+
         inline Command_ptr make_echo()
         {
             return new Echo(f_interpreter);
@@ -102,6 +123,31 @@ namespace cmd {
             return new Time(f_interpreter);
         }
 
+        inline Command_ptr make_stats()
+        {
+            return new Stats(f_interpreter);
+        }
+
+        inline Command_ptr make_compile_stats()
+        {
+            return new CompileStats(f_interpreter);
+        }
+
+        inline Command_ptr make_dd_stats()
+        {
+            return new DDStats(f_interpreter);
+        }
+
+        inline Command_ptr make_mem_stats()
+        {
+            return new MemStats(f_interpreter);
+        }
+
+        inline Command_ptr make_gc()
+        {
+            return new GC(f_interpreter);
+        }
+
         inline Command_ptr make_quit()
         {
             return new Quit(f_interpreter);
@@ -127,6 +173,16 @@ namespace cmd {
             return new Reach(f_interpreter);
         }
 
+        inline Command_ptr make_optimize()
+        {
+            return new Optimize(f_interpreter);
+        }
+
+        inline Command_ptr make_equiv()
+        {
+            return new Equiv(f_interpreter);
+        }
+
         inline Command_ptr make_check_init()
         {
             return new CheckInit(f_interpreter);
@@ -167,11 +223,46 @@ namespace cmd {
             return new DupTrace(f_interpreter);
         }
 
+        inline Command_ptr make_diff_traces()
+        {
+            return new DiffTraces(f_interpreter);
+        }
+
+        inline Command_ptr make_find_in_trace()
+        {
+            return new FindInTrace(f_interpreter);
+        }
+
+        inline Command_ptr make_validate_trace()
+        {
+            return new ValidateTrace(f_interpreter);
+        }
+
         inline Command_ptr make_select_trace()
         {
             return new SelectTrace(f_interpreter);
         }
 
+        inline Command_ptr make_background(Command_ptr command, pconst_char descr)
+        {
+            return new Background(f_interpreter, command, descr);
+        }
+
+        inline Command_ptr make_jobs()
+        {
+            return new Jobs(f_interpreter);
+        }
+
+        inline Command_ptr make_wait()
+        {
+            return new Wait(f_interpreter);
+        }
+
+        inline Command_ptr make_kill()
+        {
+            return new Kill(f_interpreter);
+        }
+
         inline Command_ptr make_get()
         {
             return new Get(f_interpreter);
@@ -205,6 +296,11 @@ namespace cmd {
             return new DoTopic(f_interpreter);
         }
 
+        inline CommandTopic_ptr topic_parallel()
+        {
+            return new ParallelTopic(f_interpreter);
+        }
+
         inline CommandTopic_ptr topic_on()
         {
             return new OnTopic(f_interpreter);
@@ -225,6 +321,31 @@ namespace cmd {
             return new TimeTopic(f_interpreter);
         }
 
+        inline CommandTopic_ptr topic_stats()
+        {
+            return new StatsTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_compile_stats()
+        {
+            return new CompileStatsTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_dd_stats()
+        {
+            return new DDStatsTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_mem_stats()
+        {
+            return new MemStatsTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_gc()
+        {
+            return new GCTopic(f_interpreter);
+        }
+
         inline CommandTopic_ptr topic_quit()
         {
             return new QuitTopic(f_interpreter);
@@ -250,6 +371,16 @@ namespace cmd {
             return new ReachTopic(f_interpreter);
         }
 
+        inline CommandTopic_ptr topic_optimize()
+        {
+            return new OptimizeTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_equiv()
+        {
+            return new EquivTopic(f_interpreter);
+        }
+
         inline CommandTopic_ptr topic_check_init()
         {
             return new CheckInitTopic(f_interpreter);
@@ -290,11 +421,41 @@ namespace cmd {
             return new DupTraceTopic(f_interpreter);
         }
 
+        inline CommandTopic_ptr topic_diff_traces()
+        {
+            return new DiffTracesTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_find_in_trace()
+        {
+            return new FindInTraceTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_validate_trace()
+        {
+            return new ValidateTraceTopic(f_interpreter);
+        }
+
         inline CommandTopic_ptr topic_select_trace()
         {
             return new SelectTraceTopic(f_interpreter);
         }
 
+        inline CommandTopic_ptr topic_jobs()
+        {
+            return new JobsTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_wait()
+        {
+            return new WaitTopic(f_interpreter);
+        }
+
+        inline CommandTopic_ptr topic_kill()
+        {
+            return new KillTopic(f_interpreter);
+        }
+
         inline CommandTopic_ptr topic_get()
         {
             return new GetTopic(f_interpreter);
@@ -325,7 +486,6 @@ namespace cmd {
         ~CommandMgr();
 
     private:
-        static CommandMgr_ptr f_instance;
         Interpreter& f_interpreter;
     };
 
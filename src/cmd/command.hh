@@ -31,9 +31,14 @@
 #include <cmd/typedefs.hh>
 #include <common/common.hh>
 #include <expr/expr.hh>
+#include <sat/watchdog.hh>
 #include <utils/variant.hh>
 
+#include <iostream>
 #include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
 
 namespace cmd {
 
@@ -43,6 +48,20 @@ namespace cmd {
     protected:
         Interpreter& f_owner;
 
+        // resource limits, enforced by algorithms
+        sat::ResourceLimits f_limits;
+
+        // output stream, NULL for std::cout
+        std::ostream* f_os;
+
+        // cancellation, scopes of the engines in use
+        boost::mutex f_mutex;
+        bool f_cancelled;
+        std::vector<const void*> f_scopes;
+
+        // ids of the witnesses registered while running
+        expr::AtomVector f_witnesses;
+
     public:
         Command(Interpreter& owner);
         virtual ~Command();
@@ -50,6 +69,41 @@ namespace cmd {
         // functor-pattern
         utils::Variant virtual operator()() = 0;
 
+        // resource limits (seconds, conflicts per engine, MB)
+        void set_timeout(value_t secs);
+        void set_conflicts(value_t conflicts);
+        void set_max_memory(value_t megs);
+
+        inline const sat::ResourceLimits& limits() const
+        {
+            return f_limits;
+        }
+
+        // commands print their results here, parallel blocks give
+        // each command a stream of its own
+        inline void set_output(std::ostream& os)
+        {
+            f_os = &os;
+        }
+
+        inline std::ostream& out() const
+        {
+            return f_os ? *f_os : std::cout;
+        }
+
+        // algorithms register the scope of their engines, cancel()
+        // interrupts all of them (e.g. killing a background job)
+        void attach(const void* scope);
+        void detach(const void* scope);
+
+        void cancel();
+        bool cancelled();
+
+        // algorithms report the witnesses they register, so that
+        // clients (e.g. the server) can return them
+        void add_witness(const expr::Atom& id);
+        expr::AtomVector witnesses();
+
         // representation
         friend std::ostream& operator<<(std::ostream& os, Command& cmd);
     };
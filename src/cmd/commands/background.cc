@@ -0,0 +1,58 @@
+/**
+ * @file background.cc
+ * @brief Command `&` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/background.hh>
+#include <cmd/commands/commands.hh>
+
+#include <cmd/jobs.hh>
+
+namespace cmd {
+
+    Background::Background(Interpreter& owner, Command_ptr command, pconst_char descr)
+        : Command(owner)
+        , f_command(command)
+        , f_descr(descr)
+    {}
+
+    Background::~Background()
+    {
+        delete f_command;
+    }
+
+    utils::Variant Background::operator()()
+    {
+        Command_ptr command { f_command };
+        f_command = NULL;
+
+        unsigned id { JobMgr::INSTANCE().submit(command, f_descr) };
+        out()
+            << "["
+            << id
+            << "] "
+            << f_descr
+            << std::endl;
+
+        return utils::Variant(okMessage);
+    }
+
+} // namespace cmd
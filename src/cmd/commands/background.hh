@@ -0,0 +1,56 @@
+/**
+ * @file background.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler interface for the `&`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef BACKGROUND_CMD_H
+#define BACKGROUND_CMD_H
+
+#include <cmd/command.hh>
+
+#include <string>
+
+namespace cmd {
+
+    /* `<command> &`, runs command as a background job */
+    class Background: public Command {
+
+        /* the command to be run (owned until submitted) */
+        Command_ptr f_command;
+
+        /* the command line, for `jobs` */
+        std::string f_descr;
+
+    public:
+        Background(Interpreter& owner, Command_ptr command, pconst_char descr);
+        virtual ~Background();
+
+        utils::Variant virtual operator()();
+    };
+
+    typedef Background* Background_ptr;
+
+} // namespace cmd
+
+#endif /* BACKGROUND_CMD_H */
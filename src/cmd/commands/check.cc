@@ -24,35 +24,50 @@
 #include <cmd/commands/check.hh>
 #include <cmd/commands/commands.hh>
 
+#include <cmd/commands/dump_traces.hh>
+
 #include <algorithms/check/check.hh>
 
 namespace cmd {
 
     Check::Check(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
+        , f_property(NULL)
+        , f_max_depth(0)
     {}
 
     Check::~Check()
-    {}
+    {
+        f_properties.clear();
+    }
 
     void Check::set_property(expr::Expr_ptr property)
     {
         f_property = property;
     }
 
+    void Check::add_property(expr::Expr_ptr property)
+    {
+        f_properties.push_back(property);
+    }
+
     void Check::add_constraint(expr::Expr_ptr constraint)
     {
         f_constraints.push_back(constraint);
     }
 
+    void Check::set_max_depth(step_t max_depth)
+    {
+        f_max_depth = max_depth;
+    }
+
     bool Check::check_requirements()
     {
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         model::Model& model { mm.model() };
 
         if (0 == model.modules().size()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -65,14 +80,154 @@ namespace cmd {
 
     utils::Variant Check::operator()()
     {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         bool res { false };
 
+        if (!check_requirements()) {
+            return utils::Variant(errMessage);
+        }
+
+        if (!f_properties.empty()) {
+            return check_multiple_properties();
+        }
+
         DEBUG
             << "Property to check is `"
             << f_property
             << "`."
             << std::endl;
 
+        check::Check ltl { *this, mm.model() };
+        ltl.process(expr::ExprVector { f_property }, f_constraints, f_max_depth);
+
+        switch (ltl.status()) {
+            case check::ltl_status_t::CHECK_FALSE:
+                if (!om.quiet()) {
+                    out()
+                        << wrnPrefix;
+                }
+                out()
+                    << "Property is FALSE";
+
+                if (ltl.has_witness()) {
+                    witness::Witness& w { ltl.witness() };
+
+                    out()
+                        << ", registered counterexample `"
+                        << w.id()
+                        << "`, "
+                        << w.size()
+                        << " steps."
+                        << std::endl;
+
+                    DumpTraces { this->f_owner }();
+                }
+                break;
+
+            case check::ltl_status_t::CHECK_TRUE:
+                if (!om.quiet()) {
+                    out()
+                        << outPrefix;
+                }
+                out()
+                    << "Property is TRUE."
+                    << std::endl;
+
+                res = true;
+                break;
+
+            case check::ltl_status_t::CHECK_UNKNOWN:
+                if (!om.quiet()) {
+                    out()
+                        << outPrefix;
+                }
+                out()
+                    << "Property could not be decided."
+                    << std::endl;
+                break;
+
+            case check::ltl_status_t::CHECK_ERROR:
+                if (!om.quiet()) {
+                    out()
+                        << outPrefix;
+                }
+                out()
+                    << "Unexpected error."
+                    << std::endl;
+                break;
+
+            default:
+                assert(false); /* unexpected */
+        }
+
+        return utils::Variant(res ? okMessage : errMessage);
+    }
+
+    utils::Variant Check::check_multiple_properties()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+
+        expr::ExprVector properties { f_property };
+        properties.insert(properties.end(), f_properties.begin(), f_properties.end());
+
+        check::Check ltl { *this, mm.model() };
+        ltl.process(properties, f_constraints, f_max_depth);
+
+        /* one line per property, in order */
+        for (const auto& result : ltl.results()) {
+            if (!om.quiet()) {
+                out()
+                    << ((check::ltl_status_t::CHECK_FALSE == result.status)
+                        ? wrnPrefix : outPrefix);
+            }
+
+            out()
+                << "Property `"
+                << result.property
+                << "` ";
+
+            switch (result.status) {
+                case check::ltl_status_t::CHECK_FALSE:
+                    out()
+                        << "is FALSE (k = "
+                        << result.depth
+                        << ")";
+
+                    if (NULL != result.witness) {
+                        out()
+                            << ", registered counterexample `"
+                            << result.witness->id()
+                            << "`";
+                    }
+                    break;
+
+                case check::ltl_status_t::CHECK_TRUE:
+                    out()
+                        << "is TRUE";
+                    break;
+
+                case check::ltl_status_t::CHECK_UNKNOWN:
+                    out()
+                        << "could not be decided";
+                    break;
+
+                case check::ltl_status_t::CHECK_ERROR:
+                    out()
+                        << "unexpected error";
+                    break;
+
+                default:
+                    assert(false); /* unexpected */
+            }
+
+            out()
+                << "."
+                << std::endl;
+        }
+
+        bool res { check::ltl_status_t::CHECK_TRUE == ltl.status() };
         return utils::Variant(res ? okMessage : errMessage);
     }
 
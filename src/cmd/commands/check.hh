@@ -38,22 +38,33 @@ namespace cmd {
 
         /** cmd params */
         void set_property(expr::Expr_ptr property);
+
+        /* additional properties, checked along with the first one
+           over a shared unrolling */
+        void add_property(expr::Expr_ptr property);
+
         void add_constraint(expr::Expr_ptr constraint);
+        void set_max_depth(step_t max_depth);
 
         /* run() */
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
-
         /* the property to be verified */
         expr::Expr_ptr f_property;
 
+        /* additional properties */
+        expr::ExprVector f_properties;
+
         /* (optional) additional constraints */
         expr::ExprVector f_constraints;
 
+        /* (optional) counterexamples length limit, zero if none */
+        step_t f_max_depth;
+
         // -- helpers -------------------------------------------------------------
         bool check_requirements();
+        utils::Variant check_multiple_properties();
     };
 
     typedef Check* Check_ptr;
@@ -34,7 +34,6 @@ namespace cmd {
 
     CheckInit::CheckInit(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
     {}
 
     CheckInit::~CheckInit()
@@ -51,7 +50,7 @@ namespace cmd {
         model::Model& model { mm.model() };
 
         if (0 == model.modules().size()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -76,11 +75,11 @@ namespace cmd {
             switch (check_init.status()) {
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_OK:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Initial states consistency check ok."
                         << std::endl;
 
@@ -89,22 +88,38 @@ namespace cmd {
 
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_KO:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Initial states consistency check failed."
                         << std::endl;
+
+                    /* a minimal core for each inconsistent partition */
+                    for (const auto& core : check_init.cores()) {
+                        out()
+                            << "Conflicting constraints:"
+                            << std::endl;
+
+                        for (const auto& constraint : core) {
+                            out()
+                                << "  "
+                                << constraint.kind
+                                << " "
+                                << constraint.expr
+                                << std::endl;
+                        }
+                    }
                     break;
 
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_UNDECIDED:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Could not decide initial states consistency check."
                         << std::endl;
                     break;
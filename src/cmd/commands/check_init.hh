@@ -43,8 +43,6 @@ namespace cmd {
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
-
         /* (optional) additional constraints */
         expr::ExprVector f_constraints;
 
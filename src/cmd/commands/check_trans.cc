@@ -33,7 +33,6 @@ namespace cmd {
 
     CheckTrans::CheckTrans(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
     {}
 
     CheckTrans::~CheckTrans()
@@ -50,7 +49,7 @@ namespace cmd {
         model::Model& model { mm.model() };
 
         if (0 == model.modules().size()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -75,11 +74,11 @@ namespace cmd {
             switch (check_trans.status()) {
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_OK:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Transition relation consistency check ok."
                         << std::endl;
 
@@ -88,22 +87,38 @@ namespace cmd {
 
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_KO:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Transition relation consistency check failed."
                         << std::endl;
+
+                    /* a minimal core for each inconsistent partition */
+                    for (const auto& core : check_trans.cores()) {
+                        out()
+                            << "Conflicting constraints:"
+                            << std::endl;
+
+                        for (const auto& constraint : core) {
+                            out()
+                                << "  "
+                                << constraint.kind
+                                << " "
+                                << constraint.expr
+                                << std::endl;
+                        }
+                    }
                     break;
 
                 case fsm::fsm_consistency_t::FSM_CONSISTENCY_UNDECIDED:
                     if (!om.quiet()) {
-                        f_out
+                        out()
                             << outPrefix;
                     }
 
-                    f_out
+                    out()
                         << "Could not decide transition relation consistency check."
                         << std::endl;
                     break;
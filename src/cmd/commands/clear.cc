@@ -53,7 +53,7 @@ namespace cmd {
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
 
         /* FIXME: implement stream redirection for std{out,err} */
-        std::ostream& out { std::cout };
+        std::ostream& out { this->out() };
 
         if (!om.quiet()) {
             out
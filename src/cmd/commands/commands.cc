@@ -27,10 +27,13 @@
 #include <iostream>
 #include <sstream>
 
+#include <algorithm>
 #include <ctime>
 
 #include <commands.hh>
 
+#include <sat/engine_mgr.hh>
+
 /* algorithms */
 #include <check/check.hh>
 #include <reach/reach.hh>
@@ -46,6 +49,8 @@ namespace cmd {
 
     Command::Command(Interpreter& owner)
         : f_owner(owner)
+        , f_os(NULL)
+        , f_cancelled(false)
     {
         const void* instance { this };
         DRIVEL
@@ -62,6 +67,71 @@ namespace cmd {
                << std::endl;
     }
 
+    void Command::set_timeout(value_t secs)
+    {
+        f_limits.timeout = secs;
+    }
+
+    void Command::set_conflicts(value_t conflicts)
+    {
+        f_limits.conflicts = conflicts;
+    }
+
+    void Command::set_max_memory(value_t megs)
+    {
+        f_limits.max_memory = megs;
+    }
+
+    void Command::attach(const void* scope)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_scopes.push_back(scope);
+    }
+
+    void Command::detach(const void* scope)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        std::vector<const void*>::iterator eye {
+            std::find(f_scopes.begin(), f_scopes.end(), scope)
+        };
+        if (f_scopes.end() != eye) {
+            f_scopes.erase(eye);
+        }
+    }
+
+    void Command::cancel()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_cancelled = true;
+
+        sat::EngineMgr& mgr { sat::EngineMgr::INSTANCE() };
+        for (const void* scope : f_scopes) {
+            mgr.interrupt(scope);
+        }
+    }
+
+    bool Command::cancelled()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_cancelled;
+    }
+
+    void Command::add_witness(const expr::Atom& id)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (f_witnesses.end() == std::find(f_witnesses.begin(), f_witnesses.end(), id)) {
+            f_witnesses.push_back(id);
+        }
+    }
+
+    expr::AtomVector Command::witnesses()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_witnesses;
+    }
+
     CommandTopic::CommandTopic(Interpreter& owner)
         : f_owner(owner)
     {
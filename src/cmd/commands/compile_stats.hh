@@ -0,0 +1,71 @@
+/**
+ * @file compile_stats.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler inteface for the `compile-stats`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILE_STATS_CMD_H
+#define COMPILE_STATS_CMD_H
+
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class CompileStats: public Command {
+    public:
+        CompileStats(Interpreter& owner);
+        virtual ~CompileStats();
+
+        /* the format to use (must be one of "plain", "json") */
+        void set_format(pconst_char format);
+
+        /* the output filepath (optional) */
+        void set_output(pconst_char output);
+
+        /* forget stats, after reporting */
+        void set_clear(bool value);
+
+        /* the number of most expensive units to report (0 is all) */
+        void set_top(unsigned value);
+
+        utils::Variant virtual operator()();
+
+    private:
+        pconst_char f_format;
+        pchar f_output;
+        bool f_clear;
+        unsigned f_top;
+    };
+
+    using CompileStats_ptr = CompileStats*;
+
+    class CompileStatsTopic: public CommandTopic {
+    public:
+        CompileStatsTopic(Interpreter& owner);
+        virtual ~CompileStatsTopic();
+
+        void virtual usage();
+    };
+
+};     // namespace cmd
+#endif /* COMPILE_STATS_CMD_H */
@@ -0,0 +1,168 @@
+/**
+ * @file dd_stats.cc
+ * @brief Command `dd-stats` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/dd_stats.hh>
+#include <cmd/commands/dump_traces.hh>
+
+#include <dd/cudd_mgr.hh>
+
+#include <jsoncpp/json/json.h>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    DDStats::DDStats(Interpreter& owner)
+        : Command(owner)
+        , f_format(strdup(TRACE_FMT_DEFAULT))
+        , f_output(NULL)
+    {}
+
+    DDStats::~DDStats()
+    {
+        free((pchar) f_format);
+        free(f_output);
+    }
+
+    void DDStats::set_format(pconst_char format)
+    {
+        free((pchar) f_format);
+        f_format = strdup(format);
+        if (strcmp(f_format, TRACE_FMT_PLAIN) &&
+            strcmp(f_format, TRACE_FMT_JSON)) {
+            throw UnsupportedFormat(f_format);
+        }
+    }
+
+    void DDStats::set_output(pconst_char output)
+    {
+        free(f_output);
+        f_output = strdup(output);
+    }
+
+    void DDStats::report(std::ostream& os, bool json)
+    {
+        dd::CuddStats stats { dd::CuddMgr::INSTANCE().stats() };
+        double ratio {
+            0.0 < stats.cache_lookups ? stats.cache_hits / stats.cache_lookups : 0.0
+        };
+
+        if (json) {
+            Json::Value root;
+
+            root["managers"] = stats.managers;
+            root["live_nodes"] = Json::UInt64(stats.live_nodes);
+            root["peak_nodes"] = Json::UInt64(stats.peak_nodes);
+            root["memory"] = Json::UInt64(stats.memory);
+            root["gcs"] = Json::UInt64(stats.gcs);
+            root["gc_secs"] = stats.gc_secs;
+            root["cache_lookups"] = stats.cache_lookups;
+            root["cache_hits"] = stats.cache_hits;
+            root["cache_hit_ratio"] = ratio;
+
+            os
+                << root.toStyledString()
+                << std::endl;
+
+            return;
+        }
+
+        os
+            << "DD managers: "
+            << stats.managers
+            << " live"
+            << std::endl
+
+            << "Live nodes: "
+            << stats.live_nodes
+            << " ("
+            << stats.memory / (1 << 20)
+            << " MB in use)"
+            << std::endl
+
+            << "Peak nodes: "
+            << stats.peak_nodes
+            << std::endl
+
+            << "Garbage collections: "
+            << stats.gcs
+            << ", "
+            << std::fixed << std::setprecision(3) << stats.gc_secs
+            << "s"
+            << std::endl
+
+            << "Cache: "
+            << std::setprecision(0) << stats.cache_hits
+            << " hits over "
+            << stats.cache_lookups
+            << " lookups ("
+            << std::setprecision(1) << 100.0 * ratio
+            << "%)"
+            << std::endl;
+    }
+
+    utils::Variant DDStats::operator()()
+    {
+        if (f_output) {
+            std::ofstream out { f_output, std::ofstream::binary };
+            if (!out) {
+                ERR
+                    << "Can not open `"
+                    << f_output
+                    << "` for writing"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            report(out, !strcmp(f_format, TRACE_FMT_JSON));
+        } else {
+            report(out(), !strcmp(f_format, TRACE_FMT_JSON));
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    DDStatsTopic::DDStatsTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    DDStatsTopic::~DDStatsTopic()
+    {
+        TRACE
+            << "Destroyed dd-stats topic"
+            << std::endl;
+    }
+
+    void DDStatsTopic::usage()
+    {
+        display_manpage("dd-stats");
+    }
+
+}; // namespace cmd
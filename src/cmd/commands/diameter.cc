@@ -33,7 +33,6 @@ namespace cmd {
 
     Diameter::Diameter(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
     {}
 
     Diameter::~Diameter()
@@ -45,7 +44,7 @@ namespace cmd {
         model::Model& model { mm.model() };
 
         if (0 == model.modules().size()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -68,7 +67,7 @@ namespace cmd {
             computeDiameter.process();
             step_t value = computeDiameter.diameter();
 
-            f_out
+            out()
                 << "FSM diameter is "
                 << std::dec
                 << value
@@ -40,8 +40,6 @@ namespace cmd {
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
-
         // -- helpers -------------------------------------------------------------
         bool check_requirements();
     };
@@ -0,0 +1,209 @@
+/**
+ * @file diff_traces.cc
+ * @brief Command `diff-traces` class implementation.
+ *
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/diff_traces.hh>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <witness/witness.hh>
+#include <witness/witness_mgr.hh>
+
+namespace cmd {
+
+    DiffTraces::DiffTraces(Interpreter& owner)
+        : Command(owner)
+        , f_trace_id(NULL)
+        , f_other_id(NULL)
+    {}
+
+    DiffTraces::~DiffTraces()
+    {
+        free(f_trace_id);
+        free(f_other_id);
+    }
+
+    void DiffTraces::set_trace_id(pconst_char trace_id)
+    {
+        free(f_trace_id);
+        f_trace_id = strdup(trace_id);
+    }
+
+    void DiffTraces::set_other_id(pconst_char other_id)
+    {
+        free(f_other_id);
+        f_other_id = strdup(other_id);
+    }
+
+    utils::Variant DiffTraces::operator()()
+    {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        std::ostream& os { out() };
+
+        witness::Witness& a { wm.witness(f_trace_id) };
+        witness::Witness& b { f_other_id ? wm.witness(f_other_id) : wm.current() };
+
+        /* positions of the symbols of a in the language of b, -1 for
+           those b does not have */
+        const expr::ExprVector& lang { a.lang() };
+        bool same_lang { lang == b.lang() };
+
+        std::vector<int> remap;
+        if (!same_lang) {
+            for (expr::ExprVector::const_iterator i = lang.begin(); i != lang.end(); ++i) {
+                remap.push_back(b.symbol_index(*i));
+            }
+        }
+
+        witness::WitnessRows rows_a { a };
+        witness::WitnessRows rows_b { b };
+
+        std::vector<unsigned> positions;
+        bool equal_before { false };
+        unsigned ndiffs { 0 };
+
+        while (true) {
+            bool has_a { rows_a.next() };
+            bool has_b { rows_b.next() };
+
+            if (!has_a && !has_b) {
+                break;
+            }
+
+            if (!has_a || !has_b) {
+                os
+                    << "@"
+                    << (has_a ? rows_a.time() : rows_b.time())
+                    << ": only in `"
+                    << (has_a ? a.id() : b.id())
+                    << "`"
+                    << std::endl;
+
+                ++ndiffs;
+                continue;
+            }
+
+            const expr::ExprVector& x { rows_a.row() };
+            const expr::ExprVector& y { rows_b.row() };
+
+            positions.clear();
+            if (!same_lang) {
+                for (unsigned i = 0; i < x.size(); ++i) {
+                    if (-1 != remap[i] && x[i] != y[remap[i]]) {
+                        positions.push_back(i);
+                    }
+                }
+            }
+
+            /* rows were equal, only the values that changed since may
+               differ */
+            else if (equal_before && rows_a.changed() && rows_b.changed()) {
+                std::vector<unsigned> changed;
+                std::set_union(rows_a.changed()->begin(), rows_a.changed()->end(),
+                               rows_b.changed()->begin(), rows_b.changed()->end(),
+                               std::back_inserter(changed));
+
+                for (std::vector<unsigned>::const_iterator i = changed.begin(); i != changed.end(); ++i) {
+                    if (x[*i] != y[*i]) {
+                        positions.push_back(*i);
+                    }
+                }
+            }
+
+            /* values are pooled, rows are compared as plain memory */
+            else if (memcmp(x.data(), y.data(), x.size() * sizeof(expr::Expr_ptr))) {
+                for (unsigned i = 0; i < x.size(); ++i) {
+                    if (x[i] != y[i]) {
+                        positions.push_back(i);
+                    }
+                }
+            }
+
+            equal_before = positions.empty();
+            if (equal_before) {
+                continue;
+            }
+
+            os
+                << "@"
+                << rows_a.time()
+                << ":";
+
+            for (std::vector<unsigned>::const_iterator i = positions.begin(); i != positions.end(); ++i) {
+                os
+                    << (i == positions.begin() ? " " : ", ")
+                    << lang[*i];
+            }
+
+            os
+                << std::endl;
+
+            ++ndiffs;
+        }
+
+        if (ndiffs) {
+            os
+                << "-- Traces `"
+                << a.id()
+                << "` and `"
+                << b.id()
+                << "` differ in "
+                << ndiffs
+                << " steps"
+                << std::endl;
+        } else {
+            os
+                << "-- Traces `"
+                << a.id()
+                << "` and `"
+                << b.id()
+                << "` are the same"
+                << std::endl;
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    DiffTracesTopic::DiffTracesTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    DiffTracesTopic::~DiffTracesTopic()
+    {
+        TRACE
+            << "Destroyed diff-traces topic"
+            << std::endl;
+    }
+
+    void DiffTracesTopic::usage()
+    {
+        display_manpage("diff-traces");
+    }
+
+}; // namespace cmd
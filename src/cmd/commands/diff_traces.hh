@@ -0,0 +1,54 @@
+/*
+ * @file diff_traces.hh
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ **/
+#ifndef DIFF_TRACES_CMD_H
+#define DIFF_TRACES_CMD_H
+
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class DiffTraces: public Command {
+
+        pchar f_trace_id;
+        pchar f_other_id;
+
+    public:
+        DiffTraces(Interpreter& owner);
+        virtual ~DiffTraces();
+
+        void set_trace_id(pconst_char trace_id);
+        void set_other_id(pconst_char other_id);
+
+        utils::Variant virtual operator()();
+    };
+    typedef DiffTraces* DiffTraces_ptr;
+
+    class DiffTracesTopic: public CommandTopic {
+    public:
+        DiffTracesTopic(Interpreter& owner);
+        virtual ~DiffTracesTopic();
+
+        void virtual usage();
+    };
+
+}; // namespace cmd
+
+#endif // DIFF_TRACES_CMD_H
@@ -51,6 +51,7 @@ namespace cmd {
             Command_ptr c { *i };
             assert(NULL != c);
 
+            c->set_output(out());
             res = (*c)();
             if (cm.is_failure(res)) {
                 break;
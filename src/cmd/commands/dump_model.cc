@@ -28,13 +28,19 @@
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/dump_model.hh>
 
+#include <algorithms/fsm/fsm.hh>
+
+#include <compiler/btor2.hh>
+
 #include <model/model.hh>
 #include <model/model_mgr.hh>
 #include <model/module.hh>
+#include <model/snapshot.hh>
 
 #include <type/type.hh>
 
 #include <utils/logging.hh>
+#include <utils/profile.hh>
 
 namespace cmd {
 
@@ -44,6 +50,10 @@ namespace cmd {
         , f_state(false)
         , f_init(false)
         , f_trans(false)
+        , f_binary(false)
+        , f_aiger(false)
+        , f_btor2(false)
+        , f_target(NULL)
     {}
 
     DumpModel::~DumpModel()
@@ -75,6 +85,26 @@ namespace cmd {
         f_trans = true;
     }
 
+    void DumpModel::select_binary()
+    {
+        f_binary = true;
+    }
+
+    void DumpModel::select_aiger()
+    {
+        f_aiger = true;
+    }
+
+    void DumpModel::select_btor2()
+    {
+        f_btor2 = true;
+    }
+
+    void DumpModel::set_target(expr::Expr_ptr target)
+    {
+        f_target = target;
+    }
+
     void DumpModel::dump_heading(std::ostream& os, model::Module& module)
     {
         os
@@ -185,7 +215,7 @@ namespace cmd {
 
     std::ostream& DumpModel::get_output_stream()
     {
-        std::ostream* res { &std::cout };
+        std::ostream* res { &out() };
 
         if (f_output) {
             if (f_outfile == NULL) {
@@ -205,10 +235,85 @@ namespace cmd {
 
     utils::Variant DumpModel::operator()()
     {
+        utils::ProfileScope scope { "output" };
+
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         model::Model& model { mm.model() };
         const model::Modules& modules { model.modules() };
 
+        if (f_binary) {
+            if (!f_output) {
+                WARN
+                    << "Binary snapshots need an output file"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            /* sections can not be selected */
+            return utils::Variant(model::Snapshot::save(f_output) ? okMessage : errMessage);
+        }
+
+        if (f_target && !f_aiger && !f_btor2) {
+            WARN
+                << "A target is only written with --aiger or --btor2"
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        if (f_aiger && f_btor2) {
+            WARN
+                << "Only one of --aiger and --btor2 can be given"
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        if (f_btor2) {
+            if (modules.empty()) {
+                WARN
+                    << "Model not loaded"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            compiler::Btor2Export exporter { model };
+            try {
+                exporter.process(f_target, get_output_stream());
+            } catch (compiler::UnsupportedLowering& ul) {
+                WARN
+                    << ul.what()
+                    << std::endl
+                    << "  no BTOR2 lowering"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            return utils::Variant(okMessage);
+        }
+
+        if (f_aiger) {
+            if (modules.empty()) {
+                WARN
+                    << "Model not loaded"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            /* binary, when written to a `.aig` file */
+            size_t len { f_output ? strlen(f_output) : 0 };
+            bool binary { 4 <= len && !strcmp(f_output + len - 4, ".aig") };
+
+            fsm::AigerExport exporter { *this, model };
+            return utils::Variant(exporter.process(f_target, get_output_stream(), binary)
+                                      ? okMessage
+                                      : errMessage);
+        }
+
         std::ostream& out(get_output_stream());
         bool dump_all { !f_state && !f_init && !f_trans };
 
@@ -49,6 +49,18 @@ namespace cmd {
         void select_init();
         void select_trans();
 
+        /* a binary snapshot, see read-model --binary */
+        void select_binary();
+
+        /* the bit-blasted FSM as an AIG, with the states satisfying
+           target (if any) as bad states */
+        void select_aiger();
+
+        /* the FSM at the word level, in the BTOR2 format, with the
+           states satisfying target (if any) as bad states */
+        void select_btor2();
+        void set_target(expr::Expr_ptr target);
+
         utils::Variant virtual operator()();
 
     private:
@@ -58,6 +70,10 @@ namespace cmd {
         bool f_state;
         bool f_init;
         bool f_trans;
+        bool f_binary;
+        bool f_aiger;
+        bool f_btor2;
+        expr::Expr_ptr f_target;
 
         void dump_heading(std::ostream& os, model::Module& module);
         void dump_variables(std::ostream& os, model::Module& module);
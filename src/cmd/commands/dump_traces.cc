@@ -33,13 +33,20 @@
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 
+#include <witness/binary.hh>
 #include <witness/witness.hh>
 #include <witness/witness_mgr.hh>
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <boost/preprocessor/repetition/repeat.hpp>
 
+#include <jsoncpp/json/json.h>
+
+#include <utils/profile.hh>
+
 namespace cmd {
 
     static std::string build_unsupported_format_error_message(pconst_char format)
@@ -89,7 +96,8 @@ namespace cmd {
     {
         f_format = strdup(format);
         if (strcmp(f_format, TRACE_FMT_PLAIN) &&
-            strcmp(f_format, TRACE_FMT_JSON)) {
+            strcmp(f_format, TRACE_FMT_JSON) &&
+            strcmp(f_format, TRACE_FMT_BINARY)) {
             throw UnsupportedFormat(f_format);
         }
     }
@@ -123,51 +131,56 @@ namespace cmd {
 
     void DumpTraces::dump_plain(std::ostream& os, const witness::WitnessList& witness_list)
     {
+        /* one printer for all traces, output is flushed in chunks */
+        expr::Printer printer { os, true };
+
         std::for_each(
             begin(witness_list), end(witness_list),
-            [this, &os](witness::Witness_ptr wp) {
+            [this, &printer](witness::Witness_ptr wp) {
                 witness::Witness& w { *wp };
 
-                os
+                printer
                     << "-- "
                     << w.desc()
-                    << std::endl
+                    << "\n"
                     << "Witness: "
                     << w.id()
-                    << std::endl
-                    << std::endl;
+                    << "\n"
+                    << "\n";
 
                 expr::ExprVector input_assignments;
                 process_input(w, input_assignments);
 
                 if (0 < input_assignments.size()) {
-                    os
+                    printer
                         << ":: ENV"
-                        << std::endl;
-                    dump_plain_section(os, "input", input_assignments);
+                        << "\n";
+                    dump_plain_section(printer, "input", input_assignments);
                 }
 
+                DefineColumns defines;
+                process_defines(w, defines);
+
                 for (step_t time = w.first_time(); time <= w.last_time(); ++time) {
-                    os
+                    printer
                         << ":: @"
-                        << std::dec
-                        << time
-                        << std::endl;
+                        << (value_t) time
+                        << "\n";
 
                     expr::ExprVector state_vars_assignments;
                     expr::ExprVector defines_assignments;
 
-                    process_time_frame(w, time,
+                    process_time_frame(w, time, defines,
                                        state_vars_assignments,
                                        defines_assignments);
 
-                    dump_plain_section(os, "state", state_vars_assignments);
-                    dump_plain_section(os, "defines", defines_assignments);
+                    dump_plain_section(printer, "state", state_vars_assignments);
+                    dump_plain_section(printer, "defines", defines_assignments);
                 }
             });
     }
 
-    void DumpTraces::dump_plain_section(std::ostream& os,
+    void DumpTraces::dump_plain_section(expr::Printer& printer,
                                         const char* section,
                                         expr::ExprVector& assignments)
     {
@@ -181,122 +194,228 @@ namespace cmd {
             return;
         }
 
-        os
+        printer
             << "-- "
             << section
-            << std::endl;
+            << "\n";
 
         for (auto eq : assignments) {
-            os
+            printer
                 << TAB
                 << eq->lhs()
                 << " = "
                 << eq->rhs()
-                << std::endl;
+                << "\n";
         }
 
-        os
-            << std::endl;
+        printer
+            << "\n";
     }
 
-    void DumpTraces::dump_json(std::ostream& os, const witness::WitnessList& witness_list)
+    /* scalar values as JSON, nested arrays are not supported */
+    static void write_json_scalar(std::ostream& os, expr::Expr_ptr value)
     {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
 
-        Json::StreamWriterBuilder builder;
-        const std::unique_ptr<Json::StreamWriter> writer { builder.newStreamWriter() };
+        if (em.is_identifier(value)) {
+            os << Json::valueToQuotedString(value->atom().c_str());
+        } else if (em.is_bool_const(value)) {
+            os << (em.is_true(value) ? "true" : "false");
+        } else if (em.is_constant(value)) {
+            os << (Json::Value::UInt64) em.const_value(value);
+        } else {
+            os << "null";
+        }
+    }
+
+    void DumpTraces::dump_json(std::ostream& os, const witness::WitnessList& witness_list)
+    {
+        os
+            << "{"
+            << "\n"
+            << "   \"traces\" : [";
 
-        Json::Value root, lst { Json::arrayValue };
+        bool first_trace { true };
         std::for_each(
             begin(witness_list), end(witness_list),
-            [this, &em, &lst](witness::Witness_ptr wp) {
-                Json::Value obj;
-
-                obj["id"] = wp->id();
-                obj["description"] = wp->desc();
+            [this, &os, &first_trace](witness::Witness_ptr wp) {
+                os
+                    << (first_trace ? "\n" : ",\n")
+                    << "      {"
+                    << "\n"
+                    << "         \"id\" : "
+                    << Json::valueToQuotedString(wp->id().c_str())
+                    << ",\n"
+                    << "         \"description\" : "
+                    << Json::valueToQuotedString(wp->desc().c_str())
+                    << ",\n";
+                first_trace = false;
 
                 /* dump input assignments */
                 expr::ExprVector input_vars_assignments;
                 process_input(*wp, input_vars_assignments);
-                Json::Value input { section_to_json(input_vars_assignments) };
-                if (!input.empty()) {
-                    obj["input"] = input;
+                if (!input_vars_assignments.empty()) {
+                    bool first { true };
+
+                    os
+                        << "         ";
+                    dump_json_section(os, "input", input_vars_assignments, first);
+                    os
+                        << ",\n";
                 }
 
-                Json::Value steps { Json::arrayValue };
-                for (step_t time = wp->first_time(); time <= wp->last_time(); ++time) {
-                    Json::Value step;
+                os
+                    << "         \"steps\" : [";
+
+                DefineColumns defines;
+                process_defines(*wp, defines);
 
+                /* each step is written, then dropped */
+                for (step_t time = wp->first_time(); time <= wp->last_time(); ++time) {
                     expr::ExprVector state_vars_assignments;
                     expr::ExprVector defines_assignments;
-                    process_time_frame(*wp, time,
+                    process_time_frame(*wp, time, defines,
                                        state_vars_assignments,
                                        defines_assignments);
 
-                    Json::Value vars { section_to_json(state_vars_assignments) };
-                    if (!vars.empty()) {
-                        step["state"] = vars;
-                    }
+                    bool first { true };
+                    os
+                        << (time == wp->first_time() ? "\n" : ",\n")
+                        << "            { ";
 
-                    Json::Value defs { section_to_json(defines_assignments) };
-                    if (!defs.empty()) {
-                        step["defines"] = defs;
-                    }
+                    dump_json_section(os, "state", state_vars_assignments, first);
+                    dump_json_section(os, "defines", defines_assignments, first);
 
-                    steps.append(step);
+                    os
+                        << " }";
                 }
-                obj["steps"] = steps;
-                lst.append(obj);
+
+                os
+                    << "\n"
+                    << "         ]"
+                    << "\n"
+                    << "      }";
             });
 
-        root["traces"] = lst;
         os
-            << root.toStyledString()
+            << "\n"
+            << "   ]"
+            << "\n"
+            << "}"
             << std::endl;
     }
 
-    Json::Value DumpTraces::section_to_json(expr::ExprVector& assignments)
+    void DumpTraces::dump_json_section(std::ostream& os, const char* section,
+                                       expr::ExprVector& assignments, bool& first)
     {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
-        Json::Value res;
+
+        if (assignments.empty()) {
+            return;
+        }
+
+        os
+            << (first ? "" : ", ")
+            << "\""
+            << section
+            << "\" : { ";
+        first = false;
+
+        for (expr::ExprVector::const_iterator i = assignments.begin();
+             i != assignments.end(); ++i) {
+            expr::Atom lhs { (*i)->lhs()->rhs()->atom() };
+            expr::Expr_ptr rhs { (*i)->rhs() };
+
+            os
+                << (i == assignments.begin() ? "" : ", ")
+                << Json::valueToQuotedString(lhs.c_str())
+                << " : ";
+
+            if (em.is_array(rhs)) {
+                expr::ExprVector values { em.array_literals(rhs) };
+
+                os
+                    << "[ ";
+                for (expr::ExprVector::const_iterator j = values.begin();
+                     j != values.end(); ++j) {
+                    assert(!em.is_array(*j)); // nested arrays are not supported
+
+                    if (j != values.begin()) {
+                        os
+                            << ", ";
+                    }
+                    write_json_scalar(os, *j);
+                }
+                os
+                    << " ]";
+            } else {
+                write_json_scalar(os, rhs);
+            }
+        }
+
+        os
+            << " }";
+    }
+
+    void DumpTraces::dump_binary(std::ostream& os, const witness::WitnessList& witness_list)
+    {
+        witness::write_string(os, witness::BIN_MAGIC);
+        witness::write_varint(os, witness::BIN_VERSION);
+        witness::write_varint(os, witness_list.size());
 
         std::for_each(
-            begin(assignments), end(assignments),
-            [&res, &em](expr::Expr_ptr assignment) {
-                expr::Atom lhs { assignment->lhs()->rhs()->atom() };
-                expr::Expr_ptr rhs { assignment->rhs() };
-
-                if (em.is_identifier(rhs)) {
-                    res[lhs] = rhs->atom();
-                } else if (em.is_bool_const(rhs)) {
-                    res[lhs] = em.is_true(rhs);
-                } else if (em.is_array(rhs)) {
-                    Json::Value array_value { Json::arrayValue };
-                    expr::ExprVector values { em.array_literals(rhs) };
-
-                    std::for_each(begin(values), end(values),
-                                  [&array_value, &em](expr::Expr_ptr lit) {
-                                      Json::Value scalar;
-                                      if (em.is_identifier(lit)) {
-                                          scalar = lit->atom();
-                                      } else if (em.is_bool_const(lit)) {
-                                          scalar = em.is_true(lit);
-                                      } else if (em.is_array(lit)) {
-                                          assert(false); // nested arrays are not supported
-                                      } else if (em.is_constant(lit)) {
-                                          scalar = (Json::Value::UInt64) em.const_value(lit);
-                                      }
-                                      array_value.append(scalar);
-                                  });
-                    res[lhs] = array_value;
-                } else if (em.is_constant(rhs)) {
-                    res[lhs] = (Json::Value::UInt64) em.const_value(rhs);
-                } else {
-                    assert(false);
+            begin(witness_list), end(witness_list),
+            [this, &os](witness::Witness_ptr wp) {
+                witness::write_string(os, wp->id());
+                witness::write_string(os, wp->desc());
+
+                expr::ExprVector input_vars_assignments;
+                process_input(*wp, input_vars_assignments);
+
+                witness::write_varint(os, input_vars_assignments.size());
+                for (expr::ExprVector::const_iterator i = input_vars_assignments.begin();
+                     i != input_vars_assignments.end(); ++i) {
+                    witness::write_name(os, (*i)->lhs());
+                    witness::write_binary_value(os, (*i)->rhs());
+                }
+
+                witness::write_varint(os, wp->size());
+
+                /* names are the same for all steps, they are taken
+                   from the first one */
+                expr::ExprVector previous_state;
+                expr::ExprVector previous_defines;
+
+                DefineColumns defines;
+                process_defines(*wp, defines);
+
+                for (step_t time = wp->first_time(); time <= wp->last_time(); ++time) {
+                    expr::ExprVector state_vars_assignments;
+                    expr::ExprVector defines_assignments;
+                    process_time_frame(*wp, time, defines,
+                                       state_vars_assignments,
+                                       defines_assignments);
+
+                    if (time == wp->first_time()) {
+                        witness::write_varint(os, state_vars_assignments.size());
+                        for (expr::ExprVector::const_iterator i = state_vars_assignments.begin();
+                             i != state_vars_assignments.end(); ++i) {
+                            witness::write_name(os, (*i)->lhs());
+                        }
+
+                        witness::write_varint(os, defines_assignments.size());
+                        for (expr::ExprVector::const_iterator i = defines_assignments.begin();
+                             i != defines_assignments.end(); ++i) {
+                            witness::write_name(os, (*i)->lhs());
+                        }
+                    }
+
+                    witness::write_binary_values(os, state_vars_assignments, previous_state);
+                    witness::write_binary_values(os, defines_assignments, previous_defines);
                 }
             });
 
-        return res;
+        os.flush();
     }
 
     void DumpTraces::process_input(witness::Witness& w,
@@ -343,15 +462,38 @@ namespace cmd {
              fun);
     }
 
+    void DumpTraces::process_defines(witness::Witness& w, DefineColumns& defines)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
+        symb::SymbIter symbs { mm.model() };
+        while (symbs.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbs.next() };
+
+            symb::Symbol_ptr symb { pair.second };
+            if (symb->is_hidden() || !symb->is_define()) {
+                continue;
+            }
+
+            expr::Expr_ptr ctx { pair.first };
+            expr::Expr_ptr full { em.make_dot(ctx, symb->name()) };
+
+            defines.push_back(std::make_pair(full, expr::ExprVector()));
+            wm.eval_frames(w, ctx, symb->as_define().body(), defines.back().second);
+        }
+    }
+
     /* here UNDEF is used to fill up symbols not showing up in the witness where
        they're expected to. (i. e. UNDEF is only a UI entity) */
     void DumpTraces::process_time_frame(witness::Witness& w, step_t time,
+                                        const DefineColumns& defines,
                                         expr::ExprVector& state_vars_assignments,
                                         expr::ExprVector& defines_assignments)
     {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
-        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
 
         witness::TimeFrame& tf { w[time] };
         model::Model& model { mm.model() };
@@ -383,21 +525,17 @@ namespace cmd {
                 };
                 state_vars_assignments.push_back(em.make_eq(full, value));
             }
+        } /* while(symbs.has_next()) */
 
-            else if (symb->is_define()) {
-                symb::Define& define { symb->as_define() };
-                expr::Expr_ptr body { define.body() };
-
-                expr::Expr_ptr value {
-                    wm.eval(w, ctx, body, time)
-                };
-                if (!value) {
-                    value = em.make_undef();
-                }
-
-                defines_assignments.push_back(em.make_eq(full, value));
+        step_t k { time - w.first_time() };
+        for (const auto& define : defines) {
+            expr::Expr_ptr value { define.second[k] };
+            if (!value) {
+                value = em.make_undef();
             }
-        } /* while(symbs.has_next()) */
+
+            defines_assignments.push_back(em.make_eq(define.first, value));
+        }
 
         OrderingPreservingComparisonFunctor fun { model };
         sort(state_vars_assignments.begin(),
@@ -409,7 +547,7 @@ namespace cmd {
 
     std::ostream& DumpTraces::get_output_stream()
     {
-        std::ostream* res { &std::cout };
+        std::ostream* res { &out() };
         if (f_output) {
             if (f_outfile == NULL) {
                 DEBUG
@@ -428,6 +566,8 @@ namespace cmd {
 
     utils::Variant DumpTraces::operator()()
     {
+        utils::ProfileScope scope { "output" };
+
         std::ostream& os { get_output_stream() };
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
 
@@ -453,6 +593,8 @@ namespace cmd {
             dump_plain(os, witness_list);
         } else if (!strcmp(f_format, TRACE_FMT_JSON)) {
             dump_json(os, witness_list);
+        } else if (!strcmp(f_format, TRACE_FMT_BINARY)) {
+            dump_binary(os, witness_list);
         } else {
             assert(false);
         }
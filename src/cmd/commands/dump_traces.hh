@@ -29,12 +29,11 @@
 
 #include <cmd/command.hh>
 #include <expr/atom.hh>
+#include <expr/printer/printer.hh>
 
 #include <witness/witness.hh>
 #include <witness/witness_mgr.hh>
 
-#include <jsoncpp/json/json.h>
-
 namespace cmd {
 
     /** Raised when the type checker detects a wrong type */
@@ -76,7 +75,8 @@ namespace cmd {
         /* the trace ids selected for dumping */
         expr::AtomVector f_trace_ids;
 
-        /* the format to use for dumping (must be one of "plain", "json") */
+        /* the format to use for dumping (must be one of "plain",
+           "json", "binary") */
         pconst_char f_format;
 
         /* the output filepath (optional) */
@@ -116,23 +116,35 @@ namespace cmd {
         utils::Variant virtual operator()();
 
     private:
+        /* the values of each define, at all times of a witness */
+        typedef std::vector<std::pair<expr::Expr_ptr, expr::ExprVector>> DefineColumns;
+
         std::ostream* f_outfile { NULL };
         std::ostream& get_output_stream();
 
         /* PLAIN format helpers */
         void dump_plain(std::ostream& os, const witness::WitnessList& witness_list);
-        void dump_plain_section(std::ostream& os, const char* section, expr::ExprVector& assignments);
+        void dump_plain_section(expr::Printer& printer, const char* section, expr::ExprVector& assignments);
 
-        /* JSON format helpers */
+        /* JSON format helpers, frames are written as they are
+           processed */
         void dump_json(std::ostream& os, const witness::WitnessList& witness_list);
-        Json::Value section_to_json(expr::ExprVector& assignments);
+        void dump_json_section(std::ostream& os, const char* section,
+                               expr::ExprVector& assignments, bool& first);
+
+        /* BINARY format helpers */
+        void dump_binary(std::ostream& os, const witness::WitnessList& witness_list);
 
         /* these values actually come from the current environment */
         void process_input(witness::Witness& w,
                            expr::ExprVector& input_vars_assignments);
 
+        /* defines are evaluated once for all frames */
+        void process_defines(witness::Witness& w, DefineColumns& defines);
+
         /* these values actually belong to the trace */
         void process_time_frame(witness::Witness& w, step_t time,
+                                const DefineColumns& defines,
                                 expr::ExprVector& state_vars_assignments,
                                 expr::ExprVector& defines_assignments);
     };
@@ -23,6 +23,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
 
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/dup_trace.hh>
@@ -66,13 +67,30 @@ namespace cmd {
 
     utils::Variant DupTrace::operator()()
     {
-        /* FIXME: implement stream redirection for std{out,err} */
-        std::ostream& out(std::cout);
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        witness::Witness& w { wm.witness(f_trace_id) };
 
-        out
-            << outPrefix
-            << "WARNING: this commands currently does nothing!"
-            << std::endl;
+        std::ostringstream oss_id;
+        if (f_duplicate_id) {
+            oss_id
+                << f_duplicate_id;
+        } else {
+            oss_id
+                << w.id()
+                << "_"
+                << wm.autoincrement();
+        }
+
+        std::ostringstream oss_desc;
+        oss_desc
+            << "Duplicate of `"
+            << w.id()
+            << "`";
+
+        /* frames are copied as they are stored, deltas included */
+        witness::Witness_ptr dup { w.duplicate(oss_id.str(), oss_desc.str()) };
+        wm.record(*dup);
+        add_witness(dup->id());
 
         return utils::Variant(okMessage);
     }
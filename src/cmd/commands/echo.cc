@@ -57,7 +57,7 @@ namespace cmd {
         witness::WitnessMgr& wm(witness::WitnessMgr::INSTANCE());
 
         /* FIXME: implement stream redirection for std{out,err} */
-        std::ostream& out { std::cout };
+        std::ostream& out { this->out() };
 
         if (!om.quiet()) {
             out
@@ -0,0 +1,262 @@
+/**
+ * @file equiv.cc
+ * @brief Command `equiv` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <boost/filesystem.hpp>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/dump_traces.hh>
+#include <cmd/commands/equiv.hh>
+
+#include <algorithms/compiled_fsm.hh>
+#include <algorithms/fsm/fsm.hh>
+#include <algorithms/reach/reach.hh>
+#include <algorithms/reach/session.hh>
+#include <algorithms/sim/session.hh>
+
+#include <expr/rewrite_cache.hh>
+
+#include <model/miter.hh>
+#include <model/model_mgr.hh>
+
+#include <sat/inlining.hh>
+
+#include <witness/witness_mgr.hh>
+
+#include <parse.hh>
+
+#include <utils/logging.hh>
+#include <utils/profile.hh>
+
+namespace cmd {
+
+    Equiv::Equiv(Interpreter& owner)
+        : Command(owner)
+    {}
+
+    Equiv::~Equiv()
+    {
+        f_outputs.clear();
+    }
+
+    void Equiv::add_input(pconst_char input)
+    {
+        if (input) {
+            f_inputs.push_back(input);
+        }
+    }
+
+    void Equiv::add_output(expr::Expr_ptr output)
+    {
+        f_outputs.push_back(output);
+    }
+
+    bool Equiv::check_requirements()
+    {
+        if (2 != f_inputs.size()) {
+            out()
+                << wrnPrefix
+                << "Two revisions are needed, the old one and the new one. Aborting..."
+                << std::endl;
+
+            return false;
+        }
+
+        bool ok { true };
+        for (const auto& input : f_inputs) {
+            boost::filesystem::path modelpath { input };
+            if (!exists(modelpath) || !is_regular_file(modelpath)) {
+                WARN
+                    << "File `"
+                    << input
+                    << "` does not exist, or is not a regular file."
+                    << std::endl;
+
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    /* The two revisions are read on their own, and the model loaded is
+     * replaced by their miter (see model/miter.hh): the inputs of the
+     * two are tied, and the target is that any output differs. Bit
+     * equivalences of the two sides are proposed by simulation, and
+     * proven by induction (see mining.cc), before the search: the
+     * induction step is left with the state bits which do not match
+     * each other. */
+    utils::Variant Equiv::operator()()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+
+        if (!check_requirements()) {
+            return utils::Variant(errMessage);
+        }
+
+        /* as for read-model, nothing survives the model being
+           replaced */
+        reach::SessionMgr::INSTANCE().clear();
+        sim::SessionMgr::INSTANCE().clear();
+        fsm::DiameterMgr::INSTANCE().clear();
+        witness::WitnessMgr::INSTANCE().clear_programs();
+        expr::RewriteCache::INSTANCE().clear();
+
+        mm.reset();
+
+        model::Model_ptr revisions[2] { new model::Model(), new model::Model() };
+        bool ok { true };
+        {
+            utils::ProfileScope scope { "parse" };
+            for (unsigned i = 0; ok && i < 2; ++i) {
+                if (!parse::parseFileInto(f_inputs[i].c_str(), *revisions[i])) {
+                    WARN
+                        << "Syntax error"
+                        << std::endl;
+
+                    ok = false;
+                } else if (revisions[i]->empty()) {
+                    WARN
+                        << "File `"
+                        << f_inputs[i]
+                        << "` declares no module"
+                        << std::endl;
+
+                    ok = false;
+                }
+            }
+        }
+
+        model::Miter miter { mm.model(), *revisions[0], *revisions[1] };
+        if (ok && !miter.build(f_outputs)) {
+            ok = false;
+        }
+
+        delete revisions[0];
+        delete revisions[1];
+
+        if (ok && !mm.analyze()) {
+            WARN
+                << "Semantic error"
+                << std::endl;
+
+            ok = false;
+        }
+
+        if (ok && !mm.is_boolean()) {
+            (void) sat::InlinedOperatorMgr::INSTANCE();
+        }
+
+        algorithms::CompiledFSMMgr& fsm_mgr { algorithms::CompiledFSMMgr::INSTANCE() };
+        if (ok) {
+            fsm_mgr.invalidate();
+        } else {
+            fsm_mgr.clear();
+            return utils::Variant(errMessage);
+        }
+
+        reach::Reachability reachability { *this, mm.model() };
+        reachability.set_sweeping(true);
+        reachability.process(miter.target(), expr::ExprVector());
+
+        if (!om.quiet()) {
+            out()
+                << (reach::reachability_status_t::REACHABILITY_REACHABLE ==
+                            reachability.status()
+                        ? wrnPrefix
+                        : outPrefix);
+        }
+
+        bool res { false };
+        switch (reachability.status()) {
+            case reach::reachability_status_t::REACHABILITY_UNREACHABLE: {
+                unsigned n_outputs { (unsigned) miter.outputs().size() };
+                unsigned n_tied { (unsigned) miter.tied().size() };
+
+                out()
+                    << "Revisions are equivalent on "
+                    << n_outputs
+                    << " outputs, "
+                    << n_tied
+                    << " inputs tied."
+                    << std::endl;
+
+                res = true;
+                break;
+            }
+
+            case reach::reachability_status_t::REACHABILITY_REACHABLE:
+                out()
+                    << "Revisions differ";
+
+                if (reachability.has_witness()) {
+                    witness::Witness& w { reachability.witness() };
+
+                    out()
+                        << ", registered witness `"
+                        << w.id()
+                        << "`, "
+                        << w.size()
+                        << " steps."
+                        << std::endl;
+
+                    DumpTraces { this->f_owner }();
+                } else {
+                    out()
+                        << "."
+                        << std::endl;
+                }
+                break;
+
+            case reach::reachability_status_t::REACHABILITY_UNKNOWN:
+                out()
+                    << "Equivalence could not be decided."
+                    << std::endl;
+                break;
+
+            case reach::reachability_status_t::REACHABILITY_ERROR:
+                out()
+                    << "Unexpected error."
+                    << std::endl;
+                break;
+
+            default:
+                assert(false); /* unexpected */
+        }
+
+        return utils::Variant { res ? okMessage : errMessage };
+    }
+
+    EquivTopic::EquivTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    EquivTopic::~EquivTopic()
+    {}
+
+    void EquivTopic::usage()
+    {
+        display_manpage("equiv");
+    }
+
+} // namespace cmd
@@ -0,0 +1,70 @@
+/**
+ * @file equiv.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler interface for the `equiv`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef EQUIV_CMD_H
+#define EQUIV_CMD_H
+
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class Equiv: public Command {
+    public:
+        Equiv(Interpreter& owner);
+        virtual ~Equiv();
+
+        /** cmd params */
+
+        /* the old revision, then the new one */
+        void add_input(pconst_char input);
+
+        /* an output to be compared, all DEFINEs the two main modules
+           have in common if none is given */
+        void add_output(expr::Expr_ptr output);
+
+        /* run() */
+        utils::Variant virtual operator()();
+
+    private:
+        std::vector<std::string> f_inputs;
+        expr::ExprVector f_outputs;
+
+        // -- helpers -------------------------------------------------------------
+        bool check_requirements();
+    };
+    using Equiv_ptr = Equiv*;
+
+    class EquivTopic: public CommandTopic {
+    public:
+        EquivTopic(Interpreter& owner);
+        virtual ~EquivTopic();
+
+        void virtual usage();
+    };
+
+} // namespace cmd
+
+#endif /* EQUIV_CMD_H */
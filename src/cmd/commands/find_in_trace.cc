@@ -0,0 +1,195 @@
+/**
+ * @file find_in_trace.cc
+ * @brief Command `find-in-trace` class implementation.
+ *
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/find_in_trace.hh>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <witness/program.hh>
+#include <witness/witness.hh>
+#include <witness/witness_mgr.hh>
+
+namespace cmd {
+
+    FindInTrace::FindInTrace(Interpreter& owner)
+        : Command(owner)
+        , f_trace_id(NULL)
+        , f_predicate(NULL)
+        , f_all(false)
+    {}
+
+    FindInTrace::~FindInTrace()
+    {
+        free(f_trace_id);
+    }
+
+    void FindInTrace::set_trace_id(pconst_char trace_id)
+    {
+        free(f_trace_id);
+        f_trace_id = strdup(trace_id);
+    }
+
+    void FindInTrace::set_predicate(expr::Expr_ptr predicate)
+    {
+        f_predicate = predicate;
+    }
+
+    void FindInTrace::set_all(bool value)
+    {
+        f_all = value;
+    }
+
+    utils::Variant FindInTrace::operator()()
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        std::ostream& os { out() };
+
+        witness::Witness& w { f_trace_id ? wm.witness(f_trace_id) : wm.current() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        /* predicates over the vars of each frame are run on the rows,
+           and only where their support changed. Others are evaluated
+           frame by frame */
+        witness::Program_ptr program { witness::Program::compile(ctx, f_predicate) };
+        std::vector<unsigned> positions;
+
+        if (program) {
+            if (!program->type()->is_boolean()) {
+                WARN
+                    << "Predicate `"
+                    << f_predicate
+                    << "` is not boolean"
+                    << std::endl;
+
+                delete program;
+                return utils::Variant(errMessage);
+            }
+
+            const witness::Support& support { program->support() };
+            for (witness::Support::const_iterator i = support.begin(); i != support.end(); ++i) {
+                int index { w.symbol_index(i->first) };
+
+                if (0 != i->second || -1 == index) {
+                    positions.clear();
+                    delete program;
+                    program = NULL;
+                    break;
+                }
+
+                positions.push_back(index);
+            }
+        }
+
+        witness::WitnessRows rows { w };
+        expr::ExprVector values;
+        bool holds { false };
+        bool known { false };
+        unsigned nfound { 0 };
+
+        while (rows.next()) {
+            if (program) {
+                const std::vector<unsigned>* changed { rows.changed() };
+                bool stale { !known || !changed };
+
+                for (unsigned i = 0; !stale && i < positions.size(); ++i) {
+                    stale = std::binary_search(changed->begin(), changed->end(), positions[i]);
+                }
+
+                if (stale) {
+                    const expr::ExprVector& row { rows.row() };
+
+                    values.clear();
+                    for (std::vector<unsigned>::const_iterator i = positions.begin();
+                         i != positions.end() && row[*i]; ++i) {
+                        values.push_back(row[*i]);
+                    }
+
+                    expr::Expr_ptr value {
+                        values.size() == positions.size() ? program->execute(values) : NULL
+                    };
+
+                    holds = value && em.is_true(value);
+                    known = true;
+                }
+            } else {
+                expr::Expr_ptr value { wm.eval(w, ctx, f_predicate, rows.time()) };
+                holds = value && em.is_true(value);
+            }
+
+            if (!holds) {
+                continue;
+            }
+
+            os
+                << "@"
+                << rows.time()
+                << std::endl;
+
+            ++nfound;
+            if (!f_all) {
+                break;
+            }
+        }
+
+        delete program;
+
+        if (!nfound) {
+            os
+                << "-- Predicate `"
+                << f_predicate
+                << "` never holds in `"
+                << w.id()
+                << "`"
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    FindInTraceTopic::FindInTraceTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    FindInTraceTopic::~FindInTraceTopic()
+    {
+        TRACE
+            << "Destroyed find-in-trace topic"
+            << std::endl;
+    }
+
+    void FindInTraceTopic::usage()
+    {
+        display_manpage("find-in-trace");
+    }
+
+}; // namespace cmd
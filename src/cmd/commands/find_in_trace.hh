@@ -0,0 +1,60 @@
+/*
+ * @file find_in_trace.hh
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ **/
+#ifndef FIND_IN_TRACE_CMD_H
+#define FIND_IN_TRACE_CMD_H
+
+#include <cmd/command.hh>
+
+#include <expr/expr.hh>
+
+namespace cmd {
+
+    class FindInTrace: public Command {
+
+        pchar f_trace_id;
+        expr::Expr_ptr f_predicate;
+
+        /* all frames, not just the first one */
+        bool f_all;
+
+    public:
+        FindInTrace(Interpreter& owner);
+        virtual ~FindInTrace();
+
+        void set_trace_id(pconst_char trace_id);
+        void set_predicate(expr::Expr_ptr predicate);
+        void set_all(bool value);
+
+        utils::Variant virtual operator()();
+    };
+    typedef FindInTrace* FindInTrace_ptr;
+
+    class FindInTraceTopic: public CommandTopic {
+    public:
+        FindInTraceTopic(Interpreter& owner);
+        virtual ~FindInTraceTopic();
+
+        void virtual usage();
+    };
+
+}; // namespace cmd
+
+#endif // FIND_IN_TRACE_CMD_H
@@ -0,0 +1,107 @@
+/**
+ * @file gc.cc
+ * @brief Command `gc` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/gc.hh>
+
+#include <expr/collector.hh>
+#include <expr/expr_mgr.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    GC::GC(Interpreter& owner)
+        : Command(owner)
+        , f_stats(false)
+    {}
+
+    GC::~GC()
+    {}
+
+    void GC::set_stats(bool value)
+    {
+        f_stats = value;
+    }
+
+    utils::Variant GC::operator()()
+    {
+        expr::ExprCollector& collector { expr::ExprCollector::INSTANCE() };
+
+        if (!f_stats) {
+            /* this command holds no exprs, but others may be running */
+            collector.request();
+            return utils::Variant(okMessage);
+        }
+
+        expr::ExprCollectorStats stats { collector.stats() };
+
+        size_t live, bytes;
+        expr::ExprMgr::INSTANCE().pool_stats(live, bytes);
+
+        out()
+            << "Live exprs: "
+            << live
+            << " ("
+            << (bytes >> 10)
+            << " KB)"
+            << std::endl
+
+            << "Collections: "
+            << stats.collections
+            << ", "
+            << stats.freed
+            << " exprs freed"
+            << std::endl;
+
+        if (stats.collections) {
+            out()
+                << "Last collection: "
+                << stats.last_freed
+                << " exprs freed, "
+                << stats.last_live
+                << " live, took "
+                << stats.last_elapsed
+                << std::endl;
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    GCTopic::GCTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    GCTopic::~GCTopic()
+    {
+        TRACE
+            << "Destroyed gc topic"
+            << std::endl;
+    }
+
+    void GCTopic::usage()
+    {
+        display_manpage("gc");
+    }
+
+}; // namespace cmd
@@ -98,7 +98,7 @@ namespace cmd {
     utils::Variant Get::operator()()
     {
         /* FIXME: implement stream redirection for std{out,err} */
-        std::ostream& out { std::cout };
+        std::ostream& out { this->out() };
 
         if (NULL == f_identifier) {
             print_all_assignments(out);
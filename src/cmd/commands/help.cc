@@ -138,17 +138,17 @@ namespace cmd {
                 << std::endl;
 
             auto topics { CommandMgr::INSTANCE().topics() };
-            std::cout
+            out()
                 << "Available help topics:"
                 << std::endl;
 
             for (auto& topic : topics) {
-                std::cout
+                out()
                     << "- "
                     << topic
                     << std::endl;
             }
-            std::cout << std::endl;
+            out() << std::endl;
 
             return utils::Variant(okMessage);
         }
@@ -0,0 +1,81 @@
+/**
+ * @file jobs.cc
+ * @brief Command `jobs` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/jobs.hh>
+
+#include <cmd/jobs.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    Jobs::Jobs(Interpreter& owner)
+        : Command(owner)
+    {}
+
+    Jobs::~Jobs()
+    {}
+
+    utils::Variant Jobs::operator()()
+    {
+        static const char* labels[] = {
+            "Running", "Done", "Failed", "Killed",
+        };
+
+        std::ostream& os { out() };
+
+        JobMap jobs { JobMgr::INSTANCE().jobs() };
+        for (const auto& pair : jobs) {
+            Job& job { *pair.second };
+
+            os
+                << "["
+                << job.id()
+                << "] "
+                << labels[job.status()]
+                << "\t"
+                << job.descr()
+                << std::endl;
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    JobsTopic::JobsTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    JobsTopic::~JobsTopic()
+    {
+        TRACE
+            << "Destroyed jobs topic"
+            << std::endl;
+    }
+
+    void JobsTopic::usage()
+    {
+        display_manpage("jobs");
+    }
+
+} // namespace cmd
@@ -0,0 +1,75 @@
+/**
+ * @file kill.cc
+ * @brief Command `kill` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/kill.hh>
+
+#include <cmd/jobs.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    Kill::Kill(Interpreter& owner)
+        : Command(owner)
+        , f_job_id(0)
+    {}
+
+    Kill::~Kill()
+    {}
+
+    void Kill::set_job_id(unsigned job_id)
+    {
+        f_job_id = job_id;
+    }
+
+    /* the job's engines are interrupted, its output is still shown
+       on `wait` */
+    utils::Variant Kill::operator()()
+    {
+        Job_ptr job { JobMgr::INSTANCE().job(f_job_id) };
+        if (!job) {
+            throw UnknownJobId(f_job_id);
+        }
+
+        job->kill();
+        return utils::Variant(okMessage);
+    }
+
+    KillTopic::KillTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    KillTopic::~KillTopic()
+    {
+        TRACE
+            << "Destroyed kill topic"
+            << std::endl;
+    }
+
+    void KillTopic::usage()
+    {
+        display_manpage("kill");
+    }
+
+} // namespace cmd
@@ -46,7 +46,7 @@ namespace cmd {
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
         Interpreter& interpreter { Interpreter::INSTANCE() };
 
-        std::ostream& out { std::cout };
+        std::ostream& out { this->out() };
 
         utils::Variant& last { interpreter.last_result() };
 
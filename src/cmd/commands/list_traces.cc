@@ -41,7 +41,7 @@ namespace cmd {
         witness::Witness& current(wm.current());
 
         witness::WitnessList::const_iterator eye;
-        std::ostream& os { std::cout };
+        std::ostream& os { out() };
 
         const witness::WitnessList& witnesses { wm.witnesses() };
         if (!witnesses.empty()) {
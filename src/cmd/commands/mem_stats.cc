@@ -0,0 +1,210 @@
+/**
+ * @file mem_stats.cc
+ * @brief Command `mem-stats` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/dump_traces.hh>
+#include <cmd/commands/mem_stats.hh>
+
+#include <jsoncpp/json/json.h>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    /* one decimal digit is enough for estimates */
+    static inline std::ostream& mb(std::ostream& os, double bytes)
+    {
+        return os
+               << std::fixed << std::setprecision(1) << bytes / (1 << 20)
+               << " MB";
+    }
+
+    static inline size_t find_figure(const utils::MemoryUsage& usage,
+                                     const std::string& subsystem)
+    {
+        for (const auto& entry : usage) {
+            if (entry.first == subsystem) {
+                return entry.second;
+            }
+        }
+
+        return 0;
+    }
+
+    MemStats::MemStats(Interpreter& owner)
+        : Command(owner)
+        , f_format(strdup(TRACE_FMT_DEFAULT))
+        , f_output(NULL)
+    {}
+
+    MemStats::~MemStats()
+    {
+        free((pchar) f_format);
+        free(f_output);
+    }
+
+    void MemStats::set_format(pconst_char format)
+    {
+        free((pchar) f_format);
+        f_format = strdup(format);
+        if (strcmp(f_format, TRACE_FMT_PLAIN) &&
+            strcmp(f_format, TRACE_FMT_JSON)) {
+            throw UnsupportedFormat(f_format);
+        }
+    }
+
+    void MemStats::set_output(pconst_char output)
+    {
+        free(f_output);
+        f_output = strdup(output);
+    }
+
+    void MemStats::report(std::ostream& os, bool json)
+    {
+        utils::MemoryMgr& mem { utils::MemoryMgr::INSTANCE() };
+
+        utils::MemorySample current { mem.sample() };
+        utils::MemorySample peaks { mem.peaks() };
+
+        if (json) {
+            Json::Value root, lst { Json::arrayValue };
+
+            root["rss_kb"] = Json::Int64(current.rss_kb);
+            root["peak_rss_kb"] = Json::Int64(current.peak_rss_kb);
+
+            for (const auto& entry : current.usage) {
+                Json::Value obj;
+
+                obj["name"] = entry.first;
+                obj["bytes"] = Json::UInt64(entry.second);
+                obj["peak_bytes"] = Json::UInt64(find_figure(peaks.usage, entry.first));
+
+                lst.append(obj);
+            }
+            root["subsystems"] = lst;
+
+            os
+                << root.toStyledString()
+                << std::endl;
+
+            return;
+        }
+
+        os << "Resident set: ";
+        mb(os, 1024.0 * current.rss_kb)
+            << ", peak ";
+        mb(os, 1024.0 * current.peak_rss_kb)
+            << std::endl;
+
+        size_t total { 0 };
+        for (const auto& entry : current.usage) {
+            os
+                << entry.first
+                << ": ";
+            mb(os, entry.second)
+                << " (peak ";
+            mb(os, find_figure(peaks.usage, entry.first))
+                << ")"
+                << std::endl;
+
+            total += entry.second;
+        }
+
+        /* allocator overhead, stacks, caches without a probe */
+        double rss { 1024.0 * current.rss_kb };
+        os << "Unaccounted: ";
+        mb(os, total < rss ? rss - total : 0.0)
+            << std::endl;
+    }
+
+    utils::Variant MemStats::operator()()
+    {
+        if (f_output) {
+            std::ofstream out { f_output, std::ofstream::binary };
+            if (!out) {
+                ERR
+                    << "Can not open `"
+                    << f_output
+                    << "` for writing"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            report(out, !strcmp(f_format, TRACE_FMT_JSON));
+        } else {
+            report(out(), !strcmp(f_format, TRACE_FMT_JSON));
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    void print_memory_by_step(std::ostream& os,
+                              const std::map<step_t, utils::MemorySample>& steps)
+    {
+        for (const auto& step : steps) {
+            const utils::MemorySample& sample { step.second };
+
+            os
+                << "k = "
+                << step.first
+                << ": rss ";
+            mb(os, 1024.0 * sample.rss_kb)
+                << ", peak ";
+            mb(os, 1024.0 * sample.peak_rss_kb);
+
+            for (const auto& entry : sample.usage) {
+                os
+                    << ", "
+                    << entry.first
+                    << " ";
+                mb(os, entry.second);
+            }
+
+            os
+                << std::endl;
+        }
+    }
+
+    MemStatsTopic::MemStatsTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    MemStatsTopic::~MemStatsTopic()
+    {
+        TRACE
+            << "Destroyed mem-stats topic"
+            << std::endl;
+    }
+
+    void MemStatsTopic::usage()
+    {
+        display_manpage("mem-stats");
+    }
+
+}; // namespace cmd
@@ -0,0 +1,73 @@
+/**
+ * @file mem_stats.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler inteface for the `mem-stats`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MEM_STATS_CMD_H
+#define MEM_STATS_CMD_H
+
+#include <cmd/command.hh>
+
+#include <utils/memory.hh>
+
+#include <map>
+
+namespace cmd {
+
+    class MemStats: public Command {
+    public:
+        MemStats(Interpreter& owner);
+        virtual ~MemStats();
+
+        /* the format to use (must be one of "plain", "json") */
+        void set_format(pconst_char format);
+
+        /* the output filepath (optional) */
+        void set_output(pconst_char output);
+
+        utils::Variant virtual operator()();
+
+    private:
+        pconst_char f_format;
+        pchar f_output;
+
+        void report(std::ostream& os, bool json);
+    };
+
+    /* peak figures by unrolling step, e.g. of `reach --mem` */
+    void print_memory_by_step(std::ostream& os,
+                              const std::map<step_t, utils::MemorySample>& steps);
+
+    using MemStats_ptr = MemStats*;
+
+    class MemStatsTopic: public CommandTopic {
+    public:
+        MemStatsTopic(Interpreter& owner);
+        virtual ~MemStatsTopic();
+
+        void virtual usage();
+    };
+
+};     // namespace cmd
+#endif /* MEM_STATS_CMD_H */
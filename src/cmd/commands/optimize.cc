@@ -0,0 +1,169 @@
+/**
+ * @file optimize.cc
+ * @brief Command `optimize` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/dump_traces.hh>
+#include <cmd/commands/optimize.hh>
+
+#include <witness/witness_mgr.hh>
+
+namespace cmd {
+
+    Optimize::Optimize(Interpreter& owner)
+        : Command(owner)
+        , f_target(NULL)
+        , f_cost(NULL)
+        , f_binary(false)
+    {}
+
+    Optimize::~Optimize()
+    {
+        f_constraints.clear();
+    }
+
+    void Optimize::set_target(expr::Expr_ptr target)
+    {
+        f_target = target;
+    }
+
+    void Optimize::set_cost(expr::Expr_ptr cost)
+    {
+        f_cost = cost;
+    }
+
+    void Optimize::use_binary_search()
+    {
+        f_binary = true;
+    }
+
+    void Optimize::add_constraint(expr::Expr_ptr constraint)
+    {
+        f_constraints.push_back(constraint);
+    }
+
+    bool Optimize::check_requirements()
+    {
+        if (!f_target || !f_cost) {
+            out()
+                << wrnPrefix
+                << "No target or no cost given. Aborting..."
+                << std::endl;
+
+            return false;
+        }
+
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+        model::Model& model { mm.model() };
+        if (model.empty()) {
+            out()
+                << wrnPrefix
+                << "Model not loaded."
+                << std::endl;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    utils::Variant Optimize::operator()()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+        bool res { false };
+
+        if (!check_requirements()) {
+            return utils::Variant(errMessage);
+        }
+
+        reach::Optimization optimization { *this, mm.model() };
+        optimization.process(f_target, f_cost, f_constraints, f_binary);
+
+        if (!om.quiet()) {
+            out()
+                << (reach::reachability_status_t::REACHABILITY_UNREACHABLE ==
+                            optimization.status()
+                        ? wrnPrefix
+                        : outPrefix);
+        }
+
+        switch (optimization.status()) {
+            case reach::reachability_status_t::REACHABILITY_REACHABLE: {
+                witness::Witness& w { optimization.witness() };
+
+                out()
+                    << "Target is reachable, "
+                    << (optimization.optimal() ? "least" : "best known")
+                    << " cost is "
+                    << optimization.cost()
+                    << ", registered witness `"
+                    << w.id()
+                    << "`, "
+                    << w.size()
+                    << " steps."
+                    << std::endl;
+
+                DumpTraces { this->f_owner }();
+
+                res = optimization.optimal();
+                break;
+            }
+
+            case reach::reachability_status_t::REACHABILITY_UNREACHABLE:
+                out()
+                    << "Target is unreachable."
+                    << std::endl;
+                break;
+
+            case reach::reachability_status_t::REACHABILITY_UNKNOWN:
+                out()
+                    << "Reachability could not be decided."
+                    << std::endl;
+                break;
+
+            case reach::reachability_status_t::REACHABILITY_ERROR:
+                out()
+                    << "Unexpected error."
+                    << std::endl;
+                break;
+
+            default:
+                assert(false); /* unexpected */
+        }
+
+        return utils::Variant { res ? okMessage : errMessage };
+    }
+
+    OptimizeTopic::OptimizeTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    OptimizeTopic::~OptimizeTopic()
+    {}
+
+    void OptimizeTopic::usage()
+    {
+        display_manpage("optimize");
+    }
+
+} // namespace cmd
@@ -0,0 +1,76 @@
+/**
+ * @file optimize.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler interface for the `optimize`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef OPTIMIZE_CMD_H
+#define OPTIMIZE_CMD_H
+
+#include <algorithms/reach/optimize.hh>
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class Optimize: public Command {
+    public:
+        Optimize(Interpreter& owner);
+        virtual ~Optimize();
+
+        /** cmd params */
+        void set_target(expr::Expr_ptr target);
+
+        /* the cost to be minimized, at the last state of the witness */
+        void set_cost(expr::Expr_ptr cost);
+
+        /* binary search over the bound, instead of linear */
+        void use_binary_search();
+
+        void add_constraint(expr::Expr_ptr constraint);
+
+        /* run() */
+        utils::Variant virtual operator()();
+
+    private:
+        expr::Expr_ptr f_target;
+        expr::Expr_ptr f_cost;
+        bool f_binary;
+
+        expr::ExprVector f_constraints;
+
+        // -- helpers -------------------------------------------------------------
+        bool check_requirements();
+    };
+    using Optimize_ptr = Optimize*;
+
+    class OptimizeTopic: public CommandTopic {
+    public:
+        OptimizeTopic(Interpreter& owner);
+        virtual ~OptimizeTopic();
+
+        void virtual usage();
+    };
+
+} // namespace cmd
+
+#endif /* OPTIMIZE_CMD_H */
@@ -0,0 +1,165 @@
+/*
+ * @file parallel.cc
+ * @brief Command `parallel` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithms/scheduler.hh>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/parallel.hh>
+
+#include <cmd/cmd.hh>
+
+#include <boost/thread.hpp>
+
+namespace cmd {
+
+    Parallel::Parallel(Interpreter& owner)
+        : Command(owner)
+        , f_commands()
+        , f_jobs(0)
+        , f_next(0)
+    {}
+
+    Parallel::~Parallel()
+    {
+        for (auto outcome : f_outcomes) {
+            delete outcome;
+        }
+
+        f_commands.clear();
+    }
+
+    void Parallel::add_command(Command_ptr c)
+    {
+        f_commands.push_back(c);
+    }
+
+    void Parallel::set_jobs(unsigned jobs)
+    {
+        f_jobs = jobs;
+    }
+
+    /* commands are picked in submission order, each of them prints
+       to a stream of its own. Engines and watchdogs are scoped to the
+       algorithms of each command, limits and interruptions of one
+       command do not affect the others */
+    void Parallel::worker(utils::Context* context)
+    {
+        utils::ContextScope scope { *context };
+
+        while (true) {
+            unsigned index;
+            {
+                boost::mutex::scoped_lock lock { f_mutex };
+                if (f_commands.size() <= f_next) {
+                    break;
+                }
+                index = f_next++;
+            }
+
+            Command_ptr c { f_commands[index] };
+            Outcome& outcome { *f_outcomes[index] };
+
+            c->set_output(outcome.output);
+            try {
+                outcome.result = (*c)();
+            }
+
+            catch (Exception& e) {
+                outcome.error = e.what();
+                outcome.result = utils::Variant(errMessage);
+            }
+        }
+    }
+
+    utils::Variant Parallel::operator()()
+    {
+        CommandMgr& cm { CommandMgr::INSTANCE() };
+
+        unsigned n { (unsigned) f_commands.size() };
+        for (unsigned i = 0; i < n; ++i) {
+            f_outcomes.push_back(new Outcome());
+        }
+
+        unsigned jobs { f_jobs ? f_jobs : algorithms::Scheduler::INSTANCE().slots() };
+        if (n < jobs) {
+            jobs = n;
+        }
+
+        DEBUG
+            << "Running "
+            << n
+            << " commands, "
+            << jobs
+            << " at a time"
+            << std::endl;
+
+        boost::thread_group workers;
+        for (unsigned i = 0; i < jobs; ++i) {
+            workers.create_thread(
+                boost::bind(&Parallel::worker, this, &utils::Context::current()));
+        }
+        workers.join_all();
+
+        /* outputs are shown in submission order, the result is the
+           first failure if any */
+        utils::Variant res;
+        bool failed { false };
+        for (auto outcome : f_outcomes) {
+            out() << outcome->output.str();
+
+            if (!outcome->error.empty()) {
+                ERR
+                    << "Exception!! "
+                    << outcome->error
+                    << std::endl;
+            }
+
+            if (!failed) {
+                res = outcome->result;
+                failed = cm.is_failure(res);
+            }
+        }
+
+        return res;
+    }
+
+    ParallelTopic::ParallelTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    ParallelTopic::~ParallelTopic()
+    {
+        TRACE
+            << "Destroyed parallel topic"
+            << std::endl;
+    }
+
+    void ParallelTopic::usage()
+    {
+        display_manpage("parallel");
+    }
+
+}; // namespace cmd
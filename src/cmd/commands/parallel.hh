@@ -0,0 +1,83 @@
+/**
+ * @file parallel.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler inteface for the `parallel`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cmd/command.hh>
+#include <cmd/commands/do.hh>
+
+#include <utils/context.hh>
+
+#include <boost/thread/mutex.hpp>
+
+#include <sstream>
+
+namespace cmd {
+
+    class Parallel: public Command {
+        Commands f_commands;
+
+        /* max number of commands running at once, 0 for the number
+           of scheduler slots */
+        unsigned f_jobs;
+
+        /* per-command outputs and errors, by submission order */
+        struct Outcome {
+            std::ostringstream output;
+            std::string error;
+            utils::Variant result;
+        };
+        std::vector<Outcome*> f_outcomes;
+
+        /* next command to be started */
+        boost::mutex f_mutex;
+        unsigned f_next;
+
+        /* commands run in context, the one of the caller */
+        void worker(utils::Context* context);
+
+    public:
+        Parallel(Interpreter& owner);
+        virtual ~Parallel();
+
+        void add_command(Command_ptr command);
+        void set_jobs(unsigned jobs);
+
+        utils::Variant virtual operator()();
+    };
+    typedef Parallel* Parallel_ptr;
+
+    class ParallelTopic: public CommandTopic {
+    public:
+        ParallelTopic(Interpreter& owner);
+        virtual ~ParallelTopic();
+
+        void virtual usage();
+    };
+
+};     // namespace cmd
+#endif /* PARALLEL_H */
@@ -21,17 +21,24 @@
  *
  **/
 
+#include <fstream>
+#include <sstream>
+
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/pick_state.hh>
 
+#include <parse.hh>
+
 namespace cmd {
 
     PickState::PickState(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
         , f_allsat(false)
         , f_count(false)
         , f_limit(-1)
+        , f_jobs(1)
+        , f_samples(0)
+        , f_approx(false)
     {}
 
     PickState::~PickState()
@@ -57,13 +64,38 @@ namespace cmd {
         f_constraints.push_back(constraint);
     }
 
+    void PickState::set_jobs(unsigned jobs)
+    {
+        f_jobs = jobs;
+    }
+
+    void PickState::set_samples(value_t n)
+    {
+        f_samples = n;
+    }
+
+    void PickState::set_approx(bool approx)
+    {
+        f_approx = approx;
+    }
+
+    void PickState::set_sets(pconst_char path)
+    {
+        f_sets = path;
+    }
+
+    void PickState::add_projection(expr::Expr_ptr var)
+    {
+        f_projection.push_back(var);
+    }
+
     bool PickState::check_requirements()
     {
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         model::Model& model { mm.model() };
 
         if (0 == model.modules().size()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -72,7 +104,7 @@ namespace cmd {
         }
 
         if (f_allsat && f_count) {
-            f_out
+            out()
                 << wrnPrefix
                 << "ALLSAT counting and enumeration are mutually exclusive."
                 << std::endl;
@@ -80,6 +112,33 @@ namespace cmd {
             return false;
         }
 
+        if (0 < f_samples && (f_allsat || f_count)) {
+            out()
+                << wrnPrefix
+                << "Sampling, ALLSAT counting and enumeration are mutually exclusive."
+                << std::endl;
+
+            return false;
+        }
+
+        if (!f_sets.empty() && (f_allsat || f_count || 0 < f_samples)) {
+            out()
+                << wrnPrefix
+                << "Constraint sets are not supported by sampling, ALLSAT counting or enumeration."
+                << std::endl;
+
+            return false;
+        }
+
+        if (f_approx && !f_count) {
+            out()
+                << wrnPrefix
+                << "Approximate counting requires counting."
+                << std::endl;
+
+            return false;
+        }
+
         return true;
     }
 
@@ -87,7 +146,7 @@ namespace cmd {
     {
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
         if (!om.quiet()) {
-            f_out << wrnPrefix;
+            out() << wrnPrefix;
         }
     }
 
@@ -95,34 +154,147 @@ namespace cmd {
     {
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
         if (!om.quiet()) {
-            f_out << outPrefix;
+            out() << outPrefix;
         }
     }
 
+    /* one set per line, constraints separated by semicolons, `--`
+       starts a comment. Blank lines are skipped */
+    bool PickState::read_sets(std::vector<expr::ExprVector>& res)
+    {
+        std::ifstream is { f_sets.c_str() };
+        if (!is) {
+            WARN
+                << "Could not open constraint sets file `"
+                << f_sets
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+
+        unsigned lineno { 0 };
+        std::string line;
+        while (std::getline(is, line)) {
+            ++lineno;
+
+            std::string::size_type comment { line.find("--") };
+            if (std::string::npos != comment) {
+                line.erase(comment);
+            }
+
+            /* the constraints given with -c apply to all sets */
+            expr::ExprVector constraints { f_constraints };
+            bool empty { true };
+
+            std::istringstream iss { line };
+            std::string text;
+            while (std::getline(iss, text, ';')) {
+                if (std::string::npos == text.find_first_not_of(" \t\r")) {
+                    continue;
+                }
+
+                expr::Expr_ptr constraint { parse::parseExpression(text.c_str()) };
+                if (NULL == constraint) {
+                    WARN
+                        << "Malformed constraint at line "
+                        << lineno
+                        << " of `"
+                        << f_sets
+                        << "`"
+                        << std::endl;
+
+                    return false;
+                }
+
+                constraints.push_back(constraint);
+                empty = false;
+            }
+
+            if (!empty) {
+                res.push_back(constraints);
+            }
+        }
+
+        return true;
+    }
+
+    bool PickState::pick_sets()
+    {
+        std::vector<expr::ExprVector> sets;
+        if (!read_sets(sets)) {
+            return false;
+        }
+
+        sim::Simulation simulation { *this, model::ModelMgr::INSTANCE().model() };
+        std::vector<witness::Witness_ptr> witnesses;
+        value_t feasible { simulation.pick_states(sets, f_jobs, witnesses) };
+
+        for (unsigned i = 0; i < witnesses.size(); ++i) {
+            if (NULL != witnesses[i]) {
+                out_prefix();
+                out()
+                    << "Set "
+                    << i + 1
+                    << ": registered witness `"
+                    << witnesses[i]->id()
+                    << "`"
+                    << std::endl;
+            } else {
+                wrn_prefix();
+                out()
+                    << "Set "
+                    << i + 1
+                    << ": no feasible initial states found"
+                    << std::endl;
+            }
+        }
+
+        out_prefix();
+        out()
+            << feasible
+            << " of "
+            << sets.size()
+            << " constraint sets feasible"
+            << std::endl;
+
+        return 0 < feasible;
+    }
+
     utils::Variant PickState::operator()()
     {
         bool res { false };
-        if (check_requirements()) {
+        if (check_requirements() && !f_sets.empty()) {
+            res = pick_sets();
+        } else if (check_requirements()) {
             sim::Simulation simulation { *this, model::ModelMgr::INSTANCE().model() };
-            value_t states { simulation.pick_state(f_constraints, f_allsat, f_count, f_limit) };
+            value_t states {
+                0 < f_samples
+                    ? simulation.sample_states(f_constraints, f_projection, f_samples)
+                : f_approx
+                    ? simulation.approx_count_states(f_constraints, f_projection)
+                    : simulation.pick_state(f_constraints, f_projection, f_allsat, f_count, f_limit, f_jobs)
+            };
 
             if (0 == states) {
                 wrn_prefix();
-                f_out
+                out()
                     << "No feasible initial states found"
                     << std::endl;
             } else if (1 == states) {
                 res = true;
                 out_prefix();
-                f_out
+                out()
                     << "One feasible initial state found"
                     << std::endl;
             } else {
                 res = true;
                 out_prefix();
-                f_out
+                out()
+                    << (f_approx ? "About " : "")
                     << states
                     << " feasible initial states"
+                    << (0 < f_samples ? " sampled" : "")
                     << std::endl;
             }
         }
@@ -40,6 +40,9 @@ namespace cmd {
         /** cmd params */
         void add_constraint(expr::Expr_ptr constraint);
 
+        /* ALLSAT states are distinct on these vars only */
+        void add_projection(expr::Expr_ptr var);
+
         void set_allsat(bool value);
         inline bool allsat() const
         {
@@ -58,14 +61,28 @@ namespace cmd {
             return f_limit;
         }
 
+        /* near-uniform sampling of n states, approximate counting */
+        void set_samples(value_t n);
+        void set_approx(bool value);
+
+        void set_jobs(unsigned jobs);
+        inline unsigned jobs() const
+        {
+            return f_jobs;
+        }
+
+        /* one state per constraint set of the file, a set per line */
+        void set_sets(pconst_char path);
+
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
-
         /* (optional) additional constraints */
         expr::ExprVector f_constraints;
 
+        /* (optional) ALLSAT projection vars */
+        expr::ExprVector f_projection;
+
         /* perform ALLSAT enumeration? */
         bool f_allsat;
 
@@ -75,11 +92,27 @@ namespace cmd {
         /* ALLSAT enumeration/counting limit (optional) */
         unsigned f_limit;
 
+        /* ALLSAT parallel partitions */
+        unsigned f_jobs;
+
+        /* states sampled (0 if not sampling) */
+        value_t f_samples;
+
+        /* counting by hashing, rather than ALLSAT */
+        bool f_approx;
+
+        /* constraint sets file (optional) */
+        std::string f_sets;
+
         // -- helpers -------------------------------------------------------------
         bool check_requirements();
 
         void wrn_prefix();
         void out_prefix();
+
+        /* false (with a warning) if the file can not be read */
+        bool read_sets(std::vector<expr::ExprVector>& res);
+        bool pick_sets();
     };
 
     typedef PickState* PickState_ptr;
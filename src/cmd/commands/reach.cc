@@ -21,25 +21,41 @@
  *
  **/
 
+#include <algorithm>
 #include <cstring>
+#include <sstream>
 
 #include <expr/time/analyzer/analyzer.hh>
 
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/reach.hh>
 #include <cmd/commands/dump_traces.hh>
+#include <cmd/commands/mem_stats.hh>
+
+#include <algorithms/reach/result_cache.hh>
+
+#include <witness/witness_mgr.hh>
 
 namespace cmd {
 
     Reach::Reach(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
         , f_target(NULL)
 	, f_quiet(false)
+        , f_pdr(false)
+        , f_stride(1)
+        , f_geometric(false)
+        , f_session(false)
+        , f_memory(false)
+        , f_has_origin_time(false)
+        , f_origin_time(0)
+        , f_shorten(false)
+        , f_minimize(false)
     {}
 
     Reach::~Reach()
     {
+        f_targets.clear();
         f_constraints.clear();
     }
 
@@ -48,6 +64,11 @@ namespace cmd {
         f_target = target;
     }
 
+    void Reach::add_target(expr::Expr_ptr target)
+    {
+        f_targets.push_back(target);
+    }
+
     void Reach::add_constraint(expr::Expr_ptr constraint)
     {
         expr::time::Analyzer eta { expr::ExprMgr::INSTANCE() };
@@ -78,11 +99,77 @@ namespace cmd {
 	f_quiet = true;
     }
 
+    void Reach::use_pdr()
+    {
+        f_pdr = true;
+    }
+
+    void Reach::set_stride(step_t stride)
+    {
+        f_stride = std::max(stride, 1U);
+    }
+
+    void Reach::use_geometric_stride()
+    {
+        f_geometric = true;
+    }
+
+    void Reach::use_session()
+    {
+        f_session = true;
+    }
+
+    void Reach::track_memory()
+    {
+        f_memory = true;
+    }
+
+    void Reach::set_cnf_trace_path(pconst_char dirname)
+    {
+        f_cnf_trace_path = dirname;
+    }
+
+    void Reach::set_phase_seed(pconst_char trace_id)
+    {
+        f_phase_seed = trace_id;
+    }
+
+    void Reach::set_origin(pconst_char trace_id)
+    {
+        f_origin = trace_id;
+    }
+
+    void Reach::set_origin_time(step_t time)
+    {
+        f_has_origin_time = true;
+        f_origin_time = time;
+    }
+
+    void Reach::use_shortening()
+    {
+        f_shorten = true;
+    }
+
+    void Reach::use_minimization()
+    {
+        f_minimize = true;
+    }
+
+    void Reach::set_checkpoint(pconst_char path)
+    {
+        f_checkpoint = path;
+    }
+
+    void Reach::set_resume(pconst_char path)
+    {
+        f_resume = path;
+    }
+
 
     bool Reach::check_requirements()
     {
         if (!f_target) {
-            f_out
+            out()
                 << wrnPrefix
                 << "No target given. Aborting..."
                 << std::endl;
@@ -93,7 +180,7 @@ namespace cmd {
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         model::Model& model { mm.model() };
         if (model.empty()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -101,6 +188,35 @@ namespace cmd {
             return false;
         }
 
+        if (f_origin.empty() && f_has_origin_time) {
+            out()
+                << wrnPrefix
+                << "`--at` requires `--from-trace`. Aborting..."
+                << std::endl;
+
+            return false;
+        }
+
+        if ((!f_origin.empty() || f_shorten || f_minimize) &&
+            (f_pdr || !f_targets.empty())) {
+            out()
+                << wrnPrefix
+                << "Origin states and witness post-processing only supported by single target BMC. Aborting..."
+                << std::endl;
+
+            return false;
+        }
+
+        if ((!f_checkpoint.empty() || !f_resume.empty()) &&
+            (f_pdr || !f_targets.empty() || f_session || !f_origin.empty())) {
+            out()
+                << wrnPrefix
+                << "Checkpoints only supported by single target BMC, with no session nor origin states. Aborting..."
+                << std::endl;
+
+            return false;
+        }
+
         return true;
     }
 
@@ -114,26 +230,116 @@ namespace cmd {
             return utils::Variant(errMessage);
         }
 
-        reach::Reachability bmc { *this, mm.model() };
-        bmc.process(f_target, f_constraints);
+        if (!f_targets.empty()) {
+            return check_multiple_targets();
+        }
+
+        algorithms::Algorithm* algorithm { NULL };
+        pdr::PDR* ic3 { NULL };
+        reach::Checkpoint_ptr checkpoint { NULL };
+        reach::reachability_status_t status;
+
+        /* results from the initial states only, witnesses depend on
+           the algorithm and their post-processing */
+        reach::ResultCache_ptr cache { NULL };
+        witness::Witness_ptr cached { NULL };
+        bool hit { false };
+        if (!om.reach_cache().empty() && !f_session && f_origin.empty()) {
+            std::ostringstream oss;
+            oss
+                << (f_pdr ? "pdr" : "bmc")
+                << (f_shorten ? " shorten" : "")
+                << (f_minimize ? " minimize" : "");
+
+            cache = new reach::ResultCache(om.reach_cache(), mm.model(), f_target,
+                                           f_constraints, oss.str());
+            hit = cache->lookup(status, cached);
+            if (hit && NULL != cached) {
+                add_witness(cached->id());
+            }
+        }
 
-        switch (bmc.status()) {
+        if (hit) {
+            /* no strategy is run */
+        } else if (f_pdr) {
+            ic3 = new pdr::PDR(*this, mm.model());
+            ic3->set_cnf_trace_path(f_cnf_trace_path);
+            if (!f_phase_seed.empty()) {
+                ic3->set_phase_seed(witness::WitnessMgr::INSTANCE().witness(f_phase_seed));
+            }
+            if (f_memory) {
+                ic3->track_memory();
+            }
+            ic3->process(f_target, f_constraints);
+
+            status = ic3->status();
+            algorithm = ic3;
+        } else {
+            reach::Reachability* bmc { new reach::Reachability(*this, mm.model()) };
+            bmc->set_cnf_trace_path(f_cnf_trace_path);
+            bmc->set_stride(f_stride, f_geometric);
+            bmc->set_postprocessing(f_shorten, f_minimize);
+            if (!f_phase_seed.empty()) {
+                bmc->set_phase_seed(witness::WitnessMgr::INSTANCE().witness(f_phase_seed));
+            }
+            if (f_memory) {
+                bmc->track_memory();
+            }
+            if (f_session) {
+                bmc->set_session(&reach::SessionMgr::INSTANCE().session(mm.model()));
+            }
+            if (!f_origin.empty()) {
+                witness::Witness& origin { witness::WitnessMgr::INSTANCE().witness(f_origin) };
+                bmc->set_origin(origin, f_has_origin_time ? f_origin_time : origin.last_time());
+            }
+            if (!f_checkpoint.empty() || !f_resume.empty()) {
+                checkpoint = new reach::Checkpoint(f_checkpoint.empty() ? f_resume : f_checkpoint,
+                                                   mm.model(), f_target, f_constraints);
+                if (!f_resume.empty() && !checkpoint->load(f_resume)) {
+                    delete checkpoint;
+                    delete bmc;
+                    delete cache;
+                    return utils::Variant(errMessage);
+                }
+                bmc->set_checkpoint(checkpoint);
+            }
+            bmc->process(f_target, f_constraints);
+
+            /* undecided, e.g. out of resources: the last steps are
+               kept for the next run */
+            if (NULL != checkpoint &&
+                reach::reachability_status_t::REACHABILITY_UNKNOWN == bmc->status()) {
+                checkpoint->save();
+            }
+
+            status = bmc->status();
+            algorithm = bmc;
+        }
+
+        witness::Witness_ptr found {
+            NULL != algorithm && algorithm->has_witness() ? &algorithm->witness() : cached
+        };
+        if (NULL != cache && !hit) {
+            cache->store(status, found);
+        }
+
+        switch (status) {
             case reach::reachability_status_t::REACHABILITY_REACHABLE:
                 if (!om.quiet()) {
-                    f_out
+                    out()
                         << outPrefix;
                 }
 		if (! f_quiet) {
-		    f_out
+		    out()
 			<< "Target is reachable";
 
 		}
 
-		if (bmc.has_witness()) {
-                    witness::Witness& w { bmc.witness() };
+		if (NULL != found) {
+                    witness::Witness& w { *found };
 
                     if (! f_quiet) {
-			f_out
+			out()
 			    << ", registered witness `"
 			    << w.id()
 			    << "`, "
@@ -149,37 +355,40 @@ namespace cmd {
 
             case reach::reachability_status_t::REACHABILITY_UNREACHABLE:
                 if (!om.quiet()) {
-                    f_out
+                    out()
                         << wrnPrefix;
                 }
 		if (! f_quiet) {
-		    f_out
+		    out()
 			<< "Target is unreachable."
 			<< std::endl;
 
+                    if (NULL != ic3) {
+                        print_invariant(*ic3);
+                    }
 		}
                 break;
 
             case reach::reachability_status_t::REACHABILITY_UNKNOWN:
 		if (!om.quiet()) {
-                    f_out
+                    out()
                         << outPrefix;
                 }
 
 		// cannot be quiet about undecidability
-		f_out
+		out()
 		    << "Reachability could not be decided."
 		    << std::endl;
                 break;
 
             case reach::reachability_status_t::REACHABILITY_ERROR:
 		if (!om.quiet()) {
-                    f_out
+                    out()
                         << outPrefix;
                 }
 
 		// cannot be quiet about errors
-		f_out
+		out()
 		    << "Unexpected error."
 		    << std::endl;
                 break;
@@ -188,9 +397,137 @@ namespace cmd {
                 assert(false); /* unexpected */
         }
 
+        if (f_memory && NULL != algorithm) {
+            print_memory_by_step(out(), algorithm->memory_by_step());
+        }
+
+        delete algorithm;
+        delete checkpoint;
+        delete cache;
+        return utils::Variant { res ? okMessage : errMessage };
+    }
+
+    utils::Variant Reach::check_multiple_targets()
+    {
+        opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+        bool res { false };
+
+        if (f_pdr) {
+            out()
+                << wrnPrefix
+                << "Multiple targets not supported by PDR. Aborting..."
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        expr::ExprVector targets { f_target };
+        targets.insert(targets.end(), f_targets.begin(), f_targets.end());
+
+        reach::MultiReachability multi { *this, mm.model() };
+        multi.set_cnf_trace_path(f_cnf_trace_path);
+        if (!f_phase_seed.empty()) {
+            multi.set_phase_seed(witness::WitnessMgr::INSTANCE().witness(f_phase_seed));
+        }
+        if (f_memory) {
+            multi.track_memory();
+        }
+        multi.process(targets, f_constraints);
+
+        /* one line per target, in order */
+        for (const auto& result : multi.results()) {
+            if (!om.quiet()) {
+                out()
+                    << ((reach::reachability_status_t::REACHABILITY_REACHABLE == result.status)
+                        ? outPrefix : wrnPrefix);
+            }
+
+            out()
+                << "Target `"
+                << result.target
+                << "` ";
+
+            switch (result.status) {
+                case reach::reachability_status_t::REACHABILITY_REACHABLE:
+                    out()
+                        << "is reachable (k = "
+                        << result.depth
+                        << ")";
+
+                    if (NULL != result.witness) {
+                        add_witness(result.witness->id());
+                        out()
+                            << ", registered witness `"
+                            << result.witness->id()
+                            << "`";
+                    }
+                    res = true;
+                    break;
+
+                case reach::reachability_status_t::REACHABILITY_UNREACHABLE:
+                    out()
+                        << "is unreachable (k = "
+                        << result.depth
+                        << ")";
+                    break;
+
+                case reach::reachability_status_t::REACHABILITY_UNKNOWN:
+                    out()
+                        << "could not be decided";
+                    break;
+
+                case reach::reachability_status_t::REACHABILITY_ERROR:
+                    out()
+                        << "unexpected error";
+                    break;
+
+                default:
+                    assert(false); /* unexpected */
+            }
+
+            out()
+                << "."
+                << std::endl;
+        }
+
+        if (f_memory) {
+            print_memory_by_step(out(), multi.memory_by_step());
+        }
+
         return utils::Variant { res ? okMessage : errMessage };
     }
 
+    void Reach::print_invariant(const pdr::PDR& ic3)
+    {
+        const std::vector<std::string>& invariant { ic3.invariant() };
+
+        out()
+            << "Inductive invariant ("
+            << invariant.size()
+            << " clauses):"
+            << std::endl;
+
+        if (invariant.empty()) {
+            out()
+                << "  TRUE"
+                << std::endl;
+        }
+
+        for (const auto& clause : invariant) {
+            out()
+                << "  "
+                << clause
+                << std::endl;
+        }
+
+        out()
+            << "PDR: ";
+        ic3.print_frames(out());
+        out()
+            << std::endl;
+    }
+
     ReachTopic::ReachTopic(Interpreter& owner)
         : CommandTopic(owner)
     {}
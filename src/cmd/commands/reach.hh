@@ -26,7 +26,9 @@
 #ifndef REACH_CMD_H
 #define REACH_CMD_H
 
+#include <algorithms/pdr/pdr.hh>
 #include <algorithms/reach/reach.hh>
+#include <algorithms/reach/multi.hh>
 #include <cmd/command.hh>
 
 namespace cmd {
@@ -39,29 +41,104 @@ namespace cmd {
         /** cmd params */
         void set_target(expr::Expr_ptr target);
 
+        /* multiple targets, checked along with the first one over a
+           shared unrolling */
+        void add_target(expr::Expr_ptr target);
+
         /* guided reachability support: forward, backward and global guides */
         void add_constraint(expr::Expr_ptr constraint);
 
 	/* quiet mode */
 	void go_quiet();
 
+        /* IC3/PDR instead of the BMC strategies */
+        void use_pdr();
+
+        /* step-jumping BMC, stride steps at once (geometric: doubled
+           at each unrolling) */
+        void set_stride(step_t stride);
+        void use_geometric_stride();
+
+        /* persistent session, the unrolling is kept for later
+           commands */
+        void use_session();
+
+        /* peak memory figures by unrolling step, printed once done */
+        void track_memory();
+
+        /* CNF tracing, DIMACS and iCNF files are written in dirname */
+        void set_cnf_trace_path(pconst_char dirname);
+
+        /* decision phases are seeded from the given trace */
+        void set_phase_seed(pconst_char trace_id);
+
+        /* the search resumes from a state of the given trace, the
+           last one unless a time is given */
+        void set_origin(pconst_char trace_id);
+        void set_origin_time(step_t time);
+
+        /* witnesses are post-processed (see reach::Reachability) */
+        void use_shortening();
+        void use_minimization();
+
+        /* steps completed are checkpointed to path, a run resumed
+           from a checkpoint skips the steps it completed and
+           checkpoints to the same path, unless another is given */
+        void set_checkpoint(pconst_char path);
+        void set_resume(pconst_char path);
+
         /* run() */
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
-
         /* the negation of invariant property to be verified */
         expr::Expr_ptr f_target;
 
+        /* additional targets */
+        expr::ExprVector f_targets;
+
 	/* if true and a witness is found, it is immediately displayed */
 	bool f_quiet;
 
+        /* if true, PDR is used */
+        bool f_pdr;
+
+        /* step-jumping BMC */
+        step_t f_stride;
+        bool f_geometric;
+
+        /* if true, the persistent session is used */
+        bool f_session;
+
+        /* if true, memory is tracked by unrolling step */
+        bool f_memory;
+
         /* constraints for guided reachability */
         expr::ExprVector f_constraints;
 
+        /* CNF tracing directory (if not empty) */
+        std::string f_cnf_trace_path;
+
+        /* phase seeding trace (if not empty) */
+        std::string f_phase_seed;
+
+        /* origin trace (if not empty), and time */
+        std::string f_origin;
+        bool f_has_origin_time;
+        step_t f_origin_time;
+
+        /* witness post-processing */
+        bool f_shorten;
+        bool f_minimize;
+
+        /* checkpointing and resume paths (if not empty) */
+        std::string f_checkpoint;
+        std::string f_resume;
+
         // -- helpers -------------------------------------------------------------
         bool check_requirements();
+        utils::Variant check_multiple_targets();
+        void print_invariant(const pdr::PDR& ic3);
     };
     using Reach_ptr = Reach*;
 
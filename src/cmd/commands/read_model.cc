@@ -29,17 +29,33 @@
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/read_model.hh>
 
+#include <algorithms/compiled_fsm.hh>
+#include <algorithms/fsm/fsm.hh>
+#include <algorithms/reach/session.hh>
+#include <algorithms/sim/session.hh>
+
+#include <expr/rewrite_cache.hh>
+
+#include <model/aiger.hh>
 #include <model/model_mgr.hh>
+#include <model/snapshot.hh>
+
+#include <sat/inlining.hh>
+
+#include <witness/witness_mgr.hh>
 
 #include <parse.hh>
 
 #include <utils/logging.hh>
+#include <utils/profile.hh>
 
 namespace cmd {
 
     ReadModel::ReadModel(Interpreter& owner)
         : Command(owner)
         , f_input(NULL)
+        , f_binary(false)
+        , f_aiger(false)
     {}
 
     ReadModel::~ReadModel()
@@ -56,6 +72,25 @@ namespace cmd {
         }
     }
 
+    void ReadModel::add_input(pconst_char input)
+    {
+        if (!f_input) {
+            set_input(input);
+        } else if (input) {
+            f_more_inputs.push_back(input);
+        }
+    }
+
+    void ReadModel::select_binary()
+    {
+        f_binary = true;
+    }
+
+    void ReadModel::select_aiger()
+    {
+        f_aiger = true;
+    }
+
     bool ReadModel::check_requirements()
     {
         if (!f_input) {
@@ -66,6 +101,14 @@ namespace cmd {
             return false;
         }
 
+        if (!f_more_inputs.empty() && (f_binary || f_aiger)) {
+            WARN
+                << "Snapshots and AIGs are read from a single file."
+                << std::endl;
+
+            return false;
+        }
+
         return true;
     }
 
@@ -79,35 +122,112 @@ namespace cmd {
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
         bool ok { true };
 
-        boost::filesystem::path modelpath { f_input };
-        if (!exists(modelpath)) {
-            WARN
-                << "File `"
-                << f_input
-                << "` does not exist."
-                << std::endl;
-
-            ok = false;
-        } else if (!is_regular_file(modelpath)) {
-            WARN
-                << "File `"
-                << f_input
-                << "` is not a regular file."
-                << std::endl;
+        /* sessions, diameters and compiled programs do not survive
+           the model they were built on. Compiled FSM sections (and
+           types) of unchanged modules do, see below */
+        reach::SessionMgr::INSTANCE().clear();
+        sim::SessionMgr::INSTANCE().clear();
+        fsm::DiameterMgr::INSTANCE().clear();
+        witness::WitnessMgr::INSTANCE().clear_programs();
+        expr::RewriteCache::INSTANCE().clear();
+
+        std::vector<std::string> inputs { f_input };
+        inputs.insert(inputs.end(), f_more_inputs.begin(), f_more_inputs.end());
+
+        for (const auto& input : inputs) {
+            boost::filesystem::path modelpath { input };
+            if (!exists(modelpath)) {
+                WARN
+                    << "File `"
+                    << input
+                    << "` does not exist."
+                    << std::endl;
+
+                ok = false;
+            } else if (!is_regular_file(modelpath)) {
+                WARN
+                    << "File `"
+                    << input
+                    << "` is not a regular file."
+                    << std::endl;
+
+                ok = false;
+            }
+        }
 
-            ok = false;
-        } else if (!parse::parseFile(f_input)) {
-            WARN
-                << "Syntax error"
-                << std::endl;
+        if (!ok) {
+            /* nothing read */
+        } else if (f_binary) {
+            /* no parsing, nor type checking */
+            bool loaded;
+            {
+                utils::ProfileScope scope { "parse" };
+                loaded = model::Snapshot::load(f_input);
+            }
+
+            if (!loaded) {
+                ok = false;
+            } else if (!mm.analyze()) {
+                WARN
+                    << "Semantic error"
+                    << std::endl;
+
+                ok = false;
+            }
+        } else if (f_aiger) {
+            bool loaded;
+            {
+                utils::ProfileScope scope { "parse" };
+                loaded = model::Aiger::load(f_input);
+            }
+
+            if (!loaded) {
+                ok = false;
+            } else if (!mm.analyze()) {
+                WARN
+                    << "Semantic error"
+                    << std::endl;
+
+                ok = false;
+            }
+        } else {
+            mm.reset();
+
+            bool parsed;
+            {
+                utils::ProfileScope scope { "parse" };
+                parsed = f_more_inputs.empty()
+                             ? parse::parseFile(f_input)
+                             : parse::parseFiles(inputs);
+            }
+
+            if (!parsed) {
+                WARN
+                    << "Syntax error"
+                    << std::endl;
+
+                ok = false;
+            } else if (!mm.analyze()) {
+                WARN
+                    << "Semantic error"
+                    << std::endl;
+
+                ok = false;
+            }
+        }
 
-            ok = false;
-        } else if (!mm.analyze()) {
-            WARN
-                << "Semantic error"
-                << std::endl;
+        /* microcode is for algebraic operators only, its index is
+           read here (rather than by the first strategy needing it)
+           unless the model is boolean */
+        if (ok && !mm.is_boolean()) {
+            (void) sat::InlinedOperatorMgr::INSTANCE();
+        }
 
-            ok = false;
+        algorithms::CompiledFSMMgr& fsm_mgr { algorithms::CompiledFSMMgr::INSTANCE() };
+        if (ok) {
+            fsm_mgr.invalidate();
+        } else {
+            fsm_mgr.clear();
         }
 
         return utils::Variant { ok ? okMessage : errMessage };
@@ -45,10 +45,26 @@ namespace cmd {
             return f_input;
         }
 
+        /* the first input, or one more file of the same model (the
+           files are parsed concurrently, see parse::parseFiles) */
+        void add_input(pconst_char input);
+
+        /* input is a binary snapshot, see dump-model --binary */
+        void select_binary();
+
+        /* input is an AIG, in the AIGER format */
+        void select_aiger();
+
         utils::Variant virtual operator()();
 
     private:
         bool check_requirements();
+
+        bool f_binary;
+        bool f_aiger;
+
+        /* files past the first one */
+        std::vector<std::string> f_more_inputs;
     };
     typedef ReadModel* ReadModel_ptr;
 
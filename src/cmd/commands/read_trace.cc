@@ -21,19 +21,28 @@
  *
  **/
 
+#include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithms/scheduler.hh>
+
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/read_trace.hh>
 
 #include <model/model_mgr.hh>
 
+#include <type/type_mgr.hh>
+
 #include <parse.hh>
 
 #include <witness/witness.hh>
@@ -54,7 +63,7 @@ namespace cmd {
             symb::Symbol_ptr symbol { pair.second };
 
             expr::Expr_ptr identifier { em.make_dot(ctx, symbol->name()) };
-            f_lang.push_back(identifier);
+            add_symbol(identifier);
 
             DEBUG
                 << "Added symbol `"
@@ -74,8 +83,8 @@ namespace cmd {
 
     ReadTrace::ReadTrace(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
         , f_input(NULL)
+        , f_jobs(1)
     {}
 
     ReadTrace::~ReadTrace()
@@ -92,6 +101,11 @@ namespace cmd {
         }
     }
 
+    void ReadTrace::set_jobs(unsigned jobs)
+    {
+        f_jobs = std::max(1U, jobs);
+    }
+
     bool ReadTrace::check_requirements()
     {
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
@@ -106,7 +120,7 @@ namespace cmd {
 
         model::Model& model { mm.model() };
         if (model.empty()) {
-            f_out
+            out()
                 << wrnPrefix
                 << "Model not loaded."
                 << std::endl;
@@ -173,13 +187,200 @@ namespace cmd {
         return utils::Variant { ok ? okMessage : errMessage };
     }
 
-    bool ReadTrace::parsePlainTrace(boost::filesystem::path& tracepath)
+    /* frames are decoded in batches, so that memory is bounded */
+    static const unsigned PLAIN_BATCH_FRAMES { 1024 };
+
+    /* batches smaller than this are not worth splitting */
+    static const unsigned PLAIN_MIN_FRAMES_PER_JOB { 64 };
+
+    static inline bool is_id_first_char(char c)
+    {
+        return isalpha(c) || '_' == c;
+    }
+
+    static inline bool is_id_following_char(char c)
+    {
+        return is_id_first_char(c) || isdigit(c) || '-' == c || '#' == c || '$' == c;
+    }
+
+    /* `a.b.c`, NULL unless text is a dotted identifier. Keywords are
+       not ruled out here, only names in the witness' language are
+       ever accepted for the lhs */
+    static expr::Expr_ptr fast_identifier(const std::string& text)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        expr::Expr_ptr res { NULL };
+        size_t i { 0 };
+        while (i < text.size()) {
+            if (!is_id_first_char(text[i])) {
+                return NULL;
+            }
+
+            size_t j { i + 1 };
+            while (j < text.size() && is_id_following_char(text[j])) {
+                ++j;
+            }
+
+            expr::Expr_ptr id { em.make_identifier(text.substr(i, j - i)) };
+            res = res ? em.make_dot(res, id) : id;
+
+            if (j == text.size()) {
+                break;
+            }
+            if ('.' != text[j] || j + 1 == text.size()) {
+                return NULL;
+            }
+            i = j + 1;
+        }
+
+        return res;
+    }
+
+    static bool all_of_class(const std::string& text, size_t from, const char* digits)
+    {
+        if (text.size() <= from) {
+            return false;
+        }
+
+        for (size_t i = from; i < text.size(); ++i) {
+            if (!strchr(digits, text[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* constants, booleans and enum literals, built as the parser
+       would. NULL if text needs to be parsed */
+    static expr::Expr_ptr fast_value(const std::string& text)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        if (text.empty()) {
+            return NULL;
+        }
+
+        if ("0" == text || ('0' != text[0] && all_of_class(text, 0, "0123456789"))) {
+            return em.make_dec_const(text);
+        }
+
+        if ('0' == text[0] && 1 < text.size()) {
+            char c { text[1] };
+
+            if (('x' == c || 'X' == c) && all_of_class(text, 2, "0123456789abcdefABCDEF")) {
+                return em.make_hex_const(text);
+            }
+            if (('b' == c || 'B' == c) && all_of_class(text, 2, "01")) {
+                return em.make_bin_const(text);
+            }
+            if (all_of_class(text, 1, "01234567")) {
+                return em.make_oct_const(text);
+            }
+
+            return NULL;
+        }
+
+        if (!is_id_first_char(text[0]) ||
+            text.end() != std::find_if(text.begin(), text.end(),
+                                       [](char c) { return !is_id_following_char(c); })) {
+            return NULL;
+        }
+
+        expr::Expr_ptr id { em.make_identifier(text) };
+        if (em.is_true(id) || em.is_false(id)) {
+            return id;
+        }
+
+        const symb::Literals& literals { tm.literals() };
+        if (literals.end() != literals.find(em.make_dot(em.make_empty(), id))) {
+            return id;
+        }
+
+        return NULL;
+    }
+
+    void ReadTrace::decode_plain_frames(PlainFrames& frames, unsigned begin, unsigned end)
+    {
+        for (unsigned k = begin; k < end; ++k) {
+            std::vector<PlainAssignment>& assignments { frames[k].assignments };
+
+            for (std::vector<PlainAssignment>::iterator i = assignments.begin();
+                 i != assignments.end(); ++i) {
+                i->lhs = fast_identifier(i->lhs_text);
+                i->rhs = fast_value(i->rhs_text);
+            }
+        }
+    }
+
+    void ReadTrace::flush_plain_frames(witness::Witness& witness, PlainFrames& frames)
     {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        unsigned nframes { (unsigned) frames.size() };
+        unsigned njobs {
+            std::min(f_jobs, std::max(1U, nframes / PLAIN_MIN_FRAMES_PER_JOB))
+        };
+
+        if (1 == njobs) {
+            decode_plain_frames(frames, 0, nframes);
+        } else {
+            algorithms::Tasks tasks;
+            for (unsigned j = 0; j < njobs; ++j) {
+                tasks.push_back(algorithms::Task(
+                    "read_trace",
+                    boost::bind(&ReadTrace::decode_plain_frames, this,
+                                boost::ref(frames),
+                                j * nframes / njobs, (j + 1) * nframes / njobs)));
+            }
+
+            algorithms::Scheduler::INSTANCE().run(tasks, []() { return true; });
+        }
+
+        /* frames are filled before the next one is added, so that
+           they are sealed with their values. The parser is not
+           reentrant, the assignments the fast path could not decode
+           are parsed here */
+        expr::Expr_ptr ctx { em.make_empty() };
+        for (PlainFrames::iterator i = frames.begin(); i != frames.end(); ++i) {
+            witness::TimeFrame& tf { witness.extend() };
+            if (i->time != witness.last_time()) {
+                throw ReadTraceException("FileFormat", "Unexpected time");
+            }
+
+            for (std::vector<PlainAssignment>::iterator j = i->assignments.begin();
+                 j != i->assignments.end(); ++j) {
+                expr::Expr_ptr lhs {
+                    j->lhs ? j->lhs : parse::parseExpression(j->lhs_text.c_str())
+                };
+                expr::Expr_ptr rhs {
+                    j->rhs ? j->rhs : parse::parseExpression(j->rhs_text.c_str())
+                };
+
+                DRIVEL
+                    << lhs
+                    << " = "
+                    << rhs
+                    << std::endl;
+
+                tf.set_value(em.make_dot(ctx, lhs), rhs);
+            }
+        }
+
+        frames.clear();
+    }
+
+    bool ReadTrace::parsePlainTrace(boost::filesystem::path& tracepath)
+    {
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
 
         witness::Witness_ptr witness = NULL;
-        witness::TimeFrame_ptr current = NULL;
+        PlainFrames frames;
+
+        /* INPUT values belong to the environment, not to the trace */
+        bool env { false };
 
         TRACE
             << "Reading PLAIN trace from file "
@@ -207,12 +408,25 @@ namespace cmd {
                                 trimmed, strlen(id_prefix)))
                     };
 
+                    /* one file may hold several traces */
+                    if (witness) {
+                        flush_plain_frames(*witness, frames);
+                        wm.record(*witness);
+                        add_witness(witness->id());
+                    }
+
                     std::ostringstream oss;
                     oss
                         << "Loaded from "
                         << tracepath;
 
                     witness = new ReadTraceWitness(witness_id, oss.str());
+                    env = false;
+                    continue;
+                }
+
+                if (":: ENV" == trimmed) {
+                    env = true;
                     continue;
                 }
 
@@ -224,9 +438,17 @@ namespace cmd {
                         << time_string
                         << std::endl;
 
+                    if (!witness) {
+                        throw ReadTraceException("FileFormat", "Missing witness id");
+                    }
+
+                    if (PLAIN_BATCH_FRAMES == frames.size()) {
+                        flush_plain_frames(*witness, frames);
+                    }
+
                     step_t k { (step_t) std::stoi(time_string) };
-                    current = &witness->extend();
-                    assert(k == witness->last_time());
+                    frames.push_back(PlainFrame { k, std::vector<PlainAssignment>() });
+                    env = false;
                     continue;
                 }
 
@@ -238,23 +460,20 @@ namespace cmd {
                         throw ReadTraceException("FileFormat", "Malformed assignment");
                     }
 
-                    expr::Expr_ptr ctx { em.make_empty() };
-                    expr::Expr_ptr lhs {
-                        parse::parseExpression(
-                            boost::algorithm::trim_copy(split[0]).c_str())
-                    };
-                    expr::Expr_ptr rhs {
-                        parse::parseExpression(
-                            boost::algorithm::trim_copy(split[1]).c_str())
-                    };
+                    if (env) {
+                        continue;
+                    }
 
-                    DRIVEL
-                        << lhs
-                        << " = "
-                        << rhs
-                        << std::endl;
+                    if (frames.empty()) {
+                        throw ReadTraceException("FileFormat", "Assignment out of time frame");
+                    }
 
-                    current->set_value(em.make_dot(ctx, lhs), rhs);
+                    PlainAssignment assignment {
+                        boost::algorithm::trim_copy(split[0]),
+                        boost::algorithm::trim_copy(split[1]),
+                        NULL, NULL
+                    };
+                    frames.back().assignments.push_back(assignment);
                     continue;
                 }
 
@@ -266,7 +485,13 @@ namespace cmd {
             }
 
             src.close();
+            if (!witness) {
+                return false;
+            }
+
+            flush_plain_frames(*witness, frames);
             wm.record(*witness);
+            add_witness(witness->id());
 
             return true;
         }
@@ -274,16 +499,340 @@ namespace cmd {
         return false;
     }
 
+    /* A pull tokenizer for JSON, values are read as they come. Only
+       ASCII escapes are supported in strings */
+    class JsonStream {
+    public:
+        JsonStream(std::istream& is)
+            : f_is(is)
+        {}
+
+        /* the next non-blank char, not consumed */
+        int peek()
+        {
+            int c;
+            while (EOF != (c = f_is.peek()) && isspace(c)) {
+                f_is.get();
+            }
+
+            return c;
+        }
+
+        void expect(char c)
+        {
+            if (c != peek()) {
+                fail();
+            }
+            f_is.get();
+        }
+
+        /* consumes c, if it comes next */
+        bool accept(char c)
+        {
+            if (c != peek()) {
+                return false;
+            }
+            f_is.get();
+
+            return true;
+        }
+
+        std::string read_string()
+        {
+            std::string res;
+
+            expect('"');
+            for (int c = f_is.get(); '"' != c; c = f_is.get()) {
+                if (EOF == c) {
+                    fail();
+                }
+
+                if ('\\' == c) {
+                    c = f_is.get();
+                    switch (c) {
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    case 'u': {
+                        char hex[5] = { 0 };
+                        if (!f_is.read(hex, 4)) {
+                            fail();
+                        }
+                        long code { strtol(hex, NULL, 0x10) };
+                        c = code < 0x80 ? (int) code : '?';
+                        break;
+                    }
+                    case '"':
+                    case '\\':
+                    case '/':
+                        break;
+                    default:
+                        fail();
+                    }
+                }
+
+                res.push_back((char) c);
+            }
+
+            return res;
+        }
+
+        /* numbers and the true, false and null words */
+        std::string read_word()
+        {
+            std::string res;
+
+            peek();
+            for (int c = f_is.peek(); EOF != c && (isalnum(c) || strchr("+-.", c)); c = f_is.peek()) {
+                res.push_back((char) f_is.get());
+            }
+
+            if (res.empty()) {
+                fail();
+            }
+
+            return res;
+        }
+
+        void skip_value()
+        {
+            int c { peek() };
+
+            if ('"' == c) {
+                read_string();
+            } else if ('{' == c || '[' == c) {
+                char close { '{' == c ? '}' : ']' };
+
+                f_is.get();
+                if (accept(close)) {
+                    return;
+                }
+                do {
+                    if ('}' == close) {
+                        read_string();
+                        expect(':');
+                    }
+                    skip_value();
+                } while (accept(','));
+                expect(close);
+            } else {
+                read_word();
+            }
+        }
+
+        void fail()
+        {
+            throw ReadTraceException("FileFormat", "Malformed JSON");
+        }
+
+    private:
+        std::istream& f_is;
+    };
+
+    /* scalars and arrays of scalars, NULL for null values */
+    static expr::Expr_ptr json_value(JsonStream& js)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        int c { js.peek() };
+        if ('"' == c) {
+            return em.make_identifier(js.read_string());
+        }
+
+        if ('[' == c) {
+            expr::ExprVector values;
+
+            js.expect('[');
+            if (!js.accept(']')) {
+                do {
+                    expr::Expr_ptr value { json_value(js) };
+                    if (!value) {
+                        js.fail();
+                    }
+                    values.push_back(value);
+                } while (js.accept(','));
+                js.expect(']');
+            }
+
+            if (values.empty()) {
+                js.fail();
+            }
+
+            expr::Expr_ptr res { values.back() };
+            for (unsigned i = values.size() - 1; 0 < i; --i) {
+                res = em.make_array_comma(values[i - 1], res);
+            }
+
+            return em.make_array(res);
+        }
+
+        if ('{' == c) {
+            js.fail();
+        }
+
+        std::string word { js.read_word() };
+        if ("true" == word) {
+            return em.make_true();
+        }
+        if ("false" == word) {
+            return em.make_false();
+        }
+        if ("null" == word) {
+            return NULL;
+        }
+
+        char* end;
+        value_t value { (value_t) strtoull(word.c_str(), &end, 10) };
+        if (*end) {
+            js.fail();
+        }
+
+        return em.make_const(value);
+    }
+
+    /* { "name" : value, ... } into frame tf */
+    static void json_section(JsonStream& js, witness::TimeFrame& tf)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        expr::Expr_ptr ctx { em.make_empty() };
+
+        js.expect('{');
+        if (js.accept('}')) {
+            return;
+        }
+
+        do {
+            expr::Expr_ptr lhs { em.make_identifier(js.read_string()) };
+            js.expect(':');
+
+            expr::Expr_ptr rhs { json_value(js) };
+            if (rhs) {
+                tf.set_value(em.make_dot(ctx, lhs), rhs);
+            }
+        } while (js.accept(','));
+        js.expect('}');
+    }
+
+    static witness::Witness_ptr json_trace(JsonStream& js, const boost::filesystem::path& tracepath)
+    {
+        witness::Witness_ptr res { NULL };
+
+        js.expect('{');
+        if (js.accept('}')) {
+            js.fail();
+        }
+
+        do {
+            std::string key { js.read_string() };
+            js.expect(':');
+
+            if ("id" == key) {
+                std::ostringstream oss;
+                oss
+                    << "Loaded from "
+                    << tracepath;
+
+                res = new ReadTraceWitness(js.read_string(), oss.str());
+            }
+
+            else if ("steps" == key) {
+                /* each step is decoded as it is read */
+                if (!res) {
+                    throw ReadTraceException("FileFormat", "Missing witness id");
+                }
+
+                js.expect('[');
+                if (js.accept(']')) {
+                    continue;
+                }
+
+                do {
+                    witness::TimeFrame& tf { res->extend() };
+
+                    js.expect('{');
+                    if (js.accept('}')) {
+                        continue;
+                    }
+
+                    do {
+                        std::string section { js.read_string() };
+                        js.expect(':');
+
+                        if ("state" == section || "defines" == section) {
+                            json_section(js, tf);
+                        } else {
+                            js.skip_value();
+                        }
+                    } while (js.accept(','));
+                    js.expect('}');
+                } while (js.accept(','));
+                js.expect(']');
+            }
+
+            /* the description is replaced, INPUT values belong to the
+               environment */
+            else {
+                js.skip_value();
+            }
+        } while (js.accept(','));
+        js.expect('}');
+
+        if (!res) {
+            throw ReadTraceException("FileFormat", "Missing witness id");
+        }
+
+        return res;
+    }
+
     bool ReadTrace::parseJsonTrace(boost::filesystem::path& tracepath)
     {
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+
         TRACE
             << "Reading JSON trace from file "
             << tracepath
             << " ..."
             << std::endl;
 
-        // TODO: not implemented yet
-        return false;
+        std::ifstream src { tracepath.string() };
+        if (!src.is_open()) {
+            return false;
+        }
+
+        /* traces are recorded as soon as they are read */
+        JsonStream js { src };
+        bool found { false };
+
+        js.expect('{');
+        if (!js.accept('}')) {
+            do {
+                std::string key { js.read_string() };
+                js.expect(':');
+
+                if ("traces" != key) {
+                    js.skip_value();
+                    continue;
+                }
+
+                js.expect('[');
+                if (js.accept(']')) {
+                    continue;
+                }
+
+                do {
+                    witness::Witness_ptr witness { json_trace(js, tracepath) };
+                    wm.record(*witness);
+                    add_witness(witness->id());
+                    found = true;
+                } while (js.accept(','));
+                js.expect(']');
+            } while (js.accept(','));
+            js.expect('}');
+        }
+
+        return found;
     }
 
     bool ReadTrace::parseYamlTrace(boost::filesystem::path& tracepath)
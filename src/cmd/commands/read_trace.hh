@@ -27,6 +27,9 @@
 #ifndef READ_TRACE_H
 #define READ_TRACE_H
 
+#include <string>
+#include <vector>
+
 #include <cmd/command.hh>
 
 #include <expr/atom.hh>
@@ -47,16 +50,40 @@ namespace cmd {
             return f_input;
         }
 
+        /* values of PLAIN traces are decoded by up to jobs threads */
+        void set_jobs(unsigned jobs);
+        inline unsigned jobs() const
+        {
+            return f_jobs;
+        }
+
         utils::Variant virtual operator()();
 
     private:
-        std::ostream& f_out;
         pchar f_input;
+        unsigned f_jobs;
 
         bool check_requirements();
         bool parseJsonTrace(boost::filesystem::path& tracepath);
         bool parseYamlTrace(boost::filesystem::path& tracepath);
         bool parsePlainTrace(boost::filesystem::path& tracepath);
+
+        /* the frames of a PLAIN trace read so far, not yet decoded */
+        struct PlainAssignment {
+            std::string lhs_text;
+            std::string rhs_text;
+
+            expr::Expr_ptr lhs;
+            expr::Expr_ptr rhs;
+        };
+        struct PlainFrame {
+            step_t time;
+            std::vector<PlainAssignment> assignments;
+        };
+        typedef std::vector<PlainFrame> PlainFrames;
+
+        void decode_plain_frames(PlainFrames& frames, unsigned begin, unsigned end);
+        void flush_plain_frames(witness::Witness& witness, PlainFrames& frames);
     };
     typedef ReadTrace* ReadTrace_ptr;
 
@@ -23,6 +23,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 
 #include <cmd/commands/commands.hh>
 #include <cmd/commands/simulate.hh>
@@ -31,11 +32,14 @@ namespace cmd {
 
     Simulate::Simulate(Interpreter& owner)
         : Command(owner)
-        , f_out(std::cout)
         , f_invar_condition(NULL)
         , f_until_condition(NULL)
         , f_k(1)
+        , f_random(false)
+        , f_lanes(false)
+        , f_period(1)
         , f_trace_uid(NULL)
+        , f_inputs(NULL)
     {}
 
 
@@ -43,6 +47,9 @@ namespace cmd {
     {
         free(f_trace_uid);
         f_trace_uid = NULL;
+
+        free(f_inputs);
+        f_inputs = NULL;
     }
 
     void Simulate::set_invar_condition(expr::Expr_ptr invar_condition)
@@ -66,81 +73,138 @@ namespace cmd {
         f_trace_uid = strdup(trace_uid);
     }
 
+    void Simulate::set_inputs(pconst_char inputs)
+    {
+        free(f_inputs);
+        f_inputs = strdup(inputs);
+    }
+
     void Simulate::set_k(step_t k)
     {
         f_k = k;
     }
 
+    void Simulate::set_random(bool random)
+    {
+        f_random = random;
+    }
+
+    void Simulate::set_lanes(bool lanes)
+    {
+        f_lanes = lanes;
+    }
+
+    void Simulate::set_period(step_t period)
+    {
+        f_period = period;
+    }
+
     utils::Variant Simulate::operator()()
     {
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
         model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
 
+        std::ifstream inputs;
+        if (NULL != f_inputs) {
+            inputs.open(f_inputs);
+            if (!inputs) {
+                WARN
+                    << "Could not open input vectors file `"
+                    << f_inputs
+                    << "`"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+        }
+
         sim::Simulation simulation(*this, mm.model());
 
         bool res { false };
 
-        expr::ExprVector f_constraints;
+        /* the invariant condition holds in each simulated step */
+        expr::ExprVector constraints { f_constraints };
+        if (NULL != f_invar_condition) {
+            constraints.push_back(f_invar_condition);
+        }
+
         sim::simulation_status_t rc {
-            simulation.simulate(f_constraints, f_trace_uid)
+            NULL != f_inputs
+                ? simulation.stream_simulate(constraints, f_trace_uid, inputs)
+            : !f_random
+                ? simulation.simulate(constraints, f_trace_uid, f_k)
+                : f_lanes
+                ? simulation.lanes_simulate(constraints, f_k, f_period)
+                : simulation.random_simulate(constraints, f_trace_uid, f_k, f_period)
         };
 
         switch (rc) {
             case sim::simulation_status_t::SIMULATION_DONE:
                 res = true;
                 if (!om.quiet()) {
-                    f_out
+                    out()
                         << outPrefix;
                 }
 
-                f_out
+                out()
                     << "Simulation done";
                 break;
 
             case sim::simulation_status_t::SIMULATION_DEADLOCKED:
                 if (!om.quiet()) {
-                    f_out
+                    out()
                         << wrnPrefix;
                 }
 
-                f_out
+                out()
                     << "Simulation deadlocked"
                     << std::endl;
                 break;
 
             case sim::simulation_status_t::SIMULATION_INTERRUPTED:
                 if (!om.quiet()) {
-                    f_out
+                    out()
                         << wrnPrefix;
                 }
 
-                f_out
+                out()
                     << "Simulation interrupted"
                     << std::endl;
                 break;
 
+            case sim::simulation_status_t::SIMULATION_UNKNOWN:
+                if (!om.quiet()) {
+                    out()
+                        << wrnPrefix;
+                }
+
+                out()
+                    << "Simulation could not be performed"
+                    << std::endl;
+                break;
+
             default:
                 assert(false); /* unreachable */
         }
 
         if (simulation.has_witness()) {
             if (!om.quiet()) {
-                f_out
+                out()
                     << outPrefix;
             }
 
-            f_out
+            out()
                 << "Registered witness `"
                 << simulation.witness().id()
                 << "`"
                 << std::endl;
         } else {
             if (!om.quiet()) {
-                f_out
+                out()
                     << wrnPrefix;
             }
 
-            f_out
+            out()
                 << "(no witness available)"
                 << std::endl;
         }
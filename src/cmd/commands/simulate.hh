@@ -57,6 +57,31 @@ namespace cmd {
             return f_k;
         }
 
+        void set_random(bool random);
+        inline bool random() const
+        {
+            return f_random;
+        }
+
+        void set_lanes(bool lanes);
+        inline bool lanes() const
+        {
+            return f_lanes;
+        }
+
+        void set_period(step_t period);
+        inline step_t period() const
+        {
+            return f_period;
+        }
+
+        /* input vectors, one step per line (see concrete.cc) */
+        void set_inputs(pconst_char inputs);
+        inline pconst_char inputs() const
+        {
+            return f_inputs;
+        }
+
         void set_trace_uid(pconst_char trace_uid);
         inline pconst_char trace_uid() const
         {
@@ -64,8 +89,6 @@ namespace cmd {
         }
 
     private:
-        std::ostream& f_out;
-
         /* (optional) additional constraints */
         expr::ExprVector f_constraints;
 
@@ -78,8 +101,16 @@ namespace cmd {
         /* Number of simulation steps to be performed (optional) */
         step_t f_k;
 
+        /* Random simulation, one state every period is recorded */
+        bool f_random;
+        bool f_lanes;
+        step_t f_period;
+
         /* Simulation trace uid (optional) */
         pchar f_trace_uid;
+
+        /* Input vectors file (optional) */
+        pchar f_inputs;
     };
 
     typedef Simulate* Simulate_ptr;
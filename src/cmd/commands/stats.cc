@@ -0,0 +1,117 @@
+/**
+ * @file stats.cc
+ * @brief Command `stats` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/dump_traces.hh>
+#include <cmd/commands/stats.hh>
+
+#include <sat/engine_mgr.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    Stats::Stats(Interpreter& owner)
+        : Command(owner)
+        , f_format(strdup(TRACE_FMT_DEFAULT))
+        , f_output(NULL)
+        , f_clear(false)
+    {}
+
+    Stats::~Stats()
+    {
+        free((pchar) f_format);
+        free(f_output);
+    }
+
+    void Stats::set_format(pconst_char format)
+    {
+        free((pchar) f_format);
+        f_format = strdup(format);
+        if (strcmp(f_format, TRACE_FMT_PLAIN) &&
+            strcmp(f_format, TRACE_FMT_JSON)) {
+            throw UnsupportedFormat(f_format);
+        }
+    }
+
+    void Stats::set_output(pconst_char output)
+    {
+        free(f_output);
+        f_output = strdup(output);
+    }
+
+    void Stats::set_clear(bool value)
+    {
+        f_clear = value;
+    }
+
+    utils::Variant Stats::operator()()
+    {
+        sat::EngineMgr& mgr { sat::EngineMgr::INSTANCE() };
+        bool json { !strcmp(f_format, TRACE_FMT_JSON) };
+
+        if (f_output) {
+            std::ofstream out { f_output, std::ofstream::binary };
+            if (!out) {
+                ERR
+                    << "Can not open `"
+                    << f_output
+                    << "` for writing"
+                    << std::endl;
+
+                return utils::Variant(errMessage);
+            }
+
+            mgr.report_stats(out, json);
+        } else {
+            mgr.report_stats(out(), json);
+        }
+
+        if (f_clear) {
+            mgr.clear_stats();
+        }
+
+        return utils::Variant(okMessage);
+    }
+
+    StatsTopic::StatsTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    StatsTopic::~StatsTopic()
+    {
+        TRACE
+            << "Destroyed stats topic"
+            << std::endl;
+    }
+
+    void StatsTopic::usage()
+    {
+        display_manpage("stats");
+    }
+
+}; // namespace cmd
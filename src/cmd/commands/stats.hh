@@ -0,0 +1,67 @@
+/**
+ * @file stats.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler inteface for the `stats`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef STATS_CMD_H
+#define STATS_CMD_H
+
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class Stats: public Command {
+    public:
+        Stats(Interpreter& owner);
+        virtual ~Stats();
+
+        /* the format to use (must be one of "plain", "json") */
+        void set_format(pconst_char format);
+
+        /* the output filepath (optional) */
+        void set_output(pconst_char output);
+
+        /* forget stats for destroyed engines, after reporting */
+        void set_clear(bool value);
+
+        utils::Variant virtual operator()();
+
+    private:
+        pconst_char f_format;
+        pchar f_output;
+        bool f_clear;
+    };
+
+    using Stats_ptr = Stats*;
+
+    class StatsTopic: public CommandTopic {
+    public:
+        StatsTopic(Interpreter& owner);
+        virtual ~StatsTopic();
+
+        void virtual usage();
+    };
+
+};     // namespace cmd
+#endif /* STATS_CMD_H */
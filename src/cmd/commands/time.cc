@@ -22,8 +22,12 @@
  **/
 
 #include <iomanip>
+#include <sstream>
+
+#include <sys/resource.h>
 
 #include <utils/clock.hh>
+#include <utils/profile.hh>
 
 #include <cmd/interpreter.hh>
 
@@ -36,20 +40,119 @@ namespace cmd {
 
     Time::Time(Interpreter& owner)
         : Command(owner)
+        , f_command(NULL)
     {}
 
     Time::~Time()
-    {}
+    {
+        delete f_command;
+    }
+
+    void Time::set_command(Command_ptr command)
+    {
+        delete f_command;
+        f_command = command;
+    }
+
+    static double process_cpu_secs()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        return usage.ru_utime.tv_sec + 1e-6 * usage.ru_utime.tv_usec +
+               usage.ru_stime.tv_sec + 1e-6 * usage.ru_stime.tv_usec;
+    }
+
+    /* runs the command with the profiler enabled, then reports the
+       phases the subsystems recorded meanwhile */
+    utils::Variant Time::profile()
+    {
+        utils::Profiler& profiler { utils::Profiler::INSTANCE() };
+        f_command->set_output(out());
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        double cpu0 { process_cpu_secs() };
+
+        utils::Variant res;
+        profiler.enable();
+        try {
+            res = (*f_command)();
+        } catch (...) {
+            profiler.disable();
+            throw;
+        }
+        profiler.disable();
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double wall { (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec) };
+        double cpu { process_cpu_secs() - cpu0 };
+
+        /* formatted apart, flags of the output stream are left alone */
+        std::ostringstream os;
+        os
+            << outPrefix
+            << "Wall time: "
+            << std::fixed << std::setprecision(3) << wall
+            << "s, CPU time: "
+            << cpu
+            << "s, peak RSS: "
+            << utils::Profiler::peak_rss_kb() / 1024
+            << " MB"
+            << std::endl;
+
+        const utils::Phases phases { profiler.phases() };
+        if (phases.empty()) {
+            out() << os.str();
+            return res;
+        }
+
+        os
+            << "   "
+            << std::left << std::setw(32) << "phase"
+            << std::right
+            << std::setw(8) << "count"
+            << std::setw(12) << "wall"
+            << std::setw(12) << "cpu"
+            << std::setw(12) << "peak RSS"
+            << std::endl;
+
+        for (const auto& phase : phases) {
+            const utils::PhaseStats& stats { phase.second };
+
+            std::ostringstream wall_secs, cpu_secs, rss;
+            wall_secs << std::fixed << std::setprecision(3) << stats.wall_secs << "s";
+            cpu_secs << std::fixed << std::setprecision(3) << stats.cpu_secs << "s";
+            rss << stats.peak_rss_kb / 1024 << " MB";
+
+            os
+                << "   "
+                << std::left << std::setw(32) << phase.first
+                << std::right
+                << std::setw(8) << stats.count
+                << std::setw(12) << wall_secs.str()
+                << std::setw(12) << cpu_secs.str()
+                << std::setw(12) << rss.str()
+                << std::endl;
+        }
+
+        out() << os.str();
+        return res;
+    }
 
     utils::Variant Time::operator()()
     {
+        if (f_command) {
+            return profile();
+        }
+
         opts::OptsMgr& om { opts::OptsMgr::INSTANCE() };
 
         static struct timespec old;
         static bool first { true };
 
         /* FIXME: implement stream redirection for std{out,err} */
-        std::ostream& out { std::cout };
+        std::ostream& out { this->out() };
 
         struct timespec now;
         clock_gettime(CLOCK_MONOTONIC, &now);
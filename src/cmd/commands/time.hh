@@ -32,13 +32,23 @@
 namespace cmd {
 
     class Time: public Command {
+
+        /* the command to be profiled (optional, owned) */
+        Command_ptr f_command;
+
+        utils::Variant profile();
+
     public:
         Time(Interpreter& owner);
         virtual ~Time();
 
+        void set_command(Command_ptr command);
+
         utils::Variant virtual operator()();
     };
 
+    typedef Time* Time_ptr;
+
 
     class TimeTopic: public CommandTopic {
     public:
@@ -0,0 +1,392 @@
+/**
+ * @file validate_trace.cc
+ * @brief Command `validate-trace` class implementation.
+ *
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stack>
+
+#include <boost/thread.hpp>
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/validate_trace.hh>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <model/model_mgr.hh>
+#include <model/module.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <witness/program.hh>
+#include <witness/witness.hh>
+#include <witness/witness_mgr.hh>
+
+#include <utils/context.hh>
+
+/* frames are handed to the workers this many at a time, in order */
+static const unsigned validate_block_frames { 256 };
+
+namespace cmd {
+
+    /* an FSM constraint, in the scope of a module instance */
+    struct TraceConstraint {
+        const char* section;
+        expr::Expr_ptr ctx;
+        expr::Expr_ptr body;
+
+        /* value positions in the rows of the trace, by support entry,
+           empty unless the body can be compiled and all its vars are
+           in the language of the trace */
+        std::vector<unsigned> positions;
+        bool compiled;
+        bool assigned;
+    };
+
+    /* the constraints of all module instances, INIT, INVAR and TRANS
+       in this order, instance after instance */
+    static void collect_constraints(std::vector<TraceConstraint>& res)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        model::Model& model { model::ModelMgr::INSTANCE().model() };
+
+        std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
+        stack.push(std::make_pair(em.make_empty(), &model.main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, model::Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            model::Module& module { *top.second };
+
+            const std::pair<const char*, const expr::ExprVector*> sections[] = {
+                { "INIT", &module.init() },
+                { "INVAR", &module.invar() },
+                { "TRANS", &module.trans() },
+            };
+            for (const auto& section : sections) {
+                for (auto body : *section.second) {
+                    TraceConstraint constraint;
+                    constraint.section = section.first;
+                    constraint.ctx = ctx;
+                    constraint.body = body;
+                    constraint.compiled = false;
+                    constraint.assigned = false;
+
+                    res.push_back(constraint);
+                }
+            }
+
+            const symb::Variables& vars { module.vars() };
+            for (const auto& pair : vars) {
+                type::Type_ptr vtype { pair.second->type() };
+                if (vtype->is_instance()) {
+                    type::InstanceType_ptr instance { vtype->as_instance() };
+                    stack.push(std::make_pair(em.make_dot(ctx, pair.first),
+                                              &model.module(instance->name())));
+                }
+            }
+        }
+    }
+
+    /* true iff the constraint applies to the i-th of n frames */
+    static bool applies(const TraceConstraint& constraint, step_t first, unsigned i, unsigned n)
+    {
+        if (!strcmp("INIT", constraint.section)) {
+            return 0 == i && 0 == first;
+        }
+
+        if (!strcmp("TRANS", constraint.section)) {
+            return i + 1 < n;
+        }
+
+        return true;
+    }
+
+    ValidateTrace::ValidateTrace(Interpreter& owner)
+        : Command(owner)
+        , f_trace_id(NULL)
+        , f_jobs(0)
+    {}
+
+    ValidateTrace::~ValidateTrace()
+    {
+        free(f_trace_id);
+    }
+
+    void ValidateTrace::set_trace_id(pconst_char trace_id)
+    {
+        free(f_trace_id);
+        f_trace_id = strdup(trace_id);
+    }
+
+    void ValidateTrace::set_jobs(unsigned jobs)
+    {
+        f_jobs = jobs;
+    }
+
+    /* Constraints are evaluated on concrete values, no solver is
+     * involved: the rows of the trace are taken once, then blocks of
+     * frames are checked concurrently, with compiled programs (one
+     * set per worker, programs keep their own stacks). Blocks are
+     * picked in order, none is started past the first violation
+     * found, thus the one reported is the first one: the earliest,
+     * and the first constraint in it. Constraints which can not be
+     * compiled are evaluated afterwards, frame by frame, up to it. */
+    utils::Variant ValidateTrace::operator()()
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
+        std::ostream& os { out() };
+
+        witness::Witness& w { f_trace_id ? wm.witness(f_trace_id) : wm.current() };
+        step_t first { w.first_time() };
+
+        std::vector<TraceConstraint> constraints;
+        collect_constraints(constraints);
+
+        std::vector<expr::ExprVector> rows;
+        {
+            witness::WitnessRows wr { w };
+            while (wr.next()) {
+                rows.push_back(wr.row());
+            }
+        }
+        unsigned n_frames { (unsigned) rows.size() };
+
+        for (auto& constraint : constraints) {
+            witness::Program_ptr program {
+                witness::Program::compile(constraint.ctx, constraint.body)
+            };
+            if (!program) {
+                constraint.assigned = true;
+                continue;
+            }
+
+            constraint.compiled = true;
+            constraint.assigned = true;
+
+            const witness::Support& support { program->support() };
+            for (const auto& entry : support) {
+                int index { w.symbol_index(entry.first) };
+                if (-1 == index) {
+                    constraint.assigned = false;
+                    break;
+                }
+
+                constraint.positions.push_back(index);
+            }
+
+            delete program;
+        }
+
+        /* the first violation, as (frame, constraint) */
+        typedef std::pair<unsigned, unsigned> Violation;
+        const Violation none { n_frames, (unsigned) constraints.size() };
+        Violation violation { none };
+        boost::mutex violation_mutex;
+
+        std::atomic<unsigned> next_block { 0 };
+        std::atomic<unsigned> bound { n_frames };
+        std::atomic<unsigned> n_skipped { 0 };
+
+        utils::Context& context { utils::Context::current() };
+
+        auto worker = [&]() {
+            utils::ContextScope scope { context };
+
+            std::vector<witness::Program_ptr> programs;
+            for (const auto& constraint : constraints) {
+                programs.push_back(constraint.compiled && constraint.assigned
+                                       ? witness::Program::compile(constraint.ctx, constraint.body)
+                                       : NULL);
+            }
+
+            expr::ExprVector values;
+            while (true) {
+                unsigned lo { validate_block_frames * next_block++ };
+                if (n_frames <= lo || bound <= lo) {
+                    break;
+                }
+
+                unsigned hi { std::min(n_frames, lo + validate_block_frames) };
+                for (unsigned i = lo; i < hi && i < bound; ++i) {
+                    for (unsigned j = 0; j < constraints.size(); ++j) {
+                        witness::Program_ptr program { programs[j] };
+                        if (!program || !applies(constraints[j], first, i, n_frames)) {
+                            continue;
+                        }
+
+                        const witness::Support& support { program->support() };
+                        const std::vector<unsigned>& positions { constraints[j].positions };
+
+                        values.clear();
+                        for (unsigned k = 0; k < support.size(); ++k) {
+                            unsigned frame { i + (unsigned) support[k].second };
+                            expr::Expr_ptr value {
+                                frame < n_frames ? rows[frame][positions[k]] : NULL
+                            };
+                            if (!value) {
+                                break;
+                            }
+                            values.push_back(value);
+                        }
+
+                        expr::Expr_ptr value {
+                            values.size() == support.size() ? program->execute(values) : NULL
+                        };
+                        if (!value) {
+                            ++n_skipped;
+                        } else if (em.is_false(value)) {
+                            boost::mutex::scoped_lock lock { violation_mutex };
+                            violation = std::min(violation, Violation(i, j));
+                            bound = std::min((unsigned) bound, i + 1);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            for (auto program : programs) {
+                delete program;
+            }
+        };
+
+        unsigned n_threads { f_jobs ? f_jobs : opts::OptsMgr::INSTANCE().threads() };
+        if (0 == n_threads) {
+            n_threads = std::max(1U, boost::thread::hardware_concurrency());
+        }
+        n_threads = std::min(n_threads, 1 + n_frames / validate_block_frames);
+
+        if (1 < n_threads) {
+            boost::thread_group threads;
+            for (unsigned i = 0; i < n_threads; ++i) {
+                threads.create_thread(worker);
+            }
+            threads.join_all();
+        } else {
+            worker();
+        }
+
+        /* the walking evaluator, for what could not be compiled */
+        for (unsigned i = 0; i < n_frames && i <= violation.first; ++i) {
+            for (unsigned j = 0; j < constraints.size(); ++j) {
+                const TraceConstraint& constraint { constraints[j] };
+                if (constraint.compiled || !applies(constraint, first, i, n_frames) ||
+                    (i == violation.first && violation.second < j)) {
+                    continue;
+                }
+
+                expr::Expr_ptr value { wm.eval(w, constraint.ctx, constraint.body, first + i) };
+                if (!value) {
+                    ++n_skipped;
+                } else if (em.is_false(value)) {
+                    violation = std::min(violation, Violation(i, j));
+                    break;
+                }
+            }
+        }
+
+        /* constraints on vars the trace has no values for */
+        for (const auto& constraint : constraints) {
+            if (constraint.compiled && !constraint.assigned) {
+                for (unsigned i = 0; i < n_frames; ++i) {
+                    if (applies(constraint, first, i, n_frames)) {
+                        ++n_skipped;
+                    }
+                }
+            }
+        }
+
+        if (violation != none) {
+            const TraceConstraint& constraint { constraints[violation.second] };
+            os
+                << "-- "
+                << constraint.section
+                << " `"
+                << constraint.body
+                << "`";
+
+            if (!em.is_empty(constraint.ctx)) {
+                os
+                    << " (in `"
+                    << constraint.ctx
+                    << "`)";
+            }
+
+            os
+                << " violated at time "
+                << first + violation.first
+                << " in `"
+                << w.id()
+                << "`"
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        unsigned skipped { n_skipped };
+        if (0 < skipped) {
+            os
+                << "-- Trace `"
+                << w.id()
+                << "` is not fully assigned, "
+                << skipped
+                << " checks skipped, no violation found"
+                << std::endl;
+
+            return utils::Variant(errMessage);
+        }
+
+        os
+            << "-- Trace `"
+            << w.id()
+            << "` is valid, "
+            << n_frames
+            << " frames"
+            << std::endl;
+
+        return utils::Variant(okMessage);
+    }
+
+    ValidateTraceTopic::ValidateTraceTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    ValidateTraceTopic::~ValidateTraceTopic()
+    {
+        TRACE
+            << "Destroyed validate-trace topic"
+            << std::endl;
+    }
+
+    void ValidateTraceTopic::usage()
+    {
+        display_manpage("validate-trace");
+    }
+
+}; // namespace cmd
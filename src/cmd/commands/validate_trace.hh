@@ -0,0 +1,58 @@
+/*
+ * @file validate_trace.hh
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ **/
+#ifndef VALIDATE_TRACE_CMD_H
+#define VALIDATE_TRACE_CMD_H
+
+#include <cmd/command.hh>
+
+#include <expr/expr.hh>
+
+namespace cmd {
+
+    class ValidateTrace: public Command {
+
+        pchar f_trace_id;
+
+        /* worker threads, 0 for one per core */
+        unsigned f_jobs;
+
+    public:
+        ValidateTrace(Interpreter& owner);
+        virtual ~ValidateTrace();
+
+        void set_trace_id(pconst_char trace_id);
+        void set_jobs(unsigned jobs);
+
+        utils::Variant virtual operator()();
+    };
+    typedef ValidateTrace* ValidateTrace_ptr;
+
+    class ValidateTraceTopic: public CommandTopic {
+    public:
+        ValidateTraceTopic(Interpreter& owner);
+        virtual ~ValidateTraceTopic();
+
+        void virtual usage();
+    };
+
+}; // namespace cmd
+
+#endif // VALIDATE_TRACE_CMD_H
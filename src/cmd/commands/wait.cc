@@ -0,0 +1,111 @@
+/**
+ * @file wait.cc
+ * @brief Command `wait` class implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/commands/commands.hh>
+#include <cmd/commands/wait.hh>
+
+#include <cmd/jobs.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    Wait::Wait(Interpreter& owner)
+        : Command(owner)
+        , f_job_id(0)
+    {}
+
+    Wait::~Wait()
+    {}
+
+    void Wait::set_job_id(unsigned job_id)
+    {
+        f_job_id = job_id;
+    }
+
+    utils::Variant Wait::operator()()
+    {
+        JobMgr& jm { JobMgr::INSTANCE() };
+
+        std::vector<unsigned> ids;
+        if (f_job_id) {
+            if (!jm.job(f_job_id)) {
+                throw UnknownJobId(f_job_id);
+            }
+            ids.push_back(f_job_id);
+        } else {
+            for (const auto& pair : jm.jobs()) {
+                ids.push_back(pair.first);
+            }
+        }
+
+        /* the outputs of the jobs are shown once they are over, the
+           result is the one of the last job */
+        utils::Variant res { okMessage };
+        for (auto id : ids) {
+            Job_ptr job { jm.job(id) };
+            if (!job) {
+                continue; /* waited for meanwhile */
+            }
+
+            job->join();
+            job = jm.release(id);
+            if (!job) {
+                continue;
+            }
+
+            out()
+                << job->output();
+
+            if (!job->error().empty()) {
+                const std::string& error { job->error() };
+                ERR
+                    << "Exception!! "
+                    << error
+                    << std::endl;
+            }
+
+            res = job->result();
+            delete job;
+        }
+
+        return res;
+    }
+
+    WaitTopic::WaitTopic(Interpreter& owner)
+        : CommandTopic(owner)
+    {}
+
+    WaitTopic::~WaitTopic()
+    {
+        TRACE
+            << "Destroyed wait topic"
+            << std::endl;
+    }
+
+    void WaitTopic::usage()
+    {
+        display_manpage("wait");
+    }
+
+} // namespace cmd
@@ -0,0 +1,60 @@
+/**
+ * @file wait.hh
+ * @brief Command-interpreter subsystem related classes and definitions.
+ *
+ * This header file contains the handler interface for the `wait`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef WAIT_CMD_H
+#define WAIT_CMD_H
+
+#include <cmd/command.hh>
+
+namespace cmd {
+
+    class Wait: public Command {
+
+        /* the job id, 0 for all jobs */
+        unsigned f_job_id;
+
+    public:
+        Wait(Interpreter& owner);
+        virtual ~Wait();
+
+        void set_job_id(unsigned job_id);
+
+        utils::Variant virtual operator()();
+    };
+
+    typedef Wait* Wait_ptr;
+
+    class WaitTopic: public CommandTopic {
+    public:
+        WaitTopic(Interpreter& owner);
+        virtual ~WaitTopic();
+
+        void virtual usage();
+    };
+
+} // namespace cmd
+
+#endif /* WAIT_CMD_H */
@@ -29,6 +29,7 @@
 
 #include <common/exceptions.hh>
 
+#include <boost/lexical_cast.hpp>
 
 namespace cmd {
 
@@ -41,6 +42,14 @@ namespace cmd {
         {}
     };
 
+    class UnknownJobId: public CommandException {
+    public:
+        UnknownJobId(unsigned id)
+            : CommandException("UnknownJobId",
+                               "no job " + boost::lexical_cast<std::string>(id))
+        {}
+    };
+
 }; // namespace cmd
 
 #endif /* COMMAND_EXCEPTIONS_H */
@@ -35,6 +35,8 @@
 
 #include <parse.hh>
 
+#include <expr/collector.hh>
+
 #include <utils/logging.hh>
 
 namespace cmd {
@@ -66,14 +68,11 @@ namespace cmd {
         return line_buf;
     }
 
-    Interpreter_ptr Interpreter::f_instance = NULL;
     Interpreter& Interpreter::INSTANCE()
     {
-        if (!f_instance) {
-            f_instance = new Interpreter();
-        }
-
-        return *f_instance;
+        /* made on first use, concurrent first uses wait for it */
+        static Interpreter_ptr instance { new Interpreter() };
+        return *instance;
     }
 
     Interpreter::Interpreter()
@@ -130,6 +129,10 @@ namespace cmd {
         }
 
         delete cmd; /* claims ownership! */
+
+        /* log lines of the command come before its result */
+        utils::Logger::INSTANCE().flush();
+
         return f_last_result;
     }
 
@@ -163,6 +166,8 @@ namespace cmd {
         if (cmdline != NULL) {
             chomp(cmdline);
             if (cmdline && 0 < strlen(cmdline)) {
+                expr::ExprGuard guard;
+
                 try {
                     CommandVector_ptr cmds { parse::parseCommand(cmdline) };
                     if (cmds) {
@@ -189,6 +194,9 @@ namespace cmd {
             f_leaving = true;
         }
 
+        /* no command of the line holds exprs anymore, except for jobs */
+        expr::ExprCollector::INSTANCE().safe_point();
+
         return f_last_result;
     }
 
@@ -113,7 +113,6 @@ namespace cmd {
 
         utils::Variant f_last_result;
 
-        static Interpreter_ptr f_instance;
         struct timespec f_epoch;
     };
 
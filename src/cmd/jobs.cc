@@ -0,0 +1,204 @@
+/**
+ * @file jobs.cc
+ * @brief Command interpreter subsystem, background jobs implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cmd/jobs.hh>
+#include <cmd/commands/commands.hh>
+
+#include <expr/collector.hh>
+
+#include <utils/logging.hh>
+
+namespace cmd {
+
+    Job::Job(unsigned id, Command_ptr command, const std::string& descr,
+             JobCallback done)
+        : f_id(id)
+        , f_command(command)
+        , f_descr(descr)
+        , f_done(done)
+        , f_context(utils::Context::current())
+        , f_status(JOB_RUNNING)
+        , f_killed(false)
+    {
+        f_command->set_output(f_output);
+
+        /* the exprs of the command are held until the job is over */
+        expr::ExprCollector::INSTANCE().pin();
+        f_thread = boost::thread(&Job::run, this);
+    }
+
+    Job::~Job()
+    {
+        join();
+        delete f_command;
+    }
+
+    void Job::run()
+    {
+        utils::ContextScope scope { f_context };
+
+        utils::Variant res;
+        std::string error;
+
+        std::ostringstream tag;
+        tag << "job " << f_id;
+        utils::Logger::INSTANCE().set_tag(tag.str());
+
+        try {
+            res = (*f_command)();
+        }
+
+        catch (Exception& e) {
+            error = e.what();
+            res = utils::Variant(errMessage);
+        }
+
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            f_result = res;
+            f_error = error;
+
+            if (f_killed) {
+                f_status = JOB_KILLED;
+            } else if (res.is_string() && res.as_string() == errMessage) {
+                f_status = JOB_FAILED;
+            } else {
+                f_status = JOB_DONE;
+            }
+        }
+
+        if (f_done) {
+            f_done(*this);
+        }
+
+        expr::ExprCollector::INSTANCE().unpin();
+    }
+
+    job_status_t Job::status()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_status;
+    }
+
+    void Job::join()
+    {
+        if (f_thread.joinable()) {
+            f_thread.join();
+        }
+    }
+
+    void Job::kill()
+    {
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            if (JOB_RUNNING != f_status) {
+                return;
+            }
+            f_killed = true;
+        }
+
+        f_command->cancel();
+    }
+
+    JobMgr::JobMgr()
+        : f_next_id(0)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized JobMgr @"
+            << instance
+            << std::endl;
+    }
+
+    JobMgr::~JobMgr()
+    {
+        shutdown();
+
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed JobMgr @"
+            << instance
+            << std::endl;
+    }
+
+    unsigned JobMgr::submit(Command_ptr command, const std::string& descr)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        unsigned id { ++f_next_id };
+        f_jobs.insert(std::make_pair(id, new Job(id, command, descr)));
+
+        DEBUG
+            << "Started job "
+            << id
+            << std::endl;
+
+        return id;
+    }
+
+    Job_ptr JobMgr::job(unsigned id)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        JobMap::const_iterator eye { f_jobs.find(id) };
+        return f_jobs.end() != eye ? eye->second : NULL;
+    }
+
+    JobMap JobMgr::jobs()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_jobs;
+    }
+
+    Job_ptr JobMgr::release(unsigned id)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        JobMap::iterator eye { f_jobs.find(id) };
+        if (f_jobs.end() == eye) {
+            return NULL;
+        }
+
+        Job_ptr res { eye->second };
+        f_jobs.erase(eye);
+
+        return res;
+    }
+
+    void JobMgr::shutdown()
+    {
+        JobMap jobs;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            jobs.swap(f_jobs);
+        }
+
+        for (auto& pair : jobs) {
+            pair.second->kill();
+        }
+        for (auto& pair : jobs) {
+            delete pair.second;
+        }
+    }
+
+}; // namespace cmd
@@ -0,0 +1,169 @@
+/**
+ * @file jobs.hh
+ * @brief Command interpreter subsystem, background jobs.
+ *
+ * This header file contains the declarations required to run
+ * commands in the background of the interactive shell. Each job runs
+ * one command in a thread of its own: its engines are scoped to the
+ * algorithms of that command, witnesses are recorded by the command
+ * itself when done. The output of a job is buffered, and shown on
+ * `wait`.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <cmd/command.hh>
+
+#include <utils/context.hh>
+
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <sstream>
+
+namespace cmd {
+
+    typedef enum {
+        JOB_RUNNING,
+        JOB_DONE,
+        JOB_FAILED,
+        JOB_KILLED,
+    } job_status_t;
+
+    class Job;
+
+    /* invoked by the job's thread, once the job is over */
+    typedef boost::function<void(Job&)> JobCallback;
+
+    class Job {
+    public:
+        /* claims ownership of command */
+        Job(unsigned id, Command_ptr command, const std::string& descr,
+            JobCallback done = JobCallback());
+        ~Job();
+
+        inline unsigned id() const
+        {
+            return f_id;
+        }
+
+        inline const std::string& descr() const
+        {
+            return f_descr;
+        }
+
+        job_status_t status();
+
+        /* joins the worker thread, the job is over afterwards */
+        void join();
+
+        /* interrupts the engines of the command */
+        void kill();
+
+        /* available after join() */
+        inline const utils::Variant& result() const
+        {
+            return f_result;
+        }
+
+        inline const std::string& error() const
+        {
+            return f_error;
+        }
+
+        inline std::string output() const
+        {
+            return f_output.str();
+        }
+
+        inline expr::AtomVector witnesses() const
+        {
+            return f_command->witnesses();
+        }
+
+    private:
+        void run();
+
+        unsigned f_id;
+        Command_ptr f_command;
+        std::string f_descr;
+        JobCallback f_done;
+
+        /* the context of the submitter, the command runs in it */
+        utils::Context& f_context;
+
+        std::ostringstream f_output;
+        utils::Variant f_result;
+        std::string f_error;
+
+        boost::mutex f_mutex;
+        job_status_t f_status;
+        bool f_killed;
+
+        boost::thread f_thread;
+    };
+
+    typedef Job* Job_ptr;
+    typedef std::map<unsigned, Job_ptr> JobMap;
+
+    typedef class JobMgr* JobMgr_ptr;
+
+    class JobMgr {
+    public:
+        static JobMgr& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static JobMgr_ptr instance { new JobMgr() };
+            return *instance;
+        }
+
+        /* starts a job for command (claims ownership), returns its id */
+        unsigned submit(Command_ptr command, const std::string& descr);
+
+        /* NULL iff no such job */
+        Job_ptr job(unsigned id);
+
+        /* jobs not yet waited for, by id */
+        JobMap jobs();
+
+        /* forgets a job, which must be over. The caller claims
+           ownership */
+        Job_ptr release(unsigned id);
+
+        /* kills and joins all jobs, e.g. on leaving */
+        void shutdown();
+
+    protected:
+        JobMgr();
+        ~JobMgr();
+
+    private:
+        boost::mutex f_mutex;
+        JobMap f_jobs;
+        unsigned f_next_id;
+    };
+
+}; // namespace cmd
+
+#endif /* JOBS_H */
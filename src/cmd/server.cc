@@ -0,0 +1,756 @@
+/**
+ * @file server.cc
+ * @brief Command interpreter subsystem, JSON-RPC server implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cmd/cmd.hh>
+#include <cmd/commands/commands.hh>
+#include <cmd/server.hh>
+
+#include <parse.hh>
+
+#include <expr/collector.hh>
+
+#include <sat/remote.hh>
+
+#include <utils/context.hh>
+#include <utils/logging.hh>
+
+#include <boost/bind.hpp>
+
+#include <jsoncpp/json/json.h>
+
+namespace cmd {
+
+    /* JSON-RPC 2.0 error codes */
+    const int RPC_PARSE_ERROR { -32700 };
+    const int RPC_INVALID_REQUEST { -32600 };
+    const int RPC_INVALID_PARAMS { -32602 };
+    const int RPC_COMMAND_FAILED { -32000 };
+
+    /* the command parser is not reentrant */
+    static boost::mutex parse_mutex;
+
+    static std::string to_line(const Json::Value& value)
+    {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+
+        return Json::writeString(builder, value) + "\n";
+    }
+
+    static bool is_port(const std::string& endpoint)
+    {
+        return !endpoint.empty() &&
+               endpoint.end() == std::find_if(endpoint.begin(), endpoint.end(),
+                                              [](char c) { return !isdigit(c); });
+    }
+
+    /* `host:port`, or a port on localhost */
+    static bool is_inet(const std::string& endpoint, std::string& host, std::string& port)
+    {
+        std::string::size_type colon { endpoint.rfind(':') };
+
+        host = (std::string::npos == colon) ? "127.0.0.1" : endpoint.substr(0, colon);
+        port = (std::string::npos == colon) ? endpoint : endpoint.substr(1 + colon);
+
+        return is_port(port);
+    }
+
+    static bool to_ints(const Json::Value& array, std::vector<int>& out)
+    {
+        if (!array.isArray()) {
+            return false;
+        }
+
+        for (const auto& lit : array) {
+            if (!lit.isInt()) {
+                return false;
+            }
+            out.push_back(lit.asInt());
+        }
+
+        return true;
+    }
+
+    /* One client: requests are read one line at a time, and run as
+     * jobs. Responses are written as jobs are over, in any order:
+     * clients match them by id. */
+    class Connection {
+    public:
+        Connection(Server& server, int fd);
+
+        /* pending jobs are killed */
+        ~Connection();
+
+        void run();
+
+    private:
+        void handle(const std::string& line);
+
+        /* the command runs in the named context (see
+           utils/context.hh) */
+        void submit(const Json::Value& id, const std::string& context,
+                    const std::string& method, const Json::Value& params);
+        void cancel(const Json::Value& id, const Json::Value& params);
+        void list(const Json::Value& id);
+
+        /* CNF queries (see sat/remote.hh) are solved one at a time,
+           on a thread of their own */
+        void solve_cnf(const Json::Value& id, const Json::Value& params);
+        void run_cnf(Json::Value id, std::vector<int> clauses,
+                     std::vector<int> assumptions);
+
+        /* invoked by the job's thread */
+        void done(Json::Value id, Job& job);
+
+        void respond(const Json::Value& id, const Json::Value& result);
+        void fail(const Json::Value& id, int code, const std::string& message,
+                  const Json::Value& data = Json::Value());
+        void write(const Json::Value& response);
+
+        /* destroys the jobs which are over */
+        void reap();
+
+        Server& f_server;
+        int f_fd;
+
+        /* jobs by (serialized) request id, and those over */
+        boost::mutex f_mutex;
+        std::map<std::string, Job_ptr> f_jobs;
+        std::vector<Job_ptr> f_over;
+        unsigned f_next_id;
+
+        /* the CNF instance of this client, and the pending query (if
+           any) */
+        sat::CnfSession f_cnf;
+        Json::Value f_cnf_id;
+        boost::thread* f_cnf_thread;
+
+        boost::mutex f_write_mutex;
+    };
+
+    Connection::Connection(Server& server, int fd)
+        : f_server(server)
+        , f_fd(fd)
+        , f_next_id(0)
+        , f_cnf_thread(NULL)
+    {}
+
+    Connection::~Connection()
+    {
+        std::vector<Job_ptr> pending;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            for (const auto& pair : f_jobs) {
+                pending.push_back(pair.second);
+            }
+        }
+
+        /* jobs move themselves to f_over when done */
+        for (auto job : pending) {
+            job->kill();
+        }
+        for (auto job : pending) {
+            job->join();
+        }
+
+        if (f_cnf_thread) {
+            f_cnf.interrupt();
+            f_cnf_thread->join();
+            delete f_cnf_thread;
+        }
+
+        reap();
+    }
+
+    void Connection::run()
+    {
+        std::string buffer;
+        char chunk[0x1000];
+
+        while (true) {
+            ssize_t n { recv(f_fd, chunk, sizeof(chunk), 0) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+
+            buffer.append(chunk, n);
+
+            std::string::size_type eol;
+            while (std::string::npos != (eol = buffer.find('\n'))) {
+                std::string line { buffer.substr(0, eol) };
+                buffer.erase(0, 1 + eol);
+
+                if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                    handle(line);
+                }
+            }
+
+            reap();
+        }
+    }
+
+    void Connection::handle(const std::string& line)
+    {
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader { builder.newCharReader() };
+
+        Json::Value request;
+        std::string errors;
+        if (!reader->parse(line.data(), line.data() + line.size(), &request, &errors)) {
+            fail(Json::Value(), RPC_PARSE_ERROR, errors);
+            return;
+        }
+
+        if (!request.isObject() || !request["method"].isString()) {
+            fail(request.isObject() ? request["id"] : Json::Value(),
+                 RPC_INVALID_REQUEST, "Invalid request");
+            return;
+        }
+
+        const Json::Value& id { request["id"] };
+        const std::string method { request["method"].asString() };
+        const Json::Value& params { request["params"] };
+
+        /* requests naming no context share the default one */
+        std::string context { utils::Context::default_context().name() };
+        if (request.isMember("context")) {
+            if (!request["context"].isString()) {
+                fail(id, RPC_INVALID_REQUEST, "context must be a string");
+                return;
+            }
+            context = request["context"].asString();
+        }
+
+        if (method == "cancel") {
+            cancel(id, params);
+        } else if (method == "jobs") {
+            list(id);
+        } else if (method == "solve-cnf") {
+            solve_cnf(id, params);
+        } else if (method == "shutdown") {
+            respond(id, Json::Value(okMessage));
+            f_server.shutdown();
+        } else {
+            submit(id, context, method, params);
+        }
+    }
+
+    void Connection::submit(const Json::Value& id, const std::string& context,
+                            const std::string& method, const Json::Value& params)
+    {
+        /* the command line is the method, followed by the params */
+        std::ostringstream oss;
+        oss << method;
+
+        if (params.isString()) {
+            oss << " " << params.asString();
+        } else if (params.isArray()) {
+            for (const auto& param : params) {
+                if (!param.isString()) {
+                    fail(id, RPC_INVALID_PARAMS, "params must be strings");
+                    return;
+                }
+                oss << " " << param.asString();
+            }
+        } else if (!params.isNull()) {
+            fail(id, RPC_INVALID_PARAMS, "params must be a string, or an array of strings");
+            return;
+        }
+
+        const std::string cmdline { oss.str() };
+
+        /* commands are made, and run, in the context */
+        utils::ContextScope scope { utils::Context::named(context) };
+
+        /* parsed exprs are held by the job from now on, it pins the
+           collector as well */
+        expr::ExprGuard guard;
+
+        CommandVector_ptr cmds { NULL };
+        try {
+            boost::mutex::scoped_lock lock { parse_mutex };
+            cmds = parse::parseCommand(cmdline.c_str());
+        }
+
+        catch (Exception& e) {
+            fail(id, RPC_INVALID_PARAMS, e.what());
+            return;
+        }
+
+        if (!cmds || cmds->empty()) {
+            delete cmds;
+            fail(id, RPC_INVALID_PARAMS, "Could not parse `" + cmdline + "`");
+            return;
+        }
+
+        Command_ptr command { cmds->front() };
+        if (1 < cmds->size()) {
+            Do_ptr seq { (Do_ptr) CommandMgr::INSTANCE().make_do() };
+            for (auto c : *cmds) {
+                seq->add_command(c);
+            }
+            command = seq;
+        }
+        delete cmds;
+
+        /* the job can not be over before it is registered */
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        const std::string key { to_line(id) };
+        if (f_jobs.end() != f_jobs.find(key)) {
+            delete command;
+            fail(id, RPC_INVALID_REQUEST, "Duplicate request id");
+            return;
+        }
+
+        f_jobs[key] = new Job(++f_next_id, command, cmdline,
+                              boost::bind(&Connection::done, this, id, _1));
+    }
+
+    void Connection::cancel(const Json::Value& id, const Json::Value& params)
+    {
+        if (!params.isObject() || !params.isMember("id")) {
+            fail(id, RPC_INVALID_PARAMS, "the id of the request is required");
+            return;
+        }
+
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+
+            std::map<std::string, Job_ptr>::const_iterator eye {
+                f_jobs.find(to_line(params["id"]))
+            };
+            if (f_jobs.end() != eye) {
+                eye->second->kill();
+            }
+
+            if (!f_cnf_id.isNull() && to_line(f_cnf_id) == to_line(params["id"])) {
+                f_cnf.interrupt();
+            }
+        }
+
+        /* the request is answered anyway, when over */
+        respond(id, Json::Value(okMessage));
+    }
+
+    void Connection::list(const Json::Value& id)
+    {
+        static const char* labels[] = {
+            "Running", "Done", "Failed", "Killed",
+        };
+
+        Json::Value result { Json::arrayValue };
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+
+            for (const auto& pair : f_jobs) {
+                Job& job { *pair.second };
+
+                Json::Value entry;
+                entry["command"] = job.descr();
+                entry["status"] = labels[job.status()];
+                result.append(entry);
+            }
+        }
+
+        respond(id, result);
+    }
+
+    void Connection::solve_cnf(const Json::Value& id, const Json::Value& params)
+    {
+        std::vector<int> clauses;
+        std::vector<int> assumptions;
+
+        if (!params.isObject() ||
+            !to_ints(params["clauses"], clauses) ||
+            !to_ints(params["assumptions"], assumptions)) {
+            fail(id, RPC_INVALID_PARAMS, "clauses and assumptions must be arrays of ints");
+            return;
+        }
+
+        if (!f_cnf.select_backend(params["backend"].asString())) {
+            fail(id, RPC_INVALID_PARAMS, "Unknown SAT backend");
+            return;
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        if (!f_cnf_id.isNull()) {
+            fail(id, RPC_INVALID_REQUEST, "A CNF query is pending");
+            return;
+        }
+
+        /* the previous query is over */
+        if (f_cnf_thread) {
+            f_cnf_thread->join();
+            delete f_cnf_thread;
+        }
+
+        f_cnf_id = id;
+        f_cnf_thread = new boost::thread(&Connection::run_cnf, this, id,
+                                         clauses, assumptions);
+    }
+
+    void Connection::run_cnf(Json::Value id, std::vector<int> clauses,
+                             std::vector<int> assumptions)
+    {
+        f_cnf.add_clauses(clauses);
+
+        std::vector<int> model;
+        sat::status_t status { f_cnf.solve(assumptions, model) };
+
+        Json::Value result;
+        if (sat::STATUS_SAT == status) {
+            result["status"] = "SAT";
+            result["model"] = Json::Value(Json::arrayValue);
+            for (int lit : model) {
+                result["model"].append(lit);
+            }
+        } else {
+            result["status"] = (sat::STATUS_UNSAT == status) ? "UNSAT" : "UNKNOWN";
+        }
+
+        /* a late cancel does not affect the next query */
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            f_cnf_id = Json::Value();
+            f_cnf.clear_interrupt();
+        }
+
+        respond(id, result);
+    }
+
+    void Connection::done(Json::Value id, Job& job)
+    {
+        std::ostringstream status;
+        status << job.result();
+
+        Json::Value result;
+        result["status"] = status.str();
+        result["output"] = job.output();
+
+        /* witnesses are returned in the JSON trace format */
+        expr::AtomVector witnesses { job.witnesses() };
+        if (!witnesses.empty()) {
+            std::ostringstream traces;
+
+            DumpTraces dump { Interpreter::INSTANCE() };
+            dump.set_format(TRACE_FMT_JSON);
+            for (const auto& witness_id : witnesses) {
+                dump.add_trace_id(witness_id.c_str());
+            }
+            dump.Command::set_output(traces);
+
+            try {
+                dump();
+
+                Json::Value obj;
+                std::istringstream is { traces.str() };
+                is >> obj;
+
+                result["traces"] = obj["traces"];
+            }
+
+            catch (std::exception& e) {
+                std::string what { e.what() };
+                WARN
+                    << "Could not dump witnesses: "
+                    << what
+                    << std::endl;
+            }
+        }
+
+        if (job.error().empty()) {
+            respond(id, result);
+        } else {
+            fail(id, RPC_COMMAND_FAILED, job.error(), result);
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_jobs.erase(to_line(id));
+        f_over.push_back(&job);
+    }
+
+    void Connection::respond(const Json::Value& id, const Json::Value& result)
+    {
+        Json::Value response;
+        response["jsonrpc"] = "2.0";
+        response["id"] = id;
+        response["result"] = result;
+
+        write(response);
+    }
+
+    void Connection::fail(const Json::Value& id, int code, const std::string& message,
+                          const Json::Value& data)
+    {
+        Json::Value response;
+        response["jsonrpc"] = "2.0";
+        response["id"] = id;
+        response["error"]["code"] = code;
+        response["error"]["message"] = message;
+        if (!data.isNull()) {
+            response["error"]["data"] = data;
+        }
+
+        write(response);
+    }
+
+    void Connection::write(const Json::Value& response)
+    {
+        const std::string line { to_line(response) };
+
+        boost::mutex::scoped_lock lock { f_write_mutex };
+
+        const char* p { line.data() };
+        size_t left { line.size() };
+        while (0 < left) {
+            ssize_t n { send(f_fd, p, left, MSG_NOSIGNAL) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                break; /* client is gone */
+            }
+
+            p += n;
+            left -= n;
+        }
+    }
+
+    void Connection::reap()
+    {
+        std::vector<Job_ptr> over;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            over.swap(f_over);
+        }
+
+        for (auto job : over) {
+            delete job;
+        }
+
+        expr::ExprCollector::INSTANCE().safe_point();
+    }
+
+    Server::Server(const std::string& endpoint)
+        : f_endpoint(endpoint)
+        , f_fd(-1)
+        , f_leaving(false)
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized Server @"
+            << instance
+            << std::endl;
+    }
+
+    Server::~Server()
+    {
+        if (0 <= f_fd) {
+            close(f_fd);
+        }
+
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Server @"
+            << instance
+            << std::endl;
+    }
+
+    bool Server::listen()
+    {
+        std::string host;
+        std::string port;
+        if (is_inet(f_endpoint, host, port)) {
+            struct sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(atoi(port.c_str()));
+
+            if (1 != inet_pton(AF_INET, host.c_str(), &addr.sin_addr)) {
+                errno = EINVAL;
+                return false;
+            }
+
+            f_fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (f_fd < 0) {
+                return false;
+            }
+
+            int on { 1 };
+            setsockopt(f_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+            if (bind(f_fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                return false;
+            }
+        } else {
+            struct sockaddr_un addr;
+            if (sizeof(addr.sun_path) <= f_endpoint.size()) {
+                return false;
+            }
+
+            f_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (f_fd < 0) {
+                return false;
+            }
+
+            /* a stale socket is replaced */
+            unlink(f_endpoint.c_str());
+
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, f_endpoint.c_str(), sizeof(addr.sun_path) - 1);
+
+            if (bind(f_fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                return false;
+            }
+        }
+
+        return 0 == ::listen(f_fd, SOMAXCONN);
+    }
+
+    bool Server::run()
+    {
+        if (!listen()) {
+            std::string what { strerror(errno) };
+            ERR
+                << "Could not listen on `"
+                << f_endpoint
+                << "`: "
+                << what
+                << std::endl;
+
+            return false;
+        }
+
+        INFO
+            << "Listening on `"
+            << f_endpoint
+            << "`"
+            << std::endl;
+
+        while (true) {
+            int fd { accept(f_fd, NULL, NULL) };
+            if (fd < 0 && EINTR == errno) {
+                continue;
+            }
+
+            join_finished();
+
+            boost::mutex::scoped_lock lock { f_mutex };
+            if (f_leaving || fd < 0) {
+                if (0 <= fd) {
+                    close(fd);
+                }
+                break;
+            }
+
+            f_clients[fd] = new boost::thread(&Server::serve, this, fd);
+        }
+
+        /* clients have been shut down, their jobs are killed */
+        while (true) {
+            boost::thread* thread { NULL };
+            {
+                boost::mutex::scoped_lock lock { f_mutex };
+                if (!f_clients.empty()) {
+                    thread = f_clients.begin()->second;
+                }
+            }
+
+            if (!thread) {
+                break;
+            }
+
+            thread->join();
+            join_finished();
+        }
+        join_finished();
+
+        std::string host;
+        std::string port;
+        if (!is_inet(f_endpoint, host, port)) {
+            unlink(f_endpoint.c_str());
+        }
+
+        return true;
+    }
+
+    void Server::shutdown()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_leaving = true;
+
+        /* wakes up accept(), and the clients' recv() */
+        ::shutdown(f_fd, SHUT_RDWR);
+        for (const auto& pair : f_clients) {
+            ::shutdown(pair.first, SHUT_RDWR);
+        }
+    }
+
+    void Server::join_finished()
+    {
+        std::vector<boost::thread*> finished;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            finished.swap(f_finished);
+        }
+
+        for (auto thread : finished) {
+            if (thread->joinable()) {
+                thread->join();
+            }
+            delete thread;
+        }
+    }
+
+    void Server::serve(int fd)
+    {
+        {
+            Connection connection { *this, fd };
+            connection.run();
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        close(fd);
+
+        std::map<int, boost::thread*>::iterator eye { f_clients.find(fd) };
+        f_finished.push_back(eye->second);
+        f_clients.erase(eye);
+    }
+
+}; // namespace cmd
@@ -0,0 +1,89 @@
+/**
+ * @file server.hh
+ * @brief Command interpreter subsystem, JSON-RPC server.
+ *
+ * This header file contains the declarations required to serve
+ * commands over a socket, as in `--server`. Requests are JSON-RPC 2.0
+ * objects, one per line: the method is the command name (e.g.
+ * `reach`), params are its arguments, either a string or an array of
+ * strings. Each request is run as a job (see jobs.hh), concurrently
+ * with the others, on the model loaded (and compiled) once. Responses
+ * hold the command result, its output and the witnesses it
+ * registered, in the JSON trace format.
+ *
+ * The server is also a worker for remote solving (see sat/remote.hh):
+ * `solve-cnf` requests are solved on the CNF instance of the client.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <cmd/jobs.hh>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cmd {
+
+    class Server {
+    public:
+        /* endpoint is a TCP port (bound to localhost), `address:port`
+           (an IPv4 address, e.g. 0.0.0.0 for all interfaces), or the
+           path of a Unix socket otherwise */
+        Server(const std::string& endpoint);
+        ~Server();
+
+        /* serves clients until a `shutdown` request, false iff the
+           endpoint could not be bound */
+        bool run();
+
+        /* stops accepting clients, and closes the current ones */
+        void shutdown();
+
+    private:
+        /* non-copyable */
+        Server(const Server&);
+        Server& operator=(const Server&);
+
+        bool listen();
+        void serve(int fd);
+
+        std::string f_endpoint;
+        int f_fd;
+
+        boost::mutex f_mutex;
+        bool f_leaving;
+
+        /* threads serving clients, by socket. Those done are joined
+           on the next accept */
+        std::map<int, boost::thread*> f_clients;
+        std::vector<boost::thread*> f_finished;
+
+        void join_finished();
+    };
+
+}; // namespace cmd
+
+#endif /* SERVER_H */
@@ -26,5 +26,6 @@ const char* YASMV_HOME_PATH { "YASMV_HOME" };
 
 const char* TRACE_FMT_PLAIN { "plain" };
 const char* TRACE_FMT_JSON  { "json" };
+const char* TRACE_FMT_BINARY { "binary" };
 
 const char* TRACE_FMT_DEFAULT { TRACE_FMT_PLAIN };
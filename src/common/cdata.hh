@@ -35,5 +35,6 @@ extern const char *YASMV_HOME_PATH;
 extern const char *TRACE_FMT_DEFAULT;
 extern const char *TRACE_FMT_PLAIN;
 extern const char *TRACE_FMT_JSON;
+extern const char *TRACE_FMT_BINARY;
 
 #endif /* COMMON_CDATA_H  */
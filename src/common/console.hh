@@ -56,9 +56,9 @@ class ConsoleMgr {
 
 public:
     static ConsoleMgr& INSTANCE() {
-        if (! f_instance)
-            f_instance = new ConsoleMgr();
-        return (*f_instance);
+        /* made on first use, concurrent first uses wait for it */
+        static ConsoleMgr_ptr instance { new ConsoleMgr() };
+        return *instance;
     }
 
     axter::ezlogger<>& err();
@@ -72,8 +72,6 @@ protected:
     ConsoleMgr();
 
 private:
-    static ConsoleMgr_ptr f_instance;
-
     axter::ezlogger<> f_err;
     axter::ezlogger<> f_warn;
     axter::ezlogger<> f_trace;
@@ -0,0 +1,206 @@
+/**
+ * @file aig.cc
+ * @brief Basic expressions compiler - And-Inverter Graphs
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cassert>
+
+#include <compiler/aig.hh>
+
+#include <boost/unordered_set.hpp>
+
+#include <utils/logging.hh>
+
+namespace compiler {
+
+    AigMgr::AigMgr()
+    {
+        /* the constant false */
+        AigNode zero { -1, AIG_FALSE, AIG_FALSE };
+        f_nodes.push_back(zero);
+
+        const void* instance { this };
+        DRIVEL
+            << "Initialized AigMgr @"
+            << instance
+            << std::endl;
+    }
+
+    AigMgr::~AigMgr()
+    {
+        TRACE
+            << "Destroyed AigMgr"
+            << std::endl;
+    }
+
+    aig_lit_t AigMgr::make_input(int index)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        InputMap::const_iterator eye { f_input_map.find(index) };
+        if (f_input_map.end() != eye) {
+            return eye->second;
+        }
+
+        aig_lit_t res { (aig_lit_t) f_nodes.size() << 1 };
+        AigNode input { index, AIG_FALSE, AIG_FALSE };
+        f_nodes.push_back(input);
+        f_input_map.insert(std::make_pair(index, res));
+
+        return res;
+    }
+
+    aig_lit_t AigMgr::make_and(aig_lit_t lhs, aig_lit_t rhs)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (lhs > rhs) {
+            std::swap(lhs, rhs);
+        }
+
+        /* constants, lhs comes first */
+        if (AIG_FALSE == lhs) {
+            return AIG_FALSE;
+        }
+        if (AIG_TRUE == lhs) {
+            return rhs;
+        }
+
+        /* a & a, a & !a */
+        if (lhs == rhs) {
+            return lhs;
+        }
+        if (lhs == aig_not(rhs)) {
+            return AIG_FALSE;
+        }
+
+        /* one level of nesting, (a & b) & a and (a & b) & !a */
+        for (unsigned pass = 0; pass < 2; ++pass) {
+            aig_lit_t x { pass ? rhs : lhs };
+            aig_lit_t y { pass ? lhs : rhs };
+
+            if (aig_complemented(x)) {
+                continue;
+            }
+
+            const AigNode& n { f_nodes[aig_node(x)] };
+            if (!n.is_and()) {
+                continue;
+            }
+
+            if (n.lhs == y || n.rhs == y) {
+                return x;
+            }
+            if (n.lhs == aig_not(y) || n.rhs == aig_not(y)) {
+                return AIG_FALSE;
+            }
+        }
+
+        return make_node(lhs, rhs);
+    }
+
+    aig_lit_t AigMgr::make_node(aig_lit_t lhs, aig_lit_t rhs)
+    {
+        const std::pair<aig_lit_t, aig_lit_t> key { lhs, rhs };
+
+        AndMap::const_iterator eye { f_and_map.find(key) };
+        if (f_and_map.end() != eye) {
+            return eye->second;
+        }
+
+        aig_lit_t res { (aig_lit_t) f_nodes.size() << 1 };
+        AigNode node { -1, lhs, rhs };
+        f_nodes.push_back(node);
+        f_and_map.insert(std::make_pair(key, res));
+
+        return res;
+    }
+
+    AigNode AigMgr::node(unsigned id)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        assert(id < f_nodes.size());
+        return f_nodes[id];
+    }
+
+    bool AigMgr::find_index(unsigned id, int& res)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Node2DDMap::const_iterator eye { f_node2dd_map.find(id) };
+        if (f_node2dd_map.end() == eye) {
+            return false;
+        }
+
+        res = eye->second;
+        return true;
+    }
+
+    bool AigMgr::find_node(int index, unsigned& res)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        DD2NodeMap::const_iterator eye { f_dd2node_map.find(index) };
+        if (f_dd2node_map.end() == eye) {
+            return false;
+        }
+
+        res = eye->second;
+        return true;
+    }
+
+    void AigMgr::bind(unsigned id, int index)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_node2dd_map.insert(std::make_pair(id, index));
+        f_dd2node_map.insert(std::make_pair(index, id));
+    }
+
+    void AigMgr::support(aig_lit_t lit, std::vector<int>& res)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        boost::unordered_set<unsigned> visited;
+        std::vector<unsigned> stack;
+        stack.push_back(aig_node(lit));
+
+        while (!stack.empty()) {
+            unsigned id { stack.back() };
+            stack.pop_back();
+
+            if (!visited.insert(id).second) {
+                continue;
+            }
+
+            const AigNode& n { f_nodes[id] };
+            if (n.is_input()) {
+                res.push_back(n.index);
+            } else if (n.is_and()) {
+                stack.push_back(aig_node(n.lhs));
+                stack.push_back(aig_node(n.rhs));
+            }
+        }
+    }
+
+} // namespace compiler
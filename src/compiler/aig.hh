@@ -0,0 +1,168 @@
+/**
+ * @file aig.hh
+ * @brief Basic expressions compiler - And-Inverter Graphs
+ *
+ * This header file contains the declarations required by the AIG
+ * compiler backend (--compiler-backend=aig). Boolean structure is
+ * kept in a single, structurally hashed And-Inverter Graph whose
+ * inputs are DD vars, rather than in ADDs. Each AIG node used by a
+ * compiled unit is represented by a fresh DD var, defined by an AIG
+ * descriptor and CNF-ized by the engines. Thus the size of compiled
+ * units is linear in the size of the expressions, regardless of the
+ * variable ordering.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILATION_AIG_H
+#define COMPILATION_AIG_H
+
+#include <utility>
+#include <vector>
+
+#include <dd/dd.hh>
+
+#include <utils/context.hh>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace compiler {
+
+    /* literals are (node << 1 | complemented), node 0 is the
+       constant false */
+    typedef unsigned aig_lit_t;
+
+    const aig_lit_t AIG_FALSE { 0 };
+    const aig_lit_t AIG_TRUE { 1 };
+
+    inline aig_lit_t aig_not(aig_lit_t lit)
+    {
+        return lit ^ 1;
+    }
+
+    inline unsigned aig_node(aig_lit_t lit)
+    {
+        return lit >> 1;
+    }
+
+    inline bool aig_complemented(aig_lit_t lit)
+    {
+        return lit & 1;
+    }
+
+    /* inputs have a DD var index, AND nodes have none */
+    struct AigNode {
+        int index;
+        aig_lit_t lhs;
+        aig_lit_t rhs;
+
+        inline bool is_constant() const
+        {
+            return -1 == index && lhs == rhs;
+        }
+
+        inline bool is_input() const
+        {
+            return -1 != index;
+        }
+
+        inline bool is_and() const
+        {
+            return -1 == index && lhs != rhs;
+        }
+    };
+
+    typedef class AigMgr* AigMgr_ptr;
+
+    class AigMgr {
+    public:
+        /* the DD var with the given index */
+        aig_lit_t make_input(int index);
+
+        /* AND nodes are simplified (constants, equal or opposite
+           operands, up to one level of nesting) and structurally
+           hashed */
+        aig_lit_t make_and(aig_lit_t lhs, aig_lit_t rhs);
+
+        inline aig_lit_t make_or(aig_lit_t lhs, aig_lit_t rhs)
+        {
+            return aig_not(make_and(aig_not(lhs), aig_not(rhs)));
+        }
+
+        inline aig_lit_t make_xor(aig_lit_t lhs, aig_lit_t rhs)
+        {
+            return make_or(make_and(lhs, aig_not(rhs)),
+                           make_and(aig_not(lhs), rhs));
+        }
+
+        inline aig_lit_t make_ite(aig_lit_t cnd, aig_lit_t lhs, aig_lit_t rhs)
+        {
+            return make_or(make_and(cnd, lhs),
+                           make_and(aig_not(cnd), rhs));
+        }
+
+        /* a copy, nodes can be added by other threads */
+        AigNode node(unsigned id);
+
+        /* the DD var index representing an AND node, if any. Indices
+           are shared by the DD managers of all compilers */
+        bool find_index(unsigned id, int& res);
+
+        /* the AND node represented by a DD var, if any */
+        bool find_node(int index, unsigned& res);
+
+        void bind(unsigned id, int index);
+
+        /* DD var indices of the inputs in the cone of lit */
+        void support(aig_lit_t lit, std::vector<int>& res);
+
+        static AigMgr& INSTANCE()
+        {
+            return utils::Context::current().instance<AigMgr>(
+                utils::CONTEXT_AIGS, []() { return new AigMgr(); });
+        }
+
+    protected:
+        AigMgr();
+        ~AigMgr();
+
+    private:
+        aig_lit_t make_node(aig_lit_t lhs, aig_lit_t rhs);
+
+        boost::mutex f_mutex;
+
+        std::vector<AigNode> f_nodes;
+
+        typedef boost::unordered_map<std::pair<aig_lit_t, aig_lit_t>, aig_lit_t> AndMap;
+        AndMap f_and_map;
+
+        typedef boost::unordered_map<int, aig_lit_t> InputMap;
+        InputMap f_input_map;
+
+        typedef boost::unordered_map<unsigned, int> Node2DDMap;
+        Node2DDMap f_node2dd_map;
+
+        typedef boost::unordered_map<int, unsigned> DD2NodeMap;
+        DD2NodeMap f_dd2node_map;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILATION_AIG_H */
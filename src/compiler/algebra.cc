@@ -21,6 +21,10 @@
  *
  **/
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <common/common.hh>
 
 #include <compiler.hh>
@@ -137,6 +141,14 @@ namespace compiler {
                       ? lhs_type
                       : rhs_type);
 
+        /* constant operand, cheaper than generic microcode */
+        dd::DDVector specialized;
+        if (algebraic_constant_operand(expr->symb(), signedness, width,
+                                       lhs, rhs, specialized)) {
+            PUSH_DV(specialized, width);
+            return;
+        }
+
 	/* ordinary binary operation */
         FRESH_DV(res, width);
         PUSH_DV(res, width);
@@ -146,6 +158,183 @@ namespace compiler {
         f_inlined_operator_descriptors.push_back(md);
     }
 
+    /* DD vectors are MSB-first, these helpers use LSB-first bit
+     * indexes. */
+    static inline const ADD& dv_bit(const dd::DDVector& dv, unsigned i)
+    {
+        return dv[dv.size() - i - 1];
+    }
+
+    /* true iff all the bits are constant, value is set accordingly */
+    static bool dv_constant_value(const dd::DDVector& dv, uint64_t& value)
+    {
+        if (64 < dv.size()) {
+            return false;
+        }
+
+        value = 0;
+        for (unsigned i = 0; i < dv.size(); ++i) {
+            DdNode* node { dv_bit(dv, i).getNode() };
+            if (!Cudd_IsConstant(node)) {
+                return false;
+            }
+
+            if (cuddV(node)) {
+                value |= (1ULL << i);
+            }
+        }
+
+        return true;
+    }
+
+    /* x << n, pure wiring */
+    static void dv_lshift(const dd::DDVector& x, uint64_t n, const ADD& zero,
+                          dd::DDVector& res)
+    {
+        unsigned width { static_cast<unsigned>(x.size()) };
+
+        res.clear();
+        for (unsigned j = 0; j < width; ++j) {
+            unsigned i { width - j - 1 }; /* bit index for res[j] */
+            res.push_back(n <= i ? dv_bit(x, i - n) : zero);
+        }
+    }
+
+    /* x >> n, pure wiring. Sign bit is replicated for signed operands */
+    static void dv_rshift(const dd::DDVector& x, uint64_t n, const ADD& fill,
+                          dd::DDVector& res)
+    {
+        unsigned width { static_cast<unsigned>(x.size()) };
+
+        res.clear();
+        for (unsigned j = 0; j < width; ++j) {
+            unsigned i { width - j - 1 };
+            res.push_back(n < width - i ? dv_bit(x, i + n) : fill);
+        }
+    }
+
+    bool Compiler::algebraic_constant_operand(expr::ExprType symb, bool signedness,
+                                              unsigned width, dd::DDVector& lhs,
+                                              dd::DDVector& rhs, dd::DDVector& res)
+    {
+        uint64_t k;
+        const uint64_t mask {
+            64 <= width ? ~0ULL : (1ULL << width) - 1
+        };
+
+        const ADD zero { f_dd.addZero() };
+
+        /* x * k, k * x */
+        if (expr::MUL == symb) {
+            if (dv_constant_value(rhs, k)) {
+                algebraic_mul_by_constant(signedness, width, lhs, k & mask, res);
+                return true;
+            }
+            if (dv_constant_value(lhs, k)) {
+                algebraic_mul_by_constant(signedness, width, rhs, k & mask, res);
+                return true;
+            }
+
+            return false;
+        }
+
+        /* other operators are specialized for constant rhs only */
+        if (!dv_constant_value(rhs, k)) {
+            return false;
+        }
+
+        if (expr::LSHIFT == symb) {
+            dv_lshift(lhs, k, zero, res);
+            return true;
+        }
+
+        if (expr::RSHIFT == symb) {
+            dv_rshift(lhs, k, signedness ? dv_bit(lhs, width - 1) : zero, res);
+            return true;
+        }
+
+        /* x / 2^n, x mod 2^n. Signed division truncates towards zero,
+           so only k = 1 is trivial for signed operands */
+        if ((expr::DIV == symb || expr::MOD == symb) &&
+            0 != k && 0 == (k & (k - 1)) && (!signedness || 1 == k)) {
+
+            unsigned n { 0 };
+            while ((1ULL << n) != k) {
+                ++n;
+            }
+
+            if (expr::DIV == symb) {
+                dv_rshift(lhs, n, zero, res);
+            } else {
+                res.clear();
+                for (unsigned j = 0; j < width; ++j) {
+                    unsigned i { width - j - 1 };
+                    res.push_back(i < n ? dv_bit(lhs, i) : zero);
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void Compiler::algebraic_mul_by_constant(bool signedness, unsigned width,
+                                             dd::DDVector& x, uint64_t k,
+                                             dd::DDVector& res)
+    {
+        /* k in non-adjacent form, i.e. as a sum of the fewest signed
+           powers of two: x * k is a shift-and-add network of those
+           terms. Digits beyond width do not affect the result,
+           multiplication being modulo 2^width for both signed and
+           unsigned operands. */
+        std::vector<std::pair<unsigned, bool>> digits; /* (shift, negative) */
+        for (unsigned i = 0; 0 != k && i < width; ++i, k >>= 1) {
+            if (k & 1) {
+                bool negative { 0 != (k & 2) };
+                digits.push_back(std::make_pair(i, negative));
+
+                if (negative) {
+                    ++k;
+                } else {
+                    --k;
+                }
+            }
+        }
+
+        /* start off with a positive term, if any */
+        std::vector<std::pair<unsigned, bool>>::iterator first {
+            std::find_if(digits.begin(), digits.end(),
+                         [](const std::pair<unsigned, bool>& digit) {
+                             return !digit.second;
+                         })
+        };
+
+        dd::DDVector acc;
+        if (digits.end() != first) {
+            dv_lshift(x, first->first, f_dd.addZero(), acc);
+            digits.erase(first);
+        } else {
+            acc.assign(width, f_dd.addZero());
+        }
+
+        for (const auto& digit : digits) {
+            dd::DDVector term;
+            dv_lshift(x, digit.first, f_dd.addZero(), term);
+
+            FRESH_DV(tmp, width);
+            InlinedOperatorDescriptor iod {
+                make_ios(signedness, digit.second ? expr::SUB : expr::PLUS, width),
+                tmp, acc, term
+            };
+            f_inlined_operator_descriptors.push_back(iod);
+
+            acc = tmp;
+        }
+
+        res = acc;
+    }
+
     void Compiler::algebraic_plus(const expr::Expr_ptr expr)
     {
         algebraic_binary(expr);
@@ -243,6 +432,29 @@ namespace compiler {
             return;
         }
 
+        /* x = k, x != k: a bit pattern, no microcode needed */
+        expr::ExprType symb { expr->symb() };
+        if (expr::EQ == symb || expr::NE == symb) {
+            uint64_t k;
+            const dd::DDVector* x { NULL };
+
+            if (dv_constant_value(rhs, k)) {
+                x = &lhs;
+            } else if (dv_constant_value(lhs, k)) {
+                x = &rhs;
+            }
+
+            if (x) {
+                ADD res { f_dd.addOne() };
+                for (unsigned i = 0; i < width; ++i) {
+                    ADD bit { (k >> i) & 1 ? f_dd.addOne() : f_dd.addZero() };
+                    res *= dv_bit(*x, i).Xnor(bit);
+                }
+
+                PUSH_DD(expr::EQ == symb ? res : res.Cmpl());
+                return;
+            }
+        }
 
 	/* ordinary relational */
         FRESH_DV(res, 1);
@@ -389,36 +601,7 @@ namespace compiler {
             return;
         }
 
-        dd::DDVector cnd_dds;
-        dd::DDVector act_dds;
-        unsigned j_, j { 0 };
-
-        do {
-            unsigned i;
-            ADD cnd { bm.one() };
-
-            i = 0;
-            j_ = j;
-            while (i < iwidth) {
-                ADD bit { (j_ & 1) ? bm.one() : bm.zero() };
-                unsigned ndx { iwidth - i - 1 };
-                j_ >>= 1;
-
-                cnd *= index[ndx].Xnor(bit);
-                ++i;
-            }
-
-            cnd_dds.push_back(cnd);
-            act_dds.push_back(make_auto_dd());
-        } while (++j < elem_count);
-
-        FRESH_DV(dv, elem_width);
-        PUSH_DV(dv, elem_width);
-
-        MultiwaySelectionDescriptor msd {
-            elem_width, elem_count, dv, cnd_dds, act_dds, lhs
-        };
-        f_multiway_selection_descriptors.push_back(msd);
+        array_select(elem_width, elem_count, index, lhs);
     }
 
     /* add n-1 non significant zero, LSB is original bit */
@@ -427,7 +610,7 @@ namespace compiler {
         TOP_CTX(ctx);
         type::Type_ptr tp { f_owner.type(expr->lhs(), ctx) };
         for (unsigned i = 0; i < tp->width() - 1; ++i) {
-            PUSH_DD(f_enc.zero());
+            PUSH_DD(f_dd.addZero());
         }
     }
 
@@ -438,7 +621,7 @@ namespace compiler {
         type::Type_ptr tp { f_owner.type(expr->rhs(), ctx) };
         POP_DV(rhs, tp->width());
 
-        ADD res { f_enc.zero() };
+        ADD res { f_dd.addZero() };
         for (unsigned i = 0; i < tp->width(); ++i)
             res = res.Or(rhs[i]);
 
@@ -469,7 +652,7 @@ namespace compiler {
 
                 /* unsigned, pad with zeroes */
                 for (unsigned i = src_type->width(); i < tgt_type->width(); ++i) {
-                    PUSH_DD(f_enc.zero());
+                    PUSH_DD(f_dd.addZero());
                 }
             }
         }
@@ -26,6 +26,11 @@
 #include <compiler.hh>
 #include <expr.hh>
 
+/* array sizes for --array-encoding=auto, larger arrays use lazy
+   selections */
+static const unsigned max_flat_array_elems { 16 };
+static const unsigned max_tree_array_elems { 256 };
+
 namespace compiler {
 
     void Compiler::array_equals(const expr::Expr_ptr expr)
@@ -50,7 +55,7 @@ namespace compiler {
         POP_DV(lhs, width * elems);
 
         /* res := AND(lhs[i] == rhs[i]) */
-        ADD res(f_enc.one());
+        ADD res(f_dd.addOne());
         for (unsigned j = 0; j < elems; ++j) {
             dd::DDVector rhs_fragment;
             rhs_fragment.clear();
@@ -139,4 +144,133 @@ namespace compiler {
             mi->second.push_back(md);
         }
     }
+
+    void Compiler::array_select(unsigned elem_width, unsigned elem_count,
+                                dd::DDVector& index, dd::DDVector& lhs)
+    {
+        if ("flat" == f_array_encoding ||
+            ("auto" == f_array_encoding && elem_count <= max_flat_array_elems)) {
+            array_select_flat(elem_width, elem_count, index, lhs);
+        } else if ("tree" == f_array_encoding ||
+                   ("auto" == f_array_encoding && elem_count <= max_tree_array_elems)) {
+            array_select_tree(elem_width, elem_count, index, lhs);
+        } else {
+            array_select_lazy(elem_width, elem_count, index, lhs);
+        }
+    }
+
+    /* one activation per element, acts[j] <-> (index = j) */
+    void Compiler::array_select_flat(unsigned elem_width, unsigned elem_count,
+                                     dd::DDVector& index, dd::DDVector& lhs)
+    {
+        unsigned iwidth { static_cast<unsigned>(index.size()) };
+
+        dd::DDVector cnd_dds;
+        dd::DDVector act_dds;
+        unsigned j_, j { 0 };
+
+        do {
+            unsigned i;
+            ADD cnd { f_dd.addOne() };
+
+            i = 0;
+            j_ = j;
+            while (i < iwidth) {
+                ADD bit { (j_ & 1) ? f_dd.addOne() : f_dd.addZero() };
+                unsigned ndx { iwidth - i - 1 };
+                j_ >>= 1;
+
+                cnd *= index[ndx].Xnor(bit);
+                ++i;
+            }
+
+            cnd_dds.push_back(cnd);
+            act_dds.push_back(make_auto_dd());
+        } while (++j < elem_count);
+
+        /* Push MUX output DD vector */
+        FRESH_DV(dv, elem_width);
+        PUSH_DV(dv, elem_width);
+
+        MultiwaySelectionDescriptor msd {
+            elem_width, elem_count, dv, cnd_dds, act_dds, lhs
+        };
+        f_multiway_selection_descriptors.push_back(msd);
+    }
+
+    /* 2-way ITE MUXes, one level per index bit (LSB first). Each MUX
+       is a toplevel on its own, activated by its index bit */
+    void Compiler::array_select_tree(unsigned elem_width, unsigned elem_count,
+                                     dd::DDVector& index, dd::DDVector& lhs)
+    {
+        unsigned iwidth { static_cast<unsigned>(index.size()) };
+
+        std::vector<dd::DDVector> level;
+        for (unsigned j = 0; j < elem_count; ++j) {
+            level.push_back(dd::DDVector(lhs.begin() + elem_width * j,
+                                         lhs.begin() + elem_width * (j + 1)));
+        }
+
+        unsigned bit { 0 };
+        while (1 < level.size()) {
+            assert(bit < iwidth);
+            ADD cnd { index[iwidth - bit - 1] };
+
+            std::vector<dd::DDVector> next;
+            for (unsigned k = 0; k + 1 < level.size(); k += 2) {
+                FRESH_DV(z, elem_width);
+
+                BinarySelectionDescriptor md {
+                    elem_width, z, cnd, make_auto_dd(), level[k + 1], level[k]
+                };
+                f_expr2bsd_map[make_auto_id()].push_back(md);
+
+                next.push_back(z);
+            }
+
+            /* odd one out, goes up as it is */
+            if (level.size() & 1) {
+                next.push_back(level.back());
+            }
+
+            level = next;
+            ++bit;
+        }
+
+        PUSH_DV(level[0], elem_width);
+    }
+
+    /* no activations, the SAT engine refines the selection on demand.
+       Index bits that are not plain DD vars are bound to aux vars */
+    void Compiler::array_select_lazy(unsigned elem_width, unsigned elem_count,
+                                     dd::DDVector& index, dd::DDVector& lhs)
+    {
+        dd::DDVector cnd_dds;
+        dd::DDVector act_dds;
+        dd::DDVector bits;
+
+        for (const auto& bit : index) {
+            DdNode* node { bit.getNode() };
+
+            if (Cudd_IsConstant(node) ||
+                node == f_dd.addVar(node->index).getNode()) {
+                bits.push_back(bit);
+                continue;
+            }
+
+            ADD aux { make_auto_dd() };
+            cnd_dds.push_back(bit);
+            act_dds.push_back(aux);
+            bits.push_back(aux);
+        }
+
+        FRESH_DV(dv, elem_width);
+        PUSH_DV(dv, elem_width);
+
+        MultiwaySelectionDescriptor msd {
+            elem_width, elem_count, dv, cnd_dds, act_dds, lhs, bits
+        };
+        f_multiway_selection_descriptors.push_back(msd);
+    }
+
 } // namespace compiler
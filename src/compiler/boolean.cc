@@ -39,6 +39,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_and(aig_lit(lhs), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(lhs.Times(rhs)); /* 0, 1 logic uses arithmetic product for AND */
     }
 
@@ -48,6 +54,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_or(aig_lit(lhs), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(lhs.Or(rhs));
     }
 
@@ -57,6 +69,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_xor(aig_lit(lhs), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(lhs.Xor(rhs));
     }
 
@@ -66,6 +84,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_or(aig_not(aig_lit(lhs)), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(lhs.Cmpl().Or(rhs));
     }
 
@@ -75,6 +99,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(aig_not(f_aig.make_xor(aig_lit(lhs), aig_lit(rhs)))));
+            return;
+        }
+
         PUSH_DD(lhs.Xnor(rhs));
     }
 
@@ -85,6 +115,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(aig_not(f_aig.make_xor(aig_lit(lhs), aig_lit(rhs)))));
+            return;
+        }
+
         PUSH_DD(lhs.Xnor(rhs));
     }
 
@@ -95,6 +131,12 @@ namespace compiler {
 
         POP_DD(rhs);
         POP_DD(lhs);
+
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_xor(aig_lit(lhs), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(lhs.Xor(rhs));
     }
 
@@ -107,6 +149,11 @@ namespace compiler {
         POP_DD(lhs);
         POP_DD(cnd);
 
+        if (f_aig_backend) {
+            PUSH_DD(aig_dd(f_aig.make_ite(aig_lit(cnd), aig_lit(lhs), aig_lit(rhs))));
+            return;
+        }
+
         PUSH_DD(cnd.Ite(lhs, rhs));
     }
 
@@ -152,38 +199,7 @@ namespace compiler {
 
             PUSH_DD(lhs[subscript]);
         } else {
-            /* Build selection DDs */
-            dd::DDVector cnd_dds;
-            dd::DDVector act_dds;
-            unsigned j_, j { 0 };
-            do {
-
-                unsigned i;
-                ADD cnd(bm.one());
-
-                i = 0;
-                j_ = j;
-                while (i < iwidth) {
-                    ADD bit { (j_ & 1) ? bm.one() : bm.zero() };
-                    unsigned ndx { iwidth - i - 1 };
-                    j_ >>= 1;
-
-                    cnd *= index[ndx].Xnor(bit);
-                    ++i;
-                }
-
-                cnd_dds.push_back(cnd);
-                act_dds.push_back(make_auto_dd());
-            } while (++j < elem_count);
-
-            /* Push MUX output DD vector */
-            FRESH_DV(dv, elem_width);
-            PUSH_DV(dv, elem_width);
-
-            MultiwaySelectionDescriptor msd {
-                elem_width, elem_count, dv, cnd_dds, act_dds, lhs
-            };
-            f_multiway_selection_descriptors.push_back(msd);
+            array_select(elem_width, elem_count, index, lhs);
         }
     }
 
@@ -0,0 +1,872 @@
+/**
+ * @file btor2.cc
+ * @brief Word-level export of the FSM in the BTOR2 format,
+ * implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stack>
+
+#include <compiler/btor2.hh>
+
+#include <env/environment.hh>
+
+#include <model/module.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/proxy.hh>
+
+#include <type/classes.hh>
+
+#include <utils/logging.hh>
+
+namespace compiler {
+
+    static inline unsigned long width_mask(unsigned width)
+    {
+        return width < 64 ? (1UL << width) - 1 : ~0UL;
+    }
+
+    /* the least number of bits telling n values apart, at least one */
+    static unsigned bits_for(unsigned long n)
+    {
+        unsigned res { 1 };
+        while (res < 64 && (1UL << res) < n) {
+            ++res;
+        }
+
+        return res;
+    }
+
+    Btor2Export::Btor2Export(model::Model& model)
+        : f_model(model)
+        , f_em(expr::ExprMgr::INSTANCE())
+        , f_tm(type::TypeMgr::INSTANCE())
+        , f_preprocessor()
+        , f_last_nid(0)
+    {}
+
+    Btor2Export::~Btor2Export()
+    {}
+
+    /* One step of the FSM per cycle, as for AIGs: states hold the
+     * current values, their successors are inputs, which the TRANS
+     * constraints relate to them. INIT is only required on the first
+     * cycle, while a state of its own is still 0. Everything but bad
+     * states is a single constraint: as constraints hold on every
+     * cycle, including the last one, bad states are only reached with
+     * a successor (i.e. the FSM is assumed not to deadlock). */
+    void Btor2Export::process(expr::Expr_ptr target, std::ostream& os)
+    {
+        declare_vars();
+
+        unsigned s1 { sort_bv(1) };
+        unsigned started { node("state " + std::to_string(s1) + " __started") };
+        op("init", s1, started, const_bv(0, 1));
+        op("next", s1, started, const_bv(1, 1));
+
+        unsigned constraint { fsm_constraint(started) };
+
+        for (auto full : f_states) {
+            const VarNodes& nodes { f_vars[full] };
+            op("next", sort_of(nodes.type), nodes.now, nodes.succ);
+        }
+
+        unsigned bad { 0 };
+        if (NULL != target) {
+            bad = as_bool(lower(f_em.make_empty(), target, 0), target);
+        }
+
+        if (constraint != const_bv(1, 1)) {
+            node("constraint " + std::to_string(constraint) + " fsm");
+        }
+
+        if (NULL != target) {
+            node("bad " + std::to_string(bad));
+        }
+
+        os
+            << "; written by yasmv"
+            << std::endl;
+
+        if (NULL != target) {
+            os
+                << "; bad states: "
+                << target
+                << std::endl;
+        }
+
+        os
+            << f_lines;
+
+        unsigned n_states { (unsigned) f_states.size() };
+        INFO
+            << "Wrote BTOR2 model with "
+            << n_states
+            << " states and "
+            << f_last_nid
+            << " nodes"
+            << std::endl;
+    }
+
+    void Btor2Export::declare_vars()
+    {
+        std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
+        stack.push(std::make_pair(f_em.make_empty(), &f_model.main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, model::Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            model::Module& module { *top.second };
+
+            symb::Variables attrs { module.vars() };
+            for (symb::Variables::const_iterator vi = attrs.begin(); attrs.end() != vi; ++vi) {
+                expr::Expr_ptr full { f_em.make_dot(ctx, vi->first) };
+
+                symb::Variable& var { *vi->second };
+                type::Type_ptr vtype { var.type() };
+                if (vtype->is_instance()) {
+                    type::InstanceType_ptr instance { vtype->as_instance() };
+                    model::Module& module { f_model.module(instance->name()) };
+                    stack.push(std::make_pair(full, &module));
+                } else {
+                    declare_var(full, var);
+                }
+            }
+        }
+    }
+
+    void Btor2Export::declare_var(expr::Expr_ptr full, symb::Variable& var)
+    {
+        type::Type_ptr type { var.type() };
+
+        std::ostringstream oss;
+        oss
+            << full;
+        const std::string name { oss.str() };
+
+        /* INPUT vars are in fact bodyless, typed DEFINEs, those with
+           no value are left free on every cycle */
+        if (var.is_input()) {
+            try {
+                env::Environment::INSTANCE().get(var.name());
+                return;
+            } catch (env::NoSuchIdentifier&) {}
+
+            unsigned input { node("input " + std::to_string(sort_of(type)) + " " + name) };
+            VarNodes nodes { type, input, 0 };
+            f_vars.insert(std::make_pair(full, nodes));
+
+            range_constraints(input, type);
+            return;
+        }
+
+        unsigned sid { sort_of(type) };
+        unsigned now { node("state " + std::to_string(sid) + " " + name) };
+        unsigned succ {
+            var.is_frozen() ? now : node("input " + std::to_string(sid) + " next(" + name + ")")
+        };
+
+        VarNodes nodes { type, now, succ };
+        f_vars.insert(std::make_pair(full, nodes));
+        f_states.push_back(full);
+
+        range_constraints(now, type);
+        if (!var.is_frozen()) {
+            range_constraints(succ, type);
+        }
+    }
+
+    unsigned Btor2Export::fsm_constraint(unsigned started)
+    {
+        env::Environment& env { env::Environment::INSTANCE() };
+        unsigned s1 { sort_bv(1) };
+
+        unsigned init { section(f_em.make_empty(), env.extra_init()) };
+        unsigned res { op("and", s1, section(f_em.make_empty(), env.extra_invar()),
+                          section(f_em.make_empty(), env.extra_trans())) };
+
+        std::stack<std::pair<expr::Expr_ptr, model::Module_ptr>> stack;
+        stack.push(std::make_pair(f_em.make_empty(), &f_model.main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, model::Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            model::Module& module { *top.second };
+
+            init = op("and", s1, init, section(ctx, module.init()));
+            res = op("and", s1, res, section(ctx, module.invar()));
+            res = op("and", s1, res, section(ctx, module.trans()));
+
+            symb::Variables attrs { module.vars() };
+            for (symb::Variables::const_iterator vi = attrs.begin(); attrs.end() != vi; ++vi) {
+                type::Type_ptr vtype { vi->second->type() };
+                if (vtype->is_instance()) {
+                    type::InstanceType_ptr instance { vtype->as_instance() };
+                    model::Module& module { f_model.module(instance->name()) };
+                    stack.push(std::make_pair(f_em.make_dot(ctx, vi->first), &module));
+                }
+            }
+        }
+
+        for (auto range : f_ranges) {
+            res = op("and", s1, res, range);
+        }
+
+        /* INIT on the first cycle only */
+        return op("and", s1, res, op("or", s1, started, init));
+    }
+
+    unsigned Btor2Export::section(expr::Expr_ptr ctx, const expr::ExprVector& bodies)
+    {
+        unsigned s1 { sort_bv(1) };
+
+        unsigned res { const_bv(1, 1) };
+        for (auto body : bodies) {
+            res = op("and", s1, res, as_bool(lower(ctx, body, 0), body));
+        }
+
+        return res;
+    }
+
+    unsigned Btor2Export::node(const std::string& line)
+    {
+        boost::unordered_map<std::string, unsigned>::const_iterator eye { f_nodes.find(line) };
+        if (f_nodes.end() != eye) {
+            return eye->second;
+        }
+
+        unsigned res { ++f_last_nid };
+        f_lines += std::to_string(res) + " " + line + "\n";
+        f_nodes.insert(std::make_pair(line, res));
+
+        return res;
+    }
+
+    unsigned Btor2Export::op(const char* name, unsigned sid, unsigned a, unsigned b,
+                             unsigned c)
+    {
+        /* conjunctions with true are the other operand */
+        if (!strcmp(name, "and") && sort_bv(1) == sid) {
+            unsigned one { const_bv(1, 1) };
+            if (one == a) {
+                return b;
+            }
+            if (one == b) {
+                return a;
+            }
+        }
+
+        std::ostringstream oss;
+        oss
+            << name
+            << " "
+            << sid
+            << " "
+            << a;
+
+        if (0 != b) {
+            oss
+                << " "
+                << b;
+        }
+
+        if (0 != c) {
+            oss
+                << " "
+                << c;
+        }
+
+        return node(oss.str());
+    }
+
+    unsigned Btor2Export::sort_bv(unsigned width)
+    {
+        return node("sort bitvec " + std::to_string(width));
+    }
+
+    unsigned Btor2Export::sort_of(type::Type_ptr type)
+    {
+        if (type->is_array()) {
+            type::ArrayType_ptr at { type->as_array() };
+            unsigned index { sort_bv(bits_for(at->nelems())) };
+            unsigned element { sort_of(at->of()) };
+
+            return node("sort array " + std::to_string(index) + " " + std::to_string(element));
+        }
+
+        if (!type->is_boolean() && !type->is_enum() && !type->is_signed_algebraic() &&
+            !type->is_unsigned_algebraic()) {
+            throw UnsupportedLowering(type->repr());
+        }
+
+        return sort_bv(sort_width(type));
+    }
+
+    unsigned Btor2Export::const_bv(unsigned long value, unsigned width)
+    {
+        std::string bits;
+        for (unsigned i = width; 0 < i; --i) {
+            bits += (i - 1 < 64 && (value >> (i - 1)) & 1) ? '1' : '0';
+        }
+
+        return node("const " + std::to_string(sort_bv(width)) + " " + bits);
+    }
+
+    unsigned Btor2Export::sort_width(type::Type_ptr type)
+    {
+        if (type->is_boolean()) {
+            return 1;
+        }
+
+        if (type->is_enum()) {
+            return bits_for(type->as_enum()->literals().size());
+        }
+
+        return type->width();
+    }
+
+    void Btor2Export::range_constraints(unsigned nid, type::Type_ptr type)
+    {
+        if (type->is_array()) {
+            type::ArrayType_ptr at { type->as_array() };
+            type::Type_ptr of { at->of() };
+            if (!of->is_enum()) {
+                return;
+            }
+
+            unsigned width { bits_for(at->nelems()) };
+            for (unsigned k = 0; k < at->nelems(); ++k) {
+                range_constraints(op("read", sort_of(of), nid, const_bv(k, width)), of);
+            }
+
+            return;
+        }
+
+        if (!type->is_enum()) {
+            return;
+        }
+
+        unsigned n { (unsigned) type->as_enum()->literals().size() };
+        unsigned width { sort_width(type) };
+        if (n < (1UL << width)) {
+            f_ranges.push_back(op("ult", sort_bv(1), nid, const_bv(n, width)));
+        }
+    }
+
+    unsigned Btor2Export::as_bv(const Term& t, unsigned width)
+    {
+        if (TERM_CONST == t.kind) {
+            return const_bv((unsigned long) t.value & width_mask(width), width);
+        }
+
+        if (t.width == width) {
+            return t.nid;
+        }
+
+        std::ostringstream oss;
+        if (t.width < width) {
+            oss
+                << (t.is_signed ? "sext" : "uext")
+                << " "
+                << sort_bv(width)
+                << " "
+                << t.nid
+                << " "
+                << width - t.width;
+        } else {
+            oss
+                << "slice "
+                << sort_bv(width)
+                << " "
+                << t.nid
+                << " "
+                << width - 1
+                << " 0";
+        }
+
+        return node(oss.str());
+    }
+
+    unsigned Btor2Export::as_bool(const Term& t, expr::Expr_ptr expr)
+    {
+        if (TERM_BOOL != t.kind) {
+            throw UnsupportedLowering(expr);
+        }
+
+        return t.nid;
+    }
+
+    Btor2Export::Term Btor2Export::lower(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                         step_t time)
+    {
+        expr::TimedExpr key { f_em.make_dot(ctx, expr), time };
+        auto eye { f_terms.find(key) };
+        if (f_terms.end() != eye) {
+            return eye->second;
+        }
+
+        unsigned s1 { sort_bv(1) };
+        Term res { TERM_BOOL, 0, 1, false, 0 };
+        expr::ExprType symb { expr->symb() };
+
+        switch (symb) {
+            case expr::IDENT:
+            case expr::ICONST:
+            case expr::HCONST:
+            case expr::OCONST:
+            case expr::BCONST:
+                res = lower_leaf(ctx, expr, time);
+                break;
+
+            case expr::NEXT:
+                res = lower(ctx, expr->lhs(), time + 1);
+                break;
+
+            case expr::DOT:
+                res = lower(f_em.make_dot(ctx, expr->lhs()), expr->rhs(), time);
+                break;
+
+            case expr::PARAMS:
+                res = lower(ctx,
+                            model::ModelMgr::INSTANCE().expansion_cache().expand(
+                                f_preprocessor, expr, ctx),
+                            time);
+                break;
+
+            case expr::GUARD:
+                res = lower(ctx, f_em.make_implies(expr->lhs(), expr->rhs()), time);
+                break;
+
+            case expr::ASSIGNMENT:
+                res = lower(ctx, f_em.make_eq(f_em.make_next(expr->lhs()), expr->rhs()), time);
+                break;
+
+            case expr::SUBSCRIPT:
+                res = lower_subscript(ctx, expr, time);
+                break;
+
+            case expr::NOT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                res.nid = op("not", s1, as_bool(x, expr));
+                break;
+            }
+
+            case expr::AND:
+            case expr::OR:
+            case expr::IMPLIES: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                const char* name { expr::AND == symb ? "and" : expr::OR == symb ? "or" : "implies" };
+                res.nid = op(name, s1, as_bool(x, expr), as_bool(y, expr));
+                break;
+            }
+
+            case expr::ITE: {
+                expr::Expr_ptr cond { expr->lhs() };
+                if (!f_em.is_cond(cond)) {
+                    throw UnsupportedLowering(expr);
+                }
+
+                Term c { lower(ctx, cond->lhs(), time) };
+                Term x { lower(ctx, cond->rhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                if (TERM_BOOL == x.kind || TERM_BOOL == y.kind) {
+                    res.nid = op("ite", s1, as_bool(c, expr), as_bool(x, expr), as_bool(y, expr));
+                    break;
+                }
+
+                unsigned width { std::max(TERM_CONST == x.kind ? 0 : x.width,
+                                          TERM_CONST == y.kind ? 0 : y.width) };
+                if (0 == width) {
+                    width = opts::OptsMgr::INSTANCE().word_width();
+                }
+
+                res.kind = TERM_BV;
+                res.width = width;
+                res.is_signed = x.is_signed || y.is_signed;
+                res.nid = op("ite", sort_bv(width), as_bool(c, expr), as_bv(x, width),
+                             as_bv(y, width));
+                break;
+            }
+
+            case expr::CAST: {
+                type::Type_ptr type { f_tm.find_type_by_def(expr->lhs()) };
+                if (!type->is_signed_algebraic() && !type->is_unsigned_algebraic()) {
+                    throw UnsupportedLowering(expr);
+                }
+
+                Term x { lower(ctx, expr->rhs(), time) };
+                res.kind = TERM_BV;
+                res.width = type->width();
+                res.is_signed = type->is_signed_algebraic();
+                res.nid = as_bv(x, res.width);
+                break;
+            }
+
+            case expr::NEG:
+            case expr::BW_NOT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+
+                if (TERM_CONST == x.kind) {
+                    res = x;
+                    res.value = expr::NEG == symb ? -x.value : ~x.value;
+                    break;
+                }
+
+                if (TERM_BOOL == x.kind && expr::BW_NOT == symb) {
+                    res.nid = op("not", s1, x.nid);
+                    break;
+                }
+
+                res = x;
+                res.nid = op(expr::NEG == symb ? "neg" : "not", sort_bv(x.width), x.nid);
+                break;
+            }
+
+            case expr::EQ:
+            case expr::NE:
+            case expr::GE:
+            case expr::GT:
+            case expr::LE:
+            case expr::LT:
+            case expr::PLUS:
+            case expr::SUB:
+            case expr::MUL:
+            case expr::DIV:
+            case expr::MOD:
+            case expr::BW_AND:
+            case expr::BW_OR:
+            case expr::BW_XOR:
+            case expr::BW_XNOR:
+            case expr::LSHIFT:
+            case expr::RSHIFT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                bool relational { expr::EQ == symb || expr::NE == symb || expr::GE == symb ||
+                                  expr::GT == symb || expr::LE == symb || expr::LT == symb };
+
+                /* booleans */
+                if (TERM_BOOL == x.kind || TERM_BOOL == y.kind) {
+                    const char* name {
+                        expr::EQ == symb ? "eq" :
+                        expr::NE == symb ? "neq" :
+                        expr::BW_AND == symb ? "and" :
+                        expr::BW_OR == symb ? "or" :
+                        expr::BW_XOR == symb ? "xor" :
+                        expr::BW_XNOR == symb ? "xnor" :
+                                                NULL
+                    };
+                    if (NULL == name) {
+                        throw UnsupportedLowering(expr);
+                    }
+
+                    res.nid = op(name, s1, as_bool(x, expr), as_bool(y, expr));
+                    break;
+                }
+
+                /* constants are folded, where it is safe to */
+                if (TERM_CONST == x.kind && TERM_CONST == y.kind && !relational) {
+                    value_t a { x.value };
+                    value_t b { y.value };
+
+                    bool folded { true };
+                    value_t value { 0 };
+                    switch (symb) {
+                        case expr::PLUS:
+                            value = a + b;
+                            break;
+                        case expr::SUB:
+                            value = a - b;
+                            break;
+                        case expr::MUL:
+                            value = a * b;
+                            break;
+                        case expr::BW_AND:
+                            value = a & b;
+                            break;
+                        case expr::BW_OR:
+                            value = a | b;
+                            break;
+                        case expr::BW_XOR:
+                            value = a ^ b;
+                            break;
+                        default:
+                            folded = false;
+                    }
+
+                    if (folded) {
+                        res = x;
+                        res.value = value;
+                        break;
+                    }
+                }
+
+                /* operands are extended to the largest width, signed
+                   if either one is */
+                unsigned width { std::max(TERM_CONST == x.kind ? 0 : x.width,
+                                          TERM_CONST == y.kind ? 0 : y.width) };
+                if (0 == width) {
+                    width = opts::OptsMgr::INSTANCE().word_width();
+                }
+                bool is_signed { x.is_signed || y.is_signed };
+
+                /* shift amounts keep their own signedness */
+                if (expr::LSHIFT == symb || expr::RSHIFT == symb) {
+                    width = TERM_CONST == x.kind ? width : x.width;
+                    is_signed = x.is_signed;
+                }
+
+                unsigned a { as_bv(x, width) };
+                unsigned b { as_bv(y, width) };
+
+                const char* name { NULL };
+                switch (symb) {
+                    case expr::EQ:
+                        name = "eq";
+                        break;
+                    case expr::NE:
+                        name = "neq";
+                        break;
+                    case expr::GE:
+                        name = is_signed ? "sgte" : "ugte";
+                        break;
+                    case expr::GT:
+                        name = is_signed ? "sgt" : "ugt";
+                        break;
+                    case expr::LE:
+                        name = is_signed ? "slte" : "ulte";
+                        break;
+                    case expr::LT:
+                        name = is_signed ? "slt" : "ult";
+                        break;
+                    case expr::PLUS:
+                        name = "add";
+                        break;
+                    case expr::SUB:
+                        name = "sub";
+                        break;
+                    case expr::MUL:
+                        name = "mul";
+                        break;
+                    case expr::DIV:
+                        name = is_signed ? "sdiv" : "udiv";
+                        break;
+                    case expr::MOD:
+                        name = is_signed ? "srem" : "urem";
+                        break;
+                    case expr::BW_AND:
+                        name = "and";
+                        break;
+                    case expr::BW_OR:
+                        name = "or";
+                        break;
+                    case expr::BW_XOR:
+                        name = "xor";
+                        break;
+                    case expr::BW_XNOR:
+                        name = "xnor";
+                        break;
+                    case expr::LSHIFT:
+                        name = "sll";
+                        break;
+                    case expr::RSHIFT:
+                        name = is_signed ? "sra" : "srl";
+                        break;
+                    default:
+                        assert(false); /* unreachable */
+                }
+
+                if (relational) {
+                    res.nid = op(name, s1, a, b);
+                } else {
+                    res.kind = TERM_BV;
+                    res.width = width;
+                    res.is_signed = is_signed;
+                    res.nid = op(name, sort_bv(width), a, b);
+                }
+                break;
+            }
+
+            default:
+                throw UnsupportedLowering(expr);
+        }
+
+        f_terms.insert(std::make_pair(key, res));
+        return res;
+    }
+
+    Btor2Export::Term Btor2Export::lower_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                              step_t time)
+    {
+        if (f_em.is_true(expr) || f_em.is_false(expr)) {
+            Term res { TERM_BOOL, const_bv(f_em.is_true(expr) ? 1 : 0, 1), 1, false, 0 };
+            return res;
+        }
+
+        if (f_em.is_int_const(expr)) {
+            Term res { TERM_CONST, 0, 0, false, expr->value() };
+            return res;
+        }
+
+        expr::Expr_ptr full { f_em.make_dot(ctx, expr) };
+
+        symb::ResolverProxy resolver;
+        symb::Symbol_ptr symb { resolver.symbol(full) };
+
+        /* enum literals, by index */
+        if (symb->is_literal()) {
+            type::Type_ptr type { symb->as_literal().type() };
+            if (!type->is_enum()) {
+                throw UnsupportedLowering(expr);
+            }
+
+            unsigned width { sort_width(type) };
+            Term res {
+                TERM_BV, const_bv(type->as_enum()->value(expr), width), width, false, 0
+            };
+            return res;
+        }
+
+        if (symb->is_variable()) {
+            const symb::Variable& var { symb->as_variable() };
+
+            boost::unordered_map<expr::Expr_ptr, VarNodes>::const_iterator i {
+                f_vars.find(full)
+            };
+
+            /* bound INPUT vars take their values */
+            if (var.is_input() && f_vars.end() == i) {
+                return lower(ctx, env::Environment::INSTANCE().get(expr), time);
+            }
+
+            /* one cycle is one step, free inputs have no successor */
+            if (f_vars.end() == i || 1 < time || (1 == time && 0 == i->second.succ)) {
+                throw UnsupportedLowering(expr);
+            }
+
+            type::Type_ptr type { var.type() };
+            if (type->is_array()) {
+                throw UnsupportedLowering(expr);
+            }
+
+            Term res {
+                type->is_boolean() ? TERM_BOOL : TERM_BV,
+                0 == time ? i->second.now : i->second.succ,
+                sort_width(type), type->is_signed_algebraic(), 0
+            };
+            return res;
+        }
+
+        if (symb->is_parameter()) {
+            expr::Expr_ptr rewrite { model::ModelMgr::INSTANCE().rewrite_parameter(full) };
+            return lower(rewrite->lhs(), rewrite->rhs(), time);
+        }
+
+        /* DEFINEs, shared by the terms using them */
+        if (symb->is_define()) {
+            return lower(ctx, symb->as_define().body(), time);
+        }
+
+        throw UnsupportedLowering(expr);
+    }
+
+    Btor2Export::Term Btor2Export::lower_subscript(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                                   step_t time)
+    {
+        /* the array var, possibly shifted in time and qualified */
+        expr::Expr_ptr base { expr->lhs() };
+        expr::Expr_ptr base_ctx { ctx };
+        step_t base_time { time };
+        while (f_em.is_next(base) || f_em.is_dot(base)) {
+            if (f_em.is_next(base)) {
+                ++base_time;
+                base = base->lhs();
+            } else {
+                base_ctx = f_em.make_dot(base_ctx, base->lhs());
+                base = base->rhs();
+            }
+        }
+
+        if (!f_em.is_identifier(base)) {
+            throw UnsupportedLowering(expr);
+        }
+
+        expr::Expr_ptr full { f_em.make_dot(base_ctx, base) };
+
+        boost::unordered_map<expr::Expr_ptr, VarNodes>::const_iterator i { f_vars.find(full) };
+        if (f_vars.end() == i || !i->second.type->is_array() || 1 < base_time ||
+            (1 == base_time && 0 == i->second.succ)) {
+            throw UnsupportedLowering(expr);
+        }
+
+        type::ArrayType_ptr at { i->second.type->as_array() };
+        type::Type_ptr of { at->of() };
+        unsigned array { 0 == base_time ? i->second.now : i->second.succ };
+        unsigned nelems { at->nelems() };
+        unsigned width { bits_for(nelems) };
+
+        Term res {
+            of->is_boolean() ? TERM_BOOL : TERM_BV, 0, sort_width(of),
+            of->is_signed_algebraic(), 0
+        };
+
+        /* the index is in the original context and time */
+        Term index { lower(ctx, expr->rhs(), time) };
+        if (TERM_BOOL == index.kind) {
+            throw UnsupportedLowering(expr);
+        }
+
+        if (TERM_CONST == index.kind) {
+            if (index.value < 0 || (value_t) nelems <= index.value) {
+                throw UnsupportedLowering(expr);
+            }
+
+            res.nid = op("read", sort_of(of), array, const_bv(index.value, width));
+            return res;
+        }
+
+        /* out of range indexes select the last element */
+        unsigned selector { index.nid };
+        if (index.width != width || (1UL << width) != nelems) {
+            unsigned w { std::max(index.width, width) };
+            unsigned ext { as_bv(index, w) };
+            unsigned last { const_bv(nelems - 1, w) };
+            unsigned in_range { op("ult", sort_bv(1), ext, const_bv(nelems, w)) };
+
+            Term clamped { TERM_BV, op("ite", sort_bv(w), in_range, ext, last), w, false, 0 };
+            selector = as_bv(clamped, width);
+        }
+
+        res.nid = op("read", sort_of(of), array, selector);
+        return res;
+    }
+
+} // namespace compiler
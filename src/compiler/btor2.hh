@@ -0,0 +1,154 @@
+/**
+ * @file btor2.hh
+ * @brief Word-level export of the FSM in the BTOR2 format
+ *
+ * This header file contains the declarations of the lowering of the
+ * FSM to BTOR2, for word-level hardware model checkers. As with the
+ * SMT-LIB2 lowering, no bit-blasting takes place: booleans are
+ * lowered to bit-vectors of width 1, algebraics to bit-vectors of
+ * their width, enums to bit-vectors indexing their literals and
+ * arrays to BTOR2 arrays. Nodes are structurally hashed, DEFINEs are
+ * shared by all the nodes using them.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILER_BTOR2_H
+#define COMPILER_BTOR2_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+#include <expr/time/timed_expr.hh>
+
+#include <compiler/exceptions.hh>
+
+#include <model/model.hh>
+#include <model/model_mgr.hh>
+
+#include <symb/classes.hh>
+
+#include <type/type_mgr.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace compiler {
+
+    class Btor2Export {
+    public:
+        Btor2Export(model::Model& model);
+        ~Btor2Export();
+
+        /* writes the FSM of the model (and the extra constraints of
+         * the environment), with the states satisfying target (unless
+         * NULL) as bad states. Throws UnsupportedLowering on exprs
+         * with no BTOR2 counterpart here (e.g. absolute times, whole
+         * arrays, temporal operators), nothing is written then. */
+        void process(expr::Expr_ptr target, std::ostream& os);
+
+    private:
+        typedef enum {
+            TERM_BOOL,
+            TERM_BV,
+            TERM_CONST, /* int constants, width is taken from the context */
+        } term_kind_t;
+
+        struct Term {
+            term_kind_t kind;
+            unsigned nid;
+            unsigned width;
+            bool is_signed;
+            value_t value;
+        };
+
+        /* the nodes of a var: its state, and the input its successor
+           is (frozen vars are their own successors). Unbound INPUT
+           vars are inputs, with no successor */
+        struct VarNodes {
+            type::Type_ptr type;
+            unsigned now;
+            unsigned succ;
+        };
+
+        void declare_vars();
+        void declare_var(expr::Expr_ptr full, symb::Variable& var);
+
+        /* the FSM and extra constraints, a single conjunction. INIT
+           is only required unless started */
+        unsigned fsm_constraint(unsigned started);
+        unsigned section(expr::Expr_ptr ctx, const expr::ExprVector& bodies);
+
+        Term lower(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+        Term lower_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+        Term lower_subscript(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+
+        /* the node of a line, appended on first use */
+        unsigned node(const std::string& line);
+        unsigned op(const char* name, unsigned sid, unsigned a, unsigned b = 0,
+                    unsigned c = 0);
+
+        unsigned sort_bv(unsigned width);
+        unsigned sort_of(type::Type_ptr type);
+        unsigned const_bv(unsigned long value, unsigned width);
+
+        /* t as a bit-vector of width, extended (by its signedness)
+           or truncated */
+        unsigned as_bv(const Term& t, unsigned width);
+
+        /* t as a bit-vector of width 1 */
+        unsigned as_bool(const Term& t, expr::Expr_ptr expr);
+
+        /* the bits of the bit-vector sort for type */
+        unsigned sort_width(type::Type_ptr type);
+
+        /* enums take the values of their literals only */
+        void range_constraints(unsigned nid, type::Type_ptr type);
+
+        model::Model& f_model;
+
+        expr::ExprMgr& f_em;
+        type::TypeMgr& f_tm;
+
+        /* DEFINEs with params are expanded first */
+        expr::preprocessor::Preprocessor f_preprocessor;
+
+        /* the lines written so far, and the nodes by line */
+        std::string f_lines;
+        boost::unordered_map<std::string, unsigned> f_nodes;
+        unsigned f_last_nid;
+
+        /* vars by fully qualified name */
+        boost::unordered_map<expr::Expr_ptr, VarNodes> f_vars;
+        std::vector<expr::Expr_ptr> f_states;
+
+        /* range constraints of the enum vars */
+        std::vector<unsigned> f_ranges;
+
+        /* terms by timed fully qualified expr */
+        boost::unordered_map<expr::TimedExpr, Term,
+                             expr::TimedExprHash, expr::TimedExprEq>
+            f_terms;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILER_BTOR2_H */
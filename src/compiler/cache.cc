@@ -0,0 +1,737 @@
+/**
+ * @file cache.cc
+ * @brief Basic expressions compiler - On-disk compilation cache
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <compiler/cache.hh>
+#include <compiler/compiler.hh>
+
+#include <env/environment.hh>
+
+#include <model/model.hh>
+#include <model/model_mgr.hh>
+#include <model/module.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/classes.hh>
+#include <symb/symb_iter.hh>
+
+#include <utils/logging.hh>
+
+#include <dd/cudd-2.5.0/cudd/cuddInt.h>
+
+/* bump whenever the file format, or the compilation, changes */
+static const char* unit_cache_magic = "yasmv-unit 2";
+static const char* unit_cache_ext = ".unit";
+
+namespace compiler {
+
+    /* FNV-1a, stable across runs (unlike std::hash) */
+    static uint64_t stable_hash(const std::string& s)
+    {
+        uint64_t res { 14695981039346656037ULL };
+        for (unsigned char c : s) {
+            res ^= c;
+            res *= 1099511628211ULL;
+        }
+
+        return res;
+    }
+
+    /* DD nodes of a unit, and the vars they depend upon, as they are
+       written to the cache file */
+    struct UnitWriter {
+        UnitWriter(enc::EncodingMgr& enc,
+                   const boost::unordered_map<expr::Expr_ptr, std::string>& var_names)
+            : f_enc(enc)
+            , f_var_names(var_names)
+        {}
+
+        /* post-order, children come first */
+        unsigned node(DdNode* node)
+        {
+            boost::unordered_map<DdNode*, unsigned>::const_iterator i { f_ids.find(node) };
+            if (f_ids.end() != i) {
+                return i->second;
+            }
+
+            std::ostringstream oss;
+            if (Cudd_IsConstant(node)) {
+                oss
+                    << "c "
+                    << std::setprecision(17)
+                    << Cudd_V(node);
+            } else {
+                unsigned t { this->node(Cudd_T(node)) };
+                unsigned e { this->node(Cudd_E(node)) };
+
+                oss
+                    << "n "
+                    << var(node->index)
+                    << " "
+                    << t
+                    << " "
+                    << e;
+            }
+
+            unsigned res { (unsigned) f_nodes.size() };
+            f_nodes.push_back(oss.str());
+            f_ids[node] = res;
+
+            return res;
+        }
+
+        void dds(std::ostream& os, const dd::DDVector& dds)
+        {
+            os << dds.size();
+            for (const auto& dd : dds) {
+                os << " " << node(dd.getNode());
+            }
+        }
+
+        /* model vars by name, aux vars are built anew on loading */
+        unsigned var(unsigned index)
+        {
+            boost::unordered_map<unsigned, unsigned>::const_iterator i { f_var_ids.find(index) };
+            if (f_var_ids.end() != i) {
+                return i->second;
+            }
+
+            const enc::UCBI& ucbi { f_enc.find_ucbi(index) };
+            boost::unordered_map<expr::Expr_ptr, std::string>::const_iterator vi {
+                f_var_names.find(ucbi.expr())
+            };
+
+            std::ostringstream oss;
+            oss
+                << (f_var_names.end() != vi ? "v " : "t ")
+                << ucbi.time()
+                << " "
+                << ucbi.bitno();
+
+            if (f_var_names.end() != vi) {
+                oss
+                    << " "
+                    << vi->second;
+            }
+
+            unsigned res { (unsigned) f_vars.size() };
+            f_vars.push_back(oss.str());
+            f_var_ids[index] = res;
+
+            return res;
+        }
+
+        enc::EncodingMgr& f_enc;
+        const boost::unordered_map<expr::Expr_ptr, std::string>& f_var_names;
+
+        boost::unordered_map<DdNode*, unsigned> f_ids;
+        std::vector<std::string> f_nodes;
+
+        boost::unordered_map<unsigned, unsigned> f_var_ids;
+        std::vector<std::string> f_vars;
+    };
+
+    /* false iff the vector could not be read */
+    static bool read_dds(std::istream& is, const std::vector<ADD>& nodes, dd::DDVector& res)
+    {
+        unsigned n;
+        if (!(is >> n)) {
+            return false;
+        }
+
+        for (unsigned i = 0; i < n; ++i) {
+            unsigned id;
+            if (!(is >> id) || nodes.size() <= id) {
+                return false;
+            }
+
+            res.push_back(nodes[id]);
+        }
+
+        return true;
+    }
+
+    UnitCache::UnitCache(Compiler& owner)
+        : f_owner(owner)
+        , f_enc(enc::EncodingMgr::INSTANCE())
+        , f_cachepath(opts::OptsMgr::INSTANCE().compile_cache())
+        , f_vars_ready(false)
+    {}
+
+    UnitCache::~UnitCache()
+    {}
+
+    const std::string& UnitCache::model_signature()
+    {
+        if (!f_model_signature.empty()) {
+            return f_model_signature;
+        }
+
+        model::Model& model { model::ModelMgr::INSTANCE().model() };
+
+        std::vector<std::string> modules;
+        for (const auto& pair : model.modules()) {
+            model::Module& module { *pair.second };
+            std::ostringstream oss;
+
+            oss
+                << "module "
+                << module.name()
+                << std::endl;
+
+            for (const auto& param : module.parameters()) {
+                oss
+                    << "param "
+                    << param.first
+                    << " : "
+                    << param.second->type()
+                    << std::endl;
+            }
+
+            std::vector<std::string> symbols;
+            for (const auto& var : module.vars()) {
+                const symb::Variable& v { *var.second };
+                std::ostringstream vss;
+
+                vss
+                    << "var "
+                    << var.first
+                    << " : "
+                    << v.type()
+                    << (v.is_input() ? " input" : "")
+                    << (v.is_frozen() ? " frozen" : "")
+                    << (v.is_temp() ? " temp" : "")
+                    << (v.is_inertial() ? " inertial" : "");
+
+                symbols.push_back(vss.str());
+            }
+
+            for (const auto& def : module.defs()) {
+                std::ostringstream dss;
+
+                dss
+                    << "define "
+                    << def.first
+                    << " := "
+                    << def.second->body();
+
+                symbols.push_back(dss.str());
+            }
+
+            std::sort(symbols.begin(), symbols.end());
+            for (const auto& symbol : symbols) {
+                oss
+                    << symbol
+                    << std::endl;
+            }
+
+            for (auto init : module.init()) {
+                oss
+                    << "init "
+                    << init
+                    << std::endl;
+            }
+            for (auto invar : module.invar()) {
+                oss
+                    << "invar "
+                    << invar
+                    << std::endl;
+            }
+            for (auto trans : module.trans()) {
+                oss
+                    << "trans "
+                    << trans
+                    << std::endl;
+            }
+
+            modules.push_back(oss.str());
+        }
+        std::sort(modules.begin(), modules.end());
+
+        /* INPUT vars are compiled as their current value */
+        env::Environment& env { env::Environment::INSTANCE() };
+        std::vector<std::string> inputs;
+        for (auto id : env.identifiers()) {
+            std::ostringstream oss;
+
+            oss
+                << "input "
+                << id
+                << " = "
+                << env.get(id);
+
+            inputs.push_back(oss.str());
+        }
+        std::sort(inputs.begin(), inputs.end());
+
+        std::ostringstream oss;
+        for (const auto& module : modules) {
+            oss << module;
+        }
+        for (const auto& input : inputs) {
+            oss
+                << input
+                << std::endl;
+        }
+
+        f_model_signature = oss.str();
+        return f_model_signature;
+    }
+
+    void UnitCache::collect_vars()
+    {
+        if (f_vars_ready) {
+            return;
+        }
+
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        symb::SymbIter symbols { model::ModelMgr::INSTANCE().model() };
+        while (symbols.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { symbols.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symbol { pair.second };
+
+            if (!symbol->is_variable() || symbol->as_variable().is_input()) {
+                continue;
+            }
+
+            expr::Expr_ptr full { em.make_dot(ctx, symbol->name()) };
+
+            std::ostringstream oss;
+            oss << full;
+
+            f_vars[oss.str()] = std::make_pair(full, symbol->as_variable().type());
+            f_var_names[full] = oss.str();
+        }
+
+        f_vars_ready = true;
+    }
+
+    boost::filesystem::path UnitCache::cachefile(expr::Expr_ptr ctx, expr::Expr_ptr body)
+    {
+        std::ostringstream oss;
+        oss
+            << unit_cache_magic
+            << std::endl
+            << "word-width "
+            << opts::OptsMgr::INSTANCE().word_width()
+            << std::endl
+            << "enum-encoding "
+            << opts::OptsMgr::INSTANCE().enum_encoding()
+            << std::endl
+            << "narrow-ranges "
+            << opts::OptsMgr::INSTANCE().narrow_ranges()
+            << std::endl
+            << model_signature()
+            << "expr "
+            << ctx
+            << " :: "
+            << body;
+
+        std::ostringstream name;
+        name
+            << std::hex
+            << std::setw(16)
+            << std::setfill('0')
+            << stable_hash(oss.str())
+            << unit_cache_ext;
+
+        return f_cachepath / name.str();
+    }
+
+    bool UnitCache::read(expr::Expr_ptr ctx, expr::Expr_ptr body, Entry& res)
+    {
+        boost::filesystem::path path { cachefile(ctx, body) };
+        std::ifstream is { path.c_str() };
+        if (!is) {
+            return false;
+        }
+
+        collect_vars();
+
+        /* the expr is stored in full, against hash collisions */
+        std::string line;
+        std::ostringstream key;
+        key
+            << "expr "
+            << ctx
+            << " :: "
+            << body;
+
+        if (!std::getline(is, line) || line != unit_cache_magic ||
+            !std::getline(is, line) || line != key.str()) {
+            return false;
+        }
+
+        std::string section;
+        unsigned n;
+
+        if (!(is >> section >> n) || section != "vars") {
+            return false;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            std::string kind;
+            Entry::Var var;
+
+            if (!(is >> kind >> var.time >> var.bitno)) {
+                return false;
+            }
+
+            if (kind == "v") {
+                std::string name;
+                std::getline(is >> std::ws, name);
+
+                VarsMap::const_iterator vi { f_vars.find(name) };
+                if (f_vars.end() == vi) {
+                    return false;
+                }
+
+                var.expr = vi->second.first;
+                var.type = vi->second.second;
+            } else if (kind == "t") {
+                var.expr = NULL;
+                var.type = NULL;
+            } else {
+                return false;
+            }
+
+            res.vars.push_back(var);
+        }
+
+        /* children first */
+        if (!(is >> section >> n) || section != "nodes") {
+            return false;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            std::string kind;
+            Entry::Node node { false, 0, 0, 0, 0 };
+
+            if (!(is >> kind)) {
+                return false;
+            }
+
+            if (kind == "c") {
+                node.constant = true;
+                if (!(is >> node.value)) {
+                    return false;
+                }
+            } else if (kind == "n") {
+                if (!(is >> node.var >> node.t >> node.e) ||
+                    res.vars.size() <= node.var || i <= node.t || i <= node.e) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+
+            res.nodes.push_back(node);
+        }
+
+        /* DDs and descriptors, as node ids */
+        std::ostringstream tail;
+        tail << is.rdbuf();
+        res.tail = tail.str();
+        res.path = path.native();
+
+        return true;
+    }
+
+    bool UnitCache::load(const Entry& entry, expr::Expr_ptr expr,
+                         dd::DDVector& dds, InlinedOperatorDescriptors& iods,
+                         Expr2BinarySelectionDescriptorsMap& bsds,
+                         MultiwaySelectionDescriptors& msds)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        /* vars, as DD var indices */
+        std::vector<unsigned> vars;
+        for (const auto& var : entry.vars) {
+            enc::Encoding_ptr enc { NULL };
+
+            if (var.expr) {
+                expr::TimedExpr timed { var.expr, var.time };
+                enc = f_enc.find_encoding(timed);
+                if (!enc) {
+                    enc = f_enc.make_var_encoding(var.expr, var.type);
+                    f_enc.register_encoding(timed, enc);
+                }
+            } else {
+                enc = f_enc.make_encoding(tm.find_boolean());
+                f_enc.register_encoding(expr::TimedExpr(em.make_dot(em.make_empty(),
+                                                                    f_owner.make_auto_id()),
+                                                        var.time),
+                                        enc);
+            }
+
+            if (enc->bits().size() <= var.bitno) {
+                return false;
+            }
+
+            vars.push_back(enc->bits()[var.bitno].getNode()->index);
+        }
+
+        /* DDs are built on the manager of the owner */
+        Cudd& dd { f_owner.dd() };
+        std::vector<ADD> nodes;
+        for (const auto& node : entry.nodes) {
+            nodes.push_back(node.constant
+                                ? dd.constant(node.value)
+                                : dd.addVar(vars[node.var]).Ite(nodes[node.t], nodes[node.e]));
+        }
+
+        std::istringstream is { entry.tail };
+        std::string section;
+        unsigned n;
+
+        if (!(is >> section) || section != "dds" || !read_dds(is, nodes, dds)) {
+            return false;
+        }
+
+        if (!(is >> section >> n) || section != "iods") {
+            return false;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            bool is_signed;
+            int optype;
+            unsigned width;
+            dd::DDVector z, x, y;
+
+            if (!(is >> is_signed >> optype >> width) ||
+                !read_dds(is, nodes, z) || !read_dds(is, nodes, x) || !read_dds(is, nodes, y)) {
+                return false;
+            }
+
+            InlinedOperatorSignature ios {
+                make_ios(is_signed, (expr::ExprType) optype, width)
+            };
+            if (y.empty()) {
+                iods.push_back(InlinedOperatorDescriptor(ios, z, x));
+            } else {
+                iods.push_back(InlinedOperatorDescriptor(ios, z, x, y));
+            }
+        }
+
+        if (!(is >> section >> n) || section != "bsds") {
+            return false;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            unsigned width;
+            dd::DDVector z, cnd, aux, x, y;
+
+            if (!(is >> width) ||
+                !read_dds(is, nodes, z) || !read_dds(is, nodes, cnd) || 1 != cnd.size() ||
+                !read_dds(is, nodes, aux) || 1 != aux.size() ||
+                !read_dds(is, nodes, x) || !read_dds(is, nodes, y)) {
+                return false;
+            }
+
+            bsds[expr].push_back(BinarySelectionDescriptor(width, z, cnd[0], aux[0], x, y));
+        }
+
+        if (!(is >> section >> n) || section != "msds") {
+            return false;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            unsigned elem_width, elem_count;
+            dd::DDVector z, cnds, acts, x, index;
+
+            if (!(is >> elem_width >> elem_count) ||
+                !read_dds(is, nodes, z) || !read_dds(is, nodes, cnds) ||
+                !read_dds(is, nodes, acts) || !read_dds(is, nodes, x) ||
+                !read_dds(is, nodes, index)) {
+                return false;
+            }
+
+            msds.push_back(MultiwaySelectionDescriptor(elem_width, elem_count,
+                                                       z, cnds, acts, x, index));
+        }
+
+        const std::string& path { entry.path };
+        DEBUG
+            << "Loaded compiled unit for "
+            << expr
+            << " from "
+            << path
+            << std::endl;
+
+        return true;
+    }
+
+    void UnitCache::store(expr::Expr_ptr ctx, expr::Expr_ptr body, const Unit& unit)
+    {
+        collect_vars();
+
+        UnitWriter writer { f_enc, f_var_names };
+        std::ostringstream oss;
+
+        oss << "dds ";
+        writer.dds(oss, unit.dds());
+        oss << std::endl;
+
+        oss
+            << "iods "
+            << unit.inlined_operator_descriptors().size()
+            << std::endl;
+        for (const auto& iod : unit.inlined_operator_descriptors()) {
+            const InlinedOperatorSignature& ios { iod.ios() };
+
+            oss
+                << ios_issigned(ios)
+                << " "
+                << (int) ios_optype(ios)
+                << " "
+                << ios_width(ios)
+                << " ";
+            writer.dds(oss, iod.z());
+            oss << " ";
+            writer.dds(oss, iod.x());
+            oss << " ";
+            writer.dds(oss, iod.y());
+            oss << std::endl;
+        }
+
+        BinarySelectionDescriptors bsds;
+        for (const auto& pair : unit.binary_selection_descriptors_map()) {
+            bsds.insert(bsds.end(), pair.second.begin(), pair.second.end());
+        }
+
+        oss
+            << "bsds "
+            << bsds.size()
+            << std::endl;
+        for (const auto& bsd : bsds) {
+            oss
+                << bsd.width()
+                << " ";
+            writer.dds(oss, bsd.z());
+            oss
+                << " 1 "
+                << writer.node(bsd.cnd().getNode())
+                << " 1 "
+                << writer.node(bsd.aux().getNode())
+                << " ";
+            writer.dds(oss, bsd.x());
+            oss << " ";
+            writer.dds(oss, bsd.y());
+            oss << std::endl;
+        }
+
+        oss
+            << "msds "
+            << unit.array_mux_descriptors().size()
+            << std::endl;
+        for (const auto& md : unit.array_mux_descriptors()) {
+            oss
+                << md.elem_width()
+                << " "
+                << md.elem_count()
+                << " ";
+            writer.dds(oss, md.z());
+            oss << " ";
+            writer.dds(oss, md.cnds());
+            oss << " ";
+            writer.dds(oss, md.acts());
+            oss << " ";
+            writer.dds(oss, md.x());
+            oss << " ";
+            writer.dds(oss, md.index());
+            oss << std::endl;
+        }
+
+        boost::filesystem::path path { cachefile(ctx, body) };
+
+        /* written aside, then renamed: concurrent runs sharing the
+           cache never see partial entries */
+        std::ostringstream tmpname;
+        tmpname
+            << path.native()
+            << "."
+            << getpid();
+        boost::filesystem::path tmppath { tmpname.str() };
+
+        try {
+            create_directories(f_cachepath);
+
+            {
+                std::ofstream os { tmppath.c_str() };
+
+                os
+                    << unit_cache_magic
+                    << std::endl
+                    << "expr "
+                    << ctx
+                    << " :: "
+                    << body
+                    << std::endl;
+
+                os
+                    << "vars "
+                    << writer.f_vars.size()
+                    << std::endl;
+                for (const auto& var : writer.f_vars) {
+                    os
+                        << var
+                        << std::endl;
+                }
+
+                os
+                    << "nodes "
+                    << writer.f_nodes.size()
+                    << std::endl;
+                for (const auto& node : writer.f_nodes) {
+                    os
+                        << node
+                        << std::endl;
+                }
+
+                os << oss.str();
+
+                if (!os) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+
+            rename(tmppath, path);
+        } catch (const std::exception& e) {
+            /* not fatal, the unit is compiled again next time */
+            pconst_char what { e.what() };
+            WARN
+                << "Could not cache compiled unit: "
+                << what
+                << std::endl;
+
+            boost::system::error_code ec;
+            remove(tmppath, ec);
+        }
+    }
+
+} // namespace compiler
@@ -0,0 +1,134 @@
+/**
+ * @file cache.hh
+ * @brief Basic expressions compiler - On-disk compilation cache
+ *
+ * This header file contains the declarations required by the
+ * persistent cache of compilation units. Units are stored in a
+ * directory (--compile-cache), one file per compiled expression,
+ * named after a stable hash of the model, the word width, the
+ * environment and the expression itself. DD vars are stored by the
+ * name, time and bit number of their encodings, so that cached units
+ * can be loaded regardless of the order encodings are built in. Aux
+ * vars (e.g. ITE selectors) are built anew on loading.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILATION_CACHE_H
+#define COMPILATION_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include <compiler/typedefs.hh>
+
+#include <enc/enc_mgr.hh>
+
+#include <boost/filesystem.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace compiler {
+
+    class Compiler;
+
+    class UnitCache {
+    public:
+        UnitCache(Compiler& owner);
+        ~UnitCache();
+
+        /* false iff no cache directory was given */
+        inline bool enabled() const
+        {
+            return !f_cachepath.empty();
+        }
+
+        /* a cache entry, as read from disk */
+        struct Entry {
+            /* model vars, or aux vars if expr is NULL */
+            struct Var {
+                expr::Expr_ptr expr;
+                type::Type_ptr type;
+                step_t time;
+                unsigned bitno;
+            };
+            std::vector<Var> vars;
+
+            /* DD nodes, children first */
+            struct Node {
+                bool constant;
+                double value;
+                unsigned var;
+                unsigned t;
+                unsigned e;
+            };
+            std::vector<Node> nodes;
+
+            /* DDs and descriptors, made of nodes */
+            std::string tail;
+
+            std::string path;
+        };
+
+        /* true iff the entry for ctx :: body was found. No DD
+           operation is involved, the caller needs no DD lock */
+        bool read(expr::Expr_ptr ctx, expr::Expr_ptr body, Entry& res);
+
+        /* true iff the unit in entry could be built, its parts are
+         * loaded in the given containers (selection descriptors are
+         * all mapped to expr), on the DD manager of the owner.
+         * Corrupted entries are misses */
+        bool load(const Entry& entry, expr::Expr_ptr expr,
+                  dd::DDVector& dds, InlinedOperatorDescriptors& iods,
+                  Expr2BinarySelectionDescriptorsMap& bsds,
+                  MultiwaySelectionDescriptors& msds);
+
+        /* stores the unit for ctx :: body, failures are not fatal */
+        void store(expr::Expr_ptr ctx, expr::Expr_ptr body, const Unit& unit);
+
+    private:
+        /* one file per (model, word width, environment, expr) */
+        boost::filesystem::path cachefile(expr::Expr_ptr ctx, expr::Expr_ptr body);
+
+        /* printed model, built on first use. Symbols are sorted by
+           name, so that it does not depend on the order of the
+           symbol tables */
+        const std::string& model_signature();
+
+        /* full names of the model vars, built on first use */
+        void collect_vars();
+
+        Compiler& f_owner;
+        enc::EncodingMgr& f_enc;
+
+        boost::filesystem::path f_cachepath;
+
+        std::string f_model_signature;
+
+        typedef boost::unordered_map<std::string, std::pair<expr::Expr_ptr, type::Type_ptr>> VarsMap;
+        VarsMap f_vars;
+
+        typedef boost::unordered_map<expr::Expr_ptr, std::string> VarNamesMap;
+        VarNamesMap f_var_names;
+
+        bool f_vars_ready;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILATION_CACHE_H */
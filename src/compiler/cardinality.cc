@@ -0,0 +1,183 @@
+/**
+ * @file cardinality.cc
+ * @brief Expression compiler subsystem, counts of booleans compared
+ * to constants.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+#include <algorithm>
+
+#include <common/common.hh>
+
+#include <compiler.hh>
+#include <expr.hh>
+
+/* counters tracking more counts than this are not worth it, the
+   adders and comparators are used instead */
+static const unsigned cardinality_max_counts { 64 };
+
+namespace compiler {
+
+    /* c REL k, for the counts tracked */
+    static bool holds(expr::ExprType symb, value_t c, value_t k)
+    {
+        switch (symb) {
+            case expr::EQ:
+                return c == k;
+            case expr::NE:
+                return c != k;
+            case expr::LT:
+                return c < k;
+            case expr::LE:
+                return c <= k;
+            case expr::GT:
+                return c > k;
+            case expr::GE:
+                return c >= k;
+            default:
+                assert(false);
+        }
+
+        return false;
+    }
+
+    /* k REL x is x REL' k */
+    static expr::ExprType mirrored(expr::ExprType symb)
+    {
+        switch (symb) {
+            case expr::LT:
+                return expr::GT;
+            case expr::LE:
+                return expr::GE;
+            case expr::GT:
+                return expr::LT;
+            case expr::GE:
+                return expr::LE;
+            default:
+                return symb;
+        }
+    }
+
+    bool Compiler::cardinality_leaves(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                      expr::ExprVector& res)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (em.is_add(expr)) {
+            return cardinality_leaves(ctx, expr->lhs(), res) &&
+                   cardinality_leaves(ctx, expr->rhs(), res);
+        }
+
+        if (em.is_cast(expr) &&
+            f_owner.type(expr->rhs(), ctx)->is_boolean()) {
+            res.push_back(expr->rhs());
+            return true;
+        }
+
+        return false;
+    }
+
+    /* b_1 + .. + b_n REL k, each b_i a boolean cast to an algebraic,
+     * without adders nor comparators: counts[c] holds iff exactly c of
+     * the b_i seen so far do, and counts[s] iff at least s do, for
+     * s = min(n, k + 1). Each b_i takes every count one step up, or
+     * leaves it be. The result is the disjunction of the counts for
+     * which REL holds. The sum must not wrap around, i.e. n fits in the
+     * type of the sum, or its value would not be the count. */
+    bool Compiler::cardinality(const expr::Expr_ptr expr)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        if (COMPILING != f_status || !is_binary_algebraic(expr)) {
+            return false;
+        }
+
+        expr::Expr_ptr ctx { f_ctx_stack.back() };
+        expr::ExprType symb { expr->symb() };
+        expr::Expr_ptr sum { expr->lhs() };
+        expr::Expr_ptr konst { expr->rhs() };
+        if (em.is_constant(sum)) {
+            std::swap(sum, konst);
+            symb = mirrored(symb);
+        }
+
+        if (!em.is_constant(konst) || !em.is_add(sum)) {
+            return false;
+        }
+
+        expr::ExprVector leaves;
+        if (!cardinality_leaves(ctx, sum, leaves)) {
+            return false;
+        }
+
+        type::Type_ptr type { f_owner.type(sum, ctx) };
+        unsigned width { type->width() };
+        unsigned bits { type->is_signed_algebraic() ? width - 1 : width };
+        unsigned n { (unsigned) leaves.size() };
+        if (bits < 32 && (1ULL << bits) <= n) {
+            return false;
+        }
+
+        value_t k { konst->value() };
+        if (k < 0) {
+            return false;
+        }
+
+        unsigned s { (unsigned) std::min<value_t>(n, k + 1) };
+        if (cardinality_max_counts < s) {
+            return false;
+        }
+
+        dd::DDVector counts(s + 1, f_dd.addZero());
+        counts[0] = f_dd.addOne();
+        for (auto leaf : leaves) {
+            size_t depth { f_add_stack.size() };
+
+            f_recursion_stack.push(expr::activation_record(leaf));
+            walk();
+
+            assert(depth + 1 == f_add_stack.size());
+            (void) depth;
+
+            DROP_TYPE();
+            POP_DD(b);
+
+            ADD not_b { b.Cmpl() };
+            counts[s] = counts[s].Or(counts[s - 1].Times(b));
+            for (unsigned c = s - 1; 0 < c; --c) {
+                counts[c] = counts[c].Times(not_b).Or(counts[c - 1].Times(b));
+            }
+            counts[0] = counts[0].Times(not_b);
+        }
+
+        ADD res { f_dd.addZero() };
+        for (unsigned c = 0; c <= s; ++c) {
+            if (holds(symb, c, k)) {
+                res = res.Or(counts[c]);
+            }
+        }
+
+        PUSH_TYPE(tm.find_boolean());
+        PUSH_DD(res);
+
+        return true;
+    }
+
+} // namespace compiler
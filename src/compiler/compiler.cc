@@ -23,6 +23,11 @@
  **/
 
 #include <compiler.hh>
+#include <stats.hh>
+
+#include <dd/cudd_mgr.hh>
+
+#include <opts/opts_mgr.hh>
 
 #include <utils/logging.hh>
 
@@ -33,37 +38,108 @@ namespace compiler {
         return status = static_cast<EStatus>(1 + static_cast<int>(status));
     }
 
+    /* shared by all compilers, aux vars names are never reused */
+    std::atomic<unsigned> Compiler::f_temp_auto_index { 0 };
+
     Unit Compiler::process(expr::Expr_ptr ctx, expr::Expr_ptr body)
     {
         /* the compiler can be shared among multiple strategies running on multiple threads */
         boost::mutex::scoped_lock lock { f_process_mutex };
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
 
+        expr::Expr_ptr expr { em.make_dot(ctx, body) };
+
+        /* DDs are built on the manager of this compiler, compilers
+           working in parallel only serialize on encodings and on the
+           transfer of their results */
+        UnitCache::Entry entry;
+        bool cached { f_unit_cache.enabled() && f_unit_cache.read(ctx, body, entry) };
+
         f_status = READY;
+        f_memo_hits = 0;
+        f_memo_misses = 0;
+        f_reordering_time = f_dd.ReadReorderingTime();
+
+        UnitStats stats { expr };
 
         /* Pass 1: build encodings */
         build_encodings(ctx, body);
+        stats.lap(PASS_BUILD_ENCODINGS);
+
+        /* Compiled units are taken from the on-disk cache, if
+           available. Encodings are always built as above */
+        if (cached) {
+            clear_internals();
+
+            if (f_unit_cache.load(entry, expr, f_add_stack,
+                                  f_inlined_operator_descriptors, f_expr2bsd_map,
+                                  f_multiway_selection_descriptors)) {
+                stats.lap(PASS_CACHE_LOAD);
+                stats.disk_hit = true;
+                record_stats(stats);
+
+                return export_unit(expr);
+            }
+
+            stats.lap(PASS_CACHE_LOAD);
+        }
+
+        /* Word-level rewriting, the unit and the cache entry are
+           still keyed by the original body */
+        expr::Expr_ptr simplified { f_simplifier.process(body) };
+        stats.lap(PASS_SIMPLIFY);
 
         /* Pass 2: perform boolean compilation using DDs */
-        compile(ctx, body);
+        compile(ctx, simplified);
+        stats.lap(PASS_COMPILE);
 
         /* Pass 3: checking internal structures */
-        check_internals(ctx, body);
+        check_internals(ctx, simplified);
+        stats.lap(PASS_CHECK_INTERNALS);
 
         /* Pass 4: ITE MUXes, for each descriptor, we need to conjunct `! AND (
            prev_conditions ) AND cnd <-> aux` to the original formula. */
-        activate_ite_muxes(ctx, body);
+        activate_ite_muxes(ctx, simplified);
+        stats.lap(PASS_ACTIVATE_ITE_MUXES);
 
         /* Pass 5: Array MUXes, for each descriptor, push a conjunct `cnd_i <-> act_i, i in
            [0..n_elems[` to the original formula. */
-        activate_array_muxes(ctx, body);
+        activate_array_muxes(ctx, simplified);
+        stats.lap(PASS_ACTIVATE_ARRAY_MUXES);
+
+        if (f_aig_backend) {
+            aig_prune();
+        }
+        record_stats(stats);
+
+        /* AIG nodes are not stored on disk */
+        if (f_unit_cache.enabled() && f_aig_descriptors.empty()) {
+            Unit unit { expr, f_add_stack, f_inlined_operator_descriptors,
+                        f_expr2bsd_map, f_multiway_selection_descriptors,
+                        f_aig_descriptors };
+            f_unit_cache.store(ctx, body, unit);
+        }
+
+        return export_unit(expr);
+    }
 
-        return Unit(em.make_dot(ctx, body), f_add_stack, f_inlined_operator_descriptors,
-                    f_expr2bsd_map, f_multiway_selection_descriptors);
+    void Compiler::record_stats(UnitStats& stats)
+    {
+        stats.memo_hits = f_memo_hits;
+        stats.memo_misses = f_memo_misses;
+        stats.reordering_secs = 1e-3 * (f_dd.ReadReorderingTime() - f_reordering_time);
+
+        for (const auto& dd : f_add_stack) {
+            stats.dd_nodes += dd.nodeCount();
+        }
+
+        CompilerStatsMgr::INSTANCE().record(stats);
     }
 
     Compiler::Compiler()
-        : f_compilation_cache()
+        : f_dd(dd::CuddMgr::INSTANCE().dd())
+        , f_imported_encodings()
+        , f_compilation_cache()
         , f_inlined_operator_descriptors()
         , f_expr2bsd_map()
         , f_bsuf_map()
@@ -73,9 +149,17 @@ namespace compiler {
         , f_time_stack()
         , f_owner(model::ModelMgr::INSTANCE())
         , f_enc(enc::EncodingMgr::INSTANCE())
+        , f_aig(AigMgr::INSTANCE())
         , f_preprocessor()
-        , f_temp_auto_index(0)
+        , f_simplifier()
+        , f_aig_backend("aig" == opts::OptsMgr::INSTANCE().compiler_backend())
+        , f_array_encoding(opts::OptsMgr::INSTANCE().array_encoding())
+        , f_static_order(opts::OptsMgr::INSTANCE().dd_static_order())
         , f_status(READY)
+        , f_unit_cache(*this)
+        , f_memo_hits(0)
+        , f_memo_misses(0)
+        , f_reordering_time(0)
     {
         const void* instance { this };
         DRIVEL
@@ -86,6 +170,12 @@ namespace compiler {
 
     Compiler::~Compiler()
     {
+        clear_internals();
+        f_compilation_cache.clear();
+        f_imported_encodings.clear();
+
+        dd::CuddMgr::INSTANCE().release(f_dd);
+
         const void* instance { this };
         DRIVEL
             << "Destroyed Compiler @"
@@ -47,20 +47,28 @@
  * to fully express those results at a later stage.
  */
 
+#include <atomic>
+
 #include <dd/dd.hh>
 #include <dd/dd_walker.hh>
 
-#include <expr/walker/walker.hh>
+#include <expr/walker/static_walker.hh>
 
 #include <type/type.hh>
 
 #include <enc/enc.hh>
+#include <dd/transfer.hh>
+
 #include <enc/enc_mgr.hh>
 
 #include <model/model.hh>
 #include <model/model_mgr.hh>
 
+#include <compiler/aig.hh>
+#include <compiler/cache.hh>
 #include <compiler/exceptions.hh>
+#include <compiler/simplifier.hh>
+#include <compiler/stats.hh>
 #include <compiler/typedefs.hh>
 #include <compiler/streamers.hh>
 
@@ -69,17 +77,30 @@
 
 #include <boost/thread/mutex.hpp>
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 namespace compiler {
 
-    class Compiler: public expr::ExprWalker {
+    class Compiler: public expr::StaticExprWalker<Compiler> {
+        /* hooks are dispatched statically, the walker is a hot spot */
+        friend class expr::StaticExprWalker<Compiler>;
+
     public:
         Compiler();
         virtual ~Compiler();
 
+        /* units are returned on the DD manager of the encodings */
         Unit process(expr::Expr_ptr ctx, expr::Expr_ptr body);
 
     private:
+        /* aux vars of cached units are built anew */
+        friend class UnitCache;
+
+        inline Cudd& dd() const
+        {
+            return f_dd;
+        }
+
         /**
           The compiler does NOT support LTL ops. To enable
           verification of temporal properties, the LTL operators needs to
@@ -91,6 +112,9 @@ namespace compiler {
         OP_HOOKS;
 
         void walk_instant(const expr::Expr_ptr expr);
+
+        /* AT over an interval, frame by frame (used by walk_at_preorder) */
+        void walk_interval_frames(const expr::Expr_ptr expr);
         void walk_leaf(const expr::Expr_ptr expr);
 
         /* push DDs and type information for variables (used by walk_leaf) */
@@ -161,6 +185,17 @@ namespace compiler {
         void array_equals(const expr::Expr_ptr expr);
         void array_ite(const expr::Expr_ptr expr);
 
+        /* a[i], on a non-constant index. Pushes the selected element,
+           the encoding depends on the size of the array */
+        void array_select(unsigned elem_width, unsigned elem_count,
+                          dd::DDVector& index, dd::DDVector& lhs);
+        void array_select_flat(unsigned elem_width, unsigned elem_count,
+                               dd::DDVector& index, dd::DDVector& lhs);
+        void array_select_tree(unsigned elem_width, unsigned elem_count,
+                               dd::DDVector& index, dd::DDVector& lhs);
+        void array_select_lazy(unsigned elem_width, unsigned elem_count,
+                               dd::DDVector& index, dd::DDVector& lhs);
+
         /* -- casts ------------------------------------------------------------- */
         void algebraic_cast_from_boolean(const expr::Expr_ptr expr);
         void boolean_cast_from_algebraic(const expr::Expr_ptr expr);
@@ -174,20 +209,56 @@ namespace compiler {
         void algebraic_relational(const expr::Expr_ptr expr);
         void algebraic_constant(expr::Expr_ptr expr, unsigned width);
 
+        /* sums of booleans compared to constants, as counters (no
+           adders, nor comparators), true iff the result was pushed */
+        bool cardinality(const expr::Expr_ptr expr);
+        bool cardinality_leaves(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                expr::ExprVector& res);
+
+        /* constant operand specializations (shifts, multiplications,
+         * trivial divisions), true iff res was built */
+        bool algebraic_constant_operand(expr::ExprType symb, bool signedness,
+                                        unsigned width, dd::DDVector& lhs,
+                                        dd::DDVector& rhs, dd::DDVector& res);
+        void algebraic_mul_by_constant(bool signedness, unsigned width,
+                                       dd::DDVector& x, uint64_t k,
+                                       dd::DDVector& res);
+
+        /* units are compiled on the DDs of this compiler, and
+           transferred to the DD manager of the encodings */
+        Unit export_unit(expr::Expr_ptr expr);
+
         /* cache management */
         void clear_internals();
         bool cache_miss(const expr::Expr_ptr expr);
         void memoize_result(const expr::Expr_ptr expr);
 
+        /* profiling */
+        void record_stats(UnitStats& stats);
+
         /* encoding management */
         enc::Encoding_ptr find_encoding(const expr::TimedExpr& timed_expr,
                                         const type::Type_ptr type);
 
+        /* static variable ordering (--dd-static-order) */
+        bool operand_var(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                         expr::Expr_ptr& full, step_t& time, type::Type_ptr& type);
+        void interleave_operands(const expr::Expr_ptr expr);
+        void sync_order();
+
         /* automatic inner variables (determinization, muxes, etc...) */
         expr::Expr_ptr make_auto_id();
         void make_auto_ddvect(dd::DDVector& dv, unsigned width);
         ADD make_auto_dd();
 
+        /* AIG backend (--compiler-backend=aig), 0-1 ADDs to AIG
+           literals and back. AND nodes are represented by auto DD
+           vars */
+        aig_lit_t aig_lit(ADD add);
+        ADD aig_dd(aig_lit_t lit);
+        void aig_define(const AigDescriptor& ad);
+        void aig_prune();
+
         void pre_hook();
         void post_hook();
 
@@ -205,6 +276,15 @@ namespace compiler {
 
         /* -- data -------------------------------------------------------------- */
 
+        /* DDs are built on a manager of this compiler, owned. It
+           comes first, DDs are released before it is */
+        Cudd& f_dd;
+
+        /* encoding DDs, transferred from the DD manager of the
+           encodings on first use */
+        typedef boost::unordered_map<enc::Encoding_ptr, dd::DDVector> ImportedEncodingsMap;
+        ImportedEncodingsMap f_imported_encodings;
+
         /* TimedExpr -> Compilation Unit cache */
         using CompilationMap = boost::unordered_map<expr::TimedExpr, Unit,
                                                     expr::TimedExprHash, expr::TimedExprEq>;
@@ -222,6 +302,10 @@ namespace compiler {
         /* Multiway selection (Arrays) descriptors */
         MultiwaySelectionDescriptors f_multiway_selection_descriptors;
 
+        /* AIG descriptors, and the AND nodes they define */
+        AigDescriptors f_aig_descriptors;
+        boost::unordered_set<unsigned> f_aig_defined;
+
         /* type checking */
         type::TypeVector f_type_stack;
 
@@ -237,18 +321,40 @@ namespace compiler {
         /* managers */
         model::ModelMgr& f_owner;
         enc::EncodingMgr& f_enc;
+        AigMgr& f_aig;
 
         /* owned */
         expr::preprocessor::Preprocessor f_preprocessor;
+        Simplifier f_simplifier;
 
         /* Auto expressions and DDs */
-        unsigned f_temp_auto_index;
+        static std::atomic<unsigned> f_temp_auto_index;
+
+        /* true iff boolean structure is compiled to AIGs */
+        bool f_aig_backend;
+
+        /* array subscripts encoding (--array-encoding) */
+        std::string f_array_encoding;
+
+        /* true iff related vars get interleaved encodings */
+        bool f_static_order;
 
         /* Compiler status (see above) */
         EStatus f_status;
 
         /* synchronization */
         boost::mutex f_process_mutex;
+
+        /* on-disk cache (--compile-cache) */
+        UnitCache f_unit_cache;
+
+        /* profiling, for the unit being processed */
+        unsigned long f_memo_hits;
+        unsigned long f_memo_misses;
+
+        /* reordering time of the DD manager (ms), when the unit
+           processing began */
+        long f_reordering_time;
     };
 
 } // namespace compiler
@@ -105,37 +105,7 @@ namespace compiler {
                 PUSH_DD(lhs[elem_width * subscript + elem_width - i - 1]);
             }
         } else {
-            /* Build selection DDs */
-            dd::DDVector cnd_dds;
-            dd::DDVector act_dds;
-            unsigned j_, j { 0 };
-            do {
-                unsigned i;
-                ADD cnd { bm.one() };
-
-                i = 0;
-                j_ = j;
-                while (i < iwidth) {
-                    ADD bit { (j_ & 1) ? bm.one() : bm.zero() };
-                    unsigned ndx { iwidth - i - 1 };
-                    j_ >>= 1;
-
-                    cnd *= index[ndx].Xnor(bit);
-                    ++i;
-                }
-
-                cnd_dds.push_back(cnd);
-                act_dds.push_back(make_auto_dd());
-            } while (++j < elem_count);
-
-            /* Push MUX output DD vector */
-            FRESH_DV(dv, elem_width);
-            PUSH_DV(dv, elem_width);
-
-            MultiwaySelectionDescriptor msd {
-                elem_width, elem_count, dv, cnd_dds, act_dds, lhs
-            };
-            f_multiway_selection_descriptors.push_back(msd);
+            array_select(elem_width, elem_count, index, lhs);
         }
     }
 
@@ -53,4 +53,9 @@ namespace compiler {
                             format_unexpected_expression(expr))
     {}
 
+    UnsupportedLowering::UnsupportedLowering(expr::Expr_ptr expr)
+        : CompilerException("UnsupportedLowering",
+                            format_unexpected_expression(expr))
+    {}
+
 } // namespace compiler
@@ -52,6 +52,12 @@ namespace compiler {
         UnexpectedExpression(expr::Expr_ptr expr);
     };
 
+    /** Raised when an expr has no word-level SMT counterpart */
+    class UnsupportedLowering: public CompilerException {
+    public:
+        UnsupportedLowering(expr::Expr_ptr expr);
+    };
+
 } // namespace compiler
 
 #endif /* COMPILER_EXCEPTIONS_H */
@@ -23,8 +23,15 @@
 
 #include <compiler.hh>
 
+#include <symb/classes.hh>
+#include <symb/proxy.hh>
+
 #include <utils/logging.hh>
 
+/* ITE chains with more arms than this are activated by the aux var of
+   the arm before each one, rather than by its whole activation DD */
+static const unsigned ite_chain_linear_threshold { 8 };
+
 namespace compiler {
 
     /* auto id generator */
@@ -32,10 +39,7 @@ namespace compiler {
     {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
 
-        std::ostringstream oss;
-        oss << "__tmp" << f_temp_auto_index++;
-
-        return em.make_identifier(oss.str());
+        return em.make_identifier("__tmp" + std::to_string(f_temp_auto_index++));
     }
 
     /* build an auto fresh ADD variable and register its encoding */
@@ -57,14 +61,137 @@ namespace compiler {
         expr::TimedExpr key { em.make_dot(ctx, aid), time };
         f_enc.register_encoding(key, be);
 
+        /* the same DD var, on the manager of this compiler */
         dd::DDVector& bits { be->bits() };
-        return bits[0]; // just one
+        return f_dd.addVar(bits[0].getNode()->index); // just one
+    }
+
+    aig_lit_t Compiler::aig_lit(ADD add)
+    {
+        boost::unordered_map<DdNode*, aig_lit_t> lits;
+
+        /* post-order, children come first. ADDs have no complemented
+           arcs */
+        std::vector<std::pair<DdNode*, bool>> stack;
+        stack.push_back(std::make_pair(add.getNode(), false));
+
+        while (!stack.empty()) {
+            DdNode* node { stack.back().first };
+            bool expanded { stack.back().second };
+            stack.pop_back();
+
+            if (lits.end() != lits.find(node)) {
+                continue;
+            }
+
+            if (Cudd_IsConstant(node)) {
+                lits[node] = (0 == Cudd_V(node)) ? AIG_FALSE : AIG_TRUE;
+                continue;
+            }
+
+            if (!expanded) {
+                stack.push_back(std::make_pair(node, true));
+                stack.push_back(std::make_pair(Cudd_T(node), false));
+                stack.push_back(std::make_pair(Cudd_E(node), false));
+                continue;
+            }
+
+            /* auto DD vars representing AND nodes are not inputs */
+            int index { (int) node->index };
+            unsigned id;
+            aig_lit_t var {
+                f_aig.find_node(index, id) ? (aig_lit_t) id << 1 : f_aig.make_input(index)
+            };
+
+            lits[node] = f_aig.make_ite(var, lits.at(Cudd_T(node)), lits.at(Cudd_E(node)));
+        }
+
+        return lits.at(add.getNode());
+    }
+
+    ADD Compiler::aig_dd(aig_lit_t lit)
+    {
+        AigNode node { f_aig.node(aig_node(lit)) };
+
+        if (node.is_constant()) {
+            return aig_complemented(lit) ? f_dd.addOne() : f_dd.addZero();
+        }
+
+        ADD res;
+        if (node.is_input()) {
+            res = f_dd.addVar(node.index);
+        } else {
+            int index;
+            if (f_aig.find_index(aig_node(lit), index)) {
+                res = f_dd.addVar(index);
+            } else {
+                res = make_auto_dd();
+                f_aig.bind(aig_node(lit), res.getNode()->index);
+            }
+
+            aig_define(AigDescriptor(res, aig_node(lit) << 1));
+        }
+
+        return aig_complemented(lit) ? res.Cmpl() : res;
+    }
+
+    void Compiler::aig_define(const AigDescriptor& ad)
+    {
+        if (f_aig_defined.insert(aig_node(ad.root())).second) {
+            f_aig_descriptors.push_back(ad);
+        }
+    }
+
+    /* drops the descriptors of AND nodes the unit does not refer to
+       (e.g. inner nodes of a conjunction) */
+    void Compiler::aig_prune()
+    {
+        boost::unordered_set<int> used;
+        auto collect = [&used](const dd::DDVector& v) {
+            for (const auto& dd : v) {
+                for (auto index : dd.SupportIndices()) {
+                    used.insert(index);
+                }
+            }
+        };
+
+        collect(f_add_stack);
+        for (const auto& iod : f_inlined_operator_descriptors) {
+            collect(iod.z());
+            collect(iod.x());
+            collect(iod.y());
+        }
+        for (const auto& pair : f_expr2bsd_map) {
+            for (const auto& bsd : pair.second) {
+                collect(bsd.z());
+                collect(bsd.x());
+                collect(bsd.y());
+                collect(dd::DDVector { bsd.cnd(), bsd.aux() });
+            }
+        }
+        for (const auto& msd : f_multiway_selection_descriptors) {
+            collect(msd.z());
+            collect(msd.cnds());
+            collect(msd.acts());
+            collect(msd.x());
+            collect(msd.index());
+        }
+
+        AigDescriptors kept;
+        for (const auto& ad : f_aig_descriptors) {
+            if (used.end() != used.find(ad.z().getNode()->index)) {
+                kept.push_back(ad);
+            }
+        }
+
+        f_aig_descriptors = kept;
     }
 
     /* build an auto DD vector of fresh ADD variables. */
     void Compiler::make_auto_ddvect(dd::DDVector& dv, unsigned width)
     {
         assert(0 == dv.size());
+        dv.reserve(width);
         for (unsigned i = 0; i < width; ++i) {
             dv.push_back(make_auto_dd());
         }
@@ -83,6 +210,12 @@ namespace compiler {
             DRIVEL
                 << "(encoding) " << key << "..."
                 << std::endl;
+
+            /* before the operands get encoded */
+            if (f_static_order &&
+                (em.is_binary_relational(expr) || em.is_binary_arithmetical(expr))) {
+                interleave_operands(expr);
+            }
         }
 
         else if (f_status == COMPILING) {
@@ -169,7 +302,8 @@ namespace compiler {
                 std::pair<expr::TimedExpr, Unit>(
                     key,
                     Unit(timedExpression, dv, f_inlined_operator_descriptors,
-                         f_expr2bsd_map, f_multiway_selection_descriptors)));
+                         f_expr2bsd_map, f_multiway_selection_descriptors,
+                         f_aig_descriptors)));
 
             return;
         }
@@ -248,23 +382,143 @@ namespace compiler {
                 }
             }
 
+            /* push cached AIG descriptors */
+            {
+                const AigDescriptors& vec {
+                    unit.aig_descriptors()
+                };
+
+                AigDescriptors::const_iterator i;
+                for (i = vec.begin(); vec.end() != i; ++i) {
+                    aig_define(*i);
+                }
+            }
+
             /* push cached type */
             PUSH_TYPE(type);
 
             /* cache hit */
+            ++f_memo_hits;
             return false;
         }
 
         /* cache miss */
+        ++f_memo_misses;
         return true;
     }
 
+    /* @a..b{phi} is the conjunction of phi at each frame. The body is
+       compiled once per frame, no conjunction of timed exprs is built */
+    void Compiler::walk_interval_frames(const expr::Expr_ptr expr)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        expr::Expr_ptr interval { expr->lhs() };
+        expr::Expr_ptr body { expr->rhs() };
+
+        expr::Expr_ptr a { interval->lhs() };
+        expr::Expr_ptr b { interval->rhs() };
+        if (!em.is_instant(a) || !em.is_instant(b)) {
+            throw UnexpectedExpression(expr);
+        }
+
+        step_t va { (step_t) a->value() };
+        step_t vb { (step_t) b->value() };
+
+        step_t begin { va <= vb ? va : vb };
+        step_t end { vb <= va ? va : vb };
+
+        /* timed exprs leave their frames on the stack when building
+           encodings, restore the depth instead of popping */
+        size_t depth { f_time_stack.size() };
+        for (step_t k = begin; k <= end; ++k) {
+            PUSH_TIME(k);
+            (*this)(body);
+            f_time_stack.resize(depth);
+
+            if (ENCODING == f_status) {
+                continue;
+            }
+
+            TOP_TYPE(type);
+            if (!type->is_boolean()) {
+                throw UnexpectedExpression(expr);
+            }
+
+            if (begin != k) {
+                boolean_and(expr);
+            }
+        }
+    }
+
     void Compiler::pre_hook()
     {}
 
     void Compiler::post_hook()
     {}
 
+    Unit Compiler::export_unit(expr::Expr_ptr expr)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_enc.mutex() };
+
+        /* shared nodes are transferred once, within the unit */
+        dd::DDTransfer transfer { f_enc.dd() };
+
+        dd::DDVector dds { transfer(f_add_stack) };
+
+        InlinedOperatorDescriptors iods;
+        for (const auto& iod : f_inlined_operator_descriptors) {
+            dd::DDVector z { transfer(iod.z()) };
+            dd::DDVector x { transfer(iod.x()) };
+
+            if (iod.y().empty()) {
+                iods.push_back(InlinedOperatorDescriptor(iod.ios(), z, x));
+            } else {
+                dd::DDVector y { transfer(iod.y()) };
+                iods.push_back(InlinedOperatorDescriptor(iod.ios(), z, x, y));
+            }
+        }
+
+        Expr2BinarySelectionDescriptorsMap bsds;
+        for (const auto& pair : f_expr2bsd_map) {
+            BinarySelectionDescriptors& descriptors { bsds[pair.first] };
+
+            for (const auto& bsd : pair.second) {
+                dd::DDVector z { transfer(bsd.z()) };
+                dd::DDVector x { transfer(bsd.x()) };
+                dd::DDVector y { transfer(bsd.y()) };
+
+                descriptors.push_back(BinarySelectionDescriptor(bsd.width(), z,
+                                                                transfer(bsd.cnd()),
+                                                                transfer(bsd.aux()), x, y));
+            }
+        }
+
+        MultiwaySelectionDescriptors msds;
+        for (const auto& msd : f_multiway_selection_descriptors) {
+            dd::DDVector z { transfer(msd.z()) };
+            dd::DDVector cnds { transfer(msd.cnds()) };
+            dd::DDVector acts { transfer(msd.acts()) };
+            dd::DDVector x { transfer(msd.x()) };
+
+            if (msd.is_lazy()) {
+                dd::DDVector index { transfer(msd.index()) };
+                msds.push_back(MultiwaySelectionDescriptor(msd.elem_width(), msd.elem_count(),
+                                                           z, cnds, acts, x, index));
+            } else {
+                msds.push_back(MultiwaySelectionDescriptor(msd.elem_width(), msd.elem_count(),
+                                                           z, cnds, acts, x));
+            }
+        }
+
+        AigDescriptors ads;
+        for (const auto& ad : f_aig_descriptors) {
+            ads.push_back(AigDescriptor(transfer(ad.z()), ad.root()));
+        }
+
+        return Unit(expr, dds, iods, bsds, msds, ads);
+    }
+
     void Compiler::clear_internals()
     {
         f_add_stack.clear();
@@ -276,6 +530,9 @@ namespace compiler {
         f_expr2bsd_map.clear();
         f_multiway_selection_descriptors.clear();
         f_bsuf_map.clear();
+
+        f_aig_descriptors.clear();
+        f_aig_defined.clear();
     }
 
     void Compiler::build_encodings(expr::Expr_ptr ctx, expr::Expr_ptr body)
@@ -340,8 +597,8 @@ namespace compiler {
         assert(1 == f_ctx_stack.size());
         assert(1 == f_time_stack.size());
 
-        assert(res.FindMin().Equals(f_enc.zero()));
-        assert(res.FindMax().Equals(f_enc.one()));
+        assert(res.FindMin().Equals(f_dd.addZero()));
+        assert(res.FindMax().Equals(f_dd.addOne()));
     }
 
     void Compiler::activate_ite_muxes(expr::Expr_ptr ctx, expr::Expr_ptr body)
@@ -369,14 +626,21 @@ namespace compiler {
                 << toplevel << "`"
                 << std::endl;
 
-            ADD prev { f_enc.zero() };
+            /* each activation depends on the one before: as DDs,
+               activations grow with every previous condition. As the
+               aux vars are bound to the activations, long chains
+               refer to them instead, i.e. one small constraint per
+               arm */
+            bool linear { ite_chain_linear_threshold < descriptors.size() };
+
+            ADD prev { f_dd.addZero() };
 
             BinarySelectionDescriptors::const_reverse_iterator j;
             for (j = descriptors.rbegin(); descriptors.rend() != j; ++j) {
                 ADD act { prev.Cmpl().Times(j->cnd()) };
 
                 PUSH_DD(act.Xnor(j->aux()));
-                prev = act;
+                prev = linear ? j->aux() : act;
             }
         }
     }
@@ -428,7 +692,7 @@ namespace compiler {
                 << type << " for " << key
                 << std::endl;
 
-            res = f_enc.make_encoding(type);
+            res = f_enc.make_var_encoding(key.expr(), type);
             f_enc.register_encoding(key, res);
         }
 
@@ -436,4 +700,107 @@ namespace compiler {
         return res;
     }
 
+    /* plain vars, possibly under next, as encoding keys */
+    bool Compiler::operand_var(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                               expr::Expr_ptr& full, step_t& time,
+                               type::Type_ptr& type)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        while (em.is_next(expr)) {
+            expr = expr->lhs();
+            ++time;
+        }
+
+        if (!em.is_identifier(expr)) {
+            return false;
+        }
+
+        full = em.make_dot(ctx, expr);
+
+        symb::ResolverProxy resolver;
+        symb::Symbol_ptr symb { resolver.symbol(full) };
+        if (!symb || !symb->is_variable()) {
+            return false;
+        }
+
+        const symb::Variable& var { symb->as_variable() };
+        if (var.is_input()) {
+            return false;
+        }
+
+        if (var.is_frozen()) {
+            time = FROZEN;
+        }
+
+        type = var.type();
+        return true;
+    }
+
+    /* static variable ordering (--dd-static-order), same-typed
+       algebraic operands get interleaved encodings. Those already
+       built are never moved, the new one goes below */
+    void Compiler::interleave_operands(const expr::Expr_ptr expr)
+    {
+        TOP_CTX(ctx);
+        TOP_TIME(time);
+
+        expr::Expr_ptr lhs, rhs;
+        step_t lhs_time { time }, rhs_time { time };
+        type::Type_ptr lhs_type, rhs_type;
+
+        if (!operand_var(ctx, expr->lhs(), lhs, lhs_time, lhs_type) ||
+            !operand_var(ctx, expr->rhs(), rhs, rhs_time, rhs_type)) {
+            return;
+        }
+
+        if (lhs_type != rhs_type || !lhs_type->is_algebraic() ||
+            (lhs == rhs && lhs_time == rhs_time)) {
+            return;
+        }
+
+        expr::TimedExpr lhs_key { lhs, lhs_time };
+        expr::TimedExpr rhs_key { rhs, rhs_time };
+
+        enc::Encoding_ptr lhs_enc { f_enc.find_encoding(lhs_key) };
+        enc::Encoding_ptr rhs_enc { f_enc.find_encoding(rhs_key) };
+
+        if (lhs_enc && rhs_enc) {
+            return;
+        }
+
+        if (!rhs_enc) {
+            lhs_enc = find_encoding(lhs_key, lhs_type);
+            f_enc.register_encoding(rhs_key, f_enc.make_var_encoding(rhs, rhs_type, lhs_enc));
+        } else {
+            f_enc.register_encoding(lhs_key, f_enc.make_var_encoding(lhs, lhs_type, rhs_enc));
+        }
+    }
+
+    /* the variable order of the encodings is mirrored here
+       (--dd-static-order), each time new encodings are imported */
+    void Compiler::sync_order()
+    {
+        Cudd& dd { f_enc.dd() };
+
+        /* local vars are a subset of the global ones */
+        int size { dd.ReadSize() };
+        if (f_dd.ReadSize() < size) {
+            f_dd.addVar(size - 1);
+        }
+        assert(size == f_dd.ReadSize());
+
+        std::vector<int> permutation;
+        bool same { true };
+        for (int level = 0; level < size; ++level) {
+            int index { dd.ReadInvPerm(level) };
+            permutation.push_back(index);
+            same = same && index == f_dd.ReadInvPerm(level);
+        }
+
+        if (!same) {
+            f_dd.ShuffleHeap(&permutation[0]);
+        }
+    }
+
 } // namespace compiler
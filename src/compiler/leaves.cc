@@ -63,8 +63,8 @@ namespace compiler {
         if (em.is_true(expr) || em.is_false(expr)) {
             PUSH_TYPE(tm.find_boolean());
             PUSH_DD(em.is_true(expr)
-                        ? f_enc.one()
-                        : f_enc.zero());
+                        ? f_dd.addOne()
+                        : f_dd.addZero());
             return;
         }
 
@@ -91,7 +91,7 @@ namespace compiler {
             symb::Constant& konst { symb->as_const() };
 
             PUSH_TYPE(konst.type());
-            PUSH_DD(f_enc.constant(konst.value()));
+            PUSH_DD(f_dd.constant(konst.value()));
             return;
         }
 
@@ -119,7 +119,7 @@ namespace compiler {
             assert(NULL != eenc);
 
             PUSH_TYPE(type);
-            PUSH_DD(f_enc.constant(eenc->value(expr)));
+            PUSH_DD(f_dd.constant(eenc->value(expr)));
             return;
         }
 
@@ -188,7 +188,19 @@ namespace compiler {
     {
         assert(NULL != enc);
 
-        dd::DDVector& dds { enc->dv() };
+        ImportedEncodingsMap::const_iterator eye { f_imported_encodings.find(enc) };
+        if (f_imported_encodings.end() == eye) {
+            boost::recursive_mutex::scoped_lock lock { f_enc.mutex() };
+
+            dd::DDTransfer transfer { f_dd };
+            eye = f_imported_encodings.insert(std::make_pair(enc, transfer(enc->dv()))).first;
+
+            if (f_static_order) {
+                sync_order();
+            }
+        }
+
+        const dd::DDVector& dds { eye->second };
         auto width { dds.size() };
         assert(0 < width);
 
@@ -252,7 +264,7 @@ namespace compiler {
         }
 
         for (unsigned i = 0; i < width; ++i) {
-            ADD digit { f_enc.constant(value % base) };
+            ADD digit { f_dd.constant(value % base) };
 
             f_add_stack.push_back(digit);
             value /= base;
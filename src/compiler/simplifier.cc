@@ -0,0 +1,1074 @@
+/**
+ * @file simplifier.cc
+ * @brief Basic expressions compiler - Word-level simplifier
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cassert>
+
+#include <compiler/simplifier.hh>
+
+#include <model/model_mgr.hh>
+
+#include <symb/classes.hh>
+#include <symb/exceptions.hh>
+#include <symb/proxy.hh>
+
+#include <utils/logging.hh>
+
+namespace compiler {
+
+    Simplifier::Simplifier()
+        : f_em(expr::ExprMgr::INSTANCE())
+        , f_expr_stack()
+        , f_ctx(NULL)
+        , f_literals()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized Simplifier @"
+            << instance
+            << std::endl;
+    }
+
+    Simplifier::~Simplifier()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Destroyed Simplifier @"
+            << instance
+            << std::endl;
+    }
+
+    expr::Expr_ptr Simplifier::process(expr::Expr_ptr expr)
+    {
+        f_expr_stack.clear();
+
+        this->operator()(expr);
+
+        assert(1 == f_expr_stack.size());
+        expr::Expr_ptr res { f_expr_stack.back() };
+        f_expr_stack.pop_back();
+
+        if (res != expr) {
+            DEBUG
+                << "Simplified `"
+                << expr
+                << "` to `"
+                << res
+                << "`"
+                << std::endl;
+        }
+
+        return res;
+    }
+
+    expr::Expr_ptr Simplifier::specialize(expr::Expr_ptr ctx, expr::Expr_ptr expr)
+    {
+        f_ctx = ctx;
+        f_literals.clear();
+
+        expr::Expr_ptr res { process(expr) };
+
+        f_ctx = NULL;
+        f_literals.clear();
+
+        return res;
+    }
+
+    expr::Expr_ptr Simplifier::constant_actual(expr::Expr_ptr full)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+
+        symb::ResolverProxy resolver;
+        while (true) {
+            symb::Symbol_ptr symb;
+            try {
+                symb = resolver.symbol(full);
+            } catch (symb::UnresolvedSymbol& us) {
+                return NULL;
+            }
+
+            if (symb->is_literal()) {
+                return full->rhs();
+            }
+
+            if (!symb->is_parameter()) {
+                return NULL;
+            }
+
+            expr::Expr_ptr rewrite { mm.rewrite_parameter(full) };
+            expr::Expr_ptr actual { rewrite->rhs() };
+            if (em.is_constant(actual) ||
+                (em.is_neg(actual) && em.is_int_const(actual->lhs()))) {
+                return actual;
+            }
+
+            /* the actual is a parameter (or literal) in turn, or not
+               a constant at all */
+            if (!em.is_identifier(actual)) {
+                return NULL;
+            }
+
+            full = em.make_dot(rewrite->lhs(), actual);
+        }
+    }
+
+    void Simplifier::pre_hook()
+    {}
+    void Simplifier::post_hook()
+    {}
+
+    void Simplifier::pre_node_hook(expr::Expr_ptr expr)
+    {}
+    void Simplifier::post_node_hook(expr::Expr_ptr expr)
+    {}
+
+    bool Simplifier::walk_F_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    void Simplifier::walk_F_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_G_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    void Simplifier::walk_G_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_X_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    void Simplifier::walk_X_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_U_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_U_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_U_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_R_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_R_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_R_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_at_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_at_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_at_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_interval_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_interval_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_interval_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_next_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_next_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_unary(expr);
+    }
+
+    bool Simplifier::walk_neg_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_neg_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_unary(expr);
+    }
+
+    bool Simplifier::walk_not_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_not_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_unary(expr);
+    }
+
+    bool Simplifier::walk_bw_not_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_bw_not_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_unary(expr);
+    }
+
+    bool Simplifier::walk_add_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_add_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_add_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_sub_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_sub_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_sub_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_div_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_div_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_div_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_mod_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_mod_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_mod_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_mul_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_mul_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_mul_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_and_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_and_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_and_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_or_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_or_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_or_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_bw_and_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_bw_and_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_bw_and_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_bw_or_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_bw_or_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_bw_or_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_bw_xor_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_bw_xor_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_bw_xor_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_implies_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_implies_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_implies_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_guard_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_guard_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_guard_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_bw_xnor_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_bw_xnor_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_bw_xnor_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_lshift_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_lshift_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_lshift_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_rshift_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_rshift_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_rshift_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_type_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_type_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_type_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_cast_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_cast_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_cast_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_assignment_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_assignment_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_assignment_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_eq_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_eq_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_eq_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_ne_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_ne_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_ne_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_le_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_le_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_le_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_lt_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_lt_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_lt_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_ge_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_ge_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_ge_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_gt_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_gt_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_gt_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_ite_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_ite_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_ite_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_cond_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_cond_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_cond_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_dot_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_dot_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_dot_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_params_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_params_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_params_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_params_comma_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_params_comma_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_params_comma_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_subscript_preorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    bool Simplifier::walk_subscript_inorder(const expr::Expr_ptr expr)
+    {
+        return true;
+    }
+    void Simplifier::walk_subscript_postorder(const expr::Expr_ptr expr)
+    {
+        rebuild_binary(expr);
+    }
+
+    bool Simplifier::walk_set_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    void Simplifier::walk_set_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_set_comma_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_set_comma_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_set_comma_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_array_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    void Simplifier::walk_array_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    bool Simplifier::walk_array_comma_preorder(const expr::Expr_ptr expr)
+    {
+        return keep(expr);
+    }
+    bool Simplifier::walk_array_comma_inorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+        return false;
+    }
+    void Simplifier::walk_array_comma_postorder(const expr::Expr_ptr expr)
+    {
+        assert(false); /* unreachable */
+    }
+
+    void Simplifier::walk_instant(const expr::Expr_ptr expr)
+    {
+        f_expr_stack.push_back(expr);
+    }
+
+    void Simplifier::walk_leaf(const expr::Expr_ptr expr)
+    {
+        if (NULL != f_ctx && f_em.is_identifier(expr)) {
+            expr::Expr_ptr konst { constant_actual(f_em.make_dot(f_ctx, expr)) };
+
+            if (NULL != konst) {
+                if (f_em.is_identifier(konst)) {
+                    f_literals.insert(konst);
+                }
+
+                f_expr_stack.push_back(konst);
+                return;
+            }
+        }
+
+        f_expr_stack.push_back(expr);
+    }
+
+    bool Simplifier::keep(const expr::Expr_ptr expr)
+    {
+        f_expr_stack.push_back(expr);
+        return false;
+    }
+
+    void Simplifier::rebuild_unary(const expr::Expr_ptr expr)
+    {
+        expr::Expr_ptr lhs { f_expr_stack.back() };
+        f_expr_stack.pop_back();
+
+        f_expr_stack.push_back(simplify_unary(expr->symb(), lhs));
+    }
+
+    void Simplifier::rebuild_binary(const expr::Expr_ptr expr)
+    {
+        expr::Expr_ptr rhs { f_expr_stack.back() };
+        f_expr_stack.pop_back();
+
+        expr::Expr_ptr lhs { f_expr_stack.back() };
+        f_expr_stack.pop_back();
+
+        f_expr_stack.push_back(simplify_binary(expr->symb(), lhs, rhs));
+    }
+
+    expr::Expr_ptr Simplifier::simplify_unary(expr::ExprType symb, expr::Expr_ptr lhs)
+    {
+        switch (symb) {
+            case expr::NOT:
+                if (f_em.is_true(lhs)) {
+                    return f_em.make_false();
+                }
+                if (f_em.is_false(lhs)) {
+                    return f_em.make_true();
+                }
+
+                /* fallthrough */
+
+            case expr::NEG:
+            case expr::BW_NOT:
+                /* involutions */
+                if (symb == lhs->symb()) {
+                    return lhs->lhs();
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        return make(symb, lhs, NULL);
+    }
+
+    expr::Expr_ptr Simplifier::simplify_binary(expr::ExprType symb, expr::Expr_ptr lhs,
+                                               expr::Expr_ptr rhs)
+    {
+        auto is_int = [this](expr::Expr_ptr expr, value_t value) {
+            return f_em.is_int_const(expr) && value == expr->value();
+        };
+
+        bool konst { f_em.is_int_const(lhs) && f_em.is_int_const(rhs) };
+
+        /* booleans and enum literals, distinct values */
+        auto is_value = [this](expr::Expr_ptr expr) {
+            return f_em.is_bool_const(expr) || f_literals.end() != f_literals.find(expr);
+        };
+        bool distinct { lhs != rhs && is_value(lhs) && is_value(rhs) };
+
+        switch (symb) {
+            case expr::PLUS:
+                if (konst) {
+                    return f_em.make_const(lhs->value() + rhs->value());
+                }
+                if (is_int(lhs, 0)) {
+                    return rhs;
+                }
+                if (is_int(rhs, 0)) {
+                    return lhs;
+                }
+                break;
+
+            case expr::SUB:
+                /* negative constants are left to the compiler */
+                if (konst && rhs->value() <= lhs->value()) {
+                    return f_em.make_const(lhs->value() - rhs->value());
+                }
+                if (is_int(rhs, 0)) {
+                    return lhs;
+                }
+                if (lhs == rhs) {
+                    return f_em.make_zero();
+                }
+                break;
+
+            case expr::MUL:
+                if (konst) {
+                    return f_em.make_const(lhs->value() * rhs->value());
+                }
+                if (is_int(lhs, 0) || is_int(rhs, 0)) {
+                    return f_em.make_zero();
+                }
+                if (is_int(lhs, 1)) {
+                    return rhs;
+                }
+                if (is_int(rhs, 1)) {
+                    return lhs;
+                }
+                break;
+
+            case expr::DIV:
+                if (is_int(rhs, 1)) {
+                    return lhs;
+                }
+                break;
+
+            case expr::MOD:
+                if (is_int(rhs, 1)) {
+                    return f_em.make_zero();
+                }
+                break;
+
+            case expr::BW_AND:
+                if (is_int(lhs, 0) || is_int(rhs, 0)) {
+                    return f_em.make_zero();
+                }
+                if (lhs == rhs) {
+                    return lhs;
+                }
+                break;
+
+            case expr::BW_OR:
+                if (is_int(lhs, 0)) {
+                    return rhs;
+                }
+                if (is_int(rhs, 0)) {
+                    return lhs;
+                }
+                if (lhs == rhs) {
+                    return lhs;
+                }
+                break;
+
+            case expr::BW_XOR:
+                if (is_int(lhs, 0)) {
+                    return rhs;
+                }
+                if (is_int(rhs, 0)) {
+                    return lhs;
+                }
+                if (lhs == rhs) {
+                    return f_em.make_zero();
+                }
+                break;
+
+            case expr::LSHIFT:
+            case expr::RSHIFT:
+                if (is_int(rhs, 0)) {
+                    return lhs;
+                }
+                break;
+
+            case expr::AND:
+                if (f_em.is_false(lhs) || f_em.is_false(rhs)) {
+                    return f_em.make_false();
+                }
+                if (f_em.is_true(lhs)) {
+                    return rhs;
+                }
+                if (f_em.is_true(rhs) || lhs == rhs) {
+                    return lhs;
+                }
+                break;
+
+            case expr::OR:
+                if (f_em.is_true(lhs) || f_em.is_true(rhs)) {
+                    return f_em.make_true();
+                }
+                if (f_em.is_false(lhs)) {
+                    return rhs;
+                }
+                if (f_em.is_false(rhs) || lhs == rhs) {
+                    return lhs;
+                }
+                break;
+
+            case expr::IMPLIES:
+                if (f_em.is_false(lhs) || f_em.is_true(rhs) || lhs == rhs) {
+                    return f_em.make_true();
+                }
+                if (f_em.is_true(lhs)) {
+                    return rhs;
+                }
+                break;
+
+            case expr::EQ:
+            case expr::GE:
+            case expr::LE:
+                if (lhs == rhs) {
+                    return f_em.make_true();
+                }
+                if (expr::EQ == symb && konst) {
+                    return lhs->value() == rhs->value()
+                               ? f_em.make_true()
+                               : f_em.make_false();
+                }
+                if (expr::EQ == symb && distinct) {
+                    return f_em.make_false();
+                }
+                break;
+
+            case expr::NE:
+            case expr::GT:
+            case expr::LT:
+                if (lhs == rhs) {
+                    return f_em.make_false();
+                }
+                if (expr::NE == symb && konst) {
+                    return lhs->value() != rhs->value()
+                               ? f_em.make_true()
+                               : f_em.make_false();
+                }
+                if (expr::NE == symb && distinct) {
+                    return f_em.make_true();
+                }
+                break;
+
+            case expr::ITE:
+                /* lhs is (cnd ? then), rhs is the else */
+                if (expr::COND == lhs->symb()) {
+                    expr::Expr_ptr cnd { lhs->lhs() };
+                    expr::Expr_ptr then { lhs->rhs() };
+
+                    if (f_em.is_true(cnd) || then == rhs) {
+                        return then;
+                    }
+                    if (f_em.is_false(cnd)) {
+                        return rhs;
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        expr::Expr_ptr lifted { lift_next(symb, lhs, rhs) };
+        if (lifted) {
+            return lifted;
+        }
+
+        return make(symb, lhs, rhs);
+    }
+
+    expr::Expr_ptr Simplifier::lift_next(expr::ExprType symb, expr::Expr_ptr lhs,
+                                         expr::Expr_ptr rhs)
+    {
+        /* operands are in different time frames for these */
+        if (expr::SUBSCRIPT == symb) {
+            return NULL;
+        }
+
+        bool lhs_next { f_em.is_next(lhs) };
+        bool rhs_next { f_em.is_next(rhs) };
+
+        if (lhs_next && rhs_next) {
+            return f_em.make_next(simplify_binary(symb, lhs->lhs(), rhs->lhs()));
+        }
+
+        if (lhs_next && f_em.is_constant(rhs)) {
+            return f_em.make_next(simplify_binary(symb, lhs->lhs(), rhs));
+        }
+
+        if (rhs_next && f_em.is_constant(lhs)) {
+            return f_em.make_next(simplify_binary(symb, lhs, rhs->lhs()));
+        }
+
+        return NULL;
+    }
+
+    expr::Expr_ptr Simplifier::make(expr::ExprType symb, expr::Expr_ptr lhs,
+                                    expr::Expr_ptr rhs)
+    {
+        switch (symb) {
+            case expr::NEXT:
+                return f_em.make_next(lhs);
+            case expr::NEG:
+                return f_em.make_neg(lhs);
+            case expr::NOT:
+                return f_em.make_not(lhs);
+            case expr::BW_NOT:
+                return f_em.make_bw_not(lhs);
+            case expr::PLUS:
+                return f_em.make_add(lhs, rhs);
+            case expr::SUB:
+                return f_em.make_sub(lhs, rhs);
+            case expr::DIV:
+                return f_em.make_div(lhs, rhs);
+            case expr::MOD:
+                return f_em.make_mod(lhs, rhs);
+            case expr::MUL:
+                return f_em.make_mul(lhs, rhs);
+            case expr::AND:
+                return f_em.make_and(lhs, rhs);
+            case expr::OR:
+                return f_em.make_or(lhs, rhs);
+            case expr::BW_AND:
+                return f_em.make_bw_and(lhs, rhs);
+            case expr::BW_OR:
+                return f_em.make_bw_or(lhs, rhs);
+            case expr::BW_XOR:
+                return f_em.make_bw_xor(lhs, rhs);
+            case expr::BW_XNOR:
+                return f_em.make_bw_xnor(lhs, rhs);
+            case expr::IMPLIES:
+                return f_em.make_implies(lhs, rhs);
+            case expr::LSHIFT:
+                return f_em.make_lshift(lhs, rhs);
+            case expr::RSHIFT:
+                return f_em.make_rshift(lhs, rhs);
+            case expr::EQ:
+                return f_em.make_eq(lhs, rhs);
+            case expr::NE:
+                return f_em.make_ne(lhs, rhs);
+            case expr::LE:
+                return f_em.make_le(lhs, rhs);
+            case expr::LT:
+                return f_em.make_lt(lhs, rhs);
+            case expr::GE:
+                return f_em.make_ge(lhs, rhs);
+            case expr::GT:
+                return f_em.make_gt(lhs, rhs);
+            case expr::ITE:
+                return f_em.make_ite(lhs, rhs);
+            case expr::COND:
+                return f_em.make_cond(lhs, rhs);
+            case expr::SUBSCRIPT:
+                return f_em.make_subscript(lhs, rhs);
+
+            default:
+                assert(false); /* unreachable */
+                return NULL;
+        }
+    }
+
+} // namespace compiler
@@ -0,0 +1,116 @@
+/**
+ * @file simplifier.hh
+ * @brief Basic expressions compiler - Word-level simplifier
+ *
+ * This header file contains the declarations required by the
+ * word-level simplifier, which rewrites expressions before they are
+ * compiled. The rewrites only depend on the structure of the
+ * expressions, not on their types: constant folding, neutral and
+ * absorbing operands (e.g. `x + 0`, `x * 1`, `x & 0`), trivial
+ * relations (e.g. `x = x`), decided conditionals and shifts by zero.
+ * Operators whose operands are all in the next state are lifted
+ * (i.e. `next(x) + next(y)` becomes `next(x + y)`), so that equal
+ * subexpressions in different frames are compiled once.
+ *
+ * Bodies of module instances can also be specialized on the
+ * constants their parameters are bound to: the parameters are
+ * replaced by the constants before simplification, so that decided
+ * branches (e.g. of `case MODE = 0 : ...`) are pruned.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILATION_SIMPLIFIER_H
+#define COMPILATION_SIMPLIFIER_H
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+#include <expr/walker/walker.hh>
+
+#include <boost/unordered_set.hpp>
+
+namespace compiler {
+
+    class Simplifier: public expr::ExprWalker {
+    public:
+        Simplifier();
+        ~Simplifier();
+
+        expr::Expr_ptr process(expr::Expr_ptr expr);
+
+        /* expr in ctx, with the parameters bound to constants replaced
+           by them, and simplified. Comparisons of distinct enum
+           literals are decided as well */
+        expr::Expr_ptr specialize(expr::Expr_ptr ctx, expr::Expr_ptr expr);
+
+        /* the constant (an int or boolean constant, or an enum
+           literal) the parameter full is bound to, through the
+           parameters of the enclosing instances if need be. NULL if
+           full is not a parameter bound to a constant */
+        static expr::Expr_ptr constant_actual(expr::Expr_ptr full);
+
+    protected:
+        void pre_hook();
+        void post_hook();
+
+        void pre_node_hook(expr::Expr_ptr expr);
+        void post_node_hook(expr::Expr_ptr expr);
+
+        LTL_HOOKS;
+        OP_HOOKS;
+
+        void walk_instant(const expr::Expr_ptr expr);
+        void walk_leaf(const expr::Expr_ptr expr);
+
+    private:
+        /* expr is kept as it is, operands are not walked */
+        bool keep(const expr::Expr_ptr expr);
+
+        /* expr is rebuilt on its simplified operands */
+        void rebuild_unary(const expr::Expr_ptr expr);
+        void rebuild_binary(const expr::Expr_ptr expr);
+
+        expr::Expr_ptr simplify_unary(expr::ExprType symb, expr::Expr_ptr lhs);
+        expr::Expr_ptr simplify_binary(expr::ExprType symb, expr::Expr_ptr lhs,
+                                       expr::Expr_ptr rhs);
+
+        /* next(x) op next(y) -> next(x op y), constants are time
+           invariant. NULL if not applicable */
+        expr::Expr_ptr lift_next(expr::ExprType symb, expr::Expr_ptr lhs,
+                                 expr::Expr_ptr rhs);
+
+        /* rhs is NULL for unary operators */
+        expr::Expr_ptr make(expr::ExprType symb, expr::Expr_ptr lhs,
+                            expr::Expr_ptr rhs);
+
+        expr::ExprMgr& f_em;
+
+        /* results stack */
+        expr::ExprVector f_expr_stack;
+
+        /* the context of the body being specialized, NULL otherwise */
+        expr::Expr_ptr f_ctx;
+
+        /* enum literals seen while specializing */
+        boost::unordered_set<expr::Expr_ptr> f_literals;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILATION_SIMPLIFIER_H */
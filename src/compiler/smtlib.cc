@@ -0,0 +1,721 @@
+/**
+ * @file smtlib.cc
+ * @brief Word-level lowering of exprs to SMT-LIB2 terms, implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <sstream>
+
+#include <compiler/smtlib.hh>
+
+#include <env/environment.hh>
+
+#include <model/model_mgr.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <sat/smt.hh>
+
+#include <symb/classes.hh>
+#include <symb/proxy.hh>
+
+#include <type/classes.hh>
+
+#include <utils/logging.hh>
+
+namespace compiler {
+
+    static inline unsigned long width_mask(unsigned width)
+    {
+        return width < 64 ? (1UL << width) - 1 : ~0UL;
+    }
+
+    static std::string bv_literal(unsigned long value, unsigned width)
+    {
+        std::ostringstream oss;
+        oss
+            << "(_ bv"
+            << (value & width_mask(width))
+            << " "
+            << width
+            << ")";
+
+        return oss.str();
+    }
+
+    static std::string sort(bool is_bool, unsigned width)
+    {
+        if (is_bool) {
+            return "Bool";
+        }
+
+        std::ostringstream oss;
+        oss
+            << "(_ BitVec "
+            << width
+            << ")";
+
+        return oss.str();
+    }
+
+    static std::string apply(const char* op, const std::string& x,
+                             const std::string& y = std::string())
+    {
+        std::string res { "(" };
+        res += op;
+        res += " " + x;
+        if (!y.empty()) {
+            res += " " + y;
+        }
+        res += ")";
+
+        return res;
+    }
+
+    SmtLowering::SmtLowering()
+        : f_em(expr::ExprMgr::INSTANCE())
+        , f_tm(type::TypeMgr::INSTANCE())
+        , f_preprocessor()
+        , f_preamble(NULL)
+    {}
+
+    SmtLowering::~SmtLowering()
+    {}
+
+    std::string SmtLowering::process(expr::Expr_ptr ctx, expr::Expr_ptr body, step_t time,
+                                     std::string& preamble)
+    {
+        f_preamble = &preamble;
+
+        Term term { lower(NULL != ctx ? ctx : f_em.make_empty(), body, time) };
+
+        f_preamble = NULL;
+        return as_bool(term, body);
+    }
+
+    void SmtLowering::var_consts(expr::Expr_ptr full, type::Type_ptr type, bool frozen,
+                                 step_t time, std::vector<std::string>& res,
+                                 std::string& preamble)
+    {
+        f_preamble = &preamble;
+
+        if (type->is_array()) {
+            type::ArrayType_ptr at { type->as_array() };
+            for (unsigned k = 0; k < at->nelems(); ++k) {
+                res.push_back(scalar_const(quoted(full, time, frozen, k), at->of()).text);
+            }
+        } else {
+            res.push_back(scalar_const(quoted(full, time, frozen), type).text);
+        }
+
+        f_preamble = NULL;
+    }
+
+    expr::Expr_ptr SmtLowering::decode(type::Type_ptr type, const std::string& value)
+    {
+        unsigned long v;
+        if (!sat::parse_smt_value(value, v)) {
+            return NULL;
+        }
+
+        if (type->is_boolean()) {
+            return v ? f_em.make_true() : f_em.make_false();
+        }
+
+        if (type->is_enum()) {
+            const expr::ExprSet& literals { type->as_enum()->literals() };
+            for (auto literal : literals) {
+                if (0 == v--) {
+                    return literal;
+                }
+            }
+
+            return NULL;
+        }
+
+        unsigned width { type->width() };
+        if (type->is_signed_algebraic() && 0 < width && width <= 64 &&
+            (v & (1UL << (width - 1)))) {
+            unsigned long cmpl { 1 + (~v & width_mask(width)) };
+            return f_em.make_neg(f_em.make_const((value_t) cmpl));
+        }
+
+        return f_em.make_const((value_t) v);
+    }
+
+    std::string SmtLowering::quoted(expr::Expr_ptr full, step_t time, bool frozen,
+                                    int element)
+    {
+        std::ostringstream oss;
+        oss
+            << "|"
+            << full;
+
+        if (0 <= element) {
+            oss
+                << "["
+                << element
+                << "]";
+        }
+
+        if (!frozen) {
+            oss
+                << "@"
+                << time;
+        }
+
+        oss
+            << "|";
+
+        return oss.str();
+    }
+
+    unsigned SmtLowering::sort_width(type::Type_ptr type)
+    {
+        if (type->is_enum()) {
+            unsigned n { (unsigned) type->as_enum()->literals().size() };
+
+            unsigned res { 1 };
+            while ((1UL << res) < n) {
+                ++res;
+            }
+
+            return res;
+        }
+
+        return type->width();
+    }
+
+    SmtLowering::Term SmtLowering::scalar_const(const std::string& name, type::Type_ptr type)
+    {
+        bool is_bool { type->is_boolean() };
+        if (!is_bool && !type->is_enum() && !type->is_signed_algebraic() &&
+            !type->is_unsigned_algebraic()) {
+            throw UnsupportedLowering(type->repr());
+        }
+
+        unsigned width { is_bool ? 0 : sort_width(type) };
+        if (f_declared.insert(name).second) {
+            assert(NULL != f_preamble);
+            *f_preamble += "(declare-const " + name + " " + sort(is_bool, width) + ")\n";
+
+            /* enums take the values of their literals only */
+            if (type->is_enum()) {
+                unsigned n { (unsigned) type->as_enum()->literals().size() };
+                if (n < (1UL << width)) {
+                    *f_preamble += "(assert (bvult " + name + " " + bv_literal(n, width) + "))\n";
+                }
+            }
+        }
+
+        Term res {
+            is_bool ? TERM_BOOL : TERM_BV, name, width,
+            type->is_signed_algebraic(), 0
+        };
+        return res;
+    }
+
+    std::string SmtLowering::as_bv(const Term& t, unsigned width)
+    {
+        if (TERM_CONST == t.kind) {
+            return bv_literal((unsigned long) t.value, width);
+        }
+
+        if (TERM_BOOL == t.kind) {
+            return "(ite " + t.text + " " + bv_literal(1, width) + " " + bv_literal(0, width) + ")";
+        }
+
+        if (t.width == width) {
+            return t.text;
+        }
+
+        std::ostringstream oss;
+        if (t.width < width) {
+            oss
+                << "((_ "
+                << (t.is_signed ? "sign_extend" : "zero_extend")
+                << " "
+                << width - t.width
+                << ") "
+                << t.text
+                << ")";
+        } else {
+            oss
+                << "((_ extract "
+                << width - 1
+                << " 0) "
+                << t.text
+                << ")";
+        }
+
+        return oss.str();
+    }
+
+    std::string SmtLowering::as_bool(const Term& t, expr::Expr_ptr expr)
+    {
+        if (TERM_BOOL != t.kind) {
+            throw UnsupportedLowering(expr);
+        }
+
+        return t.text;
+    }
+
+    SmtLowering::Term SmtLowering::lower(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                         step_t time)
+    {
+        expr::TimedExpr key { f_em.make_dot(ctx, expr), time };
+        auto eye { f_terms.find(key) };
+        if (f_terms.end() != eye) {
+            return eye->second;
+        }
+
+        Term res { TERM_BOOL, "", 0, false, 0 };
+        expr::ExprType symb { expr->symb() };
+
+        switch (symb) {
+            case expr::IDENT:
+            case expr::ICONST:
+            case expr::HCONST:
+            case expr::OCONST:
+            case expr::BCONST:
+                res = lower_leaf(ctx, expr, time);
+                break;
+
+            case expr::NEXT:
+                res = lower(ctx, expr->lhs(), time + 1);
+                break;
+
+            case expr::DOT:
+                res = lower(f_em.make_dot(ctx, expr->lhs()), expr->rhs(), time);
+                break;
+
+            case expr::PARAMS:
+                res = lower(ctx,
+                            model::ModelMgr::INSTANCE().expansion_cache().expand(
+                                f_preprocessor, expr, ctx),
+                            time);
+                break;
+
+            case expr::GUARD:
+                res = lower(ctx, f_em.make_implies(expr->lhs(), expr->rhs()), time);
+                break;
+
+            case expr::ASSIGNMENT:
+                res = lower(ctx, f_em.make_eq(f_em.make_next(expr->lhs()), expr->rhs()), time);
+                break;
+
+            case expr::SUBSCRIPT:
+                res = lower_subscript(ctx, expr, time);
+                break;
+
+            case expr::NOT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                res.text = apply("not", as_bool(x, expr));
+                break;
+            }
+
+            case expr::AND:
+            case expr::OR:
+            case expr::IMPLIES: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                const char* op { expr::AND == symb ? "and" : expr::OR == symb ? "or" : "=>" };
+                res.text = apply(op, as_bool(x, expr), as_bool(y, expr));
+                break;
+            }
+
+            case expr::ITE: {
+                expr::Expr_ptr cond { expr->lhs() };
+                if (!f_em.is_cond(cond)) {
+                    throw UnsupportedLowering(expr);
+                }
+
+                Term c { lower(ctx, cond->lhs(), time) };
+                Term x { lower(ctx, cond->rhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                if (TERM_BOOL == x.kind || TERM_BOOL == y.kind) {
+                    res.text = "(ite " + as_bool(c, expr) + " " + as_bool(x, expr) + " " +
+                               as_bool(y, expr) + ")";
+                    break;
+                }
+
+                if (TERM_CONST == x.kind && TERM_CONST == y.kind) {
+                    x.kind = TERM_BV;
+                    x.width = opts::OptsMgr::INSTANCE().word_width();
+                    x.text = as_bv(Term { TERM_CONST, "", 0, false, x.value }, x.width);
+                }
+
+                unsigned width { std::max(x.width, y.width) };
+                res.kind = TERM_BV;
+                res.width = width;
+                res.is_signed = x.is_signed || y.is_signed;
+                res.text = "(ite " + as_bool(c, expr) + " " + as_bv(x, width) + " " +
+                           as_bv(y, width) + ")";
+                break;
+            }
+
+            case expr::CAST: {
+                type::Type_ptr type { f_tm.find_type_by_def(expr->lhs()) };
+                if (!type->is_signed_algebraic() && !type->is_unsigned_algebraic()) {
+                    throw UnsupportedLowering(expr);
+                }
+
+                Term x { lower(ctx, expr->rhs(), time) };
+                res.kind = TERM_BV;
+                res.width = type->width();
+                res.is_signed = type->is_signed_algebraic();
+                res.text = as_bv(x, res.width);
+                break;
+            }
+
+            case expr::NEG:
+            case expr::BW_NOT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+
+                if (TERM_CONST == x.kind) {
+                    res = x;
+                    res.value = expr::NEG == symb ? -x.value : ~x.value;
+                    break;
+                }
+
+                if (TERM_BOOL == x.kind && expr::BW_NOT == symb) {
+                    res.text = apply("not", x.text);
+                    break;
+                }
+
+                res = x;
+                res.text = apply(expr::NEG == symb ? "bvneg" : "bvnot", as_bv(x, x.width));
+                break;
+            }
+
+            case expr::EQ:
+            case expr::NE:
+            case expr::GE:
+            case expr::GT:
+            case expr::LE:
+            case expr::LT:
+            case expr::PLUS:
+            case expr::SUB:
+            case expr::MUL:
+            case expr::DIV:
+            case expr::MOD:
+            case expr::BW_AND:
+            case expr::BW_OR:
+            case expr::BW_XOR:
+            case expr::BW_XNOR:
+            case expr::LSHIFT:
+            case expr::RSHIFT: {
+                Term x { lower(ctx, expr->lhs(), time) };
+                Term y { lower(ctx, expr->rhs(), time) };
+
+                bool relational { expr::EQ == symb || expr::NE == symb || expr::GE == symb ||
+                                  expr::GT == symb || expr::LE == symb || expr::LT == symb };
+
+                /* booleans */
+                if (TERM_BOOL == x.kind || TERM_BOOL == y.kind) {
+                    const char* op {
+                        expr::EQ == symb || expr::BW_XNOR == symb ? "=" :
+                        expr::NE == symb || expr::BW_XOR == symb  ? "distinct" :
+                        expr::BW_AND == symb                      ? "and" :
+                        expr::BW_OR == symb                        ? "or" :
+                                                                     NULL
+                    };
+                    if (NULL == op) {
+                        throw UnsupportedLowering(expr);
+                    }
+
+                    res.text = apply(op, as_bool(x, expr), as_bool(y, expr));
+                    break;
+                }
+
+                /* constants are folded, where it is safe to */
+                if (TERM_CONST == x.kind && TERM_CONST == y.kind && !relational) {
+                    value_t a { x.value };
+                    value_t b { y.value };
+
+                    bool folded { true };
+                    value_t value { 0 };
+                    switch (symb) {
+                        case expr::PLUS:
+                            value = a + b;
+                            break;
+                        case expr::SUB:
+                            value = a - b;
+                            break;
+                        case expr::MUL:
+                            value = a * b;
+                            break;
+                        case expr::BW_AND:
+                            value = a & b;
+                            break;
+                        case expr::BW_OR:
+                            value = a | b;
+                            break;
+                        case expr::BW_XOR:
+                            value = a ^ b;
+                            break;
+                        default:
+                            folded = false;
+                    }
+
+                    if (folded) {
+                        res = x;
+                        res.value = value;
+                        break;
+                    }
+                }
+
+                /* operands are extended to the largest width, signed
+                   if either one is */
+                unsigned width { std::max(x.width, y.width) };
+                if (0 == width) {
+                    width = opts::OptsMgr::INSTANCE().word_width();
+                }
+                bool is_signed { x.is_signed || y.is_signed };
+
+                /* shift amounts keep their own signedness */
+                if (expr::LSHIFT == symb || expr::RSHIFT == symb) {
+                    width = TERM_CONST == x.kind ? width : x.width;
+                    is_signed = x.is_signed;
+                }
+
+                const std::string a { as_bv(x, width) };
+                const std::string b { as_bv(y, width) };
+
+                const char* op { NULL };
+                switch (symb) {
+                    case expr::EQ:
+                        op = "=";
+                        break;
+                    case expr::NE:
+                        op = "distinct";
+                        break;
+                    case expr::GE:
+                        op = is_signed ? "bvsge" : "bvuge";
+                        break;
+                    case expr::GT:
+                        op = is_signed ? "bvsgt" : "bvugt";
+                        break;
+                    case expr::LE:
+                        op = is_signed ? "bvsle" : "bvule";
+                        break;
+                    case expr::LT:
+                        op = is_signed ? "bvslt" : "bvult";
+                        break;
+                    case expr::PLUS:
+                        op = "bvadd";
+                        break;
+                    case expr::SUB:
+                        op = "bvsub";
+                        break;
+                    case expr::MUL:
+                        op = "bvmul";
+                        break;
+                    case expr::DIV:
+                        op = is_signed ? "bvsdiv" : "bvudiv";
+                        break;
+                    case expr::MOD:
+                        op = is_signed ? "bvsrem" : "bvurem";
+                        break;
+                    case expr::BW_AND:
+                        op = "bvand";
+                        break;
+                    case expr::BW_OR:
+                        op = "bvor";
+                        break;
+                    case expr::BW_XOR:
+                        op = "bvxor";
+                        break;
+                    case expr::BW_XNOR:
+                        op = "bvxnor";
+                        break;
+                    case expr::LSHIFT:
+                        op = "bvshl";
+                        break;
+                    case expr::RSHIFT:
+                        op = is_signed ? "bvashr" : "bvlshr";
+                        break;
+                    default:
+                        assert(false); /* unreachable */
+                }
+
+                res.text = apply(op, a, b);
+                if (!relational) {
+                    res.kind = TERM_BV;
+                    res.width = width;
+                    res.is_signed = is_signed;
+                }
+                break;
+            }
+
+            default:
+                throw UnsupportedLowering(expr);
+        }
+
+        f_terms.insert(std::make_pair(key, res));
+        return res;
+    }
+
+    SmtLowering::Term SmtLowering::lower_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                              step_t time)
+    {
+        if (f_em.is_true(expr) || f_em.is_false(expr)) {
+            Term res { TERM_BOOL, f_em.is_true(expr) ? "true" : "false", 0, false, 0 };
+            return res;
+        }
+
+        if (f_em.is_int_const(expr)) {
+            Term res { TERM_CONST, "", 0, false, expr->value() };
+            return res;
+        }
+
+        expr::Expr_ptr full { f_em.make_dot(ctx, expr) };
+
+        symb::ResolverProxy resolver;
+        symb::Symbol_ptr symb { resolver.symbol(full) };
+
+        /* enum literals, by index */
+        if (symb->is_literal()) {
+            type::Type_ptr type { symb->as_literal().type() };
+            if (!type->is_enum()) {
+                throw UnsupportedLowering(expr);
+            }
+
+            unsigned width { sort_width(type) };
+            Term res {
+                TERM_BV, bv_literal(type->as_enum()->value(expr), width), width, false, 0
+            };
+            return res;
+        }
+
+        if (symb->is_variable()) {
+            const symb::Variable& var { symb->as_variable() };
+
+            /* INPUT vars are in fact bodyless, typed DEFINEs */
+            if (var.is_input()) {
+                return lower(ctx, env::Environment::INSTANCE().get(expr), time);
+            }
+
+            type::Type_ptr type { var.type() };
+            if (type->is_instance() || type->is_array()) {
+                throw UnsupportedLowering(expr);
+            }
+
+            return scalar_const(quoted(full, time, var.is_frozen()), type);
+        }
+
+        if (symb->is_parameter()) {
+            expr::Expr_ptr rewrite { model::ModelMgr::INSTANCE().rewrite_parameter(full) };
+            return lower(rewrite->lhs(), rewrite->rhs(), time);
+        }
+
+        /* DEFINEs, as functions of their own */
+        if (symb->is_define()) {
+            Term body { lower(ctx, symb->as_define().body(), time) };
+            if (TERM_CONST == body.kind) {
+                return body;
+            }
+
+            const std::string name { quoted(full, time, false) };
+            if (f_declared.insert(name).second) {
+                *f_preamble += "(define-fun " + name + " () " +
+                               sort(TERM_BOOL == body.kind, body.width) + " " +
+                               body.text + ")\n";
+            }
+
+            Term res { body };
+            res.text = name;
+            return res;
+        }
+
+        throw UnsupportedLowering(expr);
+    }
+
+    SmtLowering::Term SmtLowering::lower_subscript(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                                   step_t time)
+    {
+        /* the array var, possibly shifted in time and qualified */
+        expr::Expr_ptr base { expr->lhs() };
+        expr::Expr_ptr base_ctx { ctx };
+        step_t base_time { time };
+        while (f_em.is_next(base) || f_em.is_dot(base)) {
+            if (f_em.is_next(base)) {
+                ++base_time;
+                base = base->lhs();
+            } else {
+                base_ctx = f_em.make_dot(base_ctx, base->lhs());
+                base = base->rhs();
+            }
+        }
+
+        if (!f_em.is_identifier(base)) {
+            throw UnsupportedLowering(expr);
+        }
+
+        expr::Expr_ptr full { f_em.make_dot(base_ctx, base) };
+
+        symb::ResolverProxy resolver;
+        symb::Symbol_ptr symb { resolver.symbol(full) };
+        if (!symb->is_variable() || symb->as_variable().is_input() ||
+            !symb->as_variable().type()->is_array()) {
+            throw UnsupportedLowering(expr);
+        }
+
+        const symb::Variable& var { symb->as_variable() };
+        type::ArrayType_ptr at { var.type()->as_array() };
+
+        std::vector<Term> elements;
+        for (unsigned k = 0; k < at->nelems(); ++k) {
+            elements.push_back(scalar_const(quoted(full, base_time, var.is_frozen(), k), at->of()));
+        }
+
+        /* the index is in the original context and time */
+        Term index { lower(ctx, expr->rhs(), time) };
+        if (TERM_BOOL == index.kind) {
+            throw UnsupportedLowering(expr);
+        }
+
+        if (TERM_CONST == index.kind) {
+            if (index.value < 0 || (value_t) elements.size() <= index.value) {
+                throw UnsupportedLowering(expr);
+            }
+
+            return elements[index.value];
+        }
+
+        /* a selection chain, out of range indexes select the last
+           element */
+        Term res { elements.back() };
+        for (int k = (int) elements.size() - 2; 0 <= k; --k) {
+            if (index.width < 64 && (1UL << index.width) <= (unsigned long) k) {
+                continue;
+            }
+
+            res.text = "(ite (= " + index.text + " " + bv_literal(k, index.width) + ") " +
+                       elements[k].text + " " + res.text + ")";
+        }
+
+        return res;
+    }
+
+} // namespace compiler
@@ -0,0 +1,133 @@
+/**
+ * @file smtlib.hh
+ * @brief Word-level lowering of exprs to SMT-LIB2 terms
+ *
+ * This header file contains the declarations of the lowering of exprs
+ * to QF_BV terms, for the SMT solvers of sat/smt.hh. Unlike the DD
+ * compiler, no bit-blasting takes place: booleans are lowered to
+ * Bool terms, algebraics to bit-vectors of their width, enums to
+ * bit-vectors indexing their literals. Vars are lowered to a const
+ * for each time (frozen vars to a single one), arrays to a const per
+ * element. DEFINEs are lowered to a function of their own for each
+ * time, so that they are shared by all the terms using them.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILER_SMTLIB_H
+#define COMPILER_SMTLIB_H
+
+#include <string>
+#include <vector>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+#include <expr/time/timed_expr.hh>
+
+#include <compiler/exceptions.hh>
+
+#include <model/model_mgr.hh>
+
+#include <type/type_mgr.hh>
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+namespace compiler {
+
+    class SmtLowering {
+    public:
+        SmtLowering();
+        ~SmtLowering();
+
+        /* a Bool term for body, in ctx, at time. The declarations of
+         * the consts and functions it needs, which were not emitted
+         * before, are appended to preamble (along with the range
+         * constraints of enum consts). Throws UnsupportedLowering on
+         * exprs with no QF_BV counterpart here (e.g. whole arrays,
+         * temporal operators). */
+        std::string process(expr::Expr_ptr ctx, expr::Expr_ptr body, step_t time,
+                            std::string& preamble);
+
+        /* the consts of var (by fully qualified name, of the given
+           type, not an instance) at time, one per element for
+           arrays. Declarations are appended as above */
+        void var_consts(expr::Expr_ptr full, type::Type_ptr type, bool frozen,
+                        step_t time, std::vector<std::string>& res,
+                        std::string& preamble);
+
+        /* the value of a scalar const of type, from a value printed
+           by the solver. NULL if it can not be decoded */
+        expr::Expr_ptr decode(type::Type_ptr type, const std::string& value);
+
+    private:
+        typedef enum {
+            TERM_BOOL,
+            TERM_BV,
+            TERM_CONST, /* int constants, width is taken from the context */
+        } term_kind_t;
+
+        struct Term {
+            term_kind_t kind;
+            std::string text;
+            unsigned width;
+            bool is_signed;
+            value_t value;
+        };
+
+        Term lower(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+        Term lower_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+        Term lower_subscript(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t time);
+
+        /* a scalar const, declared on first use */
+        Term scalar_const(const std::string& name, type::Type_ptr type);
+
+        /* t as a bit-vector of width, extended (by its signedness)
+           or truncated */
+        std::string as_bv(const Term& t, unsigned width);
+
+        /* t as a Bool term */
+        std::string as_bool(const Term& t, expr::Expr_ptr expr);
+
+        /* the bits of the bit-vector sort for type */
+        unsigned sort_width(type::Type_ptr type);
+
+        static std::string quoted(expr::Expr_ptr full, step_t time, bool frozen,
+                                  int element = -1);
+
+        expr::ExprMgr& f_em;
+        type::TypeMgr& f_tm;
+
+        /* DEFINEs with params are expanded first */
+        expr::preprocessor::Preprocessor f_preprocessor;
+
+        std::string* f_preamble;
+
+        /* terms by timed fully qualified expr */
+        boost::unordered_map<expr::TimedExpr, Term,
+                             expr::TimedExprHash, expr::TimedExprEq>
+            f_terms;
+
+        /* consts and functions declared so far */
+        boost::unordered_set<std::string> f_declared;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILER_SMTLIB_H */
@@ -0,0 +1,353 @@
+/**
+ * @file stats.cc
+ * @brief Basic expressions compiler - Profiling statistics
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <compiler/stats.hh>
+
+#include <expr/collector.hh>
+#include <expr/expr_mgr.hh>
+#include <expr/rewrite_cache.hh>
+
+#include <jsoncpp/json/json.h>
+
+#include <utils/logging.hh>
+#include <utils/profile.hh>
+#include <utils/trace.hh>
+
+namespace compiler {
+
+    static const char* pass_names[] = {
+        "build-encodings",
+        "simplify",
+        "compile",
+        "check-internals",
+        "activate-ite-muxes",
+        "activate-array-muxes",
+        "cache-load",
+    };
+
+    static const char* rewrite_pass_names[] = {
+        "preprocess",
+        "nnf",
+        "expand",
+    };
+
+    static inline double elapsed(const struct timespec& t0, const struct timespec& t1)
+    {
+        return (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+    }
+
+    UnitStats::UnitStats(expr::Expr_ptr expr)
+        : expr(expr)
+        , memo_hits(0)
+        , memo_misses(0)
+        , disk_hit(false)
+        , dd_nodes(0)
+        , reordering_secs(0.0)
+    {
+        for (unsigned i = 0; i < N_PASSES; ++i) {
+            wall_secs[i] = 0.0;
+            cpu_secs[i] = 0.0;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &f_wall);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &f_cpu);
+    }
+
+    void UnitStats::lap(compiler_pass_t pass)
+    {
+        struct timespec wall, cpu;
+        clock_gettime(CLOCK_MONOTONIC, &wall);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+
+        wall_secs[pass] += elapsed(f_wall, wall);
+        cpu_secs[pass] += elapsed(f_cpu, cpu);
+
+        utils::EventTracer::INSTANCE()
+            .complete(pass_names[pass], "compile", f_wall, wall);
+
+        f_wall = wall;
+        f_cpu = cpu;
+    }
+
+    double UnitStats::total_wall_secs() const
+    {
+        double res { 0.0 };
+        for (unsigned i = 0; i < N_PASSES; ++i) {
+            res += wall_secs[i];
+        }
+
+        return res;
+    }
+
+    double UnitStats::total_cpu_secs() const
+    {
+        double res { 0.0 };
+        for (unsigned i = 0; i < N_PASSES; ++i) {
+            res += cpu_secs[i];
+        }
+
+        return res;
+    }
+
+    CompilerStatsMgr::CompilerStatsMgr()
+    {
+        const void* instance { this };
+        DRIVEL
+            << "Initialized CompilerStatsMgr @"
+            << instance
+            << std::endl;
+
+        /* units are reported by expr, until the stats are cleared */
+        expr::ExprCollector::INSTANCE().add_roots(
+            "compiler stats", [this](expr::ExprMarker& marker) {
+                boost::mutex::scoped_lock lock { f_mutex };
+
+                for (const auto& stats : f_units) {
+                    marker.mark(stats.expr);
+                }
+            });
+    }
+
+    CompilerStatsMgr::~CompilerStatsMgr()
+    {
+        TRACE
+            << "Destroyed CompilerStatsMgr"
+            << std::endl;
+    }
+
+    void CompilerStatsMgr::record(const UnitStats& stats)
+    {
+        /* passes are also reported to the profiler, e.g. by `time` */
+        utils::Profiler& profiler { utils::Profiler::INSTANCE() };
+        if (profiler.enabled()) {
+            for (unsigned i = 0; i < N_PASSES; ++i) {
+                if (0.0 < stats.wall_secs[i]) {
+                    profiler.charge(std::string("compile (") + pass_names[i] + ")",
+                                    stats.wall_secs[i], stats.cpu_secs[i]);
+                }
+            }
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_units.push_back(stats);
+    }
+
+    void CompilerStatsMgr::clear()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_units.clear();
+    }
+
+    void CompilerStatsMgr::report(std::ostream& os, bool json, unsigned top)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        double wall[N_PASSES];
+        double cpu[N_PASSES];
+        for (unsigned i = 0; i < N_PASSES; ++i) {
+            wall[i] = 0.0;
+            cpu[i] = 0.0;
+        }
+
+        unsigned long memo_hits { 0 };
+        unsigned long memo_misses { 0 };
+        unsigned long disk_hits { 0 };
+        unsigned long dd_nodes { 0 };
+        double reordering_secs { 0.0 };
+
+        for (const auto& unit : f_units) {
+            for (unsigned i = 0; i < N_PASSES; ++i) {
+                wall[i] += unit.wall_secs[i];
+                cpu[i] += unit.cpu_secs[i];
+            }
+
+            memo_hits += unit.memo_hits;
+            memo_misses += unit.memo_misses;
+            disk_hits += unit.disk_hit ? 1 : 0;
+            dd_nodes += unit.dd_nodes;
+            reordering_secs += unit.reordering_secs;
+        }
+
+        /* most expensive units first */
+        std::vector<const UnitStats*> units;
+        for (const auto& unit : f_units) {
+            units.push_back(&unit);
+        }
+        std::stable_sort(units.begin(), units.end(),
+                         [](const UnitStats* a, const UnitStats* b) {
+                             return a->total_wall_secs() > b->total_wall_secs();
+                         });
+        if (top && top < units.size()) {
+            units.resize(top);
+        }
+
+        size_t exprs, expr_bytes;
+        expr::ExprMgr::INSTANCE().pool_stats(exprs, expr_bytes);
+
+        expr::RewriteCacheStats rewrites[expr::N_REWRITE_PASSES];
+        for (unsigned i = 0; i < expr::N_REWRITE_PASSES; ++i) {
+            rewrites[i] = expr::RewriteCache::INSTANCE().stats((expr::rewrite_pass_t) i);
+        }
+
+        if (json) {
+            Json::Value root, passes { Json::arrayValue }, lst { Json::arrayValue };
+
+            for (unsigned i = 0; i < N_PASSES; ++i) {
+                Json::Value obj;
+                obj["name"] = pass_names[i];
+                obj["wall_secs"] = wall[i];
+                obj["cpu_secs"] = cpu[i];
+
+                passes.append(obj);
+            }
+            root["passes"] = passes;
+
+            root["units"] = (Json::UInt64) f_units.size();
+            root["memo_hits"] = (Json::UInt64) memo_hits;
+            root["memo_misses"] = (Json::UInt64) memo_misses;
+            root["disk_hits"] = (Json::UInt64) disk_hits;
+            root["disk_misses"] = (Json::UInt64) (f_units.size() - disk_hits);
+            root["dd_nodes"] = (Json::UInt64) dd_nodes;
+            root["reordering_secs"] = reordering_secs;
+            root["exprs"] = (Json::UInt64) exprs;
+            root["expr_bytes"] = (Json::UInt64) expr_bytes;
+
+            Json::Value rewrite_cache;
+            rewrite_cache["slots"] = (Json::UInt64) rewrites[0].slots;
+            for (unsigned i = 0; i < expr::N_REWRITE_PASSES; ++i) {
+                Json::Value obj;
+                obj["used"] = (Json::UInt64) rewrites[i].used;
+                obj["lookups"] = (Json::UInt64) rewrites[i].lookups;
+                obj["hits"] = (Json::UInt64) rewrites[i].hits;
+                obj["stores"] = (Json::UInt64) rewrites[i].stores;
+                obj["evictions"] = (Json::UInt64) rewrites[i].evictions;
+
+                rewrite_cache[rewrite_pass_names[i]] = obj;
+            }
+            root["rewrite_cache"] = rewrite_cache;
+
+            for (const auto* unit : units) {
+                std::ostringstream oss;
+                oss << unit->expr;
+
+                Json::Value obj;
+                obj["expr"] = oss.str();
+                obj["wall_secs"] = unit->total_wall_secs();
+                obj["cpu_secs"] = unit->total_cpu_secs();
+                obj["memo_hits"] = (Json::UInt64) unit->memo_hits;
+                obj["memo_misses"] = (Json::UInt64) unit->memo_misses;
+                obj["disk_hit"] = unit->disk_hit;
+                obj["dd_nodes"] = (Json::UInt64) unit->dd_nodes;
+                obj["reordering_secs"] = unit->reordering_secs;
+
+                lst.append(obj);
+            }
+            root["top"] = lst;
+
+            os
+                << root.toStyledString()
+                << std::endl;
+
+            return;
+        }
+
+        os
+            << f_units.size()
+            << " units, cache: "
+            << memo_hits
+            << " hits, "
+            << memo_misses
+            << " misses, on-disk cache: "
+            << disk_hits
+            << " hits, "
+            << f_units.size() - disk_hits
+            << " misses, DD nodes: "
+            << dd_nodes
+            << ", DD reordering: "
+            << std::fixed << std::setprecision(3) << reordering_secs
+            << "s"
+            << std::endl
+
+            << "Expressions: "
+            << exprs
+            << " nodes, "
+            << expr_bytes / 1024
+            << " KB"
+            << std::endl
+
+            << "Rewrite cache: "
+            << rewrites[0].slots
+            << " slots";
+
+        for (unsigned i = 0; i < expr::N_REWRITE_PASSES; ++i) {
+            os
+                << ", "
+                << rewrite_pass_names[i]
+                << ": "
+                << rewrites[i].hits
+                << "/"
+                << rewrites[i].lookups
+                << " hits, "
+                << rewrites[i].used
+                << " entries, "
+                << rewrites[i].evictions
+                << " evicted";
+        }
+        os
+            << std::endl;
+
+        for (unsigned i = 0; i < N_PASSES; ++i) {
+            os
+                << "  "
+                << pass_names[i]
+                << ": wall "
+                << std::fixed << std::setprecision(3) << wall[i]
+                << "s, cpu "
+                << cpu[i]
+                << "s"
+                << std::endl;
+        }
+
+        for (const auto* unit : units) {
+            os
+                << unit->expr
+                << ": wall "
+                << std::fixed << std::setprecision(3) << unit->total_wall_secs()
+                << "s, cpu "
+                << unit->total_cpu_secs()
+                << "s, cache: "
+                << unit->memo_hits
+                << " hits, "
+                << unit->memo_misses
+                << " misses, DD nodes: "
+                << unit->dd_nodes
+                << (unit->disk_hit ? " (on-disk cache)" : "")
+                << std::endl;
+        }
+    }
+
+} // namespace compiler
@@ -0,0 +1,124 @@
+/**
+ * @file stats.hh
+ * @brief Basic expressions compiler - Profiling statistics
+ *
+ * This header file contains the declarations required to collect
+ * profiling data on the compiler. For each compiled unit, the wall
+ * and CPU time spent in each pass, the hits and misses on the
+ * compilation cache and the size of the resulting DDs are recorded,
+ * for all compilers. Data are reported by the `compile-stats`
+ * command.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef COMPILATION_STATS_H
+#define COMPILATION_STATS_H
+
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <expr/expr.hh>
+
+#include <boost/thread/mutex.hpp>
+
+namespace compiler {
+
+    /* compiler passes, units found in the on-disk cache are loaded
+       in place of the passes following the encodings */
+    typedef enum {
+        PASS_BUILD_ENCODINGS,
+        PASS_SIMPLIFY,
+        PASS_COMPILE,
+        PASS_CHECK_INTERNALS,
+        PASS_ACTIVATE_ITE_MUXES,
+        PASS_ACTIVATE_ARRAY_MUXES,
+        PASS_CACHE_LOAD,
+        N_PASSES,
+    } compiler_pass_t;
+
+    /* profiling data for a single compiled unit */
+    struct UnitStats {
+        UnitStats(expr::Expr_ptr expr);
+
+        /* charges the time elapsed since the previous lap (or
+           construction) to pass */
+        void lap(compiler_pass_t pass);
+
+        expr::Expr_ptr expr;
+
+        double wall_secs[N_PASSES];
+        double cpu_secs[N_PASSES];
+
+        /* hits and misses on the compilation cache */
+        unsigned long memo_hits;
+        unsigned long memo_misses;
+
+        /* true iff the unit was loaded from the on-disk cache */
+        bool disk_hit;
+
+        /* total size of the resulting DDs */
+        unsigned long dd_nodes;
+
+        /* DD dynamic reordering, included in the passes it took
+           place in */
+        double reordering_secs;
+
+        double total_wall_secs() const;
+        double total_cpu_secs() const;
+
+    private:
+        struct timespec f_wall;
+        struct timespec f_cpu;
+    };
+
+    typedef class CompilerStatsMgr* CompilerStatsMgr_ptr;
+
+    class CompilerStatsMgr {
+    public:
+        void record(const UnitStats& stats);
+
+        /* per-pass totals, and the top most expensive units (all of
+           them if top is 0) */
+        void report(std::ostream& os, bool json, unsigned top);
+
+        void clear();
+
+        static CompilerStatsMgr& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static CompilerStatsMgr_ptr instance { new CompilerStatsMgr() };
+            return *instance;
+        }
+
+    protected:
+        CompilerStatsMgr();
+        ~CompilerStatsMgr();
+
+    private:
+        boost::mutex f_mutex;
+
+        std::vector<UnitStats> f_units;
+    };
+
+} // namespace compiler
+
+#endif /* COMPILATION_STATS_H */
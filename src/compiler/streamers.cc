@@ -367,7 +367,24 @@ std::ostream& operator<<(std::ostream& os, const compiler::MultiwaySelectionDesc
             break;
         }
     }
-    os << "])";
+    os << "]";
+
+    if (md.is_lazy()) {
+        os << ", lazy";
+    }
+    os << ")";
+
+    return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const compiler::AigDescriptor& ad)
+{
+    os << "AIG (z = "
+       << ad.z().getNode()->index
+       << ", root = "
+       << (compiler::aig_complemented(ad.root()) ? "!" : "")
+       << compiler::aig_node(ad.root())
+       << ")";
 
     return os;
 }
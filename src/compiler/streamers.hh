@@ -48,4 +48,6 @@ std::string bsd2string(const compiler::InlinedOperatorSignature& ios);
 std::ostream& operator<<(std::ostream& os, const compiler::MultiwaySelectionDescriptor& md);
 std::string msd2string(const compiler::InlinedOperatorSignature& ios);
 
+std::ostream& operator<<(std::ostream& os, const compiler::AigDescriptor& ad);
+
 #endif /* COMPILATION_STREAMERS_H */
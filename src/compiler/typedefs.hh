@@ -28,6 +28,9 @@
 #define COMPILER_TYPEDEFS_H
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <compiler/aig.hh>
 
 #include <dd/dd.hh>
 
@@ -88,6 +91,11 @@ namespace compiler {
                         const InlinedOperatorSignature& y) const;
     };
 
+    using InlinedOperatorSignatureSet =
+        boost::unordered_set<InlinedOperatorSignature,
+                             InlinedOperatorSignatureHash,
+                             InlinedOperatorSignatureEq>;
+
     class BinarySelectionDescriptor {
     public:
         BinarySelectionDescriptor(unsigned width, dd::DDVector& z, ADD cnd,
@@ -132,12 +140,22 @@ namespace compiler {
         dd::DDVector f_y;
     };
 
+    /* Array MUXes come in two flavors. Flat MUXes select element j
+     * when acts[j] holds, acts[j] <-> cnds[j] is in the formula. Lazy
+     * MUXes only carry the index bits (MSB first), the SAT engine
+     * refines them on demand, one element at a time. There, cnds and
+     * acts only bind the index bits that are not plain DD vars. */
     class MultiwaySelectionDescriptor {
     public:
         MultiwaySelectionDescriptor(unsigned elem_width, unsigned elem_count,
                                     dd::DDVector& z, dd::DDVector& cnds,
                                     dd::DDVector& acts, dd::DDVector& x);
 
+        MultiwaySelectionDescriptor(unsigned elem_width, unsigned elem_count,
+                                    dd::DDVector& z, dd::DDVector& cnds,
+                                    dd::DDVector& acts, dd::DDVector& x,
+                                    dd::DDVector& index);
+
         inline unsigned elem_width() const
         {
             return f_elem_width;
@@ -168,6 +186,16 @@ namespace compiler {
             return f_x;
         }
 
+        inline const dd::DDVector& index() const
+        {
+            return f_index;
+        }
+
+        inline bool is_lazy() const
+        {
+            return !f_index.empty();
+        }
+
     private:
         unsigned f_elem_width;
         unsigned f_elem_count;
@@ -175,6 +203,7 @@ namespace compiler {
         dd::DDVector f_cnds;
         dd::DDVector f_acts;
         dd::DDVector f_x;
+        dd::DDVector f_index;
     };
 
     class InlinedOperatorDescriptor {
@@ -229,6 +258,26 @@ namespace compiler {
         dd::DDVector f_y;
     };
 
+    /* z <-> root, for the AIG backend */
+    class AigDescriptor {
+    public:
+        AigDescriptor(ADD z, aig_lit_t root);
+
+        inline const ADD& z() const
+        {
+            return f_z;
+        }
+
+        inline aig_lit_t root() const
+        {
+            return f_root;
+        }
+
+    private:
+        ADD f_z;
+        aig_lit_t f_root;
+    };
+
     using InlinedOperatorDescriptors =
         std::vector<InlinedOperatorDescriptor>;
 
@@ -238,6 +287,9 @@ namespace compiler {
     using MultiwaySelectionDescriptors =
         std::vector<MultiwaySelectionDescriptor>;
 
+    using AigDescriptors =
+        std::vector<AigDescriptor>;
+
     using Expr2BinarySelectionDescriptorsMap =
         boost::unordered_map<expr::Expr_ptr, BinarySelectionDescriptors>;
 
@@ -246,12 +298,14 @@ namespace compiler {
         Unit(expr::Expr_ptr expr, dd::DDVector& dds,
              InlinedOperatorDescriptors& inlined_operator_descriptors,
              Expr2BinarySelectionDescriptorsMap& binary_selection_descriptors_map,
-             MultiwaySelectionDescriptors& array_mux_descriptors)
+             MultiwaySelectionDescriptors& array_mux_descriptors,
+             AigDescriptors& aig_descriptors)
             : f_expr(expr)
             , f_dds(dds)
             , f_inlined_operator_descriptors(inlined_operator_descriptors)
             , f_binary_selection_descriptors_map(binary_selection_descriptors_map)
             , f_array_mux_descriptors(array_mux_descriptors)
+            , f_aig_descriptors(aig_descriptors)
         {}
 
         inline const expr::Expr_ptr expr() const
@@ -279,12 +333,32 @@ namespace compiler {
             return f_array_mux_descriptors;
         }
 
+        inline const AigDescriptors& aig_descriptors() const
+        {
+            return f_aig_descriptors;
+        }
+
+        /* true iff the unit is made of its DDs only, with no
+           operators to inline nor selections to activate (e.g. on
+           boolean models) */
+        inline bool dds_only() const
+        {
+            return f_inlined_operator_descriptors.empty() &&
+                   f_binary_selection_descriptors_map.empty() &&
+                   f_array_mux_descriptors.empty() &&
+                   f_aig_descriptors.empty();
+        }
+
+        /* the expr of the unit, and those of its selections, are live */
+        void mark(expr::ExprMarker& marker) const;
+
     private:
         expr::Expr_ptr f_expr;
         dd::DDVector f_dds;
         InlinedOperatorDescriptors f_inlined_operator_descriptors;
         Expr2BinarySelectionDescriptorsMap f_binary_selection_descriptors_map;
         MultiwaySelectionDescriptors f_array_mux_descriptors;
+        AigDescriptors f_aig_descriptors;
     };
 
     using CompilationUnit_ptr =
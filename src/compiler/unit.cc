@@ -24,6 +24,8 @@
 #include <compiler/streamers.hh>
 #include <compiler/typedefs.hh>
 
+#include <expr/collector.hh>
+
 #include <type/type.hh>
 
 namespace compiler {
@@ -63,6 +65,26 @@ namespace compiler {
         , f_cnds(cnds)
         , f_acts(acts)
         , f_x(x)
+        , f_index()
+    {}
+
+    MultiwaySelectionDescriptor::MultiwaySelectionDescriptor(unsigned elem_width,
+                                                             unsigned elem_count,
+                                                             dd::DDVector& z, dd::DDVector& cnds,
+                                                             dd::DDVector& acts, dd::DDVector& x,
+                                                             dd::DDVector& index)
+        : f_elem_width(elem_width)
+        , f_elem_count(elem_count)
+        , f_z(z)
+        , f_cnds(cnds)
+        , f_acts(acts)
+        , f_x(x)
+        , f_index(index)
+    {}
+
+    AigDescriptor::AigDescriptor(ADD z, aig_lit_t root)
+        : f_z(z)
+        , f_root(root)
     {}
 
     long InlinedOperatorSignatureHash::operator()(const InlinedOperatorSignature& k) const
@@ -85,4 +107,14 @@ namespace compiler {
                x.get<2>() == y.get<2>();
     }
 
+    void Unit::mark(expr::ExprMarker& marker) const
+    {
+        marker.mark(f_expr);
+        for (Expr2BinarySelectionDescriptorsMap::const_iterator i =
+                 f_binary_selection_descriptors_map.begin();
+             i != f_binary_selection_descriptors_map.end(); ++i) {
+            marker.mark(i->first);
+        }
+    }
+
 } // namespace compiler
@@ -48,13 +48,14 @@ namespace compiler {
         expr::Expr_ptr lhs { expr->lhs() };
         assert(em.is_instant(lhs) || em.is_interval(lhs));
 
-        if (em.is_interval(lhs)) {
-            throw UnexpectedExpression(expr);
-        }
-
         expr::Expr_ptr rhs { expr->rhs() };
         assert(NULL != rhs);
 
+        if (em.is_interval(lhs)) {
+            walk_interval_frames(expr);
+            return false;
+        }
+
         return true;
     }
     bool Compiler::walk_at_inorder(const expr::Expr_ptr expr)
@@ -75,7 +76,7 @@ namespace compiler {
         DROP_TIME();
     }
 
-    /* INTERVAL needs rewriting: not supposed to reach the compiler */
+    /* INTERVAL is only walked as the lhs of AT, frame by frame */
     bool Compiler::walk_interval_preorder(const expr::Expr_ptr expr)
     {
         assert(false);
@@ -618,7 +619,7 @@ namespace compiler {
 
     bool Compiler::walk_eq_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_eq_inorder(const expr::Expr_ptr expr)
     {
@@ -653,7 +654,7 @@ namespace compiler {
 
     bool Compiler::walk_ne_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_ne_inorder(const expr::Expr_ptr expr)
     {
@@ -684,7 +685,7 @@ namespace compiler {
 
     bool Compiler::walk_gt_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_gt_inorder(const expr::Expr_ptr expr)
     {
@@ -707,7 +708,7 @@ namespace compiler {
 
     bool Compiler::walk_ge_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_ge_inorder(const expr::Expr_ptr expr)
     {
@@ -730,7 +731,7 @@ namespace compiler {
 
     bool Compiler::walk_lt_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_lt_inorder(const expr::Expr_ptr expr)
     {
@@ -753,7 +754,7 @@ namespace compiler {
 
     bool Compiler::walk_le_preorder(const expr::Expr_ptr expr)
     {
-        return cache_miss(expr);
+        return cache_miss(expr) && !cardinality(expr);
     }
     bool Compiler::walk_le_inorder(const expr::Expr_ptr expr)
     {
@@ -864,13 +865,14 @@ namespace compiler {
         DROP_CTX();
     }
 
-    /* on-demand preprocessing to expand defines delegated to Preprocessor */
+    /* defines are expanded once, by the analysis, the preprocessor is
+       only needed for exprs it did not see (e.g. rewritten ones) */
     bool Compiler::walk_params_preorder(const expr::Expr_ptr expr)
     {
         TOP_CTX(ctx);
 
         expr::Expr_ptr preprocessed {
-            f_preprocessor.process(expr, ctx)
+            f_owner.expansion_cache().expand(f_preprocessor, expr, ctx)
         };
         (*this)(preprocessed);
 
@@ -21,18 +21,28 @@
  *
  **/
 
+#include <algorithm>
+
 #include <cudd_mgr.hh>
 
 #include <utils/logging.hh>
+#include <utils/memory.hh>
 
 namespace dd {
 
-    CuddMgr_ptr CuddMgr::f_instance = NULL;
-
     CuddMgr::CuddMgr()
+        : f_reordering(CUDD_REORDER_GROUP_SIFT_CONV)
+        , f_max_reorderings(0)
+        , f_unique_slots(CUDD_UNIQUE_SLOTS)
+        , f_cache_slots(CUDD_CACHE_SLOTS)
+        , f_max_memory(0)
+        , f_released { 0, 0, 0, 0, 0, 0.0, 0.0, 0.0 }
     {
         const void* instance { this };
 
+        utils::MemoryMgr::INSTANCE()
+            .add_probe("dd", [this]() { return stats().memory; });
+
         DRIVEL
             << "Initialized CuddMgr @ "
             << instance
@@ -55,14 +65,99 @@ namespace dd {
 
     Cudd& CuddMgr::dd()
     {
-        Cudd* res { new Cudd() };
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Cudd* res { new Cudd(0, 0, f_unique_slots, f_cache_slots, f_max_memory) };
         assert(NULL != res);
 
         /* Common setup for all dd instances */
-        res->AutodynEnable(CUDD_REORDER_GROUP_SIFT_CONV);
+        if (CUDD_REORDER_NONE != f_reordering) {
+            res->AutodynEnable(f_reordering);
+        }
+        if (f_max_reorderings) {
+            res->SetMaxReorderings(f_max_reorderings);
+        }
+
         f_cudd_instances.push_back(res);
 
         return *res;
     }
 
+    bool CuddMgr::set_reordering(const std::string& method, unsigned max_reorderings)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if ("none" == method) {
+            f_reordering = CUDD_REORDER_NONE;
+        } else if ("sift" == method) {
+            f_reordering = CUDD_REORDER_SIFT;
+        } else if ("group-sift" == method) {
+            f_reordering = CUDD_REORDER_GROUP_SIFT_CONV;
+        } else {
+            return false;
+        }
+
+        f_max_reorderings = max_reorderings;
+        return true;
+    }
+
+    void CuddMgr::set_sizes(unsigned unique_slots, unsigned cache_slots,
+                            unsigned long max_memory)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_unique_slots = unique_slots;
+        f_cache_slots = cache_slots;
+        f_max_memory = max_memory;
+    }
+
+    void CuddMgr::collect_stats(Cudd& dd, CuddStats& stats)
+    {
+        DdManager* mgr { dd.getManager() };
+
+        /* no reads with side effects (e.g. death row flushes) */
+        stats.live_nodes += Cudd_ReadKeys(mgr) - Cudd_ReadDead(mgr);
+        stats.memory += Cudd_ReadMemoryInUse(mgr);
+
+        stats.peak_nodes = std::max(stats.peak_nodes,
+                                    (unsigned long) Cudd_ReadPeakNodeCount(mgr));
+        stats.gcs += Cudd_ReadGarbageCollections(mgr);
+        stats.gc_secs += (double) Cudd_ReadGarbageCollectionTime(mgr) / 1000.0;
+        stats.cache_lookups += Cudd_ReadCacheLookUps(mgr);
+        stats.cache_hits += Cudd_ReadCacheHits(mgr);
+    }
+
+    CuddStats CuddMgr::stats()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        CuddStats res { f_released };
+        res.managers = f_cudd_instances.size();
+        res.live_nodes = 0;
+        res.memory = 0;
+
+        for (auto dd : f_cudd_instances) {
+            collect_stats(*dd, res);
+        }
+
+        return res;
+    }
+
+    void CuddMgr::release(Cudd& dd)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        CuddVector::iterator eye {
+            std::find(f_cudd_instances.begin(), f_cudd_instances.end(), &dd)
+        };
+        assert(f_cudd_instances.end() != eye);
+
+        collect_stats(dd, f_released);
+        f_released.live_nodes = 0;
+        f_released.memory = 0;
+
+        f_cudd_instances.erase(eye);
+        delete &dd;
+    }
+
 }; // namespace dd
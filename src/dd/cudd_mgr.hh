@@ -27,11 +27,14 @@
 #ifndef CUDD_MGR_H
 #define CUDD_MGR_H
 
+#include <string>
 #include <vector>
 
 #include <common/common.hh>
 #include <cuddObj.hh>
 
+#include <boost/thread/mutex.hpp>
+
 namespace dd {
 
     typedef class CuddMgr* CuddMgr_ptr;
@@ -39,18 +42,51 @@ namespace dd {
 
     typedef std::vector<Cudd_ptr> CuddVector;
 
+    /* figures of the DD managers, summed over all of them */
+    struct CuddStats {
+        unsigned managers;
+
+        /* of the live managers */
+        unsigned long live_nodes;
+        unsigned long memory;
+
+        /* of all managers, including released ones */
+        unsigned long peak_nodes;
+        unsigned long gcs;
+        double gc_secs;
+        double cache_lookups;
+        double cache_hits;
+    };
+
     class CuddMgr {
 
     public:
         /* Generate a *new* Cudd instance */
         Cudd& dd();
 
+        /* Dispose of an instance, no DDs built on it may be alive */
+        void release(Cudd& dd);
+
+        /* Dynamic reordering of the instances generated from now on
+           (`none`, `sift`, `group-sift`), at most max_reorderings
+           times each (0 = no limit). False iff method is unknown */
+        bool set_reordering(const std::string& method, unsigned max_reorderings);
+
+        /* Unique table slots (per subtable), computed table slots and
+           max memory in bytes (0 = CUDD default) of the instances
+           generated from now on */
+        void set_sizes(unsigned unique_slots, unsigned cache_slots,
+                       unsigned long max_memory);
+
+        /* Figures of managers in use by other threads are
+           approximate, they are read while those are running */
+        CuddStats stats();
+
         static CuddMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new CuddMgr();
-            }
-            return (*f_instance);
+            /* made on first use, concurrent first uses wait for it */
+            static CuddMgr_ptr instance { new CuddMgr() };
+            return *instance;
         }
 
     protected:
@@ -58,8 +94,22 @@ namespace dd {
         ~CuddMgr();
 
     private:
-        static CuddMgr_ptr f_instance;
         CuddVector f_cudd_instances;
+
+        /* instances are made by each compiler, on any thread */
+        boost::mutex f_mutex;
+
+        Cudd_ReorderingType f_reordering;
+        unsigned f_max_reorderings;
+
+        unsigned f_unique_slots;
+        unsigned f_cache_slots;
+        unsigned long f_max_memory;
+
+        /* cumulative figures of the released instances */
+        CuddStats f_released;
+
+        void collect_stats(Cudd& dd, CuddStats& stats);
     };
 
 }; // namespace dd
@@ -60,23 +60,20 @@
 #define PUSH_DD(add) \
     f_add_stack.push_back(add)
 
-/** Fetch a DD vector of given width */
-#define POP_DV(vec, width)                 \
-    dd::DDVector vec;                      \
-    for (unsigned i = 0; i < width; ++i) { \
-        vec.push_back(f_add_stack.back()); \
-        f_add_stack.pop_back();            \
-    }
+/** Fetch a DD vector of given width, top of the stack comes first.
+    Bits are moved in one go, vectors are allocated once */
+#define POP_DV(vec, width)                                               \
+    dd::DDVector vec(f_add_stack.rbegin(), f_add_stack.rbegin() + (width)); \
+    f_add_stack.erase(f_add_stack.end() - (width), f_add_stack.end())
 
 /** Declare a DD vector of given width */
 #define FRESH_DV(vec, width) \
     dd::DDVector vec;        \
     make_auto_ddvect(vec, width);
 
-/** Push a DD vector of given width */
-#define PUSH_DV(vec, width)              \
-    for (unsigned i = 0; i < width; ++i) \
-    PUSH_DD(vec[width - i - 1])
+/** Push a DD vector of given width, first bit ends up on top */
+#define PUSH_DV(vec, width) \
+    f_add_stack.insert(f_add_stack.end(), (vec).rend() - (width), (vec).rend())
 
 namespace dd {
 
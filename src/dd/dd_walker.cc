@@ -21,11 +21,49 @@
  *
  **/
 
+#include <algorithm>
+
 #include <common/common.hh>
 #include <dd_walker.hh>
 
 namespace dd {
 
+    /* --- Visited set ---------------------------------------------------------- */
+    ADDVisitedSet::ADDVisitedSet()
+        : f_slots(1024, Slot { NULL, 0 })
+        , f_size(0)
+        , f_generation(1)
+    {}
+
+    void ADDVisitedSet::clear()
+    {
+        f_size = 0;
+
+        /* stale stamps could match again on wrap around */
+        if (0 == ++f_generation) {
+            std::fill(f_slots.begin(), f_slots.end(), Slot { NULL, 0 });
+            f_generation = 1;
+        }
+    }
+
+    void ADDVisitedSet::grow()
+    {
+        std::vector<Slot> slots(2 * f_slots.size(), Slot { NULL, 0 });
+        slots.swap(f_slots);
+
+        unsigned generation { f_generation };
+        f_size = 0;
+        if (0 == ++f_generation) {
+            f_generation = 1;
+        }
+
+        for (const auto& slot : slots) {
+            if (slot.generation == generation) {
+                mark(slot.node);
+            }
+        }
+    }
+
     /* --- ADD Walker ----------------------------------------------------------- */
     ADDWalker::ADDWalker()
     {}
@@ -93,4 +131,74 @@ namespace dd {
         }
     }
 
+    /* --- ADD DAG Walker ------------------------------------------------------- */
+    ADDDagWalker::ADDDagWalker(ADDWalkerScratch& scratch)
+        : f_recursion_stack(scratch.stack)
+        , f_visited(scratch.visited)
+    {}
+
+    ADDDagWalker::~ADDDagWalker()
+    {}
+
+    ADDDagWalker& ADDDagWalker::operator()(ADD dd)
+    {
+        f_recursion_stack.clear();
+        f_visited.clear();
+
+        const DdNode* toplevel { dd.getNode() };
+        f_visited.mark(toplevel);
+        f_recursion_stack.push_back(add_activation_record(toplevel));
+
+        pre_hook();
+
+        walk();
+
+        post_hook();
+
+        return *this;
+    }
+
+    /* post-order visit strategy, nodes already visited are skipped */
+    void ADDDagWalker::walk()
+    {
+        while (!f_recursion_stack.empty()) {
+            add_activation_record& curr { f_recursion_stack.back() };
+            assert(!Cudd_IsComplement(curr.node));
+
+            const DdNode* node { curr.node };
+
+            /* leaves have no children */
+            if (cuddIsConstant(node)) {
+                curr.pc = DD_WALK_NODE;
+            }
+
+            /* curr is invalidated by pushes */
+            switch (curr.pc) {
+                case DD_WALK_LHS:
+                    curr.pc = DD_WALK_RHS;
+                    if (f_visited.mark(cuddT(node))) {
+                        f_recursion_stack.push_back(add_activation_record(cuddT(node)));
+                    }
+                    break;
+
+                case DD_WALK_RHS:
+                    curr.pc = DD_WALK_NODE;
+                    if (f_visited.mark(cuddE(node))) {
+                        f_recursion_stack.push_back(add_activation_record(cuddE(node)));
+                    }
+                    break;
+
+                case DD_WALK_NODE:
+                    if (condition(node)) {
+                        action(node);
+                    }
+                    f_recursion_stack.pop_back();
+                    break;
+
+                default:
+                    assert(false); // unexpected
+            }
+        }
+    }
+
 }; // namespace dd
@@ -24,7 +24,9 @@
 #define DD_WALKER_H
 
 #include <common/common.hh>
+#include <cstdint>
 #include <stack>
+#include <vector>
 
 #include <cuddInt.h>
 #include <dd/dd.hh>
@@ -48,6 +50,67 @@ namespace dd {
         {}
     };
     typedef std::stack<struct add_activation_record> add_walker_stack;
+    typedef std::vector<struct add_activation_record> add_walker_vector;
+
+    /* a set of DD nodes, cleared in constant time by bumping its
+       generation. Nodes carry no id of their own, and their flags are
+       shared by all threads working on a manager, so marks are kept
+       in an open addressing table of their own, kept across walks */
+    class ADDVisitedSet {
+    public:
+        ADDVisitedSet();
+
+        /* true iff node was not in the set, adds it */
+        inline bool mark(const DdNode* node)
+        {
+            if (f_slots.size() <= 2 * f_size) {
+                grow();
+            }
+
+            size_t mask { f_slots.size() - 1 };
+            for (size_t i = hash(node) & mask;; i = (i + 1) & mask) {
+                Slot& slot { f_slots[i] };
+
+                if (slot.generation != f_generation) {
+                    slot.node = node;
+                    slot.generation = f_generation;
+                    ++f_size;
+
+                    return true;
+                }
+                if (slot.node == node) {
+                    return false;
+                }
+            }
+        }
+
+        void clear();
+
+    private:
+        struct Slot {
+            const DdNode* node;
+            unsigned generation;
+        };
+
+        static inline size_t hash(const DdNode* node)
+        {
+            uint64_t x { (uint64_t)(uintptr_t) node >> 4 };
+            return (size_t)((x * 0x9E3779B97F4A7C15ULL) >> 20);
+        }
+
+        void grow();
+
+        std::vector<Slot> f_slots;
+        size_t f_size;
+        unsigned f_generation;
+    };
+
+    /* storage of DAG walkers, to be reused across walks (e.g. owned by
+       a SAT engine, for all of its CNFizations) */
+    struct ADDWalkerScratch {
+        add_walker_vector stack;
+        ADDVisitedSet visited;
+    };
 
     class DDWalkerException: public Exception {
     public:
@@ -74,6 +137,29 @@ namespace dd {
         add_walker_stack f_recursion_stack;
     };
 
+    /* visits each node of the DAG once, children first. The walk
+       allocates nothing once the scratch storage has grown */
+    class ADDDagWalker {
+    public:
+        ADDDagWalker(ADDWalkerScratch& scratch);
+        virtual ~ADDDagWalker();
+
+        virtual ADDDagWalker& operator()(ADD dd);
+
+    protected:
+        virtual void walk();
+
+        virtual bool condition(const DdNode* node) = 0;
+        virtual void action(const DdNode* node) = 0;
+
+        virtual void pre_hook() = 0;
+        virtual void post_hook() = 0;
+
+        /* explicit recursion stack, the toplevel is at the bottom */
+        add_walker_vector& f_recursion_stack;
+        ADDVisitedSet& f_visited;
+    };
+
 }; // namespace dd
 
 #endif
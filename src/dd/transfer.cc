@@ -0,0 +1,82 @@
+/**
+ * @file transfer.cc
+ * @brief Cudd module (DDTransfer class implementation)
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+
+#include <transfer.hh>
+
+namespace dd {
+
+    DDTransfer::DDTransfer(Cudd& to)
+        : f_to(to)
+        , f_map()
+    {}
+
+    ADD DDTransfer::operator()(ADD add)
+    {
+        /* post-order, children come first. ADDs have no complemented
+           arcs */
+        std::vector<std::pair<DdNode*, bool>> stack;
+        stack.push_back(std::make_pair(add.getNode(), false));
+
+        while (!stack.empty()) {
+            DdNode* node { stack.back().first };
+            bool expanded { stack.back().second };
+            stack.pop_back();
+
+            if (f_map.end() != f_map.find(node)) {
+                continue;
+            }
+
+            if (Cudd_IsConstant(node)) {
+                f_map.insert(std::make_pair(node, f_to.constant(Cudd_V(node))));
+                continue;
+            }
+
+            if (!expanded) {
+                stack.push_back(std::make_pair(node, true));
+                stack.push_back(std::make_pair(Cudd_T(node), false));
+                stack.push_back(std::make_pair(Cudd_E(node), false));
+                continue;
+            }
+
+            ADD res { f_to.addVar(node->index).Ite(f_map.at(Cudd_T(node)),
+                                                   f_map.at(Cudd_E(node))) };
+            f_map.insert(std::make_pair(node, res));
+        }
+
+        return f_map.at(add.getNode());
+    }
+
+    DDVector DDTransfer::operator()(const DDVector& vec)
+    {
+        DDVector res;
+        res.reserve(vec.size());
+
+        for (const auto& add : vec) {
+            res.push_back((*this)(add));
+        }
+
+        return res;
+    }
+
+}; // namespace dd
@@ -0,0 +1,60 @@
+/**
+ * @file transfer.hh
+ * @brief Cudd module (DDTransfer class)
+ *
+ * This header contains declarations required to transfer DDs across
+ * Cudd managers. CUDD managers are not reentrant, compilers running
+ * on different threads build their DDs on managers of their own and
+ * transfer the results to the shared one. DD var indices are
+ * preserved, variable orders need not be the same.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+
+#ifndef DD_TRANSFER_H
+#define DD_TRANSFER_H
+
+#include <dd/dd.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace dd {
+
+    class DDTransfer {
+    public:
+        /* DDs are rebuilt on manager to, the caller holds whatever
+           lock it requires. Nodes are memoized by address: source
+           DDs must outlive the transfer, and no operation may take
+           place on their manager meanwhile */
+        DDTransfer(Cudd& to);
+
+        ADD operator()(ADD add);
+        DDVector operator()(const DDVector& vec);
+
+    private:
+        Cudd& f_to;
+
+        typedef boost::unordered_map<DdNode*, ADD> TransferMap;
+        TransferMap f_map;
+    };
+
+}; // namespace dd
+
+#endif /* DD_TRANSFER_H */
@@ -41,7 +41,8 @@ namespace enc {
         return res;
     }
 
-    AlgebraicEncoding::AlgebraicEncoding(unsigned width, bool is_signed, ADD* dds)
+    AlgebraicEncoding::AlgebraicEncoding(unsigned width, bool is_signed, ADD* dds,
+                                         unsigned significant)
         : f_width(width)
         , f_signed(is_signed)
         , f_temporary(NULL != dds)
@@ -51,6 +52,18 @@ namespace enc {
             for (unsigned i = 0; i < width; ++i) {
                 f_dv.push_back(dds[i]);
             }
+        } else if (0 < significant && significant < width) {
+            /* MSB first, bits are taken in the same order */
+            dd::DDVector digits;
+            for (unsigned i = 0; i < significant; ++i) {
+                digits.push_back(make_monolithic_encoding(1));
+            }
+
+            ADD extension { f_signed ? digits[0] : f_mgr.constant(0) };
+            for (unsigned i = significant; i < width; ++i) {
+                f_dv.push_back(extension);
+            }
+            f_dv.insert(f_dv.end(), digits.begin(), digits.end());
         } else {
             for (unsigned i = 0; i < width; ++i) {
                 f_dv.push_back(make_monolithic_encoding(1));
@@ -88,4 +101,31 @@ namespace enc {
         return em.make_const(res);
     }
 
+    bool AlgebraicEncoding::assignment(expr::Expr_ptr value, int* assignment)
+    {
+        expr::ExprMgr& em { f_mgr.em() };
+
+        bool negative { em.is_neg(value) };
+        if (negative) {
+            value = value->lhs();
+        }
+
+        if (!em.is_int_const(value) || (negative && !is_signed())) {
+            return false;
+        }
+
+        /* two's complement, digits are MSB first */
+        value_t res { negative ? -value->value() : value->value() };
+        for (unsigned i = 0; i < f_width; ++i) {
+            unsigned shift { f_width - 1 - i };
+            value_t digit { shift < 8 * sizeof(value_t) ? (res >> shift) & 1 : 0 };
+
+            if (!assign_digit(f_dv[i].getNode(), digit, assignment)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
 }; // namespace enc
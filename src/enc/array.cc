@@ -61,4 +61,36 @@ namespace enc {
         return em.make_array(acc);
     }
 
+    bool ArrayEncoding::assignment(expr::Expr_ptr value, int* assignment)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (!em.is_array(value)) {
+            return false;
+        }
+
+        /* (e0, (e1, ... en)), as built by expr() */
+        expr::Expr_ptr elements { value->lhs() };
+        for (Encodings::const_iterator i = f_elements.begin();
+             f_elements.end() != i; ++i) {
+
+            if (NULL == elements) {
+                return false;
+            }
+
+            expr::Expr_ptr element { elements };
+            elements = NULL;
+            if (em.is_array_comma(element)) {
+                elements = element->rhs();
+                element = element->lhs();
+            }
+
+            if (!(*i)->assignment(element, assignment)) {
+                return false;
+            }
+        }
+
+        return NULL == elements;
+    }
+
 }; // namespace enc
@@ -60,4 +60,27 @@ namespace enc {
         return res;
     }
 
+    bool Encoding::assign_digit(DdNode* digit, value_t value, int* assignment)
+    {
+        if (cuddIsConstant(digit)) {
+            return value == (value_t) cuddV(digit);
+        }
+
+        int index { (int) digit->index };
+        if (0 <= assignment[index]) {
+            return assign_digit(assignment[index] ? cuddT(digit) : cuddE(digit),
+                                value, assignment);
+        }
+
+        for (int bit : { 1, 0 }) {
+            assignment[index] = bit;
+            if (assign_digit(bit ? cuddT(digit) : cuddE(digit), value, assignment)) {
+                return true;
+            }
+        }
+
+        assignment[index] = -1;
+        return false;
+    }
+
 }; // namespace enc
@@ -69,6 +69,13 @@ namespace enc {
         /* vector of DD leaves (consts) -> expr */
         virtual expr::Expr_ptr expr(int* assignment) = 0;
 
+        /* expr -> vector of DD leaves, the other way around: the
+           entries of the bits of this encoding in assignment (by DD
+           index, -1 if unknown) are set to a combination representing
+           value. False if there is none, entries set so far are left
+           as they are */
+        virtual bool assignment(expr::Expr_ptr value, int* assignment) = 0;
+
     protected:
         Encoding()
             : f_mgr(EncodingMgr::INSTANCE())
@@ -84,6 +91,10 @@ namespace enc {
         // low level services
         ADD make_bit();
         ADD make_monolithic_encoding(unsigned nbits);
+
+        // a path of digit to the leaf of the given value, consistent
+        // with the entries of assignment set already
+        static bool assign_digit(DdNode* digit, value_t value, int* assignment);
     };
 
     typedef Encoding* Encoding_ptr;
@@ -99,6 +110,8 @@ namespace enc {
         // here assignment *must* have size 1
         expr::Expr_ptr expr(int* assignment);
 
+        bool assignment(expr::Expr_ptr value, int* assignment);
+
         ADD bit();
 
     protected:
@@ -122,6 +135,8 @@ namespace enc {
         // here assignment *must* have size 1
         virtual expr::Expr_ptr expr(int* assignment);
 
+        virtual bool assignment(expr::Expr_ptr value, int* assignment);
+
         inline bool is_signed() const
         {
             return f_signed;
@@ -143,8 +158,12 @@ namespace enc {
             assert(0);
         }
 
-        // width is number of *digits* here, dds is reserved for temporary encodings
-        AlgebraicEncoding(unsigned width, bool is_signed, ADD* dds = NULL);
+        // width is number of *digits* here, dds is reserved for
+        // temporary encodings. Only the last significant digits take
+        // bits if not 0, the others are 0 (or copies of the first
+        // significant one, if signed)
+        AlgebraicEncoding(unsigned width, bool is_signed, ADD* dds = NULL,
+                          unsigned significant = 0);
 
         unsigned f_width;
         bool f_signed;
@@ -181,15 +200,28 @@ namespace enc {
         // here assignment *must* have size 1
         virtual expr::Expr_ptr expr(int* assignment);
 
+        virtual bool assignment(expr::Expr_ptr value, int* assignment);
+
         virtual value_t value(expr::Expr_ptr literal);
 
+        inline enum_encoding_t encoding() const
+        {
+            return f_encoding;
+        }
+
     protected:
         virtual ~EnumEncoding()
         {
             assert(0);
         }
 
-        EnumEncoding(const expr::ExprSet& lits);
+        EnumEncoding(const expr::ExprSet& lits, enum_encoding_t encoding);
+
+        /* n - 1 bits, see enum_encoding_t */
+        ADD make_one_hot_encoding(unsigned n);
+        ADD make_order_encoding(unsigned n);
+
+        enum_encoding_t f_encoding;
 
         ValueExprMap f_v2e_map;
         ExprValueMap f_e2v_map;
@@ -205,6 +237,8 @@ namespace enc {
     public:
         virtual expr::Expr_ptr expr(int* assignment);
 
+        virtual bool assignment(expr::Expr_ptr value, int* assignment);
+
     protected:
         ArrayEncoding(Encodings elements);
 
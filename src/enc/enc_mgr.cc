@@ -25,15 +25,21 @@
 #include <enc.hh>
 #include <enc_mgr.hh>
 
+#include <expr/collector.hh>
+
 #include <utils/logging.hh>
 
 namespace enc {
 
-    EncodingMgr_ptr EncodingMgr::f_instance = NULL;
-
     Encoding_ptr EncodingMgr::make_encoding(type::Type_ptr tp)
+    {
+        return make_encoding_aux(tp, 0);
+    }
+
+    Encoding_ptr EncodingMgr::make_encoding_aux(type::Type_ptr tp, unsigned significant)
     {
         assert(NULL != tp);
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
 
         Encoding_ptr res { NULL };
 
@@ -44,6 +50,8 @@ namespace enc {
         type::ArrayType_ptr vtype;
 
         /* disable DD reordering */
+        Cudd_ReorderingType method;
+        bool reordering { f_cudd.ReorderingStatus(&method) };
         f_cudd.AutodynDisable();
 
         if ((btype = dynamic_cast<type::BooleanType_ptr>(tp))) {
@@ -51,15 +59,17 @@ namespace enc {
         }
 
         else if ((sa_type = dynamic_cast<type::SignedAlgebraicType_ptr>(tp))) {
-            res = new AlgebraicEncoding(sa_type->width(), true, sa_type->dds());
+            res = new AlgebraicEncoding(sa_type->width(), true, sa_type->dds(),
+                                        significant);
         }
 
         else if ((ua_type = dynamic_cast<type::UnsignedAlgebraicType_ptr>(tp))) {
-            res = new AlgebraicEncoding(ua_type->width(), false, ua_type->dds());
+            res = new AlgebraicEncoding(ua_type->width(), false, ua_type->dds(),
+                                        significant);
         }
 
         else if ((etype = dynamic_cast<type::EnumType_ptr>(tp))) {
-            res = new EnumEncoding(etype->literals());
+            res = new EnumEncoding(etype->literals(), enum_encoding(etype));
         }
 
         else if ((vtype = dynamic_cast<type::ArrayType_ptr>(tp))) {
@@ -76,15 +86,119 @@ namespace enc {
             assert(false);
         }
 
-        /* enable DD reordering */
-        f_cudd.AutodynEnable(CUDD_REORDER_SAME);
+        /* enable DD reordering, unless disabled (--dd-reordering) */
+        if (reordering) {
+            f_cudd.AutodynEnable(method);
+        }
 
         assert(NULL != res);
         return res;
     }
 
+    /* more literals than this are log encoded anyway, one-hot and
+       order encodings take a bit per literal */
+    static const unsigned enum_max_unary_literals { 16 };
+
+    enum_encoding_t EncodingMgr::enum_encoding(type::EnumType_ptr type)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        /* a single bit either way */
+        unsigned n { (unsigned) type->literals().size() };
+        if (n <= 2) {
+            return ENUM_ENCODING_LOG;
+        }
+
+        if ("log" == f_enum_encoding) {
+            return ENUM_ENCODING_LOG;
+        }
+        if ("one-hot" == f_enum_encoding) {
+            return ENUM_ENCODING_ONE_HOT;
+        }
+        if ("order" == f_enum_encoding) {
+            return ENUM_ENCODING_ORDER;
+        }
+
+        EnumUses::const_iterator i { f_enum_uses.find(type) };
+        if (f_enum_uses.end() == i || enum_max_unary_literals < n) {
+            return ENUM_ENCODING_LOG;
+        }
+
+        /* sets of literals are intervals in the order encoding, or
+           unions of few of them. Comparisons against literals are
+           conjunctions of a few bits in the one-hot encoding, those
+           between vars are cheaper in the log encoding */
+        const EnumUse& use { i->second };
+        if (use.literal_comparisons + use.var_comparisons < use.set_comparisons) {
+            return ENUM_ENCODING_ORDER;
+        }
+        if (2 * use.var_comparisons < use.literal_comparisons) {
+            return ENUM_ENCODING_ONE_HOT;
+        }
+
+        return ENUM_ENCODING_LOG;
+    }
+
+    void EncodingMgr::set_enum_uses(const EnumUses& uses)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+        f_enum_uses = uses;
+    }
+
+    Encoding_ptr EncodingMgr::make_encoding(type::Type_ptr tp, Encoding_ptr anchor)
+    {
+        assert(NULL != anchor);
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        /* bits of anchor are kept in allocation order */
+        for (const auto& bit : anchor->bits()) {
+            f_anchors.push_back(bit.getNode()->index);
+        }
+
+        /* anchors in excess are not used */
+        Encoding_ptr res { make_encoding(tp) };
+        f_anchors.clear();
+
+        return res;
+    }
+
+    Encoding_ptr EncodingMgr::make_var_encoding(expr::Expr_ptr full, type::Type_ptr tp,
+                                                Encoding_ptr anchor)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        VarWidths::const_iterator i { f_var_widths.find(full) };
+        unsigned significant {
+            f_var_widths.end() != i && tp->is_algebraic() ? i->second : 0
+        };
+
+        if (NULL != anchor) {
+            for (const auto& bit : anchor->bits()) {
+                f_anchors.push_back(bit.getNode()->index);
+            }
+        }
+
+        Encoding_ptr res { make_encoding_aux(tp, significant) };
+        f_anchors.clear();
+
+        return res;
+    }
+
+    void EncodingMgr::set_var_widths(const VarWidths& widths)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+        f_var_widths = widths;
+
+        /* all the encodings of a var have the same bits */
+        for (TimedExpr2EncMap::const_iterator i = f_timed_expr2enc_map.begin();
+             i != f_timed_expr2enc_map.end(); ++i) {
+            f_var_widths.erase(i->first.expr());
+        }
+    }
+
     Encoding_ptr EncodingMgr::find_encoding(const expr::TimedExpr& key)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         const TimedExpr2EncMap::iterator eye { f_timed_expr2enc_map.find(key) };
 
         if (eye != f_timed_expr2enc_map.end()) {
@@ -97,6 +211,7 @@ namespace enc {
 
     void EncodingMgr::register_encoding(const expr::TimedExpr& key, Encoding_ptr enc)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         std::ostringstream oss;
         f_timed_expr2enc_map[key] = enc;
 
@@ -134,13 +249,44 @@ namespace enc {
         : f_cudd { dd::CuddMgr::INSTANCE().dd() }
         , f_em { expr::ExprMgr::INSTANCE() }
         , f_word_width { opts::OptsMgr::INSTANCE().word_width() }
+        , f_enum_encoding { opts::OptsMgr::INSTANCE().enum_encoding() }
     {
         const void* instance { this };
 
+        if ("auto" != f_enum_encoding && "log" != f_enum_encoding &&
+            "one-hot" != f_enum_encoding && "order" != f_enum_encoding) {
+            WARN
+                << "Unknown enum encoding `"
+                << f_enum_encoding
+                << "`, using the default"
+                << std::endl;
+
+            f_enum_encoding = "auto";
+        }
+
         DRIVEL
             << "Initialized EncodingMgr @ " << instance
             << ", native word size is " << f_word_width
             << std::endl;
+
+        /* literals of enum encodings are held by their types */
+        expr::ExprCollector::INSTANCE().add_roots(
+            "encodings", [this](expr::ExprMarker& marker) {
+                boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+                for (TimedExpr2EncMap::const_iterator i = f_timed_expr2enc_map.begin();
+                     i != f_timed_expr2enc_map.end(); ++i) {
+                    marker.mark(i->first.expr());
+                }
+                for (Index2UCBIMap::const_iterator i = f_index2ucbi_map.begin();
+                     i != f_index2ucbi_map.end(); ++i) {
+                    marker.mark(i->second.expr());
+                }
+                for (VarWidths::const_iterator i = f_var_widths.begin();
+                     i != f_var_widths.end(); ++i) {
+                    marker.mark(i->first);
+                }
+            });
     }
 
     EncodingMgr::~EncodingMgr()
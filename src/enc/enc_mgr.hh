@@ -27,8 +27,10 @@
 #ifndef ENCODING_MGR_H
 #define ENCODING_MGR_H
 
+#include <deque>
 #include <vector>
 
+#include <boost/thread/recursive_mutex.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <common/common.hh>
@@ -43,12 +45,52 @@
 #include <dd/cudd_mgr.hh>
 
 #include <enc/ucbi.hh>
+#include <utils/context.hh>
 #include <utils/pool.hh>
 
 namespace enc {
 
     typedef class Encoding* Encoding_ptr; // fwd decl
 
+    /* bits of enum encodings, leaves are literal indices either way */
+    typedef enum {
+        ENUM_ENCODING_LOG,     /* binary index, log2(n) bits */
+        ENUM_ENCODING_ONE_HOT, /* bit i selects literal i, unless a
+                                  lower one is set. n - 1 bits, none
+                                  set selects the last literal */
+        ENUM_ENCODING_ORDER,   /* bit i is set iff the index is
+                                  greater than i, n - 1 bits */
+    } enum_encoding_t;
+
+    /* how the vars of an enum type are used by the model, see
+       model::Analyzer. Drives the choice of their encoding */
+    struct EnumUse {
+        EnumUse()
+            : literal_comparisons(0)
+            , var_comparisons(0)
+            , set_comparisons(0)
+        {}
+
+        /* (in)equalities and assignments against a literal */
+        unsigned literal_comparisons;
+
+        /* ... against another var */
+        unsigned var_comparisons;
+
+        /* ... against a set of literals */
+        unsigned set_comparisons;
+    };
+
+    typedef boost::unordered_map<type::EnumType_ptr, EnumUse,
+                                 utils::PtrHash, utils::PtrEq>
+        EnumUses;
+
+    /* significant bits of the encodings of algebraic vars, by fully
+       qualified var name, see model::RangeAnalyzer */
+    typedef boost::unordered_map<expr::Expr_ptr, unsigned,
+                                 utils::PtrHash, utils::PtrEq>
+        VarWidths;
+
     typedef std::vector<int> IndexVector;
 
     struct ADDHash {
@@ -80,6 +122,15 @@ namespace enc {
             return f_cudd;
         }
 
+        /* CUDD managers are not reentrant: threads operating on the
+           DDs of the encodings (e.g. compilers transferring DDs from
+           and to their own managers) hold this lock. Encodings
+           registration takes it as well */
+        inline boost::recursive_mutex& mutex()
+        {
+            return f_mutex;
+        }
+
         inline ADD one()
         {
             return f_cudd.addOne();
@@ -116,9 +167,18 @@ namespace enc {
             return Cudd_V(x.getNode());
         }
 
+        /* a new DD var, right below the next anchor in the variable
+           order if any (see make_encoding) */
         inline ADD bit()
         {
-            return f_cudd.addVar();
+            if (f_anchors.empty()) {
+                return f_cudd.addVar();
+            }
+
+            int anchor { f_anchors.front() };
+            f_anchors.pop_front();
+
+            return f_cudd.addNewVarAtLevel(1 + f_cudd.ReadPerm(anchor));
         }
 
         inline unsigned nbits()
@@ -129,12 +189,41 @@ namespace enc {
         // Makes a new encoding. Used by the compiler
         Encoding_ptr make_encoding(type::Type_ptr type);
 
+        // Makes a new encoding, whose bits are interleaved with those
+        // of anchor: each one comes right below the bit of anchor in
+        // the same position (i.e. MSB first, for algebraics). Used by
+        // the compiler, for static variable ordering
+        Encoding_ptr make_encoding(type::Type_ptr type, Encoding_ptr anchor);
+
+        // Makes a new encoding for the var of fully qualified name
+        // full (at any time), possibly interleaved with anchor as
+        // above. Algebraic vars of a known range (--narrow-ranges)
+        // only take bits for their significant digits, the others
+        // are constant (or copies of the sign digit)
+        Encoding_ptr make_var_encoding(expr::Expr_ptr full, type::Type_ptr type,
+                                       Encoding_ptr anchor = NULL);
+
+        // The encoding of vars of the enum type, from program
+        // options (--enum-encoding) or, if `auto`, from the uses of
+        // the type
+        enum_encoding_t enum_encoding(type::EnumType_ptr type);
+
+        // Sets the uses of enum types, encodings made from now on
+        // are chosen by them. Used by the model analyzer
+        void set_enum_uses(const EnumUses& uses);
+
+        // Sets the significant bits of algebraic vars, encodings
+        // made from now on by make_var_encoding follow them. Used by
+        // the model manager, after analysis
+        void set_var_widths(const VarWidths& widths);
+
         // Registers an encoding. Used by the compiler
         void register_encoding(const expr::TimedExpr& key, Encoding_ptr enc);
 
         // Retrieves Untimed Canonical Bit Id for index
         inline const UCBI& find_ucbi(int index)
         {
+            boost::recursive_mutex::scoped_lock lock { f_mutex };
             return f_index2ucbi_map.at(index);
         }
 
@@ -149,10 +238,8 @@ namespace enc {
 
         static EncodingMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new EncodingMgr();
-            }
-            return (*f_instance);
+            return utils::Context::current().instance<EncodingMgr>(
+                utils::CONTEXT_ENCODINGS, []() { return new EncodingMgr(); });
         }
 
         inline unsigned word_width() const
@@ -165,7 +252,8 @@ namespace enc {
         ~EncodingMgr();
 
     private:
-        static EncodingMgr_ptr f_instance;
+        /* significant is 0 for all digits */
+        Encoding_ptr make_encoding_aux(type::Type_ptr type, unsigned significant);
 
         Cudd& f_cudd;
         expr::ExprMgr& f_em;
@@ -177,6 +265,17 @@ namespace enc {
         Index2UCBIMap f_index2ucbi_map;
 
         unsigned f_word_width;
+
+        /* from program options, `auto` unless known */
+        std::string f_enum_encoding;
+        EnumUses f_enum_uses;
+
+        VarWidths f_var_widths;
+
+        /* DD var indices new bits are placed below, in order */
+        std::deque<int> f_anchors;
+
+        boost::recursive_mutex f_mutex;
     };
 
 };     // namespace enc
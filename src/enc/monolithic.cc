@@ -42,6 +42,17 @@ namespace enc {
         return res == 0 ? em.make_false() : em.make_true();
     }
 
+    bool BooleanEncoding::assignment(expr::Expr_ptr value, int* assignment)
+    {
+        expr::ExprMgr& em { f_mgr.em() };
+
+        if (!em.is_bool_const(value)) {
+            return false;
+        }
+
+        return assign_digit(f_dv[0].getNode(), em.is_true(value) ? 1 : 0, assignment);
+    }
+
     ADD BooleanEncoding::bit()
     {
         assert(1 == f_dv.size());
@@ -64,10 +75,32 @@ namespace enc {
         return res;
     }
 
-    EnumEncoding::EnumEncoding(const expr::ExprSet& lits)
+    EnumEncoding::EnumEncoding(const expr::ExprSet& lits, enum_encoding_t encoding)
+        : f_encoding(encoding)
     {
-        unsigned nbits { range_repr_bits(lits.size()) };
-        f_dv.push_back(make_monolithic_encoding(nbits));
+        unsigned n { (unsigned) lits.size() };
+
+        /* one-hot and order encodings need a bit at least */
+        if (n < 2) {
+            f_encoding = ENUM_ENCODING_LOG;
+        }
+
+        switch (f_encoding) {
+            case ENUM_ENCODING_LOG:
+                f_dv.push_back(make_monolithic_encoding(range_repr_bits(n)));
+                break;
+
+            case ENUM_ENCODING_ONE_HOT:
+                f_dv.push_back(make_one_hot_encoding(n));
+                break;
+
+            case ENUM_ENCODING_ORDER:
+                f_dv.push_back(make_order_encoding(n));
+                break;
+
+            default:
+                assert(false); /* unreachable */
+        }
 
         value_t v;
         expr::ExprSet::iterator eye;
@@ -78,6 +111,37 @@ namespace enc {
         }
     }
 
+    ADD EnumEncoding::make_one_hot_encoding(unsigned n)
+    {
+        /* bits are made in order, they are in the DD order as well */
+        dd::DDVector bits;
+        for (unsigned i = 0; i < n - 1; ++i) {
+            bits.push_back(make_bit());
+        }
+
+        ADD res { f_mgr.constant(n - 1) };
+        for (unsigned i = n - 1; 0 < i--;) {
+            res = bits[i].Ite(f_mgr.constant(i), res);
+        }
+
+        return res;
+    }
+
+    ADD EnumEncoding::make_order_encoding(unsigned n)
+    {
+        dd::DDVector bits;
+        for (unsigned i = 0; i < n - 1; ++i) {
+            bits.push_back(make_bit());
+        }
+
+        ADD res { f_mgr.constant(n - 1) };
+        for (unsigned i = n - 1; 0 < i--;) {
+            res = bits[i].Ite(res, f_mgr.constant(i));
+        }
+
+        return res;
+    }
+
     value_t EnumEncoding::value(expr::Expr_ptr lit)
     {
         ExprValueMap::iterator eye { f_e2v_map.find(lit) };
@@ -86,6 +150,16 @@ namespace enc {
         return (*eye).second;
     }
 
+    bool EnumEncoding::assignment(expr::Expr_ptr value, int* assignment)
+    {
+        ExprValueMap::const_iterator eye { f_e2v_map.find(value) };
+        if (f_e2v_map.end() == eye) {
+            return false;
+        }
+
+        return assign_digit(f_dv[0].getNode(), (*eye).second, assignment);
+    }
+
     expr::Expr_ptr EnumEncoding::expr(int* assignment)
     {
         ADD eval { f_dv[0].Eval(assignment) };
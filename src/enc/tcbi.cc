@@ -64,9 +64,7 @@ namespace enc {
     long TCBIHash::operator()(const TCBI& k) const
     {
         long x, res = 0;
-        expr::ExprHash eh;
-
-        long v0 { eh(*k.expr()) };
+        long v0 { (long) k.expr()->id() };
         long v1 { k.absolute_time() };
         long v2 { k.bitno() };
 
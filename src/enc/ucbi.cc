@@ -60,9 +60,7 @@ namespace enc {
     long UCBIHash::operator()(const UCBI& k) const
     {
         long x, res { 0 };
-        expr::ExprHash eh;
-
-        long v0 { eh(*k.expr()) };
+        long v0 { (long) k.expr()->id() };
         long v1 { k.time() };
         long v2 { k.bitno() };
 
@@ -22,6 +22,11 @@
 
 #include <environment.hh>
 
+#include <expr/collector.hh>
+
+#include <utils/context.hh>
+
+#include <algorithm>
 #include <sstream>
 #include <string>
 
@@ -39,14 +44,30 @@ namespace env {
         return oss.str();
     }
 
-    Environment_ptr Environment::f_instance = NULL;
     Environment& Environment::INSTANCE()
     {
-        if (!f_instance) {
-            f_instance = new Environment();
-        }
+        return utils::Context::current().instance<Environment>(
+            utils::CONTEXT_ENVIRONMENT, []() { return new Environment(); });
+    }
 
-        return *f_instance;
+    Environment::Environment()
+    {
+        expr::ExprCollector::INSTANCE().add_roots(
+            "environment", [this](expr::ExprMarker& marker) {
+                for (Expr2ExprMap::const_iterator i = f_env.begin();
+                     i != f_env.end(); ++i) {
+                    marker.mark(i->first);
+                    marker.mark(i->second);
+                }
+                for (expr::ExprSet::const_iterator i = f_identifiers.begin();
+                     i != f_identifiers.end(); ++i) {
+                    marker.mark(*i);
+                }
+
+                marker.mark(f_extra_inits);
+                marker.mark(f_extra_invars);
+                marker.mark(f_extra_transes);
+            });
     }
 
     expr::Expr_ptr Environment::get(expr::Expr_ptr id) const
@@ -106,4 +127,32 @@ namespace env {
         f_extra_transes.push_back(constraint);
     }
 
+    static bool remove_extra(expr::ExprVector& extras, expr::Expr_ptr constraint)
+    {
+        expr::ExprVector::iterator i {
+            std::find(extras.begin(), extras.end(), constraint)
+        };
+        if (extras.end() == i) {
+            return false;
+        }
+
+        extras.erase(i);
+        return true;
+    }
+
+    bool Environment::remove_extra_init(expr::Expr_ptr constraint)
+    {
+        return remove_extra(f_extra_inits, constraint);
+    }
+
+    bool Environment::remove_extra_invar(expr::Expr_ptr constraint)
+    {
+        return remove_extra(f_extra_invars, constraint);
+    }
+
+    bool Environment::remove_extra_trans(expr::Expr_ptr constraint)
+    {
+        return remove_extra(f_extra_transes, constraint);
+    }
+
 }; // namespace env
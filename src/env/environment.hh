@@ -76,25 +76,33 @@ namespace env {
             return f_identifiers;
         }
 
+        /* extra constraints are compiled on their own, adding or
+           removing them leaves the compiled FSM alone. Removals are
+           false iff constraint was not there */
         void add_extra_init(expr::Expr_ptr constraint);
+        bool remove_extra_init(expr::Expr_ptr constraint);
         inline const expr::ExprVector& extra_init() const
         {
             return f_extra_inits;
         }
 
         void add_extra_invar(expr::Expr_ptr constraint);
+        bool remove_extra_invar(expr::Expr_ptr constraint);
         inline const expr::ExprVector& extra_invar() const
         {
             return f_extra_invars;
         }
 
         void add_extra_trans(expr::Expr_ptr constraint);
+        bool remove_extra_trans(expr::Expr_ptr constraint);
         inline const expr::ExprVector& extra_trans() const
         {
             return f_extra_transes;
         }
 
     private:
+        Environment();
+
         /* input vars */
         Expr2ExprMap f_env;
         expr::ExprSet f_identifiers;
@@ -104,8 +112,6 @@ namespace env {
         expr::ExprVector f_extra_inits;
         expr::ExprVector f_extra_invars;
         expr::ExprVector f_extra_transes;
-
-        static Environment_ptr f_instance;
     };
 
 }; // namespace env
@@ -20,17 +20,20 @@
  * 02110-1301 USA
  *
  **/
+#include <cassert>
+#include <cstring>
+
 #include <atom.hh>
 
 namespace expr {
 
-    long AtomHash::operator()(const Atom& k) const
+    static inline unsigned long atom_hash(const char* name, size_t len)
     {
         unsigned long hash { 0 };
         unsigned long x { 0 };
 
-        for (std::size_t i = 0; i < k.length(); i++) {
-            hash = (hash << 4) + k[i];
+        for (std::size_t i = 0; i < len; i++) {
+            hash = (hash << 4) + name[i];
             if ((x = hash & 0xF0000000L) != 0) {
                 hash ^= (x >> 24);
             }
@@ -40,9 +43,111 @@ namespace expr {
         return hash;
     }
 
+    /* the shard comes from the high bits, the slot from the low ones */
+    static inline unsigned long atom_scramble(unsigned long hash)
+    {
+        hash *= 0x9E3779B97F4A7C15UL;
+        return hash ^ (hash >> 29);
+    }
+
+    long AtomHash::operator()(const Atom& k) const
+    {
+        return atom_hash(k.data(), k.length());
+    }
+
     bool AtomEq::operator()(const Atom& x, const Atom& y) const
     {
         return x == y;
     }
 
+    AtomTable::AtomTable()
+        : f_next(0)
+    {
+        for (auto& chunk : f_chunks) {
+            chunk.store(NULL);
+        }
+
+        for (auto& shard : f_shards) {
+            shard.index.resize(256, Slot { 0, 0, false });
+            shard.size = 0;
+        }
+    }
+
+    AtomTable::~AtomTable()
+    {
+        for (auto& chunk : f_chunks) {
+            delete[] chunk.load();
+        }
+    }
+
+    atom_t AtomTable::intern(const char* name, size_t len)
+    {
+        unsigned long hash { atom_scramble(atom_hash(name, len)) };
+        Shard& shard { f_shards[(hash >> 58) % N_SHARDS] };
+
+        boost::mutex::scoped_lock lock { shard.mutex };
+
+        if (shard.index.size() <= 2 * shard.size) {
+            grow(shard);
+        }
+
+        size_t mask { shard.index.size() - 1 };
+        size_t i { hash & mask };
+        for (; shard.index[i].used; i = (i + 1) & mask) {
+            const Slot& slot { shard.index[i] };
+
+            if (slot.hash == hash) {
+                const Atom& candidate { atom(slot.id) };
+                if (candidate.size() == len &&
+                    0 == memcmp(candidate.data(), name, len)) {
+                    return slot.id;
+                }
+            }
+        }
+
+        atom_t res { make_atom(name, len) };
+        shard.index[i] = Slot { hash, res, true };
+        ++shard.size;
+
+        return res;
+    }
+
+    atom_t AtomTable::make_atom(const char* name, size_t len)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        atom_t res { f_next.load() };
+        assert((res >> ATOM_CHUNK_BITS) < ATOM_MAX_CHUNKS);
+
+        std::atomic<Atom*>& chunk { f_chunks[res >> ATOM_CHUNK_BITS] };
+        if (0 == (res & (ATOM_CHUNK_SIZE - 1))) {
+            chunk.store(new Atom[ATOM_CHUNK_SIZE], std::memory_order_release);
+        }
+
+        chunk.load()[res & (ATOM_CHUNK_SIZE - 1)].assign(name, len);
+        f_next.store(1 + res);
+
+        return res;
+    }
+
+    void AtomTable::grow(Shard& shard)
+    {
+        std::vector<Slot> index(2 * shard.index.size(), Slot { 0, 0, false });
+        size_t mask { index.size() - 1 };
+
+        for (const auto& slot : shard.index) {
+            if (!slot.used) {
+                continue;
+            }
+
+            size_t i { slot.hash & mask };
+            while (index[i].used) {
+                i = (i + 1) & mask;
+            }
+            index[i] = slot;
+        }
+
+        shard.index.swap(index);
+    }
+
 } // namespace expr
@@ -27,9 +27,11 @@
 #ifndef ATOM_POOL_H
 #define ATOM_POOL_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include <boost/thread/mutex.hpp>
 #include <boost/unordered_set.hpp>
 
 namespace expr {
@@ -46,10 +48,73 @@ namespace expr {
         bool operator()(const Atom& x, const Atom& y) const;
     };
 
-    typedef boost::unordered_set<Atom, AtomHash, AtomEq> AtomPool;
-    typedef std::pair<AtomPool::iterator, bool> AtomPoolHit;
-
     typedef std::vector<Atom> AtomVector;
+
+    /* dense ids of interned atoms */
+    typedef unsigned atom_t;
+
+    const unsigned ATOM_CHUNK_BITS = 12;
+    const unsigned ATOM_CHUNK_SIZE = 1 << ATOM_CHUNK_BITS;
+    const unsigned ATOM_MAX_CHUNKS = 1 << 14;
+
+    /* the symbol table of atoms. Atoms are stored in chunks that
+     * never move, indexed by id, so that they can be read with no
+     * lock while others are being interned. Names are looked up by
+     * their chars in a sharded index of ids, a hit allocates
+     * nothing. */
+    class AtomTable {
+    public:
+        AtomTable();
+        ~AtomTable();
+
+        /* the id of the len chars at name, interned on first use */
+        atom_t intern(const char* name, size_t len);
+
+        inline atom_t intern(const Atom& atom)
+        {
+            return intern(atom.data(), atom.size());
+        }
+
+        inline const Atom& atom(atom_t id) const
+        {
+            return f_chunks[id >> ATOM_CHUNK_BITS].load(std::memory_order_acquire)
+                [id & (ATOM_CHUNK_SIZE - 1)];
+        }
+
+        /* number of interned atoms */
+        inline size_t size() const
+        {
+            return f_next.load();
+        }
+
+    private:
+        static const unsigned N_SHARDS = 64;
+
+        /* free slots have no atom */
+        struct Slot {
+            unsigned long hash;
+            atom_t id;
+            bool used;
+        };
+
+        struct Shard {
+            boost::mutex mutex;
+            std::vector<Slot> index;
+            size_t size;
+        };
+
+        /* a new id, for name */
+        atom_t make_atom(const char* name, size_t len);
+
+        void grow(Shard& shard);
+
+        Shard f_shards[N_SHARDS];
+
+        /* guards id allocation */
+        boost::mutex f_mutex;
+        std::atomic<Atom*> f_chunks[ATOM_MAX_CHUNKS];
+        std::atomic<atom_t> f_next;
+    };
 } // namespace expr
 
 #endif /* ATOM_POOL_H */
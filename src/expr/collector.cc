@@ -0,0 +1,260 @@
+/**
+ * @file collector.cc
+ * @brief Expression management, collection of unreachable exprs
+ *
+ * This module contains definitions and services that implement the
+ * collector of unreachable exprs.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <ctime>
+
+#include <expr/collector.hh>
+#include <expr/expr_mgr.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/clock.hh>
+#include <utils/logging.hh>
+
+namespace expr {
+
+    /* leaves have no subexprs, the operands of UNDEF are garbage */
+    static inline bool is_leaf(ExprType symb)
+    {
+        return IDENT == symb || QSTRING == symb || UNDEF == symb ||
+               (ICONST <= symb && symb <= INSTANT);
+    }
+
+    ExprMarker::ExprMarker(unsigned n_ids)
+        : f_marks(n_ids, false)
+        , f_n_marked(0)
+    {}
+
+    void ExprMarker::mark(Expr_ptr expr)
+    {
+        if (NULL == expr || is_marked(expr)) {
+            return;
+        }
+
+        f_marks[expr->id()] = true;
+        ++f_n_marked;
+        f_stack.push_back(expr);
+
+        while (!f_stack.empty()) {
+            Expr_ptr top { f_stack.back() };
+            f_stack.pop_back();
+
+            if (is_leaf(top->symb())) {
+                continue;
+            }
+
+            for (Expr_ptr child : { top->lhs(), top->rhs() }) {
+                if (NULL != child && !is_marked(child)) {
+                    f_marks[child->id()] = true;
+                    ++f_n_marked;
+                    f_stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    ExprCollector& ExprCollector::INSTANCE()
+    {
+        /* made on first use, concurrent first uses wait for it */
+        static ExprCollector_ptr instance { new ExprCollector() };
+        return *instance;
+    }
+
+    ExprCollector::ExprCollector()
+        : f_next_handle(0)
+        , f_pins(0)
+        , f_requested(false)
+        , f_last_made(0)
+    {
+        f_stats.collections = 0;
+        f_stats.freed = 0;
+        f_stats.last_freed = 0;
+        f_stats.last_live = 0;
+
+        const void* instance { this };
+        DEBUG
+            << "ExprCollector @"
+            << instance
+            << " initialized"
+            << std::endl;
+    }
+
+    ExprCollector::~ExprCollector()
+    {
+        const void* instance { this };
+        DEBUG
+            << "Destroyed ExprCollector @"
+            << instance
+            << std::endl;
+    }
+
+    unsigned ExprCollector::add(const std::string& name, ExprRoots marker, bool cache)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Registration registration { ++f_next_handle, name, marker, cache };
+        f_registrations.push_back(registration);
+
+        return registration.handle;
+    }
+
+    unsigned ExprCollector::add_roots(const std::string& name, ExprRoots roots)
+    {
+        return add(name, roots, false);
+    }
+
+    unsigned ExprCollector::add_cache(const std::string& name, ExprCachePruner pruner)
+    {
+        return add(name, pruner, true);
+    }
+
+    void ExprCollector::remove(unsigned handle)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_registrations.erase(
+            std::remove_if(f_registrations.begin(), f_registrations.end(),
+                           [handle](const Registration& registration) {
+                               return handle == registration.handle;
+                           }),
+            f_registrations.end());
+    }
+
+    void ExprCollector::pin()
+    {
+        /* waits for a running collection to be over */
+        boost::mutex::scoped_lock lock { f_collect_mutex };
+        ++f_pins;
+    }
+
+    void ExprCollector::unpin()
+    {
+        assert(0 < f_pins);
+        --f_pins;
+    }
+
+    void ExprCollector::request()
+    {
+        f_requested = true;
+    }
+
+    void ExprCollector::safe_point()
+    {
+        boost::mutex::scoped_lock lock { f_collect_mutex };
+
+        if (0 < f_pins || (!f_requested && !due())) {
+            return;
+        }
+
+        collect_aux();
+    }
+
+    size_t ExprCollector::collect()
+    {
+        boost::mutex::scoped_lock lock { f_collect_mutex };
+        return collect_aux();
+    }
+
+    ExprCollectorStats ExprCollector::stats()
+    {
+        boost::mutex::scoped_lock lock { f_collect_mutex };
+        return f_stats;
+    }
+
+    bool ExprCollector::due()
+    {
+        unsigned threshold { opts::OptsMgr::INSTANCE().gc_threshold() };
+        if (0 == threshold) {
+            return false;
+        }
+
+        /* the live set is not marked again before it has doubled, at
+           least */
+        size_t made { ExprMgr::INSTANCE().made() - f_last_made };
+        return std::max<size_t>(threshold, f_stats.last_live) <= made;
+    }
+
+    size_t ExprCollector::collect_aux()
+    {
+        ExprMgr& em { ExprMgr::INSTANCE() };
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        std::vector<Registration> registrations;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            registrations = f_registrations;
+        }
+
+        ExprMarker marker { em.made() };
+        em.mark_builtins(marker);
+
+        /* roots first, caches keep what they refer to */
+        for (const auto& registration : registrations) {
+            if (!registration.cache) {
+                registration.marker(marker);
+            }
+        }
+        for (const auto& registration : registrations) {
+            if (registration.cache) {
+                registration.marker(marker);
+            }
+        }
+
+        size_t res { em.sweep(marker) };
+
+        size_t live, bytes;
+        em.pool_stats(live, bytes);
+
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        ++f_stats.collections;
+        f_stats.freed += res;
+        f_stats.last_freed = res;
+        f_stats.last_live = live;
+        f_stats.last_elapsed = utils::elapsed_repr(start, end);
+
+        f_last_made = em.made();
+        f_requested = false;
+
+        INFO
+            << "Collected "
+            << res
+            << " exprs, "
+            << live
+            << " live ("
+            << (bytes >> 10)
+            << " KB), took "
+            << f_stats.last_elapsed
+            << std::endl;
+
+        return res;
+    }
+
+}; // namespace expr
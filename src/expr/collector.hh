@@ -0,0 +1,195 @@
+/**
+ * @file collector.hh
+ * @brief Expression management, collection of unreachable exprs
+ *
+ * This header file contains the declarations required by the
+ * collector of the exprs no module refers to anymore (e.g. the
+ * temporaries of preprocessing, or of witness printing). Collection
+ * is mark and sweep: modules holding exprs across commands register
+ * roots, which mark the exprs they hold, and caches, which drop the
+ * entries whose keys were not marked (and mark the others) once all
+ * roots are marked. Everything else is returned to the pools.
+ *
+ * Exprs are hash-consed, a holder which is not a root would see its
+ * exprs replaced by others after a collection. Collections thus only
+ * take place at safe points (i.e. between command lines), when no
+ * command is running: commands pin the collector for as long as they
+ * hold parsed exprs.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef EXPR_COLLECTOR_H
+#define EXPR_COLLECTOR_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <expr/expr.hh>
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace expr {
+
+    /* the live exprs, during a collection */
+    class ExprMarker {
+    public:
+        /* n_ids is the number of exprs pooled so far */
+        ExprMarker(unsigned n_ids);
+
+        /* expr and its subexprs are live, NULL is ignored */
+        void mark(Expr_ptr expr);
+
+        inline void mark(const ExprVector& exprs)
+        {
+            for (auto expr : exprs) {
+                mark(expr);
+            }
+        }
+
+        /* exprs pooled after the marker was made are live, and so
+           is NULL */
+        inline bool is_marked(const Expr_ptr expr) const
+        {
+            if (NULL == expr) {
+                return true;
+            }
+
+            unsigned id { expr->id() };
+            return f_marks.size() <= id || f_marks[id];
+        }
+
+        inline size_t n_marked() const
+        {
+            return f_n_marked;
+        }
+
+    private:
+        std::vector<bool> f_marks;
+        ExprVector f_stack;
+        size_t f_n_marked;
+    };
+
+    /* marks the exprs held by a module */
+    typedef boost::function<void(ExprMarker&)> ExprRoots;
+
+    /* drops the entries of a cache whose keys are not marked, and
+       marks the exprs of the others */
+    typedef boost::function<void(ExprMarker&)> ExprCachePruner;
+
+    struct ExprCollectorStats {
+        unsigned collections;
+
+        /* over all collections */
+        unsigned long freed;
+
+        /* figures of the last collection */
+        size_t last_freed;
+        size_t last_live;
+        std::string last_elapsed;
+    };
+
+    typedef class ExprCollector* ExprCollector_ptr;
+
+    class ExprCollector {
+    public:
+        static ExprCollector& INSTANCE();
+
+        /* registrations last until remove() is called with the
+           returned handle, singletons never do */
+        unsigned add_roots(const std::string& name, ExprRoots roots);
+        unsigned add_cache(const std::string& name, ExprCachePruner pruner);
+        void remove(unsigned handle);
+
+        /* exprs are held outside of the roots until unpin() is called
+           (e.g. by a running command), no collection takes place
+           meanwhile. Pins can be released by another thread */
+        void pin();
+        void unpin();
+
+        /* a collection takes place at the next safe point */
+        void request();
+
+        /* the caller holds no expr outside of the roots: a collection
+           takes place if one was requested, or if enough exprs were
+           pooled since the last one (--gc-threshold), unless pinned */
+        void safe_point();
+
+        /* collects now, returns the number of exprs freed. The caller
+           must be at a safe point */
+        size_t collect();
+
+        ExprCollectorStats stats();
+
+    protected:
+        ExprCollector();
+        ~ExprCollector();
+
+    private:
+        struct Registration {
+            unsigned handle;
+            std::string name;
+            ExprRoots marker;
+            bool cache;
+        };
+
+        unsigned add(const std::string& name, ExprRoots marker, bool cache);
+
+        bool due();
+        size_t collect_aux();
+
+        /* guards the registrations */
+        boost::mutex f_mutex;
+        std::vector<Registration> f_registrations;
+        unsigned f_next_handle;
+
+        /* held by collections, pins wait for them to be over */
+        boost::mutex f_collect_mutex;
+        std::atomic<unsigned> f_pins;
+        std::atomic<bool> f_requested;
+
+        /* exprs pooled so far, as of the last collection */
+        unsigned f_last_made;
+
+        ExprCollectorStats f_stats;
+    };
+
+    /* pins the collector, for the lifetime of the guard */
+    class ExprGuard {
+    public:
+        inline ExprGuard()
+        {
+            ExprCollector::INSTANCE().pin();
+        }
+
+        inline ~ExprGuard()
+        {
+            ExprCollector::INSTANCE().unpin();
+        }
+
+    private:
+        ExprGuard(const ExprGuard&);
+        ExprGuard& operator=(const ExprGuard&);
+    };
+
+}; // namespace expr
+
+#endif /* EXPR_COLLECTOR_H */
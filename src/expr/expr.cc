@@ -75,12 +75,12 @@ namespace expr {
         throw BadSymbol(expr);
     }
 
-    Atom& Expr_TAG::atom() const
+    const Atom& Expr_TAG::atom() const
     {
         Expr_ptr expr { const_cast<Expr_ptr>(this) };
 
         if (IDENT == f_symb || QSTRING == f_symb) {
-            return *u.f_atom;
+            return ExprMgr::INSTANCE().atom(u.f_atom);
         }
 
         throw BadSymbol(expr);
@@ -116,35 +116,32 @@ namespace expr {
 
     long ExprHash::operator()(const Expr& k) const
     {
-        if (k.f_symb == IDENT) {
-            return (long) (k.u.f_atom);
+        if (k.f_symb == IDENT || k.f_symb == QSTRING) {
+            return ((long) (k.f_symb) << 32) | (long) (k.u.f_atom);
         }
 
-        long v0, v1, x, res { (long) (k.f_symb) };
+        unsigned long v0, v1, res { (unsigned long) (k.f_symb) };
 
         if (k.f_symb == ICONST || k.f_symb == HCONST ||
             k.f_symb == BCONST || k.f_symb == OCONST ||
             k.f_symb == INSTANT) {
-            v0 = (long) (k.u.f_value);
-            v1 = (long) (k.u.f_value >> sizeof(long));
+            v0 = (unsigned long) (k.u.f_value);
+            v1 = 0;
         } else {
-            v0 = (long) (k.u.f_lhs);
-            v1 = (long) (k.u.f_rhs);
+            /* children are pooled already, their ids are dense */
+            v0 = k.u.f_lhs ? 1 + k.u.f_lhs->f_id : 0;
+            v1 = k.u.f_rhs ? 1 + k.u.f_rhs->f_id : 0;
         }
 
-        res = (res << 4) + v0;
-        if ((x = res & 0xF0000000L) != 0) {
-            res ^= (x >> 24);
-        }
-        res &= ~x;
+        res = (res ^ v0) * 0x100000001B3UL;
+        res = (res ^ v1) * 0x100000001B3UL;
 
-        res = (res << 4) + v1;
-        if ((x = res & 0xF0000000L) != 0) {
-            res ^= (x >> 24);
-        }
-        res &= ~x;
+        return (long) res;
+    }
 
-        return res;
+    long ExprIdHash::operator()(const Expr_ptr expr) const
+    {
+        return (long) expr->f_id;
     }
 
     bool ExprEq::operator()(const Expr& x, const Expr& y) const
@@ -154,8 +151,8 @@ namespace expr {
             x.f_symb == y.f_symb &&
 
             (
-                /* ...either have the same identifier */
-                (x.f_symb == IDENT && *x.u.f_atom == *y.u.f_atom) ||
+                /* ...either have the same atom (ids are unique) */
+                ((x.f_symb == IDENT || x.f_symb == QSTRING) && x.u.f_atom == y.u.f_atom) ||
 
                 /* ...or have the same constant value */
                 (x.f_symb >= ICONST && x.f_symb <= INSTANT && x.u.f_value == y.u.f_value) ||
@@ -26,6 +26,7 @@
 #ifndef EXPR_H
 #define EXPR_H
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -161,9 +162,12 @@ namespace expr {
         // AST symb type
         ExprType f_symb;
 
+        // dense sequential id, given on pooling
+        unsigned f_id;
+
         union {
-            // identifiers
-            Atom_ptr f_atom;
+            // identifiers and strings, by atom id
+            atom_t f_atom;
 
             // numeric constants
             value_t f_value;
@@ -181,7 +185,12 @@ namespace expr {
             return f_symb;
         }
 
-        Atom& atom() const;
+        inline unsigned id() const
+        {
+            return f_id;
+        }
+
+        const Atom& atom() const;
         value_t value() const;
 
         inline Expr_ptr lhs()
@@ -194,16 +203,22 @@ namespace expr {
         }
 
         // identifiers and strings
-        inline Expr_TAG(ExprType symb, const Atom& atom)
+        inline Expr_TAG(ExprType symb, atom_t atom)
+            : f_symb(symb)
+            , f_id(0)
         {
             assert(IDENT == symb || QSTRING == symb);
-            f_symb = symb;
-            u.f_atom = const_cast<Atom*>(&atom);
+
+            /* no stale bits, for hashing */
+            u.f_lhs = NULL;
+            u.f_rhs = NULL;
+            u.f_atom = atom;
         }
 
         // binary expr (rhs is NULL for unary ops)
         inline Expr_TAG(ExprType symb, Expr_ptr lhs, Expr_ptr rhs)
             : f_symb(symb)
+            , f_id(0)
         {
             u.f_lhs = lhs;
             u.f_rhs = rhs;
@@ -212,6 +227,7 @@ namespace expr {
         // numeric constants, are treated as machine size consts.
         inline Expr_TAG(ExprType symb, value_t value)
             : f_symb(symb)
+            , f_id(0)
         {
             assert(symb == ICONST ||
                    symb == HCONST ||
@@ -225,6 +241,7 @@ namespace expr {
         // nullary nodes (errors, undefined)
         inline Expr_TAG(ExprType symb)
             : f_symb(symb)
+            , f_id(0)
         {
             assert(symb == UNDEF);
         }
@@ -243,16 +260,64 @@ namespace expr {
 
     std::ostream& operator<<(std::ostream& os, const Expr_ptr expr);
 
+    /* the live exprs of a collection, see expr/collector.hh */
+    class ExprMarker;
+
+    /* a map of pooled exprs to values, stored flat by expr id */
+    template <typename T>
+    class ExprIdMap {
+    public:
+        /* NULL iff no value was set for expr */
+        inline const T* find(const Expr_ptr expr) const
+        {
+            unsigned id { expr->id() };
+            return id < f_known.size() && f_known[id] ? &f_values[id] : NULL;
+        }
+
+        inline void set(const Expr_ptr expr, const T& value)
+        {
+            unsigned id { expr->id() };
+            if (f_values.size() <= id) {
+                size_t size { std::max<size_t>(1024, 2 * (size_t) id) };
+                f_values.resize(size);
+                f_known.resize(size, false);
+            }
+
+            f_values[id] = value;
+            f_known[id] = true;
+        }
+
+        inline void erase(const Expr_ptr expr)
+        {
+            unsigned id { expr->id() };
+            if (id < f_known.size()) {
+                f_known[id] = false;
+            }
+        }
+
+        inline void clear()
+        {
+            f_values.clear();
+            f_known.clear();
+        }
+
+    private:
+        std::vector<T> f_values;
+        std::vector<bool> f_known;
+    };
+
     struct ExprHash {
         long operator()(const Expr& k) const;
     };
 
+    /* pointers to pooled exprs, hashed by id */
+    struct ExprIdHash {
+        long operator()(const Expr_ptr expr) const;
+    };
+
     struct ExprEq {
         bool operator()(const Expr& x, const Expr& y) const;
     };
 
-    typedef boost::unordered_set<Expr, ExprHash, ExprEq> ExprPool;
-    typedef std::pair<ExprPool::iterator, bool> ExprPoolHit;
-
 };     // namespace expr
 #endif /* EXPR_H */
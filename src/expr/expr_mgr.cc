@@ -22,20 +22,23 @@
  **/
 
 #include <cmath>
+#include <cstring>
 #include <common/common.hh>
 #include <expr_mgr.hh>
 
+#include <expr/collector.hh>
+
 #include <stack>
 #include <vector>
 
 #include <utils/logging.hh>
+#include <utils/memory.hh>
 
 namespace expr {
 
     // singleton instance initialization
-    ExprMgr_ptr ExprMgr::f_instance = NULL;
-
     ExprMgr::ExprMgr()
+        : f_next_id(0)
     {
         const void* instance { this };
 
@@ -76,6 +79,14 @@ namespace expr {
         array_expr = make_identifier(ARRAY_TOKEN);
         empty_expr = make_identifier(EMPTY_TOKEN);
 
+        utils::MemoryMgr::INSTANCE()
+            .add_probe("exprs", [this]() {
+                size_t exprs, bytes;
+                pool_stats(exprs, bytes);
+
+                return bytes;
+            });
+
         DEBUG
             << "ExprMgr @"
             << instance
@@ -107,44 +118,72 @@ namespace expr {
         return make_set(res);
     }
 
-    const Atom& ExprMgr::internalize(Atom atom)
+    const Atom& ExprMgr::internalize(const Atom& atom)
     {
-        boost::mutex::scoped_lock lock { f_atom_mutex };
+        return f_atoms.atom(f_atoms.intern(atom));
+    }
 
-        AtomPoolHit ah { f_atom_pool.insert(atom) };
-        const Atom& pooled_atom { *ah.first };
+    Expr_ptr ExprMgr::make_identifier(const Atom& atom)
+    {
+        return make_expr(IDENT, f_atoms.intern(atom));
+    }
 
-        return pooled_atom;
+    Expr_ptr ExprMgr::make_identifier(const char* name)
+    {
+        return make_expr(IDENT, f_atoms.intern(name, strlen(name)));
+    }
+
+    Expr_ptr ExprMgr::make_qstring(const Atom& atom)
+    {
+        return make_expr(QSTRING, f_atoms.intern(atom));
     }
 
-    Expr_ptr ExprMgr::make_identifier(Atom atom)
+    Expr_ptr ExprMgr::__make_expr(Expr_ptr expr)
     {
-        boost::mutex::scoped_lock lock { f_atom_mutex };
+        ExprPoolShard& shard { f_expr_shards[shard_index(ExprHash()(*expr))] };
+        boost::mutex::scoped_lock lock { shard.mutex };
 
-        AtomPoolHit ah { f_atom_pool.insert(atom) };
-        const Atom& pooled_atom { *ah.first };
+        bool fresh;
+        Expr_ptr res { shard.pool.insert(*expr, fresh) };
+        if (fresh) {
+            res->f_id = f_next_id++;
+        }
 
-        return make_expr(IDENT, pooled_atom);
+        return res;
     }
 
-    Expr_ptr ExprMgr::make_qstring(Atom atom)
+    void ExprMgr::pool_stats(size_t& exprs, size_t& bytes)
     {
-        boost::mutex::scoped_lock lock { f_atom_mutex };
+        exprs = 0;
+        bytes = 0;
 
-        AtomPoolHit ah { f_atom_pool.insert(atom) };
-        const Atom& pooled_atom { *ah.first };
+        for (auto& shard : f_expr_shards) {
+            boost::mutex::scoped_lock lock { shard.mutex };
 
-        return make_expr(QSTRING, pooled_atom);
+            exprs += shard.pool.size();
+            bytes += shard.pool.bytes();
+        }
     }
 
-    Expr_ptr ExprMgr::__make_expr(Expr_ptr expr)
+    void ExprMgr::mark_builtins(ExprMarker& marker)
     {
-        boost::mutex::scoped_lock lock { f_expr_mutex };
+        for (Expr_ptr expr : { time_expr, bool_expr, string_expr, false_expr,
+                               true_expr, const_int_expr, unsigned_int_expr,
+                               signed_int_expr, array_expr, empty_expr }) {
+            marker.mark(expr);
+        }
+    }
 
-        ExprPoolHit eh { f_expr_pool.insert(*expr) };
-        Expr_ptr pooled_expr { const_cast<Expr_ptr>(&(*eh.first)) };
+    size_t ExprMgr::sweep(const ExprMarker& marker)
+    {
+        size_t res { 0 };
 
-        return pooled_expr;
+        for (auto& shard : f_expr_shards) {
+            boost::mutex::scoped_lock lock { shard.mutex };
+            res += shard.pool.sweep(marker);
+        }
+
+        return res;
     }
 
     Expr_ptr ExprMgr::left_associate_dot(const Expr_ptr expr)
@@ -30,11 +30,22 @@
 #include <boost/thread/mutex.hpp>
 
 #include <expr/expr.hh>
+#include <expr/pool.hh>
 
 #include <opts/opts_mgr.hh>
 
 namespace expr {
 
+    /* hash-consing pools are split in shards, each guarded by a lock
+       of its own. Equal keys hash the same, hence they always meet in
+       the same shard and uniqueness is preserved */
+    const unsigned EXPR_POOL_SHARDS = 64;
+
+    struct ExprPoolShard {
+        boost::mutex mutex;
+        ExprPool pool;
+    };
+
     typedef class ExprMgr* ExprMgr_ptr;
     class ExprMgr {
     public:
@@ -506,6 +517,14 @@ namespace expr {
             return make_expr(SUBSCRIPT, a, b);
         }
 
+        /* expr's operator over other operands (rhs is NULL for unary
+           ops), for rewritings. Not for leaves */
+        inline Expr_ptr make_like(const Expr_ptr expr, Expr_ptr lhs, Expr_ptr rhs)
+        {
+            assert(NULL != lhs);
+            return make_expr(expr->f_symb, lhs, rhs);
+        }
+
         inline Expr_ptr make_array(Expr_ptr a)
         {
             return make_expr(ARRAY, a, NULL);
@@ -671,7 +690,7 @@ namespace expr {
 
         inline Expr_ptr make_zero()
         {
-            Expr tmp(ICONST, 0); // we need a temp store
+            Expr tmp(ICONST, (value_t) 0); // we need a temp store
             return __make_expr(&tmp);
         }
 
@@ -683,7 +702,7 @@ namespace expr {
 
         inline Expr_ptr make_one()
         {
-            Expr tmp(ICONST, 1); // we need a temp store
+            Expr tmp(ICONST, (value_t) 1); // we need a temp store
             return __make_expr(&tmp);
         }
 
@@ -739,7 +758,10 @@ namespace expr {
             return expr->f_symb == IDENT;
         }
 
-        Expr_ptr make_identifier(Atom atom);
+        Expr_ptr make_identifier(const Atom& atom);
+
+        /* no string is built, unless name is a new atom */
+        Expr_ptr make_identifier(const char* name);
 
         inline bool is_qstring(const Expr_ptr expr) const
         {
@@ -747,9 +769,44 @@ namespace expr {
             return expr->f_symb == QSTRING;
         }
 
-        Expr_ptr make_qstring(Atom atom);
+        Expr_ptr make_qstring(const Atom& atom);
+
+        const Atom& internalize(const Atom& atom);
+
+        /* the atom of an identifier or string, by id */
+        inline const Atom& atom(atom_t id) const
+        {
+            return f_atoms.atom(id);
+        }
+
+        /* pooled exprs and the memory they take, over all shards */
+        void pool_stats(size_t& exprs, size_t& bytes);
+
+        /* exprs pooled so far, collected ones included */
+        inline unsigned made() const
+        {
+            return f_next_id.load();
+        }
 
-        const Atom& internalize(Atom atom);
+        /* -- collection (see expr/collector.hh) ------------------------------- */
+        void mark_builtins(ExprMarker& marker);
+
+        /* drops the exprs that are not marked, returns their number */
+        size_t sweep(const ExprMarker& marker);
+
+        /* an operator as it was pooled before (e.g. read from a model
+           snapshot), no canonical form is enforced on operands */
+        inline Expr_ptr make_stored(ExprType et, Expr_ptr a, Expr_ptr b)
+        {
+            return make_expr(et, a, b);
+        }
+
+        /* a numeric constant of kind et, as it was pooled before */
+        inline Expr_ptr make_stored(ExprType et, value_t value)
+        {
+            Expr tmp(et, value); // we need a temp store
+            return __make_expr(&tmp);
+        }
 
         /* -- broad is-a predicates -------------------------------------------- */
         inline bool is_temporal(const Expr_ptr expr) const
@@ -940,11 +997,9 @@ namespace expr {
 
         static inline ExprMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new ExprMgr();
-            }
-
-            return (*f_instance);
+            /* made on first use, concurrent first uses wait for it */
+            static ExprMgr_ptr instance { new ExprMgr() };
+            return *instance;
         }
 
     protected:
@@ -952,8 +1007,6 @@ namespace expr {
         ~ExprMgr();
 
     private:
-        static ExprMgr_ptr f_instance;
-
         /* mid level services */
         inline Expr_ptr make_expr(ExprType et, Expr_ptr a, Expr_ptr b)
         {
@@ -962,7 +1015,7 @@ namespace expr {
         }
 
         /* identifiers & strings */
-        inline Expr_ptr make_expr(ExprType et, const Atom& atom)
+        inline Expr_ptr make_expr(ExprType et, atom_t atom)
         {
             Expr tmp(et, atom); // we need a temp store
             return __make_expr(&tmp);
@@ -998,11 +1051,22 @@ namespace expr {
         Expr_ptr empty_expr;
 
         /* synchronized shared pools */
-        boost::mutex f_expr_mutex;
-        ExprPool f_expr_pool;
+        ExprPoolShard f_expr_shards[EXPR_POOL_SHARDS];
+        AtomTable f_atoms;
+
+        /* ids of pooled exprs, in order of creation */
+        std::atomic<unsigned> f_next_id;
 
-        boost::mutex f_atom_mutex;
-        AtomPool f_atom_pool;
+        /* scrambled, so that aligned pointers spread over all shards */
+        static inline unsigned shard_index(long hash)
+        {
+            unsigned long x { (unsigned long) hash };
+            x ^= x >> 17;
+            x *= 0x9E3779B97F4A7C15UL;
+            x ^= x >> 29;
+
+            return x % EXPR_POOL_SHARDS;
+        }
     };
 
 }; // namespace expr
@@ -27,6 +27,7 @@
 #include <expr/expr_mgr.hh>
 
 #include <expr/nnfizer/nnfizer.hh>
+#include <expr/rewrite_cache.hh>
 
 #include <utils/logging.hh>
 
@@ -60,6 +61,12 @@ namespace expr {
 
     Expr_ptr Nnfizer::process(Expr_ptr expr)
     {
+        RewriteCache& cache { RewriteCache::INSTANCE() };
+        Expr_ptr cached { cache.lookup(REWRITE_NNF, NULL, expr) };
+        if (cached) {
+            return cached;
+        }
+
         assert(0 == f_polarity_stack.size());
         PUSH_POLARITY(true);
 
@@ -69,6 +76,8 @@ namespace expr {
         assert(0 == f_polarity_stack.size());
 
         POP_EXPR(res);
+
+        cache.store(REWRITE_NNF, NULL, expr, res);
         return res;
     }
 
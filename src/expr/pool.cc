@@ -0,0 +1,170 @@
+/**
+ * @file pool.cc
+ * @brief Expression management, expression pool implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <new>
+
+#include <collector.hh>
+#include <pool.hh>
+
+namespace expr {
+
+    ExprPool::ExprPool()
+        : f_used(EXPR_CHUNK_SIZE)
+        , f_index(1024, NULL)
+        , f_size(0)
+    {}
+
+    ExprPool::~ExprPool()
+    {
+        /* exprs are trivially destructible */
+        for (auto chunk : f_chunks) {
+            ::operator delete(chunk);
+        }
+    }
+
+    Expr_ptr ExprPool::insert(const Expr& expr, bool& fresh)
+    {
+        fresh = false;
+
+        if (f_index.size() <= 2 * f_size) {
+            grow();
+        }
+
+        ExprHash hash;
+        ExprEq eq;
+
+        size_t mask { f_index.size() - 1 };
+        size_t i { slot(hash(expr), mask) };
+        for (; f_index[i]; i = (i + 1) & mask) {
+            if (eq(*f_index[i], expr)) {
+                return f_index[i];
+            }
+        }
+
+        Expr_ptr where;
+        if (!f_free.empty()) {
+            where = f_free.back();
+            f_free.pop_back();
+        } else {
+            if (EXPR_CHUNK_SIZE == f_used) {
+                f_chunks.push_back(static_cast<Expr_ptr>(
+                    ::operator new(EXPR_CHUNK_SIZE * sizeof(Expr))));
+                f_used = 0;
+            }
+
+            where = f_chunks.back() + f_used++;
+        }
+
+        Expr_ptr res { new (where) Expr(expr) };
+        f_index[i] = res;
+        ++f_size;
+        fresh = true;
+
+        return res;
+    }
+
+    size_t ExprPool::bytes() const
+    {
+        return f_chunks.size() * EXPR_CHUNK_SIZE * sizeof(Expr) +
+               (f_index.size() + f_free.capacity()) * sizeof(Expr_ptr);
+    }
+
+    size_t ExprPool::sweep(const ExprMarker& marker)
+    {
+        size_t res { 0 };
+
+        for (auto& expr : f_index) {
+            if (expr && !marker.is_marked(expr)) {
+                expr->f_id = EXPR_FREE_ID;
+                expr = NULL;
+                ++res;
+            }
+        }
+        f_size -= res;
+
+        /* every slot up to f_used has held an expr, the last chunk is
+           kept to be filled */
+        std::vector<Expr_ptr> chunks;
+        std::vector<Expr_ptr>().swap(f_free);
+        for (size_t i = 0; i < f_chunks.size(); ++i) {
+            Expr_ptr chunk { f_chunks[i] };
+            bool last { 1 + i == f_chunks.size() };
+            size_t used { last ? f_used : EXPR_CHUNK_SIZE };
+
+            size_t n_free { 0 };
+            for (size_t j = 0; j < used; ++j) {
+                if (EXPR_FREE_ID == chunk[j].f_id) {
+                    ++n_free;
+                }
+            }
+
+            if (!last && EXPR_CHUNK_SIZE == n_free) {
+                ::operator delete(chunk);
+                continue;
+            }
+
+            for (size_t j = 0; j < used; ++j) {
+                if (EXPR_FREE_ID == chunk[j].f_id) {
+                    f_free.push_back(chunk + j);
+                }
+            }
+            chunks.push_back(chunk);
+        }
+        f_chunks.swap(chunks);
+
+        size_t size { 1024 };
+        while (size <= 4 * f_size) {
+            size <<= 1;
+        }
+        rehash(size);
+
+        return res;
+    }
+
+    void ExprPool::grow()
+    {
+        rehash(2 * f_index.size());
+    }
+
+    void ExprPool::rehash(size_t size)
+    {
+        std::vector<Expr_ptr> index(size, NULL);
+        size_t mask { index.size() - 1 };
+
+        ExprHash hash;
+        for (auto expr : f_index) {
+            if (!expr) {
+                continue;
+            }
+
+            size_t i { slot(hash(*expr), mask) };
+            while (index[i]) {
+                i = (i + 1) & mask;
+            }
+            index[i] = expr;
+        }
+
+        f_index.swap(index);
+    }
+
+} // namespace expr
@@ -0,0 +1,99 @@
+/**
+ * @file pool.hh
+ * @brief Expression management
+ *
+ * This header file contains the declarations required by the pool of
+ * expression nodes. Nodes are allocated in chunks that are never
+ * moved nor freed, so that pooled exprs have stable addresses, and
+ * are interned by an open addressing index of pointers, sparing the
+ * per-node allocation and bookkeeping of a node-based hash set.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef EXPR_POOL_H
+#define EXPR_POOL_H
+
+#include <vector>
+
+#include <expr/expr.hh>
+
+namespace expr {
+
+    /* exprs per arena chunk */
+    const size_t EXPR_CHUNK_SIZE = 4096;
+
+    /* the id of the slots of collected exprs */
+    const unsigned EXPR_FREE_ID = ~0U;
+
+    class ExprMarker;
+
+    class ExprPool {
+    public:
+        ExprPool();
+        ~ExprPool();
+
+        /* the pooled expr equal to expr, made on first use (fresh
+           is true then) */
+        Expr_ptr insert(const Expr& expr, bool& fresh);
+
+        /* number of pooled exprs */
+        inline size_t size() const
+        {
+            return f_size;
+        }
+
+        /* memory held by the arena and the index */
+        size_t bytes() const;
+
+        /* drops the exprs that are not marked, returns their number.
+           Their slots are reused first, chunks left with no exprs are
+           released and the index is shrunk to fit */
+        size_t sweep(const ExprMarker& marker);
+
+    private:
+        void grow();
+        void rehash(size_t size);
+
+        /* hashes of pointers have their low bits clear, and the shard
+           of a pool was picked with another scramble of the same hash */
+        static inline size_t slot(long hash, size_t mask)
+        {
+            unsigned long x { (unsigned long) hash };
+            x *= 0xFF51AFD7ED558CCDUL;
+            x ^= x >> 33;
+
+            return x & mask;
+        }
+
+        /* arena, the last chunk is being filled */
+        std::vector<Expr_ptr> f_chunks;
+        size_t f_used;
+
+        /* slots of collected exprs */
+        std::vector<Expr_ptr> f_free;
+
+        /* intern index, NULL slots are free */
+        std::vector<Expr_ptr> f_index;
+        size_t f_size;
+    };
+
+}; // namespace expr
+
+#endif /* EXPR_POOL_H */
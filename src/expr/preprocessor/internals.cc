@@ -27,6 +27,52 @@
 
 namespace expr::preprocessor {
 
+    ScopeChain::ScopeChain()
+    {}
+
+    void ScopeChain::push_scope()
+    {
+        f_scopes.push_back(ExprStack());
+    }
+
+    void ScopeChain::pop_scope()
+    {
+        assert(!f_scopes.empty());
+
+        for (auto formal : f_scopes.back()) {
+            Bindings::iterator i { f_bindings.find(formal) };
+            assert(f_bindings.end() != i);
+
+            i->second.pop_back();
+            if (i->second.empty()) {
+                f_bindings.erase(i);
+            }
+        }
+
+        f_scopes.pop_back();
+    }
+
+    void ScopeChain::bind(expr::Expr_ptr formal, expr::Expr_ptr actual)
+    {
+        assert(!f_scopes.empty());
+
+        f_bindings[formal].push_back(actual);
+        f_scopes.back().push_back(formal);
+    }
+
+    expr::Expr_ptr ScopeChain::lookup(expr::Expr_ptr formal) const
+    {
+        Bindings::const_iterator i { f_bindings.find(formal) };
+
+        return f_bindings.end() != i ? i->second.back() : NULL;
+    }
+
+    void ScopeChain::clear()
+    {
+        f_bindings.clear();
+        f_scopes.clear();
+    }
+
     // void Preprocessor::traverse_param_list(ExprVector& params, const Expr_ptr expr)
     // {
     //     if (f_em.is_params_comma( expr)) {
@@ -27,6 +27,7 @@
 #include <symb/proxy.hh>
 
 #include <expr/preprocessor/preprocessor.hh>
+#include <expr/rewrite_cache.hh>
 
 #include <utils/logging.hh>
 
@@ -66,6 +67,13 @@ namespace expr::preprocessor {
 
     expr::Expr_ptr Preprocessor::process(expr::Expr_ptr expr, expr::Expr_ptr ctx)
     {
+        /* results only depend on the model, shared by all instances */
+        RewriteCache& cache { RewriteCache::INSTANCE() };
+        expr::Expr_ptr cached { cache.lookup(REWRITE_PREPROCESS, ctx, expr) };
+        if (cached) {
+            return cached;
+        }
+
         // remove previous results
         f_ctx_stack.clear();
         f_expr_stack.clear();
@@ -84,6 +92,7 @@ namespace expr::preprocessor {
         POP_EXPR(res);
         assert(NULL != res);
 
+        cache.store(REWRITE_PREPROCESS, ctx, expr, res);
         return res;
     }
 
@@ -749,16 +758,10 @@ namespace expr::preprocessor {
         // .. or a symbol
         if (f_em.is_identifier(expr_)) {
 
-            /* traverse the env stack, subst with the first occurence, if any */
-            ExprPairStack::reverse_iterator env_iter;
-            for (env_iter = f_env.rbegin(); env_iter != f_env.rend(); ++env_iter) {
-
-                std::pair<expr::Expr_ptr, expr::Expr_ptr> entry(*env_iter);
-
-                if (entry.first == expr_) {
-                    expr_ = entry.second;
-                    break;
-                }
+            /* subst with the innermost binding, if any */
+            expr::Expr_ptr actual { f_env.lookup(expr_) };
+            if (actual) {
+                expr_ = actual;
             }
 
             /* Symb resolution */
@@ -815,6 +818,8 @@ namespace expr::preprocessor {
     //     /* Populate the subst environment */
     //     assert( formals.size() == actuals.size());
 
+    //     std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> new_bindings;
+
     //     ExprVector::const_iterator ai;
     //     ExprVector::const_iterator fi;
     //     for (ai = actuals.begin(), fi = formals.begin();
@@ -826,22 +831,20 @@ namespace expr::preprocessor {
     //         expr::Expr_ptr actual
     //             (*ai);
 
-    //         ExprPairStack::reverse_iterator eps_riter;
-    //         for ( eps_riter = f_env.rbegin(); eps_riter != f_env.rend(); ++ eps_riter ) {
-
-    //             std::pair<expr::Expr_ptr, expr::Expr_ptr> tmp
-    //                 (*eps_riter);
+    //         expr::Expr_ptr bound
+    //             (f_env.lookup(actual));
 
-    //             if (tmp.first == actual) {
-    //                 actual = tmp.second;
-    //             }
+    //         if (bound) {
+    //             actual = bound;
     //         }
 
-    //         expr::Expr_ptr formal
-    //             (*fi);
+    //         new_bindings.push_back( std::make_pair(*fi, actual));
+    //     }
 
-    //         f_env.push_back( std::pair <expr::Expr_ptr, expr::Expr_ptr>
-    //                          ( formal, actual ));
+    //     /* actuals are resolved in the caller's env */
+    //     f_env.push_scope();
+    //     for (const auto& binding : new_bindings) {
+    //         f_env.bind(binding.first, binding.second);
     //     }
 
     //     /* Here comes a bit of magic: we just relaunch the preprocessor on the
@@ -849,9 +852,7 @@ namespace expr::preprocessor {
     //     (*this)(define.body());
 
     //     /* Restore previous environment */
-    //     for (ai = actuals.begin(); ai != actuals.end(); ++ ai ) {
-    //         f_env.pop_back();
-    //     }
+    //     f_env.pop_scope();
     // }
 
 } // namespace expr::preprocessor
@@ -37,14 +37,41 @@
 #include <expr/expr_mgr.hh>
 #include <expr/walker/walker.hh>
 
+#include <boost/unordered_map.hpp>
+
 namespace expr::preprocessor {
 
     // NOTE: here we're using a vector in order to bypass STL stack
     // interface limitations. (i.e. absence of clear())
-    typedef std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> ExprPairStack;
     typedef std::vector<expr::Expr_ptr> ExprStack;
     typedef std::vector<symb::Define_ptr> DefinesStack;
 
+    /* nested substitution environments, the bindings of inner scopes
+       shadow those of outer ones. Each formal keeps the stack of its
+       actuals, lookups do not scan the chain */
+    class ScopeChain {
+    public:
+        ScopeChain();
+
+        void push_scope();
+        void pop_scope();
+
+        /* in the innermost scope */
+        void bind(expr::Expr_ptr formal, expr::Expr_ptr actual);
+
+        /* the innermost actual of formal, NULL if unbound */
+        expr::Expr_ptr lookup(expr::Expr_ptr formal) const;
+
+        void clear();
+
+    private:
+        typedef boost::unordered_map<expr::Expr_ptr, ExprStack> Bindings;
+        Bindings f_bindings;
+
+        /* formals bound in each scope, innermost last */
+        std::vector<ExprStack> f_scopes;
+    };
+
     class Preprocessor: public expr::ExprWalker {
     public:
         Preprocessor();
@@ -75,8 +102,8 @@ namespace expr::preprocessor {
         // Results stack
         ExprStack f_expr_stack;
 
-        // Not terribly efficient but easier to implement nested envs with
-        ExprPairStack f_env;
+        // nested envs of define parameters
+        ScopeChain f_env;
 
         /* internals */
         // void substitute_expression(const expr::Expr_ptr expr);
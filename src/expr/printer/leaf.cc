@@ -29,6 +29,7 @@
 #include <enc/enc_mgr.hh>
 
 #include <iomanip>
+#include <sstream>
 
 namespace expr {
 
@@ -116,39 +117,59 @@ namespace expr {
 
     static void print_atom_leaf(const Expr_ptr expr, std::ostream& os)
     {
-        Atom& atom { expr->atom() };
+        const Atom& atom { expr->atom() };
 
         os
             << atom;
     }
 
     void Printer::print_leaf(const Expr_ptr expr)
+    {
+        /* the text of leaves is kept by buffered printers, binary
+           consts depend on the word width and are not */
+        if (!f_buffer || BCONST == expr->f_symb) {
+            print_leaf(expr, f_os);
+            return;
+        }
+
+        LeafMap::const_iterator i { f_leaves.find(expr) };
+        if (f_leaves.end() == i) {
+            std::ostringstream oss;
+            print_leaf(expr, oss);
+
+            i = f_leaves.insert(std::make_pair(expr, oss.str())).first;
+        }
+
+        f_os << i->second;
+    }
+
+    void Printer::print_leaf(const Expr_ptr expr, std::ostream& os)
     {
         switch (expr->f_symb) {
             case ICONST:
             case INSTANT:
-                print_dec_leaf(expr, f_os);
+                print_dec_leaf(expr, os);
                 break;
 
             case HCONST:
-                print_hex_leaf(expr, f_os);
+                print_hex_leaf(expr, os);
                 break;
 
             case BCONST:
-                print_bin_leaf(expr, f_os);
+                print_bin_leaf(expr, os);
                 break;
 
             case OCONST:
-                print_oct_leaf(expr, f_os);
+                print_oct_leaf(expr, os);
                 break;
 
             case IDENT:
             case QSTRING:
-                print_atom_leaf(expr, f_os);
+                print_atom_leaf(expr, os);
                 break;
 
             case UNDEF:
-                f_os
+                os
                     << "UNDEFINED";
                 break;
 
@@ -33,23 +33,94 @@
 
 namespace expr {
 
+    PrintBuffer::PrintBuffer(std::ostream& sink, size_t size)
+        : f_sink(sink)
+        , f_data(size)
+    {
+        setp(f_data.data(), f_data.data() + f_data.size());
+    }
+
+    PrintBuffer::~PrintBuffer()
+    {
+        drain();
+    }
+
+    bool PrintBuffer::drain()
+    {
+        std::streamsize n { pptr() - pbase() };
+        if (n) {
+            f_sink.write(pbase(), n);
+            setp(f_data.data(), f_data.data() + f_data.size());
+        }
+
+        return f_sink.good();
+    }
+
+    PrintBuffer::int_type PrintBuffer::overflow(int_type c)
+    {
+        if (!drain()) {
+            return traits_type::eof();
+        }
+
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    int PrintBuffer::sync()
+    {
+        if (!drain()) {
+            return -1;
+        }
+
+        f_sink.flush();
+        return 0;
+    }
+
     Printer::Printer()
-        : f_os(std::cout)
+        : f_buffer(NULL)
+        , f_buffered(NULL)
+        , f_os(std::cout)
     {}
 
     Printer::Printer(std::ostream& os)
-        : f_os(os)
+        : f_buffer(NULL)
+        , f_buffered(NULL)
+        , f_os(os)
     {}
 
-    Printer::~Printer()
+    Printer::Printer(std::ostream& os, bool buffered)
+        : f_buffer(buffered ? new PrintBuffer(os) : NULL)
+        , f_buffered(buffered ? new std::ostream(f_buffer) : NULL)
+        , f_os(buffered ? *f_buffered : os)
     {}
 
+    Printer::~Printer()
+    {
+        if (f_buffer) {
+            f_os << std::flush;
+
+            delete f_buffered;
+            delete f_buffer;
+        }
+    }
+
+    void Printer::flush()
+    {
+        f_os << std::flush;
+    }
+
     void Printer::pre_hook()
     {}
 
     void Printer::post_hook()
     {
-        f_os << std::flush;
+        if (!f_buffer) {
+            f_os << std::flush;
+        }
     }
 
     Printer& Printer::operator<<(Expr_ptr expr)
@@ -66,7 +137,25 @@ namespace expr {
 
     Printer& Printer::operator<<(const std::string& str)
     {
-        f_os << str << std::flush;
+        f_os << str;
+        post_hook();
+
+        return *this;
+    }
+
+    Printer& Printer::operator<<(const char* str)
+    {
+        f_os << str;
+        post_hook();
+
+        return *this;
+    }
+
+    Printer& Printer::operator<<(value_t value)
+    {
+        f_os << std::dec << value;
+        post_hook();
+
         return *this;
     }
 
@@ -3,7 +3,10 @@
  * @brief Expr printer
  *
  * This header file contains the declarations required by the
- * Expression printer class.
+ * Expression printer class. Buffered printers write into a
+ * preallocated buffer, flushed to the output stream in large chunks,
+ * and keep the text of the leaves they printed. They are meant to be
+ * reused over many exprs (e.g. dumping traces).
  *
  * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
  *
@@ -27,24 +30,63 @@
 #define PRINTER_H
 
 #include <expr/walker/walker.hh>
+#include <streambuf>
 #include <string>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
 
 namespace expr {
 
+    /* bytes buffered by buffered printers */
+    const size_t PRINT_BUFFER_SIZE = 1 << 16;
+
+    /* a fixed buffer, written to the sink when full or synced */
+    class PrintBuffer: public std::streambuf {
+    public:
+        PrintBuffer(std::ostream& sink, size_t size = PRINT_BUFFER_SIZE);
+        ~PrintBuffer();
+
+    protected:
+        int_type overflow(int_type c);
+        int sync();
+
+    private:
+        bool drain();
+
+        std::ostream& f_sink;
+        std::vector<char> f_data;
+    };
+
     class Printer: public ExprWalker {
+        /* NULL unless buffered */
+        PrintBuffer* f_buffer;
+        std::ostream* f_buffered;
+
         std::ostream& f_os;
 
+        typedef boost::unordered_map<Expr_ptr, std::string, ExprIdHash> LeafMap;
+        LeafMap f_leaves;
+
     public:
         Printer(); // defaults to std::cout
         Printer(std::ostream& os);
 
+        /* exprs are not flushed one by one if buffered, the buffer is
+           flushed when full, on flush() and on destruction */
+        Printer(std::ostream& os, bool buffered);
+
         ~Printer();
 
         Printer& operator<<(const std::string& str);
+        Printer& operator<<(const char* str);
+        Printer& operator<<(value_t value);
 
         Printer& operator<<(Expr& expr);
         Printer& operator<<(Expr_ptr expr);
 
+        void flush();
+
     protected:
         void pre_hook();
         void post_hook();
@@ -60,6 +102,7 @@ namespace expr {
 
     private:
         void print_leaf(const Expr_ptr expr);
+        void print_leaf(const Expr_ptr expr, std::ostream& os);
     };
 
 }; // namespace expr
@@ -0,0 +1,167 @@
+/**
+ * @file rewrite_cache.cc
+ * @brief Expression management, shared cache of rewriting passes
+ * implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <common/common.hh>
+
+#include <collector.hh>
+#include <rewrite_cache.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/logging.hh>
+
+namespace expr {
+
+    RewriteCache::RewriteCache()
+        : f_mask(0)
+    {
+        unsigned requested { opts::OptsMgr::INSTANCE().rewrite_cache() };
+
+        /* a power of two, 0 disables the cache */
+        size_t size { 0 };
+        if (requested) {
+            for (size = 1; size < requested; size <<= 1)
+                ;
+        }
+
+        Slot empty { NULL, NULL, NULL, REWRITE_PREPROCESS };
+        f_slots.resize(size, empty);
+        f_mask = size ? size - 1 : 0;
+
+        for (unsigned i = 0; i < N_REWRITE_PASSES; ++i) {
+            f_lookups[i] = 0;
+            f_hits[i] = 0;
+            f_stores[i] = 0;
+            f_evictions[i] = 0;
+        }
+
+        DEBUG
+            << "Initialized rewrite cache, "
+            << size
+            << " slots"
+            << std::endl;
+
+        ExprCollector::INSTANCE().add_cache(
+            "rewrites", [this](ExprMarker& marker) {
+                prune(marker);
+            });
+    }
+
+    RewriteCache::~RewriteCache()
+    {}
+
+    Expr_ptr RewriteCache::lookup(rewrite_pass_t pass, Expr_ptr ctx, Expr_ptr expr)
+    {
+        if (!enabled()) {
+            return NULL;
+        }
+
+        ++f_lookups[pass];
+
+        size_t index { slot(pass, ctx, expr) };
+        boost::mutex::scoped_lock lock { stripe(index) };
+
+        const Slot& entry { f_slots[index] };
+        if (entry.expr == expr && entry.ctx == ctx && entry.pass == pass) {
+            ++f_hits[pass];
+            return entry.res;
+        }
+
+        return NULL;
+    }
+
+    void RewriteCache::store(rewrite_pass_t pass, Expr_ptr ctx, Expr_ptr expr, Expr_ptr res)
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        ++f_stores[pass];
+
+        size_t index { slot(pass, ctx, expr) };
+        boost::mutex::scoped_lock lock { stripe(index) };
+
+        Slot& entry { f_slots[index] };
+        if (entry.expr && (entry.expr != expr || entry.ctx != ctx || entry.pass != pass)) {
+            ++f_evictions[entry.pass];
+        }
+
+        entry.ctx = ctx;
+        entry.expr = expr;
+        entry.res = res;
+        entry.pass = pass;
+    }
+
+    void RewriteCache::clear()
+    {
+        for (size_t index = 0; index < f_slots.size(); ++index) {
+            boost::mutex::scoped_lock lock { stripe(index) };
+
+            Slot& entry { f_slots[index] };
+            entry.ctx = NULL;
+            entry.expr = NULL;
+            entry.res = NULL;
+        }
+    }
+
+    void RewriteCache::prune(ExprMarker& marker)
+    {
+        for (size_t index = 0; index < f_slots.size(); ++index) {
+            boost::mutex::scoped_lock lock { stripe(index) };
+
+            Slot& entry { f_slots[index] };
+            if (!entry.expr) {
+                continue;
+            }
+
+            if (marker.is_marked(entry.ctx) && marker.is_marked(entry.expr)) {
+                marker.mark(entry.res);
+            } else {
+                entry.ctx = NULL;
+                entry.expr = NULL;
+                entry.res = NULL;
+            }
+        }
+    }
+
+    RewriteCacheStats RewriteCache::stats(rewrite_pass_t pass)
+    {
+        RewriteCacheStats res {
+            f_slots.size(), 0,
+            f_lookups[pass], f_hits[pass], f_stores[pass], f_evictions[pass]
+        };
+
+        for (size_t index = 0; index < f_slots.size(); ++index) {
+            boost::mutex::scoped_lock lock { stripe(index) };
+
+            const Slot& entry { f_slots[index] };
+            if (entry.expr && entry.pass == pass) {
+                ++res.used;
+            }
+        }
+
+        return res;
+    }
+
+}; // namespace expr
@@ -0,0 +1,141 @@
+/**
+ * @file rewrite_cache.hh
+ * @brief Expression management, shared cache of rewriting passes
+ *
+ * This header file contains the declarations required by the cache
+ * of the results of expression rewriting passes (i.e. preprocessing,
+ * NNF conversion, time expansion). Exprs are hash-consed, thus a
+ * result only depends on the pass, the context and the expr being
+ * rewritten, and can be reused by every instance of the pass in the
+ * session. The cache is direct-mapped: its size is fixed
+ * (--rewrite-cache) and colliding entries replace each other.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef EXPR_REWRITE_CACHE_H
+#define EXPR_REWRITE_CACHE_H
+
+#include <atomic>
+#include <vector>
+
+#include <expr/expr.hh>
+
+#include <utils/context.hh>
+
+#include <boost/thread/mutex.hpp>
+
+namespace expr {
+
+    /* passes sharing the cache */
+    typedef enum {
+        REWRITE_PREPROCESS,
+        REWRITE_NNF,
+        REWRITE_EXPAND,
+        N_REWRITE_PASSES,
+    } rewrite_pass_t;
+
+    /* lock stripes over the slots */
+    const unsigned REWRITE_CACHE_STRIPES = 64;
+
+    struct RewriteCacheStats {
+        size_t slots;
+        size_t used;
+
+        unsigned long lookups;
+        unsigned long hits;
+        unsigned long stores;
+        unsigned long evictions;
+    };
+
+    typedef class RewriteCache* RewriteCache_ptr;
+
+    class RewriteCache {
+    public:
+        static inline RewriteCache& INSTANCE()
+        {
+            return utils::Context::current().instance<RewriteCache>(
+                utils::CONTEXT_REWRITES, []() { return new RewriteCache(); });
+        }
+
+        /* the result of pass on expr in ctx (NULL for context-free
+           passes), NULL iff not cached */
+        Expr_ptr lookup(rewrite_pass_t pass, Expr_ptr ctx, Expr_ptr expr);
+
+        /* records res, it replaces the entry on the same slot */
+        void store(rewrite_pass_t pass, Expr_ptr ctx, Expr_ptr expr, Expr_ptr res);
+
+        /* drops all entries, e.g. when the model changes. Counters
+           are kept */
+        void clear();
+
+        /* drops the entries whose ctx or expr is not live, the
+           results of the others are marked (see expr/collector.hh) */
+        void prune(ExprMarker& marker);
+
+        /* figures of one pass, slots are those of the whole cache */
+        RewriteCacheStats stats(rewrite_pass_t pass);
+
+        inline bool enabled() const
+        {
+            return !f_slots.empty();
+        }
+
+    protected:
+        RewriteCache();
+        ~RewriteCache();
+
+    private:
+        struct Slot {
+            Expr_ptr ctx;
+            Expr_ptr expr;
+            Expr_ptr res;
+            rewrite_pass_t pass;
+        };
+
+        inline size_t slot(rewrite_pass_t pass, Expr_ptr ctx, Expr_ptr expr) const
+        {
+            unsigned long x { ctx ? ctx->id() : 0xFFFFFFFFUL };
+
+            x = (x << 32) ^ expr->id() ^ ((unsigned long) pass << 60);
+            x *= 0xFF51AFD7ED558CCDUL;
+            x ^= x >> 33;
+
+            return x & f_mask;
+        }
+
+        inline boost::mutex& stripe(size_t index)
+        {
+            return f_stripes[index % REWRITE_CACHE_STRIPES];
+        }
+
+        std::vector<Slot> f_slots;
+        size_t f_mask;
+
+        boost::mutex f_stripes[REWRITE_CACHE_STRIPES];
+
+        std::atomic<unsigned long> f_lookups[N_REWRITE_PASSES];
+        std::atomic<unsigned long> f_hits[N_REWRITE_PASSES];
+        std::atomic<unsigned long> f_stores[N_REWRITE_PASSES];
+        std::atomic<unsigned long> f_evictions[N_REWRITE_PASSES];
+    };
+
+}; // namespace expr
+
+#endif /* EXPR_REWRITE_CACHE_H */
@@ -27,6 +27,7 @@
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 
+#include <expr/rewrite_cache.hh>
 #include <expr/time/expander/expander.hh>
 
 #include <utils/logging.hh>
@@ -60,10 +61,18 @@ namespace expr::time {
 
     Expr_ptr Expander::process(Expr_ptr expr)
     {
+        RewriteCache& cache { RewriteCache::INSTANCE() };
+        Expr_ptr cached { cache.lookup(REWRITE_EXPAND, NULL, expr) };
+        if (cached) {
+            return cached;
+        }
+
         f_expr_stack.clear();
         this->operator()(expr);
 
         TOP_EXPR(res);
+
+        cache.store(REWRITE_EXPAND, NULL, expr, res);
         return res;
     }
 
@@ -48,9 +48,7 @@ namespace expr {
     long TimedExprHash::operator()(const TimedExpr& k) const
     {
         long x, res { 0 };
-        ExprHash eh;
-
-        long v0 { eh(*k.expr()) };
+        long v0 { (long) k.expr()->id() };
         long v1 { k.time() };
 
         res = (res << 4) + v0;
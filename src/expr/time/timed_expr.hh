@@ -65,9 +65,6 @@ namespace expr {
         bool operator()(const TimedExpr& x, const TimedExpr& y) const;
     };
 
-    typedef boost::unordered_set<Expr, ExprHash, ExprEq> ExprPool;
-    typedef std::pair<ExprPool::iterator, bool> ExprPoolHit;
-
 }; // namespace expr
 
 #endif /* TIMED_EXPR_H */
@@ -3,7 +3,8 @@
  * @brief Expression walker pattern implementation
  *
  * This header file contains the declarations required by the Expression
- * Walker class.
+ * Walker class. Hooks are virtual, the walking machine is that of
+ * StaticExprWalker (see static_walker.hh).
  *
  * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
  *
@@ -35,10 +36,13 @@
 #include <expr/walker/exceptions.hh>
 #include <expr/walker/helpers.hh>
 #include <expr/walker/typedefs.hh>
+#include <expr/walker/static_walker.hh>
 
 namespace expr {
 
-    class ExprWalker {
+    class ExprWalker: public StaticExprWalker<ExprWalker> {
+        friend class StaticExprWalker<ExprWalker>;
+
     public:
         ExprWalker()
         {}
@@ -46,8 +50,6 @@ namespace expr {
         virtual ~ExprWalker()
         {}
 
-        ExprWalker& operator()(const Expr_ptr expr);
-
     protected:
         /* global hooks */
         virtual void pre_hook()
@@ -61,12 +63,6 @@ namespace expr {
         virtual void post_node_hook(Expr_ptr expr)
         {}
 
-        virtual void walk();
-        void rewrite(const Expr_ptr expr);
-
-        walker_stack f_recursion_stack;
-        bool f_rewritten;
-
         // -- hooks ----------------------------------------------------------------
 
         // LTL temporal ops
@@ -249,6 +245,9 @@ namespace expr {
         virtual void walk_leaf(const Expr_ptr expr) = 0;
     };
 
+    /* the machine is instantiated once, in walker.cc */
+    extern template class StaticExprWalker<ExprWalker>;
+
 }; // namespace expr
 
 #endif /* EXPR_WALKER_H */
@@ -43,6 +43,10 @@
  **/
 
 #include <cmd/cmd.hh>
+#include <cmd/jobs.hh>
+#include <cmd/server.hh>
+
+#include <dd/cudd_mgr.hh>
 
 #include <expr/expr.hh>
 #include <expr/printer/printer.hh>
@@ -56,6 +60,9 @@
 
 #include <sat/sat.hh>
 
+#include <utils/profile.hh>
+#include <utils/trace.hh>
+
 #include <boost/chrono.hpp>
 
 static const std::string heading_msg =
@@ -157,6 +164,19 @@ int main(int argc, const char* argv[])
         opts::OptsMgr& opts_mgr { opts::OptsMgr::INSTANCE() };
         opts_mgr.parse_command_line(argc, argv);
 
+        utils::Logger& logger { utils::Logger::INSTANCE() };
+        logger.set_tag("main");
+        if (opts_mgr.async_log()) {
+            logger.start_async();
+        }
+
+        const std::string trace_filename { opts_mgr.trace_events() };
+        if (!trace_filename.empty()) {
+            utils::EventTracer::INSTANCE().enable(trace_filename);
+        }
+
+        sat::EngineMgr::INSTANCE().set_progress_fd(opts_mgr.progress_fd());
+
         if (opts_mgr.help()) {
             std::cout
                 << opts_mgr.usage()
@@ -171,6 +191,18 @@ int main(int argc, const char* argv[])
                 << std::endl;
         }
 
+        /* DD managers are configured before any is made */
+        if (!dd::CuddMgr::INSTANCE().set_reordering(opts_mgr.dd_reordering(),
+                                                    opts_mgr.dd_max_reorderings())) {
+            WARN
+                << "Unknown DD reordering `"
+                << opts_mgr.dd_reordering()
+                << "`, using the default"
+                << std::endl;
+        }
+        dd::CuddMgr::INSTANCE().set_sizes(opts_mgr.dd_unique_slots(), opts_mgr.dd_cache(),
+                                          (unsigned long) opts_mgr.dd_max_memory() << 20);
+
         /* initialize global managers now to prevent initialization race-conditions later on */
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
         (void) em;
@@ -178,36 +210,46 @@ int main(int argc, const char* argv[])
         (void) mm;
         witness::WitnessMgr& wm { witness::WitnessMgr::INSTANCE() };
         (void) wm;
+        utils::Profiler& profiler { utils::Profiler::INSTANCE() };
+        (void) profiler;
 
-        /* load microcode */
-        sat::InlinedOperatorMgr& iom { sat::InlinedOperatorMgr::INSTANCE() };
-        size_t nloaders { iom.loaders().size() };
-
-        if (!opts_mgr.quiet()) {
-            TRACE
-                << nloaders
-                << " microcode fragments registered."
-                << std::endl;
-        }
+        /* microcode is loaded on demand, its index is read along
+           with the first model needing it (see read-model) */
 
         /* run options-generated commands (if any) */
-        const std::string model_filename { opts_mgr.model() };
-        if (!model_filename.empty()) {
+        const std::vector<std::string> model_filenames { opts_mgr.models() };
+        if (!model_filenames.empty()) {
             cmd::ReadModel_ptr cmd {
                 reinterpret_cast<cmd::ReadModel_ptr>(cmd::CommandMgr::INSTANCE().make_read_model())
             };
 
-            cmd->set_input(model_filename.c_str());
+            for (const auto& model_filename : model_filenames) {
+                cmd->add_input(model_filename.c_str());
+            }
             batch(cmd);
         }
 
+        /* serve requests, the model stays loaded and compiled */
+        const std::string endpoint { opts_mgr.server() };
+        if (!endpoint.empty()) {
+            cmd::Server server { endpoint };
+            if (!server.run()) {
+                interpreter.quit(1);
+            }
+        }
+
         /* run interactive commands */
-        do {
-            interpreter();
-        } while (!interpreter.is_leaving());
+        else {
+            do {
+                interpreter();
+            } while (!interpreter.is_leaving());
 
-        if (isatty(STDIN_FILENO))
-            std::cout << std::endl;
+            if (isatty(STDIN_FILENO))
+                std::cout << std::endl;
+        }
+
+        /* background jobs do not survive the shell */
+        cmd::JobMgr::INSTANCE().shutdown();
     }
 
     catch (Exception& e) {
@@ -219,6 +261,17 @@ int main(int argc, const char* argv[])
             << std::endl;
     }
 
+    if (!utils::EventTracer::INSTANCE().write()) {
+        std::cerr
+            << red
+            << "Could not write trace events"
+            << normal
+            << std::endl;
+    }
+
+    /* queued log lines are written before leaving */
+    utils::Logger::INSTANCE().stop_async();
+
     return interpreter.retcode();
 }
 
@@ -0,0 +1,371 @@
+/**
+ * @file model/aiger.cc
+ * @brief Model management subsystem, AIGER import implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <symb/classes.hh>
+
+#include <type/type_mgr.hh>
+
+#include <model/aiger.hh>
+#include <model/model.hh>
+#include <model/model_mgr.hh>
+#include <model/module.hh>
+
+#include <utils/logging.hh>
+
+namespace model {
+
+    namespace {
+
+        class AigerReader {
+        public:
+            AigerReader(const std::string& data)
+                : f_data(data)
+                , f_pos(0)
+            {}
+
+            void read(Model& model)
+            {
+                expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+                type::Type_ptr boolean { type::TypeMgr::INSTANCE().find_boolean() };
+
+                std::string format { word() };
+                bool binary { format == "aig" };
+                if (!binary && format != "aag") {
+                    throw std::runtime_error("not an AIGER file");
+                }
+
+                /* M I L O A [B C J F] */
+                std::vector<unsigned> header;
+                while (!at_eol()) {
+                    header.push_back(number());
+                }
+                eol();
+                if (header.size() < 5 || 9 < header.size()) {
+                    throw std::runtime_error("malformed header");
+                }
+                header.resize(9, 0);
+
+                unsigned n_vars { header[0] };
+                unsigned n_inputs { header[1] };
+                unsigned n_latches { header[2] };
+                unsigned n_outputs { header[3] };
+                unsigned n_ands { header[4] };
+                unsigned n_bads { header[5] };
+                unsigned n_constraints { header[6] };
+                unsigned n_justice { header[7] };
+                unsigned n_fairness { header[8] };
+
+                if (n_vars < n_inputs + n_latches + n_ands) {
+                    throw std::runtime_error("inconsistent header");
+                }
+
+                expr::Expr_ptr name { em.make_identifier("main") };
+                Module_ptr module { new Module(name) };
+                model.add_module(*module);
+
+                f_vars.assign(1 + n_vars, NULL);
+
+                for (unsigned i = 0; i < n_inputs; ++i) {
+                    unsigned lit { binary ? 2 * (i + 1) : line_literal() };
+
+                    symb::Variable_ptr var { new symb::Variable(name, define(lit, "i", i), boolean) };
+                    var->set_input(true);
+                    module->add_var(f_vars[lit >> 1], var);
+                }
+
+                /* latches refer to gates not defined yet */
+                std::vector<std::pair<unsigned, unsigned>> latches;
+                for (unsigned i = 0; i < n_latches; ++i) {
+                    unsigned lit { binary ? 2 * (n_inputs + i + 1) : number() };
+                    unsigned next { number() };
+                    unsigned reset { at_eol() ? 0 : number() };
+                    eol();
+
+                    expr::Expr_ptr id { define(lit, "l", i) };
+                    module->add_var(id, new symb::Variable(name, id, boolean));
+
+                    if (reset != 0 && reset != 1 && reset != lit) {
+                        throw std::runtime_error("unsupported latch reset");
+                    }
+                    if (reset != lit) {
+                        module->add_init(1 == reset ? id : em.make_not(id));
+                    }
+
+                    latches.push_back(std::make_pair(lit, next));
+                }
+
+                std::vector<unsigned> outputs;
+                for (unsigned i = 0; i < n_outputs; ++i) {
+                    outputs.push_back(line_literal());
+                }
+
+                std::vector<unsigned> bads;
+                for (unsigned i = 0; i < n_bads; ++i) {
+                    bads.push_back(line_literal());
+                }
+
+                std::vector<unsigned> constraints;
+                for (unsigned i = 0; i < n_constraints; ++i) {
+                    constraints.push_back(line_literal());
+                }
+
+                /* liveness properties, skipped */
+                unsigned n_skipped { n_fairness };
+                for (unsigned i = 0; i < n_justice; ++i) {
+                    n_skipped += line_literal();
+                }
+                for (unsigned i = 0; i < n_skipped; ++i) {
+                    line_literal();
+                }
+                if (0 < n_justice + n_fairness) {
+                    WARN
+                        << "Justice and fairness properties are not supported, ignored"
+                        << std::endl;
+                }
+
+                std::vector<std::pair<unsigned, std::pair<unsigned, unsigned>>> ands;
+                for (unsigned i = 0; i < n_ands; ++i) {
+                    unsigned lhs, rhs0, rhs1;
+                    if (binary) {
+                        lhs = 2 * (n_inputs + n_latches + i + 1);
+                        rhs0 = lhs - delta();
+                        rhs1 = rhs0 - delta();
+                    } else {
+                        lhs = number();
+                        rhs0 = number();
+                        rhs1 = number();
+                        eol();
+                    }
+
+                    define(lhs, "a", i);
+                    ands.push_back(std::make_pair(lhs, std::make_pair(rhs0, rhs1)));
+                }
+
+                for (const auto& gate : ands) {
+                    expr::Expr_ptr id { f_vars[gate.first >> 1] };
+                    expr::Expr_ptr body {
+                        em.make_and(literal(gate.second.first), literal(gate.second.second))
+                    };
+
+                    module->add_def(id, new symb::Define(name, id, body));
+                }
+
+                for (const auto& latch : latches) {
+                    module->add_trans(em.make_eq(em.make_next(literal(latch.first)),
+                                                 literal(latch.second)));
+                }
+
+                for (auto constraint : constraints) {
+                    module->add_invar(literal(constraint));
+                }
+
+                /* AIGER 1.0, outputs are bad states */
+                if (bads.empty()) {
+                    bads = outputs;
+                }
+
+                expr::Expr_ptr any { em.make_false() };
+                for (unsigned i = 0; i < bads.size(); ++i) {
+                    std::ostringstream oss;
+                    oss << "bad" << i;
+
+                    expr::Expr_ptr id { em.make_identifier(oss.str().c_str()) };
+                    module->add_def(id, new symb::Define(name, id, literal(bads[i])));
+
+                    any = i ? em.make_or(any, id) : id;
+                }
+
+                expr::Expr_ptr id { em.make_identifier("bad") };
+                module->add_def(id, new symb::Define(name, id, any));
+
+                DEBUG
+                    << "Read AIG with "
+                    << n_inputs
+                    << " inputs, "
+                    << n_latches
+                    << " latches, "
+                    << n_ands
+                    << " gates, "
+                    << bads.size()
+                    << " bad state properties and "
+                    << n_constraints
+                    << " constraints"
+                    << std::endl;
+            }
+
+        private:
+            /* the name of the var of lit, i.e. prefix followed by the
+               index of the var among the ones of its kind */
+            expr::Expr_ptr define(unsigned lit, const char* prefix, unsigned index)
+            {
+                unsigned var { lit >> 1 };
+                if (0 != (lit & 1) || 0 == var || f_vars.size() <= var || NULL != f_vars[var]) {
+                    throw std::runtime_error("invalid literal definition");
+                }
+
+                std::ostringstream oss;
+                oss << prefix << index;
+
+                return f_vars[var] = expr::ExprMgr::INSTANCE().make_identifier(oss.str().c_str());
+            }
+
+            expr::Expr_ptr literal(unsigned lit)
+            {
+                expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+                unsigned var { lit >> 1 };
+                if (f_vars.size() <= var || (0 != var && NULL == f_vars[var])) {
+                    throw std::runtime_error("undefined literal");
+                }
+
+                expr::Expr_ptr res { 0 == var ? em.make_false() : f_vars[var] };
+                return (lit & 1) ? em.make_not(res) : res;
+            }
+
+            inline bool at_eol()
+            {
+                while (f_pos < f_data.size() && ' ' == f_data[f_pos]) {
+                    ++f_pos;
+                }
+
+                return f_data.size() <= f_pos || '\n' == f_data[f_pos];
+            }
+
+            void eol()
+            {
+                if (!at_eol()) {
+                    throw std::runtime_error("unexpected token");
+                }
+                if (f_pos < f_data.size()) {
+                    ++f_pos;
+                }
+            }
+
+            std::string word()
+            {
+                at_eol();
+
+                size_t start { f_pos };
+                while (f_pos < f_data.size() && ' ' != f_data[f_pos] &&
+                       '\n' != f_data[f_pos]) {
+                    ++f_pos;
+                }
+
+                return f_data.substr(start, f_pos - start);
+            }
+
+            unsigned number()
+            {
+                std::string token { word() };
+                if (token.empty() ||
+                    token.find_first_not_of("0123456789") != std::string::npos) {
+                    throw std::runtime_error("number expected");
+                }
+
+                return std::stoul(token);
+            }
+
+            /* a literal on a line of its own */
+            unsigned line_literal()
+            {
+                unsigned res { number() };
+                eol();
+
+                return res;
+            }
+
+            /* binary AND gates, 7 bits at a time */
+            unsigned delta()
+            {
+                unsigned res { 0 };
+                for (unsigned shift = 0;; shift += 7) {
+                    if (f_data.size() <= f_pos || 28 < shift) {
+                        throw std::runtime_error("truncated AND gates");
+                    }
+
+                    unsigned char c = f_data[f_pos++];
+                    res |= (c & 0x7f) << shift;
+                    if (!(c & 0x80)) {
+                        return res;
+                    }
+                }
+            }
+
+            const std::string& f_data;
+            size_t f_pos;
+
+            /* by AIGER var index */
+            std::vector<expr::Expr_ptr> f_vars;
+        };
+
+    } // namespace
+
+    bool Aiger::load(const std::string& path)
+    {
+        ModelMgr& mm { ModelMgr::INSTANCE() };
+
+        std::ifstream is { path.c_str(), std::ifstream::binary };
+        if (!is) {
+            WARN
+                << "Could not open AIG `"
+                << path
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+
+        std::string data { std::istreambuf_iterator<char>(is),
+                           std::istreambuf_iterator<char>() };
+
+        mm.reset();
+
+        bool res { true };
+        try {
+            AigerReader reader { data };
+            reader.read(mm.model());
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not read AIG `"
+                << path
+                << "`: "
+                << what
+                << std::endl;
+
+            res = false;
+        }
+
+        return res;
+    }
+
+} // namespace model
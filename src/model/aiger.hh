@@ -0,0 +1,53 @@
+/**
+ * @file aiger.hh
+ * @brief Model management subsystem, AIGER import
+ *
+ * This header file contains the declarations required to read an
+ * And-Inverter Graph in the AIGER format (either ASCII `aag` or
+ * binary `aig`, up to version 1.9) as a model. The model has a
+ * single module: inputs are boolean input vars (`i0`, `i1`, ...),
+ * latches are boolean state vars (`l0`, `l1`, ...) with their reset
+ * values as INITs and their next state functions as TRANSes, AND
+ * gates are DEFINEs (`a0`, `a1`, ...) and invariant constraints are
+ * INVARs. Bad state properties (or outputs, if none is given, as in
+ * AIGER 1.0) are DEFINEs `bad0`, `bad1`, ..., their disjunction is
+ * `bad`: `reach bad` runs a benchmark. Justice and fairness
+ * properties are ignored, as are the symbols of the AIG.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MODEL_AIGER_H
+#define MODEL_AIGER_H
+
+#include <string>
+
+namespace model {
+
+    class Aiger {
+    public:
+        /* replaces the current model with the AIG at path, which
+           still needs to be analyzed. False if the file can not be
+           read, or is not well formed */
+        static bool load(const std::string& path);
+    };
+
+} // namespace model
+
+#endif /* MODEL_AIGER_H */
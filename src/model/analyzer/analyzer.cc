@@ -25,6 +25,7 @@
 
 #include <compiler/compiler.hh>
 
+#include <expr/collector.hh>
 #include <expr/expr_mgr.hh>
 
 #include <expr/expr.hh>
@@ -80,6 +81,31 @@ namespace model {
         // invoke walker on the body of the expr to be processed
         (*this)(expr);
         assert(!f_expr_stack.size());
+
+        // DEFINEs are live only if the FSM refers to them
+        if (section != ANALYZE_DEFINE) {
+            collect_live(ctx, expr);
+        }
+    }
+
+    void Analyzer::clear()
+    {
+        f_dependency_tracking_map.clear();
+        f_enum_uses.clear();
+        f_live.clear();
+    }
+
+    void Analyzer::mark(expr::ExprMarker& marker) const
+    {
+        for (DependencyTrackingMap::const_iterator i = f_dependency_tracking_map.begin();
+             i != f_dependency_tracking_map.end(); ++i) {
+            marker.mark(i->first);
+            marker.mark(i->second);
+        }
+
+        for (auto symbol : f_live) {
+            marker.mark(symbol);
+        }
     }
 
     void Analyzer::generate_framing_conditions()
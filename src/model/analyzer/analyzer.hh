@@ -27,6 +27,8 @@
 #ifndef ANALYZER_H
 #define ANALYZER_H
 
+#include <enc/enc_mgr.hh>
+
 #include <expr/expr_mgr.hh>
 
 #include <expr/preprocessor/preprocessor.hh>
@@ -36,6 +38,7 @@
 #include <type/type_mgr.hh>
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 namespace model {
 
@@ -45,6 +48,9 @@ namespace model {
     /* identifier -> framing condition clause */
     typedef boost::unordered_map<expr::Expr_ptr, expr::Expr_ptr, utils::PtrHash, utils::PtrEq> FramingConditionMap;
 
+    /* fully qualified names of the symbols INIT, INVAR and TRANS depend on */
+    typedef boost::unordered_set<expr::Expr_ptr, utils::PtrHash, utils::PtrEq> LiveSymbols;
+
     class ModelMgr;
     typedef enum {
         ANALYZE_INIT,
@@ -64,6 +70,29 @@ namespace model {
         // generates framing conditions, adds them in the module
         void generate_framing_conditions();
 
+        // forgets the dependencies (and the uses of enums, and the
+        // live symbols) found so far
+        void clear();
+
+        // uses of enum vars found so far, by type (see
+        // enc::EncodingMgr::enum_encoding)
+        inline const enc::EnumUses& enum_uses() const
+        {
+            return f_enum_uses;
+        }
+
+        // symbols referenced by the INITs, INVARs and TRANSes
+        // analyzed so far, directly or through DEFINEs and module
+        // parameters. Other vars and DEFINEs have no influence on the
+        // FSM
+        inline const LiveSymbols& live() const
+        {
+            return f_live;
+        }
+
+        // the exprs of the dependencies found so far are live
+        void mark(expr::ExprMarker& marker) const;
+
     protected:
         void pre_hook();
         void post_hook();
@@ -88,8 +117,22 @@ namespace model {
 
         DependencyTrackingMap f_dependency_tracking_map;
 
+        enc::EnumUses f_enum_uses;
+
+        LiveSymbols f_live;
+
         // helpers
         bool mutually_exclusive(expr::Expr_ptr p, expr::Expr_ptr q);
+
+        // the enum type of operand, if it is an enum var (possibly
+        // next) or literal, NULL otherwise
+        type::EnumType_ptr enum_operand(expr::Expr_ptr operand, bool& literal);
+
+        // counts a comparison (or assignment) of lhs against rhs
+        void count_enum_use(expr::Expr_ptr lhs, expr::Expr_ptr rhs);
+
+        // adds the symbols body depends on in ctx to the live ones
+        void collect_live(expr::Expr_ptr ctx, expr::Expr_ptr body);
     };
 
 }; // namespace model
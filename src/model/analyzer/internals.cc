@@ -25,6 +25,8 @@
 
 #include <expr/expr.hh>
 #include <symb/proxy.hh>
+#include <symb/classes.hh>
+#include <symb/exceptions.hh>
 #include <type/type.hh>
 
 #include <model/analyzer/analyzer.hh>
@@ -46,4 +48,129 @@ namespace model {
         f_expr_stack.pop_back();
     }
 
+    type::EnumType_ptr Analyzer::enum_operand(expr::Expr_ptr operand, bool& literal)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        literal = false;
+        if (em.is_next(operand)) {
+            operand = operand->lhs();
+        }
+
+        if (!em.is_identifier(operand)) {
+            return NULL;
+        }
+
+        expr::Expr_ptr ctx { f_ctx_stack.back() };
+        expr::Expr_ptr full { em.make_dot(ctx, operand) };
+
+        /* e.g. the formal params of DEFINEs, which are not resolved
+           here. Counts are just hints, these are skipped */
+        symb::Symbol_ptr symb;
+        try {
+            symb::ResolverProxy resolver;
+            symb = resolver.symbol(full);
+        } catch (symb::UnresolvedSymbol& us) {
+            return NULL;
+        }
+
+        type::Type_ptr type { NULL };
+        if (symb->is_literal()) {
+            literal = true;
+            type = symb->as_literal().type();
+        } else if (symb->is_variable()) {
+            type = symb->as_variable().type();
+        }
+
+        return (NULL != type && type->is_enum()) ? type->as_enum() : NULL;
+    }
+
+    void Analyzer::count_enum_use(expr::Expr_ptr lhs, expr::Expr_ptr rhs)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        bool lhs_literal, rhs_literal;
+        type::EnumType_ptr lhs_type { enum_operand(lhs, lhs_literal) };
+        type::EnumType_ptr rhs_type { enum_operand(rhs, rhs_literal) };
+
+        /* e.g. nondeterministic assignments */
+        if (NULL != lhs_type && !lhs_literal && em.is_set(rhs)) {
+            ++f_enum_uses[lhs_type].set_comparisons;
+            return;
+        }
+
+        if (NULL == lhs_type || NULL == rhs_type) {
+            return;
+        }
+
+        if (lhs_literal != rhs_literal) {
+            ++f_enum_uses[lhs_literal ? rhs_type : lhs_type].literal_comparisons;
+        } else if (!lhs_literal) {
+            ++f_enum_uses[lhs_type].var_comparisons;
+            if (rhs_type != lhs_type) {
+                ++f_enum_uses[rhs_type].var_comparisons;
+            }
+        }
+    }
+
+    void Analyzer::collect_live(expr::Expr_ptr ctx, expr::Expr_ptr body)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        ModelMgr& mm { ModelMgr::INSTANCE() };
+
+        std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> stack;
+        stack.push_back(std::make_pair(ctx, body));
+
+        while (!stack.empty()) {
+            expr::Expr_ptr curr_ctx { stack.back().first };
+            expr::Expr_ptr expr { stack.back().second };
+            stack.pop_back();
+
+            if (em.is_constant(expr) || em.is_qstring(expr) ||
+                em.is_instant(expr) || em.is_undef(expr)) {
+                continue;
+            }
+
+            if (em.is_dot(expr)) {
+                stack.push_back(std::make_pair(em.make_dot(curr_ctx, expr->lhs()),
+                                               expr->rhs()));
+                continue;
+            }
+
+            if (em.is_identifier(expr)) {
+                expr::Expr_ptr full { em.make_dot(curr_ctx, expr) };
+
+                /* bodies are walked once */
+                if (!f_live.insert(full).second) {
+                    continue;
+                }
+
+                /* e.g. the formal params of DEFINEs */
+                symb::Symbol_ptr symb;
+                try {
+                    symb::ResolverProxy resolver;
+                    symb = resolver.symbol(full);
+                } catch (symb::UnresolvedSymbol& us) {
+                    continue;
+                }
+
+                if (symb->is_define()) {
+                    stack.push_back(std::make_pair(curr_ctx, symb->as_define().body()));
+                } else if (symb->is_parameter()) {
+                    expr::Expr_ptr rewrite { mm.rewrite_parameter(full) };
+                    stack.push_back(std::make_pair(rewrite->lhs(), rewrite->rhs()));
+                }
+
+                continue;
+            }
+
+            if (NULL != expr->rhs()) {
+                stack.push_back(std::make_pair(curr_ctx, expr->rhs()));
+            }
+            if (NULL != expr->lhs()) {
+                stack.push_back(std::make_pair(curr_ctx, expr->lhs()));
+            }
+        }
+    }
+
 }; // namespace model
@@ -398,6 +398,8 @@ namespace model {
             throw SemanticError("Assignments require an lvalue for lhs");
         }
 
+        count_enum_use(lhs, expr->rhs());
+
         /* strip [] */
         if (em.is_subscript(lhs)) {
             lhs = lhs->lhs();
@@ -448,7 +450,9 @@ namespace model {
         return true;
     }
     void Analyzer::walk_eq_postorder(const expr::Expr_ptr expr)
-    {}
+    {
+        count_enum_use(expr->lhs(), expr->rhs());
+    }
 
     bool Analyzer::walk_ne_preorder(const expr::Expr_ptr expr)
     {
@@ -459,7 +463,9 @@ namespace model {
         return true;
     }
     void Analyzer::walk_ne_postorder(const expr::Expr_ptr expr)
-    {}
+    {
+        count_enum_use(expr->lhs(), expr->rhs());
+    }
 
     bool Analyzer::walk_gt_preorder(const expr::Expr_ptr expr)
     {
@@ -0,0 +1,228 @@
+/**
+ * @file miter.cc
+ * @brief Model management subsystem, miters of two revisions
+ * implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <sstream>
+
+#include <expr/expr_mgr.hh>
+
+#include <model/miter.hh>
+#include <model/module.hh>
+
+#include <symb/classes.hh>
+
+#include <type/classes.hh>
+#include <type/type_mgr.hh>
+
+#include <utils/logging.hh>
+
+namespace model {
+
+    Miter::Miter(Model& model, Model& old_rev, Model& new_rev)
+        : f_model(model)
+        , f_old(old_rev)
+        , f_new(new_rev)
+        , f_target(NULL)
+    {}
+
+    expr::Expr_ptr Miter::renamed(expr::Expr_ptr name, const char* prefix)
+    {
+        std::ostringstream oss;
+        oss
+            << prefix
+            << name;
+
+        return expr::ExprMgr::INSTANCE().make_identifier(oss.str().c_str());
+    }
+
+    Module& Miter::rename(Module& module, const char* prefix)
+    {
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        Module& res { f_model.add_module(*new Module(renamed(module.name(), prefix))) };
+        expr::Expr_ptr name { res.name() };
+
+        for (const auto& param : module.parameters()) {
+            res.add_parameter(param.first,
+                              new symb::Parameter(name, param.first, param.second->type()));
+        }
+
+        for (const auto& pair : module.vars()) {
+            symb::Variable& var { *pair.second };
+
+            type::Type_ptr tp { var.type() };
+            if (tp->is_instance()) {
+                type::InstanceType_ptr instance { tp->as_instance() };
+                tp = tm.find_instance(renamed(instance->name(), prefix), instance->params());
+            }
+
+            symb::Variable_ptr copy { new symb::Variable(name, pair.first, tp) };
+            copy->set_hidden(var.is_hidden());
+            copy->set_input(var.is_input());
+            copy->set_inertial(var.is_inertial());
+            copy->set_frozen(var.is_frozen());
+            copy->set_temp(var.is_temp());
+            copy->set_format(var.format());
+
+            res.add_var(pair.first, copy);
+        }
+
+        for (const auto& pair : module.defs()) {
+            symb::Define& def { *pair.second };
+
+            symb::Define_ptr copy { new symb::Define(name, pair.first, def.body()) };
+            copy->set_hidden(def.is_hidden());
+            copy->set_format(def.format());
+
+            res.add_def(pair.first, copy);
+        }
+
+        for (auto body : module.init()) {
+            res.add_init(body);
+        }
+
+        /* enum vars got their INVARs already, see Module::add_var */
+        for (auto body : module.invar()) {
+            const expr::ExprVector& invar { res.invar() };
+            if (invar.end() == std::find(invar.begin(), invar.end(), body)) {
+                res.add_invar(body);
+            }
+        }
+
+        for (auto body : module.trans()) {
+            res.add_trans(body);
+        }
+
+        return res;
+    }
+
+    bool Miter::build(const expr::ExprVector& outputs)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        Module& old_main { f_old.main_module() };
+        Module& new_main { f_new.main_module() };
+
+        /* outputs are DEFINEs or vars of both main modules */
+        f_outputs = outputs;
+        if (f_outputs.empty()) {
+            for (const auto& pair : old_main.defs()) {
+                if (new_main.defs().end() != new_main.defs().find(pair.first)) {
+                    f_outputs.push_back(pair.first);
+                }
+            }
+        }
+
+        if (f_outputs.empty()) {
+            WARN
+                << "The two revisions have no DEFINE in common, no outputs to compare"
+                << std::endl;
+
+            return false;
+        }
+
+        auto declares = [](Module& module, expr::Expr_ptr id) {
+            return module.defs().end() != module.defs().find(id) ||
+                   module.vars().end() != module.vars().find(id);
+        };
+
+        for (auto output : f_outputs) {
+            if (!declares(old_main, output) || !declares(new_main, output)) {
+                WARN
+                    << "Output `"
+                    << output
+                    << "` is not declared by both revisions"
+                    << std::endl;
+
+                return false;
+            }
+        }
+
+        /* the miter comes first, it is the main module */
+        expr::Expr_ptr miter_id { em.make_identifier("miter") };
+        expr::Expr_ptr old_id { em.make_identifier("old") };
+        expr::Expr_ptr new_id { em.make_identifier("new") };
+
+        Module& miter { f_model.add_module(*new Module(miter_id)) };
+        expr::Expr_ptr old_main_id { renamed(old_main.name(), "old_") };
+        expr::Expr_ptr new_main_id { renamed(new_main.name(), "new_") };
+
+        for (const auto& pair : f_old.modules()) {
+            rename(*pair.second, "old_");
+        }
+        for (const auto& pair : f_new.modules()) {
+            rename(*pair.second, "new_");
+        }
+
+        miter.add_var(old_id, new symb::Variable(miter_id, old_id,
+                                                 tm.find_instance(old_main_id, em.make_empty())));
+        miter.add_var(new_id, new symb::Variable(miter_id, new_id,
+                                                 tm.find_instance(new_main_id, em.make_empty())));
+
+        /* the environment of the two revisions is the same */
+        for (const auto& pair : old_main.vars()) {
+            symb::Variable& var { *pair.second };
+            if (!var.is_input() && !var.is_frozen()) {
+                continue;
+            }
+
+            symb::Variables::const_iterator i { new_main.vars().find(pair.first) };
+            if (new_main.vars().end() == i ||
+                i->second->type() != var.type() ||
+                i->second->is_input() != var.is_input() ||
+                i->second->is_frozen() != var.is_frozen()) {
+                continue;
+            }
+
+            miter.add_invar(em.make_eq(em.make_dot(old_id, pair.first),
+                                       em.make_dot(new_id, pair.first)));
+            f_tied.push_back(pair.first);
+        }
+
+        expr::Expr_ptr differ { NULL };
+        for (auto output : f_outputs) {
+            expr::Expr_ptr ne {
+                em.make_ne(em.make_dot(old_id, output), em.make_dot(new_id, output))
+            };
+            differ = (NULL == differ) ? ne : em.make_or(differ, ne);
+        }
+
+        f_target = em.make_identifier("differ");
+        miter.add_def(f_target, new symb::Define(miter_id, f_target, differ));
+
+        unsigned n_outputs { (unsigned) f_outputs.size() };
+        unsigned n_tied { (unsigned) f_tied.size() };
+        DEBUG
+            << "Built miter, "
+            << n_outputs
+            << " outputs compared, "
+            << n_tied
+            << " inputs and frozen vars tied"
+            << std::endl;
+
+        return true;
+    }
+
+}; // namespace model
@@ -0,0 +1,90 @@
+/**
+ * @file miter.hh
+ * @brief Model management subsystem, miters of two revisions
+ *
+ * This header file contains the declarations of the miter of two
+ * revisions of a model, for sequential equivalence checking. The
+ * modules of each revision are renamed apart (`old_` and `new_`
+ * prefixes), and a main module of its own, `miter`, declares an
+ * instance of the main module of each revision, `old` and `new`.
+ * Input and frozen vars of the two main modules having the same name
+ * and type take the same values. The revisions are equivalent iff
+ * `differ` (a DEFINE of the miter, true iff any of the outputs
+ * compared differs) is unreachable.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MODEL_MITER_H
+#define MODEL_MITER_H
+
+#include <expr/expr.hh>
+
+#include <model/model.hh>
+
+namespace model {
+
+    class Miter {
+    public:
+        /* the miter of revisions old_rev and new_rev is built into
+           model (e.g. the current one, just reset), which takes over
+           their modules */
+        Miter(Model& model, Model& old_rev, Model& new_rev);
+
+        /* outputs compared, by name: DEFINEs or vars of both main
+           modules. If none is given, all the DEFINEs the two main
+           modules have in common are. False (with a warning) iff an
+           output is missing in either revision, or there is none */
+        bool build(const expr::ExprVector& outputs);
+
+        /* the DEFINE of the miter, true iff some output differs */
+        inline expr::Expr_ptr target() const
+        {
+            return f_target;
+        }
+
+        inline const expr::ExprVector& outputs() const
+        {
+            return f_outputs;
+        }
+
+        /* inputs and frozen vars taking the same values */
+        inline const expr::ExprVector& tied() const
+        {
+            return f_tied;
+        }
+
+    private:
+        Model& f_model;
+        Model& f_old;
+        Model& f_new;
+
+        expr::Expr_ptr f_target;
+        expr::ExprVector f_outputs;
+        expr::ExprVector f_tied;
+
+        /* a copy of module, renamed, added to the miter. Instances
+           refer to the renamed modules */
+        Module& rename(Module& module, const char* prefix);
+        expr::Expr_ptr renamed(expr::Expr_ptr name, const char* prefix);
+    };
+
+}; // namespace model
+
+#endif /* MODEL_MITER_H */
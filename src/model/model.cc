@@ -21,6 +21,10 @@
  *
  **/
 
+#include <algorithm>
+#include <vector>
+
+#include <expr/collector.hh>
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 
@@ -33,6 +37,8 @@ namespace model {
 
     Model::Model()
         : f_modules()
+        , f_main(NULL)
+        , f_autoincrement(0)
     {
         const void* instance(this);
 
@@ -44,8 +50,14 @@ namespace model {
 
     Model::~Model()
     {
-        // TODO: free memory for symbols... (they've been allocated using new)
-        assert(false); // XXX
+        const void* instance(this);
+
+        /* modules are not freed, they are either merged into another
+           model or their symbols may still be referenced */
+        DEBUG
+            << "Destroyed Model instance @"
+            << instance
+            << std::endl;
     }
 
     Module& Model::add_module(Module& module)
@@ -59,11 +71,72 @@ namespace model {
 
         f_modules.insert(
             std::pair<expr::Expr_ptr, Module_ptr>(name, &module));
+        if (NULL == f_main) {
+            f_main = name;
+        }
 
         module.set_owner(this);
         return module;
     }
 
+    void Model::merge(Model& other)
+    {
+        if (NULL == f_main) {
+            f_main = other.f_main;
+        }
+
+        for (Modules::const_iterator i = other.f_modules.begin();
+             i != other.f_modules.end(); ++i) {
+            add_module(*i->second);
+        }
+
+        /* declaration ordering, replayed after ours */
+        std::vector<std::pair<unsigned, expr::Expr_ptr>> order;
+        for (SymbolIndexMap::const_iterator i = other.f_symbol_index_map.begin();
+             i != other.f_symbol_index_map.end(); ++i) {
+            order.push_back(std::make_pair(i->second, i->first));
+        }
+        std::sort(order.begin(), order.end());
+
+        for (const auto& entry : order) {
+            f_symbol_index_map.insert(
+                std::pair<expr::Expr_ptr, unsigned>(entry.second, ++f_autoincrement));
+        }
+
+        other.f_modules.clear();
+        other.f_main = NULL;
+        other.f_autoincrement = 0;
+        other.f_symbol_index_map.clear();
+    }
+
+    void Model::clear()
+    {
+        DEBUG
+            << "Clearing model"
+            << std::endl;
+
+        /* modules are not freed, their symbols may still be
+           referenced */
+        f_modules.clear();
+        f_main = NULL;
+
+        f_autoincrement = 0;
+        f_symbol_index_map.clear();
+    }
+
+    void Model::mark(expr::ExprMarker& marker) const
+    {
+        for (Modules::const_iterator i = f_modules.begin();
+             i != f_modules.end(); ++i) {
+            i->second->mark(marker);
+        }
+
+        for (SymbolIndexMap::const_iterator i = f_symbol_index_map.begin();
+             i != f_symbol_index_map.end(); ++i) {
+            marker.mark(i->first);
+        }
+    }
+
     Module& Model::module(expr::Expr_ptr module_name)
     {
         Modules::const_iterator i { f_modules.find(module_name) };
@@ -81,9 +154,7 @@ namespace model {
             throw MainModuleNotFound();
         }
 
-        Modules::const_iterator i { f_modules.begin() };
-
-        return *(i->second);
+        return module(f_main);
     }
 
     void Model::autoIndexSymbol(expr::Expr_ptr identifier)
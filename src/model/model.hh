@@ -47,16 +47,28 @@ namespace model {
         }
 
         Module& add_module(Module& module);
+
+        /* takes over the modules of `other` (e.g. read on their own),
+           their declarations follow the ones of this model, in the
+           same order. `other` is left empty */
+        void merge(Model& other);
+
+        /* forgets all modules, before reading a model again */
+        void clear();
         Module& module(expr::Expr_ptr module_name);
 
-        /* topmost module in the model */
+        /* topmost module in the model, i.e. the first one added */
         Module& main_module();
 
         void autoIndexSymbol(expr::Expr_ptr identifier);
         unsigned symbol_index(expr::Expr_ptr identifier);
 
+        /* the exprs of all modules are live */
+        void mark(expr::ExprMarker& marker) const;
+
     private:
         Modules f_modules;
+        expr::Expr_ptr f_main;
 
         unsigned f_autoincrement;
         SymbolIndexMap f_symbol_index_map;
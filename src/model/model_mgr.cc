@@ -21,6 +21,16 @@
  *
  **/
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread.hpp>
+
+#include <enc/enc_mgr.hh>
+
+#include <expr/collector.hh>
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 
@@ -31,29 +41,225 @@
 #include <model/model.hh>
 #include <model/model_mgr.hh>
 #include <model/module.hh>
+#include <model/ranges.hh>
+
+#include <opts/opts_mgr.hh>
 
+#include <utils/context.hh>
 #include <utils/logging.hh>
+#include <utils/profile.hh>
 
 namespace model {
 
     ModelMgr& ModelMgr::INSTANCE()
     {
-        if (!f_instance) {
-            f_instance = new ModelMgr();
-        }
-
-        return (*f_instance);
+        return utils::Context::current().instance<ModelMgr>(
+            utils::CONTEXT_MODEL, []() { return new ModelMgr(); });
     }
 
-    // static initialization
-    ModelMgr_ptr ModelMgr::f_instance { NULL };
-
     ModelMgr::ModelMgr()
         : f_model()
         , f_resolver(*this)
-        , f_type_checker(*this)
+        , f_type_cache()
+        , f_expansion_cache()
+        , f_type_checkers()
+        , f_signatures()
+        , f_pending_signatures()
+        , f_changed()
         , f_analyzed(false)
-    {}
+        , f_framed(false)
+        , f_boolean(false)
+    {
+        expr::ExprCollector& collector { expr::ExprCollector::INSTANCE() };
+
+        /* symbols of the modules read before a reset are still
+           referenced, and so are the names of the modules analyzed */
+        collector.add_roots(
+            "model", [this](expr::ExprMarker& marker) {
+                f_model.mark(marker);
+                f_resolver.mark(marker);
+                f_analyzer.mark(marker);
+
+                for (symb::Symbols::const_iterator i = f_symbols.begin();
+                     i != f_symbols.end(); ++i) {
+                    marker.mark(i->first);
+                    if (i->second) {
+                        i->second->mark(marker);
+                    }
+                }
+
+                for (SignatureMap::const_iterator i = f_signatures.begin();
+                     i != f_signatures.end(); ++i) {
+                    marker.mark(i->first);
+                }
+                for (SignatureMap::const_iterator i = f_pending_signatures.begin();
+                     i != f_pending_signatures.end(); ++i) {
+                    marker.mark(i->first);
+                }
+                for (auto changed : f_changed) {
+                    marker.mark(changed);
+                }
+
+                for (ContextMap::const_iterator i = f_context_map.begin();
+                     i != f_context_map.end(); ++i) {
+                    marker.mark(i->first);
+                }
+                for (ParamMap::const_iterator i = f_param_map.begin();
+                     i != f_param_map.end(); ++i) {
+                    marker.mark(i->first);
+                    marker.mark(i->second);
+                }
+            });
+
+        collector.add_cache(
+            "types of exprs", [this](expr::ExprMarker& marker) {
+                f_type_cache.prune(marker);
+            });
+
+        collector.add_cache(
+            "expansions of defines", [this](expr::ExprMarker& marker) {
+                f_expansion_cache.prune(marker);
+            });
+    }
+
+    TypeChecker& ModelMgr::checker()
+    {
+        TypeChecker* res { f_type_checkers.get() };
+
+        if (!res) {
+            res = new TypeChecker(*this, f_type_cache);
+            f_type_checkers.reset(res);
+        }
+
+        return *res;
+    }
+
+    void ModelMgr::reset()
+    {
+        f_model.clear();
+        f_analyzer.clear();
+
+        f_context_map.clear();
+        f_param_map.clear();
+
+        f_analyzed = false;
+    }
+
+    bool ModelMgr::changed(expr::Expr_ptr ctx) const
+    {
+        if (!ctx) {
+            ctx = expr::ExprMgr::INSTANCE().make_empty();
+        }
+
+        ContextMap::const_iterator mi { f_context_map.find(ctx) };
+        if (f_context_map.end() == mi) {
+            return true;
+        }
+
+        return f_changed.end() != f_changed.find(mi->second->name());
+    }
+
+    std::size_t ModelMgr::fingerprint() const
+    {
+        const Modules& modules { f_model.modules() };
+
+        /* regardless of the order of the modules */
+        std::size_t res { 0 };
+        for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+            res += signature(*mi->second);
+        }
+
+        return res;
+    }
+
+    void ModelMgr::diff_modules()
+    {
+        const Modules& modules { f_model.modules() };
+
+        f_pending_signatures.clear();
+        f_changed.clear();
+
+        for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+            expr::Expr_ptr name { mi->first };
+
+            std::size_t sig { signature(*mi->second) };
+            f_pending_signatures.insert(std::make_pair(name, sig));
+
+            SignatureMap::const_iterator si { f_signatures.find(name) };
+            if (f_signatures.end() == si || si->second != sig) {
+                f_changed.insert(name);
+            }
+        }
+
+        /* actual parameters may come from any module */
+        if (!f_changed.empty()) {
+            for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+                if (!mi->second->parameters().empty()) {
+                    f_changed.insert(mi->first);
+                }
+            }
+        }
+
+        /* modules refer to the symbols of the instances they hold */
+        bool fixpoint { false };
+        while (!fixpoint) {
+            fixpoint = true;
+
+            for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+                if (f_changed.end() != f_changed.find(mi->first)) {
+                    continue;
+                }
+
+                const symb::Variables& vars { mi->second->vars() };
+                for (symb::Variables::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+                    type::Type_ptr tp { vi->second->type() };
+
+                    if (tp->is_instance() &&
+                        f_changed.end() != f_changed.find(tp->as_instance()->name())) {
+                        f_changed.insert(mi->first);
+                        fixpoint = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        unsigned n_changed { (unsigned) f_changed.size() };
+        unsigned n_modules { (unsigned) modules.size() };
+        DEBUG
+            << n_changed
+            << " modules out of "
+            << n_modules
+            << " need analysis"
+            << std::endl;
+    }
+
+    std::size_t ModelMgr::signature(const Module& module) const
+    {
+        std::size_t res { module.signature() };
+        boost::hash_combine(res, opts::OptsMgr::INSTANCE().word_width());
+
+        return res;
+    }
+
+    void ModelMgr::trust(const std::vector<std::pair<expr::Expr_ptr, type::Type_ptr>>& types)
+    {
+        const Modules& modules { f_model.modules() };
+
+        f_signatures.clear();
+        for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+            f_signatures.insert(std::make_pair(mi->first, signature(*mi->second)));
+        }
+
+        f_type_cache.clear();
+        f_expansion_cache.clear();
+        for (std::vector<std::pair<expr::Expr_ptr, type::Type_ptr>>::const_iterator i = types.begin();
+             i != types.end(); ++i) {
+            f_type_cache.set(i->first, i->second);
+        }
+
+        f_framed = true;
+    }
 
     Module_ptr ModelMgr::scope(expr::Expr_ptr key)
     {
@@ -78,6 +284,9 @@ namespace model {
 	Model& model { f_model };
         Module& main_module { model.main_module() };
 
+        /* bodies to be type checked, by module instance */
+        std::vector<TypeCheckJobs> modules;
+
         std::stack<boost::tuple<expr::Expr_ptr, Module_ptr, expr::Expr_ptr>> stack;
         stack.push(
 	    boost::make_tuple<expr::Expr_ptr, Module_ptr, expr::Expr_ptr>
@@ -217,115 +426,36 @@ namespace model {
                 } // for defines
             }     /* MMGR_ANALYZE */
 
-            else if (MMGR_TYPE_CHECK == pass) {
+            /* types of unchanged modules are known already */
+            else if (MMGR_TYPE_CHECK == pass &&
+                     f_changed.end() != f_changed.find(curr_module.name())) {
+                TypeCheckJobs jobs;
+
                 const expr::ExprVector& init { curr_module.init() };
                 for (expr::ExprVector::const_iterator ii = init.begin();
                      ii != init.end(); ++ii) {
-
-                    expr::Expr_ptr body { *ii };
-
-                    DEBUG
-                        << "Type checking INIT "
-                        << curr_ctx << "::" << body
-                        << std::endl;
-
-                    try {
-                        f_type_checker.process(body, curr_ctx);
-                    } catch (Exception& ae) {
-                        std::string tmp(ae.what());
-
-                        WARN
-                            << tmp
-                            << std::endl
-                            << "  in INIT "
-                            << curr_ctx << "::" << body
-                            << std::endl;
-
-                        return false;
-                    }
-                } // for init
+                    jobs.push_back(TypeCheckJob { "INIT", curr_ctx, *ii });
+                }
 
                 const expr::ExprVector& invar { curr_module.invar() };
                 for (expr::ExprVector::const_iterator ii = invar.begin();
                      ii != invar.end(); ++ii) {
-
-                    expr::Expr_ptr body { *ii };
-
-                    DEBUG
-                        << "Type checking INVAR "
-                        << curr_ctx << "::" << body
-                        << std::endl;
-
-                    try {
-                        f_type_checker.process(body, curr_ctx);
-                    } catch (Exception& ae) {
-                        std::string tmp { ae.what() };
-
-                        WARN
-                            << tmp
-                            << std::endl
-                            << "  in INVAR "
-                            << curr_ctx << "::" << body
-                            << std::endl;
-
-                        return false;
-                    }
-                } // for invar
+                    jobs.push_back(TypeCheckJob { "INVAR", curr_ctx, *ii });
+                }
 
                 const expr::ExprVector& trans { curr_module.trans() };
                 for (expr::ExprVector::const_iterator ti = trans.begin();
                      ti != trans.end(); ++ti) {
-
-                    expr::Expr_ptr body { *ti };
-
-                    DEBUG
-                        << "Type checking TRANS "
-                        << curr_ctx << "::" << body
-                        << std::endl;
-
-                    try {
-                        f_type_checker.process(body, curr_ctx);
-                    } catch (Exception& ae) {
-                        std::string tmp { ae.what() };
-
-                        WARN
-                            << tmp
-                            << std::endl
-                            << "  in TRANS "
-                            << curr_ctx << "::" << body
-                            << std::endl;
-
-                        return false;
-                    }
-                } // for trans
+                    jobs.push_back(TypeCheckJob { "TRANS", curr_ctx, *ti });
+                }
 
                 const symb::Defines& defs { curr_module.defs() };
-
                 for (symb::Defines::const_iterator di = defs.begin();
                      di != defs.end(); ++di) {
+                    jobs.push_back(TypeCheckJob { "DEFINE", curr_ctx, (*di).second->body() });
+                }
 
-                    expr::Expr_ptr body { (*di).second->body() };
-
-                    DEBUG
-                        << "Type checking "
-                        << curr_ctx << "::" << body
-                        << std::endl;
-
-                    try {
-                        f_type_checker.process(body, curr_ctx);
-                    } catch (Exception& ae) {
-                        std::string tmp { ae.what() };
-
-                        WARN
-                            << tmp
-                            << std::endl
-                            << "  in DEFINE "
-                            << curr_ctx << "::" << body
-                            << std::endl;
-
-                        return false;
-                    }
-                } // for defines
+                modules.push_back(jobs);
             }     /* MMGR_TYPE_CHECK */
 
             symb::Variables attrs { curr_module.vars() };
@@ -401,23 +531,217 @@ namespace model {
             }
         }
 
+        if (MMGR_TYPE_CHECK == pass) {
+            return type_check(modules);
+        }
+
+        return true;
+    }
+
+    bool ModelMgr::type_check(const std::vector<TypeCheckJobs>& modules)
+    {
+        unsigned nthreads { opts::OptsMgr::INSTANCE().threads() };
+        if (0 == nthreads) {
+            nthreads = std::max(1U, boost::thread::hardware_concurrency());
+        }
+        nthreads = std::min(nthreads, (unsigned) modules.size());
+
+        /* the failing body and the message, by module */
+        std::vector<const TypeCheckJob*> failed(modules.size(), NULL);
+        std::vector<std::string> messages(modules.size());
+
+        /* modules are picked in order, no new one is started after a
+           failure. Thus all modules before the first failing one
+           are checked, as they would be in a sequential walk */
+        std::atomic<unsigned> next { 0 };
+        std::atomic<bool> failure { false };
+
+        /* anything other than a type error is rethrown */
+        std::exception_ptr unexpected;
+        boost::mutex unexpected_mutex;
+
+        /* workers check in the context of the caller */
+        utils::Context& context { utils::Context::current() };
+
+        auto worker = [&]() {
+            utils::ContextScope scope { context };
+            TypeChecker& type_checker { checker() };
+
+            for (unsigned i = next++; i < modules.size() && !failure; i = next++) {
+                const TypeCheckJobs& jobs { modules[i] };
+
+                for (TypeCheckJobs::const_iterator ji = jobs.begin();
+                     ji != jobs.end(); ++ji) {
+
+                    DEBUG
+                        << "Type checking "
+                        << ji->section << " "
+                        << ji->ctx << "::" << ji->body
+                        << std::endl;
+
+                    try {
+                        type_checker.process(ji->body, ji->ctx);
+                    } catch (Exception& ae) {
+                        failed[i] = &(*ji);
+                        messages[i] = ae.what();
+                        failure = true;
+                        break;
+                    } catch (...) {
+                        boost::mutex::scoped_lock lock { unexpected_mutex };
+                        if (!unexpected) {
+                            unexpected = std::current_exception();
+                        }
+                        failure = true;
+                        break;
+                    }
+                }
+            }
+        };
+
+        if (1 < nthreads) {
+            boost::thread_group threads;
+            for (unsigned i = 0; i < nthreads; ++i) {
+                threads.create_thread(worker);
+            }
+            threads.join_all();
+        } else {
+            worker();
+        }
+
+        if (unexpected) {
+            std::rethrow_exception(unexpected);
+        }
+
+        for (unsigned i = 0; i < modules.size(); ++i) {
+            const TypeCheckJob* job { failed[i] };
+
+            if (job) {
+                WARN
+                    << messages[i]
+                    << std::endl
+                    << "  in "
+                    << job->section << " "
+                    << job->ctx << "::" << job->body
+                    << std::endl;
+
+                return false;
+            }
+        }
+
         return true;
     }
 
+    void ModelMgr::report_dead_symbols()
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        unsigned n_dead_vars { 0 };
+        unsigned n_dead_defines { 0 };
+
+        for (ContextMap::const_iterator i = f_context_map.begin();
+             i != f_context_map.end(); ++i) {
+            expr::Expr_ptr ctx { i->first };
+            const Module& module { *i->second };
+
+            const symb::Variables& vars { module.vars() };
+            for (symb::Variables::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+                expr::Expr_ptr full { em.make_dot(ctx, vi->first) };
+
+                if (!vi->second->type()->is_instance() && !is_live(full)) {
+                    DRIVEL
+                        << "Var `"
+                        << full
+                        << "` is dead"
+                        << std::endl;
+
+                    ++n_dead_vars;
+                }
+            }
+
+            const symb::Defines& defs { module.defs() };
+            for (symb::Defines::const_iterator di = defs.begin(); di != defs.end(); ++di) {
+                expr::Expr_ptr full { em.make_dot(ctx, di->first) };
+
+                if (!is_live(full)) {
+                    DRIVEL
+                        << "DEFINE `"
+                        << full
+                        << "` is unused"
+                        << std::endl;
+
+                    ++n_dead_defines;
+                }
+            }
+        }
+
+        if (0 < n_dead_vars || 0 < n_dead_defines) {
+            INFO
+                << n_dead_vars
+                << " vars and "
+                << n_dead_defines
+                << " DEFINEs have no influence on INIT, INVAR and TRANS"
+                << std::endl;
+        }
+    }
+
     /* This method performs several DFS walks of the model, starting
      * from module MAIN. During each walk a different task is
      * executed. Refer to analyzer_pass_t enum definition for the
      * exact sequence of actions. */
+    void ModelMgr::detect_boolean()
+    {
+        const Modules& modules { f_model.modules() };
+
+        f_boolean = true;
+        for (Modules::const_iterator mi = modules.begin();
+             f_boolean && mi != modules.end(); ++mi) {
+            const symb::Variables& vars { mi->second->vars() };
+            for (symb::Variables::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+                type::Type_ptr tp { vi->second->type() };
+
+                if (!tp->is_boolean() && !tp->is_enum() && !tp->is_instance()) {
+                    f_boolean = false;
+                    break;
+                }
+            }
+        }
+
+        if (f_boolean) {
+            DEBUG
+                << "Boolean model, no microcode needed"
+                << std::endl;
+        }
+    }
+
     bool ModelMgr::analyze()
     {
+        utils::ProfileScope scope { "analysis" };
+
         analyzer_pass_t pass { (analyzer_pass_t) 0 };
 
+        bool framed { f_framed };
+        f_framed = false;
+
+        /* before framing conditions are added */
+        diff_modules();
+
         while (pass < MMGR_DONE) {
             DRIVEL
                 << "Model analysis (pass " << pass << ")"
                 << std::endl;
 
+            if (MMGR_TYPE_CHECK == pass) {
+                f_type_cache.erase_if([this](expr::Expr_ptr ctx) {
+                    return changed(ctx);
+                });
+                f_expansion_cache.erase_if([this](expr::Expr_ptr ctx) {
+                    return changed(ctx);
+                });
+            }
+
             if (!analyze_aux(pass)) {
+                /* nothing is trusted on the next reading */
+                f_signatures.clear();
                 return false;
             } else {
                 int tmp { 1 + (int) pass };
@@ -425,8 +749,26 @@ namespace model {
             }
         }
 
+        f_signatures.swap(f_pending_signatures);
         f_analyzed = true;
-        f_analyzer.generate_framing_conditions();
+
+        /* encodings made from now on follow the uses of enums */
+        enc::EncodingMgr::INSTANCE().set_enum_uses(f_analyzer.enum_uses());
+
+        /* algebraic vars of a known range take fewer bits */
+        enc::VarWidths widths;
+        if (opts::OptsMgr::INSTANCE().narrow_ranges()) {
+            RangeAnalyzer ranges { f_model };
+            ranges.narrowed_widths(widths);
+        }
+        enc::EncodingMgr::INSTANCE().set_var_widths(widths);
+
+        report_dead_symbols();
+        detect_boolean();
+
+        if (!framed) {
+            f_analyzer.generate_framing_conditions();
+        }
 
         TRACE
             << "Model analysis complete"
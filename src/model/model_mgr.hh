@@ -37,6 +37,9 @@
 
 #include <type/type_mgr.hh>
 
+#include <boost/thread/tss.hpp>
+#include <boost/unordered_set.hpp>
+
 namespace model {
 
     using ContextMap =
@@ -45,6 +48,10 @@ namespace model {
     using ParamMap =
 	boost::unordered_map<expr::Expr_ptr, expr::Expr_ptr>;
 
+    /* module name -> signature, as of the last successful analysis */
+    using SignatureMap =
+	boost::unordered_map<expr::Expr_ptr, std::size_t, utils::PtrHash, utils::PtrEq>;
+
     typedef enum {
         MMGR_BUILD_CTX_MAP,
         MMGR_BUILD_PARAM_MAP,
@@ -53,6 +60,16 @@ namespace model {
         MMGR_DONE
     } analyzer_pass_t;
 
+    /* a body to be type checked, section is "INIT", "INVAR", ... */
+    struct TypeCheckJob {
+        const char* section;
+        expr::Expr_ptr ctx;
+        expr::Expr_ptr body;
+    };
+
+    /* the bodies of one module instance, checked by the same thread */
+    typedef std::vector<TypeCheckJob> TypeCheckJobs;
+
     typedef class ModelMgr* ModelMgr_ptr;
     class ModelMgr {
 
@@ -78,19 +95,70 @@ namespace model {
         // this must be called before any type checking
         bool analyze();
 
+        /* forgets the model, before reading it again. Signatures of
+           the modules analyzed so far are kept, modules that did not
+           change are not type checked again */
+        void reset();
+
+        /* true iff the module instance at ctx (NULL for main) is new,
+           or its module changed on the last analysis, or depends on
+           one that did. Results built on unchanged instances can be
+           kept */
+        bool changed(expr::Expr_ptr ctx) const;
+
+        /* true iff every var of the model is boolean or of an enum
+           type (module instances aside), as of the last analysis:
+           its units are made of DDs only, no microcode is needed */
+        inline bool is_boolean() const
+        {
+            return f_boolean;
+        }
+
+        /* identifies the model read, models made of the same modules
+           have the same fingerprint */
+        std::size_t fingerprint() const;
+
+        /* the types of pairs (ctx, body) known so far */
+        inline TypeCache& type_cache()
+        {
+            return f_type_cache;
+        }
+
+        /* the expansions of parametric DEFINE calls known so far */
+        inline ExpansionCache& expansion_cache()
+        {
+            return f_expansion_cache;
+        }
+
+        /* the modules read so far are taken as analyzed (e.g. they
+           come from a snapshot), along with the given types and their
+           framing conditions. The next analysis does not type check
+           them, nor does it add framing conditions */
+        void trust(const std::vector<std::pair<expr::Expr_ptr, type::Type_ptr>>& types);
+
         inline Analyzer& analyzer()
         {
             return f_analyzer;
         }
 
+        /* true iff the var or DEFINE of fully qualified name full has
+           an influence on INIT, INVAR or TRANS, as of the last
+           analysis. Dead vars take any value at any time, they need
+           not be told apart in states */
+        inline bool is_live(expr::Expr_ptr full) const
+        {
+            return f_analyzer.live().end() != f_analyzer.live().find(full);
+        }
+
         // delegated type inference method
         inline type::Type_ptr type(expr::Expr_ptr body,
                                    expr::Expr_ptr ctx = expr::ExprMgr::INSTANCE().make_empty())
         {
             assert(f_analyzed);
-            return f_type_checker.type(body, ctx);
+            return checker().type(body, ctx);
         }
 
+
         Module_ptr scope(expr::Expr_ptr ctx);
 
         expr::Expr_ptr rewrite_parameter(expr::Expr_ptr expr);
@@ -108,22 +176,51 @@ namespace model {
         }
 
     private:
-        static ModelMgr_ptr f_instance;
-
         /* local data */
         Model f_model;
 
         // owned
         ModelResolver f_resolver;
         Analyzer f_analyzer;
-        TypeChecker f_type_checker;
+        TypeCache f_type_cache;
+        ExpansionCache f_expansion_cache;
+
+        /* one checker per thread, sharing the cache */
+        boost::thread_specific_ptr<TypeChecker> f_type_checkers;
+        TypeChecker& checker();
+
+        SignatureMap f_signatures;
+        SignatureMap f_pending_signatures;
+
+        /* names of the changed modules */
+        boost::unordered_set<expr::Expr_ptr, utils::PtrHash, utils::PtrEq> f_changed;
+
+        /* compares modules against the last analysis */
+        void diff_modules();
+
+        /* types of constants depend on the word width */
+        std::size_t signature(const Module& module) const;
+
+        /* logs the vars and DEFINEs the FSM does not depend on */
+        void report_dead_symbols();
 
         ContextMap f_context_map;
         ParamMap f_param_map;
 
         /* internals */
         bool analyze_aux(analyzer_pass_t pass);
+
+        /* modules are checked in parallel, errors are reported in
+           the order of the walk */
+        bool type_check(const std::vector<TypeCheckJobs>& modules);
         bool f_analyzed;
+
+        /* framing conditions are in the model already */
+        bool f_framed;
+
+        /* no algebraic nor array vars, see is_boolean() */
+        bool f_boolean;
+        void detect_boolean();
     };
 
 } // namespace model
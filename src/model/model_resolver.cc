@@ -23,6 +23,8 @@
 
 #include <algorithm>
 
+#include <expr/collector.hh>
+
 #include <model/model.hh>
 #include <model/model_mgr.hh>
 #include <model/model_resolver.hh>
@@ -64,6 +66,15 @@ namespace model {
     ModelResolver::~ModelResolver()
     {}
 
+    void ModelResolver::mark(expr::ExprMarker& marker) const
+    {
+        for (symb::Constants::const_iterator i = f_constants.begin();
+             i != f_constants.end(); ++i) {
+            marker.mark(i->first);
+            i->second->mark(marker);
+        }
+    }
+
     void ModelResolver::add_symbol(const expr::Expr_ptr key, symb::Symbol_ptr symb)
     {
         // TODO: turn this into an exception
@@ -40,6 +40,9 @@ namespace model {
         void add_symbol(const expr::Expr_ptr key, symb::Symbol_ptr symb);
         symb::Symbol_ptr symbol(const expr::Expr_ptr key);
 
+        /* the exprs of the global consts are live */
+        void mark(expr::ExprMarker& marker) const;
+
     private:
         ModelMgr& f_owner;
         symb::Constants f_constants; // global consts
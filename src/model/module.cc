@@ -25,6 +25,10 @@
 #include <string>
 #include <utility>
 
+#include <boost/functional/hash.hpp>
+
+#include <expr/collector.hh>
+
 #include <model/exceptions.hh>
 #include <model/model.hh>
 #include <model/module.hh>
@@ -229,4 +233,81 @@ namespace model {
         f_trans.push_back(expr);
     }
 
+    void Module::mark(expr::ExprMarker& marker) const
+    {
+        marker.mark(f_name);
+        for (expr::ExprSet::const_iterator i = f_locals.begin();
+             i != f_locals.end(); ++i) {
+            marker.mark(*i);
+        }
+
+        for (symb::Variables::const_iterator vi = f_localVars.begin();
+             vi != f_localVars.end(); ++vi) {
+            marker.mark(vi->first);
+            vi->second->mark(marker);
+        }
+        for (symb::Parameters::const_iterator pi = f_localParams.begin();
+             pi != f_localParams.end(); ++pi) {
+            marker.mark(pi->first);
+            pi->second->mark(marker);
+        }
+        for (symb::Defines::const_iterator di = f_localDefs.begin();
+             di != f_localDefs.end(); ++di) {
+            marker.mark(di->first);
+            di->second->mark(marker);
+        }
+
+        marker.mark(f_init);
+        marker.mark(f_invar);
+        marker.mark(f_trans);
+    }
+
+    std::size_t Module::signature() const
+    {
+        std::size_t res { boost::hash<void*>()(f_name) };
+
+        /* decls are not ordered */
+        std::size_t decls { 0 };
+        for (symb::Variables::const_iterator vi = f_localVars.begin();
+             vi != f_localVars.end(); ++vi) {
+            const symb::Variable& var { *vi->second };
+
+            std::size_t h { boost::hash<void*>()(vi->first) };
+            boost::hash_combine(h, (void*) var.type());
+            boost::hash_combine(h, var.is_hidden());
+            boost::hash_combine(h, var.is_input());
+            boost::hash_combine(h, var.is_inertial());
+            boost::hash_combine(h, var.is_frozen());
+
+            decls += h;
+        }
+        for (symb::Defines::const_iterator di = f_localDefs.begin();
+             di != f_localDefs.end(); ++di) {
+            const symb::Define& def { *di->second };
+
+            std::size_t h { boost::hash<void*>()(di->first) };
+            boost::hash_combine(h, (void*) def.body());
+            boost::hash_combine(h, def.is_hidden());
+
+            decls += h;
+        }
+        boost::hash_combine(res, decls);
+
+        for (symb::Parameters::const_iterator pi = f_localParams.begin();
+             pi != f_localParams.end(); ++pi) {
+            boost::hash_combine(res, (void*) pi->first);
+            boost::hash_combine(res, (void*) pi->second->type());
+        }
+
+        for (const expr::ExprVector* exprs : { &f_init, &f_invar, &f_trans }) {
+            boost::hash_combine(res, exprs->size());
+            for (expr::ExprVector::const_iterator i = exprs->begin();
+                 i != exprs->end(); ++i) {
+                boost::hash_combine(res, (void*) *i);
+            }
+        }
+
+        return res;
+    }
+
 }; // namespace model
@@ -81,6 +81,14 @@ namespace model {
         }
         void add_trans(expr::Expr_ptr expr);
 
+        /* a hash of the declarations and of the bodies, as parsed.
+           Exprs and types are pooled, equal modules have equal
+           signatures over a session */
+        std::size_t signature() const;
+
+        /* the exprs of the module are live */
+        void mark(expr::ExprMarker& marker) const;
+
     private:
         friend std::ostream& operator<<(std::ostream& os, Module& module);
 
@@ -0,0 +1,918 @@
+/**
+ * @file ranges.cc
+ * @brief Model management subsystem, value range analysis
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <climits>
+#include <stack>
+
+#include <expr/expr_mgr.hh>
+
+#include <model/model_mgr.hh>
+#include <model/module.hh>
+#include <model/ranges.hh>
+
+#include <symb/classes.hh>
+#include <symb/exceptions.hh>
+#include <symb/proxy.hh>
+
+#include <type/classes.hh>
+
+#include <utils/logging.hh>
+
+namespace model {
+
+    /* rounds of the fixpoint iteration before bounds still growing
+       are widened, and narrowing rounds once a fixpoint is reached */
+    static const unsigned ranges_widen_after { 4 };
+    static const unsigned ranges_narrowings { 2 };
+
+    /* DEFINEs and ITEs nested deeper than this take any value */
+    static const unsigned ranges_max_depth { 64 };
+
+    static inline expr::ExprType negated(expr::ExprType symb)
+    {
+        switch (symb) {
+            case expr::EQ:
+                return expr::NE;
+            case expr::NE:
+                return expr::EQ;
+            case expr::LT:
+                return expr::GE;
+            case expr::GE:
+                return expr::LT;
+            case expr::LE:
+                return expr::GT;
+            case expr::GT:
+                return expr::LE;
+            default:
+                assert(false);
+                return symb;
+        }
+    }
+
+    /* `a op b` is `b mirrored(op) a` */
+    static inline expr::ExprType mirrored(expr::ExprType symb)
+    {
+        switch (symb) {
+            case expr::LT:
+                return expr::GT;
+            case expr::GT:
+                return expr::LT;
+            case expr::LE:
+                return expr::GE;
+            case expr::GE:
+                return expr::LE;
+            default:
+                return symb;
+        }
+    }
+
+    static inline bool is_relational(expr::ExprType symb)
+    {
+        return expr::EQ == symb || expr::NE == symb ||
+               expr::LT == symb || expr::LE == symb ||
+               expr::GT == symb || expr::GE == symb;
+    }
+
+    RangeAnalyzer::RangeAnalyzer(Model& model)
+        : f_model(model)
+        , f_em(expr::ExprMgr::INSTANCE())
+    {
+        collect_scopes();
+
+        for (const auto& pair : f_vars) {
+            f_invariant[pair.first] = any(pair.second.width, pair.second.is_signed);
+        }
+
+        for (const auto& invar : f_invar) {
+            if (!refine(invar.first, invar.second, true, f_invariant, f_invariant)) {
+                DEBUG
+                    << "INVARs have no states, no ranges inferred"
+                    << std::endl;
+                return;
+            }
+        }
+
+        Box init { f_invariant };
+        for (const auto& body : f_init) {
+            if (!refine(body.first, body.second, true, init, init)) {
+                DEBUG
+                    << "INITs have no states, no ranges inferred"
+                    << std::endl;
+                return;
+            }
+        }
+
+        for (const auto& body : f_trans) {
+            collect_updates(body.first, body.second);
+        }
+
+        for (auto& pair : f_vars) {
+            StateVar& var { pair.second };
+
+            var.bounded = exhaustive(var.updates);
+            for (const auto& update : var.updates) {
+                if (NULL == update.guard) {
+                    var.bounded = true;
+                }
+            }
+        }
+
+        /* ascending, widening the bounds still growing after a few
+           rounds to the ones of INVARs */
+        Box box { init };
+        bool stable { false };
+        for (unsigned round = 0; !stable; ++round) {
+            Box next { post(box) };
+
+            stable = true;
+            for (auto& pair : box) {
+                Interval& current { pair.second };
+                Interval grown { join(current, next[pair.first]) };
+
+                if (same(current, grown)) {
+                    continue;
+                }
+
+                stable = false;
+                if (ranges_widen_after <= round && !grown.top) {
+                    const Interval& invariant { f_invariant[pair.first] };
+
+                    if (invariant.top) {
+                        grown = invariant;
+                    } else {
+                        if (grown.lo < current.lo) {
+                            grown.lo = invariant.lo;
+                        }
+                        if (current.hi < grown.hi) {
+                            grown.hi = invariant.hi;
+                        }
+                    }
+                }
+
+                current = grown;
+            }
+        }
+
+        /* box is a post-fixpoint, the successors of its states are
+           (again) one */
+        for (unsigned i = 0; i < ranges_narrowings; ++i) {
+            Box next { post(box) };
+
+            for (auto& pair : box) {
+                pair.second = meet(pair.second,
+                                   join(init[pair.first], next[pair.first]));
+            }
+        }
+
+        for (const auto& pair : box) {
+            const Interval& interval { pair.second };
+
+            if (!interval.empty && !interval.top) {
+                ValueRange range { interval.lo, interval.hi };
+                f_ranges[pair.first] = range;
+            }
+        }
+
+        unsigned n_ranges { (unsigned) f_ranges.size() };
+        DEBUG
+            << n_ranges
+            << " var ranges inferred"
+            << std::endl;
+    }
+
+    RangeAnalyzer::~RangeAnalyzer()
+    {}
+
+    void RangeAnalyzer::narrowed_widths(enc::VarWidths& res) const
+    {
+        for (const auto& pair : f_ranges) {
+            StateVars::const_iterator i { f_vars.find(pair.first) };
+            assert(f_vars.end() != i);
+
+            const StateVar& var { i->second };
+            value_t lo { pair.second.lo };
+            value_t hi { pair.second.hi };
+
+            unsigned bits { 1 };
+            if (var.is_signed) {
+                while (bits < var.width &&
+                       (lo < -(1L << (bits - 1)) || (1L << (bits - 1)) - 1 < hi)) {
+                    ++bits;
+                }
+            } else {
+                while (bits < var.width && 0 != (hi >> bits)) {
+                    ++bits;
+                }
+            }
+
+            if (bits < var.width) {
+                DEBUG
+                    << pair.first
+                    << " is in ["
+                    << lo
+                    << ", "
+                    << hi
+                    << "], "
+                    << bits
+                    << " bits out of "
+                    << var.width
+                    << std::endl;
+
+                res[pair.first] = bits;
+            }
+        }
+    }
+
+    void RangeAnalyzer::collect_scopes()
+    {
+        std::stack<std::pair<expr::Expr_ptr, Module_ptr>> stack;
+        stack.push(std::make_pair(f_em.make_empty(), &f_model.main_module()));
+
+        while (0 < stack.size()) {
+            const std::pair<expr::Expr_ptr, Module_ptr> top { stack.top() };
+            stack.pop();
+
+            expr::Expr_ptr ctx { top.first };
+            Module& module { *top.second };
+
+            const symb::Variables& vars { module.vars() };
+            for (const auto& pair : vars) {
+                const symb::Variable& var { *pair.second };
+                type::Type_ptr vtype { var.type() };
+
+                if (vtype->is_instance()) {
+                    type::InstanceType_ptr instance { vtype->as_instance() };
+                    stack.push(std::make_pair(f_em.make_dot(ctx, pair.first),
+                                              &f_model.module(instance->name())));
+                    continue;
+                }
+
+                /* INPUT vars are in fact bodyless, typed DEFINEs */
+                if (!vtype->is_algebraic() || var.is_input()) {
+                    continue;
+                }
+
+                StateVar state_var {
+                    vtype->as_algebraic()->width(),
+                    vtype->is_signed_algebraic(),
+                    var.is_frozen(),
+                    Updates(),
+                    false
+                };
+                f_vars[f_em.make_dot(ctx, pair.first)] = state_var;
+            }
+
+            for (auto body : module.init()) {
+                f_init.push_back(std::make_pair(ctx, body));
+            }
+            for (auto body : module.invar()) {
+                f_invar.push_back(std::make_pair(ctx, body));
+            }
+            for (auto body : module.trans()) {
+                f_trans.push_back(std::make_pair(ctx, body));
+            }
+        }
+    }
+
+    void RangeAnalyzer::collect_updates(expr::Expr_ptr ctx, expr::Expr_ptr body)
+    {
+        if (f_em.is_and(body)) {
+            collect_updates(ctx, body->lhs());
+            collect_updates(ctx, body->rhs());
+            return;
+        }
+
+        expr::Expr_ptr guard { NULL };
+        expr::Expr_ptr action { body };
+        if (f_em.is_guard(body) || f_em.is_implies(body)) {
+            guard = body->lhs();
+            action = body->rhs();
+        }
+
+        expr::Expr_ptr lhs, rhs;
+        if (f_em.is_assignment(action)) {
+            lhs = action->lhs();
+            rhs = action->rhs();
+        } else if (f_em.is_eq(action) && f_em.is_next(action->lhs())) {
+            lhs = action->lhs()->lhs();
+            rhs = action->rhs();
+        } else if (f_em.is_eq(action) && f_em.is_next(action->rhs())) {
+            lhs = action->rhs()->lhs();
+            rhs = action->lhs();
+        } else {
+            return;
+        }
+
+        expr::Expr_ptr full;
+        if (state_var(ctx, lhs, full)) {
+            Update update { ctx, guard, rhs };
+            f_vars[full].updates.push_back(update);
+        }
+    }
+
+    /* framing conditions, see Analyzer::generate_framing_conditions */
+    bool RangeAnalyzer::exhaustive(const Updates& updates)
+    {
+        for (const auto& update : updates) {
+            if (NULL == update.guard) {
+                continue;
+            }
+
+            /* flattened conjunction */
+            expr::ExprVector conjuncts;
+            expr::ExprVector stack { update.guard };
+            while (!stack.empty()) {
+                expr::Expr_ptr top { stack.back() };
+                stack.pop_back();
+
+                if (f_em.is_and(top)) {
+                    stack.push_back(top->lhs());
+                    stack.push_back(top->rhs());
+                } else {
+                    conjuncts.push_back(top);
+                }
+            }
+
+            bool frame { true };
+            for (auto conjunct : conjuncts) {
+                if (!f_em.is_not(conjunct)) {
+                    frame = false;
+                    break;
+                }
+
+                expr::Expr_ptr negated { conjunct->lhs() };
+                frame = std::any_of(updates.begin(), updates.end(),
+                                    [&update, negated](const Update& other) {
+                                        return &other != &update &&
+                                               other.ctx == update.ctx &&
+                                               other.guard == negated;
+                                    });
+                if (!frame) {
+                    break;
+                }
+            }
+
+            if (frame) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    RangeAnalyzer::Box RangeAnalyzer::post(const Box& box)
+    {
+        Box res;
+
+        for (const auto& pair : f_vars) {
+            expr::Expr_ptr full { pair.first };
+            const StateVar& var { pair.second };
+            const Interval& invariant { f_invariant[full] };
+
+            Box::const_iterator i { box.find(full) };
+            assert(box.end() != i);
+
+            Interval next;
+            if (var.frozen) {
+                next = i->second;
+            } else if (!var.bounded) {
+                next = invariant;
+            } else {
+                /* plain assignments bound the successors by
+                   themselves */
+                bool plain { false };
+                next = any(var.width, var.is_signed);
+                for (const auto& update : var.updates) {
+                    if (NULL == update.guard) {
+                        plain = true;
+                        next = meet(next, assign(var, eval(update.ctx, update.rhs, box, box)));
+                    }
+                }
+
+                if (!plain) {
+                    next.empty = true;
+                    for (const auto& update : var.updates) {
+                        Box refined { box };
+                        if (refine(update.ctx, update.guard, true, refined, box)) {
+                            next = join(next, assign(var, eval(update.ctx, update.rhs,
+                                                               refined, box)));
+                        }
+                    }
+                }
+
+                next = meet(next, invariant);
+            }
+
+            res[full] = next;
+        }
+
+        return res;
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::assign(const StateVar& var,
+                                                  const Interval& value)
+    {
+        Interval range { any(var.width, var.is_signed) };
+        if (value.empty) {
+            return value;
+        }
+
+        /* values out of range wrap around */
+        if (value.top ||
+            (range.top ? value.lo < 0 : value.lo < range.lo || range.hi < value.hi)) {
+            return range;
+        }
+
+        Interval res { value };
+        res.width = var.width;
+        res.is_signed = var.is_signed;
+
+        return res;
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::eval(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                                const Box& box, const Box& next_box,
+                                                unsigned depth)
+    {
+        const Interval top { false, true, 0, 0, 0, false };
+
+        if (ranges_max_depth < depth) {
+            return top;
+        }
+
+        if (f_em.is_int_const(expr)) {
+            value_t value { f_em.const_value(expr) };
+            Interval res { false, false, value, value, 0, false };
+            return res;
+        }
+
+        if (f_em.is_next(expr)) {
+            return eval(ctx, expr->lhs(), next_box, next_box, 1 + depth);
+        }
+
+        if (f_em.is_dot(expr)) {
+            return eval(f_em.make_dot(ctx, expr->lhs()), expr->rhs(),
+                        box, next_box, 1 + depth);
+        }
+
+        if (f_em.is_identifier(expr)) {
+            expr::Expr_ptr full { f_em.make_dot(ctx, expr) };
+
+            Box::const_iterator i { box.find(full) };
+            if (box.end() != i) {
+                return i->second;
+            }
+
+            symb::Symbol_ptr symb;
+            try {
+                symb::ResolverProxy resolver;
+                symb = resolver.symbol(full);
+            } catch (symb::UnresolvedSymbol& us) {
+                return top;
+            }
+
+            if (symb->is_const()) {
+                value_t value { symb->as_const().value() };
+                Interval res { false, false, value, value, 0, false };
+                return res;
+            }
+
+            if (symb->is_variable()) {
+                type::Type_ptr vtype { symb->as_variable().type() };
+                return vtype->is_algebraic()
+                           ? any(vtype->as_algebraic()->width(),
+                                 vtype->is_signed_algebraic())
+                           : top;
+            }
+
+            if (symb->is_define()) {
+                return eval(ctx, symb->as_define().body(), box, next_box, 1 + depth);
+            }
+
+            if (symb->is_parameter()) {
+                expr::Expr_ptr rewrite { ModelMgr::INSTANCE().rewrite_parameter(full) };
+                return eval(rewrite->lhs(), rewrite->rhs(), box, next_box, 1 + depth);
+            }
+
+            return top;
+        }
+
+        switch (expr->symb()) {
+            case expr::NEG: {
+                Interval zero { false, false, 0, 0, 0, false };
+                return eval_arithmetic(expr::SUB, zero,
+                                       eval(ctx, expr->lhs(), box, next_box, 1 + depth));
+            }
+
+            case expr::PLUS:
+            case expr::SUB:
+            case expr::MUL:
+            case expr::DIV:
+            case expr::MOD:
+                return eval_arithmetic(expr->symb(),
+                                       eval(ctx, expr->lhs(), box, next_box, 1 + depth),
+                                       eval(ctx, expr->rhs(), box, next_box, 1 + depth));
+
+            case expr::ITE: {
+                expr::Expr_ptr cond { expr->lhs() };
+                if (!f_em.is_cond(cond)) {
+                    return top;
+                }
+
+                Interval res { true, false, 0, 0, 0, false };
+
+                Box then_box { box };
+                if (refine(ctx, cond->lhs(), true, then_box, next_box)) {
+                    res = join(res, eval(ctx, cond->rhs(), then_box, next_box, 1 + depth));
+                }
+
+                Box else_box { box };
+                if (refine(ctx, cond->lhs(), false, else_box, next_box)) {
+                    res = join(res, eval(ctx, expr->rhs(), else_box, next_box, 1 + depth));
+                }
+
+                return res;
+            }
+
+            default:
+                return top;
+        }
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::eval_arithmetic(expr::ExprType symb,
+                                                           Interval a, Interval b)
+    {
+        if (a.empty) {
+            return a;
+        }
+        if (b.empty) {
+            return b;
+        }
+
+        /* the type of the non-constant operand, if any */
+        unsigned width { std::max(a.width, b.width) };
+        bool is_signed { a.is_signed || b.is_signed };
+        Interval range { any(width, is_signed) };
+
+        if (a.top) {
+            a = any(a.width, a.is_signed);
+        }
+        if (b.top) {
+            b = any(b.width, b.is_signed);
+        }
+        if (a.top || b.top) {
+            return range;
+        }
+
+        value_t lo, hi;
+        bool overflow { false };
+
+        switch (symb) {
+            case expr::PLUS:
+                overflow = __builtin_add_overflow(a.lo, b.lo, &lo) ||
+                           __builtin_add_overflow(a.hi, b.hi, &hi);
+                break;
+
+            case expr::SUB:
+                overflow = __builtin_sub_overflow(a.lo, b.hi, &lo) ||
+                           __builtin_sub_overflow(a.hi, b.lo, &hi);
+                break;
+
+            case expr::MUL: {
+                value_t products[4];
+                overflow = __builtin_mul_overflow(a.lo, b.lo, &products[0]) ||
+                           __builtin_mul_overflow(a.lo, b.hi, &products[1]) ||
+                           __builtin_mul_overflow(a.hi, b.lo, &products[2]) ||
+                           __builtin_mul_overflow(a.hi, b.hi, &products[3]);
+                if (!overflow) {
+                    lo = *std::min_element(products, products + 4);
+                    hi = *std::max_element(products, products + 4);
+                }
+                break;
+            }
+
+            /* divisors ranging over 0 take any value */
+            case expr::DIV: {
+                if (b.lo <= 0 && 0 <= b.hi) {
+                    return range;
+                }
+                if ((LONG_MIN == a.lo || LONG_MIN == a.hi) && (-1 == b.lo || -1 == b.hi)) {
+                    return range;
+                }
+
+                value_t quotients[4] { a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi };
+                lo = *std::min_element(quotients, quotients + 4);
+                hi = *std::max_element(quotients, quotients + 4);
+                break;
+            }
+
+            case expr::MOD:
+                if (a.lo < 0 || b.lo <= 0) {
+                    return range;
+                }
+
+                if (a.hi < b.lo) {
+                    lo = a.lo;
+                    hi = a.hi;
+                } else {
+                    lo = 0;
+                    hi = std::min(a.hi, b.hi - 1);
+                }
+                break;
+
+            default:
+                return range;
+        }
+
+        if (overflow) {
+            return range;
+        }
+
+        /* out of range results wrap around */
+        if (0 < width &&
+            (range.top ? lo < 0 : lo < range.lo || range.hi < hi)) {
+            return range;
+        }
+
+        Interval res { false, false, lo, hi, width, is_signed };
+        return res;
+    }
+
+    bool RangeAnalyzer::refine(expr::Expr_ptr ctx, expr::Expr_ptr cond, bool positive,
+                               Box& box, const Box& next_box)
+    {
+        if (f_em.is_true(cond)) {
+            return positive;
+        }
+        if (f_em.is_false(cond)) {
+            return !positive;
+        }
+
+        if (f_em.is_not(cond)) {
+            return refine(ctx, cond->lhs(), !positive, box, next_box);
+        }
+
+        if ((f_em.is_and(cond) && positive) || (f_em.is_or(cond) && !positive)) {
+            return refine(ctx, cond->lhs(), positive, box, next_box) &&
+                   refine(ctx, cond->rhs(), positive, box, next_box);
+        }
+
+        if (f_em.is_implies(cond) && !positive) {
+            return refine(ctx, cond->lhs(), true, box, next_box) &&
+                   refine(ctx, cond->rhs(), false, box, next_box);
+        }
+
+        /* disjunctions, each disjunct refines a box of its own */
+        if (f_em.is_and(cond) || f_em.is_or(cond) || f_em.is_implies(cond)) {
+            bool lhs_positive { f_em.is_implies(cond) ? false : positive };
+
+            Box lhs_box { box };
+            bool lhs_ok { refine(ctx, cond->lhs(), lhs_positive, lhs_box, next_box) };
+
+            Box rhs_box { box };
+            bool rhs_ok { refine(ctx, cond->rhs(), positive, rhs_box, next_box) };
+
+            if (!lhs_ok || !rhs_ok) {
+                if (lhs_ok) {
+                    box.swap(lhs_box);
+                }
+                if (rhs_ok) {
+                    box.swap(rhs_box);
+                }
+                return lhs_ok || rhs_ok;
+            }
+
+            for (auto& pair : box) {
+                pair.second = join(lhs_box[pair.first], rhs_box[pair.first]);
+            }
+            return true;
+        }
+
+        if (is_relational(cond->symb())) {
+            expr::ExprType symb { positive ? cond->symb() : negated(cond->symb()) };
+            return refine_atom(ctx, symb, cond->lhs(), cond->rhs(), box, next_box);
+        }
+
+        /* DEFINEs in guards */
+        if (f_em.is_identifier(cond)) {
+            expr::Expr_ptr full { f_em.make_dot(ctx, cond) };
+
+            symb::Symbol_ptr symb;
+            try {
+                symb::ResolverProxy resolver;
+                symb = resolver.symbol(full);
+            } catch (symb::UnresolvedSymbol& us) {
+                return true;
+            }
+
+            if (symb->is_define()) {
+                return refine(ctx, symb->as_define().body(), positive, box, next_box);
+            }
+        }
+
+        return true;
+    }
+
+    bool RangeAnalyzer::refine_atom(expr::Expr_ptr ctx, expr::ExprType symb,
+                                    expr::Expr_ptr lhs, expr::Expr_ptr rhs,
+                                    Box& box, const Box& next_box)
+    {
+        for (unsigned side = 0; side < 2; ++side) {
+            expr::Expr_ptr operand { 0 == side ? lhs : rhs };
+            expr::Expr_ptr other { 0 == side ? rhs : lhs };
+            expr::ExprType op { 0 == side ? symb : mirrored(symb) };
+
+            expr::Expr_ptr full;
+            if (!state_var(ctx, operand, full)) {
+                continue;
+            }
+
+            Interval bound { eval(ctx, other, box, next_box) };
+            if (bound.empty) {
+                return false;
+            }
+            if (bound.top) {
+                continue;
+            }
+
+            Interval& interval { box[full] };
+            Interval refined { interval };
+
+            /* unsigned vars of the widest type have no upper bound
+               here, only bounding it from above does anything */
+            if (refined.top) {
+                if (refined.is_signed || (expr::LT != op && expr::LE != op && expr::EQ != op)) {
+                    continue;
+                }
+
+                refined.top = false;
+                refined.lo = 0;
+                refined.hi = LONG_MAX;
+            }
+
+            switch (op) {
+                case expr::EQ:
+                    refined.lo = std::max(refined.lo, bound.lo);
+                    refined.hi = std::min(refined.hi, bound.hi);
+                    break;
+
+                /* only the ends can be excluded */
+                case expr::NE:
+                    if (bound.lo == bound.hi) {
+                        if (refined.lo == bound.lo) {
+                            if (refined.lo == refined.hi) {
+                                return false;
+                            }
+                            ++refined.lo;
+                        } else if (refined.hi == bound.lo) {
+                            --refined.hi;
+                        }
+                    }
+                    break;
+
+                case expr::LT:
+                    if (LONG_MIN == bound.hi) {
+                        return false;
+                    }
+                    refined.hi = std::min(refined.hi, bound.hi - 1);
+                    break;
+
+                case expr::LE:
+                    refined.hi = std::min(refined.hi, bound.hi);
+                    break;
+
+                case expr::GT:
+                    if (LONG_MAX == bound.lo) {
+                        return false;
+                    }
+                    refined.lo = std::max(refined.lo, bound.lo + 1);
+                    break;
+
+                case expr::GE:
+                    refined.lo = std::max(refined.lo, bound.lo);
+                    break;
+
+                default:
+                    assert(false);
+            }
+
+            if (refined.hi < refined.lo) {
+                return false;
+            }
+
+            interval = refined;
+        }
+
+        return true;
+    }
+
+    bool RangeAnalyzer::state_var(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                                  expr::Expr_ptr& full)
+    {
+        while (f_em.is_dot(expr)) {
+            ctx = f_em.make_dot(ctx, expr->lhs());
+            expr = expr->rhs();
+        }
+
+        if (!f_em.is_identifier(expr)) {
+            return false;
+        }
+
+        full = f_em.make_dot(ctx, expr);
+        return f_vars.end() != f_vars.find(full);
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::any(unsigned width, bool is_signed)
+    {
+        Interval res { false, true, 0, 0, width, is_signed };
+
+        if (0 == width) {
+            return res;
+        }
+
+        if (is_signed && width <= 64) {
+            res.top = false;
+            res.lo = 64 == width ? LONG_MIN : -(1L << (width - 1));
+            res.hi = 64 == width ? LONG_MAX : (1L << (width - 1)) - 1;
+        } else if (!is_signed && width < 64) {
+            res.top = false;
+            res.lo = 0;
+            res.hi = (1L << width) - 1;
+        }
+
+        return res;
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::join(const Interval& a, const Interval& b)
+    {
+        if (a.empty) {
+            return b;
+        }
+        if (b.empty) {
+            return a;
+        }
+
+        Interval res { 0 < a.width ? a : b };
+        if (a.top || b.top) {
+            res.top = true;
+            return res;
+        }
+
+        res.lo = std::min(a.lo, b.lo);
+        res.hi = std::max(a.hi, b.hi);
+        return res;
+    }
+
+    RangeAnalyzer::Interval RangeAnalyzer::meet(const Interval& a, const Interval& b)
+    {
+        if (a.empty) {
+            return a;
+        }
+        if (b.empty || a.top) {
+            return b;
+        }
+        if (b.top) {
+            return a;
+        }
+
+        Interval res { a };
+        res.lo = std::max(a.lo, b.lo);
+        res.hi = std::min(a.hi, b.hi);
+        res.empty = res.hi < res.lo;
+        return res;
+    }
+
+    bool RangeAnalyzer::same(const Interval& a, const Interval& b)
+    {
+        if (a.empty || b.empty) {
+            return a.empty == b.empty;
+        }
+        if (a.top || b.top) {
+            return a.top == b.top;
+        }
+
+        return a.lo == b.lo && a.hi == b.hi;
+    }
+
+} // namespace model
@@ -0,0 +1,189 @@
+/**
+ * @file ranges.hh
+ * @brief Model management subsystem, value range analysis
+ *
+ * This header file contains the declarations of the value range
+ * analysis pass. An interval is inferred for each algebraic state
+ * var, by abstract interpretation of INIT, INVAR and TRANS on boxes
+ * (i.e. an interval for each var): every value the var takes in a
+ * reachable state is in its interval. The intervals of the initial
+ * states are given by the INIT and INVAR atoms bounding a var against
+ * an expr (e.g. `x = 0`, `x < N`), those of the successors by the
+ * assignments of the var in TRANS (`next(x) = <expr>`, `x := <expr>`,
+ * guarded ones included if their guards are exhaustive, e.g. once
+ * framing conditions are in), evaluated on intervals. Guards and ITE
+ * conditions refine the intervals of the vars they bound. Fixpoints
+ * are reached by widening to the bounds given by INVARs (or types),
+ * then narrowed again.
+ *
+ * The analysis is conservative: vars whose successors are not bounded
+ * by an assignment, and exprs with no interval counterpart here
+ * (e.g. bitwise operators, arrays) take any value of their type, and
+ * arithmetics that could wrap around does so.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MODEL_RANGES_H
+#define MODEL_RANGES_H
+
+#include <vector>
+
+#include <common/common.hh>
+
+#include <enc/enc_mgr.hh>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <model/model.hh>
+
+#include <utils/pool.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace model {
+
+    struct ValueRange {
+        value_t lo;
+        value_t hi;
+    };
+
+    /* by fully qualified var name */
+    typedef boost::unordered_map<expr::Expr_ptr, ValueRange,
+                                 utils::PtrHash, utils::PtrEq>
+        ValueRanges;
+
+    class RangeAnalyzer {
+    public:
+        /* the whole pass takes place here */
+        RangeAnalyzer(Model& model);
+        ~RangeAnalyzer();
+
+        /* the vars bounded by the analysis, vars not in here can take
+           any value of their type */
+        inline const ValueRanges& ranges() const
+        {
+            return f_ranges;
+        }
+
+        /* the bits which are enough to encode the vars bounded by the
+           analysis, for those needing less than their type width */
+        void narrowed_widths(enc::VarWidths& res) const;
+
+    private:
+        /* width 0 is for int constants, top for any value of the
+           type (or any value at all, for constants) */
+        struct Interval {
+            bool empty;
+            bool top;
+            value_t lo;
+            value_t hi;
+            unsigned width;
+            bool is_signed;
+        };
+
+        typedef boost::unordered_map<expr::Expr_ptr, Interval,
+                                     utils::PtrHash, utils::PtrEq>
+            Box;
+
+        /* guard is NULL for plain assignments */
+        struct Update {
+            expr::Expr_ptr ctx;
+            expr::Expr_ptr guard;
+            expr::Expr_ptr rhs;
+        };
+        typedef std::vector<Update> Updates;
+
+        struct StateVar {
+            unsigned width;
+            bool is_signed;
+            bool frozen;
+            Updates updates;
+            bool bounded;
+        };
+
+        typedef boost::unordered_map<expr::Expr_ptr, StateVar,
+                                     utils::PtrHash, utils::PtrEq>
+            StateVars;
+
+        /* bodies, with their ctx */
+        typedef std::vector<std::pair<expr::Expr_ptr, expr::Expr_ptr>> Bodies;
+
+        void collect_scopes();
+
+        /* assignments in the conjuncts of body */
+        void collect_updates(expr::Expr_ptr ctx, expr::Expr_ptr body);
+
+        /* true iff one of the guards of var is the conjunction of the
+           negations of (some of) the others */
+        bool exhaustive(const Updates& updates);
+
+        /* the intervals of the successors of the states in box */
+        Box post(const Box& box);
+
+        /* value, as assigned to var */
+        static Interval assign(const StateVar& var, const Interval& value);
+
+        /* the interval of expr, in ctx. Current vars are looked up in
+           box, next ones in next_box */
+        Interval eval(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                      const Box& box, const Box& next_box, unsigned depth = 0);
+
+        Interval eval_arithmetic(expr::ExprType symb, Interval a, Interval b);
+
+        /* restricts box to the states satisfying cond (or its
+           negation), false if none does */
+        bool refine(expr::Expr_ptr ctx, expr::Expr_ptr cond, bool positive,
+                    Box& box, const Box& next_box);
+
+        bool refine_atom(expr::Expr_ptr ctx, expr::ExprType symb,
+                         expr::Expr_ptr lhs, expr::Expr_ptr rhs,
+                         Box& box, const Box& next_box);
+
+        /* the fully qualified name of expr, if it is a state var in
+           ctx (not under next) */
+        bool state_var(expr::Expr_ptr ctx, expr::Expr_ptr expr,
+                       expr::Expr_ptr& full);
+
+        /* the interval of any value of a type */
+        static Interval any(unsigned width, bool is_signed);
+
+        static Interval join(const Interval& a, const Interval& b);
+        static Interval meet(const Interval& a, const Interval& b);
+        static bool same(const Interval& a, const Interval& b);
+
+        Model& f_model;
+        expr::ExprMgr& f_em;
+
+        StateVars f_vars;
+
+        Bodies f_init;
+        Bodies f_invar;
+        Bodies f_trans;
+
+        /* the states satisfying INVARs */
+        Box f_invariant;
+
+        ValueRanges f_ranges;
+    };
+
+} // namespace model
+
+#endif /* MODEL_RANGES_H */
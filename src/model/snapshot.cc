@@ -0,0 +1,790 @@
+/**
+ * @file model/snapshot.cc
+ * @brief Model management subsystem, binary model snapshots
+ * implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <symb/classes.hh>
+
+#include <type/classes.hh>
+#include <type/type_mgr.hh>
+
+#include <model/model.hh>
+#include <model/model_mgr.hh>
+#include <model/module.hh>
+#include <model/snapshot.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/logging.hh>
+
+/* bump whenever the file format changes */
+static const char snapshot_magic[] = "yasmv-snapshot 1";
+
+/* written as it is, snapshots are not portable across byte orders */
+static const uint32_t snapshot_byte_order { 0x01020304 };
+
+namespace model {
+
+    typedef enum {
+        SNAPSHOT_BOOLEAN,
+        SNAPSHOT_CONSTANT,
+        SNAPSHOT_UNSIGNED,
+        SNAPSHOT_SIGNED,
+        SNAPSHOT_ENUM,
+        SNAPSHOT_INSTANCE,
+        SNAPSHOT_STRING,
+        SNAPSHOT_TIME,
+        SNAPSHOT_ARRAY,
+    } snapshot_type_t;
+
+    typedef enum {
+        SNAPSHOT_VAR,
+        SNAPSHOT_DEFINE,
+    } snapshot_decl_t;
+
+    /* variable flags */
+    static const uint8_t SNAPSHOT_HIDDEN { 1 << 0 };
+    static const uint8_t SNAPSHOT_INPUT { 1 << 1 };
+    static const uint8_t SNAPSHOT_INERTIAL { 1 << 2 };
+    static const uint8_t SNAPSHOT_FROZEN { 1 << 3 };
+    static const uint8_t SNAPSHOT_TEMP { 1 << 4 };
+
+    static inline bool is_leaf(expr::ExprType symb)
+    {
+        return expr::IDENT == symb || expr::QSTRING == symb ||
+               expr::ICONST == symb || expr::HCONST == symb ||
+               expr::OCONST == symb || expr::BCONST == symb ||
+               expr::INSTANT == symb || expr::UNDEF == symb;
+    }
+
+    /* exprs and types are numbered from 1 as they are written, 0
+       stands for NULL */
+    struct SnapshotWriter {
+        template <typename T>
+        static void put(std::string& buf, T value)
+        {
+            buf.append((const char*) &value, sizeof(value));
+        }
+
+        /* post-order, children come first */
+        uint32_t expr(expr::Expr_ptr root)
+        {
+            if (!root) {
+                return 0;
+            }
+
+            std::vector<std::pair<expr::Expr_ptr, bool>> stack;
+            stack.push_back(std::make_pair(root, false));
+
+            while (!stack.empty()) {
+                expr::Expr_ptr e { stack.back().first };
+                bool expanded { stack.back().second };
+                stack.pop_back();
+
+                if (f_expr_ids.end() != f_expr_ids.find(e)) {
+                    continue;
+                }
+
+                expr::ExprType symb { e->symb() };
+                if (!expanded && !is_leaf(symb)) {
+                    stack.push_back(std::make_pair(e, true));
+                    if (e->rhs()) {
+                        stack.push_back(std::make_pair(e->rhs(), false));
+                    }
+                    if (e->lhs()) {
+                        stack.push_back(std::make_pair(e->lhs(), false));
+                    }
+                    continue;
+                }
+
+                put<uint8_t>(f_exprs, symb);
+                if (expr::IDENT == symb || expr::QSTRING == symb) {
+                    const expr::Atom& atom { e->atom() };
+                    put<uint32_t>(f_exprs, atom.size());
+                    f_exprs.append(atom);
+                } else if (expr::UNDEF == symb) {
+                    /* nothing more */
+                } else if (is_leaf(symb)) {
+                    put<int64_t>(f_exprs, e->value());
+                } else {
+                    put<uint32_t>(f_exprs, e->lhs() ? f_expr_ids.at(e->lhs()) : 0);
+                    put<uint32_t>(f_exprs, e->rhs() ? f_expr_ids.at(e->rhs()) : 0);
+                }
+
+                f_expr_ids[e] = ++f_n_exprs;
+            }
+
+            return f_expr_ids.at(root);
+        }
+
+        /* 0 if tp can not be stored (i.e. temp encodings) */
+        uint32_t type(type::Type_ptr tp)
+        {
+            boost::unordered_map<type::Type_ptr, uint32_t>::const_iterator i {
+                f_type_ids.find(tp)
+            };
+            if (f_type_ids.end() != i) {
+                return i->second;
+            }
+
+            std::string rec;
+            if (tp->is_boolean()) {
+                put<uint8_t>(rec, SNAPSHOT_BOOLEAN);
+            } else if (tp->is_constant()) {
+                put<uint8_t>(rec, SNAPSHOT_CONSTANT);
+                put<uint32_t>(rec, tp->width());
+            } else if (tp->is_unsigned_algebraic()) {
+                if (tp->as_unsigned_algebraic()->dds()) {
+                    return 0;
+                }
+                put<uint8_t>(rec, SNAPSHOT_UNSIGNED);
+                put<uint32_t>(rec, tp->width());
+            } else if (tp->is_signed_algebraic()) {
+                if (tp->as_signed_algebraic()->dds()) {
+                    return 0;
+                }
+                put<uint8_t>(rec, SNAPSHOT_SIGNED);
+                put<uint32_t>(rec, tp->width());
+            } else if (tp->is_enum()) {
+                const expr::ExprSet& literals { tp->as_enum()->literals() };
+                put<uint8_t>(rec, SNAPSHOT_ENUM);
+                put<uint32_t>(rec, literals.size());
+                for (expr::ExprSet::const_iterator li = literals.begin();
+                     li != literals.end(); ++li) {
+                    put<uint32_t>(rec, expr(*li));
+                }
+            } else if (tp->is_instance()) {
+                type::InstanceType_ptr instance { tp->as_instance() };
+                put<uint8_t>(rec, SNAPSHOT_INSTANCE);
+                put<uint32_t>(rec, expr(instance->name()));
+                put<uint32_t>(rec, expr(instance->params()));
+            } else if (tp->is_string()) {
+                put<uint8_t>(rec, SNAPSHOT_STRING);
+            } else if (tp->is_time()) {
+                put<uint8_t>(rec, SNAPSHOT_TIME);
+            } else if (tp->is_array()) {
+                type::ArrayType_ptr array { tp->as_array() };
+                uint32_t of { type(array->of()) };
+                if (!of) {
+                    return 0;
+                }
+                put<uint8_t>(rec, SNAPSHOT_ARRAY);
+                put<uint32_t>(rec, of);
+                put<uint32_t>(rec, array->nelems());
+            } else {
+                return 0;
+            }
+
+            f_types.append(rec);
+            f_type_ids[tp] = ++f_n_types;
+
+            return f_n_types;
+        }
+
+        /* types of symbols are always known */
+        uint32_t symbol_type(type::Type_ptr tp)
+        {
+            uint32_t res { type(tp) };
+            if (!res) {
+                throw std::runtime_error("unsupported symbol type");
+            }
+
+            return res;
+        }
+
+        void exprs(const expr::ExprVector& ev)
+        {
+            put<uint32_t>(f_body, ev.size());
+            for (expr::ExprVector::const_iterator i = ev.begin(); i != ev.end(); ++i) {
+                put<uint32_t>(f_body, expr(*i));
+            }
+        }
+
+        void module(Model& model, Module& module)
+        {
+            expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+            expr::Expr_ptr name { module.name() };
+
+            put<uint32_t>(f_body, expr(name));
+
+            const symb::Parameters& params { module.parameters() };
+            put<uint32_t>(f_body, params.size());
+            for (symb::Parameters::const_iterator pi = params.begin();
+                 pi != params.end(); ++pi) {
+                put<uint32_t>(f_body, expr(pi->first));
+                put<uint32_t>(f_body, symbol_type(pi->second->type()));
+            }
+
+            /* vars and defines, in declaration order */
+            std::vector<std::pair<unsigned, symb::Symbol_ptr>> decls;
+            const symb::Variables& vars { module.vars() };
+            for (symb::Variables::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+                unsigned index { model.symbol_index(em.make_dot(em.make_empty(), vi->first)) };
+                decls.push_back(std::make_pair(index, vi->second));
+            }
+            const symb::Defines& defs { module.defs() };
+            for (symb::Defines::const_iterator di = defs.begin(); di != defs.end(); ++di) {
+                unsigned index { model.symbol_index(em.make_dot(em.make_empty(), di->first)) };
+                decls.push_back(std::make_pair(index, di->second));
+            }
+            std::stable_sort(decls.begin(), decls.end(),
+                             [](const std::pair<unsigned, symb::Symbol_ptr>& a,
+                                const std::pair<unsigned, symb::Symbol_ptr>& b) {
+                                 return a.first < b.first;
+                             });
+
+            /* INVARs of enum vars are added back along with the vars */
+            expr::ExprVector implied;
+
+            put<uint32_t>(f_body, decls.size());
+            for (std::vector<std::pair<unsigned, symb::Symbol_ptr>>::const_iterator di = decls.begin();
+                 di != decls.end(); ++di) {
+                symb::Symbol_ptr symb { di->second };
+
+                if (symb->is_variable()) {
+                    const symb::Variable& var { symb->as_variable() };
+                    uint8_t flags {
+                        (uint8_t) ((var.is_hidden() ? SNAPSHOT_HIDDEN : 0) |
+                                   (var.is_input() ? SNAPSHOT_INPUT : 0) |
+                                   (var.is_inertial() ? SNAPSHOT_INERTIAL : 0) |
+                                   (var.is_frozen() ? SNAPSHOT_FROZEN : 0) |
+                                   (var.is_temp() ? SNAPSHOT_TEMP : 0))
+                    };
+
+                    put<uint8_t>(f_body, SNAPSHOT_VAR);
+                    put<uint32_t>(f_body, expr(var.name()));
+                    put<uint32_t>(f_body, symbol_type(var.type()));
+                    put<uint8_t>(f_body, flags);
+                    put<uint8_t>(f_body, var.format());
+
+                    if (var.type()->is_enum()) {
+                        implied.push_back(em.make_eq(var.name(), var.type()->repr()));
+                    }
+                } else {
+                    const symb::Define& def { symb->as_define() };
+
+                    put<uint8_t>(f_body, SNAPSHOT_DEFINE);
+                    put<uint32_t>(f_body, expr(def.name()));
+                    put<uint32_t>(f_body, expr(def.body()));
+                    put<uint8_t>(f_body, def.is_hidden() ? 1 : 0);
+                    put<uint8_t>(f_body, def.format());
+                }
+            }
+
+            exprs(module.init());
+
+            expr::ExprVector invar;
+            const expr::ExprVector& all { module.invar() };
+            for (expr::ExprVector::const_iterator ii = all.begin(); ii != all.end(); ++ii) {
+                expr::ExprVector::iterator j {
+                    std::find(implied.begin(), implied.end(), *ii)
+                };
+
+                if (implied.end() != j) {
+                    implied.erase(j);
+                } else {
+                    invar.push_back(*ii);
+                }
+            }
+            exprs(invar);
+
+            /* framing conditions included */
+            exprs(module.trans());
+        }
+
+        boost::unordered_map<expr::Expr_ptr, uint32_t> f_expr_ids;
+        uint32_t f_n_exprs { 0 };
+        std::string f_exprs;
+
+        boost::unordered_map<type::Type_ptr, uint32_t> f_type_ids;
+        uint32_t f_n_types { 0 };
+        std::string f_types;
+
+        std::string f_body;
+    };
+
+    /* reads a snapshot mapped in memory, all reads are bounds
+       checked */
+    struct SnapshotReader {
+        SnapshotReader(const char* data, size_t size)
+            : f_p(data)
+            , f_end(data + size)
+        {
+            f_exprs.push_back(NULL);
+            f_types.push_back(NULL);
+        }
+
+        template <typename T>
+        T get()
+        {
+            T res;
+            if ((size_t) (f_end - f_p) < sizeof(res)) {
+                throw std::runtime_error("truncated snapshot");
+            }
+
+            memcpy(&res, f_p, sizeof(res));
+            f_p += sizeof(res);
+
+            return res;
+        }
+
+        const char* bytes(size_t n)
+        {
+            if ((size_t) (f_end - f_p) < n) {
+                throw std::runtime_error("truncated snapshot");
+            }
+
+            const char* res { f_p };
+            f_p += n;
+
+            return res;
+        }
+
+        expr::Expr_ptr expr()
+        {
+            uint32_t id { get<uint32_t>() };
+            if (f_exprs.size() <= id) {
+                throw std::runtime_error("corrupted snapshot");
+            }
+
+            return f_exprs[id];
+        }
+
+        type::Type_ptr type()
+        {
+            uint32_t id { get<uint32_t>() };
+            if (f_types.size() <= id) {
+                throw std::runtime_error("corrupted snapshot");
+            }
+
+            return f_types[id];
+        }
+
+        /* types of symbols are always known */
+        type::Type_ptr symbol_type()
+        {
+            type::Type_ptr res { type() };
+            if (!res) {
+                throw std::runtime_error("corrupted snapshot");
+            }
+
+            return res;
+        }
+
+        void read_exprs()
+        {
+            expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+            uint32_t n { get<uint32_t>() };
+            f_exprs.reserve(1 + n);
+
+            for (uint32_t i = 0; i < n; ++i) {
+                expr::ExprType symb { (expr::ExprType) get<uint8_t>() };
+                if (expr::UNDEF < symb) {
+                    throw std::runtime_error("corrupted snapshot");
+                }
+
+                expr::Expr_ptr e { NULL };
+                if (expr::IDENT == symb || expr::QSTRING == symb) {
+                    uint32_t len { get<uint32_t>() };
+                    expr::Atom atom(bytes(len), len);
+
+                    e = expr::IDENT == symb
+                            ? em.make_identifier(atom)
+                            : em.make_qstring(atom);
+                } else if (expr::UNDEF == symb) {
+                    e = em.make_undef();
+                } else if (is_leaf(symb)) {
+                    e = em.make_stored(symb, (value_t) get<int64_t>());
+                } else {
+                    expr::Expr_ptr lhs { expr() };
+                    expr::Expr_ptr rhs { expr() };
+
+                    e = em.make_stored(symb, lhs, rhs);
+                }
+
+                f_exprs.push_back(e);
+            }
+        }
+
+        void read_types()
+        {
+            type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+            uint32_t n { get<uint32_t>() };
+            f_types.reserve(1 + n);
+
+            for (uint32_t i = 0; i < n; ++i) {
+                type::Type_ptr tp { NULL };
+
+                switch (get<uint8_t>()) {
+                case SNAPSHOT_BOOLEAN:
+                    tp = tm.find_boolean();
+                    break;
+
+                case SNAPSHOT_CONSTANT:
+                    tp = tm.find_constant(get<uint32_t>());
+                    break;
+
+                case SNAPSHOT_UNSIGNED:
+                    tp = tm.find_unsigned(get<uint32_t>());
+                    break;
+
+                case SNAPSHOT_SIGNED:
+                    tp = tm.find_signed(get<uint32_t>());
+                    break;
+
+                case SNAPSHOT_ENUM: {
+                    expr::ExprSet literals;
+                    uint32_t n_literals { get<uint32_t>() };
+                    for (uint32_t j = 0; j < n_literals; ++j) {
+                        literals.insert(expr());
+                    }
+
+                    tp = tm.find_enum(literals);
+                    break;
+                }
+
+                case SNAPSHOT_INSTANCE: {
+                    expr::Expr_ptr name { expr() };
+                    expr::Expr_ptr params { expr() };
+
+                    tp = tm.find_instance(name, params);
+                    break;
+                }
+
+                case SNAPSHOT_STRING:
+                    tp = tm.find_string();
+                    break;
+
+                case SNAPSHOT_TIME:
+                    tp = tm.find_time();
+                    break;
+
+                case SNAPSHOT_ARRAY: {
+                    type::Type_ptr of { symbol_type() };
+                    uint32_t nelems { get<uint32_t>() };
+                    if (!of->is_scalar()) {
+                        throw std::runtime_error("corrupted snapshot");
+                    }
+
+                    tp = tm.find_array_type(of->as_scalar(), nelems);
+                    break;
+                }
+
+                default:
+                    throw std::runtime_error("corrupted snapshot");
+                }
+
+                f_types.push_back(tp);
+            }
+        }
+
+        void read_exprs(expr::ExprVector& res)
+        {
+            uint32_t n { get<uint32_t>() };
+            for (uint32_t i = 0; i < n; ++i) {
+                res.push_back(expr());
+            }
+        }
+
+        void read_module(Model& model)
+        {
+            expr::Expr_ptr name { expr() };
+
+            Module_ptr module { new Module(name) };
+            model.add_module(*module);
+
+            uint32_t n_params { get<uint32_t>() };
+            for (uint32_t i = 0; i < n_params; ++i) {
+                expr::Expr_ptr pid { expr() };
+                type::Type_ptr tp { symbol_type() };
+
+                module->add_parameter(pid, new symb::Parameter(name, pid, tp));
+            }
+
+            uint32_t n_decls { get<uint32_t>() };
+            for (uint32_t i = 0; i < n_decls; ++i) {
+                uint8_t kind { get<uint8_t>() };
+
+                if (SNAPSHOT_VAR == kind) {
+                    expr::Expr_ptr vid { expr() };
+                    type::Type_ptr tp { symbol_type() };
+                    uint8_t flags { get<uint8_t>() };
+                    value_format_t format { (value_format_t) get<uint8_t>() };
+
+                    symb::Variable_ptr var { new symb::Variable(name, vid, tp) };
+                    var->set_hidden(0 != (flags & SNAPSHOT_HIDDEN));
+                    var->set_input(0 != (flags & SNAPSHOT_INPUT));
+                    var->set_inertial(0 != (flags & SNAPSHOT_INERTIAL));
+                    var->set_frozen(0 != (flags & SNAPSHOT_FROZEN));
+                    var->set_temp(0 != (flags & SNAPSHOT_TEMP));
+                    var->set_format(format);
+
+                    module->add_var(vid, var);
+                } else if (SNAPSHOT_DEFINE == kind) {
+                    expr::Expr_ptr id { expr() };
+                    expr::Expr_ptr body { expr() };
+                    bool hidden { 0 != get<uint8_t>() };
+                    value_format_t format { (value_format_t) get<uint8_t>() };
+
+                    symb::Define_ptr def { new symb::Define(name, id, body) };
+                    def->set_hidden(hidden);
+                    def->set_format(format);
+
+                    module->add_def(id, def);
+                } else {
+                    throw std::runtime_error("corrupted snapshot");
+                }
+            }
+
+            expr::ExprVector init;
+            read_exprs(init);
+            for (expr::ExprVector::const_iterator i = init.begin(); i != init.end(); ++i) {
+                module->add_init(*i);
+            }
+
+            expr::ExprVector invar;
+            read_exprs(invar);
+            for (expr::ExprVector::const_iterator i = invar.begin(); i != invar.end(); ++i) {
+                module->add_invar(*i);
+            }
+
+            expr::ExprVector trans;
+            read_exprs(trans);
+            for (expr::ExprVector::const_iterator i = trans.begin(); i != trans.end(); ++i) {
+                module->add_trans(*i);
+            }
+        }
+
+        const char* f_p;
+        const char* f_end;
+
+        expr::ExprVector f_exprs;
+        std::vector<type::Type_ptr> f_types;
+    };
+
+    bool Snapshot::save(const std::string& path)
+    {
+        ModelMgr& mm { ModelMgr::INSTANCE() };
+        Model& model { mm.model() };
+        const Modules& modules { model.modules() };
+
+        /* written aside, then renamed: readers never see partial
+           snapshots */
+        std::ostringstream tmpname;
+        tmpname
+            << path
+            << "."
+            << getpid();
+        boost::filesystem::path tmppath { tmpname.str() };
+
+        try {
+            SnapshotWriter writer;
+            std::string& body { writer.f_body };
+
+            SnapshotWriter::put<uint32_t>(body, opts::OptsMgr::INSTANCE().word_width());
+
+            /* main module first */
+            Module& main { model.main_module() };
+            SnapshotWriter::put<uint32_t>(body, modules.size());
+            writer.module(model, main);
+            for (Modules::const_iterator mi = modules.begin(); mi != modules.end(); ++mi) {
+                if (mi->second != &main) {
+                    writer.module(model, *mi->second);
+                }
+            }
+
+            /* types that can not be stored are inferred again */
+            std::string types;
+            uint32_t n_types { 0 };
+            mm.type_cache().for_each([&](expr::Expr_ptr key, type::Type_ptr tp) {
+                uint32_t id { writer.type(tp) };
+
+                if (id) {
+                    SnapshotWriter::put<uint32_t>(types, writer.expr(key));
+                    SnapshotWriter::put<uint32_t>(types, id);
+                    ++n_types;
+                }
+            });
+            SnapshotWriter::put<uint32_t>(body, n_types);
+            body.append(types);
+
+            {
+                std::ofstream os { tmppath.c_str(), std::ofstream::binary };
+
+                os.write(snapshot_magic, sizeof(snapshot_magic));
+                os.write((const char*) &snapshot_byte_order, sizeof(snapshot_byte_order));
+
+                os.write((const char*) &writer.f_n_exprs, sizeof(writer.f_n_exprs));
+                os << writer.f_exprs;
+
+                os.write((const char*) &writer.f_n_types, sizeof(writer.f_n_types));
+                os << writer.f_types;
+
+                os << body;
+
+                if (!os) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+
+            rename(tmppath, boost::filesystem::path { path });
+
+            unsigned n_exprs { writer.f_n_exprs };
+            unsigned n_modules { (unsigned) modules.size() };
+            DEBUG
+                << "Wrote snapshot `"
+                << path
+                << "`, "
+                << n_modules
+                << " modules, "
+                << n_exprs
+                << " exprs"
+                << std::endl;
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not write snapshot: "
+                << what
+                << std::endl;
+
+            boost::system::error_code ec;
+            remove(tmppath, ec);
+
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Snapshot::load(const std::string& path)
+    {
+        ModelMgr& mm { ModelMgr::INSTANCE() };
+
+        int fd { open(path.c_str(), O_RDONLY) };
+        if (-1 == fd) {
+            WARN
+                << "Could not open snapshot `"
+                << path
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+
+        struct stat st;
+        void* data { MAP_FAILED };
+        if (0 == fstat(fd, &st) && 0 < st.st_size) {
+            data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+
+        if (MAP_FAILED == data) {
+            WARN
+                << "Could not map snapshot `"
+                << path
+                << "`"
+                << std::endl;
+
+            return false;
+        }
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+        bool res { true };
+        try {
+            SnapshotReader reader { (const char*) data, (size_t) st.st_size };
+
+            if (memcmp(reader.bytes(sizeof(snapshot_magic)), snapshot_magic,
+                       sizeof(snapshot_magic)) ||
+                snapshot_byte_order != reader.get<uint32_t>()) {
+                throw std::runtime_error("not a snapshot, or written by another build");
+            }
+
+            reader.read_exprs();
+            reader.read_types();
+
+            /* types of constants depend on the word width */
+            mm.reset();
+            opts::OptsMgr::INSTANCE().set_word_width(reader.get<uint32_t>());
+
+            uint32_t n_modules { reader.get<uint32_t>() };
+            for (uint32_t i = 0; i < n_modules; ++i) {
+                reader.read_module(mm.model());
+            }
+
+            std::vector<std::pair<expr::Expr_ptr, type::Type_ptr>> types;
+            uint32_t n_types { reader.get<uint32_t>() };
+            for (uint32_t i = 0; i < n_types; ++i) {
+                expr::Expr_ptr key { reader.expr() };
+                type::Type_ptr tp { reader.symbol_type() };
+
+                types.push_back(std::make_pair(key, tp));
+            }
+
+            mm.trust(types);
+
+            unsigned n { n_modules };
+            DEBUG
+                << "Read snapshot `"
+                << path
+                << "`, "
+                << n
+                << " modules"
+                << std::endl;
+        } catch (const std::exception& e) {
+            pconst_char what { e.what() };
+            WARN
+                << "Could not read snapshot `"
+                << path
+                << "`: "
+                << what
+                << std::endl;
+
+            res = false;
+        }
+
+        munmap(data, st.st_size);
+        return res;
+    }
+
+} // namespace model
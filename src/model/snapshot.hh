@@ -0,0 +1,56 @@
+/**
+ * @file snapshot.hh
+ * @brief Model management subsystem, binary model snapshots
+ *
+ * This header file contains the declarations required to save the
+ * analyzed model to a binary snapshot, and to read it back with no
+ * parsing involved. A snapshot holds the pooled exprs the model is
+ * made of (children first), the types of its symbols and of the
+ * bodies checked so far, the modules and the word width. Loading a
+ * snapshot builds the model as the parser would, then the modules
+ * are trusted: the analysis that follows does not type check them.
+ *
+ * Snapshots are only meant to be read by the same build that wrote
+ * them, on the same machine (i.e. native byte order).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MODEL_SNAPSHOT_H
+#define MODEL_SNAPSHOT_H
+
+#include <string>
+
+namespace model {
+
+    class Snapshot {
+    public:
+        /* writes the current (analyzed) model to path, false on I/O
+           errors */
+        static bool save(const std::string& path);
+
+        /* replaces the current model with the one in the snapshot at
+           path, which still needs to be analyzed. False if the file
+           can not be read, or was not written by this build */
+        static bool load(const std::string& path);
+    };
+
+} // namespace model
+
+#endif /* MODEL_SNAPSHOT_H */
@@ -0,0 +1,419 @@
+/**
+ * @file symmetry.cc
+ * @brief Model management subsystem, symmetry detection
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <functional>
+#include <stack>
+
+#include <expr/expr_mgr.hh>
+
+#include <model/module.hh>
+#include <model/symmetry.hh>
+
+#include <symb/classes.hh>
+
+#include <type/classes.hh>
+
+#include <utils/logging.hh>
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+namespace model {
+
+    typedef boost::unordered_map<expr::Expr_ptr, expr::Expr_ptr,
+                                 utils::PtrHash, utils::PtrEq>
+        RewriteMap;
+
+    typedef boost::unordered_set<expr::Expr_ptr, utils::PtrHash, utils::PtrEq>
+        PooledExprSet;
+
+    static inline bool is_leaf(const expr::Expr_ptr expr)
+    {
+        switch (expr->symb()) {
+            case expr::IDENT:
+            case expr::QSTRING:
+            case expr::ICONST:
+            case expr::HCONST:
+            case expr::OCONST:
+            case expr::BCONST:
+            case expr::INSTANT:
+            case expr::UNDEF:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    /* commutative and associative */
+    static inline bool is_ac(expr::ExprType symb)
+    {
+        switch (symb) {
+            case expr::PLUS:
+            case expr::MUL:
+            case expr::BW_AND:
+            case expr::BW_OR:
+            case expr::BW_XOR:
+            case expr::BW_XNOR:
+            case expr::AND:
+            case expr::OR:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    static inline bool by_id(const expr::Expr_ptr x, const expr::Expr_ptr y)
+    {
+        return x->id() < y->id();
+    }
+
+    SymmetryDetector::SymmetryDetector(Model& model)
+        : f_model(model)
+        , f_em(expr::ExprMgr::INSTANCE())
+    {
+        Scopes scopes;
+        collect_scopes(scopes);
+
+        for (const auto& scope : scopes) {
+            SymmetryClasses candidates;
+            collect_candidates(scope, candidates);
+
+            for (const auto& sc : candidates) {
+                bool ok { true };
+                for (unsigned i = 1; ok && i < sc.size(); ++i) {
+                    ok = exchangeable(sc, i, scopes);
+                }
+
+                if (ok) {
+                    f_classes.push_back(sc);
+                }
+            }
+        }
+
+        unsigned n_classes { (unsigned) f_classes.size() };
+        DEBUG
+            << n_classes
+            << " symmetry classes found"
+            << std::endl;
+    }
+
+    SymmetryDetector::~SymmetryDetector()
+    {}
+
+    void SymmetryDetector::collect_scopes(Scopes& res)
+    {
+        std::stack<Scope> stack;
+
+        Scope main { expr::ExprVector(), f_em.make_empty(), &f_model.main_module() };
+        stack.push(main);
+
+        while (0 < stack.size()) {
+            const Scope top { stack.top() };
+            stack.pop();
+
+            res.push_back(top);
+
+            const symb::Variables& vars { top.module->vars() };
+            for (const auto& pair : vars) {
+                type::Type_ptr vtype { pair.second->type() };
+                if (!vtype->is_instance()) {
+                    continue;
+                }
+
+                type::InstanceType_ptr instance { vtype->as_instance() };
+
+                Scope inner { top.path, f_em.make_dot(top.ctx, pair.first),
+                              &f_model.module(instance->name()) };
+                inner.path.push_back(pair.first);
+
+                stack.push(inner);
+            }
+        }
+    }
+
+    void SymmetryDetector::collect_candidates(const Scope& scope, SymmetryClasses& res)
+    {
+        /* instances of parameterless modules, by module */
+        boost::unordered_map<expr::Expr_ptr, expr::ExprVector,
+                             utils::PtrHash, utils::PtrEq>
+            instances;
+
+        const symb::Variables& vars { scope.module->vars() };
+        for (const auto& pair : vars) {
+            type::Type_ptr vtype { pair.second->type() };
+
+            if (vtype->is_instance()) {
+                expr::Expr_ptr name { vtype->as_instance()->name() };
+                if (f_model.module(name).parameters().empty()) {
+                    instances[name].push_back(pair.first);
+                }
+            }
+
+            else if (vtype->is_array()) {
+                unsigned nelems { vtype->as_array()->nelems() };
+                if (2 <= nelems) {
+                    SymmetryClass sc { scope.path, scope.ctx, expr::ExprVector(),
+                                       pair.first, nelems };
+                    res.push_back(sc);
+                }
+            }
+        }
+
+        for (auto& pair : instances) {
+            expr::ExprVector& names { pair.second };
+            if (names.size() < 2) {
+                continue;
+            }
+
+            std::sort(names.begin(), names.end(), by_id);
+
+            SymmetryClass sc { scope.path, scope.ctx, names, NULL, 0 };
+            res.push_back(sc);
+        }
+    }
+
+    bool SymmetryDetector::exchangeable(const SymmetryClass& sc, unsigned i,
+                                        const Scopes& scopes)
+    {
+        for (const auto& scope : scopes) {
+            /* scopes above sc's, sc's included */
+            unsigned depth { (unsigned) scope.path.size() };
+            if (sc.path.size() < depth ||
+                !std::equal(scope.path.begin(), scope.path.end(), sc.path.begin())) {
+                continue;
+            }
+
+            /* the exchange only maps FSM formulas among themselves */
+            auto equivalent = [this, &sc, i, depth](const expr::ExprVector& bodies) {
+                PooledExprSet canonicals;
+                for (auto body : bodies) {
+                    canonicals.insert(canonical(body));
+                }
+
+                for (auto body : bodies) {
+                    expr::Expr_ptr exchanged { exchange(sc, i, depth, body) };
+                    if (NULL == exchanged || 0 == canonicals.count(canonical(exchanged))) {
+                        return false;
+                    }
+                }
+
+                return true;
+            };
+
+            Module& module { *scope.module };
+            if (!equivalent(module.init()) ||
+                !equivalent(module.invar()) ||
+                !equivalent(module.trans())) {
+                return false;
+            }
+
+            /* whereas DEFINEs and actual parameters are left alone */
+            expr::ExprVector bodies;
+            for (const auto& pair : module.defs()) {
+                bodies.push_back(pair.second->body());
+            }
+            for (const auto& pair : module.vars()) {
+                type::Type_ptr vtype { pair.second->type() };
+                if (vtype->is_instance()) {
+                    expr::Expr_ptr params { vtype->as_instance()->params() };
+                    if (NULL != params) {
+                        bodies.push_back(params);
+                    }
+                }
+            }
+
+            for (auto body : bodies) {
+                expr::Expr_ptr exchanged { exchange(sc, i, depth, body) };
+                if (NULL == exchanged || canonical(exchanged) != canonical(body)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SymmetryDetector::invariant(const SymmetryClass& sc, expr::Expr_ptr expr)
+    {
+        for (unsigned i = 1; i < sc.size(); ++i) {
+            expr::Expr_ptr exchanged { exchange(sc, i, 0, expr) };
+            if (NULL == exchanged || canonical(exchanged) != canonical(expr)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    expr::Expr_ptr SymmetryDetector::exchange(const SymmetryClass& sc, unsigned i,
+                                              unsigned depth, expr::Expr_ptr expr)
+    {
+        /* the members, as seen from the scope at depth */
+        expr::Expr_ptr prefix { NULL };
+        for (unsigned k = depth; k < sc.path.size(); ++k) {
+            prefix = NULL != prefix ? f_em.make_dot(prefix, sc.path[k]) : sc.path[k];
+        }
+        auto relative = [this, prefix](expr::Expr_ptr name) {
+            return NULL != prefix ? f_em.make_dot(prefix, name) : name;
+        };
+
+        expr::Expr_ptr a { NULL };
+        expr::Expr_ptr b { NULL };
+        expr::Expr_ptr array { NULL };
+        if (NULL != sc.array) {
+            array = relative(sc.array);
+        } else {
+            a = relative(sc.instances[0]);
+            b = relative(sc.instances[i]);
+        }
+
+        bool failed { false };
+        RewriteMap memo;
+
+        std::function<expr::Expr_ptr(expr::Expr_ptr)> walk =
+            [&](expr::Expr_ptr expr) -> expr::Expr_ptr {
+            if (failed) {
+                return expr;
+            }
+
+            if (expr == a) {
+                return b;
+            }
+            if (expr == b) {
+                return a;
+            }
+
+            /* array elements are only exchanged by constant subscripts */
+            if (expr == array) {
+                failed = true;
+                return expr;
+            }
+
+            if (is_leaf(expr)) {
+                return expr;
+            }
+
+            RewriteMap::const_iterator eye { memo.find(expr) };
+            if (memo.end() != eye) {
+                return eye->second;
+            }
+
+            expr::Expr_ptr res { expr };
+            if (f_em.is_subscript(expr) && NULL != array) {
+                expr::Expr_ptr base { expr->lhs() };
+                while (f_em.is_next(base)) {
+                    base = base->lhs();
+                }
+
+                if (base == array) {
+                    expr::Expr_ptr index { expr->rhs() };
+                    if (!f_em.is_int_const(index)) {
+                        failed = true;
+                        return expr;
+                    }
+
+                    value_t value { index->value() };
+                    if (0 == value) {
+                        res = f_em.make_subscript(expr->lhs(), f_em.make_const(i));
+                    } else if ((value_t) i == value) {
+                        res = f_em.make_subscript(expr->lhs(), f_em.make_const(0));
+                    }
+
+                    memo[expr] = res;
+                    return res;
+                }
+            }
+
+            if (f_em.is_dot(expr)) {
+                /* field names are not rewritten */
+                res = f_em.make_like(expr, walk(expr->lhs()), expr->rhs());
+            } else {
+                expr::Expr_ptr rhs { expr->rhs() };
+                res = f_em.make_like(expr, walk(expr->lhs()), NULL != rhs ? walk(rhs) : NULL);
+            }
+
+            memo[expr] = res;
+            return res;
+        };
+
+        expr::Expr_ptr res { walk(expr) };
+        return failed ? NULL : res;
+    }
+
+    expr::Expr_ptr SymmetryDetector::canonical(expr::Expr_ptr expr)
+    {
+        if (is_leaf(expr) || f_em.is_dot(expr)) {
+            return expr;
+        }
+
+        RewriteMap::const_iterator eye { f_canonicals.find(expr) };
+        if (f_canonicals.end() != eye) {
+            return eye->second;
+        }
+
+        expr::Expr_ptr res { NULL };
+
+        expr::ExprType symb { expr->symb() };
+        if (is_ac(symb)) {
+            /* operands of the whole chain */
+            expr::ExprVector operands;
+
+            std::stack<expr::Expr_ptr> stack;
+            stack.push(expr);
+            while (0 < stack.size()) {
+                expr::Expr_ptr top { stack.top() };
+                stack.pop();
+
+                if (top->symb() == symb) {
+                    stack.push(top->rhs());
+                    stack.push(top->lhs());
+                } else {
+                    operands.push_back(canonical(top));
+                }
+            }
+
+            std::sort(operands.begin(), operands.end(), by_id);
+
+            res = operands[0];
+            for (unsigned k = 1; k < operands.size(); ++k) {
+                res = f_em.make_like(expr, res, operands[k]);
+            }
+        } else {
+            expr::Expr_ptr lhs { canonical(expr->lhs()) };
+            expr::Expr_ptr rhs { NULL != expr->rhs() ? canonical(expr->rhs()) : NULL };
+
+            if ((expr::EQ == symb || expr::NE == symb) && rhs->id() < lhs->id()) {
+                std::swap(lhs, rhs);
+            }
+
+            res = f_em.make_like(expr, lhs, rhs);
+        }
+
+        f_canonicals[expr] = res;
+        return res;
+    }
+
+} // namespace model
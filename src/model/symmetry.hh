@@ -0,0 +1,129 @@
+/**
+ * @file symmetry.hh
+ * @brief Model management subsystem, symmetry detection
+ *
+ * This header file contains the declarations of the symmetry
+ * detection pass. A symmetry class is a set of interchangeable
+ * members: either the instances of the same (parameterless) module
+ * declared by a module, or the elements of an array var. Members are
+ * interchangeable if all of the transpositions of the first member
+ * and any other one leave the model invariant, i.e. the INITs,
+ * INVARs, TRANSes and DEFINEs of the declaring module and of all the
+ * modules above it, and the actual parameters of their instances.
+ * Transpositions generate all the permutations, so that states can
+ * be sorted by members (e.g. by lex-leader symmetry-breaking
+ * predicates).
+ *
+ * Detection is syntactic and conservative: exprs are compared modulo
+ * commutativity and associativity, arrays are only accepted if all
+ * references to their elements have constant subscripts.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef MODEL_SYMMETRY_H
+#define MODEL_SYMMETRY_H
+
+#include <vector>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <model/model.hh>
+
+#include <utils/pool.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace model {
+
+    struct SymmetryClass {
+        /* the module instance declaring the members, as the names of
+           the instances from the main module, and as a context */
+        expr::ExprVector path;
+        expr::Expr_ptr ctx;
+
+        /* either the names of the instances, or the name of the array
+           var and the number of its elements */
+        expr::ExprVector instances;
+        expr::Expr_ptr array;
+        unsigned nelems;
+
+        inline unsigned size() const
+        {
+            return NULL != array ? nelems : (unsigned) instances.size();
+        }
+    };
+
+    typedef std::vector<SymmetryClass> SymmetryClasses;
+
+    class SymmetryDetector {
+    public:
+        /* the whole pass takes place here */
+        SymmetryDetector(Model& model);
+        ~SymmetryDetector();
+
+        inline const SymmetryClasses& classes() const
+        {
+            return f_classes;
+        }
+
+        /* true iff expr, in the main module, is invariant under the
+           permutations of the members of sc */
+        bool invariant(const SymmetryClass& sc, expr::Expr_ptr expr);
+
+    private:
+        struct Scope {
+            expr::ExprVector path;
+            expr::Expr_ptr ctx;
+            Module_ptr module;
+        };
+        typedef std::vector<Scope> Scopes;
+
+        void collect_scopes(Scopes& res);
+
+        /* candidate classes declared in scope */
+        void collect_candidates(const Scope& scope, SymmetryClasses& res);
+
+        /* true iff the members 0 and i of sc can be exchanged in all
+           the scopes above sc's (sc's included) */
+        bool exchangeable(const SymmetryClass& sc, unsigned i, const Scopes& scopes);
+
+        /* expr, in the scope at depth, with the members 0 and i of sc
+           exchanged. NULL if they can not be told apart in expr
+           (e.g. a subscript which is not constant) */
+        expr::Expr_ptr exchange(const SymmetryClass& sc, unsigned i,
+                                unsigned depth, expr::Expr_ptr expr);
+
+        /* commutative and associative operands, sorted */
+        expr::Expr_ptr canonical(expr::Expr_ptr expr);
+
+        Model& f_model;
+        expr::ExprMgr& f_em;
+
+        SymmetryClasses f_classes;
+
+        boost::unordered_map<expr::Expr_ptr, expr::Expr_ptr,
+                             utils::PtrHash, utils::PtrEq>
+            f_canonicals;
+    };
+
+} // namespace model
+
+#endif /* MODEL_SYMMETRY_H */
@@ -371,7 +371,7 @@ namespace model {
             << std::endl;
 #endif
 
-        f_map[key] = type;
+        f_cache.set(key, type);
     }
 
     type::Type_ptr TypeChecker::type(expr::Expr_ptr expr, expr::Expr_ptr ctx)
@@ -383,14 +383,11 @@ namespace model {
          * '<' rhs, Arithmetical -> lhs '+' rhs */
         expr::Expr_ptr key { em.make_dot(ctx, expr) };
 
-        TypeReg::const_iterator eye { f_map.find(key) };
-        type::Type_ptr res { NULL };
+        type::Type_ptr res { f_cache.find(key) };
 
         // cache miss, fallback to walker
-        if (eye == f_map.end()) {
+        if (!res) {
             res = process(expr, ctx);
-        } else {
-            res = (*eye).second;
         }
 
         assert(NULL != res);
@@ -524,10 +521,9 @@ namespace model {
             em.make_dot(f_ctx_stack.back(), expr)
         };
 
-        TypeReg::iterator eye { f_map.find(key) };
+        type::Type_ptr res { f_cache.find(key) };
 
-        if (eye != f_map.end()) {
-            type::Type_ptr res { (*eye).second };
+        if (res) {
             PUSH_TYPE(res);
 
 #if defined DEBUG_TYPE_CHECKER
@@ -23,6 +23,7 @@
 
 #include <common/common.hh>
 
+#include <expr/collector.hh>
 #include <expr/expr.hh>
 #include <type/type.hh>
 
@@ -35,8 +36,76 @@
 
 namespace model {
 
-    TypeChecker::TypeChecker(ModelMgr& owner)
-        : f_map()
+    void TypeCache::prune(expr::ExprMarker& marker)
+    {
+        boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+
+        expr::ExprVector keys;
+        for (expr::ExprVector::const_iterator i = f_keys.begin();
+             i != f_keys.end(); ++i) {
+            expr::Expr_ptr key { *i };
+
+            if (marker.is_marked(key->lhs()) && marker.is_marked(key->rhs())) {
+                marker.mark(key);
+                keys.push_back(key);
+            } else {
+                f_map.erase(key);
+            }
+        }
+
+        f_keys.swap(keys);
+    }
+
+    expr::Expr_ptr ExpansionCache::expand(expr::preprocessor::Preprocessor& preprocessor,
+                                          expr::Expr_ptr expr, expr::Expr_ptr ctx)
+    {
+        expr::Expr_ptr key { expr::ExprMgr::INSTANCE().make_dot(ctx, expr) };
+
+        {
+            boost::shared_lock<boost::shared_mutex> lock { f_mutex };
+            const expr::Expr_ptr* eye { f_map.find(key) };
+
+            if (eye) {
+                return *eye;
+            }
+        }
+
+        /* expanded outside of the lock, a race only costs a duplicate
+           expansion, to the same expr */
+        expr::Expr_ptr res { preprocessor.process(expr, ctx) };
+
+        boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+        if (!f_map.find(key)) {
+            f_keys.push_back(key);
+            f_map.set(key, res);
+        }
+
+        return res;
+    }
+
+    void ExpansionCache::prune(expr::ExprMarker& marker)
+    {
+        boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+
+        expr::ExprVector keys;
+        for (expr::ExprVector::const_iterator i = f_keys.begin();
+             i != f_keys.end(); ++i) {
+            expr::Expr_ptr key { *i };
+
+            if (marker.is_marked(key->lhs()) && marker.is_marked(key->rhs())) {
+                marker.mark(key);
+                marker.mark(*f_map.find(key));
+                keys.push_back(key);
+            } else {
+                f_map.erase(key);
+            }
+        }
+
+        f_keys.swap(keys);
+    }
+
+    TypeChecker::TypeChecker(ModelMgr& owner, TypeCache& cache)
+        : f_cache(cache)
         , f_type_stack()
         , f_ctx_stack()
         , f_owner(owner)
@@ -569,7 +638,9 @@ namespace model {
     bool TypeChecker::walk_params_preorder(const expr::Expr_ptr expr)
     {
         expr::Expr_ptr ctx { f_ctx_stack.back() };
-        expr::Expr_ptr preprocessed { f_preprocessor.process(expr, ctx) };
+        expr::Expr_ptr preprocessed {
+            f_owner.expansion_cache().expand(f_preprocessor, expr, ctx)
+        };
 
         (*this)(preprocessed);
         return false;
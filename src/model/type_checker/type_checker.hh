@@ -28,24 +28,151 @@
 #define TYPE_CHECKER_H
 
 #include <expr/preprocessor/preprocessor.hh>
-#include <expr/walker/walker.hh>
+#include <expr/walker/static_walker.hh>
 
 #include <type/type.hh>
 #include <type/type_mgr.hh>
 
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
 #include <boost/unordered_map.hpp>
 
 namespace model {
 
-    typedef boost::unordered_map<expr::Expr_ptr, type::Type_ptr, utils::PtrHash, utils::PtrEq> TypeReg;
+    /* by id of the (ctx, expr) key, the checker is a hot spot */
+    typedef expr::ExprIdMap<type::Type_ptr> TypeReg;
+
+    /* types of (ctx, expr) keys, shared by the checkers of all
+       threads. Entries of unchanged modules are kept on reading the
+       model again */
+    class TypeCache {
+    public:
+        /* NULL iff key was not typed yet */
+        inline type::Type_ptr find(const expr::Expr_ptr key)
+        {
+            boost::shared_lock<boost::shared_mutex> lock { f_mutex };
+            const type::Type_ptr* eye { f_map.find(key) };
+
+            return eye ? *eye : NULL;
+        }
+
+        inline void set(const expr::Expr_ptr key, type::Type_ptr type)
+        {
+            boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+            if (!f_map.find(key)) {
+                f_keys.push_back(key);
+            }
+            f_map.set(key, type);
+        }
+
+        /* drops the entries whose ctx satisfies pred */
+        template <typename Pred>
+        void erase_if(Pred pred)
+        {
+            boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+
+            expr::ExprVector keys;
+            for (expr::ExprVector::const_iterator i = f_keys.begin();
+                 i != f_keys.end(); ++i) {
+                expr::Expr_ptr key { *i };
+
+                if (pred(key->lhs())) {
+                    f_map.erase(key);
+                } else {
+                    keys.push_back(key);
+                }
+            }
+
+            f_keys.swap(keys);
+        }
+
+        inline void clear()
+        {
+            boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+            f_map.clear();
+            f_keys.clear();
+        }
+
+        /* drops the entries whose ctx or body is not live, the keys
+           of the others are marked (see expr/collector.hh) */
+        void prune(expr::ExprMarker& marker);
+
+        /* calls f(key, type) on each entry, in insertion order */
+        template <typename F>
+        void for_each(F f)
+        {
+            boost::shared_lock<boost::shared_mutex> lock { f_mutex };
+
+            for (expr::ExprVector::const_iterator i = f_keys.begin();
+                 i != f_keys.end(); ++i) {
+                f(*i, *f_map.find(*i));
+            }
+        }
+
+    private:
+        TypeReg f_map;
+        expr::ExprVector f_keys;
+        boost::shared_mutex f_mutex;
+    };
+
+    /* define-expanded bodies of (ctx, expr) keys of parametric
+       DEFINE calls, made by the checkers during analysis and taken
+       as they are by the compilers. Shared by all threads, cleared
+       as the types are */
+    class ExpansionCache {
+    public:
+        /* the expansion of expr in ctx, by preprocessor on a miss */
+        expr::Expr_ptr expand(expr::preprocessor::Preprocessor& preprocessor,
+                              expr::Expr_ptr expr, expr::Expr_ptr ctx);
+
+        /* drops the entries whose ctx satisfies pred */
+        template <typename Pred>
+        void erase_if(Pred pred)
+        {
+            boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+
+            expr::ExprVector keys;
+            for (expr::ExprVector::const_iterator i = f_keys.begin();
+                 i != f_keys.end(); ++i) {
+                expr::Expr_ptr key { *i };
+
+                if (pred(key->lhs())) {
+                    f_map.erase(key);
+                } else {
+                    keys.push_back(key);
+                }
+            }
+
+            f_keys.swap(keys);
+        }
+
+        inline void clear()
+        {
+            boost::unique_lock<boost::shared_mutex> lock { f_mutex };
+            f_map.clear();
+            f_keys.clear();
+        }
+
+        /* as TypeCache::prune(), expansions of live keys are marked
+           as well */
+        void prune(expr::ExprMarker& marker);
+
+    private:
+        expr::ExprIdMap<expr::Expr_ptr> f_map;
+        expr::ExprVector f_keys;
+        boost::shared_mutex f_mutex;
+    };
 
     /* enable the following macro to debug the TypeChecker */
     // #define DEBUG_TYPE_CHECKER
 
     class ModelMgr;
-    class TypeChecker: public expr::ExprWalker {
+    class TypeChecker: public expr::StaticExprWalker<TypeChecker> {
+        /* hooks are dispatched statically, the walker is a hot spot */
+        friend class expr::StaticExprWalker<TypeChecker>;
+
     public:
-        TypeChecker(ModelMgr& owner);
+        TypeChecker(ModelMgr& owner, TypeCache& cache);
         ~TypeChecker();
 
         /** @brief Returns Type object for given FQExpr (memoized). */
@@ -73,7 +200,7 @@ namespace model {
         void walk_leaf(const expr::Expr_ptr expr);
 
     private:
-        TypeReg f_map; // cache
+        TypeCache& f_cache;
 
         type::TypeVector f_type_stack;
         expr::ExprVector f_ctx_stack;
@@ -29,9 +29,6 @@
 
 namespace opts {
 
-    // static initialization
-    OptsMgr_ptr OptsMgr::f_instance = NULL;
-
     OptsMgr::OptsMgr()
         : f_desc("Program options")
         , f_pos()
@@ -78,9 +75,316 @@ namespace opts {
             )
 
             (
-                "model",
+                "sat-backend",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_SAT_BACKEND),
+                "SAT backend (minisat, minisat-core)"
+            )
+
+            (
+                "portfolio",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_PORTFOLIO),
+                "solver portfolio profile (default, diverse)"
+            )
+
+            (
+                "share-learnts",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_SHARE_LEARNTS),
+                "max size of learnt clauses shared among strategies (0 disables sharing)"
+            )
+
+            (
+                "frame-elimination",
+                "eliminate vars of time frames older than the last two, where possible"
+            )
+
+            (
+                "clause-filter",
+                "drop duplicate and subsumed clauses of each time frame before the SAT backend"
+            )
+
+            (
+                "clause-db-memory",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CLAUSE_DB_MEMORY),
+                "max MB of clause database per SAT engine, learnts reduced to fit (0 = half the command's memory limit, shared among threads)"
+            )
+
+            (
+                "checkpoint-interval",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CHECKPOINT_INTERVAL),
+                "min seconds between checkpoints of reach runs (0 = at each step)"
+            )
+
+            (
+                "checkpoint-learnts",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CHECKPOINT_LEARNTS),
+                "max size of learnt clauses kept in checkpoints of reach runs (0 = none)"
+            )
+
+            (
+                "input-elimination",
+                "let the SAT preprocessor eliminate the vars of inputs only read by TRANS"
+            )
+
+            (
+                "release-dds",
+                "drop the DDs of the compiled INVARs and TRANSes once their CNF templates are built"
+            )
+
+            (
+                "symmetry-breaking",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_SYMMETRY_BREAKING),
+                "lex-leader symmetry breaking on initial states (none, reach, pick-state, all)"
+            )
+
+            (
+                "smt-solver",
                 boost::program_options::value<std::string>(),
-                "input model"
+                "SMT-LIB2 solver command for word-level reach and pick-state (e.g. `z3 -in`)"
+            )
+
+            (
+                "threads",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_THREADS),
+                "max number of strategies running at the same time (0 = number of cores)"
+            )
+
+            (
+                "thread-affinity",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_THREAD_AFFINITY),
+                "pin strategy threads to cores (none, compact: filling NUMA nodes in turn, scatter: across NUMA nodes)"
+            )
+
+            (
+                "cooperative",
+                "run one strategy at a time, SAT calls taking turns in slices of --solve-quantum conflicts"
+            )
+
+            (
+                "lag-factor",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_LAG_FACTOR),
+                "strategies whose next step is projected to take N times longer than the fastest one's give way to the others (0 = never)"
+            )
+
+            (
+                "deterministic",
+                "reproducible results and witnesses, the same on every run regardless of --threads"
+            )
+
+            (
+                "solve-quantum",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_SOLVE_QUANTUM),
+                "conflicts per slice of a SAT call, before giving way to waiting strategies (0 = whole calls)"
+            )
+
+            (
+                "kinduction-simple-path",
+                "strengthen the k-induction step with simple-path constraints"
+            )
+
+            (
+                "lazy-simple-path",
+                "assert simple-path constraints on demand, only between states found equal"
+            )
+
+            (
+                "simple-path-encoding",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_SIMPLE_PATH_ENCODING),
+                "simple-path constraints encoding (pairwise, sorting)"
+            )
+
+            (
+                "split-forward",
+                "search forward reachability witnesses on an unrolling of their own"
+            )
+
+            (
+                "cube-and-conquer",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CUBE_AND_CONQUER),
+                "conflicts after which a forward witness query is split into cubes, solved in parallel (0 = disabled)"
+            )
+
+            (
+                "cube-vars",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CUBE_VARS),
+                "number of splitting vars of cube-and-conquer, i.e. 2^N cubes"
+            )
+
+            (
+                "remote-workers",
+                boost::program_options::value<std::string>(),
+                "comma separated endpoints of yasmv servers solving cubes of cube-and-conquer"
+            )
+
+            (
+                "sweep",
+                "cofactor state bits found constant in all reachable states out of the FSM"
+            )
+
+            (
+                "ternary-sim",
+                "cofactor state bits found stuck by ternary simulation out of the FSM"
+            )
+
+            (
+                "mine-invariants",
+                "add invariants mined by simulation, and proved inductive, to the INVARs of reach"
+            )
+
+            (
+                "bdd-approx",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_BDD_APPROX),
+                "state bits in each block of the BDD over-approximation of the reachable states, added to the INVARs of reach (0 = disabled)"
+            )
+
+            (
+                "stream-parse",
+                "parse models one module at a time, releasing the tokens of each module when done"
+            )
+
+            (
+                "coi",
+                "restrict reachability to the cone of influence of the target"
+            )
+
+            (
+                "microcode-cache",
+                boost::program_options::value<std::string>(),
+                "directory where minimized microcode is cached"
+            )
+
+            (
+                "compile-cache",
+                boost::program_options::value<std::string>(),
+                "directory where compiled units are cached"
+            )
+
+            (
+                "reach-cache",
+                boost::program_options::value<std::string>(),
+                "directory where reachability results are cached"
+            )
+
+            (
+                "cnf-strategy",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_CNF_STRATEGY),
+                "CNFization algorithm (single-cut, no-cut, polarity, adaptive)"
+            )
+
+            (
+                "cnf-no-cut-paths",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_CNF_NO_CUT_PATHS),
+                "max paths to zero of the DDs CNF-ized without cuts by the adaptive strategy"
+            )
+
+            (
+                "decision-order",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_DECISION_ORDER),
+                "SAT decisions on model vars first, frames nearest to the first one first, or last (none, frames, reverse)"
+            )
+
+            (
+                "compiler-backend",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_COMPILER_BACKEND),
+                "boolean structure of compiled formulas (dd, aig)"
+            )
+
+            (
+                "array-encoding",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_ARRAY_ENCODING),
+                "array subscripts encoding (auto, flat, tree, lazy)"
+            )
+
+            (
+                "enum-encoding",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_ENUM_ENCODING),
+                "enum vars encoding (auto, log, one-hot, order)"
+            )
+
+            (
+                "narrow-ranges",
+                "encode algebraic vars with the bits of the value ranges inferred for them"
+            )
+
+            (
+                "dd-reordering",
+                boost::program_options::value<std::string>()->default_value(DEFAULT_DD_REORDERING),
+                "DD dynamic reordering (none, sift, group-sift)"
+            )
+
+            (
+                "dd-max-reorderings",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_DD_MAX_REORDERINGS),
+                "max number of DD reorderings per manager (0 = no limit)"
+            )
+
+            (
+                "dd-static-order",
+                "interleave the DD vars of related variables, MSB first"
+            )
+
+            (
+                "dd-unique-slots",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_DD_UNIQUE_SLOTS),
+                "initial DD unique table slots, per variable"
+            )
+
+            (
+                "dd-cache",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_DD_CACHE),
+                "initial DD computed table slots"
+            )
+
+            (
+                "dd-max-memory",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_DD_MAX_MEMORY),
+                "max memory per DD manager, in MB (0 = CUDD default)"
+            )
+
+            (
+                "rewrite-cache",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_REWRITE_CACHE),
+                "slots of the cache of rewriting passes (0 = disabled)"
+            )
+
+            (
+                "gc-threshold",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_GC_THRESHOLD),
+                "exprs pooled between automatic collections of unreachable exprs (0 = disabled)"
+            )
+
+            (
+                "witness-cache",
+                boost::program_options::value<unsigned>()->default_value(DEFAULT_WITNESS_CACHE),
+                "witnesses kept in memory, the least recently used others are spilled to disk (0 = all)"
+            )
+
+            (
+                "async-log",
+                "queue log lines, written by a background thread"
+            )
+
+            (
+                "trace-events",
+                boost::program_options::value<std::string>(),
+                "write trace events of the run to file, in Chrome trace format"
+            )
+
+            (
+                "progress-fd",
+                boost::program_options::value<int>(),
+                "write a JSON line of progress after each SAT solve to file descriptor"
+            )
+
+            (
+                "server",
+                boost::program_options::value<std::string>(),
+                "serve JSON-RPC requests on a TCP port (localhost) or a Unix socket path"
+            )
+
+            (
+                "model",
+                boost::program_options::value<std::vector<std::string>>(),
+                "input model (several files are read as a single model)"
             )
             ;
         // clang-format on
@@ -121,6 +425,9 @@ namespace opts {
         }
 
         f_started = true;
+
+        /* the level is tested by each log line, it is cached there */
+        utils::Logger::INSTANCE().set_level(get_verbosity_level_tolerance());
     }
 
     unsigned OptsMgr::verbosity() const
@@ -178,11 +485,414 @@ namespace opts {
     }
 
 
-    std::string OptsMgr::model() const
+    void OptsMgr::set_sat_backend(const std::string& value)
+    {
+        TRACE
+            << "Setting SAT backend to "
+            << value
+            << std::endl;
+
+        f_sat_backend = value;
+    }
+
+    std::string OptsMgr::sat_backend() const
+    {
+        if (!f_sat_backend.empty()) {
+            return f_sat_backend;
+        }
+
+        return f_vm.count("sat-backend")
+                   ? f_vm["sat-backend"].as<std::string>()
+                   : std::string(DEFAULT_SAT_BACKEND);
+    }
+
+    std::string OptsMgr::portfolio() const
+    {
+        return f_vm.count("portfolio")
+                   ? f_vm["portfolio"].as<std::string>()
+                   : std::string(DEFAULT_PORTFOLIO);
+    }
+
+    unsigned OptsMgr::share_learnts() const
+    {
+        return f_vm.count("share-learnts")
+                   ? f_vm["share-learnts"].as<unsigned>()
+                   : DEFAULT_SHARE_LEARNTS;
+    }
+
+    bool OptsMgr::frame_elimination() const
+    {
+        return 0 != f_vm.count("frame-elimination");
+    }
+
+    bool OptsMgr::clause_filter() const
+    {
+        return 0 != f_vm.count("clause-filter");
+    }
+
+    unsigned OptsMgr::clause_db_memory() const
+    {
+        return f_vm.count("clause-db-memory")
+                   ? f_vm["clause-db-memory"].as<unsigned>()
+                   : DEFAULT_CLAUSE_DB_MEMORY;
+    }
+
+    unsigned OptsMgr::checkpoint_interval() const
+    {
+        return f_vm.count("checkpoint-interval")
+                   ? f_vm["checkpoint-interval"].as<unsigned>()
+                   : DEFAULT_CHECKPOINT_INTERVAL;
+    }
+
+    unsigned OptsMgr::checkpoint_learnts() const
+    {
+        return f_vm.count("checkpoint-learnts")
+                   ? f_vm["checkpoint-learnts"].as<unsigned>()
+                   : DEFAULT_CHECKPOINT_LEARNTS;
+    }
+
+    bool OptsMgr::input_elimination() const
+    {
+        return 0 != f_vm.count("input-elimination");
+    }
+
+    bool OptsMgr::release_dds() const
+    {
+        return 0 != f_vm.count("release-dds");
+    }
+
+    std::string OptsMgr::symmetry_breaking() const
+    {
+        return f_vm.count("symmetry-breaking")
+                   ? f_vm["symmetry-breaking"].as<std::string>()
+                   : std::string(DEFAULT_SYMMETRY_BREAKING);
+    }
+
+    std::string OptsMgr::smt_solver() const
+    {
+        std::string res { "" };
+        if (f_vm.count("smt-solver")) {
+            res = f_vm["smt-solver"].as<std::string>();
+        }
+
+        return res;
+    }
+
+    unsigned OptsMgr::threads() const
+    {
+        return f_vm.count("threads")
+                   ? f_vm["threads"].as<unsigned>()
+                   : DEFAULT_THREADS;
+    }
+
+    std::string OptsMgr::thread_affinity() const
+    {
+        return f_vm.count("thread-affinity")
+                   ? f_vm["thread-affinity"].as<std::string>()
+                   : std::string(DEFAULT_THREAD_AFFINITY);
+    }
+
+    bool OptsMgr::cooperative() const
+    {
+        return 0 != f_vm.count("cooperative");
+    }
+
+    unsigned OptsMgr::lag_factor() const
+    {
+        return f_vm.count("lag-factor")
+                   ? f_vm["lag-factor"].as<unsigned>()
+                   : DEFAULT_LAG_FACTOR;
+    }
+
+    bool OptsMgr::deterministic() const
+    {
+        return 0 != f_vm.count("deterministic");
+    }
+
+    unsigned OptsMgr::solve_quantum() const
+    {
+        unsigned res {
+            f_vm.count("solve-quantum")
+                ? f_vm["solve-quantum"].as<unsigned>()
+                : DEFAULT_SOLVE_QUANTUM
+        };
+
+        /* cooperative strategies need slices */
+        if (0 == res && cooperative()) {
+            res = DEFAULT_COOPERATIVE_QUANTUM;
+        }
+
+        return res;
+    }
+
+    bool OptsMgr::kinduction_simple_path() const
+    {
+        return 0 != f_vm.count("kinduction-simple-path");
+    }
+
+    bool OptsMgr::lazy_simple_path() const
+    {
+        return 0 != f_vm.count("lazy-simple-path");
+    }
+
+    std::string OptsMgr::simple_path_encoding() const
+    {
+        return f_vm.count("simple-path-encoding")
+                   ? f_vm["simple-path-encoding"].as<std::string>()
+                   : std::string(DEFAULT_SIMPLE_PATH_ENCODING);
+    }
+
+    bool OptsMgr::split_forward() const
+    {
+        return 0 != f_vm.count("split-forward");
+    }
+
+    unsigned OptsMgr::cube_and_conquer() const
+    {
+        /* cubes race each other */
+        if (deterministic()) {
+            return 0;
+        }
+
+        return f_vm.count("cube-and-conquer")
+                   ? f_vm["cube-and-conquer"].as<unsigned>()
+                   : DEFAULT_CUBE_AND_CONQUER;
+    }
+
+    unsigned OptsMgr::cube_vars() const
+    {
+        return f_vm.count("cube-vars")
+                   ? f_vm["cube-vars"].as<unsigned>()
+                   : DEFAULT_CUBE_VARS;
+    }
+
+    std::vector<std::string> OptsMgr::remote_workers() const
+    {
+        std::vector<std::string> res;
+        if (f_vm.count("remote-workers")) {
+            std::istringstream iss { f_vm["remote-workers"].as<std::string>() };
+
+            std::string endpoint;
+            while (std::getline(iss, endpoint, ',')) {
+                if (!endpoint.empty()) {
+                    res.push_back(endpoint);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    bool OptsMgr::sweep() const
+    {
+        return 0 != f_vm.count("sweep");
+    }
+
+    bool OptsMgr::ternary_sim() const
+    {
+        return 0 != f_vm.count("ternary-sim");
+    }
+
+    bool OptsMgr::mine_invariants() const
+    {
+        return 0 != f_vm.count("mine-invariants");
+    }
+
+    unsigned OptsMgr::bdd_approx() const
+    {
+        return f_vm.count("bdd-approx")
+                   ? f_vm["bdd-approx"].as<unsigned>()
+                   : DEFAULT_BDD_APPROX;
+    }
+
+    bool OptsMgr::stream_parse() const
+    {
+        return 0 != f_vm.count("stream-parse");
+    }
+
+    bool OptsMgr::coi() const
+    {
+        return 0 != f_vm.count("coi");
+    }
+
+    std::string OptsMgr::microcode_cache() const
+    {
+        std::string res { "" };
+        if (f_vm.count("microcode-cache")) {
+            res = f_vm["microcode-cache"].as<std::string>();
+        }
+
+        return res;
+    }
+
+    std::string OptsMgr::compile_cache() const
+    {
+        std::string res { "" };
+        if (f_vm.count("compile-cache")) {
+            res = f_vm["compile-cache"].as<std::string>();
+        }
+
+        return res;
+    }
+
+    std::string OptsMgr::reach_cache() const
     {
         std::string res { "" };
+        if (f_vm.count("reach-cache")) {
+            res = f_vm["reach-cache"].as<std::string>();
+        }
+
+        return res;
+    }
+
+    std::string OptsMgr::cnf_strategy() const
+    {
+        return f_vm.count("cnf-strategy")
+                   ? f_vm["cnf-strategy"].as<std::string>()
+                   : std::string(DEFAULT_CNF_STRATEGY);
+    }
+
+    unsigned OptsMgr::cnf_no_cut_paths() const
+    {
+        return f_vm.count("cnf-no-cut-paths")
+                   ? f_vm["cnf-no-cut-paths"].as<unsigned>()
+                   : DEFAULT_CNF_NO_CUT_PATHS;
+    }
+
+    std::string OptsMgr::decision_order() const
+    {
+        return f_vm.count("decision-order")
+                   ? f_vm["decision-order"].as<std::string>()
+                   : std::string(DEFAULT_DECISION_ORDER);
+    }
+
+    std::string OptsMgr::compiler_backend() const
+    {
+        return f_vm.count("compiler-backend")
+                   ? f_vm["compiler-backend"].as<std::string>()
+                   : std::string(DEFAULT_COMPILER_BACKEND);
+    }
+
+    std::string OptsMgr::array_encoding() const
+    {
+        return f_vm.count("array-encoding")
+                   ? f_vm["array-encoding"].as<std::string>()
+                   : std::string(DEFAULT_ARRAY_ENCODING);
+    }
+
+    std::string OptsMgr::enum_encoding() const
+    {
+        return f_vm.count("enum-encoding")
+                   ? f_vm["enum-encoding"].as<std::string>()
+                   : std::string(DEFAULT_ENUM_ENCODING);
+    }
+
+    bool OptsMgr::narrow_ranges() const
+    {
+        return 0 != f_vm.count("narrow-ranges");
+    }
+
+    std::string OptsMgr::dd_reordering() const
+    {
+        return f_vm.count("dd-reordering")
+                   ? f_vm["dd-reordering"].as<std::string>()
+                   : std::string(DEFAULT_DD_REORDERING);
+    }
+
+    unsigned OptsMgr::dd_max_reorderings() const
+    {
+        return f_vm.count("dd-max-reorderings")
+                   ? f_vm["dd-max-reorderings"].as<unsigned>()
+                   : DEFAULT_DD_MAX_REORDERINGS;
+    }
+
+    bool OptsMgr::dd_static_order() const
+    {
+        return 0 != f_vm.count("dd-static-order");
+    }
+
+    unsigned OptsMgr::dd_unique_slots() const
+    {
+        return f_vm.count("dd-unique-slots")
+                   ? f_vm["dd-unique-slots"].as<unsigned>()
+                   : DEFAULT_DD_UNIQUE_SLOTS;
+    }
+
+    unsigned OptsMgr::dd_cache() const
+    {
+        return f_vm.count("dd-cache")
+                   ? f_vm["dd-cache"].as<unsigned>()
+                   : DEFAULT_DD_CACHE;
+    }
+
+    unsigned OptsMgr::dd_max_memory() const
+    {
+        return f_vm.count("dd-max-memory")
+                   ? f_vm["dd-max-memory"].as<unsigned>()
+                   : DEFAULT_DD_MAX_MEMORY;
+    }
+
+    unsigned OptsMgr::rewrite_cache() const
+    {
+        return f_vm.count("rewrite-cache")
+                   ? f_vm["rewrite-cache"].as<unsigned>()
+                   : DEFAULT_REWRITE_CACHE;
+    }
+
+    unsigned OptsMgr::gc_threshold() const
+    {
+        return f_vm.count("gc-threshold")
+                   ? f_vm["gc-threshold"].as<unsigned>()
+                   : DEFAULT_GC_THRESHOLD;
+    }
+
+    unsigned OptsMgr::witness_cache() const
+    {
+        return f_vm.count("witness-cache")
+                   ? f_vm["witness-cache"].as<unsigned>()
+                   : DEFAULT_WITNESS_CACHE;
+    }
+
+    std::vector<std::string> OptsMgr::models() const
+    {
+        std::vector<std::string> res;
         if (f_vm.count("model")) {
-            res = f_vm["model"].as<std::string>();
+            res = f_vm["model"].as<std::vector<std::string>>();
+        }
+
+        return res;
+    }
+
+    bool OptsMgr::async_log() const
+    {
+        return 0 != f_vm.count("async-log");
+    }
+
+    std::string OptsMgr::trace_events() const
+    {
+        std::string res { "" };
+        if (f_vm.count("trace-events")) {
+            res = f_vm["trace-events"].as<std::string>();
+        }
+
+        return res;
+    }
+
+    int OptsMgr::progress_fd() const
+    {
+        int res { -1 };
+        if (f_vm.count("progress-fd")) {
+            res = f_vm["progress-fd"].as<int>();
+        }
+
+        return res;
+    }
+
+    std::string OptsMgr::server() const
+    {
+        std::string res { "" };
+        if (f_vm.count("server")) {
+            res = f_vm["server"].as<std::string>();
         }
 
         return res;
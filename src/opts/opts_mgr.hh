@@ -27,6 +27,9 @@
 #ifndef OPTS_H
 #define OPTS_H
 
+#include <string>
+#include <vector>
+
 #include <boost/program_options.hpp>
 
 #include <common/common.hh>
@@ -41,16 +44,45 @@ namespace opts {
     const unsigned DEFAULT_WORD_WIDTH = 16;
     const unsigned DEFAULT_PRECISION = 0;
     const unsigned DEFAULT_VERBOSITY = 0;
+    const char* const DEFAULT_SAT_BACKEND = "minisat";
+    const char* const DEFAULT_CNF_STRATEGY = "single-cut";
+    const unsigned DEFAULT_CNF_NO_CUT_PATHS = 16;
+    const char* const DEFAULT_DECISION_ORDER = "none";
+    const char* const DEFAULT_COMPILER_BACKEND = "dd";
+    const char* const DEFAULT_ARRAY_ENCODING = "auto";
+    const char* const DEFAULT_ENUM_ENCODING = "auto";
+    const char* const DEFAULT_DD_REORDERING = "group-sift";
+    const unsigned DEFAULT_DD_MAX_REORDERINGS = 0;
+    const unsigned DEFAULT_DD_UNIQUE_SLOTS = 256;
+    const unsigned DEFAULT_DD_CACHE = 262144;
+    const unsigned DEFAULT_DD_MAX_MEMORY = 0;
+    const unsigned DEFAULT_REWRITE_CACHE = 65536;
+    const unsigned DEFAULT_GC_THRESHOLD = 4194304;
+    const unsigned DEFAULT_WITNESS_CACHE = 0;
+    const char* const DEFAULT_SIMPLE_PATH_ENCODING = "pairwise";
+    const char* const DEFAULT_PORTFOLIO = "default";
+    const unsigned DEFAULT_SHARE_LEARNTS = 0;
+    const unsigned DEFAULT_CLAUSE_DB_MEMORY = 0;
+    const unsigned DEFAULT_CHECKPOINT_INTERVAL = 600;
+    const unsigned DEFAULT_CHECKPOINT_LEARNTS = 0;
+    const unsigned DEFAULT_BDD_APPROX = 0;
+    const unsigned DEFAULT_THREADS = 0;
+    const unsigned DEFAULT_SOLVE_QUANTUM = 0;
+    const unsigned DEFAULT_COOPERATIVE_QUANTUM = 1000;
+    const unsigned DEFAULT_LAG_FACTOR = 10;
+    const unsigned DEFAULT_CUBE_AND_CONQUER = 0;
+    const unsigned DEFAULT_CUBE_VARS = 4;
+    const char* const DEFAULT_SYMMETRY_BREAKING = "none";
+    const char* const DEFAULT_THREAD_AFFINITY = "none";
 
     class OptsMgr {
 
     public:
         static OptsMgr& INSTANCE()
         {
-            if (!f_instance)
-                f_instance = new OptsMgr();
-
-            return (*f_instance);
+            /* made on first use, concurrent first uses wait for it */
+            static OptsMgr_ptr instance { new OptsMgr() };
+            return *instance;
         }
 
         // the usage message
@@ -76,8 +108,180 @@ namespace opts {
         unsigned precision() const;
         void set_precision(unsigned);
 
-        // model filename
-        std::string model() const;
+        // SAT backend used by engines (e.g. `minisat`, `minisat-core`)
+        std::string sat_backend() const;
+        void set_sat_backend(const std::string&);
+
+        // solver portfolio profile (`default`, `diverse`)
+        std::string portfolio() const;
+
+        // max size of learnt clauses shared among strategies (0 = disabled)
+        unsigned share_learnts() const;
+
+        // incremental elimination of the vars of older time frames
+        bool frame_elimination() const;
+
+        // drop duplicate and subsumed clauses of each time frame
+        bool clause_filter() const;
+
+        // MB of clause database per SAT engine (0 = from the memory
+        // limit of the command, if any)
+        unsigned clause_db_memory() const;
+
+        // min seconds between checkpoints of reach runs (0 = at each step)
+        unsigned checkpoint_interval() const;
+
+        // max size of the learnts kept in checkpoints (0 = none)
+        unsigned checkpoint_learnts() const;
+
+        // inputs only read by TRANS are left to the SAT preprocessor
+        bool input_elimination() const;
+
+        // INVARs and TRANSes are kept as CNF templates only, once built
+        bool release_dds() const;
+
+        // lex-leader symmetry breaking on initial states (`none`, `reach`, `pick-state`, `all`)
+        std::string symmetry_breaking() const;
+
+        // SMT-LIB2 solver command for the word-level strategies (empty = none)
+        std::string smt_solver() const;
+
+        // max number of running strategies (0 = number of cores)
+        unsigned threads() const;
+
+        // placement of the strategy threads on the cores (`none`, `compact`, `scatter`)
+        std::string thread_affinity() const;
+
+        // strategies take turns on a single slot, solving in slices
+        bool cooperative() const;
+
+        // strategies whose next step is projected to take this many
+        // times longer than the fastest one's give way to the others
+        // (0 = never)
+        unsigned lag_factor() const;
+
+        // reproducible results, regardless of threads and timing
+        bool deterministic() const;
+
+        // conflicts per slice of a SAT call, before giving way to
+        // waiting strategies (0 = never, unless cooperative)
+        unsigned solve_quantum() const;
+
+        // simple-path strengthening for the k-induction step
+        bool kinduction_simple_path() const;
+
+        // on-demand simple-path (state uniqueness) constraints
+        bool lazy_simple_path() const;
+
+        // simple-path constraints encoding (`pairwise`, `sorting`)
+        std::string simple_path_encoding() const;
+
+        // separate unrollings for forward witnesses and proofs
+        bool split_forward() const;
+
+        // conflicts before a forward witness query is split into cubes
+        // (0 = disabled)
+        unsigned cube_and_conquer() const;
+
+        // number of splitting vars of cube-and-conquer (2^N cubes)
+        unsigned cube_vars() const;
+
+        // endpoints of the remote workers of cube-and-conquer
+        std::vector<std::string> remote_workers() const;
+
+        // constant state bits sweeping
+        bool sweep() const;
+
+        // state bits stuck by ternary simulation are swept as well
+        bool ternary_sim() const;
+
+        // invariants mined by simulation strengthen the reach strategies
+        bool mine_invariants() const;
+
+        // state bits in each block of the BDD over-approximation of the
+        // reachable states, for the reach strategies (0 = disabled)
+        unsigned bdd_approx() const;
+
+        // parse models one module at a time
+        bool stream_parse() const;
+
+        // cone of influence reduction for reachability
+        bool coi() const;
+
+        // minimized microcode cache directory (empty = no caching)
+        std::string microcode_cache() const;
+
+        // compiled units cache directory (empty = no caching)
+        std::string compile_cache() const;
+
+        // reachability results cache directory (empty = no caching)
+        std::string reach_cache() const;
+
+        // CNFization algorithm (`single-cut`, `no-cut`, `polarity`,
+        // `adaptive`)
+        std::string cnf_strategy() const;
+
+        // max paths to zero of the DDs CNF-ized without cuts, with the
+        // `adaptive` strategy
+        unsigned cnf_no_cut_paths() const;
+
+        // SAT decisions on model vars first, by frame (`none`, `frames`,
+        // `reverse`)
+        std::string decision_order() const;
+
+        // boolean structure of compiled units (`dd`, `aig`)
+        std::string compiler_backend() const;
+
+        // array subscripts encoding (`auto`, `flat`, `tree`, `lazy`)
+        std::string array_encoding() const;
+
+        // enum vars encoding (`auto`, `log`, `one-hot`, `order`)
+        std::string enum_encoding() const;
+
+        // range analysis driven narrowing of algebraic encodings
+        bool narrow_ranges() const;
+
+        // DD dynamic reordering (`none`, `sift`, `group-sift`)
+        std::string dd_reordering() const;
+
+        // max number of DD reorderings per manager (0 = no limit)
+        unsigned dd_max_reorderings() const;
+
+        // interleaved encodings for related vars
+        bool dd_static_order() const;
+
+        // initial DD unique table slots, per variable
+        unsigned dd_unique_slots() const;
+
+        // initial DD computed table slots
+        unsigned dd_cache() const;
+
+        // max memory per DD manager, in MB (0 = CUDD default)
+        unsigned dd_max_memory() const;
+
+        // slots of the cache of rewriting passes (0 = disabled)
+        unsigned rewrite_cache() const;
+
+        // exprs pooled between automatic collections (0 = disabled)
+        unsigned gc_threshold() const;
+
+        // witnesses kept in memory, others are spilled to disk (0 = all)
+        unsigned witness_cache() const;
+
+        // model filenames, read as a single model
+        std::vector<std::string> models() const;
+
+        // log lines are written by a background thread
+        bool async_log() const;
+
+        // trace events filename (empty = no tracing)
+        std::string trace_events() const;
+
+        // progress channel file descriptor (-1 = none)
+        int progress_fd() const;
+
+        // server endpoint, a TCP port or a Unix socket path (empty = interactive)
+        std::string server() const;
 
         // to be invoked by main
         void parse_command_line(int argc, const char** argv);
@@ -89,8 +293,6 @@ namespace opts {
         OptsMgr();
 
     private:
-        static OptsMgr_ptr f_instance;
-
         /* local data */
         boost::program_options::options_description f_desc;
         boost::program_options::positional_options_description f_pos;
@@ -104,6 +306,8 @@ namespace opts {
 
         unsigned f_word_width;
         unsigned f_precision;
+
+        std::string f_sat_backend;
     };
 
 }; // namespace opts
@@ -21,7 +21,21 @@
  *
  **/
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <common/common.hh>
 
 #include <cmd/cmd.hh>
@@ -30,6 +44,7 @@
 #include <expr/printer/printer.hh>
 
 #include <model/model.hh>
+#include <model/model_mgr.hh>
 
 #include <opts/opts_mgr.hh>
 
@@ -41,64 +56,145 @@
 
 namespace parse {
 
-static bool parseErrors;
+/* files are parsed concurrently (see parseFiles), each thread keeps
+   track of its own errors and position */
+static thread_local bool parseErrors;
+
+/* lines before the chunk being parsed, for error messages */
+static thread_local ANTLR3_UINT32 lineOffset;
+
+/* SMV sources run at about this many bytes per token */
+static const size_t BYTES_PER_TOKEN { 6 };
+
 static void yasmvdisplayRecognitionError (pANTLR3_BASE_RECOGNIZER recognizer,
                                           pANTLR3_UINT8 * tokenNames);
 static void reportParserStatus(bool parseErrors, timespec start,
-                               timespec stop);
+                               timespec stop, size_t nbytes);
+
+static bool parseModelFile(const char* fName, model::Model& target);
+static bool parseModelStream(pANTLR3_INPUT_STREAM input, size_t nbytes,
+                             model::Model& target);
+static bool parseModelChunk(pANTLR3_UINT8 data, size_t size,
+                            const char* fName, ANTLR3_UINT32 line,
+                            model::Model& target);
+static bool hasModelDirectives(const char* fName);
+static void findModuleChunks(const char* data, size_t size,
+                             std::vector<size_t>& offsets,
+                             std::vector<ANTLR3_UINT32>& lines);
 
 /**
- * Runs the parser SMV rule on an input .smv file.
+ * Runs the parser SMV rule on an input .smv file. The file is mapped
+ * in memory and read in place. In streaming mode (--stream-parse)
+ * each module is parsed on its own, and its tokens are released
+ * right after, instead of keeping the tokens of the whole file.
  *
  * @returns true if parsing was successful, false otherwise.
  */
 bool parseFile(const char* fName)
 {
-    pANTLR3_INPUT_STREAM input;
-    pANTLR3_COMMON_TOKEN_STREAM tstream;
-
-    psmvParser psr;
-    psmvLexer  lxr;
-
-    DEBUG
-        << "Parsing smv file "
-        << fName
-        << " ..."
-        << std::endl;
-
-    struct timespec start_clock;
-    clock_gettime(CLOCK_MONOTONIC, &start_clock);
+    return parseModelFile(fName, model::ModelMgr::INSTANCE().model());
+}
 
-    input = antlr3FileStreamNew((pANTLR3_UINT8) fName, ANTLR3_ENC_8BIT);
+/**
+ * Runs the parser SMV rule on an input .smv file, as parseFile does,
+ * into a model other than the current one (e.g. a revision to be
+ * compared against another one). Types are those of the current
+ * context.
+ *
+ * @returns true if parsing was successful, false otherwise.
+ */
+bool parseFileInto(const char* fName, model::Model& target)
+{
+    return parseModelFile(fName, target);
+}
 
-    if (!input)
-        throw FileInputException(fName);
+/**
+ * Runs the parser SMV rule on several input .smv files, as if they
+ * were read one after the other. Files are parsed concurrently, each
+ * one by a lexer and a parser of its own, into a model of its own:
+ * the modules are merged afterwards, in the order of the files. Model
+ * directives (e.g. #word-width) change how the files after them are
+ * parsed, the files up to the last one having any are parsed in
+ * order, before the others.
+ *
+ * @returns true if parsing was successful, false otherwise.
+ */
+bool parseFiles(const std::vector<std::string>& fNames)
+{
+    model::Model& model { model::ModelMgr::INSTANCE().model() };
 
-    lxr = smvLexerNew(input); // smvLexerNew is generated by ANTLR
-    assert(lxr);
+    size_t n_ordered { 0 };
+    for (size_t i = 0; i < fNames.size(); ++ i)
+        if (hasModelDirectives(fNames[i].c_str()))
+            n_ordered = 1 + i;
 
-    tstream = antlr3CommonTokenStreamSourceNew(ANTLR3_SIZE_HINT, TOKENSOURCE(lxr));
-    assert(tstream);
+    /* nothing to gain with less than two files left */
+    if (fNames.size() < 2 + n_ordered)
+        n_ordered = fNames.size();
 
-    psr = smvParserNew(tstream);  // smvParserNew is generated by ANTLR3
-    assert(psr);
+    for (size_t i = 0; i < n_ordered; ++ i)
+        if (!parseModelFile(fNames[i].c_str(), model))
+            return false;
 
-    parseErrors = false;
-    psr->pParser->rec->displayRecognitionError = yasmvdisplayRecognitionError;
+    size_t n_files { fNames.size() - n_ordered };
+    if (0 == n_files)
+        return true;
 
-    psr->smv(psr);
+    unsigned n_threads {
+        std::max(1u, std::min((unsigned) n_files, boost::thread::hardware_concurrency()))
+    };
 
-    // cleanup
-    psr->free(psr);
-    tstream->free(tstream);
-    lxr->free(lxr);
-    input->close(input);
+    DEBUG
+        << "Parsing "
+        << n_files
+        << " files on "
+        << n_threads
+        << " threads"
+        << std::endl;
 
-    struct timespec stop_clock;
-    clock_gettime(CLOCK_MONOTONIC, &stop_clock);
+    std::vector<model::Model_ptr> staging;
+    for (size_t i = 0; i < n_files; ++ i)
+        staging.push_back(new model::Model());
+
+    std::vector<char> parsed(n_files, false);
+    boost::mutex mutex;
+    size_t next { 0 };
+
+    boost::thread_group threads;
+    for (unsigned t = 0; t < n_threads; ++ t)
+        threads.create_thread([&]() {
+            while (true) {
+                size_t i;
+                {
+                    boost::mutex::scoped_lock lock { mutex };
+                    if (n_files <= next)
+                        return;
+                    i = next ++;
+                }
+
+                const char* fName { fNames[n_ordered + i].c_str() };
+                try {
+                    parsed[i] = parseModelFile(fName, *staging[i]);
+                }
+                catch (const Exception& e) {
+                    pconst_char what { e.what() };
+                    ERR
+                        << what
+                        << std::endl;
+                }
+            }
+        });
+    threads.join_all();
+
+    bool res { std::find(parsed.begin(), parsed.end(), false) == parsed.end() };
+    for (size_t i = 0; i < n_files; ++ i) {
+        if (res)
+            model.merge(*staging[i]);
+
+        delete staging[i];
+    }
 
-    reportParserStatus(parseErrors, start_clock, stop_clock);
-    return ! parseErrors;
+    return res;
 }
 
 /**
@@ -149,7 +245,7 @@ cmd::CommandVector_ptr parseCommand(const char *command_line)
     struct timespec stop_clock;
     clock_gettime(CLOCK_MONOTONIC, &stop_clock);
 
-    reportParserStatus(parseErrors, start_clock, stop_clock);
+    reportParserStatus(parseErrors, start_clock, stop_clock, strlen(command_line));
     return ! parseErrors
         ? res : NULL;
 }
@@ -236,6 +332,201 @@ type::Type_ptr parseTypedef(const char *string)
 }
 
 /* -- static helpers ------------------------------------------------------- */
+
+/* parses an input .smv file, its modules are added to target */
+static bool parseModelFile(const char* fName, model::Model& target)
+{
+    DEBUG
+        << "Parsing smv file "
+        << fName
+        << " ..."
+        << std::endl;
+
+    struct timespec start_clock;
+    clock_gettime(CLOCK_MONOTONIC, &start_clock);
+
+    int fd { open(fName, O_RDONLY) };
+    if (fd < 0)
+        throw FileInputException(fName);
+
+    struct stat st;
+    size_t size { 0 == fstat(fd, &st) ? (size_t) st.st_size : 0 };
+
+    /* empty files can not be mapped */
+    void* data { 0 < size && size <= UINT32_MAX
+            ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)
+            : MAP_FAILED };
+    close(fd);
+
+    bool res { false };
+    if (MAP_FAILED == data) {
+        pANTLR3_INPUT_STREAM input {
+            antlr3FileStreamNew((pANTLR3_UINT8) fName, ANTLR3_ENC_8BIT)
+        };
+
+        if (!input)
+            throw FileInputException(fName);
+
+        lineOffset = 0;
+        res = parseModelStream(input, size, target);
+    }
+    else {
+        madvise(data, size, MADV_SEQUENTIAL);
+
+        if (opts::OptsMgr::INSTANCE().stream_parse()) {
+            std::vector<size_t> offsets;
+            std::vector<ANTLR3_UINT32> lines;
+            findModuleChunks((const char*) data, size, offsets, lines);
+
+            unsigned n_chunks { (unsigned) offsets.size() };
+            DEBUG
+                << "Parsing "
+                << n_chunks
+                << " chunks"
+                << std::endl;
+
+            res = true;
+            for (unsigned i = 0; res && i < offsets.size(); ++ i) {
+                size_t begin { offsets[i] };
+                size_t end { i + 1 < offsets.size() ? offsets[i + 1] : size };
+
+                res = parseModelChunk((pANTLR3_UINT8) data + begin, end - begin,
+                                      fName, lines[i], target);
+            }
+        }
+        else
+            res = parseModelChunk((pANTLR3_UINT8) data, size, fName, 1, target);
+
+        munmap(data, size);
+    }
+
+    struct timespec stop_clock;
+    clock_gettime(CLOCK_MONOTONIC, &stop_clock);
+
+    reportParserStatus(!res, start_clock, stop_clock, size);
+    return res;
+}
+
+/* runs the parser SMV rule on input, which is closed afterwards. The
+   token vector is sized after the input */
+static bool parseModelStream(pANTLR3_INPUT_STREAM input, size_t nbytes,
+                             model::Model& target)
+{
+    pANTLR3_COMMON_TOKEN_STREAM tstream;
+
+    psmvParser psr;
+    psmvLexer  lxr;
+
+    lxr = smvLexerNew(input); // smvLexerNew is generated by ANTLR
+    assert(lxr);
+
+    ANTLR3_UINT32 hint {
+        (ANTLR3_UINT32) std::max<size_t>(ANTLR3_SIZE_HINT, nbytes / BYTES_PER_TOKEN)
+    };
+    tstream = antlr3CommonTokenStreamSourceNew(hint, TOKENSOURCE(lxr));
+    assert(tstream);
+
+    psr = smvParserNew(tstream);  // smvParserNew is generated by ANTLR3
+    assert(psr);
+
+    parseErrors = false;
+    psr->pParser->rec->displayRecognitionError = yasmvdisplayRecognitionError;
+    psr->target_model = &target;
+
+    psr->smv(psr);
+
+    // cleanup, tokens are released here
+    psr->free(psr);
+    tstream->free(tstream);
+    lxr->free(lxr);
+    input->close(input);
+
+    return ! parseErrors;
+}
+
+/* parses size bytes of a mapped file in place, from line on */
+static bool parseModelChunk(pANTLR3_UINT8 data, size_t size,
+                            const char* fName, ANTLR3_UINT32 line,
+                            model::Model& target)
+{
+    pANTLR3_INPUT_STREAM input {
+        antlr3StringStreamNew(data, ANTLR3_ENC_8BIT, (ANTLR3_UINT32) size,
+                              (pANTLR3_UINT8) fName)
+    };
+    assert(input);
+
+    lineOffset = line - 1;
+    return parseModelStream(input, size, target);
+}
+
+/* true iff the file has model directives, i.e. lines starting with a
+   `#` before the first module */
+static bool hasModelDirectives(const char* fName)
+{
+    std::ifstream is { fName };
+    std::string line;
+
+    while (std::getline(is, line)) {
+        std::istringstream iss { line };
+        std::string word;
+
+        if (!(iss >> word))
+            continue;
+
+        if ('#' == word[0])
+            return true;
+
+        if ("MODULE" == word)
+            break;
+    }
+
+    return false;
+}
+
+/* offsets (and line numbers) of the chunks of a model, each one
+ * starting with a line whose first word is MODULE. The first chunk
+ * starts at 0, directives are parsed along with the first module. As
+ * MODULE is a keyword, such lines can not be found within a module,
+ * nor in a (line) comment */
+static void findModuleChunks(const char* data, size_t size,
+                             std::vector<size_t>& offsets,
+                             std::vector<ANTLR3_UINT32>& lines)
+{
+    static const char keyword[] = "MODULE";
+    static const size_t len { sizeof(keyword) - 1 };
+
+    offsets.push_back(0);
+    lines.push_back(1);
+
+    bool first { true };
+    ANTLR3_UINT32 line { 1 };
+    for (size_t pos = 0; pos < size; ) {
+        size_t begin { pos };
+
+        while (pos < size && (' ' == data[pos] || '\t' == data[pos]))
+            ++ pos;
+
+        if (pos + len < size && 0 == memcmp(data + pos, keyword, len) &&
+            isspace((unsigned char) data[pos + len])) {
+
+            /* the first module belongs to the first chunk */
+            if (first)
+                first = false;
+            else {
+                offsets.push_back(begin);
+                lines.push_back(line);
+            }
+        }
+
+        const void* eol { memchr(data + pos, '\n', size - pos) };
+        if (!eol)
+            break;
+
+        pos = 1 + ((const char*) eol - data);
+        ++ line;
+    }
+}
+
 static void yasmvdisplayRecognitionError (pANTLR3_BASE_RECOGNIZER recognizer,
                                           pANTLR3_UINT8 * tokenNames)
 {
@@ -245,7 +536,7 @@ static void yasmvdisplayRecognitionError (pANTLR3_BASE_RECOGNIZER recognizer,
 
         if (0 <= recognizer->state->exception->charPositionInLine) {
             std::cerr << " in line "
-                      << recognizer->state->exception->line
+                      << lineOffset + recognizer->state->exception->line
                       << ", offset "
                       << recognizer->state->exception->charPositionInLine ;
         }
@@ -257,9 +548,15 @@ static void yasmvdisplayRecognitionError (pANTLR3_BASE_RECOGNIZER recognizer,
     parseErrors = true;
 }
 
-static void reportParserStatus(bool parseErrors, timespec start, timespec stop)
+static void reportParserStatus(bool parseErrors, timespec start, timespec stop,
+                               size_t nbytes)
 {
     const std::string elapsed { utils::elapsed_repr(start, stop) };
+
+    double secs { (double) (stop.tv_sec - start.tv_sec) +
+                  (double) (stop.tv_nsec - start.tv_nsec) / 1e9 };
+    double mbs { 0 < secs ? (double) nbytes / (1 << 20) / secs : 0 };
+
     if (parseErrors)
         DEBUG
             << "Parser terminated with errors in "
@@ -270,7 +567,11 @@ static void reportParserStatus(bool parseErrors, timespec start, timespec stop)
         DEBUG
             << "Parser terminated successfully in "
             << elapsed
-            << "."
+            << " ("
+            << nbytes
+            << " bytes, "
+            << mbs
+            << " MB/s)."
             << std::endl;
 }
 
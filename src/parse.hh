@@ -24,12 +24,18 @@
 #ifndef PARSE_HH
 #define PARSE_HH
 
+#include <string>
+#include <vector>
+
 #include <cmd/command.hh>
 #include <expr/expr.hh>
+#include <model/model.hh>
 #include <type/type.hh>
 
 namespace parse {
     bool parseFile(const char* fName);
+    bool parseFiles(const std::vector<std::string>& fNames);
+    bool parseFileInto(const char* fName, model::Model& target);
     cmd::CommandVector_ptr parseCommand(const char *command_line);
     expr::Expr_ptr parseExpression(const char *string);
     type::Type_ptr parseTypedef(const char *string);
@@ -63,6 +63,15 @@ options {
         (mm.model());
 }
 
+@parser::context {
+    /* where parsed modules go, each parser has its own */
+    model::Model* target_model;
+}
+
+@parser::apifuncs {
+    ctx->target_model = &smv_model;
+}
+
 // --- Model Description Language  ---------------------------------------------
 smv
 scope {
@@ -90,7 +99,7 @@ modules
 
 module_def
     : 'MODULE' module_id=identifier
-      { smv_model.add_module(* ($smv::current_module = new model::Module(module_id))); }
+      { ctx->target_model->add_module(* ($smv::current_module = new model::Module(module_id))); }
 
       fsm_param_decl? module_body ';'
     ;
@@ -970,14 +979,31 @@ command_line returns [cmd::CommandVector_ptr res]
 
 commands [cmd::CommandVector_ptr cmds]
     :
-        c=command
+        c=job_command
         { cmds->push_back(c); }
 
         (
-            ';' c=command
+            ';' c=job_command
             { cmds->push_back(c); }
         )* ;
 
+/* `<command> &` runs command in the background */
+job_command returns [cmd::Command_ptr res]
+@init {
+    pANTLR3_COMMON_TOKEN first { LT(1) };
+    pANTLR3_COMMON_TOKEN last { NULL };
+}
+    :  c=command
+       { $res = c; last = LT(-1); }
+
+       ( '&'
+         {
+             pANTLR3_STRING descr { INPUT->toStringTT(INPUT, first, last) };
+             $res = cm.make_background(c, (pconst_char) descr->chars);
+         }
+       )?
+    ;
+
 command_topic returns [cmd::CommandTopic_ptr res]
     :  c=check_command_topic
        { $res = c; }
@@ -997,6 +1023,9 @@ command_topic returns [cmd::CommandTopic_ptr res]
     |  c=do_command_topic
        { $res = c; }
 
+    |  c=parallel_command_topic
+       { $res = c; }
+
     |  c=dump_model_command_topic
         { $res = c; }
 
@@ -1006,6 +1035,15 @@ command_topic returns [cmd::CommandTopic_ptr res]
     |  c=dup_trace_command_topic
         { $res = c; }
 
+    |  c=diff_traces_command_topic
+        { $res = c; }
+
+    |  c=find_in_trace_command_topic
+        { $res = c; }
+
+    |  c=validate_trace_command_topic
+        { $res = c; }
+
     |  c=echo_command_topic
        { $res = c; }
 
@@ -1039,15 +1077,45 @@ command_topic returns [cmd::CommandTopic_ptr res]
     |  c=reach_command_topic
        { $res = c; }
 
+    |  c=optimize_command_topic
+       { $res = c; }
+
+    |  c=equiv_command_topic
+       { $res = c; }
+
     | c=select_trace_topic
       { $res = c; }
 
+    |  c=jobs_command_topic
+       { $res = c; }
+
+    |  c=wait_command_topic
+       { $res = c; }
+
+    |  c=kill_command_topic
+       { $res = c; }
+
     |  c=set_command_topic
        { $res = c; }
 
     |  c=simulate_command_topic
        { $res = c; }
 
+    |  c=stats_command_topic
+       { $res = c; }
+
+    |  c=compile_stats_command_topic
+       { $res = c; }
+
+    |  c=dd_stats_command_topic
+       { $res = c; }
+
+    |  c=mem_stats_command_topic
+       { $res = c; }
+
+    |  c=gc_command_topic
+       { $res = c; }
+
     |  c=time_command_topic
        { $res = c; }
     ;
@@ -1071,6 +1139,9 @@ command returns [cmd::Command_ptr res]
     |  c=do_command
        { $res = c; }
 
+    |  c=parallel_command
+       { $res = c; }
+
     |  c=dump_model_command
         { $res = c; }
 
@@ -1080,6 +1151,15 @@ command returns [cmd::Command_ptr res]
     |  c=dup_trace_command
         { $res = c; }
 
+    |  c=diff_traces_command
+        { $res = c; }
+
+    |  c=find_in_trace_command
+        { $res = c; }
+
+    |  c=validate_trace_command
+        { $res = c; }
+
     |  c=echo_command
        { $res = c; }
 
@@ -1113,15 +1193,45 @@ command returns [cmd::Command_ptr res]
     |  c=reach_command
        { $res = c; }
 
+    |  c=optimize_command
+       { $res = c; }
+
+    |  c=equiv_command
+       { $res = c; }
+
     |  c=select_trace_command
        { $res = c; }
 
+    |  c=jobs_command
+       { $res = c; }
+
+    |  c=wait_command
+       { $res = c; }
+
+    |  c=kill_command
+       { $res = c; }
+
     |  c=set_command
        { $res = c; }
 
     |  c=simulate_command
        { $res = c; }
 
+    |  c=stats_command
+       { $res = c; }
+
+    |  c=compile_stats_command
+       { $res = c; }
+
+    |  c=dd_stats_command
+       { $res = c; }
+
+    |  c=mem_stats_command
+       { $res = c; }
+
+    |  c=gc_command
+       { $res = c; }
+
     |  c=time_command
        { $res = c; }
     ;
@@ -1152,6 +1262,24 @@ do_command_topic returns [cmd::CommandTopic_ptr res]
        { $res = cm.topic_do(); }
     ;
 
+parallel_command returns [cmd::Command_ptr res]
+    : 'parallel'
+      { $res = cm.make_parallel(); }
+
+      ( '-j' jobs=constant
+        { ((cmd::Parallel_ptr) $res)->set_jobs(jobs->value()); }
+      )?
+
+      (
+            subcommand = command ';'
+            { ((cmd::Parallel_ptr) res)->add_command(subcommand); }
+      )+ ;
+
+parallel_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'parallel'
+       { $res = cm.topic_parallel(); }
+    ;
+
 echo_command returns [cmd::Command_ptr res]
 @init {
     expr::ExprVector ev;
@@ -1196,9 +1324,109 @@ on_command_topic returns [cmd::CommandTopic_ptr res]
         { $res = cm.topic_on(); }
     ;
 
+stats_command returns [cmd::Command_ptr res]
+    : 'stats'
+      { $res = cm.make_stats(); }
+
+    (
+      '-c'
+      { ((cmd::Stats_ptr) $res)->set_clear(true); }
+    |
+      '-f' format=pcchar_identifier
+      { ((cmd::Stats_ptr) $res)->set_format(format); }
+
+    | '-o' output=pcchar_quoted_string
+      { ((cmd::Stats_ptr) $res)->set_output(output); }
+    )*
+    ;
+
+stats_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'stats'
+      { $res = cm.topic_stats(); }
+    ;
+
+compile_stats_command returns [cmd::Command_ptr res]
+    : 'compile-stats'
+      { $res = cm.make_compile_stats(); }
+
+    (
+      '-c'
+      { ((cmd::CompileStats_ptr) $res)->set_clear(true); }
+    |
+      '-f' format=pcchar_identifier
+      { ((cmd::CompileStats_ptr) $res)->set_format(format); }
+
+    | '-o' output=pcchar_quoted_string
+      { ((cmd::CompileStats_ptr) $res)->set_output(output); }
+
+    | '-n' top=constant
+      { ((cmd::CompileStats_ptr) $res)->set_top(top->value()); }
+    )*
+    ;
+
+compile_stats_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'compile-stats'
+      { $res = cm.topic_compile_stats(); }
+    ;
+
+dd_stats_command returns [cmd::Command_ptr res]
+    : 'dd-stats'
+      { $res = cm.make_dd_stats(); }
+
+    (
+      '-f' format=pcchar_identifier
+      { ((cmd::DDStats_ptr) $res)->set_format(format); }
+
+    | '-o' output=pcchar_quoted_string
+      { ((cmd::DDStats_ptr) $res)->set_output(output); }
+    )*
+    ;
+
+dd_stats_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'dd-stats'
+      { $res = cm.topic_dd_stats(); }
+    ;
+
+mem_stats_command returns [cmd::Command_ptr res]
+    : 'mem-stats'
+      { $res = cm.make_mem_stats(); }
+
+    (
+      '-f' format=pcchar_identifier
+      { ((cmd::MemStats_ptr) $res)->set_format(format); }
+
+    | '-o' output=pcchar_quoted_string
+      { ((cmd::MemStats_ptr) $res)->set_output(output); }
+    )*
+    ;
+
+mem_stats_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'mem-stats'
+      { $res = cm.topic_mem_stats(); }
+    ;
+
+gc_command returns [cmd::Command_ptr res]
+    : 'gc'
+      { $res = cm.make_gc(); }
+
+    (
+      '-s'
+      { ((cmd::GC_ptr) $res)->set_stats(true); }
+    )?
+    ;
+
+gc_command_topic returns [cmd::CommandTopic_ptr res]
+    : 'gc'
+      { $res = cm.topic_gc(); }
+    ;
+
 time_command returns [cmd::Command_ptr res]
     : 'time'
       { $res = cm.make_time(); }
+
+      ( c=command
+        { ((cmd::Time_ptr) $res)->set_command(c); }
+      )?
     ;
 
 time_command_topic returns [cmd::CommandTopic_ptr res]
@@ -1210,9 +1438,17 @@ read_model_command returns [cmd::Command_ptr res]
     :  'read-model'
         { $res = cm.make_read_model(); }
 
-        ( input=pcchar_quoted_string {
-            ((cmd::ReadModel_ptr) $res)->set_input(input);
+        ( '--binary' {
+            ((cmd::ReadModel_ptr) $res)->select_binary();
+        }
+
+        | '--aiger' {
+            ((cmd::ReadModel_ptr) $res)->select_aiger();
         }) ?
+
+        ( input=pcchar_quoted_string {
+            ((cmd::ReadModel_ptr) $res)->add_input(input);
+        }) *
     ;
 
 read_model_command_topic returns [cmd::CommandTopic_ptr res]
@@ -1224,6 +1460,10 @@ read_trace_command returns [cmd::Command_ptr res]
     :  'read-trace'
         { $res = cm.make_read_trace(); }
 
+        ( '-j' jobs=constant
+          { ((cmd::ReadTrace_ptr) $res)->set_jobs(jobs->value()); }
+        )?
+
         ( input=pcchar_quoted_string {
             ((cmd::ReadTrace_ptr) $res)->set_input(input);
         }) ?
@@ -1242,6 +1482,16 @@ dump_model_command returns [cmd::Command_ptr res]
             ((cmd::DumpModel_ptr) $res)->set_output(output);
         }
 
+        | '--binary' { ((cmd::DumpModel_ptr) $res)->select_binary(); }
+
+        | '--aiger' { ((cmd::DumpModel_ptr) $res)->select_aiger(); }
+
+        | '--btor2' { ((cmd::DumpModel_ptr) $res)->select_btor2(); }
+
+        | '-t' target=toplevel_expression {
+            ((cmd::DumpModel_ptr) $res)->set_target(target);
+        }
+
         | '-s' ('state' { ((cmd::DumpModel_ptr) $res)->select_state(); }
         |       'init'  { ((cmd::DumpModel_ptr) $res)->select_init();  }
         |       'trans' { ((cmd::DumpModel_ptr) $res)->select_trans(); })
@@ -1261,7 +1511,13 @@ check_command returns[cmd::Command_ptr res]
       { ((cmd::Check_ptr) $res)->set_property(property); }
 
       ( '-c' constraint=temporal_expression
-      { ((cmd::Check_ptr) $res)->add_constraint(constraint); })*
+      { ((cmd::Check_ptr) $res)->add_constraint(constraint); }
+
+      | '-a' other=temporal_expression
+      { ((cmd::Check_ptr) $res)->add_property(other); }
+
+      | '-k' depth=constant
+      { ((cmd::Check_ptr) $res)->set_max_depth(depth->value()); })*
     ;
 
 check_command_topic returns[cmd::CommandTopic_ptr res]
@@ -1285,6 +1541,8 @@ check_init_command_topic returns [cmd::CommandTopic_ptr res]
 diameter_command returns[cmd::Command_ptr res]
     : 'diameter'
       { $res = cm.make_diameter(); }
+
+      ( resource_limit[$res] )*
     ;
 
 diameter_command_topic returns [cmd::CommandTopic_ptr res]
@@ -1301,8 +1559,53 @@ reach_command returns[cmd::Command_ptr res]
 
         ( '-q'
             { ((cmd::Reach_ptr) $res)->go_quiet(); }
+
+        | '--pdr'
+            { ((cmd::Reach_ptr) $res)->use_pdr(); }
+
+        | '--stride' stride=constant
+            { ((cmd::Reach_ptr) $res)->set_stride(stride->value()); }
+
+        | '--geometric'
+            { ((cmd::Reach_ptr) $res)->use_geometric_stride(); }
+
+        | '--session'
+            { ((cmd::Reach_ptr) $res)->use_session(); }
+
+        | '--mem'
+            { ((cmd::Reach_ptr) $res)->track_memory(); }
+
+        | '--seed' seed_id=pcchar_identifier
+            { ((cmd::Reach_ptr) $res)->set_phase_seed(seed_id); }
+
+        | '--from-trace' origin_id=pcchar_identifier
+            { ((cmd::Reach_ptr) $res)->set_origin(origin_id); }
+
+        | '--at' origin_time=constant
+            { ((cmd::Reach_ptr) $res)->set_origin_time(origin_time->value()); }
+
+        | '--shorten'
+            { ((cmd::Reach_ptr) $res)->use_shortening(); }
+
+        | '--minimize'
+            { ((cmd::Reach_ptr) $res)->use_minimization(); }
+
+        | '--checkpoint' checkpoint_path=pcchar_quoted_string
+            { ((cmd::Reach_ptr) $res)->set_checkpoint(checkpoint_path); }
+
+        | '--resume' resume_path=pcchar_quoted_string
+            { ((cmd::Reach_ptr) $res)->set_resume(resume_path); }
+
+        | '-a' other=toplevel_expression
+            { ((cmd::Reach_ptr) $res)->add_target(other); }
         )*
 
+        ( '-d' dirname=pcchar_quoted_string
+            { ((cmd::Reach_ptr) $res)->set_cnf_trace_path(dirname); }
+        )?
+
+        ( resource_limit[$res] )*
+
         ( '-c' constraint=toplevel_expression
           { ((cmd::Reach_ptr) $res)->add_constraint(constraint); }
         )*
@@ -1313,6 +1616,52 @@ reach_command_topic returns [cmd::CommandTopic_ptr res]
         { $res = cm.topic_reach(); }
     ;
 
+optimize_command returns[cmd::Command_ptr res]
+    :   'optimize'
+        { $res = cm.make_optimize(); }
+
+        target=toplevel_expression
+        { ((cmd::Optimize_ptr) $res)->set_target(target); }
+
+        '--cost' cost=toplevel_expression
+        { ((cmd::Optimize_ptr) $res)->set_cost(cost); }
+
+        ( '--binary'
+            { ((cmd::Optimize_ptr) $res)->use_binary_search(); }
+
+        | resource_limit[$res]
+        )*
+
+        ( '-c' constraint=toplevel_expression
+          { ((cmd::Optimize_ptr) $res)->add_constraint(constraint); }
+        )*
+    ;
+
+optimize_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'optimize'
+        { $res = cm.topic_optimize(); }
+    ;
+
+equiv_command returns[cmd::Command_ptr res]
+    :   'equiv'
+        { $res = cm.make_equiv(); }
+
+        ( '-o' output=identifier
+          { ((cmd::Equiv_ptr) $res)->add_output(output); }
+        )*
+
+        old_rev=pcchar_quoted_string
+        { ((cmd::Equiv_ptr) $res)->add_input(old_rev); }
+
+        new_rev=pcchar_quoted_string
+        { ((cmd::Equiv_ptr) $res)->add_input(new_rev); }
+    ;
+
+equiv_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'equiv'
+        { $res = cm.topic_equiv(); }
+    ;
+
 select_trace_command returns[cmd::Command_ptr res]
     :   'select-trace'
         { $res = cm.make_select_trace(); }
@@ -1326,6 +1675,43 @@ select_trace_topic returns [cmd::CommandTopic_ptr res]
        { $res = cm.topic_select_trace(); }
     ;
 
+jobs_command returns [cmd::Command_ptr res]
+    :  'jobs'
+       { $res = cm.make_jobs(); }
+    ;
+
+jobs_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'jobs'
+       { $res = cm.topic_jobs(); }
+    ;
+
+wait_command returns [cmd::Command_ptr res]
+    :  'wait'
+       { $res = cm.make_wait(); }
+
+       ( id=constant
+         { ((cmd::Wait_ptr) $res)->set_job_id(id->value()); }
+       )?
+    ;
+
+wait_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'wait'
+       { $res = cm.topic_wait(); }
+    ;
+
+kill_command returns [cmd::Command_ptr res]
+    :  'kill'
+       { $res = cm.make_kill(); }
+
+       id=constant
+       { ((cmd::Kill_ptr) $res)->set_job_id(id->value()); }
+    ;
+
+kill_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'kill'
+       { $res = cm.topic_kill(); }
+    ;
+
 check_trans_command returns[cmd::Command_ptr res]
     : 'check-trans'
       { $res = cm.make_check_trans(); }
@@ -1392,6 +1778,61 @@ dup_trace_command_topic returns [cmd::CommandTopic_ptr res]
         { $res = cm.topic_dup_trace(); }
     ;
 
+diff_traces_command returns [cmd::Command_ptr res]
+    : 'diff-traces'
+      { $res = cm.make_diff_traces(); }
+
+      trace_id=pcchar_identifier
+      { ((cmd::DiffTraces_ptr) $res)->set_trace_id(trace_id); }
+
+      ( other_id=pcchar_identifier
+        { ((cmd::DiffTraces_ptr) $res)->set_other_id(other_id); } )?
+    ;
+
+diff_traces_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'diff-traces'
+        { $res = cm.topic_diff_traces(); }
+    ;
+
+find_in_trace_command returns [cmd::Command_ptr res]
+    : 'find-in-trace'
+      { $res = cm.make_find_in_trace(); }
+
+    (
+         '-a'
+         { ((cmd::FindInTrace_ptr) $res)->set_all(true); }
+
+    |    '-t' trace_id=pcchar_identifier
+         { ((cmd::FindInTrace_ptr) $res)->set_trace_id(trace_id); }
+    )*
+
+      predicate=toplevel_expression
+      { ((cmd::FindInTrace_ptr) $res)->set_predicate(predicate); }
+    ;
+
+find_in_trace_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'find-in-trace'
+        { $res = cm.topic_find_in_trace(); }
+    ;
+
+validate_trace_command returns [cmd::Command_ptr res]
+    : 'validate-trace'
+      { $res = cm.make_validate_trace(); }
+
+    (
+         '-t' trace_id=pcchar_identifier
+         { ((cmd::ValidateTrace_ptr) $res)->set_trace_id(trace_id); }
+
+    |    '-j' jobs=constant
+         { ((cmd::ValidateTrace_ptr) $res)->set_jobs(jobs->value()); }
+    )*
+    ;
+
+validate_trace_command_topic returns [cmd::CommandTopic_ptr res]
+    :  'validate-trace'
+        { $res = cm.topic_validate_trace(); }
+    ;
+
 pick_state_command returns [cmd::Command_ptr res]
     :   'pick-state'
         { $res = cm.make_pick_state(); }
@@ -1407,6 +1848,23 @@ pick_state_command returns [cmd::Command_ptr res]
 
     |    '-c' constraint=toplevel_expression
          { ((cmd::PickState_ptr) $res)->add_constraint(constraint); }
+
+    |    '-p' var=toplevel_expression
+         { ((cmd::PickState_ptr) $res)->add_projection(var); }
+
+    |    '-j' jobs=constant
+         { ((cmd::PickState_ptr) $res)->set_jobs(jobs->value()); }
+
+    |    '--sample' samples=constant
+         { ((cmd::PickState_ptr) $res)->set_samples(samples->value()); }
+
+    |    '--approx'
+         { ((cmd::PickState_ptr) $res)->set_approx(true); }
+
+    |    '--sets' sets=pcchar_quoted_string
+         { ((cmd::PickState_ptr) $res)->set_sets(sets); }
+
+    |    resource_limit[$res]
     )* ;
 
 pick_state_command_topic returns [cmd::CommandTopic_ptr res]
@@ -1429,6 +1887,20 @@ simulate_command returns [cmd::Command_ptr res]
 
     |   '-t' trace_id=pcchar_identifier
         { ((cmd::Simulate_ptr) $res)->set_trace_uid(trace_id); }
+
+    |   '--inputs' inputs=pcchar_quoted_string
+        { ((cmd::Simulate_ptr) $res)->set_inputs(inputs); }
+
+    |   '-r'
+        { ((cmd::Simulate_ptr) $res)->set_random(true); }
+
+    |   '-l'
+        { ((cmd::Simulate_ptr) $res)->set_lanes(true); }
+
+    |   '-s' period=constant
+        { ((cmd::Simulate_ptr) $res)->set_period(period->value()); }
+
+    |   resource_limit[$res]
     )* ;
 
 simulate_command_topic returns [cmd::CommandTopic_ptr res]
@@ -1436,6 +1908,17 @@ simulate_command_topic returns [cmd::CommandTopic_ptr res]
         { $res = cm.topic_simulate(); }
     ;
 
+resource_limit [cmd::Command_ptr cmd]
+    :   '--timeout' secs=constant
+        { cmd->set_timeout(secs->value()); }
+
+    |   '--conflicts' conflicts=constant
+        { cmd->set_conflicts(conflicts->value()); }
+
+    |   '--max-memory' megs=constant
+        { cmd->set_max_memory(megs->value()); }
+    ;
+
 get_command returns [cmd::Command_ptr res]
     : 'get'
       { $res = cm.make_get(); }
@@ -0,0 +1,406 @@
+/**
+ * @file sat/backend.cc
+ * @brief SAT interface, solver backend implementation.
+ *
+ * This module contains the Minisat implementations of the solver
+ * backend interface. `minisat` is the default, with SatELite-style
+ * preprocessing; `minisat-core` runs plain CDCL search, which is
+ * often faster on incremental BMC instances where most of the
+ * variables are frozen anyway.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstring>
+
+#include <sat/backend.hh>
+#include <sat/exceptions.hh>
+
+#include <algorithm>
+
+namespace sat {
+
+    /* learnts kept under a memory limit, at least */
+    static const double MIN_LEARNTS { 1000 };
+
+    /* solver internals (trail, learnts) are protected in Minisat */
+    class SharingSolver: public SimpSolver {
+    public:
+        SharingSolver()
+            : f_learntsize_factor(learntsize_factor)
+            , f_learntsize_inc(learntsize_inc)
+        {}
+
+        /* simplify() waits for enough propagations since the last
+           time, satisfied clauses are dropped right away here */
+        bool drop_satisfied()
+        {
+            simpDB_props = 0;
+            return simplify();
+        }
+
+        /* The learnts limit is set by solve() from learntsize_factor,
+         * and grows by learntsize_inc as the search goes. When the
+         * defaults allow more learnts than fit in max_bytes along with
+         * the problem clauses (by their average size so far), the
+         * limit is what fits and stays there. A search growing beyond
+         * max_bytes anyway is reduced before the next one. */
+        void limit_learnts(uint64_t max_bytes)
+        {
+            learntsize_factor = f_learntsize_factor;
+            learntsize_inc = f_learntsize_inc;
+
+            if (0 == max_bytes || 0 == nClauses()) {
+                return;
+            }
+
+            double budget { (double) max_bytes / sizeof(uint32_t) };
+            if (budget < ca.size() && 0 < learnts.size()) {
+                reduceDB();
+                checkGarbage(0);
+            }
+
+            /* a header word for each clause, and an activity for
+               each learnt */
+            double learnt_words { (double) learnts_literals + 2.0 * nLearnts() };
+            double problem_words { (double) (ca.size() - ca.wasted()) - learnt_words };
+            double avg_words { 0 < nLearnts() ? learnt_words / nLearnts() : 2.0 };
+            double room { std::max(MIN_LEARNTS, (budget - problem_words) / avg_words) };
+
+            if (room < f_learntsize_factor * nClauses()) {
+                learntsize_factor = room / nClauses();
+                learntsize_inc = 1.0;
+            }
+        }
+
+        /* priorities are initial activities, in units of the current
+           bump: conflicts overtake them soon enough */
+        void set_priority(Var var, double priority)
+        {
+            activity[var] = std::max(activity[var], priority * var_inc);
+            if (order_heap.inHeap(var)) {
+                order_heap.decrease(var);
+            }
+        }
+
+        /* clauses live in the clause allocator's region, made of
+           32-bit words, freed ones included until collected */
+        inline uint64_t clause_db_bytes() const
+        {
+            return static_cast<uint64_t>(ca.size()) * sizeof(uint32_t);
+        }
+
+        void export_learnts(unsigned max_size, LitsVector& out)
+        {
+            if (!okay()) {
+                return;
+            }
+
+            /* solve() always backtracks to the root level, the whole
+               trail is made of root level units */
+            for (int i = 0; i < trail.size(); ++i) {
+                out.push_back(Lits(1, trail[i]));
+            }
+
+            for (int i = 0; i < learnts.size(); ++i) {
+                const Minisat::Clause& c { ca[learnts[i]] };
+
+                if (static_cast<unsigned>(c.size()) <= max_size) {
+                    Lits lits;
+                    for (int j = 0; j < c.size(); ++j) {
+                        lits.push_back(c[j]);
+                    }
+
+                    out.push_back(lits);
+                }
+            }
+        }
+
+    private:
+        /* the defaults, restored when there is room */
+        const double f_learntsize_factor;
+        const double f_learntsize_inc;
+    };
+
+    class MinisatBackend: public SolverBackend {
+    public:
+        MinisatBackend(const char* name, bool simplify)
+            : f_name(name)
+            , f_simplify(simplify)
+            , f_max_bytes(0)
+        {
+            /* Default configuration */
+            f_solver.random_var_freq = .1;
+            // f_solver.ccmin_mode = 0;
+            // f_solver.phase_saving = 0;
+            f_solver.rnd_init_act = true;
+            f_solver.garbage_frac = 0.50;
+
+            if (!f_simplify) {
+                f_solver.use_elim = false;
+
+                /* preprocessing off for good, satisfied problem
+                   clauses can then be removed as well (the
+                   preprocessor's occurrence lists refer to them) */
+                f_solver.eliminate(true);
+            }
+        }
+
+        const char* name() const
+        {
+            return f_name;
+        }
+
+        Var new_var(bool frozen)
+        {
+            Var var(f_solver.newVar());
+
+            f_solver.setFrozen(var, frozen);
+
+            return var;
+        }
+
+        void freeze(Var var, bool frozen)
+        {
+            f_solver.setFrozen(var, frozen);
+        }
+
+        void add_clause(vec<Lit>& ps)
+        {
+            f_solver.addClause_(ps);
+        }
+
+        unsigned eliminate()
+        {
+            if (!f_simplify) {
+                return 0;
+            }
+
+            int eliminated { f_solver.eliminated_vars };
+            f_solver.eliminate(false);
+
+            return f_solver.eliminated_vars - eliminated;
+        }
+
+        bool is_eliminated(Var var) const
+        {
+            return f_simplify && f_solver.isEliminated(var);
+        }
+
+        void simplify()
+        {
+            f_solver.drop_satisfied();
+        }
+
+        void limit_memory(uint64_t max_bytes)
+        {
+            f_max_bytes = max_bytes;
+        }
+
+        status_t solve(const vec<Lit>& assumptions)
+        {
+            f_solver.limit_learnts(f_max_bytes);
+
+            Minisat::lbool status { f_solver.solveLimited(assumptions, f_simplify) };
+
+            if (status == l_True) {
+                return STATUS_SAT;
+            } else if (status == l_False) {
+                return STATUS_UNSAT;
+            }
+
+            assert(status == l_Undef);
+            return STATUS_UNKNOWN;
+        }
+
+        bool failed(Lit assumption)
+        {
+            /* the conflict holds the negation of failed assumptions */
+            for (int i = 0; i < f_solver.conflict.size(); ++i) {
+                if (f_solver.conflict[i] == ~assumption) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        int value(Var var)
+        {
+            return 0 == Minisat::toInt(f_solver.modelValue(var));
+        }
+
+        void interrupt()
+        {
+            f_solver.interrupt();
+        }
+
+        void clear_interrupt()
+        {
+            f_solver.clearInterrupt();
+        }
+
+        void tune(const SolverConfig& config)
+        {
+            if (0 < config.random_seed) {
+                f_solver.random_seed = config.random_seed;
+            }
+            if (0 <= config.random_var_freq) {
+                f_solver.random_var_freq = config.random_var_freq;
+            }
+            if (0 <= config.luby_restart) {
+                f_solver.luby_restart = (0 != config.luby_restart);
+            }
+            if (0 <= config.phase_saving) {
+                f_solver.phase_saving = config.phase_saving;
+            }
+            if (0 <= config.ccmin_mode) {
+                f_solver.ccmin_mode = config.ccmin_mode;
+            }
+        }
+
+        void set_phase(Var var, bool value)
+        {
+            /* Minisat decides the negative literal of vars whose user
+               polarity is l_True */
+            f_solver.setPolarity(var, value ? l_False : l_True);
+        }
+
+        void set_priority(Var var, double priority)
+        {
+            f_solver.set_priority(var, priority);
+        }
+
+        void export_learnts(unsigned max_size, LitsVector& out)
+        {
+            f_solver.export_learnts(max_size, out);
+        }
+
+        void configure(int64_t conf_budget, int64_t prop_budget)
+        {
+            /* negative budgets mean no budget, also for engines that
+               have already been solving */
+            f_solver.budgetOff();
+            if (0 <= conf_budget) {
+                f_solver.setConfBudget(conf_budget);
+            }
+            if (0 <= prop_budget) {
+                f_solver.setPropBudget(prop_budget);
+            }
+        }
+
+        void print_stats(std::ostream& os) const
+        {
+            os
+                << "solves: "
+                << f_solver.solves
+
+                << ", starts: "
+                << f_solver.starts
+
+                << ", decs: "
+                << f_solver.decisions
+
+                << ", rnd decs: "
+                << f_solver.rnd_decisions
+
+                << ", props: "
+                << f_solver.propagations
+
+                << ", conflicts: "
+                << f_solver.conflicts
+
+                << ", dec vars: "
+                << f_solver.dec_vars
+
+                << ", clause lits: "
+                << f_solver.clauses_literals
+
+                << ", learnt lits: "
+                << f_solver.learnts_literals
+
+                << ", max lits: "
+                << f_solver.max_literals
+
+                << ", tot lits: "
+                << f_solver.tot_literals;
+        }
+
+        void counters(SolverCounters& counters) const
+        {
+            counters.vars = f_solver.nVars();
+            counters.clauses = f_solver.nClauses();
+            counters.learnts = f_solver.nLearnts();
+            counters.conflicts = f_solver.conflicts;
+            counters.propagations = f_solver.propagations;
+            counters.decisions = f_solver.decisions;
+            counters.eliminated = f_solver.eliminated_vars;
+            counters.memory = f_solver.clause_db_bytes();
+        }
+
+    private:
+        const char* f_name;
+        bool f_simplify;
+        uint64_t f_max_bytes;
+
+        SharingSolver f_solver;
+    };
+
+    static SolverBackend_ptr make_minisat()
+    {
+        return new MinisatBackend("minisat", true);
+    }
+
+    static SolverBackend_ptr make_minisat_core()
+    {
+        return new MinisatBackend("minisat-core", false);
+    }
+
+    /* known backends, new backends are registered here */
+    static const struct {
+        const char* name;
+        SolverBackend_ptr (*factory)();
+    } SOLVER_BACKENDS[] = {
+        { "minisat", make_minisat },
+        { "minisat-core", make_minisat_core },
+    };
+
+    bool is_solver_backend(const std::string& name)
+    {
+        for (const auto& entry : SOLVER_BACKENDS) {
+            if (!strcmp(entry.name, name.c_str())) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    SolverBackend_ptr make_solver_backend(const std::string& name)
+    {
+        for (const auto& entry : SOLVER_BACKENDS) {
+            if (!strcmp(entry.name, name.c_str())) {
+                return entry.factory();
+            }
+        }
+
+        throw UnknownSolverBackend(name);
+    }
+
+}; // namespace sat
@@ -0,0 +1,126 @@
+/**
+ * @file sat/backend.hh
+ * @brief SAT interface, solver backend declaration.
+ *
+ * This module contains the declaration of the abstract solver backend
+ * used by sat::Engine. The interface follows IPASIR closely: add
+ * clauses, assume, solve, fetch values, interrupt. Variables and
+ * literals keep the Minisat encoding used throughout this package.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_BACKEND_H
+#define SAT_BACKEND_H
+
+#include <iostream>
+#include <string>
+
+#include <sat/portfolio.hh>
+#include <sat/stats.hh>
+#include <sat/typedefs.hh>
+
+namespace sat {
+
+    class SolverBackend;
+    typedef SolverBackend* SolverBackend_ptr;
+
+    class SolverBackend {
+    public:
+        virtual ~SolverBackend()
+        {}
+
+        /* backend name, as used for selection */
+        virtual const char* name() const = 0;
+
+        /* a new variable, frozen variables are not eliminated by
+         * preprocessing (if any) */
+        virtual Var new_var(bool frozen = false) = 0;
+        virtual void freeze(Var var, bool frozen = true) = 0;
+
+        /* add a clause, the clause vector may be modified */
+        virtual void add_clause(vec<Lit>& ps) = 0;
+
+        /* variable elimination on all the vars that are not frozen,
+         * returns the number of vars eliminated by this call. A var
+         * can not be used in new clauses once eliminated, model
+         * values are still available for it */
+        virtual unsigned eliminate() = 0;
+        virtual bool is_eliminated(Var var) const = 0;
+
+        /* clauses satisfied at the root level (e.g. those of retired
+         * groups) are dropped, and their memory reclaimed */
+        virtual void simplify() = 0;
+
+        /* learnt clauses are reduced to keep the clause database
+         * within max_bytes (0 for no limit), problem clauses are
+         * always kept. A hint, backends that take none ignore it */
+        virtual void limit_memory(uint64_t max_bytes) = 0;
+
+        /* solve under assumptions */
+        virtual status_t solve(const vec<Lit>& assumptions) = 0;
+
+        /* true iff the assumption is part of the final conflict of
+         * the last UNSAT result */
+        virtual bool failed(Lit assumption) = 0;
+
+        /* model value for var, 1 iff true. Only meaningful after a
+         * SAT result */
+        virtual int value(Var var) = 0;
+
+        /* asynchronous interruption, safe to call from other threads */
+        virtual void interrupt() = 0;
+
+        /* interruptions are sticky, until cleared */
+        virtual void clear_interrupt() = 0;
+
+        /* search heuristics, fields set to defaults are ignored */
+        virtual void tune(const SolverConfig& config) = 0;
+
+        /* the value decisions on var try first, instead of the saved
+         * phase. A hint, backends that take none ignore it */
+        virtual void set_phase(Var var, bool value) = 0;
+
+        /* decisions pick vars of higher priority (in [0, 1]) first,
+         * until conflicts bump other vars past them. A hint, backends
+         * that take none ignore it */
+        virtual void set_priority(Var var, double priority) = 0;
+
+        /* root level units and learnt clauses of at most max_size
+         * literals, used for clause sharing. Backends that can not
+         * export learnts leave out untouched */
+        virtual void export_learnts(unsigned max_size, LitsVector& out) = 0;
+
+        /* resource budgets for the next solve() */
+        virtual void configure(int64_t conf_budget, int64_t prop_budget) = 0;
+
+        /* solver statistics */
+        virtual void print_stats(std::ostream& os) const = 0;
+        virtual void counters(SolverCounters& counters) const = 0;
+    };
+
+    /* backend factory, throws UnknownSolverBackend */
+    SolverBackend_ptr make_solver_backend(const std::string& name);
+
+    /* true iff name is a known backend */
+    bool is_solver_backend(const std::string& name);
+
+}; // namespace sat
+
+#endif /* SAT_BACKEND_H */
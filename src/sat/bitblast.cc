@@ -0,0 +1,533 @@
+/**
+ * @file sat/bitblast.cc
+ * @brief SAT interface, native operator bit-blasting implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sat/bitblast.hh>
+
+namespace sat {
+
+    /* Literals use the Minisat integer encoding (see
+       Minisat::toInt), the lowest bit is the sign. */
+    static inline int32_t neg(int32_t lit)
+    {
+        return lit ^ 1;
+    }
+
+    bool can_bitblast(const compiler::InlinedOperatorSignature& ios)
+    {
+        if (!compiler::ios_width(ios)) {
+            return false;
+        }
+
+        switch (compiler::ios_optype(ios)) {
+            case expr::ExprType::PLUS:
+            case expr::ExprType::SUB:
+            case expr::ExprType::EQ:
+            case expr::ExprType::NE:
+            case expr::ExprType::LT:
+            case expr::ExprType::LE:
+            case expr::ExprType::GT:
+            case expr::ExprType::GE:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    bool can_generate(const compiler::InlinedOperatorSignature& ios)
+    {
+        if (!compiler::ios_width(ios)) {
+            return false;
+        }
+
+        switch (compiler::ios_optype(ios)) {
+            case expr::ExprType::MUL:
+            case expr::ExprType::DIV:
+            case expr::ExprType::MOD:
+            case expr::ExprType::NEG:
+            case expr::ExprType::BW_NOT:
+            case expr::ExprType::BW_AND:
+            case expr::ExprType::BW_OR:
+            case expr::ExprType::BW_XOR:
+            case expr::ExprType::BW_XNOR:
+            case expr::ExprType::IMPLIES:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    void bitblast(const compiler::InlinedOperatorSignature& ios, Microcode& microcode)
+    {
+        assert(can_bitblast(ios) || can_generate(ios));
+
+        bool is_signed { compiler::ios_issigned(ios) };
+        BitBlaster bb { compiler::ios_width(ios) };
+
+        switch (compiler::ios_optype(ios)) {
+            case expr::ExprType::PLUS:
+                bb.adder(false);
+                break;
+
+            case expr::ExprType::SUB:
+                bb.adder(true);
+                break;
+
+            case expr::ExprType::EQ:
+                bb.equality(false);
+                break;
+
+            case expr::ExprType::NE:
+                bb.equality(true);
+                break;
+
+            /* x < y, x <= y */
+            case expr::ExprType::LT:
+                bb.comparator(is_signed, true, false);
+                break;
+
+            case expr::ExprType::LE:
+                bb.comparator(is_signed, false, false);
+                break;
+
+            /* x > y is y < x, x >= y is y <= x */
+            case expr::ExprType::GT:
+                bb.comparator(is_signed, true, true);
+                break;
+
+            case expr::ExprType::GE:
+                bb.comparator(is_signed, false, true);
+                break;
+
+            case expr::ExprType::MUL:
+                bb.multiplier();
+                break;
+
+            case expr::ExprType::DIV:
+                bb.divider(is_signed, false);
+                break;
+
+            case expr::ExprType::MOD:
+                bb.divider(is_signed, true);
+                break;
+
+            case expr::ExprType::NEG:
+                bb.negation();
+                break;
+
+            case expr::ExprType::BW_NOT:
+            case expr::ExprType::BW_AND:
+            case expr::ExprType::BW_OR:
+            case expr::ExprType::BW_XOR:
+            case expr::ExprType::BW_XNOR:
+            case expr::ExprType::IMPLIES:
+                bb.bitwise(compiler::ios_optype(ios));
+                break;
+
+            default:
+                assert(false); /* unreachable */
+        }
+
+        bb.flush(microcode);
+    }
+
+    BitBlaster::BitBlaster(unsigned width)
+        : f_width(width)
+        , f_next(3 * width)
+        , f_true(-1)
+    {
+        assert(0 < width);
+        f_offsets.push_back(0);
+    }
+
+    void BitBlaster::clause(std::initializer_list<int32_t> lits)
+    {
+        for (int32_t lit : lits) {
+            push(lit);
+        }
+
+        close();
+    }
+
+    void BitBlaster::gate_and(int32_t out, int32_t a, int32_t b)
+    {
+        clause({ neg(out), a });
+        clause({ neg(out), b });
+        clause({ out, neg(a), neg(b) });
+    }
+
+    void BitBlaster::gate_or(int32_t out, int32_t a, int32_t b)
+    {
+        clause({ out, neg(a) });
+        clause({ out, neg(b) });
+        clause({ neg(out), a, b });
+    }
+
+    void BitBlaster::gate_xor(int32_t out, int32_t a, int32_t b)
+    {
+        clause({ neg(out), a, b });
+        clause({ neg(out), neg(a), neg(b) });
+        clause({ out, neg(a), b });
+        clause({ out, a, neg(b) });
+    }
+
+    void BitBlaster::gate_xor3(int32_t out, int32_t a, int32_t b, int32_t c)
+    {
+        /* one clause for each assignment of the inputs, forcing the
+           output to their parity */
+        for (unsigned k = 0; k < 8; ++k) {
+            bool va { 0 != (k & 1) };
+            bool vb { 0 != (k & 2) };
+            bool vc { 0 != (k & 4) };
+
+            clause({ va ? neg(a) : a,
+                     vb ? neg(b) : b,
+                     vc ? neg(c) : c,
+                     (va ^ vb ^ vc) ? out : neg(out) });
+        }
+    }
+
+    void BitBlaster::gate_maj(int32_t out, int32_t a, int32_t b, int32_t c)
+    {
+        clause({ out, neg(a), neg(b) });
+        clause({ out, neg(a), neg(c) });
+        clause({ out, neg(b), neg(c) });
+        clause({ neg(out), a, b });
+        clause({ neg(out), a, c });
+        clause({ neg(out), b, c });
+    }
+
+    void BitBlaster::gate_ite(int32_t out, int32_t c, int32_t t, int32_t e)
+    {
+        clause({ neg(c), neg(t), out });
+        clause({ neg(c), t, neg(out) });
+        clause({ c, neg(e), out });
+        clause({ c, e, neg(out) });
+    }
+
+    int32_t BitBlaster::constant(bool value)
+    {
+        if (f_true < 0) {
+            f_true = fresh();
+            clause({ f_true });
+        }
+
+        return value ? f_true : neg(f_true);
+    }
+
+    BitBlaster::Bits BitBlaster::add(const Bits& a, const Bits& b, int32_t cin, int32_t* cout)
+    {
+        assert(a.size() == b.size());
+
+        Bits res;
+        int32_t carry { cin };
+        for (unsigned i = 0; i < a.size(); ++i) {
+            int32_t sum { fresh() };
+            gate_xor3(sum, a[i], b[i], carry);
+            res.push_back(sum);
+
+            bool last { i == a.size() - 1 };
+            if (!last || NULL != cout) {
+                int32_t next { fresh() };
+                gate_maj(next, a[i], b[i], carry);
+                carry = next;
+            }
+        }
+
+        if (NULL != cout) {
+            *cout = carry;
+        }
+
+        return res;
+    }
+
+    BitBlaster::Bits BitBlaster::negate(const Bits& a)
+    {
+        /* -a is ~a + 1 */
+        Bits complement;
+        for (int32_t bit : a) {
+            complement.push_back(neg(bit));
+        }
+
+        return add(complement, Bits(a.size(), constant(false)), constant(true));
+    }
+
+    BitBlaster::Bits BitBlaster::select(int32_t c, const Bits& t, const Bits& e)
+    {
+        assert(t.size() == e.size());
+
+        Bits res;
+        for (unsigned i = 0; i < t.size(); ++i) {
+            int32_t out { fresh() };
+            gate_ite(out, c, t[i], e[i]);
+            res.push_back(out);
+        }
+
+        return res;
+    }
+
+    void BitBlaster::udivide(const Bits& a, const Bits& b, Bits& quotient, Bits& remainder)
+    {
+        unsigned width { (unsigned) a.size() };
+
+        /* the partial remainder needs an extra bit before it is
+           reduced, it is less than b afterwards */
+        Bits divisor { b };
+        divisor.push_back(constant(false));
+
+        Bits complement;
+        for (int32_t bit : divisor) {
+            complement.push_back(neg(bit));
+        }
+
+        quotient.assign(width, constant(false));
+        remainder.assign(width, constant(false));
+        for (int i = width - 1; 0 <= i; --i) {
+            /* r = 2r + a(i) */
+            Bits shifted { a[i] };
+            shifted.insert(shifted.end(), remainder.begin(), remainder.end());
+
+            /* r - b does not borrow iff r >= b */
+            int32_t ge;
+            Bits diff { add(shifted, complement, constant(true), &ge) };
+
+            quotient[i] = ge;
+            remainder = select(ge, diff, shifted);
+            remainder.pop_back();
+        }
+    }
+
+    void BitBlaster::bind(const Bits& res)
+    {
+        assert(res.size() == f_width);
+
+        for (unsigned i = 0; i < f_width; ++i) {
+            clause({ neg(z(i)), res[i] });
+            clause({ z(i), neg(res[i]) });
+        }
+    }
+
+    void BitBlaster::multiplier()
+    {
+        /* sum of the partial products x * y(i) * 2^i, truncated */
+        Bits acc;
+        for (unsigned j = 0; j < f_width; ++j) {
+            int32_t pp { fresh() };
+            gate_and(pp, x(j), y(0));
+            acc.push_back(pp);
+        }
+
+        for (unsigned i = 1; i < f_width; ++i) {
+            Bits partial(i, constant(false));
+            for (unsigned j = 0; j + i < f_width; ++j) {
+                int32_t pp { fresh() };
+                gate_and(pp, x(j), y(i));
+                partial.push_back(pp);
+            }
+
+            acc = add(acc, partial, constant(false));
+        }
+
+        bind(acc);
+    }
+
+    void BitBlaster::divider(bool is_signed, bool remainder)
+    {
+        Bits a;
+        Bits b;
+        for (unsigned i = 0; i < f_width; ++i) {
+            a.push_back(x(i));
+            b.push_back(y(i));
+        }
+
+        /* signed operands are divided by their magnitudes, the
+           quotient is negative iff signs differ, the remainder takes
+           the sign of the dividend */
+        int32_t sa { a.back() };
+        int32_t sb { b.back() };
+        if (is_signed) {
+            a = select(sa, negate(a), a);
+            b = select(sb, negate(b), b);
+        }
+
+        Bits q;
+        Bits r;
+        udivide(a, b, q, r);
+
+        if (is_signed) {
+            if (remainder) {
+                r = select(sa, negate(r), r);
+            } else {
+                int32_t sq { fresh() };
+                gate_xor(sq, sa, sb);
+                q = select(sq, negate(q), q);
+            }
+        }
+
+        bind(remainder ? r : q);
+    }
+
+    void BitBlaster::negation()
+    {
+        Bits a;
+        for (unsigned i = 0; i < f_width; ++i) {
+            a.push_back(x(i));
+        }
+
+        bind(negate(a));
+    }
+
+    void BitBlaster::bitwise(expr::ExprType op_type)
+    {
+        for (unsigned i = 0; i < f_width; ++i) {
+            switch (op_type) {
+                case expr::ExprType::BW_NOT:
+                    clause({ z(i), x(i) });
+                    clause({ neg(z(i)), neg(x(i)) });
+                    break;
+
+                case expr::ExprType::BW_AND:
+                    gate_and(z(i), x(i), y(i));
+                    break;
+
+                case expr::ExprType::BW_OR:
+                    gate_or(z(i), x(i), y(i));
+                    break;
+
+                case expr::ExprType::BW_XOR:
+                    gate_xor(z(i), x(i), y(i));
+                    break;
+
+                case expr::ExprType::BW_XNOR:
+                    gate_xor(neg(z(i)), x(i), y(i));
+                    break;
+
+                case expr::ExprType::IMPLIES:
+                    gate_or(z(i), neg(x(i)), y(i));
+                    break;
+
+                default:
+                    assert(false); /* unreachable */
+            }
+        }
+    }
+
+    void BitBlaster::adder(bool subtract)
+    {
+        /* x - y is x + ~y + 1 */
+        int32_t carry { 0 };
+        for (unsigned i = 0; i < f_width; ++i) {
+            int32_t a { x(i) };
+            int32_t b { subtract ? neg(y(i)) : y(i) };
+            bool last { i == f_width - 1 };
+
+            if (!i) {
+                /* carry in is a constant, no need for full-adder */
+                gate_xor(subtract ? neg(z(i)) : z(i), a, b);
+                if (!last) {
+                    carry = fresh();
+                    if (subtract) {
+                        gate_or(carry, a, b);
+                    } else {
+                        gate_and(carry, a, b);
+                    }
+                }
+            } else {
+                gate_xor3(z(i), a, b, carry);
+                if (!last) {
+                    int32_t next { fresh() };
+                    gate_maj(next, a, b, carry);
+                    carry = next;
+                }
+            }
+        }
+    }
+
+    void BitBlaster::comparator(bool is_signed, bool strict, bool swap)
+    {
+        /* x < y iff x - y borrows, x <= y iff x - y - 1 borrows.
+           Signed operands compare as unsigned ones with both sign
+           bits complemented. */
+        int32_t borrow { 0 };
+        for (unsigned i = 0; i < f_width; ++i) {
+            bool last { i == f_width - 1 };
+            int32_t a { neg(swap ? y(i) : x(i)) };
+            int32_t b { swap ? x(i) : y(i) };
+
+            if (last && is_signed) {
+                a = neg(a);
+                b = neg(b);
+            }
+
+            int32_t out { last ? z(0) : fresh() };
+            if (!i) {
+                if (strict) {
+                    gate_and(out, a, b);
+                } else {
+                    gate_or(out, a, b);
+                }
+            } else {
+                gate_maj(out, a, b, borrow);
+            }
+
+            borrow = out;
+        }
+    }
+
+    void BitBlaster::equality(bool negated)
+    {
+        int32_t eq { negated ? neg(z(0)) : z(0) };
+
+        if (1 == f_width) {
+            gate_xor(neg(eq), x(0), y(0));
+            return;
+        }
+
+        /* eq <-> AND_i (x(i) <-> y(i)) */
+        std::vector<int32_t> bits;
+        for (unsigned i = 0; i < f_width; ++i) {
+            int32_t bit { fresh() };
+            gate_xor(neg(bit), x(i), y(i));
+            clause({ neg(eq), bit });
+            bits.push_back(bit);
+        }
+
+        push(eq);
+        for (int32_t bit : bits) {
+            push(neg(bit));
+        }
+        close();
+    }
+
+    void BitBlaster::flush(Microcode& microcode)
+    {
+        microcode.assign(f_offsets, f_literals);
+
+        /* ready for another run */
+        f_offsets.push_back(0);
+        f_next = 3 * f_width;
+        f_true = -1;
+    }
+
+}; // namespace sat
@@ -0,0 +1,166 @@
+/**
+ * @file sat/bitblast.hh
+ * @brief SAT interface, native operator bit-blasting declarations.
+ *
+ * This module contains the declarations of the built-in CNF
+ * generator for ripple-carry adders and comparators. Generated
+ * clauses follow the microcode layout (z, x, y interface vars,
+ * followed by cnf vars), so that they can be injected exactly as
+ * clauses loaded from a microcode file. Unlike microcode files they
+ * are available for any word width.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_BITBLAST_H
+#define SAT_BITBLAST_H
+
+#include <cassert>
+#include <initializer_list>
+#include <stdint.h>
+#include <vector>
+
+#include <compiler/typedefs.hh>
+#include <sat/microcode.hh>
+
+namespace sat {
+
+    /* true iff clauses for `ios` can be generated natively (PLUS,
+       SUB, EQ, NE, LT, LE, GT, GE, either signed or unsigned, any
+       width) */
+    bool can_bitblast(const compiler::InlinedOperatorSignature& ios);
+
+    /* true iff clauses for `ios` can be generated in-process, for the
+       operators of ucodegen.py which are not cheap enough to be
+       generated on every run (MUL, DIV, MOD, NEG, bitwise operators,
+       any width). These are minimized and cached as microcode (see
+       inlining.hh). Division by zero yields all ones, and the
+       dividend as remainder (as in SMT-LIB). Signed division
+       truncates towards zero. */
+    bool can_generate(const compiler::InlinedOperatorSignature& ios);
+
+    /* generates clauses for `ios` into `microcode`, either natively
+       or in-process. Interface vars use the microcode layout: for a
+       width w operator, vars [0, w) are z, [w, 2w) are x and [2w, 3w)
+       are y, least significant bit first. Relational operators only
+       use var 0 for z, unary ones do not use y. */
+    void bitblast(const compiler::InlinedOperatorSignature& ios, Microcode& microcode);
+
+    class BitBlaster {
+    public:
+        BitBlaster(unsigned width);
+
+        /* interface literals, i-th bit (LSB first) */
+        inline int32_t z(unsigned i) const
+        {
+            assert(i < f_width);
+            return 2 * i;
+        }
+
+        inline int32_t x(unsigned i) const
+        {
+            assert(i < f_width);
+            return 2 * (f_width + i);
+        }
+
+        inline int32_t y(unsigned i) const
+        {
+            assert(i < f_width);
+            return 2 * (2 * f_width + i);
+        }
+
+        /* ripple-carry adder, z = x + y + cin (mod 2^width). When
+           subtracting, y literals are complemented and cin is 1. */
+        void adder(bool subtract);
+
+        /* ripple-borrow comparator, z(0) <-> (x < y) (or x <= y if
+           not strict). `swap` compares y against x instead. */
+        void comparator(bool is_signed, bool strict, bool swap);
+
+        /* equality, z(0) <-> (x == y) (or x != y if negated) */
+        void equality(bool negated);
+
+        /* shift-and-add multiplier, z = x * y (mod 2^width) */
+        void multiplier();
+
+        /* restoring divider, z = x / y (or x mod y if remainder) */
+        void divider(bool is_signed, bool remainder);
+
+        /* z = -x (mod 2^width) */
+        void negation();
+
+        /* bitwise operators, z = ~x or z = x op y */
+        void bitwise(expr::ExprType op_type);
+
+        /* moves the generated clauses into `microcode` */
+        void flush(Microcode& microcode);
+
+    private:
+        typedef std::vector<int32_t> Bits;
+
+        inline int32_t fresh()
+        {
+            return 2 * f_next++;
+        }
+
+        /* clauses are built one literal at a time, `close`
+           terminates the current clause */
+        inline void push(int32_t lit)
+        {
+            f_literals.push_back(lit);
+        }
+
+        inline void close()
+        {
+            f_offsets.push_back(f_literals.size());
+        }
+
+        void clause(std::initializer_list<int32_t> lits);
+
+        /* Tseitin gates, out <-> f(inputs) */
+        void gate_and(int32_t out, int32_t a, int32_t b);
+        void gate_or(int32_t out, int32_t a, int32_t b);
+        void gate_xor(int32_t out, int32_t a, int32_t b);
+        void gate_xor3(int32_t out, int32_t a, int32_t b, int32_t c);
+        void gate_maj(int32_t out, int32_t a, int32_t b, int32_t c);
+        void gate_ite(int32_t out, int32_t c, int32_t t, int32_t e);
+
+        /* word-level building blocks, on fresh literals */
+        int32_t constant(bool value);
+        Bits add(const Bits& a, const Bits& b, int32_t cin, int32_t* cout = NULL);
+        Bits negate(const Bits& a);
+        Bits select(int32_t c, const Bits& t, const Bits& e);
+        void udivide(const Bits& a, const Bits& b, Bits& quotient, Bits& remainder);
+
+        /* z <-> res, bit by bit */
+        void bind(const Bits& res);
+
+        unsigned f_width;
+        int32_t f_next;
+
+        /* the constant true literal, -1 until needed */
+        int32_t f_true;
+
+        std::vector<uint32_t> f_offsets;
+        std::vector<int32_t> f_literals;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_BITBLAST_H */
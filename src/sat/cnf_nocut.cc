@@ -24,14 +24,16 @@
 #include <dd/dd_walker.hh>
 #include <sat/sat.hh>
 
-// #define  DEBUG_CNF_LITERALS
+// #define DEBUG_CNF_LITERALS
 
 namespace sat {
 
-    class CNFBuilderNoCut: public dd::ADDWalker {
+    /* A clause for each path from the root to the zero leaf, ruling
+     * the assignment of the path out: no aux vars are needed, but
+     * paths may be exponentially many more than nodes. */
+    class CNFBuilderNoCut {
     public:
-        CNFBuilderNoCut(Engine& sat, step_t time,
-                        group_t group = MAINGROUP)
+        CNFBuilderNoCut(Engine& sat, step_t time, group_t group = MAINGROUP)
             : f_sat(sat)
             , f_time(time)
             , f_group(group)
@@ -40,83 +42,66 @@ namespace sat {
         ~CNFBuilderNoCut()
         {}
 
-        void pre_hook()
+        void operator()(const ADD& add)
         {
-            assert(1 == f_recursion_stack.size());
+            f_path.clear();
 
-            dd::add_activation_record curr { f_recursion_stack.top() };
-            f_toplevel = const_cast<DdNode*>(curr.node);
-        }
+            if (MAINGROUP != f_group) {
+                f_path.push(mkLit(f_group, true));
+            }
 
-        void post_hook()
-        {
-            /* build and push clause toplevel */
-            vec<Lit> ps;
-            ps.push(mkLit(f_group, true));
+            DdNode* node { add.getNode() };
 
-            assert(NULL != f_toplevel);
+            /* constant zero, make formula unsatisfiable */
+            if (cuddIsConstant(node)) {
+                if (!Cudd_V(node)) {
+                    f_path.push(mkLit(0, true));
+                    push();
+                }
 
-            /* assert toplevel fun */
-            push1(f_sat.find_cnf_var(f_toplevel, f_time), false);
-        }
+                return;
+            }
 
-        inline bool is_unseen(const DdNode* node) const
-        {
-            return f_seen.end() == f_seen.find(const_cast<DdNode*>(node));
+            walk(node);
         }
 
-        inline void mark(const DdNode* node)
-        {
-            f_seen.insert(const_cast<DdNode*>(node));
-        }
+    private:
+        Engine& f_sat;
 
-        bool condition(const DdNode* node)
-        {
-            return cuddIsConstant(node) && !cuddV(node);
-        }
+        step_t f_time;
+        group_t f_group;
 
-        void action(const DdNode* node)
-        {
-            DdManager* dd_mgr { f_sat.enc().dd().getManager() };
+        /* the group literal, then the literals falsified along the
+           current path */
+        vec<Lit> f_path;
 
-            value_t value { Cudd_V(node) };
-            assert(!value);
+        void walk(const DdNode* node)
+        {
+            if (cuddIsConstant(node)) {
+                if (!Cudd_V(node)) {
+                    push();
+                }
 
-            vec<Lit> ps;
-            if (MAINGROUP != f_group) {
-                ps.push(mkLit(f_group, true));
+                return;
             }
 
-            int i, size { dd_mgr->size };
-            for (i = 0; i < size; ++i) {
-                Lit lit {
-                    mkLit(f_sat.find_dd_var(i, f_time), true)
-                };
-                ps.push(lit);
-            }
+            Var v { f_sat.find_dd_var(node, f_time) };
 
-            f_sat.add_clause(ps);
+            /* v on the then branch */
+            f_path.push(mkLit(v, true));
+            walk(cuddT(node));
+            f_path.pop();
 
-            DEBUG
-                << ps
-                << std::endl;
+            /* !v on the else branch */
+            f_path.push(mkLit(v, false));
+            walk(cuddE(node));
+            f_path.pop();
         }
 
-    private:
-        Engine& f_sat;
-        boost::unordered_set<DdNode*> f_seen;
-
-        DdNode* f_toplevel;
-
-        step_t f_time;
-        group_t f_group;
-
-        /* push 1 var clause */
-        inline void push1(Var x, bool px)
+        void push()
         {
             vec<Lit> ps;
-            ps.push(mkLit(f_group, true));
-            ps.push(mkLit(x, px));
+            f_path.copyTo(ps);
 
 #ifdef DEBUG_CNF_LITERALS
             DRIVEL
@@ -131,7 +116,14 @@ namespace sat {
     void Engine::cnf_push_no_cut(ADD add, step_t time, const group_t group)
     {
         CNFBuilderNoCut worker { *this, time, group };
+
         worker(add);
+
+#ifdef DEBUG_CNF_LITERALS
+        DRIVEL
+            << "------------------------------------------------------------"
+            << std::endl;
+#endif
     }
 
 }; // namespace sat
@@ -29,11 +29,12 @@
 
 namespace sat {
 
-    class CNFBuilderSingleCut: public dd::ADDWalker {
+    class CNFBuilderSingleCut: public dd::ADDDagWalker {
     public:
-        CNFBuilderSingleCut(Engine& sat, step_t time,
+        CNFBuilderSingleCut(Engine& sat, dd::ADDWalkerScratch& scratch, step_t time,
                             group_t group = MAINGROUP)
-            : f_sat(sat)
+            : dd::ADDDagWalker(scratch)
+            , f_sat(sat)
             , f_toplevel(NULL)
             , f_time(time)
             , f_group(group)
@@ -46,7 +47,7 @@ namespace sat {
         {
             assert(1 == f_recursion_stack.size());
 
-            dd::add_activation_record curr { f_recursion_stack.top() };
+            dd::add_activation_record curr { f_recursion_stack.back() };
             f_toplevel = const_cast<DdNode*>(curr.node);
         }
 
@@ -64,26 +65,13 @@ namespace sat {
             return 1 == f_recursion_stack.size();
         }
 
-        inline bool is_unseen(const DdNode* node) const
-        {
-            return f_seen.end() == f_seen.find(const_cast<DdNode*>(node));
-        }
-
-        inline void mark(const DdNode* node)
-        {
-            f_seen.insert(const_cast<DdNode*>(node));
-        }
-
         bool condition(const DdNode* node)
         {
             assert(NULL != node);
-            return cuddIsConstant(node)
 
-                       /* toplevel leaf or ... */
-                       ? is_toplevel()
-
-                       /* is a non-constant, yet unseen node. */
-                       : is_unseen(node);
+            /* toplevel leaf or a non-constant node, each node is
+               visited once */
+            return !cuddIsConstant(node) || is_toplevel();
         }
 
         void action(const DdNode* node)
@@ -95,8 +83,6 @@ namespace sat {
                     push1(0, true); /* make formula unsatisfiable */
                 }
             } else {
-                mark(node);
-
                 Var f { f_sat.find_cnf_var(node, f_time) };
                 Var v { f_sat.find_dd_var(node, f_time) };
 
@@ -216,7 +202,6 @@ namespace sat {
 
     private:
         Engine& f_sat;
-        boost::unordered_set<DdNode*> f_seen;
 
         DdNode* f_toplevel;
 
@@ -289,7 +274,7 @@ namespace sat {
 
     void Engine::cnf_push_single_cut(ADD add, step_t time, const group_t group)
     {
-        CNFBuilderSingleCut worker { *this, time, group };
+        CNFBuilderSingleCut worker { *this, f_walker_scratch, time, group };
 
         worker(add);
 
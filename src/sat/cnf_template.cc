@@ -0,0 +1,238 @@
+/**
+ * @file sat/cnf_template.cc
+ * @brief SAT interface, time-shiftable CNF templates implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sat/backend.hh>
+#include <sat/cnf_template.hh>
+#include <sat/engine.hh>
+
+namespace sat {
+
+    const Var TEMPLATE_CONSTANT_VAR { 0 };
+    const Var TEMPLATE_GROUP_VAR { 1 };
+
+    /* Records vars and clauses instead of solving, used to build
+     * templates. */
+    class RecordingBackend: public SolverBackend {
+    public:
+        RecordingBackend()
+            : f_n_vars(0)
+        {
+            f_offsets.push_back(0);
+        }
+
+        const char* name() const
+        {
+            return "recorder";
+        }
+
+        Var new_var(bool frozen)
+        {
+            return f_n_vars++;
+        }
+
+        void freeze(Var var, bool frozen)
+        {}
+
+        void add_clause(vec<Lit>& ps)
+        {
+            for (int i = 0; i < ps.size(); ++i) {
+                f_literals.push_back(Minisat::toInt(ps[i]));
+            }
+            f_offsets.push_back(f_literals.size());
+        }
+
+        unsigned eliminate()
+        {
+            return 0;
+        }
+
+        bool is_eliminated(Var var) const
+        {
+            return false;
+        }
+
+        void simplify()
+        {}
+
+        void limit_memory(uint64_t max_bytes)
+        {}
+
+        status_t solve(const vec<Lit>& assumptions)
+        {
+            assert(false); /* unreachable */
+            return STATUS_UNKNOWN;
+        }
+
+        bool failed(Lit assumption)
+        {
+            assert(false); /* unreachable */
+            return true;
+        }
+
+        int value(Var var)
+        {
+            assert(false); /* unreachable */
+            return 0;
+        }
+
+        void interrupt()
+        {}
+
+        void clear_interrupt()
+        {}
+
+        void tune(const SolverConfig& config)
+        {}
+
+        void set_phase(Var var, bool value)
+        {}
+
+        void set_priority(Var var, double priority)
+        {}
+
+        void export_learnts(unsigned max_size, LitsVector& out)
+        {}
+
+        void configure(int64_t conf_budget, int64_t prop_budget)
+        {}
+
+        void print_stats(std::ostream& os) const
+        {
+            os
+                << "vars: "
+                << f_n_vars
+                << ", clauses: "
+                << f_offsets.size() - 1;
+        }
+
+        void counters(SolverCounters& counters) const
+        {
+            counters.vars = f_n_vars;
+            counters.clauses = f_offsets.size() - 1;
+            counters.memory = f_offsets.capacity() * sizeof(uint32_t) +
+                              f_literals.capacity() * sizeof(int32_t);
+        }
+
+        Var f_n_vars;
+        std::vector<uint32_t> f_offsets;
+        std::vector<int32_t> f_literals;
+    };
+
+    CNFTemplate::CNFTemplate(const compiler::Unit& unit)
+        : f_n_aux_vars(0)
+    {
+        RecordingBackend* recorder { new RecordingBackend() };
+        Engine scratch { "template", recorder };
+
+        /* a non-main group, so that every clause carries the group
+           literal and the actual group can be chosen at instantiation */
+        group_t group { scratch.new_group() };
+        assert(TEMPLATE_GROUP_VAR == group);
+
+        scratch.push(unit, 0, group);
+
+        /* templates are never solved, lazy MUXes can not be refined */
+        scratch.flush_lazy_muxes();
+
+        /* model vars booked along with their frame may be in no
+           clause, they are left out */
+        std::vector<bool> used(recorder->f_n_vars, false);
+        for (auto literal : recorder->f_literals) {
+            used[Minisat::var(Minisat::toLit(literal))] = true;
+        }
+
+        /* renumber recorded vars into the template var space */
+        std::vector<Var> renumber(recorder->f_n_vars, -1);
+        renumber[TEMPLATE_CONSTANT_VAR] = TEMPLATE_CONSTANT_VAR;
+        renumber[TEMPLATE_GROUP_VAR] = TEMPLATE_GROUP_VAR;
+
+        for (Var v = 2; v < recorder->f_n_vars; ++v) {
+            if (used[v] && scratch.is_model_var(v)) {
+                const enc::TCBI& tcbi { scratch.var_to_tcbi(v) };
+                renumber[v] = 2 + f_model_vars.size();
+                f_model_vars.push_back(enc::UCBI(tcbi.expr(), tcbi.time(), tcbi.bitno()));
+            }
+        }
+
+        for (Var v = 2; v < recorder->f_n_vars; ++v) {
+            if (used[v] && -1 == renumber[v]) {
+                renumber[v] = 2 + f_model_vars.size() + f_n_aux_vars++;
+            }
+        }
+
+        f_offsets = recorder->f_offsets;
+        f_literals.reserve(recorder->f_literals.size());
+        for (auto literal : recorder->f_literals) {
+            Lit lit { Minisat::toLit(literal) };
+            f_literals.push_back(
+                Minisat::toInt(mkLit(renumber[Minisat::var(lit)], Minisat::sign(lit))));
+        }
+
+        unsigned n_clauses { size() };
+        size_t n_model_vars { f_model_vars.size() };
+        DEBUG
+            << "CNF template built, "
+            << n_clauses << " clauses, "
+            << n_model_vars << " model vars, "
+            << f_n_aux_vars << " aux vars"
+            << std::endl;
+    }
+
+    void CNFTemplate::instantiate(Engine& engine, step_t time, group_t group) const
+    {
+        std::vector<Var> vars;
+        vars.reserve(2 + f_model_vars.size() + f_n_aux_vars);
+
+        vars.push_back(TEMPLATE_CONSTANT_VAR);
+        vars.push_back(group);
+
+        for (const auto& ucbi : f_model_vars) {
+            vars.push_back(engine.tcbi_to_var(enc::TCBI(ucbi, time)));
+        }
+
+        for (unsigned i = 0; i < f_n_aux_vars; ++i) {
+            vars.push_back(engine.new_sat_var());
+        }
+
+        vec<Lit> ps;
+        for (unsigned i = 0; i < size(); ++i) {
+            ps.clear();
+
+            const int32_t* end { f_literals.data() + f_offsets[1 + i] };
+            for (const int32_t* p = f_literals.data() + f_offsets[i]; p != end; ++p) {
+                Lit lit { Minisat::toLit(*p) };
+                Var var { Minisat::var(lit) };
+
+                /* main group clauses carry no group literal */
+                if (TEMPLATE_GROUP_VAR == var && MAINGROUP == group) {
+                    continue;
+                }
+
+                ps.push(mkLit(vars[var], Minisat::sign(lit)));
+            }
+
+            engine.add_clause(ps);
+        }
+    }
+
+}; // namespace sat
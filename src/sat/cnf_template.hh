@@ -0,0 +1,75 @@
+/**
+ * @file sat/cnf_template.hh
+ * @brief SAT interface, time-shiftable CNF templates declaration.
+ *
+ * This module contains the declaration of CNF templates. A template
+ * holds the CNF of a compiled unit with symbolic time: model vars are
+ * kept as untimed bit identifiers, CNF auxiliary vars as local
+ * indexes. Instantiating a template at a given time only requires a
+ * variable renumbering pass, no DD walking or descriptor processing.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_CNF_TEMPLATE_H
+#define SAT_CNF_TEMPLATE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include <compiler/typedefs.hh>
+
+#include <enc/ucbi.hh>
+
+#include <sat/typedefs.hh>
+
+namespace sat {
+
+    class Engine;
+
+    class CNFTemplate {
+    public:
+        /* CNF-izes unit once, using a scratch engine */
+        CNFTemplate(const compiler::Unit& unit);
+
+        /* pushes the template clauses into engine, at time */
+        void instantiate(Engine& engine, step_t time,
+                         group_t group = MAINGROUP) const;
+
+        inline unsigned size() const
+        {
+            return f_offsets.size() - 1;
+        }
+
+    private:
+        /* template var space: 0 is the constant var, 1 is the group
+         * placeholder, model vars follow, then auxiliary vars. */
+        std::vector<enc::UCBI> f_model_vars;
+        unsigned f_n_aux_vars;
+
+        /* flat clauses, template literals in Minisat int encoding */
+        std::vector<uint32_t> f_offsets;
+        std::vector<int32_t> f_literals;
+    };
+
+    typedef std::vector<CNFTemplate> CNFTemplates;
+
+}; // namespace sat
+
+#endif /* SAT_CNF_TEMPLATE_H */
@@ -0,0 +1,191 @@
+/**
+ * @file sat/dimacs.cc
+ * @brief SAT interface, DIMACS and iCNF tracing implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sstream>
+
+#include <sat/dimacs.hh>
+#include <sat/exceptions.hh>
+
+#include <utils/logging.hh>
+
+namespace sat {
+
+    static inline int dimacs(Lit lit)
+    {
+        int var { 1 + Minisat::var(lit) };
+        return Minisat::sign(lit) ? -var : var;
+    }
+
+    int dimacs_lit(Lit lit)
+    {
+        return dimacs(lit);
+    }
+
+    DimacsTracer::DimacsTracer(const std::string& prefix)
+        : f_prefix(prefix)
+        , f_queries(0)
+        , f_n_vars(0)
+    {
+        if (!prefix.empty()) {
+            f_icnf.open((prefix + ".icnf").c_str());
+        }
+        if (!prefix.empty() && !f_icnf) {
+            throw EngineException("DimacsTracer",
+                                  "can not open `" + prefix + ".icnf` for writing");
+        }
+
+        f_offsets.push_back(0);
+        f_icnf
+            << "p inccnf"
+            << std::endl;
+    }
+
+    DimacsTracer::DimacsTracer(const DimacsTracer& parent)
+        : f_queries(0)
+        , f_n_vars(parent.f_n_vars)
+        , f_offsets(parent.f_offsets)
+        , f_literals(parent.f_literals)
+        , f_annotations(parent.f_annotations)
+    {}
+
+    DimacsTracer::~DimacsTracer()
+    {}
+
+    void DimacsTracer::touch(Var var)
+    {
+        if (f_n_vars <= var) {
+            f_n_vars = 1 + var;
+        }
+    }
+
+    void DimacsTracer::add_clause(const vec<Lit>& ps)
+    {
+        for (int i = 0; i < ps.size(); ++i) {
+            touch(Minisat::var(ps[i]));
+
+            f_icnf << dimacs(ps[i]) << " ";
+            f_literals.push_back(dimacs(ps[i]));
+        }
+        f_offsets.push_back(f_literals.size());
+
+        f_icnf << "0\n";
+    }
+
+    void DimacsTracer::add_model_var(Var var, const enc::TCBI& tcbi)
+    {
+        std::ostringstream oss;
+
+        touch(var);
+        oss
+            << "c tcbi "
+            << 1 + var
+            << " "
+            << tcbi;
+
+        f_annotations.push_back(oss.str());
+        f_icnf
+            << f_annotations.back()
+            << "\n";
+    }
+
+    void DimacsTracer::clauses(unsigned first, std::vector<int>& out) const
+    {
+        for (unsigned i = first; i < n_clauses(); ++i) {
+            for (uint32_t j = f_offsets[i]; j < f_offsets[1 + i]; ++j) {
+                out.push_back(f_literals[j]);
+            }
+            out.push_back(0);
+        }
+    }
+
+    void DimacsTracer::solve(const vec<Lit>& assumptions)
+    {
+        if (f_prefix.empty()) {
+            return;
+        }
+
+        f_icnf << "a ";
+        for (int i = 0; i < assumptions.size(); ++i) {
+            touch(Minisat::var(assumptions[i]));
+            f_icnf << dimacs(assumptions[i]) << " ";
+        }
+        f_icnf << "0" << std::endl;
+
+        write_query(assumptions);
+    }
+
+    void DimacsTracer::write_query(const vec<Lit>& assumptions)
+    {
+        std::ostringstream oss;
+        oss
+            << f_prefix
+            << "-"
+            << ++f_queries
+            << ".cnf";
+
+        const std::string filename { oss.str() };
+        std::ofstream out { filename.c_str() };
+        if (!out) {
+            throw EngineException("DimacsTracer",
+                                  "can not open `" + filename + "` for writing");
+        }
+
+        unsigned n_clauses { static_cast<unsigned>(f_offsets.size() - 1) };
+        out
+            << "c query #"
+            << f_queries
+            << ", assumptions are given as unit clauses\n";
+
+        for (const auto& annotation : f_annotations) {
+            out
+                << annotation
+                << "\n";
+        }
+
+        out
+            << "p cnf "
+            << f_n_vars
+            << " "
+            << n_clauses + assumptions.size()
+            << "\n";
+
+        for (unsigned i = 0; i < n_clauses; ++i) {
+            for (uint32_t j = f_offsets[i]; j < f_offsets[1 + i]; ++j) {
+                out << f_literals[j] << " ";
+            }
+            out << "0\n";
+        }
+
+        for (int i = 0; i < assumptions.size(); ++i) {
+            out
+                << dimacs(assumptions[i])
+                << " 0\n";
+        }
+
+        DEBUG
+            << "Written DIMACS query "
+            << filename
+            << std::endl;
+    }
+
+}; // namespace sat
@@ -0,0 +1,95 @@
+/**
+ * @file sat/dimacs.hh
+ * @brief SAT interface, DIMACS and iCNF tracing declaration.
+ *
+ * This module contains the declaration of the CNF tracer. When
+ * enabled on an engine, the tracer writes the whole run as an
+ * incremental iCNF file (`<prefix>.icnf`) and each query as a
+ * standalone DIMACS file (`<prefix>-<n>.cnf`), with assumptions
+ * turned into unit clauses. Model vars are annotated with their TCBI
+ * in `c tcbi <var> <tcbi>` comment lines, so that models found by
+ * external solvers can be mapped back to witnesses.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_DIMACS_H
+#define SAT_DIMACS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <enc/tcbi.hh>
+
+#include <sat/typedefs.hh>
+
+namespace sat {
+
+    /* DIMACS literal for a Minisat literal, vars are 1-based */
+    int dimacs_lit(Lit lit);
+
+    class DimacsTracer {
+    public:
+        /* with an empty prefix, clauses are only recorded in memory */
+        DimacsTracer(const std::string& prefix);
+
+        /* an in-memory copy of the clauses recorded by parent (e.g.
+           for an engine fork), nothing is written */
+        DimacsTracer(const DimacsTracer& parent);
+        ~DimacsTracer();
+
+        void add_clause(const vec<Lit>& ps);
+        void add_model_var(Var var, const enc::TCBI& tcbi);
+        void solve(const vec<Lit>& assumptions);
+
+        /* the clauses recorded from the first-th on, as zero
+           terminated DIMACS literals */
+        inline unsigned n_clauses() const
+        {
+            return f_offsets.size() - 1;
+        }
+        void clauses(unsigned first, std::vector<int>& out) const;
+
+    private:
+        void write_query(const vec<Lit>& assumptions);
+        void touch(Var var);
+
+        std::string f_prefix;
+        std::ofstream f_icnf;
+
+        /* number of queries so far */
+        unsigned f_queries;
+
+        /* number of vars seen so far */
+        Var f_n_vars;
+
+        /* clause database, flat */
+        std::vector<uint32_t> f_offsets;
+        std::vector<int32_t> f_literals;
+
+        /* TCBI annotations */
+        std::vector<std::string> f_annotations;
+    };
+
+    typedef DimacsTracer* DimacsTracer_ptr;
+
+}; // namespace sat
+
+#endif /* SAT_DIMACS_H */
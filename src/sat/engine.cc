@@ -21,26 +21,309 @@
  *
  **/
 
+#include <algorithm>
 #include <cstdlib>
 #include <sat.hh>
 
+#include <opts/opts_mgr.hh>
+
+#include <utils/memory.hh>
+#include <utils/profile.hh>
+#include <utils/trace.hh>
+
 namespace sat {
 
+    /* retired groups between backend simplifications */
+    static const unsigned RETIREMENTS_PER_SIMPLIFY { 8 };
+
+    /* clauses longer than this are only checked for duplicates */
+    static const unsigned CLAUSE_FILTER_MAX_SUBSUMPTION { 16 };
+
     /**
  * @brief SAT instancte ctor
  */
-    Engine::Engine(const char* instance_name)
+    Engine::Engine(const char* instance_name, const char* backend_name)
+        : f_instance_name(instance_name)
+        , f_enc_mgr(enc::EncodingMgr::INSTANCE())
+        , f_cnf_frame(NULL)
+        , f_cnf_frame_time(0)
+        , f_backend(NULL)
+        , f_tracer(NULL)
+        , f_exchange(NULL)
+        , f_exchange_role(EXCHANGE_IMPORT)
+        , f_exchange_cursor(0)
+        , f_exchange_max_size(0)
+        , f_memory_budget(0)
+        , f_retired(0)
+        , f_clause_filtering(false)
+        , f_clause_filter(NULL)
+        , f_dropped_duplicates(0)
+        , f_dropped_subsumed(0)
+        , f_n_vars(0)
+        , f_n_clauses(0)
+        , f_scope(NULL)
+        , f_step(0)
+        , f_quantum(0)
+        , f_conf_limit(-1)
+        , f_prop_budget(-1)
+    {
+        /* diversified configuration from the portfolio, an explicit
+           backend takes precedence over the configuration's */
+        const SolverConfig config { EngineMgr::INSTANCE().assign_config(instance_name) };
+
+        if (NULL == backend_name) {
+            backend_name = config.backend;
+        }
+
+        f_backend = make_solver_backend(NULL != backend_name
+                                            ? std::string(backend_name)
+                                            : opts::OptsMgr::INSTANCE().sat_backend());
+        f_backend->tune(config);
+
+        initialize();
+    }
+
+    Engine::Engine(const char* instance_name, SolverBackend_ptr backend)
         : f_instance_name(instance_name)
         , f_enc_mgr(enc::EncodingMgr::INSTANCE())
+        , f_cnf_frame(NULL)
+        , f_cnf_frame_time(0)
+        , f_backend(backend)
+        , f_tracer(NULL)
+        , f_exchange(NULL)
+        , f_exchange_role(EXCHANGE_IMPORT)
+        , f_exchange_cursor(0)
+        , f_exchange_max_size(0)
+        , f_memory_budget(0)
+        , f_retired(0)
+        , f_clause_filtering(false)
+        , f_clause_filter(NULL)
+        , f_dropped_duplicates(0)
+        , f_dropped_subsumed(0)
+        , f_n_vars(0)
+        , f_n_clauses(0)
+        , f_scope(NULL)
+        , f_step(0)
+        , f_quantum(0)
+        , f_conf_limit(-1)
+        , f_prop_budget(-1)
+    {
+        initialize();
+    }
+
+    /* The backend is built again from the recorded clauses, and the
+     * parent's learnts (root units included): Minisat solvers can not
+     * be copied. Vars are made first, in the same order, so that the
+     * registries hold for the fork as they are. */
+    Engine::Engine(const char* instance_name, const Engine& parent)
+        : f_instance_name(instance_name)
+        , f_enc_mgr(parent.f_enc_mgr)
+        , f_tdd2var_map(parent.f_tdd2var_map)
+        , f_cnf_frame(NULL)
+        , f_cnf_frame_time(0)
+        , f_taig2var_map(parent.f_taig2var_map)
+        , f_injected_muxes(parent.f_injected_muxes)
+        , f_tcbi2var_map(parent.f_tcbi2var_map)
+        , f_frame_layout(parent.f_frame_layout)
+        , f_layout_bits(parent.f_layout_bits)
+        , f_reserved_frames(parent.f_reserved_frames)
+        , f_dd_vars(parent.f_dd_vars)
+        , f_fixed_bits(parent.f_fixed_bits)
+        , f_backend(NULL)
+        , f_tracer(NULL)
+        , f_exchange(NULL)
+        , f_exchange_role(EXCHANGE_IMPORT)
+        , f_exchange_cursor(0)
+        , f_exchange_max_size(0)
+        , f_memory_budget(parent.f_memory_budget)
+        , f_retired(0)
+        , f_frame_elimination(parent.f_frame_elimination)
+        , f_frame_vars(parent.f_frame_vars)
+        , f_clause_filtering(parent.f_clause_filtering)
+        , f_clause_filter(NULL)
+        , f_dropped_duplicates(0)
+        , f_dropped_subsumed(0)
+        , f_transient_inputs(parent.f_transient_inputs)
+        , f_transient_vars(parent.f_transient_vars)
+        , f_cnf_strategy(parent.f_cnf_strategy)
+        , f_cnf_no_cut_paths(parent.f_cnf_no_cut_paths)
+        , f_n_vars(0)
+        , f_n_clauses(0)
+        , f_decision_order(parent.f_decision_order)
+        , f_status(parent.f_status)
+        , f_scope(NULL)
+        , f_step(parent.f_step)
+        , f_quantum(0)
+        , f_conf_limit(-1)
+        , f_prop_budget(-1)
+        , f_groups_map(parent.f_groups_map)
+        , f_lazy_muxes(parent.f_lazy_muxes)
+    {
+        assert(NULL != parent.f_tracer);
+
+        const SolverConfig config { EngineMgr::INSTANCE().assign_config(instance_name) };
+        f_backend = make_solver_backend(parent.f_backend->name());
+        f_backend->tune(config);
+        f_backend->limit_memory(f_memory_budget);
+
+        /* model vars are frozen, unless transient */
+        boost::unordered_set<Var> transient(f_transient_vars.begin(), f_transient_vars.end());
+
+        SolverCounters counters;
+        parent.f_backend->counters(counters);
+        for (Var var = 0; var < (Var) counters.vars; ++var) {
+            bool model {
+                var < (Var) parent.f_var2tcbi_map.size() &&
+                NULL != parent.f_var2tcbi_map[var]
+            };
+            f_backend->new_var(model && 0 == transient.count(var));
+        }
+
+        /* entries point to the keys of our own registry */
+        f_var2tcbi_map.resize(parent.f_var2tcbi_map.size(), NULL);
+        for (const auto& entry : f_tcbi2var_map) {
+            f_var2tcbi_map[entry.second] = &entry.first;
+            prioritize(entry.second, entry.first);
+        }
+
+        f_tracer = new DimacsTracer(*parent.f_tracer);
+
+        std::vector<int> clauses;
+        parent.f_tracer->clauses(0, clauses);
+
+        vec<Lit> ps;
+        for (auto literal : clauses) {
+            if (0 == literal) {
+                f_backend->add_clause(ps);
+                ps.clear();
+            } else {
+                ps.push(mkLit(abs(literal) - 1, literal < 0));
+            }
+        }
+
+        /* learnts are implied by the clauses, they are not recorded */
+        LitsVector learnts;
+        parent.f_backend->export_learnts(UINT_MAX, learnts);
+        for (const auto& learnt : learnts) {
+            ps.clear();
+            for (auto lit : learnt) {
+                ps.push(lit);
+            }
+            f_backend->add_clause(ps);
+        }
+
+        parent.f_groups.copyTo(f_groups);
+
+        EngineMgr::INSTANCE()
+            .register_instance(this);
+
+        clock_gettime(CLOCK_MONOTONIC, &f_step_start);
+
+        const void* instance { this };
+        size_t n_clauses { parent.f_tracer->n_clauses() };
+        size_t n_learnts { learnts.size() };
+        DEBUG
+            << "Forked Engine instance @"
+            << instance
+            << " from "
+            << parent.name()
+            << ", "
+            << n_clauses
+            << " clauses, "
+            << n_learnts
+            << " learnts"
+            << std::endl;
+    }
+
+    void Engine::configure(int64_t conf_budget, int64_t prop_budget)
+    {
+        SolverCounters counters;
+        f_backend->counters(counters);
+
+        f_conf_limit = 0 <= conf_budget ? (int64_t) counters.conflicts + conf_budget : -1;
+        f_prop_budget = prop_budget;
+
+        f_backend->configure(conf_budget, prop_budget);
+    }
+
+    void Engine::set_memory_budget(uint64_t max_bytes)
+    {
+        f_memory_budget = max_bytes;
+        f_backend->limit_memory(max_bytes);
+
+        if (0 < max_bytes) {
+            f_frame_elimination = true;
+        }
+    }
+
+    /* Slices end on their own conflict budget, which is set before
+     * each of them and restored to what is left of the configured
+     * one afterwards. A slice ending earlier (e.g. on an
+     * interruption) or on the configured budget ends the solve() as
+     * well. Propagation budgets are relative, slicing is off with
+     * them. */
+    status_t Engine::backend_solve(const vec<Lit>& assumptions)
+    {
+        if (0 == f_quantum || 0 <= f_prop_budget || !f_slice_hook) {
+            return f_backend->solve(assumptions);
+        }
+
+        status_t res;
+        while (true) {
+            SolverCounters counters;
+            f_backend->counters(counters);
+            int64_t conflicts { (int64_t) counters.conflicts };
+
+            int64_t slice { f_quantum };
+            if (0 <= f_conf_limit) {
+                slice = std::max((int64_t) 0, std::min(slice, f_conf_limit - conflicts));
+            }
+
+            f_backend->configure(slice, -1);
+            res = f_backend->solve(assumptions);
+
+            f_backend->counters(counters);
+            int64_t spent { (int64_t) counters.conflicts - conflicts };
+
+            f_backend->configure(0 <= f_conf_limit
+                                     ? std::max((int64_t) 0, f_conf_limit - (int64_t) counters.conflicts)
+                                     : -1,
+                                 -1);
+
+            if (STATUS_UNKNOWN != res || spent < slice ||
+                (0 <= f_conf_limit && f_conf_limit <= (int64_t) counters.conflicts)) {
+                break;
+            }
+
+            f_slice_hook();
+        }
+
+        return res;
+    }
+
+    void Engine::initialize()
     {
         const void* instance { this };
 
-        /* Default configuration */
-        f_solver.random_var_freq = .1;
-        // f_solver.ccmin_mode = 0;
-        // f_solver.phase_saving = 0;
-        f_solver.rnd_init_act = true;
-        f_solver.garbage_frac = 0.50;
+        const std::string cnf { opts::OptsMgr::INSTANCE().cnf_strategy() };
+        if (cnf == "polarity") {
+            f_cnf_strategy = CNF_POLARITY;
+        } else if (cnf == "no-cut") {
+            f_cnf_strategy = CNF_NO_CUT;
+        } else if (cnf == "adaptive") {
+            f_cnf_strategy = CNF_ADAPTIVE;
+        } else {
+            f_cnf_strategy = CNF_SINGLE_CUT;
+        }
+        f_cnf_no_cut_paths = opts::OptsMgr::INSTANCE().cnf_no_cut_paths();
+        f_frame_elimination = opts::OptsMgr::INSTANCE().frame_elimination();
+        f_clause_filtering = opts::OptsMgr::INSTANCE().clause_filter();
+
+        const std::string order { opts::OptsMgr::INSTANCE().decision_order() };
+        f_decision_order = (order == "frames")
+                               ? DECISION_ORDER_FRAMES
+                               : (order == "reverse") ? DECISION_ORDER_REVERSE
+                                                      : DECISION_ORDER_NONE;
 
         /* MAINGROUP (=0) is already there. */
         f_groups.push(new_sat_var());
@@ -48,23 +331,305 @@ namespace sat {
         EngineMgr::INSTANCE()
             .register_instance(this);
 
+        clock_gettime(CLOCK_MONOTONIC, &f_step_start);
+
+        const char* name { f_backend->name() };
         DEBUG
             << "Initialized Engine instance @"
             << instance
+            << " ("
+            << name
+            << " backend)"
             << std::endl;
     }
 
     Engine::~Engine()
     {
+        trace_step();
+
         EngineMgr::INSTANCE()
             .unregister_instance(this);
+
+        if (NULL != f_exchange) {
+            EngineMgr::INSTANCE()
+                .leave_exchange(f_exchange_channel);
+        }
+
+        delete f_backend;
+        delete f_tracer;
     }
 
-    status_t Engine::sat_solve_groups(const Groups& groups)
+    void Engine::set_step(step_t step)
+    {
+        /* repeated calls for the same step are not a new span */
+        if (step != f_step) {
+            trace_step();
+        }
+
+        f_step = step;
+    }
+
+    void Engine::trace_step()
+    {
+        utils::EventTracer& tracer { utils::EventTracer::INSTANCE() };
+        if (!tracer.enabled()) {
+            return;
+        }
+
+        /* a step spans its solves and the unrolling that follows */
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        tracer.complete("step", "reach", f_step_start, now, name(), (long) f_step);
+        f_step_start = now;
+    }
+
+    uint64_t Engine::clause_db_bytes() const
+    {
+        SolverCounters counters;
+        f_backend->counters(counters);
+
+        return counters.memory;
+    }
+
+    uint64_t Engine::registry_bytes() const
+    {
+        uint64_t res { 0 };
+
+        for (const auto& entry : f_tdd2var_map) {
+            res += utils::hash_bytes(entry.second);
+        }
+        res += utils::hash_bytes(f_tdd2var_map);
+        res += utils::hash_bytes(f_taig2var_map);
+        res += utils::hash_bytes(f_tcbi2var_map);
+        res += utils::vector_bytes(f_var2tcbi_map);
+
+        for (const auto* rows : { &f_dd_vars.f_forward, &f_dd_vars.f_backward }) {
+            for (const auto& row : *rows) {
+                res += utils::vector_bytes(row);
+            }
+            res += utils::vector_bytes(*rows);
+        }
+
+        for (const auto& entry : f_frame_vars) {
+            res += utils::vector_bytes(entry.second);
+        }
+        res += utils::hash_bytes(f_frame_vars);
+
+        return res;
+    }
+
+    void Engine::trace_cnf(const std::string& prefix)
+    {
+        assert(NULL == f_tracer);
+        f_tracer = new DimacsTracer(prefix);
+
+        /* model vars booked so far (if any) */
+        for (Var var = 0; var < (Var) f_var2tcbi_map.size(); ++var) {
+            if (NULL != f_var2tcbi_map[var]) {
+                f_tracer->add_model_var(var, *f_var2tcbi_map[var]);
+            }
+        }
+    }
+
+    void Engine::record_cnf()
+    {
+        if (NULL == f_tracer) {
+            trace_cnf("");
+        }
+    }
+
+    unsigned Engine::recorded_clauses(unsigned first, std::vector<int>& out) const
+    {
+        assert(NULL != f_tracer);
+        f_tracer->clauses(first, out);
+
+        return f_tracer->n_clauses();
+    }
+
+    void Engine::query_assumptions(std::vector<int>& out) const
+    {
+        for (int i = 0; i < f_groups.size(); ++i) {
+            Var grp { f_groups[i] };
+            out.push_back(dimacs_lit(mkLit(abs(grp), grp < 0)));
+        }
+    }
+
+    void Engine::release_frame(step_t time)
+    {
+        /* the CNF vars of the frame are no longer needed either way */
+        if (f_tdd2var_map.erase(time) && time == f_cnf_frame_time) {
+            f_cnf_frame = NULL;
+        }
+
+        /* no more clauses are pushed on the frame */
+        f_clause_filters.erase(time);
+
+        if (!f_frame_elimination) {
+            return;
+        }
+
+        boost::unordered_map<step_t, VarVector>::iterator i {
+            f_frame_vars.find(time)
+        };
+
+        if (f_frame_vars.end() == i) {
+            return;
+        }
+
+        for (const auto var : i->second) {
+            f_backend->freeze(var, false);
+        }
+
+        size_t released { i->second.size() };
+        f_frame_vars.erase(i);
+
+        unsigned eliminated { f_backend->eliminate() };
+        DEBUG
+            << "Released "
+            << released
+            << " model vars, "
+            << eliminated
+            << " vars eliminated"
+            << std::endl;
+    }
+
+    void Engine::join_exchange(const std::string& channel, exchange_role_t role)
+    {
+        assert(NULL == f_exchange);
+
+        f_exchange = EngineMgr::INSTANCE().join_exchange(channel);
+        f_exchange_channel = channel;
+        f_exchange_role = role;
+        f_exchange_max_size = opts::OptsMgr::INSTANCE().share_learnts();
+    }
+
+    void Engine::import_learnts()
+    {
+        SharedClauses shared;
+        f_exchange->fetch(f_exchange_cursor, f_step, shared);
+        add_model_clauses(shared);
+
+        size_t n { shared.size() };
+        DEBUG
+            << "Imported "
+            << n
+            << " shared clauses"
+            << std::endl;
+    }
+
+    void Engine::add_model_clauses(const SharedClauses& clauses)
+    {
+        for (const auto& clause : clauses) {
+            vec<Lit> ps;
+            for (const auto& lit : clause) {
+                Var var { tcbi_to_var(lit.first) };
+
+                /* released frames can not be constrained any further */
+                if (f_backend->is_eliminated(var)) {
+                    break;
+                }
+
+                ps.push(mkLit(var, lit.second));
+            }
+
+            if (ps.size() == static_cast<int>(clause.size())) {
+                add_clause(ps);
+            }
+        }
+    }
+
+    void Engine::model_learnts(unsigned max_size, SharedClauses& out) const
+    {
+        LitsVector learnts;
+        f_backend->export_learnts(max_size, learnts);
+
+        for (const auto& lits : learnts) {
+            SharedClause clause;
+
+            /* clauses involving group literals, or CNF auxiliary
+               vars, make no sense outside of this engine */
+            Lits::const_iterator i;
+            for (i = lits.begin(); lits.end() != i; ++i) {
+                Var var { Minisat::var(*i) };
+                if (!is_model_var(var)) {
+                    break;
+                }
+
+                clause.push_back(SharedLit(var_to_tcbi(var), Minisat::sign(*i)));
+            }
+
+            if (lits.end() == i) {
+                out.push_back(clause);
+            }
+        }
+    }
+
+    void Engine::export_learnts()
+    {
+        SharedClauses learnts;
+        model_learnts(f_exchange_max_size, learnts);
+
+        SharedClauses shared;
+        for (const auto& clause : learnts) {
+            std::vector<int> key;
+            for (const auto& lit : clause) {
+                key.push_back(Minisat::toInt(mkLit(f_tcbi2var_map.at(lit.first), lit.second)));
+            }
+
+            std::sort(key.begin(), key.end());
+            if (f_exported.insert(key).second) {
+                shared.push_back(clause);
+            }
+        }
+
+        if (!shared.empty()) {
+            f_exchange->publish(f_step, shared);
+        }
+
+        size_t n { shared.size() };
+        DEBUG
+            << "Exported "
+            << n
+            << " learnt clauses"
+            << std::endl;
+    }
+
+    void Engine::retire_last_group()
+    {
+        /* MAINGROUP can not be retired */
+        assert(1 < f_groups.size());
+
+        group_t group { abs(f_groups.last()) };
+        f_groups.pop();
+
+        vec<Lit> ps;
+        ps.push(mkLit(group, true));
+        add_clause(ps);
+
+        DEBUG
+            << "Retired group var "
+            << group
+            << std::endl;
+
+        /* clauses of deep unrollings pile up, one group a step */
+        if (0 == ++f_retired % RETIREMENTS_PER_SIMPLIFY ||
+            (0 < f_memory_budget && f_memory_budget < clause_db_bytes())) {
+            f_backend->simplify();
+        }
+    }
+
+    status_t Engine::sat_solve_groups(const Groups& groups, const vec<Lit>* extra)
     {
         vec<Lit> assumptions;
 
-        clock_t t0 { clock() };
+        if (NULL != f_exchange && EXCHANGE_IMPORT == f_exchange_role) {
+            import_learnts();
+        }
+
+        struct timespec wall0, cpu0;
+        clock_gettime(CLOCK_MONOTONIC, &wall0);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
         for (int i = 0; i < groups.size(); ++i) {
             Var grp { groups[i] };
 
@@ -76,24 +641,63 @@ namespace sat {
             assumptions.push(mkLit(abs(grp), grp < 0));
         }
 
+        if (NULL != extra) {
+            for (int i = 0; i < extra->size(); ++i) {
+                assumptions.push((*extra)[i]);
+            }
+        }
+
         DEBUG
             << "Solving ..."
             << std::endl;
 
-        Minisat::lbool status { f_solver.solveLimited(assumptions) };
-        if (status == l_True) {
-            f_status = STATUS_SAT;
-        } else if (status == l_False) {
-            f_status = STATUS_UNSAT;
-        } else if (status == l_Undef) {
-            f_status = STATUS_UNKNOWN;
-        } else {
-            assert(false); /* unreachable */
+        if (NULL != f_tracer) {
+            f_tracer->solve(assumptions);
+        }
+
+        f_status = backend_solve(assumptions);
+
+        /* lazy array MUXes, refined until the model agrees with them */
+        while (STATUS_SAT == f_status && refine_lazy_muxes()) {
+            if (NULL != f_tracer) {
+                f_tracer->solve(assumptions);
+            }
+
+            f_status = backend_solve(assumptions);
         }
 
-        clock_t elapsed { clock() - t0 };
-        double secs { (double) elapsed / (double) CLOCKS_PER_SEC };
+        struct timespec wall1, cpu1;
+        clock_gettime(CLOCK_MONOTONIC, &wall1);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
 
+        SolveStats stats;
+        stats.step = f_step;
+        stats.status = f_status;
+        stats.wall_secs = (wall1.tv_sec - wall0.tv_sec) + 1e-9 * (wall1.tv_nsec - wall0.tv_nsec);
+        stats.cpu_secs = (cpu1.tv_sec - cpu0.tv_sec) + 1e-9 * (cpu1.tv_nsec - cpu0.tv_nsec);
+        counters(stats.counters);
+
+        if (NULL != f_exchange && EXCHANGE_EXPORT == f_exchange_role) {
+            export_learnts();
+        }
+
+        EngineMgr::INSTANCE()
+            .record_solve(this, stats);
+
+        utils::Profiler& profiler { utils::Profiler::INSTANCE() };
+        if (profiler.enabled()) {
+            profiler.charge(std::string("solve (") + name() + ")",
+                            stats.wall_secs, stats.cpu_secs);
+        }
+
+        utils::EventTracer::INSTANCE()
+            .complete("solve", "sat", wall0, wall1, name(), (long) f_step);
+
+        if (f_solve_observer) {
+            f_solve_observer(stats);
+        }
+
+        double secs { stats.wall_secs };
         DEBUG
             << "Took "
             << secs
@@ -105,6 +709,38 @@ namespace sat {
     }
 
     void Engine::push(compiler::Unit cu, step_t time, group_t group)
+    {
+        utils::ProfileScope scope { "cnf" };
+        utils::TraceScope trace { "push", "cnf", name() };
+
+        if (f_clause_filtering) {
+            f_clause_filter = &f_clause_filters[time];
+        }
+
+        push_aux(cu, time, group);
+        f_clause_filter = NULL;
+    }
+
+    /* no-cut takes a clause for each path to zero and no aux vars,
+     * single-cut an aux var and two to four clauses for each node. The
+     * former is taken for DDs with few paths to zero, and no more of
+     * them than twice their nodes, i.e. fewer clauses too */
+    cnf_strategy_t Engine::cnf_strategy(ADD add) const
+    {
+        if (CNF_ADAPTIVE != f_cnf_strategy) {
+            return f_cnf_strategy;
+        }
+
+        DdNode* node { add.getNode() };
+        double zero_paths { Cudd_CountPath(node) - Cudd_CountPathsToNonZero(node) };
+        int nodes { Cudd_DagSize(node) };
+
+        return (zero_paths <= f_cnf_no_cut_paths && zero_paths <= 2.0 * nodes)
+                   ? CNF_NO_CUT
+                   : CNF_SINGLE_CUT;
+    }
+
+    void Engine::push_aux(const compiler::Unit& cu, step_t time, group_t group)
     {
         /**
          * 1. Pushing DDs
@@ -113,11 +749,38 @@ namespace sat {
             const dd::DDVector& dv { cu.dds() };
             dd::DDVector::const_iterator i;
             for (i = dv.begin(); dv.end() != i; ++i) {
-                cnf_push_single_cut(*i, time, group);
-                // cnf_push_no_cut( *i, time, group );
+                uint64_t n_vars { f_n_vars };
+                uint64_t n_clauses { f_n_clauses };
+
+                CNFCounters* counters;
+                switch (cnf_strategy(*i)) {
+                    case CNF_POLARITY:
+                        cnf_push_polarity(*i, time, group);
+                        counters = &f_cnf_polarity;
+                        break;
+
+                    case CNF_NO_CUT:
+                        cnf_push_no_cut(*i, time, group);
+                        counters = &f_cnf_no_cut;
+                        break;
+
+                    default:
+                        cnf_push_single_cut(*i, time, group);
+                        counters = &f_cnf_single_cut;
+                        break;
+                }
+
+                ++counters->dds;
+                counters->vars += f_n_vars - n_vars;
+                counters->clauses += f_n_clauses - n_clauses;
             }
         }
 
+        /* the CNF of the DDs is all there is */
+        if (cu.dds_only()) {
+            return;
+        }
+
         /**
          * 2. Pushing CNF for inlined operators
          */
@@ -154,6 +817,10 @@ namespace sat {
 
                 compiler::BinarySelectionDescriptors::const_iterator i;
                 for (i = descriptors.begin(); descriptors.end() != i; ++i) {
+                    if (!first_mux_injection(i->aux(), time, group)) {
+                        continue;
+                    }
+
                     CNFBinarySelectionInliner worker { *this, time, group };
                     worker(*i);
                 }
@@ -171,25 +838,265 @@ namespace sat {
             };
             compiler::MultiwaySelectionDescriptors::const_iterator i;
             for (i = muxes.begin(); muxes.end() != i; ++i) {
+                if (!first_mux_injection(i->z()[0], time, group)) {
+                    continue;
+                }
+
+                if (i->is_lazy()) {
+                    push_lazy_mux(*i, time, group);
+                    continue;
+                }
+
                 CNFMultiwaySelectionInliner worker { *this, time, group };
                 worker(*i);
             }
         }
+
+        /**
+         * 5. Pushing AIG nodes
+         */
+        {
+            const compiler::AigDescriptors& nodes {
+                cu.aig_descriptors()
+            };
+            compiler::AigDescriptors::const_iterator i;
+            for (i = nodes.begin(); nodes.end() != i; ++i) {
+                CNFAigInliner worker { *this, time, group };
+                worker(*i);
+            }
+        }
+    }
+
+    /* Clauses of the same frame are checked against those already
+     * pushed on it: exact duplicates are dropped, and so are clauses
+     * containing a unit or a binary clause of the frame. Group
+     * literals are literals as any other, a clause of a group is only
+     * subsumed by clauses of the same group (or of none). Long clauses
+     * are only checked for duplicates, their subsets are too many. */
+    bool Engine::filter_clause(const vec<Lit>& ps)
+    {
+        ClauseFilter& filter { *f_clause_filter };
+
+        std::vector<int> lits;
+        lits.reserve(ps.size());
+        for (int i = 0; i < ps.size(); ++i) {
+            lits.push_back(toInt(ps[i]));
+        }
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+
+        if (filter.clauses.end() != filter.clauses.find(lits)) {
+            ++f_dropped_duplicates;
+            return true;
+        }
+
+        if (lits.size() <= CLAUSE_FILTER_MAX_SUBSUMPTION) {
+            for (unsigned i = 0; i < lits.size(); ++i) {
+                if (filter.units.end() != filter.units.find(lits[i])) {
+                    ++f_dropped_subsumed;
+                    return true;
+                }
+            }
+
+            for (unsigned i = 0; i < lits.size(); ++i) {
+                for (unsigned j = i + 1; j < lits.size(); ++j) {
+                    if (filter.binaries.end() !=
+                        filter.binaries.find(std::make_pair(lits[i], lits[j]))) {
+                        ++f_dropped_subsumed;
+                        return true;
+                    }
+                }
+            }
+        }
+
+        if (1 == lits.size()) {
+            filter.units.insert(lits[0]);
+        } else if (2 == lits.size()) {
+            filter.binaries.insert(std::make_pair(lits[0], lits[1]));
+        }
+        filter.clauses.insert(lits);
+
+        return false;
     }
 
     Var Engine::find_dd_var(const DdNode* node, step_t time)
     {
         assert(NULL != node && !Cudd_IsConstant(node));
-        const enc::UCBI& ucbi { find_ucbi(node->index) };
-        const enc::TCBI tcbi { ucbi, time };
-        return tcbi_to_var(tcbi);
+        return find_dd_var(node->index, time);
     }
 
     Var Engine::find_dd_var(int node_index, step_t time)
     {
+        /* a pair of array reads, once booked */
+        Var* slot { f_dd_vars.slot(node_index, time) };
+        if (NULL != slot && 0 <= *slot) {
+            return *slot;
+        }
+
         const enc::UCBI& ucbi { find_ucbi(node_index) };
         const enc::TCBI tcbi { ucbi, time };
-        return tcbi_to_var(tcbi);
+        Var var { tcbi_to_var(tcbi) };
+
+        if (NULL != slot) {
+            *slot = var;
+        }
+
+        return var;
+    }
+
+    Var Engine::find_aig_var(unsigned node, step_t time)
+    {
+        TAig2VarMap::const_iterator eye { f_taig2var_map.find(std::make_pair(node, time)) };
+        return f_taig2var_map.end() != eye ? eye->second : -1;
+    }
+
+    void Engine::register_aig_var(unsigned node, step_t time, Var var)
+    {
+        f_taig2var_map.insert(std::make_pair(std::make_pair(node, time), var));
+    }
+
+    bool Engine::first_mux_injection(const ADD& aux, step_t time, group_t group)
+    {
+        return f_injected_muxes.insert(
+                   std::make_pair(std::make_pair(aux.getNode(), time), group))
+            .second;
+    }
+
+    void Engine::push_lazy_mux(const compiler::MultiwaySelectionDescriptor& md,
+                               step_t time, group_t group)
+    {
+        LazyArrayMux mux;
+
+        mux.elem_width = md.elem_width();
+        mux.elem_count = md.elem_count();
+        mux.group = group;
+
+        /* vars are all allocated here, models have values for them */
+        for (const auto& dd : md.index()) {
+            mux.index.push_back(dd_lit(dd, time));
+        }
+        for (const auto& dd : md.z()) {
+            mux.z.push_back(dd_lit(dd, time));
+        }
+        for (const auto& dd : md.x()) {
+            mux.x.push_back(dd_lit(dd, time));
+        }
+        mux.refined.resize(mux.elem_count, false);
+
+        /* refinements would refer to vars possibly eliminated */
+        if (f_frame_elimination || !f_transient_inputs.empty()) {
+            for (unsigned j = 0; j < mux.elem_count; ++j) {
+                inject_lazy_mux_element(mux, j);
+            }
+
+            return;
+        }
+
+        f_lazy_muxes.push_back(mux);
+    }
+
+    void Engine::flush_lazy_muxes()
+    {
+        for (auto& mux : f_lazy_muxes) {
+            for (unsigned j = 0; j < mux.elem_count; ++j) {
+                if (!mux.refined[j]) {
+                    inject_lazy_mux_element(mux, j);
+                }
+            }
+        }
+
+        f_lazy_muxes.clear();
+    }
+
+    bool Engine::refine_lazy_muxes()
+    {
+        unsigned refined { 0 };
+
+        for (auto& mux : f_lazy_muxes) {
+            if (MAINGROUP != mux.group && 1 != value(mux.group)) {
+                continue;
+            }
+
+            uint64_t j { 0 };
+            unsigned iwidth { static_cast<unsigned>(mux.index.size()) };
+            for (unsigned i = 0; i < iwidth && i < 64; ++i) {
+                if (lit_value(mux.index[iwidth - i - 1])) {
+                    j |= (1ULL << i);
+                }
+            }
+
+            if (mux.elem_count <= j || mux.refined[j]) {
+                continue;
+            }
+
+            for (unsigned k = 0; k < mux.elem_width; ++k) {
+                if (lit_value(mux.z[k]) != lit_value(mux.x[j * mux.elem_width + k])) {
+                    inject_lazy_mux_element(mux, j);
+                    ++refined;
+                    break;
+                }
+            }
+        }
+
+        if (refined) {
+            DEBUG
+                << "Refined "
+                << refined
+                << " lazy array MUXes"
+                << std::endl;
+        }
+
+        return 0 < refined;
+    }
+
+    /* index = j -> z = x[j] */
+    void Engine::inject_lazy_mux_element(LazyArrayMux& mux, unsigned j)
+    {
+        unsigned iwidth { static_cast<unsigned>(mux.index.size()) };
+
+        vec<Lit> premise;
+        if (MAINGROUP != mux.group) {
+            premise.push(mkLit(mux.group, true));
+        }
+        for (unsigned i = 0; i < iwidth; ++i) {
+            bool bit { i < 64 && ((uint64_t) j >> i) & 1 };
+            Lit lit { mux.index[iwidth - i - 1] };
+            premise.push(bit ? ~lit : lit);
+        }
+
+        for (unsigned pol = 0; pol < 2; ++pol) {
+            for (unsigned k = 0; k < mux.elem_width; ++k) {
+                vec<Lit> ps;
+                premise.copyTo(ps);
+
+                Lit z { mux.z[k] };
+                Lit x { mux.x[j * mux.elem_width + k] };
+                ps.push(pol ? z : ~z);
+                ps.push(pol ? ~x : x);
+                add_clause(ps);
+            }
+        }
+
+        mux.refined[j] = true;
+    }
+
+    /* DD bits are model vars, or constants */
+    Lit Engine::dd_lit(const ADD& dd, step_t time)
+    {
+        /* true */
+        const Var alpha { 0 };
+
+        DdNode* node { dd.getNode() };
+        if (Cudd_IsConstant(node)) {
+            return mkLit(alpha, 0 == Cudd_V(node));
+        }
+
+        return mkLit(find_dd_var(node, time));
+    }
+
+    bool Engine::lit_value(Lit lit)
+    {
+        return (1 == value(Minisat::var(lit))) != Minisat::sign(lit);
     }
 
     Var Engine::find_cnf_var(const DdNode* node, step_t time)
@@ -197,14 +1104,20 @@ namespace sat {
         Var res;
 
         assert(NULL != node);
-        TimedDD timed_node { const_cast<DdNode*>(node), time };
+        DdNode* key { const_cast<DdNode*>(node) };
+
+        /* CNF-ization of a unit takes place within a single frame */
+        if (NULL == f_cnf_frame || time != f_cnf_frame_time) {
+            f_cnf_frame = &f_tdd2var_map[time];
+            f_cnf_frame_time = time;
+        }
 
-        TDD2VarMap::const_iterator eye { f_tdd2var_map.find(timed_node) };
-        if (f_tdd2var_map.end() == eye) {
+        DD2VarMap::const_iterator eye { f_cnf_frame->find(key) };
+        if (f_cnf_frame->end() == eye) {
             res = new_sat_var();
 
             /* Insert into tdd2var map */
-            f_tdd2var_map.insert(std::pair<TimedDD, Var>(timed_node, res));
+            f_cnf_frame->insert(std::pair<DdNode*, Var>(key, res));
 
 #if 0
             DRIVEL
@@ -220,42 +1133,40 @@ namespace sat {
         return res;
     }
 
-    void Engine::clear_cnf_map()
+    void Engine::fix_bit(const enc::UCBI& ucbi, bool value)
     {
-        f_rewrite_map.clear();
+        const enc::TCBI key { enc::UCBI(ucbi.expr(), FROZEN, ucbi.bitno()), 0 };
+        f_fixed_bits[key] = value;
     }
 
-    Var Engine::rewrite_cnf_var(Var v, step_t time)
+    void Engine::set_transient_input(const enc::UCBI& ucbi)
     {
-        Var res;
-
-        TimedVar timed_var(v, time);
-        RewriteMap::const_iterator eye {
-            f_rewrite_map.find(timed_var)
-        };
-
-        if (f_rewrite_map.end() == eye) {
-            res = new_sat_var();
-
-            /* Insert into tvv2var map */
-            f_rewrite_map.insert(std::pair<TimedVar, Var>(timed_var, res));
+        const enc::TCBI key { enc::UCBI(ucbi.expr(), FROZEN, ucbi.bitno()), 0 };
+        f_transient_inputs.insert(key);
+    }
 
-#if 0
-            DRIVEL
-                << "Rewrote microcode cnf var "
-                << v << "@" << time
-                << " as "
-                << res
-                << std::endl;
-#endif
-        } else {
-            res = (*eye).second;
+    unsigned Engine::eliminated_inputs() const
+    {
+        unsigned res { 0 };
+        for (const auto var : f_transient_vars) {
+            if (f_backend->is_eliminated(var)) {
+                ++res;
+            }
         }
+
         return res;
     }
 
     Var Engine::tcbi_to_var(const enc::TCBI& tcbi)
     {
+        /* fixed bits are time invariant */
+        if (!f_fixed_bits.empty() && FROZEN != tcbi.time()) {
+            const enc::TCBI key { enc::UCBI(tcbi.expr(), FROZEN, tcbi.bitno()), 0 };
+            if (f_fixed_bits.end() != f_fixed_bits.find(key)) {
+                return tcbi_to_var(key);
+            }
+        }
+
         Var var;
         const TCBI2VarMap::iterator eye {
             f_tcbi2var_map.find(tcbi)
@@ -264,31 +1175,126 @@ namespace sat {
         if (f_tcbi2var_map.end() != eye) {
             var = eye->second;
         } else {
-            /* generate a new var and book it. Newly created var is not eliminable. */
-            var = new_sat_var(true);
+            /* the frame is booked as a whole, the var may be in it */
+            if (FROZEN != tcbi.time() && reserve_frame(tcbi.absolute_time())) {
+                return tcbi_to_var(tcbi);
+            }
+
+            /* transient inputs are left to preprocessing */
+            bool transient { false };
+            if (!f_transient_inputs.empty() && FROZEN != tcbi.time()) {
+                const enc::TCBI key { enc::UCBI(tcbi.expr(), FROZEN, tcbi.bitno()), 0 };
+                transient = f_transient_inputs.end() != f_transient_inputs.find(key);
+            }
+
+            /* generate a new var and book it. Newly created var is not
+               eliminable, unless transient. */
+            var = new_sat_var(!transient);
 
             DRIVEL
                 << "Adding model var " << var
                 << " for " << tcbi
                 << std::endl;
 
-            f_tcbi2var_map.insert(std::pair<enc::TCBI, Var>(tcbi, var));
-            f_var2tcbi_map.insert(std::pair<Var, enc::TCBI>(var, tcbi));
+            const TCBI2VarMap::iterator booked {
+                f_tcbi2var_map.insert(std::pair<enc::TCBI, Var>(tcbi, var)).first
+            };
+            if (f_var2tcbi_map.size() <= (size_t) var) {
+                f_var2tcbi_map.resize(1 + var, NULL);
+            }
+            f_var2tcbi_map[var] = &booked->first;
+
+            /* frozen (i.e. time invariant) vars are never released */
+            if (transient) {
+                f_transient_vars.push_back(var);
+            } else if (f_frame_elimination && FROZEN != tcbi.time()) {
+                f_frame_vars[tcbi.absolute_time()].push_back(var);
+            }
+
+            if (NULL != f_tracer) {
+                f_tracer->add_model_var(var, tcbi);
+            }
+
+            prioritize(var, booked->first);
+
+            if (FROZEN != tcbi.time()) {
+                const enc::TCBI key { enc::UCBI(tcbi.expr(), FROZEN, tcbi.bitno()), 0 };
+                if (f_layout_bits.insert(key).second) {
+                    f_frame_layout.push_back(enc::UCBI(tcbi.expr(), 0, tcbi.bitno()));
+                }
+            }
+
+            const FixedBitsMap::const_iterator fixed {
+                f_fixed_bits.find(tcbi)
+            };
+            if (f_fixed_bits.end() != fixed) {
+                vec<Lit> ps;
+                ps.push(mkLit(var, !fixed->second));
+                add_clause(ps);
+            }
         }
 
         return var;
     }
 
-    enc::TCBI& Engine::var_to_tcbi(Var var)
+    /* Model bits are thus contiguous within each frame, rather than
+     * interleaved with the CNF vars of its units (and those of other
+     * frames), and every frame but the first has them in the same
+     * order: the vars of a bit in two frames are a block apart, as
+     * long as the layout did not grow in between. Bits are booked
+     * along with their frame whether used there or not, hence only
+     * those used elsewhere already. */
+    bool Engine::reserve_frame(step_t time)
     {
-        const Var2TCBIMap::iterator eye {
-            f_var2tcbi_map.find(var)
-        };
+        if (!f_reserved_frames.insert(time).second) {
+            return false;
+        }
+
+        /* bits of the layout are booked already, it does not grow */
+        for (unsigned i = 0; i < f_frame_layout.size(); ++i) {
+            tcbi_to_var(enc::TCBI(f_frame_layout[i], time));
+        }
+
+        return true;
+    }
+
+    void Engine::set_decision_order(decision_order_t order)
+    {
+        f_decision_order = order;
 
+        for (const auto& entry : f_tcbi2var_map) {
+            prioritize(entry.second, entry.first);
+        }
+    }
+
+    /* frames are counted from the first one: positive times from 0,
+       negative ones (backward unrollings) from UINT_MAX. Frozen bits
+       hold in all frames, they come first */
+    void Engine::prioritize(Var var, const enc::TCBI& tcbi)
+    {
+        if (DECISION_ORDER_NONE == f_decision_order) {
+            return;
+        }
+
+        double priority { 1.0 };
+        if (FROZEN != tcbi.time()) {
+            step_t time { tcbi.absolute_time() };
+            double distance { (double) (time < FROZEN ? time : UINT_MAX - time) };
+
+            priority = DECISION_ORDER_FRAMES == f_decision_order
+                           ? 0.5 / (1.0 + distance)
+                           : 0.5 - 0.5 / (1.0 + distance);
+        }
+
+        f_backend->set_priority(var, priority);
+    }
+
+    const enc::TCBI& Engine::var_to_tcbi(Var var) const
+    {
         /* TCBI *has* to be there already. */
-        assert(f_var2tcbi_map.end() != eye);
+        assert(is_model_var(var));
 
-        return eye->second;
+        return *f_var2tcbi_map[var];
     }
 
 }; // namespace sat
@@ -28,16 +28,40 @@
 #ifndef SAT_ENGINE_H
 #define SAT_ENGINE_H
 
+#include <dd/dd_walker.hh>
+
 #include <enc/enc_mgr.hh>
 
 #include <compiler/typedefs.hh>
 
+#include <sat/backend.hh>
+#include <sat/cnf_template.hh>
+#include <sat/dimacs.hh>
+#include <sat/exchange.hh>
 #include <sat/typedefs.hh>
 
 #include <utils/logging.hh>
 
+#include <boost/function.hpp>
+
+#include <ctime>
+
 namespace sat {
 
+    /* called after each solve() with its statistics */
+    typedef boost::function<void(const SolveStats&)> SolveObserver;
+
+    /* called between the slices of a time-sliced solve() */
+    typedef boost::function<void()> SliceHook;
+
+    /* clauses pushed on a time frame, as sorted literals, and its unit
+       and binary clauses on their own (see --clause-filter) */
+    struct ClauseFilter {
+        boost::unordered_set<std::vector<int> > clauses;
+        boost::unordered_set<int> units;
+        boost::unordered_set<std::pair<int, int> > binaries;
+    };
+
     class Engine {
     public:
         /**
@@ -65,6 +89,18 @@ namespace sat {
             f_groups.last() *= -1;
         }
 
+        /**
+     * @brief Permanently retires last group for the SAT instance.
+     *
+     * The group is committed as disabled by a unit clause and dropped
+     * from the assumptions, so that the solver can simplify away all
+     * of its (now satisfied) clauses. Unlike an inverted group, a
+     * retired group can not be enabled again. The backend simplifies
+     * every few retirements, or right away when over its memory
+     * budget.
+     */
+        void retire_last_group();
+
         /**
      * @brief Returns the complete set of defined SAT groups.
      *
@@ -82,7 +118,23 @@ namespace sat {
         void push(compiler::Unit cu, step_t time, group_t group = MAINGROUP);
 
         /**
-     * @brief Invoke Minisat
+     * @brief add a CNF-ized formula to the SAT problem instance.
+     */
+        inline void push(const CNFTemplate& tmpl, step_t time, group_t group = MAINGROUP)
+        {
+            tmpl.instantiate(*this, time, group);
+        }
+
+        /**
+     * @brief Releases a time frame that will never be referred to
+     * again: its model vars are unfrozen and eliminated by the
+     * backend, where possible. No-op unless frame elimination is
+     * enabled by program options, or by a memory budget.
+     */
+        void release_frame(step_t time);
+
+        /**
+     * @brief Invoke the SAT backend
      */
         inline status_t solve()
         {
@@ -90,22 +142,121 @@ namespace sat {
         }
 
         /**
-     * @brief Interrupt Minisat
+     * @brief Invoke the SAT backend, under additional assumptions
+     */
+        inline status_t solve(const vec<Lit>& assumptions)
+        {
+            return sat_solve_groups(f_groups, &assumptions);
+        }
+
+        /**
+     * @brief True iff given assumption was needed to prove the last
+     * UNSAT result, i.e. it belongs to the final conflict.
+     */
+        inline bool failed(Lit assumption)
+        {
+            return f_backend->failed(assumption);
+        }
+
+        /**
+     * @brief Interrupt the SAT backend
      */
         inline void interrupt()
         {
-            f_solver.interrupt();
+            f_backend->interrupt();
         }
 
         /**
-     * @brief Configure Minisat
+     * @brief Clears a past interruption, so that an engine can be
+     * used again (e.g. by a later command)
      */
-        inline void configure(int64_t conf_budget, int64_t prop_budget)
+        inline void clear_interrupt()
         {
-            f_solver.setConfBudget(conf_budget);
-            f_solver.setPropBudget(prop_budget);
+            f_backend->clear_interrupt();
         }
 
+        /**
+     * @brief Configure the SAT backend
+     */
+        void configure(int64_t conf_budget, int64_t prop_budget);
+
+        /**
+     * @brief Memory budget of the clause database (0 for none):
+     * learnts are reduced to fit, and the frames released are
+     * eliminated, their clauses go with their vars
+     */
+        void set_memory_budget(uint64_t max_bytes);
+
+        /**
+     * @brief Time slicing: each solve() runs in slices of at most
+     * quantum conflicts, hook is called in between (e.g. to give way
+     * to other strategies). The budget set by configure() still
+     * bounds the whole solve(). A zero quantum disables slicing
+     */
+        inline void set_time_slicing(int64_t quantum, SliceHook hook)
+        {
+            f_quantum = quantum;
+            f_slice_hook = hook;
+        }
+
+        /**
+     * @brief Sets the scope (e.g. the owning algorithm), used for
+     * scoped interruptions
+     */
+        inline void set_scope(const void* scope)
+        {
+            f_scope = scope;
+        }
+
+        inline const void* scope() const
+        {
+            return f_scope;
+        }
+
+        /**
+     * @brief True iff CNF tracing is enabled
+     */
+        inline bool traced() const
+        {
+            return NULL != f_tracer;
+        }
+
+        /**
+     * @brief Bytes taken by the backend clause database and by the
+     * CNF registries of this instance, estimates
+     */
+        uint64_t clause_db_bytes() const;
+        uint64_t registry_bytes() const;
+
+        /**
+     * @brief Backend counters, so far
+     */
+        inline void counters(SolverCounters& counters) const
+        {
+            f_backend->counters(counters);
+            counters.eliminated_inputs = eliminated_inputs();
+            counters.dropped_duplicates = f_dropped_duplicates;
+            counters.dropped_subsumed = f_dropped_subsumed;
+            counters.single_cut = f_cnf_single_cut;
+            counters.no_cut = f_cnf_no_cut;
+            counters.polarity = f_cnf_polarity;
+        }
+
+        /**
+     * @brief Observer of solve() statistics (e.g. tracking memory
+     * per unrolling step), called in the solving thread
+     */
+        inline void set_solve_observer(SolveObserver observer)
+        {
+            f_solve_observer = observer;
+        }
+
+        /**
+     * @brief Sets the unrolling step, used for statistics and
+     * clause sharing. Steps are reported as spans when tracing
+     */
+        void set_step(step_t step);
+
         /**
      * @brief Last solving status
      */
@@ -115,12 +266,12 @@ namespace sat {
         }
 
         /**
-     * @brief Fetch variable value from Minisat model
+     * @brief Fetch variable value from the SAT backend model
      */
         inline int value(Var var)
         {
             assert(STATUS_SAT == f_status);
-            return 0 == Minisat::toInt(f_solver.modelValue(var));
+            return f_backend->value(var);
         }
 
         /**
@@ -128,10 +279,59 @@ namespace sat {
      */
         Var tcbi_to_var(const enc::TCBI& tcbi);
 
+        /**
+     * @brief Seeds the phase of the var of tcbi: decisions on it try
+     * value first (e.g. its value in a previous witness)
+     */
+        inline void set_phase(const enc::TCBI& tcbi, bool value)
+        {
+            f_backend->set_phase(tcbi_to_var(tcbi), value);
+        }
+
+        /**
+     * @brief Decisions pick vars of higher priority (in [0, 1])
+     * first, until conflicts bump other vars past them
+     */
+        inline void set_priority(Var var, double priority)
+        {
+            f_backend->set_priority(var, priority);
+        }
+
+        /**
+     * @brief Model vars are decided upon first, by frame (defaults to
+     * --decision-order). Vars booked so far are prioritized as well
+     */
+        void set_decision_order(decision_order_t order);
+
+        /**
+     * @brief Fixes a model bit to value at all times: all of its
+     * TCBIs share a single var, asserted by a unit clause. To be
+     * invoked before the bit is first referred to.
+     */
+        void fix_bit(const enc::UCBI& ucbi, bool value);
+
+        /**
+     * @brief Marks an input bit as transient: its vars are not
+     * frozen, and are left to the backend preprocessing. Only for
+     * inputs whose vars are referred to by a single batch of clauses
+     * (e.g. the TRANS of their frame), and never again once solved.
+     * To be invoked before the bit is first referred to.
+     */
+        void set_transient_input(const enc::UCBI& ucbi);
+
         /**
      * @brief Minisat variable -> TCBI mapping
      */
-        enc::TCBI& var_to_tcbi(Var var);
+        const enc::TCBI& var_to_tcbi(Var var) const;
+
+        /**
+     * @brief true iff var is a model var (i.e. it has a TCBI)
+     */
+        inline bool is_model_var(Var var) const
+        {
+            return 0 <= var && var < (Var) f_var2tcbi_map.size() &&
+                   NULL != f_var2tcbi_map[var];
+        }
 
         /**
      * @brief DD index -> UCBI mapping
@@ -157,25 +357,43 @@ namespace sat {
         Var find_cnf_var(const DdNode* node, step_t time);
 
         /**
-     * @brief CNF registry for injection CNF var
+     * @brief Timed AIG nodes to Minisat variable mapping, -1 if the
+     * node has not been CNF-ized yet
+     */
+        Var find_aig_var(unsigned node, step_t time);
+        void register_aig_var(unsigned node, step_t time, Var var);
+
+        /**
+     * @brief True iff the selection MUX owning DD var aux (i.e. the
+     * activation var of ITEs, the first output bit of arrays) has not
+     * been injected yet at time, within group. Units built on shared
+     * subexpressions (e.g. DEFINEs) share their MUXes.
      */
-        void clear_cnf_map();
+        bool first_mux_injection(const ADD& aux, step_t time, group_t group);
 
         /**
-     * @brief Rewrites a CNF var
+     * @brief Registers a lazy array MUX. Its elements are constrained
+     * on demand by solve(), when a model selects them with a value
+     * other than the MUX output. With frame elimination all of them
+     * are constrained at once, frames may not be refined later.
      */
-        Var rewrite_cnf_var(Var var, step_t time);
+        void push_lazy_mux(const compiler::MultiwaySelectionDescriptor& md,
+                           step_t time, group_t group);
+
+        /**
+     * @brief Constrains all the elements of the lazy array MUXes
+     * pushed so far, for instances whose clauses are used elsewhere
+     * (e.g. CNF templates).
+     */
+        void flush_lazy_muxes();
 
         /**
      * @brief a new Minisat variable
      */
         inline Var new_sat_var(bool frozen = false) // proxy
         {
-            Var var(f_solver.newVar());
-
-            f_solver.setFrozen(var, frozen);
-
-            return var;
+            ++f_n_vars;
+            return f_backend->new_var(frozen);
         }
 
         /**
@@ -183,13 +401,84 @@ namespace sat {
      */
         inline void add_clause(vec<Lit>& ps) // proxy
         {
-            f_solver.addClause_(ps);
+            if (NULL != f_clause_filter && filter_clause(ps)) {
+                return;
+            }
+
+            if (NULL != f_tracer) {
+                f_tracer->add_clause(ps);
+            }
+
+            ++f_n_clauses;
+            f_backend->add_clause(ps);
         }
 
         /**
-     * @brief SAT instance ctor
+     * @brief trace clauses and queries as DIMACS/iCNF files, named
+     * after prefix. To be enabled before any clause is added.
+     */
+        void trace_cnf(const std::string& prefix);
+
+        /**
+     * @brief records clauses in memory (unless traced already), for
+     * remote solving. To be enabled before any clause is added.
+     */
+        void record_cnf();
+
+        /**
+     * @brief the recorded clauses from the first-th on, as zero
+     * terminated DIMACS literals, and their number so far
      */
-        Engine(const char* instance_name);
+        unsigned recorded_clauses(unsigned first, std::vector<int>& out) const;
+
+        /**
+     * @brief DIMACS assumptions of a query, i.e. the groups
+     */
+        void query_assumptions(std::vector<int>& out) const;
+
+        /**
+     * @brief join a learnt clauses exchange channel. Importers fetch
+     * shared clauses before each solve(), exporters publish their
+     * short learnts over model vars after it.
+     */
+        void join_exchange(const std::string& channel, exchange_role_t role);
+
+        /**
+     * @brief learnts over model vars of at most max_size literals, as
+     * TCBI clauses, e.g. to be added to another engine unrolling the
+     * same model (or to this one, once restarted).
+     */
+        void model_learnts(unsigned max_size, SharedClauses& out) const;
+
+        /**
+     * @brief adds TCBI clauses, those constraining a released frame
+     * are dropped.
+     */
+        void add_model_clauses(const SharedClauses& clauses);
+
+        /**
+     * @brief SAT instance ctor, backend defaults to the one selected
+     * by program options.
+     */
+        Engine(const char* instance_name, const char* backend_name = NULL);
+
+        /**
+     * @brief SAT instance ctor, with an explicit backend. Backend
+     * ownership is transferred to the engine.
+     */
+        Engine(const char* instance_name, SolverBackend_ptr backend);
+
+        /**
+     * @brief SAT instance fork, on a backend of the same kind as the
+     * parent's: clauses (learnts included), groups and the TCBI and
+     * CNF registries are those of the parent, so that the fork starts
+     * from its unrolling rather than from scratch. The parent must be
+     * recording its CNF (see record_cnf), the fork records it as well
+     * and can be forked in turn. Not to be called while the parent is
+     * solving. Observers, time slicing, budgets and clause exchanges
+     * are not inherited.
+     */
+        Engine(const char* instance_name, const Engine& parent);
 
         /**
      * @brief SAT instance dctor
@@ -201,6 +490,16 @@ namespace sat {
             return f_enc_mgr;
         }
 
+        inline const char* name() const
+        {
+            return f_instance_name;
+        }
+
+        inline const char* backend_name() const
+        {
+            return f_backend->name();
+        }
+
     private:
         const char* f_instance_name;
 
@@ -208,14 +507,91 @@ namespace sat {
 
         // CNF registry
         TDD2VarMap f_tdd2var_map;
-        RewriteMap f_rewrite_map;
+
+        // the frame of the last find_cnf_var (map nodes are stable)
+        DD2VarMap* f_cnf_frame;
+        step_t f_cnf_frame_time;
+        TAig2VarMap f_taig2var_map;
+        TimedMuxSet f_injected_muxes;
 
         // Bidirectional time mapping
         TCBI2VarMap f_tcbi2var_map;
         Var2TCBIMap f_var2tcbi_map;
 
-        // SAT solver, currently Minisat
-        SimpSolver f_solver;
+        // frame-major layout: the first model var of a frame books
+        // the vars of the whole frame, in a block laid out as the
+        // bits used so far (by their FROZEN TCBI, in order of first
+        // use). Bits first used later are appended to the layout,
+        // and allocated one at a time on frames already booked
+        std::vector<enc::UCBI> f_frame_layout;
+        TCBISet f_layout_bits;
+        boost::unordered_set<step_t> f_reserved_frames;
+
+        // true iff the frame was not booked already
+        bool reserve_frame(step_t time);
+
+        // model vars by DD index and time, the fast path of find_dd_var
+        DDVarTable f_dd_vars;
+
+        // constant model bits (if any)
+        FixedBitsMap f_fixed_bits;
+
+        // SAT solver backend, owned by this instance
+        SolverBackend_ptr f_backend;
+
+        // CNF tracer (optional), owned by this instance
+        DimacsTracer_ptr f_tracer;
+
+        // learnt clauses exchange (optional)
+        ClauseExchange_ptr f_exchange;
+        std::string f_exchange_channel;
+        exchange_role_t f_exchange_role;
+        size_t f_exchange_cursor;
+        unsigned f_exchange_max_size;
+        boost::unordered_set<std::vector<int> > f_exported;
+
+        // clause database budget (0 = none), retirements since the last
+        // backend simplification
+        uint64_t f_memory_budget;
+        unsigned f_retired;
+
+        // incremental frame elimination, model vars by absolute time
+        bool f_frame_elimination;
+        boost::unordered_map<step_t, VarVector> f_frame_vars;
+
+        // per-frame clause filter (optional), the filter of the frame
+        // being pushed (if any), and the clauses dropped so far
+        bool f_clause_filtering;
+        boost::unordered_map<step_t, ClauseFilter> f_clause_filters;
+        ClauseFilter* f_clause_filter;
+        uint64_t f_dropped_duplicates;
+        uint64_t f_dropped_subsumed;
+        bool filter_clause(const vec<Lit>& ps);
+
+        // transient input bits (if any), and their vars
+        TCBISet f_transient_inputs;
+        VarVector f_transient_vars;
+        unsigned eliminated_inputs() const;
+
+        // CNFization algorithm for DDs, and the max paths to zero of
+        // the DDs CNF-ized without cuts by the adaptive one
+        cnf_strategy_t f_cnf_strategy;
+        unsigned f_cnf_no_cut_paths;
+
+        // vars and clauses given to the backend so far, and their
+        // share by CNFization algorithm
+        uint64_t f_n_vars;
+        uint64_t f_n_clauses;
+        CNFCounters f_cnf_single_cut;
+        CNFCounters f_cnf_no_cut;
+        CNFCounters f_cnf_polarity;
+
+        // decisions on model vars, and the priority of each of them
+        decision_order_t f_decision_order;
+        void prioritize(Var var, const enc::TCBI& tcbi);
+
+        // stack and visited marks of the CNF builders, kept across units
+        dd::ADDWalkerScratch f_walker_scratch;
 
         // used to partition the formula to be solved using assumptions
         Groups f_groups;
@@ -223,39 +599,55 @@ namespace sat {
         // last solve() status
         status_t f_status;
 
-        // -- CNF ------------------------------------------------------------
-        Index2VarMap f_index2var_map;
-        inline Var index2var(int index)
-        {
-            Index2VarMap::const_iterator eye(f_index2var_map.find(index));
+        // interruption scope (optional)
+        const void* f_scope;
 
-            if (eye != f_index2var_map.end())
-                return (*eye).second;
+        // current unrolling step (statistics only)
+        step_t f_step;
 
-            return -1; /* cnf var */
-        }
+        // when the current step was set (tracing only)
+        struct timespec f_step_start;
+        void trace_step();
 
-        Var2IndexMap f_var2index_map;
-        inline int var2index(Var v)
-        {
-            Var2IndexMap::const_iterator eye(f_var2index_map.find(v));
+        // solve() statistics observer (optional)
+        SolveObserver f_solve_observer;
 
-            if (eye != f_var2index_map.end())
-                return (*eye).second;
+        // time slicing (optional), and the budgets of configure()
+        // (conflicts as an absolute count, -1 for none)
+        int64_t f_quantum;
+        SliceHook f_slice_hook;
+        int64_t f_conf_limit;
+        int64_t f_prop_budget;
 
-            return -1; /* cnf var */
-        }
+        status_t backend_solve(const vec<Lit>& assumptions);
 
         Group2VarMap f_groups_map;
 
         // -- Low level services -----------------------------------------------
+        void initialize();
+
+        void push_aux(const compiler::Unit& cu, step_t time, group_t group);
+
         Lit cnf_find_group_lit(group_t group, bool enabled = true);
 
-        status_t sat_solve_groups(const Groups& groups);
+        status_t sat_solve_groups(const Groups& groups, const vec<Lit>* extra = NULL);
+
+        /* lazy array MUXes, true iff any was refined on the last
+           model */
+        LazyArrayMuxes f_lazy_muxes;
+        bool refine_lazy_muxes();
+        void inject_lazy_mux_element(LazyArrayMux& mux, unsigned j);
+        Lit dd_lit(const ADD& dd, step_t time);
+        bool lit_value(Lit lit);
+
+        void import_learnts();
+        void export_learnts();
 
-        /* CNFization algorithms */
+        /* CNFization algorithms, and the one for add */
+        cnf_strategy_t cnf_strategy(ADD add) const;
         void cnf_push_no_cut(ADD add, step_t time, const group_t group);
         void cnf_push_single_cut(ADD add, step_t time, const group_t group);
+        void cnf_push_polarity(ADD add, step_t time, const group_t group);
 
         friend std::ostream& operator<<(std::ostream& os, const Engine& engine);
     };
@@ -23,17 +23,32 @@
 
 #include <sat/engine.hh>
 #include <sat/engine_mgr.hh>
+#include <sat/sat.hh>
 
+#include <cerrno>
 #include <csignal>
+#include <iomanip>
 
-namespace sat {
+#include <unistd.h>
+
+#include <jsoncpp/json/json.h>
+
+#include <opts/opts_mgr.hh>
 
-    EngineMgr_ptr EngineMgr::f_instance { NULL };
+#include <utils/memory.hh>
+
+namespace sat {
 
     EngineMgr::EngineMgr()
+        : f_assigned(0)
+        , f_progress_fd(-1)
     {
         const void* instance { this };
 
+        utils::MemoryMgr& mem { utils::MemoryMgr::INSTANCE() };
+        mem.add_probe("sat clauses", [this]() { return clause_db_bytes(); });
+        mem.add_probe("sat registries", [this]() { return registry_bytes(); });
+
         DRIVEL
             << "Initialized EngineMgr @ " << instance
             << std::endl;
@@ -49,6 +64,30 @@ namespace sat {
             << std::endl;
     }
 
+    size_t EngineMgr::clause_db_bytes()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        size_t res { 0 };
+        for (const auto engine : f_engines) {
+            res += engine->clause_db_bytes();
+        }
+
+        return res;
+    }
+
+    size_t EngineMgr::registry_bytes()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        size_t res { 0 };
+        for (const auto engine : f_engines) {
+            res += engine->registry_bytes();
+        }
+
+        return res;
+    }
+
     void EngineMgr::register_instance(Engine_ptr engine)
     {
         boost::mutex::scoped_lock lock { f_mutex };
@@ -63,6 +102,14 @@ namespace sat {
             << std::endl;
 
         f_engines.insert(engine);
+
+        EngineStats stats;
+        stats.name = engine->name();
+        stats.backend = engine->backend_name();
+        stats.active = true;
+
+        f_stats_index[engine] = f_stats.size();
+        f_stats.push_back(stats);
     }
 
     void EngineMgr::unregister_instance(Engine_ptr engine)
@@ -79,6 +126,314 @@ namespace sat {
             << std::endl;
 
         f_engines.erase(engine);
+
+        f_stats[f_stats_index[engine]].active = false;
+        f_stats_index.erase(engine);
+    }
+
+    SolverConfig EngineMgr::assign_config(const std::string& instance_name)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        const std::string profile { opts::OptsMgr::INSTANCE().portfolio() };
+        const SolverConfigs& configs { portfolio_profile(profile) };
+
+        /* engines are made in no particular order by concurrent
+           strategies, their names (FNV-1a) are stable across runs */
+        if (opts::OptsMgr::INSTANCE().deterministic()) {
+            uint32_t hash { 2166136261u };
+            for (char c : instance_name) {
+                hash = (hash ^ (unsigned char) c) * 16777619u;
+            }
+
+            return configs[hash % configs.size()];
+        }
+
+        return configs[f_assigned++ % configs.size()];
+    }
+
+    void EngineMgr::record_solve(Engine_ptr engine, const SolveStats& stats)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        assert(f_stats_index.find(engine) != f_stats_index.end());
+        EngineStats& entry { f_stats[f_stats_index[engine]] };
+
+        if (-1 != f_progress_fd) {
+            write_progress(entry, stats);
+        }
+
+        entry.solves.push_back(stats);
+    }
+
+    void EngineMgr::set_progress_fd(int fd)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        /* a reader going away is reported by write() */
+        if (-1 != fd) {
+            signal(SIGPIPE, SIG_IGN);
+        }
+
+        f_progress_fd = fd;
+    }
+
+    ClauseExchange_ptr EngineMgr::join_exchange(const std::string& channel)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        std::pair<ClauseExchange_ptr, unsigned>& entry { f_exchanges[channel] };
+        if (0 == entry.second++) {
+            entry.first = new ClauseExchange();
+        }
+
+        return entry.first;
+    }
+
+    void EngineMgr::leave_exchange(const std::string& channel)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        auto i { f_exchanges.find(channel) };
+        assert(f_exchanges.end() != i);
+
+        if (0 == --i->second.second) {
+            delete i->second.first;
+            f_exchanges.erase(i);
+        }
+    }
+
+    void EngineMgr::clear_stats()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        EngineStatsVector active;
+        boost::unordered_map<Engine_ptr, size_t>::iterator i;
+        for (i = f_stats_index.begin(); f_stats_index.end() != i; ++i) {
+            i->second = active.size();
+            active.push_back(f_stats[i->second]);
+        }
+
+        f_stats.swap(active);
+    }
+
+    static const char* status_repr(int status)
+    {
+        switch (status) {
+            case STATUS_SAT:
+                return "SAT";
+            case STATUS_UNSAT:
+                return "UNSAT";
+            default:
+                return "UNKNOWN";
+        }
+    }
+
+    static Json::Value cnf_to_json(const CNFCounters& counters)
+    {
+        Json::Value obj;
+
+        obj["dds"] = Json::UInt64(counters.dds);
+        obj["vars"] = Json::UInt64(counters.vars);
+        obj["clauses"] = Json::UInt64(counters.clauses);
+
+        return obj;
+    }
+
+    /* algorithms with no DDs are left out */
+    static void print_cnf(std::ostream& os, const char* name, const CNFCounters& counters)
+    {
+        if (!counters.dds) {
+            return;
+        }
+
+        os
+            << ", "
+            << name
+            << ": "
+            << counters.dds
+            << " dds/"
+            << counters.vars
+            << " vars/"
+            << counters.clauses
+            << " clauses";
+    }
+
+    static Json::Value solve_to_json(const SolveStats& stats)
+    {
+        Json::Value obj;
+
+        obj["step"] = stats.step;
+        obj["status"] = status_repr(stats.status);
+        obj["wall"] = stats.wall_secs;
+        obj["cpu"] = stats.cpu_secs;
+        obj["vars"] = Json::UInt64(stats.counters.vars);
+        obj["clauses"] = Json::UInt64(stats.counters.clauses);
+        obj["learnts"] = Json::UInt64(stats.counters.learnts);
+        obj["conflicts"] = Json::UInt64(stats.counters.conflicts);
+        obj["propagations"] = Json::UInt64(stats.counters.propagations);
+        obj["decisions"] = Json::UInt64(stats.counters.decisions);
+        obj["eliminated"] = Json::UInt64(stats.counters.eliminated);
+        obj["eliminated_inputs"] = Json::UInt64(stats.counters.eliminated_inputs);
+        obj["dropped_duplicates"] = Json::UInt64(stats.counters.dropped_duplicates);
+        obj["dropped_subsumed"] = Json::UInt64(stats.counters.dropped_subsumed);
+        obj["memory"] = Json::UInt64(stats.counters.memory);
+
+        Json::Value cnf;
+        cnf["single_cut"] = cnf_to_json(stats.counters.single_cut);
+        cnf["no_cut"] = cnf_to_json(stats.counters.no_cut);
+        cnf["polarity"] = cnf_to_json(stats.counters.polarity);
+        obj["cnf"] = cnf;
+
+        return obj;
+    }
+
+    void EngineMgr::write_progress(const EngineStats& engine, const SolveStats& stats)
+    {
+        Json::Value obj { solve_to_json(stats) };
+        obj["engine"] = engine.name;
+        obj["backend"] = engine.backend;
+
+        /* growth of the problem since the previous solve, clauses
+           may also shrink by simplification */
+        SolverCounters prev;
+        if (!engine.solves.empty()) {
+            prev = engine.solves.back().counters;
+        }
+        obj["vars_added"] = Json::Int64((int64_t) stats.counters.vars - (int64_t) prev.vars);
+        obj["clauses_added"] = Json::Int64((int64_t) stats.counters.clauses - (int64_t) prev.clauses);
+        obj["rss_kb"] = Json::Int64(utils::MemoryMgr::rss_kb());
+
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+
+        const std::string line { Json::writeString(builder, obj) + "\n" };
+
+        const char* p { line.c_str() };
+        size_t left { line.size() };
+        while (0 < left) {
+            ssize_t n { write(f_progress_fd, p, left) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                WARN
+                    << "Progress channel closed"
+                    << std::endl;
+
+                f_progress_fd = -1;
+                return;
+            }
+
+            p += n;
+            left -= n;
+        }
+    }
+
+    void EngineMgr::report_stats(std::ostream& os, bool json)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        if (json) {
+            Json::Value root, lst { Json::arrayValue };
+
+            for (const auto& engine : f_stats) {
+                if (engine.solves.empty()) {
+                    continue;
+                }
+
+                Json::Value obj;
+                obj["name"] = engine.name;
+                obj["backend"] = engine.backend;
+                obj["active"] = engine.active;
+
+                Json::Value solves { Json::arrayValue };
+                for (const auto& solve : engine.solves) {
+                    solves.append(solve_to_json(solve));
+                }
+                obj["solves"] = solves;
+
+                lst.append(obj);
+            }
+
+            root["engines"] = lst;
+            os
+                << root.toStyledString()
+                << std::endl;
+
+            return;
+        }
+
+        for (const auto& engine : f_stats) {
+            if (engine.solves.empty()) {
+                continue;
+            }
+
+            double wall { 0.0 };
+            double cpu { 0.0 };
+            for (const auto& solve : engine.solves) {
+                wall += solve.wall_secs;
+                cpu += solve.cpu_secs;
+            }
+
+            os
+                << engine.name
+                << " ("
+                << engine.backend
+                << (engine.active ? ", active" : "")
+                << "): "
+                << engine.solves.size()
+                << " solves, wall "
+                << std::fixed << std::setprecision(3) << wall
+                << "s, cpu "
+                << cpu
+                << "s"
+                << std::endl;
+
+            for (const auto& solve : engine.solves) {
+                os
+                    << "  k = "
+                    << solve.step
+                    << ", "
+                    << status_repr(solve.status)
+                    << ", wall "
+                    << solve.wall_secs
+                    << "s, cpu "
+                    << solve.cpu_secs
+                    << "s, vars: "
+                    << solve.counters.vars
+                    << ", clauses: "
+                    << solve.counters.clauses
+                    << ", learnts: "
+                    << solve.counters.learnts
+                    << ", conflicts: "
+                    << solve.counters.conflicts
+                    << ", props: "
+                    << solve.counters.propagations
+                    << ", decs: "
+                    << solve.counters.decisions
+                    << ", elim: "
+                    << solve.counters.eliminated
+                    << " ("
+                    << solve.counters.eliminated_inputs
+                    << " inputs)"
+                    << ", dropped: "
+                    << solve.counters.dropped_duplicates
+                    << " dup, "
+                    << solve.counters.dropped_subsumed
+                    << " subs"
+                    << ", mem: "
+                    << solve.counters.memory / 1024
+                    << "KB";
+
+                print_cnf(os, "single-cut", solve.counters.single_cut);
+                print_cnf(os, "no-cut", solve.counters.no_cut);
+                print_cnf(os, "polarity", solve.counters.polarity);
+
+                os
+                    << std::endl;
+            }
+        }
     }
 
     void EngineMgr::interrupt()
@@ -92,6 +447,19 @@ namespace sat {
         }
     }
 
+    void EngineMgr::interrupt(const void* scope)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        EngineSet::iterator esi;
+        for (esi = begin(f_engines); end(f_engines) != esi; ++esi) {
+            Engine_ptr pe { *esi };
+            if (scope == pe->scope()) {
+                pe->interrupt();
+            }
+        }
+    }
+
     void EngineMgr::dump_stats(std::ostream& os)
     {
         boost::mutex::scoped_lock lock { f_mutex };
@@ -25,6 +25,11 @@
 #define SAT_ENGINE_MGR_H
 
 #include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <sat/exchange.hh>
+#include <sat/portfolio.hh>
+#include <sat/stats.hh>
 #include <sat/typedefs.hh>
 
 namespace sat {
@@ -37,17 +42,47 @@ namespace sat {
      */
         void interrupt();
 
+        /**
+     * @brief Signals an interrupt to all running instances in scope
+     */
+        void interrupt(const void* scope);
+
         /**
      * @brief Requires a stats printout from all existing instances
      */
         void dump_stats(std::ostream& os);
 
+        /**
+     * @brief Structured statistics for all engines, both active and
+     * destroyed ones, in plain text or JSON format.
+     */
+        void report_stats(std::ostream& os, bool json = false);
+
+        /**
+     * @brief Progress channel: after each solve() a JSON object is
+     * written to fd, one per line (-1 disables the channel). If the
+     * reader goes away the channel is disabled.
+     */
+        void set_progress_fd(int fd);
+
+        /**
+     * @brief Forget statistics for destroyed engines
+     */
+        void clear_stats();
+
+        /**
+     * @brief Bytes taken by the clause databases and by the CNF
+     * registries of the existing instances, estimates. Instances
+     * running in other threads are read while running.
+     */
+        size_t clause_db_bytes();
+        size_t registry_bytes();
+
         static EngineMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new EngineMgr();
-            }
-            return (*f_instance);
+            /* made on first use, concurrent first uses wait for it */
+            static EngineMgr_ptr instance { new EngineMgr() };
+            return *instance;
         }
 
     protected:
@@ -67,9 +102,41 @@ namespace sat {
      */
         void unregister_instance(Engine_ptr engine);
 
-        static EngineMgr_ptr f_instance;
+        /**
+     * @brief Next configuration from the portfolio profile selected
+     * by program options, or (in deterministic mode) the one given
+     * by the instance name. Used by Engine ctor.
+     */
+        SolverConfig assign_config(const std::string& instance_name);
+
+        /**
+     * @brief Records statistics for a solve() call. Used by Engine.
+     */
+        void record_solve(Engine_ptr engine, const SolveStats& stats);
+
+        /**
+     * @brief Clause exchange channel by name, created on first
+     * join. Channels are destroyed when the last engine leaves.
+     */
+        ClauseExchange_ptr join_exchange(const std::string& channel);
+        void leave_exchange(const std::string& channel);
+
         EngineSet f_engines;
 
+        /* portfolio configurations handed out so far */
+        unsigned f_assigned;
+
+        /* statistics, engines are mapped to their entry */
+        EngineStatsVector f_stats;
+        boost::unordered_map<Engine_ptr, size_t> f_stats_index;
+
+        /* progress channel (-1 = none) */
+        int f_progress_fd;
+        void write_progress(const EngineStats& engine, const SolveStats& stats);
+
+        /* clause exchange channels, with the number of members */
+        boost::unordered_map<std::string, std::pair<ClauseExchange_ptr, unsigned> > f_exchanges;
+
         boost::mutex f_mutex;
     };
 
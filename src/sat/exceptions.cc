@@ -49,4 +49,58 @@ namespace sat {
                           format_loader_exception(ios))
     {}
 
+    std::string format_microcode_exception(const std::string& filename,
+                                           const std::string& reason)
+    {
+        std::ostringstream oss;
+
+        oss
+            << "can not load microcode file `"
+            << filename
+            << "`: "
+            << reason;
+
+        return oss.str();
+    }
+
+    MicrocodeException::MicrocodeException(const std::string& filename,
+                                           const std::string& reason)
+        : EngineException("MicrocodeException",
+                          format_microcode_exception(filename, reason))
+    {}
+
+    std::string format_unknown_solver_backend(const std::string& name)
+    {
+        std::ostringstream oss;
+
+        oss
+            << "unknown SAT backend `"
+            << name
+            << "`";
+
+        return oss.str();
+    }
+
+    UnknownSolverBackend::UnknownSolverBackend(const std::string& name)
+        : EngineException("UnknownSolverBackend",
+                          format_unknown_solver_backend(name))
+    {}
+
+    std::string format_unknown_portfolio_profile(const std::string& name)
+    {
+        std::ostringstream oss;
+
+        oss
+            << "unknown portfolio profile `"
+            << name
+            << "`";
+
+        return oss.str();
+    }
+
+    UnknownPortfolioProfile::UnknownPortfolioProfile(const std::string& name)
+        : EngineException("UnknownPortfolioProfile",
+                          format_unknown_portfolio_profile(name))
+    {}
+
 }; // namespace sat
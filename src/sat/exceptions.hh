@@ -44,6 +44,21 @@ namespace sat {
         InlinedOperatorLoaderException(const compiler::InlinedOperatorSignature& ios);
     };
 
+    class MicrocodeException: public EngineException {
+    public:
+        MicrocodeException(const std::string& filename, const std::string& reason);
+    };
+
+    class UnknownSolverBackend: public EngineException {
+    public:
+        UnknownSolverBackend(const std::string& name);
+    };
+
+    class UnknownPortfolioProfile: public EngineException {
+    public:
+        UnknownPortfolioProfile(const std::string& name);
+    };
+
 }; // namespace sat
 
 #endif /* SAT_EXCEPTIONS_H */
@@ -0,0 +1,53 @@
+/**
+ * @file sat/exchange.cc
+ * @brief SAT interface, learnt clauses exchange channel implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sat/exchange.hh>
+
+namespace sat {
+
+    ClauseExchange::ClauseExchange()
+    {}
+
+    void ClauseExchange::publish(step_t depth, const SharedClauses& clauses)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        for (const auto& clause : clauses) {
+            f_entries.push_back(Entry { depth, clause });
+        }
+    }
+
+    void ClauseExchange::fetch(size_t& cursor, step_t depth, SharedClauses& out)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        /* stop at the first clause learnt deeper than the importer,
+           it will be fetched later on. Depths published by a single
+           exporter never decrease, so nothing is held back for good. */
+        while (cursor < f_entries.size() && f_entries[cursor].depth <= depth) {
+            out.push_back(f_entries[cursor].clause);
+            ++cursor;
+        }
+    }
+
+}; // namespace sat
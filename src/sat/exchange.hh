@@ -0,0 +1,84 @@
+/**
+ * @file sat/exchange.hh
+ * @brief SAT interface, learnt clauses exchange channel declaration.
+ *
+ * This module contains the declaration of the channel used by engines
+ * working on the same unrolling to share learnt clauses. Clauses are
+ * exchanged in terms of TCBIs, so that each engine can map them onto
+ * its own variables.
+ *
+ * Sharing is only sound from an engine whose clause database is
+ * included in the importer's one (e.g. fast_forward -> forward, the
+ * latter adds uniqueness constraints) and only for clauses learnt at
+ * an unrolling depth not greater than the importer's: a clause over
+ * early states may well depend on transitions not yet asserted by the
+ * importer. Each shared clause is therefore tagged with the depth it
+ * was learnt at.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_EXCHANGE_H
+#define SAT_EXCHANGE_H
+
+#include <utility>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <enc/tcbi.hh>
+
+namespace sat {
+
+    /* a literal, as (TCBI, negated) */
+    typedef std::pair<enc::TCBI, bool> SharedLit;
+    typedef std::vector<SharedLit> SharedClause;
+    typedef std::vector<SharedClause> SharedClauses;
+
+    typedef enum {
+        EXCHANGE_IMPORT,
+        EXCHANGE_EXPORT,
+    } exchange_role_t;
+
+    class ClauseExchange {
+    public:
+        ClauseExchange();
+
+        /* appends clauses learnt at the given depth */
+        void publish(step_t depth, const SharedClauses& clauses);
+
+        /* fetches clauses published past cursor and learnt at most at
+         * the given depth, cursor is advanced accordingly. */
+        void fetch(size_t& cursor, step_t depth, SharedClauses& out);
+
+    private:
+        struct Entry {
+            step_t depth;
+            SharedClause clause;
+        };
+
+        std::vector<Entry> f_entries;
+        boost::mutex f_mutex;
+    };
+
+    typedef ClauseExchange* ClauseExchange_ptr;
+
+}; // namespace sat
+
+#endif /* SAT_EXCHANGE_H */
@@ -24,140 +24,217 @@
 #include <cstring>
 #include <sstream>
 
-#include <boost/algorithm/string.hpp>
 #include <jsoncpp/json/json.h>
 
 #include <compiler/streamers.hh>
 #include <compiler/typedefs.hh>
 
+#include <sat/bitblast.hh>
 #include <sat/engine.hh>
 #include <sat/exceptions.hh>
 #include <sat/inlining.hh>
+#include <sat/minimizer.hh>
 #include <sat/typedefs.hh>
 
 #include <dd/dd_walker.hh>
 
+#include <opts/opts_mgr.hh>
+
 #include <utils/misc.hh>
 #include <utils/pool.hh>
+#include <utils/profile.hh>
+#include <utils/trace.hh>
 
 namespace sat {
 
     static const char* JSON_GENERATED { "generated" };
     static const char* JSON_CNF { "cnf" };
 
-    InlinedOperatorLoader::InlinedOperatorLoader(const boost::filesystem::path& filepath)
-        : f_fullpath(filepath)
+    static const char* MICROCODE_INDEX { "index" };
+
+    /* operator mnemonics, as used in microcode file names */
+    static const struct {
+        const char* mnemonic;
+        expr::ExprType op_type;
+    } MICROCODE_MNEMONICS[] = {
+        { "neg", expr::ExprType::NEG },
+        { "add", expr::ExprType::PLUS },
+        { "sub", expr::ExprType::SUB },
+        { "div", expr::ExprType::DIV },
+        { "mod", expr::ExprType::MOD },
+        { "mul", expr::ExprType::MUL },
+        { "not", expr::ExprType::BW_NOT },
+        { "or", expr::ExprType::BW_OR },
+        { "and", expr::ExprType::BW_AND },
+        { "xor", expr::ExprType::BW_XOR },
+        { "xnor", expr::ExprType::BW_XNOR },
+        { "impl", expr::ExprType::IMPLIES },
+        { "eq", expr::ExprType::EQ },
+        { "ne", expr::ExprType::NE },
+        { "gt", expr::ExprType::GT },
+        { "ge", expr::ExprType::GE },
+        { "lt", expr::ExprType::LT },
+        { "le", expr::ExprType::LE },
+        { "lsh", expr::ExprType::LSHIFT },
+        { "rsh", expr::ExprType::RSHIFT },
+    };
+
+    /* Microcode name for a signature (e.g. `u-mul-8`): this is the
+       microcode file name, without extension. Returns an empty
+       string for signatures that have no microcode mnemonic. */
+    static std::string microcode_name(const compiler::InlinedOperatorSignature& ios)
     {
-        const std::string native { filepath.filename().replace_extension().native() };
+        expr::ExprType op_type { compiler::ios_optype(ios) };
+
+        for (const auto& entry : MICROCODE_MNEMONICS) {
+            if (entry.op_type == op_type) {
+                std::ostringstream oss;
+                oss
+                    << (compiler::ios_issigned(ios) ? 's' : 'u')
+                    << '-'
+                    << entry.mnemonic
+                    << '-'
+                    << compiler::ios_width(ios);
+
+                return oss.str();
+            }
+        }
 
-        std::vector<std::string> fragments;
-        split(fragments, native, boost::is_any_of("-"));
+        return std::string();
+    }
 
-        assert(3 == fragments.size());
+    InlinedOperatorLoader::InlinedOperatorLoader(const boost::filesystem::path& filepath,
+                                                 const compiler::InlinedOperatorSignature& ios,
+                                                 const boost::filesystem::path& cachepath,
+                                                 const MicrocodeArchive* archive)
+        : f_loaded(false)
+        , f_planned(false)
+        , f_fullpath(filepath)
+        , f_cachepath(cachepath)
+        , f_ios(ios)
+        , f_generated(false)
+        , f_archive(archive)
+    {}
 
-        const char* signedness { fragments[0].c_str() };
-        assert(*signedness == 's' || *signedness == 'u');
+    InlinedOperatorLoader::InlinedOperatorLoader(const compiler::InlinedOperatorSignature& ios,
+                                                 const boost::filesystem::path& filepath)
+        : f_loaded(false)
+        , f_planned(false)
+        , f_fullpath(filepath)
+        , f_cachepath(filepath.parent_path())
+        , f_ios(ios)
+        , f_generated(!filepath.empty())
+        , f_archive(NULL)
+    {}
 
-        const char* op { fragments[1].c_str() };
-        expr::ExprType op_type;
-        if (!strcmp("neg", op)) {
-            op_type = expr::ExprType::NEG;
-        } else if (!strcmp("add", op)) {
-            op_type = expr::ExprType::PLUS;
-        } else if (!strcmp("sub", op)) {
-            op_type = expr::ExprType::SUB;
-        } else if (!strcmp("div", op)) {
-            op_type = expr::ExprType::DIV;
-        } else if (!strcmp("mod", op)) {
-            op_type = expr::ExprType::MOD;
-        } else if (!strcmp("mul", op)) {
-            op_type = expr::ExprType::MUL;
-        } else if (!strcmp("not", op)) {
-            op_type = expr::ExprType::BW_NOT;
-        } else if (!strcmp("or", op)) {
-            op_type = expr::ExprType::BW_OR;
-        } else if (!strcmp("and", op)) {
-            op_type = expr::ExprType::BW_AND;
-        } else if (!strcmp("xor", op)) {
-            op_type = expr::ExprType::BW_XOR;
-        } else if (!strcmp("xnor", op)) {
-            op_type = expr::ExprType::BW_XNOR;
-        } else if (!strcmp("impl", op)) {
-            op_type = expr::ExprType::IMPLIES;
-        } else if (!strcmp("eq", op)) {
-            op_type = expr::ExprType::EQ;
-        } else if (!strcmp("ne", op)) {
-            op_type = expr::ExprType::NE;
-        } else if (!strcmp("gt", op)) {
-            op_type = expr::ExprType::GT;
-        } else if (!strcmp("ge", op)) {
-            op_type = expr::ExprType::GE;
-        } else if (!strcmp("lt", op)) {
-            op_type = expr::ExprType::LT;
-        } else if (!strcmp("le", op)) {
-            op_type = expr::ExprType::LE;
-        } else if (!strcmp("lsh", op)) {
-            op_type = expr::ExprType::LSHIFT;
-        } else if (!strcmp("rsh", op)) {
-            op_type = expr::ExprType::RSHIFT;
-        } else {
-            ERR
-                << "Unsupported mnemonic: "
-                << op
-                << std::endl;
-            assert(false);
-        }
+    InlinedOperatorLoader::~InlinedOperatorLoader()
+    {}
 
-        char buf[20];
-        strncpy(buf, fragments[2].c_str(), 20);
+    bool InlinedOperatorLoader::is_binary() const
+    {
+        return !strcmp(f_fullpath.extension().c_str(), MICROCODE_BINARY_EXT);
+    }
 
-        char* width { buf };
-        f_ios = compiler::make_ios('s' == *signedness, op_type, atoi(width));
+    boost::filesystem::path InlinedOperatorLoader::cachefile() const
+    {
+        if (f_cachepath.empty() || is_native()) {
+            return boost::filesystem::path();
+        }
+
+        return f_cachepath / (f_fullpath.stem().native() + MICROCODE_BINARY_EXT);
     }
 
-    InlinedOperatorLoader::~InlinedOperatorLoader()
-    {}
+    bool InlinedOperatorLoader::cache_hit(const boost::filesystem::path& cachefile) const
+    {
+        using boost::filesystem::filesystem_error;
 
-    const LitsVector& InlinedOperatorLoader::clauses()
+        /* stale entries (older than the microcode file, or archive)
+           are ignored */
+        const boost::filesystem::path& source { f_archive ? f_archive->path() : f_fullpath };
+        try {
+            return !cachefile.empty() && exists(cachefile) &&
+                   last_write_time(source) <= last_write_time(cachefile);
+        } catch (const filesystem_error&) {
+            return false;
+        }
+    }
+
+    const Microcode& InlinedOperatorLoader::clauses()
     {
+        /* loaded clauses are never changed, the steady state (i.e.
+           every injection but the first few) takes no lock */
+        if (f_loaded.load(std::memory_order_acquire)) {
+            return f_microcode;
+        }
+
         boost::mutex::scoped_lock lock { f_loading_mutex };
 
-        if (0 == f_clauses.size()) {
-            unsigned count { 0 };
+        if (!f_loaded.load(std::memory_order_relaxed)) {
+            utils::ProfileScope scope { "microcode" };
+            utils::TraceScope trace { "load", "microcode" };
+
             clock_t t0 { clock() };
             double secs;
 
-            Lits newClause;
-            std::ifstream json_file { f_fullpath.c_str() };
-
-            Json::Value obj;
-            json_file >> obj;
-            assert(obj.type() == Json::objectValue);
+            boost::filesystem::path cached { cachefile() };
 
-            const Json::Value generated { obj[JSON_GENERATED] };
+            if (is_native()) {
+                DEBUG
+                    << "Generating clauses for "
+                    << f_ios
+                    << std::endl;
 
-            DEBUG
-                << "Loading clauses for "
-                << f_ios
-                << ", generated "
-                << generated;
+                bitblast(f_ios, f_microcode);
 
-            const Json::Value cnf { obj[JSON_CNF] };
-            assert(cnf.type() == Json::arrayValue);
+                /* no cache to keep in-process generated clauses */
+                if (!can_bitblast(f_ios)) {
+                    minimize();
+                }
+            } else if (cache_hit(cached)) {
+                DEBUG
+                    << "Mapping minimized clauses for "
+                    << f_ios
+                    << std::endl;
 
-            for (auto clause : cnf) {
-                assert(clause.type() == Json::arrayValue);
+                f_microcode.map(cached);
+            } else if (f_generated) {
+                INFO
+                    << "Generating microcode for "
+                    << f_ios
+                    << " into "
+                    << f_fullpath
+                    << std::endl;
 
-                newClause.clear();
-                for (auto literal : clause) {
-                    assert(literal.type() == Json::intValue);
-                    newClause.push_back(Minisat::toLit(literal.asInt()));
+                bitblast(f_ios, f_microcode);
+                minimize();
+                store(f_fullpath);
+            } else {
+                if (f_archive) {
+                    DEBUG
+                        << "Inflating clauses for "
+                        << f_ios
+                        << std::endl;
+
+                    f_archive->extract(f_fullpath.stem().native(), f_microcode);
+                } else if (is_binary()) {
+                    DEBUG
+                        << "Mapping clauses for "
+                        << f_ios
+                        << std::endl;
+
+                    f_microcode.map(f_fullpath);
+                } else {
+                    load_json();
                 }
 
-                f_clauses.push_back(newClause);
-                ++count;
+                minimize();
+
+                if (!cached.empty()) {
+                    store(cached);
+                }
             }
 
+            unsigned count { f_microcode.size() };
             clock_t t1 { clock() };
             secs = 1000 * (double) (t1 - t0) / (double) CLOCKS_PER_SEC;
 
@@ -166,18 +243,187 @@ namespace sat {
                 << " clauses fetched, took " << secs
                 << " ms"
                 << std::endl;
+
+            f_loaded.store(true, std::memory_order_release);
         }
 
-        return f_clauses;
+        return f_microcode;
     }
 
-    // static initialization
-    InlinedOperatorMgr_ptr InlinedOperatorMgr::f_instance { NULL };
+    const InjectionPlan& InlinedOperatorLoader::plan()
+    {
+        if (f_planned.load(std::memory_order_acquire)) {
+            return f_plan;
+        }
+
+        const Microcode& microcode { clauses() };
+
+        boost::mutex::scoped_lock lock { f_planning_mutex };
+        if (!f_planned.load(std::memory_order_relaxed)) {
+            bool relational { 1 == compiler::ios_width(f_ios) };
+            switch (compiler::ios_optype(f_ios)) {
+                case expr::ExprType::EQ:
+                case expr::ExprType::NE:
+                case expr::ExprType::LT:
+                case expr::ExprType::LE:
+                case expr::ExprType::GT:
+                case expr::ExprType::GE:
+                    relational = true;
+                    break;
+
+                default:
+                    break;
+            }
+
+            f_plan.build(microcode, compiler::ios_width(f_ios), relational);
+            f_planned.store(true, std::memory_order_release);
+        }
+
+        return f_plan;
+    }
+
+    InjectionPlan::InjectionPlan()
+    {}
+
+    void InjectionPlan::build(const Microcode& microcode, unsigned width, bool relational)
+    {
+        /* slot of each microcode var, -1 until it occurs */
+        std::vector<int> slot_of;
+
+        f_offsets.reserve(1 + microcode.size());
+        f_offsets.push_back(0);
+        f_literals.reserve(microcode.n_literals());
+
+        for (unsigned i = 0; i < microcode.size(); ++i) {
+            const int32_t* end { microcode.clause_end(i) };
+            for (const int32_t* p = microcode.clause_begin(i); p != end; ++p) {
+                unsigned var { static_cast<unsigned>(*p >> 1) };
+
+                if (slot_of.size() <= var) {
+                    slot_of.resize(1 + var, -1);
+                }
+
+                if (slot_of[var] < 0) {
+                    /* microcode vars are LSB first, descriptor bits
+                       MSB first */
+                    Slot slot { SLOT_AUX, 0 };
+                    if (var < width) {
+                        assert(!relational || !var);
+                        slot = Slot { SLOT_Z, relational ? 0 : width - var - 1 };
+                    } else if (var < 2 * width) {
+                        slot = Slot { SLOT_X, 2 * width - var - 1 };
+                    } else if (var < 3 * width) {
+                        slot = Slot { SLOT_Y, 3 * width - var - 1 };
+                    }
+
+                    slot_of[var] = f_slots.size();
+                    f_slots.push_back(slot);
+                }
+
+                f_literals.push_back(2 * slot_of[var] + (*p & 1));
+            }
+
+            f_offsets.push_back(f_literals.size());
+        }
+    }
+
+    void InlinedOperatorLoader::store(const boost::filesystem::path& cachefile)
+    {
+        /* written aside and renamed, concurrent runs never map a
+           partial file */
+        try {
+            create_directories(f_cachepath);
+
+            boost::filesystem::path tmp { cachefile };
+            tmp += boost::filesystem::unique_path(".%%%%-%%%%");
+
+            f_microcode.write(tmp);
+            rename(tmp, cachefile);
+        } catch (const std::exception& e) {
+            /* not fatal, clauses are generated or minimized again next time */
+            pconst_char what { e.what() };
+            WARN
+                << "Could not cache microcode: "
+                << what
+                << std::endl;
+        }
+    }
+
+    void InlinedOperatorLoader::minimize()
+    {
+        unsigned before { f_microcode.size() };
+
+        /* z, x and y are the interface vars */
+        CNFMinimizer minimizer { 3 * compiler::ios_width(f_ios) };
+        minimizer.load(f_microcode);
+        minimizer.run();
+        minimizer.flush(f_microcode);
+
+        unsigned after { f_microcode.size() };
+        unsigned subsumed { minimizer.subsumed() };
+        unsigned strengthened { minimizer.strengthened() };
+        unsigned eliminated { minimizer.eliminated() };
+
+        DEBUG
+            << "Minimized clauses for "
+            << f_ios
+            << ": "
+            << before
+            << " -> "
+            << after
+            << " ("
+            << subsumed
+            << " subsumed, "
+            << strengthened
+            << " strengthened, "
+            << eliminated
+            << " vars eliminated)"
+            << std::endl;
+    }
+
+    void InlinedOperatorLoader::load_json()
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<int32_t> literals;
+        std::ifstream json_file { f_fullpath.c_str() };
+
+        Json::Value obj;
+        json_file >> obj;
+        assert(obj.type() == Json::objectValue);
+
+        const Json::Value generated { obj[JSON_GENERATED] };
+
+        DEBUG
+            << "Loading clauses for "
+            << f_ios
+            << ", generated "
+            << generated;
+
+        const Json::Value cnf { obj[JSON_CNF] };
+        assert(cnf.type() == Json::arrayValue);
+
+        /* literals go straight into the flat representation, no
+           per-clause allocation */
+        offsets.reserve(1 + cnf.size());
+        offsets.push_back(0);
+
+        for (const auto& clause : cnf) {
+            assert(clause.type() == Json::arrayValue);
+
+            for (const auto& literal : clause) {
+                assert(literal.type() == Json::intValue);
+                literals.push_back(literal.asInt());
+            }
+
+            offsets.push_back(literals.size());
+        }
+
+        f_microcode.assign(offsets, literals);
+    }
 
     InlinedOperatorMgr::InlinedOperatorMgr()
         : f_builtin_microcode_path(STRING(YASMV_HOME))
     {
-        using boost::filesystem::directory_iterator;
         using boost::filesystem::filesystem_error;
         using boost::filesystem::path;
 
@@ -189,48 +435,79 @@ namespace sat {
             exit(1);
         }
 
-        path micropath { env_microcode_path
-                             ? env_microcode_path
-                             : f_builtin_microcode_path.c_str() };
+        f_micropath = env_microcode_path
+                          ? env_microcode_path
+                          : f_builtin_microcode_path.c_str();
 
-        micropath += "/microcode/";
-        try {
-            if (exists(micropath) && is_directory(micropath)) {
-                for (directory_iterator di = directory_iterator(micropath);
-                     di != directory_iterator(); ++di) {
+        f_micropath /= "microcode";
 
-                    path entry { di->path() };
-                    if (strcmp(entry.extension().c_str(), ".json")) {
-                        continue;
-                    }
+        /* minimized microcode cache (optional) */
+        f_cachepath = opts::OptsMgr::INSTANCE().microcode_cache();
 
-                    // lazy clauses-loaders registration
-                    try {
-                        InlinedOperatorLoader* loader { new InlinedOperatorLoader(entry) };
-                        assert(NULL != loader);
-
-                        f_loaders.insert(
-                            std::pair<compiler::InlinedOperatorSignature, InlinedOperatorLoader_ptr>(loader->ios(), loader));
-                    } catch (InlinedOperatorLoaderException& iole) {
-                        pconst_char what { iole.what() };
-                        WARN
-                            << what
-                            << std::endl;
-                    }
+        /* generated microcode, in the user cache directory unless a
+           cache is given */
+        f_generated_path = f_cachepath;
+        if (f_generated_path.empty()) {
+            const char* xdg_cache { getenv("XDG_CACHE_HOME") };
+            const char* home { getenv("HOME") };
+
+            if (NULL != xdg_cache && *xdg_cache) {
+                f_generated_path = path(xdg_cache) / "yasmv" / "microcode";
+            } else if (NULL != home && *home) {
+                f_generated_path = path(home) / ".cache" / "yasmv" / "microcode";
+            }
+        }
+        try {
+            if (exists(f_micropath) && is_directory(f_micropath)) {
+                path index_path { f_micropath / MICROCODE_INDEX };
+
+                /* With no index available, microcode files are
+                   looked up on demand by their conventional name. */
+                if (exists(index_path)) {
+                    read_index(index_path);
+                } else {
+                    TRACE
+                        << "No microcode index found, "
+                        << "microcode files will be probed on demand."
+                        << std::endl;
                 }
             } else {
-                ERR
-                    << "Path "
-                    << micropath
-                    << " does not exist or is not a readable directory."
-                    << std::endl;
+                /* no need to unpack the microcode, clauses are
+                   inflated from the archive one operator at a time */
+                path archive_path { f_micropath.parent_path() / MICROCODE_ARCHIVE };
+                if (!exists(archive_path)) {
+                    ERR
+                        << "Path "
+                        << f_micropath
+                        << " does not exist or is not a readable directory, "
+                        << "and no microcode archive was found."
+                        << std::endl;
+
+                    /* leave immediately */
+                    exit(1);
+                }
+
+                f_archive.open(archive_path);
 
-                /* leave immediately */
-                exit(1);
+                size_t count { f_archive.size() };
+                TRACE
+                    << count
+                    << " microcode archive entries read from "
+                    << archive_path
+                    << std::endl;
             }
         } catch (const filesystem_error& fse) {
             pconst_char what { fse.what() };
 
+            ERR
+                << what
+                << std::endl;
+
+            /* leave immediately */
+            exit(1);
+        } catch (const MicrocodeException& me) {
+            pconst_char what { me.what() };
+
             ERR
                 << what
                 << std::endl;
@@ -244,31 +521,166 @@ namespace sat {
     {
     }
 
+    void InlinedOperatorMgr::read_index(const boost::filesystem::path& index_path)
+    {
+        std::ifstream index_file { index_path.c_str() };
+        std::string line;
+
+        /* Each line of the index maps a microcode name to a file,
+           relative to the microcode directory. Empty lines and lines
+           starting with a `#` are ignored. */
+        while (std::getline(index_file, line)) {
+            std::istringstream iss { line };
+            std::string name;
+            std::string filename;
+
+            if (!(iss >> name) || '#' == name[0]) {
+                continue;
+            }
+
+            if (!(iss >> filename)) {
+                WARN
+                    << "Malformed microcode index entry: `"
+                    << line
+                    << "`"
+                    << std::endl;
+                continue;
+            }
+
+            f_index[name] = f_micropath / filename;
+        }
+
+        size_t count { f_index.size() };
+        TRACE
+            << count
+            << " microcode index entries read from "
+            << index_path
+            << std::endl;
+    }
+
+    bool InlinedOperatorMgr::lookup(const std::string& name, boost::filesystem::path& res) const
+    {
+        /* named as if unpacked next to the archive */
+        if (f_archive.is_open()) {
+            res = f_archive.path() / (name + MICROCODE_BINARY_EXT);
+            return f_archive.has(name);
+        }
+
+        if (!f_index.empty()) {
+            MicrocodeIndex::const_iterator i { f_index.find(name) };
+            if (f_index.end() == i) {
+                return false;
+            }
+
+            res = i->second;
+            return true;
+        }
+
+        /* binary microcode takes precedence */
+        res = f_micropath / (name + MICROCODE_BINARY_EXT);
+        if (exists(res)) {
+            return true;
+        }
+
+        res = f_micropath / (name + MICROCODE_JSON_EXT);
+        return exists(res);
+    }
+
     InlinedOperatorLoader& InlinedOperatorMgr::require(const compiler::InlinedOperatorSignature& ios)
     {
+        InlinedOperatorLoaderMap* required { f_required.get() };
+        if (!required) {
+            required = new InlinedOperatorLoaderMap();
+            f_required.reset(required);
+        }
+
+        InlinedOperatorLoaderMap::const_iterator i { required->find(ios) };
+        if (i != required->end()) {
+            return *i->second;
+        }
+
+        InlinedOperatorLoader& loader { require_aux(ios) };
+        required->insert(
+            std::pair<compiler::InlinedOperatorSignature, InlinedOperatorLoader_ptr>(ios, &loader));
+
+        return loader;
+    }
+
+    InlinedOperatorLoader& InlinedOperatorMgr::require_aux(const compiler::InlinedOperatorSignature& ios)
+    {
+        boost::mutex::scoped_lock lock { f_require_mutex };
+
         InlinedOperatorLoaderMap::const_iterator i { f_loaders.find(ios) };
+        if (i != f_loaders.end()) {
+            return *i->second;
+        }
 
-        if (i == f_loaders.end()) {
-            DRIVEL
+        /* adders and comparators are generated natively, for any
+           width, no microcode file is needed */
+        if (can_bitblast(ios)) {
+            InlinedOperatorLoader_ptr loader { new InlinedOperatorLoader(ios) };
+            f_loaders.insert(
+                std::pair<compiler::InlinedOperatorSignature, InlinedOperatorLoader_ptr>(ios, loader));
+
+            DEBUG
+                << "Registered native loader for "
                 << ios
-                << " not found, falling back..."
                 << std::endl;
 
-            compiler::InlinedOperatorSignature fallback {
-                compiler::make_ios(compiler::ios_issigned(ios), compiler::ios_optype(ios), compiler::ios_width(ios))
-            };
-            i = f_loaders.find(fallback);
+            return *loader;
+        }
+
+        /* lazy clauses-loaders registration */
+        std::string name { microcode_name(ios) };
+        boost::filesystem::path filepath;
+
+        /* missing microcode is generated on demand */
+        if (!name.empty() && !lookup(name, filepath) && can_generate(ios)) {
+            if (!f_generated_path.empty()) {
+                filepath = f_generated_path / (name + MICROCODE_BINARY_EXT);
+            }
+
+            InlinedOperatorLoader_ptr loader { new InlinedOperatorLoader(ios, filepath) };
+            f_loaders.insert(
+                std::pair<compiler::InlinedOperatorSignature, InlinedOperatorLoader_ptr>(ios, loader));
+
+            DEBUG
+                << "Registered generating loader for "
+                << ios
+                << std::endl;
+
+            return *loader;
         }
 
-        if (i == f_loaders.end()) {
+        if (name.empty() || !lookup(name, filepath)) {
+            DRIVEL
+                << ios
+                << " not found"
+                << std::endl;
+
             throw InlinedOperatorLoaderException(ios);
         }
 
-        return *i->second;
+        InlinedOperatorLoader_ptr loader {
+            new InlinedOperatorLoader(filepath, ios, f_cachepath,
+                                      f_archive.is_open() ? &f_archive : NULL)
+        };
+        f_loaders.insert(
+            std::pair<compiler::InlinedOperatorSignature, InlinedOperatorLoader_ptr>(ios, loader));
+
+        DEBUG
+            << "Registered microcode loader for "
+            << ios
+            << " ("
+            << filepath
+            << ")"
+            << std::endl;
+
+        return *loader;
     }
 
     void CNFOperatorInliner::inject(const compiler::InlinedOperatorDescriptor& md,
-                                    const LitsVector& clauses)
+                                    const InjectionPlan& plan)
     {
         DRIVEL
             << const_cast<compiler::InlinedOperatorDescriptor&>(md)
@@ -277,103 +689,52 @@ namespace sat {
         /* true */
         const Var alpha { 0 };
 
-        /* local refs */
-        const dd::DDVector& z { md.z() };
-        const dd::DDVector& x { md.x() };
-        const dd::DDVector& y { md.y() };
-        int width { static_cast<int>(compiler::ios_width(md.ios())) };
+        /* the target literal of each slot: DD vars from the registry,
+           constants as alpha, cnf vars rewritten into new sat vars
+           (distinct among distinct injections). Slots are in order
+           of first occurrence, so are new vars. */
+        const std::vector<InjectionPlan::Slot>& slots { plan.slots() };
+        f_table.resize(slots.size());
 
-        /* keep each injection in a separate cnf space */
-        f_sat.clear_cnf_map();
+        for (unsigned i = 0; i < slots.size(); ++i) {
+            const InjectionPlan::Slot& slot { slots[i] };
 
-        for (const auto& clause : clauses) {
-            Minisat::vec<Lit> ps;
-            if (MAINGROUP != f_group) {
-                ps.push(mkLit(f_group, true));
+            if (InjectionPlan::SLOT_AUX == slot.kind) {
+                f_table[i] = mkLit(f_sat.new_sat_var());
+                continue;
             }
 
-            /* for each literal in clause, determine whether
-               associated var belongs to z, x, y or is a cnf var. For
-               each group in (z, x, y) fetch appropriate DD var from
-               the registry; cnf vars gets rewritten into new sat
-               vars. Remark: rewritten cnf vars must be kept distinct
-               among distinct injections. */
-            for (auto lit : clause) {
-                Var lit_var { Minisat::var(lit) };
-                int lit_sign { Minisat::sign(lit) };
-
-                Var tgt_var;
-
-                /* z? */
-                if (lit_var < width) {
-                    int ndx { lit_var };
-                    assert(0 <= ndx && ndx < width);
-
-                    const DdNode* node { NULL };
-                    if (md.is_relational()) {
-                        assert(!ndx);
-                        node = z[0].getNode();
-                    } else {
-                        node = z[width - ndx - 1].getNode();
-                    }
-
-                    if (!Cudd_IsConstant(node)) {
-                        tgt_var = f_sat.find_dd_var(node, f_time);
-                        ps.push(mkLit(tgt_var, lit_sign));
-                    } else {
-                        value_t value { cuddV(node) };
-
-                        assert(value < 2); // 0 or 1
-                        ps.push(mkLit(alpha, value ? lit_sign : !lit_sign));
-                    }
-                }
-
-                /* x? */
-                else if (width <= lit_var && lit_var < 2 * width) {
-                    int ndx { lit_var - width };
-
-                    assert(0 <= ndx && ndx < width);
-                    const DdNode* node { x[width - ndx - 1].getNode() };
-
-                    if (!Cudd_IsConstant(node)) {
-                        tgt_var = f_sat.find_dd_var(node, f_time);
-                        ps.push(mkLit(tgt_var, lit_sign));
-                    } else {
-                        value_t value { cuddV(node) };
-
-                        assert(value < 2); // 0 or 1
-                        ps.push(mkLit(alpha, value ? lit_sign : !lit_sign));
-                    }
-                }
-
-                /* y? */
-                else if (2 * width <= lit_var && lit_var < 3 * width) {
-                    int ndx { lit_var - 2 * width };
-
-                    assert(0 <= ndx && ndx < width);
-                    const DdNode* node { y[width - ndx - 1].getNode() };
+            const dd::DDVector& bits {
+                InjectionPlan::SLOT_Z == slot.kind ? md.z() :
+                InjectionPlan::SLOT_X == slot.kind ? md.x() :
+                                                      md.y()
+            };
+            const DdNode* node { bits[slot.index].getNode() };
 
-                    if (!Cudd_IsConstant(node)) {
-                        tgt_var = f_sat.find_dd_var(node, f_time);
-                        ps.push(mkLit(tgt_var, lit_sign));
-                    } else {
-                        value_t value { cuddV(node) };
+            if (!Cudd_IsConstant(node)) {
+                f_table[i] = mkLit(f_sat.find_dd_var(node, f_time));
+            } else {
+                value_t value { cuddV(node) };
 
-                        assert(value < 2); // 0 or 1
-                        ps.push(mkLit(alpha, value ? lit_sign : !lit_sign));
-                    }
-                }
+                assert(value < 2); // 0 or 1
+                f_table[i] = mkLit(alpha, !value);
+            }
+        }
 
-                /* none of the above, it's a cnf var. */
-                else {
-                    int ndx { lit_var - 3 * width };
+        /* clause buffer, reused across clauses (clear() keeps the
+           allocated storage) */
+        Minisat::vec<Lit> ps;
 
-                    assert(0 <= ndx /* && ndx < width */);
-                    tgt_var = f_sat.rewrite_cnf_var(ndx, f_time);
-                    ps.push(mkLit(tgt_var, lit_sign));
-                }
+        for (unsigned i = 0; i < plan.size(); ++i) {
+            ps.clear();
+            if (MAINGROUP != f_group) {
+                ps.push(mkLit(f_group, true));
+            }
 
-            } /* for (j = clause...) */
+            const int32_t* end { plan.clause_end(i) };
+            for (const int32_t* p = plan.clause_begin(i); p != end; ++p) {
+                ps.push(f_table[*p >> 1] ^ (*p & 1));
+            }
 
             f_sat.add_clause(ps);
         } /* foreach clause ... */
@@ -487,4 +848,106 @@ namespace sat {
         }
     }
 
+    void CNFAigInliner::inject(const compiler::AigDescriptor& ad)
+    {
+        DRIVEL
+            << ad
+            << std::endl;
+
+        Var z { f_sat.find_dd_var(ad.z().getNode(), f_time) };
+        Lit root { cnf_lit(ad.root()) };
+
+        /* Z <-> root */
+        for (unsigned pol = 0; pol < 2; ++pol) {
+            Minisat::vec<Lit> ps;
+
+            if (MAINGROUP != f_group) {
+                ps.push(mkLit(f_group, true));
+            }
+
+            ps.push(mkLit(z, !pol));
+            ps.push(pol ? ~root : root);
+            f_sat.add_clause(ps);
+        }
+    }
+
+    Lit CNFAigInliner::cnf_lit(compiler::aig_lit_t lit)
+    {
+        compiler::AigMgr& aig { compiler::AigMgr::INSTANCE() };
+
+        /* true */
+        const Var alpha { 0 };
+
+        auto node_lit = [&](unsigned id) {
+            compiler::AigNode node { aig.node(id) };
+
+            if (node.is_constant()) {
+                return mkLit(alpha, true);
+            }
+            if (node.is_input()) {
+                return mkLit(f_sat.find_dd_var(node.index, f_time));
+            }
+
+            Var var { f_sat.find_aig_var(id, f_time) };
+            assert(-1 != var);
+            return mkLit(var);
+        };
+
+        auto child_lit = [&](compiler::aig_lit_t child) {
+            Lit res { node_lit(compiler::aig_node(child)) };
+            return compiler::aig_complemented(child) ? ~res : res;
+        };
+
+        /* post-order, children come first */
+        std::vector<std::pair<unsigned, bool>> stack;
+        stack.push_back(std::make_pair(compiler::aig_node(lit), false));
+
+        while (!stack.empty()) {
+            unsigned id { stack.back().first };
+            bool expanded { stack.back().second };
+            stack.pop_back();
+
+            compiler::AigNode node { aig.node(id) };
+            if (!node.is_and() || -1 != f_sat.find_aig_var(id, f_time)) {
+                continue;
+            }
+
+            if (!expanded) {
+                stack.push_back(std::make_pair(id, true));
+                stack.push_back(std::make_pair(compiler::aig_node(node.lhs), false));
+                stack.push_back(std::make_pair(compiler::aig_node(node.rhs), false));
+                continue;
+            }
+
+            Lit a { child_lit(node.lhs) };
+            Lit b { child_lit(node.rhs) };
+
+            Var v { f_sat.new_sat_var() };
+            f_sat.register_aig_var(id, f_time, v);
+
+            /* v <-> a & b */
+            {
+                Minisat::vec<Lit> ps;
+                ps.push(mkLit(v, true));
+                ps.push(a);
+                f_sat.add_clause(ps);
+            }
+            {
+                Minisat::vec<Lit> ps;
+                ps.push(mkLit(v, true));
+                ps.push(b);
+                f_sat.add_clause(ps);
+            }
+            {
+                Minisat::vec<Lit> ps;
+                ps.push(mkLit(v));
+                ps.push(~a);
+                ps.push(~b);
+                f_sat.add_clause(ps);
+            }
+        }
+
+        return child_lit(lit);
+    }
+
 } // namespace sat
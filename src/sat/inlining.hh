@@ -27,12 +27,16 @@
 #define SAT_HELPERS
 
 #include <dd/dd_walker.hh>
+#include <sat/microcode.hh>
 #include <sat/typedefs.hh>
 
 #include <compiler/typedefs.hh>
 
+#include <atomic>
+
 #include <boost/filesystem.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
 
 namespace sat {
 
@@ -44,10 +48,86 @@ namespace sat {
                                  compiler::InlinedOperatorSignatureEq>
         InlinedOperatorLoaderMap;
 
+    /* microcode name -> microcode file */
+    typedef boost::unordered_map<std::string, boost::filesystem::path> MicrocodeIndex;
+
+
+    /* Injection plan for the clauses of a signature: each var of the
+     * microcode is given a slot, in order of first occurrence, and
+     * the literals refer to slots (slot * 2 + sign). An injection
+     * fills a table with the target literal of each slot, once per
+     * var, then clauses are a sequence of table lookups. */
+    class InjectionPlan {
+    public:
+        typedef enum {
+            SLOT_Z,
+            SLOT_X,
+            SLOT_Y,
+            SLOT_AUX,
+        } slot_kind_t;
+
+        struct Slot {
+            slot_kind_t kind;
+
+            /* bit in the descriptor vector (MSB first), unused for
+               auxiliary vars */
+            unsigned index;
+        };
+
+        InjectionPlan();
+
+        /* classifies the vars of microcode, for a width operator */
+        void build(const Microcode& microcode, unsigned width, bool relational);
+
+        inline bool ready() const
+        {
+            return !f_offsets.empty();
+        }
+
+        inline const std::vector<Slot>& slots() const
+        {
+            return f_slots;
+        }
+
+        inline unsigned size() const
+        {
+            return f_offsets.size() - 1;
+        }
+
+        inline const int32_t* clause_begin(unsigned i) const
+        {
+            return f_literals.data() + f_offsets[i];
+        }
+
+        inline const int32_t* clause_end(unsigned i) const
+        {
+            return f_literals.data() + f_offsets[1 + i];
+        }
+
+    private:
+        std::vector<Slot> f_slots;
+        std::vector<uint32_t> f_offsets;
+        std::vector<int32_t> f_literals;
+    };
 
     class InlinedOperatorLoader {
     public:
-        InlinedOperatorLoader(const boost::filesystem::path& filepath);
+        /* non-native clauses are minimized once loaded, if
+           `cachepath` is not empty the minimized clauses are cached
+           there, in binary microcode format. If `archive` is given,
+           the clauses are inflated from its entry for the stem of
+           `filepath` instead */
+        InlinedOperatorLoader(const boost::filesystem::path& filepath,
+                              const compiler::InlinedOperatorSignature& ios,
+                              const boost::filesystem::path& cachepath,
+                              const MicrocodeArchive* archive = NULL);
+
+        /* clauses are generated natively, no microcode file. If
+           `filepath` is not empty, clauses are generated in-process
+           (see bitblast.hh) when it does not exist yet, then minimized
+           and written there in binary microcode format */
+        InlinedOperatorLoader(const compiler::InlinedOperatorSignature& ios,
+                              const boost::filesystem::path& filepath = boost::filesystem::path());
         ~InlinedOperatorLoader();
 
         inline const compiler::InlinedOperatorSignature& ios() const
@@ -55,15 +135,58 @@ namespace sat {
             return f_ios;
         }
 
-        // synchronized
-        const LitsVector& clauses();
+        inline const boost::filesystem::path& fullpath() const
+        {
+            return f_fullpath;
+        }
+
+        /* true iff clauses come from a binary microcode file */
+        bool is_binary() const;
+
+        /* true iff clauses are generated natively (see bitblast.hh) */
+        inline bool is_native() const
+        {
+            return f_fullpath.empty();
+        }
+
+        // synchronized until loaded, lock-free from then on
+        const Microcode& clauses();
+
+        // synchronized until built (once, from the clauses), lock-free
+        // from then on
+        const InjectionPlan& plan();
 
     private:
+        void load_json();
+        void minimize();
+
+        /* writes the clauses to cachefile, failures are not fatal */
+        void store(const boost::filesystem::path& cachefile);
+
+        /* cached minimized clauses, empty if caching is disabled */
+        boost::filesystem::path cachefile() const;
+        bool cache_hit(const boost::filesystem::path& cachefile) const;
+
+        /* set (release) once f_microcode is final, acquired by
+           readers which then need no lock */
+        std::atomic<bool> f_loaded;
         boost::mutex f_loading_mutex;
-        LitsVector f_clauses;
+        Microcode f_microcode;
+
+        /* likewise, for f_plan */
+        std::atomic<bool> f_planned;
+        boost::mutex f_planning_mutex;
+        InjectionPlan f_plan;
 
         boost::filesystem::path f_fullpath;
+        boost::filesystem::path f_cachepath;
         compiler::InlinedOperatorSignature f_ios;
+
+        /* true iff the microcode file is generated on demand */
+        bool f_generated;
+
+        /* the archive holding the clauses, if any (not owned) */
+        const MicrocodeArchive* f_archive;
     };
 
     typedef class InlinedOperatorMgr* InlinedOperatorMgr_ptr;
@@ -72,12 +195,14 @@ namespace sat {
     public:
         static InlinedOperatorMgr& INSTANCE()
         {
-            if (!f_instance)
-                f_instance = new InlinedOperatorMgr();
-
-            return (*f_instance);
+            /* made on first use, concurrent first uses wait for it */
+            static InlinedOperatorMgr_ptr instance { new InlinedOperatorMgr() };
+            return *instance;
         }
 
+        // loaders are created on demand (synchronized), and then
+        // remembered by each thread, which finds them again without
+        // locking
         InlinedOperatorLoader& require(const compiler::InlinedOperatorSignature& ios);
 
         inline const InlinedOperatorLoaderMap& loaders() const
@@ -85,15 +210,44 @@ namespace sat {
             return f_loaders;
         }
 
+        /* number of entries in the microcode index, or in the
+           microcode archive (if any) */
+        inline size_t indexed() const
+        {
+            return f_archive.is_open() ? f_archive.size() : f_index.size();
+        }
+
     protected:
         InlinedOperatorMgr();
         ~InlinedOperatorMgr();
 
     private:
-        static InlinedOperatorMgr_ptr f_instance;
+        void read_index(const boost::filesystem::path& index_path);
+        bool lookup(const std::string& name, boost::filesystem::path& res) const;
+
+        // synchronized
+        InlinedOperatorLoader& require_aux(const compiler::InlinedOperatorSignature& ios);
+
         std::string f_builtin_microcode_path;
+        boost::filesystem::path f_micropath;
+        boost::filesystem::path f_cachepath;
+
+        /* where microcode generated on demand is kept, either the
+           minimized microcode cache or the user cache directory
+           (empty if neither is available) */
+        boost::filesystem::path f_generated_path;
+
+        MicrocodeIndex f_index;
 
+        /* used when no microcode directory is available */
+        MicrocodeArchive f_archive;
+
+        boost::mutex f_require_mutex;
         InlinedOperatorLoaderMap f_loaders;
+
+        /* the loaders each thread has required so far, loaders are
+           never destroyed */
+        boost::thread_specific_ptr<InlinedOperatorLoaderMap> f_required;
     };
 
 
@@ -115,16 +269,19 @@ namespace sat {
             compiler::InlinedOperatorSignature ios(md.ios());
             InlinedOperatorLoader& loader(mm.require(ios));
 
-            inject(md, loader.clauses());
+            inject(md, loader.plan());
         }
 
     private:
         void inject(const compiler::InlinedOperatorDescriptor& md,
-                    const LitsVector& clauses);
+                    const InjectionPlan& plan);
 
         Engine& f_sat;
         step_t f_time;
         group_t f_group;
+
+        /* target literals by slot, reused across injections */
+        std::vector<Lit> f_table;
     };
 
     class CNFBinarySelectionInliner {
@@ -175,6 +332,34 @@ namespace sat {
         group_t f_group;
     };
 
+    class CNFAigInliner {
+    public:
+        CNFAigInliner(Engine& sat, step_t time, group_t group = MAINGROUP)
+            : f_sat(sat)
+            , f_time(time)
+            , f_group(group)
+        {}
+
+        ~CNFAigInliner()
+        {}
+
+        inline void operator()(const compiler::AigDescriptor& ad)
+        {
+            inject(ad);
+        }
+
+    private:
+        void inject(const compiler::AigDescriptor& ad);
+
+        /* Tseitin encoding of the cone of lit. Definitions of AND
+           nodes are shared among groups */
+        Lit cnf_lit(compiler::aig_lit_t lit);
+
+        Engine& f_sat;
+        step_t f_time;
+        group_t f_group;
+    };
+
 }; // namespace sat
 
 #endif /* SAT_HELPERS */
@@ -0,0 +1,241 @@
+/**
+ * @file sat/interpolant.cc
+ * @brief SAT interface, Craig interpolants implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cassert>
+
+#include <sat/engine.hh>
+#include <sat/interpolant.hh>
+
+namespace sat {
+
+    const Interpolant::Node Interpolant::FALSE_NODE;
+    const Interpolant::Node Interpolant::TRUE_NODE;
+
+    Interpolant::Interpolant()
+        : f_root(TRUE_NODE)
+    {
+        Gate gate;
+
+        gate.kind = GATE_CONST;
+        gate.a = 0;
+        gate.b = 0;
+
+        f_gates.push_back(gate); /* FALSE_NODE */
+        f_gates.push_back(gate); /* TRUE_NODE */
+    }
+
+    Interpolant::Node Interpolant::make_gate(gate_t kind, unsigned a, unsigned b)
+    {
+        uint64_t key {
+            (static_cast<uint64_t>(kind) << 62) |
+            (static_cast<uint64_t>(a) << 31) | b
+        };
+
+        boost::unordered_map<uint64_t, Node>::const_iterator i { f_hash.find(key) };
+        if (f_hash.end() != i) {
+            return i->second;
+        }
+
+        Gate gate;
+        gate.kind = kind;
+        gate.a = a;
+        gate.b = b;
+
+        Node res { static_cast<Node>(f_gates.size()) };
+        f_gates.push_back(gate);
+        f_hash.insert(std::make_pair(key, res));
+
+        return res;
+    }
+
+    Interpolant::Node Interpolant::make_leaf(Lit lit)
+    {
+        return make_gate(GATE_LEAF, Minisat::toInt(lit), 0);
+    }
+
+    Interpolant::Node Interpolant::make_and(Node a, Node b)
+    {
+        if (FALSE_NODE == a || FALSE_NODE == b) {
+            return FALSE_NODE;
+        }
+        if (TRUE_NODE == a || a == b) {
+            return b;
+        }
+        if (TRUE_NODE == b) {
+            return a;
+        }
+
+        /* commutative, operands are normalized */
+        return make_gate(GATE_AND, std::min(a, b), std::max(a, b));
+    }
+
+    Interpolant::Node Interpolant::make_or(Node a, Node b)
+    {
+        if (TRUE_NODE == a || TRUE_NODE == b) {
+            return TRUE_NODE;
+        }
+        if (FALSE_NODE == a || a == b) {
+            return b;
+        }
+        if (FALSE_NODE == b) {
+            return a;
+        }
+
+        return make_gate(GATE_OR, std::min(a, b), std::max(a, b));
+    }
+
+    void Interpolant::reachable(std::vector<bool>& res) const
+    {
+        /* operands always precede their gates */
+        res.assign(f_gates.size(), false);
+        res[f_root] = true;
+
+        for (Node i = f_root; TRUE_NODE < i; --i) {
+            if (!res[i]) {
+                continue;
+            }
+
+            const Gate& gate { f_gates[i] };
+            if (GATE_AND == gate.kind || GATE_OR == gate.kind) {
+                res[gate.a] = true;
+                res[gate.b] = true;
+            }
+        }
+    }
+
+    unsigned Interpolant::size() const
+    {
+        std::vector<bool> marks;
+        reachable(marks);
+
+        unsigned res { 0 };
+        for (Node i = TRUE_NODE + 1; i < f_gates.size(); ++i) {
+            const Gate& gate { f_gates[i] };
+            if (marks[i] && GATE_LEAF != gate.kind) {
+                ++res;
+            }
+        }
+
+        return res;
+    }
+
+    bool Interpolant::eval(const std::vector<bool>& leaves) const
+    {
+        std::vector<bool> values(1 + f_root, false);
+
+        values[TRUE_NODE] = true;
+        for (Node i = TRUE_NODE + 1; i <= f_root; ++i) {
+            const Gate& gate { f_gates[i] };
+
+            switch (gate.kind) {
+                case GATE_LEAF: {
+                    Lit lit { Minisat::toLit(gate.a) };
+                    values[i] = leaves[Minisat::var(lit)] != Minisat::sign(lit);
+                    break;
+                }
+
+                case GATE_AND:
+                    values[i] = values[gate.a] && values[gate.b];
+                    break;
+
+                case GATE_OR:
+                    values[i] = values[gate.a] || values[gate.b];
+                    break;
+
+                default:
+                    assert(false); /* unreachable */
+            }
+        }
+
+        return values[f_root];
+    }
+
+    Lit Interpolant::encode(Engine& engine, const std::vector<Var>& leaves) const
+    {
+        if (f_root <= TRUE_NODE) {
+            /* a fresh var, asserted true */
+            Var var { engine.new_sat_var() };
+
+            vec<Lit> ps;
+            ps.push(mkLit(var));
+            engine.add_clause(ps);
+
+            return mkLit(var, FALSE_NODE == f_root);
+        }
+
+        std::vector<bool> marks;
+        reachable(marks);
+
+        std::vector<Lit> lits(1 + f_root, Minisat::lit_Undef);
+        for (Node i = TRUE_NODE + 1; i <= f_root; ++i) {
+            if (!marks[i]) {
+                continue;
+            }
+
+            const Gate& gate { f_gates[i] };
+            if (GATE_LEAF == gate.kind) {
+                Lit lit { Minisat::toLit(gate.a) };
+                lits[i] = mkLit(leaves[Minisat::var(lit)], Minisat::sign(lit));
+                continue;
+            }
+
+            /* constants have been folded away */
+            Lit g { mkLit(engine.new_sat_var()) };
+            Lit a { lits[gate.a] };
+            Lit b { lits[gate.b] };
+            assert(Minisat::lit_Undef != a && Minisat::lit_Undef != b);
+
+            /* AND gates are encoded as g <-> a & b, OR gates as
+               !g <-> !a & !b */
+            bool is_or { GATE_OR == gate.kind };
+            if (is_or) {
+                g = ~g;
+                a = ~a;
+                b = ~b;
+            }
+
+            vec<Lit> ps;
+
+            ps.push(~g);
+            ps.push(a);
+            engine.add_clause(ps);
+
+            ps.clear();
+            ps.push(~g);
+            ps.push(b);
+            engine.add_clause(ps);
+
+            ps.clear();
+            ps.push(g);
+            ps.push(~a);
+            ps.push(~b);
+            engine.add_clause(ps);
+
+            lits[i] = is_or ? ~g : g;
+        }
+
+        return lits[f_root];
+    }
+
+}; // namespace sat
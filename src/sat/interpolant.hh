@@ -0,0 +1,120 @@
+/**
+ * @file sat/interpolant.hh
+ * @brief SAT interface, Craig interpolants declarations.
+ *
+ * This module contains the declarations of the circuits Craig
+ * interpolants are built into. An interpolant is an AND/OR circuit
+ * over literals (leaves), with constants folded and structurally
+ * hashed gates. Leaves are opaque to the circuit: it is up to the
+ * producer and the consumers to agree on what they stand for (see
+ * sat/proof.hh).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_INTERPOLANT_H
+#define SAT_INTERPOLANT_H
+
+#include <stdint.h>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+#include <sat/typedefs.hh>
+
+namespace sat {
+
+    class Interpolant {
+    public:
+        typedef unsigned Node;
+
+        static const Node FALSE_NODE = 0;
+        static const Node TRUE_NODE = 1;
+
+        Interpolant();
+
+        Node make_leaf(Lit lit);
+        Node make_and(Node a, Node b);
+        Node make_or(Node a, Node b);
+
+        inline Node make_const(bool value) const
+        {
+            return value ? TRUE_NODE : FALSE_NODE;
+        }
+
+        inline void set_root(Node root)
+        {
+            f_root = root;
+        }
+
+        inline Node root() const
+        {
+            return f_root;
+        }
+
+        inline bool is_true() const
+        {
+            return TRUE_NODE == f_root;
+        }
+
+        inline bool is_false() const
+        {
+            return FALSE_NODE == f_root;
+        }
+
+        /* number of gates reachable from the root */
+        unsigned size() const;
+
+        /* value of the root, leaves[var] is the value of leaf var */
+        bool eval(const std::vector<bool>& leaves) const;
+
+        /* Tseitin encoding of the circuit into engine, leaf var v is
+         * mapped to engine var leaves[v]. Returns a literal which is
+         * equivalent to the root. */
+        Lit encode(Engine& engine, const std::vector<Var>& leaves) const;
+
+    private:
+        typedef enum {
+            GATE_CONST,
+            GATE_LEAF,
+            GATE_AND,
+            GATE_OR,
+        } gate_t;
+
+        /* leaves hold the literal (Minisat integer encoding) in `a` */
+        struct Gate {
+            gate_t kind;
+            unsigned a;
+            unsigned b;
+        };
+
+        Node make_gate(gate_t kind, unsigned a, unsigned b);
+
+        /* marks gates reachable from the root */
+        void reachable(std::vector<bool>& res) const;
+
+        std::vector<Gate> f_gates;
+        boost::unordered_map<uint64_t, Node> f_hash;
+
+        Node f_root;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_INTERPOLANT_H */
@@ -97,46 +97,14 @@ namespace sat {
 
     std::ostream& operator<<(std::ostream& os, const Engine& engine)
     {
-        const Solver& solver { engine.f_solver };
-
         os
             << "Solver: `"
             << engine.f_instance_name
+            << "` ("
+            << engine.f_backend->name()
+            << "), ";
 
-            << "`, solves: "
-            << solver.solves
-
-            << ", starts: "
-            << solver.starts
-
-            << ", decs: "
-            << solver.decisions
-
-            << ", rnd decs: "
-            << solver.rnd_decisions
-
-            << ", props: "
-            << solver.propagations
-
-            << ", conflicts: "
-            << solver.conflicts
-
-            << ", dec vars: "
-            << solver.dec_vars
-
-            << ", clause lits: "
-            << solver.clauses_literals
-
-            << ", learnt lits: "
-            << solver.learnts_literals
-
-            << ", max lits: "
-            << solver.max_literals
-
-            << ", tot lits: "
-            << solver.tot_literals
-
-            ;
+        engine.f_backend->print_stats(os);
 
         return os;
     }
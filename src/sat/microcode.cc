@@ -0,0 +1,333 @@
+/**
+ * @file sat/microcode.cc
+ * @brief SAT interface, microcode clauses container implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include <sat/exceptions.hh>
+#include <sat/microcode.hh>
+
+namespace sat {
+
+    const char* MICROCODE_JSON_EXT { ".json" };
+    const char* MICROCODE_BINARY_EXT { ".bin" };
+    const char* MICROCODE_ARCHIVE { "microcode.pack" };
+
+    /* checks a binary microcode image, either mapped or in memory */
+    static const MicrocodeHeader* check_image(const std::string& filename,
+                                              const void* data, size_t size)
+    {
+        if (size < sizeof(MicrocodeHeader)) {
+            throw MicrocodeException(filename, "truncated header");
+        }
+
+        const MicrocodeHeader* header {
+            reinterpret_cast<const MicrocodeHeader*>(data)
+        };
+
+        if (MICROCODE_MAGIC != header->magic) {
+            throw MicrocodeException(filename, "bad magic number");
+        }
+
+        if (MICROCODE_VERSION != header->version) {
+            throw MicrocodeException(filename, "unsupported format version");
+        }
+
+        size_t expected { sizeof(MicrocodeHeader) +
+                          sizeof(uint32_t) * (1 + header->n_clauses) +
+                          sizeof(int32_t) * header->n_literals };
+
+        if (size != expected) {
+            throw MicrocodeException(filename, "size mismatch");
+        }
+
+        return header;
+    }
+
+    Microcode::Microcode()
+        : f_n_clauses(0)
+        , f_n_literals(0)
+        , f_offsets(NULL)
+        , f_literals(NULL)
+        , f_mapping(NULL)
+        , f_mapping_size(0)
+    {}
+
+    Microcode::~Microcode()
+    {
+        unmap();
+    }
+
+    void Microcode::unmap()
+    {
+        if (NULL != f_mapping) {
+            munmap(f_mapping, f_mapping_size);
+
+            f_mapping = NULL;
+            f_mapping_size = 0;
+        }
+    }
+
+    void Microcode::map(const boost::filesystem::path& filepath)
+    {
+        const std::string& filename { filepath.native() };
+
+        int fd { open(filename.c_str(), O_RDONLY) };
+        if (fd < 0) {
+            throw MicrocodeException(filename, strerror(errno));
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            int saved_errno { errno };
+            close(fd);
+            throw MicrocodeException(filename, strerror(saved_errno));
+        }
+
+        size_t size { static_cast<size_t>(st.st_size) };
+        if (size < sizeof(MicrocodeHeader)) {
+            close(fd);
+            throw MicrocodeException(filename, "truncated header");
+        }
+
+        void* mapping { mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) };
+        close(fd); /* the mapping keeps the file referenced */
+
+        if (MAP_FAILED == mapping) {
+            throw MicrocodeException(filename, strerror(errno));
+        }
+
+        const MicrocodeHeader* header;
+        try {
+            header = check_image(filename, mapping, size);
+        } catch (const MicrocodeException&) {
+            munmap(mapping, size);
+            throw;
+        }
+
+        unmap();
+        f_mapping = mapping;
+        f_mapping_size = size;
+
+        f_n_clauses = header->n_clauses;
+        f_n_literals = header->n_literals;
+
+        f_offsets = reinterpret_cast<const uint32_t*>(1 + header);
+        f_literals = reinterpret_cast<const int32_t*>(f_offsets + 1 + f_n_clauses);
+
+        /* advise the kernel, clauses are always scanned sequentially */
+        madvise(f_mapping, f_mapping_size, MADV_SEQUENTIAL);
+    }
+
+    void Microcode::decode(const std::string& filename, const char* data, size_t size)
+    {
+        const MicrocodeHeader* header { check_image(filename, data, size) };
+
+        const uint32_t* offsets { reinterpret_cast<const uint32_t*>(1 + header) };
+        const int32_t* literals { reinterpret_cast<const int32_t*>(offsets + 1 + header->n_clauses) };
+
+        std::vector<uint32_t> offsets_storage(offsets, offsets + 1 + header->n_clauses);
+        std::vector<int32_t> literals_storage(literals, literals + header->n_literals);
+
+        if (0 != offsets_storage[0] ||
+            offsets_storage.back() != literals_storage.size()) {
+            throw MicrocodeException(filename, "bad clause offsets");
+        }
+
+        assign(offsets_storage, literals_storage);
+    }
+
+    void Microcode::assign(std::vector<uint32_t>& offsets, std::vector<int32_t>& literals)
+    {
+        assert(!offsets.empty() && 0 == offsets[0]);
+        assert(offsets.back() == literals.size());
+
+        unmap();
+
+        f_offsets_storage.clear();
+        f_literals_storage.clear();
+
+        f_offsets_storage.swap(offsets);
+        f_literals_storage.swap(literals);
+
+        f_n_clauses = f_offsets_storage.size() - 1;
+        f_n_literals = f_literals_storage.size();
+
+        f_offsets = f_offsets_storage.data();
+        f_literals = f_literals_storage.data();
+    }
+
+    void Microcode::write(const boost::filesystem::path& filepath) const
+    {
+        assert(ready());
+
+        const std::string& filename { filepath.native() };
+        std::ofstream out { filename.c_str(), std::ios::binary | std::ios::trunc };
+
+        if (!out) {
+            throw MicrocodeException(filename, "can not open file for writing");
+        }
+
+        MicrocodeHeader header;
+        header.magic = MICROCODE_MAGIC;
+        header.version = MICROCODE_VERSION;
+        header.n_clauses = f_n_clauses;
+        header.n_literals = f_n_literals;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(f_offsets),
+                  sizeof(uint32_t) * (1 + f_n_clauses));
+        out.write(reinterpret_cast<const char*>(f_literals),
+                  sizeof(int32_t) * f_n_literals);
+
+        if (!out) {
+            throw MicrocodeException(filename, "write failed");
+        }
+    }
+
+    MicrocodeArchive::MicrocodeArchive()
+        : f_fd(-1)
+    {}
+
+    MicrocodeArchive::~MicrocodeArchive()
+    {
+        if (0 <= f_fd) {
+            close(f_fd);
+        }
+    }
+
+    /* reads exactly `size` bytes at `offset`, false on errors or
+       short reads */
+    static bool read_at(int fd, void* buf, size_t size, off_t offset)
+    {
+        char* p { static_cast<char*>(buf) };
+        while (0 < size) {
+            ssize_t n { pread(fd, p, size, offset) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+
+            p += n;
+            size -= n;
+            offset += n;
+        }
+
+        return true;
+    }
+
+    void MicrocodeArchive::open(const boost::filesystem::path& filepath)
+    {
+        const std::string& filename { filepath.native() };
+
+        int fd { ::open(filename.c_str(), O_RDONLY) };
+        if (fd < 0) {
+            throw MicrocodeException(filename, strerror(errno));
+        }
+
+        MicrocodeArchiveHeader header;
+        if (!read_at(fd, &header, sizeof(header), 0)) {
+            close(fd);
+            throw MicrocodeException(filename, "truncated header");
+        }
+
+        if (MICROCODE_ARCHIVE_MAGIC != header.magic) {
+            close(fd);
+            throw MicrocodeException(filename, "bad magic number");
+        }
+
+        if (MICROCODE_ARCHIVE_VERSION != header.version) {
+            close(fd);
+            throw MicrocodeException(filename, "unsupported format version");
+        }
+
+        std::vector<MicrocodeArchiveEntry> entries(header.n_entries);
+        if (!read_at(fd, entries.data(), sizeof(MicrocodeArchiveEntry) * entries.size(),
+                     sizeof(header))) {
+            close(fd);
+            throw MicrocodeException(filename, "truncated entries");
+        }
+
+        boost::unordered_map<std::string, MicrocodeArchiveEntry> index;
+        for (const auto& entry : entries) {
+            std::string name { entry.name, strnlen(entry.name, MICROCODE_ARCHIVE_NAME_LEN) };
+            index.insert(std::make_pair(name, entry));
+        }
+
+        if (0 <= f_fd) {
+            close(f_fd);
+        }
+
+        f_fd = fd;
+        f_path = filepath;
+        f_entries.swap(index);
+    }
+
+    bool MicrocodeArchive::has(const std::string& name) const
+    {
+        return f_entries.end() != f_entries.find(name);
+    }
+
+    void MicrocodeArchive::extract(const std::string& name, Microcode& res) const
+    {
+        assert(is_open());
+
+        /* reported as the file the blob would be unpacked to */
+        const std::string filename { (f_path / (name + MICROCODE_BINARY_EXT)).native() };
+
+        boost::unordered_map<std::string, MicrocodeArchiveEntry>::const_iterator i {
+            f_entries.find(name)
+        };
+        if (f_entries.end() == i) {
+            throw MicrocodeException(filename, "not in archive");
+        }
+
+        const MicrocodeArchiveEntry& entry { i->second };
+
+        std::vector<Bytef> packed(entry.packed_size);
+        if (!read_at(f_fd, packed.data(), packed.size(), entry.offset)) {
+            throw MicrocodeException(filename, "truncated blob");
+        }
+
+        std::vector<char> image(entry.size);
+        uLongf size { entry.size };
+        if (Z_OK != uncompress(reinterpret_cast<Bytef*>(image.data()), &size,
+                               packed.data(), packed.size()) ||
+            size != entry.size) {
+            throw MicrocodeException(filename, "corrupted blob");
+        }
+
+        res.decode(filename, image.data(), image.size());
+    }
+
+}; // namespace sat
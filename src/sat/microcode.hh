@@ -0,0 +1,217 @@
+/**
+ * @file sat/microcode.hh
+ * @brief SAT interface, microcode clauses container declaration.
+ *
+ * This module contains the declaration of the flat container used to
+ * hold the CNF clauses of an inlined operator (a.k.a. microcode), as
+ * well as the definition of the binary microcode format. Binary
+ * microcode files can be memory-mapped and used in-place, without any
+ * parsing or per-clause allocation, and of the microcode archive,
+ * which holds the binary microcode files of a whole microcode
+ * directory, each compressed on its own.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_MICROCODE_H
+#define SAT_MICROCODE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <sat/typedefs.hh>
+
+namespace sat {
+
+    /* Binary microcode format. All fields are stored in host byte
+     * order, the file layout is:
+     *
+     *   header | offsets[n_clauses + 1] | literals[n_literals]
+     *
+     * Literals use the Minisat integer encoding (see
+     * Minisat::toInt), the i-th clause spans literals in the range
+     * [offsets[i], offsets[i + 1]). */
+    const uint32_t MICROCODE_MAGIC { 0x42435559 }; /* "YUCB" */
+    const uint32_t MICROCODE_VERSION { 1 };
+
+    extern const char* MICROCODE_JSON_EXT;
+    extern const char* MICROCODE_BINARY_EXT;
+
+    struct MicrocodeHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t n_clauses;
+        uint32_t n_literals;
+    };
+
+    /* Microcode archive format. All fields are stored in host byte
+     * order, the file layout is:
+     *
+     *   header | entries[n_entries] | blobs
+     *
+     * Each blob is a binary microcode file, compressed as a single
+     * zlib stream. Entries give the offset of the blob from the start
+     * of the archive, its compressed and inflated sizes, so that the
+     * clauses of an operator are read and inflated with no need to go
+     * through those of any other. */
+    const uint32_t MICROCODE_ARCHIVE_MAGIC { 0x41435559 }; /* "YUCA" */
+    const uint32_t MICROCODE_ARCHIVE_VERSION { 1 };
+    const unsigned MICROCODE_ARCHIVE_NAME_LEN { 32 };
+
+    extern const char* MICROCODE_ARCHIVE;
+
+    struct MicrocodeArchiveHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t n_entries;
+        uint32_t reserved;
+    };
+
+    struct MicrocodeArchiveEntry {
+        char name[MICROCODE_ARCHIVE_NAME_LEN]; /* NUL-padded */
+        uint64_t offset;
+        uint32_t packed_size;
+        uint32_t size;
+    };
+
+    class Microcode {
+    public:
+        Microcode();
+        ~Microcode();
+
+        /* maps a binary microcode file in memory, the clauses are
+         * used in-place. */
+        void map(const boost::filesystem::path& filepath);
+
+        /* copies the clauses out of a binary microcode image held in
+         * memory (e.g. inflated from an archive), `filename` is only
+         * used to report errors. */
+        void decode(const std::string& filename, const char* data, size_t size);
+
+        /* takes over a flat representation built by the caller (e.g.
+         * parsing a JSON microcode file): the i-th clause spans
+         * literals in [offsets[i], offsets[i + 1]), offsets[0] is 0.
+         * Both vectors are left empty. */
+        void assign(std::vector<uint32_t>& offsets, std::vector<int32_t>& literals);
+
+        /* writes the flat representation in binary microcode format */
+        void write(const boost::filesystem::path& filepath) const;
+
+        /* true iff clauses have been either mapped or assigned */
+        inline bool ready() const
+        {
+            return NULL != f_offsets;
+        }
+
+        /* number of clauses */
+        inline unsigned size() const
+        {
+            return f_n_clauses;
+        }
+
+        /* total number of literals */
+        inline unsigned n_literals() const
+        {
+            return f_n_literals;
+        }
+
+        /* literals range for the i-th clause */
+        inline const int32_t* clause_begin(unsigned i) const
+        {
+            assert(i < f_n_clauses);
+            return f_literals + f_offsets[i];
+        }
+
+        inline const int32_t* clause_end(unsigned i) const
+        {
+            assert(i < f_n_clauses);
+            return f_literals + f_offsets[1 + i];
+        }
+
+    private:
+        /* non-copyable, the mapping is owned by this instance */
+        Microcode(const Microcode&);
+        Microcode& operator=(const Microcode&);
+
+        void unmap();
+
+        unsigned f_n_clauses;
+        unsigned f_n_literals;
+
+        const uint32_t* f_offsets;
+        const int32_t* f_literals;
+
+        /* memory mapping (binary microcode) */
+        void* f_mapping;
+        size_t f_mapping_size;
+
+        /* heap storage (JSON microcode) */
+        std::vector<uint32_t> f_offsets_storage;
+        std::vector<int32_t> f_literals_storage;
+    };
+
+    class MicrocodeArchive {
+    public:
+        MicrocodeArchive();
+        ~MicrocodeArchive();
+
+        /* reads the header and the entries of an archive, blobs are
+         * only read when extracted. */
+        void open(const boost::filesystem::path& filepath);
+
+        inline bool is_open() const
+        {
+            return 0 <= f_fd;
+        }
+
+        inline const boost::filesystem::path& path() const
+        {
+            return f_path;
+        }
+
+        /* number of entries */
+        inline size_t size() const
+        {
+            return f_entries.size();
+        }
+
+        bool has(const std::string& name) const;
+
+        /* reads and inflates the blob for `name` into `res`. Blobs are
+         * read with positioned reads, concurrent extractions need no
+         * lock. */
+        void extract(const std::string& name, Microcode& res) const;
+
+    private:
+        /* non-copyable, the descriptor is owned by this instance */
+        MicrocodeArchive(const MicrocodeArchive&);
+        MicrocodeArchive& operator=(const MicrocodeArchive&);
+
+        boost::filesystem::path f_path;
+        int f_fd;
+
+        boost::unordered_map<std::string, MicrocodeArchiveEntry> f_entries;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_MICROCODE_H */
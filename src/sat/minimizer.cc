@@ -0,0 +1,373 @@
+/**
+ * @file sat/minimizer.cc
+ * @brief SAT interface, microcode CNF minimizer implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cassert>
+
+#include <sat/minimizer.hh>
+
+namespace sat {
+
+    /* bounded variable elimination limits: vars requiring too many
+       resolution steps, or yielding long resolvents, are kept */
+    static const size_t MAX_RESOLUTIONS { 256 };
+    static const size_t MAX_RESOLVENT_SIZE { 20 };
+
+    /* Literals use the Minisat integer encoding (see
+       Minisat::toInt): in a sorted clause complementary literals are
+       adjacent. */
+    static inline int32_t lit_var(int32_t lit)
+    {
+        return lit >> 1;
+    }
+
+    static inline uint64_t abstraction(const std::vector<int32_t>& clause)
+    {
+        uint64_t res { 0 };
+        for (int32_t lit : clause) {
+            res |= 1ULL << (lit_var(lit) & 63);
+        }
+
+        return res;
+    }
+
+    typedef enum {
+        SUBSUMPTION_NONE,
+        SUBSUMPTION_FULL,
+        SUBSUMPTION_STRENGTHEN,
+    } subsumption_t;
+
+    /* does `c` subsume `d`? If `c` subsumes `d` once a single literal
+       is complemented, `flip` is set to the literal of `d` that can be
+       removed (self-subsuming resolution). Both clauses are sorted. */
+    static subsumption_t subsumes(const std::vector<int32_t>& c,
+                                  const std::vector<int32_t>& d, int32_t& flip)
+    {
+        size_t k { 0 };
+
+        flip = -1;
+        for (int32_t lit : c) {
+            while (k < d.size() && lit_var(d[k]) < lit_var(lit)) {
+                ++k;
+            }
+
+            if (k == d.size() || lit_var(d[k]) != lit_var(lit)) {
+                return SUBSUMPTION_NONE;
+            }
+
+            if (d[k] != lit) {
+                if (0 <= flip) {
+                    return SUBSUMPTION_NONE;
+                }
+
+                flip = d[k];
+            }
+
+            ++k;
+        }
+
+        return flip < 0 ? SUBSUMPTION_FULL : SUBSUMPTION_STRENGTHEN;
+    }
+
+    /* resolves `a` and `b` on `var`, false iff the resolvent is a
+       tautology */
+    static bool resolve(const std::vector<int32_t>& a, const std::vector<int32_t>& b,
+                        int32_t var, std::vector<int32_t>& out)
+    {
+        size_t i { 0 };
+        size_t j { 0 };
+
+        out.clear();
+        while (i < a.size() || j < b.size()) {
+            int32_t lit;
+
+            if (j == b.size() || (i < a.size() && a[i] < b[j])) {
+                lit = a[i++];
+            } else if (i == a.size() || b[j] < a[i]) {
+                lit = b[j++];
+            } else {
+                lit = a[i];
+                ++i;
+                ++j;
+            }
+
+            if (lit_var(lit) == var) {
+                continue;
+            }
+
+            if (!out.empty() && lit_var(out.back()) == lit_var(lit)) {
+                return false;
+            }
+
+            out.push_back(lit);
+        }
+
+        return true;
+    }
+
+    CNFMinimizer::CNFMinimizer(unsigned n_frozen)
+        : f_n_frozen(n_frozen)
+        , f_subsumed(0)
+        , f_strengthened(0)
+        , f_eliminated(0)
+    {}
+
+    void CNFMinimizer::load(const Microcode& microcode)
+    {
+        int32_t n_vars { static_cast<int32_t>(f_n_frozen) };
+        for (unsigned i = 0; i < microcode.size(); ++i) {
+            const int32_t* end { microcode.clause_end(i) };
+            for (const int32_t* p = microcode.clause_begin(i); p != end; ++p) {
+                n_vars = std::max(n_vars, 1 + lit_var(*p));
+            }
+        }
+
+        f_occurs.resize(n_vars);
+
+        Clause clause;
+        for (unsigned i = 0; i < microcode.size(); ++i) {
+            clause.assign(microcode.clause_begin(i), microcode.clause_end(i));
+            add_clause(clause);
+        }
+    }
+
+    void CNFMinimizer::add_clause(Clause& clause)
+    {
+        std::sort(clause.begin(), clause.end());
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+        for (size_t k = 1; k < clause.size(); ++k) {
+            if (lit_var(clause[k - 1]) == lit_var(clause[k])) {
+                return; /* tautology */
+            }
+        }
+
+        unsigned index { static_cast<unsigned>(f_clauses.size()) };
+
+        for (int32_t lit : clause) {
+            f_occurs[lit_var(lit)].push_back(index);
+        }
+
+        f_abstractions.push_back(abstraction(clause));
+        f_removed.push_back(false);
+        f_clauses.push_back(Clause());
+        f_clauses.back().swap(clause);
+
+        f_queue.push_back(index);
+    }
+
+    void CNFMinimizer::remove_clause(unsigned i)
+    {
+        /* occurrence lists are cleaned lazily */
+        f_removed[i] = true;
+        f_clauses[i].clear();
+    }
+
+    const std::vector<unsigned>& CNFMinimizer::occurrences(int32_t var)
+    {
+        std::vector<unsigned>& occurs { f_occurs[var] };
+
+        /* drop removed clauses, and clauses `var` has been removed
+           from by strengthening */
+        occurs.erase(
+            std::remove_if(
+                occurs.begin(), occurs.end(),
+                [this, var](unsigned i) {
+                    const Clause& clause { f_clauses[i] };
+                    Clause::const_iterator p {
+                        std::lower_bound(clause.begin(), clause.end(), 2 * var)
+                    };
+
+                    return f_removed[i] ||
+                           p == clause.end() || lit_var(*p) != var;
+                }),
+            occurs.end());
+
+        return occurs;
+    }
+
+    void CNFMinimizer::subsume()
+    {
+        while (!f_queue.empty()) {
+            unsigned i { f_queue.front() };
+            f_queue.pop_front();
+
+            if (f_removed[i]) {
+                continue;
+            }
+
+            /* candidates are the clauses sharing the least frequent
+               var of clause i */
+            const Clause& c { f_clauses[i] };
+            int32_t best { lit_var(c[0]) };
+            for (int32_t lit : c) {
+                if (occurrences(lit_var(lit)).size() < f_occurs[best].size()) {
+                    best = lit_var(lit);
+                }
+            }
+
+            const std::vector<unsigned> candidates { occurrences(best) };
+            for (unsigned j : candidates) {
+                if (j == i || f_removed[j]) {
+                    continue;
+                }
+
+                const Clause& d { f_clauses[j] };
+                if (c.size() > d.size() || (f_abstractions[i] & ~f_abstractions[j])) {
+                    continue;
+                }
+
+                int32_t flip;
+                switch (subsumes(c, d, flip)) {
+                    case SUBSUMPTION_FULL:
+                        remove_clause(j);
+                        ++f_subsumed;
+                        break;
+
+                    case SUBSUMPTION_STRENGTHEN:
+                        strengthen(j, flip);
+                        break;
+
+                    case SUBSUMPTION_NONE:
+                        break;
+                }
+            }
+        }
+    }
+
+    void CNFMinimizer::strengthen(unsigned i, int32_t lit)
+    {
+        Clause& clause { f_clauses[i] };
+
+        clause.erase(std::find(clause.begin(), clause.end(), lit));
+        assert(!clause.empty());
+
+        f_abstractions[i] = abstraction(clause);
+        ++f_strengthened;
+
+        /* the strengthened clause may now subsume others */
+        f_queue.push_back(i);
+    }
+
+    bool CNFMinimizer::eliminate(int32_t var)
+    {
+        const std::vector<unsigned> occurs { occurrences(var) };
+        if (occurs.empty()) {
+            return false;
+        }
+
+        std::vector<unsigned> pos;
+        std::vector<unsigned> neg;
+        for (unsigned i : occurs) {
+            const Clause& clause { f_clauses[i] };
+            if (std::binary_search(clause.begin(), clause.end(), 2 * var)) {
+                pos.push_back(i);
+            } else {
+                neg.push_back(i);
+            }
+        }
+
+        if (pos.size() * neg.size() > MAX_RESOLUTIONS) {
+            return false;
+        }
+
+        /* eliminate only if the clause count does not grow */
+        std::vector<Clause> resolvents;
+        Clause resolvent;
+        for (unsigned p : pos) {
+            for (unsigned n : neg) {
+                if (!resolve(f_clauses[p], f_clauses[n], var, resolvent)) {
+                    continue;
+                }
+
+                if (resolvent.size() > MAX_RESOLVENT_SIZE ||
+                    resolvents.size() == occurs.size()) {
+                    return false;
+                }
+
+                resolvents.push_back(resolvent);
+            }
+        }
+
+        for (unsigned i : occurs) {
+            remove_clause(i);
+        }
+
+        for (Clause& clause : resolvents) {
+            add_clause(clause);
+        }
+
+        ++f_eliminated;
+        return true;
+    }
+
+    void CNFMinimizer::run()
+    {
+        subsume();
+
+        /* interface vars are frozen, cheapest candidates first */
+        std::vector<std::pair<size_t, int32_t>> candidates;
+        for (int32_t var = f_n_frozen; var < static_cast<int32_t>(f_occurs.size()); ++var) {
+            candidates.push_back(std::make_pair(occurrences(var).size(), var));
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const auto& candidate : candidates) {
+            eliminate(candidate.second);
+        }
+
+        /* resolvents may be subsumed by older clauses as well */
+        for (unsigned i = 0; i < f_clauses.size(); ++i) {
+            if (!f_removed[i]) {
+                f_queue.push_back(i);
+            }
+        }
+        subsume();
+    }
+
+    void CNFMinimizer::flush(Microcode& microcode)
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<int32_t> literals;
+
+        offsets.push_back(0);
+        for (unsigned i = 0; i < f_clauses.size(); ++i) {
+            if (f_removed[i]) {
+                continue;
+            }
+
+            const Clause& clause { f_clauses[i] };
+            literals.insert(literals.end(), clause.begin(), clause.end());
+            offsets.push_back(literals.size());
+        }
+
+        microcode.assign(offsets, literals);
+
+        f_clauses.clear();
+        f_removed.clear();
+        f_abstractions.clear();
+        f_occurs.clear();
+        f_queue.clear();
+    }
+
+}; // namespace sat
@@ -0,0 +1,107 @@
+/**
+ * @file sat/minimizer.hh
+ * @brief SAT interface, microcode CNF minimizer declarations.
+ *
+ * This module contains the declarations of the one-time CNF
+ * minimizer microcode goes through when it is loaded. Microcode is
+ * injected once for each unrolling step, shrinking it pays off
+ * immediately. The minimizer performs subsumption, self-subsuming
+ * resolution and bounded variable elimination (SatELite-style);
+ * interface vars (z, x, y) are never eliminated, so that the
+ * minimized clauses define exactly the same relation among them.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_MINIMIZER_H
+#define SAT_MINIMIZER_H
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+#include <sat/microcode.hh>
+
+namespace sat {
+
+    class CNFMinimizer {
+    public:
+        /* vars in [0, n_frozen) are interface vars */
+        CNFMinimizer(unsigned n_frozen);
+
+        /* takes a copy of the clauses in `microcode` */
+        void load(const Microcode& microcode);
+
+        /* subsumption, self-subsuming resolution, bounded variable
+           elimination and a final subsumption round */
+        void run();
+
+        /* moves the minimized clauses into `microcode` */
+        void flush(Microcode& microcode);
+
+        inline unsigned subsumed() const
+        {
+            return f_subsumed;
+        }
+
+        inline unsigned strengthened() const
+        {
+            return f_strengthened;
+        }
+
+        inline unsigned eliminated() const
+        {
+            return f_eliminated;
+        }
+
+    private:
+        typedef std::vector<int32_t> Clause;
+
+        /* normalizes (sorts, drops duplicate literals) and adds a
+           clause. Tautologies are discarded. */
+        void add_clause(Clause& clause);
+        void remove_clause(unsigned i);
+
+        /* drops stale entries from the occurrence list of var */
+        const std::vector<unsigned>& occurrences(int32_t var);
+
+        void subsume();
+        void strengthen(unsigned i, int32_t lit);
+        bool eliminate(int32_t var);
+
+        unsigned f_n_frozen;
+
+        std::vector<Clause> f_clauses;
+        std::vector<bool> f_removed;
+        std::vector<uint64_t> f_abstractions;
+
+        /* var -> indexes of clauses containing it (either polarity) */
+        std::vector<std::vector<unsigned>> f_occurs;
+
+        /* clauses to be checked for (self-)subsumption */
+        std::deque<unsigned> f_queue;
+
+        unsigned f_subsumed;
+        unsigned f_strengthened;
+        unsigned f_eliminated;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_MINIMIZER_H */
@@ -0,0 +1,64 @@
+/**
+ * @file sat/portfolio.cc
+ * @brief SAT interface, solver portfolio implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sat/exceptions.hh>
+#include <sat/portfolio.hh>
+
+namespace sat {
+
+    /* backend, seed, random freq, luby, phase saving, ccmin */
+    static const SolverConfig DEFAULT_CONFIGS[] = {
+        { NULL, -1, -1, -1, -1, -1 },
+    };
+
+    static const SolverConfig DIVERSE_CONFIGS[] = {
+        { NULL, -1, -1, -1, -1, -1 },
+        { NULL, 2, -1, 0, 1, -1 },
+        { "minisat-core", 3, .02, -1, -1, 1 },
+        { NULL, 4, .0, 1, 0, 2 },
+    };
+
+    static const struct {
+        const char* name;
+        SolverConfigs configs;
+    } PORTFOLIO_PROFILES[] = {
+        { "default",
+          SolverConfigs(DEFAULT_CONFIGS,
+                        DEFAULT_CONFIGS + sizeof(DEFAULT_CONFIGS) / sizeof(SolverConfig)) },
+        { "diverse",
+          SolverConfigs(DIVERSE_CONFIGS,
+                        DIVERSE_CONFIGS + sizeof(DIVERSE_CONFIGS) / sizeof(SolverConfig)) },
+    };
+
+    const SolverConfigs& portfolio_profile(const std::string& name)
+    {
+        for (const auto& profile : PORTFOLIO_PROFILES) {
+            if (name == profile.name) {
+                return profile.configs;
+            }
+        }
+
+        throw UnknownPortfolioProfile(name);
+    }
+
+}; // namespace sat
@@ -0,0 +1,65 @@
+/**
+ * @file sat/portfolio.hh
+ * @brief SAT interface, solver portfolio declaration.
+ *
+ * This module contains the declaration of solver configurations and
+ * portfolio profiles. A profile is a list of diversified
+ * configurations, which the EngineMgr hands out in turn to newly
+ * created engines, so that concurrently running strategies do not
+ * race on the same search heuristics.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_PORTFOLIO_H
+#define SAT_PORTFOLIO_H
+
+#include <string>
+#include <vector>
+
+namespace sat {
+
+    /* Solver configuration. Negative values (and NULL) mean the
+     * backend default is kept. */
+    struct SolverConfig {
+        /* backend name */
+        const char* backend;
+
+        double random_seed;
+        double random_var_freq;
+
+        /* 0: geometric, 1: luby */
+        int luby_restart;
+
+        /* 0: none, 1: limited, 2: full */
+        int phase_saving;
+
+        /* 0: none, 1: basic, 2: deep */
+        int ccmin_mode;
+    };
+
+    typedef std::vector<SolverConfig> SolverConfigs;
+
+    /* configurations for the given profile, throws
+     * UnknownPortfolioProfile */
+    const SolverConfigs& portfolio_profile(const std::string& name);
+
+}; // namespace sat
+
+#endif /* SAT_PORTFOLIO_H */
@@ -0,0 +1,1049 @@
+/**
+ * @file sat/proof.cc
+ * @brief SAT interface, proof-logging solver backend implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include <sat/proof.hh>
+
+namespace sat {
+
+    static const double VAR_DECAY { 0.95 };
+    static const double CLAUSE_DECAY { 0.999 };
+    static const int64_t RESTART_FIRST { 100 };
+    static const double MIN_LEARNTS { 2000 };
+
+    static const uint8_t OCCURS_A { 1 };
+    static const uint8_t OCCURS_B { 2 };
+
+    /* seen marks, root level vars are resolved away last */
+    static const uint8_t SEEN { 1 };
+    static const uint8_t SEEN_ROOT { 2 };
+
+    static const Interpolant::Node NO_NODE {
+        std::numeric_limits<Interpolant::Node>::max()
+    };
+
+    /* Luby restart sequence, as in Minisat */
+    static double luby(double y, int x)
+    {
+        int size { 1 };
+        int seq { 0 };
+
+        while (size < x + 1) {
+            ++seq;
+            size = 2 * size + 1;
+        }
+
+        while (size - 1 != x) {
+            size = (size - 1) >> 1;
+            --seq;
+            x = x % size;
+        }
+
+        double res { 1.0 };
+        while (0 < seq--) {
+            res *= y;
+        }
+
+        return res;
+    }
+
+    const ProofBackend::ClauseId ProofBackend::NO_CLAUSE;
+
+    ProofBackend::ProofBackend()
+        : f_max_learnts(MIN_LEARNTS)
+        , f_var_inc(1.0)
+        , f_clause_inc(1.0)
+        , f_qhead(0)
+        , f_units_done(0)
+        , f_empty(NO_CLAUSE)
+        , f_refutation(NO_CLAUSE)
+        , f_partition(PARTITION_A)
+        , f_interrupted(false)
+        , f_conf_budget(-1)
+        , f_prop_budget(-1)
+        , f_solves(0)
+        , f_conflicts(0)
+        , f_decisions(0)
+        , f_propagations(0)
+        , f_resolutions(0)
+    {}
+
+    ProofBackend::~ProofBackend()
+    {}
+
+    const char* ProofBackend::name() const
+    {
+        return "proof";
+    }
+
+    Var ProofBackend::new_var(bool frozen)
+    {
+        Var var { static_cast<Var>(f_assigns.size()) };
+
+        f_assigns.push_back(2);
+        f_polarity.push_back(1);
+        f_level.push_back(0);
+        f_reason.push_back(NO_CLAUSE);
+        f_unit.push_back(NO_CLAUSE);
+        f_occurs.push_back(0);
+        f_seen.push_back(0);
+        f_activity.push_back(0.0);
+        f_heap_index.push_back(-1);
+
+        f_watches.push_back(std::vector<ClauseId>());
+        f_watches.push_back(std::vector<ClauseId>());
+
+        heap_insert(var);
+        return var;
+    }
+
+    void ProofBackend::freeze(Var var, bool frozen)
+    {
+        /* no preprocessing, nothing to do */
+    }
+
+    unsigned ProofBackend::eliminate()
+    {
+        return 0;
+    }
+
+    bool ProofBackend::is_eliminated(Var var) const
+    {
+        return false;
+    }
+
+    /* the interpolant is built from the proof, which refers to every
+       clause: none is dropped */
+    void ProofBackend::simplify()
+    {}
+
+    void ProofBackend::limit_memory(uint64_t max_bytes)
+    {}
+
+    ProofBackend::ClauseId ProofBackend::new_clause(bool original, partition_t partition)
+    {
+        ClauseId res { static_cast<ClauseId>(f_clauses.size()) };
+
+        Clause clause;
+        clause.original = original;
+        clause.attached = false;
+        clause.partition = partition;
+        clause.activity = 0.0;
+        clause.start = NO_CLAUSE;
+
+        f_clauses.push_back(clause);
+        return res;
+    }
+
+    void ProofBackend::attach(ClauseId id)
+    {
+        Clause& clause { f_clauses[id] };
+        assert(2 <= clause.lits.size());
+
+        clause.attached = true;
+        f_watches[clause.lits[0]].push_back(id);
+        f_watches[clause.lits[1]].push_back(id);
+    }
+
+    void ProofBackend::add_clause(vec<Lit>& ps)
+    {
+        /* the solver is always at root level here */
+        assert(0 == decision_level());
+
+        std::vector<int> lits;
+        for (int i = 0; i < ps.size(); ++i) {
+            lits.push_back(Minisat::toInt(ps[i]));
+        }
+
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+
+        for (size_t i = 1; i < lits.size(); ++i) {
+            if (lits[i - 1] == (lits[i] ^ 1)) {
+                return; /* tautology */
+            }
+        }
+
+        for (int lit : lits) {
+            f_occurs[lit >> 1] |= PARTITION_A == f_partition ? OCCURS_A : OCCURS_B;
+        }
+
+        /* non-false literals first */
+        std::stable_partition(lits.begin(), lits.end(),
+                              [this](int lit) { return 0 != lit_value(lit); });
+
+        ClauseId id { new_clause(true, f_partition) };
+        f_clauses[id].lits = lits;
+
+        if (NO_CLAUSE != f_empty) {
+            return;
+        }
+
+        if (lits.empty() || 0 == lit_value(lits[0])) {
+            f_empty = derive_empty(id);
+            return;
+        }
+
+        /* satisfied at root level, forever */
+        if (1 == lit_value(lits[0]) ||
+            (1 < lits.size() && 1 == lit_value(lits[1]))) {
+            return;
+        }
+
+        if (1 == lits.size() || 0 == lit_value(lits[1])) {
+            enqueue(lits[0], id);
+
+            ClauseId conflict { propagate() };
+            derive_units();
+
+            if (NO_CLAUSE != conflict) {
+                f_empty = derive_empty(conflict);
+            }
+
+            return;
+        }
+
+        attach(id);
+    }
+
+    void ProofBackend::enqueue(int lit, ClauseId reason)
+    {
+        Var var { lit >> 1 };
+        assert(2 == f_assigns[var]);
+
+        f_assigns[var] = 1 ^ (lit & 1);
+        f_level[var] = decision_level();
+        f_reason[var] = reason;
+        f_trail.push_back(lit);
+    }
+
+    ProofBackend::ClauseId ProofBackend::propagate()
+    {
+        while (f_qhead < f_trail.size()) {
+            int false_lit { f_trail[f_qhead++] ^ 1 };
+            std::vector<ClauseId>& watches { f_watches[false_lit] };
+
+            ++f_propagations;
+
+            size_t i { 0 };
+            size_t j { 0 };
+            while (i < watches.size()) {
+                ClauseId id { watches[i++] };
+                Clause& clause { f_clauses[id] };
+
+                /* detached learnts are dropped lazily */
+                if (!clause.attached) {
+                    continue;
+                }
+
+                std::vector<int>& lits { clause.lits };
+                if (lits[0] == false_lit) {
+                    std::swap(lits[0], lits[1]);
+                }
+                assert(lits[1] == false_lit);
+
+                if (1 == lit_value(lits[0])) {
+                    watches[j++] = id;
+                    continue;
+                }
+
+                /* look for a new watch */
+                size_t k;
+                for (k = 2; k < lits.size() && 0 == lit_value(lits[k]); ++k)
+                    ;
+
+                if (k < lits.size()) {
+                    std::swap(lits[1], lits[k]);
+                    f_watches[lits[1]].push_back(id);
+                    continue;
+                }
+
+                watches[j++] = id;
+                if (0 == lit_value(lits[0])) {
+                    while (i < watches.size()) {
+                        watches[j++] = watches[i++];
+                    }
+                    watches.resize(j);
+
+                    f_qhead = f_trail.size();
+                    return id;
+                }
+
+                enqueue(lits[0], id);
+            }
+
+            watches.resize(j);
+        }
+
+        return NO_CLAUSE;
+    }
+
+    void ProofBackend::backtrack(unsigned level)
+    {
+        if (decision_level() <= level) {
+            return;
+        }
+
+        for (size_t i = f_trail.size(); f_trail_lim[level] < i; --i) {
+            int lit { f_trail[i - 1] };
+            Var var { lit >> 1 };
+
+            f_polarity[var] = lit & 1;
+            f_assigns[var] = 2;
+            f_reason[var] = NO_CLAUSE;
+            heap_insert(var);
+        }
+
+        f_trail.resize(f_trail_lim[level]);
+        f_trail_lim.resize(level);
+        f_qhead = f_trail.size();
+    }
+
+    void ProofBackend::derive_units()
+    {
+        assert(0 == decision_level());
+
+        for (; f_units_done < f_trail.size(); ++f_units_done) {
+            int lit { f_trail[f_units_done] };
+            Var var { lit >> 1 };
+
+            ClauseId reason { f_reason[var] };
+            assert(NO_CLAUSE != reason);
+
+            if (1 == f_clauses[reason].lits.size()) {
+                f_unit[var] = reason;
+                continue;
+            }
+
+            /* all the other literals of the reason are false, by
+               earlier root level units */
+            std::vector<Resolution> chain;
+            for (int other : f_clauses[reason].lits) {
+                if (other != lit) {
+                    chain.push_back(Resolution(other >> 1, f_unit[other >> 1]));
+                }
+            }
+
+            ClauseId id { new_clause(false, PARTITION_A) };
+            f_clauses[id].lits.push_back(lit);
+            f_clauses[id].start = reason;
+            f_clauses[id].chain.swap(chain);
+            f_resolutions += f_clauses[id].chain.size();
+
+            f_unit[var] = id;
+        }
+    }
+
+    ProofBackend::ClauseId ProofBackend::derive_empty(ClauseId cls)
+    {
+        std::vector<Resolution> chain;
+        for (int lit : f_clauses[cls].lits) {
+            assert(0 == lit_value(lit) && 0 == f_level[lit >> 1]);
+            chain.push_back(Resolution(lit >> 1, f_unit[lit >> 1]));
+        }
+
+        ClauseId id { new_clause(false, PARTITION_A) };
+        f_clauses[id].start = cls;
+        f_clauses[id].chain.swap(chain);
+        f_resolutions += f_clauses[id].chain.size();
+
+        return id;
+    }
+
+    ProofBackend::ClauseId ProofBackend::analyze(ClauseId conflict, unsigned& backtrack_level)
+    {
+        std::vector<int> learnt;
+        std::vector<Resolution> chain;
+        std::vector<Var> roots;
+
+        learnt.push_back(-1);
+
+        unsigned path { 0 };
+        int lit { -1 };
+        size_t index { f_trail.size() };
+        ClauseId reason { conflict };
+
+        do {
+            if (!f_clauses[reason].original) {
+                bump_clause(reason);
+            }
+
+            /* the first literal of a reason is the implied one */
+            const std::vector<int>& lits { f_clauses[reason].lits };
+            for (size_t k = (-1 == lit) ? 0 : 1; k < lits.size(); ++k) {
+                int q { lits[k] };
+                Var var { q >> 1 };
+
+                if (f_seen[var]) {
+                    continue;
+                }
+
+                if (0 == f_level[var]) {
+                    f_seen[var] = SEEN_ROOT;
+                    roots.push_back(var);
+                    continue;
+                }
+
+                f_seen[var] = SEEN;
+                bump_var(var);
+
+                if (f_level[var] >= decision_level()) {
+                    ++path;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+
+            /* next literal on the trail to resolve on */
+            while (SEEN != f_seen[f_trail[--index] >> 1])
+                ;
+
+            lit = f_trail[index];
+            reason = f_reason[lit >> 1];
+            f_seen[lit >> 1] = 0;
+            --path;
+
+            if (0 < path) {
+                chain.push_back(Resolution(lit >> 1, reason));
+            }
+        } while (0 < path);
+
+        learnt[0] = lit ^ 1;
+
+        /* basic minimization: literals implied by the other literals
+           of the clause are resolved away, latest first */
+        unsigned removed { 0 };
+        std::vector<bool> redundant(learnt.size(), false);
+        for (size_t i = 1; i < learnt.size(); ++i) {
+            ClauseId r { f_reason[learnt[i] >> 1] };
+            if (NO_CLAUSE == r) {
+                continue;
+            }
+
+            const std::vector<int>& lits { f_clauses[r].lits };
+            size_t k;
+            for (k = 1; k < lits.size(); ++k) {
+                Var var { lits[k] >> 1 };
+                if (!f_seen[var] && 0 < f_level[var]) {
+                    break;
+                }
+            }
+
+            if (k == lits.size()) {
+                redundant[i] = true;
+                ++removed;
+            }
+        }
+
+        if (0 < removed) {
+            std::vector<int> kept;
+            for (size_t i = 0; i < learnt.size(); ++i) {
+                if (!redundant[i]) {
+                    kept.push_back(learnt[i]);
+                } else {
+                    f_seen[learnt[i] >> 1] |= 4;
+                }
+            }
+
+            for (size_t i = f_trail.size(); 0 < removed; --i) {
+                Var var { f_trail[i - 1] >> 1 };
+                if (!(f_seen[var] & 4)) {
+                    continue;
+                }
+
+                ClauseId r { f_reason[var] };
+                chain.push_back(Resolution(var, r));
+
+                for (int q : f_clauses[r].lits) {
+                    Var other { q >> 1 };
+                    if (0 == f_level[other] && !f_seen[other]) {
+                        f_seen[other] = SEEN_ROOT;
+                        roots.push_back(other);
+                    }
+                }
+
+                f_seen[var] &= ~4;
+                --removed;
+            }
+
+            for (size_t i = 1; i < learnt.size(); ++i) {
+                f_seen[learnt[i] >> 1] = 0;
+            }
+
+            learnt.swap(kept);
+        } else {
+            for (size_t i = 1; i < learnt.size(); ++i) {
+                f_seen[learnt[i] >> 1] = 0;
+            }
+        }
+
+        /* root level literals go last */
+        for (Var var : roots) {
+            chain.push_back(Resolution(var, f_unit[var]));
+            f_seen[var] = 0;
+        }
+
+        /* the second watch is the literal with the highest level */
+        backtrack_level = 0;
+        for (size_t i = 1; i < learnt.size(); ++i) {
+            if (f_level[learnt[i] >> 1] > backtrack_level) {
+                backtrack_level = f_level[learnt[i] >> 1];
+                std::swap(learnt[1], learnt[i]);
+            }
+        }
+
+        ClauseId id { new_clause(false, PARTITION_A) };
+        Clause& clause { f_clauses[id] };
+
+        clause.lits.swap(learnt);
+        clause.start = conflict;
+        clause.chain.swap(chain);
+        f_resolutions += clause.chain.size();
+
+        return id;
+    }
+
+    ProofBackend::ClauseId ProofBackend::assumption_clause(int lit)
+    {
+        /* assumptions are unit clauses belonging to B */
+        ClauseId id { new_clause(true, PARTITION_B) };
+        f_clauses[id].lits.push_back(lit);
+
+        return id;
+    }
+
+    ProofBackend::ClauseId ProofBackend::analyze_final(int lit)
+    {
+        std::vector<Resolution> chain;
+        std::vector<Var> roots;
+        Var var { lit >> 1 };
+
+        f_failed.push_back(lit);
+        ClauseId start { assumption_clause(lit) };
+
+        if (0 == f_level[var]) {
+            roots.push_back(var);
+        } else {
+            f_seen[var] = SEEN;
+
+            for (size_t i = f_trail.size(); f_trail_lim[0] < i; --i) {
+                int q { f_trail[i - 1] };
+                Var x { q >> 1 };
+
+                if (SEEN != f_seen[x]) {
+                    continue;
+                }
+
+                ClauseId r { f_reason[x] };
+                if (NO_CLAUSE == r) {
+                    /* decisions are assumptions here */
+                    f_failed.push_back(q);
+                    chain.push_back(Resolution(x, assumption_clause(q)));
+                } else {
+                    chain.push_back(Resolution(x, r));
+
+                    const std::vector<int>& lits { f_clauses[r].lits };
+                    for (size_t k = 1; k < lits.size(); ++k) {
+                        Var other { lits[k] >> 1 };
+
+                        if (f_seen[other]) {
+                            continue;
+                        }
+
+                        if (0 == f_level[other]) {
+                            f_seen[other] = SEEN_ROOT;
+                            roots.push_back(other);
+                        } else {
+                            f_seen[other] = SEEN;
+                        }
+                    }
+                }
+
+                f_seen[x] = 0;
+            }
+        }
+
+        for (Var root : roots) {
+            chain.push_back(Resolution(root, f_unit[root]));
+            f_seen[root] = 0;
+        }
+
+        ClauseId id { new_clause(false, PARTITION_A) };
+        f_clauses[id].start = start;
+        f_clauses[id].chain.swap(chain);
+        f_resolutions += f_clauses[id].chain.size();
+
+        return id;
+    }
+
+    void ProofBackend::reduce_learnts()
+    {
+        std::sort(f_learnts.begin(), f_learnts.end(),
+                  [this](ClauseId x, ClauseId y) {
+                      return f_clauses[x].activity < f_clauses[y].activity;
+                  });
+
+        /* detached clauses keep their proofs, not their literals */
+        std::vector<ClauseId> kept;
+        size_t half { f_learnts.size() / 2 };
+        for (size_t i = 0; i < f_learnts.size(); ++i) {
+            ClauseId id { f_learnts[i] };
+            Clause& clause { f_clauses[id] };
+
+            int first { clause.lits[0] };
+            bool locked {
+                f_reason[first >> 1] == id && 1 == lit_value(first)
+            };
+
+            if (i < half && !locked && 2 < clause.lits.size()) {
+                clause.attached = false;
+                std::vector<int>().swap(clause.lits);
+            } else {
+                kept.push_back(id);
+            }
+        }
+
+        f_learnts.swap(kept);
+        f_max_learnts *= 1.1;
+    }
+
+    void ProofBackend::bump_var(Var var)
+    {
+        if (1e100 < (f_activity[var] += f_var_inc)) {
+            for (double& activity : f_activity) {
+                activity *= 1e-100;
+            }
+            f_var_inc *= 1e-100;
+        }
+
+        if (0 <= f_heap_index[var]) {
+            heap_up(f_heap_index[var]);
+        }
+    }
+
+    void ProofBackend::bump_clause(ClauseId id)
+    {
+        if (1e20 < (f_clauses[id].activity += f_clause_inc)) {
+            for (ClauseId learnt : f_learnts) {
+                f_clauses[learnt].activity *= 1e-20;
+            }
+            f_clause_inc *= 1e-20;
+        }
+    }
+
+    void ProofBackend::heap_insert(Var var)
+    {
+        if (0 <= f_heap_index[var]) {
+            return;
+        }
+
+        f_heap_index[var] = f_heap.size();
+        f_heap.push_back(var);
+        heap_up(f_heap.size() - 1);
+    }
+
+    void ProofBackend::heap_up(unsigned i)
+    {
+        Var var { f_heap[i] };
+
+        while (0 < i) {
+            unsigned parent { (i - 1) >> 1 };
+            if (f_activity[f_heap[parent]] >= f_activity[var]) {
+                break;
+            }
+
+            f_heap[i] = f_heap[parent];
+            f_heap_index[f_heap[i]] = i;
+            i = parent;
+        }
+
+        f_heap[i] = var;
+        f_heap_index[var] = i;
+    }
+
+    void ProofBackend::heap_down(unsigned i)
+    {
+        Var var { f_heap[i] };
+
+        while (2 * i + 1 < f_heap.size()) {
+            unsigned child { 2 * i + 1 };
+            if (child + 1 < f_heap.size() &&
+                f_activity[f_heap[child + 1]] > f_activity[f_heap[child]]) {
+                ++child;
+            }
+
+            if (f_activity[f_heap[child]] <= f_activity[var]) {
+                break;
+            }
+
+            f_heap[i] = f_heap[child];
+            f_heap_index[f_heap[i]] = i;
+            i = child;
+        }
+
+        f_heap[i] = var;
+        f_heap_index[var] = i;
+    }
+
+    Var ProofBackend::heap_pop()
+    {
+        Var res { f_heap[0] };
+
+        f_heap[0] = f_heap.back();
+        f_heap_index[f_heap[0]] = 0;
+        f_heap.pop_back();
+        f_heap_index[res] = -1;
+
+        if (!f_heap.empty()) {
+            heap_down(0);
+        }
+
+        return res;
+    }
+
+    Var ProofBackend::pick_branch_var()
+    {
+        while (!f_heap.empty()) {
+            Var var { heap_pop() };
+            if (2 == f_assigns[var]) {
+                return var;
+            }
+        }
+
+        return -1;
+    }
+
+    status_t ProofBackend::search(int64_t conflicts, const vec<Lit>& assumptions)
+    {
+        int64_t count { 0 };
+
+        while (true) {
+            ClauseId conflict { propagate() };
+            if (0 == decision_level()) {
+                derive_units();
+            }
+
+            if (NO_CLAUSE != conflict) {
+                ++f_conflicts;
+                ++count;
+
+                if (0 == decision_level()) {
+                    f_empty = derive_empty(conflict);
+                    f_refutation = f_empty;
+                    return STATUS_UNSAT;
+                }
+
+                unsigned level;
+                ClauseId id { analyze(conflict, level) };
+                backtrack(level);
+
+                int asserting { f_clauses[id].lits[0] };
+                if (1 < f_clauses[id].lits.size()) {
+                    attach(id);
+                    f_learnts.push_back(id);
+                    bump_clause(id);
+                }
+                enqueue(asserting, id);
+
+                f_var_inc /= VAR_DECAY;
+                f_clause_inc /= CLAUSE_DECAY;
+                continue;
+            }
+
+            bool within_budget {
+                !f_interrupted &&
+                (f_conf_budget < 0 || static_cast<int64_t>(f_conflicts) < f_conf_budget) &&
+                (f_prop_budget < 0 || static_cast<int64_t>(f_propagations) < f_prop_budget)
+            };
+
+            if (conflicts <= count || !within_budget) {
+                backtrack(0);
+                return STATUS_UNKNOWN;
+            }
+
+            if (f_max_learnts <= f_learnts.size()) {
+                reduce_learnts();
+            }
+
+            int next { -1 };
+            while (decision_level() < static_cast<unsigned>(assumptions.size())) {
+                int p { Minisat::toInt(assumptions[decision_level()]) };
+                int val { lit_value(p) };
+
+                if (1 == val) {
+                    /* dummy decision level */
+                    f_trail_lim.push_back(f_trail.size());
+                } else if (0 == val) {
+                    f_refutation = analyze_final(p);
+                    return STATUS_UNSAT;
+                } else {
+                    next = p;
+                    break;
+                }
+            }
+
+            if (-1 == next) {
+                Var var { pick_branch_var() };
+                if (-1 == var) {
+                    return STATUS_SAT;
+                }
+
+                ++f_decisions;
+                next = 2 * var + f_polarity[var];
+            }
+
+            f_trail_lim.push_back(f_trail.size());
+            enqueue(next, NO_CLAUSE);
+        }
+    }
+
+    status_t ProofBackend::solve(const vec<Lit>& assumptions)
+    {
+        ++f_solves;
+
+        f_assumptions.clear();
+        for (int i = 0; i < assumptions.size(); ++i) {
+            f_assumptions.push_back(Minisat::toInt(assumptions[i]));
+        }
+        f_failed.clear();
+        f_model.clear();
+        f_refutation = NO_CLAUSE;
+
+        if (NO_CLAUSE != f_empty) {
+            f_refutation = f_empty;
+            return STATUS_UNSAT;
+        }
+
+        f_max_learnts = std::max(f_max_learnts, f_clauses.size() / 3.0);
+
+        status_t res { STATUS_UNKNOWN };
+        for (int restarts = 0; STATUS_UNKNOWN == res; ++restarts) {
+            res = search(luby(2, restarts) * RESTART_FIRST, assumptions);
+
+            /* search() restarts at root level only when out of budget */
+            if (STATUS_UNKNOWN == res &&
+                (f_interrupted ||
+                 (0 <= f_conf_budget && f_conf_budget <= static_cast<int64_t>(f_conflicts)) ||
+                 (0 <= f_prop_budget && f_prop_budget <= static_cast<int64_t>(f_propagations)))) {
+                break;
+            }
+        }
+
+        if (STATUS_SAT == res) {
+            f_model = f_assigns;
+        }
+
+        backtrack(0);
+        return res;
+    }
+
+    bool ProofBackend::failed(Lit assumption)
+    {
+        return f_failed.end() !=
+               std::find(f_failed.begin(), f_failed.end(), Minisat::toInt(assumption));
+    }
+
+    int ProofBackend::value(Var var)
+    {
+        return 1 == f_model[var];
+    }
+
+    void ProofBackend::interrupt()
+    {
+        f_interrupted = true;
+    }
+
+    void ProofBackend::clear_interrupt()
+    {
+        f_interrupted = false;
+    }
+
+    void ProofBackend::tune(const SolverConfig& config)
+    {
+        /* default heuristics only */
+    }
+
+    void ProofBackend::set_phase(Var var, bool value)
+    {
+        /* the saved phase, until the var is assigned again */
+        f_polarity[var] = value ? 0 : 1;
+    }
+
+    void ProofBackend::set_priority(Var var, double priority)
+    {
+        /* an initial activity, as for the Minisat backends */
+        f_activity[var] = std::max(f_activity[var], priority * f_var_inc);
+        if (0 <= f_heap_index[var]) {
+            heap_up(f_heap_index[var]);
+        }
+    }
+
+    void ProofBackend::export_learnts(unsigned max_size, LitsVector& out)
+    {
+        /* learnts are not shared */
+    }
+
+    void ProofBackend::configure(int64_t conf_budget, int64_t prop_budget)
+    {
+        f_conf_budget = conf_budget < 0 ? -1 : f_conflicts + conf_budget;
+        f_prop_budget = prop_budget < 0 ? -1 : f_propagations + prop_budget;
+    }
+
+    bool ProofBackend::interpolant(const std::vector<int>& leaves, Interpolant& res)
+    {
+        assert(NO_CLAUSE != f_refutation);
+
+        /* values of the assumptions: 0 false, 1 true, 2 none */
+        std::vector<int8_t> assumed(f_assigns.size(), 2);
+        for (int lit : f_assumptions) {
+            assumed[lit >> 1] = 1 ^ (lit & 1);
+        }
+
+        std::vector<Interpolant::Node> nodes(f_clauses.size(), NO_NODE);
+        std::vector<ClauseId> stack;
+
+        stack.push_back(f_refutation);
+        while (!stack.empty()) {
+            ClauseId id { stack.back() };
+            const Clause& clause { f_clauses[id] };
+
+            if (NO_NODE != nodes[id]) {
+                stack.pop_back();
+                continue;
+            }
+
+            /* leaves: B clauses are TRUE, A clauses are the
+               disjunction of their shared literals */
+            if (clause.original) {
+                Interpolant::Node node { Interpolant::TRUE_NODE };
+
+                if (PARTITION_A == clause.partition) {
+                    node = Interpolant::FALSE_NODE;
+
+                    for (int lit : clause.lits) {
+                        Var var { lit >> 1 };
+
+                        if (2 != assumed[var]) {
+                            node = res.make_or(node, res.make_const(1 == (assumed[var] ^ (lit & 1))));
+                        } else if (f_occurs[var] & OCCURS_B) {
+                            if (static_cast<size_t>(var) >= leaves.size() || leaves[var] < 0) {
+                                return false;
+                            }
+
+                            node = res.make_or(node, res.make_leaf(mkLit(leaves[var], lit & 1)));
+                        }
+                    }
+                }
+
+                nodes[id] = node;
+                stack.pop_back();
+                continue;
+            }
+
+            /* derived clauses, once their antecedents are done */
+            bool ready { NO_NODE != nodes[clause.start] };
+            if (!ready) {
+                stack.push_back(clause.start);
+            }
+
+            for (const auto& resolution : clause.chain) {
+                if (NO_NODE == nodes[resolution.second]) {
+                    stack.push_back(resolution.second);
+                    ready = false;
+                }
+            }
+
+            if (!ready) {
+                continue;
+            }
+
+            Interpolant::Node node { nodes[clause.start] };
+            for (const auto& resolution : clause.chain) {
+                Var pivot { resolution.first };
+                Interpolant::Node other { nodes[resolution.second] };
+
+                /* A-local pivots yield disjunctions, all the others
+                   conjunctions */
+                if (OCCURS_A == f_occurs[pivot] && 2 == assumed[pivot]) {
+                    node = res.make_or(node, other);
+                } else {
+                    node = res.make_and(node, other);
+                }
+            }
+
+            nodes[id] = node;
+            stack.pop_back();
+        }
+
+        res.set_root(nodes[f_refutation]);
+        return true;
+    }
+
+    void ProofBackend::print_stats(std::ostream& os) const
+    {
+        os
+            << "solves: "
+            << f_solves
+
+            << ", decs: "
+            << f_decisions
+
+            << ", props: "
+            << f_propagations
+
+            << ", conflicts: "
+            << f_conflicts
+
+            << ", clauses: "
+            << f_clauses.size()
+
+            << ", resolutions: "
+            << f_resolutions;
+    }
+
+    void ProofBackend::counters(SolverCounters& counters) const
+    {
+        counters.vars = f_assigns.size();
+        counters.clauses = f_clauses.size() - f_learnts.size();
+        counters.learnts = f_learnts.size();
+        counters.conflicts = f_conflicts;
+        counters.propagations = f_propagations;
+        counters.decisions = f_decisions;
+        counters.eliminated = 0;
+
+        /* resolution chains take most of it */
+        uint64_t memory { f_clauses.capacity() * sizeof(Clause) };
+        for (const auto& clause : f_clauses) {
+            memory += clause.lits.capacity() * sizeof(int) +
+                      clause.chain.capacity() * sizeof(Resolution);
+        }
+        for (const auto& watches : f_watches) {
+            memory += watches.capacity() * sizeof(ClauseId);
+        }
+        counters.memory = memory;
+    }
+
+}; // namespace sat
@@ -0,0 +1,224 @@
+/**
+ * @file sat/proof.hh
+ * @brief SAT interface, proof-logging solver backend declarations.
+ *
+ * This module contains the declaration of a small CDCL solver
+ * backend which logs the resolution proof of each clause it learns.
+ * Clauses are labeled as they are added, as belonging to either the
+ * A or B partition of the problem. After an UNSAT result, a Craig
+ * interpolant of A and B is extracted from the refutation, using
+ * McMillan's construction: the interpolant is implied by A, is
+ * inconsistent with B, and only refers to vars occurring in both.
+ *
+ * The backend is nowhere as fast as Minisat and keeps the whole
+ * proof in memory, it is only meant for interpolation-based
+ * algorithms (see algorithms/reach/interpolation.cc).
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_PROOF_H
+#define SAT_PROOF_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include <sat/backend.hh>
+#include <sat/interpolant.hh>
+
+namespace sat {
+
+    typedef enum {
+        PARTITION_A,
+        PARTITION_B,
+    } partition_t;
+
+    class ProofBackend: public SolverBackend {
+    public:
+        ProofBackend();
+        ~ProofBackend();
+
+        /* clauses added from now on belong to partition */
+        inline void set_partition(partition_t partition)
+        {
+            f_partition = partition;
+        }
+
+        /* Interpolant of the last UNSAT result. Shared vars are
+         * translated into leaves by `leaves` (-1 for vars that are
+         * not expected to be shared), assumptions are replaced by
+         * their value. Returns false iff an unexpected shared var is
+         * found. */
+        bool interpolant(const std::vector<int>& leaves, Interpolant& res);
+
+        // -- SolverBackend ----------------------------------------------------
+        const char* name() const;
+
+        Var new_var(bool frozen);
+        void freeze(Var var, bool frozen);
+        void add_clause(vec<Lit>& ps);
+
+        unsigned eliminate();
+        bool is_eliminated(Var var) const;
+
+        void simplify();
+        void limit_memory(uint64_t max_bytes);
+
+        status_t solve(const vec<Lit>& assumptions);
+        bool failed(Lit assumption);
+        int value(Var var);
+        void interrupt();
+        void clear_interrupt();
+
+        void tune(const SolverConfig& config);
+        void set_phase(Var var, bool value);
+        void set_priority(Var var, double priority);
+        void export_learnts(unsigned max_size, LitsVector& out);
+        void configure(int64_t conf_budget, int64_t prop_budget);
+
+        void print_stats(std::ostream& os) const;
+        void counters(SolverCounters& counters) const;
+
+    private:
+        typedef uint32_t ClauseId;
+        static const ClauseId NO_CLAUSE = ~0U;
+
+        /* binary resolution on a pivot var, with an antecedent */
+        typedef std::pair<Var, ClauseId> Resolution;
+
+        /* Original clauses are leaves of the proof. Every other clause
+         * is derived by a chain of resolutions, starting from a
+         * clause. Literals use the Minisat integer encoding, derived
+         * clauses that are not attached need not keep them. */
+        struct Clause {
+            std::vector<int> lits;
+
+            bool original;
+            bool attached;
+            partition_t partition;
+
+            double activity;
+
+            ClauseId start;
+            std::vector<Resolution> chain;
+        };
+
+        /* values: 0 false, 1 true, 2 unassigned */
+        inline int lit_value(int lit) const
+        {
+            int val { f_assigns[lit >> 1] };
+            return 2 == val ? 2 : val ^ (lit & 1);
+        }
+
+        inline unsigned decision_level() const
+        {
+            return static_cast<unsigned>(f_trail_lim.size());
+        }
+
+        ClauseId new_clause(bool original, partition_t partition);
+        void attach(ClauseId id);
+
+        void enqueue(int lit, ClauseId reason);
+        ClauseId propagate();
+        void backtrack(unsigned level);
+
+        /* proofs of root level units, in trail order */
+        void derive_units();
+
+        /* a derived clause that resolves away all assigned vars in
+           `cls` (which are false at root level) */
+        ClauseId derive_empty(ClauseId cls);
+
+        /* first UIP learning, res[0] is the asserting literal */
+        ClauseId analyze(ClauseId conflict, unsigned& backtrack_level);
+
+        /* refutation using the false assumption `lit`, collects
+           failed assumptions */
+        ClauseId analyze_final(int lit);
+        ClauseId assumption_clause(int lit);
+
+        void reduce_learnts();
+
+        /* VSIDS */
+        void bump_var(Var var);
+        void bump_clause(ClauseId id);
+        void heap_insert(Var var);
+        void heap_up(unsigned i);
+        void heap_down(unsigned i);
+        Var heap_pop();
+
+        Var pick_branch_var();
+
+        status_t search(int64_t conflicts, const vec<Lit>& assumptions);
+
+        /* clauses, learnts among them */
+        std::vector<Clause> f_clauses;
+        std::vector<ClauseId> f_learnts;
+        double f_max_learnts;
+
+        /* watches[lit] holds the clauses `lit` is watched in */
+        std::vector<std::vector<ClauseId>> f_watches;
+
+        /* per-var data */
+        std::vector<int8_t> f_assigns;
+        std::vector<int8_t> f_polarity;
+        std::vector<int8_t> f_model;
+        std::vector<unsigned> f_level;
+        std::vector<ClauseId> f_reason;
+        std::vector<ClauseId> f_unit;
+        std::vector<uint8_t> f_occurs; /* 1: A, 2: B */
+        std::vector<uint8_t> f_seen;
+        std::vector<double> f_activity;
+
+        std::vector<Var> f_heap;
+        std::vector<int> f_heap_index;
+        double f_var_inc;
+        double f_clause_inc;
+
+        std::vector<int> f_trail;
+        std::vector<unsigned> f_trail_lim;
+        unsigned f_qhead;
+        unsigned f_units_done;
+
+        /* refutation of the original clauses (if any), and of the
+           last UNSAT result */
+        ClauseId f_empty;
+        ClauseId f_refutation;
+
+        /* assumptions of the last solve(), and the failed ones */
+        std::vector<int> f_assumptions;
+        std::vector<int> f_failed;
+
+        partition_t f_partition;
+
+        volatile bool f_interrupted;
+        int64_t f_conf_budget;
+        int64_t f_prop_budget;
+
+        uint64_t f_solves;
+        uint64_t f_conflicts;
+        uint64_t f_decisions;
+        uint64_t f_propagations;
+        uint64_t f_resolutions;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_PROOF_H */
@@ -0,0 +1,366 @@
+/**
+ * @file sat/remote.cc
+ * @brief SAT interface, remote solving implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <sat/remote.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <utils/logging.hh>
+
+#include <jsoncpp/json/json.h>
+
+namespace sat {
+
+    static std::string to_line(const Json::Value& value)
+    {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+
+        return Json::writeString(builder, value) + "\n";
+    }
+
+    static inline Lit dimacs_lit(int lit)
+    {
+        return mkLit(abs(lit) - 1, lit < 0);
+    }
+
+    CnfSession::CnfSession()
+        : f_backend(NULL)
+        , f_n_vars(0)
+    {}
+
+    CnfSession::~CnfSession()
+    {
+        delete f_backend;
+    }
+
+    bool CnfSession::select_backend(const std::string& name)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        if (f_backend) {
+            return true;
+        }
+
+        const std::string backend {
+            name.empty() ? opts::OptsMgr::INSTANCE().sat_backend() : name
+        };
+        if (!is_solver_backend(backend)) {
+            return false;
+        }
+
+        f_backend = make_solver_backend(backend);
+        return true;
+    }
+
+    void CnfSession::touch(int lit)
+    {
+        /* vars are never eliminated, all of them may be in the model */
+        while (f_n_vars < abs(lit)) {
+            f_backend->new_var(true);
+            ++f_n_vars;
+        }
+    }
+
+    void CnfSession::add_clauses(const std::vector<int>& clauses)
+    {
+        assert(f_backend);
+
+        vec<Lit> ps;
+        for (int lit : clauses) {
+            if (lit) {
+                touch(lit);
+                ps.push(dimacs_lit(lit));
+                continue;
+            }
+
+            f_backend->add_clause(ps);
+            ps.clear();
+        }
+    }
+
+    status_t CnfSession::solve(const std::vector<int>& assumptions, std::vector<int>& model)
+    {
+        assert(f_backend);
+
+        vec<Lit> ps;
+        for (int lit : assumptions) {
+            touch(lit);
+            ps.push(dimacs_lit(lit));
+        }
+
+        status_t status { f_backend->solve(ps) };
+
+        model.clear();
+        if (STATUS_SAT == status) {
+            for (Var var = 0; var < f_n_vars; ++var) {
+                model.push_back(f_backend->value(var) ? 1 + var : -(1 + var));
+            }
+        }
+
+        return status;
+    }
+
+    void CnfSession::interrupt()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        if (f_backend) {
+            f_backend->interrupt();
+        }
+    }
+
+    void CnfSession::clear_interrupt()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        if (f_backend) {
+            f_backend->clear_interrupt();
+        }
+    }
+
+    RemoteSolver::RemoteSolver(const std::string& endpoint)
+        : f_endpoint(endpoint)
+        , f_fd(-1)
+        , f_lost(false)
+        , f_next_id(0)
+        , f_pending(0)
+    {}
+
+    RemoteSolver::~RemoteSolver()
+    {
+        if (0 <= f_fd) {
+            close(f_fd);
+        }
+    }
+
+    bool RemoteSolver::connect()
+    {
+        std::string host { "localhost" };
+        std::string port { f_endpoint };
+
+        std::string::size_type colon { f_endpoint.rfind(':') };
+        if (std::string::npos != colon) {
+            host = f_endpoint.substr(0, colon);
+            port = f_endpoint.substr(1 + colon);
+        }
+
+        bool is_port { !port.empty() &&
+                       std::string::npos == port.find_first_not_of("0123456789") };
+
+        if (!is_port) {
+            struct sockaddr_un addr;
+            if (sizeof(addr.sun_path) <= f_endpoint.size()) {
+                return false;
+            }
+
+            f_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (f_fd < 0) {
+                return false;
+            }
+
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, f_endpoint.c_str(), sizeof(addr.sun_path) - 1);
+
+            return 0 == ::connect(f_fd, (struct sockaddr*) &addr, sizeof(addr));
+        }
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* res { NULL };
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res)) {
+            return false;
+        }
+
+        for (struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+            f_fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (f_fd < 0) {
+                continue;
+            }
+
+            if (0 == ::connect(f_fd, ai->ai_addr, ai->ai_addrlen)) {
+                break;
+            }
+
+            close(f_fd);
+            f_fd = -1;
+        }
+        freeaddrinfo(res);
+
+        return 0 <= f_fd;
+    }
+
+    bool RemoteSolver::send_line(const std::string& line)
+    {
+        const char* p { line.data() };
+        size_t left { line.size() };
+        while (0 < left) {
+            ssize_t n { send(f_fd, p, left, MSG_NOSIGNAL) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+
+            p += n;
+            left -= n;
+        }
+
+        return true;
+    }
+
+    bool RemoteSolver::recv_line(std::string& line)
+    {
+        char chunk[0x1000];
+
+        std::string::size_type eol;
+        while (std::string::npos == (eol = f_buffer.find('\n'))) {
+            ssize_t n { recv(f_fd, chunk, sizeof(chunk), 0) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+
+            f_buffer.append(chunk, n);
+        }
+
+        line = f_buffer.substr(0, eol);
+        f_buffer.erase(0, 1 + eol);
+
+        return true;
+    }
+
+    status_t RemoteSolver::solve(const std::vector<int>& clauses,
+                                 const std::vector<int>& assumptions,
+                                 std::vector<int>& model)
+    {
+        Json::Value request;
+        request["jsonrpc"] = "2.0";
+        request["method"] = "solve-cnf";
+        request["params"]["backend"] = opts::OptsMgr::INSTANCE().sat_backend();
+
+        Json::Value& lits { request["params"]["clauses"] = Json::Value(Json::arrayValue) };
+        for (int lit : clauses) {
+            lits.append(lit);
+        }
+        Json::Value& query { request["params"]["assumptions"] = Json::Value(Json::arrayValue) };
+        for (int lit : assumptions) {
+            query.append(lit);
+        }
+
+        unsigned id;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            id = f_pending = ++f_next_id;
+            request["id"] = id;
+
+            f_lost = !send_line(to_line(request));
+        }
+
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader { builder.newCharReader() };
+
+        status_t status { STATUS_UNKNOWN };
+        std::string line;
+        while (!f_lost) {
+            if (!recv_line(line)) {
+                f_lost = true;
+                break;
+            }
+
+            Json::Value response;
+            std::string errors;
+            if (!reader->parse(line.data(), line.data() + line.size(), &response, &errors)) {
+                f_lost = true;
+                break;
+            }
+
+            /* responses to cancel requests are skipped */
+            if (!response["id"].isUInt() || id != response["id"].asUInt()) {
+                continue;
+            }
+
+            if (response.isMember("error")) {
+                const std::string message { response["error"]["message"].asString() };
+                WARN
+                    << "Worker `"
+                    << f_endpoint
+                    << "` failed: "
+                    << message
+                    << std::endl;
+
+                f_lost = true;
+                break;
+            }
+
+            const Json::Value& result { response["result"] };
+            const std::string name { result["status"].asString() };
+
+            model.clear();
+            if (name == "SAT") {
+                status = STATUS_SAT;
+                for (const auto& lit : result["model"]) {
+                    model.push_back(lit.asInt());
+                }
+            } else if (name == "UNSAT") {
+                status = STATUS_UNSAT;
+            }
+            break;
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_pending = 0;
+
+        return status;
+    }
+
+    void RemoteSolver::interrupt()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        if (!f_pending || f_lost) {
+            return;
+        }
+
+        Json::Value request;
+        request["jsonrpc"] = "2.0";
+        request["id"] = ++f_next_id;
+        request["method"] = "cancel";
+        request["params"]["id"] = f_pending;
+
+        send_line(to_line(request));
+    }
+
+}; // namespace sat
@@ -0,0 +1,143 @@
+/**
+ * @file sat/remote.hh
+ * @brief SAT interface, remote solving declarations.
+ *
+ * This module contains the declarations of the two ends of remote
+ * solving. Queries are plain CNF, i.e. DIMACS literals: a coordinator
+ * sends the clauses of its instance (only those added since its last
+ * query) and the assumptions of a query to a worker, a yasmv process
+ * in server mode (see cmd/server.hh), and gets back the status and
+ * the model, if any. The coordinator maps the model back onto its own
+ * instance via the TCBI <-> var mapping, so that witnesses are built
+ * as if solved locally.
+ *
+ * Requests are JSON-RPC `solve-cnf` calls, whose params are:
+ *
+ *   {"clauses": [ 1, -2, 0, ... ], "assumptions": [ 3, -4 ], "backend": "minisat"}
+ *
+ * clauses are zero-terminated, and added to the instance of the
+ * connection, which is kept across calls. The result is:
+ *
+ *   {"status": "SAT", "model": [ 1, -2, -3, 4, ... ]}
+ *
+ * A `cancel` call with the id of the pending query interrupts it.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_REMOTE_H
+#define SAT_REMOTE_H
+
+#include <string>
+#include <vector>
+
+#include <sat/backend.hh>
+#include <sat/typedefs.hh>
+
+#include <boost/thread/mutex.hpp>
+
+namespace sat {
+
+    /* Worker end: the CNF instance of a connection */
+    class CnfSession {
+    public:
+        CnfSession();
+        ~CnfSession();
+
+        /* the backend is selected by the first query, false if unknown */
+        bool select_backend(const std::string& name);
+
+        /* zero terminated DIMACS clauses */
+        void add_clauses(const std::vector<int>& clauses);
+
+        /* model holds a DIMACS literal for each var if SAT */
+        status_t solve(const std::vector<int>& assumptions, std::vector<int>& model);
+
+        /* safe to call from other threads. Interruptions are sticky,
+           until cleared */
+        void interrupt();
+        void clear_interrupt();
+
+    private:
+        /* non-copyable */
+        CnfSession(const CnfSession&);
+        CnfSession& operator=(const CnfSession&);
+
+        void touch(int lit);
+
+        boost::mutex f_mutex;
+        SolverBackend_ptr f_backend;
+        Var f_n_vars;
+    };
+
+    /* Coordinator end: a connection to a worker, used by one thread at
+     * a time except for interrupt() */
+    class RemoteSolver {
+    public:
+        /* endpoint is either `host:port`, a port on localhost, or the
+           path of a Unix socket */
+        RemoteSolver(const std::string& endpoint);
+        ~RemoteSolver();
+
+        /* false iff the worker could not be reached */
+        bool connect();
+
+        /* clauses are appended to the worker's instance. Returns
+           STATUS_UNKNOWN if interrupted, or if the connection is lost
+           (see lost()) */
+        status_t solve(const std::vector<int>& clauses,
+                       const std::vector<int>& assumptions,
+                       std::vector<int>& model);
+
+        /* interrupts the pending query (if any) */
+        void interrupt();
+
+        inline bool lost() const
+        {
+            return f_lost;
+        }
+
+        inline const std::string& endpoint() const
+        {
+            return f_endpoint;
+        }
+
+    private:
+        /* non-copyable */
+        RemoteSolver(const RemoteSolver&);
+        RemoteSolver& operator=(const RemoteSolver&);
+
+        bool send_line(const std::string& line);
+        bool recv_line(std::string& line);
+
+        std::string f_endpoint;
+        int f_fd;
+        bool f_lost;
+
+        /* request ids, and the pending one (0 = none) */
+        unsigned f_next_id;
+        unsigned f_pending;
+
+        std::string f_buffer;
+        boost::mutex f_mutex;
+    };
+
+}; // namespace sat
+
+#endif /* SAT_REMOTE_H */
@@ -43,6 +43,9 @@
 /* Engine Mgr class */
 #include <sat/engine_mgr.hh>
 
+/* Resource limits */
+#include <sat/watchdog.hh>
+
 namespace sat {
 };
 
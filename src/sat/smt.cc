@@ -0,0 +1,373 @@
+/**
+ * @file sat/smt.cc
+ * @brief SAT interface, word-level SMT solvers implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <sat/smt.hh>
+
+#include <utils/logging.hh>
+
+namespace sat {
+
+    /* how long to wait for the solver before polling the stop
+       predicate, in ms */
+    static const int smt_poll_interval { 100 };
+
+    SmtSolver::SmtSolver(const std::string& command)
+        : f_command(command)
+        , f_pid(-1)
+        , f_fd(-1)
+        , f_lost(false)
+    {}
+
+    SmtSolver::~SmtSolver()
+    {
+        if (0 <= f_fd) {
+            command("(exit)");
+            close(f_fd);
+        }
+
+        if (0 < f_pid) {
+            int status;
+            waitpid(f_pid, &status, 0);
+        }
+    }
+
+    bool SmtSolver::start()
+    {
+        /* a socket pair rather than pipes, writes to a dead solver
+           fail instead of raising SIGPIPE */
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+            return false;
+        }
+
+        f_pid = fork();
+        if (f_pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+
+        if (0 == f_pid) {
+            close(fds[0]);
+            dup2(fds[1], STDIN_FILENO);
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[1]);
+
+            execl("/bin/sh", "sh", "-c", f_command.c_str(), (char*) NULL);
+            _exit(127);
+        }
+
+        close(fds[1]);
+        f_fd = fds[0];
+
+        /* errors are reported as responses, success is silent */
+        return command("(set-option :print-success false)") &&
+               command("(set-option :produce-models true)") &&
+               command("(set-logic QF_BV)");
+    }
+
+    bool SmtSolver::command(const std::string& text)
+    {
+        if (f_lost) {
+            return false;
+        }
+
+        const std::string line { text + "\n" };
+        const char* p { line.data() };
+        size_t left { line.size() };
+        while (0 < left) {
+            ssize_t n { send(f_fd, p, left, MSG_NOSIGNAL) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                f_lost = true;
+                return false;
+            }
+
+            p += n;
+            left -= n;
+        }
+
+        return true;
+    }
+
+    status_t SmtSolver::check()
+    {
+        std::string response;
+        if (!command("(check-sat)") || !recv_response(response)) {
+            return STATUS_UNKNOWN;
+        }
+
+        if ("sat" == response) {
+            return STATUS_SAT;
+        }
+        if ("unsat" == response) {
+            return STATUS_UNSAT;
+        }
+
+        if ("unknown" != response) {
+            WARN
+                << "Unexpected response from SMT solver `"
+                << f_command
+                << "`: "
+                << response
+                << std::endl;
+        }
+
+        return STATUS_UNKNOWN;
+    }
+
+    bool SmtSolver::values(const std::vector<std::string>& terms,
+                           std::vector<std::string>& res)
+    {
+        res.clear();
+        if (terms.empty()) {
+            return true;
+        }
+
+        std::string text { "(get-value (" };
+        for (const auto& term : terms) {
+            text += " " + term;
+        }
+        text += "))";
+
+        std::string response;
+        if (!command(text) || !recv_response(response)) {
+            return false;
+        }
+
+        /* ((term value) (term value) ...), the second item of each
+           pair is taken as it is */
+        unsigned depth { 0 };
+        unsigned item { 0 };
+        std::string::size_type begin { 0 };
+        for (std::string::size_type i = 0; i < response.size(); ++i) {
+            char c { response[i] };
+
+            if ('|' == c) {
+                std::string::size_type close { response.find('|', 1 + i) };
+                if (std::string::npos == close) {
+                    return false;
+                }
+                if (2 == depth && 0 == item++) {
+                    begin = i;
+                }
+                i = close;
+                continue;
+            }
+
+            if ('(' == c) {
+                if (2 == depth) {
+                    if (1 == item) {
+                        begin = i;
+                    }
+                    ++item;
+                }
+                if (1 == depth) {
+                    item = 0;
+                }
+                ++depth;
+            }
+
+            else if (')' == c) {
+                if (0 == depth) {
+                    return false;
+                }
+                --depth;
+
+                /* a value list is closed */
+                if (2 == depth && 2 == item && res.size() < terms.size() &&
+                    '(' == response[begin]) {
+                    res.push_back(response.substr(begin, 1 + i - begin));
+                    item = 3;
+                }
+            }
+
+            else if (!isspace(c) && 2 == depth) {
+                std::string::size_type end { i };
+                while (end < response.size() && !isspace(response[end]) &&
+                       ')' != response[end] && '(' != response[end]) {
+                    ++end;
+                }
+
+                if (1 == item) {
+                    res.push_back(response.substr(i, end - i));
+                }
+                ++item;
+                i = end - 1;
+            }
+        }
+
+        return res.size() == terms.size();
+    }
+
+    bool SmtSolver::recv_response(std::string& response)
+    {
+        char chunk[0x1000];
+
+        while (!f_lost) {
+            /* a response is complete once its parens are balanced */
+            unsigned depth { 0 };
+            bool quoted { false };
+            bool open { false };
+            std::string::size_type end { std::string::npos };
+
+            for (std::string::size_type i = 0; i < f_buffer.size(); ++i) {
+                char c { f_buffer[i] };
+
+                if ('|' == c) {
+                    quoted = !quoted;
+                }
+                if (quoted) {
+                    continue;
+                }
+
+                if ('(' == c) {
+                    ++depth;
+                    open = true;
+                } else if (')' == c && 0 < depth) {
+                    --depth;
+                    if (0 == depth) {
+                        end = 1 + i;
+                        break;
+                    }
+                } else if ('\n' == c && !open) {
+                    /* an atom (e.g. `sat`) */
+                    if (0 < i) {
+                        end = i;
+                        break;
+                    }
+                }
+            }
+
+            if (std::string::npos != end) {
+                response = f_buffer.substr(0, end);
+                f_buffer.erase(0, end);
+
+                /* leading and trailing blanks */
+                std::string::size_type first { response.find_first_not_of(" \t\r\n") };
+                std::string::size_type last { response.find_last_not_of(" \t\r\n") };
+                response = std::string::npos == first
+                               ? std::string()
+                               : response.substr(first, 1 + last - first);
+
+                if (response.empty()) {
+                    continue;
+                }
+
+                if (0 == response.compare(0, 6, "(error")) {
+                    WARN
+                        << "SMT solver `"
+                        << f_command
+                        << "` reported "
+                        << response
+                        << std::endl;
+
+                    f_lost = true;
+                    return false;
+                }
+
+                return true;
+            }
+
+            struct pollfd pfd { f_fd, POLLIN, 0 };
+            int ready { poll(&pfd, 1, smt_poll_interval) };
+            if (ready < 0 && EINTR == errno) {
+                continue;
+            }
+
+            if (0 == ready) {
+                if (f_stop && f_stop()) {
+                    kill_solver();
+                    return false;
+                }
+
+                continue;
+            }
+
+            ssize_t n { recv(f_fd, chunk, sizeof(chunk), 0) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            if (n <= 0) {
+                f_lost = true;
+                break;
+            }
+
+            f_buffer.append(chunk, n);
+        }
+
+        return false;
+    }
+
+    void SmtSolver::kill_solver()
+    {
+        if (0 < f_pid) {
+            kill(f_pid, SIGKILL);
+        }
+
+        f_lost = true;
+    }
+
+    bool parse_smt_value(const std::string& value, unsigned long& res)
+    {
+        res = 0;
+
+        if ("true" == value || "false" == value) {
+            res = "true" == value ? 1 : 0;
+            return true;
+        }
+
+        if (2 < value.size() && '#' == value[0]) {
+            int base { 'b' == value[1] ? 2 : 'x' == value[1] ? 0x10 : 0 };
+            if (0 == base) {
+                return false;
+            }
+
+            char* end;
+            res = strtoul(value.c_str() + 2, &end, base);
+            return '\0' == *end;
+        }
+
+        /* (_ bvN w) */
+        if (0 == value.compare(0, 5, "(_ bv")) {
+            char* end;
+            res = strtoul(value.c_str() + 5, &end, 10);
+            return ' ' == *end;
+        }
+
+        return false;
+    }
+
+}; // namespace sat
@@ -0,0 +1,111 @@
+/**
+ * @file sat/smt.hh
+ * @brief SAT interface, word-level SMT solvers declarations.
+ *
+ * This module contains the declarations of the SMT solvers interface,
+ * the alternative to bit-blasting for word-level models. Any SMT-LIB2
+ * solver supporting QF_BV and incremental solving (e.g. `z3 -in`,
+ * `bitwuzla`, `boolector --smt2 -i`) is run as a child process, whose
+ * standard input and output are connected to this end: commands are
+ * sent as text, and only check-sat and get-value have a response
+ * which is read back. Terms are built by compiler::SmtLowering.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_SMT_H
+#define SAT_SMT_H
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include <sat/typedefs.hh>
+
+#include <boost/function.hpp>
+
+namespace sat {
+
+    /* polled while waiting for the solver, true to give up */
+    typedef boost::function<bool()> SmtStopPredicate;
+
+    class SmtSolver {
+    public:
+        /* command is run by /bin/sh */
+        SmtSolver(const std::string& command);
+        ~SmtSolver();
+
+        /* false iff the solver could not be started */
+        bool start();
+
+        /* commands with no response (declarations, assertions, push,
+           pop). False iff the solver is lost */
+        bool command(const std::string& text);
+
+        /* STATUS_UNKNOWN if the solver says so, if stopped (the
+           solver is killed then) or lost */
+        status_t check();
+
+        /* the values of the given terms in the model of the last
+           check, as printed by the solver (e.g. `#b0101`, `true`) */
+        bool values(const std::vector<std::string>& terms,
+                    std::vector<std::string>& res);
+
+        inline void set_stop(SmtStopPredicate stop)
+        {
+            f_stop = stop;
+        }
+
+        inline bool lost() const
+        {
+            return f_lost;
+        }
+
+        inline const std::string& name() const
+        {
+            return f_command;
+        }
+
+    private:
+        /* non-copyable */
+        SmtSolver(const SmtSolver&);
+        SmtSolver& operator=(const SmtSolver&);
+
+        /* a whole s-expression or atom, nested newlines included */
+        bool recv_response(std::string& response);
+
+        void kill_solver();
+
+        std::string f_command;
+        pid_t f_pid;
+        int f_fd;
+        bool f_lost;
+
+        std::string f_buffer;
+        SmtStopPredicate f_stop;
+    };
+
+    /* `#b...`, `#x...` or `(_ bvN w)` as an unsigned value, `true` and
+       `false` as 1 and 0. False if value can not be parsed */
+    bool parse_smt_value(const std::string& value, unsigned long& res);
+
+}; // namespace sat
+
+#endif /* SAT_SMT_H */
@@ -0,0 +1,133 @@
+/**
+ * @file sat/stats.hh
+ * @brief SAT interface, solver statistics declaration.
+ *
+ * This module contains the declaration of the structured statistics
+ * collected for each solve() call of each engine. Statistics are kept
+ * by the EngineMgr, and outlive the engines they refer to.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_STATS_H
+#define SAT_STATS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <common/common.hh>
+
+namespace sat {
+
+    /* DDs CNF-ized by an algorithm, and the vars and clauses it took
+       (model vars included, on first use) */
+    struct CNFCounters {
+        CNFCounters()
+            : dds(0)
+            , vars(0)
+            , clauses(0)
+        {}
+
+        uint64_t dds;
+        uint64_t vars;
+        uint64_t clauses;
+    };
+
+    /* solver counters, as reported by backends */
+    struct SolverCounters {
+        SolverCounters()
+            : vars(0)
+            , clauses(0)
+            , learnts(0)
+            , conflicts(0)
+            , propagations(0)
+            , decisions(0)
+            , eliminated(0)
+            , eliminated_inputs(0)
+            , dropped_duplicates(0)
+            , dropped_subsumed(0)
+            , memory(0)
+        {}
+
+        uint64_t vars;
+        uint64_t clauses;
+        uint64_t learnts;
+        uint64_t conflicts;
+        uint64_t propagations;
+        uint64_t decisions;
+
+        /* vars removed by preprocessing */
+        uint64_t eliminated;
+
+        /* ... of which transient inputs, see Engine::set_transient_input() */
+        uint64_t eliminated_inputs;
+
+        /* clauses never given to the backend, see --clause-filter */
+        uint64_t dropped_duplicates;
+        uint64_t dropped_subsumed;
+
+        /* bytes taken by the clause database, an estimate */
+        uint64_t memory;
+
+        /* by CNFization algorithm, see --cnf-strategy */
+        CNFCounters single_cut;
+        CNFCounters no_cut;
+        CNFCounters polarity;
+    };
+
+    /* a single solve() call */
+    struct SolveStats {
+        SolveStats()
+            : step(0)
+            , status(0)
+            , wall_secs(0.0)
+            , cpu_secs(0.0)
+        {}
+
+        /* unrolling step, as set by the caller */
+        step_t step;
+
+        /* a status_t */
+        int status;
+
+        /* counters, after solving */
+        SolverCounters counters;
+
+        double wall_secs;
+        double cpu_secs;
+    };
+
+    /* an engine lifetime */
+    struct EngineStats {
+        /* engine name (i.e. the strategy) and backend */
+        std::string name;
+        std::string backend;
+
+        /* true until the engine is destroyed */
+        bool active;
+
+        std::vector<SolveStats> solves;
+    };
+
+    typedef std::vector<EngineStats> EngineStatsVector;
+
+}; // namespace sat
+
+#endif /* SAT_STATS_H */
@@ -72,48 +72,78 @@ namespace sat {
         STATUS_UNKNOWN,
     } status_t;
 
+    typedef enum {
+        CNF_SINGLE_CUT,
+        CNF_POLARITY,
+        CNF_NO_CUT,
+
+        /* no-cut or single-cut, by the shape of each DD */
+        CNF_ADAPTIVE,
+    } cnf_strategy_t;
+
+    /* decisions on model vars, by the distance of their frame from
+       the first one (the INIT of forward unrollings, the target of
+       backward ones), ahead of CNF and microcode aux vars */
+    typedef enum {
+        DECISION_ORDER_NONE,
+        DECISION_ORDER_FRAMES,
+        DECISION_ORDER_REVERSE,
+    } decision_order_t;
+
     typedef boost::unordered_map<enc::TCBI, Var, enc::TCBIHash, enc::TCBIEq> TCBI2VarMap;
-    typedef boost::unordered_map<Var, enc::TCBI, utils::IntHash, utils::IntEq> Var2TCBIMap;
 
-    struct TimedVar {
+    /* model vars -> TCBIs, indexed by var (NULL for CNF and group
+       vars). Entries point to the keys of the TCBI2VarMap, whose nodes
+       are never moved nor erased */
+    typedef std::vector<const enc::TCBI*> Var2TCBIMap;
+
+    /* constant model bits, keyed by their FROZEN TCBI */
+    typedef boost::unordered_map<enc::TCBI, bool, enc::TCBIHash, enc::TCBIEq> FixedBitsMap;
+
+    /* model bits, keyed by their FROZEN TCBI */
+    typedef boost::unordered_set<enc::TCBI, enc::TCBIHash, enc::TCBIEq> TCBISet;
+
+    /* Dense (DD index, time) -> var table, in front of the TCBI
+     * registry. Forward times are rows of their own, negative times
+     * (backward unrollings) rows by their distance from the end.
+     * FROZEN and far away times are not covered. Entries are -1 until
+     * booked, and never change afterwards. */
+    struct DDVarTable {
     public:
-        TimedVar(Var var, step_t time)
-            : f_var(var)
-            , f_time(time)
-        {}
+        /* rows per direction */
+        static const step_t max_rows { 1 << 16 };
 
-        inline Var var() const
+        /* the entry for index at time, NULL if not covered */
+        inline Var* slot(int index, step_t time)
         {
-            return f_var;
-        }
+            assert(0 <= index);
 
-        inline step_t time() const
-        {
-            return f_time;
-        }
+            std::vector<std::vector<Var>>* rows { &f_forward };
+            step_t row { time };
+            if (is_negative(time)) {
+                rows = &f_backward;
+                row = UINT_MAX - time;
+            }
 
-        // The CNF var
-        Var f_var;
+            if (FROZEN == time || max_rows <= row) {
+                return NULL;
+            }
 
-        // expression time (default is 0)
-        step_t f_time;
-    };
+            if (rows->size() <= row) {
+                rows->resize(1 + row);
+            }
 
-    struct TimedVarHash {
-        inline long operator()(const TimedVar& k) const
-        {
-            return 0L;
-        }
-    };
+            std::vector<Var>& vars { (*rows)[row] };
+            if (vars.size() <= (unsigned) index) {
+                vars.resize(1 + index, -1);
+            }
 
-    struct TimedVarEq {
-        inline bool operator()(const TimedVar& x, const TimedVar& y) const
-        {
-            return (x.var() == y.var() && x.time() == y.time());
+            return &vars[index];
         }
-    };
 
-    typedef boost::unordered_map<TimedVar, Var, TimedVarHash, TimedVarEq> RewriteMap;
+        std::vector<std::vector<Var>> f_forward;
+        std::vector<std::vector<Var>> f_backward;
+    };
 
     struct TimedDD {
     public:
@@ -143,7 +173,8 @@ namespace sat {
         inline long operator()(const TimedDD& k) const
         {
             utils::PtrHash hasher;
-            return hasher(reinterpret_cast<void*>(k.node()));
+            long res { hasher(reinterpret_cast<void*>(k.node())) };
+            return res ^ ((long) k.time() * 0x9e3779b1L);
         }
     };
 
@@ -154,7 +185,21 @@ namespace sat {
         }
     };
 
-    typedef boost::unordered_map<TimedDD, Var, TimedDDHash, TimedDDEq> TDD2VarMap;
+    /* CNF vars of DD nodes within a single time frame */
+    typedef boost::unordered_map<DdNode*, Var, utils::PtrHash, utils::PtrEq> DD2VarMap;
+
+    /* ... by time frame, so that the cost of a lookup does not depend
+       on the depth of the unrolling and the table of a frame which is
+       no longer referred to can be dropped as a whole */
+    typedef boost::unordered_map<step_t, DD2VarMap> TDD2VarMap;
+
+    /* AIG nodes, by id and time */
+    typedef boost::unordered_map<std::pair<unsigned, step_t>, Var> TAig2VarMap;
+
+    /* selection MUXes already injected, by the DD node of their
+       first activation var, time and group */
+    typedef std::pair<std::pair<DdNode*, step_t>, Var> TimedMux;
+    typedef boost::unordered_set<TimedMux> TimedMuxSet;
 
 // move me!
 #if 0
@@ -171,27 +216,24 @@ struct ptr_hasher  {
 
     typedef vec<group_t> Groups;
 
-#include <boost/unordered_map.hpp>
-#include <utils/pool.hh>
+    /* a lazy array MUX, as pushed at some time. Bits are literals,
+       the index is MSB first, element j is x[j * elem_width ..] */
+    struct LazyArrayMux {
+        unsigned elem_width;
+        unsigned elem_count;
+        group_t group;
 
-    typedef boost::unordered_map<int, Var, utils::IntHash, utils::IntEq> Index2VarMap;
+        std::vector<Lit> index;
+        std::vector<Lit> z;
+        std::vector<Lit> x;
 
-    struct VarHash {
-        inline long operator()(Var v) const
-        {
-            return (long) (v);
-        }
+        /* elements constrained so far */
+        std::vector<bool> refined;
     };
+    typedef std::vector<LazyArrayMux> LazyArrayMuxes;
 
-    struct VarEq {
-        inline bool operator()(const Var x,
-                               const Var y) const
-        {
-            return x == y;
-        }
-    };
-
-    typedef boost::unordered_map<Var, int, VarHash, VarEq> Var2IndexMap;
+#include <boost/unordered_map.hpp>
+#include <utils/pool.hh>
 
     struct GroupHash {
         inline long operator()(group_t group) const
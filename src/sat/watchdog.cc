@@ -0,0 +1,131 @@
+/**
+ * @file sat/watchdog.cc
+ * @brief SAT interface, resource limits watchdog implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <cstdio>
+
+#include <unistd.h>
+
+#include <sat/engine_mgr.hh>
+#include <sat/watchdog.hh>
+
+#include <utils/logging.hh>
+
+namespace sat {
+
+    /* polling interval, in milliseconds */
+    static const unsigned WATCHDOG_TICK { 100 };
+
+    /* current resident set size, in MB (0 if unknown) */
+    static unsigned resident_megs()
+    {
+        FILE* statm { fopen("/proc/self/statm", "r") };
+        if (NULL == statm) {
+            return 0;
+        }
+
+        unsigned long size, resident { 0 };
+        if (2 != fscanf(statm, "%lu %lu", &size, &resident)) {
+            resident = 0;
+        }
+        fclose(statm);
+
+        return (resident * sysconf(_SC_PAGESIZE)) >> 20;
+    }
+
+    Watchdog::Watchdog(const void* scope, const ResourceLimits& limits)
+        : f_scope(scope)
+        , f_limits(limits)
+        , f_done(false)
+        , f_expired(false)
+        , f_thread(&Watchdog::run, this)
+    {}
+
+    Watchdog::~Watchdog()
+    {
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            f_done = true;
+        }
+
+        f_cond.notify_one();
+        f_thread.join();
+    }
+
+    bool Watchdog::expired()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_expired;
+    }
+
+    void Watchdog::run()
+    {
+        const boost::posix_time::ptime t0 {
+            boost::posix_time::microsec_clock::universal_time()
+        };
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        while (!f_done) {
+            f_cond.timed_wait(lock, boost::posix_time::milliseconds(WATCHDOG_TICK));
+            if (f_done) {
+                break;
+            }
+
+            if (!f_expired) {
+                const boost::posix_time::time_duration elapsed {
+                    boost::posix_time::microsec_clock::universal_time() - t0
+                };
+
+                if (0 < f_limits.timeout && f_limits.timeout <= elapsed.total_seconds()) {
+                    unsigned timeout { f_limits.timeout };
+                    WARN
+                        << "Timeout ("
+                        << timeout
+                        << "s) expired, interrupting..."
+                        << std::endl;
+
+                    f_expired = true;
+                }
+
+                else if (0 < f_limits.max_memory) {
+                    unsigned megs { resident_megs() };
+                    if (f_limits.max_memory <= megs) {
+                        WARN
+                            << "Memory limit exceeded ("
+                            << megs
+                            << "MB), interrupting..."
+                            << std::endl;
+
+                        f_expired = true;
+                    }
+                }
+            }
+
+            /* engines created after expiration must be stopped as
+               well, keep on interrupting */
+            if (f_expired) {
+                EngineMgr::INSTANCE().interrupt(f_scope);
+            }
+        }
+    }
+
+}; // namespace sat
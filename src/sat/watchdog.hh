@@ -0,0 +1,99 @@
+/**
+ * @file sat/watchdog.hh
+ * @brief SAT interface, resource limits watchdog declaration.
+ *
+ * This module contains the declaration of the watchdog used to
+ * enforce per-command resource limits. Wall time and memory are
+ * polled by a dedicated thread, which interrupts all the engines in
+ * its scope as soon as a limit is exceeded. Conflict budgets are
+ * enforced by the solvers themselves.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef SAT_WATCHDOG_H
+#define SAT_WATCHDOG_H
+
+#include <stdint.h>
+
+#include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace sat {
+
+    /* Per-command resource limits, zero means no limit */
+    struct ResourceLimits {
+        ResourceLimits()
+            : timeout(0)
+            , conflicts(0)
+            , max_memory(0)
+        {}
+
+        /* wall time, in seconds */
+        unsigned timeout;
+
+        /* conflicts, for each engine */
+        uint64_t conflicts;
+
+        /* resident memory, in MB */
+        unsigned max_memory;
+
+        /* true iff limits require a watchdog */
+        inline bool watched() const
+        {
+            return 0 < timeout || 0 < max_memory;
+        }
+    };
+
+    class Watchdog {
+    public:
+        /* starts watching, engines in scope are interrupted when a
+         * limit is exceeded */
+        Watchdog(const void* scope, const ResourceLimits& limits);
+
+        /* stops watching */
+        ~Watchdog();
+
+        /* true iff a limit has been exceeded */
+        bool expired();
+
+    private:
+        /* non-copyable */
+        Watchdog(const Watchdog&);
+        Watchdog& operator=(const Watchdog&);
+
+        void run();
+
+        const void* f_scope;
+        ResourceLimits f_limits;
+
+        bool f_done;
+        bool f_expired;
+
+        boost::mutex f_mutex;
+        boost::condition_variable f_cond;
+        boost::thread f_thread;
+    };
+
+    typedef Watchdog* Watchdog_ptr;
+
+}; // namespace sat
+
+#endif /* SAT_WATCHDOG_H */
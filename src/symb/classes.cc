@@ -21,6 +21,8 @@
  *
  **/
 
+#include <expr/collector.hh>
+
 #include <symb/classes.hh>
 #include <symb/exceptions.hh>
 #include <symb/typedefs.hh>
@@ -47,6 +49,16 @@ namespace symb {
         return (*res);
     }
 
+    void Symbol::mark(expr::ExprMarker& marker) const
+    {
+        marker.mark(module());
+        marker.mark(name());
+
+        if (is_define()) {
+            marker.mark(as_define().body());
+        }
+    }
+
     bool Symbol::is_parameter(void) const
     {
         return NULL != dynamic_cast<const Parameter_ptr>(const_cast<const Symbol_ptr>(this));
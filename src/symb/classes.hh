@@ -95,6 +95,9 @@ namespace symb {
         bool is_hidden() const;
         void set_hidden(bool value);
 
+        /* the exprs of the symbol are live */
+        void mark(expr::ExprMarker& marker) const;
+
         value_format_t format() const
         {
             return f_format;
@@ -36,6 +36,15 @@ BOOST_AUTO_TEST_SUITE_END()
 
 #include <utils/logging.hh>
 
+/* tests only log warnings and errors */
+struct LoggingSetup {
+    LoggingSetup()
+    {
+        utils::Logger::INSTANCE().set_level(axter::log_always);
+    }
+};
+BOOST_GLOBAL_FIXTURE(LoggingSetup);
+
 // just for debugging purposes within gdb
 void pe(expr::Expr_ptr e)
 {
@@ -25,6 +25,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <stdint.h>
+#include <ctime>
 
 #include <compiler/compiler.hh>
 
@@ -35,6 +36,7 @@
 #include <model/model.hh>
 #include <model/model_mgr.hh>
 #include <model/module.hh>
+#include <model/ranges.hh>
 
 using LList = std::initializer_list<std::initializer_list<int>>;
 class DDChecker {
@@ -503,4 +505,344 @@ BOOST_AUTO_TEST_CASE(compiler_boolean)
     }
 }
 
+BOOST_AUTO_TEST_CASE(compiler_constant_operands)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    compiler::Compiler f_compiler;
+
+    model::Model& model { mm.model() };
+
+    expr::Atom a_main { "main" };
+    expr::Expr_ptr main_expr { em.make_identifier(a_main) };
+
+    if (model.empty()) {
+        model.add_module(*new model::Module(main_expr));
+    }
+    model::Module& main_module { model.main_module() };
+
+    type::Type_ptr u16 { tm.find_unsigned(16) };
+
+    expr::Atom a_a { "a" };
+    expr::Expr_ptr a { em.make_identifier(a_a) };
+    main_module.add_var(a, new symb::Variable(main_expr, a, u16));
+
+    expr::Atom a_b { "b" };
+    expr::Expr_ptr b { em.make_identifier(a_b) };
+    main_module.add_var(b, new symb::Variable(main_expr, b, u16));
+
+    expr::Expr_ptr ctx { em.make_empty() };
+
+    /* a << 2 = b, shifts by constants are pure wiring */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_lshift(a, em.make_const(2)), b))
+        };
+
+        const compiler::InlinedOperatorDescriptors& iods { cu.inlined_operator_descriptors() };
+        BOOST_CHECK(iods.size() == 1);
+        BOOST_CHECK(expr::EQ == compiler::ios_optype(iods.at(0).ios()));
+    }
+
+    /* a * 8 = b, multiplication by a power of two is a shift */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_mul(a, em.make_const(8)), b))
+        };
+
+        const compiler::InlinedOperatorDescriptors& iods { cu.inlined_operator_descriptors() };
+        BOOST_CHECK(iods.size() == 1);
+        BOOST_CHECK(expr::EQ == compiler::ios_optype(iods.at(0).ios()));
+    }
+
+    /* 3 * a = b, i.e. (a << 2) - a */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_mul(em.make_const(3), a), b))
+        };
+
+        const compiler::InlinedOperatorDescriptors& iods { cu.inlined_operator_descriptors() };
+        BOOST_CHECK(iods.size() == 2);
+        BOOST_CHECK(expr::SUB == compiler::ios_optype(iods.at(0).ios()));
+    }
+
+    /* a * b = a, no constant operand */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_mul(a, b), a))
+        };
+
+        const compiler::InlinedOperatorDescriptors& iods { cu.inlined_operator_descriptors() };
+        BOOST_CHECK(iods.size() == 2);
+        BOOST_CHECK(expr::MUL == compiler::ios_optype(iods.at(0).ios()));
+    }
+
+    /* (a + 0) * 1 = b, identities are rewritten at word level */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_mul(em.make_add(a, em.make_zero()),
+                                                           em.make_one()), b))
+        };
+
+        const compiler::InlinedOperatorDescriptors& iods { cu.inlined_operator_descriptors() };
+        BOOST_CHECK(iods.size() == 1);
+        BOOST_CHECK(expr::EQ == compiler::ios_optype(iods.at(0).ios()));
+    }
+
+    /* a = 42, comparisons with constants are bit patterns */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(a, em.make_const(42)))
+        };
+
+        BOOST_CHECK(cu.inlined_operator_descriptors().empty());
+        BOOST_CHECK(1 == cu.dds().size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compiler_array_subscripts)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    compiler::Compiler f_compiler;
+
+    model::Model& model { mm.model() };
+
+    expr::Atom a_main { "main" };
+    expr::Expr_ptr main_expr { em.make_identifier(a_main) };
+
+    if (model.empty()) {
+        model.add_module(*new model::Module(main_expr));
+    }
+    model::Module& main_module { model.main_module() };
+
+    expr::Atom a_i { "i" };
+    expr::Expr_ptr i { em.make_identifier(a_i) };
+    main_module.add_var(i, new symb::Variable(main_expr, i, tm.find_unsigned(16)));
+
+    expr::Atom a_small { "small" };
+    expr::Expr_ptr small { em.make_identifier(a_small) };
+    main_module.add_var(small, new symb::Variable(main_expr, small,
+                                                  tm.find_unsigned_array(8, 8)));
+
+    expr::Atom a_medium { "medium" };
+    expr::Expr_ptr medium { em.make_identifier(a_medium) };
+    main_module.add_var(medium, new symb::Variable(main_expr, medium,
+                                                   tm.find_unsigned_array(8, 64)));
+
+    expr::Atom a_large { "large" };
+    expr::Expr_ptr large { em.make_identifier(a_large) };
+    main_module.add_var(large, new symb::Variable(main_expr, large,
+                                                  tm.find_unsigned_array(8, 1024)));
+
+    expr::Expr_ptr ctx { em.make_empty() };
+
+    /* small arrays, one activation per element */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_subscript(small, i), em.make_zero()))
+        };
+
+        const compiler::MultiwaySelectionDescriptors& msds { cu.array_mux_descriptors() };
+        BOOST_CHECK(1 == msds.size());
+        BOOST_CHECK(!msds.at(0).is_lazy());
+        BOOST_CHECK(8 == msds.at(0).acts().size());
+    }
+
+    /* medium arrays, a tree of 63 2-way MUXes */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_subscript(medium, i), em.make_zero()))
+        };
+
+        BOOST_CHECK(cu.array_mux_descriptors().empty());
+        BOOST_CHECK(63 == cu.binary_selection_descriptors_map().size());
+    }
+
+    /* large arrays, lazy selection on plain index bits */
+    {
+        compiler::Unit cu {
+            f_compiler.process(ctx, em.make_eq(em.make_subscript(large, i), em.make_zero()))
+        };
+
+        const compiler::MultiwaySelectionDescriptors& msds { cu.array_mux_descriptors() };
+        BOOST_CHECK(1 == msds.size());
+        BOOST_CHECK(msds.at(0).is_lazy());
+        BOOST_CHECK(msds.at(0).acts().empty());
+        BOOST_CHECK(16 == msds.at(0).index().size());
+    }
+}
+
+/* compile times for arithmetic-heavy formulas, on the usual widths */
+BOOST_AUTO_TEST_CASE(compiler_arithmetic_benchmark)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    compiler::Compiler f_compiler;
+
+    model::Model& model { mm.model() };
+
+    expr::Atom a_main { "main" };
+    expr::Expr_ptr main_expr { em.make_identifier(a_main) };
+
+    if (model.empty()) {
+        model.add_module(*new model::Module(main_expr));
+    }
+    model::Module& main_module { model.main_module() };
+
+    expr::Expr_ptr ctx { em.make_empty() };
+    const unsigned depth { 64 };
+
+    for (unsigned width : { 8, 16, 32, 64 }) {
+        expr::Atom a_p { "p" + std::to_string(width) };
+        expr::Expr_ptr p { em.make_identifier(a_p) };
+        main_module.add_var(p, new symb::Variable(main_expr, p, tm.find_unsigned(width)));
+
+        expr::Atom a_q { "q" + std::to_string(width) };
+        expr::Expr_ptr q { em.make_identifier(a_q) };
+        main_module.add_var(q, new symb::Variable(main_expr, q, tm.find_unsigned(width)));
+
+        /* ((p + q) * p + q) * p ... = q */
+        expr::Expr_ptr body { p };
+        for (unsigned i = 0; i < depth; ++i) {
+            body = em.make_mul(em.make_add(body, q), p);
+        }
+
+        clock_t t0 { clock() };
+        compiler::Unit cu { f_compiler.process(ctx, em.make_eq(body, q)) };
+        double secs { (double) (clock() - t0) / (double) CLOCKS_PER_SEC };
+
+        BOOST_CHECK(2 * depth + 1 == cu.inlined_operator_descriptors().size());
+        BOOST_TEST_MESSAGE("width " << width << ": " << secs << " seconds");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(aig_structural_hashing)
+{
+    compiler::AigMgr& aig { compiler::AigMgr::INSTANCE() };
+
+    compiler::aig_lit_t x { aig.make_input(0) };
+    compiler::aig_lit_t y { aig.make_input(1) };
+    BOOST_CHECK(x == aig.make_input(0));
+
+    /* constants, equal and opposite operands */
+    BOOST_CHECK(compiler::AIG_FALSE == aig.make_and(x, compiler::AIG_FALSE));
+    BOOST_CHECK(x == aig.make_and(compiler::AIG_TRUE, x));
+    BOOST_CHECK(x == aig.make_and(x, x));
+    BOOST_CHECK(compiler::AIG_FALSE == aig.make_and(x, compiler::aig_not(x)));
+
+    /* AND nodes are shared, regardless of the operands order */
+    compiler::aig_lit_t xy { aig.make_and(x, y) };
+    BOOST_CHECK(xy == aig.make_and(y, x));
+    BOOST_CHECK(aig.node(compiler::aig_node(xy)).is_and());
+
+    /* one level of nesting */
+    BOOST_CHECK(xy == aig.make_and(xy, x));
+    BOOST_CHECK(compiler::AIG_FALSE == aig.make_and(xy, compiler::aig_not(y)));
+
+    std::vector<int> support;
+    aig.support(aig.make_xor(x, y), support);
+    BOOST_CHECK(2 == support.size());
+}
+
+BOOST_AUTO_TEST_CASE(model_value_ranges)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    model::Model model;
+
+    expr::Atom a_main { "main" };
+    expr::Expr_ptr main_expr { em.make_identifier(a_main) };
+    model::Module& main_module { model.add_module(*new model::Module(main_expr)) };
+
+    expr::Atom a_c { "c" };
+    expr::Expr_ptr c { em.make_identifier(a_c) };
+    main_module.add_var(c, new symb::Variable(main_expr, c, tm.find_unsigned(16)));
+
+    expr::Atom a_d { "d" };
+    expr::Expr_ptr d { em.make_identifier(a_d) };
+    main_module.add_var(d, new symb::Variable(main_expr, d, tm.find_unsigned(16)));
+
+    /* c counts up to 10, then wraps around; d is free */
+    expr::Expr_ptr ten { em.make_const(10) };
+    main_module.add_init(em.make_eq(c, em.make_zero()));
+    main_module.add_trans(
+        em.make_eq(em.make_next(c),
+                   em.make_ite(em.make_cond(em.make_eq(c, ten), em.make_zero()),
+                               em.make_add(c, em.make_one()))));
+
+    model::RangeAnalyzer analyzer { model };
+
+    expr::Expr_ptr full_c { em.make_dot(em.make_empty(), c) };
+    expr::Expr_ptr full_d { em.make_dot(em.make_empty(), d) };
+
+    const model::ValueRanges& ranges { analyzer.ranges() };
+    BOOST_REQUIRE(1 == ranges.count(full_c));
+    BOOST_CHECK_EQUAL(0, ranges.at(full_c).lo);
+    BOOST_CHECK_EQUAL(10, ranges.at(full_c).hi);
+
+    enc::VarWidths widths;
+    analyzer.narrowed_widths(widths);
+    BOOST_CHECK_EQUAL(4, widths.at(full_c));
+    BOOST_CHECK(0 == widths.count(full_d));
+}
+
+BOOST_AUTO_TEST_CASE(model_live_symbols)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    model::ModelMgr& mm { model::ModelMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    model::Model& model { mm.model() };
+
+    expr::Atom a_main { "main" };
+    expr::Expr_ptr main_expr { em.make_identifier(a_main) };
+
+    if (model.empty()) {
+        model.add_module(*new model::Module(main_expr));
+    }
+    model::Module& main_module { model.main_module() };
+
+    expr::Atom a_u { "u" };
+    expr::Expr_ptr u { em.make_identifier(a_u) };
+    main_module.add_var(u, new symb::Variable(main_expr, u, tm.find_boolean()));
+
+    expr::Atom a_v { "v" };
+    expr::Expr_ptr v { em.make_identifier(a_v) };
+    main_module.add_var(v, new symb::Variable(main_expr, v, tm.find_boolean()));
+
+    expr::Atom a_w { "w" };
+    expr::Expr_ptr w { em.make_identifier(a_w) };
+    main_module.add_var(w, new symb::Variable(main_expr, w, tm.find_boolean()));
+
+    /* u depends on v through flip, w and unused are dead */
+    expr::Atom a_flip { "flip" };
+    expr::Expr_ptr flip { em.make_identifier(a_flip) };
+    main_module.add_def(flip, new symb::Define(main_expr, flip, em.make_not(v)));
+
+    expr::Atom a_unused { "unused" };
+    expr::Expr_ptr unused { em.make_identifier(a_unused) };
+    main_module.add_def(unused, new symb::Define(main_expr, unused, em.make_and(u, w)));
+
+    expr::Expr_ptr ctx { em.make_empty() };
+
+    model::Analyzer analyzer;
+    analyzer.process(em.make_eq(em.make_next(u), flip), ctx, model::ANALYZE_TRANS);
+    analyzer.process(em.make_and(u, w), ctx, model::ANALYZE_DEFINE);
+
+    const model::LiveSymbols& live { analyzer.live() };
+    BOOST_CHECK(1 == live.count(em.make_dot(ctx, u)));
+    BOOST_CHECK(1 == live.count(em.make_dot(ctx, v)));
+    BOOST_CHECK(1 == live.count(em.make_dot(ctx, flip)));
+    BOOST_CHECK(0 == live.count(em.make_dot(ctx, w)));
+    BOOST_CHECK(0 == live.count(em.make_dot(ctx, unused)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
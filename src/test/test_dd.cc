@@ -33,6 +33,8 @@
 
 #include <cuddObj.hh>
 
+#include <dd/dd_walker.hh>
+
 BOOST_AUTO_TEST_SUITE(tests)
 
 BOOST_AUTO_TEST_CASE(dd_boolean)
@@ -219,4 +221,70 @@ BOOST_AUTO_TEST_CASE(dd_relational)
     BOOST_CHECK(x_equals_y.Or(x_lt_y) == lhs.LEQ(rhs));
 }
 
+
+/* counts the nodes of a DAG, each of them once */
+class NodeCounter: public dd::ADDDagWalker {
+public:
+    NodeCounter(dd::ADDWalkerScratch& scratch)
+        : dd::ADDDagWalker(scratch)
+        , f_count(0)
+    {}
+
+    unsigned f_count;
+
+protected:
+    bool condition(const DdNode* node)
+    {
+        return true;
+    }
+
+    void action(const DdNode* node)
+    {
+        ++f_count;
+    }
+
+    void pre_hook()
+    {
+        f_count = 0;
+    }
+
+    void post_hook()
+    {}
+};
+
+BOOST_AUTO_TEST_CASE(dd_dag_walker)
+{
+    Cudd dd;
+    dd::ADDWalkerScratch scratch;
+    NodeCounter counter { scratch };
+
+    ADD lhs { make_integer_encoding(dd, 8, false) };
+    ADD rhs { make_integer_encoding(dd, 8, false) };
+    ADD lt { lhs.LT(rhs) };
+
+    /* shared nodes are counted once, scratch is reused */
+    for (unsigned i = 0; i < 3; ++i) {
+        counter(lt);
+        BOOST_CHECK_EQUAL(counter.f_count, (unsigned) lt.nodeCount());
+    }
+
+    ADD one { dd.addOne() };
+    counter(one);
+    BOOST_CHECK_EQUAL(counter.f_count, 1u);
+
+    /* marks survive a rehash */
+    dd::ADDVisitedSet visited;
+    std::vector<ADD> vars;
+    for (unsigned i = 0; i < 4096; ++i) {
+        vars.push_back(dd.addVar());
+        BOOST_CHECK(visited.mark(vars.back().getNode()));
+    }
+    for (const auto& var : vars) {
+        BOOST_CHECK(!visited.mark(var.getNode()));
+    }
+
+    visited.clear();
+    BOOST_CHECK(visited.mark(vars[0].getNode()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
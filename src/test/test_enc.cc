@@ -24,13 +24,139 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 #include <expr/printer/printer.hh>
 
+#include <enc/enc.hh>
+#include <enc/enc_mgr.hh>
+
+#include <type/type_mgr.hh>
+
 BOOST_AUTO_TEST_SUITE(tests)
 BOOST_AUTO_TEST_CASE(enc)
 {
     // TODO
 }
+
+BOOST_AUTO_TEST_CASE(enc_interleaved)
+{
+    ::enc::EncodingMgr& bm { ::enc::EncodingMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    type::Type_ptr u8 { tm.find_unsigned(8) };
+
+    ::enc::Encoding_ptr x { bm.make_encoding(u8) };
+    ::enc::Encoding_ptr y { bm.make_encoding(u8, x) };
+    ::enc::Encoding_ptr z { bm.make_encoding(u8, y) };
+
+    /* x0 y0 z0 x1 y1 z1 ... in the variable order */
+    Cudd& dd { bm.dd() };
+    BOOST_REQUIRE_EQUAL(8, x->bits().size());
+    for (unsigned i = 0; i < 8; ++i) {
+        int level { dd.ReadPerm(x->bits()[i].getNode()->index) };
+
+        BOOST_CHECK_EQUAL(level + 1, dd.ReadPerm(y->bits()[i].getNode()->index));
+        BOOST_CHECK_EQUAL(level + 2, dd.ReadPerm(z->bits()[i].getNode()->index));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(enc_enum_one_hot)
+{
+    ::enc::EncodingMgr& bm { ::enc::EncodingMgr::INSTANCE() };
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    expr::ExprSet lits;
+    for (const char* name : { "RED", "GREEN", "BLUE", "CYAN", "MAGENTA" }) {
+        lits.insert(em.make_identifier(name));
+    }
+    type::EnumType_ptr color { tm.find_enum(lits)->as_enum() };
+
+    /* compared to literals only, one bit per literal but the last */
+    ::enc::EnumUses uses;
+    uses[color].literal_comparisons = 3;
+    bm.set_enum_uses(uses);
+
+    ::enc::EnumEncoding_ptr enc {
+        dynamic_cast<::enc::EnumEncoding_ptr>(bm.make_encoding(color))
+    };
+    BOOST_REQUIRE(NULL != enc);
+    BOOST_CHECK_EQUAL(::enc::ENUM_ENCODING_ONE_HOT, enc->encoding());
+    BOOST_CHECK_EQUAL(4, enc->bits().size());
+
+    bm.set_enum_uses(::enc::EnumUses());
+}
+
+BOOST_AUTO_TEST_CASE(enc_narrowed)
+{
+    ::enc::EncodingMgr& bm { ::enc::EncodingMgr::INSTANCE() };
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    expr::Expr_ptr u { em.make_dot(em.make_empty(), em.make_identifier("narrow_u")) };
+    expr::Expr_ptr s { em.make_dot(em.make_empty(), em.make_identifier("narrow_s")) };
+
+    ::enc::VarWidths widths;
+    widths[u] = 4;
+    widths[s] = 3;
+    bm.set_var_widths(widths);
+
+    /* leading digits are zeroes ... */
+    ::enc::Encoding_ptr x { bm.make_var_encoding(u, tm.find_unsigned(16)) };
+    BOOST_CHECK_EQUAL(16, x->dv().size());
+    BOOST_CHECK_EQUAL(4, x->bits().size());
+    for (unsigned i = 0; i < 12; ++i) {
+        BOOST_CHECK(x->dv()[i] == bm.constant(0));
+    }
+
+    /* ... or copies of the sign digit */
+    ::enc::Encoding_ptr y { bm.make_var_encoding(s, tm.find_signed(16)) };
+    BOOST_CHECK_EQUAL(16, y->dv().size());
+    BOOST_CHECK_EQUAL(3, y->bits().size());
+    for (unsigned i = 0; i < 13; ++i) {
+        BOOST_CHECK(y->dv()[i] == y->dv()[13]);
+    }
+
+    bm.set_var_widths(::enc::VarWidths());
+}
+
+BOOST_AUTO_TEST_CASE(enc_assignment)
+{
+    ::enc::EncodingMgr& bm { ::enc::EncodingMgr::INSTANCE() };
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+    /* values are encoded back to the same values */
+    ::enc::Encoding_ptr x { bm.make_encoding(tm.find_signed(8)) };
+    for (expr::Expr_ptr value : { em.make_const(42), em.make_neg(em.make_const(3)) }) {
+        std::vector<int> assignment(bm.nbits(), -1);
+        BOOST_REQUIRE(x->assignment(value, &assignment[0]));
+
+        for (auto& bit : assignment) {
+            bit = std::max(bit, 0);
+        }
+        BOOST_CHECK(value == x->expr(&assignment[0]));
+    }
+
+    expr::ExprSet lits;
+    for (const char* name : { "NORTH", "EAST", "SOUTH", "WEST" }) {
+        lits.insert(em.make_identifier(name));
+    }
+    ::enc::Encoding_ptr dir { bm.make_encoding(tm.find_enum(lits)) };
+
+    expr::Expr_ptr south { em.make_identifier("SOUTH") };
+    std::vector<int> assignment(bm.nbits(), -1);
+    BOOST_REQUIRE(dir->assignment(south, &assignment[0]));
+    for (auto& bit : assignment) {
+        bit = std::max(bit, 0);
+    }
+    BOOST_CHECK(south == dir->expr(&assignment[0]));
+
+    /* not a literal of the enum */
+    std::vector<int> none(bm.nbits(), -1);
+    BOOST_CHECK(!dir->assignment(em.make_identifier("UP"), &none[0]));
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <expr/collector.hh>
 #include <expr/expr.hh>
 #include <expr/expr_mgr.hh>
 
@@ -32,6 +33,9 @@
 
 #include <expr/nnfizer/nnfizer.hh>
 #include <expr/printer/printer.hh>
+#include <expr/rewrite_cache.hh>
+
+#include <boost/thread.hpp>
 
 BOOST_AUTO_TEST_SUITE(tests)
 BOOST_AUTO_TEST_CASE(expressions)
@@ -575,6 +579,34 @@ BOOST_AUTO_TEST_CASE(printer)
     }
 }
 
+BOOST_AUTO_TEST_CASE(buffered_printer)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+    expr::Expr_ptr x { em.make_identifier("x") };
+    expr::Expr_ptr phi { em.make_eq(x, em.make_hconst(255)) };
+
+    std::ostringstream expected;
+    expr::Printer(expected) << phi;
+
+    std::ostringstream oss;
+    {
+        expr::Printer printer { oss, true };
+
+        /* more than one buffer, leaves are printed from the cache */
+        for (unsigned i = 0; i < expr::PRINT_BUFFER_SIZE; ++i) {
+            printer << phi << "\n";
+        }
+    }
+
+    std::string text { oss.str() };
+    std::string line { expected.str() + "\n" };
+
+    BOOST_CHECK_EQUAL(text.size(), expr::PRINT_BUFFER_SIZE * line.size());
+    BOOST_CHECK(text.substr(0, line.size()) == line);
+    BOOST_CHECK(text.substr(text.size() - line.size()) == line);
+}
+
 BOOST_AUTO_TEST_CASE(analyzer)
 {
     expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
@@ -672,6 +704,185 @@ BOOST_AUTO_TEST_CASE(expander)
                 expander.process(em.make_at(em.make_interval(_3, _0), x)));
 }
 
+BOOST_AUTO_TEST_CASE(expr_pool)
+{
+    expr::ExprPool pool;
+    bool fresh;
+
+    /* enough to span several chunks and index growths */
+    std::vector<expr::Expr_ptr> made;
+    for (value_t i = 0; i < 3 * (value_t) expr::EXPR_CHUNK_SIZE; ++i) {
+        made.push_back(pool.insert(expr::Expr(expr::ICONST, i), fresh));
+        BOOST_CHECK(fresh);
+    }
+    BOOST_CHECK_EQUAL(pool.size(), made.size());
+
+    for (value_t i = 0; i < (value_t) made.size(); ++i) {
+        BOOST_CHECK(made[i] == pool.insert(expr::Expr(expr::ICONST, i), fresh));
+        BOOST_CHECK(!fresh);
+        BOOST_CHECK(made[i]->value() == i);
+    }
+    BOOST_CHECK_EQUAL(pool.size(), made.size());
+
+    expr::Expr_ptr sum { pool.insert(expr::Expr(expr::PLUS, made[0], made[1]), fresh) };
+    BOOST_CHECK(sum == pool.insert(expr::Expr(expr::PLUS, made[0], made[1]), fresh));
+    BOOST_CHECK(sum != pool.insert(expr::Expr(expr::PLUS, made[1], made[0]), fresh));
+
+    /* ids are given by the manager, in order of creation */
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    expr::Expr_ptr a { em.make_identifier("id_a") };
+    expr::Expr_ptr b { em.make_identifier("id_b") };
+    BOOST_CHECK(a->id() < b->id());
+    BOOST_CHECK_EQUAL(a->id(), em.make_identifier("id_a")->id());
+
+    expr::ExprIdMap<int> map;
+    BOOST_CHECK(!map.find(a));
+    map.set(b, 42);
+    BOOST_CHECK(!map.find(a));
+    BOOST_CHECK_EQUAL(*map.find(b), 42);
+}
+
+BOOST_AUTO_TEST_CASE(atom_table)
+{
+    expr::AtomTable atoms;
+
+    expr::atom_t x { atoms.intern("x", 1) };
+    expr::atom_t y { atoms.intern(expr::Atom("y")) };
+    BOOST_CHECK(x != y);
+    BOOST_CHECK_EQUAL(atoms.size(), 2u);
+
+    /* lookups by chars, ids are dense */
+    BOOST_CHECK_EQUAL(x, atoms.intern("xyz", 1));
+    BOOST_CHECK_EQUAL(y, atoms.intern(expr::Atom("y")));
+    BOOST_CHECK_EQUAL(atoms.atom(x), "x");
+
+    for (unsigned i = 0; i < 2 * expr::ATOM_CHUNK_SIZE; ++i) {
+        std::ostringstream oss;
+        oss << "a" << i;
+        BOOST_CHECK_EQUAL(2 + i, atoms.intern(oss.str()));
+    }
+    BOOST_CHECK_EQUAL(atoms.atom(2 + expr::ATOM_CHUNK_SIZE), "a4096");
+
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    BOOST_CHECK(em.make_identifier("foo") == em.make_identifier(expr::Atom("foo")));
+    BOOST_CHECK(em.make_qstring("foo") != em.make_identifier("foo"));
+    BOOST_CHECK(em.make_qstring("foo") == em.make_qstring("foo"));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_pools)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+    const unsigned n_threads { 8 };
+    const unsigned n_exprs { 1000 };
+
+    /* all threads make the same exprs, in a different order */
+    std::vector<std::vector<expr::Expr_ptr>> made(n_threads);
+    boost::thread_group threads;
+    for (unsigned t = 0; t < n_threads; ++t) {
+        threads.create_thread([&em, &made, t, n_exprs]() {
+            std::vector<expr::Expr_ptr>& res { made[t] };
+            res.resize(n_exprs);
+
+            for (unsigned k = 0; k < n_exprs; ++k) {
+                unsigned i { (k * 7 + t * 13) % n_exprs };
+                std::ostringstream oss;
+                oss << "v" << i;
+
+                expr::Expr_ptr v { em.make_identifier(oss.str()) };
+                res[i] = em.make_add(v, em.make_const(i));
+            }
+        });
+    }
+    threads.join_all();
+
+    for (unsigned t = 1; t < n_threads; ++t) {
+        BOOST_CHECK(made[0] == made[t]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rewrite_cache)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    expr::RewriteCache& cache { expr::RewriteCache::INSTANCE() };
+
+    expr::Expr_ptr x { em.make_identifier("x") };
+    expr::Expr_ptr y { em.make_identifier("y") };
+    expr::Expr_ptr ctx { em.make_identifier("ctx") };
+    expr::Expr_ptr phi { em.make_not(em.make_and(x, y)) };
+
+    cache.clear();
+    BOOST_CHECK(NULL == cache.lookup(expr::REWRITE_PREPROCESS, ctx, phi));
+
+    cache.store(expr::REWRITE_PREPROCESS, ctx, phi, x);
+    BOOST_CHECK(x == cache.lookup(expr::REWRITE_PREPROCESS, ctx, phi));
+
+    /* keys include the pass and the context */
+    BOOST_CHECK(NULL == cache.lookup(expr::REWRITE_PREPROCESS, NULL, phi));
+    BOOST_CHECK(NULL == cache.lookup(expr::REWRITE_NNF, ctx, phi));
+
+    /* passes are memoized across instances */
+    expr::Nnfizer nnfizer;
+    expr::Expr_ptr nnf { nnfizer.process(phi) };
+    BOOST_CHECK(nnf == cache.lookup(expr::REWRITE_NNF, NULL, phi));
+
+    expr::RewriteCacheStats before { cache.stats(expr::REWRITE_NNF) };
+    expr::Nnfizer other;
+    BOOST_CHECK(nnf == other.process(phi));
+
+    expr::RewriteCacheStats after { cache.stats(expr::REWRITE_NNF) };
+    BOOST_CHECK_EQUAL(after.hits, 1 + before.hits);
+    BOOST_CHECK_EQUAL(after.stores, before.stores);
+
+    cache.clear();
+    BOOST_CHECK(NULL == cache.lookup(expr::REWRITE_PREPROCESS, ctx, phi));
+    BOOST_CHECK_EQUAL(0, cache.stats(expr::REWRITE_NNF).used);
+}
+
+BOOST_AUTO_TEST_CASE(expr_collection)
+{
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+    expr::ExprCollector& collector { expr::ExprCollector::INSTANCE() };
+
+    expr::Expr_ptr x { em.make_identifier("gc_x") };
+    expr::Expr_ptr y { em.make_identifier("gc_y") };
+    expr::Expr_ptr kept { em.make_and(x, em.make_not(y)) };
+    unsigned kept_id { kept->id() };
+
+    unsigned handle {
+        collector.add_roots(
+            "test", [kept](expr::ExprMarker& marker) {
+                marker.mark(kept);
+            })
+    };
+
+    expr::Expr_ptr garbage { em.make_or(x, em.make_next(y)) };
+    unsigned garbage_id { garbage->id() };
+
+    size_t live_before, bytes_before;
+    em.pool_stats(live_before, bytes_before);
+
+    unsigned collections { collector.stats().collections };
+    BOOST_CHECK(0 < collector.collect());
+    BOOST_CHECK_EQUAL(1 + collections, collector.stats().collections);
+
+    size_t live_after, bytes_after;
+    em.pool_stats(live_after, bytes_after);
+    BOOST_CHECK(live_after < live_before);
+
+    /* live exprs keep their identity */
+    BOOST_CHECK(kept == em.make_and(x, em.make_not(y)));
+    BOOST_CHECK_EQUAL(kept_id, kept->id());
+
+    /* collected ones are made again, ids are never reused */
+    expr::Expr_ptr again { em.make_or(x, em.make_next(y)) };
+    BOOST_CHECK(garbage_id < again->id());
+
+    collector.remove(handle);
+    collector.collect();
+    BOOST_CHECK(kept_id < em.make_and(x, em.make_not(y))->id());
+}
+
 // BOOST_AUTO_TEST_CASE(fqexpr)
 // {
 //     ExprMgr& em = ExprMgr::INSTANCE();
@@ -0,0 +1,679 @@
+/**
+ * @file test_sat.cc
+ * @brief SAT subsystem unit tests.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <stdint.h>
+
+#include <sat/bitblast.hh>
+#include <sat/inlining.hh>
+#include <sat/microcode.hh>
+#include <sat/minimizer.hh>
+#include <sat/proof.hh>
+#include <sat/remote.hh>
+#include <sat/sat.hh>
+#include <sat/smt.hh>
+
+/* reference semantics for a natively or in-process generated
+   operator */
+static int64_t reference(expr::ExprType op_type, bool is_signed, unsigned width,
+                         int64_t x, int64_t y)
+{
+    int64_t mask { (1LL << width) - 1 };
+    int64_t sign { 1LL << (width - 1) };
+
+    int64_t a { (is_signed && (x & sign)) ? x - (1LL << width) : x };
+    int64_t b { (is_signed && (y & sign)) ? y - (1LL << width) : y };
+
+    switch (op_type) {
+        case expr::ExprType::PLUS:
+            return (x + y) & mask;
+        case expr::ExprType::SUB:
+            return (x - y) & mask;
+        case expr::ExprType::EQ:
+            return a == b;
+        case expr::ExprType::NE:
+            return a != b;
+        case expr::ExprType::LT:
+            return a < b;
+        case expr::ExprType::LE:
+            return a <= b;
+        case expr::ExprType::GT:
+            return a > b;
+        case expr::ExprType::GE:
+            return a >= b;
+        case expr::ExprType::MUL:
+            return (x * y) & mask;
+        case expr::ExprType::DIV:
+            return (b ? a / b : (a < 0 ? 1 : -1)) & mask;
+        case expr::ExprType::MOD:
+            return (b ? a % b : a) & mask;
+        case expr::ExprType::NEG:
+            return -x & mask;
+        case expr::ExprType::BW_NOT:
+            return ~x & mask;
+        case expr::ExprType::BW_AND:
+            return x & y;
+        case expr::ExprType::BW_OR:
+            return x | y;
+        case expr::ExprType::BW_XOR:
+            return x ^ y;
+        case expr::ExprType::BW_XNOR:
+            return ~(x ^ y) & mask;
+        case expr::ExprType::IMPLIES:
+            return (~x | y) & mask;
+        default:
+            assert(false);
+    }
+
+    return 0;
+}
+
+static bool satisfies(const sat::Microcode& microcode, uint64_t assignment)
+{
+    for (unsigned i = 0; i < microcode.size(); ++i) {
+        bool sat { false };
+
+        const int32_t* end { microcode.clause_end(i) };
+        for (const int32_t* p = microcode.clause_begin(i); !sat && p != end; ++p) {
+            bool value { 0 != ((assignment >> (*p >> 1)) & 1) };
+            sat = value != (0 != (*p & 1));
+        }
+
+        if (!sat) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* exhaustive check: for every input pair, every model of the
+   clauses agrees with the reference semantics and at least one model
+   exists */
+static void check_operator(const compiler::InlinedOperatorSignature& ios,
+                           const sat::Microcode& microcode)
+{
+    expr::ExprType op_type { compiler::ios_optype(ios) };
+    bool is_signed { compiler::ios_issigned(ios) };
+    unsigned width { compiler::ios_width(ios) };
+
+    unsigned nvars { 3 * width };
+    for (unsigned i = 0; i < microcode.size(); ++i) {
+        const int32_t* end { microcode.clause_end(i) };
+        for (const int32_t* p = microcode.clause_begin(i); p != end; ++p) {
+            nvars = std::max(nvars, 1 + static_cast<unsigned>(*p >> 1));
+        }
+    }
+    BOOST_REQUIRE(nvars < 24);
+
+    bool relational { expr::ExprType::PLUS != op_type &&
+                      expr::ExprType::SUB != op_type };
+    uint64_t mask { (1ULL << width) - 1 };
+
+    for (uint64_t x = 0; x <= mask; ++x) {
+        for (uint64_t y = 0; y <= mask; ++y) {
+            int64_t expected { reference(op_type, is_signed, width, x, y) };
+            unsigned models { 0 };
+
+            for (uint64_t assignment = 0; assignment < (1ULL << nvars); ++assignment) {
+                if (x != ((assignment >> width) & mask) ||
+                    y != ((assignment >> (2 * width)) & mask)) {
+                    continue;
+                }
+
+                /* relational operators only use z(0) */
+                if (relational && (assignment & mask & ~1ULL)) {
+                    continue;
+                }
+
+                if (!satisfies(microcode, assignment)) {
+                    continue;
+                }
+
+                int64_t z { static_cast<int64_t>(
+                    relational ? assignment & 1 : assignment & mask) };
+
+                BOOST_CHECK(z == expected);
+                ++models;
+            }
+
+            BOOST_CHECK(0 < models);
+        }
+    }
+}
+
+static const expr::ExprType op_types[] = {
+    expr::ExprType::PLUS, expr::ExprType::SUB,
+    expr::ExprType::EQ, expr::ExprType::NE,
+    expr::ExprType::LT, expr::ExprType::LE,
+    expr::ExprType::GT, expr::ExprType::GE,
+};
+
+static const expr::ExprType generated_op_types[] = {
+    expr::ExprType::MUL, expr::ExprType::DIV, expr::ExprType::MOD,
+    expr::ExprType::NEG, expr::ExprType::BW_NOT,
+    expr::ExprType::BW_AND, expr::ExprType::BW_OR,
+    expr::ExprType::BW_XOR, expr::ExprType::BW_XNOR,
+    expr::ExprType::IMPLIES,
+};
+
+/* as check_operator, with a SAT solver, for operators with too many
+   auxiliary vars to enumerate their assignments: for every input
+   pair there is a model, and the expected z is the only one */
+static void check_generated(const compiler::InlinedOperatorSignature& ios,
+                            const sat::Microcode& microcode)
+{
+    expr::ExprType op_type { compiler::ios_optype(ios) };
+    bool is_signed { compiler::ios_issigned(ios) };
+    unsigned width { compiler::ios_width(ios) };
+
+    unsigned nvars { 3 * width };
+    for (unsigned i = 0; i < microcode.size(); ++i) {
+        const int32_t* end { microcode.clause_end(i) };
+        for (const int32_t* p = microcode.clause_begin(i); p != end; ++p) {
+            nvars = std::max(nvars, 1 + static_cast<unsigned>(*p >> 1));
+        }
+    }
+
+    sat::ProofBackend backend;
+    for (unsigned i = 0; i < nvars; ++i) {
+        backend.new_var(false);
+    }
+    for (unsigned i = 0; i < microcode.size(); ++i) {
+        vec<Lit> ps;
+        const int32_t* end { microcode.clause_end(i) };
+        for (const int32_t* p = microcode.clause_begin(i); p != end; ++p) {
+            ps.push(Minisat::toLit(*p));
+        }
+        backend.add_clause(ps);
+    }
+
+    uint64_t mask { (1ULL << width) - 1 };
+    for (uint64_t x = 0; x <= mask; ++x) {
+        for (uint64_t y = 0; y <= mask; ++y) {
+            int64_t expected { reference(op_type, is_signed, width, x, y) };
+
+            vec<Lit> assumptions;
+            for (unsigned i = 0; i < width; ++i) {
+                assumptions.push(mkLit(width + i, !((x >> i) & 1)));
+                assumptions.push(mkLit(2 * width + i, !((y >> i) & 1)));
+            }
+
+            BOOST_REQUIRE_EQUAL(sat::STATUS_SAT, backend.solve(assumptions));
+
+            int64_t z { 0 };
+            for (unsigned i = 0; i < width; ++i) {
+                z |= static_cast<int64_t>(backend.value(i)) << i;
+            }
+            BOOST_CHECK(z == expected);
+
+            /* no other z, under an activation var of its own */
+            Var act { backend.new_var(false) };
+            vec<Lit> ps;
+            ps.push(mkLit(act, true));
+            for (unsigned i = 0; i < width; ++i) {
+                ps.push(mkLit(i, (expected >> i) & 1));
+            }
+            backend.add_clause(ps);
+
+            assumptions.push(mkLit(act));
+            BOOST_CHECK_EQUAL(sat::STATUS_UNSAT, backend.solve(assumptions));
+        }
+    }
+}
+
+typedef std::vector<std::vector<int>> Clauses;
+
+/* value of a CNF (Minisat integer encoding), for given assignment */
+static bool satisfies(const Clauses& clauses, unsigned assignment)
+{
+    for (const auto& clause : clauses) {
+        bool sat { false };
+        for (int lit : clause) {
+            sat = sat || (1 & (assignment >> (lit >> 1))) != (1 & lit);
+        }
+
+        if (!sat) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void add_clauses(sat::ProofBackend& backend, const Clauses& clauses)
+{
+    for (const auto& clause : clauses) {
+        vec<Lit> ps;
+        for (int lit : clause) {
+            ps.push(Minisat::toLit(lit));
+        }
+        backend.add_clause(ps);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(tests)
+BOOST_AUTO_TEST_CASE(sat_bitblast)
+{
+    for (unsigned width = 1; width <= 3; ++width) {
+        for (int is_signed = 0; is_signed < 2; ++is_signed) {
+            for (expr::ExprType op_type : op_types) {
+                compiler::InlinedOperatorSignature ios {
+                    compiler::make_ios(is_signed, op_type, width)
+                };
+
+                BOOST_REQUIRE(sat::can_bitblast(ios));
+
+                sat::Microcode microcode;
+                sat::bitblast(ios, microcode);
+                check_operator(ios, microcode);
+            }
+        }
+    }
+
+    /* no microcode width limits */
+    BOOST_CHECK(sat::can_bitblast(compiler::make_ios(false, expr::ExprType::PLUS, 128)));
+    BOOST_CHECK(!sat::can_bitblast(compiler::make_ios(false, expr::ExprType::MUL, 8)));
+}
+
+BOOST_AUTO_TEST_CASE(sat_microcode_generation)
+{
+    for (unsigned width = 1; width <= 3; ++width) {
+        for (int is_signed = 0; is_signed < 2; ++is_signed) {
+            for (expr::ExprType op_type : generated_op_types) {
+                compiler::InlinedOperatorSignature ios {
+                    compiler::make_ios(is_signed, op_type, width)
+                };
+
+                BOOST_REQUIRE(!sat::can_bitblast(ios));
+                BOOST_REQUIRE(sat::can_generate(ios));
+
+                sat::Microcode microcode;
+                sat::bitblast(ios, microcode);
+                check_generated(ios, microcode);
+
+                /* as cached, minimized */
+                sat::CNFMinimizer minimizer { 3 * width };
+                minimizer.load(microcode);
+                minimizer.run();
+                minimizer.flush(microcode);
+                check_generated(ios, microcode);
+            }
+        }
+    }
+
+    BOOST_CHECK(sat::can_generate(compiler::make_ios(true, expr::ExprType::DIV, 128)));
+    BOOST_CHECK(!sat::can_generate(compiler::make_ios(false, expr::ExprType::PLUS, 8)));
+}
+
+BOOST_AUTO_TEST_CASE(sat_injection_plan)
+{
+    const unsigned width { 3 };
+    for (expr::ExprType op_type : { expr::ExprType::PLUS, expr::ExprType::LT }) {
+        compiler::InlinedOperatorSignature ios {
+            compiler::make_ios(false, op_type, width)
+        };
+        bool relational { expr::ExprType::LT == op_type };
+
+        sat::Microcode microcode;
+        sat::bitblast(ios, microcode);
+
+        sat::InjectionPlan plan;
+        plan.build(microcode, width, relational);
+        BOOST_REQUIRE_EQUAL(microcode.size(), plan.size());
+
+        /* each literal maps back to its var, through its slot */
+        std::vector<int> var_of(plan.slots().size(), -1);
+        for (unsigned i = 0; i < microcode.size(); ++i) {
+            const int32_t* p { microcode.clause_begin(i) };
+            const int32_t* q { plan.clause_begin(i) };
+            BOOST_REQUIRE_EQUAL(microcode.clause_end(i) - p, plan.clause_end(i) - q);
+
+            for (; p != microcode.clause_end(i); ++p, ++q) {
+                BOOST_CHECK_EQUAL(*p & 1, *q & 1);
+
+                int& var { var_of[*q >> 1] };
+                BOOST_CHECK(var < 0 || var == (*p >> 1));
+                var = *p >> 1;
+            }
+        }
+
+        for (unsigned i = 0; i < plan.slots().size(); ++i) {
+            const sat::InjectionPlan::Slot& slot { plan.slots()[i] };
+            unsigned var { static_cast<unsigned>(var_of[i]) };
+
+            if (var < width) {
+                BOOST_CHECK_EQUAL(sat::InjectionPlan::SLOT_Z, slot.kind);
+                BOOST_CHECK_EQUAL(relational ? 0 : width - var - 1, slot.index);
+            } else if (var < 2 * width) {
+                BOOST_CHECK_EQUAL(sat::InjectionPlan::SLOT_X, slot.kind);
+                BOOST_CHECK_EQUAL(2 * width - var - 1, slot.index);
+            } else if (var < 3 * width) {
+                BOOST_CHECK_EQUAL(sat::InjectionPlan::SLOT_Y, slot.kind);
+                BOOST_CHECK_EQUAL(3 * width - var - 1, slot.index);
+            } else {
+                BOOST_CHECK_EQUAL(sat::InjectionPlan::SLOT_AUX, slot.kind);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sat_minimizer)
+{
+    for (unsigned width = 1; width <= 3; ++width) {
+        for (expr::ExprType op_type : op_types) {
+            compiler::InlinedOperatorSignature ios {
+                compiler::make_ios(false, op_type, width)
+            };
+
+            sat::Microcode microcode;
+            sat::bitblast(ios, microcode);
+
+            /* pad clauses with redundancy: a copy of each clause, and
+               a weaker version of it */
+            std::vector<uint32_t> offsets { 0 };
+            std::vector<int32_t> literals;
+            int32_t spare { static_cast<int32_t>(2 * (3 * width + 50)) };
+            for (unsigned i = 0; i < microcode.size(); ++i) {
+                for (unsigned copy = 0; copy < 3; ++copy) {
+                    literals.insert(literals.end(),
+                                    microcode.clause_begin(i), microcode.clause_end(i));
+                    if (2 == copy) {
+                        literals.push_back(spare);
+                    }
+                    offsets.push_back(literals.size());
+                }
+            }
+
+            unsigned original { microcode.size() };
+            microcode.assign(offsets, literals);
+
+            sat::CNFMinimizer minimizer { 3 * width };
+            minimizer.load(microcode);
+            minimizer.run();
+            minimizer.flush(microcode);
+
+            BOOST_CHECK(microcode.size() <= original);
+            BOOST_CHECK(2 * original <= minimizer.subsumed());
+            check_operator(ios, microcode);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sat_interpolation)
+{
+    /* vars [0, 9) in A, [5, 14) in B: [5, 9) are shared */
+    const unsigned n_vars { 14 };
+    const unsigned shared_lo { 5 };
+    const unsigned shared_hi { 9 };
+
+    unsigned seed { 1 };
+    unsigned unsat { 0 };
+    for (unsigned round = 0; round < 200; ++round) {
+        Clauses a;
+        Clauses b;
+        for (unsigned i = 0; i < 60; ++i) {
+            std::vector<int> clause;
+            bool in_a { i < 30 };
+            for (unsigned k = 0; k < 3; ++k) {
+                seed = 1103515245 * seed + 12345;
+                int var { static_cast<int>((in_a ? 0 : shared_lo) + (seed >> 16) % shared_hi) };
+                clause.push_back(2 * var + ((seed >> 8) & 1));
+            }
+            (in_a ? a : b).push_back(clause);
+        }
+
+        /* odd rounds assume a shared var, and a B var */
+        vec<Lit> assumptions;
+        unsigned mask { 0 };
+        unsigned values { 0 };
+        if (round & 1) {
+            assumptions.push(mkLit(shared_lo, round & 2));
+            assumptions.push(mkLit(n_vars - 1, round & 4));
+            mask = (1U << shared_lo) | (1U << (n_vars - 1));
+            values = ((round & 2) ? 0 : 1U << shared_lo) |
+                     ((round & 4) ? 0 : 1U << (n_vars - 1));
+        }
+
+        sat::ProofBackend backend;
+        for (unsigned i = 0; i < n_vars; ++i) {
+            backend.new_var(false);
+        }
+
+        backend.set_partition(sat::PARTITION_A);
+        add_clauses(backend, a);
+        backend.set_partition(sat::PARTITION_B);
+        add_clauses(backend, b);
+
+        sat::status_t status { backend.solve(assumptions) };
+        BOOST_REQUIRE(sat::STATUS_UNKNOWN != status);
+
+        if (sat::STATUS_SAT == status) {
+            unsigned model { 0 };
+            for (unsigned i = 0; i < n_vars; ++i) {
+                model |= backend.value(i) << i;
+            }
+
+            BOOST_CHECK(satisfies(a, model) && satisfies(b, model));
+            BOOST_CHECK_EQUAL(values, model & mask);
+            continue;
+        }
+
+        ++unsat;
+
+        /* leaves are the shared vars themselves */
+        std::vector<int> leaves(n_vars, -1);
+        for (unsigned i = shared_lo; i < shared_hi; ++i) {
+            leaves[i] = i;
+        }
+
+        sat::Interpolant itp;
+        BOOST_REQUIRE(backend.interpolant(leaves, itp));
+
+        /* A implies the interpolant, which is inconsistent with B */
+        for (unsigned x = 0; x < (1U << n_vars); ++x) {
+            if (values != (x & mask)) {
+                continue;
+            }
+
+            std::vector<bool> leaf_values(n_vars);
+            for (unsigned i = 0; i < n_vars; ++i) {
+                leaf_values[i] = 1 & (x >> i);
+            }
+
+            bool value { itp.eval(leaf_values) };
+            BOOST_CHECK(!satisfies(a, x) || value);
+            BOOST_CHECK(!satisfies(b, x) || !value);
+        }
+    }
+
+    BOOST_CHECK(0 < unsat);
+}
+
+BOOST_AUTO_TEST_CASE(sat_cnf_session)
+{
+    sat::CnfSession session;
+    BOOST_REQUIRE(session.select_backend(""));
+
+    /* (x1 | x2) & (!x1 | x3), kept across queries */
+    std::vector<int> clauses { 1, 2, 0, -1, 3, 0 };
+    session.add_clauses(clauses);
+
+    std::vector<int> model;
+    BOOST_CHECK_EQUAL(sat::STATUS_SAT, session.solve({ 1 }, model));
+    BOOST_REQUIRE_EQUAL(3, model.size());
+    BOOST_CHECK_EQUAL(1, model[0]);
+    BOOST_CHECK_EQUAL(3, model[2]);
+
+    BOOST_CHECK_EQUAL(sat::STATUS_UNSAT, session.solve({ 1, -3 }, model));
+    BOOST_CHECK(model.empty());
+
+    /* clauses added later refer to new vars too */
+    session.add_clauses({ -2, 4, 0 });
+    BOOST_CHECK_EQUAL(sat::STATUS_SAT, session.solve({ -1, -3 }, model));
+    BOOST_REQUIRE_EQUAL(4, model.size());
+    BOOST_CHECK_EQUAL(2, model[1]);
+    BOOST_CHECK_EQUAL(4, model[3]);
+}
+
+BOOST_AUTO_TEST_CASE(sat_smt_values)
+{
+    unsigned long value;
+
+    BOOST_CHECK(sat::parse_smt_value("#b0101", value));
+    BOOST_CHECK_EQUAL(5, value);
+
+    BOOST_CHECK(sat::parse_smt_value("#xff", value));
+    BOOST_CHECK_EQUAL(0xff, value);
+
+    BOOST_CHECK(sat::parse_smt_value("(_ bv42 8)", value));
+    BOOST_CHECK_EQUAL(42, value);
+
+    BOOST_CHECK(sat::parse_smt_value("true", value));
+    BOOST_CHECK_EQUAL(1, value);
+    BOOST_CHECK(sat::parse_smt_value("false", value));
+    BOOST_CHECK_EQUAL(0, value);
+
+    BOOST_CHECK(!sat::parse_smt_value("#b01z", value));
+    BOOST_CHECK(!sat::parse_smt_value("unknown", value));
+}
+
+BOOST_AUTO_TEST_CASE(sat_time_slicing)
+{
+    /* pigeonhole: 6 pigeons, 5 holes, takes many conflicts */
+    const unsigned pigeons { 6 };
+    const unsigned holes { 5 };
+
+    for (int budget : { -1, 20 }) {
+        sat::Engine engine { "slicing", new sat::ProofBackend() };
+
+        std::vector<std::vector<Var>> in(pigeons);
+        for (auto& pigeon : in) {
+            for (unsigned h = 0; h < holes; ++h) {
+                pigeon.push_back(engine.new_sat_var());
+            }
+        }
+
+        for (const auto& pigeon : in) {
+            vec<Lit> ps;
+            for (Var var : pigeon) {
+                ps.push(mkLit(var));
+            }
+            engine.add_clause(ps);
+        }
+        for (unsigned h = 0; h < holes; ++h) {
+            for (unsigned i = 0; i < pigeons; ++i) {
+                for (unsigned j = i + 1; j < pigeons; ++j) {
+                    vec<Lit> ps;
+                    ps.push(mkLit(in[i][h], true));
+                    ps.push(mkLit(in[j][h], true));
+                    engine.add_clause(ps);
+                }
+            }
+        }
+
+        unsigned slices { 0 };
+        engine.configure(budget, -1);
+        engine.set_time_slicing(5, [&slices]() { ++slices; });
+
+        sat::status_t status { engine.solve() };
+
+        sat::SolverCounters counters;
+        engine.counters(counters);
+
+        /* the configured budget bounds the whole call */
+        if (budget < 0) {
+            BOOST_CHECK_EQUAL(sat::STATUS_UNSAT, status);
+            BOOST_CHECK(0 < slices);
+        } else {
+            BOOST_CHECK_EQUAL(sat::STATUS_UNKNOWN, status);
+            BOOST_CHECK(counters.conflicts <= (uint64_t) budget + 1);
+            BOOST_CHECK(slices <= (unsigned) budget / 5);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sat_fork)
+{
+    sat::Engine parent { "fork_parent", "minisat-core" };
+    parent.record_cnf();
+
+    Var a { parent.new_sat_var() };
+    Var b { parent.new_sat_var() };
+
+    vec<Lit> ps;
+    ps.push(mkLit(a));
+    ps.push(mkLit(b));
+    parent.add_clause(ps);
+
+    sat::group_t group { parent.new_group() };
+    ps.clear();
+    ps.push(mkLit(group, true));
+    ps.push(mkLit(a, true));
+    parent.add_clause(ps);
+
+    BOOST_CHECK_EQUAL(sat::STATUS_SAT, parent.solve());
+
+    /* the fork has the parent's clauses and groups, and goes its
+       own way from there */
+    sat::Engine fork { "fork_child", parent };
+    BOOST_CHECK_EQUAL(sat::STATUS_SAT, fork.solve());
+    BOOST_CHECK_EQUAL(1, fork.value(b));
+
+    ps.clear();
+    ps.push(mkLit(b, true));
+    fork.add_clause(ps);
+    BOOST_CHECK_EQUAL(sat::STATUS_UNSAT, fork.solve());
+
+    BOOST_CHECK_EQUAL(sat::STATUS_SAT, parent.solve());
+
+    /* forks of forks */
+    sat::Engine grandchild { "fork_grandchild", fork };
+    BOOST_CHECK_EQUAL(sat::STATUS_UNSAT, grandchild.solve());
+}
+
+BOOST_AUTO_TEST_CASE(sat_priorities)
+{
+    /* both vars default to false, whichever is decided first is
+       false, the other one is propagated to true */
+    for (unsigned first = 0; first < 2; ++first) {
+        sat::Engine engine { "priorities", new sat::ProofBackend() };
+
+        Var vars[2] = { engine.new_sat_var(), engine.new_sat_var() };
+
+        vec<Lit> ps;
+        ps.push(mkLit(vars[0]));
+        ps.push(mkLit(vars[1]));
+        engine.add_clause(ps);
+
+        engine.set_priority(vars[first], 1.0);
+
+        BOOST_CHECK_EQUAL(sat::STATUS_SAT, engine.solve());
+        BOOST_CHECK_EQUAL(0, engine.value(vars[first]));
+        BOOST_CHECK_EQUAL(1, engine.value(vars[1 - first]));
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
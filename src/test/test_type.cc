@@ -121,6 +121,31 @@ BOOST_AUTO_TEST_CASE(signed_int_array_type)
     BOOST_CHECK(!type->is_instance());
 }
 
+BOOST_AUTO_TEST_CASE(interned_types)
+{
+    type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+    expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+    /* direct-indexed widths, and wider ones */
+    BOOST_CHECK(tm.find_unsigned(16) == tm.find_unsigned(16));
+    BOOST_CHECK(tm.find_signed(16) == tm.find_signed(16));
+    BOOST_CHECK(tm.find_constant(16) == tm.find_constant(16));
+    BOOST_CHECK(tm.find_unsigned(1024) == tm.find_unsigned(1024));
+    BOOST_CHECK(tm.find_unsigned(16) != tm.find_signed(16));
+
+    BOOST_CHECK(tm.find_unsigned(16)->repr() == em.make_unsigned_int_type(16));
+    BOOST_CHECK(tm.find_signed(1024)->repr() == em.make_signed_int_type(1024));
+
+    /* arrays are shared, whichever way they are found */
+    type::ArrayType_ptr array { tm.find_unsigned_array(16, 4) };
+    BOOST_CHECK(array == tm.find_array_type(tm.find_unsigned(16), 4));
+    BOOST_CHECK(array->of() == tm.find_unsigned(16));
+    BOOST_CHECK(array->repr() ==
+                em.make_subscript(em.make_unsigned_int_type(16), em.make_const(4)));
+
+    BOOST_CHECK(tm.find_boolean_array(4) == tm.find_array_type(tm.find_boolean(), 4));
+}
+
 BOOST_AUTO_TEST_CASE(enum_type)
 {
     type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
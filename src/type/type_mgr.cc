@@ -21,6 +21,8 @@
  *
  **/
 
+#include <expr/collector.hh>
+
 #include <opts/opts_mgr.hh>
 
 #include <type.hh>
@@ -34,19 +36,43 @@
 
 namespace type {
 
-    // static initialization
-    TypeMgr_ptr TypeMgr::f_instance = NULL;
-
     TypeMgr::TypeMgr()
         : f_register()
         , f_em(expr::ExprMgr::INSTANCE())
         , f_resolver(*new TypeResolver(*this))
+        , f_boolean(NULL)
+        , f_arrays()
     {
+        for (unsigned kind = 0; kind < N_INTERNED_KINDS; ++kind) {
+            for (unsigned width = 0; width <= MAX_INTERNED_WIDTH; ++width) {
+                f_interned[kind][width].store(NULL, std::memory_order_relaxed);
+            }
+        }
+
+        /* types are never released, neither are their reprs */
+        expr::ExprCollector::INSTANCE().add_roots(
+            "types", [this](expr::ExprMarker& marker) {
+                boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+                for (const auto& pair : f_register) {
+                    marker.mark(pair.first);
+                    if (pair.second) {
+                        marker.mark(pair.second->repr());
+                    }
+                }
+                for (const auto& pair : f_arrays) {
+                    marker.mark(pair.second->repr());
+                }
+                for (const auto& pair : f_lits) {
+                    marker.mark(pair.first);
+                }
+            });
     }
 
     /** Time */
     const TimeType_ptr TypeMgr::find_time()
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_time_type()
         };
@@ -68,47 +94,35 @@ namespace type {
     /** Booleans */
     const ScalarType_ptr TypeMgr::find_boolean()
     {
+        ScalarType_ptr res { f_boolean.load(std::memory_order_acquire) };
+        if (res) {
+            return res;
+        }
+
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_boolean_type()
         };
-        ScalarType_ptr res {
-            dynamic_cast<ScalarType_ptr>(lookup_type(descr))
-        };
+        res = dynamic_cast<ScalarType_ptr>(lookup_type(descr));
 
-        if (res) {
-            return res;
+        if (!res) {
+            res = new BooleanType(*this);
+            register_type(descr, res);
         }
 
-        res = new BooleanType(*this);
-        register_type(descr, res);
-
+        f_boolean.store(res, std::memory_order_release);
         return res;
     }
 
     const ArrayType_ptr TypeMgr::find_boolean_array(unsigned size)
     {
-        expr::Expr_ptr descr {
-            f_em.make_subscript(f_em.make_boolean_type(),
-                                f_em.make_const(size))
-        };
-        ArrayType_ptr res {
-            dynamic_cast<ArrayType_ptr>(lookup_type(descr))
-        };
-
-        if (res) {
-            return res;
-        }
-
-        // new type, needs to be registered before returning
-        res = new ArrayType(*this, find_boolean(), size);
-
-        register_type(descr, res);
-        return res;
+        return find_array_type(find_boolean(), size);
     }
 
     /** Enums */
     const ScalarType_ptr TypeMgr::find_enum(expr::ExprSet& lits)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr repr {
             em().make_enum_type(lits)
         };
@@ -142,48 +156,36 @@ namespace type {
 
     const ArrayType_ptr TypeMgr::find_enum_array(expr::ExprSet& lits, unsigned size)
     {
-        expr::Expr_ptr repr {
-            f_em.make_subscript(f_em.make_enum_type(lits),
-                                f_em.make_const(size))
-        };
-        ArrayType_ptr res {
-            dynamic_cast<ArrayType_ptr>(lookup_type(repr))
-        };
-
-        if (res) {
-            return res;
-        }
-
-        // new type, needs to be registered before returning
-        res = new ArrayType(*this, find_enum(lits), size);
-
-        register_type(repr, res);
-        return res;
+        return find_array_type(find_enum(lits), size);
     }
 
     /** Constants */
     const ScalarType_ptr TypeMgr::find_constant(unsigned width)
     {
+        ScalarType_ptr res { interned(INTERNED_CONSTANT, width) };
+        if (res) {
+            return res;
+        }
+
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_const_int_type(width)
         };
-        ScalarType_ptr res {
-            dynamic_cast<ScalarType_ptr>(lookup_type(descr))
-        };
+        res = dynamic_cast<ScalarType_ptr>(lookup_type(descr));
 
-        if (res) {
-            return res;
+        if (!res) {
+            // new type, needs to be registered before returning
+            res = new ConstantType(*this, width);
+            register_type(descr, res);
         }
 
-        // new type, needs to be registered before returning
-        res = new ConstantType(*this, width);
-
-        register_type(descr, res);
+        intern(INTERNED_CONSTANT, width, res);
         return res;
     }
 
     const StringType_ptr TypeMgr::find_string()
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_string_type()
         };
@@ -204,92 +206,65 @@ namespace type {
     /** Unsigned algebraics (both integer and fixed-point) */
     const ScalarType_ptr TypeMgr::find_unsigned(unsigned width)
     {
+        ScalarType_ptr res { interned(INTERNED_UNSIGNED, width) };
+        if (res) {
+            return res;
+        }
+
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_unsigned_int_type(width)
         };
-        ScalarType_ptr res {
-            dynamic_cast<ScalarType_ptr>(lookup_type(descr))
-        };
+        res = dynamic_cast<ScalarType_ptr>(lookup_type(descr));
 
-        if (res) {
-            return res;
+        if (!res) {
+            // new type, needs to be registered before returning
+            res = new UnsignedAlgebraicType(*this, width);
+            register_type(descr, res);
         }
 
-        // new type, needs to be registered before returning
-        res = new UnsignedAlgebraicType(*this, width);
-
-        register_type(descr, res);
+        intern(INTERNED_UNSIGNED, width, res);
         return res;
     }
 
     const ArrayType_ptr TypeMgr::find_unsigned_array(unsigned width, unsigned size)
     {
-        expr::Expr_ptr descr {
-            f_em.make_subscript(
-                f_em.make_unsigned_int_type(width),
-                f_em.make_const(size))
-        };
-        ArrayType_ptr res {
-            dynamic_cast<ArrayType_ptr>(lookup_type(descr))
-        };
-
-        if (res) {
-            return res;
-        }
-
-        // new type, needs to be registered before returning
-        res = new ArrayType(*this, find_unsigned(width), size);
-
-        register_type(descr, res);
-        return res;
+        return find_array_type(find_unsigned(width), size);
     }
 
     /** Signed algebraics (both integer and fixed-point) */
     const ScalarType_ptr TypeMgr::find_signed(unsigned width)
     {
+        ScalarType_ptr res { interned(INTERNED_SIGNED, width) };
+        if (res) {
+            return res;
+        }
+
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr descr {
             f_em.make_signed_int_type(width)
         };
-        ScalarType_ptr res {
-            dynamic_cast<ScalarType_ptr>(lookup_type(descr))
-        };
+        res = dynamic_cast<ScalarType_ptr>(lookup_type(descr));
 
-        if (res) {
-            return res;
+        if (!res) {
+            // new type, needs to be registered before returning
+            res = new SignedAlgebraicType(*this, width);
+            register_type(descr, res);
         }
 
-        // new type, needs to be registered before returning
-        res = new SignedAlgebraicType(*this, width);
-
-        register_type(descr, res);
+        intern(INTERNED_SIGNED, width, res);
         return res;
     }
 
     const ArrayType_ptr TypeMgr::find_signed_array(unsigned width, unsigned size)
     {
-        expr::Expr_ptr descr {
-            f_em.make_subscript(
-                f_em.make_signed_int_type(width),
-                f_em.make_const(size))
-        };
-        ArrayType_ptr res {
-            dynamic_cast<ArrayType_ptr>(lookup_type(descr))
-        };
-
-        if (res) {
-            return res;
-        }
-
-        // new type, needs to be registered before returning
-        res = new ArrayType(*this, find_signed(width), size);
-
-        register_type(descr, res);
-        return res;
+        return find_array_type(find_signed(width), size);
     }
 
     /** Instances */
     const ScalarType_ptr TypeMgr::find_instance(expr::Expr_ptr module, expr::Expr_ptr params)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         expr::Expr_ptr repr {
             em().make_params(module, params)
         };
@@ -310,6 +285,7 @@ namespace type {
     /** Typecasts */
     const Type_ptr TypeMgr::find_type_by_def(const expr::Expr_ptr expr)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
         assert(f_em.is_type(expr));
 
 	if (f_em.is_boolean_type(expr)) {
@@ -335,6 +311,14 @@ namespace type {
     /** Arrays */
     const ArrayType_ptr TypeMgr::find_array_type(ScalarType_ptr of, unsigned nelems)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+        std::pair<ScalarType_ptr, unsigned> key { of, nelems };
+
+        ArrayMap::const_iterator i { f_arrays.find(key) };
+        if (f_arrays.end() != i) {
+            return i->second;
+        }
+
         expr::Expr_ptr descr {
             f_em.make_subscript(of->repr(),
                                 f_em.make_const(nelems))
@@ -349,6 +333,7 @@ namespace type {
             register_type(descr, res);
         }
 
+        f_arrays.insert(std::make_pair(key, res));
         return res;
     }
 
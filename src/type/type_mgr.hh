@@ -27,6 +27,11 @@
 #ifndef TYPE_MGR_H
 #define TYPE_MGR_H
 
+#include <atomic>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <expr/expr.hh>
@@ -35,13 +40,28 @@
 #include <type/type_resolver.hh>
 #include <type/typedefs.hh>
 
+#include <utils/context.hh>
+
 namespace type {
 
+    /* scalar types up to this width are found by direct indexing,
+       with no lookup in the register */
+    const unsigned MAX_INTERNED_WIDTH { 256 };
+
+    typedef enum {
+        INTERNED_CONSTANT,
+        INTERNED_UNSIGNED,
+        INTERNED_SIGNED,
+        N_INTERNED_KINDS
+    } interned_kind_t;
+
     /*
    The TypeMgr has two well-defined responsibilites:
 
    1. It keeps track of types that has been defined;
    2. It instantiates (and owns) type descriptors (Type objects).
+
+   Lookups are serialized, as type checking runs on several threads.
 */
 
     class TypeMgr {
@@ -90,11 +110,8 @@ namespace type {
         /** Singleton instance accessor */
         static inline TypeMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new TypeMgr();
-            }
-
-            return (*f_instance);
+            return utils::Context::current().instance<TypeMgr>(
+                utils::CONTEXT_TYPES, []() { return new TypeMgr(); });
         }
 
         /** A ref to the ExprMgr */
@@ -108,8 +125,6 @@ namespace type {
         ~TypeMgr();
 
     private:
-        static TypeMgr_ptr f_instance;
-
         /* --- low-level services ----------------------------------------------- */
 
         // lookup up a type from its repr, returns NULL if not found
@@ -120,6 +135,21 @@ namespace type {
 
         void register_type(const expr::Expr_ptr expr, Type_ptr vtype);
 
+        // interned scalar type, NULL if not yet known (or too wide)
+        inline ScalarType_ptr interned(interned_kind_t kind, unsigned width) const
+        {
+            return width <= MAX_INTERNED_WIDTH
+                ? f_interned[kind][width].load(std::memory_order_acquire)
+                : NULL;
+        }
+
+        inline void intern(interned_kind_t kind, unsigned width, ScalarType_ptr tp)
+        {
+            if (width <= MAX_INTERNED_WIDTH) {
+                f_interned[kind][width].store(tp, std::memory_order_release);
+            }
+        }
+
         /* local data */
         TypeMap f_register;
 
@@ -128,6 +158,17 @@ namespace type {
 
         // ref to internal resolver
         TypeResolver f_resolver;
+
+        /* find_* methods nest (e.g. arrays of booleans) */
+        boost::recursive_mutex f_mutex;
+
+        /* hot types, read with no lock */
+        std::atomic<ScalarType_ptr> f_boolean;
+        std::atomic<ScalarType_ptr> f_interned[N_INTERNED_KINDS][1 + MAX_INTERNED_WIDTH];
+
+        /* arrays by element type and size, no repr is built on hits */
+        typedef boost::unordered_map<std::pair<ScalarType_ptr, unsigned>, ArrayType_ptr> ArrayMap;
+        ArrayMap f_arrays;
     };
 
 }; // namespace type
@@ -0,0 +1,94 @@
+/**
+ * @file context.cc
+ * @brief Generic utils module, contexts implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <context.hh>
+
+#include <map>
+
+#include <boost/thread/mutex.hpp>
+
+namespace utils {
+
+    // static initialization
+    boost::thread_specific_ptr<Context> Context::f_current { [](Context*) {} };
+
+    Context& Context::current()
+    {
+        Context_ptr res { f_current.get() };
+        return res ? *res : default_context();
+    }
+
+    Context& Context::default_context()
+    {
+        static Context_ptr res { new Context("default") };
+        return *res;
+    }
+
+    Context& Context::named(const std::string& name)
+    {
+        static boost::mutex mutex;
+        static std::map<std::string, Context_ptr> contexts;
+
+        Context& dflt { default_context() };
+        if (name == dflt.name()) {
+            return dflt;
+        }
+
+        boost::mutex::scoped_lock lock { mutex };
+
+        Context_ptr& res { contexts[name] };
+        if (!res) {
+            res = new Context(name);
+        }
+
+        return *res;
+    }
+
+    Context::Context(const std::string& name)
+        : f_name(name)
+    {
+        for (unsigned i = 0; i < N_CONTEXT_SLOTS; ++i) {
+            f_slots[i].store(NULL, std::memory_order_relaxed);
+        }
+    }
+
+    Context::~Context()
+    {}
+
+    std::string Context::label(const std::string& subsystem) const
+    {
+        return is_default() ? subsystem : subsystem + " (" + f_name + ")";
+    }
+
+    ContextScope::ContextScope(Context& context)
+        : f_previous(Context::f_current.get())
+    {
+        Context::f_current.reset(context.is_default() ? NULL : &context);
+    }
+
+    ContextScope::~ContextScope()
+    {
+        Context::f_current.reset(f_previous);
+    }
+
+}; // namespace utils
@@ -0,0 +1,141 @@
+/**
+ * @file context.hh
+ * @brief Generic utils module, contexts
+ *
+ * This header file contains the declarations of contexts. A context
+ * holds the managers of a model and of everything built on it (types,
+ * encodings, AIGs, witnesses, the environment, compiled FSMs and sessions),
+ * so that unrelated models can be worked on in the same process (e.g.
+ * by server clients). The INSTANCE() of those managers is the one of
+ * the context the calling thread works in, the default context unless
+ * a ContextScope is active. Exprs, options, SAT engines and the
+ * scheduler are shared by all contexts.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef UTILS_CONTEXT_H
+#define UTILS_CONTEXT_H
+
+#include <atomic>
+#include <string>
+
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+namespace utils {
+
+    /* the managers kept by each context */
+    typedef enum {
+        CONTEXT_TYPES,
+        CONTEXT_MODEL,
+        CONTEXT_ENCODINGS,
+        CONTEXT_AIGS,
+        CONTEXT_WITNESSES,
+        CONTEXT_ENVIRONMENT,
+        CONTEXT_REWRITES,
+        CONTEXT_COMPILED_FSM,
+        CONTEXT_REACH_SESSIONS,
+        CONTEXT_SIM_SESSIONS,
+        N_CONTEXT_SLOTS,
+    } context_slot_t;
+
+    typedef class Context* Context_ptr;
+
+    class Context {
+    public:
+        /* the context of the calling thread */
+        static Context& current();
+
+        /* the context of the command line, and of the model read on
+           startup */
+        static Context& default_context();
+
+        /* the context by name, made on first use. Contexts are never
+           destroyed, neither are their managers */
+        static Context& named(const std::string& name);
+
+        inline const std::string& name() const
+        {
+            return f_name;
+        }
+
+        inline bool is_default() const
+        {
+            return this == &default_context();
+        }
+
+        /* subsystem, qualified by the name of this context unless it
+           is the default one (e.g. for memory probes) */
+        std::string label(const std::string& subsystem) const;
+
+        /* the manager in slot, made by make() on first use. The
+           manager is made in this context, concurrent first uses
+           wait for it */
+        template <typename T, typename Make>
+        inline T& instance(context_slot_t slot, Make make)
+        {
+            void* res { f_slots[slot].load(std::memory_order_acquire) };
+
+            if (!res) {
+                /* managers may use the others in their ctors */
+                boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+                res = f_slots[slot].load(std::memory_order_relaxed);
+                if (!res) {
+                    res = make();
+                    f_slots[slot].store(res, std::memory_order_release);
+                }
+            }
+
+            return *static_cast<T*>(res);
+        }
+
+    private:
+        Context(const std::string& name);
+        ~Context();
+
+        friend class ContextScope;
+
+        /* NULL for the default context */
+        static boost::thread_specific_ptr<Context> f_current;
+
+        std::string f_name;
+
+        std::atomic<void*> f_slots[N_CONTEXT_SLOTS];
+        boost::recursive_mutex f_mutex;
+    };
+
+    /* the calling thread works in context, for the lifetime of the
+       scope (e.g. on the threads of a job) */
+    class ContextScope {
+    public:
+        ContextScope(Context& context);
+        ~ContextScope();
+
+    private:
+        ContextScope(const ContextScope&);
+        ContextScope& operator=(const ContextScope&);
+
+        Context_ptr f_previous;
+    };
+
+}; // namespace utils
+
+#endif /* UTILS_CONTEXT_H */
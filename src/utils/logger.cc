@@ -0,0 +1,361 @@
+/**
+ * @file logger.cc
+ * @brief Logging support, logger backend implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <logger.hh>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace utils {
+
+    /* a line and the time it was issued at, in ns since the epoch of
+       the logger */
+    struct LogEntry {
+        uint64_t stamp;
+        std::string text;
+    };
+
+    static inline bool stamp_less(const LogEntry& a, const LogEntry& b)
+    {
+        return a.stamp < b.stamp;
+    }
+
+    /* Single producer (the owning thread), single consumer (the
+       drainer) ring. The producer only writes f_head, the consumer
+       only writes f_tail: slots in between belong to the consumer */
+    class LogRing {
+    public:
+        LogRing()
+            : f_retired(false)
+            , f_head(0)
+            , f_tail(0)
+        {}
+
+        /* false iff full */
+        inline bool push(LogEntry& entry)
+        {
+            unsigned head { f_head.load(std::memory_order_relaxed) };
+            if (SIZE == head - f_tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            LogEntry& slot { f_entries[head % SIZE] };
+            slot.stamp = entry.stamp;
+            slot.text.swap(entry.text);
+
+            f_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* false iff empty */
+        inline bool pop(LogEntry& entry)
+        {
+            unsigned tail { f_tail.load(std::memory_order_relaxed) };
+            if (tail == f_head.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            LogEntry& slot { f_entries[tail % SIZE] };
+            entry.stamp = slot.stamp;
+            entry.text.swap(slot.text);
+
+            f_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool empty() const
+        {
+            return f_tail.load(std::memory_order_acquire) ==
+                   f_head.load(std::memory_order_acquire);
+        }
+
+        /* set when the owning thread exits */
+        std::atomic<bool> f_retired;
+
+    private:
+        static const unsigned SIZE { 1024 };
+
+        LogEntry f_entries[SIZE];
+        std::atomic<unsigned> f_head;
+        std::atomic<unsigned> f_tail;
+    };
+
+    struct ThreadLog {
+        ThreadLog(const std::string& tag)
+            : tag(tag)
+            , ring(NULL)
+            , busy(false)
+        {}
+
+        std::string tag;
+
+        /* made on the first asynchronous line */
+        LogRing* ring;
+
+        /* reused by the lines of this thread */
+        std::ostringstream os;
+        bool busy;
+    };
+
+    /* the ring is left to the drainer, which disposes of it once
+       drained */
+    static void retire_thread_log(ThreadLog* tl)
+    {
+        if (NULL != tl->ring) {
+            tl->ring->f_retired = true;
+        }
+
+        delete tl;
+    }
+
+    Logger::Logger()
+        : f_level(axter::log_often)
+        , f_thread_log(retire_thread_log)
+        , f_threads(0)
+        , f_async(false)
+        , f_stopping(false)
+        , f_drainer(NULL)
+        , f_os(std::cerr)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &f_epoch);
+    }
+
+    Logger::~Logger()
+    {
+        stop_async();
+    }
+
+    ThreadLog& Logger::thread_log()
+    {
+        ThreadLog* res { f_thread_log.get() };
+
+        if (NULL == res) {
+            char tag[16];
+            snprintf(tag, sizeof tag, "t%u", f_threads++);
+
+            res = new ThreadLog(tag);
+            f_thread_log.reset(res);
+        }
+
+        return *res;
+    }
+
+    void Logger::set_tag(const std::string& tag)
+    {
+        thread_log().tag = tag;
+    }
+
+    std::string Logger::tag()
+    {
+        return thread_log().tag;
+    }
+
+    void Logger::commit(const char* level, const char* file, int line,
+                        const char* function, const std::string& text)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        uint64_t stamp {
+            (uint64_t)(now.tv_sec - f_epoch.tv_sec) * 1000000000ULL + now.tv_nsec - f_epoch.tv_nsec
+        };
+
+        ThreadLog& tl { thread_log() };
+
+        /* [secs.usecs tag] file:line (function) T :: text */
+        char prefix[64];
+        snprintf(prefix, sizeof prefix, "[%llu.%06llu ",
+                 (unsigned long long) (stamp / 1000000000ULL),
+                 (unsigned long long) (stamp % 1000000000ULL) / 1000);
+
+        LogEntry entry;
+        entry.stamp = stamp;
+        entry.text.reserve(128 + text.size());
+        entry.text
+            .append(prefix)
+            .append(tl.tag)
+            .append("] ")
+            .append(file)
+            .append(":")
+            .append(std::to_string(line))
+            .append(" (")
+            .append(function)
+            .append(") ")
+            .append(level)
+            .append(text);
+
+        /* lines are written whole */
+        if (entry.text.empty() || '\n' != entry.text.back()) {
+            entry.text.push_back('\n');
+        }
+
+        if (!f_async) {
+            boost::mutex::scoped_lock lock { f_write_mutex };
+            f_os
+                << entry.text
+                << std::flush;
+
+            return;
+        }
+
+        if (NULL == tl.ring) {
+            tl.ring = new LogRing();
+
+            boost::mutex::scoped_lock lock { f_rings_mutex };
+            f_rings.push_back(tl.ring);
+        }
+
+        /* a full ring waits for the drainer */
+        while (!tl.ring->push(entry)) {
+            boost::this_thread::yield();
+        }
+    }
+
+    size_t Logger::drain()
+    {
+        boost::mutex::scoped_lock drain_lock { f_drain_mutex };
+
+        std::vector<LogEntry> batch;
+        {
+            boost::mutex::scoped_lock lock { f_rings_mutex };
+
+            std::vector<LogRing*> rings;
+            for (const auto ring : f_rings) {
+                /* retired before popping, nothing is pushed after */
+                bool retired { ring->f_retired };
+
+                LogEntry entry;
+                while (ring->pop(entry)) {
+                    batch.push_back(LogEntry());
+                    batch.back().stamp = entry.stamp;
+                    batch.back().text.swap(entry.text);
+                }
+
+                if (retired) {
+                    delete ring;
+                } else {
+                    rings.push_back(ring);
+                }
+            }
+
+            f_rings.swap(rings);
+        }
+
+        if (batch.empty()) {
+            return 0;
+        }
+
+        /* lines of different threads, in the order they were issued */
+        std::stable_sort(batch.begin(), batch.end(), stamp_less);
+
+        boost::mutex::scoped_lock lock { f_write_mutex };
+        for (const auto& entry : batch) {
+            f_os << entry.text;
+        }
+        f_os << std::flush;
+
+        return batch.size();
+    }
+
+    void Logger::drainer()
+    {
+        while (!f_stopping) {
+            if (0 == drain()) {
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(5));
+            }
+        }
+
+        drain();
+    }
+
+    void Logger::start_async()
+    {
+        if (f_async) {
+            return;
+        }
+
+        f_stopping = false;
+        f_async = true;
+        f_drainer = new boost::thread(&Logger::drainer, this);
+    }
+
+    void Logger::stop_async()
+    {
+        if (!f_async) {
+            return;
+        }
+
+        /* lines issued from now on are written at once */
+        f_async = false;
+        f_stopping = true;
+
+        f_drainer->join();
+        delete f_drainer;
+        f_drainer = NULL;
+    }
+
+    void Logger::flush()
+    {
+        if (f_async) {
+            drain();
+        }
+    }
+
+    LogLine::LogLine(const char* level, const char* file, int line, const char* function)
+        : f_level(level)
+        , f_file(file)
+        , f_line(line)
+        , f_function(function)
+        , f_thread_log(Logger::INSTANCE().thread_log())
+        , f_os(NULL)
+        , f_owned(false)
+    {
+        if (f_thread_log.busy) {
+            f_os = new std::ostringstream();
+            f_owned = true;
+        } else {
+            f_thread_log.busy = true;
+
+            /* no state left by the last line */
+            f_os = &f_thread_log.os;
+            f_os->str(std::string());
+            f_os->clear();
+            f_os->flags(std::ios_base::dec | std::ios_base::skipws);
+            f_os->precision(6);
+            f_os->fill(' ');
+        }
+    }
+
+    LogLine::~LogLine()
+    {
+        Logger::INSTANCE().commit(f_level, f_file, f_line, f_function, f_os->str());
+
+        if (f_owned) {
+            delete f_os;
+        } else {
+            f_thread_log.busy = false;
+        }
+    }
+
+}; // namespace utils
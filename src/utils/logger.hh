@@ -0,0 +1,179 @@
+/**
+ * @file logger.hh
+ * @brief Logging support, logger backend
+ *
+ * This header file contains the declarations of the backend of the
+ * logging macros (see logging.hh). Lines are formatted by the threads
+ * issuing them, with a monotonic timestamp and the tag of the thread
+ * (e.g. the strategy it runs), and written whole: lines from
+ * concurrent threads do not mix. In asynchronous mode, lines are
+ * queued on lock-free per-thread rings instead, and written by a
+ * background thread in timestamp order.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef UTILS_LOGGER_H
+#define UTILS_LOGGER_H
+
+#include <atomic>
+#include <ctime>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <3rdparty/ezlogger/ezlogger_verbosity_level_policy.hpp>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+namespace utils {
+
+    class LogRing;
+    struct ThreadLog;
+
+    typedef class Logger* Logger_ptr;
+
+    class Logger {
+    public:
+        static Logger& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static Logger_ptr instance { new Logger() };
+            return *instance;
+        }
+
+        /* lines above the level are dropped, before being formatted */
+        inline bool enabled(axter::verbosity level) const
+        {
+            return level <= f_level.load(std::memory_order_relaxed);
+        }
+
+        inline void set_level(axter::verbosity level)
+        {
+            f_level = level;
+        }
+
+        /* from now on, lines are queued and written by a background
+           thread. Stopping writes the lines queued so far */
+        void start_async();
+        void stop_async();
+
+        /* returns once the lines queued so far are written, a no-op
+           unless asynchronous */
+        void flush();
+
+        /* the tag of the calling thread's lines, `t<n>` by default */
+        void set_tag(const std::string& tag);
+        std::string tag();
+
+        /* a line issued by the calling thread, level is the prefix
+           of its kind (e.g. "T :: ") */
+        void commit(const char* level, const char* file, int line,
+                    const char* function, const std::string& text);
+
+    protected:
+        Logger();
+        ~Logger();
+
+    private:
+        friend class LogLine;
+
+        std::atomic<axter::verbosity> f_level;
+
+        /* timestamps are relative to this */
+        struct timespec f_epoch;
+
+        /* per-thread state, rings outlive their thread until drained */
+        boost::thread_specific_ptr<ThreadLog> f_thread_log;
+        std::atomic<unsigned> f_threads;
+        ThreadLog& thread_log();
+
+        /* rings are consumed under f_drain_mutex, lines are written
+           under f_write_mutex */
+        boost::mutex f_rings_mutex;
+        std::vector<LogRing*> f_rings;
+        boost::mutex f_drain_mutex;
+        boost::mutex f_write_mutex;
+
+        std::atomic<bool> f_async;
+        std::atomic<bool> f_stopping;
+        boost::thread* f_drainer;
+
+        std::ostream& f_os;
+
+        void drainer();
+        size_t drain();
+    };
+
+    /* a line being formatted, committed on destruction */
+    class LogLine {
+    public:
+        LogLine(const char* level, const char* file, int line, const char* function);
+        ~LogLine();
+
+        template <typename T>
+        inline LogLine& operator<<(T& data)
+        {
+            (*f_os) << data;
+            return *this;
+        }
+
+        template <typename T>
+        inline LogLine& operator<<(const T& data)
+        {
+            (*f_os) << data;
+            return *this;
+        }
+
+        inline LogLine& operator<<(std::ostream& (*manip)(std::ostream&) )
+        {
+            (*f_os) << manip;
+            return *this;
+        }
+
+    private:
+        /* non-copyable */
+        LogLine(const LogLine&);
+        LogLine& operator=(const LogLine&);
+
+        const char* f_level;
+        const char* f_file;
+        int f_line;
+        const char* f_function;
+
+        /* the thread's buffer, a private one for lines formatted
+           while formatting another one */
+        ThreadLog& f_thread_log;
+        std::ostringstream* f_os;
+        bool f_owned;
+    };
+
+    /* turns a line into a void expression, for the conditional in
+       the logging macros */
+    struct LogVoidify {
+        inline void operator&(LogLine&)
+        {}
+    };
+
+}; // namespace utils
+
+#endif /* UTILS_LOGGER_H */
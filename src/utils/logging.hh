@@ -36,6 +36,8 @@
 
 #include <common/strings.hh>
 
+#include <utils/logger.hh>
+
 namespace axter {
     // custom format
     class ezlogger_format_policy  {
@@ -72,29 +74,42 @@ namespace axter {
 #include <3rdparty/ezlogger/ezlogger.hpp>
 #include <3rdparty/ezlogger/ezlogger_macros.hpp>
 
+/* Lines are only formatted when enabled, the arguments of the lines
+   dropped are not evaluated. DEBUG and DRIVEL lines are compiled out
+   of release builds (NDEBUG), or if YASMV_NO_DEBUG_LOGS is defined */
+#define YASMV_LOG(level, prefix)                                    \
+    !utils::Logger::INSTANCE().enabled(level)                       \
+        ? (void) 0                                                  \
+        : utils::LogVoidify() &                                     \
+              utils::LogLine(prefix, __FILE__, __LINE__, __FUNCTION__)
+
+#if defined(NDEBUG) || defined(YASMV_NO_DEBUG_LOGS)
+#define YASMV_DEBUG_LOG(level, prefix)                              \
+    true                                                            \
+        ? (void) 0                                                  \
+        : utils::LogVoidify() &                                     \
+              utils::LogLine(prefix, __FILE__, __LINE__, __FUNCTION__)
+#else
+#define YASMV_DEBUG_LOG(level, prefix) YASMV_LOG(level, prefix)
+#endif
+
 // custom loggers
 #define ERR                                                     \
-    EZLOGGERVLSTREAM2(axter::log_verbosity_not_set, std::cerr)  \
-    << "E :: "
+    YASMV_LOG(axter::log_verbosity_not_set, "E :: ")
 
-#define WARN                                            \
-    EZLOGGERVLSTREAM2(axter::log_always, std::cerr)     \
-    << "W :: "
+#define WARN                                                    \
+    YASMV_LOG(axter::log_always, "W :: ")
 
-#define TRACE                                           \
-    EZLOGGERVLSTREAM2(axter::log_often, std::cerr)      \
-    << "T :: "
+#define TRACE                                                   \
+    YASMV_LOG(axter::log_often, "T :: ")
 
-#define INFO                                            \
-    EZLOGGERVLSTREAM2(axter::log_regularly, std::cerr)  \
-    << "I :: "
+#define INFO                                                    \
+    YASMV_LOG(axter::log_regularly, "I :: ")
 
-#define DEBUG                                           \
-    EZLOGGERVLSTREAM2(axter::log_rarely, std::cerr)     \
-    << "D :: "
+#define DEBUG                                                   \
+    YASMV_DEBUG_LOG(axter::log_rarely, "D :: ")
 
-#define DRIVEL                                              \
-    EZLOGGERVLSTREAM2(axter::log_very_rarely, std::cerr)    \
-    << "V :: "
+#define DRIVEL                                                  \
+    YASMV_DEBUG_LOG(axter::log_very_rarely, "V :: ")
 
 #endif /* LOGGING_H */
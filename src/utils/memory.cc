@@ -0,0 +1,108 @@
+/**
+ * @file memory.cc
+ * @brief Generic utils module, memory accounting implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <memory.hh>
+#include <profile.hh>
+
+#include <fstream>
+#include <unistd.h>
+
+namespace utils {
+
+    void MemorySample::merge(const MemorySample& other)
+    {
+        if (rss_kb < other.rss_kb) {
+            rss_kb = other.rss_kb;
+        }
+        if (peak_rss_kb < other.peak_rss_kb) {
+            peak_rss_kb = other.peak_rss_kb;
+        }
+
+        for (const auto& entry : other.usage) {
+            MemoryUsage::iterator eye { usage.begin() };
+            while (usage.end() != eye && eye->first != entry.first) {
+                ++eye;
+            }
+
+            if (usage.end() == eye) {
+                usage.push_back(entry);
+            } else if (eye->second < entry.second) {
+                eye->second = entry.second;
+            }
+        }
+    }
+
+    MemoryMgr::MemoryMgr()
+    {}
+
+    MemoryMgr::~MemoryMgr()
+    {}
+
+    void MemoryMgr::add_probe(const std::string& subsystem, MemoryProbe probe)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_probes.push_back(std::make_pair(subsystem, probe));
+    }
+
+    MemorySample MemoryMgr::sample()
+    {
+        std::vector<std::pair<std::string, MemoryProbe>> probes;
+        {
+            boost::mutex::scoped_lock lock { f_mutex };
+            probes = f_probes;
+        }
+
+        MemorySample res;
+        res.rss_kb = rss_kb();
+        res.peak_rss_kb = Profiler::peak_rss_kb();
+
+        for (const auto& probe : probes) {
+            res.usage.push_back(std::make_pair(probe.first, probe.second()));
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+        f_peaks.merge(res);
+
+        return res;
+    }
+
+    MemorySample MemoryMgr::peaks()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_peaks;
+    }
+
+    long MemoryMgr::rss_kb()
+    {
+        /* size and resident pages, see proc(5) */
+        std::ifstream statm { "/proc/self/statm" };
+        long size, resident;
+
+        if (!(statm >> size >> resident)) {
+            return 0;
+        }
+
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+}; // namespace utils
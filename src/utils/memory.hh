@@ -0,0 +1,121 @@
+/**
+ * @file memory.hh
+ * @brief Generic utils module, memory accounting
+ *
+ * This header file contains the declarations of the memory accounting
+ * registry. Subsystems (the expr pool, the DD managers, the SAT
+ * engines, the witnesses) register a probe on initialization, each
+ * probe estimates the bytes its subsystem takes. Probes are sampled on
+ * demand (e.g. by `mem-stats`, or after each solve when tracking
+ * memory per unrolling step), peaks are those of the samples.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef UTILS_MEMORY_H
+#define UTILS_MEMORY_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace utils {
+
+    /* bytes taken by a subsystem, an estimate. Probes may be called
+       while their subsystem is running in other threads */
+    typedef boost::function<size_t()> MemoryProbe;
+
+    /* bytes by subsystem, in order of registration */
+    typedef std::vector<std::pair<std::string, size_t>> MemoryUsage;
+
+    struct MemorySample {
+        MemorySample()
+            : rss_kb(0)
+            , peak_rss_kb(0)
+        {}
+
+        /* resident set size of the process, and its peak, in KB */
+        long rss_kb;
+        long peak_rss_kb;
+
+        MemoryUsage usage;
+
+        /* the larger of each figure, subsystems missing here are
+           appended */
+        void merge(const MemorySample& other);
+    };
+
+    typedef class MemoryMgr* MemoryMgr_ptr;
+
+    class MemoryMgr {
+    public:
+        static MemoryMgr& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static MemoryMgr_ptr instance { new MemoryMgr() };
+            return *instance;
+        }
+
+        void add_probe(const std::string& subsystem, MemoryProbe probe);
+
+        /* calls all probes, peaks are updated */
+        MemorySample sample();
+
+        /* the peaks of the samples taken so far */
+        MemorySample peaks();
+
+        /* resident set size of the process, in KB */
+        static long rss_kb();
+
+    protected:
+        MemoryMgr();
+        ~MemoryMgr();
+
+    private:
+        std::vector<std::pair<std::string, MemoryProbe>> f_probes;
+        MemorySample f_peaks;
+
+        /* probes are not called with this held, they may take locks
+           of their own */
+        boost::mutex f_mutex;
+    };
+
+    /* an estimate of the bytes taken by a node-based hash container:
+       one node per entry (the value and a link), one link per bucket */
+    template <typename Map>
+    inline size_t hash_bytes(const Map& map)
+    {
+        return map.size() * (sizeof(typename Map::value_type) + sizeof(void*)) +
+               map.bucket_count() * sizeof(void*);
+    }
+
+    /* an estimate of the bytes taken by a vector's storage */
+    template <typename Vector>
+    inline size_t vector_bytes(const Vector& vector)
+    {
+        return vector.capacity() * sizeof(typename Vector::value_type);
+    }
+
+}; // namespace utils
+
+#endif /* UTILS_MEMORY_H */
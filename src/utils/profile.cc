@@ -0,0 +1,129 @@
+/**
+ * @file profile.cc
+ * @brief Generic utils module, profiling registry implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <profile.hh>
+
+#include <sys/resource.h>
+
+namespace utils {
+
+    static inline double elapsed(const struct timespec& t0, const struct timespec& t1)
+    {
+        return (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+    }
+
+    Profiler::Profiler()
+        : f_enabled(false)
+    {}
+
+    Profiler::~Profiler()
+    {}
+
+    void Profiler::enable()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_phases.clear();
+        f_enabled = true;
+    }
+
+    void Profiler::disable()
+    {
+        f_enabled = false;
+    }
+
+    void Profiler::charge(const std::string& phase, double wall_secs, double cpu_secs)
+    {
+        if (!f_enabled) {
+            return;
+        }
+
+        long rss { peak_rss_kb() };
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        /* a handful of phases, a linear scan keeps them in order */
+        Phases::iterator eye { f_phases.begin() };
+        while (f_phases.end() != eye && eye->first != phase) {
+            ++eye;
+        }
+        if (f_phases.end() == eye) {
+            f_phases.push_back(std::make_pair(phase, PhaseStats()));
+            eye = f_phases.end() - 1;
+        }
+
+        PhaseStats& stats { eye->second };
+        ++stats.count;
+        stats.wall_secs += wall_secs;
+        stats.cpu_secs += cpu_secs;
+        if (stats.peak_rss_kb < rss) {
+            stats.peak_rss_kb = rss;
+        }
+    }
+
+    Phases Profiler::phases()
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+        return f_phases;
+    }
+
+    long Profiler::peak_rss_kb()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage)) {
+            return 0;
+        }
+
+        return usage.ru_maxrss;
+    }
+
+    ProfileScope::ProfileScope(const char* phase, const std::string& detail)
+        : f_active(Profiler::INSTANCE().enabled())
+    {
+        if (!f_active) {
+            return;
+        }
+
+        f_phase = phase;
+        if (!detail.empty()) {
+            f_phase += " (" + detail + ")";
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &f_wall);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &f_cpu);
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        if (!f_active) {
+            return;
+        }
+
+        struct timespec wall, cpu;
+        clock_gettime(CLOCK_MONOTONIC, &wall);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+
+        Profiler::INSTANCE().charge(f_phase, elapsed(f_wall, wall), elapsed(f_cpu, cpu));
+    }
+
+}; // namespace utils
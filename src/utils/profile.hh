@@ -0,0 +1,127 @@
+/**
+ * @file profile.hh
+ * @brief Generic utils module, profiling registry
+ *
+ * This header file contains the declarations of a lightweight
+ * profiling registry, fed by the subsystems (parsing, analysis,
+ * compilation, CNF generation, microcode loading, solving, witness
+ * extraction, output). Phases are only recorded while the registry is
+ * enabled, e.g. by `time <command>`: otherwise a profiling scope costs
+ * a flag test.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef UTILS_PROFILE_H
+#define UTILS_PROFILE_H
+
+#include <atomic>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+namespace utils {
+
+    /* totals of one profiled phase */
+    struct PhaseStats {
+        PhaseStats()
+            : count(0)
+            , wall_secs(0.0)
+            , cpu_secs(0.0)
+            , peak_rss_kb(0)
+        {}
+
+        unsigned long count;
+        double wall_secs;
+
+        /* CPU time of the threads running the phase */
+        double cpu_secs;
+
+        /* peak resident set size of the process at the end of the
+           phase, in KB */
+        long peak_rss_kb;
+    };
+
+    /* phases, in order of first occurrence */
+    typedef std::vector<std::pair<std::string, PhaseStats>> Phases;
+
+    typedef class Profiler* Profiler_ptr;
+
+    class Profiler {
+    public:
+        static Profiler& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static Profiler_ptr instance { new Profiler() };
+            return *instance;
+        }
+
+        inline bool enabled() const
+        {
+            return f_enabled;
+        }
+
+        /* phases recorded so far are dropped on enabling */
+        void enable();
+        void disable();
+
+        /* charges one occurrence of phase */
+        void charge(const std::string& phase, double wall_secs, double cpu_secs);
+
+        Phases phases();
+
+        /* peak resident set size of the process, in KB */
+        static long peak_rss_kb();
+
+    protected:
+        Profiler();
+        ~Profiler();
+
+    private:
+        std::atomic<bool> f_enabled;
+
+        boost::mutex f_mutex;
+        Phases f_phases;
+    };
+
+    /* charges the wall and thread CPU time of its lifetime to a phase
+       (e.g. "solve" and the engine name), if profiling is enabled */
+    class ProfileScope {
+    public:
+        ProfileScope(const char* phase, const std::string& detail = std::string());
+        ~ProfileScope();
+
+    private:
+        /* non-copyable */
+        ProfileScope(const ProfileScope&);
+        ProfileScope& operator=(const ProfileScope&);
+
+        bool f_active;
+        std::string f_phase;
+
+        struct timespec f_wall;
+        struct timespec f_cpu;
+    };
+
+}; // namespace utils
+
+#endif /* UTILS_PROFILE_H */
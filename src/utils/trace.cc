@@ -0,0 +1,178 @@
+/**
+ * @file trace.cc
+ * @brief Generic utils module, trace events implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <fstream>
+
+#include <trace.hh>
+#include <logger.hh>
+
+#include <jsoncpp/json/json.h>
+
+namespace utils {
+
+    EventTracer::EventTracer()
+        : f_enabled(false)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &f_epoch);
+    }
+
+    EventTracer::~EventTracer()
+    {}
+
+    void EventTracer::enable(const std::string& path)
+    {
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        f_path = path;
+        f_events.clear();
+        f_tids.clear();
+        clock_gettime(CLOCK_MONOTONIC, &f_epoch);
+
+        f_enabled = true;
+    }
+
+    long long EventTracer::usecs(const struct timespec& t) const
+    {
+        return 1000000LL * (t.tv_sec - f_epoch.tv_sec) +
+               (t.tv_nsec - f_epoch.tv_nsec) / 1000;
+    }
+
+    void EventTracer::complete(const std::string& name, const char* category,
+                               const struct timespec& t0, const struct timespec& t1,
+                               const std::string& engine, long step)
+    {
+        if (!f_enabled) {
+            return;
+        }
+
+        ThreadKey key { boost::this_thread::get_id(), Logger::INSTANCE().tag() };
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        std::map<ThreadKey, unsigned>::const_iterator eye { f_tids.find(key) };
+        unsigned tid;
+        if (f_tids.end() == eye) {
+            tid = 1 + f_tids.size();
+            f_tids.insert(std::make_pair(key, tid));
+        } else {
+            tid = eye->second;
+        }
+
+        TraceEvent event;
+        event.name = name;
+        event.category = category;
+        event.tid = tid;
+        event.ts = usecs(t0);
+        event.dur = usecs(t1) - event.ts;
+        event.engine = engine;
+        event.step = step;
+
+        f_events.push_back(event);
+    }
+
+    bool EventTracer::write()
+    {
+        if (!f_enabled) {
+            return true;
+        }
+
+        boost::mutex::scoped_lock lock { f_mutex };
+
+        Json::Value lst { Json::arrayValue };
+
+        /* thread names first */
+        for (const auto& pair : f_tids) {
+            Json::Value obj;
+            obj["name"] = "thread_name";
+            obj["ph"] = "M";
+            obj["pid"] = 1;
+            obj["tid"] = pair.second;
+            obj["args"]["name"] = pair.first.second;
+
+            lst.append(obj);
+        }
+
+        for (const auto& event : f_events) {
+            Json::Value obj;
+            obj["name"] = event.name;
+            obj["cat"] = event.category;
+            obj["ph"] = "X";
+            obj["pid"] = 1;
+            obj["tid"] = event.tid;
+            obj["ts"] = Json::Int64(event.ts);
+            obj["dur"] = Json::Int64(event.dur);
+
+            if (!event.engine.empty()) {
+                obj["args"]["engine"] = event.engine;
+            }
+            if (0 <= event.step) {
+                obj["args"]["k"] = Json::Int64(event.step);
+            }
+
+            lst.append(obj);
+        }
+
+        Json::Value root;
+        root["traceEvents"] = lst;
+        root["displayTimeUnit"] = "ms";
+
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+
+        std::ofstream os { f_path.c_str() };
+        os
+            << Json::writeString(builder, root)
+            << std::endl;
+
+        return !os.fail();
+    }
+
+    TraceScope::TraceScope(const char* name, const char* category,
+                           const std::string& engine, long step)
+        : f_active(EventTracer::INSTANCE().enabled())
+        , f_name(name)
+        , f_category(category)
+        , f_step(step)
+    {
+        if (!f_active) {
+            return;
+        }
+
+        f_engine = engine;
+        clock_gettime(CLOCK_MONOTONIC, &f_start);
+    }
+
+    TraceScope::~TraceScope()
+    {
+        if (!f_active) {
+            return;
+        }
+
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        EventTracer::INSTANCE().complete(f_name, f_category, f_start, end,
+                                         f_engine, f_step);
+    }
+
+}; // namespace utils
@@ -0,0 +1,131 @@
+/**
+ * @file trace.hh
+ * @brief Generic utils module, trace events
+ *
+ * This header file contains the declarations of a recorder of timed
+ * spans (compiler passes, CNF pushes, SAT solves, microcode loads,
+ * reachability steps), written in the Chrome trace event format at
+ * exit (e.g. to be loaded into Perfetto or chrome://tracing). Spans
+ * are laid out by thread, named after the thread (or strategy)
+ * logging tag. Spans are only recorded while the recorder is
+ * enabled: otherwise a trace scope costs a flag test.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef UTILS_TRACE_H
+#define UTILS_TRACE_H
+
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace utils {
+
+    /* a complete span, times in usecs since the recorder was enabled */
+    struct TraceEvent {
+        std::string name;
+        const char* category;
+        unsigned tid;
+
+        long long ts;
+        long long dur;
+
+        /* engine instance name, and step (-1 if none) */
+        std::string engine;
+        long step;
+    };
+
+    typedef class EventTracer* EventTracer_ptr;
+
+    class EventTracer {
+    public:
+        static EventTracer& INSTANCE()
+        {
+            /* made on first use, concurrent first uses wait for it */
+            static EventTracer_ptr instance { new EventTracer() };
+            return *instance;
+        }
+
+        inline bool enabled() const
+        {
+            return f_enabled;
+        }
+
+        /* spans are recorded from now on, to be written to path */
+        void enable(const std::string& path);
+
+        /* writes the spans recorded so far, false on I/O errors */
+        bool write();
+
+        /* records the span [t0, t1) on the calling thread */
+        void complete(const std::string& name, const char* category,
+                      const struct timespec& t0, const struct timespec& t1,
+                      const std::string& engine = std::string(), long step = -1);
+
+    protected:
+        EventTracer();
+        ~EventTracer();
+
+    private:
+        std::atomic<bool> f_enabled;
+        std::string f_path;
+        struct timespec f_epoch;
+
+        boost::mutex f_mutex;
+        std::vector<TraceEvent> f_events;
+
+        /* one trace thread for each (thread, tag) pair, strategies
+           run by the same worker get a row each */
+        typedef std::pair<boost::thread::id, std::string> ThreadKey;
+        std::map<ThreadKey, unsigned> f_tids;
+
+        long long usecs(const struct timespec& t) const;
+    };
+
+    /* records its lifetime as a span, if tracing is enabled */
+    class TraceScope {
+    public:
+        TraceScope(const char* name, const char* category,
+                   const std::string& engine = std::string(), long step = -1);
+        ~TraceScope();
+
+    private:
+        /* non-copyable */
+        TraceScope(const TraceScope&);
+        TraceScope& operator=(const TraceScope&);
+
+        bool f_active;
+        const char* f_name;
+        const char* f_category;
+        std::string f_engine;
+        long f_step;
+
+        struct timespec f_start;
+    };
+
+}; // namespace utils
+
+#endif /* UTILS_TRACE_H */
@@ -0,0 +1,206 @@
+/**
+ * @file binary.cc
+ * @brief Binary trace format, implementation
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <sstream>
+
+#include <expr/expr_mgr.hh>
+#include <expr/printer/printer.hh>
+
+#include <witness/binary.hh>
+
+namespace witness {
+
+    const char* BIN_MAGIC { "yasmv-trace" };
+    const unsigned BIN_VERSION { 1 };
+
+    void write_varint(std::ostream& os, unsigned long long x)
+    {
+        do {
+            unsigned char byte { (unsigned char) (x & 0x7f) };
+            x >>= 7;
+            if (x) {
+                byte |= 0x80;
+            }
+            os.put(byte);
+        } while (x);
+    }
+
+    void write_string(std::ostream& os, const std::string& str)
+    {
+        write_varint(os, str.size());
+        os.write(str.data(), str.size());
+    }
+
+    void write_name(std::ostream& os, expr::Expr_ptr full)
+    {
+        std::ostringstream oss;
+        expr::Printer printer { oss };
+
+        printer << full;
+        write_string(os, oss.str());
+    }
+
+    /* constants are zigzag encoded, negatives stay short */
+    void write_binary_value(std::ostream& os, expr::Expr_ptr value)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (NULL == value) {
+            os.put(BIN_UNDEF);
+        } else if (em.is_identifier(value)) {
+            os.put(BIN_ATOM);
+            write_string(os, value->atom());
+        } else if (em.is_bool_const(value)) {
+            os.put(em.is_true(value) ? BIN_TRUE : BIN_FALSE);
+        } else if (em.is_constant(value)) {
+            value_t x { em.const_value(value) };
+
+            os.put(BIN_CONST);
+            write_varint(os, ((unsigned long long) x << 1) ^ (x < 0 ? ~0ULL : 0ULL));
+        } else if (em.is_array(value)) {
+            expr::ExprVector values { em.array_literals(value) };
+
+            os.put(BIN_ARRAY);
+            write_varint(os, values.size());
+            for (expr::ExprVector::const_iterator i = values.begin(); i != values.end(); ++i) {
+                write_binary_value(os, *i);
+            }
+        } else {
+            os.put(BIN_UNDEF);
+        }
+    }
+
+    /* value exprs are pooled, equal values are the same expr */
+    void write_binary_values(std::ostream& os, const expr::ExprVector& assignments,
+                             expr::ExprVector& previous)
+    {
+        previous.resize(assignments.size(), NULL);
+
+        for (unsigned i = 0; i < assignments.size(); ++i) {
+            expr::Expr_ptr value { assignments[i]->rhs() };
+
+            if (value == previous[i]) {
+                os.put(BIN_SAME);
+            } else {
+                write_binary_value(os, value);
+                previous[i] = value;
+            }
+        }
+    }
+
+    bool read_varint(std::istream& is, unsigned long long& res)
+    {
+        res = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            int byte { is.get() };
+            if (EOF == byte) {
+                return false;
+            }
+
+            res |= (unsigned long long) (byte & 0x7f) << shift;
+            if (0 == (byte & 0x80)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool read_string(std::istream& is, std::string& res)
+    {
+        unsigned long long size;
+        if (!read_varint(is, size)) {
+            return false;
+        }
+
+        res.resize(size);
+        return 0 == size || (bool) is.read(&res[0], size);
+    }
+
+    bool read_binary_value(std::istream& is, expr::Expr_ptr& res)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        switch (is.get()) {
+            case BIN_UNDEF:
+                res = NULL;
+                return true;
+
+            case BIN_FALSE:
+                res = em.make_false();
+                return true;
+
+            case BIN_TRUE:
+                res = em.make_true();
+                return true;
+
+            case BIN_CONST: {
+                unsigned long long x;
+                if (!read_varint(is, x)) {
+                    return false;
+                }
+
+                res = em.make_const((value_t) ((x >> 1) ^ (~(x & 1) + 1)));
+                return true;
+            }
+
+            case BIN_ATOM: {
+                std::string atom;
+                if (!read_string(is, atom)) {
+                    return false;
+                }
+
+                res = em.make_identifier(atom.c_str());
+                return true;
+            }
+
+            case BIN_ARRAY: {
+                unsigned long long n;
+                if (!read_varint(is, n) || 0 == n) {
+                    return false;
+                }
+
+                expr::ExprVector values;
+                for (unsigned long long i = 0; i < n; ++i) {
+                    expr::Expr_ptr value;
+                    if (!read_binary_value(is, value) || NULL == value) {
+                        return false;
+                    }
+                    values.push_back(value);
+                }
+
+                expr::Expr_ptr eye { values.back() };
+                for (unsigned i = values.size() - 1; 0 < i; --i) {
+                    eye = em.make_array_comma(values[i - 1], eye);
+                }
+
+                res = em.make_array(eye);
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+} // namespace witness
@@ -0,0 +1,79 @@
+/**
+ * @file binary.hh
+ * @brief Binary trace format
+ *
+ * This header file contains the declarations required to write and
+ * read the binary trace format (see dump-traces --format binary).
+ * The format is made of unsigned LEB128 varints, strings (length,
+ * then chars) and tagged values. After the magic come the number of
+ * traces and, for each trace: id, description, input names and
+ * values, the number of steps, state and define names, and the
+ * values of each step. Values equal to the ones in the step before
+ * are written as BIN_SAME.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef WITNESS_BINARY_H
+#define WITNESS_BINARY_H
+
+#include <iostream>
+#include <string>
+
+#include <expr/expr.hh>
+
+namespace witness {
+
+    extern const char* BIN_MAGIC;
+    extern const unsigned BIN_VERSION;
+
+    enum BinaryTag {
+        BIN_SAME = 0,
+        BIN_UNDEF,
+        BIN_FALSE,
+        BIN_TRUE,
+        BIN_CONST,
+        BIN_ATOM,
+        BIN_ARRAY,
+    };
+
+    void write_varint(std::ostream& os, unsigned long long x);
+    void write_string(std::ostream& os, const std::string& str);
+
+    /* the printed full name */
+    void write_name(std::ostream& os, expr::Expr_ptr full);
+
+    /* a value, NULL is BIN_UNDEF */
+    void write_binary_value(std::ostream& os, expr::Expr_ptr value);
+
+    /* the values of assignments (rhs), BIN_SAME for those equal to
+       the one in previous, which is updated */
+    void write_binary_values(std::ostream& os, const expr::ExprVector& assignments,
+                             expr::ExprVector& previous);
+
+    /* false on truncated or malformed input */
+    bool read_varint(std::istream& is, unsigned long long& res);
+    bool read_string(std::istream& is, std::string& res);
+
+    /* the value of a tag other than BIN_SAME, NULL for BIN_UNDEF */
+    bool read_binary_value(std::istream& is, expr::Expr_ptr& res);
+
+} // namespace witness
+
+#endif /* WITNESS_BINARY_H */
@@ -0,0 +1,163 @@
+/**
+ * @file decoder.cc
+ * @brief Witness module, lazy decoding of SAT models implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <decoder.hh>
+#include <witness_mgr.hh>
+
+#include <enc/enc_mgr.hh>
+
+#include <expr/collector.hh>
+
+#include <algorithm>
+#include <cstring>
+
+namespace witness {
+
+    ModelDecoder::ModelDecoder(Witness& w, model::Model& model, bool inputs)
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        symb::SymbIter si { model };
+        while (si.has_next()) {
+            std::pair<expr::Expr_ptr, symb::Symbol_ptr> pair { si.next() };
+            expr::Expr_ptr ctx { pair.first };
+            symb::Symbol_ptr symb { pair.second };
+            expr::Expr_ptr key { em.make_dot(ctx, symb->name()) };
+
+            w.add_symbol(key);
+
+            Entry entry { ctx, key, symb->format(), NULL, NULL };
+            if (symb->is_define()) {
+                entry.body = symb->as_define().body();
+            }
+
+            else if (symb->is_variable()) {
+                const symb::Variable& var { symb->as_variable() };
+
+                if (inputs || !var.is_input()) {
+                    entry.enc = bm.find_encoding(
+                        expr::TimedExpr(key, var.is_frozen() ? FROZEN : 0));
+                }
+
+                if (entry.enc) {
+                    dd::DDVector::const_iterator di;
+                    for (di = entry.enc->bits().begin(); entry.enc->bits().end() != di; ++di) {
+                        f_bits.push_back((*di).getNode()->index);
+                    }
+                }
+            }
+
+            int index { w.symbol_index(key) };
+            assert(-1 != index);
+
+            if ((int) f_entries.size() <= index) {
+                f_entries.resize(1 + index, Entry { NULL, NULL, FORMAT_DECIMAL, NULL, NULL });
+            }
+            f_entries[index] = entry;
+        }
+
+        std::sort(f_bits.begin(), f_bits.end());
+        f_bits.erase(std::unique(f_bits.begin(), f_bits.end()), f_bits.end());
+    }
+
+    ModelDecoder::~ModelDecoder()
+    {}
+
+    void ModelDecoder::capture(sat::Engine& engine, step_t time, std::vector<bool>& bits) const
+    {
+        enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+
+        bits.assign(bm.nbits(), false);
+        for (std::vector<unsigned>::const_iterator i = f_bits.begin(); i != f_bits.end(); ++i) {
+            unsigned bit { *i };
+            const enc::UCBI& ucbi { bm.find_ucbi(bit) };
+            const enc::TCBI tcbi { enc::TCBI(ucbi, time) };
+
+            Var var { engine.tcbi_to_var(tcbi) };
+            bits[bit] = engine.value(var); /* XXX: don't cares assigned to 0 */
+        }
+    }
+
+    void ModelDecoder::mark(expr::ExprMarker& marker) const
+    {
+        for (const auto& entry : f_entries) {
+            marker.mark(entry.ctx);
+            marker.mark(entry.key);
+            marker.mark(entry.body);
+        }
+    }
+
+    void ModelDecoder::decode(TimeFrame& tf, unsigned index)
+    {
+        if (f_entries.size() <= index) {
+            return;
+        }
+
+        const Entry& entry { f_entries[index] };
+
+        if (entry.enc) {
+            enc::EncodingMgr& bm { enc::EncodingMgr::INSTANCE() };
+
+            int inputs[bm.nbits()];
+            memset(inputs, 0, sizeof(inputs));
+
+            dd::DDVector::const_iterator di;
+            for (di = entry.enc->bits().begin(); entry.enc->bits().end() != di; ++di) {
+                unsigned bit { (*di).getNode()->index };
+                inputs[bit] = tf.bit(bit);
+            }
+
+            /* NULL values here indicate UNDEFs */
+            expr::Expr_ptr value { entry.enc->expr(inputs) };
+            if (value) {
+                tf.set_value(entry.key, value, entry.format);
+            }
+        }
+
+        else if (entry.body) {
+            WitnessMgr& wm { WitnessMgr::INSTANCE() };
+            Witness& w { tf.owner() };
+
+            try {
+                expr::Expr_ptr value {
+                    wm.eval(w, entry.ctx, entry.body, w.time_of(tf))
+                };
+
+                /* NULL values here indicate UNDEFs */
+                if (value) {
+                    tf.set_value(entry.key, value, entry.format);
+                }
+            }
+
+            catch (NoValue& nv) {
+                WARN
+                    << "Cannot evaluate define `"
+                    << entry.key
+                    << "`"
+                    << std::endl;
+            }
+        }
+    }
+
+} // namespace witness
@@ -0,0 +1,81 @@
+/**
+ * @file decoder.hh
+ * @brief Witness module, lazy decoding of SAT models
+ *
+ * This header file contains the declarations required to build the
+ * time frames of a witness from a SAT model, capturing the bits of
+ * the model eagerly and decoding the values of symbols only when they
+ * are first accessed.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef WITNESS_DECODER_H
+#define WITNESS_DECODER_H
+
+#include <vector>
+
+#include <enc/enc.hh>
+
+#include <model/model.hh>
+
+#include <sat/sat.hh>
+
+#include <witness/witness.hh>
+
+namespace witness {
+
+    class ModelDecoder : public FrameDecoder {
+    public:
+        /* adds the symbols of model to the language of w. INPUT vars
+           are decoded from the model iff inputs is true */
+        ModelDecoder(Witness& w, model::Model& model, bool inputs);
+        ~ModelDecoder();
+
+        /* the bits of the encodings in the SAT model at time, by DD
+           var index */
+        void capture(sat::Engine& engine, step_t time, std::vector<bool>& bits) const;
+
+        void decode(TimeFrame& tf, unsigned index);
+
+        void mark(expr::ExprMarker& marker) const;
+
+    private:
+        struct Entry {
+            expr::Expr_ptr ctx;
+            expr::Expr_ptr key;
+            value_format_t format;
+
+            /* NULL for vars */
+            expr::Expr_ptr body;
+
+            /* NULL for defines, and vars not in COI */
+            enc::Encoding_ptr enc;
+        };
+
+        /* by symbol index */
+        std::vector<Entry> f_entries;
+
+        /* DD var indexes of all the encodings */
+        std::vector<unsigned> f_bits;
+    };
+
+} // namespace witness
+
+#endif /* WITNESS_DECODER_H */
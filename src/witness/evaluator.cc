@@ -33,7 +33,9 @@
 namespace witness {
 
     Evaluator::Evaluator(WitnessMgr& owner)
-        : f_owner(owner)
+        : f_inputs(false)
+        , f_time(0)
+        , f_owner(owner)
     {
         const void* instance { this };
         DRIVEL
@@ -58,6 +60,10 @@ namespace witness {
         f_ctx_stack.clear();
         f_time_stack.clear();
         f_te2v_map.clear();
+
+        f_support.clear();
+        f_support_values.clear();
+        f_inputs = false;
     }
 
     expr::Expr_ptr Evaluator::process(Witness_ptr witness,
@@ -77,6 +83,7 @@ namespace witness {
 
         // toplevel (time is assumed at 0, arbitrarily nested next allowed)
         f_time_stack.push_back(time);
+        f_time = time;
 
         /* Invoke walker on the body of the expr to be processed */
         (*this)(body);
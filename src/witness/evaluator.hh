@@ -30,6 +30,7 @@
 #include <expr/time/timed_expr.hh>
 #include <expr/walker/walker.hh>
 
+#include <witness/program.hh>
 #include <witness/witness.hh>
 
 #include <utils/time.hh>
@@ -56,6 +57,15 @@ namespace witness {
 
         TimedExprValueMap f_te2v_map;
 
+        /* the vars loaded by the last evaluation, with their values,
+           and whether inputs were involved */
+        Support f_support;
+        expr::ExprVector f_support_values;
+        bool f_inputs;
+
+        /* the time of the evaluation */
+        step_t f_time;
+
     public:
         Evaluator(WitnessMgr& owner);
         virtual ~Evaluator();
@@ -65,6 +75,21 @@ namespace witness {
 			       expr::Expr_ptr body,
 			       step_t time);
 
+        inline const Support& support() const
+        {
+            return f_support;
+        }
+
+        inline const expr::ExprVector& support_values() const
+        {
+            return f_support_values;
+        }
+
+        inline bool inputs() const
+        {
+            return f_inputs;
+        }
+
     protected:
         inline WitnessMgr& owner() const
         {
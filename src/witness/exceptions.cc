@@ -122,4 +122,22 @@ namespace witness {
                            build_unknown_identifier_error_message(id))
     {}
 
+    static std::string build_spill_error_message(expr::Atom id, const std::string& reason)
+    {
+        std::ostringstream oss;
+
+        oss
+            << "Could not restore `"
+            << id
+            << "`: "
+            << reason;
+
+        return oss.str();
+    }
+
+    SpillError::SpillError(expr::Atom id, const std::string& reason)
+        : WitnessException("SpillError",
+                           build_spill_error_message(id, reason))
+    {}
+
 } // namespace witness
@@ -73,6 +73,12 @@ namespace witness {
         UnknownIdentifier(expr::Expr_ptr id);
     };
 
+    /** Raised when the frames of a spilled witness can not be read back */
+    class SpillError: public WitnessException {
+    public:
+        SpillError(expr::Atom id, const std::string& reason);
+    };
+
 } // namespace witness
 
 #endif /* WITNESS_EXCEPTIONS_H */
@@ -21,6 +21,8 @@
  *
  **/
 
+#include <algorithm>
+
 #include <env/environment.hh>
 #include <symb/proxy.hh>
 #include <witness/evaluator.hh>
@@ -183,10 +185,18 @@ namespace witness {
 
             else if (var.is_input()) {
                 push_value(env::Environment::INSTANCE().get(expr));
+                f_inputs = true;
             }
 
             else if (f_witness->has_value(full, time)) {
-                push_value(f_witness->value(full, time));
+                expr::Expr_ptr value { f_witness->value(full, time) };
+                push_value(value);
+
+                std::pair<expr::Expr_ptr, step_t> entry { full, time - f_time };
+                if (f_support.end() == std::find(f_support.begin(), f_support.end(), entry)) {
+                    f_support.push_back(entry);
+                    f_support_values.push_back(value);
+                }
             }
 
             else {
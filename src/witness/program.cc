@@ -0,0 +1,804 @@
+/**
+ * @file program.cc
+ * @brief Compiled expr evaluator implementation.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <algorithm>
+
+#include <common/common.hh>
+
+#include <env/environment.hh>
+
+#include <expr/expr.hh>
+#include <expr/expr_mgr.hh>
+
+#include <opts/opts_mgr.hh>
+
+#include <symb/classes.hh>
+#include <symb/proxy.hh>
+
+#include <type/type_mgr.hh>
+
+#include <witness/program.hh>
+
+/* defines are inlined, this bounds the size of a program */
+static const unsigned max_program_size { 1 << 16 };
+
+namespace witness {
+
+    /* scalar value of a witness value, false if not scalar */
+    static bool scalar_value(expr::Expr_ptr expr, value_t& res)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (em.is_true(expr)) {
+            res = 1;
+            return true;
+        }
+
+        if (em.is_false(expr)) {
+            res = 0;
+            return true;
+        }
+
+        if (em.is_identifier(expr)) {
+            symb::ResolverProxy resolver;
+            symb::Symbol_ptr symb {
+                resolver.symbol(em.make_dot(em.make_empty(), expr))
+            };
+
+            if (!symb->is_literal()) {
+                return false;
+            }
+
+            res = symb->as_literal().value();
+            return true;
+        }
+
+        if (em.is_constant(expr)) {
+            res = expr->value();
+            return true;
+        }
+
+        if (em.is_neg(expr) && em.is_constant(expr->lhs())) {
+            res = -expr->lhs()->value();
+            return true;
+        }
+
+        return false;
+    }
+
+    Program::Program()
+        : f_type(NULL)
+        , f_inputs(false)
+        , f_depth(0)
+        , f_max_depth(0)
+    {}
+
+    Program_ptr Program::compile(expr::Expr_ptr ctx, expr::Expr_ptr body)
+    {
+        Program_ptr res { new Program() };
+        type::Type_ptr type { NULL };
+
+        bool ok { false };
+        try {
+            ok = res->compile_expr(ctx, body, 0, type);
+        } catch (Exception& e) {
+            /* e.g. unresolved symbols, left to the walker */
+        }
+
+        if (!ok || res->f_instrs.size() > max_program_size ||
+            !(type->is_boolean() || type->is_enum() || type->is_algebraic())) {
+            delete res;
+            return NULL;
+        }
+
+        res->f_type = type;
+        res->f_stack.reserve(res->f_max_depth);
+
+        return res;
+    }
+
+    value_t Program::support_index(expr::Expr_ptr full, step_t offset)
+    {
+        std::pair<expr::Expr_ptr, step_t> entry { full, offset };
+
+        Support::const_iterator i { std::find(f_support.begin(), f_support.end(), entry) };
+        if (f_support.end() != i) {
+            return i - f_support.begin();
+        }
+
+        f_support.push_back(entry);
+        return f_support.size() - 1;
+    }
+
+    bool support_values(Witness& w, step_t time, const Support& support,
+                        expr::ExprVector& values)
+    {
+        values.clear();
+        for (Support::const_iterator i = support.begin(); i != support.end(); ++i) {
+            step_t at { time + i->second };
+            if (!w.has_value(i->first, at)) {
+                return false;
+            }
+
+            values.push_back(w.value(i->first, at));
+        }
+
+        return true;
+    }
+
+    void Program::emit(instr_t op, value_t value, expr::Expr_ptr expr, step_t offset)
+    {
+        Instr instr { op, value, expr, offset };
+        f_instrs.push_back(instr);
+
+        /* leaves push, unary ops replace, binary ops pop one, ITE
+           pops two */
+        switch (op) {
+            case INSTR_CONST:
+            case INSTR_LOAD:
+            case INSTR_INPUT:
+                ++f_depth;
+                break;
+
+            case INSTR_NEG:
+            case INSTR_NOT:
+            case INSTR_BW_NOT:
+                break;
+
+            case INSTR_ITE:
+                f_depth -= 2;
+                break;
+
+            default:
+                --f_depth;
+        }
+
+        if (f_max_depth < f_depth) {
+            f_max_depth = f_depth;
+        }
+    }
+
+    bool Program::compile_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t offset,
+                               type::Type_ptr& type)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+
+        if (em.is_bool_const(expr)) {
+            type = tm.find_boolean();
+            emit(INSTR_CONST, em.is_true(expr) ? 1 : 0);
+            return true;
+        }
+
+        if (em.is_int_const(expr)) {
+            type = tm.find_unsigned(opts::OptsMgr::INSTANCE().word_width());
+            emit(INSTR_CONST, expr->value());
+            return true;
+        }
+
+        if (!em.is_identifier(expr)) {
+            return false;
+        }
+
+        symb::ResolverProxy resolver;
+
+        expr::Expr_ptr full { em.make_dot(ctx, expr) };
+        symb::Symbol_ptr symb { resolver.symbol(full) };
+
+        if (symb->is_literal()) {
+            symb::Literal& lit { symb->as_literal() };
+
+            type = lit.type();
+            emit(INSTR_CONST, lit.value());
+            return true;
+        }
+
+        if (symb->is_variable()) {
+            symb::Variable& var { symb->as_variable() };
+
+            type = var.type();
+            if (!type->is_scalar()) {
+                return false;
+            }
+
+            if (var.is_input()) {
+                emit(INSTR_INPUT, 0, expr);
+                f_inputs = true;
+            } else {
+                emit(INSTR_LOAD, support_index(full, offset), full, offset);
+            }
+
+            return true;
+        }
+
+        if (symb->is_define()) {
+            return compile_expr(ctx, symb->as_define().body(), offset, type);
+        }
+
+        /* parameters, among others */
+        return false;
+    }
+
+    bool Program::compile_expr(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t offset,
+                               type::Type_ptr& type)
+    {
+        type::TypeMgr& tm { type::TypeMgr::INSTANCE() };
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (max_program_size < f_instrs.size()) {
+            return false;
+        }
+
+        type::Type_ptr lhs_type { NULL };
+        type::Type_ptr rhs_type { NULL };
+
+        instr_t op;
+        switch (expr->symb()) {
+            /* time shifts */
+            case expr::NEXT:
+                return compile_expr(ctx, expr->lhs(), offset + 1, type);
+
+            case expr::AT:
+                if (!em.is_instant(expr->lhs())) {
+                    return false;
+                }
+                return compile_expr(ctx, expr->rhs(), offset + expr->lhs()->value(), type);
+
+            case expr::DOT:
+                return compile_expr(em.make_dot(ctx, expr->lhs()), expr->rhs(), offset, type);
+
+            /* unary, same type */
+            case expr::NEG:
+                op = INSTR_NEG;
+                goto unary;
+            case expr::NOT:
+                op = INSTR_NOT;
+                goto unary;
+            case expr::BW_NOT:
+                op = INSTR_BW_NOT;
+                goto unary;
+            unary:
+                if (!compile_expr(ctx, expr->lhs(), offset, type)) {
+                    return false;
+                }
+                emit(op);
+                return true;
+
+            /* binary, lhs type */
+            case expr::PLUS:
+                op = INSTR_ADD;
+                goto binary;
+            case expr::SUB:
+                op = INSTR_SUB;
+                goto binary;
+            case expr::DIV:
+                op = INSTR_DIV;
+                goto binary;
+            case expr::MUL:
+                op = INSTR_MUL;
+                goto binary;
+            case expr::MOD:
+                op = INSTR_MOD;
+                goto binary;
+            case expr::AND:
+                op = INSTR_AND;
+                goto binary;
+            case expr::OR:
+                op = INSTR_OR;
+                goto binary;
+            case expr::IMPLIES:
+                op = INSTR_IMPLIES;
+                goto binary;
+            case expr::BW_AND:
+                op = INSTR_BW_AND;
+                goto binary;
+            case expr::BW_OR:
+                op = INSTR_BW_OR;
+                goto binary;
+            case expr::BW_XOR:
+                op = INSTR_BW_XOR;
+                goto binary;
+            case expr::BW_XNOR:
+                op = INSTR_BW_XNOR;
+                goto binary;
+            case expr::LSHIFT:
+                op = INSTR_LSHIFT;
+                goto binary;
+            case expr::RSHIFT:
+                op = INSTR_RSHIFT;
+                goto binary;
+            binary:
+                if (!compile_expr(ctx, expr->lhs(), offset, lhs_type) ||
+                    !compile_expr(ctx, expr->rhs(), offset, rhs_type)) {
+                    return false;
+                }
+                emit(op);
+                type = lhs_type;
+                return true;
+
+            /* relational, boolean */
+            case expr::EQ:
+                op = INSTR_EQ;
+                goto relational;
+            case expr::NE:
+                op = INSTR_NE;
+                goto relational;
+            case expr::GE:
+                op = INSTR_GE;
+                goto relational;
+            case expr::GT:
+                op = INSTR_GT;
+                goto relational;
+            case expr::LE:
+                op = INSTR_LE;
+                goto relational;
+            case expr::LT:
+                op = INSTR_LT;
+                goto relational;
+            relational:
+                if (!compile_expr(ctx, expr->lhs(), offset, lhs_type) ||
+                    !compile_expr(ctx, expr->rhs(), offset, rhs_type) ||
+                    !lhs_type->is_scalar() || !rhs_type->is_scalar()) {
+                    return false;
+                }
+                emit(op);
+                type = tm.find_boolean();
+                return true;
+
+            /* ITE(COND(c, a), b), else branch type */
+            case expr::ITE: {
+                expr::Expr_ptr cond { expr->lhs() };
+                if (!em.is_cond(cond)) {
+                    return false;
+                }
+
+                type::Type_ptr cnd_type { NULL };
+                if (!compile_expr(ctx, cond->lhs(), offset, cnd_type) ||
+                    !compile_expr(ctx, cond->rhs(), offset, lhs_type) ||
+                    !compile_expr(ctx, expr->rhs(), offset, type)) {
+                    return false;
+                }
+                emit(INSTR_ITE);
+                return true;
+            }
+
+            case expr::IDENT:
+            case expr::ICONST:
+            case expr::HCONST:
+            case expr::OCONST:
+            case expr::BCONST:
+                return compile_leaf(ctx, expr, offset, type);
+
+            /* arrays, sets, strings, casts, ... */
+            default:
+                return false;
+        }
+    }
+
+    expr::Expr_ptr Program::run(Witness& w, step_t time)
+    {
+        /* values are pooled, equal values are the same expr */
+        if (!support_values(w, time, f_support, f_values)) {
+            return NULL;
+        }
+
+        if (!f_inputs && f_memo.valid && f_values == f_memo.values) {
+            return f_memo.result;
+        }
+
+        expr::Expr_ptr res { execute(f_values) };
+
+        if (!f_inputs) {
+            f_memo.values.swap(f_values);
+            f_memo.result = res;
+            f_memo.valid = true;
+        }
+
+        return res;
+    }
+
+    expr::Expr_ptr Program::execute(const expr::ExprVector& values)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        std::vector<value_t>& stack { f_stack };
+        stack.clear();
+
+        value_t lhs, rhs;
+        for (const auto& instr : f_instrs) {
+            switch (instr.op) {
+                case INSTR_CONST:
+                    stack.push_back(instr.value);
+                    continue;
+
+                case INSTR_LOAD: {
+                    if (!scalar_value(values[instr.value], lhs)) {
+                        return NULL;
+                    }
+                    stack.push_back(lhs);
+                    continue;
+                }
+
+                case INSTR_INPUT: {
+                    expr::Expr_ptr value { env.get(instr.expr) };
+                    if (NULL == value || !scalar_value(value, lhs)) {
+                        return NULL;
+                    }
+                    stack.push_back(lhs);
+                    continue;
+                }
+
+                case INSTR_NEG:
+                    stack.back() = -stack.back();
+                    continue;
+
+                case INSTR_NOT:
+                    stack.back() = !stack.back();
+                    continue;
+
+                case INSTR_BW_NOT:
+                    stack.back() = ~stack.back();
+                    continue;
+
+                case INSTR_ITE: {
+                    value_t els { stack.back() };
+                    stack.pop_back();
+                    value_t thn { stack.back() };
+                    stack.pop_back();
+                    stack.back() = stack.back() ? thn : els;
+                    continue;
+                }
+
+                default:
+                    break;
+            }
+
+            /* binary */
+            rhs = stack.back();
+            stack.pop_back();
+            lhs = stack.back();
+
+            value_t& res { stack.back() };
+            switch (instr.op) {
+                case INSTR_ADD:
+                    res = lhs + rhs;
+                    break;
+                case INSTR_SUB:
+                    res = lhs - rhs;
+                    break;
+                case INSTR_DIV:
+                    if (0 == rhs) {
+                        return NULL;
+                    }
+                    res = lhs / rhs;
+                    break;
+                case INSTR_MUL:
+                    res = lhs * rhs;
+                    break;
+                case INSTR_MOD:
+                    if (0 == rhs) {
+                        return NULL;
+                    }
+                    res = lhs % rhs;
+                    break;
+                case INSTR_AND:
+                    res = lhs && rhs;
+                    break;
+                case INSTR_OR:
+                    res = lhs || rhs;
+                    break;
+                case INSTR_IMPLIES:
+                    res = !lhs || rhs;
+                    break;
+                case INSTR_BW_AND:
+                    res = lhs & rhs;
+                    break;
+                case INSTR_BW_OR:
+                    res = lhs | rhs;
+                    break;
+                case INSTR_BW_XOR:
+                    res = lhs ^ rhs;
+                    break;
+                case INSTR_BW_XNOR:
+                    res = ((!lhs) | rhs) & ((!rhs) | lhs);
+                    break;
+                case INSTR_LSHIFT:
+                    res = lhs << rhs;
+                    break;
+                case INSTR_RSHIFT:
+                    res = lhs >> rhs;
+                    break;
+                case INSTR_EQ:
+                    res = lhs == rhs;
+                    break;
+                case INSTR_NE:
+                    res = lhs != rhs;
+                    break;
+                case INSTR_GE:
+                    res = lhs >= rhs;
+                    break;
+                case INSTR_GT:
+                    res = lhs > rhs;
+                    break;
+                case INSTR_LE:
+                    res = lhs <= rhs;
+                    break;
+                case INSTR_LT:
+                    res = lhs < rhs;
+                    break;
+                default:
+                    assert(false); /* unreachable */
+            }
+        }
+
+        assert(1 == stack.size());
+        return result(stack.back());
+    }
+
+    /* kernels of the column runs, plain loops over arrays of values
+       which the compiler vectorizes */
+    template <typename Op>
+    static inline void column_unary(value_t* arg, unsigned n, Op op)
+    {
+        for (unsigned j = 0; j < n; ++j) {
+            arg[j] = op(arg[j]);
+        }
+    }
+
+    template <typename Op>
+    static inline void column_binary(value_t* lhs, const value_t* rhs, unsigned n, Op op)
+    {
+        for (unsigned j = 0; j < n; ++j) {
+            lhs[j] = op(lhs[j], rhs[j]);
+        }
+    }
+
+    void Program::run_frames(Witness& w, step_t first, unsigned n, expr::ExprVector& res)
+    {
+        env::Environment& env { env::Environment::INSTANCE() };
+
+        res.assign(n, NULL);
+        if (0 == n) {
+            return;
+        }
+
+        /* frames all values are known at, so far */
+        std::vector<char> valid(n, 1);
+
+        /* the columns of the support, values are pooled: runs of
+           equal values are converted once */
+        std::vector<std::vector<value_t>> loads(f_support.size(), std::vector<value_t>(n, 0));
+        for (unsigned i = 0; i < f_support.size(); ++i) {
+            expr::Expr_ptr var { f_support[i].first };
+            step_t offset { f_support[i].second };
+            std::vector<value_t>& column { loads[i] };
+
+            expr::Expr_ptr last { NULL };
+            value_t scalar { 0 };
+            bool ok { false };
+            for (unsigned j = 0; j < n; ++j) {
+                step_t at { first + j + offset };
+                if (!valid[j] || !w.has_value(var, at)) {
+                    valid[j] = 0;
+                    continue;
+                }
+
+                expr::Expr_ptr value { w.value(var, at) };
+                if (value != last) {
+                    last = value;
+                    ok = scalar_value(value, scalar);
+                }
+
+                if (!ok) {
+                    valid[j] = 0;
+                    continue;
+                }
+                column[j] = scalar;
+            }
+        }
+
+        if (f_columns.size() < f_max_depth) {
+            f_columns.resize(f_max_depth);
+        }
+        for (auto& column : f_columns) {
+            column.resize(n);
+        }
+
+        unsigned sp { 0 };
+        value_t lhs;
+        for (const auto& instr : f_instrs) {
+            switch (instr.op) {
+                case INSTR_CONST:
+                    std::fill_n(f_columns[sp++].begin(), n, instr.value);
+                    continue;
+
+                case INSTR_LOAD:
+                    std::copy(loads[instr.value].begin(), loads[instr.value].end(),
+                              f_columns[sp++].begin());
+                    continue;
+
+                /* inputs are the same at all frames */
+                case INSTR_INPUT: {
+                    expr::Expr_ptr value { env.get(instr.expr) };
+                    if (NULL == value || !scalar_value(value, lhs)) {
+                        return;
+                    }
+                    std::fill_n(f_columns[sp++].begin(), n, lhs);
+                    continue;
+                }
+
+                case INSTR_NEG:
+                    column_unary(f_columns[sp - 1].data(), n,
+                                 [](value_t a) { return -a; });
+                    continue;
+
+                case INSTR_NOT:
+                    column_unary(f_columns[sp - 1].data(), n,
+                                 [](value_t a) { return (value_t) !a; });
+                    continue;
+
+                case INSTR_BW_NOT:
+                    column_unary(f_columns[sp - 1].data(), n,
+                                 [](value_t a) { return ~a; });
+                    continue;
+
+                case INSTR_ITE: {
+                    value_t* cnd { f_columns[sp - 3].data() };
+                    const value_t* thn { f_columns[sp - 2].data() };
+                    const value_t* els { f_columns[sp - 1].data() };
+                    for (unsigned j = 0; j < n; ++j) {
+                        cnd[j] = cnd[j] ? thn[j] : els[j];
+                    }
+                    sp -= 2;
+                    continue;
+                }
+
+                default:
+                    break;
+            }
+
+            /* binary */
+            value_t* a { f_columns[sp - 2].data() };
+            const value_t* b { f_columns[sp - 1].data() };
+            --sp;
+
+            switch (instr.op) {
+                case INSTR_ADD:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x + y; });
+                    break;
+                case INSTR_SUB:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x - y; });
+                    break;
+                case INSTR_MUL:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x * y; });
+                    break;
+
+                /* no value where the divisor is 0, as for execute */
+                case INSTR_DIV:
+                case INSTR_MOD: {
+                    bool div { INSTR_DIV == instr.op };
+                    for (unsigned j = 0; j < n; ++j) {
+                        if (0 == b[j]) {
+                            valid[j] = 0;
+                            a[j] = 0;
+                        } else {
+                            a[j] = div ? a[j] / b[j] : a[j] % b[j];
+                        }
+                    }
+                    break;
+                }
+
+                case INSTR_AND:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x && y); });
+                    break;
+                case INSTR_OR:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x || y); });
+                    break;
+                case INSTR_IMPLIES:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (!x || y); });
+                    break;
+                case INSTR_BW_AND:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x & y; });
+                    break;
+                case INSTR_BW_OR:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x | y; });
+                    break;
+                case INSTR_BW_XOR:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x ^ y; });
+                    break;
+                case INSTR_BW_XNOR:
+                    column_binary(a, b, n, [](value_t x, value_t y) {
+                        return (value_t) (((!x) | y) & ((!y) | x));
+                    });
+                    break;
+                case INSTR_LSHIFT:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x << y; });
+                    break;
+                case INSTR_RSHIFT:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return x >> y; });
+                    break;
+                case INSTR_EQ:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x == y); });
+                    break;
+                case INSTR_NE:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x != y); });
+                    break;
+                case INSTR_GE:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x >= y); });
+                    break;
+                case INSTR_GT:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x > y); });
+                    break;
+                case INSTR_LE:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x <= y); });
+                    break;
+                case INSTR_LT:
+                    column_binary(a, b, n, [](value_t x, value_t y) { return (value_t) (x < y); });
+                    break;
+                default:
+                    assert(false); /* unreachable */
+            }
+        }
+
+        assert(1 == sp);
+        const std::vector<value_t>& values { f_columns[0] };
+
+        /* runs of equal values make the same expr */
+        expr::Expr_ptr last { NULL };
+        for (unsigned j = 0; j < n; ++j) {
+            if (!valid[j]) {
+                continue;
+            }
+
+            if (!last || values[j] != values[j - 1] || !valid[j - 1]) {
+                last = result(values[j]);
+            }
+            res[j] = last;
+        }
+    }
+
+    expr::Expr_ptr Program::result(value_t value)
+    {
+        expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
+
+        if (f_type->is_boolean()) {
+            return value ? em.make_true() : em.make_false();
+        }
+
+        if (f_type->is_enum()) {
+            const expr::ExprSet& literals { f_type->as_enum()->literals() };
+            expr::ExprSet::const_iterator i { literals.begin() };
+
+            while (0 < value && literals.end() != i) {
+                --value;
+                ++i;
+            }
+
+            return literals.end() != i ? *i : NULL;
+        }
+
+        return em.make_const(value);
+    }
+
+}; // namespace witness
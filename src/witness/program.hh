@@ -0,0 +1,199 @@
+/**
+ * @file program.hh
+ * @brief Compiled expr evaluator
+ *
+ * This header file contains the declarations required to evaluate
+ * expressions by compiled programs. An expression is compiled once
+ * into a flat postfix program (defines inlined, time shifts resolved
+ * into load offsets), which is then run over the values of any
+ * witness, at any time. Only scalar expressions are compiled, the
+ * walking evaluator takes care of all others.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#ifndef WITNESS_PROGRAM_H
+#define WITNESS_PROGRAM_H
+
+#include <vector>
+
+#include <expr/expr.hh>
+
+#include <type/type.hh>
+
+#include <witness/witness.hh>
+
+#include <utils/values.hh>
+
+#include <boost/unordered_map.hpp>
+
+namespace witness {
+
+    typedef enum {
+        INSTR_CONST,
+        INSTR_LOAD,
+        INSTR_INPUT,
+
+        INSTR_NEG,
+        INSTR_NOT,
+        INSTR_BW_NOT,
+
+        INSTR_ADD,
+        INSTR_SUB,
+        INSTR_DIV,
+        INSTR_MUL,
+        INSTR_MOD,
+
+        INSTR_AND,
+        INSTR_OR,
+        INSTR_IMPLIES,
+
+        INSTR_BW_AND,
+        INSTR_BW_OR,
+        INSTR_BW_XOR,
+        INSTR_BW_XNOR,
+
+        INSTR_LSHIFT,
+        INSTR_RSHIFT,
+
+        INSTR_EQ,
+        INSTR_NE,
+        INSTR_GE,
+        INSTR_GT,
+        INSTR_LE,
+        INSTR_LT,
+
+        INSTR_ITE,
+    } instr_t;
+
+    /* CONST pushes value, LOAD pushes the value of the var named
+       expr, at time + offset (value is its index in the support),
+       INPUT that of the input named expr */
+    struct Instr {
+        instr_t op;
+        value_t value;
+        expr::Expr_ptr expr;
+        step_t offset;
+    };
+
+    typedef std::vector<Instr> Instrs;
+
+    /* the (var, time offset) pairs a value depends on */
+    typedef std::vector<std::pair<expr::Expr_ptr, step_t>> Support;
+
+    /* false if some value of the support is missing in w at time */
+    bool support_values(Witness& w, step_t time, const Support& support,
+                        expr::ExprVector& values);
+
+    /* the last result of an evaluation, and the values of the
+       support it was computed from */
+    struct EvalMemo {
+        EvalMemo()
+            : result(NULL)
+            , valid(false)
+        {}
+
+        expr::ExprVector values;
+        expr::Expr_ptr result;
+        bool valid;
+    };
+
+    typedef class Program* Program_ptr;
+
+    class Program {
+    public:
+        /* NULL iff body can not be compiled in ctx */
+        static Program_ptr compile(expr::Expr_ptr ctx, expr::Expr_ptr body);
+
+        /* value of the expression at time, NULL if some value is
+           missing in w. Defines are mostly evaluated frame after
+           frame: unless the support changed since the last run, or
+           inputs are involved, the last result is returned */
+        expr::Expr_ptr run(Witness& w, step_t time);
+
+        inline const Support& support() const
+        {
+            return f_support;
+        }
+
+        /* the value for the given values of the support, by position
+           in it. No memo is involved */
+        expr::Expr_ptr execute(const expr::ExprVector& values);
+
+        /* values of the expression at times first .. first + n - 1
+           of w, NULL where some value is missing. The program runs
+           once, over columns of values (all frames at once) */
+        void run_frames(Witness& w, step_t first, unsigned n, expr::ExprVector& res);
+
+        inline type::Type_ptr type() const
+        {
+            return f_type;
+        }
+
+        inline unsigned size() const
+        {
+            return f_instrs.size();
+        }
+
+    private:
+        Program();
+
+        /* false iff expr can not be compiled */
+        bool compile_expr(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t offset,
+                          type::Type_ptr& type);
+        bool compile_leaf(expr::Expr_ptr ctx, expr::Expr_ptr expr, step_t offset,
+                          type::Type_ptr& type);
+
+        void emit(instr_t op, value_t value = 0, expr::Expr_ptr expr = NULL,
+                  step_t offset = 0);
+
+        /* index of (full, offset) in the support, added if new */
+        value_t support_index(expr::Expr_ptr full, step_t offset);
+
+        /* the expr for value, of the type of the program */
+        expr::Expr_ptr result(value_t value);
+
+        Instrs f_instrs;
+        type::Type_ptr f_type;
+
+        Support f_support;
+        bool f_inputs;
+
+        EvalMemo f_memo;
+        expr::ExprVector f_values;
+
+        /* max stack depth */
+        unsigned f_depth;
+        unsigned f_max_depth;
+
+        /* runtime stack, reused across runs */
+        std::vector<value_t> f_stack;
+
+        /* runtime stack of columns, reused across runs over frames */
+        std::vector<std::vector<value_t>> f_columns;
+    };
+
+    /* programs for (ctx, body) pairs, NULL for those that could not
+       be compiled */
+    typedef std::pair<expr::Expr_ptr, expr::Expr_ptr> ProgramKey;
+    typedef boost::unordered_map<ProgramKey, Program_ptr> ProgramMap;
+
+}; // namespace witness
+
+#endif /* WITNESS_PROGRAM_H */
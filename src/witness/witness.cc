@@ -23,22 +23,163 @@
 
 #include <witness.hh>
 
+#include <expr/collector.hh>
+
+#include <utils/memory.hh>
 #include <utils/misc.hh>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <sstream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace witness {
 
+    /* a sealed frame is a delta of the frame before it, unless it is
+       at this distance from the last keyframe */
+    static const unsigned keyframe_interval { 32 };
+
     TimeFrame::TimeFrame(Witness& owner)
-        : f_owner(owner)
+        : f_base(NULL)
+        , f_depth(0)
+        , f_sealed(false)
+        , f_n_pending(0)
+        , f_owner(&owner)
     {}
 
     TimeFrame::~TimeFrame()
     {}
 
+    static inline bool delta_less(const std::pair<unsigned, expr::Expr_ptr>& a, unsigned index)
+    {
+        return a.first < index;
+    }
+
+    expr::Expr_ptr TimeFrame::find(unsigned index) const
+    {
+        const TimeFrame* tf { this };
+
+        while (tf->f_base) {
+            Delta::const_iterator i {
+                std::lower_bound(tf->f_delta.begin(), tf->f_delta.end(), index, delta_less)
+            };
+
+            if (tf->f_delta.end() != i && index == i->first) {
+                return i->second;
+            }
+
+            tf = tf->f_base;
+        }
+
+        return index < tf->f_values.size() ? tf->f_values[index] : NULL;
+    }
+
+    void TimeFrame::materialize(expr::ExprVector& res) const
+    {
+        if (!f_base) {
+            res = f_values;
+        } else {
+            f_base->materialize(res);
+
+            for (Delta::const_iterator i = f_delta.begin(); i != f_delta.end(); ++i) {
+                res[i->first] = i->second;
+            }
+        }
+
+        res.resize(f_owner->f_lang.size(), NULL);
+    }
+
+    void TimeFrame::seal(TimeFrame* prev)
+    {
+        assert(!f_sealed && !f_base);
+        f_sealed = true;
+
+        /* values of lazy frames are not known yet */
+        if (!prev || f_n_pending || prev->f_n_pending ||
+            keyframe_interval <= 1 + prev->f_depth) {
+            return;
+        }
+
+        expr::ExprVector base;
+        prev->materialize(base);
+
+        Delta delta;
+        for (unsigned i = 0; i < base.size(); ++i) {
+            expr::Expr_ptr value { i < f_values.size() ? f_values[i] : NULL };
+
+            if (value != base[i]) {
+                delta.push_back(std::make_pair(i, value));
+            }
+        }
+
+        /* entries take twice the room of values */
+        if (base.size() < 2 * delta.size()) {
+            return;
+        }
+
+        f_delta.swap(delta);
+        f_base = prev;
+        f_depth = 1 + prev->f_depth;
+
+        expr::ExprVector().swap(f_values);
+    }
+
+    void TimeFrame::set_lazy(FrameDecoder_ptr decoder, std::vector<bool>& bits)
+    {
+        assert(!f_sealed && !f_base);
+
+        f_decoder = decoder;
+        f_bits.swap(bits);
+
+        /* values set so far are kept */
+        unsigned n { (unsigned) f_owner->f_lang.size() };
+        f_pending.assign(n, true);
+        f_n_pending = n;
+    }
+
+    void TimeFrame::decode_aux(unsigned index)
+    {
+        f_pending[index] = false;
+        --f_n_pending;
+
+        /* decoding may decode other symbols, and release it */
+        FrameDecoder_ptr decoder { f_decoder };
+        if (!find(index)) {
+            decoder->decode(*this, index);
+        }
+
+        /* all decoded, bits are no longer needed */
+        if (!f_n_pending) {
+            f_decoder.reset();
+            std::vector<bool>().swap(f_bits);
+            std::vector<bool>().swap(f_pending);
+        }
+    }
+
+    void TimeFrame::decode_all()
+    {
+        for (unsigned i = 0; f_n_pending && i < f_pending.size(); ++i) {
+            decode(i);
+        }
+    }
+
+    void TimeFrame::reset(expr::ExprVector& values)
+    {
+        f_values.swap(values);
+
+        Delta().swap(f_delta);
+        f_base = NULL;
+        f_depth = 0;
+    }
+
     TimeFrame& Witness::operator[](step_t i)
     {
+        resident();
+
         if (i < f_j) {
             throw IllegalTime(i);
         }
@@ -59,26 +200,17 @@ namespace witness {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
 
         // symbol is defined in witness' language
-        expr::ExprVector& lang(f_owner.lang());
-
-        assert(find(lang.begin(), lang.end(), expr) != lang.end());
+        int index { f_owner->symbol_index(expr) };
+        assert(-1 != index);
 
-        Expr2ExprMap::iterator eye;
-
-        eye = f_map.find(expr);
-        if (f_map.end() == eye) {
+        decode(index);
+        expr::Expr_ptr vexpr { find(index) };
+        if (!vexpr) {
             throw NoValue(expr);
         }
 
-        expr::Expr_ptr vexpr { (*eye).second };
-        Expr2FormatMap::iterator format_eye { f_format_map.find(expr) };
-
-        if (f_format_map.end() == format_eye) {
-            assert(false); /* unreachable */
-        }
-
         /* got value format */
-        value_format_t fmt { (*format_eye).second };
+        value_format_t fmt { f_owner->format(index) };
 
         /* force conversion of constants to required format.
          * TODO: extend this to sets */
@@ -113,18 +245,16 @@ namespace witness {
     bool TimeFrame::has_value(expr::Expr_ptr expr)
     {
         // symbol is defined in witness' language
-        expr::ExprVector& lang { f_owner.lang() };
+        int index { f_owner->symbol_index(expr) };
 
         // FIXME: proper exception
-        if (lang.end() == std::find(lang.begin(), lang.end(), expr)) {
+        if (-1 == index) {
             std::cerr << expr << std::endl;
             assert(false);
         }
 
-        Expr2ExprMap::iterator eye;
-
-        eye = f_map.find(expr);
-        return (f_map.end() != eye);
+        decode(index);
+        return NULL != find(index);
     }
 
     /* Sets value for expr */
@@ -139,15 +269,40 @@ namespace witness {
             << std::endl;
 
         // symbol is defined in witness' language
-        expr::ExprVector& lang { f_owner.lang() };
+        int index { f_owner->symbol_index(expr) };
 
-        if (find(lang.begin(), lang.end(), expr) == lang.end()) {
+        if (-1 == index) {
             throw UnknownIdentifier(expr);
         }
 
-        /* populate both maps at the same time. This ensures consistency. */
-        f_map.insert(std::pair<expr::Expr_ptr, expr::Expr_ptr>(expr, value));
-        f_format_map.insert(std::pair<expr::Expr_ptr, value_format_t>(expr, format));
+        /* the first value set is kept */
+        if (find(index)) {
+            return;
+        }
+
+        if (f_sealed) {
+            f_owner->pin(*this, index);
+        }
+
+        if (f_base) {
+            Delta::iterator i {
+                std::lower_bound(f_delta.begin(), f_delta.end(), (unsigned) index, delta_less)
+            };
+
+            if (f_delta.end() != i && (unsigned) index == i->first) {
+                i->second = value;
+            } else {
+                f_delta.insert(i, std::make_pair((unsigned) index, value));
+            }
+        } else {
+            if (f_values.size() <= (unsigned) index) {
+                f_values.resize(f_owner->f_lang.size(), NULL);
+            }
+
+            f_values[index] = value;
+        }
+
+        f_owner->f_formats[index] = format;
     }
 
     expr::ExprVector TimeFrame::assignments()
@@ -155,28 +310,52 @@ namespace witness {
         expr::ExprMgr& em { expr::ExprMgr::INSTANCE() };
         expr::ExprVector res;
 
-        expr::ExprVector& lang { f_owner.lang() };
-        expr::ExprVector::const_iterator i { lang.begin() };
+        const expr::ExprVector& lang { f_owner->lang() };
 
-        while (i != lang.end()) {
-            expr::Expr_ptr symb { *i };
+        decode_all();
 
-            ++i;
-            try {
-                res.push_back(em.make_eq(symb, value(symb)));
-            }
+        expr::ExprVector values;
+        materialize(values);
 
-            catch (NoValue& nv) {
+        for (unsigned i = 0; i < lang.size(); ++i) {
+            if (values[i]) {
+                expr::Expr_ptr symb { lang[i] };
+                res.push_back(em.make_eq(symb, value(symb)));
             }
         }
 
         return res;
     }
 
+    size_t TimeFrame::bytes() const
+    {
+        return sizeof(TimeFrame) +
+               utils::vector_bytes(f_values) +
+               utils::vector_bytes(f_delta) +
+               (f_bits.capacity() + f_pending.capacity()) / 8;
+    }
+
+    void TimeFrame::mark(expr::ExprMarker& marker) const
+    {
+        marker.mark(f_values);
+        for (const auto& pair : f_delta) {
+            marker.mark(pair.second);
+        }
+
+        if (f_decoder) {
+            f_decoder->mark(marker);
+        }
+    }
+
     Witness::Witness(sat::Engine_ptr pe, expr::Atom id, expr::Atom desc, step_t j)
         : f_id(id)
         , f_desc(desc)
         , f_j(j)
+        , f_time_hint(0)
+        , f_spill_fd(-1)
+        , f_n_spilled(0)
+        , f_spill_lang(0)
+        , f_spill_width(0)
         , p_engine(pe)
     {
         DEBUG
@@ -187,23 +366,246 @@ namespace witness {
             << std::endl;
     }
 
+    void Witness::set_lang(const expr::ExprVector& lang)
+    {
+        resident();
+        assert(f_frames.empty());
+
+        f_lang.clear();
+        f_index.clear();
+        f_formats.clear();
+
+        for (expr::ExprVector::const_iterator i = lang.begin(); i != lang.end(); ++i) {
+            add_symbol(*i);
+        }
+    }
+
+    void Witness::add_symbol(expr::Expr_ptr symb)
+    {
+        if (f_index.end() != f_index.find(symb)) {
+            return;
+        }
+
+        f_index.insert(std::make_pair(symb, (unsigned) f_lang.size()));
+        f_lang.push_back(symb);
+        f_formats.push_back(FORMAT_DECIMAL);
+    }
+
+    void Witness::seal_last()
+    {
+        if (f_frames.empty() || f_frames.back()->f_sealed) {
+            return;
+        }
+
+        unsigned n { (unsigned) f_frames.size() };
+        f_frames.back()->seal(1 < n ? f_frames[n - 2] : NULL);
+    }
+
+    void Witness::pin(const TimeFrame& tf, unsigned index)
+    {
+        /* values are seldom set on frames other than the last one */
+        for (TimeFrames::reverse_iterator i = f_frames.rbegin(); i != f_frames.rend(); ++i) {
+            TimeFrame& next { **i };
+
+            if (&tf == next.f_base) {
+                TimeFrame::Delta::iterator j {
+                    std::lower_bound(next.f_delta.begin(), next.f_delta.end(), index, delta_less)
+                };
+
+                if (next.f_delta.end() == j || index != j->first) {
+                    next.f_delta.insert(j, std::make_pair(index, tf.find(index)));
+                }
+
+                break;
+            }
+        }
+    }
+
     TimeFrame& Witness::extend(Witness& w)
     {
         // seizing ownership of the TimeFrames from w
         TimeFrame_ptr last { NULL };
 
-        for (TimeFrames::iterator i = w.frames().begin(); i != w.frames().end(); ++i) {
-            f_frames.push_back(*i);
-            last = (*i);
+        resident();
+        w.resident();
+
+        seal_last();
+
+        /* values are moved to the positions of the symbols in this
+           language, unless the languages are the same */
+        bool same_lang { w.f_lang == f_lang };
+
+        std::vector<int> remap;
+        std::vector<expr::ExprVector> rows;
+        if (!same_lang) {
+            for (expr::ExprVector::const_iterator i = w.f_lang.begin(); i != w.f_lang.end(); ++i) {
+                remap.push_back(symbol_index(*i));
+            }
+
+            /* before any frame is changed, deltas refer to them.
+               Pending values are decoded by their old positions */
+            for (TimeFrames::iterator i = w.frames().begin(); i != w.frames().end(); ++i) {
+                (*i)->decode_all();
+
+                rows.push_back(expr::ExprVector());
+                (*i)->materialize(rows.back());
+            }
+        }
+
+        std::vector<bool> seen(w.f_lang.size(), false);
+        for (unsigned k = 0; k < w.f_frames.size(); ++k) {
+            TimeFrame_ptr tf { w.f_frames[k] };
+
+            if (!same_lang) {
+                const expr::ExprVector& row { rows[k] };
+                expr::ExprVector values(f_lang.size(), NULL);
+
+                for (unsigned j = 0; j < row.size(); ++j) {
+                    if (row[j]) {
+                        seen[j] = true;
+                        if (-1 != remap[j]) {
+                            values[remap[j]] = row[j];
+                        }
+                    }
+                }
+
+                tf->reset(values);
+                tf->f_sealed = false;
+                tf->f_owner = this;
+
+                seal_last();
+            } else {
+                /* values come from keyframes, or deltas */
+                for (unsigned j = 0; j < tf->f_values.size(); ++j) {
+                    if (tf->f_values[j]) {
+                        seen[j] = true;
+                    }
+                }
+                for (TimeFrame::Delta::const_iterator j = tf->f_delta.begin();
+                     j != tf->f_delta.end(); ++j) {
+                    if (j->second) {
+                        seen[j->first] = true;
+                    }
+                }
+
+                tf->f_owner = this;
+            }
+
+            f_frames.push_back(tf);
+            last = tf;
         }
         w.f_frames.clear();
 
+        /* formats of the values seized */
+        for (unsigned j = 0; j < w.f_lang.size(); ++j) {
+            int index { same_lang ? (int) j : remap[j] };
+            if (seen[j] && -1 != index) {
+                f_formats[index] = w.f_formats[j];
+            }
+        }
+
         assert(last);
         return *last;
     }
 
+    void Witness::drop_first()
+    {
+        resident();
+        assert(!f_frames.empty());
+        TimeFrame_ptr first { f_frames.front() };
+
+        f_frames.erase(f_frames.begin());
+        if (!f_frames.empty() && first == f_frames.front()->f_base) {
+            expr::ExprVector values;
+            f_frames.front()->materialize(values);
+            f_frames.front()->reset(values);
+        }
+
+        /* depths are counted from the keyframe */
+        for (unsigned k = 1; k < f_frames.size(); ++k) {
+            TimeFrame& tf { *f_frames[k] };
+
+            if (!tf.f_base) {
+                break;
+            }
+
+            tf.f_depth = 1 + tf.f_base->f_depth;
+        }
+
+        delete first;
+    }
+
+    void Witness::drop_last()
+    {
+        resident();
+        assert(!f_frames.empty());
+
+        delete f_frames.back();
+        f_frames.pop_back();
+    }
+
+    Witness_ptr Witness::duplicate(expr::Atom id, expr::Atom desc)
+    {
+        Witness_ptr res { new Witness(NULL, id, desc, f_j) };
+
+        resident();
+
+        /* lazy frames share their decoders, and decode by position */
+        for (TimeFrames::const_iterator i = f_frames.begin(); i != f_frames.end(); ++i) {
+            (*i)->decode_all();
+        }
+
+        res->f_lang = f_lang;
+        res->f_index = f_index;
+        res->f_formats = f_formats;
+
+        /* deltas are copied as they are, bases are always the frames
+           before */
+        for (TimeFrames::const_iterator i = f_frames.begin(); i != f_frames.end(); ++i) {
+            const TimeFrame& tf { **i };
+            TimeFrame_ptr copy { new TimeFrame(*res) };
+
+            copy->f_values = tf.f_values;
+            copy->f_delta = tf.f_delta;
+            copy->f_base = tf.f_base ? res->f_frames.back() : NULL;
+            copy->f_depth = tf.f_depth;
+            copy->f_sealed = tf.f_sealed;
+
+            res->f_frames.push_back(copy);
+        }
+
+        return res;
+    }
+
+    step_t Witness::time_of(const TimeFrame& tf)
+    {
+        resident();
+
+        /* frames are mostly looked up in order */
+        unsigned n { (unsigned) f_frames.size() };
+        for (unsigned k = f_time_hint; k < n && k < f_time_hint + 2; ++k) {
+            if (&tf == f_frames[k]) {
+                f_time_hint = k;
+                return f_j + k;
+            }
+        }
+
+        for (unsigned k = 0; k < n; ++k) {
+            if (&tf == f_frames[k]) {
+                f_time_hint = k;
+                return f_j + k;
+            }
+        }
+
+        assert(false); /* unreachable */
+        return f_j;
+    }
+
     TimeFrame& Witness::extend()
     {
+        resident();
+        seal_last();
+
         TimeFrame_ptr tf { new TimeFrame(*this) };
         f_frames.push_back(tf);
 
@@ -224,6 +626,7 @@ namespace witness {
             throw IllegalTime(time);
         }
 
+        resident();
         expr::Expr_ptr vexpr { f_frames[time]->value(expr) };
         return vexpr;
     }
@@ -236,9 +639,217 @@ namespace witness {
             return false;
         }
 
+        resident();
         return f_frames[time]->has_value(expr);
     }
 
+    size_t Witness::bytes() const
+    {
+        size_t res { sizeof(Witness) };
+
+        res += utils::vector_bytes(f_frames);
+        for (const auto tf : f_frames) {
+            res += tf->bytes();
+        }
+
+        res += utils::vector_bytes(f_lang);
+        res += utils::hash_bytes(f_index);
+        res += utils::vector_bytes(f_formats);
+        res += utils::vector_bytes(f_spill_pool);
+
+        return res;
+    }
+
+    bool Witness::spill(const boost::filesystem::path& dir)
+    {
+        assert(!is_spilled());
+
+        /* rows decode lazy frames, their SAT models are not kept */
+        unsigned n_lang { (unsigned) f_lang.size() };
+        unsigned n_frames { (unsigned) f_frames.size() };
+
+        boost::unordered_map<expr::Expr_ptr, uint32_t, utils::PtrHash, utils::PtrEq> indices;
+        expr::ExprVector pool;
+        std::vector<uint32_t> cells;
+        cells.reserve(n_frames * n_lang);
+
+        WitnessRows rows { *this };
+        while (rows.next()) {
+            const expr::ExprVector& row { rows.row() };
+            for (unsigned i = 0; i < n_lang; ++i) {
+                expr::Expr_ptr value { i < row.size() ? row[i] : NULL };
+                if (!value) {
+                    cells.push_back(0);
+                    continue;
+                }
+
+                std::pair<boost::unordered_map<expr::Expr_ptr, uint32_t, utils::PtrHash,
+                                               utils::PtrEq>::iterator, bool>
+                    inserted { indices.insert(std::make_pair(value, 1 + pool.size())) };
+                if (inserted.second) {
+                    pool.push_back(value);
+                }
+                cells.push_back(inserted.first->second);
+            }
+        }
+
+        /* as few bytes per index as the pool takes */
+        unsigned width {
+            pool.size() < 0xff ? 1u : pool.size() < 0xffff ? 2u : 4u
+        };
+
+        /* least significant byte first */
+        std::vector<unsigned char> buffer(cells.size() * width);
+        for (size_t k = 0; k < cells.size(); ++k) {
+            for (unsigned b = 0; b < width; ++b) {
+                buffer[k * width + b] = (cells[k] >> (8 * b)) & 0xff;
+            }
+        }
+
+        boost::filesystem::path path {
+            dir / boost::filesystem::unique_path("yasmv-witness-%%%%-%%%%-%%%%")
+        };
+
+        int fd { open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600) };
+        if (fd < 0) {
+            pconst_char what { strerror(errno) };
+            WARN
+                << "Could not spill witness `"
+                << f_id
+                << "`: "
+                << what
+                << std::endl;
+
+            return false;
+        }
+
+        /* the file is kept by the descriptor only */
+        unlink(path.c_str());
+
+        size_t written { 0 };
+        while (written < buffer.size()) {
+            ssize_t n { write(fd, buffer.data() + written, buffer.size() - written) };
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+
+            if (n <= 0) {
+                pconst_char what { strerror(errno) };
+                WARN
+                    << "Could not spill witness `"
+                    << f_id
+                    << "`: "
+                    << what
+                    << std::endl;
+
+                close(fd);
+                return false;
+            }
+
+            written += n;
+        }
+
+        for (const auto tf : f_frames) {
+            delete tf;
+        }
+        TimeFrames().swap(f_frames);
+        f_time_hint = 0;
+
+        f_spill_fd = fd;
+        f_n_spilled = n_frames;
+        f_spill_lang = n_lang;
+        f_spill_width = width;
+        f_spill_pool.swap(pool);
+
+        DEBUG
+            << "Spilled witness `"
+            << f_id
+            << "`, "
+            << n_frames
+            << " frames, "
+            << f_spill_pool.size()
+            << " distinct values"
+            << std::endl;
+
+        return true;
+    }
+
+    void Witness::restore()
+    {
+        assert(is_spilled());
+
+        size_t size { (size_t) f_n_spilled * f_spill_lang * f_spill_width };
+        const unsigned char* cells { NULL };
+
+        void* mapping { MAP_FAILED };
+        if (0 < size) {
+            mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, f_spill_fd, 0);
+            if (MAP_FAILED == mapping) {
+                throw SpillError(f_id, strerror(errno));
+            }
+            madvise(mapping, size, MADV_SEQUENTIAL);
+
+            cells = static_cast<const unsigned char*>(mapping);
+        }
+
+        int fd { f_spill_fd };
+        f_spill_fd = -1;
+
+        /* frames are sealed as they are added, deltas are taken
+           again */
+        for (unsigned k = 0; k < f_n_spilled; ++k) {
+            seal_last();
+
+            TimeFrame_ptr tf { new TimeFrame(*this) };
+            tf->f_values.assign(f_lang.size(), NULL);
+
+            for (unsigned i = 0; i < f_spill_lang; ++i) {
+                const unsigned char* bytes {
+                    cells + ((size_t) k * f_spill_lang + i) * f_spill_width
+                };
+
+                uint32_t cell { 0 };
+                for (unsigned b = 0; b < f_spill_width; ++b) {
+                    cell |= (uint32_t) bytes[b] << (8 * b);
+                }
+
+                if (cell) {
+                    tf->f_values[i] = f_spill_pool[cell - 1];
+                }
+            }
+
+            f_frames.push_back(tf);
+        }
+
+        if (MAP_FAILED != mapping) {
+            munmap(mapping, size);
+        }
+        close(fd);
+
+        f_n_spilled = 0;
+        expr::ExprVector().swap(f_spill_pool);
+
+        DEBUG
+            << "Restored witness `"
+            << f_id
+            << "`"
+            << std::endl;
+    }
+
+    void Witness::mark(expr::ExprMarker& marker) const
+    {
+        for (const auto tf : f_frames) {
+            tf->mark(marker);
+        }
+
+        marker.mark(f_lang);
+        for (const auto& pair : f_index) {
+            marker.mark(pair.first);
+        }
+
+        marker.mark(f_spill_pool);
+    }
+
     /* Engine registration can be done only once */
     void Witness::register_engine(sat::Engine& e)
     {
@@ -246,4 +857,38 @@ namespace witness {
         p_engine = &e;
     }
 
+    WitnessRows::WitnessRows(Witness& w)
+        : f_witness(w)
+        , f_k(0)
+        , f_incremental(false)
+    {
+        w.resident();
+    }
+
+    bool WitnessRows::next()
+    {
+        TimeFrames& frames { f_witness.f_frames };
+        if (frames.size() <= f_k) {
+            return false;
+        }
+
+        TimeFrame& tf { *frames[f_k] };
+        tf.decode_all();
+
+        /* bases are always the frames before */
+        f_incremental = 0 < f_k && tf.f_base == frames[f_k - 1];
+        if (f_incremental) {
+            f_changed.clear();
+            for (TimeFrame::Delta::const_iterator i = tf.f_delta.begin(); i != tf.f_delta.end(); ++i) {
+                f_row[i->first] = i->second;
+                f_changed.push_back(i->first);
+            }
+        } else {
+            tf.materialize(f_row);
+        }
+
+        ++f_k;
+        return true;
+    }
+
 } // namespace witness
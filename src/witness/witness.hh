@@ -31,6 +31,8 @@
 
 #include <vector>
 
+#include <boost/filesystem.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <expr/expr.hh>
@@ -60,15 +62,51 @@ namespace witness {
     using Expr2FormatMap = boost::unordered_map<expr::Expr_ptr, value_format_t, utils::PtrHash, utils::PtrEq>;
     // using Expr2FormatMapIterator = Expr2FormatMap::iterator;
 
+    /* symbol -> position in the language of a witness */
+    using SymbolIndexMap = boost::unordered_map<expr::Expr_ptr, unsigned, utils::PtrHash, utils::PtrEq>;
+
     using TimeFrame_ptr = class TimeFrame*;
     using TimeFrames = std::vector<TimeFrame_ptr>;
 
     class Witness;
+    class TimeFrame;
+
+    /* values of lazy frames are decoded on first access, from the
+       bits of the SAT model they were taken from */
+    class FrameDecoder {
+    public:
+        virtual ~FrameDecoder()
+        {}
+
+        /* sets the value of the symbol at index in the language of
+           the owner of tf, if it has one */
+        virtual void decode(TimeFrame& tf, unsigned index) = 0;
+
+        /* the exprs values are decoded from are live */
+        virtual void mark(expr::ExprMarker& marker) const = 0;
+    };
+    using FrameDecoder_ptr = boost::shared_ptr<FrameDecoder>;
+
     class TimeFrame {
     public:
         TimeFrame(Witness& owner);
         ~TimeFrame();
 
+        inline Witness& owner() const
+        {
+            return *f_owner;
+        }
+
+        /* values are decoded from bits (by DD var index) on first
+           access, unless they are set before */
+        void set_lazy(FrameDecoder_ptr decoder, std::vector<bool>& bits);
+
+        /* the value of DD var index, in the SAT model of a lazy frame */
+        inline bool bit(unsigned index) const
+        {
+            return index < f_bits.size() && f_bits[index];
+        }
+
         /* Retrieves value for expr, throws an exception if no value exists. */
         expr::Expr_ptr value(expr::Expr_ptr expr);
 
@@ -85,9 +123,59 @@ namespace witness {
         /* Full list of assignments for this Time Frame */
         expr::ExprVector assignments();
 
+        /* bytes taken by this frame, an estimate */
+        size_t bytes() const;
+
+        /* the values of this frame are live */
+        void mark(expr::ExprMarker& marker) const;
+
     private:
-        Expr2ExprMap f_map;
-        Expr2FormatMap f_format_map;
+        friend class Witness;
+        friend class WitnessRows;
+
+        /* values by position of the symbols in the language of the
+           owner, NULL where there is none. Frames are sealed once the
+           next one is added: unless they are keyframes, they keep only
+           the values that differ from those of the frame before
+           (f_base), sorted by position */
+        expr::ExprVector f_values;
+
+        using Delta = std::vector<std::pair<unsigned, expr::Expr_ptr>>;
+        Delta f_delta;
+        TimeFrame* f_base;
+
+        /* frames to the last keyframe, 0 for keyframes */
+        unsigned f_depth;
+        bool f_sealed;
+
+        /* the value at index, NULL if there is none */
+        expr::Expr_ptr find(unsigned index) const;
+
+        /* all values, by position */
+        void materialize(expr::ExprVector& res) const;
+
+        /* prev is the frame before this one, NULL if there is none */
+        void seal(TimeFrame* prev);
+
+        /* a keyframe again, with the given values */
+        void reset(expr::ExprVector& values);
+
+        /* symbols not decoded yet, lazy frames are always keyframes */
+        FrameDecoder_ptr f_decoder;
+        std::vector<bool> f_bits;
+        std::vector<bool> f_pending;
+        unsigned f_n_pending;
+
+        inline void decode(unsigned index)
+        {
+            if (f_n_pending && index < f_pending.size() && f_pending[index]) {
+                decode_aux(index);
+            }
+        }
+        void decode_aux(unsigned index);
+
+        /* decodes all pending symbols */
+        void decode_all();
 
         // forbid copy
         TimeFrame(const TimeFrame& other)
@@ -96,7 +184,7 @@ namespace witness {
             assert(false);
         }
 
-        Witness& f_owner;
+        Witness* f_owner;
     };
 
     using Witness_ptr = class Witness*;
@@ -110,6 +198,7 @@ namespace witness {
         /* data storage */
         inline TimeFrames& frames()
         {
+            resident();
             return f_frames;
         }
 
@@ -147,7 +236,7 @@ namespace witness {
 
         inline step_t last_time()
         {
-            return f_j + f_frames.size() - 1;
+            return f_j + size() - 1;
         }
 
         inline TimeFrame& last()
@@ -157,17 +246,48 @@ namespace witness {
 
         inline step_t size()
         {
-            return f_frames.size();
+            return is_spilled() ? f_n_spilled : f_frames.size();
         }
 
-        inline expr::ExprVector& lang()
+        inline const expr::ExprVector& lang() const
         {
             return f_lang;
         }
 
+        /* replaces the language, before any value is set */
+        void set_lang(const expr::ExprVector& lang);
+
+        /* appends symb to the language, unless it is there already */
+        void add_symbol(expr::Expr_ptr symb);
+
+        /* position of symb in the language, -1 if it is not there */
+        inline int symbol_index(expr::Expr_ptr symb) const
+        {
+            SymbolIndexMap::const_iterator i { f_index.find(symb) };
+            return f_index.end() != i ? (int) i->second : -1;
+        }
+
+        /* the format of the values of the symbol at index, the last
+           one it was set with */
+        inline value_format_t format(unsigned index) const
+        {
+            return f_formats[index];
+        }
+
         /* Extends trace by k appending the given one, yields last timeframe */
         TimeFrame& extend(Witness& w);
 
+        /* drops the first (or the last) frame, the first frame
+           becomes a keyframe */
+        void drop_first();
+        void drop_last();
+
+        /* a plain witness, with the same language and frames */
+        Witness_ptr duplicate(expr::Atom id, expr::Atom desc);
+
+        /* the time of frame tf, which belongs to this witness */
+        step_t time_of(const TimeFrame& tf);
+
         /* Extends trace by 1 steps, yields new step */
         TimeFrame& extend();
 
@@ -177,6 +297,29 @@ namespace witness {
         /* Returns true iff expr has an assigned value within this time frame. */
         bool has_value(expr::Expr_ptr expr, step_t time);
 
+        /* bytes taken by this witness and its frames, an estimate */
+        size_t bytes() const;
+
+        /* true iff the frames are on disk (see spill) */
+        inline bool is_spilled() const
+        {
+            return 0 <= f_spill_fd;
+        }
+
+        /* the values of all frames are written to a file in dir
+           (unlinked, it is gone with the process), and the frames are
+           dropped. The distinct values stay in memory, frames are
+           kept on disk as arrays of indices among them. False if the
+           file could not be written, the frames are kept then */
+        bool spill(const boost::filesystem::path& dir);
+
+        /* the frames are read back, from the mapped file. Any access
+           to the frames of a spilled witness restores them first */
+        void restore();
+
+        /* the language and the values of this witness are live */
+        void mark(expr::ExprMarker& marker) const;
+
     protected:
         /* this witness' id */
         expr::Atom f_id;
@@ -192,6 +335,39 @@ namespace witness {
 
         /* Language (i.e. full list of symbols) */
         expr::ExprVector f_lang;
+        SymbolIndexMap f_index;
+
+        /* formats are kept by symbol, not by frame */
+        std::vector<value_format_t> f_formats;
+        friend class TimeFrame;
+        friend class WitnessRows;
+        friend class WitnessMgr;
+
+        /* frames based on tf keep their value at index, before it is
+           set on tf */
+        void pin(const TimeFrame& tf, unsigned index);
+
+        /* the last frame is sealed, before others are added */
+        void seal_last();
+
+        /* position of the frame last looked up by time_of */
+        unsigned f_time_hint;
+
+        inline void resident()
+        {
+            if (is_spilled()) {
+                restore();
+            }
+        }
+
+        /* -1 unless spilled, frames and symbols on disk, bytes per
+           index, and the values indices are to (shifted by one, 0 is
+           no value) */
+        int f_spill_fd;
+        unsigned f_n_spilled;
+        unsigned f_spill_lang;
+        unsigned f_spill_width;
+        expr::ExprVector f_spill_pool;
 
         /* An engine that can be used to extend this witness. This is not
            necessarily the engine that created the trace. Ordinarily it
@@ -212,6 +388,46 @@ namespace witness {
         void register_engine(sat::Engine& e);
     };
 
+    /* the values of the frames of a witness, one frame after the
+       other. Rows are updated in place from the deltas, in time
+       proportional to the number of values that changed */
+    class WitnessRows {
+    public:
+        WitnessRows(Witness& w);
+
+        /* moves to the next frame, false past the last one */
+        bool next();
+
+        inline step_t time() const
+        {
+            return f_witness.first_time() + f_k - 1;
+        }
+
+        /* values by position in the language of the witness, NULL
+           where there is none */
+        inline const expr::ExprVector& row() const
+        {
+            return f_row;
+        }
+
+        /* positions that changed since the previous row (sorted),
+           NULL if any of them may have */
+        inline const std::vector<unsigned>* changed() const
+        {
+            return f_incremental ? &f_changed : NULL;
+        }
+
+    private:
+        Witness& f_witness;
+
+        /* frames read so far */
+        unsigned f_k;
+
+        expr::ExprVector f_row;
+        std::vector<unsigned> f_changed;
+        bool f_incremental;
+    };
+
     class WitnessPrinter {
     public:
         virtual void operator()(const Witness& w, step_t j = 0, step_t k = -1) = 0;
@@ -21,23 +21,65 @@
  *
  **/
 
+#include <algorithm>
 #include <utility>
 #include <witness_mgr.hh>
 
-namespace witness {
+#include <expr/collector.hh>
+
+#include <opts/opts_mgr.hh>
 
-    // static initialization
-    WitnessMgr_ptr WitnessMgr::f_instance = NULL;
+#include <utils/memory.hh>
+
+namespace witness {
 
     WitnessMgr::WitnessMgr()
         : f_em(expr::ExprMgr::INSTANCE())
         , f_tm(type::TypeMgr::INSTANCE())
         , f_evaluator(*this)
         , f_autoincrement(0)
-    {}
+    {
+        /* one probe per context */
+        utils::MemoryMgr::INSTANCE()
+            .add_probe(utils::Context::current().label("witnesses"),
+                       [this]() { return bytes(); });
+
+        expr::ExprCollector& collector { expr::ExprCollector::INSTANCE() };
+        collector.add_roots(
+            "witnesses", [this](expr::ExprMarker& marker) {
+                boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+                for (const auto w : f_list) {
+                    w->mark(marker);
+                }
+                f_empty_witness.mark(marker);
+                marker.mark(f_values);
+            });
+
+        /* programs are compiled again on first use */
+        collector.add_cache(
+            "witness programs", [this](expr::ExprMarker& marker) {
+                boost::recursive_mutex::scoped_lock lock { f_mutex };
+                clear_programs();
+            });
+    }
+
+    size_t WitnessMgr::bytes()
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        size_t res { 0 };
+        for (const auto w : f_list) {
+            res += w->bytes();
+        }
+
+        return res;
+    }
 
     Witness& WitnessMgr::current()
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
         if (!f_curr_uid.size()) {
             return f_empty_witness;
         }
@@ -52,6 +94,8 @@ namespace witness {
 
     void WitnessMgr::set_current(expr::Atom witness_id)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
         WitnessMap::iterator eye { f_map.find(witness_id) };
 
         if (f_map.end() == eye) {
@@ -63,6 +107,8 @@ namespace witness {
 
     Witness& WitnessMgr::witness(expr::Atom id)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
         WitnessMap::iterator eye { f_map.find(id) };
 
         if (f_map.end() == eye) {
@@ -70,11 +116,15 @@ namespace witness {
         }
 
         Witness_ptr wp { (*eye).second };
+        touch(*wp);
+
         return *wp;
     }
 
     void WitnessMgr::record(Witness& witness)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
         expr::Atom uid { witness.id() };
 
         WitnessMap::iterator eye { f_map.find(uid) };
@@ -84,20 +134,112 @@ namespace witness {
 
         f_map.insert(std::pair<expr::Atom, Witness_ptr>(uid, &witness));
         f_list.push_back(&witness);
+        f_lru.push_back(&witness);
+
+        evict(witness);
+    }
+
+    void WitnessMgr::touch(Witness& w)
+    {
+        if (w.is_spilled()) {
+            w.restore();
+        }
+
+        /* the most recent are looked up first */
+        WitnessList::reverse_iterator i { std::find(f_lru.rbegin(), f_lru.rend(), &w) };
+        if (f_lru.rend() != i && f_lru.rbegin() != i) {
+            f_lru.erase(std::next(i).base());
+            f_lru.push_back(&w);
+        }
+    }
+
+    void WitnessMgr::evict(Witness& keep)
+    {
+        unsigned limit { opts::OptsMgr::INSTANCE().witness_cache() };
+        if (0 == limit) {
+            return;
+        }
+
+        unsigned resident { 0 };
+        for (const auto w : f_lru) {
+            if (!w->is_spilled()) {
+                ++resident;
+            }
+        }
+
+        if (resident <= limit) {
+            return;
+        }
+
+        boost::filesystem::path dir;
+        try {
+            dir = boost::filesystem::temp_directory_path();
+        } catch (const boost::filesystem::filesystem_error& fe) {
+            pconst_char what { fe.what() };
+            WARN
+                << "No directory to spill witnesses to: "
+                << what
+                << std::endl;
+
+            return;
+        }
+
+        /* the current witness, and those that can still be extended,
+           are in use */
+        for (WitnessList::iterator i = f_lru.begin(); limit < resident && i != f_lru.end(); ++i) {
+            Witness& w { **i };
+            if (&w == &keep || w.is_spilled() || w.has_engine() || w.id() == f_curr_uid) {
+                continue;
+            }
+
+            /* no more attempts, if the disk gives up */
+            if (!w.spill(dir)) {
+                break;
+            }
+            --resident;
+        }
     }
 
     unsigned WitnessMgr::autoincrement()
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
         return ++f_autoincrement;
     }
 
     expr::Expr_ptr WitnessMgr::eval(Witness& w, expr::Expr_ptr ctx,
                                     expr::Expr_ptr body, step_t k)
     {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        const ProgramKey key { ctx, body };
+
+        Program_ptr compiled { program(ctx, body) };
+        if (NULL != compiled) {
+            return compiled->run(w, k);
+        }
+
+        /* unless the support changed since the last evaluation, the
+           result is the same */
+        WalkerMemo& walker_memo { f_memos[key] };
+        EvalMemo& memo { walker_memo.memo };
+        if (memo.valid &&
+            support_values(w, k, walker_memo.support, f_values) &&
+            f_values == memo.values) {
+            return memo.result;
+        }
+
         expr::Expr_ptr res;
 
         try {
             res = f_evaluator.process(&w, ctx, body, k);
+
+            memo.valid = !f_evaluator.inputs();
+            if (memo.valid) {
+                walker_memo.support = f_evaluator.support();
+                memo.values = f_evaluator.support_values();
+                memo.result = res;
+            }
         } catch (NoValue& nv) {
             res = NULL;
         }
@@ -105,4 +247,42 @@ namespace witness {
         return res;
     }
 
+    void WitnessMgr::eval_frames(Witness& w, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                                 expr::ExprVector& res)
+    {
+        boost::recursive_mutex::scoped_lock lock { f_mutex };
+
+        Program_ptr compiled { program(ctx, body) };
+        if (NULL != compiled) {
+            compiled->run_frames(w, w.first_time(), w.size(), res);
+            return;
+        }
+
+        res.clear();
+        for (step_t time = w.first_time(); time <= w.last_time(); ++time) {
+            res.push_back(eval(w, ctx, body, time));
+        }
+    }
+
+    Program_ptr WitnessMgr::program(expr::Expr_ptr ctx, expr::Expr_ptr body)
+    {
+        const ProgramKey key { ctx, body };
+
+        ProgramMap::const_iterator eye { f_programs.find(key) };
+        if (f_programs.end() == eye) {
+            eye = f_programs.insert(std::make_pair(key, Program::compile(ctx, body))).first;
+        }
+
+        return eye->second;
+    }
+
+    void WitnessMgr::clear_programs()
+    {
+        for (auto& pair : f_programs) {
+            delete pair.second;
+        }
+        f_programs.clear();
+        f_memos.clear();
+    }
+
 } // namespace witness
@@ -36,8 +36,13 @@
 #include <model/model_mgr.hh>
 
 #include <witness/evaluator.hh>
+#include <witness/program.hh>
 #include <witness/witness.hh>
 
+#include <utils/context.hh>
+
+#include <boost/thread/recursive_mutex.hpp>
+
 namespace witness {
 
     typedef class WitnessMgr* WitnessMgr_ptr;
@@ -48,10 +53,8 @@ namespace witness {
     public:
         static WitnessMgr& INSTANCE()
         {
-            if (!f_instance) {
-                f_instance = new WitnessMgr();
-            }
-            return (*f_instance);
+            return utils::Context::current().instance<WitnessMgr>(
+                utils::CONTEXT_WITNESSES, []() { return new WitnessMgr(); });
         }
 
         inline expr::ExprMgr& em() const
@@ -76,28 +79,55 @@ namespace witness {
         // get currently selected witness
         Witness& current();
 
-        // get a registered witness by id
+        // get a registered witness by id, restored if spilled
         Witness& witness(expr::Atom id);
 
-        // record a new witness
+        // record a new witness, the least recently used ones are
+        // spilled to disk past --witness-cache
         void record(Witness& witness);
 
         // get a unique autoincrement index
         unsigned autoincrement();
 
+        /* compiled programs are run, when available. The walking
+           evaluator is used otherwise */
         expr::Expr_ptr eval(Witness& w, expr::Expr_ptr ctx, expr::Expr_ptr body, step_t k);
 
+        /* the values at all times of w, first to last, NULL where
+           there is none. Compiled programs evaluate all frames in one
+           pass, the walking evaluator goes frame after frame */
+        void eval_frames(Witness& w, expr::Expr_ptr ctx, expr::Expr_ptr body,
+                         expr::ExprVector& res);
+
+        /* drops all compiled programs, e.g. when a new model is read */
+        void clear_programs();
+
+        /* bytes taken by the registered witnesses, an estimate */
+        size_t bytes();
+
     protected:
         WitnessMgr();
         ~WitnessMgr();
 
     private:
-        static WitnessMgr_ptr f_instance;
+        /* the program for (ctx, body), compiled on first use. NULL if
+           it can not be compiled */
+        Program_ptr program(expr::Expr_ptr ctx, expr::Expr_ptr body);
+
+        /* w is the most recently used, restored if spilled */
+        void touch(Witness& w);
+
+        /* spills the least recently used witnesses but keep, until
+           at most --witness-cache are in memory */
+        void evict(Witness& keep);
 
         // Witness register internal map: id -> witness
         WitnessMap f_map;
         WitnessList f_list;
 
+        /* all witnesses, the least recently used first */
+        WitnessList f_lru;
+
         // ref to expr manager
         expr::ExprMgr& f_em;
 
@@ -109,9 +139,25 @@ namespace witness {
 
         Evaluator f_evaluator;
 
+        /* compiled programs, built on first use */
+        ProgramMap f_programs;
+
+        /* last results of the walking evaluator, for the pairs that
+           could not be compiled */
+        struct WalkerMemo {
+            Support support;
+            EvalMemo memo;
+        };
+        boost::unordered_map<ProgramKey, WalkerMemo> f_memos;
+        expr::ExprVector f_values;
+
         // reserved for autoincrement index
         unsigned f_autoincrement;
 
+        /* guards the register and the evaluators, commands of a
+           parallel block (or server requests) use them concurrently */
+        boost::recursive_mutex f_mutex;
+
         Witness f_empty_witness;
     };
 
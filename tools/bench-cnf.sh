@@ -0,0 +1,27 @@
+#!/bin/bash
+# CNFization benchmark: runs each example under each CNF strategy and
+# reports wall-clock times.
+DIRECTORY="examples"
+YASMV="./yasmv"
+STRATEGIES="single-cut polarity"
+
+function bench-example() {
+    COMMANDS="$DIRECTORY/$1/commands"
+    for MODEL in "$DIRECTORY/$1"/*.smv; do
+        for STRATEGY in $STRATEGIES; do
+            echo -n "$MODEL ($STRATEGY) ... "
+            START=$(date +%s%N)
+            YASMV_HOME=`pwd` $YASMV --quiet --cnf-strategy=$STRATEGY "$MODEL" < "$COMMANDS" > /dev/null
+            END=$(date +%s%N)
+            echo "$(( (END - START) / 1000000 )) ms"
+        done
+    done
+}
+
+for EXAMPLE in $(ls "$DIRECTORY"); do
+    if [[ -f "$DIRECTORY/$EXAMPLE/commands" ]]; then
+        bench-example $EXAMPLE
+    fi
+done
+
+echo ""  # one blank line
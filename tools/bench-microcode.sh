@@ -0,0 +1,32 @@
+#!/bin/bash
+# Microcode injection micro-benchmark: times pick-state on a model
+# whose only constraint is a multiplication, for increasing widths.
+YASMV="./yasmv"
+WIDTHS="8 16 24 32 40 48 56 64"
+TMPDIR=$(mktemp -d)
+
+function bench-mul() {
+    MODEL="$TMPDIR/mul$1.smv"
+    cat > "$MODEL" <<EOM
+MODULE mul$1;
+
+VAR
+	a, b, c : uint$1;
+
+INVAR
+	c = a * b ;
+EOM
+
+    echo -n "mul, width $1 ... "
+    START=$(date +%s%N)
+    echo "pick-state" | YASMV_HOME=`pwd` $YASMV --quiet "$MODEL" > /dev/null
+    END=$(date +%s%N)
+    echo "$(( (END - START) / 1000000 )) ms"
+}
+
+for WIDTH in $WIDTHS; do
+    bench-mul $WIDTH
+done
+
+rm -rf "$TMPDIR"
+echo ""  # one blank line
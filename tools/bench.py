@@ -0,0 +1,424 @@
+#!/usr/bin/env python
+"""
+bench.py - benchmark harness
+(c) 2014 Marco Pensallorto < marco DOT pensallorto AT gmail DOT com >
+
+This tool is part of the yasmv project.
+
+Runs the example models (and a few generated, parametric ones) and
+writes a JSON report with wall time, solve time, number of solves,
+clauses, vars and peak memory of each run. SAT figures come from the
+progress channel of yasmv (--progress-fd), peak memory from the
+resource usage of the child process.
+
+If a baseline report is given, the report is compared against it: a
+figure exceeding its baseline value by more than the tolerance (a
+fraction, 0.10 by default) is a regression, and the exit status is 1.
+Times under the noise floor (0.05 seconds) are never regressions.
+
+With --scaling, the models are generated by smvgen instead: each
+parameter (word width, instances, array size, density, depth) is swept
+in turn, the others staying at their defaults, and the report holds a
+series of figures per parameter, i.e. its scaling curve. Compile time
+comes from the trace events of yasmv (--trace-events).
+
+With --perf, each run is wrapped in `perf stat`, and the hardware
+counters (cycles, instructions, cache misses, branch misses) of yasmv
+are recorded along with the other figures. Counters perf can not read
+(e.g. in VMs) are left out. They are not compared against the
+baseline, they are there to tell why a time changed.
+
+usage: bench.py [--yasmv PATH] [--output FILE] [--baseline FILE]
+                [--tolerance FRACTION] [--filter SUBSTRING]
+                [--scaling [--smvgen PATH]] [--perf [--perf-path PATH]]
+"""
+
+from __future__ import print_function
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+EXAMPLES = "examples"
+NOISE_SECS = 0.05
+
+# (directory, model, commands)
+EXAMPLE_BENCHMARKS = [
+    ("cannibals", "cannibals.smv", "forward"),
+    ("cannibals", "cannibals.smv", "backward"),
+    ("maze", "solvable8x8.smv", "commands"),
+    ("maze", "unsolvable8x8.smv", "commands"),
+    ("maze", "solvable12x12.smv", "commands"),
+    ("maze", "solvable16x16.smv", "commands"),
+    ("hanoi", "hanoi3.smv", "commands"),
+    ("hanoi", "hanoi4.smv", "commands"),
+    ("hanoi", "hanoi5.smv", "commands"),
+    ("fifteen", "fifteen.smv", "commands"),
+    ("tic-tac-toe", "tic-tac-toe.smv", "commands"),
+    ("vending", "vending.smv", "commands"),
+    ("herschel", "herschel.smv", "commands"),
+    ("koenisberg", "koenisberg.smv", "commands"),
+    ("ferryman", "ferryman.smv", "commands"),
+    ("magic", "magic.smv", "commands"),
+]
+
+# longer and longer paths
+FIBONACCI_LENGTHS = [ 25, 50, 100 ]
+
+# deeper and deeper targets
+COUNTER_DEPTHS = [ 16, 32, 64 ]
+
+# wider and wider multipliers, see also bench-microcode.sh
+MUL_WIDTHS = [ 8, 16, 32 ]
+
+# smvgen parameters, their defaults and the values they are swept over
+SCALING_DEFAULTS = {
+    "width": 16,
+    "instances": 1,
+    "array-size": 4,
+    "density": 1,
+    "depth": 16,
+}
+
+SCALING_SWEEPS = [
+    ("width", [ 8, 16, 32, 64 ]),
+    ("instances", [ 1, 2, 4, 8 ]),
+    ("array-size", [ 2, 4, 8, 16 ]),
+    ("density", [ 1, 2, 4, 8 ]),
+    ("depth", [ 8, 16, 32, 64 ]),
+]
+
+# figures compared against the baseline, and whether they are times
+FIGURES = [
+    ("wall_secs", True),
+    ("compile_secs", True),
+    ("solve_secs", True),
+    ("clauses", False),
+    ("vars", False),
+    ("peak_rss_kb", False),
+]
+
+# hardware counters read by perf stat, and their figures
+PERF_EVENTS = [
+    ("cycles", "cycles"),
+    ("instructions", "instructions"),
+    ("cache-misses", "cache_misses"),
+    ("branch-misses", "branch_misses"),
+]
+
+COUNTER_MODEL = """MODULE counter%(depth)d
+
+VAR x : uint8;
+
+INIT
+    x = 0;
+
+TRANS
+    x := x + 1;
+
+DEFINE GOAL := x = %(depth)d;
+"""
+
+MUL_MODEL = """MODULE mul%(width)d;
+
+VAR
+	a, b, c : uint%(width)d;
+
+INVAR
+	c = a * b ;
+"""
+
+def generated_benchmarks(tmpdir):
+    """Writes the parametric models, yields (name, model, commands)"""
+
+    def write(name, text):
+        path = os.path.join(tmpdir, name)
+        target = open(path, "wt")
+        target.write(text)
+        target.close()
+        return path
+
+    model = os.path.join(EXAMPLES, "fibonacci", "fibonacci.smv")
+    for n in FIBONACCI_LENGTHS:
+        commands = write("fibonacci%d.cmd" % n,
+                         "set n %d\nreach GOAL\nquit\n" % n)
+        yield ("generated/fibonacci::n=%d" % n, model, commands)
+
+    for depth in COUNTER_DEPTHS:
+        model = write("counter%d.smv" % depth, COUNTER_MODEL % { "depth": depth })
+        commands = write("counter%d.cmd" % depth, "reach GOAL\nquit\n")
+        yield ("generated/counter::depth=%d" % depth, model, commands)
+
+    for width in MUL_WIDTHS:
+        model = write("mul%d.smv" % width, MUL_MODEL % { "width": width })
+        commands = write("mul%d.cmd" % width, "pick-state\nquit\n")
+        yield ("generated/mul::width=%d" % width, model, commands)
+
+def benchmarks(tmpdir):
+    for directory, model, commands in EXAMPLE_BENCHMARKS:
+        yield ("%s/%s::%s" % (directory, model, commands),
+               os.path.join(EXAMPLES, directory, model),
+               os.path.join(EXAMPLES, directory, commands))
+
+    for benchmark in generated_benchmarks(tmpdir):
+        yield benchmark
+
+def scaling_benchmarks(smvgen, tmpdir):
+    """Generates the scaling models, yields (name, model, commands)"""
+
+    commands = os.path.join(tmpdir, "scaling.cmd")
+    target = open(commands, "wt")
+    target.write("reach GOAL\nquit\n")
+    target.close()
+
+    for param, values in SCALING_SWEEPS:
+        for value in values:
+            params = dict(SCALING_DEFAULTS)
+            params[param] = value
+
+            model = os.path.join(tmpdir, "smvgen-%s-%d.smv" % (param, value))
+            args = [ smvgen, "--output", model ]
+            for name in sorted(params):
+                args += [ "--%s" % name, str(params[name]) ]
+
+            subprocess.check_call(args)
+            yield ("smvgen/%s=%d" % (param, value), model, commands)
+
+def scaling_curves(report):
+    """Arranges the figures of a scaling report by parameter"""
+
+    curves = {}
+    for param, values in SCALING_SWEEPS:
+        series = []
+        for value in values:
+            name = "smvgen/%s=%d" % (param, value)
+            if name in report:
+                point = dict(report[name])
+                point[param] = value
+                series.append(point)
+
+        if series:
+            curves[param] = series
+
+    return curves
+
+def perf_counters(path):
+    """Reads the CSV output of perf stat, returns the counts by figure"""
+
+    counts = {}
+    for line in open(path, "rt"):
+        fields = line.strip().split(",")
+        if len(fields) < 3 or line.startswith("#"):
+            continue
+
+        # e.g. `cycles:u`, or `cpu_core/cycles/u` on hybrid CPUs
+        value, event = fields[0], fields[2]
+        event = event.split(":")[0]
+        if "/" in event:
+            event = event.split("/")[1]
+        for name, figure in PERF_EVENTS:
+            if event == name:
+                try:
+                    counts[figure] = counts.get(figure, 0) + int(value)
+                except ValueError:
+                    pass # <not supported>, <not counted>
+
+    return counts
+
+def run(yasmv, model, commands, tmpdir, perf=None):
+    """Runs one benchmark, returns its figures"""
+
+    progress = tempfile.TemporaryFile(dir=tmpdir)
+    trace = os.path.join(tmpdir, "trace.json")
+    env = dict(os.environ)
+    env["YASMV_HOME"] = os.getcwd()
+
+    # the progress file is inherited by yasmv
+    fd = progress.fileno()
+    if sys.version_info[0] < 3:
+        inherit = { "close_fds": False }
+    else:
+        inherit = { "pass_fds": (fd,) }
+
+    source = open(commands, "rt")
+    devnull = open(os.devnull, "wt")
+
+    args = [ yasmv, "--quiet", "--progress-fd=%d" % fd,
+             "--trace-events=%s" % trace, model ]
+
+    counters = os.path.join(tmpdir, "perf.csv")
+    if perf is not None:
+        events = ",".join(name for name, _ in PERF_EVENTS)
+        args = [ perf, "stat", "-x", ",", "-o", counters, "-e", events, "--" ] + args
+
+    start = time.time()
+    child = subprocess.Popen(args, stdin=source, stdout=devnull, env=env, **inherit)
+
+    # resource usage of this child only
+    _, status, usage = os.wait4(child.pid, 0)
+    wall = time.time() - start
+
+    source.close()
+    devnull.close()
+
+    figures = {
+        "wall_secs": wall,
+        "compile_secs": 0.0,
+        "solve_secs": 0.0,
+        "solves": 0,
+        "clauses": 0,
+        "vars": 0,
+        "peak_rss_kb": usage.ru_maxrss,
+        "ok": os.WIFEXITED(status) and 0 == os.WEXITSTATUS(status),
+    }
+
+    progress.seek(0)
+    for line in progress:
+        solve = json.loads(line)
+
+        figures["solves"] += 1
+        figures["solve_secs"] += solve["wall"]
+        figures["clauses"] = max(figures["clauses"], solve["clauses"])
+        figures["vars"] = max(figures["vars"], solve["vars"])
+
+    progress.close()
+
+    # trace events durations are in microseconds
+    if os.path.exists(trace):
+        for event in json.load(open(trace, "rt"))["traceEvents"]:
+            if event.get("cat") == "compile":
+                figures["compile_secs"] += 1e-6 * event["dur"]
+        os.unlink(trace)
+
+    if os.path.exists(counters):
+        figures.update(perf_counters(counters))
+        os.unlink(counters)
+
+    return figures
+
+def compare(report, baseline, tolerance):
+    """Prints regressions against baseline, returns their number"""
+
+    regressions = 0
+    for name in sorted(report):
+        if name not in baseline:
+            continue
+
+        for figure, is_time in FIGURES:
+            current = report[name][figure]
+            reference = baseline[name].get(figure)
+            if reference is None:
+                continue
+
+            if is_time and current < NOISE_SECS:
+                continue
+
+            if reference * (1.0 + tolerance) < current:
+                delta = 100.0 * (current - reference) / reference if reference else float("inf")
+                print("REGRESSION %s: %s %s -> %s (+%.1f%%)" % (name, figure, reference, current, delta))
+                regressions += 1
+
+    return regressions
+
+def main():
+    yasmv = "./yasmv"
+    output = "bench.json"
+    baseline = None
+    tolerance = 0.10
+    pattern = ""
+    smvgen = None
+    perf = None
+
+    args = sys.argv[1:]
+    try:
+        while args:
+            opt = args.pop(0)
+            if opt == "--yasmv":
+                yasmv = args.pop(0)
+            elif opt == "--output":
+                output = args.pop(0)
+            elif opt == "--baseline":
+                baseline = args.pop(0)
+            elif opt == "--tolerance":
+                tolerance = float(args.pop(0))
+            elif opt == "--filter":
+                pattern = args.pop(0)
+            elif opt == "--scaling":
+                smvgen = smvgen or "./smvgen"
+            elif opt == "--smvgen":
+                smvgen = args.pop(0)
+            elif opt == "--perf":
+                perf = perf or "perf"
+            elif opt == "--perf-path":
+                perf = args.pop(0)
+            else:
+                raise ValueError(opt)
+    except (IndexError, ValueError):
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    tmpdir = tempfile.mkdtemp()
+
+    report = {}
+    failures = 0
+    if smvgen is None:
+        suite = benchmarks(tmpdir)
+    else:
+        suite = scaling_benchmarks(smvgen, tmpdir)
+
+    for name, model, commands in suite:
+        if pattern not in name:
+            continue
+
+        sys.stdout.write("Running benchmark %s ... " % name)
+        sys.stdout.flush()
+
+        figures = run(yasmv, model, commands, tmpdir, perf)
+        report[name] = figures
+
+        if figures["ok"]:
+            ipc = ""
+            if figures.get("cycles"):
+                ipc = ", %.2f IPC" % (float(figures.get("instructions", 0)) / figures["cycles"])
+            print("%.3f s (solve %.3f s, %d solves, %d clauses, %d KB%s)" %
+                  (figures["wall_secs"], figures["solve_secs"], figures["solves"],
+                   figures["clauses"], figures["peak_rss_kb"], ipc))
+        else:
+            print("FAILED!")
+            failures += 1
+
+    shutil.rmtree(tmpdir)
+
+    contents = report
+    if smvgen is not None:
+        contents = { "benchmarks": report, "scaling": scaling_curves(report) }
+
+    target = open(output, "wt")
+    json.dump(contents, target, indent=2, sort_keys=True)
+    target.write("\n")
+    target.close()
+
+    print("%d benchmarks written to %s" % (len(report), output))
+
+    regressions = 0
+    if baseline is not None:
+        if os.path.exists(baseline):
+            reference = json.load(open(baseline, "rt"))
+            if smvgen is not None:
+                reference = reference.get("benchmarks", {})
+
+            regressions = compare(report, reference, tolerance)
+            print("%d regressions against %s (tolerance %.0f%%)" %
+                  (regressions, baseline, 100.0 * tolerance))
+        else:
+            print("No baseline %s, nothing to compare against" % baseline)
+
+    if failures or regressions:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
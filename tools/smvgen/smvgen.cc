@@ -0,0 +1,245 @@
+/**
+ * @file smvgen.cc
+ * @brief Parametric generator of scalable SMV models
+ *
+ * usage: smvgen [--width N] [--instances N] [--array-size N]
+ *               [--density N] [--depth N] [--output FILE]
+ *
+ * Each instance is a counter, a shift register of array-size words
+ * fed by the counter and an accumulator, whose next value takes
+ * density multiply-add terms over the shift register and the
+ * accumulator of the previous instance. All counters step in
+ * lockstep, so that GOAL is reachable in exactly depth steps. The
+ * model is written on stdout, unless an output file is given.
+ *
+ * Remark: the instances are expanded inline, within a single module,
+ * as the main module of a model with several modules is not
+ * well-defined.
+ *
+ * Copyright (C) 2012 Marco Pensallorto < marco AT pensallorto DOT gmail DOT com >
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ **/
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+namespace options = boost::program_options;
+
+struct Params {
+    unsigned width;
+    unsigned instances;
+    unsigned array_size;
+    unsigned density;
+    unsigned depth;
+};
+
+static std::string var(unsigned instance, const char* name)
+{
+    std::ostringstream oss;
+    oss
+        << "u" << instance << "_" << name;
+
+    return oss.str();
+}
+
+static void generate(std::ostream& os, const Params& params)
+{
+    os
+        << "-- generated by smvgen"
+        << " --width " << params.width
+        << " --instances " << params.instances
+        << " --array-size " << params.array_size
+        << " --density " << params.density
+        << " --depth " << params.depth
+        << std::endl
+        << std::endl
+        << "MODULE smvgen;" << std::endl;
+
+    for (unsigned i = 0; i < params.instances; ++i) {
+        const std::string c { var(i, "c") };
+        const std::string r { var(i, "r") };
+        const std::string acc { var(i, "acc") };
+
+        os
+            << std::endl
+            << "VAR" << std::endl
+            << "    " << c << ", " << acc << " : uint" << params.width << ";" << std::endl
+            << "    " << r << " : uint" << params.width << "[" << params.array_size << "];" << std::endl
+            << std::endl
+            << "INIT" << std::endl
+            << "    " << c << " = 0 && " << acc << " = 0 && " << r << " = [";
+
+        for (unsigned j = 0; j < params.array_size; ++j) {
+            os
+                << (j ? ", " : " ") << "0";
+        }
+
+        os
+            << " ];" << std::endl
+            << std::endl
+            << "TRANS" << std::endl
+            << "    " << c << " := " << c << " + 1;" << std::endl
+            << std::endl
+            << "TRANS" << std::endl
+            << "    " << r << " := [ " << c;
+
+        for (unsigned j = 1; j < params.array_size; ++j) {
+            os
+                << ", " << r << "[" << j - 1 << "]";
+        }
+
+        os
+            << " ];" << std::endl
+            << std::endl
+            << "TRANS" << std::endl
+            << "    " << acc << " := " << acc;
+
+        /* the terms cycle over the shift register, the accumulator of
+           the previous instance chains the instances together */
+        for (unsigned k = 0; k < params.density; ++k) {
+            os
+                << " + " << r << "[" << k % params.array_size << "] * ";
+
+            if (i && 1 == k % 2) {
+                os
+                    << var(i - 1, "acc");
+            } else {
+                os
+                    << c;
+            }
+        }
+
+        os
+            << ";" << std::endl;
+    }
+
+    os
+        << std::endl
+        << "#hidden" << std::endl
+        << "DEFINE GOAL :=";
+
+    for (unsigned i = 0; i < params.instances; ++i) {
+        os
+            << (i ? " &&" : "") << " " << var(i, "c") << " = " << params.depth;
+    }
+
+    os
+        << ";" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    Params params;
+    std::string output;
+
+    options::options_description description { "smvgen options" };
+    description.add_options()
+        ( "help", "produce help message" )
+
+        ( "width",
+          options::value<unsigned>(&params.width)->default_value(16),
+          "word width of the state vars (1 .. 64)" )
+
+        ( "instances",
+          options::value<unsigned>(&params.instances)->default_value(1),
+          "number of instances" )
+
+        ( "array-size",
+          options::value<unsigned>(&params.array_size)->default_value(4),
+          "number of words of the shift register of each instance" )
+
+        ( "density",
+          options::value<unsigned>(&params.density)->default_value(1),
+          "number of multiply-add terms of each accumulator" )
+
+        ( "depth",
+          options::value<unsigned>(&params.depth)->default_value(16),
+          "number of steps GOAL is reachable in" )
+
+        ( "output,o",
+          options::value<std::string>(&output),
+          "output file (default is stdout)" )
+        ;
+
+    options::variables_map vm;
+    try {
+        options::store(options::parse_command_line(argc, argv, description), vm);
+        options::notify(vm);
+    } catch (options::error& e) {
+        std::cerr
+            << e.what()
+            << std::endl
+            << description
+            << std::endl;
+
+        return 1;
+    }
+
+    if (vm.count("help")) {
+        std::cout
+            << description
+            << std::endl;
+
+        return 0;
+    }
+
+    if (params.width < 1 || 64 < params.width ||
+        !params.instances || !params.array_size) {
+        std::cerr
+            << "width must be in 1 .. 64, instances and array size must be positive"
+            << std::endl;
+
+        return 1;
+    }
+
+    if (params.width < 64 && (1ULL << params.width) <= params.depth) {
+        std::cerr
+            << "depth "
+            << params.depth
+            << " does not fit in "
+            << params.width
+            << " bits"
+            << std::endl;
+
+        return 1;
+    }
+
+    if (output.empty()) {
+        generate(std::cout, params);
+        return 0;
+    }
+
+    std::ofstream target { output.c_str() };
+    generate(target, params);
+    target.close();
+
+    if (!target) {
+        std::cerr
+            << "Could not write "
+            << output
+            << std::endl;
+
+        return 1;
+    }
+
+    return 0;
+}
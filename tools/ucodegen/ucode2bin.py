@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+"""
+ucode2bin.py - microcode JSON to binary converter
+(c) 2014 Marco Pensallorto < marco DOT pensallorto AT gmail DOT com >
+
+This tool is part of the yasmv project.
+
+Converts microcode files produced by ucodegen.py (JSON) into the
+binary microcode format, which yasmv can memory-map and use in-place
+(see src/sat/microcode.hh for a description of the format).
+
+usage: ucode2bin.py [ -o <output-directory> ] <file-or-directory> ...
+"""
+
+import os
+import sys
+import json
+import struct
+import getopt
+
+MICROCODE_MAGIC = 0x42435559 # "YUCB"
+MICROCODE_VERSION = 1
+
+def convert(sourceName, targetName):
+    source = open(sourceName, "rt")
+    obj = json.load(source)
+    source.close()
+
+    offsets, literals = [ 0 ], []
+    for clause in obj["cnf"]:
+        literals.extend(clause)
+        offsets.append(len(literals))
+
+    target = open(targetName, "wb")
+    target.write(struct.pack("=4I", MICROCODE_MAGIC, MICROCODE_VERSION,
+                             len(offsets) - 1, len(literals)))
+    target.write(struct.pack("=%dI" % len(offsets), *offsets))
+    target.write(struct.pack("=%di" % len(literals), *literals))
+    target.close()
+
+    print("%s -> %s (%d clauses, %d literals)" % (
+        sourceName, targetName, len(offsets) - 1, len(literals)))
+
+def sources(args):
+    for arg in args:
+        if os.path.isdir(arg):
+            for entry in sorted(os.listdir(arg)):
+                if entry.endswith(".json"):
+                    yield os.path.join(arg, entry)
+        else:
+            yield arg
+
+def main():
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "o:h")
+    except getopt.GetoptError as e:
+        sys.stderr.write("%s\n" % e)
+        sys.exit(1)
+
+    outdir = None
+    for (opt, value) in opts:
+        if opt == "-o":
+            outdir = value
+        elif opt == "-h":
+            sys.stdout.write(__doc__)
+            sys.exit(0)
+
+    if not args:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    for sourceName in sources(args):
+        base = os.path.splitext(sourceName)[0]
+        if outdir is not None:
+            base = os.path.join(outdir, os.path.basename(base))
+
+        convert(sourceName, base + ".bin")
+
+if __name__ == "__main__":
+    main()
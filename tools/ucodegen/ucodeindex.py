@@ -0,0 +1,48 @@
+#!/usr/bin/env python
+"""
+ucodeindex.py - microcode index generator
+(c) 2014 Marco Pensallorto < marco DOT pensallorto AT gmail DOT com >
+
+This tool is part of the yasmv project.
+
+Writes the microcode index for a microcode directory. The index maps
+each microcode name (e.g. `u-mul-8`) to the file holding its clauses,
+so that yasmv does not have to scan the whole directory at startup.
+Binary microcode (.bin) is preferred over JSON microcode (.json) when
+both are available.
+
+usage: ucodeindex.py <microcode-directory>
+"""
+
+import os
+import sys
+
+EXTENSIONS = [ ".bin", ".json" ] # in order of preference
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    directory = sys.argv[1]
+
+    index = {}
+    for entry in os.listdir(directory):
+        name, ext = os.path.splitext(entry)
+        if ext not in EXTENSIONS:
+            continue
+
+        if name not in index or \
+                EXTENSIONS.index(ext) < EXTENSIONS.index(os.path.splitext(index[name])[1]):
+            index[name] = entry
+
+    target = open(os.path.join(directory, "index"), "wt")
+    target.write("# yasmv microcode index, generated by ucodeindex.py\n")
+    for name in sorted(index):
+        target.write("%s %s\n" % (name, index[name]))
+    target.close()
+
+    print("%d microcode entries indexed" % len(index))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+"""
+ucodepack.py - microcode archive generator
+(c) 2014 Marco Pensallorto < marco DOT pensallorto AT gmail DOT com >
+
+This tool is part of the yasmv project.
+
+Packs a microcode directory into a single microcode archive, which
+yasmv reads in-place: each operator is compressed on its own (zlib),
+and only the operators actually needed are ever read and inflated
+(see src/sat/microcode.hh for a description of the format). Binary
+microcode (.bin) is preferred over JSON microcode (.json) when both
+are available, JSON microcode is converted on the fly.
+
+usage: ucodepack.py [ -o <archive> ] <microcode-directory>
+"""
+
+import os
+import sys
+import json
+import zlib
+import struct
+import getopt
+
+MICROCODE_MAGIC = 0x42435559 # "YUCB"
+MICROCODE_VERSION = 1
+
+MICROCODE_ARCHIVE_MAGIC = 0x41435559 # "YUCA"
+MICROCODE_ARCHIVE_VERSION = 1
+MICROCODE_ARCHIVE_NAME_LEN = 32
+
+HEADER = "=4I"
+ENTRY = "=%dsQ2I" % MICROCODE_ARCHIVE_NAME_LEN
+
+EXTENSIONS = [ ".bin", ".json" ] # in order of preference
+
+def binary(sourceName):
+    if sourceName.endswith(".bin"):
+        source = open(sourceName, "rb")
+        res = source.read()
+        source.close()
+        return res
+
+    source = open(sourceName, "rt")
+    obj = json.load(source)
+    source.close()
+
+    offsets, literals = [ 0 ], []
+    for clause in obj["cnf"]:
+        literals.extend(clause)
+        offsets.append(len(literals))
+
+    return struct.pack("=4I", MICROCODE_MAGIC, MICROCODE_VERSION,
+                       len(offsets) - 1, len(literals)) + \
+        struct.pack("=%dI" % len(offsets), *offsets) + \
+        struct.pack("=%di" % len(literals), *literals)
+
+def main():
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "o:h")
+    except getopt.GetoptError as e:
+        sys.stderr.write("%s\n" % e)
+        sys.exit(1)
+
+    targetName = "microcode.pack"
+    for (opt, value) in opts:
+        if opt == "-o":
+            targetName = value
+        elif opt == "-h":
+            sys.stdout.write(__doc__)
+            sys.exit(0)
+
+    if len(args) != 1:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    directory = args[0]
+
+    index = {}
+    for entry in os.listdir(directory):
+        name, ext = os.path.splitext(entry)
+        if ext not in EXTENSIONS:
+            continue
+
+        if MICROCODE_ARCHIVE_NAME_LEN < len(name):
+            sys.stderr.write("%s: name too long, skipped\n" % entry)
+            continue
+
+        if name not in index or \
+                EXTENSIONS.index(ext) < EXTENSIONS.index(os.path.splitext(index[name])[1]):
+            index[name] = entry
+
+    names = sorted(index)
+    offset = struct.calcsize(HEADER) + len(names) * struct.calcsize(ENTRY)
+
+    entries, blobs = [], []
+    raw, packed = 0, 0
+    for name in names:
+        image = binary(os.path.join(directory, index[name]))
+        blob = zlib.compress(image, 9)
+
+        entries.append(struct.pack(ENTRY, name.encode("ascii"), offset,
+                                   len(blob), len(image)))
+        blobs.append(blob)
+
+        offset += len(blob)
+        raw += len(image)
+        packed += len(blob)
+
+    target = open(targetName, "wb")
+    target.write(struct.pack(HEADER, MICROCODE_ARCHIVE_MAGIC,
+                             MICROCODE_ARCHIVE_VERSION, len(names), 0))
+    for entry in entries:
+        target.write(entry)
+    for blob in blobs:
+        target.write(blob)
+    target.close()
+
+    print("%d microcode entries packed into %s (%d -> %d bytes)" % (
+        len(names), targetName, raw, packed))
+
+if __name__ == "__main__":
+    main()